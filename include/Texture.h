@@ -52,6 +52,18 @@ public:
      * this texture does not have a valid size.
      */
     virtual std::size_t getHeight() const = 0;
+
+    /**
+     * \brief
+     * Return the GL_ARB_bindless_texture handle of this texture, which is
+     * created and made resident on first request. Once a handle exists, the
+     * texture parameters can no longer be changed. Returns 0 if the texture
+     * doesn't support bindless access or the extension is not available.
+     */
+    virtual GLuint64 getBindlessHandle()
+    {
+        return 0;
+    }
 };
 typedef std::shared_ptr<Texture> TexturePtr;
 
@@ -109,6 +109,12 @@ public:
      * Load the AAS file contents from the given stream. 
      */
     virtual IAasFilePtr loadFromStream(std::istream& stream) = 0;
+
+    /**
+     * Load the AAS file at the given absolute path. The loader may keep the
+     * parsed data in a cache, which is used as long as the file doesn't change.
+     */
+    virtual IAasFilePtr loadFromFile(const std::string& absolutePath) = 0;
 };
 typedef std::shared_ptr<IAasFileLoader> IAasFileLoaderPtr;
 
@@ -10,6 +10,7 @@
 
 #include "imodule.h"
 #include <cstddef>
+#include <cstdint>
 
 #include "itextstream.h"
 
@@ -53,6 +54,15 @@ public:
 	/// The stream may be read forwards until it is exhausted.
 	/// The stream remains valid for the lifetime of the file.
 	virtual InputStream& getInputStream() = 0;
+	/// \brief Returns the file data if it is available in memory as a whole,
+	/// e.g. for files stored uncompressed in a memory-mapped archive. The
+	/// returned pointer keeps the memory alive, the data is read-only.
+	/// The default implementation returns an empty pointer, in which case
+	/// the data needs to be read through the input stream.
+	virtual std::shared_ptr<const uint8_t> getMappedData()
+	{
+		return {};
+	}
 };
 typedef std::shared_ptr<ArchiveFile> ArchiveFilePtr;
 
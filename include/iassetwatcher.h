@@ -0,0 +1,49 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <sigc++/signal.h>
+#include "imodule.h"
+
+namespace vfs
+{
+
+/**
+ * Watches the physical VFS search paths for changed files and reloads the
+ * assets affected by them: changed declaration files are re-parsed, the
+ * materials using a changed image reload their textures and the entities
+ * using a changed model reload it.
+ *
+ * Files stored in PK4 archives are not watched. Watching can be disabled
+ * in the preferences.
+ */
+class IAssetWatcher :
+    public RegisterableModule
+{
+public:
+    virtual ~IAssetWatcher() {}
+
+    // True if the search paths are currently being watched
+    virtual bool isWatching() const = 0;
+
+    // Emitted by the watcher thread when changed files have been detected. Listeners
+    // need to arrange for processChanges() to be called on the main thread.
+    virtual sigc::signal<void>& signal_changesDetected() = 0;
+
+    // Reloads the assets affected by the files changed since the last call
+    virtual void processChanges() = 0;
+
+    // Reloads the assets affected by the given changed files (VFS paths like
+    // "materials/base.mtr"), files not being an asset are ignored
+    virtual void reloadChangedFiles(const std::set<std::string>& vfsPaths) = 0;
+};
+
+}
+
+constexpr const char* const MODULE_ASSETWATCHER("AssetWatcher");
+
+inline vfs::IAssetWatcher& GlobalAssetWatcher()
+{
+    static module::InstanceReference<vfs::IAssetWatcher> _reference(MODULE_ASSETWATCHER);
+    return _reference;
+}
@@ -29,6 +29,15 @@ public:
     // for the currently loaded map, regardless whether it is due for a save or not.
     // Call the "runAutosaveCheck" method to see if an autosave is overdue.
     virtual void performAutosave() = 0;
+
+    // Like performAutosave, but only the scene contents are captured by the calling
+    // thread, the files are written by a worker thread afterwards. An autosave
+    // colliding with a previous one still waiting to be written replaces that one.
+    // Behaves like performAutosave if background saving is disabled.
+    virtual void performAutosaveInBackground() = 0;
+
+    // Blocks until all autosaves running in the background are written to disk
+    virtual void waitForBackgroundSaves() = 0;
 };
 
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_ENABLED = "user/ui/map/autoSaveSnapshots";
@@ -36,6 +45,15 @@ constexpr const char* const RKEY_AUTOSAVE_SNAPSHOTS_FOLDER = "user/ui/map/snapsh
 constexpr const char* const RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE = "user/ui/map/maxSnapshotFolderSize";
 constexpr const char* const RKEY_AUTOSAVE_SNAPSHOT_FOLDER_SIZE_HISTORY = "user/ui/map/snapshotFolderSizeHistory";
 
+// Snapshots only record the entities changed since the previous snapshot in a journal
+constexpr const char* const RKEY_AUTOSAVE_DIFFERENTIAL_SNAPSHOTS = "user/ui/map/differentialSnapshots";
+
+// The number of journal entries before the next full snapshot is written
+constexpr const char* const RKEY_AUTOSAVE_MAX_JOURNAL_ENTRIES = "user/ui/map/maxSnapshotJournalEntries";
+
+// Autosaves are written to disk by a worker thread
+constexpr const char* const RKEY_AUTOSAVE_IN_BACKGROUND = "user/ui/map/autoSaveInBackground";
+
 }
 
 constexpr const char* const MODULE_AUTOSAVER("AutomaticMapSaver");
@@ -127,7 +127,8 @@ public:
 	// This doesn't take into account whether the owning brush is visible or not
 	virtual bool isVisible() const = 0;
 
-	// Shader accessors
+	// Shader accessors. The returned name is interned, faces and patches
+	// using the same material return a reference to the same string.
 	virtual const std::string& getShader() const = 0;
 	virtual void setShader(const std::string& name) = 0;
 
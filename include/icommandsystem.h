@@ -228,6 +228,9 @@ using CheckFunction = std::function<bool()>;
 // A command signature consists just of arguments, return type is always void
 typedef std::vector<std::size_t> Signature;
 
+// Identifies a command string parsed by ICommandSystem::prepare()
+using PreparedCommandId = std::size_t;
+
 /**
  * greebo: Auto-completion information returned by the CommandSystem
  * when the user is entering a partial command.
@@ -356,6 +359,26 @@ public:
 	 */
 	virtual void execute(const std::string& input) = 0;
 
+	/**
+	 * Parses the given command string (see execute()) and resolves its commands,
+	 * returning an ID which can be passed to executePrepared() any number of times
+	 * without tokenising the string or looking up the commands again. Preparing
+	 * the same string again returns the same ID. Commands added or removed after
+	 * preparing the string are taken into account by the next execution.
+	 */
+	virtual PreparedCommandId prepare(const std::string& input) = 0;
+
+	/// Executes the command string prepared under the given ID
+	virtual void executePrepared(PreparedCommandId id) = 0;
+
+	/**
+	 * Executes the given command string as a single operation: the changes of all
+	 * its statements are recorded as one undo step using the given name, and the
+	 * scene change notifications are sent once after the last statement.
+	 * Without a loaded map, this behaves like execute().
+	 */
+	virtual void executeBatch(const std::string& input, const std::string& undoOperationName) = 0;
+
     /// Execute the named command with the given list of arguments
     virtual void executeCommand(const std::string& name, const ArgumentList& args = {}) = 0;
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include <sigc++/signal.h>
 #include "imodule.h"
 #include "ifilesystem.h"
@@ -36,6 +37,32 @@ struct DeclarationBlockSyntax : game::IResource
     }
 };
 
+// An immutable list of the declarations of a single type, as returned by
+// IDeclarationManager::getNameSnapshot(). It can be used without holding any lock.
+struct DeclarationNameSnapshot
+{
+    using Ptr = std::shared_ptr<const DeclarationNameSnapshot>;
+
+    struct Entry
+    {
+        // The name of the declaration, as used by findDeclaration()
+        std::string name;
+
+        // The mod name followed by the name using forward slashes, e.g. "base/textures/common/caulk"
+        std::string fullPath;
+
+        // The visibility of the file the declaration is defined in
+        vfs::Visibility visibility;
+    };
+
+    // Snapshots of the same type and version have the same contents,
+    // any change to the declarations results in a higher version
+    std::size_t version = 0;
+
+    // The entries, ordered by name (case-insensitively)
+    std::vector<Entry> entries;
+};
+
 // Common interface shared by all the declarations supported by a certain game type
 class IDeclaration :
     public game::IResource
@@ -145,6 +172,10 @@ public:
     // Iterate over all known declarations, using the given visitor
     virtual void foreachDeclaration(Type type, const std::function<void(const IDeclaration::Ptr&)>& functor) = 0;
 
+    // Returns the names of all known declarations of the given type. The snapshot is
+    // kept until the declarations of this type change, so calling this repeatedly is cheap.
+    virtual DeclarationNameSnapshot::Ptr getNameSnapshot(Type type) = 0;
+
     // Renames the declaration from oldName to newName. The new name must not be in use by any other declaration,
     // and it must be different from oldName, otherwise renaming will fail.
     // Returns true if the old declaration existed and could successfully be renamed, false on any failure.
@@ -160,6 +191,10 @@ public:
     // All declaration references will stay intact, only their contents will be refreshed
     virtual void reloadDeclarations() = 0;
 
+    // Returns true if the given VFS path is located in one of the registered decl folders
+    // and carries the folder's extension, i.e. it would be parsed by reloadDeclarations()
+    virtual bool isDeclarationFile(const std::string& vfsPath) = 0;
+
     // Saves the given declaration to a physical declaration file. Depending on the original location
     // of the declaration the outcome will be different.
     //
@@ -177,6 +212,14 @@ public:
     //      just like in case #2
     virtual void saveDeclaration(const IDeclaration::Ptr& decl) = 0;
 
+    // Like saveDeclaration(), but the file is written by a background thread. Saves to the same
+    // file are collected until it is written, then merged into it in one go. Failures are logged.
+    // Throws std::invalid_argument if the declaration lacks file information.
+    virtual void saveDeclarationDeferred(const IDeclaration::Ptr& decl) = 0;
+
+    // Blocks until all deferred saves have been written to their files
+    virtual void waitForPendingSaves() = 0;
+
     // Signal emitted right before decls are being reloaded
     virtual sigc::signal<void>& signal_DeclsReloading(Type type) = 0;
 
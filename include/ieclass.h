@@ -141,6 +141,10 @@ public:
     /// Signal emitted when entity class contents are changed or reloaded
     virtual sigc::signal<void>& changedSignal() = 0;
 
+    /// Signal emitted when only the display colour of this class has changed,
+    /// e.g. after a colour scheme override. changedSignal() is not emitted then.
+    virtual sigc::signal<void>& colourChangedSignal() = 0;
+
     /// Get the parent entity class or NULL if there is no parent
     virtual IEntityClass* getParent() = 0;
 
@@ -170,6 +170,21 @@ public:
     virtual void setKeyValue(const std::string& key,
                              const std::string& value) = 0;
 
+    /**
+     * \brief Start a batch of key value changes.
+     *
+     * Until the matching endBatchUpdate() call, the observers are not notified
+     * about any inserted, changed or erased keys. The changes are coalesced per
+     * key: the observers receive a single notification carrying the final value,
+     * keys inserted and erased again within the batch are not notified at all.
+     * Batches can be nested, the notifications are sent when the outermost
+     * batch ends. Use the EntityBatchUpdate class to ensure the batch is ended.
+     */
+    virtual void beginBatchUpdate() = 0;
+
+    /// End a batch started by beginBatchUpdate() and send the pending notifications
+    virtual void endBatchUpdate() = 0;
+
     /* Retrieve a key value from the entity.
      *
      * @param key
@@ -287,6 +302,28 @@ public:
     virtual void forEachAttachment(AttachmentFunc func) const = 0;
 };
 
+/// Scoped batch of key value changes on the given entity, see Entity::beginBatchUpdate()
+class EntityBatchUpdate
+{
+private:
+    Entity& _entity;
+
+public:
+    EntityBatchUpdate(Entity& entity) :
+        _entity(entity)
+    {
+        _entity.beginBatchUpdate();
+    }
+
+    EntityBatchUpdate(const EntityBatchUpdate& other) = delete;
+    EntityBatchUpdate& operator=(const EntityBatchUpdate& other) = delete;
+
+    ~EntityBatchUpdate()
+    {
+        _entity.endBatchUpdate();
+    }
+};
+
 /// Callback for an entity key value change
 using KeyObserverFunc = sigc::slot<void(const std::string&)>;
 
@@ -451,6 +488,36 @@ public:
 };
 typedef std::shared_ptr<ITargetManager> ITargetManagerPtr;
 
+/**
+ * Keeps track of the entities of each entity class in a map, such that clients
+ * can enumerate all entities of a certain class (like the objective or
+ * conversation entities) without walking the scene graph.
+ *
+ * An instance is owned by the RootNode, entity nodes register themselves when
+ * they are inserted into the scene and keep their entry up to date when the
+ * classname spawnarg is changed. Class names are compared case-insensitively.
+ */
+class IEntityClassIndex
+{
+public:
+    virtual ~IEntityClassIndex() {}
+
+    // Invokes the functor for each entity of the given class, in the order the
+    // entities have been added. The index must not be modified during iteration.
+    virtual void foreachEntityOfClass(const std::string& className,
+        const std::function<void(const IEntityNodePtr&)>& functor) = 0;
+
+    // Returns the number of entities of the given class
+    virtual std::size_t getNumEntitiesOfClass(const std::string& className) = 0;
+
+    // Adds the entity to the given class, it is removed from any previous class first
+    virtual void addEntity(const std::string& className, IEntityNode& entity) = 0;
+
+    // Removes the entity from the index, does nothing if it hasn't been added
+    virtual void removeEntity(IEntityNode& entity) = 0;
+};
+typedef std::shared_ptr<IEntityClassIndex> IEntityClassIndexPtr;
+
 enum class LightEditVertexType : std::size_t
 {
     StartEndDeselected,
@@ -522,6 +589,9 @@ public:
     // Constructs a new targetmanager instance (used by root nodes)
     virtual ITargetManagerPtr createTargetManager() = 0;
 
+    // Constructs a new entity class index (used by root nodes)
+    virtual IEntityClassIndexPtr createEntityClassIndex() = 0;
+
     // Access to the settings manager
     virtual IEntitySettings& getSettings() = 0;
 
@@ -112,6 +112,21 @@ public:
 	 */
 	virtual void updateSubgraph(const scene::INodePtr& root) = 0;
 
+	/**
+	 * Queues the given node to have its filtered status re-evaluated before the
+	 * next frame is rendered. Nodes in the scene are calling this when their
+	 * material, entity class or spawnargs change, newly inserted nodes are
+	 * queued automatically.
+	 */
+	virtual void queueUpdate(const scene::INodePtr& node) = 0;
+
+	/**
+	 * Re-evaluates the filtered status of all queued nodes. This is invoked
+	 * at the start of each frame, it doesn't need to be called by client code
+	 * other than to get the results before that.
+	 */
+	virtual void processQueuedUpdates() = 0;
+
 	/**
 	 * Visit the available filters, passing each filter's text name to the visitor.
 	 *
@@ -70,6 +70,10 @@ public:
     // as the one passed to addGeometry. To change the size the data needs to be removed and re-added.
     virtual void updateGeometry(Slot slot, const Vertices& vertices, const Indices& indices) = 0;
 
+    // Replaces a range of the vertex data, starting at the given vertex offset. The range must be
+    // within the vertex array passed to addGeometry, the index data is left untouched.
+    virtual void updateSubGeometry(Slot slot, std::size_t vertexOffset, const Vertices& vertices) = 0;
+
     // Submits all active geometry slots to GL
     virtual void renderAllVisibleGeometry() = 0;
 
@@ -160,6 +160,15 @@ public:
         updateSubData(slot, 0, {}, indexOffset, indices);
     }
 
+    /**
+     * Updates a portion of vertex data in a regular slot, leaving the indices alone.
+     * Equivalent to calling updateSubData() with an empty set of indices.
+     */
+    virtual void updateVertexSubData(Slot slot, std::size_t vertexOffset, const Vertices& vertices)
+    {
+        updateSubData(slot, vertexOffset, vertices, 0, {});
+    }
+
     /**
      * Called in case the stored data in the given slot should just be cut off at the end.
      */
@@ -207,6 +216,25 @@ public:
      */
     virtual AABB getBounds(Slot slot) const = 0;
 
+    /// The way the vertex data is laid out in the vertex buffer objects
+    enum class VertexFormat
+    {
+        // RenderVertex structures as they are
+        Interleaved,
+
+        // All positions (Vector3f) in a first stream, followed by
+        // a second stream of PackedVertexAttributes
+        Packed,
+    };
+
+    // Returns the vertex format used in the buffer objects
+    virtual VertexFormat getVertexFormat() const = 0;
+
+    // Returns the byte offset of the PackedVertexAttributes stream in the current
+    // vertex buffer object, as of the last call to syncToBufferObjects().
+    // Only meaningful for the Packed vertex format.
+    virtual std::size_t getPackedAttributesOffset() const = 0;
+
     // Return the buffer objects of the current frame
     virtual std::pair<IBufferObject::Ptr, IBufferObject::Ptr> getBufferObjects() = 0;
 
@@ -116,6 +116,11 @@ protected:
 
 	sigc::connection _exprChangedSignal;
 
+private:
+	// The cached result of the expression, invalidated by its changed signal
+	mutable ValueType _value = ValueType();
+	mutable bool _valueIsValid = false;
+
 public:
 	typedef std::shared_ptr<WindowVariable<ValueType>> Ptr; // smart ptr typedef
 
@@ -126,7 +131,14 @@ public:
 
 	virtual ValueType getValue() const
 	{
-		return _expression ? _expression->evaluate() : ValueType();
+		// The expression is only evaluated again after it signaled a change
+		if (!_valueIsValid)
+		{
+			_value = _expression ? _expression->evaluate() : ValueType();
+			_valueIsValid = true;
+		}
+
+		return _value;
 	}
 
 	// Assigns a new Expression to this variable. The expression needs
@@ -139,14 +151,16 @@ public:
 		_exprChangedSignal.disconnect();
 
 		_expression = newExpr;
+		_valueIsValid = false;
 
 		signal_variableChanged().emit();
 
 		// Subscribe to this new expression's changed signal
 		if (_expression)
 		{
-			_expression->signal_valueChanged().connect([this]()
+			_exprChangedSignal = _expression->signal_valueChanged().connect([this]()
 			{
+				_valueIsValid = false;
 				signal_variableChanged().emit();
 			});
 		}
@@ -159,6 +173,8 @@ public:
 		_exprChangedSignal.disconnect();
 
 		_expression = ConstantExpression<ValueType>::Create(constantValue);
+		_value = constantValue;
+		_valueIsValid = true;
 
 		signal_variableChanged().emit();
 
@@ -289,6 +305,14 @@ public:
 	virtual IWindowVariable& findVariableByName(const std::string& name) = 0;
 };
 
+// The value of a GUI state variable (gui::<key>), the numeric value
+// is converted once when the variable is assigned
+struct GuiStateValue
+{
+	std::string string;
+	float number = 0;
+};
+
 /**
 * greebo: This class represents a single D3 GUI. It holds all
 * the windowDefs and the source code behind.
@@ -311,6 +335,11 @@ public:
 	// Returns the state string "gui::<key>" or an empty string if non-existent
 	virtual std::string getStateString(const std::string& key) = 0;
 
+	// Returns the storage of the given state variable, which is allocated if non-existent.
+	// The reference stays valid as long as this GUI is alive, such that expressions
+	// can resolve their state variables once instead of looking them up by name.
+	virtual const GuiStateValue& getStateValue(const std::string& key) = 0;
+
 	// Sets up the time of the entire GUI (all windowDefs)
 	virtual void initTime(const std::size_t time) = 0;
 
@@ -55,6 +55,31 @@ public:
 
 typedef std::shared_ptr<BindableTexture> BindableTexturePtr;
 
+/**
+ * \brief Interface for an object with precomputed mipmaps, which can be
+ * uploaded to OpenGL one level at a time.
+ *
+ * The texture is created without any levels, the caller uploads them starting
+ * with the smallest one. After each upload the texture is usable, sampling
+ * the levels uploaded so far.
+ */
+class ProgressiveBindableTexture
+{
+public:
+    virtual ~ProgressiveBindableTexture() {}
+
+    /// Create the texture object at its full size, without uploading any data
+    virtual TexturePtr createProgressiveTexture(const std::string& name) const = 0;
+
+    /**
+     * \brief Upload the given mipmap level into a texture created by
+     * createProgressiveTexture(), which must already contain all smaller
+     * levels. Returns false if the upload failed, the texture keeps the levels
+     * uploaded before. Needs to be called with a current GL context.
+     */
+    virtual bool uploadLevel(const TexturePtr& texture, std::size_t level) const = 0;
+};
+
 /// Representation of a 2D image texture in an unspecified format
 class Image
 : public BindableTexture
@@ -111,6 +136,23 @@ public:
      */
     virtual ImagePtr imageFromVFS(const std::string& vfsPath) const = 0;
 
+    /**
+     * \brief
+     * Returns the VFS path of the file imageFromVFS() would load for the given
+     * path, including prefix and extension. Returns an empty string if there's
+     * no such file.
+     */
+    virtual std::string findImageInVFS(const std::string& vfsPath) const = 0;
+
+    /**
+     * \brief
+     * Load a number of images from the VFS, like imageFromVFS() does. The
+     * images are decoded in parallel, the returned vector has the same order
+     * as the given paths, containing an empty pointer for each image that
+     * could not be loaded.
+     */
+    virtual std::vector<ImagePtr> imagesFromVFS(const std::vector<std::string>& vfsPaths) const = 0;
+
     /**
      * \brief
      * Load an image from a filesystem path.
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <set>
 #include <string>
+#include <vector>
 #include <functional>
 #include "imodule.h"
 #include <sigc++/signal.h>
@@ -15,6 +18,73 @@ typedef std::shared_ptr<INode> INodePtr;
 // A list of named layers
 typedef std::set<int> LayerList;
 
+/**
+ * A set of layer IDs stored as one bit per layer, such that testing a node's
+ * layers against the visible ones is a single AND for the common layer counts.
+ * IDs below 64 don't need any memory allocation.
+ */
+class LayerMask
+{
+private:
+	static constexpr int BITS_PER_BLOCK = 64;
+
+	std::uint64_t _firstBlock = 0;
+	std::vector<std::uint64_t> _moreBlocks;
+
+public:
+	void set(int layerId, bool value = true)
+	{
+		if (layerId < 0) return;
+
+		auto blockIndex = static_cast<std::size_t>(layerId / BITS_PER_BLOCK);
+		auto bit = std::uint64_t(1) << (layerId % BITS_PER_BLOCK);
+
+		if (blockIndex > _moreBlocks.size())
+		{
+			if (!value) return; // not set anyway
+
+			_moreBlocks.resize(blockIndex, 0);
+		}
+
+		auto& block = blockIndex == 0 ? _firstBlock : _moreBlocks[blockIndex - 1];
+		block = value ? block | bit : block & ~bit;
+	}
+
+	bool test(int layerId) const
+	{
+		if (layerId < 0) return false;
+
+		auto blockIndex = static_cast<std::size_t>(layerId / BITS_PER_BLOCK);
+
+		if (blockIndex > _moreBlocks.size()) return false;
+
+		auto block = blockIndex == 0 ? _firstBlock : _moreBlocks[blockIndex - 1];
+
+		return (block & (std::uint64_t(1) << (layerId % BITS_PER_BLOCK))) != 0;
+	}
+
+	// Returns true if any layer is part of both masks
+	bool intersects(const LayerMask& other) const
+	{
+		if (_firstBlock & other._firstBlock) return true;
+
+		auto numBlocks = std::min(_moreBlocks.size(), other._moreBlocks.size());
+
+		for (std::size_t i = 0; i < numBlocks; ++i)
+		{
+			if (_moreBlocks[i] & other._moreBlocks[i]) return true;
+		}
+
+		return false;
+	}
+
+	void clear()
+	{
+		_firstBlock = 0;
+		_moreBlocks.clear();
+	}
+};
+
 /**
  * greebo: Interface of a Layered object.
  */
@@ -45,6 +115,11 @@ public:
      */
     virtual const LayerList& getLayers() const = 0;
 
+    /**
+     * Returns the layers of this object as bit mask, containing the same IDs as getLayers().
+     */
+    virtual const LayerMask& getLayerMask() const = 0;
+
 	/**
 	 * greebo: This assigns the given node to the given set of layers. Any previous
 	 * assignments of the node will be overwritten by this routine.
@@ -171,6 +246,15 @@ public:
 	 */
 	virtual bool updateNodeVisibility(const INodePtr& node) = 0;
 
+	/**
+	 * Called by the nodes of this manager's scene when they are inserted into
+	 * or removed from the scene, to maintain the index of each layer's members.
+	 * Nodes changing their layers while in the scene unregister before and
+	 * register again after the change.
+	 */
+	virtual void registerNode(INode& node) = 0;
+	virtual void unregisterNode(INode& node) = 0;
+
 	/**
 	 * greebo: Sets the selection status of the entire layer.
 	 *
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <mutex>
+#include <thread>
 
 namespace applog
 {
@@ -38,6 +39,16 @@ public:
 	 */
 	virtual void writeLog(const std::string& outputStr, LogLevel level) = 0;
 
+	/**
+	 * The ILogWriter is passing the output to its devices on a dedicated
+	 * writer thread. This variant receives the ID of the thread the output
+	 * originates from, which devices can override to include it in their log.
+	 */
+	virtual void writeLogFromThread(const std::string& outputStr, LogLevel level, std::thread::id sourceThread)
+	{
+		writeLog(outputStr, level);
+	}
+
 	/**
 	 * If this device is a console, it will be filled with the log output
 	 * that has been collected before it has been attached.
@@ -80,10 +91,16 @@ public:
 	 */
 	virtual std::mutex& getStreamLock() = 0;
 
+	/**
+	 * Blocks until all log output written so far has been passed to the devices.
+	 * Output is written asynchronously, except for errors.
+	 */
+	virtual void flush() = 0;
+
 	/**
 	 * greebo: Use these methods to attach/detach a log device from the
 	 * writer class. After attaching a device, all log output
-	 * will be written to it.
+	 * will be written to it. Detaching a device flushes the pending output first.
 	 */
 	virtual void attach(ILogDevice* device) = 0;
 	virtual void detach(ILogDevice* device) = 0;
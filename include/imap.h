@@ -16,8 +16,24 @@ const char* const RKEY_MAP_SUPPRESS_LOAD_STATUS_DIALOG = "user/ui/map/suppressMa
 // Whether to load the most recently used map on app startup
 const char* const RKEY_LOAD_LAST_MAP = "user/ui/map/loadLastMap";
 
+// Whether the models and materials of the most recently used map are loaded
+// in the background on app startup, see PRELOAD_MAP_ASSETS_CMD
+const char* const RKEY_PRELOAD_LAST_MAP = "user/ui/map/preloadLastMap";
+
+// Whether the Doom 3 map reader is parsing the primitives on multiple threads
+const char* const RKEY_MAP_PARALLEL_PARSING = "user/ui/map/parallelParsing";
+
+// Whether map resources are reading and writing the binary map cache next to the map file
+const char* const RKEY_MAP_USE_CACHE = "user/ui/map/useMapCache";
+
+// The minimum size of a map file in KB to write a map cache for it
+const char* const RKEY_MAP_CACHE_MIN_SIZE = "user/ui/map/mapCacheMinSize";
+
 const char* const LOAD_PREFAB_AT_CMD = "LoadPrefabAt";
 
+// Loads the assets listed in the manifest written when the given map had been closed
+const char* const PRELOAD_MAP_ASSETS_CMD = "PreloadMapAssets";
+
 // Namespace forward declaration
 class INamespace;
 typedef std::shared_ptr<INamespace> INamespacePtr;
@@ -27,6 +43,7 @@ class IMapFileChangeTracker;
 
 // see ientity.h
 class ITargetManager;
+class IEntityClassIndex;
 
 // see ilayer.h
 class ILayerManager;
@@ -77,6 +94,11 @@ public:
      */
     virtual ITargetManager& getTargetManager() = 0;
 
+    /**
+     * Returns the index of the entities in this map, sorted by entity class.
+     */
+    virtual IEntityClassIndex& getEntityClassIndex() = 0;
+
     /**
      * The map root node is holding an implementation of the change tracker
      * interface, to keep track of whether the map resource on disk is
@@ -251,6 +273,18 @@ public:
 
     /// Return true if a point trace is currently visible
     virtual bool isPointTraceVisible() const = 0;
+
+    /**
+     * Signal emitted by a worker thread for every frame of the animation moving
+     * the camera along the point trace (started by the FollowLeak command).
+     * Listeners need to dispatch the call to updatePointTraceAnimation() to the
+     * main thread.
+     */
+    virtual sigc::signal<void>& signal_pointTraceAnimationFrame() = 0;
+
+    // Moves the camera to the position of the running point trace animation.
+    // This must be called on the main thread.
+    virtual void updatePointTraceAnimation() = 0;
 };
 typedef std::shared_ptr<IMap> IMapPtr;
 
@@ -28,6 +28,24 @@ typedef std::function<void(const scene::INodePtr& root, scene::NodeVisitor& node
 namespace map
 {
 
+/**
+ * The values of a single primitive as parsed by PrimitiveParser::parseDetached(),
+ * which have not been turned into a scene node yet.
+ */
+class ParsedPrimitive
+{
+public:
+    virtual ~ParsedPrimitive() {}
+
+    /**
+     * Creates the scene node from the parsed values. Since the node constructors
+     * are accessing the shader system and the scenegraph, this has to be called
+     * from the main thread.
+     */
+    virtual scene::INodePtr createNode() const = 0;
+};
+typedef std::unique_ptr<ParsedPrimitive> ParsedPrimitivePtr;
+
 /**
  * A Primitive parser is able to create a primitive (brush, patch) from a given token stream.
  * The initial token, e.g. "brushDef3" is already parsed when the stream is passed to the
@@ -54,6 +72,18 @@ public:
 	 * Creates and returns a primitive node according to the encountered token.
 	 */
     virtual scene::INodePtr parse(parser::DefTokeniser& tok) const = 0;
+
+	/**
+	 * Parses the primitive without creating a scene node, such that this can be
+	 * called from worker threads, each of them using their own tokeniser.
+	 * Returns an empty pointer if the primitive cannot be parsed this way,
+	 * the caller will then pass the same tokens to parse() on the main thread.
+	 * The default implementation is not supporting detached parsing at all.
+	 */
+	virtual ParsedPrimitivePtr parseDetached(parser::DefTokeniser& tok) const
+	{
+		return ParsedPrimitivePtr();
+	}
 };
 typedef std::shared_ptr<PrimitiveParser> PrimitiveParserPtr;
 
@@ -121,6 +151,42 @@ public:
 	// Patch export methods
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) = 0;
+
+	/**
+	 * Export methods for the placeholders of a partially loaded map, holding the
+	 * keyvalue lines of an entity or the text of a primitive block (starting at
+	 * its keyword) as it has been read. The unloaded primitives of an unloaded entity are
+	 * written between the begin and end calls.
+	 * Only writers of formats able to read maps partially need to support these,
+	 * the default implementations throw a FailureException.
+	 */
+	virtual void beginWriteUnloadedEntity(const std::string& keyValueText, std::ostream& stream)
+	{
+		throw FailureException("This map format cannot write unloaded entities");
+	}
+
+	virtual void endWriteUnloadedEntity(std::ostream& stream)
+	{
+		throw FailureException("This map format cannot write unloaded entities");
+	}
+
+	virtual void writeUnloadedPrimitive(const std::string& primitiveText, std::ostream& stream)
+	{
+		throw FailureException("This map format cannot write unloaded primitives");
+	}
+
+	/**
+	 * Writers supporting the parallel export return a new, independent instance here,
+	 * which is continuing with the given entity and primitive numbers. It is used on
+	 * a worker thread to write a part of an entity into a separate buffer, only the
+	 * entity and primitive methods are called on it.
+	 * The default implementation returns an empty pointer, the whole map is then
+	 * written by this instance on the calling thread.
+	 */
+	virtual std::shared_ptr<IMapWriter> createParallelWriter(std::size_t entityNum, std::size_t primitiveNum) const
+	{
+		return std::shared_ptr<IMapWriter>();
+	}
 };
 typedef std::shared_ptr<IMapWriter> IMapWriterPtr;
 
@@ -4,7 +4,9 @@
 #include "imodule.h"
 #include "itextstream.h"
 #include "imap.h"
+#include "math/AABB.h"
 
+#include <set>
 #include <sigc++/signal.h>
 
 namespace map 
@@ -29,6 +31,16 @@ public:
 	 */
 	virtual bool load() = 0;
 
+	/**
+	 * Partially loads the resource: only the entities and primitives assigned to
+	 * one of the given layers (according to the info file) are turned into scene
+	 * nodes, together with the worldspawn. Everything else is kept as unparsed text
+	 * in placeholder nodes, which is written back unchanged when saving the resource
+	 * in the same format. Loads the whole map if no layer information is available.
+	 * Returns true on success, will throw an OperationException on failure.
+	 */
+	virtual bool loadLayers(const std::set<int>& layerIds) = 0;
+
 	// Exception type thrown by the the MapResource implementation
 	class OperationException :
 		public std::runtime_error 
@@ -115,6 +127,37 @@ public:
     virtual IMapResourcePtr createFromArchiveFile(const std::string& archivePath, 
         const std::string& filePathWithinArchive) = 0;
 
+    /**
+     * Returns a new scene holding a copy of the prefab at the given VFS or physical
+     * path. The file is parsed once, subsequent calls are cloning the nodes of the
+     * parsed scene as long as the file isn't changing on disk.
+     * Throws IMapResource::OperationException if the prefab cannot be loaded.
+     */
+    virtual scene::IMapRootNodePtr createPrefabCopy(const std::string& path) = 0;
+
+    /**
+     * Returns the bounds of the prefab at the given path, without the volumes of
+     * lights and speakers. The bounds are evaluated from the same cached scene.
+     * Throws IMapResource::OperationException if the prefab cannot be loaded.
+     */
+    virtual AABB getPrefabBounds(const std::string& path) = 0;
+
+    /**
+     * Loads the prefab at the given path into the cache used by createPrefabCopy()
+     * in the background, unless it is cached already. The file is read by a worker
+     * thread, its scene is created on the main thread once the file is in memory.
+     * Failures are logged only, createPrefabCopy() will report them when it is called.
+     */
+    virtual void preloadPrefab(const std::string& path) = 0;
+
+    // Returns true if the prefab at the given path is cached and up to date, such
+    // that createPrefabCopy() doesn't need to read the file
+    virtual bool isPrefabCached(const std::string& path) = 0;
+
+    // Emitted on the main thread when a preloaded prefab has been added to the
+    // cache, the argument is the path as it has been passed to preloadPrefab()
+    virtual sigc::signal<void(const std::string&)>& signal_prefabPreloaded() = 0;
+
 	// Signal emitted when a MapExport is starting / is finished
 	typedef sigc::signal<void, const scene::IMapRootNodePtr&> ExportEvent;
 
@@ -2,6 +2,7 @@
 
 #include "imodule.h"
 
+#include <memory>
 #include <vector>
 #include "math/Vector3.h"
 #include "math/Quaternion.h"
@@ -57,6 +58,10 @@ public:
 	// Each frame has a series of float values, applied to one or more animated components (x, y, z, yaw, pitch, roll)
 	typedef std::vector<float> FrameKeys;
 
+	// The keys of all joints in a single frame
+	typedef std::vector<Key> JointKeys;
+	typedef std::shared_ptr<const JointKeys> JointKeysPtr;
+
 	/**
 	 * Get the number of joints in this animation.
 	 */
@@ -83,9 +88,18 @@ public:
 	virtual std::size_t getNumFrames() const = 0;
 
 	/**
-	 * Returns the float values of the given frame index.
+	 * Returns the float values of the given frame index. The frames are
+	 * stored in compressed form, the values are decoded on every call.
+	 */
+	virtual FrameKeys getFrameKeys(std::size_t index) const = 0;
+
+	/**
+	 * Returns the local keys of all joints in the given frame, which is the
+	 * base frame with the animated components of this frame applied.
+	 * The keys are calculated on first access, the most recently used frames
+	 * are kept in a cache shared by everyone using this animation.
 	 */
-	virtual const FrameKeys& getFrameKeys(std::size_t index) const = 0;
+	virtual JointKeysPtr getFrameJointKeys(std::size_t index) const = 0;
 };
 typedef std::shared_ptr<IMD5Anim> IMD5AnimPtr;
 
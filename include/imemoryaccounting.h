@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "imodule.h"
+
+namespace memory
+{
+
+// One line of a memory usage report
+struct MemoryUsageEntry
+{
+    // The name of the reporter, e.g. "MaterialManager"
+    std::string reporter;
+
+    // What is being counted, e.g. "Textures (video memory)"
+    std::string name;
+
+    // The approximate number of bytes, 0 if only the number of objects is known
+    std::size_t bytes = 0;
+
+    // The number of objects, 0 if not applicable
+    std::size_t count = 0;
+};
+
+// Receives the memory usage figures of a reporter
+class IMemoryReport
+{
+public:
+    virtual ~IMemoryReport() {}
+
+    // Adds an entry to the report, the bytes are an estimate in most cases
+    virtual void addEntry(const std::string& name, std::size_t bytes, std::size_t count = 0) = 0;
+};
+
+/**
+ * Implemented by the subsystems holding noticeable amounts of memory, to let
+ * the user find out where the memory of a session goes. Reporters are registered
+ * in the IMemoryAccounting module and asked for their figures on demand.
+ */
+class IMemoryReporter
+{
+public:
+    virtual ~IMemoryReporter() {}
+
+    // The name shown in front of the reported entries
+    virtual const std::string& getMemoryReporterName() const = 0;
+
+    // Adds the current figures to the given report, invoked on the main thread
+    virtual void reportMemoryUsage(IMemoryReport& report) = 0;
+};
+
+/**
+ * Collects the memory usage figures of all registered reporters. The report
+ * is available through the MemoryReport command, and it is written to the log
+ * in regular intervals if the sampling interval has been set in the registry.
+ */
+class IMemoryAccounting :
+    public RegisterableModule
+{
+public:
+    virtual ~IMemoryAccounting() {}
+
+    // The reporter needs to stay alive until it is unregistered again
+    virtual void registerReporter(IMemoryReporter& reporter) = 0;
+    virtual void unregisterReporter(IMemoryReporter& reporter) = 0;
+
+    // Asks every reporter for its current figures, ordered by reporter name
+    virtual std::vector<MemoryUsageEntry> collectMemoryUsage() = 0;
+
+    // Writes the current figures of all reporters to the log
+    virtual void logMemoryUsage() = 0;
+
+    // Emitted by a timer thread when the next sample is due. Listeners
+    // need to arrange for logMemoryUsage() to be called on the main thread.
+    virtual sigc::signal<void>& signal_sampleDue() = 0;
+};
+
+}
+
+const char* const MODULE_MEMORYACCOUNTING("MemoryAccounting");
+
+inline memory::IMemoryAccounting& GlobalMemoryAccounting()
+{
+    static module::InstanceReference<memory::IMemoryAccounting> _reference(MODULE_MEMORYACCOUNTING);
+    return _reference;
+}
@@ -34,6 +34,14 @@ public:
         _handled = handled;
     }
 
+    // Progress-style messages return true here. Such a message is superseded
+    // by the next one of the same type, the bus is dropping it if the
+    // previous one is still being dispatched to the listeners.
+    virtual bool isCoalescable() const
+    {
+        return false;
+    }
+
 public:
     // Pre-defined message type IDs.
     // Plugin code can define their own IDs in the range of 1000+
@@ -93,6 +101,7 @@ public:
     /**
      * Send the given message to the given channel. The channel ID refers to 
      * a given message type and must have been acquired using getChannelId() beforehand.
+     * Messages can be sent from any thread, the listeners are invoked on the sending thread.
      */
     virtual void sendMessage(IMessage& message) = 0;
 };
@@ -4,10 +4,15 @@
 #include "imodel.h"
 #include "inode.h"
 #include <sigc++/signal.h>
+#include <sigc++/slot.h>
 
 namespace model 
 {
 
+// The memory budget of the model cache in MB. Models not used by any node
+// are evicted from the cache, least recently used first, if it is exceeded (0 = unlimited)
+constexpr const char* const RKEY_MODEL_CACHE_BUDGET = "user/ui/models/cacheBudget";
+
 /** Modelcache interface.
  */
 class IModelCache :
@@ -28,6 +33,49 @@ public:
 	 */
 	virtual scene::INodePtr getModelNode(const std::string& modelPath) = 0;
 
+	// Slot invoked when a model requested by getModelNodeAsync() has been loaded,
+	// the argument is the placeholder node which has been returned by that call
+	using ModelLoadedSlot = sigc::slot<void, const scene::INodePtr&>;
+
+	/**
+	 * Asynchronous variant of getModelNode(). If the model is not cached yet,
+	 * its file is parsed on a worker thread and a NullModel placeholder node is
+	 * returned immediately. Once the model has been loaded, the given slot is
+	 * invoked on the main thread (by processAsyncLoads) and the caller can replace
+	 * the placeholder by requesting the node again, which is now quick to construct.
+	 *
+	 * The slot is only invoked if a placeholder has been returned. If asynchronous
+	 * loading is disabled, this behaves like getModelNode().
+	 */
+	virtual scene::INodePtr getModelNodeAsync(const std::string& modelPath, const ModelLoadedSlot& onLoaded) = 0;
+
+	/**
+	 * Enables or disables asynchronous loading, which is disabled by default.
+	 * It requires someone to call processAsyncLoads() on the main thread
+	 * whenever signal_asyncLoadFinished() is emitted.
+	 */
+	virtual void setAsyncLoadingEnabled(bool enabled) = 0;
+
+	/**
+	 * Sets the point (usually the camera position) the queued background loads
+	 * are prioritised by: the models whose placeholders are closest to it are
+	 * parsed first. The queue is re-ordered whenever the focus changes and
+	 * after each batch of models processed by processAsyncLoads().
+	 */
+	virtual void setAsyncLoadFocus(const Vector3& focus) = 0;
+
+	// Returns true while the given model is being loaded in the background,
+	// i.e. after getModelNodeAsync() returned a placeholder for it.
+	virtual bool isModelLoading(const std::string& modelPath) = 0;
+
+	// Notifies everyone waiting for the models loaded in the background since the last call.
+	// This must be called on the main thread.
+	virtual void processAsyncLoads() = 0;
+
+	// Signal emitted by the worker threads after a model has been loaded in the background.
+	// Listeners need to dispatch the call to processAsyncLoads() to the main thread.
+	virtual sigc::signal<void> signal_asyncLoadFinished() = 0;
+
 	/**
 	 * greebo: Get the IModel object for the given VFS path. The request is cached,
 	 * so calling this with the same path twice will return the same
@@ -46,6 +94,10 @@ public:
 	// This reloads all selected models in the map
 	virtual void refreshSelectedModels(bool blockScreenUpdates = true) = 0;
 
+	// Clears the given model (a VFS path) from the cache and reloads
+	// the models of the entities in the map referencing it
+	virtual void refreshModel(const std::string& modelPath) = 0;
+
 	// Clears a specific model from the cache
 	virtual void removeModel(const std::string& modelPath) = 0;
 
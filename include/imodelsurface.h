@@ -67,6 +67,14 @@ public:
 
 	// Const access to the index array connecting the vertices.
 	virtual const std::vector<unsigned int>& getIndexArray() const = 0;
+
+	// Surfaces returning the same non-zero ID are guaranteed to have identical
+	// vertex and index arrays, the renderer is free to share their geometry.
+	// Returns 0 if the surface geometry is not shareable.
+	virtual std::size_t getGeometryId() const
+	{
+		return 0;
+	}
 };
 
 } // namespace
@@ -14,6 +14,7 @@
 
 #include "itextstream.h"
 #include "ilogwriter.h"
+#include "time/TraceRecorder.h"
 
 /**
  * \defgroup module Module system
@@ -31,7 +32,7 @@
  * As long as no external module/plugin files are removed this number is safe to stay 
  * as it is. Keep this number compatible to std::size_t, i.e. unsigned.
  */
-#define MODULE_COMPATIBILITY_LEVEL 20211014
+#define MODULE_COMPATIBILITY_LEVEL 20261019
 
 // A function taking an error title and an error message string, invoked in debug builds
 // for things like ASSERT_MESSAGE and ERROR_MESSAGE
@@ -191,6 +192,18 @@ public:
         // Empty default implementation
     }
 
+    /**
+     * Modules returning true are initialised on a worker thread as soon as their
+     * dependencies are ready, concurrently with other modules. Such a module must
+     * not touch wx or OpenGL in initialiseModule() and may use only the thread-safe
+     * parts of its dependencies (e.g. no command or signal registration).
+     * By default modules are initialised on the main thread.
+     */
+    virtual bool canInitialiseOnWorkerThread() const
+    {
+        return false;
+    }
+
     // Internally queried by the ModuleRegistry. To protect against leftover
     // binaries containing outdated moudles from being loaded and registered
     // the compatibility level is compared with the one in the ModuleRegistry.
@@ -315,6 +328,19 @@ public:
 	*/
 	virtual sigc::signal<void>& signal_modulesUnloading() = 0;
 
+	/**
+	 * Lock serialising the connections to the registry signals, which might
+	 * be made by modules initialising on worker threads.
+	 */
+	virtual std::mutex& getSignalLock() = 0;
+
+	/**
+	 * The recorder collecting the timeline events of all binaries. It is
+	 * enabled by the --trace=<file> command line option, the events are
+	 * written to that file in the Chrome trace format on shutdown.
+	 */
+	virtual util::TraceRecorder& getTraceRecorder() = 0;
+
 	// The compatibility level this Registry instance was compiled against.
 	// Old module registrations will be rejected by the registry anyway,
 	// on top of that they can actively query this number from the registry
@@ -416,6 +442,9 @@ namespace module
 		{
             auto& registry = GlobalModuleRegistry();
 
+            // Modules might be acquiring their references concurrently during startup
+            std::lock_guard<std::mutex> lock(registry.getSignalLock());
+
             _instancePtr = dynamic_cast<ModuleType*>(registry.getModule(_moduleName).get());
 
             registry.signal_allModulesUninitialised().connect([this]
@@ -481,6 +510,9 @@ namespace module
         // Remember the reference to the ModuleRegistry
         RegistryReference::Instance().setRegistry(registry);
 
+        // Point this binary's scoped trace events to the central recorder
+        util::GlobalTraceRecorderPtr() = &registry.getTraceRecorder();
+
         // Set up the assertion handler
         GlobalErrorHandler() = registry.getApplicationContext().getErrorHandlingFunction();
     }
@@ -68,6 +68,16 @@ public:
         return false;
     }
 
+    // During the active phase, mouse move events arriving faster than the views
+    // are redrawn are combined into a single event carrying the most recent
+    // position (or the sum of the motion deltas), which is sent once the pending
+    // window events have been processed. Tools that need to see every single
+    // motion event can override this method to return false.
+    virtual bool receivesCoalescedMoveEvents()
+    {
+        return true;
+    }
+
     // By default, when the user is dragging the mouse to the borders of
     // the view, the viewport will be moved along. For some tools this might
     // not be desirable, in which case they need to override this method to
@@ -103,6 +103,7 @@ public:
 		Particle,
         EntityConnection,
         MergeAction,
+        UnloadedBlock,
 	};
 
 public:
@@ -25,6 +25,9 @@ public:
     // Draws the given object, sets up transform and submits geometry
     virtual void submitObject(IRenderableObject& object) = 0;
 
+    // Draws the outline of the given object's bounding box instead of its geometry, sets up transform
+    virtual void submitObjectBounds(IRenderableObject& object) = 0;
+
     // Draws the geometry of the given slot in the given primitive mode, no transforms
     virtual void submitGeometry(IGeometryStore::Slot slot, GLenum primitiveMode) = 0;
 
@@ -43,6 +46,11 @@ public:
     // Draws the geometry with a custom set of indices
     virtual void submitGeometryWithCustomIndices(IGeometryStore::Slot slot, GLenum primitiveMode,
         const std::vector<unsigned int>& indices) = 0;
+
+    // Draws a number of vertex ranges of the given slot in a single call, each range forming
+    // a separate primitive. The first vertices are specified relative to the start of the slot.
+    virtual void submitGeometryRanges(IGeometryStore::Slot slot, GLenum primitiveMode,
+        const std::vector<GLint>& firstVertices, const std::vector<GLsizei>& counts) = 0;
 };
 
 }
@@ -23,6 +23,10 @@ namespace scene
 namespace particles
 {
 
+/// Registry keys controlling the level of detail of the particle nodes in the scene
+constexpr const char* const RKEY_ENABLE_PARTICLE_LOD = "user/ui/renderSystem/enableParticleLod";
+constexpr const char* const RKEY_PARTICLE_BUDGET = "user/ui/renderSystem/particleBudget";
+
 // see iparticlestage.h for definition
 class IStageDef;
 
@@ -143,6 +147,32 @@ public:
 };
 typedef std::shared_ptr<IRenderableParticle> IRenderableParticlePtr;
 
+/**
+ * Statistics about the level of detail the particle nodes have been
+ * updated with during the most recent frame.
+ */
+struct ParticleLodStatistics
+{
+    // The number of emitters requesting an update
+    std::size_t numEmitters = 0;
+
+    // Emitters simulating all of their particles
+    std::size_t numFullDetail = 0;
+
+    // Emitters simulating a reduced number of particles
+    std::size_t numReducedDetail = 0;
+
+    // Emitters keeping the geometry of an earlier frame
+    std::size_t numSkippedUpdates = 0;
+
+    // Emitters reduced or skipped since the particle budget has been exhausted
+    std::size_t numBudgetLimited = 0;
+
+    // The number of particles requested and actually simulated
+    std::size_t numParticlesRequested = 0;
+    std::size_t numParticlesSimulated = 0;
+};
+
 /**
  * Callback for evaluation particle defs.
  */
@@ -180,6 +210,15 @@ public:
     /// Create and return a particle node for the named particle system
 	virtual IParticleNodePtr createParticleNode(const std::string& name) = 0;
 
+    /**
+     * Returns the LOD statistics of the particle nodes updated in the most recent
+     * frame. Distant particle nodes are simulating fewer particles at a lower update
+     * rate, the number of particles per frame is limited by the budget defined in
+     * RKEY_PARTICLE_BUDGET (0 is unlimited). Renderable particles which are not
+     * part of a particle node are always updated in full detail.
+     */
+    virtual const ParticleLodStatistics& getLodStatistics() const = 0;
+
 	/**
 	 * Writes the named particle declaration to the file it is associated with,
 	 * replacing any existing declaration with the same name in that file.
@@ -136,7 +136,8 @@ public:
 	// Check whether all control vertices are in the same 3D spot (with minimal tolerance)
 	virtual bool isDegenerate() const = 0;
 
-	// Shader handling
+	// Shader handling. The returned name is interned, patches and faces
+	// using the same material return a reference to the same string.
 	virtual const std::string& getShader() const = 0;
 	virtual void setShader(const std::string& name) = 0;
 
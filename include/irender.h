@@ -6,6 +6,7 @@
 #include "igeometryrenderer.h"
 #include "isurfacerenderer.h"
 #include <functional>
+#include <map>
 
 #include "math/Vector3.h"
 #include "math/Vector4.h"
@@ -190,6 +191,19 @@ public:
      */
     virtual void foreachRenderableTouchingBounds(const AABB& bounds, const ObjectVisitFunction& functor) = 0;
 
+    /**
+     * Returns a counter that is increased every time a renderable object is added
+     * to or removed from this entity, or when one of the objects changes its bounds.
+     * Renderers can compare this value to detect whether anything cached about
+     * this entity's objects needs to be refreshed.
+     */
+    virtual std::size_t getRenderableChangeCount() const = 0;
+
+    /**
+     * The combined world bounds of all renderable objects attached to this entity.
+     */
+    virtual AABB getRenderableBounds() = 0;
+
     // Returns true if this entity produces shadows when lit (i.e.returns false when the entity has "noshadows" set to 1)
     virtual bool isShadowCasting() const = 0;
 };
@@ -534,9 +548,27 @@ public:
     virtual ~IRenderResult() {}
 
     virtual std::string toString() = 0;
+
+    // The GPU time spent on the frame in milliseconds, or 0 if it hasn't been measured.
+    // The time might belong to an earlier frame, the queries are picked up asynchronously.
+    virtual double getGpuMilliseconds()
+    {
+        return 0;
+    }
+
+    // The numerical statistics of this frame (like the number of draw calls) by name,
+    // for tools recording them over a series of frames
+    virtual std::map<std::string, std::size_t> getCounters()
+    {
+        return {};
+    }
 };
 
 constexpr const char* const RKEY_ENABLE_SHADOW_MAPPING = "user/ui/renderSystem/enableShadowMapping";
+constexpr const char* const RKEY_ENABLE_LIGHT_OCCLUSION_CULLING = "user/ui/renderSystem/enableLightOcclusionCulling";
+constexpr const char* const RKEY_ENABLE_PARALLEL_RENDER_COLLECTION = "user/ui/renderSystem/enableParallelCollection";
+constexpr const char* const RKEY_ENABLE_GPU_TIMING = "user/ui/renderSystem/enableGpuTiming";
+constexpr const char* const RKEY_ENABLE_BINDLESS_TEXTURES = "user/ui/renderSystem/enableBindlessTextures";
 
 /**
  * \brief
@@ -628,6 +660,9 @@ public:
     virtual void startFrame() = 0;
     virtual void endFrame() = 0;
 
+    // Returns the number of frames started so far, increased by every startFrame() call
+    virtual std::size_t getFrameCount() const = 0;
+
     /**
      * Render the scene based on the light-entity interactions.
      * All the active lights and entities must have added themselves
@@ -24,6 +24,14 @@ public:
 	 * Instantiates a new rendersystem.
 	 */
 	virtual RenderSystemPtr createRenderSystem() = 0;
+
+	/**
+	 * Returns a render system to be used by a preview widget. The render systems
+	 * released by their previews are kept in a small pool and handed out again,
+	 * such that a new preview can re-use the shaders captured and the geometry
+	 * buffers allocated by the previous ones, instead of starting from scratch.
+	 */
+	virtual RenderSystemPtr acquirePreviewRenderSystem() = 0;
 };
 
 } // namespace
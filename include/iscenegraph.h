@@ -1,10 +1,12 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
 #include "imodule.h"
 #include "inode.h"
 #include "ipath.h"
 #include "imap.h"
+#include "VolumeIntersectionValue.h"
 #include <sigc++/signal.h>
 
 /**
@@ -18,7 +20,12 @@
 // String identifier for the registry module
 const char* const MODULE_SCENEGRAPH("SceneGraph");
 
+// Selects the space partition used by newly rooted scene graphs, either "octree" or "looseOctree"
+const char* const RKEY_SPACE_PARTITION_TYPE("user/ui/scenegraph/spacePartition");
+
 class VolumeTest;
+class Ray;
+class AABB;
 
 namespace scene
 {
@@ -32,6 +39,45 @@ typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 * Each node may refer to zero or more 'child' nodes (directed).
 * A node may never have itself as one of its ancestors (acyclic).
 */
+/**
+ * A read-only copy of the scene graph's node hierarchy, as it has been at
+ * a given epoch of the scene graph (see Graph::getEpoch()).
+ *
+ * Snapshots are immutable and can be traversed by any number of threads
+ * without locking, while the UI thread keeps modifying the scene.
+ *
+ * Reclamation guarantees: a snapshot holds strong references to all the
+ * nodes it contains, so a node removed from the scene stays allocated as long
+ * as any snapshot containing it is alive. The scene graph keeps a reference to
+ * every snapshot it published, and only drops it on the thread calling
+ * Graph::createSnapshot() once no other reference is left. Releasing a snapshot
+ * on a worker thread therefore never destroys scene nodes on that thread.
+ *
+ * Only the structure is captured, not the node state: the nodes themselves
+ * are still shared with the UI thread, reading mutable node properties from
+ * a worker thread needs synchronisation of its own.
+ */
+class IGraphSnapshot
+{
+public:
+    virtual ~IGraphSnapshot() {}
+
+    // The epoch of the scene graph at the time this snapshot was taken
+    virtual std::size_t getEpoch() const = 0;
+
+    // The number of nodes in this snapshot, including the root
+    virtual std::size_t getNodeCount() const = 0;
+
+    // Visits every node depth-first, starting with the root node
+    // Traversal stops as soon as the functor returns false
+    virtual void foreachNode(const INode::VisitorFunc& functor) const = 0;
+
+    // Visits the direct children the given node had when this snapshot was taken
+    // Traversal stops as soon as the functor returns false
+    virtual void foreachChildNode(const INodePtr& parent, const INode::VisitorFunc& functor) const = 0;
+};
+typedef std::shared_ptr<const IGraphSnapshot> IGraphSnapshotPtr;
+
 class Graph
 {
 public:
@@ -47,6 +93,13 @@ public:
 		// Gets called when anything in the scenegraph changes
 		virtual void onSceneGraphChange() {}
 
+		// Gets called when the geometry of some nodes changed within the given bounds,
+		// while nothing else in the scene changed. Treated like any other change by default.
+		virtual void onSceneBoundsDamaged(const AABB& damagedBounds)
+		{
+			onSceneGraphChange();
+		}
+
 		// Gets called when a new <node> is inserted into the scenegraph
 		virtual void onSceneNodeInsert(const INodePtr& node) {}
 
@@ -81,8 +134,22 @@ public:
 	/// \todo Move to a separate class.
 	virtual void boundsChanged() = 0;
 
-	// A specific node has changed its bounds
-	virtual void nodeBoundsChanged(const scene::INodePtr& node) = 0;
+	// A specific node has changed its bounds. The damaged bounds are covering
+	// the previous and the current geometry of the node itself (without its children).
+	virtual void nodeBoundsChanged(const scene::INodePtr& node, const AABB& damagedBounds) = 0;
+
+	// Passes the bounds damaged by the nodes changing their bounds since the last call
+	// to the scene observers (see Observer::onSceneBoundsDamaged). Nodes with pending
+	// bounds changes are evaluated first. Views call this before deciding whether to redraw.
+	virtual void notifyDamagedBounds() = 0;
+
+	// Start a batch of scene changes. Until the matching endBatchUpdate() call, sceneChanged()
+	// and boundsChanged() don't notify anybody, the observers are notified once when the
+	// outermost batch ends. Use the GraphBatchUpdate class to ensure the batch is ended.
+	virtual void beginBatchUpdate() = 0;
+
+	// End a batch started by beginBatchUpdate() and send the pending notifications
+	virtual void endBatchUpdate() = 0;
 
 	// A walker class to be used in "foreachNodeInVolume"
 	class Walker
@@ -112,12 +179,101 @@ public:
 	// Same as above, but culls any hidden nodes
 	virtual void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) = 0;
 
+	/**
+	 * Same as foreachVisibleNodeInVolume, but the space partition is traversed by
+	 * worker threads, one for each child of the root partition node. The functor is
+	 * invoked on the calling thread once all workers are done, in the same order
+	 * as the sequential traversal would visit the nodes.
+	 */
+	virtual void foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, const INode::VisitorFunc& functor) = 0;
+
+	// Visitor used by foreachVisibleNodeAlongRay, see ISpacePartitionSystem::RayVisitor
+	typedef std::function<void(const INodePtr& node, double& maxDistance)> RayVisitor;
+
+	/**
+	 * Visits the visible scene nodes whose space partition cells are hit by the given ray,
+	 * front to back, using ISpacePartitionSystem::foreachNodeAlongRay(). The visitor is
+	 * responsible for testing the nodes against the ray, and can reduce the maximum
+	 * distance to stop the traversal early once the nearest hit has been found.
+	 */
+	virtual void foreachVisibleNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) = 0;
+
+	// Visitor used by foreachNodeByBounds, receiving each node and its intersection with the bounds
+	typedef std::function<void(const INodePtr& node, VolumeIntersectionValue intersection)> BoundsVisitor;
+
+	/**
+	 * Classifies the scene nodes against the given bounds, whole space partition cells
+	 * at a time. The members of cells outside the bounds are passed as VOLUME_OUTSIDE
+	 * without testing them, only the members of cells straddling the bounds are tested
+	 * one by one. Cells entirely inside the bounds are skipped, unless visitContained
+	 * is set, their members are then passed as VOLUME_INSIDE. Visits hidden nodes too.
+	 */
+	virtual void foreachNodeByBounds(const AABB& bounds, const BoundsVisitor& visitor, bool visitContained) = 0;
+
 	// Returns the associated spacepartition
 	virtual ISpacePartitionSystemPtr getSpacePartition() = 0;
+
+	// Cumulative figures about the volume traversals answered through the space partition
+	struct SpacePartitionQueryStatistics
+	{
+		// The number of foreach[Visible]NodeInVolume[Parallel]() calls
+		std::size_t numQueries = 0;
+
+		// The number of space partition nodes entered by these calls
+		std::size_t numVisitedNodes = 0;
+	};
+
+	/**
+	 * Returns the query figures accumulated since the scene graph has been created.
+	 * Clients interested in the figures of a certain period (e.g. a frame) need to
+	 * take the difference of two samples.
+	 */
+	virtual SpacePartitionQueryStatistics getSpacePartitionQueryStatistics() const = 0;
+
+	// The epoch of the node hierarchy, increased each time a node is inserted or erased
+	// or when the root node is changed. Can be queried from any thread.
+	virtual std::size_t getEpoch() const = 0;
+
+	/**
+	 * Publishes a snapshot of the current node hierarchy and returns it. The previous
+	 * snapshot is re-used if the epoch didn't change since then. This needs to be called
+	 * from the thread modifying the scene (the UI thread); snapshots no longer used by any
+	 * other thread are released here. Returns an empty pointer if there is no root node.
+	 */
+	virtual IGraphSnapshotPtr createSnapshot() = 0;
+
+	/**
+	 * Returns the snapshot most recently published by createSnapshot(), without taking
+	 * any locks. Can be called from any thread, the returned snapshot might be older than
+	 * the current epoch, or empty if no snapshot has been published yet.
+	 */
+	virtual IGraphSnapshotPtr getLatestSnapshot() const = 0;
 };
 typedef std::shared_ptr<Graph> GraphPtr;
 typedef std::weak_ptr<Graph> GraphWeakPtr;
 
+// Scoped batch of scene changes on the given graph, see Graph::beginBatchUpdate()
+class GraphBatchUpdate
+{
+private:
+    Graph& _graph;
+
+public:
+    GraphBatchUpdate(Graph& graph) :
+        _graph(graph)
+    {
+        _graph.beginBatchUpdate();
+    }
+
+    GraphBatchUpdate(const GraphBatchUpdate& other) = delete;
+    GraphBatchUpdate& operator=(const GraphBatchUpdate& other) = delete;
+
+    ~GraphBatchUpdate()
+    {
+        _graph.endBatchUpdate();
+    }
+};
+
 class Cloneable
 {
 public:
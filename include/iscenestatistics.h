@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <sigc++/signal.h>
+#include "imodule.h"
+#include "inode.h"
+
+namespace scene
+{
+
+// The occurrences of a single model in the scene
+struct ModelUsage
+{
+    typedef std::map<std::string, std::size_t> SkinCountMap;
+
+    std::size_t count = 0;
+    std::size_t polyCount = 0;
+
+    // Skin name => number of occurrences, only filled in for skinnable models.
+    // Unskinned occurrences are listed with an empty skin name.
+    SkinCountMap skinCount;
+};
+
+/**
+ * Maintains the statistics shown in the map info dialog, i.e. the entity class,
+ * material, model and layer usage breakdowns of the current scene. The figures
+ * are updated incrementally when nodes are inserted into or removed from the
+ * scene, nodes changing their materials, skins or layers while being in the
+ * scene are queueing an update of their own contribution.
+ *
+ * Entries dropping to a count of zero are removed from the maps.
+ * All methods need to be called from the main thread.
+ */
+class ISceneStatistics :
+    public RegisterableModule
+{
+public:
+    // The index into the material count arrays
+    enum MaterialOwner
+    {
+        Face = 0,
+        Patch = 1,
+        Model = 2,
+        Particle = 3,
+    };
+
+    typedef std::map<std::string, std::size_t> EntityClassCounts;
+    typedef std::map<std::string, std::array<std::size_t, 4>> MaterialCounts;
+    typedef std::map<std::string, ModelUsage> ModelCounts;
+
+    // Layer ID => number of entities and primitives in that layer
+    typedef std::map<int, std::size_t> LayerCounts;
+
+    virtual ~ISceneStatistics() {}
+
+    // Entity class name => number of entities
+    virtual const EntityClassCounts& getEntityClassCounts() = 0;
+
+    // Material name => number of faces, patches, models and particles using it.
+    // A model or particle is counted once per material, no matter how many
+    // of its surfaces or stages are using it.
+    virtual const MaterialCounts& getMaterialCounts() = 0;
+
+    // Model path => occurrences of that model
+    virtual const ModelCounts& getModelCounts() = 0;
+
+    // The number of entities and primitives assigned to each layer,
+    // hidden nodes are included
+    virtual const LayerCounts& getLayerCounts() = 0;
+
+    /**
+     * Called by nodes in the scene when their contribution to the statistics
+     * changed (e.g. a material or skin has been assigned). The node is evaluated
+     * again the next time the figures are requested.
+     */
+    virtual void queueUpdate(const INodePtr& node) = 0;
+
+    // Emitted when the figures have changed, or a node has queued an update
+    virtual sigc::signal<void>& signal_statisticsChanged() = 0;
+};
+
+}
+
+const char* const MODULE_SCENESTATISTICS("SceneStatistics");
+
+inline scene::ISceneStatistics& GlobalSceneStatistics()
+{
+    static module::InstanceReference<scene::ISceneStatistics> _reference(MODULE_SCENESTATISTICS);
+    return _reference;
+}
@@ -243,12 +243,19 @@ public:
 
     // Returns the volume the focus items are occupying
     virtual AABB getSelectionFocusBounds() = 0;
+
+    // Returns the combined bounds of all selected nodes (components are not considered).
+    // If considerLightVolumes is false, lights contribute their small selection box only.
+    virtual AABB getSelectionBounds(bool considerLightVolumes) = 0;
 };
 
 }
 
 constexpr const char* const MODULE_SELECTIONSYSTEM("SelectionSystem");
 
+// Enables testing the scene nodes on multiple threads when selecting
+constexpr const char* const RKEY_ENABLE_PARALLEL_SELECTION_TEST = "user/ui/selection/enableParallelTesting";
+
 inline selection::SelectionSystem& GlobalSelectionSystem()
 {
 	static module::InstanceReference<selection::SelectionSystem> _reference(MODULE_SELECTIONSYSTEM);
@@ -234,6 +234,10 @@ public:
   virtual void TestTriangles(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
   virtual void TestQuads(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
   virtual void TestQuadStrip(const VertexPointer& vertices, const IndexPointer& indices, SelectionIntersection& best) = 0;
+
+  // Returns an independent copy of this test, to be used by a different thread.
+  // Tests that can't be copied return an empty pointer.
+  virtual std::shared_ptr<SelectionTest> clone() const { return std::shared_ptr<SelectionTest>(); }
 };
 typedef std::shared_ptr<SelectionTest> SelectionTestPtr;
 
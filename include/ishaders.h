@@ -9,6 +9,7 @@
 #include "math/Vector3.h"
 #include "math/Vector4.h"
 
+#include <chrono>
 #include <ostream>
 #include <vector>
 
@@ -645,6 +646,76 @@ public:
 
     // Reload the textures used by the active shaders
     virtual void reloadImages() = 0;
+
+    // Reload the textures of the active shaders reading the given image file (a VFS path
+    // like "textures/base/stone.tga"), the textures of all other shaders stay untouched
+    virtual void reloadImage(const std::string& vfsPath) = 0;
+
+    /**
+     * Enables the background decoding of the images used by the material
+     * layers. The layers are rendered using the default interaction textures
+     * until their image has been uploaded by processAsyncTextureLoads().
+     * Disabled by default.
+     */
+    virtual void setAsyncTextureLoadingEnabled(bool enabled) = 0;
+
+    /**
+     * Uploads the images decoded in the background until the given time budget
+     * is used up, and notifies the materials using them. Requires a current
+     * GL context, the render system is calling this at the start of each frame.
+     */
+    virtual void processAsyncTextureLoads(std::chrono::milliseconds budget) = 0;
+
+    // Emitted when images are waiting to be uploaded, possibly by a worker thread.
+    // Listeners need to arrange for a new frame to be rendered on the main thread.
+    virtual sigc::signal<void> signal_asyncTextureLoadFinished() = 0;
+
+    /**
+     * Prepares the named materials ahead of their first use. The materials are
+     * constructed from their declarations, and if background texture loading is
+     * enabled, their editor images and layer images are queued for decoding.
+     * Names without a material declaration are skipped.
+     */
+    virtual void preloadMaterials(const std::vector<std::string>& names) = 0;
+
+    /**
+     * Updates the texture residency with the GL texture numbers drawn since
+     * the previous call. If the texture memory budget is exceeded, textures
+     * which have not been drawn recently are demoted to lower mipmap levels,
+     * demoted textures are restored once they are drawn again. Requires a
+     * current GL context, the render system is calling this at the end of each frame.
+     */
+    virtual void updateTextureResidency(const std::vector<GLuint>& drawnTextures) = 0;
+
+    // The maximum width and height of the editor image thumbnails
+    static constexpr std::size_t THUMBNAIL_SIZE = 128;
+
+    /// A downsampled copy of a material's editor image, as shown by the texture browsers
+    struct EditorImageThumbnail
+    {
+        // RGBA image fitting into a square of THUMBNAIL_SIZE pixels. Empty if the
+        // editor image cannot be downsampled (e.g. precompressed images), the
+        // full editor image needs to be used in this case.
+        ImagePtr image;
+
+        // The dimensions of the full-size editor image, 0 if it couldn't be loaded
+        std::size_t width = 0;
+        std::size_t height = 0;
+    };
+    using EditorImageThumbnailPtr = std::shared_ptr<EditorImageThumbnail>;
+
+    /**
+     * Returns the thumbnail of the named material's editor image. Thumbnails are
+     * generated by worker threads, or loaded from the on-disk thumbnail cache,
+     * and an empty pointer is returned until the thumbnail is ready. A ready
+     * thumbnail is handed out only once, it's the caller's responsibility to
+     * keep it. The most recently requested thumbnails are generated first.
+     */
+    virtual EditorImageThumbnailPtr getEditorImageThumbnail(const std::string& materialName) = 0;
+
+    // Emitted by the worker threads when a thumbnail is ready. Listeners need to
+    // arrange for getEditorImageThumbnail() to be called on the main thread.
+    virtual sigc::signal<void> signal_editorImageThumbnailReady() = 0;
 };
 
 inline IMaterialManager& GlobalMaterialManager()
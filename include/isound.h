@@ -76,6 +76,20 @@ public:
 	virtual const std::string& getDisplayFolder() = 0;
 };
 
+/// Header information about a sound file, as stored in the sound file index
+struct SoundFileInfo
+{
+    /// The VFS path of the file that has actually been found, which might
+    /// have a different extension than the one referenced by the shader
+    std::string resolvedPath;
+
+    /// The duration in seconds
+    float duration = 0;
+
+    unsigned int sampleRate = 0;
+    unsigned int numChannels = 0;
+};
+
 constexpr const char* const MODULE_SOUNDMANAGER("SoundManager");
 
 /// Sound manager interface.
@@ -116,6 +130,16 @@ public:
     // Will throw a std::out_of_range exception if the path cannot be resolved
     virtual float getSoundFileDuration(const std::string& vfsPath) = 0;
 
+    /**
+     * Looks up the given sound file in the index, which is built in the background
+     * after the sound shaders have been loaded and covers all the files referenced
+     * by them. The index is persisted between sessions, lookups don't touch the VFS.
+     *
+     * @returns: TRUE and fills in the info if the file is indexed, FALSE if the
+     * file could not be resolved or has not been indexed yet.
+     */
+    virtual bool findIndexedSoundFile(const std::string& vfsPath, SoundFileInfo& info) = 0;
+
     // Reloads all sound shader definitions from the VFS
     virtual void reloadSounds() = 0;
 };
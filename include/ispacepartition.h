@@ -3,10 +3,12 @@
 
 #include <list>
 #include <vector>
+#include <functional>
 #include "imodule.h"
 
 // Forward declaration
 class AABB;
+class Ray;
 
 namespace scene
 {
@@ -43,8 +45,8 @@ public:
 	// The child nodes
 	typedef std::vector<ISPNodePtr> NodeList;
 
-	// The members
-	typedef std::list<INodePtr> MemberList;
+	// The members, in no particular order
+	typedef std::vector<INodePtr> MemberList;
 
 	// Get the parent node (can be NULL for the root node)
 	virtual ISPNodePtr getParent() const = 0;
@@ -90,6 +92,21 @@ public:
 
 	// Returns the root node of this SP tree (the largest one, encompassing everything)
 	virtual ISPNodePtr getRoot() const = 0;
+
+	/**
+	 * Visitor used by foreachNodeAlongRay(). The second argument is the maximum distance
+	 * along the ray that is still of interest. After finding a hit the visitor can reduce
+	 * it, SP nodes entered by the ray beyond that distance are not traversed anymore.
+	 */
+	typedef std::function<void(const scene::INodePtr& member, double& maxDistance)> RayVisitor;
+
+	/**
+	 * Visits the members of all SP nodes hit by the given ray, front to back, ordered by
+	 * the distance at which the ray enters the SP node (in multiples of the ray direction).
+	 * SP nodes entered beyond maxDistance are skipped. The members themselves are visited
+	 * in no particular order and are not tested against the ray, this is up to the visitor.
+	 */
+	virtual void foreachNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) const = 0;
 };
 typedef std::shared_ptr<ISpacePartitionSystem> ISpacePartitionSystemPtr;
 
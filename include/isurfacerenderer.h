@@ -31,6 +31,14 @@ public:
 
     // Returns the indices to render the triangle primitives
     virtual const std::vector<unsigned int>& getIndices() = 0;
+
+    // Surfaces with the same non-zero geometry ID have identical vertices and indices
+    // and will share their storage in the renderer. The ID of a surface is not
+    // allowed to change while it is attached to a surface renderer.
+    virtual std::size_t getGeometryId()
+    {
+        return 0;
+    }
 };
 
 /**
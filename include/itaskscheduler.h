@@ -0,0 +1,109 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <sigc++/signal.h>
+#include "imodule.h"
+
+namespace threading
+{
+
+// Pending tasks of a higher priority are started first
+enum class TaskPriority
+{
+    High,       // e.g. loads the user is waiting for
+    Normal,
+    Low,        // background work like tree population or preloading
+};
+
+/**
+ * Handle to a task submitted to the ITaskScheduler. The task stays alive
+ * until it has been processed, even if all handles are released.
+ */
+class ITask
+{
+public:
+    virtual ~ITask() {}
+
+    // True if the task function has returned (or thrown), or if the task
+    // has been cancelled before it got the chance to run
+    virtual bool isFinished() const = 0;
+
+    // Blocks until the task is finished and re-throws any exception it threw.
+    // If the task has not been started yet, it is run on the calling thread.
+    virtual void wait() = 0;
+
+    // Requests the cancellation of this task. A task that has not been
+    // started yet is not run at all, a running task can check
+    // isCancellationRequested() to exit early.
+    virtual void cancel() = 0;
+
+    virtual bool isCancellationRequested() const = 0;
+};
+using TaskPtr = std::shared_ptr<ITask>;
+
+/**
+ * Thread pool shared by all subsystems running work in parallel, such that
+ * concurrent features don't start more threads than there are cores.
+ *
+ * The workers have a queue each, and tasks submitted from a worker thread go
+ * to that worker's own queue. Idle workers take pending tasks from the others.
+ *
+ * Waiting for a task or for a parallelFor() from within a task is allowed,
+ * the waiting thread is running the awaited work itself if nobody started it yet.
+ */
+class ITaskScheduler :
+    public RegisterableModule
+{
+public:
+    using TaskFunction = std::function<void()>;
+
+    // A task function that is able to check whether it has been cancelled
+    using CancellableTaskFunction = std::function<void(const ITask& task)>;
+
+    virtual ~ITaskScheduler() {}
+
+    // The number of worker threads in this pool
+    virtual std::size_t getNumWorkers() const = 0;
+
+    // Queues the given function to be run by one of the workers
+    virtual TaskPtr submit(const CancellableTaskFunction& function, TaskPriority priority = TaskPriority::Normal) = 0;
+
+    TaskPtr submit(const TaskFunction& function, TaskPriority priority = TaskPriority::Normal)
+    {
+        return submit(CancellableTaskFunction([function](const ITask&) { function(); }), priority);
+    }
+
+    // Queues the given function to be run by one of the workers. After it
+    // has finished, the continuation is queued for the main thread.
+    // The continuation is not invoked if the task threw or has been cancelled.
+    virtual TaskPtr submitWithContinuation(const CancellableTaskFunction& function,
+        const TaskFunction& mainThreadContinuation, TaskPriority priority = TaskPriority::Normal) = 0;
+
+    // Invokes the given function for each index in [0..count), using the workers
+    // as well as the calling thread. Blocks until all indices have been processed,
+    // the first exception thrown by the function is re-thrown afterwards.
+    virtual void parallelFor(std::size_t count, const std::function<void(std::size_t)>& function,
+        TaskPriority priority = TaskPriority::Normal) = 0;
+
+    // Queues the given function to be invoked by processMainThreadTasks()
+    // Can be called from any thread.
+    virtual void postToMainThread(const TaskFunction& function) = 0;
+
+    // Invokes the functions queued for the main thread, in the order they were posted
+    virtual void processMainThreadTasks() = 0;
+
+    // Emitted (on the posting thread) when a function has been queued for the main
+    // thread. The UI needs to arrange for processMainThreadTasks() to be called.
+    virtual sigc::signal<void>& signal_mainThreadTasksPending() = 0;
+};
+
+}
+
+const char* const MODULE_TASKSCHEDULER("TaskScheduler");
+
+inline threading::ITaskScheduler& GlobalTaskScheduler()
+{
+    static module::InstanceReference<threading::ITaskScheduler> _reference(MODULE_TASKSCHEDULER);
+    return _reference;
+}
@@ -8,6 +8,9 @@
 #include "iselectable.h"
 #include "imanipulator.h"
 #include "editable.h"
+#include "math/Vector2.h"
+#include <functional>
+#include <vector>
 #include <sigc++/signal.h>
 
 class Matrix3;
@@ -78,6 +81,9 @@ public:
     // If this node has selected components, this selects all related items too
     // E.g. a single winding vertex expands to the entire winding
     virtual void expandComponentSelectionToRelated() = 0;
+
+    // Invokes the functor for each component vertex, passing its UV coords and selection state
+    virtual void foreachComponentVertex(const std::function<void(const Vector2&, bool)>& functor) const = 0;
 };
 
 // A Texture Tool node that allows its components to be transformed
@@ -109,6 +115,10 @@ public:
     // Renders this node, with all coords relative to UV space origin
     virtual void render(SelectionMode mode) = 0;
 
+    // Appends the UV coords of this node's surface to the given array, three per triangle.
+    // Used by the texture tool to draw all nodes in a few batched calls.
+    virtual void getSurfaceTriangles(std::vector<Vector2>& triangles) const = 0;
+
     // If this node is selected, this selects all related items too:
     // a single face expands to all faces of the same brush
     virtual void expandSelectionToRelated() = 0;
@@ -170,6 +180,10 @@ public:
     // Iterate over every node in this graph calling the given functor
     // Collection should not be modified during iteration
     virtual void foreachNode(const std::function<bool(const INode::Ptr&)>& functor) = 0;
+
+    // Iterate over the nodes whose texture coordinate bounds are intersecting the given volume,
+    // in the same order as foreachNode(). Collection should not be modified during iteration
+    virtual void foreachNodeInVolume(const VolumeTest& volume, const std::function<bool(const INode::Ptr&)>& functor) = 0;
 };
 
 class ITextureToolSelectionSystem :
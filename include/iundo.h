@@ -6,7 +6,10 @@
 #include "imodule.h"
 #include "imap.h"
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 #include <sigc++/signal.h>
 
 /** 
@@ -18,6 +21,19 @@ class IUndoMemento
 {
 public:
     virtual ~IUndoMemento() {}
+
+    // Returns the approximate number of bytes occupied by this memento,
+    // used by the undo system to keep the history within its memory budget.
+    virtual std::size_t getMemoryUsage() const
+    {
+        return sizeof(*this);
+    }
+
+    // Invoked by a worker thread for states deep down in the undo history.
+    // Mementos may choose to move their data into a compressed form, which
+    // needs to stay safe to use concurrently to this call.
+    virtual void compressData()
+    {}
 };
 typedef std::shared_ptr<IUndoMemento> IUndoMementoPtr;
 
@@ -63,6 +79,49 @@ public:
     virtual IUndoSystem& getUndoSystem() = 0;
 };
 
+/**
+ * Memory and timing figures of an undo system, to help choosing the undo settings.
+ * The timings are accumulated since the undo system has been created.
+ */
+struct UndoSystemStatistics
+{
+    struct Operation
+    {
+        std::string name;
+        std::size_t numStates = 0;
+        std::size_t memoryUsage = 0; // approximate, in bytes
+    };
+
+    // The figures of all undoables of the same type
+    struct UndoableType
+    {
+        // The states currently held by the undo and redo operations
+        std::size_t numStates = 0;
+        std::size_t memoryUsage = 0;
+
+        // Calls to exportState() and importState() and the time spent in them
+        std::size_t numExports = 0;
+        double exportMilliseconds = 0;
+        std::size_t numImports = 0;
+        double importMilliseconds = 0;
+    };
+
+    // The recorded operations, ordered from oldest to most recent
+    std::vector<Operation> undoOperations;
+    std::vector<Operation> redoOperations;
+
+    // Figures per undoable type, keyed by the (demangled) class name
+    std::map<std::string, UndoableType> undoableTypes;
+
+    // The number of undo and redo steps and their duration
+    std::size_t numUndos = 0;
+    double undoMilliseconds = 0;
+    double maxUndoMilliseconds = 0;
+    std::size_t numRedos = 0;
+    double redoMilliseconds = 0;
+    double maxRedoMilliseconds = 0;
+};
+
 class IUndoSystem
 {
 public:
@@ -86,6 +145,10 @@ public:
 	// it immediately from the stack, therefore it never existed.
 	virtual void cancel() = 0;
 
+    // Collects the memory usage of the recorded operations and the timings of
+    // the undoables exporting and importing their states
+    virtual UndoSystemStatistics getStatistics() const = 0;
+
     enum class EventType
     {
         OperationRecorded,
@@ -29,6 +29,7 @@ typedef BasicVector3<double> Vector3;
 class Plane3;
 class Matrix4;
 class AABB;
+class AABBBatch;
 class Segment;
 
 class VolumeTest
@@ -49,6 +50,8 @@ public:
   virtual VolumeIntersectionValue TestAABB(const AABB& aabb) const = 0;
   /// \brief Returns the intersection of \p aabb transformed by \p localToWorld and volume.
   virtual VolumeIntersectionValue TestAABB(const AABB& aabb, const Matrix4& localToWorld) const = 0;
+  /// \brief Writes the intersection of each box in \p batch and volume to \p results.
+  virtual void TestAABBs(const AABBBatch& batch, VolumeIntersectionValue* results) const = 0;
 
   virtual bool fill() const = 0;
 
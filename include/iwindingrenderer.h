@@ -6,6 +6,7 @@
 #include "render/RenderVertex.h"
 
 class IRenderEntity;
+class OpenGLRenderable;
 
 namespace render
 {
@@ -51,6 +52,15 @@ public:
 
     // Submits a single winding to GL
     virtual void renderWinding(RenderMode mode, Slot slot) = 0;
+
+    // Adds the winding to the batch of highlighted windings identified by the given key
+    // (usually the highlight flags the winding is submitted with). A batch renders all its
+    // windings in polygon mode, using a single draw call per winding size, directly from
+    // the vertex data that has been allocated through addWinding().
+    // Batches are emptied at the start of every frame. Returns the renderable drawing
+    // the batch if this is the first winding added to it in the current frame, the caller
+    // is expected to submit it once. Returns nullptr for any subsequent winding.
+    virtual const OpenGLRenderable* addHighlightedWinding(Slot slot, std::size_t batchKey) = 0;
 };
 
 }
@@ -1,10 +1,10 @@
-#version 130
+#version 140
 
 uniform sampler2D u_LightProjectionTexture; // light projection texture
 uniform sampler2D u_LightFallOffTexture;    // light falloff texture
-uniform vec4 u_BlendColour;                 // light colour
 
 varying vec4 var_tex_atten_xy_z;
+flat in vec4 var_BlendColour;               // light colour
 
 void main()
 {
@@ -25,6 +25,6 @@ void main()
 
     vec4 attenuation_z	= texture2D(u_LightFallOffTexture, vec2(var_tex_atten_xy_z.z, 0.5));
     
-    gl_FragColor = u_BlendColour * attenuation_xy * attenuation_z;
+    gl_FragColor = var_BlendColour * attenuation_xy * attenuation_z;
 }
 
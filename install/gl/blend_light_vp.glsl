@@ -1,19 +1,35 @@
-#version 130
+#version 140
+
+// Must match BlendLightProgram::MaxBatchedLights
+#define MAX_BATCHED_LIGHTS 64
 
 in vec4 attr_Position;  // bound to attribute 0 in source, in object space
 
 uniform mat4 u_ModelViewProjection; // combined modelview and projection matrix
 uniform mat4 u_ObjectTransform;     // object transform (object2world)
-uniform mat4 u_LightTextureMatrix;  // light texture transform (world-to-light-UV)
+
+// Parameters of a single light, one per instance
+struct LightParameters
+{
+    mat4 lightTextureMatrix;        // light texture transform (world-to-light-UV)
+    vec4 blendColour;               // light colour
+};
+
+layout(std140) uniform LightParameterBlock
+{
+    LightParameters u_Lights[MAX_BATCHED_LIGHTS];
+};
 
 varying vec4 var_tex_atten_xy_z;
+flat out vec4 var_BlendColour;
 
 void main()
 {
     vec4 worldVertex = u_ObjectTransform * attr_Position;
 
     // calc light xy,z attenuation in light space
-    var_tex_atten_xy_z = u_LightTextureMatrix * worldVertex;
+    var_tex_atten_xy_z = u_Lights[gl_InstanceID].lightTextureMatrix * worldVertex;
+    var_BlendColour = u_Lights[gl_InstanceID].blendColour;
 
     // Apply the supplied object transform to the incoming vertex
     // transform vertex position into homogenous clip-space
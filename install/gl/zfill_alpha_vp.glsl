@@ -6,6 +6,12 @@ in vec4 attr_TexCoord; // bound to attribute 8 in source
 uniform mat4 u_ModelViewProjection; // combined modelview and projection matrix
 uniform mat4 u_ObjectTransform; // object transform (object2world)
 
+// Object transforms of instanced draw calls, indexed by gl_InstanceID
+// The array size needs to match DepthFillAlphaProgram::MaxInstances
+const int MAX_INSTANCES = 32;
+uniform mat4 u_InstanceTransforms[MAX_INSTANCES];
+uniform bool u_UseInstanceTransforms;
+
 // The two top-rows of the diffuse stage texture transformation matrix
 uniform vec4 u_DiffuseTextureMatrix[2];
 
@@ -16,7 +22,9 @@ void main()
 {
     // Apply the supplied object transform to the incoming vertex
     // transform vertex position into homogenous clip-space
-    gl_Position = u_ModelViewProjection * u_ObjectTransform * attr_Position;
+    mat4 objectTransform = u_UseInstanceTransforms ? u_InstanceTransforms[gl_InstanceID] : u_ObjectTransform;
+
+    gl_Position = u_ModelViewProjection * objectTransform * attr_Position;
 
     // Apply the stage texture transform to the incoming tex coord, component wise
     var_TexDiffuse.x = dot(u_DiffuseTextureMatrix[0], attr_TexCoord);
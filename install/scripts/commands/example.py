@@ -2,6 +2,11 @@
 __commandName__ = 'Example' # should not contain spaces
 __commandDisplayName__ = 'Nice display name for the menus' # should not contain spaces
 
+# Optional: run the command on a worker thread, such that the editor stays responsive.
+# The calls to the Global* objects are then passed to the main thread, where visitors are
+# invoked as well. Other functions can be passed there through runOnMainThread(function, *args).
+# __commandRunsInBackground__ = True
+
 # The actual algorithm called by DarkRadiant is contained in the execute() function
 def execute():
 	shader = GlobalShaderSystem.getShaderForName('bc_rat')
@@ -174,6 +174,22 @@ class Walker(dr.SelectionVisitor) :
 visitor = Walker()
 GlobalSelectionSystem.foreachSelected(visitor)
 
+# Query all brushes and entities of the map at once
+brushes = GlobalSceneGraph.findNodes(GlobalSceneGraph.root(), 'brush')
+print('{0} brushes'.format(len(brushes)))
+
+# The arrays support the buffer protocol, numpy.asarray(planes) wraps them without copying
+planes = memoryview(brushes.getFacePlanes())
+print('{0} face planes'.format(planes.shape[0]))
+
+entities = GlobalSceneGraph.findNodes(GlobalSceneGraph.root(), 'entity')
+print(entities.getKeyValues('classname'))
+print(memoryview(entities.getOrigins()).tolist())
+
+# The selected entities as list, the setters are creating a single undo operation
+selectedNodes = GlobalSelectionSystem.getSelectedNodes()
+selectedNodes.setKeyValues('name', ['script_renamed_{0}'.format(i) for i in range(len(selectedNodes))])
+
 # Visit every selected face
 class FaceVisitor(dr.SelectedFaceVisitor) :
 	def visitFace(self, face):
@@ -18,15 +18,25 @@ class BasicTexture2D
    // Texture name
    std::string _name;
 
+    // The bindless handle, created on demand
+    GLuint64 _bindlessHandle;
+
+    // True while the mipmap levels are still being uploaded
+    bool _levelsPending;
+
 public:
 
 	// Constructor
 	BasicTexture2D(GLuint texNum = 0, const std::string& name = "")
    : texture_number(texNum),
-     _name(name)
+     _name(name),
+     _bindlessHandle(0),
+     _levelsPending(false)
 	{}
 
 	~BasicTexture2D() {
+        releaseBindlessHandle();
+
 		if (texture_number != 0) {
 			// Remove this texture from openGL if it's still loaded
 			glDeleteTextures(1, &texture_number);
@@ -39,6 +49,7 @@ public:
      */
     void setGLTexNum(GLuint texnum)
     {
+        releaseBindlessHandle();
         texture_number = texnum;
     }
 
@@ -60,6 +71,21 @@ public:
         _height = height;
     }
 
+    /**
+     * \brief
+     * Mark the texture as being uploaded level by level. No bindless handle
+     * is created until it is complete, since that is freezing its state.
+     */
+    void setLevelsPending(bool pending)
+    {
+        _levelsPending = pending;
+    }
+
+    bool hasLevelsPending() const
+    {
+        return _levelsPending;
+    }
+
     /* Texture interface */
     std::string getName() const
     {
@@ -78,6 +104,32 @@ public:
         return _height;
     }
 
+    GLuint64 getBindlessHandle() override
+    {
+        if (_bindlessHandle == 0 && texture_number != 0 && !_levelsPending && GLEW_ARB_bindless_texture)
+        {
+            _bindlessHandle = glGetTextureHandleARB(texture_number);
+
+            if (_bindlessHandle != 0)
+            {
+                glMakeTextureHandleResidentARB(_bindlessHandle);
+            }
+        }
+
+        return _bindlessHandle;
+    }
+
+private:
+    void releaseBindlessHandle()
+    {
+        if (_bindlessHandle != 0)
+        {
+            // Handles are released along with the texture object
+            glMakeTextureHandleNonResidentARB(_bindlessHandle);
+            _bindlessHandle = 0;
+        }
+    }
+
 }; // class Texture
 
 typedef std::shared_ptr<BasicTexture2D> BasicTexture2DPtr;
@@ -23,6 +23,12 @@ public:
 	{
 		return _data;
 	}
+
+	// Heap memory owned by the copyable object is not included
+	std::size_t getMemoryUsage() const override
+	{
+		return sizeof(*this);
+	}
 };
 
 } // namespace
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "iundo.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+
+namespace undo
+{
+
+/**
+ * An UndoMemento holding a sequence of elements, like the control points of
+ * a patch. Instead of copying all elements for every saved state, the memento
+ * can store only the elements which differ from a previously created memento.
+ *
+ * A memento is either a keyframe, holding the full sequence, or a delta
+ * storing the changed elements plus a reference to the keyframe it is based
+ * on. Deltas are always based on keyframes, such that restoring a memento
+ * never needs to walk a chain of mementos. The keyframe is shared by all
+ * deltas referencing it and stays alive as long as any of them.
+ *
+ * Keyframes of trivially copyable elements can be deflated by compressData(),
+ * they're inflated again whenever the elements are needed. All methods are
+ * safe to call concurrently.
+ *
+ * The Element type needs to be copyable and equality-comparable.
+ */
+template<typename Element>
+class DeltaUndoMemento :
+	public IUndoMemento
+{
+public:
+	using Ptr = std::shared_ptr<const DeltaUndoMemento>;
+
+private:
+	// Guards the element storage, which is replaced when compressing
+	mutable std::mutex _lock;
+
+	// The full sequence, only used by keyframes
+	mutable std::vector<Element> _elements;
+
+	// The deflated bytes of the elements, replacing _elements once compressed
+	mutable std::vector<Bytef> _compressedElements;
+	std::size_t _numElements;
+
+	// The keyframe this memento is relative to, empty for keyframes
+	Ptr _base;
+
+	// Index and value of each element differing from the base
+	std::vector<std::pair<std::size_t, Element>> _changes;
+
+public:
+	// Use Create() to construct instances
+	DeltaUndoMemento(const std::vector<Element>& elements) :
+		_elements(elements),
+		_numElements(elements.size())
+	{}
+
+	DeltaUndoMemento(const Ptr& base, std::vector<std::pair<std::size_t, Element>>&& changes) :
+		_numElements(base->_numElements),
+		_base(base),
+		_changes(std::move(changes))
+	{}
+
+	/**
+	 * Creates a memento of the given sequence. If a previous memento is passed,
+	 * only the differences to its keyframe are stored, unless that's not saving
+	 * any memory. Pass an empty reference to always create a keyframe.
+	 */
+	static Ptr Create(const std::vector<Element>& elements, const Ptr& previous)
+	{
+		auto base = previous && previous->_base ? previous->_base : previous;
+
+		if (!base || base->_numElements != elements.size())
+		{
+			return std::make_shared<DeltaUndoMemento>(elements);
+		}
+
+		std::vector<std::pair<std::size_t, Element>> changes;
+		bool deltaIsSmaller = true;
+
+		base->withElements([&](const std::vector<Element>& baseElements)
+		{
+			for (std::size_t i = 0; i < elements.size(); ++i)
+			{
+				if (elements[i] == baseElements[i]) continue;
+
+				// The index makes a change larger than the element itself,
+				// a new keyframe is cheaper once half of the elements changed
+				if (changes.size() >= elements.size() / 2)
+				{
+					deltaIsSmaller = false;
+					return;
+				}
+
+				changes.emplace_back(i, elements[i]);
+			}
+		});
+
+		if (!deltaIsSmaller)
+		{
+			return std::make_shared<DeltaUndoMemento>(elements);
+		}
+
+		return std::make_shared<DeltaUndoMemento>(base, std::move(changes));
+	}
+
+	bool isKeyframe() const
+	{
+		return !_base;
+	}
+
+	// Assigns the saved sequence to the given target
+	void restore(std::vector<Element>& target) const
+	{
+		const auto& keyframe = _base ? *_base : *this;
+
+		keyframe.withElements([&](const std::vector<Element>& elements)
+		{
+			target = elements;
+		});
+
+		for (const auto& change : _changes)
+		{
+			target[change.first] = change.second;
+		}
+	}
+
+	// Deflates the elements of a keyframe, this has no effect on deltas.
+	// Unlike compressData() this is available through the const Ptr.
+	void compressElements() const
+	{
+		if constexpr (std::is_trivially_copyable_v<Element>)
+		{
+			std::lock_guard<std::mutex> lock(_lock);
+
+			if (_elements.empty()) return; // delta, empty or compressed already
+
+			auto sourceLength = static_cast<uLong>(_elements.size() * sizeof(Element));
+			std::vector<Bytef> compressed(compressBound(sourceLength));
+			auto compressedLength = static_cast<uLongf>(compressed.size());
+
+			if (compress2(compressed.data(), &compressedLength,
+				reinterpret_cast<const Bytef*>(_elements.data()), sourceLength, Z_BEST_SPEED) != Z_OK ||
+				compressedLength >= sourceLength)
+			{
+				return; // keep the data as it is
+			}
+
+			compressed.resize(compressedLength);
+			compressed.shrink_to_fit();
+
+			_compressedElements.swap(compressed);
+			std::vector<Element>().swap(_elements);
+		}
+	}
+
+	void compressData() override
+	{
+		compressElements();
+	}
+
+	// The keyframe is not included in the usage of a delta, it's accounted to the keyframe memento
+	std::size_t getMemoryUsage() const override
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		return sizeof(*this) + _elements.capacity() * sizeof(Element) + _compressedElements.capacity() +
+			_changes.capacity() * sizeof(std::pair<std::size_t, Element>);
+	}
+
+private:
+	// Invokes the function with the full element sequence of this keyframe
+	template<typename Function>
+	void withElements(const Function& function) const
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		if (_compressedElements.empty())
+		{
+			function(_elements);
+			return;
+		}
+
+		std::vector<Element> elements(_numElements);
+
+		if constexpr (std::is_trivially_copyable_v<Element>)
+		{
+			auto length = static_cast<uLongf>(_numElements * sizeof(Element));
+			uncompress(reinterpret_cast<Bytef*>(elements.data()), &length,
+				_compressedElements.data(), static_cast<uLong>(_compressedElements.size()));
+		}
+
+		function(elements);
+	}
+};
+
+} // namespace
@@ -3,6 +3,7 @@
 #include "igl.h"
 #include "iimage.h"
 #include "BasicTexture2D.h"
+#include <algorithm>
 #include <memory>
 #include "util/Noncopyable.h"
 #include "debugging/gl.h"
@@ -54,7 +55,7 @@ public:
     GLenum getGLFormat() const override { return GL_RGBA; }
 
     /* BindableTexture implementation */
-    TexturePtr bindTexture(const std::string& name, Role role) const override
+    TexturePtr bindTexture(const std::string& name, Role /* role */) const override
     {
 		GLuint textureNum;
 
@@ -67,16 +68,28 @@ public:
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
 
-		// Upload the image to OpenGL, choosing an internal format based on role
-        GLint format = GL_RGBA8;
-        if (role == Role::NORMAL_MAP) {
-            format = GL_RG8;
+        auto width = static_cast<GLsizei>(getWidth());
+        auto height = static_cast<GLsizei>(getHeight());
+
+        if (GLEW_VERSION_4_2 || (GLEW_VERSION_3_0 && GLEW_ARB_texture_storage))
+        {
+            // Allocate all levels up front and let the driver generate the mipmaps
+            GLsizei levels = 1;
+            for (auto size = std::max(width, height); size > 1; size >>= 1)
+            {
+                ++levels;
+            }
+
+            glTexStorage2D(GL_TEXTURE_2D, levels, GL_RGBA8, width, height);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, getPixels());
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        else
+        {
+            // Download image and set up mipmaps and filtering
+            glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
+            gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, width, height, GL_RGBA, GL_UNSIGNED_BYTE, getPixels());
         }
-
-        // Download image and set up mipmaps and filtering
-        glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
-        gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, static_cast<GLint>(getWidth()),
-                          static_cast<GLint>(getHeight()), GL_RGBA, GL_UNSIGNED_BYTE, getPixels());
 
         // Un-bind the texture
 		glBindTexture(GL_TEXTURE_2D, 0);
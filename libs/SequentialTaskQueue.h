@@ -3,14 +3,14 @@
 #include <mutex>
 #include <list>
 #include <functional>
-#include <future>
+#include "itaskscheduler.h"
 
 namespace util
 {
 
 /**
  * Queueing helper, allowing to run queued tasks one after the other,
- * each of which will be run asynchronously (by means of std::async).
+ * each of which will be run asynchronously in the shared ITaskScheduler pool.
  * No task will be started before a previous one is completed.
  *
  * Destroying this object will remove all unstarted tasks from the queue,
@@ -23,8 +23,8 @@ private:
     std::list<std::function<void()>> _queue;
 
     mutable std::recursive_mutex _currentLock;
-    std::future<void> _current;
-    std::future<void> _finished;
+    threading::TaskPtr _current;
+    threading::TaskPtr _finished;
 
 public:
     ~SequentialTaskQueue()
@@ -62,15 +62,33 @@ public:
     {
         clearPendingTasks();
 
-        _current = std::future<void>();
-        _finished = std::future<void>();
+        threading::TaskPtr current;
+
+        {
+            std::lock_guard<std::recursive_mutex> lock(_currentLock);
+            current = _current;
+        }
+
+        if (current)
+        {
+            try
+            {
+                current->wait();
+            }
+            catch (...)
+            {} // the task's failure is not the concern of the one clearing the queue
+        }
+
+        std::lock_guard<std::recursive_mutex> lock(_currentLock);
+        _current.reset();
+        _finished.reset();
     }
 
 private:
     bool isIdle() const
     {
         std::lock_guard<std::recursive_mutex> lock(_currentLock);
-        return !_current.valid() || _current.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        return !_current || _current->isFinished();
     }
 
     std::function<void()> dequeueOne()
@@ -100,13 +118,13 @@ private:
 
         // Wrap the given task in our own lambda to start the next task right afterwards
         std::lock_guard<std::recursive_mutex> lock(_currentLock);
-        _current = std::async(std::launch::async, [this, task]()
+        _current = GlobalTaskScheduler().submit([this, task]()
         {
             task();
 
             {
-                // Move our own task to the finished lane, 
-                // to avoid blocking when assigning a new future
+                // Move our own task to the finished lane,
+                // to not lose track of it when assigning the next one
                 std::lock_guard<std::recursive_mutex> lock(_currentLock);
                 _finished = std::move(_current);
 
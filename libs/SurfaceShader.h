@@ -6,6 +6,7 @@
 #include "util/Noncopyable.h"
 #include "irender.h"
 #include "shaderlib.h"
+#include "string/InternedString.h"
 
 /**
  * Encapsulates a GL ShaderPtr and keeps track whether this
@@ -18,8 +19,8 @@ class SurfaceShader :
 	public Shader::Observer
 {
 private:
-    // greebo: The name of the material
-    std::string _materialName;
+    // greebo: The name of the material, shared with all other surfaces using it
+    string::InternedString _materialName;
 
     RenderSystemPtr _renderSystem;
 
@@ -78,6 +79,12 @@ public:
     * Get the material name.
     */
     const std::string& getMaterialName() const
+    {
+        return _materialName.get();
+    }
+
+    // Get the material name as interned string, which is cheap to copy
+    const string::InternedString& getInternedMaterialName() const
     {
         return _materialName;
     }
@@ -93,7 +100,7 @@ public:
 
         releaseShader();
 
-        _materialName = name;
+        _materialName = string::InternedString(name);
 
         captureShader();
     }
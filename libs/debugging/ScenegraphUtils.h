@@ -19,6 +19,7 @@ inline std::string getNameForNodeType(scene::INode::Type type)
     case scene::INode::Type::Particle: return "particle";
     case scene::INode::Type::EntityConnection: return "entityconnection";
     case scene::INode::Type::MergeAction: return "mergeaction";
+    case scene::INode::Type::UnloadedBlock: return "unloadedblock";
     default: return "unknown";
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "itextstream.h"
+#include "time/TraceRecorder.h"
 
 #if defined(_MSC_VER) || defined(_WINDOWS_)
    #include <time.h>
@@ -75,6 +76,9 @@ private:
 	// Show FPS?
 	bool _fps;
 
+	// The timed operation shows up in the startup trace too
+	util::ScopedTraceEvent _traceEvent;
+
 public:
 
 	/**
@@ -89,7 +93,7 @@ public:
 	 * time.
 	 */
 	ScopedDebugTimer(const std::string& name, bool showFps = false)
-	: _op(name), _fps(showFps)
+	: _op(name), _fps(showFps), _traceEvent("timer", name)
 	{
 		// Save start time
 		gettimeofday(&_s, nullptr);
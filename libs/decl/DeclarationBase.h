@@ -162,7 +162,7 @@ protected:
         try
         {
             // Set up a tokeniser to let the subclass implementation parse the contents
-            parser::BasicDefTokeniser<std::string> tokeniser(getBlockSyntax().contents,
+            parser::BasicDefTokeniser<std::string_view> tokeniser(getBlockSyntax().contents,
                 getWhitespaceDelimiters(), getKeptDelimiters());
             parseFromTokens(tokeniser);
         }
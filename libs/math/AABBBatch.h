@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include "math/AABB.h"
+
+/**
+ * \brief
+ * A fixed number of AABBs stored as structure of arrays, one array per
+ * component of the origin and the extents.
+ *
+ * This layout allows for testing several boxes at once using SIMD
+ * instructions, see Frustum::testIntersection(const AABBBatch&, ...).
+ * Unused slots are zeroed out and don't have any effect.
+ */
+class AABBBatch
+{
+public:
+    // The number of boxes fitting into one batch, matching the children of an octree node
+    static constexpr std::size_t Size = 8;
+
+    alignas(32) double originX[Size];
+    alignas(32) double originY[Size];
+    alignas(32) double originZ[Size];
+    alignas(32) double extentsX[Size];
+    alignas(32) double extentsY[Size];
+    alignas(32) double extentsZ[Size];
+
+private:
+    std::size_t _count;
+
+public:
+    AABBBatch()
+    {
+        clear();
+    }
+
+    // Removes all boxes from this batch
+    void clear()
+    {
+        for (std::size_t i = 0; i < Size; ++i)
+        {
+            originX[i] = originY[i] = originZ[i] = 0;
+            extentsX[i] = extentsY[i] = extentsZ[i] = 0;
+        }
+
+        _count = 0;
+    }
+
+    std::size_t size() const
+    {
+        return _count;
+    }
+
+    bool empty() const
+    {
+        return _count == 0;
+    }
+
+    bool full() const
+    {
+        return _count == Size;
+    }
+
+    // Appends the given box, the batch must not be full
+    void add(const AABB& aabb)
+    {
+        originX[_count] = aabb.origin.x();
+        originY[_count] = aabb.origin.y();
+        originZ[_count] = aabb.origin.z();
+        extentsX[_count] = aabb.extents.x();
+        extentsY[_count] = aabb.extents.y();
+        extentsZ[_count] = aabb.extents.z();
+
+        ++_count;
+    }
+
+    // Returns the box stored at the given index
+    AABB get(std::size_t index) const
+    {
+        return AABB(Vector3(originX[index], originY[index], originZ[index]),
+            Vector3(extentsX[index], extentsY[index], extentsZ[index]));
+    }
+};
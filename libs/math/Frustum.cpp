@@ -2,6 +2,139 @@
 
 #include "AABB.h"
 
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRUSTUM_BATCH_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FRUSTUM_BATCH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define FRUSTUM_BATCH_NEON
+#endif
+
+namespace
+{
+
+// Classifies all boxes of the batch against the given plane, using the same
+// arithmetic as AABB::classifyPlane(). For each box, a bit is set in the outside
+// mask if the box is entirely behind the plane, and in the partial mask if it
+// is not entirely in front of it.
+inline void classifyBatch(const Plane3& plane, const AABBBatch& batch, unsigned& outside, unsigned& partial)
+{
+#if defined(FRUSTUM_BATCH_AVX)
+    const auto nx = _mm256_set1_pd(plane.normal().x());
+    const auto ny = _mm256_set1_pd(plane.normal().y());
+    const auto nz = _mm256_set1_pd(plane.normal().z());
+    const auto absNx = _mm256_set1_pd(fabs(plane.normal().x()));
+    const auto absNy = _mm256_set1_pd(fabs(plane.normal().y()));
+    const auto absNz = _mm256_set1_pd(fabs(plane.normal().z()));
+    const auto dist = _mm256_set1_pd(plane.dist());
+    const auto zero = _mm256_setzero_pd();
+
+    for (std::size_t i = 0; i < AABBBatch::Size; i += 4)
+    {
+        auto originDot = _mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(nx, _mm256_load_pd(batch.originX + i)),
+            _mm256_mul_pd(ny, _mm256_load_pd(batch.originY + i))),
+            _mm256_mul_pd(nz, _mm256_load_pd(batch.originZ + i)));
+
+        auto extentsDot = _mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(absNx, _mm256_load_pd(batch.extentsX + i)),
+            _mm256_mul_pd(absNy, _mm256_load_pd(batch.extentsY + i))),
+            _mm256_mul_pd(absNz, _mm256_load_pd(batch.extentsZ + i)));
+
+        auto maxDist = _mm256_sub_pd(_mm256_add_pd(originDot, extentsDot), dist);
+        auto minDist = _mm256_sub_pd(_mm256_sub_pd(originDot, extentsDot), dist);
+
+        outside |= static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(maxDist, zero, _CMP_LT_OQ))) << i;
+        partial |= (~static_cast<unsigned>(_mm256_movemask_pd(_mm256_cmp_pd(minDist, zero, _CMP_GE_OQ))) & 0xF) << i;
+    }
+#elif defined(FRUSTUM_BATCH_SSE2)
+    const auto nx = _mm_set1_pd(plane.normal().x());
+    const auto ny = _mm_set1_pd(plane.normal().y());
+    const auto nz = _mm_set1_pd(plane.normal().z());
+    const auto absNx = _mm_set1_pd(fabs(plane.normal().x()));
+    const auto absNy = _mm_set1_pd(fabs(plane.normal().y()));
+    const auto absNz = _mm_set1_pd(fabs(plane.normal().z()));
+    const auto dist = _mm_set1_pd(plane.dist());
+    const auto zero = _mm_setzero_pd();
+
+    for (std::size_t i = 0; i < AABBBatch::Size; i += 2)
+    {
+        auto originDot = _mm_add_pd(_mm_add_pd(
+            _mm_mul_pd(nx, _mm_load_pd(batch.originX + i)),
+            _mm_mul_pd(ny, _mm_load_pd(batch.originY + i))),
+            _mm_mul_pd(nz, _mm_load_pd(batch.originZ + i)));
+
+        auto extentsDot = _mm_add_pd(_mm_add_pd(
+            _mm_mul_pd(absNx, _mm_load_pd(batch.extentsX + i)),
+            _mm_mul_pd(absNy, _mm_load_pd(batch.extentsY + i))),
+            _mm_mul_pd(absNz, _mm_load_pd(batch.extentsZ + i)));
+
+        auto maxDist = _mm_sub_pd(_mm_add_pd(originDot, extentsDot), dist);
+        auto minDist = _mm_sub_pd(_mm_sub_pd(originDot, extentsDot), dist);
+
+        outside |= static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(maxDist, zero))) << i;
+        partial |= (~static_cast<unsigned>(_mm_movemask_pd(_mm_cmpge_pd(minDist, zero))) & 0x3) << i;
+    }
+#elif defined(FRUSTUM_BATCH_NEON)
+    const auto nx = vdupq_n_f64(plane.normal().x());
+    const auto ny = vdupq_n_f64(plane.normal().y());
+    const auto nz = vdupq_n_f64(plane.normal().z());
+    const auto absNx = vdupq_n_f64(fabs(plane.normal().x()));
+    const auto absNy = vdupq_n_f64(fabs(plane.normal().y()));
+    const auto absNz = vdupq_n_f64(fabs(plane.normal().z()));
+    const auto dist = vdupq_n_f64(plane.dist());
+    const auto zero = vdupq_n_f64(0);
+
+    for (std::size_t i = 0; i < AABBBatch::Size; i += 2)
+    {
+        // Separate multiplications and additions, fused operations would change the rounding
+        auto originDot = vaddq_f64(vaddq_f64(
+            vmulq_f64(nx, vld1q_f64(batch.originX + i)),
+            vmulq_f64(ny, vld1q_f64(batch.originY + i))),
+            vmulq_f64(nz, vld1q_f64(batch.originZ + i)));
+
+        auto extentsDot = vaddq_f64(vaddq_f64(
+            vmulq_f64(absNx, vld1q_f64(batch.extentsX + i)),
+            vmulq_f64(absNy, vld1q_f64(batch.extentsY + i))),
+            vmulq_f64(absNz, vld1q_f64(batch.extentsZ + i)));
+
+        auto maxDist = vsubq_f64(vaddq_f64(originDot, extentsDot), dist);
+        auto minDist = vsubq_f64(vsubq_f64(originDot, extentsDot), dist);
+
+        auto isOutside = vcltq_f64(maxDist, zero);
+        auto isInside = vcgeq_f64(minDist, zero);
+
+        outside |= ((vgetq_lane_u64(isOutside, 0) ? 1u : 0u) | (vgetq_lane_u64(isOutside, 1) ? 2u : 0u)) << i;
+        partial |= ((vgetq_lane_u64(isInside, 0) ? 0u : 1u) | (vgetq_lane_u64(isInside, 1) ? 0u : 2u)) << i;
+    }
+#else
+    for (std::size_t i = 0; i < AABBBatch::Size; ++i)
+    {
+        double originDot = plane.normal().x() * batch.originX[i] +
+            plane.normal().y() * batch.originY[i] +
+            plane.normal().z() * batch.originZ[i];
+        double extentsDot = fabs(plane.normal().x()) * batch.extentsX[i] +
+            fabs(plane.normal().y()) * batch.extentsY[i] +
+            fabs(plane.normal().z()) * batch.extentsZ[i];
+
+        if (originDot + extentsDot - plane.dist() < 0)
+        {
+            outside |= 1u << i;
+        }
+
+        if (!(originDot - extentsDot - plane.dist() >= 0))
+        {
+            partial |= 1u << i;
+        }
+    }
+#endif
+}
+
+}
+
 // Normalise all planes in frustum
 void Frustum::normalisePlanes()
 {
@@ -140,6 +273,25 @@ VolumeIntersectionValue Frustum::testIntersection(const AABB& aabb) const
     return result;
 }
 
+void Frustum::testIntersection(const AABBBatch& batch, VolumeIntersectionValue* results) const
+{
+    unsigned outside = 0;
+    unsigned partial = 0;
+
+    classifyBatch(right, batch, outside, partial);
+    classifyBatch(left, batch, outside, partial);
+    classifyBatch(bottom, batch, outside, partial);
+    classifyBatch(top, batch, outside, partial);
+    classifyBatch(back, batch, outside, partial);
+    classifyBatch(front, batch, outside, partial);
+
+    for (std::size_t i = 0; i < batch.size(); ++i)
+    {
+        results[i] = outside & (1u << i) ? VOLUME_OUTSIDE :
+            partial & (1u << i) ? VOLUME_PARTIAL : VOLUME_INSIDE;
+    }
+}
+
 VolumeIntersectionValue Frustum::testIntersection(const AABB& aabb, const Matrix4& localToWorld) const
 {
 	AABB aabb_world(aabb);
@@ -8,6 +8,7 @@
 #include "math/Matrix4.h"
 #include "math/Segment.h"
 #include "math/AABB.h"
+#include "math/AABBBatch.h"
 
 #include "VolumeIntersectionValue.h"
 
@@ -60,6 +61,16 @@ public:
     /// Test the intersection of this frustum with an AABB.
     VolumeIntersectionValue testIntersection(const AABB& aabb) const;
 
+    /**
+     * \brief
+     * Test the intersection of this frustum with all boxes of the given batch,
+     * writing one result per box to the given array.
+     *
+     * The results are the same as calling testIntersection() for every box,
+     * the boxes are evaluated in parallel using SSE2, AVX or NEON where available.
+     */
+    void testIntersection(const AABBBatch& batch, VolumeIntersectionValue* results) const;
+
     /// Test the intersection of this frustum with a transformed AABB.
     VolumeIntersectionValue testIntersection(const AABB& aabb, const Matrix4& localToWorld) const;
 
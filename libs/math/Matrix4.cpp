@@ -4,6 +4,14 @@
 
 #include <sstream>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MATRIX4_BATCH_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define MATRIX4_BATCH_NEON
+#endif
+
 namespace
 {
 	/// \brief Returns \p euler angles converted from degrees to radians.
@@ -219,4 +227,79 @@ Matrix4 Matrix4::getRotationForEulerXYZDegrees(const Vector3& euler)
 void Matrix4::scaleBy(const Vector3& scale)
 {
     multiplyBy(getScale(scale));
-}
\ No newline at end of file
+}
+
+void Matrix4::transformPoints(Vector3* points, std::size_t count, std::size_t stride) const
+{
+    auto bytes = reinterpret_cast<unsigned char*>(points);
+
+    // The four columns in storage order, column n is starting at m[4*n]
+    const double* m = _transform.matrix().data();
+
+    // All variants are evaluating ((col0 * x + col1 * y) + col2 * z) + col3
+    // using separate multiplications and additions, to get the same rounding
+#if defined(MATRIX4_BATCH_SSE2)
+    const auto col0xy = _mm_loadu_pd(m + 0);
+    const auto col0zw = _mm_loadu_pd(m + 2);
+    const auto col1xy = _mm_loadu_pd(m + 4);
+    const auto col1zw = _mm_loadu_pd(m + 6);
+    const auto col2xy = _mm_loadu_pd(m + 8);
+    const auto col2zw = _mm_loadu_pd(m + 10);
+    const auto col3xy = _mm_loadu_pd(m + 12);
+    const auto col3zw = _mm_loadu_pd(m + 14);
+
+    for (std::size_t i = 0; i < count; ++i, bytes += stride)
+    {
+        double* p = *reinterpret_cast<Vector3*>(bytes);
+
+        auto x = _mm_set1_pd(p[0]);
+        auto y = _mm_set1_pd(p[1]);
+        auto z = _mm_set1_pd(p[2]);
+
+        auto xy = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(col0xy, x), _mm_mul_pd(col1xy, y)), _mm_mul_pd(col2xy, z)), col3xy);
+        auto zw = _mm_add_pd(_mm_add_pd(_mm_add_pd(_mm_mul_pd(col0zw, x), _mm_mul_pd(col1zw, y)), _mm_mul_pd(col2zw, z)), col3zw);
+
+        _mm_storeu_pd(p, xy);
+        _mm_store_sd(p + 2, zw);
+    }
+#elif defined(MATRIX4_BATCH_NEON)
+    const auto col0xy = vld1q_f64(m + 0);
+    const auto col0zw = vld1q_f64(m + 2);
+    const auto col1xy = vld1q_f64(m + 4);
+    const auto col1zw = vld1q_f64(m + 6);
+    const auto col2xy = vld1q_f64(m + 8);
+    const auto col2zw = vld1q_f64(m + 10);
+    const auto col3xy = vld1q_f64(m + 12);
+    const auto col3zw = vld1q_f64(m + 14);
+
+    for (std::size_t i = 0; i < count; ++i, bytes += stride)
+    {
+        double* p = *reinterpret_cast<Vector3*>(bytes);
+
+        auto x = vdupq_n_f64(p[0]);
+        auto y = vdupq_n_f64(p[1]);
+        auto z = vdupq_n_f64(p[2]);
+
+        // No vfmaq_f64 here, the fused operation would round differently
+        auto xy = vaddq_f64(vaddq_f64(vaddq_f64(vmulq_f64(col0xy, x), vmulq_f64(col1xy, y)), vmulq_f64(col2xy, z)), col3xy);
+        auto zw = vaddq_f64(vaddq_f64(vaddq_f64(vmulq_f64(col0zw, x), vmulq_f64(col1zw, y)), vmulq_f64(col2zw, z)), col3zw);
+
+        vst1q_f64(p, xy);
+        p[2] = vgetq_lane_f64(zw, 0);
+    }
+#else
+    for (std::size_t i = 0; i < count; ++i, bytes += stride)
+    {
+        auto& point = *reinterpret_cast<Vector3*>(bytes);
+
+        double x = point.x();
+        double y = point.y();
+        double z = point.z();
+
+        for (int row = 0; row < 3; ++row)
+        {
+            point[row] = ((m[row] * x + m[4 + row] * y) + m[8 + row] * z) + m[12 + row];
+        }
+    }
+#endif
+}
@@ -304,6 +304,17 @@ public:
         return transform(BasicVector4<T>(point, 1)).getVector3();
     }
 
+    /**
+     * \brief Transforms an array of points in place, like calling transformPoint()
+     * on each of them.
+     *
+     * The points don't need to be tightly packed, the given stride is the
+     * distance in bytes between two consecutive points (e.g. the size of a
+     * vertex structure the points are part of). Uses SSE2 or NEON where available,
+     * performing the same operations in the same order as the scalar code.
+     */
+    void transformPoints(Vector3* points, std::size_t count, std::size_t stride = sizeof(Vector3)) const;
+
     /**
      * \brief Returns the given 3-component direction transformed by this
      * matrix.
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <limits>
 #include "Vector3.h"
 #include "Plane3.h"
 #include "Matrix4.h"
@@ -164,6 +166,46 @@ public:
 		return true; // ray hits box
 	}
 
+	/**
+	 * Slab test of this ray against the given bounding box. Returns true if the ray
+	 * hits the box, in which case entry and exit receive the distances along the ray
+	 * (in multiples of the direction vector) where it enters and leaves the box.
+	 * The entry distance is 0 if the ray starts within the box.
+	 */
+	bool intersectAABB(const AABB& aabb, double& entry, double& exit) const
+	{
+		if (!aabb.isValid()) return false;
+
+		entry = 0;
+		exit = std::numeric_limits<double>::max();
+
+		for (int i = 0; i < 3; i++)
+		{
+			auto min = aabb.origin[i] - aabb.extents[i];
+			auto max = aabb.origin[i] + aabb.extents[i];
+
+			if (direction[i] == 0)
+			{
+				// Parallel to the slab, the origin needs to be in between
+				if (origin[i] < min || origin[i] > max) return false;
+				continue;
+			}
+
+			auto inverse = 1.0 / direction[i];
+			auto tNear = (min - origin[i]) * inverse;
+			auto tFar = (max - origin[i]) * inverse;
+
+			if (tNear > tFar) std::swap(tNear, tFar);
+
+			entry = std::max(entry, tNear);
+			exit = std::min(exit, tFar);
+
+			if (entry > exit) return false;
+		}
+
+		return true;
+	}
+
 	// Return type for intersectTriangle()
 	enum eTriangleIntersectionType
 	{
@@ -17,6 +17,23 @@
 #include <memory.h>
 #include "SHA256.h"
 
+// The SHA extensions of x86 processors are detected at runtime, the ARMv8
+// crypto extensions are used if the compiler has been told they're available
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SHA256_USE_X86_SHA_EXTENSIONS
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define SHA256_TARGET_X86_SHA_EXTENSIONS
+#else
+#include <cpuid.h>
+#define SHA256_TARGET_X86_SHA_EXTENSIONS __attribute__((target("sha,sse4.1")))
+#endif
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_SHA2) || defined(__ARM_FEATURE_CRYPTO))
+#define SHA256_USE_ARM_SHA_EXTENSIONS
+#include <arm_neon.h>
+#endif
+
 namespace math
 {
 
@@ -47,7 +64,10 @@ static const WORD k[64] = {
 };
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-void sha256_transform(SHA256_CTX* ctx, const BYTE data[])
+namespace
+{
+
+void sha256_transform(WORD state[8], const BYTE data[])
 {
     WORD a, b, c, d, e, f, g, h, i, j, t1, t2, m[64];
 
@@ -56,14 +76,14 @@ void sha256_transform(SHA256_CTX* ctx, const BYTE data[])
     for (; i < 64; ++i)
         m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
 
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
-    f = ctx->state[5];
-    g = ctx->state[6];
-    h = ctx->state[7];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
 
     for (i = 0; i < 64; ++i) {
         t1 = h + EP1(e) + CH(e, f, g) + k[i] + m[i];
@@ -78,14 +98,158 @@ void sha256_transform(SHA256_CTX* ctx, const BYTE data[])
         a = t1 + t2;
     }
 
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
-    ctx->state[5] += f;
-    ctx->state[6] += g;
-    ctx->state[7] += h;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void sha256_transform_generic(WORD state[8], const BYTE data[], size_t blocks)
+{
+    for (; blocks > 0; --blocks, data += 64)
+        sha256_transform(state, data);
+}
+
+#if defined(SHA256_USE_X86_SHA_EXTENSIONS)
+
+bool cpu_has_sha_extensions()
+{
+    unsigned int basic[4] = { 0 };
+    unsigned int extended[4] = { 0 };
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) return false;
+    __cpuid(regs, 1);
+    for (int r = 0; r < 4; ++r) basic[r] = static_cast<unsigned int>(regs[r]);
+    __cpuidex(regs, 7, 0);
+    for (int r = 0; r < 4; ++r) extended[r] = static_cast<unsigned int>(regs[r]);
+#else
+    if (__get_cpuid_max(0, nullptr) < 7) return false;
+    __get_cpuid(1, &basic[0], &basic[1], &basic[2], &basic[3]);
+    __get_cpuid_count(7, 0, &extended[0], &extended[1], &extended[2], &extended[3]);
+#endif
+
+    // SSSE3 and SSE4.1 (ECX of leaf 1) are needed next to SHA (EBX of leaf 7)
+    return (basic[2] & (1u << 9)) && (basic[2] & (1u << 19)) && (extended[1] & (1u << 29));
+}
+
+// Processes the blocks using the SHA-NI instructions, working on the state
+// in the ABEF/CDGH layout expected by sha256rnds2
+SHA256_TARGET_X86_SHA_EXTENSIONS
+void sha256_transform_x86(WORD state[8], const BYTE data[], size_t blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    __m128i tmp = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0]));
+    __m128i state1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4]));
+
+    tmp = _mm_shuffle_epi32(tmp, 0xB1);                 // CDAB
+    state1 = _mm_shuffle_epi32(state1, 0x1B);           // EFGH
+    __m128i state0 = _mm_alignr_epi8(tmp, state1, 8);   // ABEF
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);        // CDGH
+
+    for (; blocks > 0; --blocks, data += 64) {
+        __m128i abefSave = state0;
+        __m128i cdghSave = state1;
+        __m128i msg[4];
+
+        // Four rounds per step, the message schedule is computed alongside
+        for (int i = 0; i < 16; ++i) {
+            if (i < 4)
+                msg[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i * 16)), byteSwap);
+
+            __m128i rounds = _mm_add_epi32(msg[i & 3], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&k[i * 4])));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, rounds);
+
+            if (i >= 3 && i < 15) {
+                __m128i next = _mm_add_epi32(msg[(i + 1) & 3], _mm_alignr_epi8(msg[i & 3], msg[(i + 3) & 3], 4));
+                msg[(i + 1) & 3] = _mm_sha256msg2_epu32(next, msg[i & 3]);
+            }
+
+            rounds = _mm_shuffle_epi32(rounds, 0x0E);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, rounds);
+
+            if (i >= 1 && i < 13)
+                msg[(i + 3) & 3] = _mm_sha256msg1_epu32(msg[(i + 3) & 3], msg[i & 3]);
+        }
+
+        state0 = _mm_add_epi32(state0, abefSave);
+        state1 = _mm_add_epi32(state1, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1B);              // FEBA
+    state1 = _mm_shuffle_epi32(state1, 0xB1);           // DCHG
+    state0 = _mm_blend_epi16(tmp, state1, 0xF0);        // DCBA
+    state1 = _mm_alignr_epi8(state1, tmp, 8);           // HGFE
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), state0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), state1);
+}
+
+#elif defined(SHA256_USE_ARM_SHA_EXTENSIONS)
+
+void sha256_transform_arm(WORD state[8], const BYTE data[], size_t blocks)
+{
+    uint32x4_t state0 = vld1q_u32(&state[0]);
+    uint32x4_t state1 = vld1q_u32(&state[4]);
+
+    for (; blocks > 0; --blocks, data += 64) {
+        uint32x4_t abcdSave = state0;
+        uint32x4_t efghSave = state1;
+        uint32x4_t msg[4];
+
+        for (int i = 0; i < 4; ++i)
+            msg[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + i * 16)));
+
+        // Four rounds per step, the message schedule is computed alongside
+        for (int i = 0; i < 16; ++i) {
+            uint32x4_t rounds = vaddq_u32(msg[i & 3], vld1q_u32(&k[i * 4]));
+
+            if (i < 12)
+                msg[i & 3] = vsha256su1q_u32(vsha256su0q_u32(msg[i & 3], msg[(i + 1) & 3]),
+                    msg[(i + 2) & 3], msg[(i + 3) & 3]);
+
+            uint32x4_t abcd = state0;
+            state0 = vsha256hq_u32(state0, state1, rounds);
+            state1 = vsha256h2q_u32(state1, abcd, rounds);
+        }
+
+        state0 = vaddq_u32(state0, abcdSave);
+        state1 = vaddq_u32(state1, efghSave);
+    }
+
+    vst1q_u32(&state[0], state0);
+    vst1q_u32(&state[4], state1);
+}
+
+#endif
+
+typedef void (*sha256_transform_func)(WORD state[8], const BYTE data[], size_t blocks);
+
+sha256_transform_func sha256_select_transform()
+{
+#if defined(SHA256_USE_X86_SHA_EXTENSIONS)
+    if (cpu_has_sha_extensions())
+        return sha256_transform_x86;
+#elif defined(SHA256_USE_ARM_SHA_EXTENSIONS)
+    return sha256_transform_arm;
+#endif
+    return sha256_transform_generic;
+}
+
+// Processes the given number of 64 byte blocks
+void sha256_transform_blocks(WORD state[8], const BYTE data[], size_t blocks)
+{
+    static const sha256_transform_func transform = sha256_select_transform();
+    transform(state, data, blocks);
+}
+
 }
 
 void sha256_init(SHA256_CTX* ctx)
@@ -104,17 +268,33 @@ void sha256_init(SHA256_CTX* ctx)
 
 void sha256_update(SHA256_CTX* ctx, const BYTE data[], size_t len)
 {
-    WORD i;
+    // Complete a partially filled block first
+    if (ctx->datalen > 0) {
+        size_t count = 64 - ctx->datalen < len ? 64 - ctx->datalen : len;
+        memcpy(ctx->data + ctx->datalen, data, count);
+        ctx->datalen += static_cast<WORD>(count);
+        data += count;
+        len -= count;
 
-    for (i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
-        }
+        if (ctx->datalen < 64)
+            return;
+
+        sha256_transform_blocks(ctx->state, ctx->data, 1);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
     }
+
+    // Whole blocks are processed in place, without copying them to the buffer
+    size_t blocks = len / 64;
+    if (blocks > 0) {
+        sha256_transform_blocks(ctx->state, data, blocks);
+        ctx->bitlen += 512 * static_cast<uint64_t>(blocks);
+        data += blocks * 64;
+        len -= blocks * 64;
+    }
+
+    memcpy(ctx->data, data, len);
+    ctx->datalen = static_cast<WORD>(len);
 }
 
 void sha256_final(SHA256_CTX* ctx, BYTE hash[])
@@ -133,7 +313,7 @@ void sha256_final(SHA256_CTX* ctx, BYTE hash[])
         ctx->data[i++] = 0x80;
         while (i < 64)
             ctx->data[i++] = 0x00;
-        sha256_transform(ctx, ctx->data);
+        sha256_transform_blocks(ctx->state, ctx->data, 1);
         memset(ctx->data, 0, 56);
     }
 
@@ -147,7 +327,7 @@ void sha256_final(SHA256_CTX* ctx, BYTE hash[])
     ctx->data[58] = (uint8_t)(ctx->bitlen >> 40);
     ctx->data[57] = (uint8_t)(ctx->bitlen >> 48);
     ctx->data[56] = (uint8_t)(ctx->bitlen >> 56);
-    sha256_transform(ctx, ctx->data);
+    sha256_transform_blocks(ctx->state, ctx->data, 1);
 
     // Since this implementation uses little endian byte ordering and SHA uses big endian,
     // reverse all the bytes when copying the final state to the output hash.
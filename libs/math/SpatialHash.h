@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "Vector3.h"
+#include "Hash.h"
+
+namespace math
+{
+
+/**
+ * \brief
+ * Sorts points into a uniform grid of cubic cells, such that all points
+ * near a given position can be looked up without comparing them pairwise.
+ *
+ * The cell size must not be smaller than the epsilon used in the queries,
+ * since only the cell containing the queried position and its neighbours
+ * are searched. The matching criterion is the same as in math::isNear().
+ */
+template<typename ValueType>
+class SpatialHash
+{
+private:
+    struct CellKey
+    {
+        std::int64_t x;
+        std::int64_t y;
+        std::int64_t z;
+
+        bool operator==(const CellKey& other) const
+        {
+            return x == other.x && y == other.y && z == other.z;
+        }
+    };
+
+    struct CellKeyHash
+    {
+        std::size_t operator()(const CellKey& key) const
+        {
+            auto hash = std::hash<std::int64_t>()(key.x);
+            math::combineHash(hash, std::hash<std::int64_t>()(key.y));
+            math::combineHash(hash, std::hash<std::int64_t>()(key.z));
+            return hash;
+        }
+    };
+
+    struct Entry
+    {
+        Vector3 point;
+        ValueType value;
+    };
+
+    double _cellSize;
+    std::unordered_map<CellKey, std::vector<Entry>, CellKeyHash> _cells;
+
+public:
+    SpatialHash(double cellSize) :
+        _cellSize(cellSize)
+    {}
+
+    void insert(const Vector3& point, const ValueType& value)
+    {
+        _cells[getCellKey(point)].push_back(Entry{ point, value });
+    }
+
+    bool empty() const
+    {
+        return _cells.empty();
+    }
+
+    void clear()
+    {
+        _cells.clear();
+    }
+
+    // Invokes the functor with each value whose point is within epsilon of the
+    // given position. Values sharing a cell are visited in insertion order.
+    void foreachNear(const Vector3& point, double epsilon,
+        const std::function<void(const Vector3&, const ValueType&)>& functor) const
+    {
+        auto key = getCellKey(point);
+
+        for (auto x = key.x - 1; x <= key.x + 1; ++x)
+        {
+            for (auto y = key.y - 1; y <= key.y + 1; ++y)
+            {
+                for (auto z = key.z - 1; z <= key.z + 1; ++z)
+                {
+                    auto cell = _cells.find(CellKey{ x, y, z });
+
+                    if (cell == _cells.end()) continue;
+
+                    for (const auto& entry : cell->second)
+                    {
+                        if (math::isNear(entry.point, point, epsilon))
+                        {
+                            functor(entry.point, entry.value);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    CellKey getCellKey(const Vector3& point) const
+    {
+        return CellKey
+        {
+            static_cast<std::int64_t>(std::floor(point.x() / _cellSize)),
+            static_cast<std::int64_t>(std::floor(point.y() / _cellSize)),
+            static_cast<std::int64_t>(std::floor(point.z() / _cellSize))
+        };
+    }
+};
+
+}
@@ -25,6 +25,9 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 /// \file
 /// \brief Curve data types and related operations.
 
+#include <algorithm>
+#include <cmath>
+#include <utility>
 #include <vector>
 #include "math/Matrix4.h"
 
@@ -182,16 +185,9 @@ inline Vector3 CatmullRom_evaluate(const ControlPoints& controlPoints, double t)
   // scale t to be segment-relative
   t *= double(controlPoints.size() - 1);
 
-  // subtract segment index;
-  std::size_t segment = 0;
-  for(std::size_t i = 0; i < controlPoints.size() - 1; ++i)
-  {
-    if(t <= double(i+1))
-    {
-      segment = i;
-      break;
-    }
-  }
+  // subtract segment index, t == i + 1 is still evaluated in segment i
+  std::size_t lastSegment = controlPoints.size() - 2;
+  std::size_t segment = t > 1 ? std::min(static_cast<std::size_t>(std::ceil(t)) - 1, lastSegment) : 0;
   t -= segment;
 
   const double reciprocal_alpha = 1.0 / 3.0;
@@ -229,10 +225,31 @@ inline double BSpline_basis(const Knots& knots, std::size_t i, std::size_t degre
   return left + right;
 }
 
+/// \brief Returns the range [first, last) of the basis functions which can be non-zero at t.
+/// These are the degree + 1 functions overlapping the knot span containing t,
+/// all others have no influence on the curve at this point.
+inline std::pair<std::size_t, std::size_t> BSpline_nonZeroBasisRange(const Knots& knots, std::size_t numControlPoints, std::size_t degree, double t)
+{
+  // The span j is the last one with knots[j] <= t < knots[j + 1]
+  auto upper = std::upper_bound(knots.begin(), knots.end(), t);
+
+  if(upper == knots.begin() || upper == knots.end())
+  {
+    return { 0, 0 }; // t is outside the knot vector
+  }
+
+  std::size_t span = std::distance(knots.begin(), upper) - 1;
+  std::size_t first = span > degree ? span - degree : 0;
+
+  return { first, std::min(span + 1, numControlPoints) };
+}
+
 inline Vector3 BSpline_evaluate(const ControlPoints& controlPoints, const Knots& knots, std::size_t degree, double t)
 {
   Vector3 result(0, 0, 0);
-  for(std::size_t i = 0; i < controlPoints.size(); ++i)
+  auto [first, last] = BSpline_nonZeroBasisRange(knots, controlPoints.size(), degree, t);
+
+  for(std::size_t i = first; i < last; ++i)
   {
     result += controlPoints[i] * BSpline_basis(knots, i, degree, t);
   }
@@ -245,7 +262,9 @@ inline Vector3 NURBS_evaluate(const ControlPoints& controlPoints, const NURBSWei
 {
   Vector3 result(0, 0, 0);
   double denominator = 0;
-  for(std::size_t i = 0; i < controlPoints.size(); ++i)
+  auto [first, last] = BSpline_nonZeroBasisRange(knots, controlPoints.size(), degree, t);
+
+  for(std::size_t i = first; i < last; ++i)
   {
     double weight = weights[i] * BSpline_basis(knots, i, degree, t);
     result += controlPoints[i] * weight;
@@ -81,6 +81,12 @@ public:
         return IMessage::Type::MapFileOperation;
     }
 
+    // Progress messages are superseded by the next one
+    bool isCoalescable() const override
+    {
+        return _msgType == Progress;
+    }
+
     const std::string& getText() const
     {
         return _message;
@@ -6,7 +6,9 @@
 #include <iostream>
 #include <ios>
 #include <string>
+#include <string_view>
 #include "string/tokeniser.h"
+#include "string/convert.h"
 
 namespace parser
 {
@@ -422,6 +424,39 @@ public:
 	 * next without actually changing the tokeniser's state.
 	 */
 	virtual std::string peek() const = 0;
+
+    /**
+     * Return the next token in the sequence, like nextToken(). The returned view
+     * is valid until the next call to any of the methods of this tokeniser.
+     *
+     * The default implementation is copying the token into an internal buffer,
+     * tokenisers working on a contiguous buffer can return views into it instead.
+     */
+    virtual std::string_view nextTokenView()
+    {
+        _tokenViewBuffer = nextToken();
+        return _tokenViewBuffer;
+    }
+
+    /**
+     * Returns the next token converted to a floating point value, see string::parseDouble().
+     * The conversion is not depending on the current locale, tokens which are not
+     * starting with a number are yielding the given fallback value.
+     */
+    double nextDouble(double defaultVal = 0.0)
+    {
+        return string::parseDouble(nextTokenView(), defaultVal);
+    }
+
+    // Returns the next token converted to an integer value, see string::parseInteger()
+    template<typename T>
+    T nextInteger(T defaultVal = T())
+    {
+        return string::parseInteger<T>(nextTokenView(), defaultVal);
+    }
+
+private:
+    std::string _tokenViewBuffer;
 };
 
 /**
@@ -510,6 +545,416 @@ public:
 	}
 };
 
+/**
+ * Specialisation of DefTokeniser working on a contiguous character buffer, like
+ * the contents of a decl block or a file loaded into memory. Behaves exactly like
+ * the other variants, but the tokens are returned as views into the buffer, only
+ * quoted tokens containing escape sequences or continuations need to be copied.
+ *
+ * The buffer must stay alive and unchanged as long as this tokeniser is in use.
+ */
+template<>
+class BasicDefTokeniser<std::string_view> :
+    public DefTokeniser
+{
+private:
+    const char* _begin;
+    const char* _cur;
+    const char* _end;
+
+    const char* _delims;
+    const char* _keptDelims;
+
+    // The token returned by the next call to nextToken()
+    std::string_view _next;
+    bool _hasNext;
+
+    // Holds the next token if it cannot refer to the buffer
+    std::string _nextBuffer;
+    bool _nextIsBuffered;
+
+    // Holds the last returned token if it couldn't refer to the buffer
+    std::string _tokenBuffer;
+
+public:
+    /**
+     * Construct a DefTokeniser working on the given buffer, and optionally
+     * a list of separators.
+     *
+     * @param str
+     * The characters to tokenise, these are not copied.
+     *
+     * @param delims
+     * The list of characters to use as delimiters.
+     *
+     * @param keptDelims
+     * String of characters to treat as delimiters but return as tokens in their
+     * own right.
+     */
+    BasicDefTokeniser(std::string_view str,
+                      const char* delims = WHITESPACE,
+                      const char* keptDelims = "{}()") :
+        _begin(str.data()),
+        _cur(str.data()),
+        _end(str.data() + str.size()),
+        _delims(delims),
+        _keptDelims(keptDelims),
+        _hasNext(false),
+        _nextIsBuffered(false)
+    {
+        advance();
+    }
+
+    // The next token might refer to the internal buffer
+    BasicDefTokeniser(const BasicDefTokeniser& other) = delete;
+    BasicDefTokeniser& operator=(const BasicDefTokeniser& other) = delete;
+
+    bool hasMoreTokens() const override
+    {
+        return _hasNext;
+    }
+
+    std::string nextToken() override
+    {
+        return std::string(nextTokenView());
+    }
+
+    std::string_view nextTokenView() override
+    {
+        if (!_hasNext)
+        {
+            throw ParseException("DefTokeniser: no more tokens");
+        }
+
+        auto token = _next;
+
+        if (_nextIsBuffered)
+        {
+            // Keep the contents alive while the following token is searched
+            _tokenBuffer.swap(_nextBuffer);
+            token = _tokenBuffer;
+        }
+
+        advance();
+
+        return token;
+    }
+
+    void assertNextToken(const std::string& val) override
+    {
+        auto tok = nextTokenView();
+
+        if (tok != val)
+        {
+            throw ParseException("DefTokeniser: Assertion failed: Required \""
+                + val + "\", found \"" + std::string(tok) + "\"");
+        }
+    }
+
+    void skipTokens(unsigned int n) override
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            nextTokenView();
+        }
+    }
+
+    std::string peek() const override
+    {
+        if (_hasNext)
+        {
+            return std::string(_next);
+        }
+
+        throw ParseException("DefTokeniser: no more tokens");
+    }
+
+    // The number of characters processed so far, including the token returned next
+    std::size_t getPosition() const
+    {
+        return static_cast<std::size_t>(_cur - _begin);
+    }
+
+private:
+    static bool contains(const char* chars, char c)
+    {
+        while (*chars != 0)
+        {
+            if (*(chars++) == c)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool isDelim(char c) const
+    {
+        return contains(_delims, c);
+    }
+
+    bool isKeptDelim(char c) const
+    {
+        return contains(_keptDelims, c);
+    }
+
+    void advance()
+    {
+        _nextIsBuffered = false;
+        _hasNext = findToken();
+    }
+
+    // Searches the next token, see DefTokeniserFunc for the rules
+    bool findToken()
+    {
+        while (_cur != _end)
+        {
+            if (isDelim(*_cur))
+            {
+                ++_cur;
+                continue;
+            }
+
+            if (isKeptDelim(*_cur))
+            {
+                _next = std::string_view(_cur++, 1);
+                return true;
+            }
+
+            if (*_cur == '\"')
+            {
+                ++_cur;
+                return findQuotedToken();
+            }
+
+            if (*_cur == '/')
+            {
+                // A single slash at the end is ignored
+                if (_cur + 1 == _end)
+                {
+                    ++_cur;
+                    return false;
+                }
+
+                if (_cur[1] == '/' || _cur[1] == '*')
+                {
+                    skipComment();
+                    continue;
+                }
+            }
+
+            return findUnquotedToken();
+        }
+
+        return false;
+    }
+
+    bool findUnquotedToken()
+    {
+        auto start = _cur;
+
+        while (_cur != _end)
+        {
+            auto c = *_cur;
+
+            if (isDelim(c) || isKeptDelim(c) || c == '\"')
+            {
+                break;
+            }
+
+            if (c == '/')
+            {
+                // A trailing slash is not part of the token
+                if (_cur + 1 == _end)
+                {
+                    _next = std::string_view(start, _cur++ - start);
+                    return true;
+                }
+
+                // A comment is ending the token
+                if (_cur[1] == '/' || _cur[1] == '*')
+                {
+                    _next = std::string_view(start, _cur - start);
+                    skipComment();
+                    return true;
+                }
+            }
+
+            ++_cur;
+        }
+
+        _next = std::string_view(start, _cur - start);
+        return true;
+    }
+
+    // Expects the current position to be right after the opening quote
+    bool findQuotedToken()
+    {
+        auto start = _cur;
+
+        // Quoted tokens without escape sequences can refer to the buffer
+        while (_cur != _end && *_cur != '\"' && *_cur != '\\')
+        {
+            ++_cur;
+        }
+
+        if (_cur == _end)
+        {
+            // Unterminated quote, only non-empty tokens are returned
+            _next = std::string_view(start, _cur - start);
+            return !_next.empty();
+        }
+
+        if (*_cur == '\"')
+        {
+            _next = std::string_view(start, _cur - start);
+            ++_cur;
+
+            switch (findContinuation())
+            {
+            case Continuation::None:
+                return true;
+            case Continuation::EndOfInput:
+                return !_next.empty();
+            case Continuation::Quote:
+                break;
+            }
+        }
+        else
+        {
+            // Found an escape sequence
+            _next = std::string_view(start, _cur - start);
+        }
+
+        _nextBuffer.assign(_next.data(), _next.size());
+        _nextIsBuffered = true;
+
+        return findBufferedQuotedToken();
+    }
+
+    // Continues a quoted token in the buffer
+    bool findBufferedQuotedToken()
+    {
+        while (true)
+        {
+            while (_cur != _end && *_cur != '\"')
+            {
+                if (*_cur == '\\')
+                {
+                    // Escape found, check next character
+                    if (++_cur == _end) break;
+
+                    switch (*_cur)
+                    {
+                    case 'n': _nextBuffer += '\n'; break;
+                    case 't': _nextBuffer += '\t'; break;
+                    case '\"': _nextBuffer += '\"'; break;
+                    default:
+                        // No special escape sequence, keep the backslash
+                        _nextBuffer += '\\';
+                        _nextBuffer += *_cur;
+                    }
+
+                    ++_cur;
+                    continue;
+                }
+
+                _nextBuffer += *(_cur++);
+            }
+
+            _next = _nextBuffer;
+
+            if (_cur == _end)
+            {
+                return !_nextBuffer.empty();
+            }
+
+            // Step over the closing quote
+            ++_cur;
+
+            switch (findContinuation())
+            {
+            case Continuation::None:
+                return true;
+            case Continuation::EndOfInput:
+                return !_nextBuffer.empty();
+            case Continuation::Quote:
+                continue;
+            }
+        }
+    }
+
+    enum class Continuation
+    {
+        None,       // the quoted token is not continued
+        Quote,      // a backslash and an opening quote have been found
+        EndOfInput, // the input ended after the backslash
+    };
+
+    // Checks for a backslash after the closing quote, which continues the quoted token
+    Continuation findContinuation()
+    {
+        while (_cur != _end && *_cur != '\\')
+        {
+            if (!isDelim(*_cur))
+            {
+                return Continuation::None;
+            }
+
+            ++_cur;
+        }
+
+        if (_cur == _end)
+        {
+            return Continuation::None;
+        }
+
+        // Step over the backslash and search for the opening quote
+        for (++_cur; _cur != _end; ++_cur)
+        {
+            if (*_cur == '\"')
+            {
+                ++_cur;
+                return Continuation::Quote;
+            }
+
+            if (!isDelim(*_cur))
+            {
+                throw ParseException("Could not find opening double quote after backslash.");
+            }
+        }
+
+        return Continuation::EndOfInput;
+    }
+
+    void skipComment()
+    {
+        if (_cur[1] == '/')
+        {
+            // The comment lasts until the end of the line
+            for (_cur += 2; _cur != _end; )
+            {
+                auto c = *(_cur++);
+
+                if (c == '\r' || c == '\n') break;
+            }
+
+            return;
+        }
+
+        // Search for the end of the delimited comment
+        for (_cur += 2; _cur != _end; ++_cur)
+        {
+            if (*_cur == '*' && _cur + 1 != _end && _cur[1] == '/')
+            {
+                _cur += 2;
+                return;
+            }
+        }
+    }
+};
+
 /**
  * Specialisation of DefTokeniser to work with std::istream objects. This is
  * needed because an std::istream does not provide begin() and end() methods
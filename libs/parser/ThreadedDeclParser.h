@@ -1,9 +1,12 @@
 #pragma once
 
+#include <algorithm>
+#include <functional>
 #include "ifilesystem.h"
 #include "itextstream.h"
 #include "idecltypes.h"
 #include "debugging/ScopedDebugTimer.h"
+#include "time/TraceRecorder.h"
 #include "parser/ParseException.h"
 #include "parser/ThreadedDefLoader.h"
 
@@ -55,11 +58,16 @@ protected:
     // Main parse entry point, process all files
     ReturnType doParse()
     {
+        util::ScopedTraceEvent trace("decl", "ThreadedDeclParser " + decl::getTypeName(_declType));
+
         try
         {
             onBeginParsing();
 
-            processFiles();
+            {
+                ScopedDebugTimer timer("[DeclParser] Parsed " + decl::getTypeName(_declType) + " declarations");
+                processFiles(collectFiles());
+            }
 
             return onFinishParsing();
         }
@@ -73,43 +81,57 @@ protected:
     // Parse all decls found in the given stream, to be implemented by subclasses
     virtual void parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) = 0;
 
-    void processFiles()
+    // Collects all files matching the extension in the base folder, sorted by name
+    std::vector<vfs::FileInfo> collectFiles()
     {
-        ScopedDebugTimer timer("[DeclParser] Parsed " + decl::getTypeName(_declType) + " declarations");
-
-        // Accumulate all the files and sort them before calling the protected parse() method
-        std::vector<vfs::FileInfo> _incomingFiles;
-        _incomingFiles.reserve(200);
+        std::vector<vfs::FileInfo> files;
+        files.reserve(200);
 
         GlobalFileSystem().forEachFile(_baseDir, _extension, [&](const vfs::FileInfo& info)
         {
-            _incomingFiles.push_back(info);
+            files.push_back(info);
         }, _depth);
 
         // Sort the files by name
-        std::sort(_incomingFiles.begin(), _incomingFiles.end(), [](const vfs::FileInfo& a, const vfs::FileInfo& b)
+        std::sort(files.begin(), files.end(), [](const vfs::FileInfo& a, const vfs::FileInfo& b)
         {
             return a.name < b.name;
         });
 
-        // Dispatch the sorted list to the protected parse() method
-        for (const auto& fileInfo : _incomingFiles)
-        {
-            auto file = GlobalFileSystem().openTextFile(fileInfo.fullPath());
+        return files;
+    }
 
-            if (!file) continue;
+    // Opens the given file and passes its contents to the given functor, parse errors are logged
+    void processFile(const vfs::FileInfo& fileInfo,
+        const std::function<void(std::istream& stream, const std::string& modDir)>& parseFunc) const
+    {
+        auto file = GlobalFileSystem().openTextFile(fileInfo.fullPath());
 
-            try
-            {
-                // Parse entity defs from the file
-                std::istream stream(&file->getInputStream());
-                parse(stream, fileInfo, file->getModName());
-            }
-            catch (ParseException& e)
+        if (!file) return;
+
+        try
+        {
+            std::istream stream(&file->getInputStream());
+            parseFunc(stream, file->getModName());
+        }
+        catch (ParseException& e)
+        {
+            rError() << "[DeclParser] Failed to parse " << fileInfo.fullPath()
+                << " (" << e.what() << ")" << std::endl;
+        }
+    }
+
+    // Dispatches the sorted files to the protected parse() method, one after the other.
+    // Subclasses can override this to process the files concurrently, as long as
+    // the results are applied in the given order.
+    virtual void processFiles(const std::vector<vfs::FileInfo>& files)
+    {
+        for (const auto& fileInfo : files)
+        {
+            processFile(fileInfo, [&](std::istream& stream, const std::string& modDir)
             {
-                rError() << "[DeclParser] Failed to parse " << fileInfo.fullPath()
-                    << " (" << e.what() << ")" << std::endl;
-            }
+                parse(stream, fileInfo, modDir);
+            });
         }
     }
 };
@@ -5,12 +5,14 @@
 #include <algorithm>
 #include <sigc++/signal.h>
 #include <vector>
+#include "itaskscheduler.h"
 
 namespace parser
 {
 
 /**
- * Helper class used to asynchronically parse/load def files in a separate thread.
+ * Helper class used to asynchronically parse/load def files in a task of the
+ * shared ITaskScheduler pool.
  *
  * The worker thread itself is ensured to be called in a thread-safe 
  * way (to prevent the worker from being invoked twice). Subsequent calls to 
@@ -32,7 +34,8 @@ private:
     FinishedSignal _finishedSignal;
 
     std::shared_future<ReturnType> _result;
-    std::shared_future<void> _finisher;
+    threading::TaskPtr _loadTask;
+    threading::TaskPtr _finisher;
     std::mutex _mutex;
 
     bool _loadingStarted;
@@ -73,6 +76,8 @@ public:
         ensureLoaderStarted();
 
         // Wait for the result or return if it's already done.
+        // If the task is still queued, this thread is running it.
+        _loadTask->wait();
         return _result.get();
     }
 
@@ -85,18 +90,19 @@ public:
         // Wait for any running thread to finish
         if (_loadingStarted)
         {
-            if (_result.valid())
+            if (_loadTask)
             {
-                _result.get();
+                _loadTask->wait();
             }
 
-            if (_finisher.valid())
+            if (_finisher)
             {
-                _finisher.get();
+                _finisher->wait();
             }
 
             _result = std::shared_future<ReturnType>();
-            _finisher = std::shared_future<void>();
+            _loadTask.reset();
+            _finisher.reset();
 
             _loadingStarted = false;
         }
@@ -111,16 +117,16 @@ private:
     struct FinishSignalEmitter
     {
         FinishedSignal& _signal;
-        std::shared_future<void>& _targetFuture;
+        threading::TaskPtr& _targetTask;
 
-        FinishSignalEmitter(FinishedSignal& signal, std::shared_future<void>& targetFuture) :
+        FinishSignalEmitter(FinishedSignal& signal, threading::TaskPtr& targetTask) :
             _signal(signal),
-            _targetFuture(targetFuture)
+            _targetTask(targetTask)
         {}
 
         ~FinishSignalEmitter()
         {
-            _targetFuture = std::async(std::launch::async, std::bind(&FinishedSignal::emit, _signal));
+            _targetTask = GlobalTaskScheduler().submit([signal = _signal]() { signal.emit(); });
         }
     };
 
@@ -131,12 +137,16 @@ private:
         if (!_loadingStarted)
         {
             _loadingStarted = true;
-            _result = std::async(std::launch::async, [&]()
+
+            auto loader = std::make_shared<std::packaged_task<ReturnType()>>([this]()
             {
-                // When going out of scope, this instance invokes the finished signal in a separate thread
+                // When going out of scope, this instance invokes the finished signal in a separate task
                 FinishSignalEmitter finisher(_finishedSignal, _finisher);
                 return _loadFunc();
             });
+
+            _result = loader->get_future().share();
+            _loadTask = GlobalTaskScheduler().submit([loader]() { (*loader)(); });
         }
     }
 };
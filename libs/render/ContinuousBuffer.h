@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <cstdint>
+#include <map>
+#include <set>
 #include <stack>
 #include <limits>
 #include <vector>
@@ -30,6 +33,11 @@ struct BufferTransaction
  *
  * Use the allocate/deallocate methods to acquire or release a chunk of
  * a certain size. The chunk size is fixed and cannot be changed.
+ *
+ * Free chunks are indexed by size (best-fit allocation) and all chunks by
+ * their offset (merging of adjacent free chunks), such that allocations
+ * don't need to scan the whole slot list. The gaps left behind by released
+ * chunks can be closed incrementally using compact().
  */
 template<typename ElementType>
 class ContinuousBuffer
@@ -71,6 +79,19 @@ private:
     // A stack of slots that can be re-used instead
     std::stack<Handle> _emptySlots;
 
+    // All slots with a non-zero size, keyed by their offset
+    std::map<std::size_t, Handle> _slotsByOffset;
+
+    // The offsets of all free slots, ordered by (size, offset) for best-fit lookups
+    std::set<std::pair<std::size_t, std::size_t>> _freeSlotsBySize;
+
+    // The offsets of all free slots in ascending order
+    std::set<std::size_t> _freeSlotOffsets;
+
+    // Identifies the state of the slot allocation (the index structures above),
+    // equal revisions refer to identical allocation states
+    std::size_t _layoutRevision;
+
     // Last data size that was synced to the buffer object
     std::size_t _lastSyncedBufferSize;
 
@@ -88,6 +109,7 @@ private:
 
 public:
     ContinuousBuffer(std::size_t initialSize = DefaultInitialSize) :
+        _layoutRevision(NextLayoutRevision()),
         _lastSyncedBufferSize(0),
         _allocatedElements(0)
     {
@@ -98,7 +120,10 @@ public:
         createSlotInfo(0, _buffer.size());
     }
 
-    ContinuousBuffer(const ContinuousBuffer& other)
+    ContinuousBuffer(const ContinuousBuffer& other) :
+        _layoutRevision(0),
+        _lastSyncedBufferSize(0),
+        _allocatedElements(0)
     {
         *this = other;
     }
@@ -113,9 +138,16 @@ public:
         memcpy(_slots.data(), other._slots.data(), other._slots.size() * sizeof(SlotInfo));
 
         _emptySlots = other._emptySlots;
+        _slotsByOffset = other._slotsByOffset;
+        _freeSlotsBySize = other._freeSlotsBySize;
+        _freeSlotOffsets = other._freeSlotOffsets;
+        _layoutRevision = other._layoutRevision;
         _unsyncedModifications = other._unsyncedModifications;
         _allocatedElements = other._allocatedElements;
 
+        // The buffer object this instance is synced to didn't receive any of the copied data
+        _lastSyncedBufferSize = 0;
+
         return *this;
     }
 
@@ -124,6 +156,7 @@ public:
         auto handle = getNextFreeSlotForSize(requiredSize);
 
         _allocatedElements += requiredSize;
+        _layoutRevision = NextLayoutRevision();
 
         return handle;
     }
@@ -224,40 +257,46 @@ public:
     void deallocate(Handle handle)
     {
         auto& releasedSlot = _slots[handle];
-        releasedSlot.Occupied = false;
-        releasedSlot.Used = 0;
 
         _allocatedElements -= releasedSlot.Size;
+        _layoutRevision = NextLayoutRevision();
 
-        // Check if the slot can merge with an adjacent one
-        Handle slotIndexToMerge = std::numeric_limits<Handle>::max();
-        if (findLeftFreeSlot(releasedSlot, slotIndexToMerge))
+        // Empty slots don't take up any space, their handle can be recycled right away
+        if (releasedSlot.Size == 0)
         {
-            auto& slotToMerge = _slots[slotIndexToMerge];
+            recycleSlot(handle);
+            return;
+        }
 
-            releasedSlot.Offset = slotToMerge.Offset;
-            releasedSlot.Size += slotToMerge.Size;
+        unindexSlot(handle);
 
-            // The merged handle goes to recycling, block it against future use
-            slotToMerge.Size = 0;
-            slotToMerge.Used = 0;
-            slotToMerge.Occupied = true;
-            _emptySlots.push(slotIndexToMerge);
-        }
+        releasedSlot.Occupied = false;
+        releasedSlot.Used = 0;
 
-        // Try to find an adjacent free slot to the right
-        if (findRightFreeSlot(releasedSlot, slotIndexToMerge))
+        // Check if the slot can merge with an adjacent one to the left
+        auto rightNeighbour = _slotsByOffset.lower_bound(releasedSlot.Offset);
+
+        if (rightNeighbour != _slotsByOffset.begin())
         {
+            auto slotIndexToMerge = std::prev(rightNeighbour)->second;
             auto& slotToMerge = _slots[slotIndexToMerge];
 
-            releasedSlot.Size += slotToMerge.Size;
+            if (!slotToMerge.Occupied)
+            {
+                unindexSlot(slotIndexToMerge);
+
+                releasedSlot.Offset = slotToMerge.Offset;
+                releasedSlot.Size += slotToMerge.Size;
 
-            // The merged handle goes to recycling, block it against future use
-            slotToMerge.Size = 0;
-            slotToMerge.Used = 0;
-            slotToMerge.Occupied = true;
-            _emptySlots.push(slotIndexToMerge);
+                // The merged handle goes to recycling
+                recycleSlot(slotIndexToMerge);
+            }
         }
+
+        // Try to find an adjacent free slot to the right
+        mergeWithRightNeighbour(handle);
+
+        indexSlot(handle);
     }
 
     void applyTransactions(const std::vector<detail::BufferTransaction>& transactions, const ContinuousBuffer<ElementType>& other,
@@ -303,13 +342,116 @@ public:
         memcpy(_slots.data(), other._slots.data(), other._slots.size() * sizeof(SlotInfo));
 
         _allocatedElements = other._allocatedElements;
-        _emptySlots = other._emptySlots;
+
+        // The index structures only need to be copied if the allocations changed
+        if (_layoutRevision != other._layoutRevision)
+        {
+            _emptySlots = other._emptySlots;
+            _slotsByOffset = other._slotsByOffset;
+            _freeSlotsBySize = other._freeSlotsBySize;
+            _freeSlotOffsets = other._freeSlotOffsets;
+            _layoutRevision = other._layoutRevision;
+        }
+    }
+
+    /**
+     * Closes the gaps left behind by released slots by moving occupied slots towards
+     * the start of the buffer, collecting the free space at its end. The buffer itself
+     * is not shrunk. Only the moved slots are marked as modified, the next sync will
+     * upload them without having to transfer the whole buffer.
+     *
+     * Moves slots until at least maxElementsToMove elements have been moved, such that
+     * the work can be spread over several calls. Handles stay valid, only their offset
+     * is changing. The handle of every moved slot is passed to the given functor.
+     * Returns true if the buffer is fully compacted.
+     */
+    template<typename MovedFunc>
+    bool compact(std::size_t maxElementsToMove, const MovedFunc& onSlotMoved)
+    {
+        std::size_t movedElements = 0;
+
+        while (!_freeSlotOffsets.empty())
+        {
+            auto freeHandle = _slotsByOffset.at(*_freeSlotOffsets.begin());
+            auto next = _slotsByOffset.find(_slots[freeHandle].Offset + _slots[freeHandle].Size);
+
+            // The leftmost free slot is the one at the end of the buffer, we're done
+            if (next == _slotsByOffset.end()) return true;
+
+            if (movedElements >= maxElementsToMove) return false;
+
+            // Adjacent free slots are always merged, so the next one is occupied
+            auto movedHandle = next->second;
+            assert(_slots[movedHandle].Occupied);
+
+            unindexSlot(freeHandle);
+            unindexSlot(movedHandle);
+
+            auto& freeSlot = _slots[freeHandle];
+            auto& movedSlot = _slots[movedHandle];
+
+            // Swap the two slots, the ranges might overlap but the data is moved to the left
+            std::copy(_buffer.begin() + movedSlot.Offset, _buffer.begin() + movedSlot.Offset + movedSlot.Used,
+                _buffer.begin() + freeSlot.Offset);
+
+            movedSlot.Offset = freeSlot.Offset;
+            freeSlot.Offset = movedSlot.Offset + movedSlot.Size;
+
+            mergeWithRightNeighbour(freeHandle);
+
+            indexSlot(movedHandle);
+            indexSlot(freeHandle);
+
+            if (movedSlot.Used > 0)
+            {
+                _unsyncedModifications.emplace_back(ModifiedMemoryChunk{ movedHandle, 0, movedSlot.Used });
+            }
+
+            movedElements += movedSlot.Used;
+            _layoutRevision = NextLayoutRevision();
+
+            onSlotMoved(movedHandle);
+        }
+
+        return true;
+    }
+
+    // The number of free elements that are not part of the free space at the end of the buffer
+    std::size_t getNumFragmentedElements() const
+    {
+        auto numFreeElements = _buffer.size() - _allocatedElements;
+
+        if (_slotsByOffset.empty()) return numFreeElements;
+
+        const auto& lastSlot = _slots[_slotsByOffset.rbegin()->second];
+
+        return lastSlot.Occupied ? numFreeElements : numFreeElements - lastSlot.Size;
     }
 
     // Copies the updated memory to the given buffer object
     void syncModificationsToBufferObject(const IBufferObject::Ptr& buffer)
     {
-        auto currentBufferSize = _buffer.size() * sizeof(ElementType);
+        syncModificationsToBufferObject(buffer, sizeof(ElementType),
+            [&](std::size_t firstElement, std::size_t numElements)
+        {
+            buffer->setData(firstElement * sizeof(ElementType),
+                reinterpret_cast<unsigned char*>(_buffer.data() + firstElement),
+                numElements * sizeof(ElementType));
+        });
+    }
+
+    /**
+     * Syncs the updated memory to the given buffer object, which is sized to hold
+     * bytesPerElement bytes for each element of this buffer. The given functor is
+     * responsible for converting and uploading the data, it is invoked with the index
+     * of the first element and the number of elements of every modified range.
+     * The buffer object is bound during the calls.
+     */
+    template<typename UploadFunc>
+    void syncModificationsToBufferObject(const IBufferObject::Ptr& buffer, std::size_t bytesPerElement,
+        const UploadFunc& uploadElements)
+    {
+        auto currentBufferSize = _buffer.size() * bytesPerElement;
 
         // On size change we upload everything
         if (_lastSyncedBufferSize != currentBufferSize)
@@ -320,8 +462,7 @@ public:
 
             // Re-upload everything
             buffer->bind();
-            buffer->setData(0, reinterpret_cast<unsigned char*>(_buffer.data()),
-                _buffer.size() * sizeof(ElementType));
+            uploadElements(0, _buffer.size());
             buffer->unbind();
         }
         else
@@ -365,16 +506,12 @@ public:
                     {
                         auto& slot = _slots[modifiedChunk.handle];
 
-                        buffer->setData((slot.Offset + modifiedChunk.offset) * sizeof(ElementType),
-                            reinterpret_cast<unsigned char*>(_buffer.data() + slot.Offset + modifiedChunk.offset),
-                            modifiedChunk.numElements * sizeof(ElementType));
+                        uploadElements(slot.Offset + modifiedChunk.offset, modifiedChunk.numElements);
                     }
                 }
                 else // copy everything in between minimum and maximum in one operation
                 {
-                    buffer->setData(minimumOffset * sizeof(ElementType),
-                        reinterpret_cast<unsigned char*>(_buffer.data() + minimumOffset),
-                        (maximumOffset - minimumOffset) * sizeof(ElementType));
+                    uploadElements(minimumOffset, maximumOffset - minimumOffset);
                 }
 
                 buffer->unbind();
@@ -384,79 +521,118 @@ public:
         _unsyncedModifications.clear();
     }
 
+    // The number of elements the underlying memory block can hold, including the unallocated ones
+    std::size_t getNumBufferElements() const
+    {
+        return _buffer.size();
+    }
+
+    // Makes the next sync re-upload the whole buffer, e.g. after switching the buffer object
+    void invalidateSyncedBufferObject()
+    {
+        _lastSyncedBufferSize = 0;
+    }
+
 private:
-    bool findLeftFreeSlot(const SlotInfo& slotToTouch, Handle& found)
+    static std::size_t NextLayoutRevision()
     {
-        auto numSlots = _slots.size();
+        static std::atomic<std::size_t> _nextRevision(1);
+        return _nextRevision++;
+    }
+
+    // Adds the slot to the index structures, to be called after changing its offset, size or occupancy
+    void indexSlot(Handle handle)
+    {
+        const auto& slot = _slots[handle];
+
+        if (slot.Size == 0) return;
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
+        _slotsByOffset[slot.Offset] = handle;
+
+        if (!slot.Occupied)
         {
-            const auto& candidate = _slots[slotIndex];
+            _freeSlotsBySize.emplace(slot.Size, slot.Offset);
+            _freeSlotOffsets.insert(slot.Offset);
+        }
+    }
 
-            if (candidate.Offset + candidate.Size == slotToTouch.Offset)
-            {
-                // The slot coordinates match, return true if this block is free
-                found = slotIndex;
-                return !candidate.Occupied;
-            }
+    // Removes the slot from the index structures, to be called before changing its offset, size or occupancy
+    void unindexSlot(Handle handle)
+    {
+        const auto& slot = _slots[handle];
+
+        if (slot.Size == 0) return;
+
+        assert(_slotsByOffset.at(slot.Offset) == handle);
+        _slotsByOffset.erase(slot.Offset);
+
+        if (!slot.Occupied)
+        {
+            _freeSlotsBySize.erase({ slot.Size, slot.Offset });
+            _freeSlotOffsets.erase(slot.Offset);
         }
+    }
+
+    // Blocks the (unindexed) slot against future use, until createSlotInfo() hands it out again
+    void recycleSlot(Handle handle)
+    {
+        auto& slot = _slots[handle];
 
-        return false;
+        slot.Size = 0;
+        slot.Used = 0;
+        slot.Occupied = true;
+        _emptySlots.push(handle);
     }
 
-    bool findRightFreeSlot(const SlotInfo& slotToTouch, Handle& found)
+    // Merges the (unindexed) free slot with the free slot following it, if there is one
+    void mergeWithRightNeighbour(Handle handle)
     {
-        auto numSlots = _slots.size();
-        auto offsetToMatch = slotToTouch.Offset + slotToTouch.Size;
+        auto& slot = _slots[handle];
+        auto rightNeighbour = _slotsByOffset.find(slot.Offset + slot.Size);
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
-        {
-            const auto& candidate = _slots[slotIndex];
+        if (rightNeighbour == _slotsByOffset.end() || _slots[rightNeighbour->second].Occupied) return;
 
-            if (candidate.Offset == offsetToMatch)
-            {
-                // The slot coordinates match, return true if this block is free
-                found = slotIndex;
-                return !candidate.Occupied;
-            }
-        }
+        auto slotIndexToMerge = rightNeighbour->second;
+        unindexSlot(slotIndexToMerge);
 
-        return false;
+        slot.Size += _slots[slotIndexToMerge].Size;
+
+        // The merged handle goes to recycling
+        recycleSlot(slotIndexToMerge);
     }
 
-    Handle getNextFreeSlotForSize(std::size_t requiredSize)
+    // Marks the free slot as occupied, the space exceeding the given size is split off into a new free slot
+    void occupySlot(Handle handle, std::size_t size)
     {
-        auto numSlots = _slots.size();
-        Handle rightmostFreeSlotIndex = static_cast<Handle>(numSlots);
-        std::size_t rightmostFreeOffset = 0;
-        std::size_t rightmostFreeSize = 0;
+        unindexSlot(handle);
 
-        for (Handle slotIndex = 0; slotIndex < numSlots; ++slotIndex)
-        {
-            auto& slot = _slots[slotIndex];
+        auto& slot = _slots[handle];
 
-            if (slot.Occupied) continue;
+        assert(!slot.Occupied && slot.Size >= size);
 
-            // Keep track of the highest slot, we need that when re-allocating
-            if (slot.Offset > rightmostFreeOffset)
-            {
-                rightmostFreeOffset = slot.Offset;
-                rightmostFreeSize = slot.Size;
-                rightmostFreeSlotIndex = slotIndex;
-            }
+        auto remainingOffset = slot.Offset + size;
+        auto remainingSize = slot.Size - size;
 
-            if (slot.Size < requiredSize) continue; // this slot is no use for us
+        slot.Size = size;
+        slot.Occupied = true;
 
-            // Calculate the remaining size before assignment
-            auto remainingSize = slot.Size - requiredSize;
-            slot.Size = requiredSize;
-            slot.Occupied = true;
+        indexSlot(handle);
 
-            if (remainingSize > 0)
-            {
-                // Allocate a new free slot with the remaining space
-                createSlotInfo(slot.Offset + requiredSize, remainingSize);
-            }
+        if (remainingSize > 0)
+        {
+            createSlotInfo(remainingOffset, remainingSize);
+        }
+    }
+
+    Handle getNextFreeSlotForSize(std::size_t requiredSize)
+    {
+        // Pick the smallest free slot that is large enough, the leftmost one if there are several
+        auto candidate = _freeSlotsBySize.lower_bound({ requiredSize, 0 });
+
+        if (candidate != _freeSlotsBySize.end())
+        {
+            auto slotIndex = _slotsByOffset.at(candidate->second);
+            occupySlot(slotIndex, requiredSize);
 
             return slotIndex;
         }
@@ -469,48 +645,55 @@ private:
         auto newSize = oldBufferSize + additionalSize;
         _buffer.resize(newSize);
 
-        // Ensure that the rightmost free slot is at the end of the buffer, otherwise allocate a new one
-        if (rightmostFreeSlotIndex == numSlots || rightmostFreeOffset + rightmostFreeSize != oldBufferSize)
+        // The slot with the highest offset is ending at the old buffer size,
+        // extend it if it's free, otherwise create a new free slot at the end
+        Handle rightmostFreeSlotIndex;
+
+        if (!_slotsByOffset.empty() && !_slots[_slotsByOffset.rbegin()->second].Occupied)
         {
-            // Create a free slot with 0 size at the end of the storage
-            _slots.emplace_back(oldBufferSize, 0, false);
+            rightmostFreeSlotIndex = _slotsByOffset.rbegin()->second;
 
-            // Adjust rightMostFreeSlotIndex to always point at this new slot
-            rightmostFreeSlotIndex = static_cast<Handle>(numSlots);
+            unindexSlot(rightmostFreeSlotIndex);
+            _slots[rightmostFreeSlotIndex].Size += additionalSize;
+            indexSlot(rightmostFreeSlotIndex);
+        }
+        else
+        {
+            rightmostFreeSlotIndex = createSlotInfo(oldBufferSize, additionalSize);
         }
 
         // Use the right most slot for our requirement, then cut up the rest of the space
-        auto& rightmostFreeSlot = _slots[rightmostFreeSlotIndex];
-
-        assert(rightmostFreeSlot.Size < requiredSize); // otherwise we've run wrong above
-
-        auto remainingSize = rightmostFreeSlot.Size + additionalSize - requiredSize;
-
-        rightmostFreeSlot.Occupied = true;
-        rightmostFreeSlot.Size = requiredSize;
-
-        createSlotInfo(rightmostFreeSlot.Offset + rightmostFreeSlot.Size, remainingSize);
+        occupySlot(rightmostFreeSlotIndex, requiredSize);
 
         return rightmostFreeSlotIndex;
     }
 
-    SlotInfo& createSlotInfo(std::size_t offset, std::size_t size, bool occupied = false)
+    Handle createSlotInfo(std::size_t offset, std::size_t size, bool occupied = false)
     {
+        Handle handle;
+
         if (_emptySlots.empty())
         {
-            return _slots.emplace_back(offset, size, occupied);
+            handle = static_cast<Handle>(_slots.size());
+            _slots.emplace_back(offset, size, occupied);
         }
+        else
+        {
+            // Re-use an old slot
+            handle = _emptySlots.top();
+            _emptySlots.pop();
 
-        // Re-use an old slot
-        auto& slot = _slots.at(_emptySlots.top());
-        _emptySlots.pop();
+            auto& slot = _slots.at(handle);
 
-        slot.Occupied = occupied;
-        slot.Offset = offset;
-        slot.Size = size;
-        slot.Used = 0;
+            slot.Occupied = occupied;
+            slot.Offset = offset;
+            slot.Size = size;
+            slot.Used = 0;
+        }
+
+        indexSlot(handle);
 
-        return slot;
+        return handle;
     }
 };
 
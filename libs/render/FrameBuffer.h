@@ -0,0 +1,187 @@
+#pragma once
+
+#include <memory>
+#include "igl.h"
+#include "debugging/gl.h"
+
+namespace render
+{
+
+// Encapsulates an openGL frame buffer object
+class FrameBuffer
+{
+private:
+    GLuint _fbo;
+    std::size_t _width;
+    std::size_t _height;
+    GLuint _textureNumber;
+    GLuint _depthBuffer;
+
+    // The frame buffer that has been bound before bind() was called
+    GLint _previousFbo;
+
+    FrameBuffer() :
+        _fbo(0),
+        _width(0),
+        _height(0),
+        _textureNumber(0),
+        _depthBuffer(0),
+        _previousFbo(0)
+    {}
+
+public:
+    constexpr static std::size_t DefaultShadowMapSize = 1024 * 6;
+
+    using Ptr = std::shared_ptr<FrameBuffer>;
+
+    ~FrameBuffer()
+    {
+        glDeleteTextures(1, &_textureNumber);
+        _textureNumber = 0;
+
+        glDeleteRenderbuffers(1, &_depthBuffer);
+        _depthBuffer = 0;
+
+        glDeleteFramebuffers(1, &_fbo);
+        _fbo = 0;
+    }
+
+    std::size_t getWidth() const
+    {
+        return _width;
+    }
+
+    std::size_t getHeight() const
+    {
+        return _height;
+    }
+
+    void bind()
+    {
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_previousFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+        debug::assertNoGlErrors();
+    }
+
+    // Re-binds the frame buffer that has been active before bind()
+    void unbind()
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(_previousFbo));
+        _previousFbo = 0;
+        debug::assertNoGlErrors();
+    }
+
+    GLuint getTextureNumber() const
+    {
+        return _textureNumber;
+    }
+
+    static Ptr CreateShadowMapBuffer(std::size_t size = DefaultShadowMapSize)
+    {
+        Ptr buffer(new FrameBuffer);
+
+        // Generate an FBO and an image to attach to it
+        glGenFramebuffers(1, &buffer->_fbo);
+        glGenTextures(1, &buffer->_textureNumber);
+
+        debug::assertNoGlErrors();
+
+        glBindTexture(GL_TEXTURE_2D, buffer->_textureNumber);
+
+        debug::assertNoGlErrors();
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        debug::assertNoGlErrors();
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32F, 
+            static_cast<GLsizei>(size), static_cast<GLsizei>(size),
+            0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
+
+        debug::assertNoGlErrors();
+
+        // Attach the texture to the FBO
+        buffer->bind();
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, buffer->_textureNumber, 0);
+
+        debug::assertNoGlErrors();
+
+        buffer->_width = size;
+        buffer->_height = size;
+
+        buffer->unbind();
+
+        return buffer;
+    }
+
+    // Creates a buffer with an RGBA colour texture and a depth/stencil attachment,
+    // returns an empty pointer if the driver doesn't accept this combination
+    static Ptr CreateColourBuffer(std::size_t width, std::size_t height)
+    {
+        Ptr buffer(new FrameBuffer);
+
+        glGenFramebuffers(1, &buffer->_fbo);
+        glGenTextures(1, &buffer->_textureNumber);
+        glGenRenderbuffers(1, &buffer->_depthBuffer);
+
+        debug::assertNoGlErrors();
+
+        glBindTexture(GL_TEXTURE_2D, buffer->_textureNumber);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8,
+            static_cast<GLsizei>(width), static_cast<GLsizei>(height),
+            0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, buffer->_depthBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8,
+            static_cast<GLsizei>(width), static_cast<GLsizei>(height));
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        debug::assertNoGlErrors();
+
+        buffer->bind();
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, buffer->_textureNumber, 0);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, buffer->_depthBuffer);
+
+        auto status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        buffer->unbind();
+
+        if (status != GL_FRAMEBUFFER_COMPLETE)
+        {
+            return Ptr();
+        }
+
+        buffer->_width = width;
+        buffer->_height = height;
+
+        return buffer;
+    }
+
+    // Copies the given region of the colour attachment into the given region
+    // of the currently bound frame buffer, using linear filtering
+    void blitColour(GLint srcWidth, GLint srcHeight, GLint dstWidth, GLint dstHeight)
+    {
+        GLint targetFbo = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &targetFbo);
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _fbo);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(targetFbo));
+
+        glBlitFramebuffer(0, 0, srcWidth, srcHeight, 0, 0, dstWidth, dstHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFbo));
+        debug::assertNoGlErrors();
+    }
+};
+
+}
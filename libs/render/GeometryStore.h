@@ -3,9 +3,12 @@
 #include <stdexcept>
 #include <limits>
 #include "igeometrystore.h"
+#include "imemoryaccounting.h"
 #include "itextstream.h"
 #include "ContinuousBuffer.h"
+#include "PackedRenderVertex.h"
 #include "string/format.h"
+#include <fmt/format.h>
 
 namespace render
 {
@@ -24,8 +27,6 @@ private:
         IndexRemap = 1,
     };
 
-    static constexpr auto NumFrameBuffers = 1;
-
     // Represents the storage for a single frame
     struct FrameBuffer
     {
@@ -41,6 +42,9 @@ private:
         std::vector<detail::BufferTransaction> vertexTransactionLog;
         std::vector<detail::BufferTransaction> indexTransactionLog;
 
+        // Location of the attribute stream in the vertex buffer object (packed format)
+        std::size_t packedAttributesOffset = 0;
+
         void applyTransactions(const FrameBuffer& other)
         {
             vertices.applyTransactions(other.vertexTransactionLog, other.vertices, GetVertexSlot);
@@ -53,6 +57,34 @@ private:
             indices.syncModificationsToBufferObject(indexBufferObject);
         }
 
+        // Uploads the vertices as two separate streams: positions and packed attributes
+        void syncToBufferObjectsPacked(std::vector<Vector3f>& positions, std::vector<PackedVertexAttributes>& attributes)
+        {
+            packedAttributesOffset = vertices.getNumBufferElements() * sizeof(Vector3f);
+
+            vertices.syncModificationsToBufferObject(vertexBufferObject, PackedVertexSize,
+                [&](std::size_t firstVertex, std::size_t numVertices)
+            {
+                positions.resize(numVertices);
+                attributes.resize(numVertices);
+
+                auto vertex = vertices.getBufferStart() + firstVertex;
+
+                for (std::size_t i = 0; i < numVertices; ++i, ++vertex)
+                {
+                    positions[i] = vertex->vertex;
+                    attributes[i] = PackedVertexAttributes(*vertex);
+                }
+
+                vertexBufferObject->setData(firstVertex * sizeof(Vector3f),
+                    reinterpret_cast<const unsigned char*>(positions.data()), numVertices * sizeof(Vector3f));
+                vertexBufferObject->setData(packedAttributesOffset + firstVertex * sizeof(PackedVertexAttributes),
+                    reinterpret_cast<const unsigned char*>(attributes.data()), numVertices * sizeof(PackedVertexAttributes));
+            });
+
+            indices.syncModificationsToBufferObject(indexBufferObject);
+        }
+
         void recordVertexTransaction(Slot slot, std::size_t offset, std::size_t numChangedElements)
         {
             vertexTransactionLog.emplace_back(detail::BufferTransaction
@@ -70,31 +102,143 @@ private:
         }
     };
 
-    // We keep a fixed number of frame buffers
+    // We keep a fixed number of frame buffers, cycled through in ring-buffer fashion
     std::vector<FrameBuffer> _frameBuffers;
     unsigned int _currentBuffer;
 
     ISyncObjectProvider& _syncObjectProvider;
+    IBufferObjectProvider& _bufferObjectProvider;
+
+    VertexFormat _vertexFormat;
+
+    // Set while the gaps in the buffers are being closed, spread over several frames
+    bool _compactionInProgress;
+
+    // Conversion buffers used when uploading packed vertices
+    std::vector<Vector3f> _positionUploadBuffer;
+    std::vector<PackedVertexAttributes> _attributeUploadBuffer;
 
 public:
-    GeometryStore(ISyncObjectProvider& syncObjectProvider, IBufferObjectProvider& bufferObjectProvider) :
+    // The number of frame buffers recommended for multi-buffered operation
+    static constexpr std::size_t MultiBufferedFrameCount = 3;
+
+    // The maximum number of elements moved per frame and buffer when compacting
+    static constexpr std::size_t CompactionElementsPerFrame = 16384;
+
+    // Bytes per vertex in the buffer objects when using the packed vertex format
+    static constexpr std::size_t PackedVertexSize = sizeof(Vector3f) + sizeof(PackedVertexAttributes);
+
+    GeometryStore(ISyncObjectProvider& syncObjectProvider, IBufferObjectProvider& bufferObjectProvider,
+                  std::size_t numFrameBuffers = 1) :
         _currentBuffer(0),
-        _syncObjectProvider(syncObjectProvider)
+        _syncObjectProvider(syncObjectProvider),
+        _bufferObjectProvider(bufferObjectProvider),
+        _vertexFormat(VertexFormat::Interleaved),
+        _compactionInProgress(false)
     {
-        _frameBuffers.resize(NumFrameBuffers);
+        if (numFrameBuffers == 0)
+        {
+            throw std::invalid_argument("GeometryStore needs at least one frame buffer");
+        }
+
+        _frameBuffers.resize(numFrameBuffers);
 
         // Assign (empty) buffer objects to the frames
         for (auto& frameBuffer : _frameBuffers)
         {
-            frameBuffer.vertexBufferObject = bufferObjectProvider.createBufferObject(IBufferObject::Type::Vertex);
-            frameBuffer.indexBufferObject = bufferObjectProvider.createBufferObject(IBufferObject::Type::Index);
+            createBufferObjects(frameBuffer);
+        }
+    }
+
+    std::size_t getNumFrameBuffers() const
+    {
+        return _frameBuffers.size();
+    }
+
+    /**
+     * Changes the number of frame buffers this store is cycling through.
+     * Waits for all pending frames to finish, then duplicates the data of the
+     * current buffer into the new set of buffers. Fresh buffer objects are acquired
+     * from the IBufferObjectProvider, they will be fully uploaded on the next sync.
+     *
+     * Must not be called in between onFrameStart() and onFrameFinished().
+     */
+    void setNumFrameBuffers(std::size_t numFrameBuffers)
+    {
+        if (numFrameBuffers == 0)
+        {
+            throw std::invalid_argument("GeometryStore needs at least one frame buffer");
+        }
+
+        // Make sure the GPU is no longer using any of our buffer objects
+        for (auto& frameBuffer : _frameBuffers)
+        {
+            if (frameBuffer.syncObject)
+            {
+                frameBuffer.syncObject->wait();
+                frameBuffer.syncObject.reset();
+            }
+        }
+
+        // The current buffer is holding the most recent state of all slots
+        const auto& current = getCurrentBuffer();
+
+        std::vector<FrameBuffer> frameBuffers(numFrameBuffers);
+
+        for (auto& frameBuffer : frameBuffers)
+        {
+            frameBuffer.vertices = current.vertices;
+            frameBuffer.indices = current.indices;
+
+            createBufferObjects(frameBuffer);
+        }
+
+        _frameBuffers.swap(frameBuffers);
+        _currentBuffer = 0;
+    }
+
+    VertexFormat getVertexFormat() const override
+    {
+        return _vertexFormat;
+    }
+
+    /**
+     * Changes the layout of the vertex data in the buffer objects. The packed format
+     * requires support for the GL_INT_2_10_10_10_REV attribute type (OpenGL 3.3).
+     * Waits for all pending frames to finish, the buffer objects will be fully
+     * uploaded on the next sync.
+     *
+     * Must not be called in between onFrameStart() and onFrameFinished().
+     */
+    void setVertexFormat(VertexFormat format)
+    {
+        if (format == _vertexFormat) return;
+
+        for (auto& frameBuffer : _frameBuffers)
+        {
+            if (frameBuffer.syncObject)
+            {
+                frameBuffer.syncObject->wait();
+                frameBuffer.syncObject.reset();
+            }
+
+            frameBuffer.vertices.invalidateSyncedBufferObject();
         }
+
+        _vertexFormat = format;
+    }
+
+    std::size_t getPackedAttributesOffset() const override
+    {
+        return getCurrentBuffer().packedAttributesOffset;
     }
 
     // Marks the beginning of a frame, switches to the next writing buffers
     void onFrameStart()
     {
-        _currentBuffer = (_currentBuffer + 1) % NumFrameBuffers;
+        auto numFrameBuffers = static_cast<unsigned int>(_frameBuffers.size());
+
+        _currentBuffer = (_currentBuffer + 1) % numFrameBuffers;
         auto& current = getCurrentBuffer();
 
         // Wait for this buffer to become available
@@ -106,9 +250,9 @@ public:
 
         // Replay any modifications of all other buffers onto this one,
         // in the order they are switched through
-        for (auto bufferIndex = (_currentBuffer + 1) % NumFrameBuffers;
+        for (auto bufferIndex = (_currentBuffer + 1) % numFrameBuffers;
              bufferIndex != _currentBuffer;
-             bufferIndex = (bufferIndex + 1) % NumFrameBuffers)
+             bufferIndex = (bufferIndex + 1) % numFrameBuffers)
         {
             current.applyTransactions(_frameBuffers[bufferIndex]);
         }
@@ -116,6 +260,8 @@ public:
         // This buffer is in sync now, we can clear its log
         current.vertexTransactionLog.clear();
         current.indexTransactionLog.clear();
+
+        compactCurrentBuffer();
     }
 
     std::pair<IBufferObject::Ptr, IBufferObject::Ptr> getBufferObjects() override
@@ -127,7 +273,15 @@ public:
     void syncToBufferObjects() override
     {
         auto& current = getCurrentBuffer();
-        current.syncToBufferObjects();
+
+        if (_vertexFormat == VertexFormat::Packed)
+        {
+            current.syncToBufferObjectsPacked(_positionUploadBuffer, _attributeUploadBuffer);
+        }
+        else
+        {
+            current.syncToBufferObjects();
+        }
     }
 
     // Completes the currently writing frame, creates sync objects
@@ -205,11 +359,14 @@ public:
             throw std::logic_error("This is an index remap slot, cannot update vertex data");
         }
 
-        assert(!indices.empty());
-        current.indices.setSubData(GetIndexSlot(slot), indexOffset, indices);
-
         current.recordVertexTransaction(slot, vertexOffset, vertices.size());
-        current.recordIndexTransaction(slot, indexOffset, indices.size());
+
+        // The indices can be omitted when only updating vertices
+        if (!indices.empty())
+        {
+            current.indices.setSubData(GetIndexSlot(slot), indexOffset, indices);
+            current.recordIndexTransaction(slot, indexOffset, indices.size());
+        }
     }
 
     void resizeData(Slot slot, std::size_t vertexSize, std::size_t indexSize) override
@@ -295,9 +452,10 @@ public:
     void printMemoryStats()
     {
         rMessage() << "-- Geometry Store Memory --" << std::endl;
-        rMessage() << "Number of Frame Buffers: " << NumFrameBuffers << std::endl;
+        rMessage() << "Number of Frame Buffers: " << _frameBuffers.size() << std::endl;
+        rMessage() << "Vertex Format: " << (_vertexFormat == VertexFormat::Packed ? "Packed" : "Interleaved") << std::endl;
 
-        for (auto i = 0; i < NumFrameBuffers; ++i)
+        for (auto i = 0; i < _frameBuffers.size(); ++i)
         {
             rMessage() << "Frame Buffer " << i << std::endl;
             rMessage() << "  Vertices: " << string::getFormattedByteSize(_frameBuffers[i].vertices.getBufferSizeInBytes()) << std::endl;
@@ -308,7 +466,71 @@ public:
         }
     }
 
+    // Adds the CPU copies and the estimated buffer object sizes of every frame buffer
+    void reportMemoryUsage(memory::IMemoryReport& report)
+    {
+        auto vertexSize = _vertexFormat == VertexFormat::Packed ? PackedVertexSize : sizeof(RenderVertex);
+
+        for (std::size_t i = 0; i < _frameBuffers.size(); ++i)
+        {
+            const auto& frameBuffer = _frameBuffers[i];
+
+            report.addEntry(fmt::format("Frame buffer {0} vertices", i),
+                frameBuffer.vertices.getBufferSizeInBytes(), frameBuffer.vertices.getNumBufferElements());
+            report.addEntry(fmt::format("Frame buffer {0} indices", i),
+                frameBuffer.indices.getBufferSizeInBytes(), frameBuffer.indices.getNumBufferElements());
+
+            auto logSize = frameBuffer.vertexTransactionLog.capacity() + frameBuffer.indexTransactionLog.capacity();
+            report.addEntry(fmt::format("Frame buffer {0} transaction logs", i), logSize * sizeof(detail::BufferTransaction));
+
+            report.addEntry(fmt::format("Frame buffer {0} (video memory)", i),
+                frameBuffer.vertices.getNumBufferElements() * vertexSize +
+                frameBuffer.indices.getNumBufferElements() * sizeof(unsigned int));
+        }
+    }
+
 private:
+    // Moves a limited number of slots per frame to close the gaps left by deallocations,
+    // the moves are recorded like regular modifications to be replayed on the other buffers
+    void compactCurrentBuffer()
+    {
+        auto& current = getCurrentBuffer();
+
+        if (!_compactionInProgress)
+        {
+            _compactionInProgress = IsFragmented(current.vertices) || IsFragmented(current.indices);
+
+            if (!_compactionInProgress) return;
+        }
+
+        auto verticesCompacted = current.vertices.compact(CompactionElementsPerFrame, [&](std::uint32_t vertexSlot)
+        {
+            current.recordVertexTransaction(GetSlot(SlotType::Regular, vertexSlot, 0), 0,
+                current.vertices.getNumUsedElements(vertexSlot));
+        });
+
+        auto indicesCompacted = current.indices.compact(CompactionElementsPerFrame, [&](std::uint32_t indexSlot)
+        {
+            current.recordIndexTransaction(GetSlot(SlotType::Regular, 0, indexSlot), 0,
+                current.indices.getNumUsedElements(indexSlot));
+        });
+
+        _compactionInProgress = !verticesCompacted || !indicesCompacted;
+    }
+
+    // A buffer is worth compacting if a quarter of its space is lost in gaps
+    template<typename ElementType>
+    static bool IsFragmented(const ContinuousBuffer<ElementType>& buffer)
+    {
+        return buffer.getNumFragmentedElements() > buffer.getNumBufferElements() / 4;
+    }
+
+    void createBufferObjects(FrameBuffer& frameBuffer)
+    {
+        frameBuffer.vertexBufferObject = _bufferObjectProvider.createBufferObject(IBufferObject::Type::Vertex);
+        frameBuffer.indexBufferObject = _bufferObjectProvider.createBufferObject(IBufferObject::Type::Index);
+    }
+
     FrameBuffer& getCurrentBuffer()
     {
         return _frameBuffers[_currentBuffer];
@@ -32,6 +32,11 @@ public:
         return _volumeTest.TestAABB(aabb, localToWorld);
     }
 
+    void TestAABBs(const AABBBatch& batch, VolumeIntersectionValue* results) const
+    {
+        _volumeTest.TestAABBs(batch, results);
+    }
+
     bool fill() const { return _volumeTest.fill(); }
 
     const Matrix4& GetViewProjection() const { return _volumeTest.GetViewProjection(); }
@@ -2,6 +2,7 @@
 
 #include "ivolumetest.h"
 #include "math/Matrix4.h"
+#include "math/AABBBatch.h"
 
 namespace render
 {
@@ -58,6 +59,14 @@ public:
 		return VOLUME_INSIDE;
 	}
 
+	void TestAABBs(const AABBBatch& batch, VolumeIntersectionValue* results) const
+	{
+		for (std::size_t i = 0; i < batch.size(); ++i)
+		{
+			results[i] = VOLUME_INSIDE;
+		}
+	}
+
 	virtual bool fill() const
 	{ 
 		return true;
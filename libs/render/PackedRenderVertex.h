@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "RenderVertex.h"
+
+namespace render
+{
+
+/**
+ * Compact GPU representation of the RenderVertex attributes apart from the
+ * position, which is kept in a separate stream such that passes which only
+ * need positions (depth fill, wireframe) don't fetch anything else.
+ *
+ * Normal, tangent and bitangent are packed into signed normalised 10:10:10:2
+ * integers (GL_INT_2_10_10_10_REV, w = 1), the colour into four unsigned bytes.
+ * Texture coordinates are kept as floats: on large, tiled brush faces they
+ * easily reach values where half floats are no longer precise enough.
+ */
+struct PackedVertexAttributes
+{
+    Vector2f texcoord;
+    std::uint32_t normal;
+    std::uint32_t tangent;
+    std::uint32_t bitangent;
+    std::uint8_t colour[4];
+
+    PackedVertexAttributes() = default;
+
+    explicit PackedVertexAttributes(const RenderVertex& vertex) :
+        texcoord(vertex.texcoord),
+        normal(PackSignedNormalised(vertex.normal)),
+        tangent(PackSignedNormalised(vertex.tangent)),
+        bitangent(PackSignedNormalised(vertex.bitangent))
+    {
+        colour[0] = PackUnsignedByte(vertex.colour.x());
+        colour[1] = PackUnsignedByte(vertex.colour.y());
+        colour[2] = PackUnsignedByte(vertex.colour.z());
+        colour[3] = PackUnsignedByte(vertex.colour.w());
+    }
+
+    // Converts the value to an unsigned normalised byte, clamping it to [0..1]
+    static std::uint8_t PackUnsignedByte(float value)
+    {
+        return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+
+    // Packs the vector into a GL_INT_2_10_10_10_REV value, components are clamped to [-1..1]
+    static std::uint32_t PackSignedNormalised(const Vector3f& vector)
+    {
+        auto packComponent = [](float value)
+        {
+            auto scaled = static_cast<std::int32_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 511.0f));
+            return static_cast<std::uint32_t>(scaled) & 0x3FF;
+        };
+
+        return packComponent(vector.x()) |
+            (packComponent(vector.y()) << 10) |
+            (packComponent(vector.z()) << 20) |
+            (1u << 30); // w = 1
+    }
+
+    // Inverse of PackSignedNormalised()
+    static Vector3f UnpackSignedNormalised(std::uint32_t packed)
+    {
+        auto unpackComponent = [](std::uint32_t bits)
+        {
+            // Sign-extend the 10 bit value
+            auto value = static_cast<std::int32_t>(bits << 22) >> 22;
+            return std::max(static_cast<float>(value) / 511.0f, -1.0f);
+        };
+
+        return Vector3f(unpackComponent(packed & 0x3FF),
+            unpackComponent((packed >> 10) & 0x3FF),
+            unpackComponent((packed >> 20) & 0x3FF));
+    }
+};
+
+static_assert(sizeof(PackedVertexAttributes) == 24, "Unexpected padding in PackedVertexAttributes");
+
+}
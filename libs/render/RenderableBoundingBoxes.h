@@ -61,7 +61,7 @@ protected:
 
             auto indexOffset = static_cast<unsigned int>(vertices.size());
 
-            vertices.insert(vertices.begin(),
+            vertices.insert(vertices.end(),
                 std::make_move_iterator(boxVertices.begin()),
                 std::make_move_iterator(boxVertices.end()));
 
@@ -18,15 +18,29 @@ public:
      * \brief
      * Use a RenderableCollectionWalker to find all renderables in the global
      * scenegraph.
+     *
+     * If useWorkerThreads is true, the scene graph culling is spread across
+     * multiple threads. The nodes are still processed on the calling thread,
+     * since preparing the renderables is accessing the render system.
      */
-    static void CollectRenderablesInScene(RenderableCollectorBase& collector, const VolumeTest& volume)
+    static void CollectRenderablesInScene(RenderableCollectorBase& collector, const VolumeTest& volume,
+        bool useWorkerThreads = false)
     {
-        // Submit renderables from scene graph
-        GlobalSceneGraph().foreachVisibleNodeInVolume(volume, [&](const scene::INodePtr& node)
+        auto processNode = [&](const scene::INodePtr& node)
         {
             collector.processNode(node, volume);
             return true;
-        });
+        };
+
+        // Submit renderables from scene graph
+        if (useWorkerThreads)
+        {
+            GlobalSceneGraph().foreachVisibleNodeInVolumeParallel(volume, processNode);
+        }
+        else
+        {
+            GlobalSceneGraph().foreachVisibleNodeInVolume(volume, processNode);
+        }
 
         // Prepare any renderables that have been directly attached to the RenderSystem
 		// without belonging to an actual scene object
@@ -314,6 +314,29 @@ protected:
         if (_renderAdapter)
             _renderAdapter->boundsChanged();
     }
+
+    // Returns true if geometry has been submitted to the shader
+    bool hasGeometry() const
+    {
+        return _surfaceSlot != IGeometryRenderer::InvalidSlot;
+    }
+
+    /**
+     * @brief Replaces a range of the vertices submitted by the last updateGeometryWithData() call,
+     * starting at the given vertex offset. The index data and the number of vertices are unchanged.
+     *
+     * May only be called if hasGeometry() returns true.
+     */
+    void updateGeometryWithSubData(std::size_t vertexOffset, const IGeometryRenderer::Vertices& vertices)
+    {
+        assert(hasGeometry());
+        assert(vertexOffset + vertices.size() <= _lastVertexSize);
+
+        _shader->updateSubGeometry(_surfaceSlot, vertexOffset, vertices);
+
+        if (_renderAdapter)
+            _renderAdapter->boundsChanged();
+    }
 };
 
 }
@@ -1,12 +1,17 @@
 #pragma once
 
+#include <cmath>
+#include <deque>
 #include "ispacepartition.h"
+#include "iscenegraph.h"
 #include "irender.h"
 #include "irenderable.h"
 
 #include "math/Matrix4.h"
 #include "math/AABB.h"
+#include "scene/SpacePartitionStatistics.h"
 #include "render/RenderableColouredBoundingBoxes.h"
+#include "render/StaticRenderableText.h"
 
 namespace render
 {
@@ -19,6 +24,11 @@ namespace render
  * setShader() and setSpacePartition() methods to enable rendering.
  *
  * This object can be directly attached to the GlobalRenderSystem().
+ *
+ * The cells are coloured by their member count, from green (one member) to
+ * red (MaxMemberColourCount members or more), empty cells are dark grey.
+ * The statistics of the tree and the query figures of the scene graph are
+ * re-evaluated every frame and displayed above the map.
  */
 class RenderableSpacePartition :
 	public Renderable
@@ -30,37 +40,91 @@ private:
 	// The space partition to render
 	scene::ISpacePartitionSystemPtr _spacePartition;
 
+	RenderSystemPtr _renderSystem;
+
     std::vector<AABB> _spacePartitionNodes;
     std::vector<Vector4> _nodeColours;
     RenderableColouredBoundingBoxes _renderableBoxes;
 
+    // The boxes of the previous frame, the geometry is only updated on change
+    std::vector<AABB> _previousNodes;
+    std::vector<Vector4> _previousColours;
+
+    ITextRenderer::Ptr _textRenderer;
+    StaticRenderableText _statisticsText;
+
+    scene::SpacePartitionStatistics _statistics;
+
+    // The scene graph query figures sampled at the last frame, and the
+    // differences of the frames considered in the averages
+    std::size_t _lastFrame;
+    bool _hasQuerySample;
+    scene::Graph::SpacePartitionQueryStatistics _lastQueryStatistics;
+    std::deque<scene::Graph::SpacePartitionQueryStatistics> _frameQueryStatistics;
+
 public:
+    // Cells with this member count or more are drawn red
+    static constexpr std::size_t MaxMemberColourCount = 32;
+
+    // The number of frames the query figures are averaged over
+    static constexpr std::size_t NumAveragedFrames = 60;
+
     RenderableSpacePartition() :
-        _renderableBoxes(_spacePartitionNodes, _nodeColours)
+        _renderableBoxes(_spacePartitionNodes, _nodeColours),
+        _statisticsText("", Vector3(0, 0, 0), Vector4(1, 1, 1, 1)),
+        _lastFrame(0),
+        _hasQuerySample(false)
     {}
 
 	void setSpacePartition(const scene::ISpacePartitionSystemPtr& spacePartition)
 	{
 		_spacePartition = spacePartition;
+		_statistics = scene::SpacePartitionStatistics();
+		_hasQuerySample = false;
+		_frameQueryStatistics.clear();
 	}
 
+    // The statistics of the most recently rendered frame
+    const scene::SpacePartitionStatistics& getStatistics() const
+    {
+        return _statistics;
+    }
+
+    // Returns the colour of a cell with the given number of members
+    static Vector4 GetMemberCountColour(std::size_t numMembers)
+    {
+        if (numMembers == 0)
+        {
+            return Vector4(0.25, 0.25, 0.25, 1);
+        }
+
+        // Logarithmic scale, from green over yellow to red
+        auto fraction = std::min(std::log2(static_cast<double>(numMembers)) /
+            std::log2(static_cast<double>(MaxMemberColourCount)), 1.0);
+
+        return Vector4(std::min(fraction * 2, 1.0), std::min((1 - fraction) * 2, 1.0), 0, 1);
+    }
+
     void onPreRender(const VolumeTest& volume) override
     {
-        if (!_spacePartition)
+        if (!_spacePartition || !_renderSystem)
         {
             _renderableBoxes.clear();
+            _statisticsText.clear();
             return;
         }
 
-        // Accumulate the bounding boxes to render
-        _spacePartitionNodes.clear();
-        _nodeColours.clear();
+        // Several views might be rendered within the same frame
+        auto frame = _renderSystem->getFrameCount();
 
-        accumulateBoundingBoxes(_spacePartition->getRoot());
+        if (frame != _lastFrame)
+        {
+            _lastFrame = frame;
+            updateStatistics();
+        }
 
-        // Update the renderable every frame
-        _renderableBoxes.queueUpdate();
         _renderableBoxes.update(_shader);
+        _statisticsText.update(_textRenderer);
     }
 
     void renderHighlights(IRenderableCollector& collector, const VolumeTest& volume) override
@@ -69,14 +133,21 @@ public:
 	void setRenderSystem(const RenderSystemPtr& renderSystem) override
 	{
         _renderableBoxes.clear();
+        _statisticsText.clear();
+        _previousNodes.clear();
+        _previousColours.clear();
+
+        _renderSystem = renderSystem;
 
 		if (renderSystem)
 		{
 			_shader = renderSystem->capture("[1 0 0]");
+			_textRenderer = renderSystem->captureTextRenderer(IGLFont::Style::Mono, 14);
 		}
 		else
 		{
 			_shader.reset();
+			_textRenderer.reset();
 		}
 	}
 
@@ -86,13 +157,68 @@ public:
 	}
 
 private:
-	void accumulateBoundingBoxes(const scene::ISPNodePtr& node)
-	{
-		const auto& members = node->getMembers();
+    void updateStatistics()
+    {
+        auto root = _spacePartition->getRoot();
 
-		float shade = members.size() > 2 ? 1 : (members.size() > 0 ? 0.6f : 0);
+        _statistics = scene::collectSpacePartitionStatistics(root);
 
-        _nodeColours.emplace_back(shade, shade, shade, 1);
+        // The queries of the previous frame
+        auto queryStatistics = GlobalSceneGraph().getSpacePartitionQueryStatistics();
+
+        if (_hasQuerySample)
+        {
+            auto& frameStatistics = _frameQueryStatistics.emplace_back();
+            frameStatistics.numQueries = queryStatistics.numQueries - _lastQueryStatistics.numQueries;
+            frameStatistics.numVisitedNodes = queryStatistics.numVisitedNodes - _lastQueryStatistics.numVisitedNodes;
+        }
+
+        _lastQueryStatistics = queryStatistics;
+        _hasQuerySample = true;
+
+        while (_frameQueryStatistics.size() > NumAveragedFrames)
+        {
+            _frameQueryStatistics.pop_front();
+        }
+
+        for (const auto& frameStatistics : _frameQueryStatistics)
+        {
+            _statistics.queriesPerFrame += frameStatistics.numQueries;
+            _statistics.visitedNodesPerFrame += frameStatistics.numVisitedNodes;
+        }
+
+        if (!_frameQueryStatistics.empty())
+        {
+            _statistics.queriesPerFrame /= _frameQueryStatistics.size();
+            _statistics.visitedNodesPerFrame /= _frameQueryStatistics.size();
+        }
+
+        // Accumulate the bounding boxes to render
+        _spacePartitionNodes.clear();
+        _nodeColours.clear();
+
+        accumulateBoundingBoxes(root);
+
+        // The geometry only needs to be uploaded when the tree has changed
+        if (_spacePartitionNodes != _previousNodes || _nodeColours != _previousColours)
+        {
+            _previousNodes = _spacePartitionNodes;
+            _previousColours = _nodeColours;
+            _renderableBoxes.queueUpdate();
+        }
+
+        // Place the figures above the map contents
+        const auto& sceneBounds = GlobalSceneGraph().root() ?
+            GlobalSceneGraph().root()->worldAABB() : AABB();
+
+        _statisticsText.setWorldPosition(sceneBounds.isValid() ?
+            sceneBounds.origin + Vector3(0, 0, sceneBounds.extents.z()) : root->getBounds().origin);
+        _statisticsText.setText(_statistics.toString());
+    }
+
+	void accumulateBoundingBoxes(const scene::ISPNodePtr& node)
+	{
+        _nodeColours.emplace_back(GetMemberCountColour(node->getMembers().size()));
 
 		AABB rb(node->getBounds());
 
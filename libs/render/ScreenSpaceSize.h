@@ -0,0 +1,44 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "ivolumetest.h"
+#include "math/AABB.h"
+#include "math/Matrix4.h"
+
+namespace render
+{
+
+// True if the given view is using a parallel (orthographic) projection
+inline bool isOrthographicView(const VolumeTest& view)
+{
+    const auto& projection = view.GetProjection();
+    return std::abs(projection[11]) < 1e-7 && std::abs(projection[15] - 1) < 1e-7;
+}
+
+/**
+ * Returns the size in pixels of the given world space bounds when drawn in the
+ * given orthographic view, measured along the larger of the two screen axes.
+ * Perspective views (where the size depends on the depth) return -1.
+ */
+inline double getProjectedSizeInPixels(const VolumeTest& view, const AABB& worldBounds)
+{
+    if (!isOrthographicView(view) || !worldBounds.isValid())
+    {
+        return -1;
+    }
+
+    const auto& viewProj = view.GetViewProjection();
+    const auto& viewport = view.GetViewport();
+    const auto& extents = worldBounds.getExtents();
+
+    // Projected half size of the box in clip space, scaled to pixels by the half viewport size
+    auto width = std::abs(viewProj.xx() * extents.x()) + std::abs(viewProj.yx() * extents.y()) +
+        std::abs(viewProj.zx() * extents.z());
+    auto height = std::abs(viewProj.xy() * extents.x()) + std::abs(viewProj.yy() * extents.y()) +
+        std::abs(viewProj.zy() * extents.z());
+
+    return 2 * std::max(width * viewport[0], height * viewport[5]);
+}
+
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <stdexcept>
+#include "Rectangle.h"
+
+namespace render
+{
+
+/**
+ * Tile allocator for a square shadow map texture. Every tile holds the six
+ * cube map faces of a single light side by side, so a tile with a face size
+ * of N pixels covers a 6N x N area of the texture.
+ *
+ * The texture is divided into a number of full-size rows (level 0), each
+ * of which can be split into four tiles of half the face size (level 1),
+ * which can be split again down to the configured maximum level.
+ * Splitting a 6N x N tile in half in both dimensions results in four tiles of
+ * the same aspect ratio, so the allocator works like a quad-tree buddy system.
+ *
+ * The Rectangle returned for a tile holds its position within the texture,
+ * width and height are set to the face size.
+ */
+class ShadowMapAtlas
+{
+public:
+    using Handle = std::size_t;
+    static constexpr Handle InvalidHandle = std::numeric_limits<Handle>::max();
+
+private:
+    static constexpr std::size_t NoChildren = std::numeric_limits<std::size_t>::max();
+
+    struct Node
+    {
+        Rectangle rectangle;
+        std::size_t level;
+        std::size_t parent;
+
+        // Index of the first of the four child nodes, NoChildren if never split.
+        // Child nodes are kept in the list after merging, to be reused on the next split.
+        std::size_t firstChild;
+        bool isSplit;
+        bool isOccupied;
+    };
+
+    std::vector<Node> _nodes;
+
+    std::size_t _numRows;
+    std::size_t _maxLevel;
+    std::size_t _numOccupiedTiles;
+
+public:
+    // Divides a square texture of the given size into numRows level 0 tiles
+    ShadowMapAtlas(std::size_t textureSize, std::size_t numRows, std::size_t maxLevel) :
+        _numRows(numRows),
+        _maxLevel(maxLevel),
+        _numOccupiedTiles(0)
+    {
+        if (numRows == 0 || textureSize / numRows < (static_cast<std::size_t>(1) << maxLevel))
+        {
+            throw std::invalid_argument("Shadow map atlas is too small for the requested levels");
+        }
+
+        auto faceSize = static_cast<int>(textureSize / numRows);
+
+        for (std::size_t row = 0; row < numRows; ++row)
+        {
+            _nodes.emplace_back(Node
+            {
+                Rectangle{ 0, static_cast<int>(row) * faceSize, faceSize, faceSize },
+                0, InvalidHandle, NoChildren, false, false
+            });
+        }
+    }
+
+    std::size_t getMaxLevel() const
+    {
+        return _maxLevel;
+    }
+
+    // The number of currently allocated tiles
+    std::size_t getNumOccupiedTiles() const
+    {
+        return _numOccupiedTiles;
+    }
+
+    // Returns the face size in pixels of a tile on the given level
+    int getFaceSize(std::size_t level) const
+    {
+        return _nodes.front().rectangle.width >> level;
+    }
+
+    /**
+     * Allocates a free tile of the given level, splitting larger tiles
+     * if necessary. Already split areas are preferred to keep the large tiles
+     * available. Returns InvalidHandle if no tile of that size is left.
+     */
+    Handle allocate(std::size_t level)
+    {
+        if (level > _maxLevel) return InvalidHandle;
+
+        // First pass: don't split up any free tiles
+        for (std::size_t row = 0; row < _numRows; ++row)
+        {
+            if (auto handle = findFreeNode(row, level, false); handle != InvalidHandle)
+            {
+                return occupy(handle);
+            }
+        }
+
+        for (std::size_t row = 0; row < _numRows; ++row)
+        {
+            if (auto handle = findFreeNode(row, level, true); handle != InvalidHandle)
+            {
+                return occupy(handle);
+            }
+        }
+
+        return InvalidHandle;
+    }
+
+    // Releases the given tile, merging it with its free siblings where possible
+    void free(Handle handle)
+    {
+        if (handle >= _nodes.size() || !_nodes[handle].isOccupied)
+        {
+            throw std::logic_error("Cannot free an unallocated shadow map tile");
+        }
+
+        _nodes[handle].isOccupied = false;
+        --_numOccupiedTiles;
+
+        // Merge the parents that have only free children
+        for (auto parent = _nodes[handle].parent; parent != InvalidHandle; parent = _nodes[parent].parent)
+        {
+            auto& parentNode = _nodes[parent];
+
+            for (auto child = parentNode.firstChild; child < parentNode.firstChild + 4; ++child)
+            {
+                if (_nodes[child].isOccupied || _nodes[child].isSplit) return;
+            }
+
+            parentNode.isSplit = false;
+        }
+    }
+
+    // Frees all tiles
+    void clear()
+    {
+        for (auto& node : _nodes)
+        {
+            node.isOccupied = false;
+            node.isSplit = false;
+        }
+
+        _numOccupiedTiles = 0;
+    }
+
+    const Rectangle& getRectangle(Handle handle) const
+    {
+        return _nodes.at(handle).rectangle;
+    }
+
+    std::size_t getLevel(Handle handle) const
+    {
+        return _nodes.at(handle).level;
+    }
+
+private:
+    Handle occupy(Handle handle)
+    {
+        _nodes[handle].isOccupied = true;
+        ++_numOccupiedTiles;
+        return handle;
+    }
+
+    Handle findFreeNode(std::size_t index, std::size_t level, bool allowSplit)
+    {
+        auto& node = _nodes[index];
+
+        if (node.isOccupied) return InvalidHandle;
+
+        if (node.level == level)
+        {
+            return node.isSplit ? InvalidHandle : index;
+        }
+
+        if (!node.isSplit)
+        {
+            if (!allowSplit) return InvalidHandle;
+
+            split(index);
+        }
+
+        auto firstChild = _nodes[index].firstChild;
+
+        for (auto child = firstChild; child < firstChild + 4; ++child)
+        {
+            if (auto handle = findFreeNode(child, level, allowSplit); handle != InvalidHandle)
+            {
+                return handle;
+            }
+        }
+
+        return InvalidHandle;
+    }
+
+    void split(std::size_t index)
+    {
+        if (_nodes[index].firstChild == NoChildren)
+        {
+            auto parent = _nodes[index];
+            auto faceSize = parent.rectangle.width / 2;
+
+            _nodes[index].firstChild = _nodes.size();
+
+            // Two tiles side by side, in two rows
+            for (int child = 0; child < 4; ++child)
+            {
+                _nodes.emplace_back(Node
+                {
+                    Rectangle
+                    {
+                        parent.rectangle.x + (child % 2) * 6 * faceSize,
+                        parent.rectangle.y + (child / 2) * faceSize,
+                        faceSize, faceSize
+                    },
+                    parent.level + 1, index, NoChildren, false, false
+                });
+            }
+        }
+
+        _nodes[index].isSplit = true;
+    }
+};
+
+}
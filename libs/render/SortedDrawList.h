@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace render
+{
+
+/**
+ * Per-frame list of draw items, each tagged with a 64 bit sort key. The items
+ * are collected in arbitrary order, sorted by their key using a (stable) LSD radix
+ * sort and then executed linearly. Encoding the state in the key from most to
+ * least significant bits (e.g. pass order, program, texture) brings all items
+ * sharing the same state next to each other.
+ *
+ * Clear the list at the end of each frame, the allocated memory can be re-used.
+ */
+template<typename Item>
+class SortedDrawList
+{
+private:
+    struct Entry
+    {
+        std::uint64_t key;
+        std::uint32_t index; // into _items
+    };
+
+    std::vector<Item> _items;
+    std::vector<Entry> _entries;
+    std::vector<Entry> _sortBuffer;
+
+    bool _sorted;
+
+public:
+    SortedDrawList() :
+        _sorted(true)
+    {}
+
+    void add(std::uint64_t key, Item&& item)
+    {
+        _entries.emplace_back(Entry{ key, static_cast<std::uint32_t>(_items.size()) });
+        _items.emplace_back(std::move(item));
+        _sorted = false;
+    }
+
+    void add(std::uint64_t key, const Item& item)
+    {
+        _entries.emplace_back(Entry{ key, static_cast<std::uint32_t>(_items.size()) });
+        _items.push_back(item);
+        _sorted = false;
+    }
+
+    bool empty() const
+    {
+        return _items.empty();
+    }
+
+    std::size_t size() const
+    {
+        return _items.size();
+    }
+
+    void clear()
+    {
+        _items.clear();
+        _entries.clear();
+        _sorted = true;
+    }
+
+    // Sorts the items by ascending key, items with equal keys keep their insertion order
+    void sort()
+    {
+        if (_sorted) return;
+
+        _sortBuffer.resize(_entries.size());
+
+        // Digits which are the same in all keys don't change the order and can be skipped
+        std::uint64_t differingBits = 0;
+
+        for (const auto& entry : _entries)
+        {
+            differingBits |= entry.key ^ _entries.front().key;
+        }
+
+        for (unsigned int shift = 0; shift < 64; shift += 8)
+        {
+            if (((differingBits >> shift) & 0xFF) == 0) continue;
+
+            std::size_t offsets[256] = { 0 };
+
+            for (const auto& entry : _entries)
+            {
+                ++offsets[(entry.key >> shift) & 0xFF];
+            }
+
+            // Convert the histogram into starting offsets
+            std::size_t total = 0;
+
+            for (auto& offset : offsets)
+            {
+                auto count = offset;
+                offset = total;
+                total += count;
+            }
+
+            for (const auto& entry : _entries)
+            {
+                _sortBuffer[offsets[(entry.key >> shift) & 0xFF]++] = entry;
+            }
+
+            _entries.swap(_sortBuffer);
+        }
+
+        _sorted = true;
+    }
+
+    // Sorts the list if necessary, then invokes the functor with the key and item of each entry
+    template<typename Functor>
+    void foreachItem(Functor&& functor)
+    {
+        sort();
+
+        for (const auto& entry : _entries)
+        {
+            functor(entry.key, _items[entry.index]);
+        }
+    }
+};
+
+}
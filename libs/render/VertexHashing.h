@@ -1,5 +1,7 @@
 #pragma once
 
+#include <unordered_map>
+#include <vector>
 #include "math/Vector3.h"
 #include "render/MeshVertex.h"
 #include "render/RenderVertex.h"
@@ -116,3 +118,39 @@ struct std::equal_to<render::RenderVertex>
             math::isNear(a.colour, b.colour, render::VertexEpsilon);
     }
 };
+
+namespace render
+{
+
+/**
+ * Vertex welder based on the hash functors above: every vertex added
+ * through weld() is only appended to the target vertex array if no similar
+ * vertex has been added before, going by the epsilons defined above.
+ * The returned index points to the vertex to use in the index buffer.
+ */
+template<typename VertexT>
+class VertexWelder
+{
+private:
+    std::unordered_map<VertexT, unsigned int> _indices;
+
+public:
+    unsigned int weld(std::vector<VertexT>& vertices, const VertexT& vertex)
+    {
+        auto result = _indices.try_emplace(vertex, static_cast<unsigned int>(vertices.size()));
+
+        if (result.second)
+        {
+            vertices.push_back(vertex);
+        }
+
+        return result.first->second;
+    }
+
+    void clear()
+    {
+        _indices.clear();
+    }
+};
+
+}
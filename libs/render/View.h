@@ -148,6 +148,12 @@ public:
 		return _frustum.testIntersection(aabb, localToWorld);
 	}
 
+    void TestAABBs(const AABBBatch& batch, VolumeIntersectionValue* results) const override
+    {
+        INC_COUNTER(_count_bboxs);
+        _frustum.testIntersection(batch, results);
+    }
+
 	const Matrix4& GetViewProjection() const override
 	{
 		return _viewproj;
@@ -3,6 +3,7 @@
 #include "igl.h"
 #include "irender.h"
 #include <limits>
+#include <map>
 #include "iwindingrenderer.h"
 #include "iobjectrenderer.h"
 #include "render/CompactWindingVertexBuffer.h"
@@ -25,6 +26,9 @@ public:
 
     // Ensures that everything in the IGeometryStore is up to date
     virtual void prepareForRendering() = 0;
+
+    // Empties the batches filled by addHighlightedWinding(), called at the start of every frame
+    virtual void clearHighlightedWindings() = 0;
 };
 
 // Traits class to retrieve the GLenum render mode based on the indexer type
@@ -114,6 +118,33 @@ private:
 
     std::size_t _windingCount;
 
+    // The windings added to a highlight batch during the current frame,
+    // rendered straight from the bucket storage without generating any indices
+    class HighlightBatch final :
+        public OpenGLRenderable
+    {
+    private:
+        WindingRenderer& _owner;
+
+    public:
+        std::vector<Slot> slots;
+
+        HighlightBatch(WindingRenderer& owner) :
+            _owner(owner)
+        {}
+
+        void render() const override
+        {
+            _owner.renderHighlightedWindings(slots);
+        }
+    };
+
+    std::map<std::size_t, std::unique_ptr<HighlightBatch>> _highlightBatches;
+
+    // Vertex ranges per bucket, re-used by every highlight batch submission
+    std::vector<std::vector<GLint>> _highlightFirstVertices;
+    std::vector<GLsizei> _highlightVertexCounts;
+
     // Represents a group of windings associated to a single entity
     // A winding is identified by its slot mapping index as used by the parent WindingRenderer
     class WindingGroup :
@@ -384,6 +415,9 @@ private:
 
     bool _geometryUpdatePending;
 
+    // The storage handles of all non-empty buckets, re-used on each render call
+    std::vector<IGeometryStore::Slot> _bucketStorageHandles;
+
 public:
     WindingRenderer(IGeometryStore& geometryStore, IObjectRenderer& objectRenderer, Shader* owningShader) :
         _geometryStore(geometryStore),
@@ -530,13 +564,17 @@ public:
     {
         assert(!_geometryUpdatePending); // prepareForRendering should have been called
 
+        _bucketStorageHandles.clear();
+
         for (auto& bucket : _buckets)
         {
             if (bucket.storageHandle == InvalidStorageHandle) continue; // nothing here
 
-            auto primitiveMode = RenderingTraits<WindingIndexerT>::Mode();
-            _objectRenderer.submitGeometry(bucket.storageHandle, primitiveMode);
+            _bucketStorageHandles.push_back(bucket.storageHandle);
         }
+
+        // Submit all buckets in one go, the object renderer can batch them into a single call
+        _objectRenderer.submitGeometry(_bucketStorageHandles, RenderingTraits<WindingIndexerT>::Mode());
     }
 
     void renderWinding(RenderMode mode, Slot slot) override
@@ -559,6 +597,30 @@ public:
         }
     }
 
+    const OpenGLRenderable* addHighlightedWinding(Slot slot, std::size_t batchKey) override
+    {
+        assert(slot < _slots.size());
+
+        auto& batch = _highlightBatches[batchKey];
+
+        if (!batch)
+        {
+            batch = std::make_unique<HighlightBatch>(*this);
+        }
+
+        batch->slots.push_back(slot);
+
+        return batch->slots.size() == 1 ? batch.get() : nullptr;
+    }
+
+    void clearHighlightedWindings() override
+    {
+        for (auto& [_, batch] : _highlightBatches)
+        {
+            batch->slots.clear();
+        }
+    }
+
     // Ensure all data is written to the IGeometryStore
     void prepareForRendering() override
     {
@@ -760,6 +822,40 @@ private:
         _objectRenderer.submitGeometryWithCustomIndices(geometrySlot, mode, indices);
     }
 
+    void renderHighlightedWindings(const std::vector<Slot>& slots)
+    {
+        assert(!_geometryUpdatePending); // prepareForRendering should have been called
+
+        _highlightFirstVertices.resize(_buckets.size());
+
+        for (auto& firstVertices : _highlightFirstVertices)
+        {
+            firstVertices.clear();
+        }
+
+        // Sort the windings into their buckets, each winding occupies a continuous vertex range
+        for (auto slot : slots)
+        {
+            const auto& slotMapping = _slots[slot];
+
+            // Windings might have been removed after they have been added to the batch
+            if (slotMapping.bucketIndex == InvalidBucketIndex) continue;
+
+            auto windingSize = _buckets[slotMapping.bucketIndex].buffer.getWindingSize();
+            _highlightFirstVertices[slotMapping.bucketIndex].push_back(static_cast<GLint>(windingSize * slotMapping.slotNumber));
+        }
+
+        for (const auto& bucket : _buckets)
+        {
+            const auto& firstVertices = _highlightFirstVertices[bucket.index];
+
+            if (firstVertices.empty() || bucket.storageHandle == InvalidStorageHandle) continue;
+
+            _highlightVertexCounts.assign(firstVertices.size(), static_cast<GLsizei>(bucket.buffer.getWindingSize()));
+            _objectRenderer.submitGeometryRanges(bucket.storageHandle, GL_POLYGON, firstVertices, _highlightVertexCounts);
+        }
+    }
+
     Slot allocateSlotMapping()
     {
         auto numSlots = static_cast<Slot>(_slots.size());
@@ -26,6 +26,7 @@ private:
     INamespacePtr _namespace;
     UndoFileChangeTracker _changeTracker;
     ITargetManagerPtr _targetManager;
+    IEntityClassIndexPtr _entityClassIndex;
     selection::ISelectionGroupManager::Ptr _selectionGroupManager;
     selection::ISelectionSetManager::Ptr _selectionSetManager;
     ILayerManager::Ptr _layerManager;
@@ -37,6 +38,7 @@ public:
     {
         _namespace = GlobalNamespaceFactory().createNamespace();
         _targetManager = GlobalEntityModule().createTargetManager();
+        _entityClassIndex = GlobalEntityModule().createEntityClassIndex();
         _selectionGroupManager = GlobalSelectionGroupModule().createSelectionGroupManager();
         _selectionSetManager = GlobalSelectionSetModule().createSelectionSetManager();
         _layerManager = GlobalLayerModule().createLayerManager(*this);
@@ -63,6 +65,11 @@ public:
         return *_targetManager;
     }
 
+    IEntityClassIndex& getEntityClassIndex() override
+    {
+        return *_entityClassIndex;
+    }
+
     selection::ISelectionGroupManager& getSelectionGroupManager() override
     {
         return *_selectionGroupManager;
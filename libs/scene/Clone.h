@@ -1,8 +1,11 @@
 #pragma once
 
 #include "inode.h"
+#include "imap.h"
 #include "iscenegraph.h"
+#include "iselectiongroup.h"
 #include <functional>
+#include <map>
 
 namespace scene
 {
@@ -100,4 +103,37 @@ inline INodePtr cloneNodeIncludingDescendants(const INodePtr& node, const PostCl
 	return clone;
 }
 
+/**
+ * Clones the nodes visited by the given traversal function into the target root,
+ * e.g. the selected nodes of a map using scene::traverseSelected. The clones
+ * are assigned to new selection groups of the target root, mirroring the groups
+ * of the source nodes.
+ */
+inline void cloneNodesIntoRoot(const INodePtr& sourceRoot,
+    const std::function<void(const INodePtr&, NodeVisitor&)>& traverse, const IMapRootNodePtr& targetRoot)
+{
+	std::map<std::size_t, selection::ISelectionGroupPtr> groups;
+
+	CloneAll cloner(targetRoot, [&](const INodePtr& sourceNode, const INodePtr& clonedNode)
+	{
+		auto groupSelectable = std::dynamic_pointer_cast<IGroupSelectable>(sourceNode);
+
+		if (!groupSelectable) return;
+
+		for (auto id : groupSelectable->getGroupIds())
+		{
+			auto& group = groups[id];
+
+			if (!group)
+			{
+				group = targetRoot->getSelectionGroupManager().createSelectionGroup();
+			}
+
+			group->addNode(clonedNode);
+		}
+	});
+
+	traverse(sourceRoot, cloner);
+}
+
 } // namespace
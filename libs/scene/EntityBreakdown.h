@@ -2,18 +2,18 @@
 
 #include <map>
 #include <string>
-#include "iscenegraph.h"
-#include "ientity.h"
-#include "ieclass.h"
+#include "iscenestatistics.h"
 
 namespace scene
 {
 
-/** greebo: This object traverses the scenegraph on construction
- * 			counting all occurrences of each entity class.
+/** greebo: This object holds the number of occurrences
+ * 			of each entity class in the scene at the time of construction.
+ *
+ * The figures are copied from the scene statistics module,
+ * no scene traversal is necessary.
  */
-class EntityBreakdown :
-	public scene::NodeVisitor
+class EntityBreakdown
 {
 public:
 	typedef std::map<std::string, std::size_t> Map;
@@ -22,38 +22,9 @@ private:
 	Map _map;
 
 public:
-	EntityBreakdown()
-	{
-		_map.clear();
-		GlobalSceneGraph().root()->traverse(*this);
-	}
-
-	bool pre(const scene::INodePtr& node) override
-	{
-		// Is this node an entity?
-		Entity* entity = Node_getEntity(node);
-
-		if (entity != nullptr)
-		{
-			IEntityClassConstPtr eclass = entity->getEntityClass();
-			std::string ecName = eclass->getDeclName();
-
-			auto found = _map.find(ecName);
-
-			if (found == _map.end())
-			{
-				// Entity class not yet registered, create new entry
-				_map.emplace(ecName, 1);
-			}
-			else
-			{
-				// Eclass is known, increase the counter
-				found->second++;
-			}
-		}
-
-		return true;
-	}
+	EntityBreakdown() :
+		_map(GlobalSceneStatistics().getEntityClassCounts())
+	{}
 
 	// Accessor method to retrieve the entity breakdown map
 	const Map& getMap() const
@@ -3,6 +3,7 @@
 #include "iscenegraph.h"
 #include "ientity.h"
 #include "iselection.h"
+#include "iscenestatistics.h"
 #include "scenelib.h"
 
 namespace scene
@@ -35,6 +36,24 @@ LayerUsageBreakdown LayerUsageBreakdown::CreateFromScene(bool includeHidden)
 
 	InitialiseVector(bd);
 
+	// The scene statistics are counting all entities and primitives
+	if (includeHidden)
+	{
+		for (const auto& [layerId, count] : GlobalSceneStatistics().getLayerCounts())
+		{
+			assert(layerId >= 0); // we assume positive layer IDs here
+
+			if (layerId >= static_cast<int>(bd.size()))
+			{
+				bd.resize(layerId + 1, 0);
+			}
+
+			bd[layerId] = count;
+		}
+
+		return bd;
+	}
+
 	GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)
 	{
 		// Filter out any hidden nodes, unless we want them
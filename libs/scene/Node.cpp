@@ -2,9 +2,10 @@
 
 #include "itransformnode.h"
 #include "iscenegraph.h"
+#include "imap.h"
+#include "iscenestatistics.h"
 #include "debugging/debugging.h"
 #include "InstanceWalkers.h"
-#include "AABBAccumulateWalker.h"
 
 namespace scene
 {
@@ -20,6 +21,7 @@ Node::Node() :
 	_childBoundsMutex(false),
 	_transformChanged(true),
 	_transformMutex(false),
+	_boundsChangePending(false),
 	_local2world(Matrix4::getIdentity()),
 	_instantiated(false),
 	_forceVisible(false),
@@ -28,6 +30,7 @@ Node::Node() :
 {
 	// Each node is part of layer 0 by default
 	_layers.insert(0);
+	_layerMask.set(0);
 }
 
 Node::Node(const Node& other) :
@@ -40,10 +43,12 @@ Node::Node(const Node& other) :
 	_boundsMutex(false),
 	_childBoundsChanged(true),
 	_childBoundsMutex(false),
+	_boundsChangePending(false),
 	_local2world(other._local2world),
 	_instantiated(false),
 	_forceVisible(false),
 	_layers(other._layers),
+	_layerMask(other._layerMask),
     _renderEntity(other._renderEntity),
     _renderState(other._renderState)
 {}
@@ -126,28 +131,33 @@ bool Node::excluded() const
 
 void Node::addToLayer(int layerId)
 {
-	_layers.insert(layerId);
+	if (_layers.count(layerId) > 0) return;
+
+	auto layers = _layers;
+	layers.insert(layerId);
+
+	setLayers(layers);
 }
 
 void Node::moveToLayer(int layerId)
 {
-	_layers.clear();
-	_layers.insert(layerId);
+	setLayers(LayerList{ layerId });
 }
 
 void Node::removeFromLayer(int layerId)
 {
 	// Look up the layer ID and remove it from the list
-	LayerList::iterator found = _layers.find(layerId);
+	if (_layers.count(layerId) == 0) return;
 
-	if (found != _layers.end()) {
-		_layers.erase(found);
+	auto layers = _layers;
+	layers.erase(layerId);
 
-		// greebo: Make sure that every node is at least member of layer 0
-		if (_layers.empty()) {
-			_layers.insert(0);
-		}
+	// greebo: Make sure that every node is at least member of layer 0
+	if (layers.empty()) {
+		layers.insert(0);
 	}
+
+	setLayers(layers);
 }
 
 const LayerList& Node::getLayers() const
@@ -155,14 +165,44 @@ const LayerList& Node::getLayers() const
 	return _layers;
 }
 
+const LayerMask& Node::getLayerMask() const
+{
+	return _layerMask;
+}
+
 void Node::assignToLayers(const LayerList& newLayers)
 {
 	if (!newLayers.empty())
     {
-        _layers = newLayers;
+        setLayers(newLayers);
     }
 }
 
+void Node::setLayers(const LayerList& layers)
+{
+	// Nodes in the scene are listed in the layer index of the root
+	auto rootNode = _instantiated ? getRootNode() : IMapRootNodePtr();
+
+	if (rootNode)
+	{
+		rootNode->getLayerManager().unregisterNode(*this);
+	}
+
+	_layers = layers;
+	_layerMask.clear();
+
+	for (int layerId : _layers)
+	{
+		_layerMask.set(layerId);
+	}
+
+	if (rootNode)
+	{
+		rootNode->getLayerManager().registerNode(*this);
+		GlobalSceneStatistics().queueUpdate(getSelf());
+	}
+}
+
 void Node::addChildNode(const INodePtr& node)
 {
 	// Add the node to the TraversableNodeSet, this triggers an
@@ -260,7 +300,16 @@ void Node::onChildAdded(const INodePtr& child)
 	child->setRenderSystem(_renderSystem.lock());
 
 	// greebo: The bounds most probably change when child nodes are added
-	boundsChanged();
+	if (auto childNode = dynamic_cast<const Node*>(child.get()); childNode)
+	{
+		// The new child is just extending the child bounds
+		childNode->_boundsInParent = AABB();
+		onChildBoundsChanged(*childNode);
+	}
+	else
+	{
+		boundsChanged();
+	}
 
 	if (!_instantiated) return;
 
@@ -278,7 +327,28 @@ void Node::onChildRemoved(const INodePtr& child)
 	// Don't change the parent node of the new child on erase
 
 	// greebo: The bounds are likely to change when child nodes are removed
-	boundsChanged();
+	if (auto childNode = dynamic_cast<const Node*>(child.get()); childNode)
+	{
+		if (childNode->_boundsChangePending)
+		{
+			childNode->_boundsChangePending = false;
+			_childrenWithChangedBounds.erase(std::find(
+				_childrenWithChangedBounds.begin(), _childrenWithChangedBounds.end(), childNode));
+		}
+
+		// The child bounds only shrink if the removed child has been touching their border
+		if (childNode->_boundsInParent.isValid() && !isInsideChildBounds(childNode->_boundsInParent))
+		{
+			_childBoundsChanged = true;
+		}
+
+		childNode->_boundsInParent = AABB();
+		propagateBoundsChanged();
+	}
+	else
+	{
+		boundsChanged();
+	}
 
 	if (!_instantiated) return;
 
@@ -302,10 +372,14 @@ void Node::onInsertIntoScene(IMapRootNode& root)
     }
 
     connectUndoSystem(root.getUndoSystem());
+
+    root.getLayerManager().registerNode(*this);
 }
 
 void Node::onRemoveFromScene(IMapRootNode& root)
 {
+    root.getLayerManager().unregisterNode(*this);
+
     disconnectUndoSystem(root.getUndoSystem());
 
     bool wasVisible = visible();
@@ -383,11 +457,16 @@ void Node::evaluateBounds() const
 		ASSERT_MESSAGE(!_boundsMutex, "re-entering bounds evaluation");
 		_boundsMutex = true;
 
+		// The region covered by the previous and the current own geometry is
+		// what needs to be redrawn, the children are reporting their own changes
+		AABB damagedBounds = _ownBounds;
+
 		_bounds = childBounds();
 
-		_bounds.includeAABB(
-			AABB::createFromOrientedAABBSafe(localAABB(), localToWorld())
-		);
+		_ownBounds = AABB::createFromOrientedAABBSafe(localAABB(), localToWorld());
+		_bounds.includeAABB(_ownBounds);
+
+		damagedBounds.includeAABB(_ownBounds);
 
 		_boundsMutex = false;
 		_boundsChanged = false;
@@ -397,7 +476,7 @@ void Node::evaluateBounds() const
 
 		if (sceneGraph)
 		{
-			sceneGraph->nodeBoundsChanged(const_cast<Node*>(this)->shared_from_this());
+			sceneGraph->nodeBoundsChanged(const_cast<Node*>(this)->shared_from_this(), damagedBounds);
 		}
 	}
 }
@@ -412,27 +491,130 @@ void Node::evaluateChildBounds() const {
 		ASSERT_MESSAGE(!_childBoundsMutex, "re-entering bounds evaluation");
 		_childBoundsMutex = true;
 
-		_childBounds = AABB();
+		accumulateChildBounds();
+
+		_childBoundsMutex = false;
+		_childBoundsChanged = false;
+	}
+	else if (!_childrenWithChangedBounds.empty()) {
+		ASSERT_MESSAGE(!_childBoundsMutex, "re-entering bounds evaluation");
+		_childBoundsMutex = true;
+
+		std::vector<const Node*> changedChildren;
+		changedChildren.swap(_childrenWithChangedBounds);
+
+		// The previous bounds of the changed children can only be replaced
+		// if none of them has been defining the border of the child bounds
+		bool canBeExtended = true;
+
+		for (auto child : changedChildren)
+		{
+			child->_boundsChangePending = false;
 
-		// Instantiate an AABB accumulator
-		AABBAccumulateWalker accumulator(_childBounds);
+			if (child->_boundsInParent.isValid() && !isInsideChildBounds(child->_boundsInParent))
+			{
+				canBeExtended = false;
+			}
+		}
 
-		// greebo: traverse the children of this node
-		traverseChildren(accumulator);
+		if (canBeExtended)
+		{
+			for (auto child : changedChildren)
+			{
+				child->_boundsInParent = child->worldAABB();
+				_childBounds.includeAABB(child->_boundsInParent);
+			}
+		}
+		else
+		{
+			accumulateChildBounds();
+		}
 
 		_childBoundsMutex = false;
-		_childBoundsChanged = false;
 	}
 }
 
+void Node::accumulateChildBounds() const
+{
+	clearChildrenWithChangedBounds();
+
+	_childBounds = AABB();
+
+	// Visits the first order children, remembering the bounds each of them contributed
+	class ChildBoundsAccumulator :
+		public NodeVisitor
+	{
+	private:
+		AABB& _bounds;
+
+	public:
+		ChildBoundsAccumulator(AABB& bounds) :
+			_bounds(bounds)
+		{}
+
+		bool pre(const INodePtr& node) override
+		{
+			const AABB& childBounds = node->worldAABB();
+			_bounds.includeAABB(childBounds);
+
+			if (auto childNode = dynamic_cast<const Node*>(node.get()); childNode)
+			{
+				childNode->_boundsInParent = childBounds;
+			}
+
+			// Don't traverse the children
+			return false;
+		}
+	};
+
+	ChildBoundsAccumulator accumulator(_childBounds);
+
+	// greebo: traverse the children of this node
+	traverseChildren(accumulator);
+}
+
+void Node::clearChildrenWithChangedBounds() const
+{
+	for (auto child : _childrenWithChangedBounds)
+	{
+		child->_boundsChangePending = false;
+	}
+
+	_childrenWithChangedBounds.clear();
+}
+
+bool Node::isInsideChildBounds(const AABB& bounds) const
+{
+	// Tolerance for the rounding errors of the accumulated bounds
+	constexpr double Epsilon = 0.001;
+
+	if (!_childBounds.isValid()) return false;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		if (bounds.origin[i] - bounds.extents[i] <= _childBounds.origin[i] - _childBounds.extents[i] + Epsilon ||
+			bounds.origin[i] + bounds.extents[i] >= _childBounds.origin[i] + _childBounds.extents[i] - Epsilon)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void Node::boundsChanged() {
-	_boundsChanged = true;
+	// Nothing is known about the change, the child bounds need to be evaluated from scratch
 	_childBoundsChanged = true;
+	clearChildrenWithChangedBounds();
 
-	INodePtr parent = _parent.lock();
-	if (parent != NULL) {
-		parent->boundsChanged();
-	}
+	propagateBoundsChanged();
+}
+
+void Node::propagateBoundsChanged() const
+{
+	_boundsChanged = true;
+
+	notifyParentBoundsChanged();
 
 	// greebo: It's enough if only root nodes call the global scenegraph
 	// as nodes are passing their calls up to their parents anyway
@@ -447,6 +629,36 @@ void Node::boundsChanged() {
 	}
 }
 
+void Node::notifyParentBoundsChanged() const
+{
+	INodePtr parent = _parent.lock();
+
+	if (!parent) return;
+
+	// Let the parent know which child changed, to update its child bounds incrementally
+	if (auto parentNode = dynamic_cast<const Node*>(parent.get()); parentNode)
+	{
+		parentNode->onChildBoundsChanged(*this);
+	}
+	else
+	{
+		parent->boundsChanged();
+	}
+}
+
+void Node::onChildBoundsChanged(const Node& child) const
+{
+	// No need to remember the child if the child bounds are re-calculated anyway,
+	// or if the child bounds are being evaluated right now (reading the new child bounds)
+	if (!_childBoundsChanged && !_childBoundsMutex && !child._boundsChangePending)
+	{
+		child._boundsChangePending = true;
+		_childrenWithChangedBounds.push_back(&child);
+	}
+
+	propagateBoundsChanged();
+}
+
 const Matrix4& Node::localToWorld() const {
 	evaluateTransform();
 	return _local2world;
@@ -458,9 +670,7 @@ void Node::evaluateTransform() const {
 		_transformMutex = true;
 
 		INodePtr parent = _parent.lock();
-		if (parent != NULL) {
-			parent->boundsChanged();
-		}
+		notifyParentBoundsChanged();
 
 		_local2world = (parent != NULL) ? parent->localToWorld() : Matrix4::getIdentity();
 
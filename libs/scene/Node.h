@@ -4,6 +4,7 @@
 #include "ipath.h"
 #include "irender.h"
 #include <list>
+#include <vector>
 #include "TraversableNodeSet.h"
 #include "math/AABB.h"
 #include "math/Matrix4.h"
@@ -37,6 +38,12 @@ private:
 	// Auto-incrementing ID (contains the largest ID in use)
 	static unsigned long _maxNodeId;
 
+	// The children that changed their bounds since the child bounds have been evaluated.
+	// As long as their previous bounds are not touching the border of the child bounds,
+	// these can be updated without visiting all children. This needs to be declared
+	// before the child set, which is notifying this node on destruction.
+	mutable std::vector<const Node*> _childrenWithChangedBounds;
+
 	TraversableNodeSet _children;
 
 	// A weak reference to the parent node
@@ -51,6 +58,16 @@ private:
 	mutable bool _transformChanged;
 	mutable bool _transformMutex;
 
+	// The world bounds this node contributed to the child bounds of its parent
+	mutable AABB _boundsInParent;
+
+	// The world bounds of this node's own geometry (excluding the children),
+	// as of the last bounds evaluation
+	mutable AABB _ownBounds;
+
+	// True if this node is listed in the parent's _childrenWithChangedBounds
+	mutable bool _boundsChangePending;
+
 	mutable Matrix4 _local2world;
 
 	// Is true when the node is part of the scenegraph
@@ -63,8 +80,32 @@ private:
 	// The list of layers this object is associated to
 	LayerList _layers;
 
+	// The same layers as bit mask
+	LayerMask _layerMask;
+
     RenderState _renderState;
 
+	// Marks the bounds of this node as changed, notifying the parent and the scene graph
+	void propagateBoundsChanged() const;
+
+	// Notifies the parent node (if any) about the bounds of this node having changed
+	void notifyParentBoundsChanged() const;
+
+	// Called by a child node after its world bounds changed
+	void onChildBoundsChanged(const Node& child) const;
+
+	// Returns true if the given box is located inside the child bounds, not touching their border
+	bool isInsideChildBounds(const AABB& bounds) const;
+
+	// Recalculates the child bounds from scratch, visiting all children
+	void accumulateChildBounds() const;
+
+	// Removes the pending mark of all children that changed their bounds
+	void clearChildrenWithChangedBounds() const;
+
+	// Assigns the layers, keeping the mask and the index of the layer manager up to date
+	void setLayers(const LayerList& layers);
+
 protected:
 	// If this node is attached to a parent entity, this is the reference to it
     IRenderEntity* _renderEntity;
@@ -106,6 +147,7 @@ public:
     void removeFromLayer(int layerId) override;
 	void moveToLayer(int layerId) override;
     const LayerList& getLayers() const override;
+    const LayerMask& getLayerMask() const override;
 	void assignToLayers(const LayerList& newLayers) override;
 
 	void addChildNode(const INodePtr& node) override;
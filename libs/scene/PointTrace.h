@@ -1,6 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
 #include "math/Vector3.h"
+#include "string/convert.h"
 
 namespace map
 {
@@ -21,16 +29,54 @@ public:
     /// Construct a PointTrace to read point data from the given stream
     explicit PointTrace(std::istream& stream)
     {
-        // Point file consists of one point per line, with three components
-        double x, y, z;
-        while (stream >> x >> y >> z)
-        {
-            _points.push_back(Vector3(x, y, z));
-        }
+        ForEachPoint(stream, [&](const Vector3& point) { _points.push_back(point); });
     }
 
     /// Return points parsed
     const Points& points() const { return _points; }
+
+    /**
+     * Streams the points of the given .lin data to the given functor, one at a
+     * time, without collecting them first. The point file consists of one point
+     * per line with three components. Parsing stops at the first token which is
+     * not a number, like extracting the values with operator>> would.
+     */
+    template<typename Functor>
+    static void ForEachPoint(std::istream& stream, Functor&& functor)
+    {
+        std::string line;
+        double components[3];
+        std::size_t numComponents = 0;
+
+        while (std::getline(stream, line))
+        {
+            std::string_view remaining(line);
+
+            while (true)
+            {
+                auto start = remaining.find_first_not_of(" \t\r");
+
+                if (start == std::string_view::npos) break;
+
+                remaining.remove_prefix(start);
+
+                auto tokenLength = std::min(remaining.find_first_of(" \t\r"), remaining.size());
+                auto value = string::parseDouble(remaining.substr(0, tokenLength),
+                    std::numeric_limits<double>::quiet_NaN());
+
+                if (std::isnan(value)) return;
+
+                remaining.remove_prefix(tokenLength);
+                components[numComponents++] = value;
+
+                if (numComponents == 3)
+                {
+                    functor(Vector3(components[0], components[1], components[2]));
+                    numComponents = 0;
+                }
+            }
+        }
+    }
 };
 
-}
\ No newline at end of file
+}
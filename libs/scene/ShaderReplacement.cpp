@@ -0,0 +1,158 @@
+#include "ShaderReplacement.h"
+
+#include <atomic>
+#include <future>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "ibrush.h"
+#include "ipatch.h"
+#include "iscenegraph.h"
+#include "iselection.h"
+#include "iundo.h"
+#include "scenelib.h"
+#include "string/InternedString.h"
+
+namespace scene
+{
+
+namespace
+{
+    // Invokes the given function for each index in [0..count) using all available cores
+    void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+    {
+        std::atomic<std::size_t> nextIndex(0);
+
+        auto worker = [&]()
+        {
+            for (auto i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        };
+
+        auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+        std::vector<std::future<void>> workers;
+
+        for (std::size_t i = 1; i < numWorkers; ++i)
+        {
+            workers.emplace_back(std::async(std::launch::async, worker));
+        }
+
+        // The calling thread is processing its share too
+        worker();
+
+        // Wait for all workers, this is re-throwing any exceptions
+        for (auto& result : workers)
+        {
+            result.get();
+        }
+    }
+
+    // The brushes and patches to search, faces are only considered if visible
+    std::vector<INodePtr> collectPrimitives(bool selectedOnly)
+    {
+        std::vector<INodePtr> primitives;
+        std::unordered_set<INode*> visited;
+
+        auto addPrimitive = [&](const INodePtr& node)
+        {
+            if ((Node_isBrush(node) || Node_isPatch(node)) && visited.insert(node.get()).second)
+            {
+                primitives.push_back(node);
+            }
+
+            return true;
+        };
+
+        if (!selectedOnly)
+        {
+            GlobalSceneGraph().root()->foreachNode([&](const INodePtr& node)
+            {
+                return node->visible() ? addPrimitive(node) : true;
+            });
+
+            return primitives;
+        }
+
+        if (GlobalSelectionSystem().getSelectionMode() == selection::SelectionMode::Component)
+        {
+            return primitives;
+        }
+
+        GlobalSelectionSystem().foreachSelected([&](const INodePtr& node)
+        {
+            // Selected group nodes contribute their child primitives
+            addPrimitive(node);
+            node->foreachNode(addPrimitive);
+        });
+
+        return primitives;
+    }
+}
+
+int findAndReplaceShader(const std::string& find, const std::string& replace, bool selectedOnly)
+{
+    std::string command("textureFindReplace");
+    command += "-find " + find + " -replace " + replace;
+    UndoableCommand undo(command);
+
+    auto primitives = collectPrimitives(selectedOnly);
+
+    // The material names of faces and patches are interned, the search
+    // is comparing the addresses of the pooled strings only
+    string::InternedString findId(find);
+
+    // Search all primitives in parallel, this is reading the material names only
+    std::vector<std::vector<std::size_t>> matchingFaces(primitives.size());
+    std::vector<char> patchMatches(primitives.size(), 0);
+
+    runInParallel(primitives.size(), [&](std::size_t index)
+    {
+        const auto& node = primitives[index];
+
+        if (auto brush = Node_getIBrush(node); brush != nullptr)
+        {
+            for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+            {
+                const auto& face = brush->getFace(i);
+
+                if (&face.getShader() == &findId.get() && face.isVisible())
+                {
+                    matchingFaces[index].push_back(i);
+                }
+            }
+        }
+        else if (auto patch = Node_getIPatch(node); patch != nullptr)
+        {
+            patchMatches[index] = &patch->getShader() == &findId.get();
+        }
+    });
+
+    // Apply the changes, this is triggering undo and renderable updates
+    int counter = 0;
+
+    for (std::size_t index = 0; index < primitives.size(); ++index)
+    {
+        if (!matchingFaces[index].empty())
+        {
+            auto brush = Node_getIBrush(primitives[index]);
+
+            for (auto faceIndex : matchingFaces[index])
+            {
+                brush->getFace(faceIndex).setShader(replace);
+                ++counter;
+            }
+        }
+        else if (patchMatches[index])
+        {
+            Node_getIPatch(primitives[index])->setShader(replace);
+            ++counter;
+        }
+    }
+
+    return counter;
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+namespace scene
+{
+
+/**
+ * greebo: Replaces the material <find> with <replace> on all visible faces
+ * and patches of the scene, or on the selected ones only.
+ * The changes are applied in a single undoable command.
+ *
+ * @returns: the number of replaced faces and patches.
+ */
+int findAndReplaceShader(const std::string& find, const std::string& replace, bool selectedOnly);
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ispacepartition.h"
+#include "fmt/format.h"
+
+namespace scene
+{
+
+/**
+ * Figures about the shape of a space partition tree, used to judge the quality
+ * of the partition (e.g. a crowded root node or very deep branches).
+ */
+struct SpacePartitionStatistics
+{
+    std::size_t numNodes = 0;
+    std::size_t numLeaves = 0;
+    std::size_t numEmptyNodes = 0;
+
+    // The depth of the deepest node, the root node has depth 0
+    std::size_t maxDepth = 0;
+
+    std::size_t numMembers = 0;
+    std::size_t numRootMembers = 0;
+    std::size_t maxMembersPerNode = 0;
+
+    // The number of members linked at each depth
+    std::vector<std::size_t> membersPerDepth;
+
+    // Averages of the volume queries over the last frames, see Graph::getSpacePartitionQueryStatistics
+    double queriesPerFrame = 0;
+    double visitedNodesPerFrame = 0;
+
+    double getVisitedNodesPerQuery() const
+    {
+        return queriesPerFrame > 0 ? visitedNodesPerFrame / queriesPerFrame : 0;
+    }
+
+    // Single line summary
+    std::string toString() const
+    {
+        return fmt::format("SP nodes: {0} | Max depth: {1} | Members: {2} | Root members: {3} | "
+            "Max members/node: {4} | Visits/frame: {5:.1f} ({6:.1f} per query)",
+            numNodes, maxDepth, numMembers, numRootMembers, maxMembersPerNode,
+            visitedNodesPerFrame, getVisitedNodesPerQuery());
+    }
+
+    // Multi-line report, including the member distribution over the tree levels
+    std::string toReport() const
+    {
+        std::string report = fmt::format("Nodes: {0} ({1} leaves, {2} empty)\n", numNodes, numLeaves, numEmptyNodes);
+
+        report += fmt::format("Maximum depth: {0}\n", maxDepth);
+        report += fmt::format("Members: {0} ({1} in the root node, at most {2} per node)\n",
+            numMembers, numRootMembers, maxMembersPerNode);
+
+        for (std::size_t depth = 0; depth < membersPerDepth.size(); ++depth)
+        {
+            report += fmt::format("  Depth {0}: {1} members\n", depth, membersPerDepth[depth]);
+        }
+
+        report += fmt::format("Volume queries per frame: {0:.1f}\n", queriesPerFrame);
+        report += fmt::format("Visited nodes per frame: {0:.1f} ({1:.1f} per query)\n",
+            visitedNodesPerFrame, getVisitedNodesPerQuery());
+
+        return report;
+    }
+};
+
+namespace detail
+{
+
+inline void collectSpacePartitionStatistics(const ISPNode& node, std::size_t depth, SpacePartitionStatistics& stats)
+{
+    auto numMembers = node.getMembers().size();
+
+    stats.numNodes++;
+    stats.numLeaves += node.isLeaf() ? 1 : 0;
+    stats.numEmptyNodes += numMembers == 0 ? 1 : 0;
+    stats.maxDepth = std::max(stats.maxDepth, depth);
+    stats.numMembers += numMembers;
+    stats.maxMembersPerNode = std::max(stats.maxMembersPerNode, numMembers);
+
+    if (stats.membersPerDepth.size() <= depth)
+    {
+        stats.membersPerDepth.resize(depth + 1, 0);
+    }
+
+    stats.membersPerDepth[depth] += numMembers;
+
+    for (const auto& child : node.getChildNodes())
+    {
+        collectSpacePartitionStatistics(*child, depth + 1, stats);
+    }
+}
+
+}
+
+// Walks the tree below the given root node, the query figures are left at zero
+inline SpacePartitionStatistics collectSpacePartitionStatistics(const ISPNodePtr& root)
+{
+    SpacePartitionStatistics stats;
+
+    if (root)
+    {
+        stats.numRootMembers = root->getMembers().size();
+        detail::collectSpacePartitionStatistics(*root, 0, stats);
+    }
+
+    return stats;
+}
+
+}
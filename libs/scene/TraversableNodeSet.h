@@ -4,6 +4,7 @@
 #include "iundo.h"
 #include <list>
 #include "util/Noncopyable.h"
+#include "util/PoolAllocator.h"
 
 namespace scene
 {
@@ -25,7 +26,8 @@ class TraversableNodeSet final :
 	public sigc::trackable
 {
 public:
-	typedef std::list<INodePtr> NodeList;
+	// The list elements are pooled, keeping the children of large nodes close together
+	typedef std::list<INodePtr, util::PoolAllocator<INodePtr>> NodeList;
 
 private:
 	NodeList _children;
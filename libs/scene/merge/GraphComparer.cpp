@@ -1,10 +1,16 @@
 #include "GraphComparer.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+#include <vector>
 #include "ientity.h"
 #include "i18n.h"
 #include "itextstream.h"
 #include "iselectiongroup.h"
+#include "imapfilechangetracker.h"
 #include "icomparablenode.h"
 #include "math/Hash.h"
 #include "scenelib.h"
@@ -18,12 +24,163 @@ namespace scene
 namespace merge
 {
 
+namespace
+{
+    // Invokes the given function for each index in [0..count) using all available cores
+    void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+    {
+        std::atomic<std::size_t> nextIndex(0);
+
+        auto worker = [&]()
+        {
+            for (auto i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        };
+
+        auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+        std::vector<std::future<void>> workers;
+
+        for (std::size_t i = 1; i < numWorkers; ++i)
+        {
+            workers.emplace_back(std::async(std::launch::async, worker));
+        }
+
+        // The calling thread is processing its share too
+        worker();
+
+        // Wait for all workers, this is re-throwing any exceptions
+        for (auto& result : workers)
+        {
+            result.get();
+        }
+    }
+
+    using NodeFingerprints = std::vector<std::pair<std::string, INodePtr>>;
+
+    // Calculates the fingerprints of the child nodes matching the predicate,
+    // this doesn't touch anything but the given nodes and can be run in parallel
+    NodeFingerprints calculateFingerprints(const INodePtr& parent,
+        const std::function<bool(const INodePtr& node)>& nodePredicate)
+    {
+        NodeFingerprints result;
+
+        parent->foreachNode([&](const INodePtr& node)
+        {
+            if (!nodePredicate(node)) return true;
+
+            auto comparable = std::dynamic_pointer_cast<IComparableNode>(node);
+            assert(comparable);
+
+            if (comparable)
+            {
+                result.emplace_back(comparable->getFingerprint(), node);
+            }
+
+            return true;
+        });
+
+        return result;
+    }
+
+    inline bool isPrimitive(const INodePtr& node)
+    {
+        return node->getNodeType() == INode::Type::Brush || node->getNodeType() == INode::Type::Patch;
+    }
+
+    // Sorts the fingerprints into a map, the first node wins in case of collisions
+    Fingerprints toSortedFingerprints(const NodeFingerprints& fingerprints, const INodePtr& parent)
+    {
+        Fingerprints result;
+
+        for (const auto& pair : fingerprints)
+        {
+            if (!result.try_emplace(pair.first, pair.second).second)
+            {
+                rWarning() << "More than one node with the same fingerprint found in the parent node with name " << parent->name() << std::endl;
+            }
+        }
+
+        return result;
+    }
+}
+
+std::shared_ptr<const FingerprintCache::EntityFingerprints> FingerprintCache::getEntityFingerprints(const IMapRootNodePtr& root)
+{
+    auto changeCount = root->getUndoChangeTracker().getCurrentChangeCount();
+    auto existing = _entries.find(root.get());
+
+    if (existing != _entries.end() && existing->second.root.lock() == root &&
+        existing->second.changeCount == changeCount)
+    {
+        return existing->second.fingerprints;
+    }
+
+    // Collect the entities first, to calculate their fingerprints in parallel
+    std::vector<INodePtr> entities;
+
+    root->foreachNode([&](const INodePtr& node)
+    {
+        if (node->getNodeType() == INode::Type::Entity)
+        {
+            entities.push_back(node);
+        }
+
+        return true;
+    });
+
+    std::vector<NodeFingerprints> fingerprints(entities.size());
+
+    runInParallel(entities.size(), [&](std::size_t i)
+    {
+        auto comparable = std::dynamic_pointer_cast<IComparableNode>(entities[i]);
+        assert(comparable);
+
+        if (comparable)
+        {
+            fingerprints[i].emplace_back(comparable->getFingerprint(), entities[i]);
+        }
+    });
+
+    auto result = std::make_shared<EntityFingerprints>();
+
+    for (const auto& entityFingerprint : fingerprints)
+    {
+        for (const auto& pair : entityFingerprint)
+        {
+            if (!result->sorted.try_emplace(pair.first, pair.second).second)
+            {
+                rWarning() << "More than one node with the same fingerprint found in the parent node with name " << root->name() << std::endl;
+                continue;
+            }
+
+            result->index.emplace(pair.first, pair.second);
+        }
+    }
+
+    _entries[root.get()] = Entry{ root, changeCount, result };
+
+    return result;
+}
+
 ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, const IMapRootNodePtr& base)
+{
+    FingerprintCache cache;
+    return Compare(source, base, cache);
+}
+
+ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, const IMapRootNodePtr& base,
+    FingerprintCache& cache)
 {
     auto result = std::make_shared<ComparisonResult>(source, base);
 
-    auto sourceEntities = NodeUtils::CollectEntityFingerprints(source);
-    auto baseEntities = NodeUtils::CollectEntityFingerprints(base);
+    auto sourceFingerprints = cache.getEntityFingerprints(source);
+    auto baseFingerprints = cache.getEntityFingerprints(base);
+
+    const auto& sourceEntities = sourceFingerprints->sorted;
+    const auto& baseEntities = baseFingerprints->sorted;
 
     // Filter out all the matching nodes and store them in the result
     if (sourceEntities.empty())
@@ -37,9 +194,9 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
     for (const auto& sourceEntity : sourceEntities)
     {
         // Check each source node for an equivalent node in the base
-        auto matchingBaseNode = baseEntities.find(sourceEntity.first);
+        auto matchingBaseNode = baseFingerprints->index.find(sourceEntity.first);
 
-        if (matchingBaseNode != baseEntities.end())
+        if (matchingBaseNode != baseFingerprints->index.end())
         {
             // Found an equivalent node
             result->equivalentEntities.emplace_back(ComparisonResult::Match{ sourceEntity.first, sourceEntity.second, matchingBaseNode->second });
@@ -57,7 +214,7 @@ ComparisonResult::Ptr GraphComparer::Compare(const IMapRootNodePtr& source, cons
     {
         // Check each source node for an equivalent node in the base
         // Matching nodes have already been checked in the above loop
-        if (sourceEntities.count(baseEntity.first) == 0)
+        if (sourceFingerprints->index.count(baseEntity.first) == 0)
         {
             auto entityName = NodeUtils::GetEntityName(baseEntity.second);
             baseMismatches.emplace(entityName, EntityMismatch{ baseEntity.first, baseEntity.second, entityName });
@@ -93,16 +250,42 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
     std::set_difference(baseMismatches.begin(), baseMismatches.end(), sourceMismatches.begin(), sourceMismatches.end(),
         std::back_inserter(missingInSource), compareEntityNames);
 
+    // Calculate the primitive fingerprints of all entities present in both graphs in parallel
+    std::vector<std::pair<const EntityMismatch*, const EntityMismatch*>> matchingEntities;
+
     for (const auto& match : matchingByName)
     {
-        auto sourceMismatch = sourceMismatches.find(match.second.entityName)->second;
-        auto baseMismatch = baseMismatches.find(match.second.entityName)->second;
+        matchingEntities.emplace_back(&sourceMismatches.find(match.second.entityName)->second,
+            &baseMismatches.find(match.second.entityName)->second);
+    }
+
+    std::vector<NodeFingerprints> sourceChildren(matchingEntities.size());
+    std::vector<NodeFingerprints> baseChildren(matchingEntities.size());
+
+    runInParallel(matchingEntities.size() * 2, [&](std::size_t i)
+    {
+        const auto& match = matchingEntities[i / 2];
+
+        if (i % 2 == 0)
+        {
+            sourceChildren[i / 2] = calculateFingerprints(match.first->node, isPrimitive);
+        }
+        else
+        {
+            baseChildren[i / 2] = calculateFingerprints(match.second->node, isPrimitive);
+        }
+    });
+
+    for (std::size_t i = 0; i < matchingEntities.size(); ++i)
+    {
+        const auto& sourceMismatch = *matchingEntities[i].first;
+        const auto& baseMismatch = *matchingEntities[i].second;
 
         auto& entityDiff = result.differingEntities.emplace_back(ComparisonResult::EntityDifference
         {
             sourceMismatch.node,
             baseMismatch.node,
-            match.second.entityName,
+            sourceMismatch.entityName,
             sourceMismatch.fingerPrint,
             baseMismatch.fingerPrint,
             ComparisonResult::EntityDifference::Type::EntityPresentButDifferent
@@ -112,7 +295,9 @@ void GraphComparer::processDifferingEntities(ComparisonResult& result, const Ent
         entityDiff.differingKeyValues = compareKeyValues(sourceMismatch.node, baseMismatch.node);
 
         // Analyse the child nodes
-        entityDiff.differingChildren = compareChildNodes(sourceMismatch.node, baseMismatch.node);
+        entityDiff.differingChildren = compareChildNodes(
+            toSortedFingerprints(sourceChildren[i], sourceMismatch.node),
+            toSortedFingerprints(baseChildren[i], baseMismatch.node));
     }
 
     for (const auto& mismatch : missingInSource)
@@ -226,13 +411,10 @@ std::list<ComparisonResult::KeyValueDifference> GraphComparer::compareKeyValues(
 }
 
 std::list<ComparisonResult::PrimitiveDifference> GraphComparer::compareChildNodes(
-    const INodePtr& sourceNode, const INodePtr& baseNode)
+    const Fingerprints& sourceChildren, const Fingerprints& baseChildren)
 {
     std::list<ComparisonResult::PrimitiveDifference> result;
 
-    auto sourceChildren = NodeUtils::CollectPrimitiveFingerprints(sourceNode);
-    auto baseChildren = NodeUtils::CollectPrimitiveFingerprints(baseNode);
-
     std::vector<Fingerprints::value_type> missingInSource;
     std::vector<Fingerprints::value_type> missingInBase;
 
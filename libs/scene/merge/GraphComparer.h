@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <unordered_map>
 
 #include "inode.h"
 #include "imap.h"
@@ -17,6 +18,43 @@ namespace scene
 namespace merge
 {
 
+/**
+ * Entity fingerprints of the scenes compared by the GraphComparer, allowing
+ * repeated comparisons against the same scene to re-use them, like the
+ * three-way merge comparing both the source and the target to the base.
+ *
+ * The fingerprints of a scene are discarded once the undo change count of its
+ * root differs from the one they have been calculated for. Changes that are
+ * not recorded by the undo system are not detected, so the cache should not
+ * outlive the comparisons it has been created for.
+ */
+class FingerprintCache
+{
+public:
+    struct EntityFingerprints
+    {
+        // Fingerprint => entity node, sorted by fingerprint
+        std::map<std::string, INodePtr> sorted;
+
+        // The same nodes, for constant time lookups
+        std::unordered_map<std::string, INodePtr> index;
+    };
+
+private:
+    struct Entry
+    {
+        std::weak_ptr<IMapRootNode> root;
+        std::size_t changeCount;
+        std::shared_ptr<EntityFingerprints> fingerprints;
+    };
+
+    std::map<const IMapRootNode*, Entry> _entries;
+
+public:
+    // Returns the entity fingerprints of the given scene, calculating them if necessary
+    std::shared_ptr<const EntityFingerprints> getEntityFingerprints(const IMapRootNodePtr& root);
+};
+
 /**
  * Static utility class to compare two scenes given by their root nodes.
  * The Source is considered to be the "newer" graph with the changes,
@@ -41,6 +79,10 @@ public:
     // Compares the two graphs and returns the result
     static ComparisonResult::Ptr Compare(const IMapRootNodePtr& source, const IMapRootNodePtr& base);
 
+    // Compares the two graphs using the fingerprints stored in the given cache
+    static ComparisonResult::Ptr Compare(const IMapRootNodePtr& source, const IMapRootNodePtr& base,
+        FingerprintCache& cache);
+
 private:
     static void processDifferingEntities(ComparisonResult& result, const EntityMismatchByName& sourceMismatches, 
         const EntityMismatchByName& baseMismatches);
@@ -49,7 +91,7 @@ private:
         const INodePtr& sourceNode, const INodePtr& baseNode);
 
     static std::list<ComparisonResult::PrimitiveDifference> compareChildNodes(
-        const INodePtr& sourceNode, const INodePtr& baseNode);
+        const Fingerprints& sourceChildren, const Fingerprints& baseChildren);
 };
 
 }
@@ -25,8 +25,11 @@ struct ThreeWayMergeOperation::ComparisonData
 
     ComparisonData(const IMapRootNodePtr& baseRoot, const IMapRootNodePtr& sourceRoot, const IMapRootNodePtr& targetRoot)
     {
-        baseToSource = GraphComparer::Compare(sourceRoot, baseRoot);
-        baseToTarget = GraphComparer::Compare(targetRoot, baseRoot);
+        // The base scene is fingerprinted once for both comparisons
+        FingerprintCache fingerprints;
+
+        baseToSource = GraphComparer::Compare(sourceRoot, baseRoot, fingerprints);
+        baseToTarget = GraphComparer::Compare(targetRoot, baseRoot, fingerprints);
 
         // Create source and target entity diff dictionaries (by entity name)
         for (auto it = baseToSource->differingEntities.begin(); it != baseToSource->differingEntities.end(); ++it)
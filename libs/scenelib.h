@@ -21,6 +21,13 @@ inline bool Node_isPrimitive(const scene::INodePtr& node)
     return type == scene::INode::Type::Brush || type == scene::INode::Type::Patch;
 }
 
+// True for the placeholders standing in for the entities and primitives
+// which have not been parsed by a partial map load
+inline bool Node_isUnloadedBlock(const scene::INodePtr& node)
+{
+    return node->getNodeType() == scene::INode::Type::UnloadedBlock;
+}
+
 namespace scene
 {
 
@@ -24,6 +24,9 @@ namespace selection
  * Keys that are now shared but were not listed before => signal_KeyAdded
  * Values that are no longer shared will disappear from the list => signal_KeyRemoved
  * Keys changing their value (shared or not) => signal_KeyValueSetChanged
+ *
+ * Every key keeps count of the distinct values of its entities, such that
+ * the uniqueness is known without comparing the values of all entities.
  */
 class CollectiveSpawnargs
 {
@@ -36,6 +39,24 @@ public:
 
         bool valueIsEqualOnAllEntities;
         std::set<Entity*> entities;
+
+        // The number of entities using each value of this key
+        std::map<std::string, std::size_t> valueCounts;
+
+        void addValue(const std::string& value)
+        {
+            ++valueCounts[value];
+        }
+
+        void removeValue(const std::string& value)
+        {
+            auto count = valueCounts.find(value);
+
+            if (count != valueCounts.end() && --count->second == 0)
+            {
+                valueCounts.erase(count);
+            }
+        }
     };
 
 private:
@@ -109,7 +130,11 @@ public:
         auto entityList = _entitiesByKey.try_emplace(key);
 
         auto& keyValueSet = entityList.first->second;
-        keyValueSet.entities.emplace(entity);
+
+        if (keyValueSet.entities.emplace(entity).second)
+        {
+            keyValueSet.addValue(valueString);
+        }
 
         if (keyValueSet.entities.size() == 1)
         {
@@ -154,14 +179,7 @@ public:
         // Only bother checking if the entity count is the same as the value count
         else if (keyValueSet.entities.size() == _keyValuesByEntity.size())
         {
-            auto valueIsUnique = std::all_of(
-                keyValueSet.entities.begin(), keyValueSet.entities.end(), [&](Entity* existing)
-                {
-                    if (entity == existing) return true; // don't check against self
-
-                    const auto& kv = getCachedKeyValuePairForEntity(existing, key);
-                    return kv.second == valueString;
-                });
+            auto valueIsUnique = keyValueSet.valueCounts.size() == 1;
 
             if (valueIsUnique)
             {
@@ -174,12 +192,20 @@ public:
     void onKeyChange(Entity* entity, const std::string& key, const std::string& value)
     {
         auto kv = _keyValuesByEntity.try_emplace(entity);
-        kv.first->second[key] = value;
+        auto& cachedValue = kv.first->second[key];
 
         // On key value change, we don't need to update the entity set in _entitiesByKey
         // But since the value changed its uniqueness might have changed with it
         auto e = _entitiesByKey.find(key);
 
+        if (e != _entitiesByKey.end() && e->second.entities.count(entity) > 0)
+        {
+            e->second.removeValue(cachedValue);
+            e->second.addValue(value);
+        }
+
+        cachedValue = value;
+
         if (e != _entitiesByKey.end())
         {
             if (e->second.entities.size() > 1)
@@ -198,7 +224,21 @@ public:
 
     void onKeyErase(Entity* entity, const std::string& key, EntityKeyValue& value)
     {
-        removeKey(entity, key);
+        // Prefer the value we saw last, this is the one counted in the key value set
+        auto cachedValue = value.get();
+        auto kv = _keyValuesByEntity.find(entity);
+
+        if (kv != _keyValuesByEntity.end())
+        {
+            auto existing = kv->second.find(key);
+
+            if (existing != kv->second.end())
+            {
+                cachedValue = existing->second;
+            }
+        }
+
+        removeKey(entity, key, cachedValue);
     }
 
     void onEntityAdded(Entity* entity)
@@ -259,7 +299,7 @@ public:
         // Remove the entity from all key-mapped lists
         for (const auto& pair : keyValues)
         {
-            removeKey(entity, pair.first);
+            removeKey(entity, pair.first, pair.second);
         }
 
         // Removing an entity might render existing keys visible
@@ -319,7 +359,8 @@ public:
     }
 
 private:
-    void removeKey(Entity* entity, const std::string& key)
+    // The value is taken by copy, the cached one is erased along the way
+    void removeKey(Entity* entity, const std::string& key, std::string value)
     {
         // The incoming Entity* pointer is only used as key and should not be de-referenced
         // as the owning scene::Node might already have turned its toes up to the daisies
@@ -343,7 +384,10 @@ private:
         {
             auto& keyValueSet = entityList->second;
 
-            keyValueSet.entities.erase(entity);
+            if (keyValueSet.entities.erase(entity) > 0)
+            {
+                keyValueSet.removeValue(value);
+            }
 
             if (keyValueSet.entities.empty())
             {
@@ -364,16 +408,9 @@ private:
         // If the value was not shared before, it might have changed to be the same for all entities now
         if (!keyValueSet.valueIsEqualOnAllEntities)
         {
-            // std::all_of will still return true if the range is empty
-            bool valueIsUnique = std::all_of(_keyValuesByEntity.begin(), _keyValuesByEntity.end(),
-                [&](const KeyValuesByEntity::value_type& pair)
-            {
-                // No need to compare the value of the entity that got changed
-                if (entity == pair.first) return true;
-
-                auto existingKey = pair.second.find(key);
-                return existingKey != pair.second.end() && existingKey->second == newValue;
-            });
+            // The value must be present on all entities, and it must be the only one
+            bool valueIsUnique = keyValueSet.entities.size() == _keyValuesByEntity.size() &&
+                keyValueSet.valueCounts.size() == 1;
 
             if (valueIsUnique)
             {
@@ -406,23 +443,17 @@ private:
 
     std::string getKeySharedByAllEntities(const std::string& key) const
     {
-        // Get the key value of the first remaining entity
-        auto firstEntity = _keyValuesByEntity.begin();
-        auto firstKey = firstEntity->second.find(key);
-
-        // For comparison it's enough to fall back to an empty value if the key is not present
-        auto remainingValue = firstKey != firstEntity->second.end() ? firstKey->second : "";
+        auto keyValueSet = _entitiesByKey.find(key);
 
-        // Skip beyond the first entity and check the rest for uniqueness
-        // std::all_of will still return true if the range is empty
-        bool valueIsUnique = std::all_of(++firstEntity, _keyValuesByEntity.end(),
-            [&](const KeyValuesByEntity::value_type& pair)
+        // The key must be present on all entities, using a single value
+        if (keyValueSet == _entitiesByKey.end() ||
+            keyValueSet->second.entities.size() != _keyValuesByEntity.size() ||
+            keyValueSet->second.valueCounts.size() != 1)
         {
-            auto existingKey = pair.second.find(key);
-            return existingKey != pair.second.end() && existingKey->second == remainingValue;
-        });
+            return {};
+        }
 
-        return valueIsUnique ? remainingValue : "";
+        return keyValueSet->second.valueCounts.begin()->first;
     }
 
     void checkKeyValueSetAfterRemoval(const std::string& key, KeyValueSet& keyValueSet)
@@ -28,6 +28,11 @@ public:
         _view(view)
     {}
 
+    std::shared_ptr<SelectionTest> clone() const override
+    {
+        return std::make_shared<SelectionVolume>(*this);
+    }
+
     const VolumeTest& getVolume() const override
     {
         return _view;
@@ -41,82 +41,3 @@ inline const std::string& texdef_name_default()
 	static std::string _default = game::current::getValue<std::string>("/defaults/defaultTexture", "_default");
 	return _default;
 }
-
-namespace scene
-{
-
-/**
- * greebo: This replaces the shader of the visited face/patch with <replace>
- * if the face is textured with <find> and increases the given <counter>.
- */
-class ShaderReplacer
-{
-private:
-	const std::string _find;
-	const std::string _replace;
-	int _counter;
-
-public:
-	ShaderReplacer(const std::string& find, const std::string& replace) :
-		_find(find),
-		_replace(replace),
-		_counter(0)
-	{}
-
-	int getReplacedCount() const
-	{
-		return _counter;
-	}
-
-	void operator()(IFace& face)
-	{
-		if (face.getShader() == _find)
-		{
-			face.setShader(_replace);
-			_counter++;
-		}
-	}
-
-	void operator()(IPatch& patch)
-	{
-		if (patch.getShader() == _find)
-		{
-			patch.setShader(_replace);
-			_counter++;
-		}
-	}
-
-	void operator()(const IPatchNodePtr& node)
-	{
-		(*this)(node->getPatch());
-	}
-};
-
-inline int findAndReplaceShader(const std::string& find, const std::string& replace, bool selectedOnly)
-{
-	std::string command("textureFindReplace");
-	command += "-find " + find + " -replace " + replace;
-	UndoableCommand undo(command);
-
-	// Construct a visitor class
-	ShaderReplacer replacer(find, replace);
-
-	if (selectedOnly)
-	{
-		if (GlobalSelectionSystem().getSelectionMode() != selection::SelectionMode::Component)
-		{
-			// Find & replace all the brush and patch shaders
-			GlobalSelectionSystem().foreachFace(std::ref(replacer));
-			GlobalSelectionSystem().foreachPatch(std::ref(replacer));
-		}
-	}
-	else
-	{
-		scene::foreachVisibleFace(std::ref(replacer));
-		scene::foreachVisiblePatch(std::ref(replacer));
-	}
-
-	return replacer.getReplacedCount();
-}
-
-}
@@ -3,6 +3,7 @@
 #include <memory>
 #include <string>
 #include <fstream>
+#include <sstream>
 #include "os/path.h"
 #include "itextstream.h"
 #include "iarchive.h"
@@ -34,6 +35,9 @@ public:
 
     // Factory method which will return a stream reference of the given ArchiveTextFile
     static Ptr OpenFromArchiveFile(const ArchiveTextFilePtr& archive);
+
+    // Factory method returning a stream on file contents that have been read before
+    static Ptr OpenFromContents(const std::string& contents);
 };
 
 namespace detail
@@ -129,6 +133,29 @@ public:
     }
 };
 
+// Stream implementation on file contents that are already in memory
+class BufferedMapResourceStream :
+    public MapResourceStream
+{
+private:
+    std::stringstream _contentStream;
+
+public:
+    BufferedMapResourceStream(const std::string& contents) :
+        _contentStream(contents)
+    {}
+
+    bool isOpen() const override
+    {
+        return true;
+    }
+
+    std::istream& getStream() override
+    {
+        return _contentStream;
+    }
+};
+
 }
 
 inline MapResourceStream::Ptr MapResourceStream::OpenFromPath(const std::string& path)
@@ -149,4 +176,9 @@ inline MapResourceStream::Ptr MapResourceStream::OpenFromArchiveFile(const Archi
     return std::make_shared<detail::ArchivedMapResourceStream>(archive);
 }
 
+inline MapResourceStream::Ptr MapResourceStream::OpenFromContents(const std::string& contents)
+{
+    return std::make_shared<detail::BufferedMapResourceStream>(contents);
+}
+
 }
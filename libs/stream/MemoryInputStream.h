@@ -0,0 +1,74 @@
+#pragma once
+
+#include "idatastream.h"
+#include <algorithm>
+#include <cstring>
+
+namespace stream
+{
+
+/**
+ * A seekable InputStream reading from a block of memory owned by someone else.
+ * In contrast to the PointerInputStream, reads are limited to the given length.
+ * Seeking is clamped to the boundaries of the memory block.
+ */
+class MemoryInputStream :
+    public SeekableInputStream
+{
+private:
+    const byte_type* _begin;
+    const byte_type* _curPos;
+    const byte_type* _end;
+
+public:
+    MemoryInputStream(const byte_type* data, size_type length) :
+        _begin(data),
+        _curPos(data),
+        _end(data + length)
+    {}
+
+    size_type read(byte_type* buffer, size_type length) override
+    {
+        auto count = std::min(static_cast<size_type>(_end - _curPos), length);
+
+        std::memcpy(buffer, _curPos, count);
+        _curPos += count;
+
+        return count;
+    }
+
+    position_type seek(position_type position) override
+    {
+        _curPos = _begin + std::min(position, static_cast<position_type>(_end - _begin));
+        return tell();
+    }
+
+    position_type seek(offset_type offset, seekdir direction) override
+    {
+        const byte_type* origin = direction == beg ? _begin : direction == end ? _end : _curPos;
+
+        auto newOffset = (origin - _begin) + offset;
+        newOffset = std::max<decltype(newOffset)>(0, std::min<decltype(newOffset)>(newOffset, _end - _begin));
+
+        _curPos = _begin + newOffset;
+        return tell();
+    }
+
+    position_type tell() const override
+    {
+        return static_cast<position_type>(_curPos - _begin);
+    }
+
+    // The bytes which have not been read yet
+    const byte_type* get() const
+    {
+        return _curPos;
+    }
+
+    size_type remaining() const
+    {
+        return static_cast<size_type>(_end - _curPos);
+    }
+};
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+
+namespace string
+{
+
+/**
+ * Immutable string value referring to a single shared copy of its contents.
+ * All interned strings of equal contents point to the same pooled std::string,
+ * such that copying them is a pointer copy and equality checks are pointer
+ * compares. Meant for the large number of duplicate values in a map, like
+ * the material names on faces or the spawnarg keys of the entities.
+ *
+ * The pool never shrinks, pooled strings stay alive until the process exits.
+ * The number of distinct strings is small compared to the number of uses.
+ * Interning is thread-safe.
+ */
+class InternedString
+{
+private:
+    const std::string* _value;
+
+public:
+    InternedString() :
+        _value(&getEmptyString())
+    {}
+
+    InternedString(const std::string& value) :
+        _value(value.empty() ? &getEmptyString() : &intern(value))
+    {}
+
+    InternedString(const char* value) :
+        InternedString(std::string(value))
+    {}
+
+    const std::string& get() const
+    {
+        return *_value;
+    }
+
+    operator const std::string&() const
+    {
+        return *_value;
+    }
+
+    const char* c_str() const
+    {
+        return _value->c_str();
+    }
+
+    bool empty() const
+    {
+        return _value->empty();
+    }
+
+    std::size_t size() const
+    {
+        return _value->size();
+    }
+
+    bool operator==(const InternedString& other) const
+    {
+        return _value == other._value;
+    }
+
+    bool operator!=(const InternedString& other) const
+    {
+        return _value != other._value;
+    }
+
+    // Comparing to a regular string compares the contents, without interning the other string
+    bool operator==(const std::string& other) const
+    {
+        return *_value == other;
+    }
+
+    bool operator!=(const std::string& other) const
+    {
+        return *_value != other;
+    }
+
+    bool operator==(const char* other) const
+    {
+        return *_value == other;
+    }
+
+    bool operator!=(const char* other) const
+    {
+        return *_value != other;
+    }
+
+    // Returns the number of distinct strings in the pool
+    static std::size_t getPoolSize()
+    {
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.lock);
+
+        return pool.strings.size();
+    }
+
+private:
+    struct Pool
+    {
+        std::mutex lock;
+
+        // Elements of an unordered_set are never moved, the pointers stay valid
+        std::unordered_set<std::string> strings;
+    };
+
+    static Pool& getPool()
+    {
+        // The pool is deliberately leaked, strings might be released during static destruction
+        static auto* pool = new Pool;
+        return *pool;
+    }
+
+    static const std::string& getEmptyString()
+    {
+        static const std::string empty;
+        return empty;
+    }
+
+    static const std::string& intern(const std::string& value)
+    {
+        auto& pool = getPool();
+        std::lock_guard<std::mutex> lock(pool.lock);
+
+        return *pool.strings.insert(value).first;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const InternedString& value)
+{
+    return stream << value.get();
+}
+
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace string
+{
+
+/**
+ * Substring search over a fixed set of strings. Every string is split into
+ * its three-character sequences, for each of them the index stores the
+ * strings containing it. A search only needs to look at the strings sharing
+ * all trigrams with the needle, instead of comparing every single string.
+ *
+ * The search is case-sensitive, add lowercase strings for case-insensitive
+ * lookups. Needles shorter than three characters are compared against all
+ * strings.
+ */
+class TrigramIndex
+{
+private:
+    std::vector<std::string> _strings;
+
+    // Sorted string indices for each trigram
+    std::unordered_map<std::uint32_t, std::vector<std::size_t>> _trigrams;
+
+public:
+    // Adds a string to the index, returns the index used to report matches
+    std::size_t add(const std::string& str)
+    {
+        auto index = _strings.size();
+        _strings.push_back(str);
+
+        for (std::size_t i = 0; i + 3 <= str.size(); ++i)
+        {
+            auto& strings = _trigrams[getTrigram(str, i)];
+
+            // Trigrams repeating within the string are listed once
+            if (strings.empty() || strings.back() != index)
+            {
+                strings.push_back(index);
+            }
+        }
+
+        return index;
+    }
+
+    std::size_t size() const
+    {
+        return _strings.size();
+    }
+
+    const std::string& get(std::size_t index) const
+    {
+        return _strings[index];
+    }
+
+    // Returns the sorted indices of all strings containing the needle
+    std::vector<std::size_t> findMatches(const std::string& needle) const
+    {
+        std::vector<std::size_t> matches;
+
+        if (needle.size() < 3)
+        {
+            for (std::size_t i = 0; i < _strings.size(); ++i)
+            {
+                if (_strings[i].find(needle) != std::string::npos)
+                {
+                    matches.push_back(i);
+                }
+            }
+
+            return matches;
+        }
+
+        // Start with the rarest trigram, this keeps the intersections small
+        std::vector<const std::vector<std::size_t>*> candidateLists;
+
+        for (std::size_t i = 0; i + 3 <= needle.size(); ++i)
+        {
+            auto found = _trigrams.find(getTrigram(needle, i));
+
+            if (found == _trigrams.end()) return matches;
+
+            candidateLists.push_back(&found->second);
+        }
+
+        std::sort(candidateLists.begin(), candidateLists.end(), [](const auto* a, const auto* b)
+        {
+            return a->size() < b->size();
+        });
+
+        std::vector<std::size_t> candidates = *candidateLists.front();
+        std::vector<std::size_t> intersection;
+
+        for (std::size_t i = 1; i < candidateLists.size() && !candidates.empty(); ++i)
+        {
+            intersection.clear();
+            std::set_intersection(candidates.begin(), candidates.end(),
+                candidateLists[i]->begin(), candidateLists[i]->end(), std::back_inserter(intersection));
+            candidates.swap(intersection);
+        }
+
+        // Sharing all trigrams doesn't mean they're in the right order
+        for (auto index : candidates)
+        {
+            if (_strings[index].find(needle) != std::string::npos)
+            {
+                matches.push_back(index);
+            }
+        }
+
+        return matches;
+    }
+
+private:
+    static std::uint32_t getTrigram(const std::string& str, std::size_t offset)
+    {
+        return static_cast<std::uint32_t>(static_cast<unsigned char>(str[offset])) << 16 |
+            static_cast<std::uint32_t>(static_cast<unsigned char>(str[offset + 1])) << 8 |
+            static_cast<std::uint32_t>(static_cast<unsigned char>(str[offset + 2]));
+    }
+};
+
+}
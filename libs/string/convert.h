@@ -3,7 +3,10 @@
 #include "math/Vector3.h"
 #include "math/Vector4.h"
 #include <sstream>
+#include <string_view>
 #include <cstdlib>
+#include <charconv>
+#include <system_error>
 
 namespace string
 {
@@ -216,32 +219,70 @@ inline std::string convert<std::string, std::string>(const std::string& str, std
 	return str;
 }
 
-#ifdef SPECIALISE_STR_TO_FLOAT
+template<typename Src> float to_float(const Src& src)
+{
+    return convert<float>(src, 0.0f);
+}
+
+inline float to_float(std::string_view src)
+{
+    return convert<float>(std::string(src), 0.0f);
+}
+
 /**
- * \brief
- * Convert a string to a float.
- *
- * If the SPECIALISE_STR_TO_FLOAT macro is defined, this will use the atof() C
- * function instead of convert<float>() which may provide a speed benefit.
- *
- * \internal
- * This is a separate function rather than an actual specialisation of
- * convert<>() for two reasons: (1) I could not get the specialisation to work
- * (i.e. be chosen by the compiler), and (2) since when using atof() there is no
- * reliable way to use the fallback value, the default value argument would be
- * ignored and hence the user-visible function behaviour would change in the
- * specialised version, which is a bad thing.
+ * Converts the number at the beginning of the given string to a double, without
+ * any allocations and independently of the current locale, like the C++ standard
+ * library stream conversions or std::atof would depend on it. Returns the fallback
+ * value if the string is not starting with a number.
+ * This is meant for the hot paths of the parsers, dealing with millions of numbers.
  */
-template<typename Src> double to_float(const Src& str)
+inline double parseDouble(std::string_view str, double defaultVal = 0.0)
 {
-    return std::atof(str.c_str());
+    // from_chars doesn't accept a leading plus sign, unlike the C functions
+    if (!str.empty() && str.front() == '+')
+    {
+        str.remove_prefix(1);
+    }
+
+#if defined(__cpp_lib_to_chars)
+    double value;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    if (result.ec == std::errc())
+    {
+        return value;
+    }
+
+    if (result.ec != std::errc::result_out_of_range)
+    {
+        return defaultVal;
+    }
+#endif
+
+    // Let strtod deal with overflowing and denormal values, it needs a terminated string
+    std::string terminated(str);
+
+    char* lastChar;
+    auto converted = std::strtod(terminated.c_str(), &lastChar);
+
+    return lastChar != terminated.c_str() ? converted : defaultVal;
 }
-#else
-template<typename Src> float to_float(const Src& src)
+
+// Integer variant of parseDouble(), returning the fallback value
+// if the string is not starting with a number in range of T
+template<typename T>
+inline T parseInteger(std::string_view str, T defaultVal = T())
 {
-    return convert<float>(src, 0.0f);
+    if (!str.empty() && str.front() == '+')
+    {
+        str.remove_prefix(1);
+    }
+
+    T value;
+    auto result = std::from_chars(str.data(), str.data() + str.size(), value);
+
+    return result.ec == std::errc() ? value : defaultVal;
 }
-#endif
 
 // Attempts to convert the given source string to a float value,
 // returning true on success. The value reference will then be holding
@@ -3,7 +3,10 @@
 /// \file
 /// C-style null-terminated-character-array string library.
 
+#include <cctype>
 #include <cstring>
+#include <string>
+#include <string_view>
 
 namespace string
 {
@@ -34,6 +37,43 @@ struct ILess
     }
 };
 
+/// Case-insensitive hash functor, to be used together with IEqual in unordered containers
+struct IHash
+{
+    std::size_t operator() (std::string_view value) const
+    {
+        // FNV-1a on the lowercase characters
+        std::size_t hash = 14695981039346656037ull;
+
+        for (auto c : value)
+        {
+            hash ^= static_cast<std::size_t>(std::tolower(static_cast<unsigned char>(c)));
+            hash *= 1099511628211ull;
+        }
+
+        return hash;
+    }
+};
+
+/// Case-insensitive equality functor for use with unordered containers
+struct IEqual
+{
+    bool operator() (std::string_view lhs, std::string_view rhs) const
+    {
+        if (lhs.size() != rhs.size()) return false;
+
+        for (std::size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (std::tolower(static_cast<unsigned char>(lhs[i])) != std::tolower(static_cast<unsigned char>(rhs[i])))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+};
+
 }
 
 /// \brief Returns true if [\p string, \p string + \p n) is lexicographically equal to [\p other, \p other + \p n).
@@ -5,6 +5,7 @@
 
 #include "itextstream.h"
 #include "StopWatch.h"
+#include "TraceRecorder.h"
 
 namespace util
 {
@@ -14,10 +15,12 @@ class ScopeTimer
 private:
     StopWatch _timer;
     std::string _message;
+    ScopedTraceEvent _traceEvent;
 
 public:
     ScopeTimer(const std::string& message) :
-        _message(message)
+        _message(message),
+        _traceEvent("timer", message)
     {}
 
     ~ScopeTimer()
@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+
+namespace util
+{
+
+/**
+ * Collects timed events of any thread, to be exported in the trace_event
+ * JSON format understood by Chrome's about:tracing and Perfetto.
+ *
+ * The recorder is disabled by default, the ScopedTraceEvent instances
+ * are not doing anything but checking the enabled flag in this case.
+ * It is recording while enabled for export, or while a capture of a short
+ * time span (like a rendered frame) is running.
+ * There is one recorder per application, owned by the ModuleRegistry.
+ * Each binary is referencing it through GlobalTraceRecorderPtr().
+ */
+class TraceRecorder
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Event
+    {
+        std::string name;
+        std::string category;
+        std::int64_t startMicroseconds;
+        std::int64_t durationMicroseconds;
+        std::size_t threadIndex;
+    };
+
+private:
+    std::atomic<bool> _enabled;
+    Clock::time_point _origin;
+
+    mutable std::mutex _lock;
+    std::vector<Event> _events;
+
+    // Set by enable(), the events are kept for export
+    bool _keepEvents;
+
+    // The number of running captures
+    std::size_t _numCaptures;
+
+    // Small sequential numbers for the threads, the first one is the one enabling the recorder
+    std::map<std::thread::id, std::size_t> _threadIndices;
+
+public:
+    TraceRecorder() :
+        _enabled(false),
+        _origin(Clock::now()),
+        _keepEvents(false),
+        _numCaptures(0)
+    {}
+
+    bool isEnabled() const
+    {
+        return _enabled.load(std::memory_order_relaxed);
+    }
+
+    // Starts recording, the timestamps of the events are relative to this call
+    void enable()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _origin = Clock::now();
+        _threadIndices.emplace(std::this_thread::get_id(), _threadIndices.size());
+        _keepEvents = true;
+        _enabled.store(true);
+    }
+
+    // Stops recording for export, running captures are continuing
+    void disable()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _keepEvents = false;
+        _enabled.store(_numCaptures > 0);
+    }
+
+    // True if the recorder has been enabled for export
+    bool isRecordingForExport() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _keepEvents;
+    }
+
+    // Starts recording the events of all threads until the matching endCapture() call.
+    // Returns the marker to pass to endCapture(). Captures can be nested.
+    std::size_t beginCapture()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        ++_numCaptures;
+        _enabled.store(true);
+
+        return _events.size();
+    }
+
+    // Returns the events added since beginCapture() returned the given marker.
+    // These events are discarded, unless the recorder has been enabled for export.
+    std::vector<Event> endCapture(std::size_t marker)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        marker = std::min(marker, _events.size());
+        std::vector<Event> captured(_events.begin() + marker, _events.end());
+
+        if (!_keepEvents)
+        {
+            _events.erase(_events.begin() + marker, _events.end());
+        }
+
+        if (_numCaptures > 0 && --_numCaptures == 0)
+        {
+            _enabled.store(_keepEvents);
+        }
+
+        return captured;
+    }
+
+    // Adds an event which took place on the calling thread
+    void addEvent(std::string name, std::string category, Clock::time_point start, Clock::time_point end)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Events ending after the capture they started in are of no interest
+        if (!_keepEvents && _numCaptures == 0) return;
+
+        auto threadIndex = _threadIndices.emplace(std::this_thread::get_id(), _threadIndices.size()).first->second;
+
+        _events.push_back(Event
+        {
+            std::move(name),
+            std::move(category),
+            std::chrono::duration_cast<std::chrono::microseconds>(start - _origin).count(),
+            std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(),
+            threadIndex
+        });
+    }
+
+    std::vector<Event> getEvents() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _events;
+    }
+
+    // Writes the recorded events as JSON object to the given stream.
+    // Nested scopes result in complete events enclosing each other on the same thread,
+    // which is how the trace viewers are stacking them.
+    void writeChromeTrace(std::ostream& stream) const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        bool first = true;
+
+        for (const auto& [id, index] : _threadIndices)
+        {
+            stream << (first ? "\n" : ",\n");
+            first = false;
+
+            stream << fmt::format(R"({{"name":"thread_name","ph":"M","pid":1,"tid":{0},"args":{{"name":"{1}"}}}})",
+                index, index == 0 ? "Main thread" : fmt::format("Thread {0}", index));
+        }
+
+        for (const auto& event : _events)
+        {
+            stream << (first ? "\n" : ",\n");
+            first = false;
+
+            stream << fmt::format(R"({{"name":"{0}","cat":"{1}","ph":"X","ts":{2},"dur":{3},"pid":1,"tid":{4}}})",
+                EscapeJson(event.name), EscapeJson(event.category), event.startMicroseconds,
+                event.durationMicroseconds, event.threadIndex);
+        }
+
+        stream << "\n]}\n";
+    }
+
+    static std::string EscapeJson(const std::string& input)
+    {
+        std::string result;
+        result.reserve(input.size());
+
+        for (auto c : input)
+        {
+            switch (c)
+            {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            case '\n': result += "\\n"; break;
+            case '\t': result += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    result += fmt::format("\\u{0:04x}", static_cast<int>(c));
+                }
+                else
+                {
+                    result += c;
+                }
+            }
+        }
+
+        return result;
+    }
+};
+
+// Each module binary has its own copy of this pointer, it's initialised in
+// module::performDefaultInitialisation() and stays empty if there's no registry.
+inline TraceRecorder*& GlobalTraceRecorderPtr()
+{
+    static TraceRecorder* _recorder = nullptr;
+    return _recorder;
+}
+
+/**
+ * Records the lifetime of this object as event in the application's trace
+ * recorder. Costs the check of a flag only, unless tracing is enabled.
+ */
+class ScopedTraceEvent
+{
+private:
+    TraceRecorder* _recorder;
+    const char* _category;
+    std::string _name;
+    TraceRecorder::Clock::time_point _start;
+
+public:
+    ScopedTraceEvent(const char* category, std::string_view name) :
+        _recorder(GlobalTraceRecorderPtr()),
+        _category(category)
+    {
+        if (_recorder == nullptr || !_recorder->isEnabled())
+        {
+            _recorder = nullptr;
+            return;
+        }
+
+        _name.assign(name.data(), name.size());
+        _start = TraceRecorder::Clock::now();
+    }
+
+    ScopedTraceEvent(const ScopedTraceEvent& other) = delete;
+    ScopedTraceEvent& operator=(const ScopedTraceEvent& other) = delete;
+
+    ~ScopedTraceEvent()
+    {
+        if (_recorder != nullptr)
+        {
+            _recorder->addEvent(std::move(_name), _category, _start, TraceRecorder::Clock::now());
+        }
+    }
+};
+
+}
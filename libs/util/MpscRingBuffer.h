@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace util
+{
+
+/**
+ * Bounded queue accepting elements from any number of producer threads,
+ * which are consumed by a single thread. Neither side is taking a lock:
+ * each slot carries a sequence number telling whether it is ready to be
+ * written or read in the current lap around the ring.
+ *
+ * The capacity must be a power of two. tryPush() fails if the ring is full,
+ * it's up to the producer to retry or to drop the element.
+ */
+template<typename T>
+class MpscRingBuffer
+{
+private:
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+
+    // Producers and consumer are touching different cache lines
+    alignas(64) std::atomic<std::size_t> _pushPosition;
+    alignas(64) std::size_t _popPosition;
+
+public:
+    MpscRingBuffer(std::size_t capacity) :
+        _mask(capacity - 1),
+        _slots(new Slot[capacity]),
+        _pushPosition(0),
+        _popPosition(0)
+    {
+        assert(capacity > 0 && (capacity & _mask) == 0);
+
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingBuffer(const MpscRingBuffer& other) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer& other) = delete;
+
+    std::size_t getCapacity() const
+    {
+        return _mask + 1;
+    }
+
+    // Can be called by any thread, returns false if the ring is full
+    bool tryPush(T&& value)
+    {
+        auto position = _pushPosition.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            auto& slot = _slots[position & _mask];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+
+            if (difference == 0)
+            {
+                // The slot is free in this lap, try to claim it
+                if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::move(value);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                // The consumer didn't release this slot yet
+                return false;
+            }
+            else
+            {
+                // Another producer claimed this slot
+                position = _pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Must only be called by the consumer thread, returns false if the ring is empty
+    bool tryPop(T& value)
+    {
+        auto& slot = _slots[_popPosition & _mask];
+
+        if (slot.sequence.load(std::memory_order_acquire) != _popPosition + 1)
+        {
+            return false;
+        }
+
+        value = std::move(slot.value);
+        slot.value = T();
+
+        // Hand the slot back to the producers for the next lap
+        slot.sequence.store(_popPosition + _mask + 1, std::memory_order_release);
+        ++_popPosition;
+
+        return true;
+    }
+
+    // True if there's nothing to pop, only meaningful on the consumer thread
+    bool empty() const
+    {
+        return _slots[_popPosition & _mask].sequence.load(std::memory_order_acquire) != _popPosition + 1;
+    }
+};
+
+}
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <functional>
+
+namespace util
+{
+
+/**
+ * A pool handing out memory blocks of a fixed size. The blocks are carved
+ * out of larger chunks, released blocks are kept in a free list and handed
+ * out again by the next allocation. Objects of the same size therefore end up
+ * close to each other, without any per-allocation overhead of the heap.
+ *
+ * Chunks are never returned to the system, the pool is retaining its peak
+ * size until the process exits. Pools are shared by all types of the same
+ * size and live until the end of the process, such that objects destroyed
+ * during static destruction can still release their blocks.
+ *
+ * All methods are thread-safe.
+ */
+class BlockPool
+{
+public:
+    struct Statistics
+    {
+        std::size_t blockSize;
+        std::size_t blocksInUse;
+        std::size_t blocksReserved;
+    };
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    std::size_t _blockSize;
+    std::size_t _blocksPerChunk;
+
+    std::vector<std::unique_ptr<std::max_align_t[]>> _chunks;
+
+    FreeBlock* _freeList;
+    std::size_t _blocksInUse;
+
+    mutable std::mutex _lock;
+
+public:
+    BlockPool(std::size_t blockSize) :
+        _blockSize(getAlignedSize(blockSize)),
+        // Aim for chunks of 64 KB, but take at least 16 blocks at a time
+        _blocksPerChunk(std::max<std::size_t>(16, 65536 / _blockSize)),
+        _freeList(nullptr),
+        _blocksInUse(0)
+    {}
+
+    BlockPool(const BlockPool& other) = delete;
+    BlockPool& operator=(const BlockPool& other) = delete;
+
+    void* allocate()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (_freeList == nullptr)
+        {
+            allocateChunk();
+        }
+
+        auto block = _freeList;
+        _freeList = block->next;
+        ++_blocksInUse;
+
+        return block;
+    }
+
+    void deallocate(void* pointer)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto block = static_cast<FreeBlock*>(pointer);
+        block->next = _freeList;
+        _freeList = block;
+        --_blocksInUse;
+    }
+
+    Statistics getStatistics() const
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        return Statistics{ _blockSize, _blocksInUse, _chunks.size() * _blocksPerChunk };
+    }
+
+    // Returns the pool for blocks of the given size
+    static BlockPool& getPool(std::size_t blockSize)
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.lock);
+
+        auto& pool = registry.pools[getAlignedSize(blockSize)];
+
+        if (!pool)
+        {
+            pool = new BlockPool(blockSize);
+        }
+
+        return *pool;
+    }
+
+    // Invokes the given functor with the statistics of every pool, ordered by block size
+    static void foreachPool(const std::function<void(const Statistics&)>& functor)
+    {
+        std::vector<Statistics> statistics;
+
+        {
+            auto& registry = getRegistry();
+            std::lock_guard<std::mutex> lock(registry.lock);
+
+            for (const auto& [size, pool] : registry.pools)
+            {
+                statistics.push_back(pool->getStatistics());
+            }
+        }
+
+        for (const auto& entry : statistics)
+        {
+            functor(entry);
+        }
+    }
+
+private:
+    struct Registry
+    {
+        std::mutex lock;
+
+        // The pools are deliberately leaked, see the class description
+        std::map<std::size_t, BlockPool*> pools;
+    };
+
+    static Registry& getRegistry()
+    {
+        static auto* registry = new Registry;
+        return *registry;
+    }
+
+    // Block sizes are rounded up, such that every block is suitably aligned
+    static std::size_t getAlignedSize(std::size_t size)
+    {
+        constexpr auto alignment = alignof(std::max_align_t);
+        return std::max((size + alignment - 1) / alignment * alignment, sizeof(std::max_align_t));
+    }
+
+    void allocateChunk()
+    {
+        auto elementsPerBlock = _blockSize / sizeof(std::max_align_t);
+
+        _chunks.emplace_back(new std::max_align_t[elementsPerBlock * _blocksPerChunk]);
+        auto chunk = _chunks.back().get();
+
+        // Link the new blocks into the free list, the first block ending up on top
+        for (auto i = _blocksPerChunk; i-- > 0;)
+        {
+            auto block = reinterpret_cast<FreeBlock*>(chunk + i * elementsPerBlock);
+            block->next = _freeList;
+            _freeList = block;
+        }
+    }
+};
+
+/**
+ * Standard allocator taking single objects from the BlockPool matching their size.
+ * Can be used with node-based containers like std::list or with std::allocate_shared,
+ * which are allocating one object at a time. Arrays are allocated from the heap.
+ */
+template<typename T>
+class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned types are not supported");
+
+    PoolAllocator() noexcept
+    {}
+
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+    {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n != 1)
+        {
+            return std::allocator<T>().allocate(n);
+        }
+
+        return static_cast<T*>(getPool().allocate());
+    }
+
+    void deallocate(T* pointer, std::size_t n) noexcept
+    {
+        if (n != 1)
+        {
+            std::allocator<T>().deallocate(pointer, n);
+            return;
+        }
+
+        getPool().deallocate(pointer);
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept
+    {
+        return true;
+    }
+
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static BlockPool& getPool()
+    {
+        static BlockPool& pool = BlockPool::getPool(sizeof(T));
+        return pool;
+    }
+};
+
+}
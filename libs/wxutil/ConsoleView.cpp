@@ -1,7 +1,6 @@
 #include "ConsoleView.h"
 
 #include "imodule.h"
-#include "iradiant.h"
 #include "string/replace.h"
 
 namespace wxutil
@@ -18,8 +17,10 @@ ConsoleView::ConsoleView(wxWindow* parent) :
 
 void ConsoleView::appendText(const std::string& text, TextMode mode)
 {
-	// The text usually arrives in single characters at a time
+	// The text arrives on the log writer thread, piece by piece.
 	// Directly writing to the wxTextCtrl is awfully slow, so let's do some buffering
+	// and insert everything that arrived in between two idle events at once
+	std::lock_guard<std::mutex> lock(_lineBufferMutex);
 
 	// In case the textmode changes, we need to flush the line
 	if (_bufferMode != mode)
@@ -31,8 +32,8 @@ void ConsoleView::appendText(const std::string& text, TextMode mode)
 	_bufferMode = mode;
 	_buffer.append(text);
 
-	// Once we hit a single newline, flush the line
-	if (text == "\n")
+	// Once we hit a newline, flush the line
+	if (!text.empty() && text.back() == '\n')
 	{
         flushLine();
 	}
@@ -45,8 +46,6 @@ void ConsoleView::flushLine()
 {
     if (!_buffer.empty())
     {
-        std::lock_guard<std::mutex> lock(_lineBufferMutex);
-
         // If the mode didn't change, put it on the pile
         if (!_lineBuffer.empty() && _lineBuffer.back().first == _bufferMode)
         {
@@ -63,17 +62,20 @@ void ConsoleView::flushLine()
 
 void ConsoleView::onIdle()
 {
-    // Idle events occur in the main thread - prevent interrupting
-    // threads in the middle of a line
-    std::lock_guard<std::mutex> idleLock(GlobalRadiantCore().getLogWriter().getStreamLock());
+    LineBuffer lines;
 
-    flushLine();
+    {
+        // Don't block the log writer while inserting the text
+        std::lock_guard<std::mutex> lock(_lineBufferMutex);
 
-    std::lock_guard<std::mutex> lock(_lineBufferMutex);
+        flushLine();
+        lines.swap(_lineBuffer);
+        _lineBuffer.reserve(512);
+    }
 
-	if (_lineBuffer.empty()) return;
+	if (lines.empty()) return;
 
-    for (LineBuffer::value_type& pair : _lineBuffer)
+    for (LineBuffer::value_type& pair : lines)
     {
         switch (pair.first)
         {
@@ -97,8 +99,6 @@ void ConsoleView::onIdle()
         AppendText(pair.second);
     }
 
-    _lineBuffer.clear();
-
     // Scroll to bottom
 	ShowPosition(GetLastPosition());
 }
@@ -36,6 +36,7 @@ private:
     typedef std::vector<std::pair<TextMode, std::string> > LineBuffer;
     LineBuffer _lineBuffer;
 
+    // Guards the buffers above, appendText() is called by the log writer thread
     std::mutex _lineBufferMutex;
 
 public:
@@ -46,6 +47,8 @@ public:
 
 protected:
 	void onIdle();
+
+    // Moves the buffered text to the line buffer, expects the mutex to be held
     void flushLine();
 };
 
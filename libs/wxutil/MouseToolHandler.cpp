@@ -8,11 +8,15 @@ namespace wxutil
 {
 
 MouseToolHandler::MouseToolHandler(ui::IMouseToolGroup::Type type) :
-    _type(type)
+    _type(type),
+    _deferredMotion(*this)
 {}
 
 void MouseToolHandler::onGLMouseButtonPress(wxMouseEvent& ev)
 {
+    // The tools need to be at the current position before handling the click
+    sendPendingMotion();
+
     // Filter out the button that was triggering this event
     unsigned int state = wxutil::MouseButton::GetButtonStateChangeForMouseEvent(ev);
 
@@ -113,61 +117,82 @@ void MouseToolHandler::onGLMouseMove(wxMouseEvent& ev)
         }
     }
     
-    Vector2 position(ev.GetX(), ev.GetY());
-
     sendMoveEventToInactiveTools(ev.GetX(), ev.GetY());
+    sendMoveEventToActiveTools(ev.GetX(), ev.GetY());
+}
+
+void MouseToolHandler::onGLCapturedMouseMove(int x, int y, unsigned int mouseState)
+{
+    sendMoveEventToInactiveTools(x, y);
+    sendMoveEventToActiveTools(x, y);
+}
 
+void MouseToolHandler::sendMoveEventToActiveTools(int x, int y)
+{
     // Pass the move event to all active tools and clear the ones that are done
-    for (ActiveMouseTools::const_iterator i = _activeMouseTools.begin();
-         i != _activeMouseTools.end();)
+    for (ActiveMouseTools::const_iterator i = _activeMouseTools.begin(); i != _activeMouseTools.end();)
     {
         ui::MouseToolPtr tool = (i++)->second;
 
-        // Ask the active mousetool to handle this event
-        switch (processMouseMoveEvent(tool, ev.GetX(), ev.GetY()))
+        if (!tool->receivesCoalescedMoveEvents())
         {
-        case ui::MouseTool::Result::Finished:
-            // Tool is done
-            clearActiveMouseTool(tool);
-            handleViewRefresh(tool->getRefreshMode());
-            break;
+            handleMoveEventResult(tool, processMouseMoveEvent(tool, x, y));
+            continue;
+        }
 
-        case ui::MouseTool::Result::Activated:
-        case ui::MouseTool::Result::Continued:
-            handleViewRefresh(tool->getRefreshMode());
-            break;
+        // Collect the motion until the queued events have been processed,
+        // the tool then receives a single event and the view is refreshed once
+        auto& pending = _pendingMotion[tool];
 
-        case ui::MouseTool::Result::Ignored:
-            break;
-        };
+        if (tool->getPointerMode() & ui::MouseTool::PointerMode::MotionDeltas)
+        {
+            pending.x += x;
+            pending.y += y;
+        }
+        else
+        {
+            pending.x = x;
+            pending.y = y;
+        }
+
+        _deferredMotion.request();
     }
 }
 
-void MouseToolHandler::onGLCapturedMouseMove(int x, int y, unsigned int mouseState)
+void MouseToolHandler::sendPendingMotion()
 {
-    sendMoveEventToInactiveTools(x, y);
+    if (_pendingMotion.empty()) return;
 
-    for (ActiveMouseTools::const_iterator i = _activeMouseTools.begin(); i != _activeMouseTools.end();)
+    auto pendingMotion = std::move(_pendingMotion);
+    _pendingMotion.clear();
+
+    for (const auto& [tool, motion] : pendingMotion)
     {
-        ui::MouseToolPtr tool = (i++)->second;
+        // Skip the tools that have been finished in the meantime
+        if (!toolIsActive(tool)) continue;
 
-        switch (processMouseMoveEvent(tool, x, y))
-        {
-        case ui::MouseTool::Result::Finished:
-            // Tool is done
-            clearActiveMouseTool(tool);
-            handleViewRefresh(tool->getRefreshMode());
-            break;
+        handleMoveEventResult(tool, processMouseMoveEvent(tool, motion.x, motion.y));
+    }
+}
 
-        case ui::MouseTool::Result::Activated:
-        case ui::MouseTool::Result::Continued:
-            handleViewRefresh(tool->getRefreshMode());
-            break;
+void MouseToolHandler::handleMoveEventResult(const ui::MouseToolPtr& tool, ui::MouseTool::Result result)
+{
+    switch (result)
+    {
+    case ui::MouseTool::Result::Finished:
+        // Tool is done
+        clearActiveMouseTool(tool);
+        handleViewRefresh(tool->getRefreshMode());
+        break;
 
-        case ui::MouseTool::Result::Ignored:
-            break;
-        };
-    }
+    case ui::MouseTool::Result::Activated:
+    case ui::MouseTool::Result::Continued:
+        handleViewRefresh(tool->getRefreshMode());
+        break;
+
+    case ui::MouseTool::Result::Ignored:
+        break;
+    };
 }
 
 bool MouseToolHandler::toolIsActive(const ui::MouseToolPtr& tool)
@@ -199,6 +224,8 @@ void MouseToolHandler::onGLMouseButtonRelease(wxMouseEvent& ev)
 {
     if (_activeMouseTools.empty()) return;
 
+    sendPendingMotion();
+
     // Determine the button that has been released
     unsigned int state = wxutil::MouseButton::GetButtonStateChangeForMouseEvent(ev) & wxutil::MouseButton::ALL_BUTTON_MASK;
 
@@ -237,6 +264,8 @@ void MouseToolHandler::clearActiveMouseTool(const ui::MouseToolPtr& tool)
 {
     unsigned int previousPointerMode = tool->getPointerMode();
 
+    _pendingMotion.erase(tool);
+
     for (ActiveMouseTools::const_iterator i = _activeMouseTools.begin(); i != _activeMouseTools.end(); ++i)
     {
         if (i->second == tool)
@@ -280,6 +309,7 @@ void MouseToolHandler::clearActiveMouseTools()
 {
     // Reset the escape listener
     _escapeListener.reset();
+    _pendingMotion.clear();
 
     if (_activeMouseTools.empty())
     {
@@ -310,6 +340,8 @@ KeyEventFilter::Result MouseToolHandler::handleEscapeKeyPress()
     // Key will slip through unless one tool reports having it processed
     KeyEventFilter::Result result = KeyEventFilter::Result::KeyIgnored;
 
+    sendPendingMotion();
+
     for (ActiveMouseTools::const_iterator i = _activeMouseTools.begin(); i != _activeMouseTools.end();)
     {
         ui::MouseToolPtr tool = (i++)->second;
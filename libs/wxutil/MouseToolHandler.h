@@ -5,6 +5,7 @@
 #include <map>
 #include <wx/event.h>
 #include "event/KeyEventFilter.h"
+#include "event/SingleIdleCallback.h"
 
 namespace wxutil
 {
@@ -29,6 +30,39 @@ private:
     // During active phases we listen for ESC keys to cancel the operation
     KeyEventFilterPtr _escapeListener;
 
+    // The motion collected for the active tools since the last move event sent to them,
+    // either the most recent position or the summed deltas (PointerMode::MotionDeltas)
+    struct PendingMotion
+    {
+        int x = 0;
+        int y = 0;
+    };
+    std::map<ui::MouseToolPtr, PendingMotion> _pendingMotion;
+
+    // Sends the pending motion once the queued window events have been processed
+    class DeferredMotion :
+        public SingleIdleCallback
+    {
+    private:
+        MouseToolHandler& _owner;
+
+    public:
+        DeferredMotion(MouseToolHandler& owner) :
+            _owner(owner)
+        {}
+
+        void request()
+        {
+            requestIdleCallback();
+        }
+
+    protected:
+        void onIdle() override
+        {
+            _owner.sendPendingMotion();
+        }
+    } _deferredMotion;
+
 public:
     MouseToolHandler(ui::IMouseToolGroup::Type type);
 
@@ -55,6 +89,12 @@ protected:
 
 private:
     void sendMoveEventToInactiveTools(int x, int y);
+    void sendMoveEventToActiveTools(int x, int y);
+
+    // Passes the collected motion to the active tools, to be called before
+    // any other event is sent to them
+    void sendPendingMotion();
+    void handleMoveEventResult(const ui::MouseToolPtr& tool, ui::MouseTool::Result result);
 
     void handleViewRefresh(unsigned int flags);
 
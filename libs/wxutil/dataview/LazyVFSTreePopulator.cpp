@@ -0,0 +1,226 @@
+#include "LazyVFSTreePopulator.h"
+
+#include <algorithm>
+#include "string/case_conv.h"
+
+namespace wxutil
+{
+
+namespace
+{
+    // The character following the slash, paths below a folder "a" are sorted
+    // in the range starting with "a/" and ending before "a0"
+    constexpr char SLASH_SUCCESSOR = '/' + 1;
+
+    template<typename Entry>
+    bool comparePath(const Entry& entry, const std::string& path)
+    {
+        return entry.path < path;
+    }
+}
+
+LazyVFSTreePopulator::LazyVFSTreePopulator(const TreeModel::Column& leafNameColumn,
+                                           const ColumnPopulationCallback& populateRow) :
+    _leafNameColumn(leafNameColumn),
+    _populateRow(populateRow)
+{}
+
+void LazyVFSTreePopulator::setSortFunction(const SortFunction& sortChildren)
+{
+    _sortChildren = sortChildren;
+}
+
+void LazyVFSTreePopulator::setPathLookupFunction(const PathLookupFunction& lookupPath)
+{
+    _lookupPath = lookupPath;
+}
+
+void LazyVFSTreePopulator::addPath(const std::string& path)
+{
+    _entries.emplace_back(Entry{ path, true, false });
+}
+
+void LazyVFSTreePopulator::populate(TreeModel& model, const wxDataViewItem& topLevel)
+{
+    _topLevel = topLevel;
+
+    // Add the intermediate folders of every path
+    auto numPaths = _entries.size();
+
+    for (std::size_t i = 0; i < numPaths; ++i)
+    {
+        auto path = _entries[i].path;
+
+        for (auto slash = path.find('/'); slash != std::string::npos; slash = path.find('/', slash + 1))
+        {
+            _entries.emplace_back(Entry{ path.substr(0, slash), false, false });
+        }
+    }
+
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b)
+    {
+        return a.path < b.path;
+    });
+
+    // Merge the duplicates, a path might be both explicit and the parent of others
+    std::vector<Entry> entries;
+    entries.reserve(_entries.size());
+
+    for (auto& entry : _entries)
+    {
+        if (!entries.empty() && entries.back().path == entry.path)
+        {
+            entries.back().isExplicit |= entry.isExplicit;
+            continue;
+        }
+
+        entries.emplace_back(std::move(entry));
+    }
+
+    _entries.swap(entries);
+
+    for (auto& entry : _entries)
+    {
+        auto childPrefix = entry.path + "/";
+        auto next = std::lower_bound(_entries.begin(), _entries.end(), childPrefix, comparePath<Entry>);
+
+        entry.hasChildren = next != _entries.end() && next->path.compare(0, childPrefix.size(), childPrefix) == 0;
+
+        _leafNames.add(string::to_lower_copy(entry.path.substr(entry.path.rfind('/') + 1)));
+    }
+
+    createChildren(model, _topLevel, std::string());
+}
+
+void LazyVFSTreePopulator::PopulateChildren(TreeModel& model, const wxDataViewItem& item)
+{
+    createChildren(model, item, getPath(model, item));
+}
+
+void LazyVFSTreePopulator::PopulateElement(TreeModel& model, const std::string& value, const TreeModel::Column& column)
+{
+    auto path = _lookupPath ? _lookupPath(value, column) : value;
+
+    if (path.empty()) return;
+
+    std::map<std::string, wxDataViewItem> folderItems;
+    populatePath(model, path, folderItems);
+}
+
+void LazyVFSTreePopulator::PopulateMatches(TreeModel& model, const wxString& lowerText)
+{
+    std::map<std::string, wxDataViewItem> folderItems;
+
+    for (auto index : _leafNames.findMatches(lowerText.ToStdString()))
+    {
+        populatePath(model, _entries[index].path, folderItems);
+    }
+}
+
+void LazyVFSTreePopulator::createChildren(TreeModel& model, const wxDataViewItem& parent, const std::string& parentPath)
+{
+    auto prefix = !parentPath.empty() ? parentPath + "/" : std::string();
+
+    auto begin = std::lower_bound(_entries.begin(), _entries.end(), prefix, comparePath<Entry>);
+    auto end = !parentPath.empty() ?
+        std::lower_bound(begin, _entries.end(), parentPath + SLASH_SUCCESSOR, comparePath<Entry>) : _entries.end();
+
+    for (auto entry = begin; entry != end;)
+    {
+        auto slash = entry->path.find('/', prefix.size());
+
+        if (slash != std::string::npos)
+        {
+            // Skip the paths below this child, they're created when it's expanded
+            entry = std::lower_bound(entry, end, entry->path.substr(0, slash) + SLASH_SUCCESSOR, comparePath<Entry>);
+            continue;
+        }
+
+        auto row = model.AddItemUnderParent(parent);
+
+        _populateRow(model, row, entry->path, entry->path.substr(prefix.size()), !entry->isExplicit);
+
+        if (entry->hasChildren)
+        {
+            model.SetChildrenPending(row.getItem(), shared_from_this());
+        }
+
+        ++entry;
+    }
+
+    if (_sortChildren)
+    {
+        _sortChildren(model, parent);
+    }
+}
+
+int LazyVFSTreePopulator::findEntry(const std::string& path) const
+{
+    auto entry = std::lower_bound(_entries.begin(), _entries.end(), path, comparePath<Entry>);
+
+    return entry != _entries.end() && entry->path == path ? static_cast<int>(entry - _entries.begin()) : -1;
+}
+
+std::string LazyVFSTreePopulator::getPath(TreeModel& model, const wxDataViewItem& item) const
+{
+    std::string path;
+    bool isLeaf = true;
+
+    for (auto current = item; current.IsOk() && current != _topLevel; current = model.GetParent(current))
+    {
+        TreeModel::Row row(current, model);
+        auto leafName = row[_leafNameColumn].getString().ToStdString();
+
+        path = isLeaf ? leafName : leafName + "/" + path;
+        isLeaf = false;
+    }
+
+    return path;
+}
+
+void LazyVFSTreePopulator::populatePath(TreeModel& model, const std::string& path,
+                                        std::map<std::string, wxDataViewItem>& folderItems)
+{
+    auto item = _topLevel;
+
+    for (std::size_t offset = 0; ; )
+    {
+        model.EnsureChildrenPopulated(item);
+
+        // The last path element is among the children now
+        auto slash = path.find('/', offset);
+
+        if (slash == std::string::npos) return;
+
+        auto folderPath = path.substr(0, slash);
+        auto folderItem = folderItems.find(folderPath);
+
+        if (folderItem == folderItems.end())
+        {
+            auto index = findEntry(folderPath);
+
+            // Paths leaving the indexed folders are not created by this populator
+            if (index == -1 || !_entries[index].hasChildren) return;
+
+            auto leafName = folderPath.substr(offset);
+
+            wxDataViewItemArray children;
+            model.GetChildren(item, children);
+
+            auto child = std::find_if(children.begin(), children.end(), [&](const wxDataViewItem& candidate)
+            {
+                TreeModel::Row row(candidate, model);
+                return row[_leafNameColumn].getString().ToStdString() == leafName;
+            });
+
+            if (child == children.end()) return;
+
+            folderItem = folderItems.emplace(folderPath, *child).first;
+        }
+
+        item = folderItem->second;
+        offset = slash + 1;
+    }
+}
+
+} // namespace
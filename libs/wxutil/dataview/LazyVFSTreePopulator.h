@@ -0,0 +1,119 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "TreeModel.h"
+#include "string/TrigramIndex.h"
+
+namespace wxutil
+{
+
+/**
+ * Counterpart of the VFSTreePopulator for large trees: the paths in the form
+ * "models/first/second/object.lwo" are collected and sorted into a prefix
+ * index, but only the top level rows are created by populate(). The rows below
+ * a folder are created when the folder is expanded, see
+ * TreeModel::LazyChildPopulator.
+ *
+ * The leaf names of all paths are stored in a trigram index, such that the
+ * rows leading to the elements matching a filter text can be created without
+ * building the whole tree.
+ *
+ * The populator is kept alive by the TreeModel it's populating, the column
+ * population callback must not refer to objects which are destroyed before
+ * the model, such as the threaded populator creating the model.
+ */
+class LazyVFSTreePopulator :
+    public TreeModel::LazyChildPopulator,
+    public std::enable_shared_from_this<LazyVFSTreePopulator>
+{
+public:
+    using Ptr = std::shared_ptr<LazyVFSTreePopulator>;
+
+    // Column population function, invoked for every created row. isFolder is true
+    // for rows which have not been passed to addPath() but are parents of other paths.
+    // The function is not supposed to send any events.
+    using ColumnPopulationCallback = std::function<void(TreeModel& model,
+                                                        TreeModel::Row& row,
+                                                        const std::string& path,
+                                                        const std::string& leafName,
+                                                        bool isFolder)>;
+
+    // Sorts the children of the given item after they have been created
+    using SortFunction = std::function<void(TreeModel& model, const wxDataViewItem& parent)>;
+
+    // Returns the path of the element having the given value in the given column,
+    // or an empty string if the column is not identifying the elements of this tree
+    using PathLookupFunction = std::function<std::string(const std::string& value,
+                                                         const TreeModel::Column& column)>;
+
+private:
+    struct Entry
+    {
+        std::string path;
+        bool isExplicit;
+        bool hasChildren;
+    };
+
+    TreeModel::Column _leafNameColumn;
+    ColumnPopulationCallback _populateRow;
+    SortFunction _sortChildren;
+    PathLookupFunction _lookupPath;
+
+    // Toplevel node to add children under
+    wxDataViewItem _topLevel;
+
+    // All paths including the intermediate folders, sorted after populate()
+    std::vector<Entry> _entries;
+
+    // Lowercase leaf names, using the same index as _entries
+    string::TrigramIndex _leafNames;
+
+public:
+    /**
+     * Construct a populator creating rows using the given callback. The leaf name
+     * column is used to locate the rows when walking down a path, the callback
+     * must assign the leaf name to it.
+     */
+    LazyVFSTreePopulator(const TreeModel::Column& leafNameColumn, const ColumnPopulationCallback& populateRow);
+
+    // Set the function sorting the lazily created rows, the rows are left in
+    // the order of their paths if there's none
+    void setSortFunction(const SortFunction& sortChildren);
+
+    // Set the function mapping the values passed to TreeModel::FindString() to
+    // paths. Without it, the values of all columns are treated as paths.
+    void setPathLookupFunction(const PathLookupFunction& lookupPath);
+
+    // Add a single VFS path, which is split and inserted at the correct place
+    // when the tree is populated
+    void addPath(const std::string& path);
+
+    // Index the collected paths and create the rows below the given toplevel item,
+    // the folders among them are marked as having pending children.
+    // Can be called from a worker thread as long as the model is not shown yet.
+    void populate(TreeModel& model, const wxDataViewItem& topLevel = wxDataViewItem());
+
+    void PopulateChildren(TreeModel& model, const wxDataViewItem& item) override;
+    void PopulateElement(TreeModel& model, const std::string& value, const TreeModel::Column& column) override;
+    void PopulateMatches(TreeModel& model, const wxString& lowerText) override;
+
+private:
+    // Create the rows of the direct children of the given folder path
+    void createChildren(TreeModel& model, const wxDataViewItem& parent, const std::string& parentPath);
+
+    // Returns the index of the given path, or -1 if it's not in the index
+    int findEntry(const std::string& path) const;
+
+    // Assemble the path of the given row by walking up to the toplevel item
+    std::string getPath(TreeModel& model, const wxDataViewItem& item) const;
+
+    // Create the pending rows on the way to the given path. Folder rows found
+    // on the way are stored in the given map, to be reused by subsequent calls.
+    void populatePath(TreeModel& model, const std::string& path, std::map<std::string, wxDataViewItem>& folderItems);
+};
+
+} // namespace
@@ -102,6 +102,15 @@ void ResourceTreeView::SetTreeModel(const TreeModel::Ptr& model)
 
 void ResourceTreeView::SetupTreeModelFilter()
 {
+    if (_mode == TreeMode::ShowFavourites && !_favouriteTypeName.empty())
+    {
+        // Rows which are not created yet are considered invisible, create the favourites
+        for (const auto& favourite : GlobalFavouritesManager().getFavourites(_favouriteTypeName))
+        {
+            _treeStore->PopulateElement(favourite, _favouriteKeyColumn);
+        }
+    }
+
     // Set up the filter
     _treeModelFilter.reset(new TreeModelFilter(_treeStore));
 
@@ -211,6 +220,12 @@ bool ResourceTreeView::SetFilterText(const wxString& filterText)
     // We use the lower-case copy of the given filter text
     _filterText = filterText.Lower();
 
+    if (_treeStore && !_filterText.empty())
+    {
+        // Create the rows leading to the matches, the pending ones are considered invisible
+        _treeStore->PopulateMatches(_filterText);
+    }
+
     wxDataViewItem item = GetSelection();
 
     // Update the top level tree items which rebuilds the view
@@ -240,6 +255,9 @@ void ResourceTreeView::UpdateTreeVisibility()
 {
     if (_treeModelFilter)
     {
+        // The filter text is not part of the model, forget the previous results
+        _treeModelFilter->ClearVisibilityCache();
+
 #if defined(__WXGTK__) && !wxCHECK_VERSION(3, 0, 5)
         // In wxGTK 3.0.4 Cleared() will just wipe out the treeview
         // Re-associate the model to refresh the view
@@ -630,6 +648,12 @@ bool ResourceTreeView::IsTreeModelRowOrAnyChildVisible(TreeModel::Row& row)
         return true; // node is visible
     }
 
+    // Children which are not created yet don't contain any matches, see SetFilterText()
+    if (_treeStore->HasPendingChildren(row.getItem()))
+    {
+        return false;
+    }
+
     // The node itself is invisible, but it might still be visible
     // if any of the child nodes is visible, dive into it
     wxDataViewItemArray children;
@@ -639,8 +663,9 @@ bool ResourceTreeView::IsTreeModelRowOrAnyChildVisible(TreeModel::Row& row)
     {
         wxutil::TreeModel::Row childRow(child, *_treeStore);
 
-        // Check the child node (recursively)
-        if (IsTreeModelRowOrAnyChildVisible(childRow))
+        // Check the child node (recursively), the filter remembers the result
+        // such that the parent rows don't evaluate the same subtree again
+        if (_treeModelFilter ? _treeModelFilter->ItemIsVisible(childRow) : IsTreeModelRowOrAnyChildVisible(childRow))
         {
             return true; // found a visible child, this is enough
         }
@@ -68,24 +68,25 @@ public:
     {
         VFSTreePopulator populator(model);
 
-        GlobalDeclarationManager().foreachDeclaration(_type, [&](const decl::IDeclaration::Ptr& decl)
+        // Work on a snapshot of the names, the decl manager is not locked while the tree is built
+        auto snapshot = GlobalDeclarationManager().getNameSnapshot(_type);
+
+        for (const auto& entry : snapshot->entries)
         {
             ThrowIfCancellationRequested();
 
-            if (decl->getBlockSyntax().fileInfo.visibility == vfs::Visibility::HIDDEN)
+            if (entry.visibility == vfs::Visibility::HIDDEN)
             {
-                return; // skip hidden declarations
+                continue; // skip hidden declarations
             }
 
-            auto fullPath = GenerateFullDeclPath(decl);
-
             // Sort the decl into the tree and set the values
-            populator.addPath(fullPath, [&](TreeModel::Row& row,
+            populator.addPath(entry.fullPath, [&](TreeModel::Row& row,
                 const std::string& path, const std::string& leafName, bool isFolder)
             {
-                AssignValuesToRow(row, path, isFolder ? path : decl->getDeclName(), leafName, isFolder);
+                AssignValuesToRow(row, path, isFolder ? path : entry.name, leafName, isFolder);
             });
-        });
+        }
     }
 
     // Generates the full path the given declaration should be sorted into.
@@ -207,19 +208,27 @@ protected:
     {
         ThrowIfCancellationRequested();
 
-        auto isFavourite = IsFavourite(declName);
-
-        row[_columns.iconAndName] = wxVariant(wxDataViewIconText(leafName, !isFolder ? _declIcon : _folderIcon));
-        row[_columns.iconAndName].setAttr(TreeViewItemStyle::Declaration(isFavourite));
-        row[_columns.fullName] = fullPath;
-        row[_columns.leafName] = leafName;
-        row[_columns.declName] = declName;
-        row[_columns.isFolder] = isFolder;
-        row[_columns.isFavourite] = isFavourite;
+        AssignValues(_columns, _declIcon, _folderIcon, IsFavourite(declName), row, fullPath, declName, leafName, isFolder);
 
         row.SendItemAdded();
     }
 
+    // Signature of AssignValuesToRow(), without sending any events
+    using RowValueAssigner = std::function<void(TreeModel::Row& row, const std::string& fullPath,
+        const std::string& declName, const std::string& leafName, bool isFolder)>;
+
+    // Returns a function assigning the same values as AssignValuesToRow(), for rows
+    // created after this populator is gone, like the ones of a LazyVFSTreePopulator.
+    // The function doesn't send any events.
+    RowValueAssigner GetDetachedRowValueAssigner() const
+    {
+        return [&columns = _columns, declIcon = _declIcon, folderIcon = _folderIcon, favourites = _favourites]
+            (TreeModel::Row& row, const std::string& fullPath, const std::string& declName, const std::string& leafName, bool isFolder)
+        {
+            AssignValues(columns, declIcon, folderIcon, favourites.count(declName) > 0, row, fullPath, declName, leafName, isFolder);
+        };
+    }
+
     const std::set<std::string>& GetFavourites() const
     {
         return _favourites;
@@ -249,6 +258,20 @@ protected:
         // Call will invoke Row::SendItemAdded()
         AssignValuesToRow(row, path, declName, leafName, false);
     }
+
+private:
+    static void AssignValues(const DeclarationTreeView::Columns& columns, const Icon& declIcon, const Icon& folderIcon,
+        bool isFavourite, TreeModel::Row& row, const std::string& fullPath, const std::string& declName,
+        const std::string& leafName, bool isFolder)
+    {
+        row[columns.iconAndName] = wxVariant(wxDataViewIconText(leafName, !isFolder ? declIcon : folderIcon));
+        row[columns.iconAndName].setAttr(TreeViewItemStyle::Declaration(isFavourite));
+        row[columns.fullName] = fullPath;
+        row[columns.leafName] = leafName;
+        row[columns.declName] = declName;
+        row[columns.isFolder] = isFolder;
+        row[columns.isFavourite] = isFavourite;
+    }
 };
 
 }
@@ -13,10 +13,10 @@ struct ThreadAbortedException : public std::runtime_error
 
 // Construct and initialise variables
 ThreadedResourceTreePopulator::ThreadedResourceTreePopulator(const TreeModel::ColumnRecord& columns) :
-    wxThread(wxTHREAD_JOINABLE),
     _finishedHandler(nullptr),
     _columns(columns),
-    _started(false)
+    _started(false),
+    _cancellationRequested(false)
 {}
 
 ThreadedResourceTreePopulator::~ThreadedResourceTreePopulator()
@@ -30,13 +30,13 @@ ThreadedResourceTreePopulator::~ThreadedResourceTreePopulator()
 
 void ThreadedResourceTreePopulator::ThrowIfCancellationRequested()
 {
-    if (TestDestroy())
+    if (_cancellationRequested)
     {
         throw ThreadAbortedException();
     }
 }
 
-wxThread::ExitCode ThreadedResourceTreePopulator::Entry()
+void ThreadedResourceTreePopulator::Run()
 {
     try
     {
@@ -57,10 +57,8 @@ wxThread::ExitCode ThreadedResourceTreePopulator::Entry()
     }
     catch (const ThreadAbortedException&)
     {
-        // Thread aborted due to Cancel request, exit now
+        // Population aborted due to Cancel request, exit now
     }
-
-    return static_cast<ExitCode>(0);
 }
 
 void ThreadedResourceTreePopulator::PostEvent(wxEvent* ev)
@@ -75,16 +73,16 @@ void ThreadedResourceTreePopulator::SetFinishedHandler(wxEvtHandler* finishedHan
 
 void ThreadedResourceTreePopulator::EnsurePopulated()
 {
-    // Start the thread now if we have to
+    // Start the task now if we have to
     if (!_started)
     {
         Populate();
     }
 
-    // Wait for any running thread
-    if (IsRunning())
+    // Wait for any running task, or run it right here if it's still queued
+    if (_task)
     {
-        Wait();
+        _task->wait();
     }
 }
 
@@ -102,15 +100,24 @@ void ThreadedResourceTreePopulator::Populate()
 
     // Set the latch
     _started = true;
-    wxThread::Run();
+    _cancellationRequested = false;
+    _task = GlobalTaskScheduler().submit([this]() { Run(); });
 }
 
 void ThreadedResourceTreePopulator::EnsureStopped()
 {
-    if (IsAlive())
+    if (IsRunning())
     {
-        Delete(); // cancel the running thread
+        // Cancel the running task, a task that has not been started yet is skipped
+        _cancellationRequested = true;
+        _task->cancel();
+        _task->wait();
     }
 }
 
+bool ThreadedResourceTreePopulator::IsRunning() const
+{
+    return _task && !_task->isFinished();
+}
+
 }
@@ -1,8 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <stdexcept>
-#include <wx/thread.h>
 #include <wx/event.h>
+#include "itaskscheduler.h"
 #include "TreeModel.h"
 #include "IResourceTreePopulator.h"
 
@@ -14,7 +15,8 @@ namespace wxutil
  * Subclasses need to implement the abstract members to add
  * the needed insertion or sorting logic.
  * 
- * At the end of the thread execution this populator will send
+ * The population is running as a task in the shared ITaskScheduler pool.
+ * At the end of the task execution this populator will send
  *  a wxutil::TreeModel::PopulationFinishedEvent to the handler.
  * 
  * Note: if a subclass is introducing additional class members
@@ -22,8 +24,7 @@ namespace wxutil
  * for the subclass destructor to call EnsureStopped().
  */
 class ThreadedResourceTreePopulator :
-    public IResourceTreePopulator,
-    protected wxThread
+    public IResourceTreePopulator
 {
 private:
     // The event handler to notify on completion
@@ -36,12 +37,15 @@ private:
     // updating the target tree store from a different thread isn't safe
     TreeModel::Ptr _treeStore;
 
-    // Whether this thread has been started at all
+    // Whether this populator has been started at all
     bool _started;
 
+    // The task running the population, empty if not started yet
+    threading::TaskPtr _task;
+    std::atomic<bool> _cancellationRequested;
+
 protected:
-    // Wrapper around TestDestroy that escalated by throwing a 
-    // ThreadAbortedException when cancellation has been requested
+    // Escalates a cancellation request by throwing a ThreadAbortedException
     void ThrowIfCancellationRequested();
 
     // Needed method to load data into the allocated tree model
@@ -52,10 +56,6 @@ protected:
     virtual void SortModel(const TreeModel::Ptr& model)
     {}
 
-    // The required entry point for wxWidgets that contains the calls
-    // to PopulateModel/SortModel as well as the exception handling
-    wxThread::ExitCode Entry() override final;
-
     // Queues an event to the attached finished handler
     void PostEvent(wxEvent* ev);
 
@@ -69,14 +69,20 @@ public:
 
     virtual void SetFinishedHandler(wxEvtHandler* finishedHandler) override;
 
-    // Blocks until the worker thread is done.
+    // Blocks until the population task is done.
     virtual void EnsurePopulated() override;
 
-    // Start the thread, if it isn't already running
+    // Start the population task, if it isn't already running
     virtual void Populate() override;
 
-    // Blocks and waits until the worker thread is done
+    // Cancels the population and waits until the task is done
     virtual void EnsureStopped() override;
+
+private:
+    // Contains the calls to PopulateModel/SortModel as well as the exception handling
+    void Run();
+
+    bool IsRunning() const;
 };
 
 }
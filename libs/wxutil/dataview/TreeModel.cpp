@@ -1,7 +1,10 @@
 #include "TreeModel.h"
 
 #include <algorithm>
+#include <atomic>
 #include <functional>
+#include <future>
+#include <thread>
 
 namespace wxutil
 {
@@ -25,64 +28,196 @@ wxString TreeModel::Column::getWxType() const
 	return types[type];
 }
 
-// TreeModel nodes form a directed acyclic graph
-class TreeModel::Node :
+namespace
+{
+    // Sort the children of different parents in parallel above this number of rows
+    constexpr std::size_t PARALLEL_SORT_THRESHOLD = 4096;
+
+    // Invokes the given function for each index in [0..count) using all available cores
+    void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+    {
+        std::atomic<std::size_t> nextIndex(0);
+
+        auto worker = [&]()
+        {
+            for (auto i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        };
+
+        auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+        std::vector<std::future<void>> workers;
+
+        for (std::size_t i = 1; i < numWorkers; ++i)
+        {
+            workers.emplace_back(std::async(std::launch::async, worker));
+        }
+
+        // The calling thread is processing its share too
+        worker();
+
+        // Wait for all workers, this is re-throwing any exceptions
+        for (auto& result : workers)
+        {
+            result.get();
+        }
+    }
+
+    inline wxDataViewItem getItemForRow(std::size_t row)
+    {
+        return wxDataViewItem(reinterpret_cast<wxDataViewItem::Type>(row));
+    }
+}
+
+// Storage of all rows of a TreeModel, one contiguous array per column. Rows are
+// identified by their index, which is used as wxDataViewItem ID. The root row has
+// the index 0, matching the invalid wxDataViewItem.
+class TreeModel::RowStorage :
 	public util::Noncopyable
 {
 public:
-	Node* parent; // NULL for the root node
+	// Index-based links between the rows, the root is linking to itself
+	std::vector<std::size_t> parents;
+	std::vector<std::vector<std::size_t>> children;
+
+	// Set for the rows whose children have not been created yet
+	std::vector<LazyChildPopulator::Ptr> pendingChildren;
+
+	// Values, attributes and enabled flags of each column, indexed by row. A column
+	// array only grows as far as the highest row that got a value in this column.
+	std::vector<std::vector<wxVariant>> values;
+	std::vector<std::vector<wxDataViewItemAttr>> attributes;
+	std::vector<std::vector<bool>> enabledFlags;
+
+	// Indices of removed rows, to be reused by the next added rows
+	std::vector<std::size_t> freeRows;
+
+	// Incremented for every change to the rows and values
+	std::size_t changeCount;
+
+	RowStorage(std::size_t numColumns) :
+		values(numColumns),
+		attributes(numColumns),
+		enabledFlags(numColumns),
+		changeCount(0)
+	{
+		clear();
+	}
+
+	// Removes all rows except for the root, which is cleared too
+	void clear()
+	{
+		parents.assign(1, 0);
+		children.resize(1);
+		children.front().clear();
+		pendingChildren.assign(1, LazyChildPopulator::Ptr());
 
-	// The item will use a Node* pointer as ID, which is possible
-	// since the wxDataViewItem is using void* as ID type
-	wxDataViewItem item;
+		for (auto& column : values) column.clear();
+		for (auto& column : attributes) column.clear();
+		for (auto& column : enabledFlags) column.clear();
 
-	typedef std::vector<wxVariant> Values;
-	Values values;
+		freeRows.clear();
+		++changeCount;
+	}
 
-	typedef std::vector<NodePtr> Children;
-	Children children;
+	std::size_t addRow(std::size_t parent)
+	{
+		std::size_t row;
+
+		if (!freeRows.empty())
+		{
+			row = freeRows.back();
+			freeRows.pop_back();
+			parents[row] = parent;
+		}
+		else
+		{
+			row = parents.size();
+			parents.push_back(parent);
+			children.emplace_back();
+			pendingChildren.emplace_back();
+		}
 
-	typedef std::vector<wxDataViewItemAttr> Attributes;
-	Attributes attributes;
+		children[parent].push_back(row);
+		++changeCount;
 
-	typedef std::vector<bool> EnabledFlags; // Each value can be flagged as enabled/disabled
-	EnabledFlags enabledFlags;
+		return row;
+	}
 
-	// Public constructor, does not accept NULL pointers
-	Node(Node* parent_) :
-		parent(parent_),
-		item(reinterpret_cast<wxDataViewItem::Type>(this))
+	// Detaches the row from its parent and releases it with all of its descendants
+	bool removeRow(std::size_t row)
 	{
-		// Use CreateRoot() instead of passing NULL
-		assert(parent_ != nullptr);
+		if (row == 0 || row >= parents.size()) return false; // cannot remove the root
+
+		auto& siblings = children[parents[row]];
+		auto found = std::find(siblings.begin(), siblings.end(), row);
+
+		if (found == siblings.end()) return false;
+
+		siblings.erase(found);
+		releaseRow(row);
+		++changeCount;
+
+		return true;
 	}
 
-private:
-	// Private constructor creates a root node, has a wxDataViewItem ID == NULL
-	Node() :
-		parent(nullptr),
-		item(nullptr)
-	{}
+	// Returns the stored value, or nullptr if no value has been assigned
+	const wxVariant* getValue(std::size_t row, unsigned int col) const
+	{
+		if (col >= values.size()) return nullptr;
 
-public:
-	static NodePtr createRoot()
+		const auto& column = values[col];
+
+		return row < column.size() && !column[row].IsNull() ? &column[row] : nullptr;
+	}
+
+	void setValue(std::size_t row, unsigned int col, const wxVariant& value)
 	{
-		return NodePtr(new Node());
+		if (values.size() < col + 1)
+		{
+			values.resize(col + 1);
+		}
+
+		auto& column = values[col];
+
+		if (column.size() < row + 1)
+		{
+			column.resize(row + 1);
+		}
+
+		column[row] = value;
+		++changeCount;
 	}
 
-	bool remove(TreeModel::Node* child)
+private:
+	void releaseRow(std::size_t row)
 	{
-		for (Children::iterator i = children.begin();
-			 i != children.end(); ++i)
+		for (auto child : children[row])
 		{
-			if (i->get() == child)
-			{
-				children.erase(i);
-				return true;
-			}
+			releaseRow(child);
 		}
 
-		return false;
+		children[row].clear();
+		pendingChildren[row].reset();
+
+		for (auto& column : values)
+		{
+			if (row < column.size()) column[row] = wxVariant();
+		}
+
+		for (auto& column : attributes)
+		{
+			if (row < column.size()) column[row] = wxDataViewItemAttr();
+		}
+
+		for (auto& column : enabledFlags)
+		{
+			if (row < column.size()) column[row] = true;
+		}
+
+		freeRows.push_back(row);
 	}
 };
 
@@ -157,7 +292,7 @@ void TreeModel::PopulationProgressEvent::SetMessage(const wxString& message)
 
 TreeModel::TreeModel(const ColumnRecord& columns, bool isListModel) :
 	_columns(columns),
-	_rootNode(Node::createRoot()),
+	_storage(std::make_shared<RowStorage>(columns.size())),
 	_defaultStringSortColumn(-1),
 	_hasDefaultCompare(false),
 	_isListModel(isListModel)
@@ -165,18 +300,29 @@ TreeModel::TreeModel(const ColumnRecord& columns, bool isListModel) :
 
 TreeModel::TreeModel(const TreeModel& existingModel) :
 	_columns(existingModel._columns),
-	_rootNode(existingModel._rootNode),
+	_storage(existingModel._storage),
 	_defaultStringSortColumn(existingModel._defaultStringSortColumn),
 	_hasDefaultCompare(existingModel._hasDefaultCompare),
-	_isListModel(existingModel._isListModel)
+	_isListModel(existingModel._isListModel),
+	_lazyChildPopulators(existingModel._lazyChildPopulators)
 {}
 
 TreeModel::~TreeModel()
 {}
 
-const TreeModel::NodePtr& TreeModel::getRootNode() const
+std::size_t TreeModel::GetRowIndex(const wxDataViewItem& item)
 {
-	return _rootNode;
+	return reinterpret_cast<std::size_t>(item.GetID());
+}
+
+std::size_t TreeModel::GetRowCapacity() const
+{
+	return _storage->parents.size();
+}
+
+std::size_t TreeModel::GetChangeCount() const
+{
+	return _storage->changeCount;
 }
 
 const TreeModel::ColumnRecord& TreeModel::GetColumns() const
@@ -186,33 +332,26 @@ const TreeModel::ColumnRecord& TreeModel::GetColumns() const
 
 TreeModel::Row TreeModel::AddItem()
 {
-	return AddItemUnderParent(_rootNode->item);
+	return AddItemUnderParent(wxDataViewItem());
 }
 
 TreeModel::Row TreeModel::AddItemUnderParent(const wxDataViewItem& parent)
 {
-	// Redirect to the root node for invalid items
-	Node* parentNode = !parent.IsOk() ? _rootNode.get() : static_cast<Node*>(parent.GetID());
-
-	NodePtr node(new Node(parentNode));
+	// Invalid items are referring to the root row
+	auto row = _storage->addRow(GetRowIndex(parent));
 
-	parentNode->children.push_back(node);
-
-	return Row(node->item, *this);
+	return Row(getItemForRow(row), *this);
 }
 
 bool TreeModel::RemoveItem(const wxDataViewItem& item)
 {
 	if (item.IsOk())
 	{
-		Node* node = static_cast<Node*>(item.GetID());
-		Node* parent = node->parent;
-
-		if (parent == NULL) return false; // cannot remove the root node
+		auto parent = GetParent(item);
 
-		if (parent->remove(node))
+		if (_storage->removeRow(GetRowIndex(item)))
 		{
-			ItemDeleted(parent->item, item);
+			ItemDeleted(parent, item);
 			return true;
 		}
 	}
@@ -227,19 +366,18 @@ int TreeModel::RemoveItems(const std::function<bool (const TreeModel::Row&)>& pr
 
 int TreeModel::RemoveItemsRecursively(const wxDataViewItem& parent, const std::function<bool (const TreeModel::Row&)>& predicate)
 {
-	Node* parentNode = !parent.IsOk() ? _rootNode.get() : static_cast<Node*>(parent.GetID());
+	auto parentRow = GetRowIndex(parent);
 
 	int deleteCount = 0;
 	wxDataViewItemArray itemsToDelete;
 
-	for (Node::Children::const_iterator i = parentNode->children.begin();
-			i != parentNode->children.end(); ++i)
+	for (auto child : _storage->children[parentRow])
 	{
-		Row row((*i)->item, *this);
+		Row row(getItemForRow(child), *this);
 
 		if (predicate(row))
 		{
-			itemsToDelete.push_back((*i)->item);
+			itemsToDelete.push_back(row.getItem());
 		}
 	}
 
@@ -252,16 +390,14 @@ int TreeModel::RemoveItemsRecursively(const wxDataViewItem& parent, const std::f
 		// Remove these items
 		std::for_each(itemsToDelete.begin(), itemsToDelete.end(), [&] (const wxDataViewItem& item)
 		{
-			Node* nodeToDelete = static_cast<Node*>(item.GetID());
-			parentNode->remove(nodeToDelete);
+			_storage->removeRow(GetRowIndex(item));
 			deleteCount++;
 		});
 	}
 
-	for (Node::Children::const_iterator i = parentNode->children.begin();
-			i != parentNode->children.end(); ++i)
+	for (std::size_t i = 0; i < _storage->children[parentRow].size(); ++i)
 	{
-		deleteCount += RemoveItemsRecursively((*i)->item, predicate);
+		deleteCount += RemoveItemsRecursively(getItemForRow(_storage->children[parentRow][i]), predicate);
 	}
 
 	return deleteCount;
@@ -282,21 +418,74 @@ void TreeModel::Clear()
 	// The Cleared() call below might query GetParent() calls
 	// for nodes that are still present in the internal tree
 	wxDataViewItemArray children;
-	GetChildren(_rootNode->item, children);
+	GetChildren(wxDataViewItem(), children);
 
 	if (!children.empty())
 	{
-		ItemsDeleted(_rootNode->item, children);
+		ItemsDeleted(wxDataViewItem(), children);
 	}
 #endif
 
-	// Now it should be safe to free all the nodes
-	_rootNode->values.clear();
-	_rootNode->children.clear();
+	// Now it should be safe to free all the rows
+	_storage->clear();
+	_lazyChildPopulators.clear();
 	
 	Cleared();
 }
 
+void TreeModel::SetChildrenPending(const wxDataViewItem& item, const LazyChildPopulator::Ptr& populator)
+{
+    auto row = GetRowIndex(item);
+
+    assert(_storage->children[row].empty());
+    _storage->pendingChildren[row] = populator;
+
+    if (std::find(_lazyChildPopulators.begin(), _lazyChildPopulators.end(), populator) == _lazyChildPopulators.end())
+    {
+        _lazyChildPopulators.push_back(populator);
+    }
+}
+
+bool TreeModel::HasPendingChildren(const wxDataViewItem& item) const
+{
+    return _storage->pendingChildren[GetRowIndex(item)] != nullptr;
+}
+
+void TreeModel::EnsureChildrenPopulated(const wxDataViewItem& item) const
+{
+    auto& pendingChildren = _storage->pendingChildren[GetRowIndex(item)];
+
+    if (!pendingChildren) return;
+
+    // Clear the flag before populating, the populator might be asking for the children
+    auto populator = std::move(pendingChildren);
+    pendingChildren.reset();
+
+    // Creating rows doesn't change the model from the viewer's point of view
+    populator->PopulateChildren(const_cast<TreeModel&>(*this), item);
+}
+
+void TreeModel::PopulateElement(const std::string& value, const Column& column)
+{
+    // Copy the list, the populators might be adding pending items
+    auto populators = _lazyChildPopulators;
+
+    for (const auto& populator : populators)
+    {
+        populator->PopulateElement(*this, value, column);
+    }
+}
+
+void TreeModel::PopulateMatches(const wxString& lowerText)
+{
+    auto populators = _lazyChildPopulators;
+
+    for (const auto& populator : populators)
+    {
+        populator->PopulateMatches(*this, lowerText);
+    }
+}
+
 void TreeModel::SetDefaultStringSortColumn(int index)
 {
 	_defaultStringSortColumn = index;
@@ -309,54 +498,55 @@ void TreeModel::SetHasDefaultCompare(bool hasDefaultCompare)
 
 void TreeModel::ForeachNode(const TreeModel::VisitFunction& visitFunction)
 {
-	// Skip the root node and traverse its immediate children recursively
-	std::for_each(_rootNode->children.begin(), _rootNode->children.end(), [&] (const NodePtr& node)
+	// Skip the root row and traverse its immediate children recursively
+	for (std::size_t i = 0; i < _storage->children[0].size(); ++i)
 	{
-		ForeachNodeRecursive(node, visitFunction);
-	});
+		ForeachNodeRecursive(_storage->children[0][i], visitFunction);
+	}
 }
 
-void TreeModel::ForeachNodeRecursive(const TreeModel::NodePtr& node, const TreeModel::VisitFunction& visitFunction)
+void TreeModel::ForeachNodeRecursive(std::size_t row, const TreeModel::VisitFunction& visitFunction)
 {
-	wxutil::TreeModel::Row row(node->item, *this);
-	visitFunction(row);
+	wxutil::TreeModel::Row visitedRow(getItemForRow(row), *this);
+	visitFunction(visitedRow);
 
-	// Enter the recursion
-	std::for_each(node->children.begin(), node->children.end(), [&] (const NodePtr& child)
+	// Enter the recursion, the children are looked up again after each step
+	// since the visitor might be adding rows
+	for (std::size_t i = 0; i < _storage->children[row].size(); ++i)
 	{
-		ForeachNodeRecursive(child, visitFunction);
-	});
+		ForeachNodeRecursive(_storage->children[row][i], visitFunction);
+	}
 }
 
 void TreeModel::ForeachNodeReverse(const TreeModel::VisitFunction& visitFunction)
 {
-	// Skip the root node and traverse its immediate children recursively
-	for (Node::Children::const_reverse_iterator i = _rootNode->children.rbegin(); i != _rootNode->children.rend(); ++i)
+	// Skip the root row and traverse its immediate children recursively
+	for (auto i = _storage->children[0].size(); i > 0; --i)
 	{
-		ForeachNodeRecursiveReverse(*i, visitFunction);
+		ForeachNodeRecursiveReverse(_storage->children[0][i - 1], visitFunction);
 	}
 }
 
-void TreeModel::ForeachNodeRecursiveReverse(const TreeModel::NodePtr& node, const TreeModel::VisitFunction& visitFunction)
+void TreeModel::ForeachNodeRecursiveReverse(std::size_t row, const TreeModel::VisitFunction& visitFunction)
 {
-	wxutil::TreeModel::Row row(node->item, *this);
-	visitFunction(row);
+	wxutil::TreeModel::Row visitedRow(getItemForRow(row), *this);
+	visitFunction(visitedRow);
 
 	// Enter the recursion
-	for (Node::Children::const_reverse_iterator i = node->children.rbegin(); i != node->children.rend(); ++i)
+	for (auto i = _storage->children[row].size(); i > 0; --i)
 	{
-		ForeachNodeRecursiveReverse(*i, visitFunction);
+		ForeachNodeRecursiveReverse(_storage->children[row][i - 1], visitFunction);
 	}
 }
 
 void TreeModel::SortModel(const TreeModel::SortFunction& sortFunction)
 {
-	SortModelRecursively(_rootNode.get(), sortFunction);
+	SortModelRecursively(0, sortFunction);
 }
 
 void TreeModel::SortModelByColumn(const TreeModel::Column& column)
 {
-	SortModelRecursively(_rootNode.get(), [&](const wxDataViewItem& a, const wxDataViewItem& b)->bool
+	SortModelRecursively(0, [&](const wxDataViewItem& a, const wxDataViewItem& b)->bool
 	{
 		Row rowA(a, *this);
 		Row rowB(b, *this);
@@ -416,31 +606,127 @@ void TreeModel::SortModelFoldersFirst(const Column& stringColumn, const Column&
 void TreeModel::SortModelFoldersFirst(const wxDataViewItem& startItem, const Column& stringColumn,
     const Column& isFolderColumn, const FolderCompareFunction& customFolderSortFunc)
 {
-    auto startNode = !startItem.IsOk() ? _rootNode.get() : static_cast<Node*>(startItem.GetID());
+    auto& storage = *_storage;
+
+    // Collect the rows having children to sort
+    std::vector<std::size_t> parentRows;
+    std::vector<std::size_t> rowsToVisit(1, GetRowIndex(startItem));
+    std::size_t numSortedRows = 0;
+
+    while (!rowsToVisit.empty())
+    {
+        auto row = rowsToVisit.back();
+        rowsToVisit.pop_back();
+
+        const auto& children = storage.children[row];
+
+        if (children.size() > 1)
+        {
+            parentRows.push_back(row);
+            numSortedRows += children.size();
+        }
+
+        rowsToVisit.insert(rowsToVisit.end(), children.begin(), children.end());
+    }
 
-    SortModelRecursively(startNode, std::bind(&TreeModel::CompareFoldersFirst,
-        this,
-        std::placeholders::_1,
-        std::placeholders::_2,
-        stringColumn,
-        stringColumn.type == Column::String ? CompareStringVariants : CompareIconTextVariants,
-        isFolderColumn,
-        customFolderSortFunc));
+    if (parentRows.empty()) return;
+
+    // Extract the sort keys first, such that the comparisons don't need to touch
+    // any wxVariants, whose reference counts must not be changed concurrently
+    struct SortKey
+    {
+        bool isFolder;
+        wxString lowerName;
+    };
+
+    std::vector<SortKey> keys(storage.parents.size());
+
+    for (auto parentRow : parentRows)
+    {
+        for (auto row : storage.children[parentRow])
+        {
+            wxVariant isFolder, name;
+            GetValue(isFolder, getItemForRow(row), isFolderColumn.getColumnIndex());
+            GetValue(name, getItemForRow(row), stringColumn.getColumnIndex());
+
+            keys[row].isFolder = isFolder.GetBool();
+
+            if (stringColumn.type == Column::String)
+            {
+                keys[row].lowerName = name.GetString().Lower();
+            }
+            else
+            {
+                wxDataViewIconText iconText;
+                iconText << name;
+                keys[row].lowerName = iconText.GetText().Lower();
+            }
+        }
+    }
+
+    auto compare = [&](std::size_t a, std::size_t b)
+    {
+        const auto& keyA = keys[a];
+        const auto& keyB = keys[b];
+
+        // Folders sort before everything else
+        if (keyA.isFolder != keyB.isFolder)
+        {
+            return keyA.isFolder;
+        }
+
+        // Ask the special compare function first if A and B are both folders
+        if (keyA.isFolder && customFolderSortFunc)
+        {
+            int customResult = customFolderSortFunc(getItemForRow(a), getItemForRow(b));
+
+            // If the custom functor returns "equal", we continue with our algorithm
+            if (customResult != 0)
+            {
+                return customResult < 0;
+            }
+        }
+
+        // greebo: We're not checking for equality here, names are unique
+        return keyA.lowerName.compare(keyB.lowerName) < 0;
+    };
+
+    auto sortChildren = [&](std::size_t index)
+    {
+        auto& children = storage.children[parentRows[index]];
+        std::sort(children.begin(), children.end(), compare);
+    };
+
+    // The children of each parent can be sorted independently. Custom folder functions
+    // are usually reading values from the model, which is not safe to do concurrently.
+    if (!customFolderSortFunc && numSortedRows >= PARALLEL_SORT_THRESHOLD && parentRows.size() > 1)
+    {
+        runInParallel(parentRows.size(), sortChildren);
+    }
+    else
+    {
+        for (std::size_t i = 0; i < parentRows.size(); ++i)
+        {
+            sortChildren(i);
+        }
+    }
 }
 
-void TreeModel::SortModelRecursively(Node* node, const TreeModel::SortFunction& sortFunction)
+void TreeModel::SortModelRecursively(std::size_t row, const TreeModel::SortFunction& sortFunction)
 {
+	auto& children = _storage->children[row];
+
 	// Use std::sort algorithm and small lambda to only pass wxDataViewItems to the client sort function
-	std::sort(node->children.begin(), node->children.end(), [&] (const NodePtr& a, const NodePtr& b)->bool
+	std::sort(children.begin(), children.end(), [&] (std::size_t a, std::size_t b)->bool
 	{
-        return sortFunction(a->item, b->item);
+        return sortFunction(getItemForRow(a), getItemForRow(b));
 	});
 
 	// Enter recursion
-	std::for_each(node->children.begin(), node->children.end(), [&] (const NodePtr& child)
+	for (auto child : children)
 	{
-        SortModelRecursively(child.get(), sortFunction);
-	});
+        SortModelRecursively(child, sortFunction);
+	}
 }
 
 wxDataViewItem TreeModel::FindString(const std::string& needle, const Column& column)
@@ -450,26 +736,29 @@ wxDataViewItem TreeModel::FindString(const std::string& needle, const Column& co
 
 wxDataViewItem TreeModel::FindString(const std::string& needle, const Column& column, const wxDataViewItem& startItem)
 {
-    auto* startNode = !startItem.IsOk() ? _rootNode.get() : static_cast<Node*>(startItem.GetID());
+    PopulateElement(needle, column);
+
+	int colIndex = column.getColumnIndex();
 
-	return FindRecursive(*startNode, [&] (const Node& node)->bool
+	return FindRecursive(GetRowIndex(startItem), [&] (std::size_t row)->bool
 	{
-		int colIndex = column.getColumnIndex();
+		auto value = _storage->getValue(row, colIndex);
+
+		if (value == nullptr)
+		{
+			return false;
+		}
 
 		if (column.type == Column::IconText)
 		{
-			if (static_cast<int>(node.values.size()) > colIndex)
-			{
-				wxDataViewIconText iconText;
-				iconText << node.values[colIndex];
+			wxDataViewIconText iconText;
+			iconText << *value;
 
-				return iconText.GetText() == needle;
-			}
+			return iconText.GetText() == needle;
 		}
 		else if (column.type == Column::String)
 		{
-			return static_cast<int>(node.values.size()) > colIndex && 
-				static_cast<std::string>(node.values[colIndex]) == needle;
+			return static_cast<std::string>(*value) == needle;
 		}
 
 		return false;
@@ -483,13 +772,12 @@ wxDataViewItem TreeModel::FindInteger(long needle, const Column& column)
 
 wxDataViewItem TreeModel::FindInteger(long needle, const Column& column, const wxDataViewItem& startItem)
 {
-    auto* startNode = !startItem.IsOk() ? _rootNode.get() : static_cast<Node*>(startItem.GetID());
+	int colIndex = column.getColumnIndex();
 
-	return FindRecursive(*startNode, [&] (const Node& node)->bool
+	return FindRecursive(GetRowIndex(startItem), [&] (std::size_t row)->bool
 	{
-		int colIndex = column.getColumnIndex();
-		return static_cast<int>(node.values.size()) > colIndex && 
-			static_cast<long>(node.values[colIndex]) == needle;
+		auto value = _storage->getValue(row, colIndex);
+		return value != nullptr && static_cast<long>(*value) == needle;
 	});
 }
 
@@ -500,27 +788,25 @@ wxDataViewItem TreeModel::FindItem(const std::function<bool(const TreeModel::Row
 
 wxDataViewItem TreeModel::FindItem(const std::function<bool(const TreeModel::Row&)>& predicate, const wxDataViewItem& startItem)
 {
-    auto* startNode = !startItem.IsOk() ? _rootNode.get() : static_cast<Node*>(startItem.GetID());
-
-    return FindRecursive(*startNode, [&](const Node& node)->bool
+    return FindRecursive(GetRowIndex(startItem), [&](std::size_t row)->bool
     {
-        Row row(node.item, *this);
-        return predicate(row);
+        Row candidate(getItemForRow(row), *this);
+        return predicate(candidate);
     });
 }
 
-wxDataViewItem TreeModel::FindRecursive(const TreeModel::Node& node, const std::function<bool (const TreeModel::Node&)>& predicate)
+wxDataViewItem TreeModel::FindRecursive(std::size_t row, const std::function<bool (std::size_t row)>& predicate)
 {
-	// Test the node itself
-	if (predicate(node))
+	// Test the row itself
+	if (predicate(row))
 	{
-		return node.item;
+		return getItemForRow(row);
 	}
 
 	// Then test all children, aborting on first success
-	for (const auto& child : node.children)
+	for (auto child : _storage->children[row])
 	{
-		wxDataViewItem item = FindRecursive(*child, predicate);
+		wxDataViewItem item = FindRecursive(child, predicate);
 
 		if (item.IsOk())
 		{
@@ -532,32 +818,19 @@ wxDataViewItem TreeModel::FindRecursive(const TreeModel::Node& node, const std::
 	return wxDataViewItem();
 }
 
-wxDataViewItem TreeModel::FindRecursiveUsingRows(const TreeModel::Node& node, const std::function<bool (TreeModel::Row&)>& predicate)
+wxDataViewItem TreeModel::FindRecursiveUsingRows(const wxDataViewItem& startItem, const std::function<bool (TreeModel::Row&)>& predicate)
 {
-	if (node.item.IsOk())
+	// The root row is not tested
+	return FindRecursive(GetRowIndex(startItem), [&](std::size_t row)->bool
 	{
-		Row row(node.item, *this);
-
-		// Test the node itself
-		if (predicate(row))
+		if (row == 0)
 		{
-			return node.item;
-		}
-	}
-
-	// Then test all children, aborting on first success
-	for (const auto& child : node.children)
-	{
-		wxDataViewItem item = FindRecursiveUsingRows(*child, predicate);
-
-		if (item.IsOk())
-		{
-			return item;
+			return false;
 		}
-	}
 
-	// Return an empty data item, which is "not ok"
-	return wxDataViewItem();
+		Row candidate(getItemForRow(row), *this);
+		return predicate(candidate);
+	});
 }
 
 bool TreeModel::RowContainsString(const Row& row, const wxString& value, const std::vector<Column>& columnsToSearch, bool lowerStrings)
@@ -600,11 +873,9 @@ wxString TreeModel::GetColumnType(unsigned int col) const
 void TreeModel::GetValue(wxVariant &variant,
                          const wxDataViewItem &item, unsigned int col) const
 {
-    Node* owningNode = item.IsOk() ? static_cast<Node*>(item.GetID()) : _rootNode.get();
-
-    // Return the value from the node if present
-    if (col < owningNode->values.size()) {
-        variant = owningNode->values[col];
+    // Return the value from the row if present
+    if (auto value = _storage->getValue(GetRowIndex(item), col); value != nullptr) {
+        variant = *value;
     }
     else {
         // GTK tree views don't like model columns returning no data, so return a default
@@ -642,30 +913,25 @@ bool TreeModel::SetValue(const wxVariant& variant, const wxDataViewItem& item, u
         value = variant.GetString();
     }
 
-    // Find the node to contain the value
-    Node* owningNode = item.IsOk() ? static_cast<Node*>(item.GetID()) : _rootNode.get();
-    if (owningNode->values.size() < col + 1) {
-        owningNode->values.resize(col + 1);
-    }
-
     // Assign the value
-    owningNode->values[col] = value;
+    _storage->setValue(GetRowIndex(item), col, value);
 
     return true;
 }
 
 bool TreeModel::GetAttr(const wxDataViewItem& item, unsigned int col, wxDataViewItemAttr& attr) const
 {
-	if (!item.IsOk())
+	if (!item.IsOk() || col >= _storage->attributes.size())
 	{
 		return false;
 	}
 
-	Node* owningNode = static_cast<Node*>(item.GetID());
+	const auto& column = _storage->attributes[col];
+	auto row = GetRowIndex(item);
 
-	if (col < owningNode->attributes.size())
+	if (row < column.size())
 	{
-		attr = owningNode->attributes[col];
+		attr = column[row];
 		return true;
 	}
 
@@ -679,32 +945,32 @@ void TreeModel::SetAttr(const wxDataViewItem& item, unsigned int col, const wxDa
 		return;
 	}
 
-	Node* owningNode = static_cast<Node*>(item.GetID());
+	if (_storage->attributes.size() < col + 1)
+	{
+		_storage->attributes.resize(col + 1);
+	}
+
+	auto& column = _storage->attributes[col];
+	auto row = GetRowIndex(item);
 
-	if (owningNode->attributes.size() < col + 1)
+	if (column.size() < row + 1)
 	{
-		owningNode->attributes.resize(col + 1);
+		column.resize(row + 1);
 	}
 
-	owningNode->attributes[col] = attr;
+	column[row] = attr;
 }
 
 wxDataViewItem TreeModel::GetParent(const wxDataViewItem& item) const
 {
-	// It's ok to ask for invisible root node's parent
+	// It's ok to ask for invisible root node's parent, the top level rows
+	// are linked to the root which has the invalid item as well
 	if (!item.IsOk())
 	{
 		return wxDataViewItem(NULL);	
 	}
 
-	Node* owningNode = static_cast<Node*>(item.GetID());
-
-	if (owningNode->parent != NULL)
-	{
-		return owningNode->parent->item;
-	}
-	
-	return wxDataViewItem(NULL);
+	return getItemForRow(_storage->parents[GetRowIndex(item)]);
 }
 
 bool TreeModel::IsContainer(const wxDataViewItem& item) const
@@ -725,9 +991,9 @@ bool TreeModel::IsContainer(const wxDataViewItem& item) const
 	return !_isListModel ? true : false;
 #else
 	// Regular implementation: return true if this node has child nodes
-	Node* owningNode = static_cast<Node*>(item.GetID());
+	auto row = GetRowIndex(item);
 
-	return owningNode != NULL && !owningNode->children.empty();
+	return !_storage->children[row].empty() || _storage->pendingChildren[row];
 #endif
 }
 
@@ -738,21 +1004,23 @@ bool TreeModel::HasContainerColumns(const wxDataViewItem&) const
 
 unsigned int TreeModel::GetChildren(const wxDataViewItem& item, wxDataViewItemArray& children) const
 {
+	EnsureChildrenPopulated(item);
+
 	// Requests for invalid items are asking for our root children, actually
-	Node* owningNode = !item.IsOk() ? _rootNode.get() : static_cast<Node*>(item.GetID());
+	const auto& childRows = _storage->children[GetRowIndex(item)];
 
-	for (Node::Children::const_iterator iter = owningNode->children.begin(); iter != owningNode->children.end(); ++iter)
+	for (auto child : childRows)
 	{
-		children.Add((*iter)->item);
+		children.Add(getItemForRow(child));
 	}
 
-	return static_cast<unsigned int>(owningNode->children.size());
+	return static_cast<unsigned int>(childRows.size());
 }
 
 wxDataViewItem TreeModel::GetRoot()
 {
 	// The root item carries the NULL pointer, the other methods need to be able to deal with that
-	return _rootNode->item;
+	return getItemForRow(0);
 }
 
 bool TreeModel::IsListModel() const
@@ -767,27 +1035,31 @@ void TreeModel::SetIsListModel(bool isListModel)
 
 int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2, unsigned int column, bool ascending) const
 {
-	Node* node1 = static_cast<Node*>(item1.GetID());
-	Node* node2 = static_cast<Node*>(item2.GetID());
-
-	if (!node1 || !node2)
+	if (!item1.IsOk() || !item2.IsOk())
 		return 0;
 
 #if 0 // Don't handle folders first sorting here
-	if (!node1->children.empty() && node2->children.empty())
+	if (IsContainer(item1) && !IsContainer(item2))
 		return ascending ? -1 : 1;
 
-	if (!node2->children.empty() && node1->children.empty())
+	if (IsContainer(item2) && !IsContainer(item1))
 		return ascending ? 1 : -1;
 #endif
 
+	if (_defaultStringSortColumn >= 0)
+	{
+		column = static_cast<unsigned int>(_defaultStringSortColumn);
+	}
+
+	wxVariant value1, value2;
+	GetValue(value1, item1, column);
+	GetValue(value2, item2, column);
+
 	if (_defaultStringSortColumn >= 0)
 	{
 		return ascending ? 
-            node1->values[_defaultStringSortColumn].GetString().CmpNoCase(
-			    node2->values[_defaultStringSortColumn].GetString()) :
-                node2->values[_defaultStringSortColumn].GetString().CmpNoCase(
-			    node1->values[_defaultStringSortColumn].GetString());
+            value1.GetString().CmpNoCase(value2.GetString()) :
+            value2.GetString().CmpNoCase(value1.GetString());
 	}
 
 	// When clicking on the dataviewctrl headers, we need to support some default algorithm
@@ -798,17 +1070,17 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
         case Column::String:
         {
             return ascending ? 
-                node1->values[column].GetString().CmpNoCase(node2->values[column].GetString()) :
-                node2->values[column].GetString().CmpNoCase(node1->values[column].GetString());
+                value1.GetString().CmpNoCase(value2.GetString()) :
+                value2.GetString().CmpNoCase(value1.GetString());
         }
 
         case Column::IconText:
         {
             wxDataViewIconText val1;
-            val1 << node1->values[column];
+            val1 << value1;
 
             wxDataViewIconText val2;
-            val2 << node2->values[column];
+            val2 << value2;
 
             return ascending ? val1.GetText().CmpNoCase(val2.GetText()) :
                 val2.GetText().CmpNoCase(val1.GetText());
@@ -816,8 +1088,8 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
 
         case Column::Double:
         {
-            double val1 = node1->values[column].GetDouble();
-            double val2 = node2->values[column].GetDouble();
+            double val1 = value1.GetDouble();
+            double val2 = value2.GetDouble();
 
             if (val1 == val2) return 0;
 
@@ -827,8 +1099,8 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
 
         case Column::Integer:
         {
-            long val1 = node1->values[column].GetInteger();
-            long val2 = node2->values[column].GetInteger();
+            long val1 = value1.GetInteger();
+            long val2 = value2.GetInteger();
 
             if (val1 == val2) return 0;
 
@@ -838,8 +1110,8 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
 
         case Column::Boolean:
         {
-            bool val1 = node1->values[column].GetBool();
-            bool val2 = node2->values[column].GetBool();
+            bool val1 = value1.GetBool();
+            bool val2 = value2.GetBool();
 
             if (val1 == val2) return 0;
 
@@ -848,8 +1120,8 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
 
         case Column::Pointer:
         {
-            void* val1 = node1->values[column].GetVoidPtr();
-            void* val2 = node2->values[column].GetVoidPtr();
+            void* val1 = value1.GetVoidPtr();
+            void* val2 = value2.GetVoidPtr();
 
             if (val1 == val2) return 0;
 
@@ -869,86 +1141,6 @@ int TreeModel::Compare(const wxDataViewItem& item1, const wxDataViewItem& item2,
 	return 0;
 }
 
-int TreeModel::CompareStringVariants(const wxVariant& a, const wxVariant& b)
-{
-    return a.GetString().CmpNoCase(b.GetString());
-}
-
-int TreeModel::CompareIconTextVariants(const wxVariant& a, const wxVariant& b)
-{
-    wxDataViewIconText aValue;
-    aValue << a;
-
-    wxDataViewIconText bValue;
-    bValue << b;
-
-    return aValue.GetText().CmpNoCase(bValue.GetText());
-}
-
-bool TreeModel::CompareFoldersFirst(const wxDataViewItem& a, const wxDataViewItem& b, 
-                                    const TreeModel::Column& stringColumn,
-                                    const std::function<int(const wxVariant&, const wxVariant&)>& stringCompareFunc, 
-                                    const TreeModel::Column& isFolderCol,
-                                    const std::function<int(const wxDataViewItem&, const wxDataViewItem&)>& folderCompareFunc)
-{
-	// Check if A or B are folders
-	wxVariant aIsFolder, bIsFolder;
-	GetValue(aIsFolder, a, isFolderCol.getColumnIndex());
-	GetValue(bIsFolder, b, isFolderCol.getColumnIndex());
-
-	if (aIsFolder)
-	{
-		// A is a folder, check if B is as well
-		if (bIsFolder)
-		{
-			// A and B are both folders
-
-            // Ask the special compare function first
-            if (folderCompareFunc)
-            {
-                int customResult = folderCompareFunc(a, b);
-
-                // If the custom functor returns "equal", we continue with our algorithm
-                if (customResult != 0)
-                {
-                    return customResult < 0;
-                }
-            }
-			
-			// Compare folder names
-			// greebo: We're not checking for equality here, shader names are unique
-			wxVariant aName, bName;
-			GetValue(aName, a, stringColumn.getColumnIndex());
-			GetValue(bName, b, stringColumn.getColumnIndex());
-
-            return stringCompareFunc(aName, bName) < 0;
-		}
-		else
-		{
-			// A is a folder, B is not, A sorts before
-			return true;
-		}
-	}
-	else
-	{
-		// A is not a folder, check if B is one
-		if (bIsFolder)
-		{
-			// A is not a folder, B is, so B sorts before A
-			return false;
-		}
-		else
-		{
-			// Neither A nor B are folders, compare names
-			// greebo: We're not checking for equality here, names are unique
-			wxVariant aName, bName;
-			GetValue(aName, a, stringColumn.getColumnIndex());
-			GetValue(bName, b, stringColumn.getColumnIndex());
-
-            return stringCompareFunc(aName, bName) < 0;
-		}
-	}
-} 
 
 // Search functor which tries to find the next match for the given search string
 // is agnostic of the search direction, it just gets invoked for each row.
@@ -1044,11 +1236,11 @@ wxDataViewItem TreeModel::FindPrevString(const wxString& needle,
 
 bool TreeModel::IsEnabled(const wxDataViewItem& item, unsigned int col) const
 {
-	Node* owningNode = item.IsOk() ? static_cast<Node*>(item.GetID()) : _rootNode.get();
+	auto row = GetRowIndex(item);
 
-	if (col < owningNode->enabledFlags.size())
+	if (col < _storage->enabledFlags.size() && row < _storage->enabledFlags[col].size())
 	{
-		return owningNode->enabledFlags[col];
+		return _storage->enabledFlags[col][row];
 	}
 	
 	// Column values without flags render as enabled by default
@@ -1062,14 +1254,20 @@ void TreeModel::SetEnabled(const wxDataViewItem& item, unsigned int col, bool en
 		return;
 	}
 
-	Node* owningNode = static_cast<Node*>(item.GetID());
+	if (_storage->enabledFlags.size() < col + 1)
+	{
+		_storage->enabledFlags.resize(col + 1);
+	}
+
+	auto& column = _storage->enabledFlags[col];
+	auto row = GetRowIndex(item);
 
-	if (owningNode->enabledFlags.size() < col + 1)
+	if (column.size() < row + 1)
 	{
-		owningNode->enabledFlags.resize(col + 1, true); // fill with true by default
+		column.resize(row + 1, true); // fill with true by default
 	}
 
-	owningNode->enabledFlags[col] = enabled;
+	column[row] = enabled;
 }
 
 void TreeModel::SendSubtreeRefreshEvents(wxDataViewItem& parentItem)
@@ -363,25 +363,56 @@ public:
 
     typedef void (wxEvtHandler::*PopulationProgressFunction)(PopulationProgressEvent&);
 
+    /**
+     * Creates the children of tree items on demand, such that large trees don't
+     * need to be built completely before they can be shown.
+     *
+     * Items are marked using SetChildrenPending(), their children are added
+     * once they're requested through GetChildren(), which happens when a view
+     * is expanding the item. Rows created by a LazyChildPopulator don't send any
+     * events, the requesting view is going to pick them up.
+     */
+    class LazyChildPopulator
+    {
+    public:
+        using Ptr = std::shared_ptr<LazyChildPopulator>;
+
+        virtual ~LazyChildPopulator() {}
+
+        // Adds the children of the given item, which has been marked by this populator
+        virtual void PopulateChildren(TreeModel& model, const wxDataViewItem& item) = 0;
+
+        // Adds the pending children on the way to the element with the given value
+        // in the given column, such that FindString() can find it.
+        virtual void PopulateElement(TreeModel& model, const std::string& value, const Column& column) = 0;
+
+        // Adds the pending children on the way to all elements whose name contains
+        // the given lowercase text
+        virtual void PopulateMatches(TreeModel& model, const wxString& lowerText) = 0;
+    };
+
 protected:
-	class Node;
-	typedef std::shared_ptr<Node> NodePtr;
+	class RowStorage;
 
 	class SearchFunctor;
 
 private:
 	const ColumnRecord& _columns;
 
-	NodePtr _rootNode;
+	// All rows of this model, shared with the models referencing this one
+	std::shared_ptr<RowStorage> _storage;
 
 	int _defaultStringSortColumn;
 
 	bool _hasDefaultCompare;
 	bool _isListModel;
 
+    // All populators which have been passed to SetChildrenPending()
+    std::vector<LazyChildPopulator::Ptr> _lazyChildPopulators;
+
 protected:
 	// Constructor to be used by subclasses, allows an existing model to be referenced.
-	// The root node of the existing model will be shared by this instance.
+	// The rows of the existing model will be shared by this instance.
 	// This is not a copy constructor btw.
 	TreeModel(const TreeModel& existingModel);
 
@@ -415,10 +446,27 @@ public:
 	// This also fires the "Cleared" event to any listeners
 	void Clear();
 
+    // Marks the given item as having children which are added by the populator when
+    // they are first requested. The item must not have any children yet.
+    void SetChildrenPending(const wxDataViewItem& item, const LazyChildPopulator::Ptr& populator);
+
+    // Returns true if the children of the given item have not been created yet
+    bool HasPendingChildren(const wxDataViewItem& item) const;
+
+    // Creates the pending children of the given item, if there are any
+    void EnsureChildrenPopulated(const wxDataViewItem& item) const;
+
+    // Creates the pending items on the way to the element with the given value in the given column
+    void PopulateElement(const std::string& value, const Column& column);
+
+    // Creates the pending items on the way to all elements whose name contains the given lowercase text
+    void PopulateMatches(const wxString& lowerText);
+
 	void SetDefaultStringSortColumn(int index);
 	void SetHasDefaultCompare(bool hasDefaultCompare);
 
 	// Visit each node in the model, excluding the internal root node
+    // Pending children which have not been created yet are not visited.
 	void ForeachNode(const VisitFunction& visitFunction);
 
 	// Visit each node in the model, backwards direction, excluding the internal root node
@@ -444,6 +492,7 @@ public:
     // Pass a boolean-valued "is-a-folder" column to indicate which items are actual folders.
     // The customFolderSortFunc can be used to compare folders in a user-defined way
     // if the custom folder func returns equal (0), the regular name comparison is performed.
+    // Large trees without a custom folder func are sorted by several threads.
 	void SortModelFoldersFirst(const Column& stringColumn, const Column& isFolderColumn, 
         const FolderCompareFunction& customFolderSortFunc);
 
@@ -453,9 +502,11 @@ public:
         const Column& isFolderColumn, const FolderCompareFunction& customFolderSortFunc);
 
     // Find the given string needle in the given column (searches the entire tree)
+    // Pending items on the way to the element are created first, see PopulateElement()
 	wxDataViewItem FindString(const std::string& needle, const Column& column);
 
     // Find the given string needle in the given column (searches only the subtree given by the startNode item)
+    // Pending items on the way to the element are created first, see PopulateElement()
 	wxDataViewItem FindString(const std::string& needle, const Column& column, const wxDataViewItem& startNode);
 
     // Find the given number needle in the given column (searches the entire tree)
@@ -527,27 +578,22 @@ public:
     void SendSubtreeRefreshEvents(wxDataViewItem& parentItem);
 
 protected:
-	// Returns a reference to the actual rootnode, only allowed for use in subclasses
-	const NodePtr& getRootNode() const;
+    // Returns the index of the given item's row in the row storage, the root has the index 0
+    static std::size_t GetRowIndex(const wxDataViewItem& item);
 
-protected:
-	void ForeachNodeRecursive(const TreeModel::NodePtr& node, const VisitFunction& visitFunction);
-	void ForeachNodeRecursiveReverse(const TreeModel::NodePtr& node, const TreeModel::VisitFunction& visitFunction);
-	void SortModelRecursively(Node* node, const TreeModel::SortFunction& sortFunction);
-
-	// Sort functor for the SortModelFoldersFirst() method, uses the stringCompare method to compare the actual text values
-    // Pass CompareStringVariants or CompareIconTextVariants as stringCompare.
-	bool CompareFoldersFirst(const wxDataViewItem& a, const wxDataViewItem& b, 
-                             const Column& stringColumn,
-                             const std::function<int(const wxVariant&, const wxVariant&)>& stringCompareFunc,
-                             const Column& isFolderCol,
-                             const std::function<int(const wxDataViewItem&, const wxDataViewItem&)>& folderCompareFunc);
-
-    static int CompareStringVariants(const wxVariant& a, const wxVariant& b);
-    static int CompareIconTextVariants(const wxVariant& a, const wxVariant& b);
-
-	wxDataViewItem FindRecursive(const TreeModel::Node& node, const std::function<bool (const TreeModel::Node&)>& predicate);
-	wxDataViewItem FindRecursiveUsingRows(const TreeModel::Node& node, const std::function<bool (TreeModel::Row&)>& predicate);
+    // Returns the number of row indices in use, all indices returned by GetRowIndex() are smaller
+    std::size_t GetRowCapacity() const;
+
+    // Returns the number of changes to the rows and values since the storage has been created,
+    // such that subclasses can tell whether any information they cached is outdated
+    std::size_t GetChangeCount() const;
+
+	void ForeachNodeRecursive(std::size_t row, const VisitFunction& visitFunction);
+	void ForeachNodeRecursiveReverse(std::size_t row, const TreeModel::VisitFunction& visitFunction);
+	void SortModelRecursively(std::size_t row, const TreeModel::SortFunction& sortFunction);
+
+	wxDataViewItem FindRecursive(std::size_t row, const std::function<bool (std::size_t row)>& predicate);
+	wxDataViewItem FindRecursiveUsingRows(const wxDataViewItem& startItem, const std::function<bool (TreeModel::Row&)>& predicate);
 	int RemoveItemsRecursively(const wxDataViewItem& parent, const std::function<bool (const Row&)>& predicate);
 };
 
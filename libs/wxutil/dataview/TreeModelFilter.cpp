@@ -66,7 +66,8 @@ TreeModelFilter::TreeModelFilter(TreeModel::Ptr childModel, const Column* filter
 	TreeModel(*childModel), // reference the existing model
 	_childModel(childModel),
 	_notifier(NULL),
-	_filterColumn(NULL)
+	_filterColumn(NULL),
+	_visibilityChangeCount(0)
 {
 	_notifier = new ChildModelNotifier(this);
 	_childModel->AddNotifier(_notifier);
@@ -91,11 +92,22 @@ void TreeModelFilter::SetFilterColumn(const Column& column)
 {
 	assert(column.type == Column::Boolean);
 	_filterColumn = &column;
+
+	ClearVisibilityCache();
 }
 
 void TreeModelFilter::SetVisibleFunc(const VisibleFunc& visibleFunc)
 {
     _customVisibleFunc = visibleFunc;
+
+    ClearVisibilityCache();
+}
+
+void TreeModelFilter::ClearVisibilityCache()
+{
+    _visibilityKnown.clear();
+    _visibility.clear();
+    _visibilityChangeCount = GetChangeCount();
 }
 
 bool TreeModelFilter::ItemIsVisible(const wxDataViewItem& item) const
@@ -107,6 +119,38 @@ bool TreeModelFilter::ItemIsVisible(const wxDataViewItem& item) const
 }
 
 bool TreeModelFilter::ItemIsVisible(Row& row) const
+{
+    if (_visibilityChangeCount != GetChangeCount())
+    {
+        const_cast<TreeModelFilter*>(this)->ClearVisibilityCache();
+    }
+
+    auto index = GetRowIndex(row.getItem());
+
+    if (index < _visibilityKnown.size() && _visibilityKnown[index])
+    {
+        return _visibility[index];
+    }
+
+    auto isVisible = EvaluateItemVisibility(row);
+
+    // The visible func might have changed the model, the result is outdated then
+    if (_visibilityChangeCount == GetChangeCount())
+    {
+        if (_visibilityKnown.size() <= index)
+        {
+            _visibilityKnown.resize(GetRowCapacity(), false);
+            _visibility.resize(GetRowCapacity(), false);
+        }
+
+        _visibilityKnown[index] = true;
+        _visibility[index] = isVisible;
+    }
+
+    return isVisible;
+}
+
+bool TreeModelFilter::EvaluateItemVisibility(Row& row) const
 {
     // A custom filter logic always takes precedence over the filter column
     if (_customVisibleFunc)
@@ -136,7 +180,7 @@ void TreeModelFilter::ForeachNode(const VisitFunction& visitFunction)
 
 wxDataViewItem TreeModelFilter::FindString(const std::string& needle, int column)
 {
-	return FindRecursiveUsingRows(*getRootNode(), [&] (Row& row)->bool
+	return FindRecursiveUsingRows(wxDataViewItem(), [&] (Row& row)->bool
 	{
         if (!ItemIsVisible(row))
 		{
@@ -149,7 +193,7 @@ wxDataViewItem TreeModelFilter::FindString(const std::string& needle, int column
 
 wxDataViewItem TreeModelFilter::FindInteger(long needle, int column)
 {
-	return FindRecursiveUsingRows(*getRootNode(), [&] (Row& row)->bool
+	return FindRecursiveUsingRows(wxDataViewItem(), [&] (Row& row)->bool
 	{
         if (!ItemIsVisible(row))
 		{
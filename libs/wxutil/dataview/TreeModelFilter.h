@@ -53,6 +53,12 @@ protected:
     // Custom filter logic
     VisibleFunc _customVisibleFunc;
 
+    // The evaluated visibility of each row, indexed like the rows of the model.
+    // Any change to the rows or values is invalidating all cached results.
+    mutable std::vector<bool> _visibilityKnown;
+    mutable std::vector<bool> _visibility;
+    mutable std::size_t _visibilityChangeCount;
+
 public:
     typedef wxObjectDataPtr<TreeModelFilter> Ptr;
 
@@ -75,6 +81,10 @@ public:
 	bool ItemIsVisible(const wxDataViewItem& item) const;
     bool ItemIsVisible(Row& row) const;
 
+    // The visibility of each row is remembered until the model changes. Call this
+    // when a custom VisibleFunc is going to evaluate differently for other reasons.
+    void ClearVisibilityCache();
+
 	// We need to provide some TreeModel methods on our own, 
 	// to implement filtering
 
@@ -87,6 +97,9 @@ public:
     virtual bool IsContainer(const wxDataViewItem& item) const;
 
 	virtual unsigned int GetChildren(const wxDataViewItem& item, wxDataViewItemArray& children) const;
+
+private:
+    bool EvaluateItemVisibility(Row& row) const;
 };
 
 } // namespace
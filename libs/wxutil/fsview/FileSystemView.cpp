@@ -166,6 +166,30 @@ bool FileSystemView::GetIsFolderSelected()
     return row[Columns().isFolder].getBool();
 }
 
+std::vector<std::string> FileSystemView::GetSiblingFilePaths()
+{
+    std::vector<std::string> paths;
+
+    wxDataViewItem item = GetSelection();
+
+    if (!item.IsOk()) return paths;
+
+    wxDataViewItemArray siblings;
+    GetModel()->GetChildren(GetModel()->GetParent(item), siblings);
+
+    for (const auto& sibling : siblings)
+    {
+        wxutil::TreeModel::Row row(sibling, *GetModel());
+
+        if (row[Columns().isFolder].getBool()) continue;
+
+        std::string path = row[Columns().vfspath];
+        paths.push_back(path);
+    }
+
+    return paths;
+}
+
 std::string FileSystemView::GetArchivePathOfSelection()
 {
     wxDataViewItem item = GetSelection();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include <sigc++/signal.h>
 #include "../dataview/TreeModel.h"
 #include "../dataview/TreeView.h"
@@ -85,6 +86,10 @@ public:
     std::string GetSelectedPath();
     bool GetIsFolderSelected();
 
+    // Returns the paths of the files listed in the same folder as the selected
+    // item (including the selected file itself), in the order of the tree model
+    std::vector<std::string> GetSiblingFilePaths();
+
     // Returns the path to the archive (directory/PK4) of the selected path
     std::string GetArchivePathOfSelection();
 
@@ -57,12 +57,17 @@ void GuiRenderer::render()
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+	// The text batches are submitted as vertex arrays, set up the state once per frame
+	glEnableClientState(GL_VERTEX_ARRAY);
+
 	if (_gui != NULL)
 	{
 		// Fetch the desktop windowDef and render it
 		render(_gui->getDesktop());
 	}
 
+	glDisableClientState(GL_VERTEX_ARRAY);
+
 	glDisable(GL_BLEND);
 }
 
@@ -166,9 +171,6 @@ void GuiRenderer::render(const gui::IGuiWindowDefPtr& window, bool ignoreFilter)
 	// Render the text
 	if (!window->text.getValue().empty())
 	{
-		glEnableClientState(GL_VERTEX_ARRAY);
-		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-
 		glEnable(GL_TEXTURE_2D);
 		Vector4 forecolor = window->forecolor;
 		glColor4dv(forecolor);
@@ -182,8 +184,6 @@ void GuiRenderer::render(const gui::IGuiWindowDefPtr& window, bool ignoreFilter)
 		window->getRenderableText().render();
 
 		glDisable(GL_TEXTURE_2D);
-		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
-		glDisableClientState(GL_VERTEX_ARRAY);
 	}
 
 	// Push the translation before rendering the children, so that they
@@ -112,21 +112,37 @@ void ModelPreview::prepareScene()
         }
 
         _modelNode.reset();
+        _pendingModelNode.reset();
 
         // Emit the signal carrying an empty pointer
         _modelLoadedSignal.emit(model::ModelNodePtr());
         return;
     }
 
+    // Check if the model key is pointing to a def
+    auto modelDef = GlobalEntityClassManager().findModel(_model);
+    auto modelPath = modelDef ? modelDef->getMesh() : _model;
+
+    // Large models are parsed in the background
+    auto modelNode = GlobalModelCache().getModelNodeAsync(modelPath,
+        sigc::mem_fun(*this, &ModelPreview::onModelLoaded));
+
+    // Keep showing the previous model until the new one is ready,
+    // the placeholder is only displayed if there's nothing else
+    if (_modelNode && GlobalModelCache().isModelLoading(modelPath))
+    {
+        _pendingModelNode = modelNode;
+        return;
+    }
+
+    _pendingModelNode.reset();
+
     if (_modelNode)
     {
         getEntity()->removeChildNode(_modelNode);
     }
 
-    // Check if the model key is pointing to a def
-    auto modelDef = GlobalEntityClassManager().findModel(_model);
-
-    _modelNode = GlobalModelCache().getModelNode(modelDef ? modelDef->getMesh() : _model);
+    _modelNode = modelNode;
 
     if (_modelNode)
     {
@@ -150,6 +166,18 @@ void ModelPreview::prepareScene()
     }
 }
 
+void ModelPreview::onModelLoaded(const scene::INodePtr& placeholder)
+{
+    // Ignore the result if the model has been changed in the meantime
+    if (_modelNode != placeholder && _pendingModelNode != placeholder) return;
+
+    // Reload the model, which is cached now, and reset the view to its bounds
+    _lastModel.clear();
+
+    queueSceneUpdate();
+    queueDraw();
+}
+
 void ModelPreview::setupInitialViewPosition()
 {
     if (_lastModel != _model)
@@ -35,6 +35,10 @@ private:
     // Current model to display
     scene::INodePtr _modelNode;
 
+    // The placeholder of the model loaded in the background, while
+    // the previous model is kept on display
+    scene::INodePtr _pendingModelNode;
+
     sigc::signal<void, const model::ModelNodePtr&> _modelLoadedSignal;
     sigc::connection _skinDeclChangedConn;
 
@@ -77,6 +81,9 @@ protected:
     void applySkin();
     void onSkinDeclarationChanged();
     void setupInitialViewPosition() override;
+
+private:
+    void onModelLoaded(const scene::INodePtr& placeholder);
 };
 
 } // namespace
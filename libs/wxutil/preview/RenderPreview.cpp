@@ -49,7 +49,7 @@ RenderPreview::RenderPreview(wxWindow* parent, bool enableAnimation) :
     _initialised(false),
 	_renderGrid(registry::getValue<bool>(RKEY_RENDERPREVIEW_SHOWGRID)),
     _enableLightingModeAtStart(false),
-    _renderSystem(GlobalRenderSystemFactory().createRenderSystem()),
+    _renderSystem(GlobalRenderSystemFactory().acquirePreviewRenderSystem()),
     _viewOrigin(0, 0, 0),
     _viewAngles(0, 0, 0),
     _modelView(Matrix4::getIdentity()),
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+namespace xml
+{
+
+// Exception to indicate that a document could not be parsed
+class ParseException :
+    public std::runtime_error
+{
+public:
+    ParseException(const std::string& what) :
+        std::runtime_error(what)
+    {}
+};
+
+}
@@ -0,0 +1,147 @@
+#include "StreamReader.h"
+
+#include <libxml/xmlreader.h>
+
+namespace xml
+{
+
+StreamReader::StreamReader(std::istream& stream) :
+    _stream(stream),
+    _reader(xmlReaderForIO(&StreamReader::ReadCallback, nullptr, this, "stream", nullptr, XML_PARSE_NOBLANKS)),
+    _nodeOwner(static_cast<xmlDocPtr>(nullptr))
+{
+    if (_reader == nullptr)
+    {
+        throw std::runtime_error("Failed to create the XML reader");
+    }
+}
+
+StreamReader::~StreamReader()
+{
+    xmlFreeTextReader(_reader);
+}
+
+bool StreamReader::readTopLevelElement()
+{
+    while (read())
+    {
+        if (xmlTextReaderNodeType(_reader) == XML_READER_TYPE_ELEMENT)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::string StreamReader::getName() const
+{
+    auto name = xmlTextReaderConstName(_reader);
+
+    return name != nullptr ? std::string(reinterpret_cast<const char*>(name)) : std::string();
+}
+
+std::string StreamReader::getAttributeValue(const std::string& key) const
+{
+    auto value = xmlTextReaderGetAttribute(_reader, reinterpret_cast<const xmlChar*>(key.c_str()));
+
+    if (value == nullptr)
+    {
+        return {};
+    }
+
+    std::string result(reinterpret_cast<const char*>(value));
+    xmlFree(value);
+
+    return result;
+}
+
+Node StreamReader::expand()
+{
+    auto node = xmlTextReaderExpand(_reader);
+
+    if (node == nullptr)
+    {
+        throw ParseException("Failed to parse the XML element " + getName());
+    }
+
+    return Node(&_nodeOwner, node);
+}
+
+void StreamReader::foreachChildElement(const std::function<void()>& functor)
+{
+    if (xmlTextReaderIsEmptyElement(_reader) == 1)
+    {
+        return;
+    }
+
+    auto parentDepth = xmlTextReaderDepth(_reader);
+
+    if (!read())
+    {
+        return;
+    }
+
+    // Stop once we reached the closing tag of the parent element
+    while (xmlTextReaderDepth(_reader) > parentDepth)
+    {
+        if (xmlTextReaderNodeType(_reader) == XML_READER_TYPE_ELEMENT &&
+            xmlTextReaderDepth(_reader) == parentDepth + 1)
+        {
+            functor();
+
+            // Skip whatever the functor didn't process
+            if (!next())
+            {
+                return;
+            }
+
+            continue;
+        }
+
+        if (!read())
+        {
+            return;
+        }
+    }
+}
+
+bool StreamReader::read()
+{
+    auto result = xmlTextReaderRead(_reader);
+
+    if (result < 0)
+    {
+        throw ParseException("Failed to parse the XML document");
+    }
+
+    return result == 1;
+}
+
+bool StreamReader::next()
+{
+    auto result = xmlTextReaderNext(_reader);
+
+    if (result < 0)
+    {
+        throw ParseException("Failed to parse the XML document");
+    }
+
+    return result == 1;
+}
+
+int StreamReader::ReadCallback(void* context, char* buffer, int length)
+{
+    auto& stream = static_cast<StreamReader*>(context)->_stream;
+
+    if (stream.bad())
+    {
+        return -1;
+    }
+
+    stream.read(buffer, length);
+
+    return static_cast<int>(stream.gcount());
+}
+
+}
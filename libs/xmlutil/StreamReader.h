@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Document.h"
+#include "ParseException.h"
+
+#include <functional>
+#include <istream>
+#include <string>
+
+// Forward declaration to avoid including the whole libxml2 headers
+typedef struct _xmlTextReader xmlTextReader;
+typedef xmlTextReader *xmlTextReaderPtr;
+
+namespace xml
+{
+
+/**
+ * Pull-style XML reader wrapping the libxml2 xmlTextReader, reading the
+ * document from the given stream while it is traversed. Only the subtrees
+ * explicitly expanded by the client are built in memory, they are released
+ * once the reader moves past them.
+ *
+ * Parser errors are reported by throwing xml::ParseException.
+ */
+class StreamReader
+{
+private:
+    std::istream& _stream;
+    xmlTextReaderPtr _reader;
+
+    // Doesn't hold any xmlDoc, it's only owning the lock used by the expanded nodes
+    Document _nodeOwner;
+
+public:
+    StreamReader(std::istream& stream);
+    ~StreamReader();
+
+    StreamReader(const StreamReader& other) = delete;
+    StreamReader& operator=(const StreamReader& other) = delete;
+
+    // Moves to the top level element, returns false if there is none
+    bool readTopLevelElement();
+
+    // Name of the element the reader is positioned on
+    std::string getName() const;
+
+    // Returns the value of the given attribute of the current element,
+    // or an empty string if the attribute is not present
+    std::string getAttributeValue(const std::string& key) const;
+
+    // Builds the subtree of the current element and returns it. The node
+    // is valid until the reader is moving past the current element.
+    Node expand();
+
+    // Invokes the given function for each child element of the current element,
+    // with the reader positioned on the child. The function can expand the child
+    // or descend into it by calling foreachChildElement() again, the rest of
+    // the child's subtree is skipped afterwards.
+    void foreachChildElement(const std::function<void()>& functor);
+
+private:
+    // Advances to the next node, returns false at the end of the document
+    bool read();
+
+    // Advances to the node following the current one, skipping its subtree
+    bool next();
+
+    static int ReadCallback(void* context, char* buffer, int length);
+};
+
+}
@@ -6,6 +6,7 @@
 #include "ieclass.h"
 #include "ui/imainframe.h"
 #include "iscenegraph.h"
+#include "imap.h"
 #include "string/string.h"
 
 #include "wxutil/dataview/TreeModel.h"
@@ -173,8 +174,8 @@ void ConversationDialog::populateWidgets()
 	// First clear the data
 	clear();
 
-	// Use an ConversationEntityFinder to walk the map and add any conversation
-	// entities to the liststore and entity map
+	// Use a ConversationEntityFinder to look up any conversation
+	// entities and add them to the liststore and entity map
 	conversation::ConversationEntityFinder finder(
 		_entityList,
 		_convEntityColumns,
@@ -182,7 +183,10 @@ void ConversationDialog::populateWidgets()
 		CONVERSATION_ENTITY_CLASS
 	);
 
-	GlobalSceneGraph().root()->traverseChildren(finder);
+	if (auto root = GlobalMapModule().getRoot(); root)
+	{
+		finder.findEntities(*root);
+	}
 
 	updateConversationPanelSensitivity();
 }
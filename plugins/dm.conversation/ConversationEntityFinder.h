@@ -1,6 +1,8 @@
 #pragma once
 
 #include "i18n.h"
+#include "ientity.h"
+#include "imap.h"
 #include <string>
 
 #include "ConversationEntity.h"
@@ -9,18 +11,15 @@ namespace conversation
 {
 
 /**
- * Visitor class to locate and list any <b>atdm:conversation_info</b> entities in
+ * Helper class to locate and list any <b>atdm:conversation_info</b> entities in
  * the current map.
  *
- * The ConversationEntityFinder will visit each scenegraph node in turn, as per the
- * behaviour of a scenegraph walker. The classname of each entity visited is
- * tested against a given value (passed in during construction) which identifies
- * it as a Conversation entity, and if the test is successful, the entity's
- * details are added to the target ConversationEntityMap and TreeModel objects
- * to be populated.
+ * The ConversationEntityFinder queries the entity class index of the map root
+ * for the entities of the class identifying a Conversation entity (passed in
+ * during construction), the details of each entity are added to the target
+ * ConversationEntityMap and TreeModel objects to be populated.
  */
-class ConversationEntityFinder :
-	public scene::NodeVisitor
+class ConversationEntityFinder
 {
 	// Name of entity class we are looking for
 	std::string _className;
@@ -63,19 +62,17 @@ public:
 	{}
 
 	/**
-	 * NodeVisitor implementation
+	 * Looks up the conversation entities in the given map.
 	 */
-	bool pre(const scene::INodePtr& node)
+	void findEntities(scene::IMapRootNode& root)
 	{
-		// Get the entity and check the classname
-		Entity* entity = Node_getEntity(node);
-
-		// Check for conversation entity or worldspawn
-		if (entity != NULL && entity->getKeyValue("classname") == _className)
+		root.getEntityClassIndex().foreachEntityOfClass(_className, [&](const IEntityNodePtr& node)
 		{
+			Entity& entity = node->getEntity();
+
 			// Construct the display string
-			std::string name = entity->getKeyValue("name");
-			std::string sDisplay = fmt::format(_("{0} at [ {1} ]"), name, entity->getKeyValue("origin"));
+			std::string name = entity.getKeyValue("name");
+			std::string sDisplay = fmt::format(_("{0} at [ {1} ]"), name, entity.getKeyValue("origin"));
 
 			// Add the entity to the list
 			wxutil::TreeModel::Row row = _store->AddItem();
@@ -85,12 +82,10 @@ public:
 
 			row.SendItemAdded();
 
-			// Construct an ObjectiveEntity with the node, and add to the map
+			// Construct a ConversationEntity with the node, and add to the map
 			ConversationEntityPtr ce(new ConversationEntity(node));
 			_map.insert(ConversationEntityMap::value_type(name, ce));
-		}
-
-		return true;
+		});
 	}
 
 };
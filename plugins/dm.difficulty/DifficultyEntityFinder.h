@@ -1,13 +1,13 @@
 #pragma once
 
 #include "ientity.h"
+#include "imap.h"
 #include "gamelib.h"
 #include "DifficultySettings.h"
 
 namespace difficulty {
 
-class DifficultyEntityFinder :
-	public scene::NodeVisitor
+class DifficultyEntityFinder
 {
 public:
 	// Found difficulty entities are stored in this list
@@ -30,22 +30,12 @@ public:
 		return _foundEntities;
 	}
 
-	// Walker implementation
-	bool pre(const scene::INodePtr& node) {
-		// Check if we have an entity
-		Entity* entity = Node_getEntity(node);
-
-		if (entity != NULL) {
-			// Check for a classname match
-			if (entity->getKeyValue("classname") == _entityClassName) {
-				_foundEntities.push_back(entity);
-			}
-
-			// Don't traverse the children of entities
-			return false;
-		}
-
-		return true;
+	// Looks up the difficulty entities in the entity class index of the given map
+	void findEntities(scene::IMapRootNode& root) {
+		root.getEntityClassIndex().foreachEntityOfClass(_entityClassName, [&](const IEntityNodePtr& node)
+		{
+			_foundEntities.push_back(&node->getEntity());
+		});
 	}
 };
 
@@ -54,9 +54,13 @@ void DifficultySettingsManager::loadDefaultSettings() {
 
 void DifficultySettingsManager::loadMapSettings()
 {
-    // Construct a helper walker
+    // Construct a helper to look up the entities
     DifficultyEntityFinder finder;
-    GlobalSceneGraph().root()->traverse(finder);
+
+    if (auto root = GlobalMapModule().getRoot(); root)
+    {
+        finder.findEntities(*root);
+    }
 
     const DifficultyEntityFinder::EntityList& found = finder.getEntities();
 
@@ -194,7 +198,11 @@ void DifficultySettingsManager::saveSettings()
 {
     // Locates all difficulty entities
     DifficultyEntityFinder finder;
-    GlobalSceneGraph().root()->traverse(finder);
+
+    if (auto root = GlobalMapModule().getRoot(); root)
+    {
+        finder.findEntities(*root);
+    }
 
     // Copy the list from the finder to a local list
     DifficultyEntityFinder::EntityList entities = finder.getEntities();
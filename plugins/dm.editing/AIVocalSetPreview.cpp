@@ -92,6 +92,23 @@ std::string AIVocalSetPreview::getRandomSoundFile()
 
 	SoundFileList files = soundShader->getSoundFileList();
 
+	// Prefer the files the index knows to be present, unless nothing is indexed yet
+	SoundFileList indexedFiles;
+	SoundFileInfo info;
+
+	for (const auto& file : files)
+	{
+		if (GlobalSoundManager().findIndexedSoundFile(file, info))
+		{
+			indexedFiles.push_back(info.resolvedPath);
+		}
+	}
+
+	if (!indexedFiles.empty())
+	{
+		files.swap(indexedFiles);
+	}
+
 	if (files.empty()) return "";
 
 	std::size_t fileIdx = static_cast<std::size_t>(rand()) % files.size();
@@ -66,21 +66,25 @@ public:
 		{
 			const scene::INodePtr& ent = e->first;
 			const KeyList& keys = e->second;
+			bool changeClassname = false;
 
-			for (KeyList::const_iterator i = keys.begin();
-				 i != keys.end(); ++i)
 			{
-				// We have a match, check which key is affected
-				if (*i == "classname")
-				{
-					// Classname change
-					changeEntityClassname(ent, _newVal);
-					_eclassCount++;
-				}
-				else
+				Entity* entity = Node_getEntity(ent);
+				assert(entity != NULL);
+
+				// Notify the entity's observers once, after all keys are replaced
+				EntityBatchUpdate batch(*entity);
+
+				for (KeyList::const_iterator i = keys.begin();
+					 i != keys.end(); ++i)
 				{
-					Entity* entity = Node_getEntity(ent);
-					assert(entity != NULL);
+					// We have a match, check which key is affected
+					if (*i == "classname")
+					{
+						// Classname changes replace the entity, do it last
+						changeClassname = true;
+						continue;
+					}
 
 					entity->setKeyValue(*i, _newVal);
 
@@ -94,6 +98,12 @@ public:
 					}
 				}
 			}
+
+			if (changeClassname)
+			{
+				changeEntityClassname(ent, _newVal);
+				_eclassCount++;
+			}
 		}
 
 		_entityMap.clear();
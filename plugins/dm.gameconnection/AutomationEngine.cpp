@@ -63,6 +63,10 @@ bool AutomationEngine::connect()
         return false;
     }
 
+    //requests are small and each one is waited for:
+    //don't let Nagle's algorithm hold them back
+    connection->DisableNagleAlgoritm();
+
     _connection.reset(new MessageTcp());
     _connection->init(std::move(connection));
     if (!_connection->isAlive())
@@ -238,6 +242,16 @@ bool AutomationEngine::areTagsInProgress(int tagMask)
     return false;
 }
 
+int AutomationEngine::countRequestsInProgress(int tagMask) const
+{
+    int count = 0;
+    for (int i = 0; i < _requests.size(); i++)
+        if (tagMask & (1 << _requests[i]._tag))
+            if (!_requests[i]._finished)
+                count++;
+    return count;
+}
+
 void AutomationEngine::wait(const std::vector<int>& reqSeqnos, const std::vector<int>& procIds)
 {
     while (areInProgress(reqSeqnos, procIds)) {
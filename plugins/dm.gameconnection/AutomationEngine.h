@@ -91,6 +91,8 @@ public:
     // Return true iff any request or multistep procedure matching the given mask is not finished yet.
     // Note: tagMask is a bitmask, so pass (1<<tag) in order to wait for one tag only.
     bool areTagsInProgress(int tagMask = TAGMASK_ALL);
+    // Returns the number of requests matching the given mask which are not finished yet.
+    int countRequestsInProgress(int tagMask = TAGMASK_ALL) const;
     // Wait for all active requests and multistep procedures matching the given mask to finish.
     // Throws DisconnectException if it cannot be done due to lost connection.
     void waitForTags(int tagMask = TAGMASK_ALL);
@@ -36,6 +36,10 @@ namespace
 {
     //this is how often this class "thinks" when idle
     constexpr int THINK_INTERVAL = 123;
+    //think interval while camera updates are pending or in flight (about the display refresh rate)
+    constexpr int CAMERA_THINK_INTERVAL = 16;
+    //how many camera updates may be sent to game without waiting for their responses
+    constexpr int MAX_CAMERA_REQUESTS_IN_FLIGHT = 3;
 
     //all ordinary requests, executed synchronously
     constexpr int TAG_GENERIC = 5;
@@ -43,6 +47,8 @@ namespace
     constexpr int TAG_CAMERA = 6;
     //multistep procedure for TDM game start/restart
     constexpr int TAG_RESTART = 7;
+    //map diffs for hot reload, sent asynchronously one at a time
+    constexpr int TAG_UPDATEMAP = 8;
 
     inline std::string messagePreamble(const std::string& type) {
         return fmt::format("message \"{}\"\n", type);
@@ -70,8 +76,8 @@ std::string GameConnection::executeGenericRequest(const std::string& request)
 
 bool GameConnection::sendAnyPendingAsync()
 {
-    if (_mapObserver.getChanges().size() && _updateMapAlways) {
-        //note: this is blocking
+    if (_mapObserver.getChanges().size() && (_updateMapAlways || _mapUpdateRequested)) {
+        _mapUpdateRequested = false;
         doUpdateMap();
         return true;
     }
@@ -99,6 +105,16 @@ void GameConnection::think()
         //think now, don't delay to next frame
         _engine->think();
     }
+    else if (!_engine->areTagsInProgress(~(1 << TAG_CAMERA)) &&
+        _engine->countRequestsInProgress(1 << TAG_CAMERA) < MAX_CAMERA_REQUESTS_IN_FLIGHT)
+    {
+        //only camera updates are in flight: pipeline the latest camera position behind them
+        if (sendPendingCameraUpdate()) {
+            _engine->think();
+        }
+    }
+
+    updateThinkInterval();
 }
 
 void GameConnection::onTimerEvent(wxTimerEvent& ev)
@@ -123,6 +139,19 @@ void GameConnection::setThinkLoop(bool enable)
     }
 }
 
+void GameConnection::updateThinkInterval()
+{
+    if (!_thinkTimer) return;
+
+    //camera responses and pipelined updates should not wait for the idle timer
+    bool cameraBusy = _cameraOutPending || _engine->areTagsInProgress(1 << TAG_CAMERA);
+    int interval = cameraBusy ? CAMERA_THINK_INTERVAL : THINK_INTERVAL;
+
+    if (_thinkTimer->GetInterval() != interval) {
+        _thinkTimer->Start(interval);
+    }
+}
+
 bool GameConnection::isAlive() const
 {
     return _engine->isAlive();
@@ -160,6 +189,11 @@ void GameConnection::disconnect(bool force)
     _engine->disconnect(force);
     assert(!_engine->isAlive() && !_engine->hasLostConnection());
 
+    //responses to dropped requests will never arrive
+    _mapUpdateSeqno = 0;
+    _mapUpdateRequested = false;
+    _mapUpdateChanges.clear();
+
     setThinkLoop(false);
     _mapEventListener.disconnect();
 
@@ -728,10 +762,11 @@ std::string saveMapDiff(const DiffEntityStatuses& entityStatuses)
 {
     auto root = GlobalSceneGraph().root();
 
-    std::set<scene::INode*> subsetNodes;
+    //collect the changed entities in scene order
+    std::vector<scene::INodePtr> changedEntities;
     root->foreachNode([&](const scene::INodePtr& node) {
         if (entityStatuses.count(node->name()))
-            subsetNodes.insert(node.get());
+            changedEntities.push_back(node);
         return true;
     });
 
@@ -761,8 +796,14 @@ std::string saveMapDiff(const DiffEntityStatuses& entityStatuses)
 
         try
         {
-            // Pass the traversal function and the root of the subgraph to export
-            exporter->exportMap(root, scene::traverseSubset(subsetNodes));
+            // The diff consists of spawnargs only: visit the changed entities
+            // without descending into their primitives, which would be ignored anyway
+            exporter->exportMap(root, [&](const scene::INodePtr&, scene::NodeVisitor& visitor) {
+                for (const auto& node : changedEntities) {
+                    visitor.pre(node);
+                    visitor.post(node);
+                }
+            });
             // end the life of the exporter instance here to finish the scene
             exporter.reset();
         }
@@ -781,17 +822,34 @@ void GameConnection::doUpdateMap()
         if (!_engine->isAlive())
             return; //no connection, don't even try
 
+        if (_mapUpdateSeqno != 0) {
+            //previous diff is not applied yet: send the changes made meanwhile right after it
+            _mapUpdateRequested = true;
+            return;
+        }
+
         // Get map diff
         std::string diff = saveMapDiff(_mapObserver.getChanges());
         if (diff.empty()) {
             return; //TODO: fail
         }
 
-        std::string response = executeGenericRequest(actionPreamble("reloadmap-diff") + "content:\n" + diff);
-        if (response.find("HotReload: SUCCESS") != std::string::npos) {
-            //success: clear current diff, so that we don't reapply it next time
-            _mapObserver.clear();
-        }
+        //changes made from now on go into the next diff
+        _mapUpdateChanges = _mapObserver.takeChanges();
+
+        //don't block: the game applies the diff while the user goes on editing
+        _mapUpdateSeqno = _engine->executeRequestAsync(TAG_UPDATEMAP,
+            actionPreamble("reloadmap-diff") + "content:\n" + diff,
+            [this](int seqno) {
+                std::string response = _engine->getResponse(seqno);
+                if (response.find("HotReload: SUCCESS") == std::string::npos && _mapObserver.isEnabled()) {
+                    //failure: keep these changes for the next diff
+                    _mapObserver.restoreChanges(_mapUpdateChanges);
+                }
+                _mapUpdateChanges.clear();
+                _mapUpdateSeqno = 0;
+            }
+        );
     }
     catch (const DisconnectException&) {
         //disconnected: will be handled during next think
@@ -71,6 +71,8 @@ public:
     // All changes a) since last successful call of this method,
     // or b) since the observer was enabled; are sent as a diff.
     // The game applies the diff on top of its current map state and hot reloads entities.
+    // The diff is sent without waiting for the answer. If the previous diff is not answered yet,
+    // the changes are sent as soon as it is.
     void doUpdateMap();
     // Enable/disable mode: doUpdateMap after every entity change.
     // Note: the update is postponed to next think, so that mass changes go as one diff.
@@ -122,6 +124,12 @@ private:
     bool _autoReloadMap = false;
     // True when "setAlwaysUpdateMapEnabled" is enabled.
     bool _updateMapAlways = false;
+    // Seqno of the map diff request sent to game but not answered yet (0 if none).
+    int _mapUpdateSeqno = 0;
+    // The changes included in the map diff which is not answered yet.
+    DiffEntityStatuses _mapUpdateChanges;
+    // True if doUpdateMap was called while the previous diff was not answered yet.
+    bool _mapUpdateRequested = false;
 
     // True when restartGame procedure is executed.
     bool _restartInProgress = false;
@@ -137,6 +145,8 @@ private:
 
     // Enable/disable timer calling think method regularly.
     void setThinkLoop(bool enable);
+    // Speed up the think loop while camera updates are being sent, slow it down when idle.
+    void updateThinkInterval();
     // Callback for _thinkTimer.
     void onTimerEvent(wxTimerEvent& ev);
     // Check how socket is doing, accept responses and send pending async requests.
@@ -164,4 +164,20 @@ const DiffEntityStatuses& MapObserver::getChanges() const {
     return _entityChanges;
 }
 
+DiffEntityStatuses MapObserver::takeChanges() {
+    DiffEntityStatuses changes;
+    changes.swap(_entityChanges);
+    return changes;
+}
+
+void MapObserver::restoreChanges(const DiffEntityStatuses& earlierChanges) {
+    for (const auto& pNS : earlierChanges) {
+        auto later = _entityChanges.find(pNS.first);
+        if (later == _entityChanges.end())
+            _entityChanges.insert(pNS);
+        else
+            later->second = pNS.second.combine(later->second);
+    }
+}
+
 }
@@ -31,6 +31,14 @@ public:
     //returns pending entity change since last clear (or since enabled)
     const DiffEntityStatuses& getChanges() const;
 
+    //moves the pending changes out, e.g. when sending them to game
+    //(clears list of pending changes)
+    DiffEntityStatuses takeChanges();
+
+    //puts changes taken earlier back, combined with the changes made after them
+    //(e.g. if game failed to apply them)
+    void restoreChanges(const DiffEntityStatuses& earlierChanges);
+
 private:
     //receives events about entity changes
     void entityUpdated(const std::string& name, const DiffStatus& diff);
@@ -1,5 +1,6 @@
 #include "Gui.h"
 #include "itextstream.h"
+#include "string/convert.h"
 
 namespace gui
 {
@@ -43,38 +44,30 @@ GuiPtr Gui::createFromTokens(parser::DefTokeniser& tokeniser)
 
 void Gui::setStateString(const std::string& key, const std::string& value)
 {
-	_state[key] = value;
+	auto& variable = _state[key];
 
-	// Handle state variable links to windowDef registers
-	GuiStateChangedSignals::iterator i = _stateSignals.find(key);
+	variable.value.string = value;
+	variable.value.number = string::convert<float>(value);
 
-	if (i != _stateSignals.end())
-	{
-		i->second.emit();
-	}
+	// Handle state variable links to windowDef registers
+	variable.changed.emit();
 }
 
 sigc::signal<void>& Gui::getChangedSignalForState(const std::string& key)
 {
-	GuiStateChangedSignals::iterator i = _stateSignals.find(key);
-
-	if (i != _stateSignals.end())
-	{
-		return i->second;
-	}
-
-	// Insert a new signal
-	std::pair<GuiStateChangedSignals::iterator, bool> result =
-		_stateSignals.insert(std::make_pair(key, sigc::signal<void>()));
-
-	return result.first->second;
+	return _state[key].changed;
 }
 
 std::string Gui::getStateString(const std::string& key)
 {
 	GuiState::const_iterator i = _state.find(key);
 
-	return (i != _state.end()) ? i->second : "";
+	return (i != _state.end()) ? i->second.value.string : "";
+}
+
+const GuiStateValue& Gui::getStateValue(const std::string& key)
+{
+	return _state[key].value;
 }
 
 void Gui::initTime(const std::size_t time)
@@ -28,13 +28,16 @@ private:
 	// The desktop window
 	IGuiWindowDefPtr _desktop;
 
-	// The global GUI state variables
-	typedef std::unordered_map<std::string, std::string> GuiState;
+	// The global GUI state variables, the nodes are never removed such that
+	// references to the values (held by compiled expressions) stay valid
+	struct StateVariable
+	{
+		GuiStateValue value;
+		sigc::signal<void> changed;
+	};
+	typedef std::unordered_map<std::string, StateVariable> GuiState;
 	GuiState _state;
 
-	typedef std::unordered_map<std::string, sigc::signal<void>> GuiStateChangedSignals;
-	GuiStateChangedSignals _stateSignals;
-
 public:
 	const IGuiWindowDefPtr& getDesktop() const override;
 	void setDesktop(const IGuiWindowDefPtr& newDesktop) override;
@@ -48,6 +51,8 @@ public:
 	// Returns the state string "gui::<key>" or an empty string if non-existent
 	std::string getStateString(const std::string& key) override;
 
+	const GuiStateValue& getStateValue(const std::string& key) override;
+
 	// Sets up the time of the entire GUI (all windowDefs)
 	void initTime(const std::size_t time) override;
 
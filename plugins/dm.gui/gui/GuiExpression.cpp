@@ -16,7 +16,8 @@ namespace gui
 // An expression referring to a GUI state variable
 GuiStateVariableExpression::GuiStateVariableExpression(IGui& gui, const std::string& variableName) :
 	_gui(gui),
-	_variableName(variableName)
+	_variableName(variableName),
+	_value(gui.getStateValue(variableName))
 {
 	if (!_variableName.empty())
 	{
@@ -30,12 +31,101 @@ GuiStateVariableExpression::GuiStateVariableExpression(IGui& gui, const std::str
 
 float GuiStateVariableExpression::getFloatValue()
 {
-	return string::convert<float>(_gui.getStateString(_variableName));
+	return _value.number;
 }
 
 std::string GuiStateVariableExpression::getStringValue()
 {
-	return _gui.getStateString(_variableName);
+	return _value.string;
+}
+
+bool GuiStateVariableExpression::compile(GuiExpressionProgram& program)
+{
+	program.addVariable(_value);
+	return true;
+}
+
+void GuiExpressionProgram::addConstant(float value)
+{
+	_instructions.push_back(Instruction{ OpCode::Constant, value, nullptr });
+
+	if (++_depth > _stack.size())
+	{
+		_stack.resize(_depth);
+	}
+}
+
+void GuiExpressionProgram::addVariable(const GuiStateValue& variable)
+{
+	_instructions.push_back(Instruction{ OpCode::Variable, 0, &variable });
+
+	if (++_depth > _stack.size())
+	{
+		_stack.resize(_depth);
+	}
+}
+
+void GuiExpressionProgram::addOperator(OpCode opCode)
+{
+	assert(opCode != OpCode::Constant && opCode != OpCode::Variable);
+	assert(_depth >= (opCode == OpCode::LogicalNot ? 1 : 2));
+
+	_instructions.push_back(Instruction{ opCode, 0, nullptr });
+
+	if (opCode != OpCode::LogicalNot)
+	{
+		--_depth;
+	}
+}
+
+float GuiExpressionProgram::evaluate() const
+{
+	if (_instructions.empty()) return 0;
+
+	float* stack = _stack.data();
+	std::size_t top = 0;
+
+	for (const auto& instruction : _instructions)
+	{
+		// Binary operators combine the two topmost values into one
+		switch (instruction.opCode)
+		{
+		case OpCode::Constant:
+			stack[top++] = instruction.constant;
+			continue;
+		case OpCode::Variable:
+			stack[top++] = instruction.variable->number;
+			continue;
+		case OpCode::LogicalNot:
+			stack[top - 1] = stack[top - 1] == 0.0f ? 1.0f : 0.0f;
+			continue;
+		default:
+			break;
+		}
+
+		float b = stack[--top];
+		float& a = stack[top - 1];
+
+		switch (instruction.opCode)
+		{
+		case OpCode::Add: a = a + b; break;
+		case OpCode::Subtract: a = a - b; break;
+		case OpCode::Multiply: a = a * b; break;
+		case OpCode::Divide: a = a / b; break;
+		case OpCode::Modulo: a = fmod(a, b); break;
+		case OpCode::LesserThan: a = a < b ? 1.0f : 0; break;
+		case OpCode::LesserThanOrEqual: a = a <= b ? 1.0f : 0; break;
+		case OpCode::GreaterThan: a = a > b ? 1.0f : 0; break;
+		case OpCode::GreaterThanOrEqual: a = a >= b ? 1.0f : 0; break;
+		case OpCode::Equal: a = a == b ? 1.0f : 0; break;
+		case OpCode::NotEqual: a = a != b ? 1.0f : 0; break;
+		case OpCode::LogicalAnd: a = (a != 0 && b != 0) ? 1.0f : 0; break;
+		case OpCode::LogicalOr: a = (a != 0 || b != 0) ? 1.0f : 0; break;
+		default: break;
+		}
+	}
+
+	return stack[0];
 }
 
 namespace detail
@@ -66,18 +156,20 @@ protected:
 	GuiExpressionPtr _a;
 	GuiExpressionPtr _b;
 	Precedence _precedence;
+	GuiExpressionProgram::OpCode _opCode;
 
 	sigc::connection _aChanged;
 	sigc::connection _bChanged;
 
 public:
-	BinaryExpression(Precedence precedence,
+	BinaryExpression(Precedence precedence, GuiExpressionProgram::OpCode opCode,
 		const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
 		GuiExpression(),
 		_a(a),
 		_b(b),
-		_precedence(precedence)
+		_precedence(precedence),
+		_opCode(opCode)
 	{
 		if (_a)
 		{
@@ -137,6 +229,16 @@ public:
 	{
 		return string::to_string(getFloatValue());
 	}
+
+	bool compile(GuiExpressionProgram& program) override
+	{
+		if (!_a || !_a->compile(program)) return false;
+
+		if (_b && !_b->compile(program)) return false;
+
+		program.addOperator(_opCode);
+		return true;
+	}
 };
 typedef std::shared_ptr<BinaryExpression> BinaryExpressionPtr;
 
@@ -147,7 +249,7 @@ class AddExpression :
 public:
 	AddExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(ADDITION, a, b)
+		BinaryExpression(ADDITION, GuiExpressionProgram::OpCode::Add, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -163,7 +265,7 @@ class SubtractExpression :
 public:
 	SubtractExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(SUBTRACTION, a, b)
+		BinaryExpression(SUBTRACTION, GuiExpressionProgram::OpCode::Subtract, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -179,7 +281,7 @@ class MultiplyExpression :
 public:
 	MultiplyExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(MULTIPLICATION, a, b)
+		BinaryExpression(MULTIPLICATION, GuiExpressionProgram::OpCode::Multiply, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -195,7 +297,7 @@ class DivideExpression :
 public:
 	DivideExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(DIVISION, a, b)
+		BinaryExpression(DIVISION, GuiExpressionProgram::OpCode::Divide, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -211,7 +313,7 @@ class ModuloExpression :
 public:
 	ModuloExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(MODULO, a, b)
+		BinaryExpression(MODULO, GuiExpressionProgram::OpCode::Modulo, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -227,7 +329,7 @@ class LesserThanExpression :
 public:
 	LesserThanExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(RELATIONAL_COMPARISON, a, b)
+		BinaryExpression(RELATIONAL_COMPARISON, GuiExpressionProgram::OpCode::LesserThan, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -243,7 +345,7 @@ class LesserThanOrEqualExpression :
 public:
 	LesserThanOrEqualExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(RELATIONAL_COMPARISON, a, b)
+		BinaryExpression(RELATIONAL_COMPARISON, GuiExpressionProgram::OpCode::LesserThanOrEqual, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -259,7 +361,7 @@ class GreaterThanExpression :
 public:
 	GreaterThanExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(RELATIONAL_COMPARISON, a, b)
+		BinaryExpression(RELATIONAL_COMPARISON, GuiExpressionProgram::OpCode::GreaterThan, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -275,7 +377,7 @@ class GreaterThanOrEqualExpression :
 public:
 	GreaterThanOrEqualExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(RELATIONAL_COMPARISON, a, b)
+		BinaryExpression(RELATIONAL_COMPARISON, GuiExpressionProgram::OpCode::GreaterThanOrEqual, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -291,7 +393,7 @@ class EqualityExpression :
 public:
 	EqualityExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(EQUALITY_COMPARISON, a, b)
+		BinaryExpression(EQUALITY_COMPARISON, GuiExpressionProgram::OpCode::Equal, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -307,7 +409,7 @@ class InequalityExpression :
 public:
 	InequalityExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(EQUALITY_COMPARISON, a, b)
+		BinaryExpression(EQUALITY_COMPARISON, GuiExpressionProgram::OpCode::NotEqual, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -325,17 +427,42 @@ private:
 
 public:
 	LogicalNotExpression(const GuiExpressionPtr& contained = GuiExpressionPtr()) :
-		BinaryExpression(LOGICAL_NOT, contained)
+		BinaryExpression(LOGICAL_NOT, GuiExpressionProgram::OpCode::LogicalNot, contained)
 	{}
 
 	virtual float getFloatValue() override
 	{
-		return _a->getFloatValue() != 0.0f ? 1.0f : 0.0f;
+		return _a->getFloatValue() == 0.0f ? 1.0f : 0.0f;
+	}
+};
+
+// A numeric expression tree compiled into a flat program, the tree is kept for change notifications
+class CompiledExpression :
+	public GuiExpression
+{
+private:
+	GuiExpressionPtr _source;
+	GuiExpressionProgram _program;
+
+public:
+	CompiledExpression(const GuiExpressionPtr& source, GuiExpressionProgram&& program) :
+		_source(source),
+		_program(std::move(program))
+	{
+		_source->signal_valueChanged().connect([this]()
+		{
+			signal_valueChanged().emit();
+		});
+	}
+
+	virtual float getFloatValue() override
+	{
+		return _program.evaluate();
 	}
 
 	virtual std::string getStringValue() override
 	{
-		return ""; // not implemented for string values
+		return string::to_string(getFloatValue());
 	}
 };
 
@@ -346,7 +473,7 @@ class LogicalAndExpression :
 public:
 	LogicalAndExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(LOGICAL_AND, a, b)
+		BinaryExpression(LOGICAL_AND, GuiExpressionProgram::OpCode::LogicalAnd, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -362,7 +489,7 @@ class LogicalOrExpression :
 public:
 	LogicalOrExpression(const GuiExpressionPtr& a = GuiExpressionPtr(),
 		const GuiExpressionPtr& b = GuiExpressionPtr()) :
-		BinaryExpression(LOGICAL_OR, a, b)
+		BinaryExpression(LOGICAL_OR, GuiExpressionProgram::OpCode::LogicalOr, a, b)
 	{}
 
 	virtual float getFloatValue() override
@@ -773,7 +900,21 @@ GuiExpressionPtr GuiExpression::CreateFromTokens(IGui& gui, parser::DefTokeniser
 	try
 	{
 		detail::GuiExpressionParser parser(gui, adapter);
-		return parser.getExpression();
+		auto expression = parser.getExpression();
+
+		// Formulas are evaluated through a flat program, constants and plain
+		// state variables are cheap enough to be evaluated directly
+		if (std::dynamic_pointer_cast<detail::BinaryExpression>(expression))
+		{
+			GuiExpressionProgram program;
+
+			if (expression->compile(program))
+			{
+				return std::make_shared<detail::CompiledExpression>(expression, std::move(program));
+			}
+		}
+
+		return expression;
 	}
 	catch (parser::ParseException& ex)
 	{
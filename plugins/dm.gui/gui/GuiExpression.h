@@ -2,6 +2,7 @@
 
 #include "igui.h"
 #include <memory>
+#include <vector>
 #include "string/convert.h"
 #include <parser/DefTokeniser.h>
 
@@ -11,6 +12,57 @@ namespace gui
 class GuiExpression;
 typedef std::shared_ptr<GuiExpression> GuiExpressionPtr;
 
+/**
+ * Flat representation of a numeric expression tree. The instructions are stored
+ * in postfix order and operate on a small value stack, state variables are
+ * referenced by their storage, such that evaluation doesn't need any virtual
+ * calls or name lookups.
+ */
+class GuiExpressionProgram
+{
+public:
+	enum class OpCode
+	{
+		Constant,
+		Variable,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Modulo,
+		LesserThan,
+		LesserThanOrEqual,
+		GreaterThan,
+		GreaterThanOrEqual,
+		Equal,
+		NotEqual,
+		LogicalNot,
+		LogicalAnd,
+		LogicalOr,
+	};
+
+private:
+	struct Instruction
+	{
+		OpCode opCode;
+		float constant;
+		const GuiStateValue* variable;
+	};
+	std::vector<Instruction> _instructions;
+
+	std::size_t _depth = 0;
+	mutable std::vector<float> _stack;
+
+public:
+	void addConstant(float value);
+	void addVariable(const GuiStateValue& variable);
+
+	// Adds an operator, consuming the topmost one (LogicalNot) or two values of the stack
+	void addOperator(OpCode opCode);
+
+	float evaluate() const;
+};
+
 // Represents a right-hand expression found in the GUI code, which can be 
 // a simple float, a string, a gui variable or a complex formula.
 class GuiExpression
@@ -24,6 +76,13 @@ public:
 	virtual float getFloatValue() = 0;
 	virtual std::string getStringValue() = 0;
 
+	// Appends the instructions calculating the float value of this expression,
+	// returns false if this expression cannot be compiled
+	virtual bool compile(GuiExpressionProgram& program)
+	{
+		return false;
+	}
+
 	// Sub-expressions or clients can subscribe to get notified about changes
 	sigc::signal<void>& signal_valueChanged()
 	{
@@ -32,6 +91,7 @@ public:
 
 	static GuiExpressionPtr CreateFromString(IGui& gui, const std::string& exprStr);
 
+	// Parses the expression, numeric formulas are compiled into a GuiExpressionProgram
 	static GuiExpressionPtr CreateFromTokens(IGui& gui, parser::DefTokeniser& tokeniser);
 };
 
@@ -54,6 +114,12 @@ public:
 	{
 		return string::to_string(getFloatValue());
 	}
+
+	bool compile(GuiExpressionProgram& program) override
+	{
+		program.addConstant(getFloatValue());
+		return true;
+	}
 };
 
 // An expression representing a constant string value
@@ -75,6 +141,12 @@ public:
 	{
 		return this->evaluate();
 	}
+
+	bool compile(GuiExpressionProgram& program) override
+	{
+		program.addConstant(getFloatValue());
+		return true;
+	}
 };
 
 // Adapter class converting a generic GuiExpression to a IGuiExpression of a given type
@@ -116,6 +188,43 @@ public:
 	}
 };
 
+// Float specialisation, making use of the contained getFloatValue()
+// which avoids converting numeric expressions to strings and back
+template<>
+class TypedExpression<float> :
+	public IGuiExpression<float>
+{
+private:
+	GuiExpressionPtr _contained;
+
+	sigc::signal<void> _sigValueChanged;
+
+public:
+	TypedExpression(const GuiExpressionPtr& contained) :
+		_contained(contained)
+	{
+		if (_contained)
+		{
+			// Connect the changed signal of the contained expression
+			// to fire our own signal
+			_contained->signal_valueChanged().connect([this]()
+			{
+				signal_valueChanged().emit();
+			});
+		}
+	}
+
+	virtual float evaluate() override
+	{
+		return _contained->getFloatValue();
+	}
+
+	sigc::signal<void>& signal_valueChanged() override
+	{
+		return _sigValueChanged;
+	}
+};
+
 // Boolean specialisation, making use of the contained getFloatValue()
 // casting it to a bool (which is true if the float value is not 0.0f).
 template<>
@@ -202,12 +311,17 @@ class GuiStateVariableExpression :
 private:
 	IGui& _gui;
 	std::string _variableName;
+
+	// The storage of the state variable, resolved on construction
+	const GuiStateValue& _value;
 	
 public:
 	GuiStateVariableExpression(IGui& gui, const std::string& variableName);
 
 	virtual float getFloatValue() override;
 	virtual std::string getStringValue() override;
+
+	bool compile(GuiExpressionProgram& program) override;
 };
 
 }
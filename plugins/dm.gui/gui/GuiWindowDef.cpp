@@ -63,7 +63,13 @@ GuiWindowDef::GuiWindowDef(IGui& owner) :
 	time = 0;
 
 	_textChanged = true;
-	text.signal_variableChanged().connect([this]() { _textChanged = true; });
+
+	// The text layout depends on these variables, it's re-generated on demand
+	for (auto variable : std::initializer_list<IWindowVariable*>{ &text, &rect, &font,
+		&textscale, &textalign, &textalignx, &textaligny, &nowrap })
+	{
+		variable->signal_variableChanged().connect([this]() { _textChanged = true; });
+	}
 
 	// Clear the shader if the background variable changes
 	background.signal_variableChanged().connect([this]() { backgroundShader.reset(); });
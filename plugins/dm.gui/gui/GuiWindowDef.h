@@ -34,7 +34,7 @@ private:
 	// The renderable text object for submission to a Renderer
 	RenderableText _renderableText;
 
-	// Is set to true when the text property is assigned
+	// Is set to true when the text or any of the layout properties are assigned
 	bool _textChanged;
 
 	// The mapping between time and GUI scripts
@@ -1,6 +1,8 @@
 #include "RenderableCharacterBatch.h"
 
+#include <algorithm>
 #include "render.h"
+#include "ishaders.h"
 #include "debugging/gl.h"
 
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
@@ -25,17 +27,60 @@ RenderableCharacterBatch::~RenderableCharacterBatch()
 #endif
 }
 
+void RenderableCharacterBatch::clear()
+{
+	_pages.clear();
+	_verts.clear();
+}
+
+bool RenderableCharacterBatch::empty() const
+{
+	return _verts.empty();
+}
+
 void RenderableCharacterBatch::addGlyph(const TextChar& ch)
 {
-	_verts.push_back(ch.coords[0]);
-	_verts.push_back(ch.coords[1]);
-	_verts.push_back(ch.coords[2]);
-	_verts.push_back(ch.coords[3]);
+	// Fonts are using very few pages, a linear search is fine
+	auto page = std::find_if(_pages.begin(), _pages.end(),
+		[&](const Page& candidate) { return candidate.shader == ch.glyph->shader; });
+
+	if (page == _pages.end())
+	{
+		_pages.emplace_back();
+		_pages.back().shader = ch.glyph->shader;
+		page = _pages.end() - 1;
+	}
+
+	page->verts.insert(page->verts.end(), ch.coords, ch.coords + 4);
 }
 
 void RenderableCharacterBatch::compile()
 {
+	std::size_t numVertices = 0;
+
+	for (const auto& page : _pages)
+	{
+		numVertices += page.verts.size();
+	}
+
+	// Merge the pages into one contiguous buffer
+	_verts.clear();
+	_verts.reserve(numVertices);
+
+	for (auto& page : _pages)
+	{
+		page.firstVertex = _verts.size();
+		page.numVertices = page.verts.size();
+
+		_verts.insert(_verts.end(), page.verts.begin(), page.verts.end());
+
+		// The staging vertices are no longer needed
+		Vertices().swap(page.verts);
+	}
+
 #ifdef RENDERABLE_CHARACTER_BATCH_USE_VBO
+	if (_verts.empty()) return;
+
 	// Space needed for geometry
 	std::size_t dataSize = sizeof(Vertex2D) * _verts.size();
 
@@ -60,31 +105,37 @@ void RenderableCharacterBatch::compile()
 
 void RenderableCharacterBatch::render() const
 {
+	if (_verts.empty()) return;
+
 #ifdef RENDERABLE_CHARACTER_BATCH_USE_VBO
-	// Bind the VBO buffer and submit the draw call
+	// Bind the VBO buffer, the pointers are set up once for all pages
 	glBindBuffer(GL_ARRAY_BUFFER, _vboData);
 
 	glClientActiveTexture(GL_TEXTURE0);
-    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glTexCoordPointer(2, GL_DOUBLE, sizeof(Vertex2D), BUFFER_OFFSET(sizeof(double)*2));
 	glVertexPointer(2, GL_DOUBLE, sizeof(Vertex2D), BUFFER_OFFSET(0));
-
-	glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_verts.size()));
-
-	debug::assertNoGlErrors();
-
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
 #else
 	// Regular array draw call
 	glVertexPointer(2, GL_DOUBLE, sizeof(Vertex2D), &(_verts.front().vertex));
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 	glTexCoordPointer(2, GL_DOUBLE, sizeof(Vertex2D), &(_verts.front().texcoord));
+#endif
+
+	for (const auto& page : _pages)
+	{
+		// Switch to the texture of this page
+		glBindTexture(GL_TEXTURE_2D, page.shader->getMaterial()->getEditorImage()->getGLTexNum());
 
-	glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(_verts.size()));
+		glDrawArrays(GL_QUADS, static_cast<GLint>(page.firstVertex), static_cast<GLsizei>(page.numVertices));
+	}
 
 	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
 	debug::assertNoGlErrors();
+
+#ifdef RENDERABLE_CHARACTER_BATCH_USE_VBO
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
 #endif
 }
 
@@ -4,6 +4,7 @@
 #include "igl.h"
 #include "irender.h"
 #include <memory>
+#include <vector>
 
 #include "TextParts.h"
 
@@ -14,14 +15,28 @@ namespace gui
 {
 
 /**
- * A container holding the render information of a bunch of characters,
- * all referencing the same font texture. The geometry of the characters
- * is arranged into a vertex buffer object on compile().
+ * A container holding the render information of a bunch of characters.
+ * The glyphs are grouped by the font page (texture) they're referencing,
+ * on compile() all pages are merged into a single vertex buffer, such that
+ * rendering needs one array setup and one draw call per font page.
  */
 class RenderableCharacterBatch
 {
 private:
-	// The local vertex buffer
+	// A range of the vertex buffer sharing the same font texture
+	struct Page
+	{
+		ShaderPtr shader;
+
+		// Glyph vertices collected before compile()
+		std::vector<Vertex2D> verts;
+
+		std::size_t firstVertex = 0;
+		std::size_t numVertices = 0;
+	};
+	std::vector<Page> _pages;
+
+	// The local vertex buffer, holding all pages
 	typedef std::vector<Vertex2D> Vertices;
 	Vertices _verts;
 
@@ -35,11 +50,17 @@ public:
 
 	~RenderableCharacterBatch();
 
+	// Removes all glyphs, compile() needs to be called again afterwards
+	void clear();
+
+	bool empty() const;
+
 	// Add a single glyph to this batch
 	void addGlyph(const TextChar& ch);
 
 	void compile();
 
+	// Binds the font textures and submits the geometry
 	void render() const;
 };
 typedef std::shared_ptr<RenderableCharacterBatch> RenderableCharacterBatchPtr;
@@ -6,6 +6,7 @@
 #include "math/Matrix4.h"
 #include <vector>
 #include <list>
+#include <unordered_map>
 #include "gamelib.h"
 #include "string/split.h"
 
@@ -20,10 +21,91 @@ namespace gui
 	{
 		const std::string GKEY_SMALLFONT_LIMIT("/defaults/guiSmallFontLimit");
 		const std::string GKEY_MEDIUMFONT_LIMIT("/defaults/guiMediumFontLimit");
+
+		// Cache of shaped words shared by all windowDefs, since labels and
+		// common words tend to be repeated all over a GUI
+		class ShapedWordCache
+		{
+		private:
+			static constexpr std::size_t MaxWords = 4096;
+
+			struct Key
+			{
+				const fonts::IGlyphSet* glyphSet;
+				float fontScale;
+				std::string word;
+
+				bool operator==(const Key& other) const
+				{
+					return glyphSet == other.glyphSet && fontScale == other.fontScale && word == other.word;
+				}
+			};
+
+			struct KeyHash
+			{
+				std::size_t operator()(const Key& key) const
+				{
+					return std::hash<std::string>()(key.word) ^
+						(std::hash<const void*>()(key.glyphSet) << 1) ^
+						(std::hash<float>()(key.fontScale) << 2);
+				}
+			};
+
+			struct Entry
+			{
+				// Used to detect glyph sets which have been re-allocated at the same address
+				std::weak_ptr<fonts::IGlyphSet> glyphSet;
+				TextWord word;
+			};
+
+			std::unordered_map<Key, Entry, KeyHash> _words;
+
+		public:
+			// Returns the word positioned at 0,0, the reference is valid until the next call
+			const TextWord& get(const std::string& word, const fonts::IGlyphSetPtr& glyphSet, float fontScale)
+			{
+				Key key{ glyphSet.get(), fontScale, word };
+
+				auto found = _words.find(key);
+
+				if (found != _words.end() && !found->second.glyphSet.expired())
+				{
+					return found->second.word;
+				}
+
+				if (_words.size() >= MaxWords)
+				{
+					_words.clear();
+				}
+
+				auto& entry = _words[key];
+
+				entry.glyphSet = glyphSet;
+				entry.word = TextWord::createForString(word, *glyphSet, fontScale);
+
+				return entry.word;
+			}
+		};
+
+		ShapedWordCache& GetShapedWordCache()
+		{
+			static ShapedWordCache _cache;
+			return _cache;
+		}
 	}
 
+bool RenderableText::LayoutProperties::operator==(const LayoutProperties& other) const
+{
+	return text == other.text && rect == other.rect && font == other.font &&
+		textscale == other.textscale && textalign == other.textalign &&
+		textalignx == other.textalignx && textaligny == other.textaligny &&
+		nowrap == other.nowrap;
+}
+
 RenderableText::RenderableText(const IGuiWindowDef& owner) :
-	_owner(owner)
+	_owner(owner),
+	_layoutValid(false),
+	_fontTextScale(0)
 {}
 
 void RenderableText::printMissingGlyphSetError() const
@@ -69,26 +151,42 @@ void RenderableText::realiseFontShaders()
 
 void RenderableText::render()
 {
-	// Add each renderable character batch to the collector
-	for (CharBatches::const_iterator i = _charBatches.begin(); i != _charBatches.end(); ++i)
-	{
-		// Switch to this shader
-		glBindTexture(GL_TEXTURE_2D, i->first->getMaterial()->getEditorImage()->getGLTexNum());
-
-		// Submit geometry
-		i->second->render();
-	}
+	// Submit geometry, one draw call per font page
+	_charBatch.render();
 }
 
 void RenderableText::recompile()
 {
-	_charBatches.clear();
+	LayoutProperties layout;
+
+	layout.text = _owner.text;
+	layout.rect = _owner.rect;
+	layout.font = _owner.font;
+	layout.textscale = _owner.textscale;
+	layout.textalign = _owner.textalign;
+	layout.textalignx = _owner.textalignx;
+	layout.textaligny = _owner.textaligny;
+	layout.nowrap = _owner.nowrap;
+
+	// Variables are often re-assigned the same value (like the readable editor
+	// setting all pages on every keystroke), keep the current layout in that case
+	if (_layoutValid && layout == _layout) return;
+
+	_layout = std::move(layout);
+	_layoutValid = true;
+
+	layoutText();
+}
+
+void RenderableText::layoutText()
+{
+	_charBatch.clear();
 
 	ensureFont();
 
 	if (_font == NULL) return; // Rendering not possible
 
-	std::string text = _owner.text;
+	const std::string& text = _layout.text;
 
 	typedef std::vector<TextLinePtr> TextLines;
 	TextLines lines;
@@ -107,18 +205,18 @@ void RenderableText::recompile()
 	fonts::IGlyphSet& glyphSet = *gsp;
 
 	// Calculate the final scale of the glyphs
-	float scale = _owner.textscale * glyphSet.getGlyphScale();
+	float scale = _layout.textscale * glyphSet.getGlyphScale();
 
 	// We need the maximum glyph height of the highest resolution font to calculate the line width
 	std::size_t maxGlyphHeight = _font->getGlyphSet(fonts::Resolution48)->getMaxGlyphHeight();
 
 	// Calculate the line height, this is usually max glyph height + 5 pixels
-	double lineHeight = lrint(_owner.textscale * maxGlyphHeight + 5);
+	double lineHeight = lrint(_layout.textscale * maxGlyphHeight + 5);
 
 	// The distance from the top of the rectangle to the baseline
-	double startingBaseLine = lrint(_owner.textscale * maxGlyphHeight + 2) + _owner.textaligny;
+	double startingBaseLine = lrint(_layout.textscale * maxGlyphHeight + 2) + _layout.textaligny;
 
-	Vector4 ownerRec = _owner.rect.getValue();
+	Vector4 ownerRec = _layout.rect;
 
 	for (std::size_t p = 0; p < paragraphs.size(); ++p)
 	{
@@ -134,12 +232,12 @@ void RenderableText::recompile()
 		string::split(words, paragraphs[p], " \t", false);
 
 		// Add the words to lines
-		TextLinePtr curLine(new TextLine(ownerRec[2] - 2 - _owner.textalignx, scale));
+		TextLinePtr curLine(new TextLine(ownerRec[2] - 2 - _layout.textalignx, scale));
 
 		while (!words.empty())
 		{
 			// If nowrap set to true, force words into this line
-			bool added = curLine->addWord(words.front(), glyphSet, _owner.nowrap);
+			bool added = curLine->addWord(GetShapedWordCache().get(words.front(), gsp, scale), _layout.nowrap);
 
 			if (added)
 			{
@@ -193,7 +291,7 @@ void RenderableText::recompile()
 
 			// Line finished, consider alignment and vertical offset
 			curLine->offset(Vector2(
-				getAlignmentCorrection(curLine->getWidth()) + _owner.textalignx, // horizontal correction
+				getAlignmentCorrection(curLine->getWidth()) + _layout.textalignx, // horizontal correction
 				lineHeight * lines.size() + startingBaseLine // vertical correction
 			));
 
@@ -209,7 +307,7 @@ void RenderableText::recompile()
 			// Allocate a new line, but only if we have any more words in this paragraph
 			if (!words.empty())
 			{
-				curLine = TextLinePtr(new TextLine(ownerRec[2] - 2 - _owner.textalignx, scale));
+				curLine = TextLinePtr(new TextLine(ownerRec[2] - 2 - _layout.textalignx, scale));
 			}
 		}
 
@@ -221,7 +319,7 @@ void RenderableText::recompile()
 			// Add that line we started, even if it's an empty one
 			curLine->offset(
 				Vector2(
-					getAlignmentCorrection(curLine->getWidth()) + _owner.textalignx,
+					getAlignmentCorrection(curLine->getWidth()) + _layout.textalignx,
 					lineHeight * lines.size() +  + startingBaseLine
 				)
 			);
@@ -230,7 +328,7 @@ void RenderableText::recompile()
 		}
 	}
 
-	// Now sort the aligned characters into separate renderables, one per shader
+	// Now sort the aligned characters into the font pages of the batch
 	for (TextLines::const_iterator line = lines.begin(); line != lines.end(); ++line)
 	{
 		// Move the lines into our GUI rectangle
@@ -239,35 +337,19 @@ void RenderableText::recompile()
 		for (TextLine::Chars::const_iterator c = (*line)->getChars().begin();
 			 c != (*line)->getChars().end(); ++c)
 		{
-			CharBatches::iterator batch = _charBatches.find(c->glyph->shader);
-
-			if (batch == _charBatches.end())
-			{
-				RenderableCharacterBatchPtr b(new RenderableCharacterBatch);
-
-				std::pair<CharBatches::iterator, bool> result = _charBatches.insert(
-					CharBatches::value_type(c->glyph->shader, b)
-				);
-
-				batch = result.first;
-			}
-
-			batch->second->addGlyph(*c);
+			_charBatch.addGlyph(*c);
 		}
 	}
 
-	// Compile the vertex buffer objects
-	for (CharBatches::iterator i = _charBatches.begin(); i != _charBatches.end(); ++i)
-	{
-		i->second->compile();
-	}
+	// Merge the pages into one vertex buffer
+	_charBatch.compile();
 }
 
 double RenderableText::getAlignmentCorrection(double lineWidth)
 {
 	double xoffset = 0;
 
-	switch (_owner.textalign)
+	switch (_layout.textalign)
 	{
 	case 0: // left
 		// Somehow D3 adds a 2 pixel offset to the left (see idSimpleWindow::CalcClientRect)
@@ -275,10 +357,10 @@ double RenderableText::getAlignmentCorrection(double lineWidth)
 		break;
 	case 1: // center
 		// Somehow D3 adds a 1 pixel offset to the left
-		xoffset = 1 + (_owner.rect.getValue()[2] - lineWidth) / 2;
+		xoffset = 1 + (_layout.rect[2] - lineWidth) / 2;
 		break;
 	case 2: // right
-		xoffset = _owner.rect.getValue()[2] - 2 - lineWidth;
+		xoffset = _layout.rect[2] - 2 - lineWidth;
 		break;
 	};
 
@@ -287,29 +369,38 @@ double RenderableText::getAlignmentCorrection(double lineWidth)
 
 void RenderableText::ensureFont()
 {
-	if (_owner.font.getValue().empty()) return; // no font specified
+	// Choose the font again if the name or the scale have been changed
+	if (_layout.font != _fontName || _layout.textscale != _fontTextScale)
+	{
+		_font.reset();
+	}
+
+	if (_layout.font.empty()) return; // no font specified
 
 	if (_font != NULL) return; // already realised
 
+	_fontName = _layout.font;
+	_fontTextScale = _layout.textscale;
+
 	// Cut off the "fonts/" part
-	std::string font = _owner.font;
+	std::string font = _layout.font;
 	string::replace_first(font, "fonts/", "");
 
 	_font = GlobalFontManager().findFontInfo(font);
 
 	if (_font == NULL)
 	{
-		rWarning() << "Cannot find font " << _owner.font.getValue()
+		rWarning() << "Cannot find font " << _layout.font
 			<< " in windowDef " << _owner.name << std::endl;
 		return;
 	}
 
 	// Determine resolution
-	if (_owner.textscale <= game::current::getValue<float>(GKEY_SMALLFONT_LIMIT))
+	if (_layout.textscale <= game::current::getValue<float>(GKEY_SMALLFONT_LIMIT))
 	{
 		_resolution = fonts::Resolution12;
 	}
-	else if (_owner.textscale <= game::current::getValue<float>(GKEY_MEDIUMFONT_LIMIT))
+	else if (_layout.textscale <= game::current::getValue<float>(GKEY_MEDIUMFONT_LIMIT))
 	{
 		_resolution = fonts::Resolution24;
 	}
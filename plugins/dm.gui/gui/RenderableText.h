@@ -3,7 +3,6 @@
 #include "igui.h"
 #include "irenderable.h"
 #include "ifonts.h"
-#include <map>
 #include "RenderableCharacterBatch.h"
 
 namespace gui
@@ -17,12 +16,30 @@ class RenderableText :
 	// The owning windowDef
 	const IGuiWindowDef& _owner;
 
-	// The character soup, arranged into OpenGLRenderables, sorted by shader
-	typedef std::map<ShaderPtr, RenderableCharacterBatchPtr> CharBatches;
-	CharBatches _charBatches;
+	// The character soup, merged into one buffer, grouped by font page
+	RenderableCharacterBatch _charBatch;
 
-	// The font we're rendering
+	// The windowDef properties the current layout has been generated from
+	struct LayoutProperties
+	{
+		std::string text;
+		Vector4 rect;
+		std::string font;
+		float textscale = 0;
+		int textalign = 0;
+		float textalignx = 0;
+		float textaligny = 0;
+		bool nowrap = false;
+
+		bool operator==(const LayoutProperties& other) const;
+	};
+	LayoutProperties _layout;
+	bool _layoutValid;
+
+	// The font we're rendering, and the properties it has been chosen for
 	fonts::IFontInfoPtr _font;
+	std::string _fontName;
+	float _fontTextScale;
 
 	// The resolution we're working with
 	fonts::Resolution _resolution;
@@ -36,12 +53,15 @@ public:
 
 	void render() override;
 
-	// Re-construct this structure, called when the text in the owning windowDef has been changed
+	// Re-construct this structure, called when the text or the layout properties
+	// of the owning windowDef have been changed. Does nothing if the evaluated
+	// properties are still the same as the ones of the current layout.
 	void recompile() override;
 
 private:
 	void realiseFontShaders();
 	void ensureFont();
+	void layoutText();
 
 	// Calculates the horizontal alignment correction for the given line width
 	// relative to the (default) left-aligned state
@@ -156,8 +156,41 @@ public:
 	bool addWord(const std::string& word, fonts::IGlyphSet& glyphs, bool noclip = false)
 	{
 		// Generate the word
-		TextWord tw = TextWord::createForString(word, glyphs, _fontScale);
-		return addWord(tw, noclip);
+		return addWord(TextWord::createForString(word, glyphs, _fontScale), noclip);
+	}
+
+	// Add an already shaped word (positioned at 0,0) to this line
+	// returns TRUE on success, FALSE if the word is too wide to fit in this line
+	bool addWord(TextWord word, bool noclip = false)
+	{
+		// Check the word length
+		double remainingWidth = _lineWidth - _charWidth;
+		double wordWidth = word.getWidth();
+
+		// stgatilov: bug compatibility against Doom 3 engine
+		// it ignores the last character when checking whether a word fits the line
+		// see also: #5914 and https://forums.thedarkmod.com/index.php?/topic/21710-implicit-linebreaks-in-text/
+		double wordWidthFit = wordWidth;
+		if (!word.empty())
+		{
+			wordWidthFit -= word.back().getWidth();
+		}
+
+		if (!noclip && wordWidthFit > remainingWidth + 1e-3)
+		{
+			return false;
+		}
+
+		// Move the word to the current position
+		word.offset(Vector2(_charWidth, 0));
+
+		// Append the characters to our own vector
+		_chars.insert(_chars.end(), word.begin(), word.end());
+
+		// Increase horizontal position
+		_charWidth += wordWidth;
+
+		return true;
 	}
 
 	// Adds a single character to this sentence
@@ -214,38 +247,6 @@ private:
 
 		return true;
 	}
-
-	bool addWord(TextWord& word, bool noclip)
-	{
-		// Check the word length
-		double remainingWidth = _lineWidth - _charWidth;
-		double wordWidth = word.getWidth();
-
-		// stgatilov: bug compatibility against Doom 3 engine
-		// it ignores the last character when checking whether a word fits the line
-		// see also: #5914 and https://forums.thedarkmod.com/index.php?/topic/21710-implicit-linebreaks-in-text/
-		double wordWidthFit = wordWidth;
-		if (!word.empty())
-		{
-			wordWidthFit -= word.back().getWidth();
-		}
-
-		if (!noclip && wordWidthFit > remainingWidth + 1e-3)
-		{
-			return false;
-		}
-
-		// Move the word to the current position
-		word.offset(Vector2(_charWidth, 0));
-
-		// Append the characters to our own vector
-		_chars.insert(_chars.end(), word.begin(), word.end());
-
-		// Increase horizontal position
-		_charWidth += wordWidth;
-
-		return true;
-	}
 };
 typedef std::shared_ptr<TextLine> TextLinePtr;
 
@@ -1,56 +1,52 @@
 #include "ObjectiveEntityFinder.h"
 
 #include "ientity.h"
+#include "imap.h"
 
 namespace objectives
 {
 
-bool ObjectiveEntityFinder::pre(const scene::INodePtr& node)
+void ObjectiveEntityFinder::findEntities(scene::IMapRootNode& root)
 {
-    // Get the entity and check the classname
-    Entity* ePtr = Node_getEntity(node);
-    if (!ePtr)
-        return true;
+    auto& index = root.getEntityClassIndex();
 
-    // We have an entity at this point
-
-    if (ePtr->isWorldspawn())
+    index.foreachEntityOfClass("worldspawn", [&](const IEntityNodePtr& node)
     {
-        _worldSpawn = ePtr;
-        return false; // Don't traverse worldspawn children
-    }
+        if (_worldSpawn == nullptr)
+        {
+            _worldSpawn = &node->getEntity();
+        }
+    });
 
-    // Check for objective entity or worldspawn
-    for (std::vector<std::string>::iterator i = _classNames.begin();
-         i != _classNames.end();
-         ++i)
+    // Look up the entities of each objective entity class
+    for (const auto& className : _classNames)
     {
-        if (ePtr->getKeyValue("classname") == *i)
+        index.foreachEntityOfClass(className, [&](const IEntityNodePtr& node)
         {
-            // Construct the display string
-            std::string name = ePtr->getKeyValue("name");
+            addObjectiveEntity(node);
+        });
+    }
+}
 
-            // Add the entity to the list
-            wxutil::TreeModel::Row row = _store->AddItem();
+void ObjectiveEntityFinder::addObjectiveEntity(const IEntityNodePtr& node)
+{
+    auto& entity = node->getEntity();
 
-            row[_columns.displayName] = fmt::format(_("{0} at [ {1} ]"), name, ePtr->getKeyValue("origin"));
-            row[_columns.entityName] = name;
-            row[_columns.startActive] = false;
+    // Construct the display string
+    std::string name = entity.getKeyValue("name");
 
-			row.SendItemAdded();
+    // Add the entity to the list
+    wxutil::TreeModel::Row row = _store->AddItem();
 
-            // Construct an ObjectiveEntity with the node, and add to the map
-            ObjectiveEntityPtr oe(new ObjectiveEntity(node));
-            _map.insert(ObjectiveEntityMap::value_type(name, oe));
+    row[_columns.displayName] = fmt::format(_("{0} at [ {1} ]"), name, entity.getKeyValue("origin"));
+    row[_columns.entityName] = name;
+    row[_columns.startActive] = false;
 
-            break;
-        }
-    }
+    row.SendItemAdded();
 
-    return false; // don't traverse entity children
+    // Construct an ObjectiveEntity with the node, and add to the map
+    ObjectiveEntityPtr oe(new ObjectiveEntity(node));
+    _map.insert(ObjectiveEntityMap::value_type(name, oe));
 }
 
 }
-
-
-
@@ -3,6 +3,8 @@
 #include "ObjectiveEntity.h"
 
 #include "i18n.h"
+#include "ientity.h"
+#include "imap.h"
 
 #include <string>
 #include <fmt/format.h>
@@ -26,22 +28,19 @@ struct ObjectiveEntityListColumns :
 };
 
 /**
- * Visitor class to locate and list any <b>atdm:target_addobjectives</b> entities in
+ * Helper class to locate and list any <b>atdm:target_addobjectives</b> entities in
  * the current map.
  *
- * The ObjectiveEntityFinder will visit each scenegraph node in turn, as per the
- * behaviour of a scenegraph walker. The classname of each entity visited is
- * tested against a given value (passed in during construction) which identifies
- * it as an Objectives entity, and if the test is successful, the entity's
- * details are added to the target ObjectiveEntityMap and GtkListStore objects
- * to be populated.
+ * The ObjectiveEntityFinder queries the entity class index of the map root for
+ * the entities of the classes identifying an Objectives entity (passed in during
+ * construction), the details of each entity are added to the target
+ * ObjectiveEntityMap and GtkListStore objects to be populated.
  *
  * The ObjectiveEntityFinder also keeps a reference to the worldspawn entity so
  * that the "activate at start" status can be determined (the worldspawn targets
  * any objective entities that should be active at start).
  */
 class ObjectiveEntityFinder
-: public scene::NodeVisitor
 {
 	// List of names of entity class we are looking for
 	std::vector<std::string> _classNames;
@@ -99,10 +98,12 @@ public:
 	}
 
 	/**
-	 * @see scene::NodeVisitor::pre()
+	 * Looks up the worldspawn and the objective entities in the given map.
 	 */
-	bool pre(const scene::INodePtr& node);
+	void findEntities(scene::IMapRootNode& root);
 
+private:
+	void addObjectiveEntity(const IEntityNodePtr& node);
 };
 
 }
@@ -10,6 +10,7 @@
 
 #include "i18n.h"
 #include "iscenegraph.h"
+#include "imap.h"
 #include "ui/imainframe.h"
 #include "iregistry.h"
 #include "ieclass.h"
@@ -184,12 +185,16 @@ void ObjectivesEditor::populateWidgets()
 	// Clear internal data first
 	clear();
 
-	// Use an ObjectiveEntityFinder to walk the map and add any objective
-	// entities to the liststore and entity map
+	// Use an ObjectiveEntityFinder to look up any objective
+	// entities and add them to the liststore and entity map
 	ObjectiveEntityFinder finder(
         _objectiveEntityList, _objEntityColumns, _entities, _objectiveEClasses
     );
-	GlobalSceneGraph().root()->traverse(finder);
+
+    if (auto root = GlobalMapModule().getRoot(); root)
+    {
+        finder.findEntities(*root);
+    }
 
     // Select the first entity in the list for convenience
     wxDataViewItemArray children;
@@ -4,6 +4,7 @@
 #include "string/string.h"
 #include "wxutil/dataview/TreeModel.h"
 #include "entitylib.h"
+#include "imap.h"
 #include "registry/registry.h"
 #include "SREntity.h"
 #include "gamelib.h"
@@ -32,13 +33,22 @@ namespace {
 	/* greebo: Finds an entity with the given classname
 	 */
 	Entity* findEntityByClass(const std::string& className) {
-		// Instantiate a walker to find the entity
-		EntityNodeFindByClassnameWalker walker(className);
+		auto root = GlobalMapModule().getRoot();
 
-		// Walk the scenegraph
-		GlobalSceneGraph().root()->traverse(walker);
+		if (!root) return nullptr;
 
-		return walker.getEntity();
+		// Look up the first entity of this class in the map's index
+		Entity* found = nullptr;
+
+		root->getEntityClassIndex().foreachEntityOfClass(className, [&](const IEntityNodePtr& node)
+		{
+			if (found == nullptr)
+			{
+				found = &node->getEntity();
+			}
+		});
+
+		return found;
 	}
 
 	// Helper visitor class to remove custom stim definitions from
@@ -0,0 +1,376 @@
+#include "BackgroundScript.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <pybind11/eval.h>
+
+#include "itextstream.h"
+#include "iradiant.h"
+#include "iundo.h"
+#include "ui/iuserinterface.h"
+#include "messages/LongRunningOperationMessage.h"
+
+namespace script
+{
+
+namespace
+{
+    // The main thread is serving calls up to this amount of time before returning to the event loop
+    constexpr std::chrono::milliseconds ServingTimeSlice(25);
+
+    // Replaces the interface objects in the script's globals by proxies passing their calls
+    // to _callOnMainThread. Results are wrapped in proxies too, except for the value types.
+    const char* const MainThreadProxyCode = R"(
+import operator as _operator
+
+_mainThreadValueTypes = ('Vector2', 'Vector3', 'Vector4', 'AABB', 'FloatArray', 'IndexArray')
+
+def _isMainThreadObject(value):
+    valueType = type(value)
+    return not isinstance(value, type) and getattr(valueType, '__module__', None) == 'darkradiant' \
+        and valueType.__name__ not in _mainThreadValueTypes
+
+def _wrapResult(value):
+    if isinstance(value, list):
+        return [_wrapResult(v) for v in value]
+    if isinstance(value, tuple):
+        return tuple(_wrapResult(v) for v in value)
+    if _isMainThreadObject(value):
+        return _MainThreadProxy(value)
+    return value
+
+def _unwrapArgument(value):
+    if isinstance(value, _MainThreadProxy):
+        return value._target
+    if isinstance(value, list):
+        return [_unwrapArgument(v) for v in value]
+    if isinstance(value, tuple):
+        return tuple(_unwrapArgument(v) for v in value)
+    return value
+
+def _callWrapped(function, args, kwargs):
+    return _wrapResult(_callOnMainThread(function, *[_unwrapArgument(a) for a in args],
+        **dict((k, _unwrapArgument(v)) for k, v in kwargs.items())))
+
+def runOnMainThread(function, *args, **kwargs):
+    return _callWrapped(function, args, kwargs)
+
+class _MainThreadProxy(object):
+    __slots__ = ('_target',)
+
+    def __init__(self, target):
+        object.__setattr__(self, '_target', target)
+
+    def __getattr__(self, name):
+        target = self._target
+        if isinstance(getattr(type(target), name, None), property):
+            return _callWrapped(getattr, (target, name), {})
+        attribute = getattr(target, name)
+        if not callable(attribute):
+            return _wrapResult(attribute)
+        return lambda *args, **kwargs: _callWrapped(attribute, args, kwargs)
+
+    def __setattr__(self, name, value):
+        _callWrapped(setattr, (self._target, name, value), {})
+
+    def __len__(self):
+        return _callWrapped(len, (self._target,), {})
+
+    def __getitem__(self, key):
+        return _callWrapped(_operator.getitem, (self._target, key), {})
+
+    def __setitem__(self, key, value):
+        _callWrapped(_operator.setitem, (self._target, key, value), {})
+
+    def __contains__(self, value):
+        return _callWrapped(_operator.contains, (self._target, value), {})
+
+    def __iter__(self):
+        return iter(_callWrapped(list, (self._target,), {}))
+
+    def __bool__(self):
+        return _callWrapped(bool, (self._target,), {})
+
+    def __eq__(self, other):
+        return _callWrapped(_operator.eq, (self._target, other), {})
+
+    def __ne__(self, other):
+        return _callWrapped(_operator.ne, (self._target, other), {})
+
+    def __hash__(self):
+        return _callWrapped(hash, (self._target,), {})
+
+    def __str__(self):
+        return _callWrapped(str, (self._target,), {})
+
+    def __repr__(self):
+        return _callWrapped(repr, (self._target,), {})
+
+for _name, _value in list(globals().items()):
+    if _isMainThreadObject(_value):
+        globals()[_name] = _MainThreadProxy(_value)
+)";
+}
+
+BackgroundScript::BackgroundScript(const std::string& filePath, const py::dict& globals,
+    const std::string& description, const std::string& undoCommandName) :
+    _filePath(filePath),
+    _description(description),
+    _undoCommandName(undoCommandName),
+    _globals(globals.attr("copy")()),
+    _running(false),
+    _mainThreadId(std::this_thread::get_id()),
+    _pythonThreadId(0),
+    _executionFinished(false),
+    _cancelled(false)
+{
+    // Background execution is available to script commands only
+    _locals["__executeCommand__"] = true;
+}
+
+BackgroundScript::~BackgroundScript()
+{
+    stop();
+
+    py::gil_scoped_acquire gil;
+
+    _locals.release().dec_ref();
+    _globals.release().dec_ref();
+}
+
+void BackgroundScript::start(const std::function<void()>& onFinished)
+{
+    _onFinished = onFinished;
+
+    {
+        py::gil_scoped_acquire gil;
+
+        // The script might hold on to the function after we're gone
+        std::weak_ptr<BackgroundScript> weakSelf = shared_from_this();
+
+        _globals["_callOnMainThread"] = py::cpp_function(
+            [weakSelf](const py::function& function, const py::args& args, const py::kwargs& kwargs) -> py::object
+            {
+                auto self = weakSelf.lock();
+                return self ? self->callOnMainThread(function, args, kwargs) : function(*args, **kwargs);
+            });
+
+        py::exec(MainThreadProxyCode, _globals);
+    }
+
+    _running = true;
+
+    radiant::LongRunningOperationMessage started(radiant::OperationEvent::Started, _description);
+    GlobalRadiantCore().getMessageBus().sendMessage(started);
+
+    _undoCommand = std::make_unique<UndoableCommand>(_undoCommandName);
+
+    _thread = std::thread(&BackgroundScript::run, this);
+
+    scheduleServing();
+}
+
+void BackgroundScript::stop()
+{
+    cancel();
+    finish();
+}
+
+void BackgroundScript::cancel()
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!_running || _executionFinished || _cancelled) return;
+
+        _cancelled = true;
+    }
+
+    // Waiting calls are rejected, the script is interrupted at the next instruction
+    _callDone.notify_all();
+
+    py::gil_scoped_acquire gil;
+
+    auto threadId = _pythonThreadId.load();
+
+    if (threadId != 0)
+    {
+        PyThreadState_SetAsyncExc(threadId, PyExc_KeyboardInterrupt);
+    }
+}
+
+void BackgroundScript::run()
+{
+    py::gil_scoped_acquire gil;
+
+    _pythonThreadId.store(PyThread_get_thread_ident());
+
+    bool cancelled;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        cancelled = _cancelled;
+    }
+
+    try
+    {
+        if (!cancelled)
+        {
+            py::eval_file(_filePath, _globals, _locals);
+        }
+    }
+    catch (const py::error_already_set& ex)
+    {
+        rError() << "Error while executing file: " << _filePath << ": " << std::endl;
+        rError() << ex.what() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        rError() << "Error trying to execute file " << _filePath << ": " << ex.what() << std::endl;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _executionFinished = true;
+    }
+
+    _callPending.notify_one();
+}
+
+py::object BackgroundScript::callOnMainThread(const py::function& function, const py::args& args, const py::kwargs& kwargs)
+{
+    if (std::this_thread::get_id() == _mainThreadId)
+    {
+        return function(*args, **kwargs);
+    }
+
+    MainThreadCall call{ function, args, kwargs };
+
+    {
+        // Let the main thread have the interpreter while we're waiting
+        py::gil_scoped_release release;
+
+        std::unique_lock<std::mutex> lock(_lock);
+
+        if (!_cancelled)
+        {
+            _pendingCalls.push_back(&call);
+            _callPending.notify_one();
+
+            // A call that is being executed needs to be waited for, even after cancellation
+            _callDone.wait(lock, [&]() { return call.done || (_cancelled && !call.started); });
+
+            if (!call.started)
+            {
+                _pendingCalls.erase(std::find(_pendingCalls.begin(), _pendingCalls.end(), &call));
+            }
+        }
+    }
+
+    if (!call.done)
+    {
+        throw std::runtime_error("The script has been cancelled");
+    }
+
+    if (call.error)
+    {
+        throw *call.error;
+    }
+
+    return call.result;
+}
+
+void BackgroundScript::scheduleServing()
+{
+    std::weak_ptr<BackgroundScript> weakSelf = shared_from_this();
+
+    GlobalUserInterface().dispatch([weakSelf]()
+    {
+        if (auto self = weakSelf.lock())
+        {
+            self->serveCalls();
+        }
+    });
+}
+
+void BackgroundScript::serveCalls()
+{
+    if (!_running) return;
+
+    auto deadline = std::chrono::steady_clock::now() + ServingTimeSlice;
+
+    std::unique_lock<std::mutex> lock(_lock);
+
+    while (_callPending.wait_until(lock, deadline, [&]() { return !_pendingCalls.empty() || _executionFinished; }))
+    {
+        if (_pendingCalls.empty())
+        {
+            // The script is done
+            lock.unlock();
+            finish();
+
+            if (_onFinished)
+            {
+                _onFinished();
+            }
+
+            return;
+        }
+
+        auto call = _pendingCalls.front();
+        _pendingCalls.pop_front();
+        call->started = true;
+
+        lock.unlock();
+        executeCall(*call);
+        lock.lock();
+
+        call->done = true;
+        _callDone.notify_all();
+
+        // Return to the event loop when the time slice is used up
+        if (std::chrono::steady_clock::now() >= deadline) break;
+    }
+
+    lock.unlock();
+    scheduleServing();
+}
+
+void BackgroundScript::executeCall(MainThreadCall& call)
+{
+    py::gil_scoped_acquire gil;
+
+    try
+    {
+        call.result = call.function(*call.args, **call.kwargs);
+    }
+    catch (py::error_already_set& ex)
+    {
+        call.error = std::make_unique<py::error_already_set>(std::move(ex));
+    }
+    catch (const std::exception& ex)
+    {
+        PyErr_SetString(PyExc_RuntimeError, ex.what());
+        call.error = std::make_unique<py::error_already_set>();
+    }
+}
+
+void BackgroundScript::finish()
+{
+    if (!_running) return;
+
+    _running = false;
+
+    if (_thread.joinable())
+    {
+        _thread.join();
+    }
+
+    _undoCommand.reset();
+
+    radiant::LongRunningOperationMessage finished(radiant::OperationEvent::Finished);
+    GlobalRadiantCore().getMessageBus().sendMessage(finished);
+}
+
+} // namespace script
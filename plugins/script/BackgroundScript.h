@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <pybind11/pybind11.h>
+
+class UndoableCommand;
+
+namespace py = pybind11;
+
+namespace script
+{
+
+/**
+ * Executes a script file on a worker thread, such that long-running
+ * scripts don't freeze the editor.
+ *
+ * The script runs with a copy of the global dictionary, in which the
+ * Global* interface objects are replaced by proxies. Every call made
+ * through these proxies (and through the objects they return) is passed
+ * to the main thread, which is serving the calls in time slices between
+ * processing the UI events. Visitors are therefore invoked on the main
+ * thread too. Any other function can be passed to the main thread by
+ * using runOnMainThread(function, *args) in the script.
+ *
+ * The execution is reported through LongRunningOperationMessages and
+ * is recorded as a single undoable operation.
+ */
+class BackgroundScript final :
+    public std::enable_shared_from_this<BackgroundScript>
+{
+private:
+    // A call passed from the worker to the main thread
+    struct MainThreadCall
+    {
+        py::function function;
+        py::args args;
+        py::kwargs kwargs;
+        py::object result;
+        std::unique_ptr<py::error_already_set> error;
+        bool started = false;
+        bool done = false;
+    };
+
+    std::string _filePath;
+    std::string _description;
+    std::string _undoCommandName;
+
+    py::dict _globals;
+    py::dict _locals;
+
+    std::unique_ptr<UndoableCommand> _undoCommand;
+    std::function<void()> _onFinished;
+    bool _running;
+
+    std::thread::id _mainThreadId;
+    std::thread _thread;
+    std::atomic<unsigned long> _pythonThreadId;
+
+    // Guards the calls and flags below
+    std::mutex _lock;
+    std::condition_variable _callPending;
+    std::condition_variable _callDone;
+    std::deque<MainThreadCall*> _pendingCalls;
+    bool _executionFinished;
+    bool _cancelled;
+
+public:
+    // The globals are copied, this needs to be called with the GIL held
+    BackgroundScript(const std::string& filePath, const py::dict& globals,
+        const std::string& description, const std::string& undoCommandName);
+
+    ~BackgroundScript();
+
+    // Starts the worker thread and serving the calls on the main thread,
+    // the callback is invoked on the main thread after the script is done
+    void start(const std::function<void()>& onFinished);
+
+    // Cancels the script if it's still running and waits for the worker thread to exit
+    void stop();
+
+private:
+    // Raises a KeyboardInterrupt in the script and rejects any further calls
+    void cancel();
+
+    void run();
+
+    // Invoked by the script on the worker thread, waits for the main thread to execute the call
+    py::object callOnMainThread(const py::function& function, const py::args& args, const py::kwargs& kwargs);
+
+    void scheduleServing();
+
+    // Executes the calls arriving within one time slice on the main thread
+    void serveCalls();
+    void executeCall(MainThreadCall& call);
+
+    void finish();
+};
+
+} // namespace script
@@ -20,13 +20,21 @@ namespace
 PythonModule::PythonModule() :
     _outputWriter(false, _outputBuffer),
     _errorWriter(true, _errorBuffer),
-    _interpreterInitialised(false)
+    _interpreterInitialised(false),
+    _mainThreadState(nullptr)
 {
     registerModule();
 }
 
 PythonModule::~PythonModule()
 {
+    // Take back the interpreter for the cleanup
+    if (_mainThreadState != nullptr)
+    {
+        PyEval_RestoreThread(_mainThreadState);
+        _mainThreadState = nullptr;
+    }
+
     _namedInterfaces.clear();
 
     // Release the references to trigger the internal cleanup before Py_Finalize
@@ -63,6 +71,11 @@ void PythonModule::initialise()
 
         // String vector is used in multiple places
         py::bind_vector< std::vector<std::string> >(_module, "StringVector");
+
+        // Scripts running in the background are passing calls through this function,
+        // in the foreground it's just calling the function
+        py::exec("def runOnMainThread(function, *args, **kwargs):\n"
+            "    return function(*args, **kwargs)\n", getGlobals());
     }
     catch (const py::error_already_set& ex)
     {
@@ -71,6 +84,10 @@ void PythonModule::initialise()
 
     // Not needed anymore
     _instance = nullptr;
+
+    // Release the interpreter lock, such that scripts can run on other threads.
+    // Every entry point needs to acquire it from now on.
+    _mainThreadState = PyEval_SaveThread();
 }
 
 void PythonModule::registerModule()
@@ -99,6 +116,8 @@ ExecutionResultPtr PythonModule::executeString(const std::string& scriptString)
     _outputBuffer.clear();
     _errorBuffer.clear();
 
+    py::gil_scoped_acquire gil;
+
     try
     {
         std::string fullScript = "import " + std::string(ModuleName) + " as DR\n"
@@ -211,6 +230,7 @@ void PythonModule::addInterface(const NamedInterface& iface)
     // Initialise the interface at once, if the module is already alive
     if (_interpreterInitialised)
     {
+        py::gil_scoped_acquire gil;
         iface.second->registerInterface(_module, getGlobals());
     }
 }
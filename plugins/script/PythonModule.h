@@ -39,11 +39,16 @@ private:
 
     bool _interpreterInitialised;
 
+    // The main thread's state while it doesn't hold the interpreter lock
+    PyThreadState* _mainThreadState;
+
 public:
     PythonModule();
     ~PythonModule();
 
-    // Starts up the interpreter, imports the darkradiant module
+    // Starts up the interpreter, imports the darkradiant module.
+    // Afterwards the interpreter lock is released, callers need to acquire it
+    // through py::gil_scoped_acquire before touching any Python object.
     void initialise();
 
     ExecutionResultPtr executeString(const std::string& scriptString);
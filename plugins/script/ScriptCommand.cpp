@@ -7,10 +7,12 @@ namespace script
 
 ScriptCommand::ScriptCommand(const std::string& name,
 							 const std::string& displayName,
-							 const std::string& scriptFilename) :
+							 const std::string& scriptFilename,
+							 bool runsInBackground) :
 	_name(name),
 	_displayName(displayName),
-	_scriptFilename(scriptFilename)
+	_scriptFilename(scriptFilename),
+	_runsInBackground(runsInBackground)
 {
 	// Register this with the command system
 	GlobalCommandSystem().addStatement(_name, "RunScriptCommand '" + _name + "'", false);
@@ -24,10 +24,14 @@ private:
 	// The script file name to execute (relative to scripts/ folder)
 	std::string _scriptFilename;
 
+	// Whether the script should be executed on a worker thread
+	bool _runsInBackground;
+
 public:
 	ScriptCommand(const std::string& name,
 				  const std::string& displayName,
-				  const std::string& scriptFilename);
+				  const std::string& scriptFilename,
+				  bool runsInBackground);
 
 	virtual ~ScriptCommand();
 
@@ -45,6 +49,12 @@ public:
     {
 		return _displayName;
 	}
+
+	// Set through the __commandRunsInBackground__ attribute of the script
+	bool runsInBackground() const
+	{
+		return _runsInBackground;
+	}
 };
 typedef std::shared_ptr<ScriptCommand> ScriptCommandPtr;
 
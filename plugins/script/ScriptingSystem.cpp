@@ -8,6 +8,7 @@
 #include "itextstream.h"
 #include "iradiant.h"
 #include "ui/imainframe.h"
+#include "ui/iuserinterface.h"
 #include "iundo.h"
 
 #include "interfaces/MathInterface.h"
@@ -19,6 +20,7 @@
 #include "interfaces/BrushInterface.h"
 #include "interfaces/PatchInterface.h"
 #include "interfaces/EntityInterface.h"
+#include "interfaces/SceneNodeListInterface.h"
 #include "interfaces/MapInterface.h"
 #include "interfaces/CommandSystemInterface.h"
 #include "interfaces/GameInterface.h"
@@ -35,6 +37,9 @@
 #include "interfaces/LayerInterface.h"
 #include "interfaces/DeclarationManagerInterface.h"
 #include "interfaces/FxManagerInterface.h"
+#include "interfaces/UndoSystemInterface.h"
+#include "interfaces/MemoryAccountingInterface.h"
+#include "interfaces/SceneStatisticsInterface.h"
 
 #include "PythonModule.h"
 
@@ -44,6 +49,7 @@
 #include "os/file.h"
 #include "os/path.h"
 #include <functional>
+#include <fmt/format.h>
 #include "string/case_conv.h"
 
 namespace script 
@@ -67,6 +73,8 @@ void ScriptingSystem::executeScriptFile(const std::string& filename, bool setExe
 {
 	try
 	{
+        py::gil_scoped_acquire gil;
+
         std::string filePath = _scriptPath + filename;
 
         // Prevent calling exec_file with a non-existent file, we would
@@ -170,16 +178,65 @@ void ScriptingSystem::executeCommand(const std::string& name)
 		return;
 	}
 
+	if (found->second->runsInBackground() && executeCommandInBackground(*found->second))
+	{
+		return;
+	}
+
     UndoableCommand cmd("runScriptCommand " + name);
 
 	// Execute the script file behind this command
 	executeScriptFile(found->second->getFilename(), true);
 }
 
+bool ScriptingSystem::executeCommandInBackground(const ScriptCommand& command)
+{
+	// Without an event loop the calls can't be passed to the main thread
+	if (!module::GlobalModuleRegistry().moduleExists(MODULE_USERINTERFACE))
+	{
+		return false;
+	}
+
+	if (_backgroundScript)
+	{
+		rError() << "Cannot execute script command " << command.getName()
+			<< ", another script is still running." << std::endl;
+		return true;
+	}
+
+	std::string filePath = _scriptPath + command.getFilename();
+
+	if (!os::fileOrDirExists(filePath))
+	{
+		rError() << "Error: File " << filePath << " doesn't exist." << std::endl;
+		return true;
+	}
+
+	try
+	{
+		py::gil_scoped_acquire gil;
+
+		_backgroundScript = std::make_shared<BackgroundScript>(filePath, _pythonModule->getGlobals(),
+			fmt::format(_("Running {0}..."), command.getDisplayName()), "runScriptCommand " + command.getName());
+	}
+	catch (const py::error_already_set& ex)
+	{
+		rError() << "Error while preparing script command " << command.getName() << ": " << std::endl;
+		rError() << ex.what() << std::endl;
+		return true;
+	}
+
+	_backgroundScript->start([this]() { _backgroundScript.reset(); });
+
+	return true;
+}
+
 void ScriptingSystem::loadCommandScript(const std::string& scriptFilename)
 {
 	try
 	{
+		py::gil_scoped_acquire gil;
+
 		// Create a new dictionary for the initialisation routine
 		py::dict locals;
 
@@ -191,6 +248,7 @@ void ScriptingSystem::loadCommandScript(const std::string& scriptFilename)
 
 		std::string cmdName;
 		std::string cmdDisplayName;
+		bool cmdRunsInBackground = false;
 
 		if (locals.contains("__commandName__"))
 		{
@@ -202,6 +260,11 @@ void ScriptingSystem::loadCommandScript(const std::string& scriptFilename)
 			cmdDisplayName = locals["__commandDisplayName__"].cast<std::string>();
 		}
 
+		if (locals.contains("__commandRunsInBackground__"))
+		{
+			cmdRunsInBackground = locals["__commandRunsInBackground__"].cast<bool>();
+		}
+
 		if (!cmdName.empty())
 		{
 			if (cmdDisplayName.empty())
@@ -210,7 +273,7 @@ void ScriptingSystem::loadCommandScript(const std::string& scriptFilename)
 			}
 
 			// Successfully retrieved the command
-			auto cmd = std::make_shared<ScriptCommand>(cmdName, cmdDisplayName, scriptFilename);
+			auto cmd = std::make_shared<ScriptCommand>(cmdName, cmdDisplayName, scriptFilename, cmdRunsInBackground);
 
 			// Try to register this named command
 			auto result = _commands.insert(std::make_pair(cmdName, cmd));
@@ -314,6 +377,7 @@ void ScriptingSystem::initialiseModule(const IApplicationContext& ctx)
 	addInterface("Brush", std::make_shared<BrushInterface>());
 	addInterface("Patch", std::make_shared<PatchInterface>());
 	addInterface("Entity", std::make_shared<EntityInterface>());
+	addInterface("SceneNodeList", std::make_shared<SceneNodeListInterface>());
 	addInterface("Radiant", std::make_shared<RadiantInterface>());
 	addInterface("Map", std::make_shared<MapInterface>());
 	addInterface("FileSystem", std::make_shared<FileSystemInterface>());
@@ -329,6 +393,9 @@ void ScriptingSystem::initialiseModule(const IApplicationContext& ctx)
 	addInterface("LayerInterface", std::make_shared<LayerInterface>());
 	addInterface("DeclarationManager", std::make_shared<DeclarationManagerInterface>());
 	addInterface("FxManager", std::make_shared<FxManagerInterface>());
+	addInterface("UndoSystem", std::make_shared<UndoSystemInterface>());
+	addInterface("MemoryAccounting", std::make_shared<MemoryAccountingInterface>());
+	addInterface("SceneStatistics", std::make_shared<SceneStatisticsInterface>());
 
 	GlobalCommandSystem().addCommand(
 		"RunScript",
@@ -358,6 +425,13 @@ void ScriptingSystem::shutdownModule()
 
 	_initialised = false;
 
+	// A script still running in the background is interrupted
+	if (_backgroundScript)
+	{
+		_backgroundScript->stop();
+		_backgroundScript.reset();
+	}
+
 	// Clear the buffer so that nodes finally get destructed
 	SceneNodeBuffer::Instance().clear();
 
@@ -10,6 +10,7 @@
 #include "PythonModule.h"
 
 #include "ScriptCommand.h"
+#include "BackgroundScript.h"
 
 namespace script 
 {
@@ -31,6 +32,9 @@ private:
 	// All named script commands (pointing to .py files)
 	ScriptCommandMap _commands;
 
+	// The script command currently running on a worker thread
+	std::shared_ptr<BackgroundScript> _backgroundScript;
+
 	sigc::signal<void> _sigScriptsReloaded;
 
 public:
@@ -79,6 +83,9 @@ public:
 private:
 	void executeScriptFile(const std::string& filename, bool setExecuteCommandAttr);
 
+	// Runs the command's script on a worker thread, returns false if that's not possible
+	bool executeCommandInBackground(const ScriptCommand& command);
+
 	void reloadScripts();
 
 	void loadCommandScript(const std::string& scriptFilename);
@@ -12,6 +12,11 @@ void CommandSystemInterface::execute(const std::string& buffer)
 	GlobalCommandSystem().execute(buffer);
 }
 
+void CommandSystemInterface::executeBatch(const std::string& buffer, const std::string& undoOperationName)
+{
+	GlobalCommandSystem().executeBatch(buffer, undoOperationName);
+}
+
 void CommandSystemInterface::addStatement(const std::string& statementName, const std::string& str)
 {
 	GlobalCommandSystem().addStatement(statementName, str);
@@ -27,6 +32,7 @@ void CommandSystemInterface::registerInterface(py::module& scope, py::dict& glob
 	pybind11::class_<CommandSystemInterface> commandSys(scope, "CommandSystem");
 
 	commandSys.def("execute", &CommandSystemInterface::execute);
+	commandSys.def("executeBatch", &CommandSystemInterface::executeBatch);
 	commandSys.def("addStatement", &CommandSystemInterface::addStatement);
 	commandSys.def("removeCommand", &CommandSystemInterface::removeCommand);
 
@@ -11,6 +11,7 @@ class CommandSystemInterface :
 {
 public:
 	void execute(const std::string& buffer);
+	void executeBatch(const std::string& buffer, const std::string& undoOperationName);
 	void addStatement(const std::string& statementName, const std::string& string);
 	void removeCommand(const std::string& name);
 
@@ -30,6 +30,18 @@ void ScriptEntityNode::setKeyValue(const std::string& key, const std::string& va
 	}
 }
 
+void ScriptEntityNode::setKeyValues(const Entity::KeyValuePairs& keyValues) {
+	Entity* entity = Node_getEntity(*this);
+
+	if (entity != NULL) {
+		EntityBatchUpdate batch(*entity);
+
+		for (const auto& pair : keyValues) {
+			entity->setKeyValue(pair.first, pair.second);
+		}
+	}
+}
+
 bool ScriptEntityNode::isInherited(const std::string& key) {
 	Entity* entity = Node_getEntity(*this);
 
@@ -142,6 +154,7 @@ void EntityInterface::registerInterface(py::module& scope, py::dict& globals)
 	entityNode.def(py::init<const scene::INodePtr&>());
 	entityNode.def("getKeyValue", &ScriptEntityNode::getKeyValue);
 	entityNode.def("setKeyValue", &ScriptEntityNode::setKeyValue);
+	entityNode.def("setKeyValues", &ScriptEntityNode::setKeyValues);
 	entityNode.def("forEachKeyValue", &ScriptEntityNode::forEachKeyValue);
 	entityNode.def("isInherited", &ScriptEntityNode::isInherited);
 	entityNode.def("getEntityClass", &ScriptEntityNode::getEntityClass);
@@ -30,6 +30,9 @@ public:
 	// Methods wrapping to Entity class
 	std::string getKeyValue(const std::string& key);
 	void setKeyValue(const std::string& key, const std::string& value);
+
+	// Sets all given keys, the entity's observers get notified once at the end
+	void setKeyValues(const Entity::KeyValuePairs& keyValues);
 	bool isInherited(const std::string& key);
 
 	ScriptEntityClass getEntityClass();
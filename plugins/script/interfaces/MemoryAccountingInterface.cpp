@@ -0,0 +1,39 @@
+#include "MemoryAccountingInterface.h"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace script
+{
+
+std::vector<memory::MemoryUsageEntry> MemoryAccountingInterface::collectMemoryUsage()
+{
+	return GlobalMemoryAccounting().collectMemoryUsage();
+}
+
+void MemoryAccountingInterface::logMemoryUsage()
+{
+	GlobalMemoryAccounting().logMemoryUsage();
+}
+
+void MemoryAccountingInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	// Expose the entry structure
+	py::class_<memory::MemoryUsageEntry> entry(scope, "MemoryUsageEntry");
+	entry.def(py::init<>());
+	entry.def_readonly("reporter", &memory::MemoryUsageEntry::reporter);
+	entry.def_readonly("name", &memory::MemoryUsageEntry::name);
+	entry.def_readonly("bytes", &memory::MemoryUsageEntry::bytes);
+	entry.def_readonly("count", &memory::MemoryUsageEntry::count);
+
+	// Add the module declaration to the given python namespace
+	py::class_<MemoryAccountingInterface> memoryAccounting(scope, "MemoryAccounting");
+
+	memoryAccounting.def("collectMemoryUsage", &MemoryAccountingInterface::collectMemoryUsage);
+	memoryAccounting.def("logMemoryUsage", &MemoryAccountingInterface::logMemoryUsage);
+
+	// Now point the Python variable "GlobalMemoryAccounting" to this instance
+	globals["GlobalMemoryAccounting"] = this;
+}
+
+} // namespace script
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "imemoryaccounting.h"
+#include "iscript.h"
+#include "iscriptinterface.h"
+
+namespace script
+{
+
+/**
+ * Exposes the memory usage figures collected by the IMemoryAccounting module,
+ * one entry per reported item, ordered by reporter name.
+ */
+class MemoryAccountingInterface :
+	public IScriptInterface
+{
+public:
+	// Wrapped methods
+	std::vector<memory::MemoryUsageEntry> collectMemoryUsage();
+	void logMemoryUsage();
+
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
@@ -9,6 +9,7 @@
 #include "BrushInterface.h"
 #include "EntityInterface.h"
 #include "PatchInterface.h"
+#include "SceneNodeListInterface.h"
 
 namespace script
 {
@@ -119,6 +120,26 @@ ScriptSceneNode SceneGraphInterface::root()
 	return ScriptSceneNode(GlobalSceneGraph().root());
 }
 
+ScriptSceneNodeList SceneGraphInterface::findNodes(const ScriptSceneNode& node, const std::string& nodeType)
+{
+	ScriptSceneNodeList result;
+
+	scene::INodePtr parent = node;
+	if (!parent) return result;
+
+	parent->foreachNode([&](const scene::INodePtr& child)
+	{
+		if (nodeType.empty() || getNameForNodeType(child->getNodeType()) == nodeType)
+		{
+			result.append(child);
+		}
+
+		return true;
+	});
+
+	return result;
+}
+
 void SceneGraphInterface::registerInterface(py::module& scope, py::dict& globals)
 {
 	// Expose the scene::Node interface
@@ -161,6 +182,7 @@ void SceneGraphInterface::registerInterface(py::module& scope, py::dict& globals
 	// Add the module declaration to the given python namespace
 	py::class_<SceneGraphInterface> sceneGraphInterface(scope, "SceneGraph");
 	sceneGraphInterface.def("root", &SceneGraphInterface::root);
+	sceneGraphInterface.def("findNodes", &SceneGraphInterface::findNodes, py::arg("node"), py::arg("nodeType") = "");
 
 	// Now point the Python variable "GlobalSceneGraph" to this instance
 	globals["GlobalSceneGraph"] = this;
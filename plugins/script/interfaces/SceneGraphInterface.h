@@ -74,12 +74,18 @@ public:
 	}
 };
 
+class ScriptSceneNodeList;
+
 class SceneGraphInterface :
 	public IScriptInterface
 {
 public:
 	ScriptSceneNode root();
 
+	// Collects the nodes below the given one, optionally only those of the
+	// given type (like "brush" or "entity", see getNodeType())
+	ScriptSceneNodeList findNodes(const ScriptSceneNode& node, const std::string& nodeType);
+
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
 
@@ -0,0 +1,276 @@
+#include "SceneNodeListInterface.h"
+
+#include <stdexcept>
+#include <pybind11/stl.h>
+
+#include "ibrush.h"
+#include "ientity.h"
+#include "imap.h"
+#include "iundo.h"
+#include "string/convert.h"
+
+namespace script
+{
+
+namespace
+{
+	// Runs the given function as one undoable operation, if there's a map to record it
+	template<typename Func>
+	void applyUndoable(const std::string& command, const Func& func)
+	{
+		if (!GlobalMapModule().getRoot())
+		{
+			func();
+			return;
+		}
+
+		UndoableCommand cmd(command);
+		func();
+	}
+}
+
+void ScriptSceneNodeList::append(const scene::INodePtr& node)
+{
+	_nodes.emplace_back(node);
+}
+
+std::size_t ScriptSceneNodeList::size() const
+{
+	return _nodes.size();
+}
+
+ScriptSceneNode ScriptSceneNodeList::getNode(std::size_t index) const
+{
+	if (index >= _nodes.size())
+	{
+		throw py::index_error("SceneNodeList index out of range");
+	}
+
+	return ScriptSceneNode(_nodes[index].lock());
+}
+
+ScriptIndexArray ScriptSceneNodeList::getFaceCounts() const
+{
+	ScriptIndexArray counts(1);
+	counts.reserveRows(_nodes.size());
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* brush = Node_getIBrush(weakNode.lock());
+		counts.push_back(brush != nullptr ? static_cast<std::int64_t>(brush->getNumFaces()) : 0);
+	}
+
+	return counts;
+}
+
+ScriptFloatArray ScriptSceneNodeList::getFacePlanes() const
+{
+	ScriptFloatArray planes(4);
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* brush = Node_getIBrush(weakNode.lock());
+		if (brush == nullptr) continue;
+
+		for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+		{
+			const auto& plane = brush->getFace(i).getPlane3();
+
+			planes.push_back(plane.normal().x());
+			planes.push_back(plane.normal().y());
+			planes.push_back(plane.normal().z());
+			planes.push_back(plane.dist());
+		}
+	}
+
+	return planes;
+}
+
+ScriptIndexArray ScriptSceneNodeList::getFaceVertexCounts() const
+{
+	ScriptIndexArray counts(1);
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* brush = Node_getIBrush(weakNode.lock());
+		if (brush == nullptr) continue;
+
+		for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+		{
+			counts.push_back(static_cast<std::int64_t>(brush->getFace(i).getWinding().size()));
+		}
+	}
+
+	return counts;
+}
+
+ScriptFloatArray ScriptSceneNodeList::getFaceVertices() const
+{
+	ScriptFloatArray vertices(3);
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* brush = Node_getIBrush(weakNode.lock());
+		if (brush == nullptr) continue;
+
+		for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+		{
+			for (const auto& windingVertex : brush->getFace(i).getWinding())
+			{
+				vertices.push_back(windingVertex.vertex.x());
+				vertices.push_back(windingVertex.vertex.y());
+				vertices.push_back(windingVertex.vertex.z());
+			}
+		}
+	}
+
+	return vertices;
+}
+
+void ScriptSceneNodeList::setShader(const std::string& shader)
+{
+	applyUndoable("setShader", [&]()
+	{
+		for (const auto& weakNode : _nodes)
+		{
+			auto* brush = Node_getIBrush(weakNode.lock());
+
+			if (brush != nullptr)
+			{
+				brush->setShader(shader);
+			}
+		}
+	});
+}
+
+ScriptFloatArray ScriptSceneNodeList::getOrigins() const
+{
+	ScriptFloatArray origins(3);
+	origins.reserveRows(_nodes.size());
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* entity = Node_getEntity(weakNode.lock());
+		auto origin = entity != nullptr ? string::convert<Vector3>(entity->getKeyValue("origin")) : Vector3(0, 0, 0);
+
+		origins.push_back(origin.x());
+		origins.push_back(origin.y());
+		origins.push_back(origin.z());
+	}
+
+	return origins;
+}
+
+void ScriptSceneNodeList::setOrigins(const py::buffer& origins)
+{
+	auto info = origins.request();
+
+	if (info.format != py::format_descriptor<double>::format() || info.ndim != 2 || info.shape[1] != 3)
+	{
+		throw std::invalid_argument("setOrigins expects a buffer of doubles with 3 columns");
+	}
+
+	if (static_cast<std::size_t>(info.shape[0]) != _nodes.size())
+	{
+		throw std::invalid_argument("setOrigins expects one row per node");
+	}
+
+	auto* data = static_cast<const char*>(info.ptr);
+
+	auto get = [&](std::size_t row, std::size_t column)
+	{
+		return *reinterpret_cast<const double*>(data + row * info.strides[0] + column * info.strides[1]);
+	};
+
+	applyUndoable("setOrigins", [&]()
+	{
+		for (std::size_t i = 0; i < _nodes.size(); ++i)
+		{
+			auto* entity = Node_getEntity(_nodes[i].lock());
+			if (entity == nullptr) continue;
+
+			entity->setKeyValue("origin", string::to_string(Vector3(get(i, 0), get(i, 1), get(i, 2))));
+		}
+	});
+}
+
+std::vector<std::string> ScriptSceneNodeList::getKeyValues(const std::string& key) const
+{
+	std::vector<std::string> values;
+	values.reserve(_nodes.size());
+
+	for (const auto& weakNode : _nodes)
+	{
+		auto* entity = Node_getEntity(weakNode.lock());
+		values.emplace_back(entity != nullptr ? entity->getKeyValue(key) : std::string());
+	}
+
+	return values;
+}
+
+void ScriptSceneNodeList::setKeyValue(const std::string& key, const std::string& value)
+{
+	applyUndoable("setKeyValue", [&]()
+	{
+		for (const auto& weakNode : _nodes)
+		{
+			auto* entity = Node_getEntity(weakNode.lock());
+
+			if (entity != nullptr)
+			{
+				entity->setKeyValue(key, value);
+			}
+		}
+	});
+}
+
+void ScriptSceneNodeList::setKeyValues(const std::string& key, const std::vector<std::string>& values)
+{
+	if (values.size() != _nodes.size())
+	{
+		throw std::invalid_argument("setKeyValues expects one value per node");
+	}
+
+	applyUndoable("setKeyValues", [&]()
+	{
+		for (std::size_t i = 0; i < _nodes.size(); ++i)
+		{
+			auto* entity = Node_getEntity(_nodes[i].lock());
+
+			if (entity != nullptr)
+			{
+				entity->setKeyValue(key, values[i]);
+			}
+		}
+	});
+}
+
+void SceneNodeListInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	py::class_<ScriptFloatArray> floatArray(scope, "FloatArray", py::buffer_protocol());
+	floatArray.def_buffer(&ScriptFloatArray::getBufferInfo);
+	floatArray.def("__len__", &ScriptFloatArray::getNumRows);
+	floatArray.def("getNumColumns", &ScriptFloatArray::getNumColumns);
+
+	py::class_<ScriptIndexArray> indexArray(scope, "IndexArray", py::buffer_protocol());
+	indexArray.def_buffer(&ScriptIndexArray::getBufferInfo);
+	indexArray.def("__len__", &ScriptIndexArray::getNumRows);
+
+	py::class_<ScriptSceneNodeList> nodeList(scope, "SceneNodeList");
+	nodeList.def(py::init<>());
+	nodeList.def("append", [](ScriptSceneNodeList& self, const ScriptSceneNode& node) { self.append(node); });
+	nodeList.def("__len__", &ScriptSceneNodeList::size);
+	nodeList.def("__getitem__", &ScriptSceneNodeList::getNode);
+	nodeList.def("getFaceCounts", &ScriptSceneNodeList::getFaceCounts);
+	nodeList.def("getFacePlanes", &ScriptSceneNodeList::getFacePlanes);
+	nodeList.def("getFaceVertexCounts", &ScriptSceneNodeList::getFaceVertexCounts);
+	nodeList.def("getFaceVertices", &ScriptSceneNodeList::getFaceVertices);
+	nodeList.def("setShader", &ScriptSceneNodeList::setShader);
+	nodeList.def("getOrigins", &ScriptSceneNodeList::getOrigins);
+	nodeList.def("setOrigins", &ScriptSceneNodeList::setOrigins);
+	nodeList.def("getKeyValues", &ScriptSceneNodeList::getKeyValues);
+	nodeList.def("setKeyValue", &ScriptSceneNodeList::setKeyValue);
+	nodeList.def("setKeyValues", &ScriptSceneNodeList::setKeyValues);
+}
+
+} // namespace script
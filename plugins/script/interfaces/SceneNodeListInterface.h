@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <pybind11/pybind11.h>
+
+#include "iscript.h"
+#include "iscriptinterface.h"
+#include "inode.h"
+
+#include "SceneGraphInterface.h"
+
+namespace script
+{
+
+/**
+ * Rows of numbers in a contiguous block, exposed to Python through the
+ * buffer protocol: numpy.asarray() and memoryview() are wrapping it
+ * without copying. Single-column arrays are one-dimensional.
+ */
+template<typename T>
+class ScriptArray
+{
+private:
+	std::vector<T> _data;
+	std::size_t _numColumns;
+
+public:
+	ScriptArray(std::size_t numColumns) :
+		_numColumns(numColumns)
+	{}
+
+	void reserveRows(std::size_t numRows)
+	{
+		_data.reserve(numRows * _numColumns);
+	}
+
+	void push_back(T value)
+	{
+		_data.push_back(value);
+	}
+
+	std::size_t getNumRows() const
+	{
+		return _data.size() / _numColumns;
+	}
+
+	std::size_t getNumColumns() const
+	{
+		return _numColumns;
+	}
+
+	py::buffer_info getBufferInfo()
+	{
+		if (_numColumns == 1)
+		{
+			return py::buffer_info(_data.data(), static_cast<py::ssize_t>(_data.size()));
+		}
+
+		return py::buffer_info(_data.data(),
+			{ static_cast<py::ssize_t>(getNumRows()), static_cast<py::ssize_t>(_numColumns) },
+			{ static_cast<py::ssize_t>(sizeof(T) * _numColumns), static_cast<py::ssize_t>(sizeof(T)) });
+	}
+};
+
+using ScriptFloatArray = ScriptArray<double>;
+using ScriptIndexArray = ScriptArray<std::int64_t>;
+
+/**
+ * A list of scene nodes, letting scripts query and change the properties
+ * of many nodes with a single call instead of one call per node, face or key.
+ * Like ScriptSceneNode, the list is not keeping the nodes alive.
+ *
+ * The getters are returning one row per node (or face), nodes of
+ * unsuitable type are contributing empty or zero rows. The setters are
+ * applied to the whole list in a single undoable operation.
+ */
+class ScriptSceneNodeList
+{
+private:
+	std::vector<scene::INodeWeakPtr> _nodes;
+
+public:
+	void append(const scene::INodePtr& node);
+
+	std::size_t size() const;
+
+	ScriptSceneNode getNode(std::size_t index) const;
+
+	// The number of faces of each brush node
+	ScriptIndexArray getFaceCounts() const;
+
+	// The face planes of all brushes (normal x, y, z and distance), concatenated in node order
+	ScriptFloatArray getFacePlanes() const;
+
+	// The number of winding vertices of each face returned by getFacePlanes()
+	ScriptIndexArray getFaceVertexCounts() const;
+
+	// The winding vertices of all faces, concatenated in face order
+	ScriptFloatArray getFaceVertices() const;
+
+	// Sets the shader of all brush faces
+	void setShader(const std::string& shader);
+
+	// The origin key of each entity node
+	ScriptFloatArray getOrigins() const;
+
+	// Sets the origin of each entity, expects a buffer of doubles with one row per node
+	void setOrigins(const py::buffer& origins);
+
+	// The given key of each entity node, one string per node
+	std::vector<std::string> getKeyValues(const std::string& key) const;
+
+	// Sets the given key on every entity node to the same value
+	void setKeyValue(const std::string& key, const std::string& value);
+
+	// Sets the given key of each entity node to the value at the same index
+	void setKeyValues(const std::string& key, const std::vector<std::string>& values);
+};
+
+class SceneNodeListInterface :
+	public IScriptInterface
+{
+public:
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
@@ -0,0 +1,51 @@
+#include "SceneStatisticsInterface.h"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+namespace script
+{
+
+scene::ISceneStatistics::EntityClassCounts SceneStatisticsInterface::getEntityClassCounts()
+{
+	return GlobalSceneStatistics().getEntityClassCounts();
+}
+
+scene::ISceneStatistics::MaterialCounts SceneStatisticsInterface::getMaterialCounts()
+{
+	return GlobalSceneStatistics().getMaterialCounts();
+}
+
+scene::ISceneStatistics::ModelCounts SceneStatisticsInterface::getModelCounts()
+{
+	return GlobalSceneStatistics().getModelCounts();
+}
+
+scene::ISceneStatistics::LayerCounts SceneStatisticsInterface::getLayerCounts()
+{
+	return GlobalSceneStatistics().getLayerCounts();
+}
+
+void SceneStatisticsInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	// Expose the model usage structure
+	py::class_<scene::ModelUsage> modelUsage(scope, "ModelUsage");
+	modelUsage.def(py::init<>());
+	modelUsage.def_readonly("count", &scene::ModelUsage::count);
+	modelUsage.def_readonly("polyCount", &scene::ModelUsage::polyCount);
+	modelUsage.def_readonly("skinCount", &scene::ModelUsage::skinCount);
+
+	// Add the module declaration to the given python namespace
+	py::class_<SceneStatisticsInterface> statistics(scope, "SceneStatistics");
+
+	// The material counts are lists of [faces, patches, models, particles]
+	statistics.def("getEntityClassCounts", &SceneStatisticsInterface::getEntityClassCounts);
+	statistics.def("getMaterialCounts", &SceneStatisticsInterface::getMaterialCounts);
+	statistics.def("getModelCounts", &SceneStatisticsInterface::getModelCounts);
+	statistics.def("getLayerCounts", &SceneStatisticsInterface::getLayerCounts);
+
+	// Now point the Python variable "GlobalSceneStatistics" to this instance
+	globals["GlobalSceneStatistics"] = this;
+}
+
+} // namespace script
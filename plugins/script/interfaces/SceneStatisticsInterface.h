@@ -0,0 +1,28 @@
+#pragma once
+
+#include "iscenestatistics.h"
+#include "iscript.h"
+#include "iscriptinterface.h"
+
+namespace script
+{
+
+/**
+ * Exposes the figures of the ISceneStatistics module, which are maintained
+ * while the scene is changing and don't need a scene traversal.
+ */
+class SceneStatisticsInterface :
+	public IScriptInterface
+{
+public:
+	// Wrapped methods
+	scene::ISceneStatistics::EntityClassCounts getEntityClassCounts();
+	scene::ISceneStatistics::MaterialCounts getMaterialCounts();
+	scene::ISceneStatistics::ModelCounts getModelCounts();
+	scene::ISceneStatistics::LayerCounts getLayerCounts();
+
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
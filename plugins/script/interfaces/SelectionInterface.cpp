@@ -46,6 +46,18 @@ ScriptSceneNode SelectionInterface::penultimateSelected()
 	return GlobalSelectionSystem().penultimateSelected();
 }
 
+ScriptSceneNodeList SelectionInterface::getSelectedNodes()
+{
+	ScriptSceneNodeList result;
+
+	GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
+	{
+		result.append(node);
+	});
+
+	return result;
+}
+
 // IScriptInterface implementation
 void SelectionInterface::registerInterface(py::module& scope, py::dict& globals)
 {
@@ -79,6 +91,7 @@ void SelectionInterface::registerInterface(py::module& scope, py::dict& globals)
 	selSys.def("setSelectedAllComponents", &SelectionInterface::setSelectedAllComponents);
 	selSys.def("ultimateSelected", &SelectionInterface::ultimateSelected);
 	selSys.def("penultimateSelected", &SelectionInterface::penultimateSelected);
+	selSys.def("getSelectedNodes", &SelectionInterface::getSelectedNodes);
 
 	// Now point the Python variable "GlobalSelectionSystem" to this instance
 	globals["GlobalSelectionSystem"] = this;
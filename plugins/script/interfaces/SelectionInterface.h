@@ -9,6 +9,7 @@
 
 #include "SceneGraphInterface.h"
 #include "BrushInterface.h"
+#include "SceneNodeListInterface.h"
 
 namespace script 
 {
@@ -74,6 +75,9 @@ public:
 	ScriptSceneNode ultimateSelected();
 	ScriptSceneNode penultimateSelected();
 
+	// Returns all selected nodes in a list, for use with the bulk accessors
+	ScriptSceneNodeList getSelectedNodes();
+
 	// IScriptInterface implementation
 	void registerInterface(py::module& scope, py::dict& globals) override;
 };
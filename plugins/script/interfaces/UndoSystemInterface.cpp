@@ -0,0 +1,78 @@
+#include "UndoSystemInterface.h"
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "imap.h"
+
+namespace script
+{
+
+UndoSystemStatistics UndoSystemInterface::getStatistics()
+{
+	if (!GlobalMapModule().getRoot())
+	{
+		return UndoSystemStatistics();
+	}
+
+	return GlobalUndoSystem().getStatistics();
+}
+
+void UndoSystemInterface::undo()
+{
+	if (GlobalMapModule().getRoot())
+	{
+		GlobalUndoSystem().undo();
+	}
+}
+
+void UndoSystemInterface::redo()
+{
+	if (GlobalMapModule().getRoot())
+	{
+		GlobalUndoSystem().redo();
+	}
+}
+
+void UndoSystemInterface::registerInterface(py::module& scope, py::dict& globals)
+{
+	// Expose the statistics structures
+	py::class_<UndoSystemStatistics::Operation> operation(scope, "UndoOperationStatistics");
+	operation.def(py::init<>());
+	operation.def_readonly("name", &UndoSystemStatistics::Operation::name);
+	operation.def_readonly("numStates", &UndoSystemStatistics::Operation::numStates);
+	operation.def_readonly("memoryUsage", &UndoSystemStatistics::Operation::memoryUsage);
+
+	py::class_<UndoSystemStatistics::UndoableType> undoableType(scope, "UndoableTypeStatistics");
+	undoableType.def(py::init<>());
+	undoableType.def_readonly("numStates", &UndoSystemStatistics::UndoableType::numStates);
+	undoableType.def_readonly("memoryUsage", &UndoSystemStatistics::UndoableType::memoryUsage);
+	undoableType.def_readonly("numExports", &UndoSystemStatistics::UndoableType::numExports);
+	undoableType.def_readonly("exportMilliseconds", &UndoSystemStatistics::UndoableType::exportMilliseconds);
+	undoableType.def_readonly("numImports", &UndoSystemStatistics::UndoableType::numImports);
+	undoableType.def_readonly("importMilliseconds", &UndoSystemStatistics::UndoableType::importMilliseconds);
+
+	py::class_<UndoSystemStatistics> statistics(scope, "UndoSystemStatistics");
+	statistics.def(py::init<>());
+	statistics.def_readonly("undoOperations", &UndoSystemStatistics::undoOperations);
+	statistics.def_readonly("redoOperations", &UndoSystemStatistics::redoOperations);
+	statistics.def_readonly("undoableTypes", &UndoSystemStatistics::undoableTypes);
+	statistics.def_readonly("numUndos", &UndoSystemStatistics::numUndos);
+	statistics.def_readonly("undoMilliseconds", &UndoSystemStatistics::undoMilliseconds);
+	statistics.def_readonly("maxUndoMilliseconds", &UndoSystemStatistics::maxUndoMilliseconds);
+	statistics.def_readonly("numRedos", &UndoSystemStatistics::numRedos);
+	statistics.def_readonly("redoMilliseconds", &UndoSystemStatistics::redoMilliseconds);
+	statistics.def_readonly("maxRedoMilliseconds", &UndoSystemStatistics::maxRedoMilliseconds);
+
+	// Add the module declaration to the given python namespace
+	py::class_<UndoSystemInterface> undoSystem(scope, "UndoSystem");
+
+	undoSystem.def("getStatistics", &UndoSystemInterface::getStatistics);
+	undoSystem.def("undo", &UndoSystemInterface::undo);
+	undoSystem.def("redo", &UndoSystemInterface::redo);
+
+	// Now point the Python variable "GlobalUndoSystem" to this instance
+	globals["GlobalUndoSystem"] = this;
+}
+
+} // namespace script
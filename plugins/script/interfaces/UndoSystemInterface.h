@@ -0,0 +1,27 @@
+#pragma once
+
+#include "iundo.h"
+#include "iscript.h"
+#include "iscriptinterface.h"
+
+namespace script
+{
+
+/**
+ * Exposes the undo system of the active map to scripts, like the
+ * statistics reported by IUndoSystem::getStatistics().
+ */
+class UndoSystemInterface :
+	public IScriptInterface
+{
+public:
+	// Wrapped methods
+	UndoSystemStatistics getStatistics();
+	void undo();
+	void redo();
+
+	// IScriptInterface implementation
+	void registerInterface(py::module& scope, py::dict& globals) override;
+};
+
+} // namespace script
@@ -1,30 +1,32 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <string>
 #include <vector>
 
-#ifdef __APPLE__
-#include <OpenAL/al.h>
-#else
-#include <AL/al.h>
-#endif
-
 #include <vorbis/vorbisfile.h>
 #include <fmt/format.h>
 
 #include "iarchive.h"
+#include "isound.h"
+#include "itextstream.h"
 #include "stream/ScopedArchiveBuffer.h"
 #include "OggFileStream.h"
+#include "SoundStream.h"
 
 namespace sound
 {
 
 /**
- * greebo: Loader class creating an AL buffer from an OGG file.
+ * greebo: Loader class for OGG files, opening them as stream
+ * which is decoded while the sound is playing.
  */
 class OggFileLoader
 {
 private:
-    class FileWrapper
+    class FileWrapper :
+        public SoundStream
     {
     private:
         OggVorbis_File _oggFile;
@@ -62,78 +64,189 @@ private:
             // Clean up the OGG routines
             ov_clear(&_oggFile);
         }
+
+        ALenum getFormat() const override
+        {
+            // Check the number of channels
+            return ov_info(const_cast<OggVorbis_File*>(&_oggFile), -1)->channels == 1 ?
+                AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        }
+
+        ALsizei getFrequency() const override
+        {
+            return static_cast<ALsizei>(ov_info(const_cast<OggVorbis_File*>(&_oggFile), -1)->rate);
+        }
+
+        std::size_t read(char* buffer, std::size_t length) override
+        {
+            std::size_t bytesRead = 0;
+
+            while (bytesRead < length)
+            {
+                int bitStream;
+                // Read a chunk of decoded data from the vorbis file
+                auto bytes = ov_read(&_oggFile, buffer + bytesRead, static_cast<int>(length - bytesRead), 0, 2, 1, &bitStream);
+
+                if (bytes == 0)
+                {
+                    break; // end of file
+                }
+                else if (bytes == OV_HOLE)
+                {
+                    rError() << "Error decoding OGG: OV_HOLE.\n";
+                }
+                else if (bytes < 0)
+                {
+                    rError() << "Error decoding OGG: " << (bytes == OV_EBADLINK ? "OV_EBADLINK" : std::to_string(bytes)) << ".\n";
+                    break;
+                }
+                else
+                {
+                    bytesRead += static_cast<std::size_t>(bytes);
+                }
+            }
+
+            return bytesRead;
+        }
+
+        bool rewind() override
+        {
+            return ov_raw_seek(&_oggFile, 0) == 0;
+        }
     };
+
+    typedef StreamBase::byte_type byte;
+
 public:
     /**
-     * greebo: Determines the OGG file length in seconds.
+     * greebo: Determines the OGG file length in seconds. Nothing is
+     * decoded, only the page headers are read: the sample rate is taken
+     * from the identification header in the first page, the number of
+     * samples from the granule position of the stream's last page.
+     *
      * @throws: std::runtime_error if an error occurs.
      */
-    static float GetDuration(ArchiveFile& vfsFile)
+    static float GetDuration(InputStream& stream)
     {
-        FileWrapper file(vfsFile);
-
-        return static_cast<float>(ov_time_total(file.getHandle(), -1));
+        return GetSoundFileInfo(stream).duration;
     }
 
     /**
-     * greebo: Loads an OGG file from the given stream into OpenAL,
-     * returns the openAL buffer handle.
+     * Reads the duration, the sample rate and the number of channels
+     * from the page headers, without decoding anything.
      *
      * @throws: std::runtime_error if an error occurs.
      */
-    static ALuint LoadFromFile(ArchiveFile& vfsFile)
+    static SoundFileInfo GetSoundFileInfo(InputStream& stream)
     {
-        FileWrapper file(vfsFile);
+        // "OggS", version, header type, granule position (8), serial number (4),
+        // page sequence number (4), checksum (4), number of segments
+        constexpr std::size_t PageHeaderSize = 27;
 
-        // Get some information about the OGG file
-        vorbis_info* vorbisInfo = ov_info(file.getHandle(), -1);
+        byte header[PageHeaderSize];
+        byte segmentTable[255];
+        std::vector<byte> body;
 
-        // Check the number of channels
-        ALenum format = (vorbisInfo->channels == 1) ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+        bool isFirstPage = true;
+        std::uint32_t serialNumber = 0;
+        std::uint32_t sampleRate = 0;
+        unsigned int numChannels = 0;
+        std::int64_t lastGranulePosition = 0;
 
-        // Get the sample Rate
-        ALsizei freq = static_cast<ALsizei>(vorbisInfo->rate);
+        while (stream.read(header, PageHeaderSize) == PageHeaderSize)
+        {
+            if (std::memcmp(header, "OggS", 4) != 0)
+            {
+                throw std::runtime_error("Invalid OGG page header");
+            }
 
-        long bytes;
-        char smallBuffer[4096];
+            auto numSegments = static_cast<std::size_t>(header[26]);
 
-        std::vector<char> largeBuffer;
-        largeBuffer.reserve(vfsFile.size() * 2);
+            if (stream.read(segmentTable, numSegments) != numSegments)
+            {
+                break;
+            }
 
-        do
-        {
-            int bitStream;
-            // Read a chunk of decoded data from the vorbis file
-            bytes = ov_read(file.getHandle(), smallBuffer, sizeof(smallBuffer), 0, 2, 1, &bitStream);
+            std::size_t bodySize = 0;
 
-            if (bytes == OV_HOLE)
+            for (std::size_t i = 0; i < numSegments; ++i)
             {
-                rError() << "Error decoding OGG: OV_HOLE.\n";
+                bodySize += segmentTable[i];
             }
-            else if (bytes == OV_EBADLINK)
+
+            body.resize(bodySize);
+
+            if (stream.read(body.data(), bodySize) != bodySize)
             {
-                rError() << "Error decoding OGG: OV_EBADLINK.\n";
+                break;
             }
-            else
+
+            auto granulePosition = ReadLittleEndian<std::int64_t>(header + 6);
+            auto pageSerialNumber = ReadLittleEndian<std::uint32_t>(header + 14);
+
+            if (isFirstPage)
             {
-                // Stuff this into the variable-sized buffer
-                largeBuffer.insert(largeBuffer.end(), smallBuffer, smallBuffer + bytes);
+                // Packet type 1, "vorbis", version (4), channels (1), sample rate (4)
+                if (bodySize < 16 || body[0] != 1 || std::memcmp(body.data() + 1, "vorbis", 6) != 0)
+                {
+                    throw std::runtime_error("No vorbis identification header");
+                }
+
+                serialNumber = pageSerialNumber;
+                numChannels = body[11];
+                sampleRate = ReadLittleEndian<std::uint32_t>(body.data() + 12);
+                isFirstPage = false;
             }
-        } 
-        while (bytes > 0);
 
-        ALuint bufferNum = 0;
-        // Allocate a new buffer
-        alGenBuffers(1, &bufferNum);
+            // Pages without a finished packet have a granule position of -1
+            if (pageSerialNumber == serialNumber && granulePosition >= 0)
+            {
+                lastGranulePosition = granulePosition;
+            }
+        }
+
+        if (sampleRate == 0)
+        {
+            throw std::runtime_error("Could not determine the OGG sample rate");
+        }
+
+        SoundFileInfo info;
+
+        info.duration = static_cast<float>(static_cast<double>(lastGranulePosition) / sampleRate);
+        info.sampleRate = sampleRate;
+        info.numChannels = numChannels;
 
-        // Upload sound data to buffer
-        alBufferData(bufferNum,
-            format,
-            largeBuffer.data(),
-            static_cast<ALsizei>(largeBuffer.size()),
-            freq);
+        return info;
+    }
+
+    /**
+     * greebo: Opens the given OGG file for streaming. The encoded data is
+     * held in memory, it's decoded piece by piece through the returned stream.
+     *
+     * @throws: std::runtime_error if an error occurs.
+     */
+    static SoundStream::Ptr OpenStream(ArchiveFile& vfsFile)
+    {
+        auto stream = std::make_unique<FileWrapper>(vfsFile);
+
+        // Throws if the file could not be opened
+        stream->getHandle();
+
+        return stream;
+    }
+
+private:
+    template<typename T>
+    static T ReadLittleEndian(const byte* data)
+    {
+        std::uint64_t value = 0;
+
+        for (std::size_t i = 0; i < sizeof(T); ++i)
+        {
+            value |= static_cast<std::uint64_t>(data[i]) << (8 * i);
+        }
 
-        return bufferNum;
+        return static_cast<T>(value);
     }
 };
 
@@ -0,0 +1,377 @@
+#include "SoundFileIndex.h"
+
+#include <fstream>
+#include <stdexcept>
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+#include "stream/utils.h"
+#include "stream/MemoryInputStream.h"
+
+#include "WavFileLoader.h"
+#include "OggFileLoader.h"
+
+namespace sound
+{
+
+namespace
+{
+    const char* const CACHE_FILE_MAGIC = "DRSNDIDX";
+    const uint32_t CACHE_FILE_VERSION = 1;
+
+    class CacheReadException :
+        public std::runtime_error
+    {
+    public:
+        CacheReadException() :
+            std::runtime_error("Unexpected end of file")
+        {}
+    };
+
+    template<typename ValueType>
+    ValueType readValue(stream::MemoryInputStream& stream)
+    {
+        if (stream.remaining() < sizeof(ValueType)) throw CacheReadException();
+
+        return stream::readLittleEndian<ValueType>(stream);
+    }
+
+    std::string readString(stream::MemoryInputStream& stream)
+    {
+        auto length = readValue<uint32_t>(stream);
+
+        if (stream.remaining() < length) throw CacheReadException();
+
+        std::string value(reinterpret_cast<const char*>(stream.get()), length);
+        stream.seek(static_cast<SeekableStream::offset_type>(length), SeekableStream::cur);
+
+        return value;
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    // Returns the first candidate path existing in the VFS, an empty info if there is none
+    vfs::FileInfo resolveSoundFile(const std::string& fileName)
+    {
+        for (const auto& candidate : getSoundFileCandidates(fileName))
+        {
+            auto fileInfo = GlobalFileSystem().getFileInfo(candidate);
+
+            if (!fileInfo.isEmpty())
+            {
+                return fileInfo;
+            }
+        }
+
+        return vfs::FileInfo();
+    }
+
+    SoundFileInfo readSoundFileInfo(const std::string& resolvedPath)
+    {
+        SoundFileInfo info;
+
+        auto file = GlobalFileSystem().openFile(resolvedPath);
+
+        if (!file)
+        {
+            rError() << "Could not open sound file " << resolvedPath << std::endl;
+            return info;
+        }
+
+        auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+
+        try
+        {
+            if (extension == "wav")
+            {
+                info = WavFileLoader::GetSoundFileInfo(file->getInputStream());
+            }
+            else if (extension == "ogg")
+            {
+                info = OggFileLoader::GetSoundFileInfo(file->getInputStream());
+            }
+        }
+        catch (const std::runtime_error& ex)
+        {
+            rError() << "Error determining sound file duration " << ex.what() << std::endl;
+        }
+
+        return info;
+    }
+}
+
+std::vector<std::string> getSoundFileCandidates(const std::string& fileName)
+{
+    return
+    {
+        fileName,
+        os::replaceExtension(fileName, ".ogg"),
+        os::replaceExtension(fileName, ".wav"),
+    };
+}
+
+SoundFileIndex::SoundFileIndex(const std::string& cacheFile) :
+    _cacheFile(cacheFile),
+    _changed(false),
+    _cancelBuild(false),
+    _builder([this]() { build(); })
+{
+    load();
+}
+
+SoundFileIndex::~SoundFileIndex()
+{
+    cancelBuild();
+    save();
+}
+
+void SoundFileIndex::rebuild(std::set<std::string> files)
+{
+    cancelBuild();
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _filesToIndex.swap(files);
+    }
+
+    _builder.start();
+}
+
+void SoundFileIndex::cancelBuild()
+{
+    _cancelBuild = true;
+    _builder.reset();
+    _cancelBuild = false;
+}
+
+bool SoundFileIndex::find(const std::string& vfsPath, SoundFileInfo& info)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto found = _files.find(vfsPath);
+
+    if (found == _files.end())
+    {
+        return false;
+    }
+
+    info = found->second.info;
+    return true;
+}
+
+SoundFileInfo SoundFileIndex::getFileInfo(const std::string& vfsPath)
+{
+    SoundFileInfo info;
+    bool fileRead = false;
+
+    if (!indexFile(vfsPath, info, fileRead))
+    {
+        throw std::out_of_range("Could not resolve sound file " + vfsPath);
+    }
+
+    return info;
+}
+
+bool SoundFileIndex::indexFile(const std::string& vfsPath, SoundFileInfo& info, bool& fileRead)
+{
+    auto fileInfo = resolveSoundFile(vfsPath);
+
+    if (fileInfo.isEmpty())
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        _changed |= _files.erase(vfsPath) > 0;
+        return false;
+    }
+
+    FileStamp stamp;
+
+    try
+    {
+        stamp.path = fileInfo.getArchivePath();
+
+        if (fileInfo.getIsPhysicalFile())
+        {
+            stamp.path = os::standardPathWithSlash(stamp.path) + fileInfo.fullPath();
+        }
+
+        stamp.modificationTime = static_cast<int64_t>(fs::last_write_time(stamp.path).time_since_epoch().count());
+        stamp.size = fileInfo.getSize();
+    }
+    catch (fs::filesystem_error&)
+    {
+        // Leave the stamp invalid, the file will be read
+        stamp = FileStamp();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto found = _files.find(vfsPath);
+
+        if (stamp.isValid() && found != _files.end() && found->second.stamp == stamp &&
+            found->second.info.resolvedPath == fileInfo.fullPath())
+        {
+            info = found->second.info;
+            fileRead = false;
+            return true;
+        }
+    }
+
+    info = readSoundFileInfo(fileInfo.fullPath());
+    info.resolvedPath = fileInfo.fullPath();
+    fileRead = true;
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _files[vfsPath] = IndexedFile{ stamp, info };
+    _changed = true;
+
+    return true;
+}
+
+void SoundFileIndex::build()
+{
+    std::set<std::string> files;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        files.swap(_filesToIndex);
+    }
+
+    std::size_t numFilesRead = 0;
+
+    for (const auto& file : files)
+    {
+        if (_cancelBuild) return;
+
+        SoundFileInfo info;
+        bool fileRead = false;
+
+        indexFile(file, info, fileRead);
+
+        if (fileRead)
+        {
+            ++numFilesRead;
+        }
+    }
+
+    std::size_t numIndexedFiles = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Drop the files no longer referenced by any shader
+        for (auto i = _files.begin(); i != _files.end();)
+        {
+            if (files.count(i->first) == 0)
+            {
+                i = _files.erase(i);
+                _changed = true;
+                continue;
+            }
+
+            ++i;
+        }
+
+        numIndexedFiles = _files.size();
+    }
+
+    rMessage() << "[SoundManager] Indexed " << numIndexedFiles << " sound files, " <<
+        numFilesRead << " of them had to be read" << std::endl;
+
+    save();
+}
+
+void SoundFileIndex::save()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_changed) return;
+
+    std::ofstream stream(_cacheFile, std::ios::binary | std::ios::trunc);
+
+    if (!stream)
+    {
+        rWarning() << "[SoundManager] Cannot write sound file index " << _cacheFile << std::endl;
+        return;
+    }
+
+    stream.write(CACHE_FILE_MAGIC, 8);
+    stream::writeLittleEndian<uint32_t>(stream, CACHE_FILE_VERSION);
+    stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(_files.size()));
+
+    for (const auto& [path, file] : _files)
+    {
+        writeString(stream, path);
+        writeString(stream, file.stamp.path);
+        stream::writeLittleEndian<uint64_t>(stream, file.stamp.size);
+        stream::writeLittleEndian<int64_t>(stream, file.stamp.modificationTime);
+        writeString(stream, file.info.resolvedPath);
+        stream::writeLittleEndian<float>(stream, file.info.duration);
+        stream::writeLittleEndian<uint32_t>(stream, file.info.sampleRate);
+        stream::writeLittleEndian<uint32_t>(stream, file.info.numChannels);
+    }
+
+    _changed = false;
+}
+
+void SoundFileIndex::load()
+{
+    if (!os::fileOrDirExists(_cacheFile)) return;
+
+    std::ifstream file(_cacheFile, std::ios::binary);
+
+    if (!file) return;
+
+    std::vector<char> buffer((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    stream::MemoryInputStream stream(reinterpret_cast<const StreamBase::byte_type*>(buffer.data()), buffer.size());
+
+    try
+    {
+        if (stream.remaining() < 8 || std::string(reinterpret_cast<const char*>(stream.get()), 8) != CACHE_FILE_MAGIC)
+        {
+            throw std::runtime_error("Invalid file header");
+        }
+
+        stream.seek(8);
+
+        if (readValue<uint32_t>(stream) != CACHE_FILE_VERSION)
+        {
+            // Written by a different version, will be replaced on the next save
+            return;
+        }
+
+        auto numFiles = readValue<uint32_t>(stream);
+
+        for (uint32_t i = 0; i < numFiles; ++i)
+        {
+            auto path = readString(stream);
+            auto& indexedFile = _files[path];
+
+            indexedFile.stamp.path = readString(stream);
+            indexedFile.stamp.size = readValue<uint64_t>(stream);
+            indexedFile.stamp.modificationTime = readValue<int64_t>(stream);
+            indexedFile.info.resolvedPath = readString(stream);
+            indexedFile.info.duration = readValue<float>(stream);
+            indexedFile.info.sampleRate = readValue<uint32_t>(stream);
+            indexedFile.info.numChannels = readValue<uint32_t>(stream);
+        }
+
+        rMessage() << "[SoundManager] Loaded " << _files.size() << " sound files from the index" << std::endl;
+    }
+    catch (const std::runtime_error& ex)
+    {
+        rWarning() << "[SoundManager] Discarding sound file index " << _cacheFile << ": " << ex.what() << std::endl;
+        _files.clear();
+    }
+}
+
+}
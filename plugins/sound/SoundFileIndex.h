@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "isound.h"
+#include "parser/ThreadedDefLoader.h"
+
+namespace sound
+{
+
+// The paths tried when resolving a sound file referenced by a shader:
+// the path as it is, then with .ogg and with .wav extension as fallback
+std::vector<std::string> getSoundFileCandidates(const std::string& fileName);
+
+/**
+ * Index of the sound files referenced by the sound shaders, mapping every
+ * file to the path it resolves to, along with its duration and format.
+ *
+ * The index is built on a worker thread after the shaders have been loaded.
+ * It is stored in a binary file in the user's cache folder, such that only
+ * files in changed archives need to be read on the next start. Physical files
+ * are checked by their own size and modification time.
+ *
+ * All public methods except rebuild() can be called from any thread.
+ */
+class SoundFileIndex
+{
+private:
+    // Identifies the state of a resolved file on disk
+    struct FileStamp
+    {
+        // The path of the containing archive, or the file path for physical files
+        std::string path;
+
+        uint64_t size = 0;
+        int64_t modificationTime = 0;
+
+        bool isValid() const
+        {
+            return !path.empty();
+        }
+
+        bool operator==(const FileStamp& other) const
+        {
+            return path == other.path && size == other.size &&
+                modificationTime == other.modificationTime;
+        }
+    };
+
+    struct IndexedFile
+    {
+        FileStamp stamp;
+        SoundFileInfo info;
+    };
+
+    std::string _cacheFile;
+
+    // Guards the members below
+    std::mutex _lock;
+
+    // The indexed files by the path as referenced in the shaders
+    std::map<std::string, IndexedFile> _files;
+    bool _changed;
+
+    // The files to be covered by the next run of the builder
+    std::set<std::string> _filesToIndex;
+
+    std::atomic<bool> _cancelBuild;
+    parser::ThreadedDefLoader<void> _builder;
+
+public:
+    // Loads the index from the given file, which doesn't need to exist yet
+    SoundFileIndex(const std::string& cacheFile);
+
+    // Stops any running build and writes the cache file
+    ~SoundFileIndex();
+
+    // Starts building the index in the background, covering the given files.
+    // Entries of any other files are dropped once the build is complete.
+    void rebuild(std::set<std::string> files);
+
+    // Looks up the given file, returns false if it is not in the index
+    bool find(const std::string& vfsPath, SoundFileInfo& info);
+
+    // Returns the info about the given file, its headers are only read if
+    // the index doesn't contain up-to-date information yet.
+    // Throws std::out_of_range if the file cannot be resolved.
+    SoundFileInfo getFileInfo(const std::string& vfsPath);
+
+    // Writes the cache file if the index has been changed
+    void save();
+
+private:
+    void build();
+    void cancelBuild();
+
+    // Resolves the file and updates its entry, returns false if the file cannot be resolved
+    bool indexFile(const std::string& vfsPath, SoundFileInfo& info, bool& fileRead);
+
+    void load();
+};
+
+}
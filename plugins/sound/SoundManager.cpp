@@ -4,15 +4,10 @@
 #include "icommandsystem.h"
 #include "ideclmanager.h"
 
-#include "os/path.h"
-#include "os/fs.h"
-#include "string/case_conv.h"
-
 #include <algorithm>
+#include <set>
 #include "itextstream.h"
 
-#include "WavFileLoader.h"
-#include "OggFileLoader.h"
 #include "decl/DeclarationCreator.h"
 
 namespace sound
@@ -24,28 +19,22 @@ namespace
 /// Sound directory name
 constexpr const char* const SOUND_FOLDER = "sound/";
 constexpr const char* const SOUND_FILE_EXTENSION = ".sndshd";
+constexpr const char* const SOUND_INDEX_FILE = "sound_index.cache";
 
 // Load the given file, trying different extensions (first OGG, then WAV) as fallback
 ArchiveFilePtr openSoundFile(const std::string& fileName)
 {
-    // Try to open the file as it is
-    auto file = GlobalFileSystem().openFile(fileName);
-
-    if (file)
+    for (const auto& candidate : getSoundFileCandidates(fileName))
     {
-        // File found, play it
-        return file;
-    }
+        auto file = GlobalFileSystem().openFile(candidate);
 
-    file = GlobalFileSystem().openFile(os::replaceExtension(fileName, ".ogg"));
-
-    if (file)
-    {
-        return file;
+        if (file)
+        {
+            return file;
+        }
     }
 
-    // Try to open the file with .wav extension
-    return GlobalFileSystem().openFile(os::replaceExtension(fileName, ".wav"));
+    return ArchiveFilePtr();
 }
 
 }
@@ -79,7 +68,7 @@ bool SoundManager::playSound(const std::string& fileName, bool loopSound)
 
 	if (file && _soundPlayer)
 	{
-		_soundPlayer->play(*file, loopSound);
+		_soundPlayer->play(file, loopSound);
 		return true;
 	}
 
@@ -140,40 +129,54 @@ void SoundManager::initialiseModule(const IApplicationContext& ctx)
     GlobalDeclarationManager().registerDeclType("sound", std::make_shared<decl::DeclarationCreator<SoundShader>>(decl::Type::SoundShader));
     GlobalDeclarationManager().registerDeclFolder(decl::Type::SoundShader, SOUND_FOLDER, SOUND_FILE_EXTENSION);
 
-    // Route the decls reloaded signal to the local signal
+    _fileIndex = std::make_unique<SoundFileIndex>(ctx.getCacheDataPath() + SOUND_INDEX_FILE);
+
+    // Update the file index when the shaders have been loaded, then route the signal to the local one
     GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::SoundShader).connect(
-        [this]() { _sigSoundShadersReloaded.emit(); }
+        sigc::mem_fun(*this, &SoundManager::onSoundShadersReloaded)
     );
 }
 
-float SoundManager::getSoundFileDuration(const std::string& vfsPath)
+void SoundManager::shutdownModule()
 {
-    auto file = openSoundFile(vfsPath);
+    // Waits for the index to be built and writes the cache file
+    _fileIndex.reset();
+}
 
-    if (!file)
+float SoundManager::getSoundFileDuration(const std::string& vfsPath)
+{
+    if (!_fileIndex)
     {
         throw std::out_of_range("Could not resolve sound file " + vfsPath);
     }
 
-    auto extension = string::to_lower_copy(os::getExtension(file->getName()));
+    return _fileIndex->getFileInfo(vfsPath).duration;
+}
+
+bool SoundManager::findIndexedSoundFile(const std::string& vfsPath, SoundFileInfo& info)
+{
+    return _fileIndex && _fileIndex->find(vfsPath, info);
+}
 
-    try
+void SoundManager::onSoundShadersReloaded()
+{
+    // Collect the files referenced by the shaders, the index is built in the background
+    std::set<std::string> files;
+
+    forEachShader([&](const ISoundShader::Ptr& shader)
     {
-        if (extension == "wav")
-        {
-            return WavFileLoader::GetDuration(file->getInputStream());
-        }
-        else if (extension == "ogg")
+        for (const auto& file : shader->getSoundFileList())
         {
-            return OggFileLoader::GetDuration(*file);
+            files.insert(file);
         }
-    }
-    catch (const std::runtime_error& ex)
+    });
+
+    if (_fileIndex)
     {
-        rError() << "Error determining sound file duration " << ex.what() << std::endl;
+        _fileIndex->rebuild(std::move(files));
     }
 
-    return 0.0f;
+    _sigSoundShadersReloaded.emit();
 }
 
 void SoundManager::reloadSounds()
@@ -2,6 +2,7 @@
 
 #include "SoundShader.h"
 #include "SoundPlayer.h"
+#include "SoundFileIndex.h"
 
 #include "isound.h"
 #include "icommandsystem.h"
@@ -19,6 +20,9 @@ private:
 	// The helper class for playing the sounds
 	std::unique_ptr<SoundPlayer> _soundPlayer;
 
+    // Durations and formats of the files referenced by the shaders
+    std::unique_ptr<SoundFileIndex> _fileIndex;
+
     sigc::signal<void> _sigSoundShadersReloaded;
 
 public:
@@ -32,11 +36,16 @@ public:
 	void stopSound() override;
     void reloadSounds() override;
     float getSoundFileDuration(const std::string& vfsPath) override;
+    bool findIndexedSoundFile(const std::string& vfsPath, SoundFileInfo& info) override;
 
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	void shutdownModule() override;
+
+private:
+    void onSoundShadersReloaded();
 };
 
 }
@@ -1,6 +1,5 @@
 #include "SoundPlayer.h"
 
-#include <vorbis/vorbisfile.h>
 #include <iostream>
 #include <vector>
 #include "string/case_conv.h"
@@ -23,11 +22,23 @@
 namespace sound
 {
 
+namespace
+{
+	// The number of buffers queued on the source while streaming
+	constexpr std::size_t NumStreamBuffers = 4;
+
+	// The size of each buffer, around 370 msec. of 16 bit stereo sound at 44.1 kHz
+	constexpr std::size_t StreamBufferSize = 65536;
+
+	// The interval to refill the processed buffers, in msec.
+	constexpr int StreamUpdateInterval = 100;
+}
+
 // Constructor
 SoundPlayer::SoundPlayer() :
 	_initialised(false),
 	_context(NULL),
-	_buffer(0),
+	_loopSound(false),
 	_source(0)
 {
 	// Disable the timer, to make sure
@@ -93,40 +104,94 @@ SoundPlayer::~SoundPlayer() {
 
 void SoundPlayer::onTimerIntervalReached(wxTimerEvent& ev)
 {
-	// Check for active source and buffer
-	if (_source != 0 && _buffer != 0)
+	// Check for active source
+	if (_source == 0) return;
+
+	// Refill the buffers the source is done with and queue them again
+	ALint numProcessed = 0;
+	alGetSourcei(_source, AL_BUFFERS_PROCESSED, &numProcessed);
+
+	for (ALint i = 0; i < numProcessed; ++i)
 	{
-		ALint state;
-		// Query the state of the source
-		alGetSourcei(_source, AL_SOURCE_STATE, &state);
+		ALuint buffer = 0;
+		alSourceUnqueueBuffers(_source, 1, &buffer);
 
-		if (state == AL_STOPPED)
+		if (fillBuffer(buffer))
 		{
-			// Erase the buffer
-			clearBuffer();
+			alSourceQueueBuffers(_source, 1, &buffer);
+		}
+	}
 
-			// Disable the timer to stop calling this function
-			_timer.Stop();
+	ALint state;
+	// Query the state of the source
+	alGetSourcei(_source, AL_SOURCE_STATE, &state);
+
+	if (state == AL_STOPPED)
+	{
+		ALint numQueued = 0;
+		alGetSourcei(_source, AL_BUFFERS_QUEUED, &numQueued);
+
+		if (numQueued > 0)
+		{
+			// The source ran out of data before the buffers were refilled, resume
+			alSourcePlay(_source);
+			return;
 		}
+
+		// Erase the buffers, this also disables the timer
+		clearBuffer();
 	}
 }
 
+bool SoundPlayer::fillBuffer(ALuint buffer)
+{
+	if (!_stream) return false;
+
+	std::size_t bytesRead = _stream->read(_streamData.data(), _streamData.size());
+
+	// Start over at the end of a looped sound, unless the stream is empty
+	if (bytesRead < _streamData.size() && _loopSound && _stream->rewind())
+	{
+		std::size_t bytesAfterRewind = _stream->read(_streamData.data() + bytesRead, _streamData.size() - bytesRead);
+
+		if (bytesRead + bytesAfterRewind == 0)
+		{
+			_loopSound = false;
+		}
+
+		bytesRead += bytesAfterRewind;
+	}
+
+	if (bytesRead == 0)
+	{
+		return false;
+	}
+
+	alBufferData(buffer, _stream->getFormat(), _streamData.data(),
+		static_cast<ALsizei>(bytesRead), _stream->getFrequency());
+
+	return true;
+}
+
 void SoundPlayer::clearBuffer()
 {
-	// Check if there is an active buffer
+	// Check if there is an active source
 	if (_source != 0) {
-		// Stop playing
+		// Stop playing, this marks all queued buffers as processed
 		alSourceStop(_source);
+		alSourcei(_source, AL_BUFFER, 0);
 		alDeleteSources(1, &_source);
 		_source = 0;
+	}
 
-		if (_buffer != 0) {
-			// Free the buffer
-			alDeleteBuffers(1, &_buffer);
-			_buffer = 0;
-		}
+	if (!_buffers.empty()) {
+		// Free the buffers
+		alDeleteBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
+		_buffers.clear();
 	}
 
+	_stream.reset();
+
 	_timer.Stop();
 }
 
@@ -135,7 +200,7 @@ void SoundPlayer::stop()
 	clearBuffer();
 }
 
-void SoundPlayer::play(ArchiveFile& file, bool loopSound) 
+void SoundPlayer::play(const ArchiveFilePtr& file, bool loopSound)
 {
 	// If we're not initialised yet, do it now
 	if (!_initialised) 
@@ -146,68 +211,64 @@ void SoundPlayer::play(ArchiveFile& file, bool loopSound)
 	// Stop any previous playback operations, that might be still active
 	clearBuffer();
 
-	// Retrieve the extension
-	std::string ext = os::getExtension(file.getName());
+	_loopSound = loopSound;
 
-	if (string::to_lower_copy(ext) == "ogg")
-	{
-		createBufferDataFromOgg(file);
-	}
-	else 
-	{
-		createBufferDataFromWav(file);
-	}
+	openStream(file);
 
-	if (_buffer != 0) 
-	{
-		alGenSources(1, &_source);
+	if (!_stream) return;
 
-		// Assign the buffer to the source and play it
-		alSourcei(_source, AL_BUFFER, _buffer);
+	_streamData.resize(StreamBufferSize);
 
-		// Set the looping flag
-		alSourcei(_source, AL_LOOPING, loopSound ? AL_TRUE : AL_FALSE);
+	_buffers.resize(NumStreamBuffers);
+	alGenBuffers(static_cast<ALsizei>(_buffers.size()), _buffers.data());
 
-		// greebo: Wait 10 msec. to fix a problem with buffers not being played
-		// maybe the AL needs time to push the data?
-		usleep(10000);
+	alGenSources(1, &_source);
 
-		alSourcePlay(_source);
+	// The stream is looped by rewinding it, not by the source
+	alSourcei(_source, AL_LOOPING, AL_FALSE);
 
-		// Enable the periodic buffer check, this destructs the buffer
-		// as soon as the playback has finished
-		_timer.Start(200);
+	// Decode the first pieces and queue them
+	for (auto buffer : _buffers)
+	{
+		if (!fillBuffer(buffer)) break;
+
+		alSourceQueueBuffers(_source, 1, &buffer);
 	}
+
+	// greebo: Wait 10 msec. to fix a problem with buffers not being played
+	// maybe the AL needs time to push the data?
+	usleep(10000);
+
+	alSourcePlay(_source);
+
+	// Enable the periodic buffer check, this refills the buffers while playing
+	// and destructs them as soon as the playback has finished
+	_timer.Start(StreamUpdateInterval);
 }
 
-void SoundPlayer::createBufferDataFromWav(ArchiveFile& file)
+void SoundPlayer::openStream(const ArchiveFilePtr& file)
 {
-	// Must be a wave file
+	// Retrieve the extension
+	std::string ext = string::to_lower_copy(os::getExtension(file->getName()));
+
 	try
 	{
-		// Create an AL sound buffer directly from the buffer in memory
-		_buffer = WavFileLoader::LoadFromStream(file.getInputStream());
+		if (ext == "ogg")
+		{
+			_stream = OggFileLoader::OpenStream(*file);
+		}
+		else
+		{
+			// Must be a wave file
+			_stream = WavFileLoader::OpenStream(file, _loopSound);
+		}
 	}
 	catch (std::runtime_error& e)
 	{
-		rError() << "SoundPlayer: Error opening WAV file: " << e.what() << std::endl;
-		_buffer = 0;
+		rError() << "SoundPlayer: Error opening " << (ext == "ogg" ? "OGG" : "WAV") <<
+			" file: " << e.what() << std::endl;
+		_stream.reset();
 	}
 }
 
-void SoundPlayer::createBufferDataFromOgg(ArchiveFile& file)
-{
-    // Must be an OGG file
-    try
-    {
-        // Create an AL sound buffer directly from the buffer in memory
-        _buffer = OggFileLoader::LoadFromFile(file);
-    }
-    catch (std::runtime_error & e)
-    {
-        rError() << "SoundPlayer: Error opening OGG file: " << e.what() << std::endl;
-        _buffer = 0;
-    }
-}
-
 } // namespace sound
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #ifdef __APPLE__
 #include <OpenAL/al.h>
@@ -12,7 +13,8 @@
 
 #include <wx/timer.h>
 
-class ArchiveFile;
+#include "iarchive.h"
+#include "SoundStream.h"
 
 namespace sound {
 
@@ -25,14 +27,18 @@ protected:
 
 	ALCcontext* _context;
 
-	// The buffer containing the currently played audio data
-	ALuint _buffer;
+	// The sound data is decoded while playing, into a small ring of buffers
+	// which are queued on the source and refilled as soon as they're processed
+	SoundStream::Ptr _stream;
+	std::vector<ALuint> _buffers;
+	std::vector<char> _streamData;
+	bool _loopSound;
 
-	// The source playing the buffer
+	// The source playing the buffers
 	ALuint _source;
 
-	// The timer object to check whether the sound is done playing
-	// to destroy the buffer afterwards
+	// The timer object to refill the processed buffers and to check
+	// whether the sound is done playing to destroy the buffers afterwards
 	wxTimer _timer;
 
 public:
@@ -47,7 +53,7 @@ public:
 	/** greebo: Call this with the ArchiveFile object containing
 	 * 			the file to be played.
 	 */
-	virtual void play(ArchiveFile& file, bool loopSound);
+	virtual void play(const ArchiveFilePtr& file, bool loopSound);
 
 	/** greebo: Stops the playback immediately.
 	 */
@@ -60,11 +66,13 @@ protected:
 	// Clears the buffer, stops playing
 	void clearBuffer();
 
-	// This is called periodically to check whether the buffer can be cleared
+	// This is called periodically to refill the buffers and to check whether they can be cleared
 	void onTimerIntervalReached(wxTimerEvent& ev);
 
-	void createBufferDataFromOgg(ArchiveFile& file);
-	void createBufferDataFromWav(ArchiveFile& file);
+	// Decodes the next piece of the stream into the given buffer, returns false at the end
+	bool fillBuffer(ALuint buffer);
+
+	void openStream(const ArchiveFilePtr& file);
 };
 
 } // namespace sound
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#ifdef __APPLE__
+#include <OpenAL/al.h>
+#else
+#include <AL/al.h>
+#endif
+
+namespace sound
+{
+
+/**
+ * A source of PCM data, decoded piece by piece while the sound
+ * is playing, such that long files don't need to be decoded upfront.
+ */
+class SoundStream
+{
+public:
+    using Ptr = std::unique_ptr<SoundStream>;
+
+    virtual ~SoundStream() {}
+
+    // The AL format of the PCM data
+    virtual ALenum getFormat() const = 0;
+
+    // The sample rate
+    virtual ALsizei getFrequency() const = 0;
+
+    // Writes up to the given number of bytes to the buffer, returns the number
+    // of bytes written. This returns 0 at the end of the stream.
+    virtual std::size_t read(char* buffer, std::size_t length) = 0;
+
+    // Returns to the beginning of the PCM data, returns false if this is not supported
+    virtual bool rewind() = 0;
+};
+
+}
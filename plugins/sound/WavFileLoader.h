@@ -1,20 +1,22 @@
 #pragma once
 
+#include <algorithm>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include "idatastream.h"
+#include "iarchive.h"
+#include "isound.h"
 
-#ifdef __APPLE__
-#include <OpenAL/al.h>
-#else
-#include <AL/al.h>
-#endif
+#include "SoundStream.h"
 
 class InputStream;
 
 namespace sound {
 
 /**
- * greebo: Loader class creating an AL buffer from a WAV file.
+ * greebo: Loader class for WAV files, opening them as stream
+ * which is read while the sound is playing.
  *
  * Modeled after the one used by the Ogre3D people, found it posted
  * somewhere on the net.
@@ -32,11 +34,15 @@ private:
         unsigned int freq;
         unsigned short bps; // bits per sample
 
+        // The size of the 'data' chunk, i.e. the PCM payload
+        unsigned int dataSize;
+
         FileInfo()
         {
             magic[4] = '\0';
             fileFormat[4] = '\0';
             audioFormat = 0;
+            dataSize = 0;
         }
 
         ALenum getAlFormat() const
@@ -47,96 +53,170 @@ private:
             }
             else
             {
-                return  bps == 8 ? AL_FORMAT_STEREO16 : AL_FORMAT_STEREO16;
+                return  bps == 8 ? AL_FORMAT_STEREO8 : AL_FORMAT_STEREO16;
             }
         }
     };
 
     typedef StreamBase::byte_type byte;
 
+    // Reads the PCM payload of a WAV file. When looping, the data read in the
+    // first pass is kept, as the underlying stream can't be rewound.
+    class WavFileStream :
+        public SoundStream
+    {
+    private:
+        ArchiveFilePtr _file;
+        InputStream& _stream;
+        FileInfo _info;
+
+        std::size_t _bytesLeft;
+
+        bool _keepData;
+        std::vector<char> _data;
+        bool _replaying;
+        std::size_t _replayPosition;
+
+    public:
+        WavFileStream(const ArchiveFilePtr& file, bool keepData) :
+            _file(file),
+            _stream(file->getInputStream()),
+            _keepData(keepData),
+            _replaying(false),
+            _replayPosition(0)
+        {
+            ParseFileInfo(_stream, _info);
+            _bytesLeft = _info.dataSize;
+        }
+
+        ALenum getFormat() const override
+        {
+            return _info.getAlFormat();
+        }
+
+        ALsizei getFrequency() const override
+        {
+            return static_cast<ALsizei>(_info.freq);
+        }
+
+        std::size_t read(char* buffer, std::size_t length) override
+        {
+            if (_replaying)
+            {
+                auto bytesToCopy = std::min(length, _data.size() - _replayPosition);
+                std::copy(_data.begin() + _replayPosition, _data.begin() + _replayPosition + bytesToCopy, buffer);
+                _replayPosition += bytesToCopy;
+
+                return bytesToCopy;
+            }
+
+            auto bytesRead = _stream.read(reinterpret_cast<byte*>(buffer), std::min(length, _bytesLeft));
+
+            // Truncated files end early
+            _bytesLeft = bytesRead > 0 ? _bytesLeft - bytesRead : 0;
+
+            if (_keepData)
+            {
+                _data.insert(_data.end(), buffer, buffer + bytesRead);
+            }
+
+            return bytesRead;
+        }
+
+        bool rewind() override
+        {
+            // The data can be replayed once it has been read completely
+            if (!_keepData || _bytesLeft > 0) return false;
+
+            _replaying = true;
+            _replayPosition = 0;
+
+            return true;
+        }
+    };
+
 public:
     /**
-     * greebo: Determines the WAV file length in seconds.
+     * greebo: Determines the WAV file length in seconds. Only the
+     * chunk headers up to the beginning of the sound data are read.
+     *
      * @throws: std::runtime_error if an error occurs.
      */
     static float GetDuration(InputStream& stream)
+    {
+        return GetSoundFileInfo(stream).duration;
+    }
+
+    /**
+     * Reads the duration, the sample rate and the number of channels
+     * from the chunk headers in front of the sound data.
+     *
+     * @throws: std::runtime_error if an error occurs.
+     */
+    static SoundFileInfo GetSoundFileInfo(InputStream& stream)
     {
         FileInfo info;
         ParseFileInfo(stream, info);
 
-        SkipToRemainingData(stream);
-
-        // The next four bytes are the remaining size of the file
-        unsigned int remainingSize = 0;
-        stream.read(reinterpret_cast<byte*>(&remainingSize), sizeof(remainingSize));
-
         // Calculate how many samples we have in the payload, then calculate the duration
-        auto numSamples = remainingSize / (info.bps >> 3);
+        auto numSamples = info.dataSize / (info.bps >> 3);
         auto numSamplesPerChannel = numSamples / info.channels;
 
-        return static_cast<float>(numSamplesPerChannel) / info.freq;
-    }
+        SoundFileInfo result;
 
-	/**
-	 * greebo: Loads a WAV file from a stream into OpenAL,
-     * returns the openAL buffer handle.
-	 *
-	 * @throws: std::runtime_error if an error occurs.
-	 */
-	static ALuint LoadFromStream(InputStream& stream)
-    {
-        FileInfo info;
-        ParseFileInfo(stream, info);
+        result.duration = static_cast<float>(numSamplesPerChannel) / info.freq;
+        result.sampleRate = info.freq;
+        result.numChannels = info.channels;
 
-        SkipToRemainingData(stream);
+        return result;
+    }
 
-		// The next four bytes are the remaining size of the file
-		unsigned int remainingSize = 0;
-		stream.read(reinterpret_cast<byte*>(&remainingSize), sizeof(remainingSize));
+    /**
+     * greebo: Opens the given WAV file for streaming. If the sound is
+     * supposed to be looped, the returned stream can be rewound.
+     *
+     * @throws: std::runtime_error if an error occurs.
+     */
+    static SoundStream::Ptr OpenStream(const ArchiveFilePtr& file, bool loopSound)
+    {
+        return std::make_unique<WavFileStream>(file, loopSound);
+    }
 
-		ALuint bufferNum = 0;
-		alGenBuffers(1, &bufferNum);
+private:
+    static void Skip(InputStream& stream, std::size_t numBytes)
+    {
+        byte temp[256];
 
-        std::vector<byte> data(remainingSize);
-        stream.read(data.data(), remainingSize);
+        while (numBytes > 0)
+        {
+            auto bytesRead = stream.read(temp, std::min(numBytes, sizeof(temp)));
 
-		alBufferData(bufferNum, info.getAlFormat(), data.data(), static_cast<ALsizei>(remainingSize), info.freq);
+            if (bytesRead == 0)
+            {
+                throw std::runtime_error("Unexpected end of file.");
+            }
 
-		return bufferNum;
-	}
+            numBytes -= bytesRead;
+        }
+    }
 
-private:
-    // Assuming that the FMT chunk has been parsed, this seeks forward to the 
-    // beginning of the sound data
-    static void SkipToRemainingData(InputStream& stream)
+    // Reads the next chunk header, returns the chunk name and fills in the size
+    static std::string ReadChunkHeader(InputStream& stream, unsigned int& chunkSize)
     {
         char buffer[5];
         buffer[4] = '\0';
 
-        // check 'data' sub chunk (2)
-        stream.read(reinterpret_cast<byte*>(buffer), 4);
-
-        if (std::string(buffer) != "data" && std::string(buffer) != "fact")
+        if (stream.read(reinterpret_cast<byte*>(buffer), 4) != 4 ||
+            stream.read(reinterpret_cast<byte*>(&chunkSize), sizeof(chunkSize)) != sizeof(chunkSize))
         {
             throw std::runtime_error("No 'data' subchunk.");
         }
 
-        // fact is an option section we don't need to worry about
-        if (std::string(buffer) == "fact")
-        {
-            byte temp[8];
-            stream.read(temp, 8);
-
-            // Now we should hit the data chunk
-            stream.read(reinterpret_cast<byte*>(buffer), 4);
-            if (std::string(buffer) != "data")
-            {
-                throw std::runtime_error("No 'data' subchunk.");
-            }
-        }
+        return buffer;
     }
-    
-    // Reads the file header, leaves the stream right after the end of the first chunk
+
+    // Reads the file header and the format, leaves the stream at the beginning of the sound data.
+    // Chunks other than 'fmt ' and 'data' (like 'fact' or 'LIST') are skipped.
     static void ParseFileInfo(InputStream& stream, FileInfo& info)
     {
         // check magic
@@ -159,17 +239,13 @@ private:
         }
 
         // check 'fmt ' sub chunk (1)
-        char buffer[5];
-        buffer[4] = '\0';
-        stream.read(reinterpret_cast<byte*>(buffer), 4);
-        if (std::string(buffer) != "fmt ") {
+        unsigned int subChunk1Size(0);
+
+        if (ReadChunkHeader(stream, subChunk1Size) != "fmt ")
+        {
             throw std::runtime_error("No 'fmt ' subchunk.");
         }
 
-        // read (1)'s size
-        unsigned int subChunk1Size(0);
-        stream.read(reinterpret_cast<byte*>(&subChunk1Size), 4);
-
         if (subChunk1Size < 16)
         {
             throw std::runtime_error("'fmt ' chunk too small.");
@@ -195,6 +271,28 @@ private:
 
         // read bits per sample
         stream.read(reinterpret_cast<byte*>(&info.bps), sizeof(info.bps));
+
+        if (info.channels == 0 || info.bps < 8 || info.freq == 0)
+        {
+            throw std::runtime_error("Invalid 'fmt ' chunk.");
+        }
+
+        // The remainder of the format chunk, chunks are padded to an even size
+        Skip(stream, subChunk1Size - 16 + (subChunk1Size & 1));
+
+        // Proceed to the 'data' sub chunk (2)
+        while (true)
+        {
+            unsigned int chunkSize = 0;
+
+            if (ReadChunkHeader(stream, chunkSize) == "data")
+            {
+                info.dataSize = chunkSize;
+                return;
+            }
+
+            Skip(stream, chunkSize + (chunkSize & 1));
+        }
     }
 };
 
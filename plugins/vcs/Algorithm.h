@@ -9,6 +9,7 @@
 #include "GitModule.h"
 #include "Commit.h"
 #include "Diff.h"
+#include "MapStatusCache.h"
 #include "VersionControlLib.h"
 #include "command/ExecutionFailure.h"
 #include "wxutil/dialog/MessageBox.h"
@@ -54,7 +55,9 @@ struct RemoteStatus
     RequiredMergeStrategy strategy;
 };
 
-inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repository)
+// Determines the status of the loaded map relative to the tracked remote,
+// the results of the expensive queries are remembered in the given cache
+inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repository, MapStatusCache& cache)
 {
     auto mapPath = repository->getRepositoryRelativePath(GlobalMapModule().getMapName());
 
@@ -76,7 +79,7 @@ inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repos
             _("Merge in progress"), RequiredMergeStrategy::MergeAlreadyInProgress };
     }
 
-    auto mapFileHasUncommittedChanges = repository->fileHasUncommittedChanges(mapPath);
+    auto mapFileHasUncommittedChanges = cache.fileHasUncommittedChanges(*repository, mapPath);
 
     if (status.remoteCommitsAhead == 0)
     {
@@ -94,14 +97,10 @@ inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repos
     auto head = repository->getHead();
     auto upstream = head->getUpstream();
 
-    // Find the merge base for this ref and its upstream
-    auto mergeBase = repository->findMergeBase(*head, *upstream);
-
-    auto remoteDiffAgainstBase = repository->getDiff(*upstream, *mergeBase);
-    
-    bool remoteDiffContainsMap = remoteDiffAgainstBase->containsFile(mapPath);
+    // Compare both branches to their merge base
+    auto branchChanges = cache.getBranchChanges(*repository, *head, *upstream, mapPath);
 
-    if (!remoteDiffContainsMap)
+    if (!branchChanges.remoteBranchChangedFile)
     {
         // Remote didn't change the map, we can integrate it without conflicting the loaded map
         return RemoteStatus{ status.localCommitsAhead, status.remoteCommitsAhead, _("Integrate"), 
@@ -114,10 +113,7 @@ inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repos
             RequiredMergeStrategy::MergeMapWithUncommittedChanges };
     }
 
-    auto localDiffAgainstBase = repository->getDiff(*head, *mergeBase);
-    bool localDiffContainsMap = localDiffAgainstBase->containsFile(mapPath);
-
-    if (!localDiffContainsMap)
+    if (!branchChanges.localBranchChangedFile)
     {
         // The local diff doesn't include the map, the remote changes can be integrated
         return RemoteStatus{ status.localCommitsAhead, status.remoteCommitsAhead, _("Integrate"),
@@ -129,6 +125,12 @@ inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repos
         RequiredMergeStrategy::MergeMap };
 }
 
+inline RemoteStatus analyseRemoteStatus(const std::shared_ptr<Repository>& repository)
+{
+    MapStatusCache cache;
+    return analyseRemoteStatus(repository, cache);
+}
+
 inline std::string getInfoFilePath(const std::string& mapPath)
 {
     auto format = GlobalMapFormatManager().getMapFormatForFilename(mapPath);
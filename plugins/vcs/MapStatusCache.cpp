@@ -0,0 +1,133 @@
+#include "MapStatusCache.h"
+
+#include <git2.h>
+#include "Repository.h"
+#include "Reference.h"
+#include "Commit.h"
+#include "Diff.h"
+#include "GitException.h"
+
+namespace vcs
+{
+
+namespace git
+{
+
+namespace
+{
+    fs::file_time_type getModificationTime(const fs::path& path)
+    {
+        std::error_code ec;
+        auto time = fs::last_write_time(path, ec);
+
+        return ec ? fs::file_time_type::min() : time;
+    }
+
+    std::uintmax_t getFileSize(const fs::path& path)
+    {
+        std::error_code ec;
+        auto size = fs::file_size(path, ec);
+
+        return ec ? 0 : size;
+    }
+}
+
+bool MapStatusCache::FileState::operator==(const FileState& other) const
+{
+    return relativePath == other.relativePath && modificationTime == other.modificationTime &&
+        size == other.size && indexModificationTime == other.indexModificationTime && head == other.head;
+}
+
+bool MapStatusCache::BranchState::operator==(const BranchState& other) const
+{
+    return relativePath == other.relativePath && head == other.head && upstream == other.upstream;
+}
+
+MapStatusCache::MapStatusCache() :
+    _fileStatusIsValid(false),
+    _fileStatus(0),
+    _branchChangesAreValid(false),
+    _branchChanges{ false, false }
+{}
+
+unsigned int MapStatusCache::getFileStatus(Repository& repository, const std::string& relativePath)
+{
+    auto filePath = fs::path(repository.getPath()) / relativePath;
+    auto head = repository.getHead();
+
+    FileState state
+    {
+        relativePath,
+        getModificationTime(filePath),
+        getFileSize(filePath),
+        getModificationTime(fs::path(git_repository_path(repository._get())) / "index"),
+        head ? getTargetOid(repository, *head) : std::string()
+    };
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_fileStatusIsValid || !(_fileState == state))
+    {
+        _fileStatus = repository.getFileStatus(relativePath);
+        _fileState = std::move(state);
+        _fileStatusIsValid = true;
+    }
+
+    return _fileStatus;
+}
+
+bool MapStatusCache::fileIsIndexed(Repository& repository, const std::string& relativePath)
+{
+    return (getFileStatus(repository, relativePath) & GIT_STATUS_WT_NEW) == 0;
+}
+
+bool MapStatusCache::fileHasUncommittedChanges(Repository& repository, const std::string& relativePath)
+{
+    return (getFileStatus(repository, relativePath) & GIT_STATUS_WT_MODIFIED) != 0;
+}
+
+MapStatusCache::BranchChanges MapStatusCache::getBranchChanges(Repository& repository,
+    const Reference& head, const Reference& upstream, const std::string& relativePath)
+{
+    BranchState state
+    {
+        relativePath,
+        getTargetOid(repository, head),
+        getTargetOid(repository, upstream)
+    };
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    if (!_branchChangesAreValid || !(_branchState == state))
+    {
+        auto mergeBase = repository.findMergeBase(head, upstream);
+
+        _branchChanges.localBranchChangedFile = repository.getDiff(head, *mergeBase)->containsFile(relativePath);
+        _branchChanges.remoteBranchChangedFile = repository.getDiff(upstream, *mergeBase)->containsFile(relativePath);
+        _branchState = std::move(state);
+        _branchChangesAreValid = true;
+    }
+
+    return _branchChanges;
+}
+
+void MapStatusCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _fileStatusIsValid = false;
+    _branchChangesAreValid = false;
+}
+
+std::string MapStatusCache::getTargetOid(Repository& repository, const Reference& reference)
+{
+    git_oid oid;
+    auto error = git_reference_name_to_id(&oid, repository._get(), reference.getName().c_str());
+    GitException::ThrowOnError(error);
+
+    return Reference::OidToString(&oid);
+}
+
+}
+
+}
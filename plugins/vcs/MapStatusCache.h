@@ -0,0 +1,91 @@
+#pragma once
+
+#include <mutex>
+#include <string>
+#include "os/fs.h"
+
+namespace vcs
+{
+
+namespace git
+{
+
+class Repository;
+class Reference;
+
+/**
+ * Remembers the outcome of the status queries concerning the loaded map, such
+ * that the periodic status refresh doesn't ask libgit2 to hash the map file or
+ * to diff the branches against their merge base again, as long as neither the
+ * map file nor the involved commits have changed.
+ *
+ * The queries are running on worker threads, access is synchronised.
+ */
+class MapStatusCache final
+{
+public:
+    // Tells whether the branches changed a file since their merge base
+    struct BranchChanges
+    {
+        bool localBranchChangedFile;
+        bool remoteBranchChangedFile;
+    };
+
+private:
+    // The state of the working tree a file status has been calculated for
+    struct FileState
+    {
+        std::string relativePath;
+        fs::file_time_type modificationTime;
+        std::uintmax_t size;
+        fs::file_time_type indexModificationTime;
+        std::string head;
+
+        bool operator==(const FileState& other) const;
+    };
+
+    // The commits the branch changes have been calculated for
+    struct BranchState
+    {
+        std::string relativePath;
+        std::string head;
+        std::string upstream;
+
+        bool operator==(const BranchState& other) const;
+    };
+
+    std::mutex _lock;
+
+    bool _fileStatusIsValid;
+    FileState _fileState;
+    unsigned int _fileStatus;
+
+    bool _branchChangesAreValid;
+    BranchState _branchState;
+    BranchChanges _branchChanges;
+
+public:
+    MapStatusCache();
+
+    // Returns the git_status_t flags of the given file, libgit2 is only queried
+    // if the file, the index or the HEAD changed since the previous call
+    unsigned int getFileStatus(Repository& repository, const std::string& relativePath);
+
+    bool fileIsIndexed(Repository& repository, const std::string& relativePath);
+    bool fileHasUncommittedChanges(Repository& repository, const std::string& relativePath);
+
+    // Checks whether the given branches changed the file since their merge base,
+    // the merge base and diffs are only calculated if one of the branches moved
+    BranchChanges getBranchChanges(Repository& repository, const Reference& head,
+        const Reference& upstream, const std::string& relativePath);
+
+    // Discards all cached results
+    void clear();
+
+private:
+    static std::string getTargetOid(Repository& repository, const Reference& reference);
+};
+
+}
+
+}
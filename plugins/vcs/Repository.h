@@ -64,6 +64,9 @@ public:
     bool fileIsIndexed(const std::string& relativePath);
     bool fileHasUncommittedChanges(const std::string& relativePath);
 
+    // Returns the git_status_t flags of the given file in the working tree
+    unsigned int getFileStatus(const std::string& relativePath);
+
     // Compares the state of the given ref to the state of its tracked remote,
     // returns the number of commits each of them is ahead of the other one.
     RefSyncStatus getSyncStatusOfBranch(const Reference& reference);
@@ -102,8 +105,6 @@ public:
 
 private:
     std::shared_ptr<Remote> getTrackedRemote();
-
-    unsigned int getFileStatus(const std::string& relativePath);
 };
 
 }
@@ -121,6 +121,7 @@ void VcsStatus::createPopupMenu()
 void VcsStatus::setRepository(const std::shared_ptr<git::Repository>& repository)
 {
     _repository = repository;
+    _statusCache.clear();
 
     findNamedObject<wxBitmapButton>(_panel, "VcsMenuButton")->Show(_repository != nullptr);
 
@@ -335,7 +336,7 @@ void VcsStatus::analyseRemoteStatus(std::shared_ptr<git::Repository> repository)
 {
     try
     {
-        setRemoteStatus(git::analyseRemoteStatus(repository));
+        setRemoteStatus(git::analyseRemoteStatus(repository, _statusCache));
     }
     catch (git::GitException& ex)
     {
@@ -348,7 +349,7 @@ void VcsStatus::performSync(std::shared_ptr<git::Repository> repository)
     try
     {
         syncWithRemote(repository);
-        setRemoteStatus(git::analyseRemoteStatus(repository));
+        setRemoteStatus(git::analyseRemoteStatus(repository, _statusCache));
     }
     catch (git::GitException& ex)
     {
@@ -448,11 +449,11 @@ void VcsStatus::performMapFileStatusCheck(std::shared_ptr<git::Repository> repos
             return;
         }
 
-        if (repository->fileHasUncommittedChanges(relativePath))
+        if (_statusCache.fileHasUncommittedChanges(*repository, relativePath))
         {
             setMapFileStatus(_("Map saved, pending commit"));
         }
-        else if (repository->fileIsIndexed(relativePath))
+        else if (_statusCache.fileIsIndexed(*repository, relativePath))
         {
             setMapFileStatus(_("Map committed"));
         }
@@ -10,6 +10,7 @@
 #include "imap.h"
 #include "../Algorithm.h"
 #include "../Repository.h"
+#include "../MapStatusCache.h"
 #include "wxutil/XmlResourceBasedWidget.h"
 #include "wxutil/menu/PopupMenu.h"
 
@@ -36,6 +37,9 @@ private:
 
     std::shared_ptr<git::Repository> _repository;
 
+    // Shared by the status checks, which are skipped if nothing changed
+    git::MapStatusCache _statusCache;
+
     wxStaticText* _remoteStatus;
     wxStaticText* _mapStatus;
 
@@ -133,6 +133,7 @@ bool RadiantApp::OnInit()
 
 		module::RegistryReference::Instance().setRegistry(radiant->getModuleRegistry());
 		module::initialiseStreams(radiant->getLogWriter());
+		util::GlobalTraceRecorderPtr() = &radiant->getModuleRegistry().getTraceRecorder();
 	}
 	catch (module::CoreModule::FailureException& ex)
 	{
@@ -235,6 +236,7 @@ void RadiantApp::OnInitCmdLine(wxCmdLineParser& parser)
 
 	parser.AddLongSwitch("disable-sound", _("Disable sound for this session."));
 	parser.AddLongOption("verbose", _("Verbose logging."));
+	parser.AddLongOption("trace", _("Record the startup timeline, written to the given file in the Chrome trace format on exit."));
 
 	parser.AddParam("Map file", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
 	parser.AddParam("fs_game=<game>", wxCMD_LINE_VAL_STRING, wxCMD_LINE_PARAM_OPTIONAL);
@@ -5,8 +5,11 @@
 #include "icolourscheme.h"
 #include "itextstream.h"
 #include "icameraview.h"
+#include "iparticles.h"
 #include "ui/imainframe.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <time.h>
 #include <fmt/format.h>
@@ -38,6 +41,10 @@ namespace
 {
     constexpr std::size_t MSEC_PER_FRAME = 16;
 
+    // The lit scene is rendered at full resolution once the view is left alone for this long
+    constexpr int REFINE_DELAY_MSEC = 250;
+    constexpr double MIN_RESOLUTION_SCALE = 0.25;
+
     constexpr unsigned int MOVE_NONE = 0;
     constexpr unsigned int MOVE_FORWARD = 1 << 0;
     constexpr unsigned int MOVE_BACK = 1 << 1;
@@ -76,6 +83,11 @@ CamWnd::CamWnd(wxWindow* parent, CameraWndManager& owner) :
     _wxGLWidget(new wxutil::GLWidget(_mainWxWidget, std::bind(&CamWnd::onRender, this), "CamWnd")),
     _timer(this),
     _timerLock(false),
+    _frameProfiler("Camera"),
+    _parallelRenderCollection(RKEY_ENABLE_PARALLEL_RENDER_COLLECTION),
+    _resolutionScale(1.0),
+    _renderedResolutionScale(1.0),
+    _refineTimer(this),
     _freeMoveEnabled(false),
     _freeMoveFlags(0),
     _freeMoveTimer(this),
@@ -88,6 +100,7 @@ CamWnd::CamWnd(wxWindow* parent, CameraWndManager& owner) :
 
     Bind(wxEVT_TIMER, &CamWnd::onFrame, this, _timer.GetId());
     Bind(wxEVT_TIMER, &CamWnd::onFreeMoveTimer, this, _freeMoveTimer.GetId());
+    Bind(wxEVT_TIMER, &CamWnd::onRefineTimer, this, _refineTimer.GetId());
     _wxGLWidget->Bind(wxEVT_IDLE, &CamWnd::onIdle, this);
 
     setFarClipPlaneDistance(calculateFarPlaneDistance(getCameraSettings()->cubicScale()));
@@ -169,8 +182,9 @@ void CamWnd::disconnectEventHandlers()
     auto toggleCameraGridEvent = GlobalEventManager().findEvent("ToggleCameraGrid");
     toggleCameraGridEvent->disconnectToolItem(gridButton);
 
-    // Stop the timer, it might still fire even during shutdown
+    // Stop the timers, these might still fire even during shutdown
     _timer.Stop();
+    _refineTimer.Stop();
 
     // Unsubscribe from the global scene graph update
     GlobalSceneGraph().removeSceneObserver(this);
@@ -463,7 +477,9 @@ void CamWnd::changeFloor(const bool up)
     float bestUp;
     float bestDown;
     camera::FloorHeightWalker walker(current, bestUp, bestDown);
-    GlobalSceneGraph().root()->traverse(walker);
+
+    const Vector3& origin = _camera->getCameraOrigin();
+    walker.walk(GlobalSceneGraph(), origin.x(), origin.y());
 
     if (up && bestUp != game::current::getValue<float>("/defaults/maxWorldCoord")) {
         current = bestUp;
@@ -473,8 +489,7 @@ void CamWnd::changeFloor(const bool up)
         current = bestDown;
     }
 
-    const Vector3& org = _camera->getCameraOrigin();
-    _camera->setCameraOrigin(Vector3(org[0], org[1], current + 48));
+    _camera->setCameraOrigin(Vector3(origin[0], origin[1], current + 48));
 
     update();
 }
@@ -734,6 +749,7 @@ void CamWnd::Cam_Draw()
 
     // Reset statistics for this frame
     _renderStats.resetStats();
+    _frameProfiler.beginFrame();
 
     _view.resetCullStats();
 
@@ -840,10 +856,15 @@ void CamWnd::Cam_Draw()
         _renderer->prepare();
 
         // Front end (renderable collection from scene)
-        render::RenderableCollectionWalker::CollectRenderablesInScene(*_renderer, _view);
+        {
+            util::ScopedTraceEvent trace("render", "Collect renderables");
+            render::RenderableCollectionWalker::CollectRenderablesInScene(*_renderer, _view,
+                _parallelRenderCollection.get());
+        }
 
         // Accumulate render statistics
         _renderStats.frontEndComplete();
+        _frameProfiler.frontEndComplete();
 
         // Render any active mousetools
         for (const ActiveMouseTools::value_type& i : _activeMouseTools)
@@ -851,10 +872,12 @@ void CamWnd::Cam_Draw()
             i.second->render(GlobalRenderSystem(), *_renderer, _view);
         }
 
+        _renderedResolutionScale = 1.0;
+
         if (getCameraSettings()->getRenderMode() == RENDER_MODE_LIGHTING)
         {
             // Lit mode
-            result = GlobalRenderSystem().renderLitScene(allowedRenderFlags, _view);
+            result = renderLitScene(allowedRenderFlags, width, height);
         }
         else
         {
@@ -939,10 +962,32 @@ void CamWnd::Cam_Draw()
         statString += _renderStats.getStatString();
     }
 
+    if (_renderedResolutionScale < 1.0)
+    {
+        statString += fmt::format(" | Resolution: {0:d}%", static_cast<int>(_renderedResolutionScale * 100));
+    }
+
+    // The particle LOD statistics of this frame, to tune the particle budget
+    const auto& particleStats = GlobalParticlesManager().getLodStatistics();
+
+    if (particleStats.numEmitters > 0)
+    {
+        statString += fmt::format(" | Particles: {0}/{1} ({2} reduced, {3} skipped)",
+            particleStats.numParticlesSimulated, particleStats.numParticlesRequested,
+            particleStats.numReducedDetail, particleStats.numSkippedUpdates);
+    }
+
     _glFont->drawString(statString);
 
     drawTime();
 
+    _frameProfiler.endFrame(result->getGpuMilliseconds());
+
+    if (_frameProfiler.graphEnabled())
+    {
+        _frameProfiler.renderGraph(width, height);
+    }
+
     if (!_activeMouseTools.empty())
     {
         glMatrixMode(GL_PROJECTION);
@@ -960,6 +1005,95 @@ void CamWnd::Cam_Draw()
     glBindTexture( GL_TEXTURE_2D, 0 );
 }
 
+IRenderResult::Ptr CamWnd::renderLitScene(unsigned int allowedRenderFlags, int width, int height)
+{
+    if (!shouldReduceResolution())
+    {
+        return GlobalRenderSystem().renderLitScene(allowedRenderFlags, _view);
+    }
+
+    if (!_reducedResolutionBuffer || _reducedResolutionBuffer->getWidth() != static_cast<std::size_t>(width) ||
+        _reducedResolutionBuffer->getHeight() != static_cast<std::size_t>(height))
+    {
+        _reducedResolutionBuffer = render::FrameBuffer::CreateColourBuffer(width, height);
+
+        if (!_reducedResolutionBuffer)
+        {
+            rWarning() << "Failed to create the reduced resolution frame buffer" << std::endl;
+            return GlobalRenderSystem().renderLitScene(allowedRenderFlags, _view);
+        }
+    }
+
+    auto scaledWidth = std::max(static_cast<int>(width * _resolutionScale), 1);
+    auto scaledHeight = std::max(static_cast<int>(height * _resolutionScale), 1);
+
+    auto start = std::chrono::steady_clock::now();
+
+    _reducedResolutionBuffer->bind();
+
+    glViewport(0, 0, scaledWidth, scaledHeight);
+    glDepthMask(GL_TRUE);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    auto result = GlobalRenderSystem().renderLitScene(allowedRenderFlags, _view);
+
+    _reducedResolutionBuffer->unbind();
+
+    glViewport(0, 0, width, height);
+    _reducedResolutionBuffer->blitColour(scaledWidth, scaledHeight, width, height);
+
+    // Wait for the scene to be completed, the adaption needs the actual GPU time
+    glFinish();
+    adaptResolutionScale(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+
+    _renderedResolutionScale = static_cast<double>(scaledWidth) / width;
+
+    // Refine the image once the interaction stopped
+    _refineTimer.StartOnce(REFINE_DELAY_MSEC);
+
+    return result;
+}
+
+void CamWnd::adaptResolutionScale(double frameMilliseconds)
+{
+    // The rendering time is roughly proportional to the pixel count,
+    // which is growing with the square of the resolution scale
+    auto factor = std::sqrt(static_cast<double>(MSEC_PER_FRAME) / std::max(frameMilliseconds, 1.0));
+
+    // Avoid visible jumps between the frames
+    factor = std::clamp(factor, 0.7, 1.25);
+
+    _resolutionScale = std::clamp(_resolutionScale * factor, MIN_RESOLUTION_SCALE, 1.0);
+}
+
+void CamWnd::markInteraction()
+{
+    _lastInteraction = std::chrono::steady_clock::now();
+}
+
+bool CamWnd::shouldReduceResolution() const
+{
+    return getCameraSettings()->adaptiveResolution() && GLEW_VERSION_3_0 &&
+        std::chrono::steady_clock::now() - _lastInteraction < std::chrono::milliseconds(REFINE_DELAY_MSEC);
+}
+
+void CamWnd::onRefineTimer(wxTimerEvent& ev)
+{
+    if (_renderedResolutionScale >= 1.0) return;
+
+    auto idleTime = std::chrono::steady_clock::now() - _lastInteraction;
+
+    if (idleTime < std::chrono::milliseconds(REFINE_DELAY_MSEC))
+    {
+        // Interaction is still going on, check back later
+        auto remaining = std::chrono::milliseconds(REFINE_DELAY_MSEC) - idleTime;
+        _refineTimer.StartOnce(static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count()) + 1);
+        return;
+    }
+
+    queueDraw();
+}
+
 bool CamWnd::onRender()
 {
     if (_drawing) return false;
@@ -1004,6 +1138,21 @@ void CamWnd::onSceneGraphChange()
     update();
 }
 
+void CamWnd::onSceneBoundsDamaged(const AABB& damagedBounds)
+{
+    if (_updateRequested) return;
+
+    // In lighting mode the changed geometry is affecting the lit surfaces
+    // and shadows around it, there's no telling which part of the view changed
+    if (getCameraSettings()->getRenderMode() == RENDER_MODE_LIGHTING ||
+        _view.TestAABB(damagedBounds) != VOLUME_OUTSIDE)
+    {
+        // Geometry being changed interactively, e.g. by a manipulator
+        markInteraction();
+        update();
+    }
+}
+
 // ----------------------------------------------------------
 
 void CamWnd::addHandlersMove()
@@ -1053,6 +1202,9 @@ void CamWnd::queueDraw()
 
 void CamWnd::onIdle(wxIdleEvent& ev)
 {
+    // Pick up the geometry changes, this might queue a redraw of this view
+    GlobalSceneGraph().notifyDamagedBounds();
+
     if (!_updateRequested) return;
 
     _updateRequested = false;
@@ -1178,7 +1330,14 @@ MouseTool::Result CamWnd::processMouseMoveEvent(const MouseToolPtr& tool, int x,
         createMouseEvent(Vector2(0, 0), Vector2(x, y)) :
         createMouseEvent(Vector2(x, y));
 
-    return tool->onMouseMove(ev);
+    auto result = tool->onMouseMove(ev);
+
+    if (result != MouseTool::Result::Ignored)
+    {
+        markInteraction();
+    }
+
+    return result;
 }
 
 void CamWnd::startCapture(const ui::MouseToolPtr& tool)
@@ -1235,6 +1394,9 @@ void CamWnd::forceRedraw()
 
 void CamWnd::requestRedraw(bool force)
 {
+    // The camera has been moved
+    markInteraction();
+
     if (force)
     {
         forceRedraw();
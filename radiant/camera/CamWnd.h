@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <memory>
 #include <sigc++/connection.h>
 
@@ -23,7 +24,10 @@
 
 #include "render/CamRenderer.h"
 #include "render/RenderStatistics.h"
+#include "render/FrameProfiler.h"
+#include "render/FrameBuffer.h"
 #include "render/View.h"
+#include "registry/CachedKey.h"
 #include "util/Noncopyable.h"
 #include "Rectangle.h"
 #include "tools/CameraMouseToolEvent.h"
@@ -116,6 +120,28 @@ private:
     // Render statistics for display in the window (frame render time etc)
     render::RenderStatistics _renderStats;
 
+    // Frame time history for the frame graph and the hitch reports
+    render::FrameProfiler _frameProfiler;
+
+    // Whether the scene graph culling is spread across worker threads
+    registry::CachedKey<bool> _parallelRenderCollection;
+
+    // Target of the lit scene while rendering at a reduced resolution,
+    // allocated at window size, the reduced frames are using a part of it
+    render::FrameBuffer::Ptr _reducedResolutionBuffer;
+
+    // Fraction of the window resolution used during interaction, adapted to the frame time
+    double _resolutionScale;
+
+    // The resolution fraction the last frame has been rendered at
+    double _renderedResolutionScale;
+
+    // The last time the camera or the scene changed interactively
+    std::chrono::steady_clock::time_point _lastInteraction;
+
+    // Triggers the full-resolution frame once the interaction stopped
+    wxTimer _refineTimer;
+
     // Remembering the free movement type while holding down a key
     bool _freeMoveEnabled;
     unsigned int _freeMoveFlags;
@@ -157,6 +183,7 @@ public:
 
     // The callback when the scene gets changed
     void onSceneGraphChange() override;
+    void onSceneBoundsDamaged(const AABB& damagedBounds) override;
 
     static void captureStates();
     static void releaseStates();
@@ -275,6 +302,7 @@ private:
 
     void onFrame(wxTimerEvent& ev);
     void onFreeMoveTimer(wxTimerEvent& ev);
+    void onRefineTimer(wxTimerEvent& ev);
     void onIdle(wxIdleEvent& ev);
 
     void handleFreeMovement(float timePassed);
@@ -285,6 +313,14 @@ private:
     void performFreeMove(int dx, int dy);
 
     void handleTextureChanged(radiant::TextureChangedMessage& msg);
+
+private:
+    void markInteraction();
+    bool shouldReduceResolution() const;
+
+    // Renders the lit scene, at a reduced resolution while interacting
+    IRenderResult::Ptr renderLitScene(unsigned int allowedRenderFlags, int width, int height);
+    void adaptResolutionScale(double frameMilliseconds);
 };
 
 /**
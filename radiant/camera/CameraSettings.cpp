@@ -6,6 +6,7 @@
 #include "registry/registry.h"
 #include "util/ScopedBoolLock.h"
 #include "CameraWndManager.h"
+#include "render/FrameProfiler.h"
 #include "string/convert.h"
 #include "wxutil/dialog/MessageBox.h"
 
@@ -24,7 +25,8 @@ CameraSettings::CameraSettings() :
 	_solidSelectionBoxes(registry::getValue<bool>(RKEY_SOLID_SELECTION_BOXES)),
 	_toggleFreelook(registry::getValue<bool>(RKEY_TOGGLE_FREE_MOVE)),
     _gridEnabled(registry::getValue<bool>(RKEY_CAMERA_GRID_ENABLED)),
-    _gridSpacing(registry::getValue<int>(RKEY_CAMERA_GRID_SPACING))
+    _gridSpacing(registry::getValue<int>(RKEY_CAMERA_GRID_SPACING)),
+    _adaptiveResolution(registry::getValue<bool>(RKEY_CAMERA_ADAPTIVE_RESOLUTION))
 {
 	// Constrain the cubic scale to a fixed value
 	if (_cubicScale > MAX_CUBIC_SCALE) {
@@ -54,6 +56,7 @@ CameraSettings::CameraSettings() :
 	observeKey(RKEY_TOGGLE_FREE_MOVE);
 	observeKey(RKEY_CAMERA_GRID_ENABLED);
 	observeKey(RKEY_CAMERA_GRID_SPACING);
+	observeKey(RKEY_CAMERA_ADAPTIVE_RESOLUTION);
 
 	// greebo: Add the preference settings
 	constructPreferencePage();
@@ -97,6 +100,12 @@ void CameraSettings::constructPreferencePage()
         gridSpacings.push_back(string::to_string(i));
     }
     page.appendCombo(_("Grid spacing"), RKEY_CAMERA_GRID_SPACING, gridSpacings, true);
+
+    page.appendCheckBox(_("Reduce resolution while moving (lighting mode)"), RKEY_CAMERA_ADAPTIVE_RESOLUTION);
+
+    // The frame profiler settings apply to the ortho views too
+    page.appendCheckBox(_("Show frame time graph"), render::RKEY_SHOW_FRAME_GRAPH);
+    page.appendSpinner(_("Log frames slower than (ms, 0 = off)"), render::RKEY_HITCH_THRESHOLD, 0, 10000, 0);
 }
 
 bool CameraSettings::showCameraToolbar() const
@@ -120,6 +129,11 @@ int CameraSettings::gridSpacing() const
     return _gridSpacing;
 }
 
+bool CameraSettings::adaptiveResolution() const
+{
+    return _adaptiveResolution;
+}
+
 void CameraSettings::importDrawMode(const int mode)
 {
 	switch (mode) {
@@ -176,6 +190,7 @@ void CameraSettings::keyChanged()
 	_solidSelectionBoxes = registry::getValue<bool>(RKEY_SOLID_SELECTION_BOXES);
     _gridEnabled = registry::getValue<bool>(RKEY_CAMERA_GRID_ENABLED);
     _gridSpacing = registry::getValue<int>(RKEY_CAMERA_GRID_SPACING);
+    _adaptiveResolution = registry::getValue<bool>(RKEY_CAMERA_ADAPTIVE_RESOLUTION);
 
 	// Determine the draw mode represented by the integer registry value
 	importDrawMode(registry::getValue<int>(RKEY_DRAWMODE));
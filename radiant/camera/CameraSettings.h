@@ -35,6 +35,7 @@ namespace
     const std::string RKEY_CAMERA_FONT_STYLE = RKEY_CAMERA_ROOT + "/fontStyle";
     const std::string RKEY_CAMERA_GRID_ENABLED = RKEY_CAMERA_ROOT + "/gridEnabled";
     const std::string RKEY_CAMERA_GRID_SPACING = RKEY_CAMERA_ROOT + "/gridSpacing";
+    const std::string RKEY_CAMERA_ADAPTIVE_RESOLUTION = RKEY_CAMERA_ROOT + "/adaptiveResolution";
 }
 
 inline float calculateFarPlaneDistance(int cubicScale)
@@ -72,6 +73,8 @@ class CameraSettings: public sigc::trackable
 	bool _gridEnabled;
 	int _gridSpacing;
 
+	bool _adaptiveResolution;
+
     // Signals
     sigc::signal<void> _sigRenderModeChanged;
 
@@ -98,6 +101,9 @@ public:
     bool gridEnabled() const;
     int gridSpacing() const;
 
+    // Whether the lit camera view is rendered at a lower resolution during movement
+    bool adaptiveResolution() const;
+
 	// Sets/returns the draw mode (wireframe, solid, textured, lighting)
 	CameraDrawMode getRenderMode() const;
 	void setRenderMode(const CameraDrawMode& mode);
@@ -6,6 +6,7 @@
 #include "xmlutil/Node.h"
 
 #include "CameraSettings.h"
+#include "render/FrameProfiler.h"
 
 #include "registry/registry.h"
 #include "module/StaticModule.h"
@@ -102,6 +103,11 @@ void CameraWndManager::registerCommands()
 
 	GlobalEventManager().addRegistryToggle("ToggleCameraGrid", RKEY_CAMERA_GRID_ENABLED);
 	GlobalEventManager().addRegistryToggle("ToggleShadowMapping", RKEY_ENABLE_SHADOW_MAPPING);
+	GlobalEventManager().addRegistryToggle("ToggleLightOcclusionCulling", RKEY_ENABLE_LIGHT_OCCLUSION_CULLING);
+	GlobalEventManager().addRegistryToggle("ToggleParallelRenderCollection", RKEY_ENABLE_PARALLEL_RENDER_COLLECTION);
+	GlobalEventManager().addRegistryToggle("ToggleGpuTiming", RKEY_ENABLE_GPU_TIMING);
+	GlobalEventManager().addRegistryToggle("ToggleBindlessTextures", RKEY_ENABLE_BINDLESS_TEXTURES);
+	GlobalEventManager().addRegistryToggle("ToggleFrameGraph", render::RKEY_SHOW_FRAME_GRAPH);
 
 	GlobalEventManager().addKeyEvent("CameraMoveForward", std::bind(&CameraWndManager::onMoveForwardKey, this, std::placeholders::_1));
 	GlobalEventManager().addKeyEvent("CameraMoveBack", std::bind(&CameraWndManager::onMoveBackKey, this, std::placeholders::_1));
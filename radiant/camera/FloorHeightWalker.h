@@ -1,13 +1,19 @@
 #pragma once
 
 #include "inode.h"
+#include "iscenegraph.h"
 #include "gamelib.h"
+#include "math/Ray.h"
 
 namespace camera
 {
 
-class FloorHeightWalker :
-    public scene::NodeVisitor
+/**
+ * Finds the top faces of the brushes above and below the given position, by
+ * casting a ray upwards and downwards through the scene's space partition.
+ * The ray queries stop as soon as the nearest floor has been found.
+ */
+class FloorHeightWalker
 {
 private:
     float _current;
@@ -24,30 +30,52 @@ public:
         _bestDown = -game::current::getValue<float>("/defaults/maxWorldCoord");
     }
 
-    bool pre(const scene::INodePtr& node)
+    // Searches the floors located above and below the given x,y coordinates
+    void walk(scene::Graph& sceneGraph, double x, double y)
     {
-        if (!node->visible()) return false; // don't traverse hidden nodes
+        Ray up(Vector3(x, y, _current), Vector3(0, 0, 1));
 
-        if (Node_isBrush(node)) // this node is a floor
+        sceneGraph.foreachVisibleNodeAlongRay(up, [&](const scene::INodePtr& node, double& maxDistance)
         {
-            const AABB& aabb = node->worldAABB();
+            auto floorHeight = getFloorHeight(node, up);
 
-            float floorHeight = aabb.origin.z() + aabb.extents.z();
-
-            if (floorHeight > _current&& floorHeight < _bestUp)
+            if (floorHeight > _current && floorHeight < _bestUp)
             {
                 _bestUp = floorHeight;
+                maxDistance = _bestUp - _current; // brushes entered beyond can't do better
             }
+        }, _bestUp - _current);
+
+        Ray down(Vector3(x, y, _current), Vector3(0, 0, -1));
+
+        sceneGraph.foreachVisibleNodeAlongRay(down, [&](const scene::INodePtr& node, double& maxDistance)
+        {
+            auto floorHeight = getFloorHeight(node, down);
 
             if (floorHeight < _current && floorHeight > _bestDown)
             {
                 _bestDown = floorHeight;
+                maxDistance = _current - _bestDown;
             }
+        }, _current - _bestDown);
+    }
 
-            return false;
+private:
+    // Returns the top of the given brush if it's hit by the ray, NaN otherwise
+    static float getFloorHeight(const scene::INodePtr& node, const Ray& ray)
+    {
+        if (!Node_isBrush(node)) return std::numeric_limits<float>::quiet_NaN(); // only brushes are floors
+
+        const AABB& aabb = node->worldAABB();
+
+        double entry, exit;
+
+        if (!ray.intersectAABB(aabb, entry, exit))
+        {
+            return std::numeric_limits<float>::quiet_NaN();
         }
 
-        return true;
+        return static_cast<float>(aabb.origin.z() + aabb.extents.z());
     }
 };
 
@@ -29,9 +29,14 @@ bool Statement::empty() const
 // Invoke the registered callback
 void Statement::execute()
 {
-	if (_enabled) {
-		GlobalCommandSystem().execute(_statement);
+	if (!_enabled) return;
+
+	if (!_preparedStatement)
+	{
+		_preparedStatement = GlobalCommandSystem().prepare(_statement);
 	}
+
+	GlobalCommandSystem().executePrepared(*_preparedStatement);
 }
 
 // Override the derived keyUp method
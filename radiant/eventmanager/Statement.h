@@ -1,9 +1,11 @@
 #pragma once
 
 #include "ui/ieventmanager.h"
+#include "icommandsystem.h"
 
 #include <wx/event.h>
 #include <sigc++/connection.h>
+#include <optional>
 #include "Event.h"
 
 namespace ui
@@ -23,6 +25,9 @@ private:
     // The statement to execute
     std::string _statement;
 
+    // The statement is parsed on first execution, keyboard repeat executes it many times
+    std::optional<cmd::PreparedCommandId> _preparedStatement;
+
     // Whether this Statement reacts on keyup or keydown
     bool _reactOnKeyUp;
 
@@ -88,9 +88,9 @@ void AutoSaveTimer::onIntervalReached(wxTimerEvent& ev)
         // Stop the timer before saving
         stopTimer();
 
-        GlobalAutoSaver().performAutosave();
+        GlobalAutoSaver().performAutosaveInBackground();
 
-        // Re-start the timer after saving has finished
+        // Re-start the timer, the files might still be written in the background
         startTimer();
     }
 }
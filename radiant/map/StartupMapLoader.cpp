@@ -55,7 +55,7 @@ void StartupMapLoader::onMainFrameReady()
 
 	if (!mapToLoad.empty())
 	{
-		loadMapSafe(mapToLoad);
+		executeWithGLContext("OpenMap", mapToLoad);
 	}
 	else if (registry::getValue<bool>(RKEY_LOAD_LAST_MAP))
 	{
@@ -63,28 +63,45 @@ void StartupMapLoader::onMainFrameReady()
 
 		if (!lastMap.empty() && os::fileOrDirExists(lastMap))
 		{
-			loadMapSafe(lastMap);
+			executeWithGLContext("OpenMap", lastMap);
 		}
 	}
 	else
 	{
 		GlobalMapModule().createNewMap();
+
+		// Warm up the caches with the assets of the map which is likely to be opened next
+		if (registry::getValue<bool>(RKEY_PRELOAD_LAST_MAP))
+		{
+			_mapToPreload = GlobalMRU().getLastMapName();
+
+			if (!_mapToPreload.empty() && os::fileOrDirExists(_mapToPreload))
+			{
+				requestIdleCallback();
+			}
+		}
 	}
 }
 
-void StartupMapLoader::loadMapSafe(const std::string& mapToLoad)
+void StartupMapLoader::onIdle()
+{
+	// The images are decoded in the background, but uploaded to the shared context
+	executeWithGLContext(PRELOAD_MAP_ASSETS_CMD, _mapToPreload);
+}
+
+void StartupMapLoader::executeWithGLContext(const std::string& command, const std::string& mapPath)
 {
-	// Check if we have a valid openGL context, otherwise postpone the load
+	// Check if we have a valid openGL context, otherwise postpone the command
 	if (GlobalOpenGLContext().getSharedContext())
 	{
-		GlobalCommandSystem().executeCommand("OpenMap", mapToLoad);
+		GlobalCommandSystem().executeCommand(command, mapPath);
 		return;
 	}
 
 	// No valid context, subscribe to the extensionsInitialised signal
-	GlobalRenderSystem().signal_extensionsInitialised().connect([mapToLoad]()
+	GlobalRenderSystem().signal_extensionsInitialised().connect([command, mapPath]()
 	{
-		GlobalCommandSystem().executeCommand("OpenMap", mapToLoad);
+		GlobalCommandSystem().executeCommand(command, mapPath);
 	});
 }
 
@@ -113,6 +130,11 @@ void StartupMapLoader::initialiseModule(const IApplicationContext& ctx)
 	);
 }
 
+void StartupMapLoader::shutdownModule()
+{
+	cancelCallbacks();
+}
+
 module::StaticModuleRegistration<StartupMapLoader> startupMapLoader;
 
 } // namespace map
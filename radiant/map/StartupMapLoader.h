@@ -3,23 +3,35 @@
 #include "iradiant.h"
 #include "imodule.h"
 #include <memory>
+#include "wxutil/event/SingleIdleCallback.h"
 
 namespace map
 {
 
 class StartupMapLoader :
-	public RegisterableModule
+	public RegisterableModule,
+	protected wxutil::SingleIdleCallback
 {
+private:
+	// The map whose assets are preloaded once the UI is idle
+	std::string _mapToPreload;
+
 public:
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
 	void initialiseModule(const IApplicationContext& ctx) override;
+	void shutdownModule() override;
+
+protected:
+	void onIdle() override;
 
 private:
 	// This gets called as soon as the mainframe is shown
 	void onMainFrameReady();
 
-	void loadMapSafe(const std::string& map);
+	// Runs the command right away if the shared GL context exists, otherwise
+	// the command is postponed until the GL extensions have been initialised
+	void executeWithGLContext(const std::string& command, const std::string& mapPath);
 };
 
 } // namespace map
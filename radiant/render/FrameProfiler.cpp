@@ -0,0 +1,238 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cassert>
+#include "igl.h"
+#include "itextstream.h"
+#include <fmt/format.h>
+
+namespace render
+{
+
+namespace
+{
+    // The graph covers up to 50 ms per frame, longer frames are clipped
+    constexpr double GraphMilliseconds = 50.0;
+    constexpr int GraphHeight = 100;
+    constexpr int BarWidth = 2;
+    constexpr int GraphMargin = 4;
+
+    inline double getMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+FrameProfiler::FrameProfiler(const std::string& viewName) :
+    _viewName(viewName),
+    _nextFrame(0),
+    _numFrames(0),
+    _capturing(false),
+    _captureMarker(0),
+    _showGraph(RKEY_SHOW_FRAME_GRAPH),
+    _hitchThreshold(RKEY_HITCH_THRESHOLD)
+{}
+
+void FrameProfiler::beginFrame()
+{
+    auto* recorder = util::GlobalTraceRecorderPtr();
+
+    // Capture the trace events of this frame, in case it turns out to be a hitch
+    _capturing = recorder != nullptr && _hitchThreshold.get() > 0;
+
+    if (_capturing)
+    {
+        _captureMarker = recorder->beginCapture();
+    }
+
+    _frameStart = Clock::now();
+    _frontEndEnd = _frameStart;
+}
+
+void FrameProfiler::frontEndComplete()
+{
+    _frontEndEnd = Clock::now();
+}
+
+void FrameProfiler::endFrame(double gpuMilliseconds)
+{
+    auto now = Clock::now();
+
+    FrameTimes times;
+    times.frontEnd = getMilliseconds(_frontEndEnd - _frameStart);
+    times.backEnd = getMilliseconds(now - _frontEndEnd);
+    times.gpu = gpuMilliseconds;
+
+    _frames[_nextFrame] = times;
+    _nextFrame = (_nextFrame + 1) % NumFrames;
+    _numFrames = std::min(_numFrames + 1, NumFrames);
+
+    std::vector<util::TraceRecorder::Event> events;
+
+    if (_capturing)
+    {
+        events = util::GlobalTraceRecorderPtr()->endCapture(_captureMarker);
+        _capturing = false;
+    }
+
+    auto threshold = _hitchThreshold.get();
+
+    if (threshold > 0 && times.getTotal() > threshold)
+    {
+        reportHitch(times, std::move(events));
+    }
+}
+
+const FrameProfiler::FrameTimes& FrameProfiler::getFrame(std::size_t age) const
+{
+    assert(age < _numFrames);
+    return _frames[(_nextFrame + NumFrames - 1 - age) % NumFrames];
+}
+
+void FrameProfiler::reportHitch(const FrameTimes& times, std::vector<util::TraceRecorder::Event> events) const
+{
+    std::string report = fmt::format("{0}: frame took {1:.1f} ms (f/e: {2:.1f} ms | b/e: {3:.1f} ms | GPU: {4:.1f} ms)",
+        _viewName, times.getTotal(), times.frontEnd, times.backEnd, times.gpu);
+
+    // Group the events by thread, enclosing events go first
+    std::sort(events.begin(), events.end(), [](const auto& a, const auto& b)
+    {
+        if (a.threadIndex != b.threadIndex) return a.threadIndex < b.threadIndex;
+        if (a.startMicroseconds != b.startMicroseconds) return a.startMicroseconds < b.startMicroseconds;
+        return a.durationMicroseconds > b.durationMicroseconds;
+    });
+
+    // The times are relative to the first event
+    auto first = std::min_element(events.begin(), events.end(), [](const auto& a, const auto& b)
+    {
+        return a.startMicroseconds < b.startMicroseconds;
+    });
+    auto origin = first != events.end() ? first->startMicroseconds : 0;
+
+    // The end times of the events enclosing the current one
+    std::vector<std::int64_t> enclosingEnds;
+    std::size_t thread = 0;
+
+    for (const auto& event : events)
+    {
+        if (event.threadIndex != thread)
+        {
+            enclosingEnds.clear();
+            thread = event.threadIndex;
+        }
+
+        while (!enclosingEnds.empty() && event.startMicroseconds >= enclosingEnds.back())
+        {
+            enclosingEnds.pop_back();
+        }
+
+        report += fmt::format("\n  Thread {0} | {1:8.2f} ms | {2:8.2f} ms | {3}{4} [{5}]", event.threadIndex,
+            (event.startMicroseconds - origin) / 1000.0, event.durationMicroseconds / 1000.0,
+            std::string(enclosingEnds.size() * 2, ' '), event.name, event.category);
+
+        enclosingEnds.push_back(event.startMicroseconds + event.durationMicroseconds);
+    }
+
+    rWarning() << report << std::endl;
+}
+
+void FrameProfiler::renderGraph(int width, int height) const
+{
+    auto pixelsPerMillisecond = GraphHeight / GraphMilliseconds;
+    auto graphWidth = static_cast<int>(NumFrames) * BarWidth;
+
+    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_CURRENT_BIT | GL_LINE_BIT);
+
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+    glOrtho(0, width, 0, height, -100, 100);
+
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+    glTranslatef(GraphMargin, GraphMargin, 0);
+
+    glDisable(GL_TEXTURE_2D);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glLineWidth(1);
+
+    // Background
+    glColor4f(0, 0, 0, 0.5f);
+    glBegin(GL_QUADS);
+    glVertex2i(0, 0);
+    glVertex2i(graphWidth, 0);
+    glVertex2i(graphWidth, GraphHeight);
+    glVertex2i(0, GraphHeight);
+    glEnd();
+
+    auto clip = [&](double milliseconds)
+    {
+        return static_cast<float>(std::min(milliseconds, GraphMilliseconds) * pixelsPerMillisecond);
+    };
+
+    // Stacked front-end and back-end bars, the most recent frame on the right
+    glBegin(GL_QUADS);
+
+    for (std::size_t age = 0; age < _numFrames; ++age)
+    {
+        const auto& frame = getFrame(age);
+
+        auto right = static_cast<float>(graphWidth - static_cast<int>(age) * BarWidth);
+        auto left = right - BarWidth;
+        auto frontEnd = clip(frame.frontEnd);
+        auto total = clip(frame.getTotal());
+
+        glColor4f(0.2f, 0.8f, 0.2f, 0.9f);
+        glVertex2f(left, 0);
+        glVertex2f(right, 0);
+        glVertex2f(right, frontEnd);
+        glVertex2f(left, frontEnd);
+
+        glColor4f(0.9f, 0.8f, 0.1f, 0.9f);
+        glVertex2f(left, frontEnd);
+        glVertex2f(right, frontEnd);
+        glVertex2f(right, total);
+        glVertex2f(left, total);
+    }
+
+    glEnd();
+
+    // GPU times
+    glColor4f(0.2f, 0.8f, 1.0f, 1.0f);
+    glBegin(GL_LINE_STRIP);
+
+    for (std::size_t age = 0; age < _numFrames; ++age)
+    {
+        glVertex2f(static_cast<float>(graphWidth - static_cast<int>(age) * BarWidth) - BarWidth * 0.5f, clip(getFrame(age).gpu));
+    }
+
+    glEnd();
+
+    // Reference lines at 60 and 30 FPS, and the hitch threshold
+    glBegin(GL_LINES);
+
+    glColor4f(1, 1, 1, 0.4f);
+
+    for (auto milliseconds : { 1000.0 / 60, 1000.0 / 30 })
+    {
+        glVertex2f(0, clip(milliseconds));
+        glVertex2f(static_cast<float>(graphWidth), clip(milliseconds));
+    }
+
+    auto threshold = _hitchThreshold.get();
+
+    if (threshold > 0 && threshold < GraphMilliseconds)
+    {
+        glColor4f(1, 0.2f, 0.2f, 0.8f);
+        glVertex2f(0, clip(threshold));
+        glVertex2f(static_cast<float>(graphWidth), clip(threshold));
+    }
+
+    glEnd();
+
+    glPopAttrib();
+}
+
+}
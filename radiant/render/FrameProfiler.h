@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "registry/CachedKey.h"
+#include "time/TraceRecorder.h"
+
+namespace render
+{
+
+constexpr const char* const RKEY_SHOW_FRAME_GRAPH = "user/ui/renderSystem/showFrameGraph";
+constexpr const char* const RKEY_HITCH_THRESHOLD = "user/ui/renderSystem/hitchThreshold";
+
+/**
+ * Keeps the timings of the frames recently rendered by a view, which can be
+ * drawn as graph on top of the view. Frames taking longer than the hitch
+ * threshold are written to the log, together with the trace events that
+ * have been recorded during the frame.
+ */
+class FrameProfiler
+{
+public:
+    struct FrameTimes
+    {
+        double frontEnd = 0;
+        double backEnd = 0;
+
+        // 0 if the renderer isn't measuring the GPU time
+        double gpu = 0;
+
+        double getTotal() const
+        {
+            return frontEnd + backEnd;
+        }
+    };
+
+    static constexpr std::size_t NumFrames = 120;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::string _viewName;
+
+    // Ring buffer, _nextFrame is the slot to be written next
+    std::array<FrameTimes, NumFrames> _frames;
+    std::size_t _nextFrame;
+    std::size_t _numFrames;
+
+    Clock::time_point _frameStart;
+    Clock::time_point _frontEndEnd;
+
+    bool _capturing;
+    std::size_t _captureMarker;
+
+    registry::CachedKey<bool> _showGraph;
+    registry::CachedKey<int> _hitchThreshold;
+
+public:
+    FrameProfiler(const std::string& viewName);
+
+    // Call these around the rendering of a frame
+    void beginFrame();
+    void frontEndComplete();
+    void endFrame(double gpuMilliseconds = 0);
+
+    std::size_t getNumFrames() const
+    {
+        return _numFrames;
+    }
+
+    // The timings of the given frame, 0 is the most recent one
+    const FrameTimes& getFrame(std::size_t age) const;
+
+    bool graphEnabled() const
+    {
+        return _showGraph.get();
+    }
+
+    // Draws the frame times as bars in the lower left corner of the view.
+    // Front-end times are green, back-end times yellow, GPU times are drawn as cyan line.
+    void renderGraph(int width, int height) const;
+
+private:
+    void reportHitch(const FrameTimes& times, std::vector<util::TraceRecorder::Event> events) const;
+};
+
+}
@@ -20,6 +20,13 @@ const std::string& SceneManipulateMouseTool::getDisplayName()
     return displayName;
 }
 
+unsigned int SceneManipulateMouseTool::getRefreshMode()
+{
+    // The other views are picking up the damaged bounds of the manipulated nodes,
+    // they don't need to be redrawn if the change is outside their volume
+    return RefreshMode::Force | RefreshMode::ActiveView;
+}
+
 selection::IManipulator::Ptr SceneManipulateMouseTool::getActiveManipulator()
 {
     return GlobalSelectionSystem().getActiveManipulator();
@@ -15,6 +15,7 @@ class SceneManipulateMouseTool :
 public:
     const std::string& getName() override;
     const std::string& getDisplayName() override;
+    unsigned int getRefreshMode() override;
 
 protected:
     selection::IManipulator::Ptr getActiveManipulator() override;
@@ -534,11 +534,10 @@ const AABB& TexTool::getVisibleTexSpace()
 
 void TexTool::drawUVCoords()
 {
-    GlobalTextureToolSceneGraph().foreachNode([&](const textool::INode::Ptr& node)
-    {
-        node->render(GlobalTextureToolSelectionSystem().getSelectionMode());
-        return true;
-    });
+    auto mode = GlobalTextureToolSelectionSystem().getSelectionMode();
+
+    _uvGeometry.update(mode);
+    _uvGeometry.render(mode);
 }
 
 void TexTool::drawGrid()
@@ -15,6 +15,7 @@
 #include "wxutil/event/SingleIdleCallback.h"
 #include "tools/TextureToolMouseEvent.h"
 #include "render/TextureToolView.h"
+#include "TexToolGeometry.h"
 #include "messages/ManipulatorModeToggleRequest.h"
 #include "messages/ComponentSelectionModeToggleRequest.h"
 #include "messages/TextureChanged.h"
@@ -47,6 +48,9 @@ private:
 
     render::TextureToolView _view;
 
+    // The UV geometry of all nodes, drawn in batches
+    TexToolGeometry _uvGeometry;
+
     wxutil::FreezePointer _freezePointer;
 
 	// The shader we're working with
@@ -0,0 +1,188 @@
+#include "TexToolGeometry.h"
+
+#include <algorithm>
+#include "itexturetoolcolours.h"
+#include "render/VBO.h"
+
+namespace ui
+{
+
+TexToolGeometry::TexToolGeometry() :
+    _vbo(0),
+    _capacity(0)
+{}
+
+TexToolGeometry::~TexToolGeometry()
+{
+    render::deleteVBO(_vbo);
+}
+
+void TexToolGeometry::update(textool::SelectionMode mode)
+{
+    _vertices.clear();
+    _slotStarts.clear();
+    _selectedSurfaces.clear();
+    _unselectedSurfaces.clear();
+    _selectedVertices.clear();
+    _unselectedVertices.clear();
+
+    GlobalTextureToolSceneGraph().foreachNode([&](const textool::INode::Ptr& node)
+    {
+        _slotStarts.push_back(_vertices.size());
+
+        auto surfaceStart = static_cast<GLuint>(_vertices.size());
+        node->getSurfaceTriangles(_vertices);
+
+        auto& surfaces = mode == textool::SelectionMode::Surface && node->isSelected() ?
+            _selectedSurfaces : _unselectedSurfaces;
+
+        for (auto i = surfaceStart; i < _vertices.size(); ++i)
+        {
+            surfaces.push_back(i);
+        }
+
+        // The component vertices are part of the slot in both modes, to keep the layout stable
+        if (auto componentSelectable = std::dynamic_pointer_cast<textool::IComponentSelectable>(node))
+        {
+            componentSelectable->foreachComponentVertex([&](const Vector2& texcoord, bool selected)
+            {
+                if (mode == textool::SelectionMode::Vertex)
+                {
+                    (selected ? _selectedVertices : _unselectedVertices).push_back(static_cast<GLuint>(_vertices.size()));
+                }
+
+                _vertices.push_back(texcoord);
+            });
+        }
+
+        return true;
+    });
+
+    _slotStarts.push_back(_vertices.size());
+
+    upload();
+}
+
+void TexToolGeometry::upload()
+{
+    if (_vertices.empty()) return;
+
+    if (_vbo == 0)
+    {
+        glGenBuffers(1, &_vbo);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+
+    if (_vertices.size() > _capacity)
+    {
+        // Leave some room to grow, selections tend to become larger one step after the other
+        _capacity = _vertices.size() + _vertices.size() / 2;
+
+        glBufferData(GL_ARRAY_BUFFER, _capacity * sizeof(Vector2), nullptr, GL_DYNAMIC_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, _vertices.size() * sizeof(Vector2), _vertices.data());
+    }
+    else
+    {
+        // Upload the runs of consecutive slots that differ from the buffer contents
+        std::size_t runStart = 0;
+        std::size_t runEnd = 0;
+
+        auto uploadRun = [&]()
+        {
+            if (runEnd <= runStart) return;
+
+            glBufferSubData(GL_ARRAY_BUFFER, runStart * sizeof(Vector2),
+                (runEnd - runStart) * sizeof(Vector2), _vertices.data() + runStart);
+        };
+
+        for (std::size_t slot = 0; slot + 1 < _slotStarts.size(); ++slot)
+        {
+            auto start = _slotStarts[slot];
+            auto end = _slotStarts[slot + 1];
+
+            auto unchanged = end <= _uploadedVertices.size() &&
+                std::equal(_vertices.begin() + start, _vertices.begin() + end, _uploadedVertices.begin() + start);
+
+            if (unchanged) continue;
+
+            if (runEnd != start)
+            {
+                uploadRun();
+                runStart = start;
+            }
+
+            runEnd = end;
+        }
+
+        uploadRun();
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _uploadedVertices.swap(_vertices);
+}
+
+void TexToolGeometry::render(textool::SelectionMode mode)
+{
+    if (_uploadedVertices.empty() || _vbo == 0) return;
+
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, sizeof(Vector2), nullptr);
+
+    auto& colours = GlobalTextureToolColourSchemeManager();
+
+    glEnable(GL_BLEND);
+    glBlendColor(0, 0, 0, 0.3f);
+    glBlendFunc(GL_CONSTANT_ALPHA_EXT, GL_ONE_MINUS_CONSTANT_ALPHA_EXT);
+
+    if (!_unselectedSurfaces.empty())
+    {
+        glColor4fv(colours.getColour(mode == textool::SelectionMode::Vertex ?
+            textool::SchemeElement::SurfaceInComponentMode : textool::SchemeElement::SurfaceInSurfaceMode));
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_unselectedSurfaces.size()), GL_UNSIGNED_INT, _unselectedSurfaces.data());
+    }
+
+    if (!_selectedSurfaces.empty())
+    {
+        glColor4fv(colours.getColour(textool::SchemeElement::SelectedSurface));
+        glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(_selectedSurfaces.size()), GL_UNSIGNED_INT, _selectedSurfaces.data());
+    }
+
+    glDisable(GL_BLEND);
+
+    if (mode == textool::SelectionMode::Vertex)
+    {
+        glPointSize(5);
+        glEnable(GL_DEPTH_TEST);
+        glDepthFunc(GL_LEQUAL);
+
+        if (!_unselectedVertices.empty())
+        {
+            glColor4fv(colours.getColour(textool::SchemeElement::Vertex));
+            glDrawElements(GL_POINTS, static_cast<GLsizei>(_unselectedVertices.size()), GL_UNSIGNED_INT, _unselectedVertices.data());
+        }
+
+        if (!_selectedVertices.empty())
+        {
+            // Move the selected vertices a bit up in the Z area
+            glPushMatrix();
+            glTranslated(0, 0, 0.1);
+
+            glColor4fv(colours.getColour(textool::SchemeElement::SelectedVertex));
+            glDrawElements(GL_POINTS, static_cast<GLsizei>(_selectedVertices.size()), GL_UNSIGNED_INT, _selectedVertices.data());
+
+            glPopMatrix();
+        }
+
+        glDisable(GL_DEPTH_TEST);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glPopClientAttrib();
+}
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+#include "igl.h"
+#include "itexturetoolmodel.h"
+#include "math/Vector2.h"
+
+namespace ui
+{
+
+/**
+ * The UV space geometry of all texture tool nodes, stored in a single vertex
+ * buffer object. Every node occupies a consecutive slot in the buffer (its
+ * surface triangles followed by its component vertices), only the slots that
+ * changed since the last frame are uploaded again.
+ *
+ * Surfaces and vertices are drawn using one call for the selected and one
+ * for the unselected items, instead of issuing GL calls per node.
+ */
+class TexToolGeometry
+{
+private:
+    GLuint _vbo;
+
+    // The number of vertices the buffer object has room for
+    std::size_t _capacity;
+
+    // The vertices currently stored in the buffer object
+    std::vector<Vector2> _uploadedVertices;
+
+    // The vertices of the current frame, and the start of each node's slot
+    std::vector<Vector2> _vertices;
+    std::vector<std::size_t> _slotStarts;
+
+    std::vector<GLuint> _selectedSurfaces;
+    std::vector<GLuint> _unselectedSurfaces;
+    std::vector<GLuint> _selectedVertices;
+    std::vector<GLuint> _unselectedVertices;
+
+public:
+    TexToolGeometry();
+    ~TexToolGeometry();
+
+    TexToolGeometry(const TexToolGeometry& other) = delete;
+    TexToolGeometry& operator=(const TexToolGeometry& other) = delete;
+
+    // Collects the geometry of the texture tool scene and uploads the changed slots
+    void update(textool::SelectionMode mode);
+
+    // Draws the surfaces and (in vertex mode) the vertices collected in the last update
+    void render(textool::SelectionMode mode);
+
+private:
+    void upload();
+};
+
+}
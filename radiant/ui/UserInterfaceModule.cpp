@@ -20,6 +20,10 @@
 #include "ieditstopwatch.h"
 #include "icounter.h"
 #include "icameraview.h"
+#include "imodelcache.h"
+#include "imemoryaccounting.h"
+#include "iassetwatcher.h"
+#include "itaskscheduler.h"
 
 #include "wxutil/menu/CommandMenuItem.h"
 #include "wxutil/MultiMonitor.h"
@@ -127,6 +131,12 @@ const StringSet& UserInterfaceModule::getDependencies() const
         MODULE_EDITING_STOPWATCH,
         MODULE_COUNTER,
         MODULE_CLIPPER,
+        MODULE_MODELCACHE,
+        MODULE_SHADERSYSTEM,
+        MODULE_MEMORYACCOUNTING,
+        MODULE_ASSETWATCHER,
+        MODULE_CAMERA_MANAGER,
+        MODULE_TASKSCHEDULER,
     };
 
 	return _dependencies;
@@ -252,6 +262,49 @@ void UserInterfaceModule::initialiseModule(const IApplicationContext& ctx)
     _reloadMaterialsConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::Material)
         .connect([this]() { dispatch([]() { GlobalMainFrame().updateAllWindows(); }); });
 
+    // Models are parsed by worker threads, pick the results up in the event loop
+    _asyncModelLoadedConn = GlobalModelCache().signal_asyncLoadFinished()
+        .connect([this]() { dispatch([]() { GlobalModelCache().processAsyncLoads(); }); });
+    GlobalModelCache().setAsyncLoadingEnabled(true);
+
+    // Parse the models close to the camera first
+    _cameraChangedConn = GlobalCameraManager().signal_cameraChanged().connect([]()
+    {
+        try
+        {
+            GlobalModelCache().setAsyncLoadFocus(GlobalCameraManager().getActiveView().getCameraOrigin());
+        }
+        catch (const std::runtime_error&)
+        {} // no camera present
+    });
+
+    // Images are decoded by worker threads, the next frame will upload them
+    _asyncTextureLoadedConn = GlobalMaterialManager().signal_asyncTextureLoadFinished()
+        .connect([this]() { dispatch([]() { GlobalMainFrame().updateAllWindows(); }); });
+    GlobalMaterialManager().setAsyncTextureLoadingEnabled(true);
+
+    // The leak follow animation is driven by a timer thread, move the camera in the event loop
+    _pointTraceAnimationConn = GlobalMapModule().signal_pointTraceAnimationFrame()
+        .connect([this]() { dispatch([]() { GlobalMapModule().updatePointTraceAnimation(); }); });
+
+    // The memory samples are taken by a timer thread, collect the figures in the event loop
+    _memorySampleConn = GlobalMemoryAccounting().signal_sampleDue()
+        .connect([this]() { dispatch([]() { GlobalMemoryAccounting().logMemoryUsage(); }); });
+
+    // Changed asset files are detected by a watcher thread, reload them in the event loop
+    _assetChangesConn = GlobalAssetWatcher().signal_changesDetected().connect([this]()
+    {
+        dispatch([]()
+        {
+            GlobalAssetWatcher().processChanges();
+            GlobalMainFrame().updateAllWindows();
+        });
+    });
+
+    // Continuations of background tasks are queued by the workers, run them in the event loop
+    _mainThreadTasksConn = GlobalTaskScheduler().signal_mainThreadTasksPending()
+        .connect([this]() { dispatch([]() { GlobalTaskScheduler().processMainThreadTasks(); }); });
+
     registerControl(std::make_shared<ConsoleControl>());
     registerControl(std::make_shared<SurfaceInspectorControl>());
     registerControl(std::make_shared<LayerControl>());
@@ -290,6 +343,17 @@ void UserInterfaceModule::shutdownModule()
     _userControls.clear();
     _autosaveTimer.reset();
 
+	GlobalModelCache().setAsyncLoadingEnabled(false);
+	_asyncModelLoadedConn.disconnect();
+	_cameraChangedConn.disconnect();
+
+	GlobalMaterialManager().setAsyncTextureLoadingEnabled(false);
+	_asyncTextureLoadedConn.disconnect();
+	_pointTraceAnimationConn.disconnect();
+	_memorySampleConn.disconnect();
+	_assetChangesConn.disconnect();
+	_mainThreadTasksConn.disconnect();
+
 	wxTheApp->Unbind(DISPATCH_EVENT, &UserInterfaceModule::onDispatchEvent, this);
 
 	GlobalRadiantCore().getMessageBus().removeListener(_execFailedListener);
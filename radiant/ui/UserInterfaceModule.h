@@ -63,6 +63,13 @@ private:
 	sigc::connection _coloursUpdatedConn;
     sigc::connection _mapEditModeChangedConn;
     sigc::connection _reloadMaterialsConn;
+    sigc::connection _asyncModelLoadedConn;
+    sigc::connection _cameraChangedConn;
+    sigc::connection _asyncTextureLoadedConn;
+    sigc::connection _pointTraceAnimationConn;
+    sigc::connection _memorySampleConn;
+    sigc::connection _assetChangesConn;
+    sigc::connection _mainThreadTasksConn;
 
 	std::size_t _execFailedListener;
 	std::size_t _notificationListener;
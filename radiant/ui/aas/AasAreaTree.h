@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "ivolumetest.h"
+#include "math/AABB.h"
+
+namespace map
+{
+
+/**
+ * Bounding volume hierarchy over the areas of an AAS file. The areas are split
+ * along the longest axis of their centers until each leaf holds no more than
+ * MaxAreasPerLeaf areas. The leaves are numbered consecutively, such that
+ * clients can keep per-leaf data (like the uploaded geometry) in a vector.
+ */
+class AasAreaTree
+{
+public:
+    static constexpr std::size_t MaxAreasPerLeaf = 64;
+
+    struct Leaf
+    {
+        AABB bounds;
+        std::vector<std::size_t> areas;
+    };
+
+private:
+    struct Node
+    {
+        AABB bounds;
+
+        // Child node indices for inner nodes, the leaf index for leaf nodes
+        std::size_t first = 0;
+        std::size_t second = 0;
+        bool isLeaf = false;
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<Leaf> _leaves;
+
+public:
+    void build(const std::vector<AABB>& areaBounds)
+    {
+        clear();
+
+        if (areaBounds.empty()) return;
+
+        std::vector<std::size_t> areas(areaBounds.size());
+
+        for (std::size_t i = 0; i < areas.size(); ++i)
+        {
+            areas[i] = i;
+        }
+
+        buildNode(areaBounds, areas.begin(), areas.end());
+    }
+
+    void clear()
+    {
+        _nodes.clear();
+        _leaves.clear();
+    }
+
+    const std::vector<Leaf>& getLeaves() const
+    {
+        return _leaves;
+    }
+
+    // Invokes the functor with the index of every leaf intersecting the given volume,
+    // skipping the ones further away from the view position than the given distance
+    template<typename Functor>
+    void foreachVisibleLeaf(const VolumeTest& volume, const Vector3& viewPos, double maxDistanceSquared, Functor&& functor) const
+    {
+        if (!_nodes.empty())
+        {
+            visitNode(0, volume, viewPos, maxDistanceSquared, functor);
+        }
+    }
+
+    // Returns the squared distance of the given point to the closest point of the box
+    static double GetDistanceSquared(const AABB& bounds, const Vector3& point)
+    {
+        double distanceSquared = 0;
+
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            auto distance = std::max(std::abs(point[axis] - bounds.origin[axis]) - bounds.extents[axis], 0.0);
+            distanceSquared += distance * distance;
+        }
+
+        return distanceSquared;
+    }
+
+private:
+    // Returns the index of the node added for the given range of areas
+    std::size_t buildNode(const std::vector<AABB>& areaBounds,
+        std::vector<std::size_t>::iterator begin, std::vector<std::size_t>::iterator end)
+    {
+        auto nodeIndex = _nodes.size();
+        _nodes.emplace_back();
+
+        AABB bounds;
+        AABB centerBounds;
+
+        for (auto i = begin; i != end; ++i)
+        {
+            bounds.includeAABB(areaBounds[*i]);
+            centerBounds.includePoint(areaBounds[*i].origin);
+        }
+
+        _nodes[nodeIndex].bounds = bounds;
+
+        if (static_cast<std::size_t>(end - begin) <= MaxAreasPerLeaf)
+        {
+            _nodes[nodeIndex].isLeaf = true;
+            _nodes[nodeIndex].first = _leaves.size();
+            _leaves.push_back(Leaf{ bounds, std::vector<std::size_t>(begin, end) });
+
+            return nodeIndex;
+        }
+
+        // Split the range at the median of the area centers along the longest axis
+        auto axis = centerBounds.extents.x() >= centerBounds.extents.y() ?
+            (centerBounds.extents.x() >= centerBounds.extents.z() ? 0 : 2) :
+            (centerBounds.extents.y() >= centerBounds.extents.z() ? 1 : 2);
+
+        auto middle = begin + (end - begin) / 2;
+
+        std::nth_element(begin, middle, end, [&](std::size_t a, std::size_t b)
+        {
+            return areaBounds[a].origin[axis] < areaBounds[b].origin[axis];
+        });
+
+        // The vector might be reallocated by the recursive calls, don't hold references
+        auto first = buildNode(areaBounds, begin, middle);
+        auto second = buildNode(areaBounds, middle, end);
+
+        _nodes[nodeIndex].first = first;
+        _nodes[nodeIndex].second = second;
+
+        return nodeIndex;
+    }
+
+    template<typename Functor>
+    void visitNode(std::size_t nodeIndex, const VolumeTest& volume, const Vector3& viewPos,
+        double maxDistanceSquared, Functor& functor) const
+    {
+        const auto& node = _nodes[nodeIndex];
+
+        if (GetDistanceSquared(node.bounds, viewPos) > maxDistanceSquared ||
+            volume.TestAABB(node.bounds) == VOLUME_OUTSIDE)
+        {
+            return;
+        }
+
+        if (node.isLeaf)
+        {
+            functor(node.first);
+            return;
+        }
+
+        visitNode(node.first, volume, viewPos, maxDistanceSquared, functor);
+        visitNode(node.second, volume, viewPos, maxDistanceSquared, functor);
+    }
+};
+
+}
@@ -77,9 +77,7 @@ void AasFileControl::ensureAasFileLoaded()
 
         if (loader && loader->canLoad(stream))
         {
-            stream.seekg(0, std::ios_base::beg);
-
-            _aasFile = loader->loadFromStream(stream);
+            _aasFile = loader->loadFromFile(_info.absolutePath);
 
             // Construct a renderable to attach to the rendersystem
             _renderable.setAasFile(_aasFile);
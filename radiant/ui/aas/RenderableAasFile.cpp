@@ -1,5 +1,6 @@
 #include "RenderableAasFile.h"
 
+#include <limits>
 #include "imap.h"
 #include "iregistry.h"
 #include "ui/imainframe.h"
@@ -13,8 +14,7 @@ namespace map
 RenderableAasFile::RenderableAasFile() :
 	_renderNumbers(registry::getValue<bool>(RKEY_SHOW_AAS_AREA_NUMBERS)),
 	_hideDistantAreas(registry::getValue<bool>(RKEY_HIDE_DISTANT_AAS_AREAS)),
-	_hideDistanceSquared(registry::getValue<float>(RKEY_AAS_AREA_HIDE_DISTANCE)),
-    _renderableAreas(_visibleAreas, { 1,1,1,1 })
+	_hideDistanceSquared(registry::getValue<float>(RKEY_AAS_AREA_HIDE_DISTANCE))
 {
 	_hideDistanceSquared *= _hideDistanceSquared;
 
@@ -37,12 +37,6 @@ void RenderableAasFile::onHideDistantAreasChanged()
     _hideDistanceSquared = registry::getValue<float>(RKEY_AAS_AREA_HIDE_DISTANCE);
     _hideDistanceSquared *= _hideDistanceSquared;
 
-    if (!_hideDistantAreas)
-    {
-        _visibleAreas = _areas;
-    }
-
-    _renderableAreas.queueUpdate();
     GlobalMainFrame().updateAllWindows();
 }
 
@@ -67,43 +61,85 @@ void RenderableAasFile::onPreRender(const VolumeTest& volume)
         _textRenderer = renderSystem->captureTextRenderer(IGLFont::Style::Sans, 14);
     }
 
-    if (_hideDistantAreas)
+    // Get the camera position for distance clipping
+    auto invModelView = volume.GetModelview().getFullInverse();
+    auto viewPos = invModelView.tCol().getProjected();
+
+    double maxDistanceSquared = _hideDistantAreas ? _hideDistanceSquared : std::numeric_limits<double>::max();
+
+    // The geometry of the chunks is uploaded when they're coming into view for the first time,
+    // afterwards they're just activated and deactivated
+    std::vector<bool> isChunkVisible(_chunks.size(), false);
+    std::vector<std::size_t> visibleNumbers;
+
+    _areaTree.foreachVisibleLeaf(volume, viewPos, maxDistanceSquared, [&](std::size_t leafIndex)
     {
-        // Get the camera position for distance clipping
-        auto invModelView = volume.GetModelview().getFullInverse();
-        auto viewPos = invModelView.tCol().getProjected();
+        isChunkVisible[leafIndex] = true;
 
-        _visibleAreas.clear();
+        if (!_renderNumbers) return;
 
-        for (const auto& area : _areas)
+        for (auto areaNum : _areaTree.getLeaves()[leafIndex].areas)
         {
-            if ((area.getOrigin() - viewPos).getLengthSquared() > _hideDistanceSquared)
+            const auto& center = _aasFile->getArea(static_cast<int>(areaNum)).center;
+
+            if ((center - viewPos).getLengthSquared() <= maxDistanceSquared && volume.TestPoint(center))
             {
-                continue;
+                visibleNumbers.push_back(areaNum);
             }
-
-            _visibleAreas.push_back(area);
         }
+    });
 
-        for (auto& [areaNum, text] : _renderableNumbers)
+    for (std::size_t i = 0; i < _chunks.size(); ++i)
+    {
+        if (isChunkVisible[i])
         {
-            text.setVisible(_renderNumbers && 
-                (_aasFile->getArea(areaNum).center - viewPos).getLengthSquared() <= _hideDistanceSquared);
-            text.update(_textRenderer);
+            _chunks[i]->renderable.update(_normalShader);
         }
+        else
+        {
+            _chunks[i]->renderable.hide();
+        }
+    }
+
+    updateVisibleNumbers(visibleNumbers);
+}
+
+void RenderableAasFile::updateVisibleNumbers(std::vector<std::size_t>& visibleNumbers)
+{
+    for (auto areaNum : _visibleNumbers)
+    {
+        _isNumberVisible[areaNum] = false;
+    }
 
-        _renderableAreas.queueUpdate();
+    for (auto areaNum : visibleNumbers)
+    {
+        _isNumberVisible[areaNum] = true;
     }
-    else
+
+    // Detach the numbers that went out of view, to keep the text renderer's work small
+    for (auto areaNum : _visibleNumbers)
     {
-        for (auto& [_, text] : _renderableNumbers)
+        if (!_isNumberVisible[areaNum])
         {
-            text.setVisible(_renderNumbers);
-            text.update(_textRenderer);
+            _renderableNumbers[areaNum]->clear();
         }
     }
 
-    _renderableAreas.update(_normalShader);
+    for (auto areaNum : visibleNumbers)
+    {
+        auto& text = _renderableNumbers[areaNum];
+
+        if (!text)
+        {
+            const auto& area = _aasFile->getArea(static_cast<int>(areaNum));
+            text = std::make_unique<render::StaticRenderableText>(string::to_string(areaNum), area.center, Vector4(1, 1, 1, 1));
+        }
+
+        // Only numbers that are not attached yet are added to the renderer
+        text->update(_textRenderer);
+    }
+
+    _visibleNumbers.swap(visibleNumbers);
 }
 
 std::size_t RenderableAasFile::getHighlightFlags()
@@ -133,34 +169,42 @@ void RenderableAasFile::prepare()
 
 void RenderableAasFile::constructRenderables()
 {
-    _areas.clear();
-    _renderableNumbers.clear();
+    std::vector<AABB> areas;
+    areas.reserve(_aasFile->getNumAreas());
 
 	for (std::size_t areaNum = 0; areaNum < _aasFile->getNumAreas(); ++areaNum)
 	{
-		const IAasFile::Area& area = _aasFile->getArea(static_cast<int>(areaNum));
+		areas.push_back(_aasFile->getArea(static_cast<int>(areaNum)).bounds);
+	}
 
-		_areas.push_back(area.bounds);
+    _areaTree.build(areas);
 
-        // Allocate a new RenderableNumber for each area
-        _renderableNumbers.try_emplace(areaNum, string::to_string(areaNum), area.center, Vector4(1, 1, 1, 1));
-	}
+    _chunks.clear();
 
-    if (!_hideDistantAreas)
+    for (const auto& leaf : _areaTree.getLeaves())
     {
-        _visibleAreas = _areas;
+        auto& chunk = _chunks.emplace_back(std::make_unique<AreaChunk>());
+
+        for (auto areaNum : leaf.areas)
+        {
+            chunk->areas.push_back(areas[areaNum]);
+        }
     }
 
-    _renderableAreas.queueUpdate();
+    _renderableNumbers.clear();
+    _renderableNumbers.resize(areas.size());
+    _isNumberVisible.assign(areas.size(), false);
+    _visibleNumbers.clear();
 }
 
 void RenderableAasFile::clear()
 {
     _aasFile.reset();
-    _renderableAreas.clear();
-    _areas.clear();
-    _visibleAreas.clear();
+    _chunks.clear();
+    _areaTree.clear();
     _renderableNumbers.clear();
+    _visibleNumbers.clear();
+    _isNumberVisible.clear();
     _normalShader.reset();
     _textRenderer.reset();
 }
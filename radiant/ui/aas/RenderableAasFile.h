@@ -1,6 +1,7 @@
 #pragma once
 
-#include <map>
+#include <memory>
+#include <vector>
 #include <sigc++/trackable.h>
 
 #include "irenderable.h"
@@ -9,6 +10,7 @@
 
 #include "render/RenderableBoundingBoxes.h"
 #include "render/StaticRenderableText.h"
+#include "AasAreaTree.h"
 
 namespace map
 {
@@ -18,7 +20,9 @@ const char* const RKEY_HIDE_DISTANT_AAS_AREAS = "user/ui/aasViewer/hideDistantAr
 const char* const RKEY_AAS_AREA_HIDE_DISTANCE = "user/ui/aasViewer/hideDistance";
 
 // Renderable drawing all the area bounds of the attached AAS file,
-// optionally showing the area numbers too
+// optionally showing the area numbers too.
+// The areas are grouped by the leaves of an AasAreaTree, the bounds of each
+// leaf are uploaded once and shown as long as the leaf is in view.
 class RenderableAasFile :
     public Renderable,
 	public sigc::trackable
@@ -29,15 +33,30 @@ private:
 	ShaderPtr _normalShader;
     ITextRenderer::Ptr _textRenderer;
 
-    std::vector<AABB> _areas;
-    std::vector<AABB> _visibleAreas;
+    // The bounds of the areas in a single leaf of the tree
+    struct AreaChunk
+    {
+        std::vector<AABB> areas;
+        render::RenderableBoundingBoxes renderable;
+
+        AreaChunk() :
+            renderable(areas, { 1,1,1,1 })
+        {}
+    };
+
+    AasAreaTree _areaTree;
+    std::vector<std::unique_ptr<AreaChunk>> _chunks;
 
 	bool _renderNumbers;
 	bool _hideDistantAreas;
 	float _hideDistanceSquared;
 
-    render::RenderableBoundingBoxes _renderableAreas;
-    std::map<std::size_t, render::StaticRenderableText> _renderableNumbers;
+    // The area numbers, created when they're coming into view
+    std::vector<std::unique_ptr<render::StaticRenderableText>> _renderableNumbers;
+
+    // The areas whose numbers are currently attached to the text renderer
+    std::vector<std::size_t> _visibleNumbers;
+    std::vector<bool> _isNumberVisible;
 
 public:
 	RenderableAasFile();
@@ -56,6 +75,7 @@ public:
 private:
 	void prepare();
 	void constructRenderables();
+    void updateVisibleNumbers(std::vector<std::size_t>& visibleNumbers);
     void onHideDistantAreasChanged();
     void onShowAreaNumbersChanged();
 };
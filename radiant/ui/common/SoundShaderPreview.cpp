@@ -262,6 +262,14 @@ std::string SoundShaderPreview::getDurationOrPlaceholder(const std::string& soun
         }
     }
 
+    // The index usually knows the file already, no need to touch the VFS
+    SoundFileInfo info;
+
+    if (GlobalSoundManager().findIndexedSoundFile(soundFile, info))
+    {
+        return getDurationString(info.duration);
+    }
+
     // No duration known yet, queue a task
     loadFileDurationAsync(soundFile);
     return "--:--";
@@ -488,6 +488,13 @@ void EntityInspector::onKeyUpdatedCommon(const std::string& key)
 void EntityInspector::onKeyAdded(const std::string& key, const std::string& value)
 {
     onKeyUpdatedCommon(key);
+
+    if (_bufferKeyChanges)
+    {
+        _bufferedKeyChanges[key] = BufferedKeyChange{ false, value, false };
+        return;
+    }
+
     onKeyChange(key, value);
 }
 
@@ -495,6 +502,12 @@ void EntityInspector::onKeyRemoved(const std::string& key)
 {
     onKeyUpdatedCommon(key);
 
+    if (_bufferKeyChanges)
+    {
+        _bufferedKeyChanges[key] = BufferedKeyChange{ true, std::string(), false };
+        return;
+    }
+
     // Look up iter in the TreeIter map, and delete it from the list store
     auto i = _keyValueIterMap.find(key);
 
@@ -516,7 +529,52 @@ void EntityInspector::onKeyRemoved(const std::string& key)
 void EntityInspector::onKeyValueSetChanged(const std::string& key, const std::string& uniqueValue)
 {
     onKeyUpdatedCommon(key);
-    onKeyChange(key, uniqueValue.empty() ? _("[differing values]") : uniqueValue, uniqueValue.empty());
+
+    std::string value = uniqueValue.empty() ? _("[differing values]") : uniqueValue;
+
+    if (_bufferKeyChanges)
+    {
+        _bufferedKeyChanges[key] = BufferedKeyChange{ false, value, uniqueValue.empty() };
+        return;
+    }
+
+    onKeyChange(key, value, uniqueValue.empty());
+}
+
+void EntityInspector::applyBufferedKeyChanges()
+{
+    auto changes = std::move(_bufferedKeyChanges);
+    _bufferedKeyChanges.clear();
+
+    for (const auto& [key, change] : changes)
+    {
+        auto existing = _keyValueIterMap.find(key);
+
+        if (change.removed)
+        {
+            // Keys added and removed again during the update don't have a row
+            if (existing != _keyValueIterMap.end())
+            {
+                _kvStore->RemoveItem(existing->second);
+                _keyValueIterMap.erase(existing);
+            }
+
+            continue;
+        }
+
+        if (existing != _keyValueIterMap.end())
+        {
+            wxutil::TreeModel::Row row(existing->second, *_kvStore);
+
+            if (row[_modelCols.value].getString().ToStdString() == change.value &&
+                row[_modelCols.isMultiValue].getBool() == change.isMultiValue)
+            {
+                continue; // nothing to do
+            }
+        }
+
+        onKeyChange(key, change.value, change.isMultiValue);
+    }
 }
 
 void EntityInspector::onDefsReloaded()
@@ -781,8 +839,14 @@ void EntityInspector::onIdle()
         _selectionNeedsUpdate = false;
 
         // Fire the selection update. This will invoke onKeyAdded/onKeyChanged etc.
-        // on ourselves for every spawnarg that should be listed or removed
+        // on ourselves for every spawnarg that should be listed or removed.
+        // A key might change several times while the entities are processed,
+        // collect the changes and touch every row only once.
+        _bufferKeyChanges = true;
         _entitySelection->update();
+        _bufferKeyChanges = false;
+
+        applyBufferedKeyChanges();
 
         // After selection rescan, trigger an update of the key types
         // of all listed key/value pairs. Not all information is fully available
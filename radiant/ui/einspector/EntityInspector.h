@@ -106,6 +106,16 @@ private:
     typedef std::map<std::string, wxDataViewItem, string::ILess> TreeIterMap;
     TreeIterMap _keyValueIterMap;
 
+    // The last change of each listed key, collected during a selection update
+    struct BufferedKeyChange
+    {
+        bool removed;
+        std::string value;
+        bool isMultiValue;
+    };
+    std::map<std::string, BufferedKeyChange, string::ILess> _bufferedKeyChanges;
+    bool _bufferKeyChanges = false;
+
     // Key and value edit boxes. These remain available even for multiple entity
     // selections.
     wxTextCtrl* _keyEntry = nullptr;
@@ -204,6 +214,10 @@ private:
     // Routines shared by onKeyAdded, onKeyRemoved and onKeyValueSetChanged
     void onKeyUpdatedCommon(const std::string& key);
 
+    // Applies the key changes collected during a selection update to the rows,
+    // rows already showing the new value are left alone
+    void applyBufferedKeyChanges();
+
     void handleShowInheritedChanged();
     void updateHelpTextPanel();
     void updateHelpText(const wxutil::TreeModel::Row& row);
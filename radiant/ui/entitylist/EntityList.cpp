@@ -25,6 +25,9 @@ namespace
 	const std::string RKEY_ROOT = "user/ui/entityList/";
 	const std::string RKEY_ENTITYLIST_FOCUS_SELECTION = RKEY_ROOT + "focusSelection";
 	const std::string RKEY_ENTITYLIST_VISIBLE_ONLY = RKEY_ROOT + "visibleNodesOnly";
+
+	// Above this number of queued scenegraph changes the tree is rebuilt instead
+	const std::size_t MAX_INCREMENTAL_TREE_CHANGES = 256;
 }
 
 EntityList::EntityList(wxWindow* parent) :
@@ -75,8 +78,11 @@ void EntityList::onPanelDeactivated()
 
 void EntityList::connectListeners()
 {
-    // Observe the scenegraph
+    // Observe the scenegraph, the changes are applied to the tree on idle
     _treeModel.connectToSceneGraph();
+    _treeChangesPendingConn = _treeModel.signal_changesPending().connect(
+        sigc::mem_fun(*this, &EntityList::requestIdleCallback)
+    );
 
     // Register self to the SelSystem to get notified upon selection changes.
     GlobalSelectionSystem().addObserver(this);
@@ -90,6 +96,7 @@ void EntityList::connectListeners()
 void EntityList::disconnectListeners()
 {
     _treeModel.disconnectFromSceneGraph();
+    _treeChangesPendingConn.disconnect();
 
     // Disconnect from the filters-changed signal
     _filtersConfigChangedConn.disconnect();
@@ -176,6 +183,24 @@ void EntityList::refreshTreeModel()
     updateSelectionStatus();
 }
 
+void EntityList::flushTreeModelChanges()
+{
+    if (_treeModel.getNumPendingChanges() == 0) return;
+
+    util::ScopedBoolLock lock(_callbackActive);
+
+    // Adding thousands of rows one by one is slower than rebuilding the tree
+    if (_treeModel.getNumPendingChanges() > MAX_INCREMENTAL_TREE_CHANGES)
+    {
+        refreshTreeModel();
+        return;
+    }
+
+    wxWindowUpdateLocker freezer(_treeView);
+
+    _treeModel.flushPendingChanges();
+}
+
 void EntityList::selectionChanged(const scene::INodePtr& node, bool isComponent)
 {
     // Ignore all types except entities, also ignore components
@@ -231,6 +256,9 @@ void EntityList::expandRootNode()
 
 void EntityList::onIdle()
 {
+    // Bring the tree up to date first, the selection might refer to new rows
+    flushTreeModelChanges();
+
     if (!_nodesToUpdate.empty())
     {
         for (const auto& weakNode : _nodesToUpdate)
@@ -34,6 +34,7 @@ private:
 	wxCheckBox* _visibleOnly;
 
 	sigc::connection _filtersConfigChangedConn;
+	sigc::connection _treeChangesPendingConn;
 
     wxDataViewItem _itemToScrollToWhenIdle;
     std::vector<scene::INodeWeakPtr> _nodesToUpdate;
@@ -63,6 +64,9 @@ private:
     // Repopulate the entire treestore from the scenegraph
     void refreshTreeModel();
 
+    // Applies the scenegraph changes queued by the tree model
+    void flushTreeModelChanges();
+
 	/** 
 	 * greebo: SelectionSystem::Observer implementation.
 	 * Gets notified as soon as the selection is changed.
@@ -59,6 +59,11 @@ const GraphTreeNode::Ptr& GraphTreeModel::insert(const scene::INodePtr& node)
 }
 
 void GraphTreeModel::erase(const scene::INodePtr& node)
+{
+	erase(scene::INodeWeakPtr(node));
+}
+
+void GraphTreeModel::erase(const scene::INodeWeakPtr& node)
 {
 	auto found = _nodemap.find(node);
 
@@ -67,13 +72,13 @@ void GraphTreeModel::erase(const scene::INodePtr& node)
 		// Remove this from the model...
 		_model->RemoveItem(found->second->getIter());
 
-		// ...and from our lookup table
-		_nodemap.erase(found);
-
-        if (_mapRootNode && _mapRootNode->getNode() == node)
+        if (_mapRootNode == found->second)
         {
             _mapRootNode.reset();
         }
+
+		// ...and from our lookup table
+		_nodemap.erase(found);
 	}
 }
 
@@ -83,9 +88,66 @@ const GraphTreeNode::Ptr& GraphTreeModel::find(const scene::INodePtr& node) cons
 	return found != _nodemap.end() ? found->second : _nullTreeNode;
 }
 
+std::size_t GraphTreeModel::getNumPendingChanges() const
+{
+	return _pendingChanges.size();
+}
+
+void GraphTreeModel::flushPendingChanges()
+{
+	// Coalesce the changes, keeping the order in which the nodes showed up first
+	std::map<scene::INodeWeakPtr, bool, std::owner_less<scene::INodeWeakPtr>> lastChanges;
+	std::vector<scene::INodeWeakPtr> changedNodes;
+
+	for (const auto& [node, inserted] : _pendingChanges)
+	{
+		auto result = lastChanges.emplace(node, inserted);
+
+		if (result.second)
+		{
+			changedNodes.push_back(node);
+		}
+		else
+		{
+			result.first->second = inserted;
+		}
+	}
+
+	_pendingChanges.clear();
+
+	for (const auto& weakNode : changedNodes)
+	{
+		// Nodes removed and inserted again get a new row, they might have been renamed
+		erase(weakNode);
+
+		auto node = weakNode.lock();
+
+		if (node && lastChanges[weakNode])
+		{
+			insert(node);
+		}
+	}
+}
+
+sigc::signal<void>& GraphTreeModel::signal_changesPending()
+{
+	return _sigChangesPending;
+}
+
+void GraphTreeModel::queueChange(const scene::INodePtr& node, bool inserted)
+{
+	_pendingChanges.emplace_back(node, inserted);
+
+	if (_pendingChanges.size() == 1)
+	{
+		_sigChangesPending.emit();
+	}
+}
+
 void GraphTreeModel::clear()
 {
 	// Remove everything, wx plus nodemap
+	_pendingChanges.clear();
 	_nodemap.clear();
 	_model->Clear();
     _mapRootNode.reset();
@@ -93,6 +155,8 @@ void GraphTreeModel::clear()
 
 void GraphTreeModel::refresh()
 {
+    _pendingChanges.clear();
+
 #if defined(__linux__)
     _model->Clear();
 #else
@@ -170,14 +234,14 @@ void GraphTreeModel::onSceneNodeInsert(const scene::INodePtr& node)
 {
     if (!NodeIsRelevant(node)) return;
 
-    insert(node); // wrap to the actual insert() method
+    queueChange(node, true); // applied by the next flushPendingChanges()
 }
 
 void GraphTreeModel::onSceneNodeErase(const scene::INodePtr& node)
 {
     if (!NodeIsRelevant(node)) return;
 
-    erase(node); // wrap to the actual erase() method
+    queueChange(node, false);
 }
 
 } // namespace
@@ -2,6 +2,8 @@
 
 #include <memory>
 #include <map>
+#include <vector>
+#include <sigc++/signal.h>
 #include "iscenegraph.h"
 #include "GraphTreeNode.h"
 
@@ -16,6 +18,10 @@ namespace ui
  *
  * The class provides basic routines to insert/remove scene::INodePtrs
  * into the model (the lookup should be performed fast).
+ *
+ * Insertions and removals observed in the scenegraph are not applied
+ * right away, they are queued until flushPendingChanges() is called,
+ * such that a node inserted and removed in between is never added.
  */
 class GraphTreeModel :
 	public scene::Graph::Observer
@@ -49,6 +55,11 @@ private:
 	// The flag whether to skip invisible items
 	bool _visibleNodesOnly;
 
+	// Scenegraph insertions (true) and removals (false) in the order they have been observed
+	std::vector<std::pair<scene::INodeWeakPtr, bool>> _pendingChanges;
+
+	sigc::signal<void> _sigChangesPending;
+
 public:
 	GraphTreeModel();
 	~GraphTreeModel() override;
@@ -61,13 +72,23 @@ public:
 	// Tries to lookup the given node in the tree, can return an empty node
 	const GraphTreeNode::Ptr& find(const scene::INodePtr& node) const;
 
+	// The number of queued scenegraph changes, before coalescing them
+	std::size_t getNumPendingChanges() const;
+
+	// Applies the queued scenegraph changes to the tree, only the last change
+	// of every node is taking effect
+	void flushPendingChanges();
+
+	// Emitted when the first change is queued after a flush or refresh
+	sigc::signal<void>& signal_changesPending();
+
 	// Remove everything from the TreeModel
 	void clear();
 
 	// Set whether invisible nodes should be considered, does NOT trigger a refresh!
 	void setConsiderVisibleNodesOnly(bool visibleOnly);
 
-	// Rebuilds the entire tree using a scene::Graph::Walker
+	// Rebuilds the entire tree using a scene::Graph::Walker, dropping any pending changes.
     // This will clear the internal wxutil::TreeModel and create a new one, so be 
     // sure to associate the TreeView with the new model by calling getModel()
 	void refresh();
@@ -104,6 +125,11 @@ public:
 private:
 	// Tries to lookup the insert position for the given node
 	wxDataViewItem findParentIter(const scene::INodePtr& node);
+
+	// Removes the row of the given node, which might not exist anymore
+	void erase(const scene::INodeWeakPtr& node);
+
+	void queueChange(const scene::INodePtr& node, bool inserted);
 };
 
 } // namespace ui
@@ -13,8 +13,8 @@ namespace ui
 class GraphTreeNode
 {
 private:
-	// A reference to the actual node
-	const scene::INodePtr& _node;
+	// The actual node, might be gone while its removal is pending
+	scene::INodeWeakPtr _node;
 
 	// The iterator pointing to the row in a wxutil::TreeModel
 	wxDataViewItem _iter;
@@ -32,9 +32,9 @@ public:
 		return _iter;
 	}
 
-	const scene::INodePtr& getNode() const
+	scene::INodePtr getNode() const
 	{
-		return _node;
+		return _node.lock();
 	}
 };
 
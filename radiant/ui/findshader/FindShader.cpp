@@ -11,6 +11,7 @@
 #include "camera/tools/ShaderClipboardTools.h"
 #include "registry/registry.h"
 #include "shaderlib.h"
+#include "scene/ShaderReplacement.h"
 
 #include <wx/button.h>
 #include <wx/stattext.h>
@@ -14,6 +14,7 @@
 #include "camera/CameraWndManager.h"
 
 #include "registry/registry.h"
+#include "time/TraceRecorder.h"
 #include "wxutil/MultiMonitor.h"
 
 #include "ui/mainframe/ScreenUpdateBlocker.h"
@@ -207,6 +208,8 @@ void MainFrame::exitCmd(const cmd::ArgumentList& args)
 
 void MainFrame::postModuleInitialisation()
 {
+	util::ScopedTraceEvent trace("ui", "MainFrame post-module initialisation");
+
 	// Initialise the mainframe
 	construct();
 
@@ -259,6 +262,8 @@ void MainFrame::setDesktopCompositionEnabled(bool enabled)
 
 void MainFrame::construct()
 {
+	util::ScopedTraceEvent trace("ui", "Construct main frame");
+
 	// Create the base window and the default widgets
 	create();
 
@@ -2,11 +2,12 @@
 
 #include "i18n.h"
 #include "ishaders.h"
+#include "string/predicate.h"
 #include "string/replace.h"
 
 #include "string/split.h"
 
-#include "wxutil/dataview/VFSTreePopulator.h"
+#include "wxutil/dataview/LazyVFSTreePopulator.h"
 
 namespace ui
 {
@@ -129,16 +130,52 @@ void MaterialPopulator::PopulateModel(const wxutil::TreeModel::Ptr& model)
 {
     model->SetHasDefaultCompare(false);
 
-    wxutil::VFSTreePopulator populator(model);
+    // The rows are created when their folders are expanded, after this populator is gone,
+    // so none of the functions below must refer to it
+    auto assignValues = GetDetachedRowValueAssigner();
+    const auto& columns = _columns;
+    auto otherMaterialsPath = _otherMaterialsPath;
+    auto texturePrefix = _texturePrefix;
 
-    // Insert the "Other Materials" folder in any case
-    populator.addPath(_otherMaterialsPath, [&](wxutil::TreeModel::Row& row,
-        const std::string& path, const std::string& leafName, bool isFolder)
+    auto populator = std::make_shared<wxutil::LazyVFSTreePopulator>(_columns.leafName,
+        [assignValues, otherMaterialsPath, &columns](wxutil::TreeModel&, wxutil::TreeModel::Row& row,
+            const std::string& path, const std::string& leafName, bool isFolder)
+    {
+        auto isOtherMaterialsFolder = path == otherMaterialsPath;
+        row[columns.isOtherMaterialsFolder] = isOtherMaterialsFolder;
+
+        // The declaration name is the path without the "Other Materials" folder
+        auto declName = isFolder || isOtherMaterialsFolder || !string::starts_with(path, otherMaterialsPath + "/") ?
+            path : path.substr(otherMaterialsPath.length() + 1);
+
+        assignValues(row, path, declName, leafName, isFolder || isOtherMaterialsFolder);
+    });
+
+    populator->setSortFunction([&columns](wxutil::TreeModel& model, const wxDataViewItem& parent)
     {
-        row[_columns.isOtherMaterialsFolder] = true;
-        AssignValuesToRow(row, path, path, path, true);
+        SortModel(model, parent, columns);
     });
 
+    // Material names passed to FindString() are located through their texture path
+    populator->setPathLookupFunction([texturePrefix, otherMaterialsPath, &columns](const std::string& value,
+        const wxutil::TreeModel::Column& column)
+    {
+        if (column.getColumnIndex() == columns.fullName.getColumnIndex())
+        {
+            return value;
+        }
+
+        if (column.getColumnIndex() == columns.declName.getColumnIndex())
+        {
+            return string::istarts_with(value, texturePrefix) ? value : otherMaterialsPath + "/" + value;
+        }
+
+        return std::string();
+    });
+
+    // Insert the "Other Materials" folder in any case
+    populator->addPath(_otherMaterialsPath);
+
     GlobalMaterialManager().foreachShaderName([&](const std::string& name)
     {
         ThrowIfCancellationRequested();
@@ -147,13 +184,13 @@ void MaterialPopulator::PopulateModel(const wxutil::TreeModel::Ptr& model)
         auto texturePath = string::istarts_with(name, _texturePrefix) ?
             name : _otherMaterialsPath + "/" + name;
 
-        populator.addPath(texturePath, [&](wxutil::TreeModel::Row& row,
-            const std::string& path, const std::string& leafName, bool isFolder)
-        {
-            row[_columns.isOtherMaterialsFolder] = false;
-            AssignValuesToRow(row, path, isFolder ? path : name, leafName, isFolder);
-        });
+        populator->addPath(texturePath);
     });
+
+    ThrowIfCancellationRequested();
+
+    // Only the top level rows are created here
+    populator->populate(*model);
 }
 
 wxutil::TreeModel::Row MaterialPopulator::InsertFolder(const wxutil::TreeModel::Ptr& model, 
@@ -189,15 +226,21 @@ void MaterialPopulator::SortModel(const wxutil::TreeModel::Ptr& model)
 
 void MaterialPopulator::SortModel(const wxutil::TreeModel::Ptr& model, const wxDataViewItem& startItem)
 {
-    model->SortModelFoldersFirst(startItem, _columns.iconAndName, _columns.isFolder,
+    SortModel(*model, startItem, _columns);
+}
+
+void MaterialPopulator::SortModel(wxutil::TreeModel& model, const wxDataViewItem& startItem,
+    const MaterialTreeView::TreeColumns& columns)
+{
+    model.SortModelFoldersFirst(startItem, columns.iconAndName, columns.isFolder,
         [&](const wxDataViewItem& a, const wxDataViewItem& b)
     {
         // Special folder comparison function
         // A and B are both folders
         wxVariant aIsOtherMaterialsFolder, bIsOtherMaterialsFolder;
 
-        model->GetValue(aIsOtherMaterialsFolder, a, _columns.isOtherMaterialsFolder.getColumnIndex());
-        model->GetValue(bIsOtherMaterialsFolder, b, _columns.isOtherMaterialsFolder.getColumnIndex());
+        model.GetValue(aIsOtherMaterialsFolder, a, columns.isOtherMaterialsFolder.getColumnIndex());
+        model.GetValue(bIsOtherMaterialsFolder, b, columns.isOtherMaterialsFolder.getColumnIndex());
 
         // Special treatment for "Other Materials" folder, which always comes last
         if (aIsOtherMaterialsFolder)
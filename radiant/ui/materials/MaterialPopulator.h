@@ -42,6 +42,10 @@ private:
         const std::string& declName, const std::string& leafName, const wxDataViewItem& parentItem);
 
     void SortModel(const wxutil::TreeModel::Ptr& model, const wxDataViewItem& startItem);
+
+    // Sorts the subtree below the given item, without referring to any populator
+    static void SortModel(wxutil::TreeModel& model, const wxDataViewItem& startItem,
+        const MaterialTreeView::TreeColumns& columns);
 };
 
 }
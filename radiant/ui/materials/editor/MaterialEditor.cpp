@@ -68,6 +68,8 @@ namespace
 
     const char* const CUSTOM_BLEND_TYPE = N_("Custom");
 
+    constexpr int SOURCE_VIEW_UPDATE_INTERVAL_MSECS = 250;
+
     // Columns for the stages list
     struct StageColumns :
         public wxutil::TreeModel::ColumnRecord
@@ -138,7 +140,8 @@ MaterialEditor::MaterialEditor() :
     _materialUpdateInProgress(false),
     _previewSceneUpdateInProgress(false),
     _updateFromSourceTextInProgress(false),
-    _sourceTextUpdateInProgress(false)
+    _sourceTextUpdateInProgress(false),
+    _sourceViewUpdateLimiter(SOURCE_VIEW_UPDATE_INTERVAL_MSECS)
 {
     loadNamedPanel(this, "MaterialEditorMainPanel");
 
@@ -150,6 +153,8 @@ MaterialEditor::MaterialEditor() :
     getControl<wxButton>("MaterialEditorCloseButton")->Bind(wxEVT_BUTTON, &MaterialEditor::_onClose, this);
     getControl<wxButton>("MaterialEditorReloadImagesButton")->Bind(wxEVT_BUTTON, &MaterialEditor::_onReloadImages, this);
 
+    _sourceViewUpdateTimer.Bind(wxEVT_TIMER, &MaterialEditor::onSourceViewUpdateTimer, this);
+
     auto oldInfoPanel = getControl<wxPanel>("MaterialEditorSaveNotePanel");
     auto declFileInfo = new wxutil::DeclFileInfo(oldInfoPanel->GetParent(), decl::Type::Material);
     replaceControl(oldInfoPanel, declFileInfo);
@@ -200,6 +205,7 @@ MaterialEditor::MaterialEditor() :
 
 MaterialEditor::~MaterialEditor()
 {
+    _sourceViewUpdateTimer.Stop();
     _materialChanged.disconnect();
     _materialBindings.clear();
     _stageBindings.clear();
@@ -1795,7 +1801,7 @@ void MaterialEditor::handleMaterialSelectionChange()
 
         _materialChanged = _material->sig_materialChanged().connect([this]()
         {
-            updateSourceView();
+            queueSourceViewUpdate();
             updateMaterialTreeItem();
         });
     }
@@ -2425,6 +2431,9 @@ void MaterialEditor::updateSourceView()
 
     util::ScopedBoolLock lock(_sourceTextUpdateInProgress);
 
+    // Any pending update is covered by this one
+    _sourceViewUpdateTimer.Stop();
+
     if (_material)
     {
         // Surround the definition with curly braces, these are not included
@@ -2437,6 +2446,31 @@ void MaterialEditor::updateSourceView()
     }
 }
 
+void MaterialEditor::queueSourceViewUpdate()
+{
+    // The source text is already up to date if it's the origin of the change
+    if (_updateFromSourceTextInProgress)
+    {
+        _sourceViewUpdateTimer.Stop();
+        return;
+    }
+
+    if (_sourceViewUpdateLimiter.readyForEvent())
+    {
+        updateSourceView();
+    }
+    else
+    {
+        // Too soon after the last update, apply the change when the editing stops
+        _sourceViewUpdateTimer.StartOnce(SOURCE_VIEW_UPDATE_INTERVAL_MSECS);
+    }
+}
+
+void MaterialEditor::onSourceViewUpdateTimer(wxTimerEvent& ev)
+{
+    updateSourceView();
+}
+
 void MaterialEditor::selectStageByIndex(std::size_t index)
 {
     auto item = _stageList->FindInteger(index, STAGE_COLS().index);
@@ -3068,7 +3102,7 @@ void MaterialEditor::onMaterialChanged()
     updateMaterialPropertiesFromMaterial();
     updateMaterialTreeItem();
     updateMaterialControlSensitivity();
-    updateSourceView();
+    queueSourceViewUpdate();
 }
 
 void MaterialEditor::convertTextCtrlToMapExpressionEntry(const std::string& ctrlName)
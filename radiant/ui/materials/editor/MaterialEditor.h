@@ -2,6 +2,7 @@
 
 #include <sigc++/connection.h>
 #include <sigc++/trackable.h>
+#include <wx/timer.h>
 #include "icommandsystem.h"
 #include "ishaders.h"
 
@@ -11,6 +12,7 @@
 #include "wxutil/XmlResourceBasedWidget.h"
 #include "MaterialPreview.h"
 #include "wxutil/sourceview/SourceView.h"
+#include "EventRateLimiter.h"
 
 #include "../MaterialTreeView.h"
 #include "Binding.h"
@@ -90,6 +92,10 @@ private:
     bool _updateFromSourceTextInProgress;
     bool _sourceTextUpdateInProgress;
 
+    // Regenerating the material source is expensive, it's not done on every single change
+    EventRateLimiter _sourceViewUpdateLimiter;
+    wxTimer _sourceViewUpdateTimer;
+
     std::string _materialToPreselect;
 
 private:
@@ -171,6 +177,8 @@ private:
     void updateSettingsNotebook();
     void updateMaterialControlSensitivity();
     void updateSourceView();
+    void queueSourceViewUpdate();
+    void onSourceViewUpdateTimer(wxTimerEvent& ev);
     void updateMaterialTreeItem();
     void updateMaterialNameControl();
     void handleMaterialSelectionChange();
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "wxutil/dataview/VFSTreePopulator.h"
+#include "wxutil/dataview/LazyVFSTreePopulator.h"
 #include "wxutil/dataview/ThreadedResourceTreePopulator.h"
 #include "iregistry.h"
 #include "igame.h"
@@ -63,7 +63,26 @@ public:
 protected:
     void PopulateModel(const wxutil::TreeModel::Ptr& model) override
     {
-        wxutil::VFSTreePopulator populator(model);
+        // The rows below the top level are created when their folders are expanded,
+        // after this populator is gone, the callbacks must not refer to it
+        auto inserter = std::make_shared<ModelDataInserter>(_columns, true);
+        const auto& columns = _columns;
+
+        auto insertRow = [inserter](wxutil::TreeModel& model, wxutil::TreeModel::Row& row,
+            const std::string& path, const std::string& leafName, bool isFolder)
+        {
+            // Fill in the column data, including skins
+            inserter->visit(model, row, path, !isFolder);
+        };
+
+        auto sortChildren = [&columns](wxutil::TreeModel& model, const wxDataViewItem& parent)
+        {
+            model.SortModelFoldersFirst(parent, columns.iconAndName, columns.isFolder);
+        };
+
+        auto populator = std::make_shared<wxutil::LazyVFSTreePopulator>(_columns.leafName, insertRow);
+        populator->setSortFunction(sortChildren);
+
         constexpr const char* MODELS_FOLDER = "models/";
 
         // Search for model files
@@ -74,7 +93,7 @@ protected:
                 // Only add visible models
                 if (fileInfo.visibility == vfs::Visibility::NORMAL)
                 {
-                    visitModelFile(MODELS_FOLDER + fileInfo.name, populator);
+                    visitModelFile(MODELS_FOLDER + fileInfo.name, *populator);
                 }
             },
             0
@@ -87,9 +106,8 @@ protected:
 
         reportProgress(_("Building tree..."));
 
-        // Fill in the column data (TRUE = including skins)
-        ModelDataInserter inserterSkins(_columns, true);
-        populator.forEachNode(inserterSkins);
+        // Only the top level rows are created here
+        populator->populate(*model);
 
         reportProgress(_("Adding Model Definitions..."));
 
@@ -107,15 +125,16 @@ protected:
         modelDefs[_columns.isModelDefFolder] = true;
         modelDefs.SendItemAdded();
 
-        wxutil::VFSTreePopulator modelDefPopulator(model, modelDefs.getItem());
+        auto modelDefPopulator = std::make_shared<wxutil::LazyVFSTreePopulator>(_columns.leafName, insertRow);
+        modelDefPopulator->setSortFunction(sortChildren);
 
         GlobalEntityClassManager().forEachModelDef([&](const IModelDef::Ptr& def)
         {
             ThrowIfCancellationRequested();
-            modelDefPopulator.addPath(def->getDeclName());
+            modelDefPopulator->addPath(def->getDeclName());
         });
 
-        modelDefPopulator.forEachNode(inserterSkins);
+        modelDefPopulator->populate(*model, modelDefs.getItem());
     }
 
     void SortModel(const wxutil::TreeModel::Ptr& model) override
@@ -145,7 +164,7 @@ protected:
         });
     }
 
-    void visitModelFile(const std::string& file, wxutil::VFSTreePopulator& populator)
+    void visitModelFile(const std::string& file, wxutil::LazyVFSTreePopulator& populator)
 	{
         ThrowIfCancellationRequested();
 
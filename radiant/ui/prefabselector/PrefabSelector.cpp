@@ -31,6 +31,7 @@
 #include "string/trim.h"
 #include "string/case_conv.h"
 #include "util/ScopedBoolLock.h"
+#include <algorithm>
 #include <functional>
 
 namespace ui
@@ -51,6 +52,9 @@ namespace
     const std::string RKEY_RECENT_PREFAB_PATHS = RKEY_BASE + "recentPaths";
 	const std::string RKEY_INSERT_AS_GROUP = RKEY_BASE + "insertAsGroup";
 	const std::string RKEY_RECALCULATE_PREFAB_ORIGIN = RKEY_BASE + "recalculatePrefabOrigin";
+
+	// The number of prefabs before and after the selected one that are loaded in the background
+	const std::size_t PRELOAD_NEIGHBOURS = 8;
 }
 
 // Constructor.
@@ -415,14 +419,6 @@ void PrefabSelector::onSelectionChanged(wxutil::FileSystemView::SelectionChanged
 
     const auto& prefabPath = ev.GetSelectedPath();
 
-    _mapResource = GlobalMapResourceManager().createFromPath(prefabPath);
-
-    if (!_mapResource)
-    {
-        clearPreview();
-        return;
-    }
-
     _lastPrefab = prefabPath;
 
     // Suppress the map loading dialog to avoid user
@@ -431,26 +427,50 @@ void PrefabSelector::onSelectionChanged(wxutil::FileSystemView::SelectionChanged
         RKEY_MAP_SUPPRESS_LOAD_STATUS_DIALOG, true
     );
 
-    if (_mapResource->load())
+    try
     {
-        // Get the node from the resource
-        const auto& root = _mapResource->getRootNode();
-
-        assert(root);
+        // The preview gets its own copy, the parsed prefab is kept
+        // in the cache to be placed without loading it again
+        _prefabRoot = GlobalMapResourceManager().createPrefabCopy(prefabPath);
 
         // Set the new rootnode
-        _preview->setRootNode(root);
+        _preview->setRootNode(_prefabRoot);
 
         _preview->getWidget()->Refresh();
     }
-    else
+    catch (const IMapResource::OperationException& ex)
     {
         // Map load failed
-        rWarning() << "Could not load prefab: " << prefabPath << std::endl;
+        rWarning() << "Could not load prefab: " << prefabPath << ": " << ex.what() << std::endl;
+        _prefabRoot.reset();
         clearPreview();
     }
 
     updateUsageInfo();
+
+    // Walking through the tree will show the next prefabs without loading them first
+    preloadNeighbours(prefabPath);
+}
+
+void PrefabSelector::preloadNeighbours(const std::string& prefabPath)
+{
+    auto siblings = _treeView->GetSiblingFilePaths();
+    auto selected = std::find(siblings.begin(), siblings.end(), prefabPath);
+
+    if (selected == siblings.end()) return;
+
+    auto index = static_cast<std::size_t>(selected - siblings.begin());
+
+    // Queue the following prefabs first, they're more likely to be visited next
+    for (auto i = index + 1; i < siblings.size() && i <= index + PRELOAD_NEIGHBOURS; ++i)
+    {
+        GlobalMapResourceManager().preloadPrefab(siblings[i]);
+    }
+
+    for (auto i = index; i > 0 && i + PRELOAD_NEIGHBOURS > index; --i)
+    {
+        GlobalMapResourceManager().preloadPrefab(siblings[i - 1]);
+    }
 }
 
 void PrefabSelector::onPrefabPathSelectionChanged()
@@ -465,14 +485,11 @@ void PrefabSelector::updateUsageInfo()
 {
 	std::string usage("");
 
-	if (_mapResource && _mapResource->getRootNode())
+	if (_prefabRoot)
 	{
-		// Retrieve the root node
-		const auto& root = _mapResource->getRootNode();
-
 		// Traverse the root to find the worldspawn
 		WorldspawnArgFinder finder("editor_description");
-		root->traverse(finder);
+		_prefabRoot->traverse(finder);
 
 		usage = finder.getFoundValue();
 
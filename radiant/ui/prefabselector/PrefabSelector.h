@@ -54,7 +54,8 @@ private:
 	// Last selected prefab, 
 	std::string _lastPrefab;
 
-	IMapResourcePtr _mapResource;
+	// The copy of the selected prefab shown in the preview
+	scene::IMapRootNodePtr _prefabRoot;
 
 	wxTextCtrl* _description = nullptr;
 
@@ -99,6 +100,9 @@ private:
 	bool getRecalculatePrefabOrigin();
 
 	void updateUsageInfo();
+
+	// Loads the prefabs listed next to the given one into the prefab cache in the background
+	void preloadNeighbours(const std::string& prefabPath);
     void addCustomPathToRecentList();
 
 	void onSelectionChanged(wxutil::FileSystemView::SelectionChangedEvent& ev);
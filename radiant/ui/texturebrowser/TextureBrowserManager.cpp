@@ -7,6 +7,7 @@
 #include "ui/ieventmanager.h"
 #include "ui/iuserinterface.h"
 #include "ishaderclipboard.h"
+#include "ishaders.h"
 #include "icommandsystem.h"
 #include "ipreferencesystem.h"
 #include "module/StaticModule.h"
@@ -44,7 +45,8 @@ public:
     }
 };
 
-TextureBrowserManager::TextureBrowserManager()
+TextureBrowserManager::TextureBrowserManager() :
+    _thumbnailsReadyDispatched(false)
 {}
 
 std::string TextureBrowserManager::getSelectedShader()
@@ -80,6 +82,11 @@ void TextureBrowserManager::updateAllWindows()
     }
 }
 
+sigc::signal<void>& TextureBrowserManager::signal_thumbnailsReady()
+{
+    return _sigThumbnailsReady;
+}
+
 void TextureBrowserManager::registerPreferencePage()
 {
     // Add a page to the given group
@@ -119,6 +126,7 @@ const StringSet& TextureBrowserManager::getDependencies() const
         _dependencies.insert(MODULE_COMMANDSYSTEM);
         _dependencies.insert(MODULE_SHADERCLIPBOARD);
         _dependencies.insert(MODULE_USERINTERFACE);
+        _dependencies.insert(MODULE_SHADERSYSTEM);
     }
 
     return _dependencies;
@@ -137,6 +145,19 @@ void TextureBrowserManager::initialiseModule(const IApplicationContext& ctx)
         sigc::mem_fun(this, &TextureBrowserManager::onShaderClipboardSourceChanged)
     );
 
+    // Thumbnails are generated by worker threads, notify the browsers in the event loop.
+    // Many thumbnails are finished at once, don't dispatch another event until the first is handled.
+    _thumbnailReadyConn = GlobalMaterialManager().signal_editorImageThumbnailReady().connect([this]()
+    {
+        if (_thumbnailsReadyDispatched.exchange(true)) return;
+
+        GlobalUserInterface().dispatch([this]()
+        {
+            _thumbnailsReadyDispatched = false;
+            _sigThumbnailsReady.emit();
+        });
+    });
+
     // Register the texture browser
     GlobalUserInterface().registerControl(std::make_shared<TextureBrowserControl>());
 
@@ -154,6 +175,7 @@ void TextureBrowserManager::shutdownModule()
 {
     GlobalUserInterface().unregisterControl(UserControl::TextureBrowser);
     _shaderClipboardConn.disconnect();
+    _thumbnailReadyConn.disconnect();
 }
 
 void TextureBrowserManager::onShaderClipboardSourceChanged()
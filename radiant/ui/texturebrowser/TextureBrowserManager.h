@@ -1,7 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <set>
 #include <sigc++/connection.h>
+#include <sigc++/signal.h>
 #include "imodule.h"
 
 namespace ui
@@ -29,6 +31,10 @@ private:
     std::set<TextureBrowserPanel*> _browsers;
     sigc::connection _shaderClipboardConn;
 
+    sigc::connection _thumbnailReadyConn;
+    sigc::signal<void> _sigThumbnailsReady;
+    std::atomic<bool> _thumbnailsReadyDispatched;
+
 public:
     TextureBrowserManager();
 
@@ -42,6 +48,9 @@ public:
     // Sends an queueUpdate() call to all registered browsers
     void updateAllWindows();
 
+    // Emitted on the main thread when editor image thumbnails are ready to be picked up
+    sigc::signal<void>& signal_thumbnailsReady();
+
     static TextureBrowserManager& Instance();
 
     // RegisterableModule
@@ -9,6 +9,7 @@
 #include "ifavourites.h"
 #include "ishaderclipboard.h"
 #include "icommandsystem.h"
+#include "ishaders.h"
 
 #include "wxutil/menu/IconTextMenuItem.h"
 #include "wxutil/GLWidget.h"
@@ -21,6 +22,7 @@
 
 #include "string/split.h"
 #include "string/case_conv.h"
+#include <algorithm>
 #include <functional>
 
 #include <wx/panel.h>
@@ -49,6 +51,9 @@ namespace
 
     constexpr int VIEWPORT_BORDER = 12;
     constexpr int TILE_BORDER = 2;
+
+    // Minimum time between two refreshes while the filter text is typed
+    constexpr int FILTER_UPDATE_INTERVAL_MSECS = 150;
 }
 
 class TextureThumbnailBrowser::TextureTile
@@ -66,15 +71,12 @@ public:
 
     void render(bool drawName)
     {
-        TexturePtr texture = material->getEditorImage();
-        if (!texture) return;
-
         // Is this texture visible?
         if ((position.y() - size.y() - FONT_HEIGHT() < _owner.getOriginY()) &&
             (position.y() > _owner.getOriginY() - _owner.getViewportHeight()))
         {
             drawBorder();
-            drawTextureQuad(texture->getGLTexNum());
+            drawImage();
             if (drawName)
                 drawTextureName();
         }
@@ -153,20 +155,44 @@ private:
         }
     }
 
-    void drawTextureQuad(GLuint num)
+    void drawImage()
+    {
+        // Tiles larger than the thumbnails need the full editor image
+        bool useEditorImage = size.x() > static_cast<int>(IMaterialManager::THUMBNAIL_SIZE) ||
+            size.y() > static_cast<int>(IMaterialManager::THUMBNAIL_SIZE);
+
+        if (!useEditorImage)
+        {
+            if (auto slot = _owner.getThumbnail(material, useEditorImage); slot)
+            {
+                drawTextureQuad(slot->textureNumber, slot->s0, slot->t0, slot->s1, slot->t1);
+                return;
+            }
+        }
+
+        // Without thumbnail only the border is drawn until it is ready
+        if (!useEditorImage) return;
+
+        if (auto texture = material->getEditorImage(); texture)
+        {
+            drawTextureQuad(texture->getGLTexNum());
+        }
+    }
+
+    void drawTextureQuad(GLuint num, float s0 = 0, float t0 = 0, float s1 = 1, float t1 = 1)
     {
         glBindTexture(GL_TEXTURE_2D, num);
         debug::assertNoGlErrors();
         glColor3f(1, 1, 1);
 
         glBegin(GL_QUADS);
-        glTexCoord2i(0, 0);
+        glTexCoord2f(s0, t0);
         glVertex2i(position.x(), position.y() - FONT_HEIGHT());
-        glTexCoord2i(1, 0);
+        glTexCoord2f(s1, t0);
         glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT());
-        glTexCoord2i(1, 1);
+        glTexCoord2f(s1, t1);
         glVertex2i(position.x() + size.x(), position.y() - FONT_HEIGHT() - size.y());
-        glTexCoord2i(0, 1);
+        glTexCoord2f(s0, t1);
         glVertex2i(position.x(), position.y() - FONT_HEIGHT() - size.y());
         glEnd();
     }
@@ -206,6 +232,7 @@ TextureThumbnailBrowser::TextureThumbnailBrowser(wxWindow* parent, bool showTool
 	_filter(nullptr),
     _filterIgnoresTexturePath(true),
     _filterIsIncremental(true),
+    _filterRateLimiter(FILTER_UPDATE_INTERVAL_MSECS),
     _wxGLWidget(nullptr),
     _heightChanged(true),
     _originInvalid(true),
@@ -217,7 +244,8 @@ TextureThumbnailBrowser::TextureThumbnailBrowser(wxWindow* parent, bool showTool
     _useUniformScale(registry::getValue<bool>(RKEY_TEXTURE_USE_UNIFORM_SCALE)),
     _uniformTextureSize(registry::getValue<int>(RKEY_TEXTURE_UNIFORM_SIZE)),
     _maxNameLength(registry::getValue<int>(RKEY_TEXTURE_MAX_NAME_LENGTH)),
-    _updateNeeded(true)
+    _updateNeeded(true),
+    _thumbnails(IMaterialManager::THUMBNAIL_SIZE)
 {
     observeKey(RKEY_TEXTURE_UNIFORM_SIZE);
     observeKey(RKEY_TEXTURE_USE_UNIFORM_SCALE);
@@ -230,6 +258,13 @@ TextureThumbnailBrowser::TextureThumbnailBrowser(wxWindow* parent, bool showTool
 
     loadScaleFromRegistry();
 
+    _filterTimer.Bind(wxEVT_TIMER, &TextureThumbnailBrowser::onFilterTimer, this);
+
+    // Thumbnails which were not ready in the last draw might be available now
+    TextureBrowserManager::Instance().signal_thumbnailsReady().connect(
+        sigc::mem_fun(this, &TextureThumbnailBrowser::queueDraw)
+    );
+
     _shader = texdef_name_default();
 
     _shaderLabel = new wxutil::IconTextMenuItem(_("No shader"), TEXTURE_ICON);
@@ -377,11 +412,25 @@ void TextureThumbnailBrowser::clearFilter()
 
 void TextureThumbnailBrowser::filterChanged()
 {
-    if (_filterIsIncremental)
-	{
+    if (!_filterIsIncremental) return;
+
+    if (_filterRateLimiter.readyForEvent())
+    {
+        _filterTimer.Stop();
         queueUpdate();
         queueDraw();
-	}
+    }
+    else
+    {
+        // Too soon after the last refresh, apply the change when the typing stops
+        _filterTimer.StartOnce(FILTER_UPDATE_INTERVAL_MSECS);
+    }
+}
+
+void TextureThumbnailBrowser::onFilterTimer(wxTimerEvent& ev)
+{
+    queueUpdate();
+    queueDraw();
 }
 
 void TextureThumbnailBrowser::keyChanged()
@@ -420,14 +469,14 @@ void TextureThumbnailBrowser::keyChanged()
 }
 
 // Return the display width of a texture in the texture browser
-int TextureThumbnailBrowser::getTextureWidth(const Texture& tex) const
+int TextureThumbnailBrowser::getTextureWidth(const Vector2i& imageSize) const
 {
     if (!_useUniformScale)
     {
         // Don't use uniform scale
-        return static_cast<int>(tex.getWidth() * (static_cast<float>(_textureScale) / 100));
+        return static_cast<int>(imageSize.x() * (static_cast<float>(_textureScale) / 100));
     }
-    else if (tex.getWidth() >= tex.getHeight())
+    else if (imageSize.x() >= imageSize.y())
     {
         // Texture is square, or wider than it is tall
         return _uniformTextureSize;
@@ -436,19 +485,19 @@ int TextureThumbnailBrowser::getTextureWidth(const Texture& tex) const
     {
         // Otherwise, preserve the texture's aspect ratio
         return static_cast<int>(_uniformTextureSize *
-            (static_cast<float>(tex.getWidth()) / tex.getHeight())
+            (static_cast<float>(imageSize.x()) / imageSize.y())
         );
     }
 }
 
-int TextureThumbnailBrowser::getTextureHeight(const Texture& tex) const
+int TextureThumbnailBrowser::getTextureHeight(const Vector2i& imageSize) const
 {
     if (!_useUniformScale)
     {
         // Don't use uniform scale
-        return static_cast<int>(tex.getHeight() * (static_cast<float>(_textureScale) / 100));
+        return static_cast<int>(imageSize.y() * (static_cast<float>(_textureScale) / 100));
     }
-    else if (tex.getHeight() >= tex.getWidth())
+    else if (imageSize.y() >= imageSize.x())
     {
         // Texture is square, or taller than it is wide
         return _uniformTextureSize;
@@ -458,7 +507,7 @@ int TextureThumbnailBrowser::getTextureHeight(const Texture& tex) const
         // Otherwise, preserve the texture's aspect ratio
         return static_cast<int>(
             _uniformTextureSize
-            * (static_cast<float>(tex.getHeight()) / tex.getWidth())
+            * (static_cast<float>(imageSize.y()) / imageSize.x())
         );
     }
 }
@@ -475,9 +524,7 @@ std::string TextureThumbnailBrowser::getFilter()
 
 bool TextureThumbnailBrowser::materialIsFiltered(const std::string& materialName)
 {
-    auto filterText = getFilter();
-
-    if (filterText.empty()) return false; // not filtered
+    if (_filterWords.empty()) return false; // not filtered
 
     std::string textureName = shader_get_textureName(materialName.c_str());
 
@@ -493,12 +540,8 @@ bool TextureThumbnailBrowser::materialIsFiltered(const std::string& materialName
 
     string::to_lower(textureName);
 
-    // Split the filter text into words, every word must match (#5738)
-    std::vector<std::string> filters;
-    string::split(filters, string::to_lower_copy(filterText), " ");
-
     // case insensitive substring match (all must match for the name to be visible)
-    for (const auto& filter : filters)
+    for (const auto& filter : _filterWords)
     {
         if (textureName.find(filter) == std::string::npos)
         {
@@ -519,12 +562,12 @@ TextureThumbnailBrowser::CurrentPosition::CurrentPosition()
 : origin(VIEWPORT_BORDER, -VIEWPORT_BORDER), rowAdvance(0)
 { }
 
-Vector2i TextureThumbnailBrowser::getNextPositionForTexture(const Texture& tex)
+Vector2i TextureThumbnailBrowser::getNextPositionForTexture(const Vector2i& imageSize)
 {
     auto& currentPos = *_currentPopulationPosition;
 
-    int nWidth = getTextureWidth(tex);
-    int nHeight = getTextureHeight(tex);
+    int nWidth = getTextureWidth(imageSize);
+    int nHeight = getTextureHeight(imageSize);
 
     // Wrap to the next row if there is not enough horizontal space for this
     // texture
@@ -536,6 +579,12 @@ Vector2i TextureThumbnailBrowser::getNextPositionForTexture(const Texture& tex)
         currentPos.rowAdvance = 0;
     }
 
+    // The texture is going to be added as _tiles.back(), see createTileForMaterial()
+    if (_rows.empty() || _rows.back().top != currentPos.origin.y())
+    {
+        _rows.push_back(TileRow{ currentPos.origin.y(), 0, _tiles.size() - 1 });
+    }
+
     // Is our texture larger than the row? If so, grow the row height to match
     // it
     if (currentPos.rowAdvance < nHeight)
@@ -598,6 +647,78 @@ void TextureThumbnailBrowser::queueUpdate()
     requestIdleCallback();
 }
 
+Vector2i TextureThumbnailBrowser::getEditorImageSize(const MaterialPtr& material) const
+{
+    auto info = _thumbnailInfo.find(material->getName());
+
+    if (info == _thumbnailInfo.end())
+    {
+        // Not known before the thumbnail is ready, assume a square image
+        return Vector2i(IMaterialManager::THUMBNAIL_SIZE, IMaterialManager::THUMBNAIL_SIZE);
+    }
+
+    if (info->second.imageSize.x() > 0 && info->second.imageSize.y() > 0)
+    {
+        return info->second.imageSize;
+    }
+
+    // No editor image to load, this is going to show the fallback texture
+    auto texture = material->getEditorImage();
+
+    return texture ? Vector2i(texture->getWidth(), texture->getHeight()) :
+        Vector2i(IMaterialManager::THUMBNAIL_SIZE, IMaterialManager::THUMBNAIL_SIZE);
+}
+
+const ThumbnailAtlas::Slot* TextureThumbnailBrowser::getThumbnail(const MaterialPtr& material, bool& useEditorImage)
+{
+    const auto& name = material->getName();
+
+    useEditorImage = false;
+
+    if (auto slot = _thumbnails.find(name); slot)
+    {
+        return slot;
+    }
+
+    auto info = _thumbnailInfo.find(name);
+
+    // Request the thumbnail if it's not known yet, or if it has been evicted from the atlas
+    if (info == _thumbnailInfo.end() || info->second.inAtlas)
+    {
+        auto thumbnail = GlobalMaterialManager().getEditorImageThumbnail(name);
+
+        // Not ready yet, the thumbnail ready signal is going to trigger a redraw
+        if (!thumbnail) return nullptr;
+
+        auto previousSize = getEditorImageSize(material);
+
+        info = _thumbnailInfo.insert_or_assign(name, ThumbnailInfo
+        {
+            Vector2i(static_cast<int>(thumbnail->width), static_cast<int>(thumbnail->height)),
+            thumbnail->image != nullptr
+        }).first;
+
+        if (thumbnail->image)
+        {
+            _thumbnails.insert(name, *thumbnail->image);
+        }
+
+        // The tile has been laid out using a placeholder size
+        if (getEditorImageSize(material) != previousSize)
+        {
+            queueUpdate();
+        }
+    }
+
+    if (!info->second.inAtlas)
+    {
+        useEditorImage = true;
+        return nullptr;
+    }
+
+    return _thumbnails.find(name);
+}
+
 void TextureThumbnailBrowser::createTileForMaterial(const MaterialPtr& material)
 {
     // Create a new tile for this material
@@ -606,16 +727,38 @@ void TextureThumbnailBrowser::createTileForMaterial(const MaterialPtr& material)
 
     tile.material = material;
 
-    Texture& texture = *tile.material->getEditorImage();
+    auto imageSize = getEditorImageSize(material);
 
-    tile.position = getNextPositionForTexture(texture);
-    tile.size.x() = getTextureWidth(texture);
-    tile.size.y() = getTextureHeight(texture);
+    tile.position = getNextPositionForTexture(imageSize);
+    tile.size.x() = getTextureWidth(imageSize);
+    tile.size.y() = getTextureHeight(imageSize);
 
     _entireSpaceHeight = std::max(
         _entireSpaceHeight,
         abs(tile.position.y()) + FONT_HEIGHT() + tile.size.y() + TILE_BORDER
     );
+
+    auto& row = _rows.back();
+    row.height = std::max(row.height, FONT_HEIGHT() + tile.size.y());
+}
+
+std::pair<std::size_t, std::size_t> TextureThumbnailBrowser::getTilesInRange(int top, int bottom) const
+{
+    // The rows are sorted from top to bottom, skip the ones ending above the range
+    auto first = std::partition_point(_rows.begin(), _rows.end(), [&](const TileRow& row)
+    {
+        return row.top - row.height >= top;
+    });
+
+    auto last = std::partition_point(first, _rows.end(), [&](const TileRow& row)
+    {
+        return row.top > bottom;
+    });
+
+    auto firstTile = first != _rows.end() ? first->firstTile : _tiles.size();
+    auto lastTile = last != _rows.end() ? last->firstTile : _tiles.size();
+
+    return { firstTile, lastTile };
 }
 
 void TextureThumbnailBrowser::refreshTiles()
@@ -630,10 +773,15 @@ void TextureThumbnailBrowser::refreshTiles()
 
     // Update all renderable items
     _tiles.clear();
+    _rows.clear();
 
     _currentPopulationPosition = std::make_unique<CurrentPosition>();
     _entireSpaceHeight = 0;
 
+    // Split the filter text into words, every word must match (#5738)
+    _filterWords.clear();
+    string::split(_filterWords, string::to_lower_copy(getFilter()), " ");
+
     populateTiles();
 
     updateScroll();
@@ -676,8 +824,12 @@ MaterialPtr TextureThumbnailBrowser::getShaderAtCoords(int x, int y)
 {
     y += getOriginY() - getViewportSize().y();
 
-    for (const auto& tile : _tiles)
+    auto [first, last] = getTilesInRange(y, y);
+
+    for (auto i = first; i < last; ++i)
     {
+        const auto& tile = _tiles[i];
+
         if (x > tile->position.x() && x - tile->position.x() < tile->size.x() &&
             y < tile->position.y() && tile->position.y() - y < tile->size.y() + FONT_HEIGHT())
         {
@@ -734,9 +886,12 @@ void TextureThumbnailBrowser::draw()
     glEnable (GL_TEXTURE_2D);
 	glPolygonMode (GL_FRONT_AND_BACK, GL_FILL);
 
-    for (const auto& tile : _tiles)
+    // Only the rows overlapping the viewport are rendered
+    auto [first, last] = getTilesInRange(getOriginY(), getOriginY() - getViewportHeight());
+
+    for (auto i = first; i < last; ++i)
     {
-        tile->render(_showNamesKey.get());
+        _tiles[i]->render(_showNamesKey.get());
     }
 
 	debug::assertNoGlErrors();
@@ -8,8 +8,12 @@
 
 #include "wxutil/DockablePanel.h"
 #include "wxutil/event/SingleIdleCallback.h"
+#include "EventRateLimiter.h"
 
+#include "ThumbnailAtlas.h"
+#include <map>
 #include <optional>
+#include <wx/timer.h>
 
 namespace wxutil
 {
@@ -37,9 +41,26 @@ class TextureThumbnailBrowser :
     public wxutil::SingleIdleCallback
 {
     class TextureTile;
-    typedef std::list<std::shared_ptr<TextureTile>> TextureTiles;
+    typedef std::vector<std::shared_ptr<TextureTile>> TextureTiles;
     TextureTiles _tiles;
 
+    // A row of tiles in the virtual space, used to find the visible tiles
+    // without iterating over all of them
+    struct TileRow
+    {
+        // Y coordinate of the row's top edge
+        int top;
+
+        // Height of the tallest tile including its name
+        int height;
+
+        // Index of the row's first tile in _tiles
+        std::size_t firstTile;
+    };
+
+    // The rows of the current layout, from top to bottom
+    std::vector<TileRow> _rows;
+
     // Size of the 2D viewport. This is the geometry of the render window, not
     // the entire virtual space.
     std::optional<Vector2i> _viewportSize;
@@ -74,6 +95,13 @@ class TextureThumbnailBrowser :
     bool _filterIgnoresTexturePath;
     bool _filterIsIncremental;
 
+    // The lower case words of the filter text, updated before the tiles are populated
+    std::vector<std::string> _filterWords;
+
+    // Limits the refreshes while the filter text is typed, the timer catches the last change
+    EventRateLimiter _filterRateLimiter;
+    wxTimer _filterTimer;
+
 	wxutil::GLWidget* _wxGLWidget;
 
 	wxScrollBar* _scrollbar;
@@ -115,6 +143,21 @@ class TextureThumbnailBrowser :
     };
     std::unique_ptr<CurrentPosition> _currentPopulationPosition;
 
+    // The editor image thumbnails of the tiles drawn so far
+    ThumbnailAtlas _thumbnails;
+
+    struct ThumbnailInfo
+    {
+        // Dimensions of the full editor image, zero if it couldn't be loaded
+        Vector2i imageSize;
+
+        // False if the tile has to be drawn using the full editor image
+        bool inAtlas;
+    };
+
+    // Materials whose thumbnail has been received from the material manager
+    std::map<std::string, ThumbnailInfo> _thumbnailInfo;
+
 public:
     TextureThumbnailBrowser(wxWindow* parent, bool showToolbar = true);
 
@@ -145,7 +188,8 @@ protected:
     // Returns the currently active filter string or "" if not active.
     std::string getFilter();
 
-    // Returns true if the given material name is filtered out (should be invisible)
+    // Returns true if the given material name is filtered out (should be invisible).
+    // Only valid while the tiles are populated.
     bool materialIsFiltered(const std::string& materialName);
 
     void clearFilter();
@@ -160,13 +204,25 @@ private:
     // Repopulates the texture tiles
     void refreshTiles();
 
-    // Return the display width/height of a texture in the texture browser
-    int getTextureWidth(const Texture& tex) const;
-    int getTextureHeight(const Texture& tex) const;
+    // Return the display width/height of an image of the given size in the texture browser
+    int getTextureWidth(const Vector2i& imageSize) const;
+    int getTextureHeight(const Vector2i& imageSize) const;
 
-    // Get a new position for the given texture, and advance the CurrentPosition
+    // Get a new position for an image of the given size, and advance the CurrentPosition
     // state object.
-    Vector2i getNextPositionForTexture(const Texture& texture);
+    Vector2i getNextPositionForTexture(const Vector2i& imageSize);
+
+    // Returns the index range of the tiles in the rows overlapping the given vertical range
+    std::pair<std::size_t, std::size_t> getTilesInRange(int top, int bottom) const;
+
+    // Returns the size of the given material's editor image, as far as it is known.
+    // Tiles are laid out with a square placeholder until the thumbnail is ready.
+    Vector2i getEditorImageSize(const MaterialPtr& material) const;
+
+    // Returns the atlas slot of the given material's thumbnail, requesting the thumbnail
+    // if it's not ready yet. Returns nullptr if the tile cannot be drawn from the atlas,
+    // useEditorImage is set if the full editor image has to be drawn instead.
+    const ThumbnailAtlas::Slot* getThumbnail(const MaterialPtr& material, bool& useEditorImage);
 
     bool checkSeekInMediaBrowser(); // sensitivity check
     void onSeekInMediaBrowser();
@@ -192,6 +248,7 @@ private:
      * Callback run when filter text was changed.
      */
     void filterChanged();
+    void onFilterTimer(wxTimerEvent& ev);
 
     /** greebo: Sets the focus of the texture browser to the shader
      *          with the given name.
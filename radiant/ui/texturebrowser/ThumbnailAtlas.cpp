@@ -0,0 +1,142 @@
+#include "ThumbnailAtlas.h"
+
+#include "debugging/gl.h"
+
+namespace ui
+{
+
+namespace
+{
+    // The width and height of each page in pixels
+    constexpr std::size_t PAGE_SIZE = 1024;
+
+    // With 128 pixel thumbnails this is 1024 thumbnails in 64 MB of texture memory
+    constexpr std::size_t MAX_PAGES = 16;
+}
+
+ThumbnailAtlas::ThumbnailAtlas(std::size_t slotSize) :
+    _slotSize(slotSize)
+{}
+
+ThumbnailAtlas::~ThumbnailAtlas()
+{
+    clear();
+}
+
+const ThumbnailAtlas::Slot* ThumbnailAtlas::find(const std::string& name)
+{
+    auto entry = _entries.find(name);
+
+    if (entry == _entries.end()) return nullptr;
+
+    _usage.splice(_usage.begin(), _usage, entry->second.usage);
+
+    return &entry->second.slot;
+}
+
+void ThumbnailAtlas::insert(const std::string& name, const Image& thumbnail)
+{
+    auto width = thumbnail.getWidth();
+    auto height = thumbnail.getHeight();
+
+    if (width == 0 || height == 0 || width > _slotSize || height > _slotSize) return;
+
+    auto existing = _entries.find(name);
+
+    if (existing != _entries.end())
+    {
+        _freeSlots.push_back(existing->second.slotIndex);
+        _usage.erase(existing->second.usage);
+        _entries.erase(existing);
+    }
+
+    auto slotIndex = allocateSlot();
+
+    auto slotsPerRow = PAGE_SIZE / _slotSize;
+    auto slotsPerPage = slotsPerRow * slotsPerRow;
+    auto page = slotIndex / slotsPerPage;
+    auto x = (slotIndex % slotsPerPage) % slotsPerRow * _slotSize;
+    auto y = (slotIndex % slotsPerPage) / slotsPerRow * _slotSize;
+
+    glBindTexture(GL_TEXTURE_2D, _pages[page]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, static_cast<GLint>(x), static_cast<GLint>(y),
+        static_cast<GLsizei>(width), static_cast<GLsizei>(height), GL_RGBA, GL_UNSIGNED_BYTE, thumbnail.getPixels());
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    debug::assertNoGlErrors();
+
+    // Keep the texture coordinates half a texel inside, the neighbouring slots must not bleed in
+    constexpr float halfTexel = 0.5f / PAGE_SIZE;
+
+    Slot slot
+    {
+        _pages[page],
+        static_cast<float>(x) / PAGE_SIZE + halfTexel,
+        static_cast<float>(y) / PAGE_SIZE + halfTexel,
+        static_cast<float>(x + width) / PAGE_SIZE - halfTexel,
+        static_cast<float>(y + height) / PAGE_SIZE - halfTexel
+    };
+
+    _usage.push_front(name);
+    _entries.emplace(name, Entry{ slotIndex, slot, _usage.begin() });
+}
+
+void ThumbnailAtlas::clear()
+{
+    if (!_pages.empty())
+    {
+        glDeleteTextures(static_cast<GLsizei>(_pages.size()), _pages.data());
+    }
+
+    _pages.clear();
+    _freeSlots.clear();
+    _entries.clear();
+    _usage.clear();
+}
+
+std::size_t ThumbnailAtlas::allocateSlot()
+{
+    if (_freeSlots.empty() && _pages.size() < MAX_PAGES)
+    {
+        GLuint page;
+        glGenTextures(1, &page);
+        glBindTexture(GL_TEXTURE_2D, page);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        auto slotsPerRow = PAGE_SIZE / _slotSize;
+        auto slotsPerPage = slotsPerRow * slotsPerRow;
+
+        // Hand out the slots in order, the free list is used from the back
+        for (auto i = slotsPerPage; i > 0; --i)
+        {
+            _freeSlots.push_back(_pages.size() * slotsPerPage + i - 1);
+        }
+
+        _pages.push_back(page);
+    }
+
+    if (_freeSlots.empty())
+    {
+        // All pages are full, evict the least recently drawn thumbnail
+        auto oldest = _entries.find(_usage.back());
+
+        _freeSlots.push_back(oldest->second.slotIndex);
+        _entries.erase(oldest);
+        _usage.pop_back();
+    }
+
+    auto slotIndex = _freeSlots.back();
+    _freeSlots.pop_back();
+
+    return slotIndex;
+}
+
+}
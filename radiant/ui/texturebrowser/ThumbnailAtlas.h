@@ -0,0 +1,81 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include "igl.h"
+#include "iimage.h"
+
+namespace ui
+{
+
+/**
+ * \brief
+ * Packs the editor image thumbnails shown by a texture browser into a few
+ * large GL textures.
+ *
+ * Each atlas page is divided into square slots of the thumbnail size. The
+ * number of pages is limited, once all slots are taken the least recently
+ * drawn thumbnail is evicted to make room for the new one. Requires a
+ * current GL context for all operations.
+ */
+class ThumbnailAtlas
+{
+public:
+    // The location of a thumbnail within one of the atlas pages
+    struct Slot
+    {
+        GLuint textureNumber;
+
+        // Texture coordinates of the top left and bottom right corners
+        float s0;
+        float t0;
+        float s1;
+        float t1;
+    };
+
+private:
+    struct Entry
+    {
+        std::size_t slotIndex;
+        Slot slot;
+        std::list<std::string>::iterator usage;
+    };
+
+    std::size_t _slotSize;
+
+    std::vector<GLuint> _pages;
+
+    // Unused slot indices, a slot index is page * SLOTS_PER_PAGE + slot
+    std::vector<std::size_t> _freeSlots;
+
+    std::map<std::string, Entry> _entries;
+
+    // Names of the stored thumbnails, the most recently drawn first
+    std::list<std::string> _usage;
+
+public:
+    // Construct an atlas storing thumbnails up to the given size
+    ThumbnailAtlas(std::size_t slotSize);
+    ~ThumbnailAtlas();
+
+    ThumbnailAtlas(const ThumbnailAtlas&) = delete;
+    ThumbnailAtlas& operator=(const ThumbnailAtlas&) = delete;
+
+    // Returns the slot of the named thumbnail and marks it as recently drawn.
+    // Returns nullptr if there's no such thumbnail in the atlas.
+    const Slot* find(const std::string& name);
+
+    // Uploads the given thumbnail, replacing any previous one with the same name.
+    // The image must be RGBA and not larger than the slot size.
+    void insert(const std::string& name, const Image& thumbnail);
+
+    // Removes all thumbnails and releases the pages
+    void clear();
+
+private:
+    std::size_t allocateSlot();
+};
+
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include "igl.h"
+#include "math/Vector2.h"
+#include "render/VBO.h"
+
+namespace ui
+{
+
+/**
+ * The vertices of one grid layer (minor or major) of an ortho view, stored
+ * in a vertex buffer object. The owning view is supposed to re-generate
+ * the vertices only when the key describing the visible grid changes.
+ */
+class GridGeometry
+{
+public:
+    // Everything the vertices of a grid layer are depending on
+    struct Key
+    {
+        int look = -1;
+        double xb = 0, xe = 0, yb = 0, ye = 0;
+        double step = 0;
+        double minorStep = 0;
+        double density = 0;
+        double crossSize = 0;
+        int mask = 0;
+        bool isMajor = false;
+
+        bool operator==(const Key& other) const
+        {
+            return look == other.look && xb == other.xb && xe == other.xe &&
+                yb == other.yb && ye == other.ye && step == other.step &&
+                minorStep == other.minorStep && density == other.density &&
+                crossSize == other.crossSize && mask == other.mask && isMajor == other.isMajor;
+        }
+    };
+
+private:
+    Key _key;
+    bool _isValid;
+
+    GLuint _vbo;
+    GLenum _mode;
+    GLsizei _numVertices;
+
+public:
+    GridGeometry() :
+        _isValid(false),
+        _vbo(0),
+        _mode(GL_POINTS),
+        _numVertices(0)
+    {}
+
+    GridGeometry(const GridGeometry& other) = delete;
+    GridGeometry& operator=(const GridGeometry& other) = delete;
+
+    ~GridGeometry()
+    {
+        render::deleteVBO(_vbo);
+    }
+
+    bool isUpToDate(const Key& key) const
+    {
+        return _isValid && _key == key;
+    }
+
+    // Uploads the vertices generated for the given key
+    void update(const Key& key, GLenum mode, const std::vector<Vector2>& vertices)
+    {
+        if (_vbo == 0)
+        {
+            glGenBuffers(1, &_vbo);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vector2),
+            !vertices.empty() ? vertices.data() : nullptr, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        _key = key;
+        _isValid = true;
+        _mode = mode;
+        _numVertices = static_cast<GLsizei>(vertices.size());
+    }
+
+    // Draws the vertices using the current colour and point size
+    void render() const
+    {
+        if (_numVertices == 0) return;
+
+        glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_DOUBLE, sizeof(Vector2), nullptr);
+
+        glDrawArrays(_mode, 0, _numVertices);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glPopClientAttrib();
+    }
+};
+
+}
@@ -64,6 +64,10 @@ namespace
 {
     constexpr const char* const RKEY_XYVIEW_ROOT = "user/ui/xyview";
     constexpr const char* const RKEY_SELECT_EPSILON = "user/ui/selectionEpsilon";
+
+    // Manipulators and size info are drawn around the changed geometry
+    // using a fixed size in screen space
+    constexpr double DAMAGE_MARGIN_PIXELS = 128;
 }
 
 int XYWnd::_nextId = 1;
@@ -81,7 +85,9 @@ XYWnd::XYWnd(wxWindow* parent, XYWndManager& owner) :
 	_defaultCursor(wxCURSOR_DEFAULT),
 	_crossHairCursor(wxCURSOR_CROSS),
 	_chasingMouse(false),
-	_isActive(false)
+	_isActive(false),
+	_parallelRenderCollection(RKEY_ENABLE_PARALLEL_RENDER_COLLECTION),
+	_frameProfiler("Ortho view")
 {
     _owner.registerXYWnd(this);
 
@@ -314,6 +320,18 @@ void XYWnd::onSceneGraphChange()
     queueDraw();
 }
 
+void XYWnd::onSceneBoundsDamaged(const AABB& damagedBounds)
+{
+    if (_updateRequested) return;
+
+    AABB bounds(damagedBounds.origin, damagedBounds.extents + Vector3(1, 1, 1) * (DAMAGE_MARGIN_PIXELS / _scale));
+
+    if (_view.TestAABB(bounds) != VOLUME_OUTSIDE)
+    {
+        queueDraw();
+    }
+}
+
 void XYWnd::updateFont()
 {
     // Clear out the font reference, it will be re-acquired
@@ -666,6 +684,88 @@ Vector4 XYWnd::getWindowCoordinates() {
     return Vector4(xb, xe, yb, ye);
 }
 
+namespace
+{
+
+// Generates the vertices of a grid layer, returns the primitive type to draw them with
+GLenum createGridVertices(const GridGeometry::Key& key, std::vector<Vector2>& vertices)
+{
+    switch (key.look)
+    {
+        case GRIDLOOK_DOTS:
+        case GRIDLOOK_BIGDOTS:
+        case GRIDLOOK_SQUARES:
+            for (double x = key.xb; x < key.xe; x += key.step)
+            {
+                for (double y = key.yb; y < key.ye; y += key.step)
+                {
+                    vertices.emplace_back(x, y);
+                }
+            }
+            return GL_POINTS;
+
+        case GRIDLOOK_MOREDOTLINES:
+        case GRIDLOOK_DOTLINES:
+            for (double x = key.xb; x < key.xe; x += key.step)
+            {
+                for (double y = key.yb; y < key.ye; y += key.minorStep / key.density)
+                {
+                    vertices.emplace_back(x, y);
+                }
+            }
+
+            for (double y = key.yb; y < key.ye; y += key.step)
+            {
+                for (double x = key.xb; x < key.xe; x += key.minorStep / key.density)
+                {
+                    vertices.emplace_back(x, y);
+                }
+            }
+            return GL_POINTS;
+
+        case GRIDLOOK_CROSSES:
+            for (double x = key.xb; x <= key.xe; x += key.step)
+            {
+                for (double y = key.yb; y <= key.ye; y += key.step)
+                {
+                    vertices.emplace_back(x - key.crossSize, y);
+                    vertices.emplace_back(x + key.crossSize, y);
+                    vertices.emplace_back(x, y - key.crossSize);
+                    vertices.emplace_back(x, y + key.crossSize);
+                }
+            }
+            return GL_LINES;
+
+        case GRIDLOOK_LINES:
+        default:
+        {
+            int i = 0;
+            for (double x = key.xb; x < key.xe; x += key.step, ++i)
+            {
+                if (key.isMajor || (i & key.mask) != 0) // greebo: No mask check for major grid
+                {
+                    vertices.emplace_back(x, key.yb);
+                    vertices.emplace_back(x, key.ye);
+                }
+            }
+
+            i = 0;
+
+            for (double y = key.yb; y < key.ye; y += key.step, ++i)
+            {
+                if (key.isMajor || (i & key.mask) != 0) // greebo: No mask check for major grid
+                {
+                    vertices.emplace_back(key.xb, y);
+                    vertices.emplace_back(key.xe, y);
+                }
+            }
+            return GL_LINES;
+        }
+    }
+}
+
+}
+
 void XYWnd::drawGrid()
 {
     double step, minor_step, stepx, stepy;
@@ -758,113 +858,53 @@ void XYWnd::drawGrid()
                 sizeFactor = 0.95;
             }
 
-            switch (look)
+            if (look == GRIDLOOK_MOREDOTLINES)
             {
-                case GRIDLOOK_DOTS:
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
-                    break;
+                density = 8;
+            }
 
+            GridGeometry::Key key;
+            key.look = look;
+            key.xb = xb;
+            key.xe = xe;
+            key.yb = yb;
+            key.ye = ye;
+            key.step = cur_step;
+            key.minorStep = minor_step;
+            key.density = density;
+            key.crossSize = sizeFactor / _scale;
+            key.mask = mask;
+            key.isMajor = gf == 1;
+
+            // The vertices only change when the view is zoomed or panned across a major step
+            auto& geometry = _gridGeometry[gf];
+
+            if (!geometry.isUpToDate(key))
+            {
+                std::vector<Vector2> vertices;
+                auto mode = createGridVertices(key, vertices);
+
+                geometry.update(key, mode, vertices);
+            }
+
+            switch (look)
+            {
                 case GRIDLOOK_BIGDOTS:
                     glPointSize(3);
                     glEnable(GL_POINT_SMOOTH);
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
+                    geometry.render();
                     glDisable(GL_POINT_SMOOTH);
                     glPointSize(1);
                     break;
 
                 case GRIDLOOK_SQUARES:
                     glPointSize(3);
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += cur_step)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
+                    geometry.render();
                     glPointSize(1);
                     break;
 
-                case GRIDLOOK_MOREDOTLINES:
-                    density = 8;
-
-                case GRIDLOOK_DOTLINES:
-                    glBegin (GL_POINTS);
-                    for (double x = xb ; x < xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y < ye ; y += minor_step / density)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-
-                    for (double y = yb ; y < ye ; y += cur_step)
-                    {
-                        for (double x = xb ; x < xe ; x += minor_step / density)
-                        {
-                            glVertex2d (x, y);
-                        }
-                    }
-                    glEnd();
-                    break;
-
-                case GRIDLOOK_CROSSES:
-                    glBegin (GL_LINES);
-                    for (double x = xb ; x <= xe ; x += cur_step)
-                    {
-                        for (double y = yb ; y <= ye ; y += cur_step)
-                        {
-                            glVertex2d (x - sizeFactor / _scale, y);
-                            glVertex2d (x + sizeFactor / _scale, y);
-                            glVertex2d (x, y - sizeFactor / _scale);
-                            glVertex2d (x, y + sizeFactor / _scale);
-                        }
-                    }
-                    glEnd();
-                    break;
-
-                case GRIDLOOK_LINES:
                 default:
-                    glBegin (GL_LINES);
-                    int i = 0;
-                    for (double x = xb ; x < xe ; x += cur_step, ++i)
-                    {
-                        if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
-                        {
-                            glVertex2d (x, yb);
-                            glVertex2d (x, ye);
-                        }
-                    }
-
-                    i = 0;
-
-                    for (double y = yb ; y < ye ; y += cur_step, ++i)
-                    {
-                        if (gf == 1 || (i & mask) != 0) // greebo: No mask check for major grid
-                        {
-                            glVertex2d (xb, y);
-                            glVertex2d (xe, y);
-                        }
-                    }
-
-                    glEnd();
+                    geometry.render();
                     break;
             }
         }
@@ -1410,6 +1450,8 @@ void XYWnd::updateModelview() {
 
 void XYWnd::draw()
 {
+    _frameProfiler.beginFrame();
+
     ensureFont();
 
     // clear
@@ -1468,9 +1510,13 @@ void XYWnd::draw()
         XYRenderer renderer(flagsMask, _highlightShaders);
 
         // First pass (scenegraph traversal)
-        render::RenderableCollectionWalker::CollectRenderablesInScene(renderer,
-                                                                      _view);
+        {
+            util::ScopedTraceEvent trace("render", "Collect renderables");
+            render::RenderableCollectionWalker::CollectRenderablesInScene(renderer,
+                                                                          _view, _parallelRenderCollection.get());
+        }
 
+        _frameProfiler.frontEndComplete();
 
 		// Render any active mousetools
 		for (const ActiveMouseTools::value_type& i : _activeMouseTools)
@@ -1616,6 +1662,13 @@ void XYWnd::draw()
 
     debug::assertNoGlErrors();
 
+    _frameProfiler.endFrame();
+
+    if (_frameProfiler.graphEnabled())
+    {
+        _frameProfiler.renderGraph(_width, _height);
+    }
+
     // Reset the depth mask to its initial value (enabled)
     glDepthMask(GL_TRUE);
     debug::assertNoGlErrors();
@@ -1695,6 +1748,9 @@ void XYWnd::onIdle(wxIdleEvent& ev)
 		performChaseMouse();
 	}
 
+    // Pick up the geometry changes, this might queue a redraw of this view
+    GlobalSceneGraph().notifyDamagedBounds();
+
     if (_updateRequested)
     {
         _updateRequested = false;
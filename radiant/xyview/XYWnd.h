@@ -17,11 +17,14 @@
 #include <sigc++/connection.h>
 
 #include "render/View.h"
+#include "registry/CachedKey.h"
+#include "render/FrameProfiler.h"
 #include "imousetool.h"
 #include "tools/XYMouseToolEvent.h"
 #include "wxutil/MouseToolHandler.h"
 #include "wxutil/DockablePanel.h"
 #include "XYRenderer.h"
+#include "GridGeometry.h"
 
 namespace ui
 {
@@ -88,6 +91,12 @@ private:
 
     bool _isActive;
 
+    // Whether the scene graph culling is spread across worker threads
+    registry::CachedKey<bool> _parallelRenderCollection;
+
+    // Frame time history for the frame graph and the hitch reports
+    render::FrameProfiler _frameProfiler;
+
     int _chasemouseCurrentX;
     int _chasemouseCurrentY;
     int _chasemouseDeltaX;
@@ -103,6 +112,9 @@ private:
 
     IGLFont::Ptr _font;
 
+    // The cached vertices of the minor and major grid
+    GridGeometry _gridGeometry[2];
+
 public:
     XYWnd(wxWindow* parent, XYWndManager& owner);
     ~XYWnd() override;
@@ -167,6 +179,7 @@ public:
 
     // greebo: This gets called upon scene change
     void onSceneGraphChange() override;
+    void onSceneBoundsDamaged(const AABB& damagedBounds) override;
 
     void updateFont();
 
@@ -32,6 +32,7 @@ Radiant::Radiant(IApplicationContext& context) :
 
 	// Set the stream references for rMessage(), redirect std::cout, etc.
 	applog::LogStream::InitialiseStreams(getLogWriter());
+	applog::LogWriter::Instance().startWriterThread();
 
     // Initialise the GlobalErorrHandler() function object, which is used by ASSERT_MESSAGE
     // This is usually a function owned by the UI module to show a popup
@@ -61,6 +62,8 @@ Radiant::~Radiant()
 		_logFile.reset();
 	}
 
+	// Write the remaining output before the streams go away
+	applog::LogWriter::Instance().stopWriterThread();
 	applog::LogStream::ShutdownStreams();
 
     // Shutdown the libxml2 DLL
@@ -0,0 +1,109 @@
+#include "BRepEvaluation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <thread>
+#include <unordered_set>
+#include "BrushNode.h"
+
+namespace brush
+{
+
+namespace
+{
+    // Below this number of brushes, starting the worker threads costs more than it saves
+    constexpr std::size_t MIN_BRUSHES_FOR_PARALLEL_EVALUATION = 64;
+
+    // Invokes the given function for each index in [0..count) using all available cores
+    void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+    {
+        std::atomic<std::size_t> nextIndex(0);
+
+        auto worker = [&]()
+        {
+            for (auto i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        };
+
+        auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+        std::vector<std::future<void>> workers;
+
+        for (std::size_t i = 1; i < numWorkers; ++i)
+        {
+            workers.emplace_back(std::async(std::launch::async, worker));
+        }
+
+        // The calling thread is processing its share too
+        worker();
+
+        // Wait for all workers, this is re-throwing any exceptions
+        for (auto& result : workers)
+        {
+            result.get();
+        }
+    }
+}
+
+void evaluateBReps(const std::vector<Brush*>& brushes)
+{
+    // Transforming the face planes notifies the scene about the changed bounds
+    for (auto* brush : brushes)
+    {
+        brush->evaluateTransform();
+    }
+
+    if (brushes.size() < MIN_BRUSHES_FOR_PARALLEL_EVALUATION)
+    {
+        for (auto* brush : brushes)
+        {
+            brush->evaluateBRep();
+        }
+
+        return;
+    }
+
+    // The brushes don't share any state, evaluate them in parallel
+    runInParallel(brushes.size(), [&](std::size_t index)
+    {
+        brushes[index]->evaluateBRep();
+    });
+}
+
+void evaluateBRepsInSubgraph(const scene::INodePtr& node)
+{
+    evaluateBRepsInSubgraphs({ node });
+}
+
+void evaluateBRepsInSubgraphs(const std::vector<scene::INodePtr>& nodes)
+{
+    std::vector<Brush*> brushes;
+    std::unordered_set<Brush*> visitedBrushes;
+
+    auto collectBrush = [&](const scene::INodePtr& candidate)
+    {
+        if (auto brushNode = std::dynamic_pointer_cast<BrushNode>(candidate); brushNode)
+        {
+            if (visitedBrushes.insert(&brushNode->getBrush()).second)
+            {
+                brushes.push_back(&brushNode->getBrush());
+            }
+        }
+
+        return true;
+    };
+
+    for (const auto& node : nodes)
+    {
+        collectBrush(node);
+        node->foreachNode(collectBrush);
+    }
+
+    evaluateBReps(brushes);
+}
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include "inode.h"
+
+class Brush;
+
+namespace brush
+{
+
+/**
+ * Evaluates the windings, edges and vertices of the given brushes on all cores.
+ *
+ * Pending transforms are applied on the calling thread first, since applying
+ * them emits bounds-changed notifications into the scene. The BRep evaluation
+ * itself only touches the brush and its observing node, the renderables are
+ * flagged for an update which happens during the next render pass.
+ *
+ * Each brush must be listed only once.
+ */
+void evaluateBReps(const std::vector<Brush*>& brushes);
+
+// Evaluates the brushes in the subgraph of the given node (including the node itself)
+void evaluateBRepsInSubgraph(const scene::INodePtr& node);
+
+// Evaluates the brushes in the subgraphs of all given nodes in one batch,
+// brushes found in several of the subgraphs are evaluated once
+void evaluateBRepsInSubgraphs(const std::vector<scene::INodePtr>& nodes);
+
+}
@@ -3,6 +3,8 @@
 #include "math/Frustum.h"
 #include "irenderable.h"
 #include "itextstream.h"
+#include "ifilter.h"
+#include "iscenestatistics.h"
 #include "shaderlib.h"
 
 #include "BrushModule.h"
@@ -10,6 +12,7 @@
 #include "Face.h"
 #include "FixedWinding.h"
 #include "math/Ray.h"
+#include "util/PoolAllocator.h"
 
 #include <functional>
 
@@ -33,6 +36,13 @@ namespace {
     {
         return std::max(std::max(extents[0], extents[1]), extents[2]);
     }
+
+    // Faces are taken from a pool, in the same block as their shared_ptr control block
+    template<typename... Args>
+    inline FacePtr createFace(Args&&... args)
+    {
+        return std::allocate_shared<Face>(util::PoolAllocator<Face>(), std::forward<Args>(args)...);
+    }
 }
 
 Brush::Brush(BrushNode& owner) :
@@ -40,6 +50,7 @@ Brush::Brush(BrushNode& owner) :
     _undoStateSaver(nullptr),
     m_planeChanged(false),
     m_transformChanged(false),
+    _hasPreviewTransform(false),
 	_detailFlag(Structural)
 {
     // Make some space for a few faces
@@ -52,6 +63,7 @@ Brush::Brush(BrushNode& owner, const Brush& other) :
     _undoStateSaver(nullptr),
     m_planeChanged(false),
     m_transformChanged(false),
+    _hasPreviewTransform(false),
 	_detailFlag(Structural)
 {
     copy(other);
@@ -83,7 +95,7 @@ IFace& Brush::addFace(const Plane3& plane)
 {
     // Allocate a new Face
     undoSave();
-    push_back(FacePtr(new Face(*this, plane)));
+    push_back(createFace(*this, plane));
 
     return *m_faces.back();
 }
@@ -92,7 +104,7 @@ IFace& Brush::addFace(const Plane3& plane, const Matrix3& textureProjection, con
 {
     // Allocate a new Face
     undoSave();
-    push_back(FacePtr(new Face(*this, plane, textureProjection, material)));
+    push_back(createFace(*this, plane, textureProjection, material));
 
     return *m_faces.back();
 }
@@ -293,6 +305,76 @@ void Brush::freezeTransform() {
     for(Faces::iterator i = m_faces.begin(); i != m_faces.end(); ++i) {
         (*i)->freezeTransform();
     }
+
+    if (_hasPreviewTransform)
+    {
+        // The previewed windings are replaced by the exact ones
+        clearPreviewTransform();
+        onFacePlaneChanged();
+    }
+
+    _untransformedWindings.clear();
+    _untransformedPlanes.clear();
+}
+
+void Brush::setPreviewTransform(const Matrix4& transform)
+{
+    // Mirroring transforms would flip the winding order, singular ones collapse the faces
+    auto determinant = transform.xCol3().cross(transform.yCol3()).dot(transform.zCol3());
+
+    // A pending transform evaluation would re-enter this method while building the windings
+    if (determinant <= 0 || m_transformChanged)
+    {
+        clearPreviewTransform();
+        return;
+    }
+
+    if (!untransformedWindingsAreValid())
+    {
+        // The faces are untransformed when this is called, build their windings once
+        _hasPreviewTransform = false;
+        _untransformedWindings.clear();
+        _untransformedPlanes.clear();
+
+        bool degenerate = buildWindings();
+
+        for (const auto& face : m_faces)
+        {
+            // A degenerate brush is built from its planes, only remember the planes
+            if (!degenerate)
+            {
+                _untransformedWindings.push_back(face->getWinding());
+            }
+
+            _untransformedPlanes.push_back(face->getPlane3());
+        }
+    }
+
+    _previewTransform = transform;
+    _hasPreviewTransform = _untransformedWindings.size() == m_faces.size();
+}
+
+void Brush::clearPreviewTransform()
+{
+    _hasPreviewTransform = false;
+}
+
+bool Brush::untransformedWindingsAreValid() const
+{
+    if (_untransformedPlanes.size() != m_faces.size())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < m_faces.size(); ++i)
+    {
+        if (m_faces[i]->getPlane3() != _untransformedPlanes[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
 }
 
 /// \brief Returns the absolute index of the \p faceVertex.
@@ -346,7 +428,7 @@ FacePtr Brush::addFace(const Face& face) {
         return FacePtr();
     }
     undoSave();
-    push_back(FacePtr(new Face(*this, face)));
+    push_back(createFace(*this, face));
     onFacePlaneChanged();
     return m_faces.back();
 }
@@ -357,7 +439,7 @@ FacePtr Brush::addPlane(const Vector3& p0, const Vector3& p1, const Vector3& p2,
         return FacePtr();
     }
     undoSave();
-    push_back(FacePtr(new Face(*this, p0, p1, p2, shader, projection)));
+    push_back(createFace(*this, p0, p1, p2, shader, projection));
     onFacePlaneChanged();
     return m_faces.back();
 }
@@ -407,6 +489,8 @@ void Brush::push_back(Faces::value_type face) {
         (*i)->push_back(*face);
         (*i)->DEBUG_verify();
     }
+
+    queueStatisticsUpdate();
 }
 
 void Brush::pop_back()
@@ -421,6 +505,8 @@ void Brush::pop_back()
         (*i)->pop_back();
         (*i)->DEBUG_verify();
     }
+
+    queueStatisticsUpdate();
 }
 
 void Brush::erase(std::size_t index)
@@ -435,6 +521,8 @@ void Brush::erase(std::size_t index)
         (*i)->erase(index);
         (*i)->DEBUG_verify();
     }
+
+    queueStatisticsUpdate();
 }
 
 void Brush::onFacePlaneChanged()
@@ -448,10 +536,25 @@ void Brush::onFaceShaderChanged()
     // When the face shader changes, no geometry change is happening
     // therefore no call to onFacePlaneChanged() is necessary
 
+    // The brush might need to be filtered differently
+    if (_owner.inScene())
+    {
+        GlobalFilterSystem().queueUpdate(_owner.getSelf());
+        GlobalSceneStatistics().queueUpdate(_owner.getSelf());
+    }
+
     // Queue an UI update of the texture tools if any of them is listening
 	signal_faceShaderChanged().emit();
 }
 
+void Brush::queueStatisticsUpdate()
+{
+    if (_owner.inScene())
+    {
+        GlobalSceneStatistics().queueUpdate(_owner.getSelf());
+    }
+}
+
 void Brush::onFaceConnectivityChanged()
 {
     for (auto i : m_observers)
@@ -479,6 +582,8 @@ void Brush::clear()
         (*i)->clear();
         (*i)->DEBUG_verify();
     }
+
+    queueStatisticsUpdate();
 }
 
 std::size_t Brush::getNumFaces() const
@@ -534,9 +639,13 @@ void Brush::removeRedundantFaces()
 
 /// \brief Constructs \p winding from the intersection of \p plane with the other planes of the brush.
 void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
-    FixedWinding buffer[2];
+    // Scratch buffers, reused by all windings calculated on this thread
+    thread_local FixedWinding buffer[2];
     bool swap = false;
 
+    buffer[0].clear();
+    buffer[1].clear();
+
     // get a poly that covers an effectively infinite area
     buffer[swap].createInfinite(plane, m_maxWorldCoord + 1);
 
@@ -554,13 +663,14 @@ void Brush::windingForClipPlane(Winding& winding, const Plane3& plane) const {
 
             buffer[!swap].clear();
 
+            // flip the plane, because we want to keep the back side
+            Plane3 clipPlane(-clip.plane3().normal(), -clip.plane3().dist());
+
+            // Planes not cutting off anything leave the winding as it is
+            if (buffer[swap].clip(plane, clipPlane, i, buffer[!swap]))
             {
-                // flip the plane, because we want to keep the back side
-                Plane3 clipPlane(-clip.plane3().normal(), -clip.plane3().dist());
-                buffer[swap].clip(plane, clipPlane, i, buffer[!swap]);
+                swap = !swap;
             }
-
-            swap = !swap;
         }
     }
 
@@ -823,19 +933,26 @@ void Brush::constructSphere(const AABB& bounds, std::size_t sides, const std::st
 // greebo: this code is modeled after http://geomalgorithms.com/a13-_intersect-4.html
 bool Brush::getIntersection(const Ray& ray, Vector3& intersection)
 {
+	// The face planes are cached along with the windings
+	evaluateBRep();
+
+	if (_facePlanes.size() == 0) return false; // no valid polyhedron
+
 	double tEnter = 0;		// maximum entering segment parameter
 	double tLeave = 5000;	// minimum leaving segment parameter (let's assume 5000 units for now)
 
 	Vector3 direction = ray.direction.getNormalised(); // normalise the ray direction
 
-	for (Faces::const_iterator i = m_faces.begin(); i != m_faces.end(); ++i)
-	{
-		const Face& face = *(*i);
-
-		if (!face.contributes()) continue; // skip non-contributing faces
+	const auto* normalX = _facePlanes.normalX.data();
+	const auto* normalY = _facePlanes.normalY.data();
+	const auto* normalZ = _facePlanes.normalZ.data();
+	const auto* dist = _facePlanes.dist.data();
 
-		auto n = -(ray.origin - face.getWinding().front().vertex).dot(face.getPlane3().normal());
-        auto d = direction.dot(face.getPlane3().normal());
+	for (std::size_t i = 0; i < _facePlanes.size(); ++i)
+	{
+		// Distance of the ray origin behind the plane, and the direction's share along the normal
+		auto n = dist[i] - (ray.origin.x() * normalX[i] + ray.origin.y() * normalY[i] + ray.origin.z() * normalZ[i]);
+		auto d = direction.x() * normalX[i] + direction.y() * normalY[i] + direction.z() * normalZ[i];
 
 		if (d == 0) // is the ray parallel to the face?
 		{
@@ -843,11 +960,9 @@ bool Brush::getIntersection(const Ray& ray, Vector3& intersection)
 			{
 				return false; // since the ray cannot intersect the brush;
 			}
-			else
-			{
-				// the ray cannot enter or leave the brush across this face
-				continue;
-			}
+
+			// the ray cannot enter or leave the brush across this face
+			continue;
 		}
 
 		auto t = n / d;
@@ -856,25 +971,19 @@ bool Brush::getIntersection(const Ray& ray, Vector3& intersection)
 		{
 			// ray is entering the brush across this face
 			tEnter = std::max(tEnter, t);
-
-			if (tEnter > tLeave)
-			{
-				return false; // the ray enters the brush after leaving => cannot intersect
-			}
 		}
-		else if (d > 0)
+		else
 		{
 			// ray is leaving the brush across this face
 			tLeave = std::min(tLeave, t);
+		}
 
-			if (tLeave < tEnter)
-			{
-				return false; // the ray leaves the brush before entering => cannot intersect
-			}
+		if (tEnter > tLeave)
+		{
+			return false; // the ray enters the brush after leaving => cannot intersect
 		}
 	}
 
-	assert(tEnter <= tLeave);
 	intersection = ray.origin + direction * tEnter;
 
 	return true;
@@ -1066,8 +1175,46 @@ bool Brush::isBounded() {
     return true;
 }
 
+bool Brush::buildPreviewWindings()
+{
+    m_aabb_local = AABB();
+
+    for (std::size_t i = 0; i < m_faces.size(); ++i)
+    {
+        auto& face = *m_faces[i];
+        auto& winding = face.getWinding();
+
+        // The untransformed windings have been cleaned up already,
+        // an affine transform keeps their connectivity intact
+        winding = _untransformedWindings[i];
+
+        if (!winding.empty())
+        {
+            _previewTransform.transformPoints(&winding.front().vertex, winding.size(), sizeof(WindingVertex));
+        }
+
+        for (const auto& vertex : winding)
+        {
+            m_aabb_local.includePoint(vertex.vertex);
+        }
+
+        face.emitTextureCoordinates();
+        face.updateWinding();
+    }
+
+    return !isBounded();
+}
+
 bool Brush::buildWindings()
 {
+    // The preview windings are not querying the face planes, evaluate a pending transform first
+    evaluateTransform();
+
+    if (_hasPreviewTransform && untransformedWindingsAreValid())
+    {
+        return buildPreviewWindings();
+    }
+
     m_aabb_local = AABB();
 
     for (std::size_t i = 0;  i < m_faces.size(); ++i)
@@ -1173,6 +1320,8 @@ void Brush::buildBRep() {
     faceVerticesCount += (*i)->getWinding().size();
   }
 
+  _facePlanes.clear();
+
   if(degenerate || faces_size < 4 || faceVerticesCount != (faceVerticesCount>>1)<<1) // sum of vertices for each face of a valid polyhedron is always even
   {
     _uniqueVertexPoints.resize(0);
@@ -1193,6 +1342,14 @@ void Brush::buildBRep() {
   }
   else
   {
+    for (const auto& face : m_faces)
+    {
+      if (face->contributes())
+      {
+        _facePlanes.add(face->getPlane3());
+      }
+    }
+
     {
       typedef std::vector<FaceVertexId> FaceVertices;
       FaceVertices faceVertices;
@@ -131,6 +131,37 @@ private:
 	// A list of face indices, one for each unique edge
 	std::vector<EdgeFaces> _edgeFaces;
 
+	// The planes of all contributing faces, one array per component, used for ray tests
+	struct FacePlanes
+	{
+		std::vector<double> normalX;
+		std::vector<double> normalY;
+		std::vector<double> normalZ;
+		std::vector<double> dist;
+
+		void clear()
+		{
+			normalX.clear();
+			normalY.clear();
+			normalZ.clear();
+			dist.clear();
+		}
+
+		void add(const Plane3& plane)
+		{
+			normalX.push_back(plane.normal().x());
+			normalY.push_back(plane.normal().y());
+			normalZ.push_back(plane.normal().z());
+			dist.push_back(plane.dist());
+		}
+
+		std::size_t size() const
+		{
+			return dist.size();
+		}
+	};
+	FacePlanes _facePlanes;
+
 	AABB m_aabb_local;
 	// ----
 
@@ -138,6 +169,15 @@ private:
 	mutable bool m_transformChanged; // transform evaluation required
 	// ----
 
+	// The transform applied to the untransformed windings while previewing
+	// a manipulation, instead of clipping the windings from the face planes
+	Matrix4 _previewTransform;
+	bool _hasPreviewTransform;
+
+	// The windings of the untransformed faces and the planes they belong to
+	std::vector<Winding> _untransformedWindings;
+	std::vector<Plane3> _untransformedPlanes;
+
 	DetailFlag _detailFlag;
 
 public:
@@ -153,6 +193,11 @@ public:
 
 		virtual ~BrushUndoMemento() {}
 
+		std::size_t getMemoryUsage() const override
+		{
+			return sizeof(*this) + _faces.capacity() * sizeof(Faces::value_type);
+		}
+
 		Faces _faces;
 		DetailFlag _detailFlag;
 	};
@@ -230,6 +275,15 @@ public:
 	void revertTransform();
 	void freezeTransform();
 
+	/**
+	 * Lets the current transform be previewed by transforming the windings
+	 * of the untransformed faces instead of rebuilding them from the planes,
+	 * as long as the transform preserves the topology of the brush.
+	 * The exact windings are rebuilt once the transform is frozen.
+	 */
+	void setPreviewTransform(const Matrix4& transform);
+	void clearPreviewTransform();
+
 	/// \brief Returns the absolute index of the \p faceVertex.
 	std::size_t absoluteIndex(FaceVertexId faceVertex);
 
@@ -339,8 +393,17 @@ private:
 	/// \brief Constructs the polygon windings for each face of the brush. Also updates the brush bounding-box and face texture-coordinates.
 	bool buildWindings();
 
+	/// \brief Constructs the face windings by transforming the untransformed windings with the preview transform.
+	bool buildPreviewWindings();
+
+	/// \brief Returns true if the stored untransformed windings belong to the current untransformed faces.
+	bool untransformedWindingsAreValid() const;
+
 	/// \brief Constructs the face windings and updates anything that depends on them.
 	void buildBRep();
+
+	// The scene statistics need to count the materials of this brush again
+	void queueStatisticsUpdate();
 }; // class Brush
 
 typedef std::vector<Brush*> BrushVector;
@@ -20,7 +20,7 @@ public:
 
 	void setPlane(const Brush& brush, const Plane3& plane, IRenderEntity& entity)
 	{
-		if (plane.isValid())
+		if (plane.isValid() && planeIntersectsBounds(plane, brush.localAABB()))
 		{
 			brush.windingForClipPlane(_winding, plane);
 
@@ -30,13 +30,34 @@ public:
             queueUpdate();
             update(_shader, entity);
 		}
-		else 
+		else if (!_winding.empty())
 		{
 			_winding.resize(0);
             clear();
 		}
 	}
 
+private:
+	// Planes missing the brush bounds cannot produce a clip winding, these brushes
+	// are skipped while the clip points are dragged around. The margin keeps planes
+	// touching the bounds, which can still yield a winding at a brush face.
+	static bool planeIntersectsBounds(const Plane3& plane, const AABB& bounds)
+	{
+		if (!bounds.isValid())
+		{
+			return true;
+		}
+
+		const double Margin = 1.0;
+
+		const auto& normal = plane.normal();
+		auto radius = fabs(normal.x()) * bounds.extents.x() +
+			fabs(normal.y()) * bounds.extents.y() + fabs(normal.z()) * bounds.extents.z();
+
+		return fabs(plane.distanceToPoint(bounds.origin)) <= radius + Margin;
+	}
+
+public:
 	void setRenderSystem(const RenderSystemPtr& renderSystem)
 	{
 		if (renderSystem)
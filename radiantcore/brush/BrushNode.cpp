@@ -433,6 +433,20 @@ void BrushNode::renderHighlights(IRenderableCollector& collector, const VolumeTe
         collector.setHighlightFlag(IRenderableCollector::Highlight::Primitives, wholeBrushSelected);
     }
 
+    // Outside merge mode, the faces are added to batches drawing all highlighted faces
+    // of a shader at once. Faces sharing a batch need to share the highlight flags.
+    std::size_t batchKey = IRenderableCollector::Highlight::Faces;
+
+    if (wholeBrushSelected)
+    {
+        batchKey |= IRenderableCollector::Highlight::Primitives;
+    }
+
+    if (collector.hasHighlightFlag(IRenderableCollector::Highlight::GroupMember))
+    {
+        batchKey |= IRenderableCollector::Highlight::GroupMember;
+    }
+
     // Submit the renderable geometry for each face
     for (auto& faceInstance : _faceInstances)
     {
@@ -448,9 +462,18 @@ void BrushNode::renderHighlights(IRenderableCollector& collector, const VolumeTe
 
             collector.setHighlightFlag(IRenderableCollector::Highlight::Faces, true);
 
-            // Submit the RenderableWinding as reference, it will render the winding in polygon mode
-            collector.addHighlightRenderable(volume.fill() ? 
-                face.getWindingSurfaceSolid() : face.getWindingSurfaceWireframe(), Matrix4::getIdentity());
+            auto& winding = volume.fill() ? face.getWindingSurfaceSolid() : face.getWindingSurfaceWireframe();
+
+            if (isInMergeMode)
+            {
+                // Submit the RenderableWinding as reference, it will render the winding in polygon mode
+                collector.addHighlightRenderable(winding, Matrix4::getIdentity());
+            }
+            else if (auto batch = winding.addToHighlightBatch(batchKey); batch != nullptr)
+            {
+                // First face in this batch during this frame, submit the batch itself
+                collector.addHighlightRenderable(*batch, Matrix4::getIdentity());
+            }
 
             collector.setHighlightFlag(IRenderableCollector::Highlight::Faces, false);
         }
@@ -518,6 +541,7 @@ void BrushNode::evaluateTransform()
 {
     if (getTransformationType() == NoTransform)
     {
+        _brush.clearPreviewTransform();
         return;
     }
 
@@ -526,6 +550,8 @@ void BrushNode::evaluateTransform()
         // If this is a pure translation (no other bits set), call the specialised method
         if (getTransformationType() == Translation)
         {
+            _brush.setPreviewTransform(Matrix4::getTranslation(getTranslation()));
+
             for (auto face : _brush)
             {
                 face->translate(getTranslation());
@@ -537,12 +563,19 @@ void BrushNode::evaluateTransform()
 
             if (transform != Matrix4::getIdentity())
             {
+                _brush.setPreviewTransform(transform);
                 _brush.transform(transform);
             }
+            else
+            {
+                _brush.clearPreviewTransform();
+            }
         }
 	}
 	else
     {
+        // Component transforms are changing the topology of the brush
+        _brush.clearPreviewTransform();
 		transformComponents(calculateTransform());
 	}
 }
@@ -22,13 +22,18 @@ class Face::SavedState final :
 public:
     FacePlane::SavedState _planeState;
     TextureProjection _texdefState;
-    std::string _materialName;
+    string::InternedString _materialName;
 
     SavedState(const Face& face) :
         _planeState(face.getPlane()),
         _texdefState(face.getProjection()),
-        _materialName(face.getShader())
+        _materialName(face.getFaceShader().getInternedMaterialName())
     {}
+
+    std::size_t getMemoryUsage() const override
+    {
+        return sizeof(*this);
+    }
 };
 
 Face::Face(Brush& owner) :
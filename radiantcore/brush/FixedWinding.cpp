@@ -3,6 +3,7 @@
 #include "Brush.h"
 #include "Winding.h"
 #include "itextstream.h"
+#include <algorithm>
 
 namespace {
 	inline bool float_is_largest_absolute(double axis, double other) {
@@ -123,16 +124,34 @@ void FixedWinding::createInfinite(const Plane3& plane, double infinity) {
 }
 
 /// \brief Clip \p winding which lies on \p plane by \p clipPlane, resulting in \p clipped.
-/// If \p winding is completely in front of the plane, \p clipped will be identical to \p winding.
+/// If \p winding is completely in front of the plane, false is returned and \p clipped is left untouched,
+/// \p winding is rotated in place to have the same vertex order the clipped winding would have.
 /// If \p winding is completely in back of the plane, \p clipped will be empty.
 /// If \p winding intersects the plane, the edge of \p clipped which lies on \p clipPlane will store the value of \p adjacent.
-void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped)
+bool FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped)
 {
 	if (size() == 0) {
-		return; // Degenerate winding, exit
+		return false; // Degenerate winding, exit
 	}
 
-	PlaneClassification classification = Winding::classifyDistance(clipPlane.distanceToPoint(back().vertex), ON_EPSILON);
+	// Classify all vertices in one go, nothing needs to be done if none of them is in the back
+	_classifications.resize(size());
+	bool hasBackVertices = false;
+
+	for (std::size_t i = 0; i < size(); ++i)
+	{
+		_classifications[i] = Winding::classifyDistance(clipPlane.distanceToPoint((*this)[i].vertex), ON_EPSILON);
+		hasBackVertices |= _classifications[i] == ePlaneBack;
+	}
+
+	if (!hasBackVertices)
+	{
+		// The clipped winding would start with the last vertex, rotate in place to match it
+		std::rotate(begin(), end() - 1, end());
+		return false;
+	}
+
+	PlaneClassification classification = _classifications.back();
 	PlaneClassification nextClassification;
 
 	// for each edge
@@ -140,7 +159,7 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 		 next != size();
 		 i = next, ++next, classification = nextClassification)
 	{
-		nextClassification = Winding::classifyDistance(clipPlane.distanceToPoint((*this)[next].vertex), ON_EPSILON);
+		nextClassification = _classifications[next];
 		const FixedWindingVertex& vertex = (*this)[i];
 
 		// if first vertex of edge is ON
@@ -191,4 +210,6 @@ void FixedWinding::clip(const Plane3& plane, const Plane3& clipPlane, std::size_
 			}
 		}
 	}
+
+	return true;
 }
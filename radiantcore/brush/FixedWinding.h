@@ -2,6 +2,7 @@
 
 #include "math/Vector3.h"
 #include "math/Plane3.h"
+#include "iclipper.h"
 
 #include <vector>
 
@@ -32,24 +33,28 @@ public:
 		edge(edge_),
 		adjacent(adjacent_)
 	{}
-
-	virtual ~FixedWindingVertex() {}
 };
 
 /**
  * greebo: A FixedWinding is a vector of FixedWindingVertices
  *         with a pre-allocated size of MAX_POINTS_ON_WINDING.
+ *
+ * Instances are meant to be reused as scratch buffers, clearing them keeps
+ * the allocated memory around.
  */
 class FixedWinding :
 	public std::vector<FixedWindingVertex>
 {
+private:
+	// Vertex classifications of the current clip() call
+	std::vector<PlaneClassification> _classifications;
+
 public:
 	FixedWinding() {
 		reserve(MAX_POINTS_ON_WINDING);
+		_classifications.reserve(MAX_POINTS_ON_WINDING);
 	}
 
-	virtual ~FixedWinding() {}
-
 	// Writes the FixedWinding data into the given Winding
 	void writeToWinding(Winding& winding);
 
@@ -57,8 +62,9 @@ public:
 	void createInfinite(const Plane3& plane, double infinity);
 
 	/// \brief Clip this winding which lies on \p plane by \p clipPlane, resulting in \p clipped.
-	/// If \p winding is completely in front of the plane, \p clipped will be identical to \p winding.
+	/// If \p winding is completely in front of the plane, false is returned and \p clipped is left untouched,
+	/// \p winding is rotated in place to have the same vertex order the clipped winding would have.
 	/// If \p winding is completely in back of the plane, \p clipped will be empty.
 	/// If \p winding intersects the plane, the edge of \p clipped which lies on \p clipPlane will store the value of \p adjacent.
-	void clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped);
+	bool clip(const Plane3& plane, const Plane3& clipPlane, std::size_t adjacent, FixedWinding& clipped);
 };
@@ -98,6 +98,15 @@ public:
         _windingSize = 0;
     }
 
+    // Adds this winding to the shader's highlight batch with the given key, returns the
+    // batch renderable if it needs to be submitted (see IWindingRenderer::addHighlightedWinding)
+    const OpenGLRenderable* addToHighlightBatch(std::size_t batchKey)
+    {
+        if (_slot == IWindingRenderer::InvalidSlot || !_shader) return nullptr;
+
+        return _shader->addHighlightedWinding(_slot, batchKey);
+    }
+
     void render() const override
     {
         if (_slot != IWindingRenderer::InvalidSlot && _shader)
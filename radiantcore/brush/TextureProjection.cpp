@@ -249,22 +249,30 @@ void TextureProjection::emitTextureCoordinates(Winding& winding, const Vector3&
     local2tex.multiplyBy(xyz2st);
 
     // Calculate the tangent and bitangent vectors to allow the correct openGL transformations
-    Vector3 tangent(local2tex.getTransposed().xCol3().getNormalised());
-    Vector3 bitangent(local2tex.getTransposed().yCol3().getNormalised());
+    Vector3 tangent(Vector3(local2tex.xx(), local2tex.yx(), local2tex.zx()).getNormalised());
+    Vector3 bitangent(Vector3(local2tex.xy(), local2tex.yy(), local2tex.zy()).getNormalised());
 
     // Transform the texture basis vectors into the "BrushFace space"
-    // usually the localToWorld matrix is identity, so this doesn't do anything.
-    local2tex.multiplyBy(localToWorld);
+    // usually the localToWorld matrix is identity, so the product can be skipped.
+    if (localToWorld != Matrix4::getIdentity())
+    {
+        local2tex.multiplyBy(localToWorld);
+    }
+
+    // Only the first two rows of the matrix contribute to the s,t coordinates,
+    // pull them out of the matrix once instead of running a full 4x4 transform per vertex
+    const double sx = local2tex.xx(), sy = local2tex.yx(), sz = local2tex.zx(), sw = local2tex.tx();
+    const double tx = local2tex.xy(), ty = local2tex.yy(), tz = local2tex.zy(), tw = local2tex.ty();
 
     // Cycle through the winding vertices and apply the texture transformation matrix
     // onto each of them.
     for (auto& vertex : winding)
     {
-        auto texcoord = local2tex.transformPoint(vertex.vertex);
+        const auto& v = vertex.vertex;
 
         // Store the s,t coordinates into the winding texcoord vector
-        vertex.texcoord[0] = texcoord[0];
-        vertex.texcoord[1] = texcoord[1];
+        vertex.texcoord[0] = sx * v.x() + sy * v.y() + sz * v.z() + sw;
+        vertex.texcoord[1] = tx * v.x() + ty * v.y() + tz * v.z() + tw;
 
         // Save the tangent and bitangent vectors, they are the same for all the face vertices
         vertex.tangent = tangent;
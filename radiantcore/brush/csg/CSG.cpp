@@ -1,12 +1,15 @@
 #include "CSG.h"
 
 #include <map>
+#include <functional>
+#include <algorithm>
 
 #include "i18n.h"
 #include "itextstream.h"
 #include "iundo.h"
 #include "igrid.h"
 #include "iselection.h"
+#include "ispacepartition.h"
 #include "ientity.h"
 
 #include "scenelib.h"
@@ -18,6 +21,7 @@
 #include "brush/Brush.h"
 #include "brush/BrushNode.h"
 #include "brush/BrushVisit.h"
+#include "brush/BRepEvaluation.h"
 #include "selection/algorithm/Primitives.h"
 #include "messages/NotificationMessage.h"
 #include "command/ExecutionNotPossible.h"
@@ -30,78 +34,120 @@ namespace algorithm
 
 const std::string RKEY_EMIT_CSG_SUBTRACT_WARNING("user/ui/brush/emitCSGSubtractWarning");
 
-void hollowBrush(const BrushNodePtr& sourceBrush, bool makeRoom)
+namespace
 {
-	// Hollow the brush using the current grid size
-    sourceBrush->getBrush().forEachFace([&] (Face& face)
-    {
-        if (!face.contributes())
-        {
-            return;
-        }
-
-        scene::INodePtr parent = sourceBrush->getParent();
+	// Creates the wall brush for the given face of the source brush, without inserting it
+	BrushNodePtr createWallBrush(const Brush& sourceBrush, std::size_t faceIndex, bool makeRoom, double offset)
+	{
+		auto brushNode = std::dynamic_pointer_cast<BrushNode>(GlobalBrushCreator().createBrush());
+		assert(brushNode);
 
-        scene::INodePtr newNode = GlobalBrushCreator().createBrush();
-        BrushNodePtr brushNode = std::dynamic_pointer_cast<BrushNode>(newNode);
-        assert(brushNode);
+		auto& brush = brushNode->getBrush();
+		const auto& face = static_cast<const Face&>(sourceBrush.getFace(faceIndex));
 
-        float offset = GlobalGrid().getGridSize();
+		// Copy all faces from the source brush
+		brush.copy(sourceBrush);
 
 		if (makeRoom)
 		{
-			face.getPlane().offset(offset);
+			// The wall extends from the source face outwards
+			auto& copiedFace = static_cast<Face&>(brush.getFace(faceIndex));
+			copiedFace.getPlane().offset(offset);
+			copiedFace.planeChanged();
 		}
 
-        // Add the child to the same parent as the source brush
-        parent->addChildNode(brushNode);
+		FacePtr newFace = brush.addFace(face);
 
-        // Move the child brushes to the same layer as their source
-        brushNode->assignToLayers(sourceBrush->getLayers());
+		if (newFace != 0)
+		{
+			newFace->flipWinding();
 
-        // Copy all faces from the source brush
-        brushNode->getBrush().copy(sourceBrush->getBrush());
+			if (!makeRoom)
+			{
+				newFace->getPlane().offset(offset);
+			}
 
-		if (makeRoom)
-		{
-			face.getPlane().offset(-offset);
+			newFace->planeChanged();
 		}
 
-        Node_setSelected(brushNode, true);
+		return brushNode;
+	}
+}
+
+void hollowBrush(const BrushNodePtr& sourceBrush, bool makeRoom)
+{
+	hollowBrushes({ sourceBrush }, makeRoom);
+}
 
-        FacePtr newFace = brushNode->getBrush().addFace(face);
+void hollowBrushes(const std::vector<BrushNodePtr>& sourceBrushes, bool makeRoom)
+{
+	// Hollow the brushes using the current grid size
+	double offset = GlobalGrid().getGridSize();
 
-        if (newFace != 0)
-        {
-            newFace->flipWinding();
+	// The wall brushes are built outside the scene, such that
+	// adding their faces isn't recording any undo state
+	std::vector<std::pair<BrushNodePtr, BrushNodePtr>> walls;
 
-			if (!makeRoom)
+	for (const auto& sourceBrush : sourceBrushes)
+	{
+		const auto& brush = sourceBrush->getBrush();
+		brush.evaluateBRep();
+
+		for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+		{
+			if (static_cast<const Face&>(brush.getFace(i)).contributes())
 			{
-	            newFace->getPlane().offset(offset);
+				walls.emplace_back(sourceBrush, createWallBrush(brush, i, makeRoom, offset));
 			}
+		}
+	}
+
+	// Evaluating the windings is the expensive part, the detached brushes are evaluated in parallel
+	std::vector<Brush*> wallBrushes;
+	wallBrushes.reserve(walls.size());
+
+	for (const auto& [_, wall] : walls)
+	{
+		wallBrushes.push_back(&wall->getBrush());
+	}
+
+	evaluateBReps(wallBrushes);
+
+	for (auto* brush : wallBrushes)
+	{
+		brush->removeEmptyFaces();
+	}
+
+	// Brushes that lost faces need another evaluation
+	evaluateBReps(wallBrushes);
+
+	// Insert all walls, the scene observers are notified once
+	scene::GraphBatchUpdate batch(GlobalSceneGraph());
+
+	for (const auto& [sourceBrush, wall] : walls)
+	{
+		// Add the child to the same parent as the source brush
+		sourceBrush->getParent()->addChildNode(wall);
 
-            newFace->planeChanged();
-        }
+		// Move the child brushes to the same layer as their source
+		wall->assignToLayers(sourceBrush->getLayers());
 
-        brushNode->getBrush().removeEmptyFaces();
-    });
+		Node_setSelected(wall, true);
+	}
 
-	// Now unselect and remove the source brush from the scene
-	scene::removeNodeFromParent(sourceBrush);
+	// Now unselect and remove the source brushes from the scene
+	for (const auto& sourceBrush : sourceBrushes)
+	{
+		scene::removeNodeFromParent(sourceBrush);
+	}
 }
 
 void hollowSelectedBrushes(const cmd::ArgumentList& args) {
 	UndoableCommand undo("hollowSelectedBrushes");
 
-	// Find all brushes
-	BrushPtrVector brushes = selection::algorithm::getSelectedBrushes();
-
-	// Cycle through the brushes and hollow them
+	// Find all brushes and hollow them
 	// We assume that all these selected brushes are visible as well.
-	for (const BrushNodePtr& brush : brushes)
-	{
-		hollowBrush(brush, false);
-	}
+	hollowBrushes(selection::algorithm::getSelectedBrushes(), false);
 
 	SceneChangeNotify();
 }
@@ -109,15 +155,9 @@ void hollowSelectedBrushes(const cmd::ArgumentList& args) {
 void makeRoomForSelectedBrushes(const cmd::ArgumentList& args) {
 	UndoableCommand undo("brushMakeRoom");
 
-	// Find all brushes
-	BrushPtrVector brushes = selection::algorithm::getSelectedBrushes();
-
-	// Cycle through the brushes and hollow them
+	// Find all brushes and hollow them
 	// We assume that all these selected brushes are visible as well.
-	for (std::size_t i = 0; i < brushes.size(); ++i)
-	{
-		hollowBrush(brushes[i], true);
-	}
+	hollowBrushes(selection::algorithm::getSelectedBrushes(), true);
 
 	SceneChangeNotify();
 }
@@ -166,14 +206,57 @@ bool Brush_subtract(const BrushNodePtr& brush, const Brush& other, BrushPtrVecto
 	return false;
 }
 
-class SubtractBrushesFromUnselected :
-	public scene::NodeVisitor
+namespace
+{
+	// Returns true if the node and all of its ancestors are visible
+	bool isVisibleInScene(scene::INodePtr node)
+	{
+		for (; node; node = node->getParent())
+		{
+			if (!node->visible())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Visits the members of all octree nodes intersecting the given bounds
+	void foreachNodeInBounds(const scene::ISPNode& spNode, const AABB& bounds,
+		const std::function<void(const scene::INodePtr&)>& functor)
+	{
+		for (const auto& member : spNode.getMembers())
+		{
+			functor(member);
+		}
+
+		for (const auto& child : spNode.getChildNodes())
+		{
+			if (child->getBounds().intersects(bounds))
+			{
+				foreachNodeInBounds(*child, bounds, functor);
+			}
+		}
+	}
+}
+
+class SubtractBrushesFromUnselected
 {
 	const BrushPtrVector& _brushlist;
 	std::size_t& _before;
 	std::size_t& _after;
 
-	BrushPtrVector _unselectedBrushes;
+	// An unselected brush touched by at least one selected brush
+	struct Candidate
+	{
+		BrushNodePtr node;
+
+		// The selected brushes intersecting the candidate, in selection order
+		std::vector<const Brush*> subtrahends;
+	};
+
+	std::vector<Candidate> _candidates;
 
 public:
 	SubtractBrushesFromUnselected(const BrushPtrVector& brushlist, std::size_t& before, std::size_t& after) :
@@ -182,32 +265,66 @@ public:
 		_after(after)
 	{}
 
-	bool pre(const scene::INodePtr& node) override
+	// Queries the octree for the unselected brushes each selected brush is touching
+	void collectCandidates()
 	{
-		if (!node->visible())
-		{
-			return false;
-		}
+		// Evaluate the root bounds first, this is updating the octree links
+		GlobalSceneGraph().root()->worldAABB();
+
+		auto spRoot = GlobalSceneGraph().getSpacePartition()->getRoot();
+
+		std::map<scene::INode*, std::size_t> candidateIndices;
 
-		if (Node_isBrush(node) && !Node_isSelected(node))
+		for (const auto& selectedBrush : _brushlist)
 		{
-			_unselectedBrushes.emplace_back(std::dynamic_pointer_cast<BrushNode>(node));
-		}
+			const Brush& subtrahend = selectedBrush->getBrush();
+			const AABB& bounds = subtrahend.localAABB();
 
-		return true;
+			foreachNodeInBounds(*spRoot, bounds, [&](const scene::INodePtr& node)
+			{
+				if (!Node_isBrush(node) || Node_isSelected(node))
+				{
+					return;
+				}
+
+				auto brushNode = std::dynamic_pointer_cast<BrushNode>(node);
+
+				if (!brushNode || !brushNode->getBrush().localAABB().intersects(bounds))
+				{
+					return;
+				}
+
+				auto existing = candidateIndices.find(node.get());
+
+				if (existing == candidateIndices.end())
+				{
+					if (!isVisibleInScene(node))
+					{
+						return;
+					}
+
+					existing = candidateIndices.emplace(node.get(), _candidates.size()).first;
+					_candidates.emplace_back(Candidate{ brushNode, {} });
+				}
+
+				_candidates[existing->second].subtrahends.push_back(&subtrahend);
+			});
+		}
 	}
 
-	void processUnselectedBrushes()
+	void processCandidates()
 	{
-		for (const auto& node : _unselectedBrushes)
+		for (const auto& candidate : _candidates)
 		{
-			processNode(node);
+			processNode(candidate);
 		}
 	}
 
 private:
-	void processNode(const BrushNodePtr& brushNode)
+	void processNode(const Candidate& candidate)
 	{
+		const BrushNodePtr& brushNode = candidate.node;
+
 		// Get the parent of this brush
 		scene::INodePtr parent = brushNode->getParent();
 		assert(parent); // parent must not be NULL
@@ -217,20 +334,14 @@ private:
 
 		BrushNodePtr original = std::dynamic_pointer_cast<BrushNode>(brushNode->clone());
 
-		//Brush* original = new Brush(*brush);
 		buffer[swap].push_back(original);
 
-		// Iterate over all selected brushes
-		for (const auto& selectedBrush : _brushlist)
+		// Iterate over all selected brushes touching this one
+		for (const Brush* selectedBrush : candidate.subtrahends)
 		{
 			for (const auto& target : buffer[swap])
 			{
-				if (Brush_subtract(target, selectedBrush->getBrush(), buffer[1 - swap]))
-				{
-					// greebo: Delete not necessary, nodes get deleted automatically by clear() below
-					// delete (*j);
-				}
-				else
+				if (!Brush_subtract(target, *selectedBrush, buffer[1 - swap]))
 				{
 					buffer[1 - swap].push_back(target);
 				}
@@ -304,9 +415,9 @@ void subtractBrushesFromUnselected(const cmd::ArgumentList& args)
 	std::size_t after = 0;
 
 	SubtractBrushesFromUnselected walker(brushes, before, after);
-	GlobalSceneGraph().root()->traverse(walker);
 
-	walker.processUnselectedBrushes();
+	walker.collectCandidates();
+	walker.processCandidates();
 
 	rMessage() << "CSG Subtract: Result: "
 		<< after << " fragment" << (after == 1 ? "" : "s")
@@ -315,15 +426,74 @@ void subtractBrushesFromUnselected(const cmd::ArgumentList& args)
 	SceneChangeNotify();
 }
 
+namespace
+{
+	// All face planes of the merged brushes, ordered by their distance, such that the
+	// faces with a plane equal to a given one can be looked up by a range search
+	class FacePlaneIndex
+	{
+		struct Entry
+		{
+			double dist;
+			std::size_t brushIndex;
+			const Face* face;
+
+			bool operator<(const Entry& other) const
+			{
+				return dist < other.dist;
+			}
+		};
+
+		std::vector<Entry> _entries;
+
+	public:
+		FacePlaneIndex(const BrushPtrVector& brushes)
+		{
+			for (std::size_t i = 0; i < brushes.size(); ++i)
+			{
+				brushes[i]->getBrush().forEachFace([&](Face& face)
+				{
+					_entries.push_back(Entry{ face.plane3().dist(), i, &face });
+				});
+			}
+
+			std::sort(_entries.begin(), _entries.end());
+		}
+
+		// True if a face of any brush other than the given one lies on the given plane
+		bool containsPlaneOfOtherBrush(const Plane3& plane, std::size_t brushIndex) const
+		{
+			// Planes within the distance epsilon are candidates for equality
+			auto first = std::lower_bound(_entries.begin(), _entries.end(),
+				Entry{ plane.dist() - EPSILON_DIST, 0, nullptr });
+
+			for (auto i = first; i != _entries.end() && i->dist <= plane.dist() + EPSILON_DIST; ++i)
+			{
+				if (i->brushIndex != brushIndex && i->face->plane3() == plane)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	};
+}
+
 // greebo: TODO: Make this a member method of the Brush class
 bool Brush_merge(Brush& brush, const BrushPtrVector& in, bool onlyshape) {
 	// gather potential outer faces
 	typedef std::vector<const Face*> FaceList;
 	FaceList faces;
 
-	for (BrushPtrVector::const_iterator i(in.begin()); i != in.end(); ++i) {
-		(*i)->getBrush().evaluateBRep();
+	for (const auto& brushNode : in)
+	{
+		brushNode->getBrush().evaluateBRep();
+	}
+
+	FacePlaneIndex planeIndex(in);
 
+	for (BrushPtrVector::const_iterator i(in.begin()); i != in.end(); ++i) {
 		for (Brush::const_iterator j((*i)->getBrush().begin()); j != (*i)->getBrush().end(); ++j) {
 			if (!(*j)->contributes()) {
 				continue;
@@ -331,24 +501,8 @@ bool Brush_merge(Brush& brush, const BrushPtrVector& in, bool onlyshape) {
 
 			const Face& face1 = *(*j);
 
-			bool skip = false;
-
-			// test faces of all input brushes
-			//!\todo SPEEDUP: Flag already-skip faces and only test brushes from i+1 upwards.
-			for (BrushPtrVector::const_iterator k(in.begin()); !skip && k != in.end(); ++k) {
-				if (k != i) { // don't test a brush against itself
-					for (Brush::const_iterator l((*k)->getBrush().begin()); !skip && l != (*k)->getBrush().end(); ++l) {
-						const Face& face2 = *(*l);
-
-						// face opposes another face
-						if (face1.plane3() == -face2.plane3()) {
-							// skip opposing planes
-							skip  = true;
-							break;
-						}
-					}
-				}
-			}
+			// skip faces opposing a face of another input brush
+			bool skip = planeIndex.containsPlaneOfOtherBrush(-face1.plane3(), i - in.begin());
 
 			// check faces already stored
 			for (FaceList::const_iterator m = faces.begin(); !skip && m != faces.end(); ++m) {
@@ -3,6 +3,7 @@
 #include "iclipper.h"
 #include "icommandsystem.h"
 #include "math/Plane3.h"
+#include <vector>
 
 // Contains the routines for brush subtract, merge and hollow
 
@@ -24,6 +25,12 @@ namespace algorithm {
  */
 void hollowBrush(const BrushNodePtr& sourceBrush, bool makeRoom);
 
+/**
+ * Hollows all the given brushes in one go. The wall brushes are evaluated
+ * in parallel before they are inserted into the scene in a single batch.
+ */
+void hollowBrushes(const std::vector<BrushNodePtr>& sourceBrushes, bool makeRoom);
+
 /**
  * greebo: Hollows all currently selected brushes.
  */
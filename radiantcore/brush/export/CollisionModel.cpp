@@ -1,5 +1,6 @@
 #include "CollisionModel.h"
 
+#include <algorithm>
 #include "itextstream.h"
 #include "iselection.h"
 #include "ientity.h"
@@ -7,6 +8,7 @@
 #include "gamelib.h"
 #include "brush/Brush.h"
 #include "brush/Winding.h"
+#include "math/Hash.h"
 
 namespace cmutil {
 
@@ -76,21 +78,37 @@ std::ostream& operator<< (std::ostream& st, const BrushStruc b) {
 	return st;
 }
 
-CollisionModel::CollisionModel() {
+std::size_t CollisionModel::EdgeKeyHash::operator()(const EdgeKey& key) const
+{
+	auto hash = std::hash<std::size_t>()(key.first);
+	math::combineHash(hash, std::hash<std::size_t>()(key.second));
+	return hash;
+}
+
+std::size_t CollisionModel::PolygonKeyHash::operator()(const PolygonKey& key) const
+{
+	std::size_t hash = key.size();
+
+	for (auto edge : key)
+	{
+		math::combineHash(hash, std::hash<std::size_t>()(edge));
+	}
+
+	return hash;
+}
+
+CollisionModel::CollisionModel() :
+	_collisionShader(game::current::getValue<std::string>(GKEY_COLLISION_SHADER))
+{
 	// Create the "NULL" edge (numVertices = 0)
 	_edges[0] = Edge(0);
+	_edgeIndices.emplace(EdgeKey(0, 0), 0);
 }
 
 int CollisionModel::findVertex(const Vector3& vertex) const {
-	for (VertexMap::const_iterator i = _vertices.begin();
-		i != _vertices.end();
-		++i)
-	{
-		if (i->second == vertex) {
-			return static_cast<int>(i->first);
-		}
-	}
-	return -1;
+	auto found = _vertexIndices.find(vertex);
+
+	return found != _vertexIndices.end() ? static_cast<int>(found->second) : -1;
 }
 
 std::size_t CollisionModel::addVertex(const Vector3& vertex)
@@ -105,6 +123,7 @@ std::size_t CollisionModel::addVertex(const Vector3& vertex)
 		// The size of the map is the highest index + 1
 		std::size_t lastIndex = _vertices.size();
 		_vertices[lastIndex] = snapped;
+		_vertexIndices.emplace(snapped, lastIndex);
 
 		return lastIndex;
 	}
@@ -115,21 +134,16 @@ std::size_t CollisionModel::addVertex(const Vector3& vertex)
 }
 
 int CollisionModel::findEdge(const Edge& edge) const {
-	for (EdgeMap::const_iterator i = _edges.begin();
-		 i != _edges.end();
-		 i++)
-	{
-		// Direction match?
-		if (i->second.from == edge.from && i->second.to == edge.to) {
-			return static_cast<int>(i->first);
-		}
+	auto found = _edgeIndices.find(EdgeKey(std::min(edge.from, edge.to), std::max(edge.from, edge.to)));
 
-		// Opposite direction match?
-		if (i->second.from == edge.to && i->second.to == edge.from) {
-			return -static_cast<int>(i->first);
-		}
+	if (found == _edgeIndices.end()) {
+		return 0;
 	}
-	return 0;
+
+	// The sign tells whether the existing edge is running in the opposite direction
+	const Edge& existing = _edges.at(found->second);
+
+	return existing.from == edge.from ? static_cast<int>(found->second) : -static_cast<int>(found->second);
 }
 
 std::size_t CollisionModel::addEdge(const Edge& edge) {
@@ -140,6 +154,7 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 		// NULL edge found, insert the edge with a new index
 		std::size_t edgeIndex = _edges.size();
 		_edges[edgeIndex] = edge;
+		_edgeIndices.emplace(EdgeKey(std::min(edge.from, edge.to), std::max(edge.from, edge.to)), edgeIndex);
 		return edgeIndex;
 	}
 	else {
@@ -147,33 +162,32 @@ std::size_t CollisionModel::addEdge(const Edge& edge) {
 	}
 }
 
+CollisionModel::PolygonKey CollisionModel::getPolygonKey(const EdgeList& edges) {
+	PolygonKey key;
+	key.reserve(edges.size());
+
+	for (auto edge : edges) {
+		key.push_back(static_cast<std::size_t>(abs(edge)));
+	}
+
+	std::sort(key.begin(), key.end());
+	return key;
+}
+
 int CollisionModel::findPolygon(const EdgeList& otherEdges) {
-	for (std::size_t p = 0; p < _polygons.size(); p++) {
-		// Check if the edge count matches
-		if (otherEdges.size() == _polygons[p].numEdges) {
-			// The match count
-			std::size_t matches = 0;
-
-			// See through the current polygon and count the matches
-			for (std::size_t i = 0; i < _polygons[p].edges.size(); i++) {
-				for (std::size_t j = 0; j < otherEdges.size(); j++) {
-					if (abs(_polygons[p].edges[i]) == abs(otherEdges[j])) {
-						matches++;
-					}
-				}
-			}
-
-			// If the polygons are the same, all the edge indices matched
-			if (matches == otherEdges.size()) {
-				// Remove the duplicate polygon
-				PolygonList::iterator i = _polygons.begin() + p;
-				_polygons.erase(i);
-				rMessage() << "CollisionModel: Removed duplicate polygon.\n";
-				return static_cast<int>(p);
-			}
-		}
+	auto found = _polygonIndices.find(getPolygonKey(otherEdges));
+
+	if (found == _polygonIndices.end()) {
+		return -1;
 	}
-	return -1;
+
+	// Remove the duplicate polygon
+	auto index = found->second;
+	_polygonIsRemoved[index] = true;
+	_polygonIndices.erase(found);
+
+	rMessage() << "CollisionModel: Removed duplicate polygon.\n";
+	return static_cast<int>(index);
 }
 
 void CollisionModel::addPolygon(
@@ -201,8 +215,10 @@ void CollisionModel::addPolygon(
 		poly.min = faceAABB.origin - faceAABB.extents;
 		poly.max = faceAABB.origin + faceAABB.extents;
 		//poly.shader = face.GetShader();
-		poly.shader = game::current::getValue<std::string>(GKEY_COLLISION_SHADER);
+		poly.shader = _collisionShader;
 
+		_polygonIndices.emplace(getPolygonKey(poly.edges), _polygons.size());
+		_polygonIsRemoved.push_back(false);
 		_polygons.push_back(poly);
 	}
 }
@@ -318,7 +334,9 @@ std::ostream& operator<<(std::ostream& st, const CollisionModel& cm) {
 	// Export the polygons
 	st << "\tpolygons {\n";
 	for (std::size_t i = 0; i < cm._polygons.size(); i++) {
-		st << "\t" << cm._polygons[i] << "\n";
+		if (!cm._polygonIsRemoved[i]) {
+			st << "\t" << cm._polygons[i] << "\n";
+		}
 	}
 	st << "\t}\n";
 
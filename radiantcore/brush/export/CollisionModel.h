@@ -2,6 +2,8 @@
 
 #include "Geometry.h"
 #include <memory>
+#include <unordered_map>
+#include "render/VertexHashing.h"
 
 class Winding;
 class Brush;
@@ -17,7 +19,34 @@ class CollisionModel
 	PolygonList _polygons;
 	BrushList _brushes;
 
+	// Undirected edge key, the smaller vertex index comes first
+	typedef std::pair<std::size_t, std::size_t> EdgeKey;
+
+	struct EdgeKeyHash
+	{
+		std::size_t operator()(const EdgeKey& key) const;
+	};
+
+	// Polygon key, made up of the sorted absolute edge indices
+	typedef std::vector<std::size_t> PolygonKey;
+
+	struct PolygonKeyHash
+	{
+		std::size_t operator()(const PolygonKey& key) const;
+	};
+
+	// Lookup tables to find existing vertices, edges and polygons without
+	// walking through the lists above. The vertices are snapped before they
+	// are stored, the coarse Vector3 hash is putting them into buckets.
+	std::unordered_map<Vector3, std::size_t> _vertexIndices;
+	std::unordered_map<EdgeKey, std::size_t, EdgeKeyHash> _edgeIndices;
+	std::unordered_map<PolygonKey, std::size_t, PolygonKeyHash> _polygonIndices;
+
+	// Polygons found to be duplicates are flagged here and not written
+	std::vector<bool> _polygonIsRemoved;
+
 	std::string _model;
+	std::string _collisionShader;
 
 public:
 	CollisionModel();
@@ -80,7 +109,7 @@ private:
 
 	/** greebo: Tries to lookup the index of the matching polygon.
 	 * 			All the Edge indices are compared regardless of
-	 * 			their order.
+	 * 			their order. A matching polygon is removed.
 	 *
 	 * @returns: the index of the polygon or -1 if not found
 	 */
@@ -92,6 +121,9 @@ private:
 	 * 			Duplicate polygons are not added.
 	 */
 	void addPolygon(const Face& face, const VertexList& vertexList);
+
+	// Returns the lookup key of the polygon defined by the given edges
+	static PolygonKey getPolygonKey(const EdgeList& edges);
 };
 
 typedef std::shared_ptr<CollisionModel> CollisionModelPtr;
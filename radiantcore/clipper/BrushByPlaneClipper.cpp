@@ -42,13 +42,14 @@ void BrushByPlaneClipper::split(const BrushPtrVector& brushes)
 			continue;
 		}
 
-		// greebo: Analyse the brush to find out which shader is the most used one
-		getMostUsedTexturing(brush);
-
 		BrushSplitType split = brush.classifyPlane(_split == eFront ? -plane : plane);
 
 		if (split.counts[ePlaneBack] > 0 && split.counts[ePlaneFront] > 0)
 		{
+			// greebo: Analyse the brush to find out which shader is the most used one
+			// This is only needed for the new faces, brushes not touched by the plane can skip it
+			getMostUsedTexturing(brush);
+
 			// the plane intersects this brush
 			if (_split == eFrontAndBack)
 			{
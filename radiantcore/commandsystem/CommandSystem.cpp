@@ -3,6 +3,9 @@
 #include "itextstream.h"
 #include "iregistry.h"
 #include "iradiant.h"
+#include "imap.h"
+#include "iscenegraph.h"
+#include "iundo.h"
 #include "debugging/debugging.h"
 #include "command/ExecutionFailure.h"
 #include "command/ExecutionNotPossible.h"
@@ -63,6 +66,8 @@ void CommandSystem::shutdownModule()
 
 	// Free all commands
 	_commands.clear();
+	_preparedCommands.clear();
+	_preparedCommandIds.clear();
 }
 
 void CommandSystem::printCmd(const ArgumentList& args) {
@@ -105,6 +110,8 @@ void CommandSystem::loadBinds() {
 				<< name << std::endl;
 		}
 	}
+
+	++_commandGeneration;
 }
 
 void CommandSystem::saveBinds() {
@@ -160,6 +167,7 @@ void CommandSystem::unbindCmd(const ArgumentList& args)
 	{
 		// This is a user-statement
 		_commands.erase(found);
+		++_commandGeneration;
 	}
 	else
 	{
@@ -194,7 +202,10 @@ void CommandSystem::addCommandObject(const std::string& name, CommandPtr cmd)
 	if (auto result = _commands.emplace(name, cmd); !result.second) {
         rError() << "Cannot register command " << name << ", this command is already registered."
                  << std::endl;
+        return;
     }
+
+	++_commandGeneration;
 }
 
 void CommandSystem::addCommand(const std::string& name, Function func,
@@ -221,6 +232,7 @@ void CommandSystem::removeCommand(const std::string& name)
 	if (i != _commands.end())
 	{
 		_commands.erase(i);
+		++_commandGeneration;
 	}
 }
 
@@ -240,7 +252,10 @@ void CommandSystem::addStatement(const std::string& statementName,
 	{
 		rError() << "Cannot register statement " << statementName
 			<< ", this statement is already registered." << std::endl;
+		return;
 	}
+
+	++_commandGeneration;
 }
 
 void CommandSystem::foreachStatement(const std::function<void(const std::string&)>& functor,
@@ -366,12 +381,93 @@ void CommandSystem::execute(const std::string& input)
     }
 }
 
+PreparedCommandId CommandSystem::prepare(const std::string& input)
+{
+    if (auto existing = _preparedCommandIds.find(input); existing != _preparedCommandIds.end())
+    {
+        return existing->second;
+    }
+
+    auto prepared = std::make_shared<PreparedCommand>();
+
+    for (auto& statement : parseCommandString(input))
+    {
+        prepared->statements.emplace_back(PreparedStatement{ std::move(statement.command), std::move(statement.args) });
+    }
+
+    resolvePreparedCommand(*prepared);
+
+    auto id = _preparedCommands.size();
+    _preparedCommands.emplace_back(std::move(prepared));
+    _preparedCommandIds.emplace(input, id);
+
+    return id;
+}
+
+void CommandSystem::resolvePreparedCommand(PreparedCommand& prepared)
+{
+    for (auto& statement : prepared.statements)
+    {
+        auto found = _commands.find(statement.command);
+        statement.executable = found != _commands.end() ? found->second : ExecutablePtr();
+    }
+
+    prepared.generation = _commandGeneration;
+}
+
+void CommandSystem::executePrepared(PreparedCommandId id)
+{
+    if (id >= _preparedCommands.size())
+    {
+        rError() << "Cannot execute prepared command " << id << ": unknown ID." << std::endl;
+        return;
+    }
+
+    // Hold a reference, the executed commands might prepare other strings
+    auto prepared = _preparedCommands[id];
+
+    if (prepared->generation != _commandGeneration)
+    {
+        resolvePreparedCommand(*prepared);
+    }
+
+    for (const auto& statement : prepared->statements)
+    {
+        // A command might remove itself or others, keep the executable alive
+        auto executable = statement.executable;
+        executeResolved(statement.command, executable, statement.args);
+    }
+}
+
+void CommandSystem::executeBatch(const std::string& input, const std::string& undoOperationName)
+{
+    auto id = prepare(input);
+
+    // The map module is depending on the command system, it's acquired at execution time
+    if (!GlobalMapModule().getRoot())
+    {
+        executePrepared(id);
+        return;
+    }
+
+    // The operation is recorded before the scene notifications are sent
+    scene::GraphBatchUpdate sceneUpdate(GlobalSceneGraph());
+    UndoableCommand undo(undoOperationName);
+
+    executePrepared(id);
+}
+
 void CommandSystem::executeCommand(const std::string& name, const ArgumentList& args)
 {
 	// Find the named command
 	auto i = _commands.find(name);
 
-	if (i == _commands.end())
+	executeResolved(name, i != _commands.end() ? i->second : ExecutablePtr(), args);
+}
+
+void CommandSystem::executeResolved(const std::string& name, const ExecutablePtr& executable, const ArgumentList& args)
+{
+	if (!executable)
 	{
 		rError() << "Cannot execute command " << name << ": Command not found." << std::endl;
 		return;
@@ -379,7 +475,7 @@ void CommandSystem::executeCommand(const std::string& name, const ArgumentList&
 
 	try
 	{
-		i->second->execute(args);
+		executable->execute(args);
 	}
 	catch (const ExecutionNotPossible& ex)
 	{
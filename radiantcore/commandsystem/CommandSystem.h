@@ -3,6 +3,8 @@
 #include "commandsystem/Command.h"
 #include "icommandsystem.h"
 #include <map>
+#include <unordered_map>
+#include <vector>
 #include "Executable.h"
 
 #include "string/string.h"
@@ -17,6 +19,30 @@ class CommandSystem :
 	typedef std::map<std::string, ExecutablePtr, string::ILess> CommandMap;
 	CommandMap _commands;
 
+	// A statement of a prepared command string, with its executable looked up
+	struct PreparedStatement
+	{
+		std::string command;
+		ArgumentList args;
+		ExecutablePtr executable; // empty if the command doesn't exist
+	};
+
+	struct PreparedCommand
+	{
+		std::vector<PreparedStatement> statements;
+
+		// The _commandGeneration the executables have been looked up in
+		std::size_t generation;
+	};
+
+	// Indexed by PreparedCommandId
+	std::vector<std::shared_ptr<PreparedCommand>> _preparedCommands;
+	std::unordered_map<std::string, PreparedCommandId> _preparedCommandIds;
+
+	// Increased whenever a command or statement is added or removed,
+	// the prepared commands are looked up again on their next execution
+	std::size_t _commandGeneration = 0;
+
 public:
 	void foreachCommand(const std::function<void(const std::string&)>& functor) override;
 
@@ -38,6 +64,10 @@ public:
 	// Execute the given command sequence
 	void execute(const std::string& input) override;
 
+	PreparedCommandId prepare(const std::string& input) override;
+	void executePrepared(PreparedCommandId id) override;
+	void executeBatch(const std::string& input, const std::string& undoOperationName) override;
+
 	// For more than 3 arguments, use this method to pass a vector of arguments
 	void executeCommand(const std::string& name, const ArgumentList& args) override;
 
@@ -59,6 +89,11 @@ public:
 private:
 	void addCommandObject(const std::string& name, CommandPtr cmd);
 
+	void resolvePreparedCommand(PreparedCommand& prepared);
+
+	// Runs the given executable, reporting failures to the message bus
+	void executeResolved(const std::string& name, const ExecutablePtr& executable, const ArgumentList& args);
+
 	// Save/load bind strings from Registry
 	void loadBinds();
 	void saveBinds();
@@ -1,6 +1,7 @@
 #ifndef _STATEMENT_H_
 #define _STATEMENT_H_
 
+#include <optional>
 #include "itextstream.h"
 #include "Executable.h"
 
@@ -15,6 +16,9 @@ class Statement :
 	// Whether this statement is a default one (won't be saved or deleted)
 	bool _isReadOnly;
 
+	// The string is parsed on first execution only
+	std::optional<PreparedCommandId> _preparedId;
+
 public:
 	Statement(const std::string& str, bool isReadOnly = false) :
 		_string(str),
@@ -22,8 +26,13 @@ public:
 	{}
 
 	void execute(const ArgumentList& args) override {
-		// Execution means parsing another string
-		GlobalCommandSystem().execute(_string);
+		// Execution means running another command string
+		if (!_preparedId)
+		{
+			_preparedId = GlobalCommandSystem().prepare(_string);
+		}
+
+		GlobalCommandSystem().executePrepared(*_preparedId);
 	}
 
     bool canExecute() const override {
@@ -0,0 +1,212 @@
+#include "DeclarationCache.h"
+
+#include <fstream>
+#include <stdexcept>
+#include "itextstream.h"
+#include "os/file.h"
+#include "stream/utils.h"
+#include "stream/MemoryInputStream.h"
+#include "vfs/MappedFile.h"
+
+namespace decl
+{
+
+namespace
+{
+    const char* const CACHE_FILE_MAGIC = "DRDECLCA";
+    const uint32_t CACHE_FILE_VERSION = 1;
+
+    class CacheReadException :
+        public std::runtime_error
+    {
+    public:
+        CacheReadException() :
+            std::runtime_error("Unexpected end of file")
+        {}
+    };
+
+    template<typename ValueType>
+    ValueType readValue(stream::MemoryInputStream& stream)
+    {
+        if (stream.remaining() < sizeof(ValueType)) throw CacheReadException();
+
+        return stream::readLittleEndian<ValueType>(stream);
+    }
+
+    std::string readString(stream::MemoryInputStream& stream)
+    {
+        auto length = readValue<uint32_t>(stream);
+
+        if (stream.remaining() < length) throw CacheReadException();
+
+        std::string value(reinterpret_cast<const char*>(stream.get()), length);
+        stream.seek(static_cast<SeekableStream::offset_type>(length), SeekableStream::cur);
+
+        return value;
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    std::string getFolderKey(const std::string& folder, const std::string& extension)
+    {
+        return folder + "*." + extension;
+    }
+}
+
+DeclarationCache::DeclarationCache(const std::string& cacheFile) :
+    _cacheFile(cacheFile)
+{
+    load();
+}
+
+std::shared_ptr<ParsedFileCache> DeclarationCache::getParsedFiles(const std::string& folder, const std::string& extension)
+{
+    auto key = getFolderKey(folder, extension);
+    _usedFolders.insert(key);
+
+    auto& parsedFiles = _folders[key];
+
+    if (!parsedFiles)
+    {
+        parsedFiles = std::make_shared<ParsedFileCache>();
+        parsedFiles->changed = true;
+    }
+
+    return parsedFiles;
+}
+
+void DeclarationCache::save()
+{
+    bool changed = false;
+
+    for (auto i = _folders.begin(); i != _folders.end();)
+    {
+        if (_usedFolders.count(i->first) == 0)
+        {
+            i = _folders.erase(i);
+            changed = true;
+            continue;
+        }
+
+        changed |= i->second->changed;
+        ++i;
+    }
+
+    if (!changed) return;
+
+    std::ofstream stream(_cacheFile, std::ios::binary | std::ios::trunc);
+
+    if (!stream)
+    {
+        rWarning() << "[DeclManager] Cannot write declaration cache " << _cacheFile << std::endl;
+        return;
+    }
+
+    stream.write(CACHE_FILE_MAGIC, 8);
+    stream::writeLittleEndian<uint32_t>(stream, CACHE_FILE_VERSION);
+    stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(_folders.size()));
+
+    for (const auto& [key, parsedFiles] : _folders)
+    {
+        writeString(stream, key);
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(parsedFiles->files.size()));
+
+        for (const auto& [path, file] : parsedFiles->files)
+        {
+            writeString(stream, path);
+            writeString(stream, file.stamp.archivePath);
+            stream::writeLittleEndian<uint64_t>(stream, file.stamp.size);
+            stream::writeLittleEndian<int64_t>(stream, file.stamp.modificationTime);
+            writeString(stream, file.modName);
+            writeString(stream, file.contentHash);
+            stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(file.blocks.size()));
+
+            for (const auto& block : file.blocks)
+            {
+                writeString(stream, block.typeName);
+                writeString(stream, block.name);
+                writeString(stream, block.contents);
+            }
+        }
+
+        parsedFiles->changed = false;
+    }
+}
+
+void DeclarationCache::load()
+{
+    if (!os::fileOrDirExists(_cacheFile)) return;
+
+    archive::MappedFile file(_cacheFile);
+
+    if (!file.isValid()) return;
+
+    stream::MemoryInputStream stream(file.data(), file.size());
+
+    try
+    {
+        if (stream.remaining() < 8 || std::string(reinterpret_cast<const char*>(stream.get()), 8) != CACHE_FILE_MAGIC)
+        {
+            throw std::runtime_error("Invalid file header");
+        }
+
+        stream.seek(8);
+
+        if (readValue<uint32_t>(stream) != CACHE_FILE_VERSION)
+        {
+            // Written by a different version, will be replaced on the next save
+            return;
+        }
+
+        auto numFolders = readValue<uint32_t>(stream);
+        std::size_t numFiles = 0;
+
+        for (uint32_t i = 0; i < numFolders; ++i)
+        {
+            auto key = readString(stream);
+            auto parsedFiles = std::make_shared<ParsedFileCache>();
+
+            auto numFolderFiles = readValue<uint32_t>(stream);
+
+            for (uint32_t f = 0; f < numFolderFiles; ++f)
+            {
+                auto path = readString(stream);
+                auto& parsedFile = parsedFiles->files[path];
+
+                parsedFile.stamp.archivePath = readString(stream);
+                parsedFile.stamp.size = readValue<uint64_t>(stream);
+                parsedFile.stamp.modificationTime = readValue<int64_t>(stream);
+                parsedFile.modName = readString(stream);
+                parsedFile.contentHash = readString(stream);
+
+                auto numBlocks = readValue<uint32_t>(stream);
+
+                for (uint32_t b = 0; b < numBlocks; ++b)
+                {
+                    auto& block = parsedFile.blocks.emplace_back();
+
+                    block.typeName = readString(stream);
+                    block.name = readString(stream);
+                    block.contents = readString(stream);
+                    block.modName = parsedFile.modName;
+                }
+            }
+
+            numFiles += parsedFiles->files.size();
+            _folders.emplace(key, std::move(parsedFiles));
+        }
+
+        rMessage() << "[DeclManager] Loaded " << numFiles << " parsed files from " << _cacheFile << std::endl;
+    }
+    catch (std::runtime_error& ex)
+    {
+        rWarning() << "[DeclManager] Discarding declaration cache " << _cacheFile << ": " << ex.what() << std::endl;
+        _folders.clear();
+    }
+}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include "DeclarationFolderParser.h"
+
+namespace decl
+{
+
+/**
+ * Persistent cache of the parsed decl files, stored in a binary file in the
+ * user's cache folder. It holds the syntax blocks of every file along with the
+ * hash of its contents, such that only changed files need to be parsed on the
+ * next start. Files located in unchanged archives are not even read.
+ *
+ * The cache file is machine-local and not meant to be shared, it will simply
+ * be discarded if it cannot be read back.
+ */
+class DeclarationCache
+{
+private:
+    std::string _cacheFile;
+
+    // The parsed files per decl folder, shared with the folder parsers
+    std::map<std::string, std::shared_ptr<ParsedFileCache>> _folders;
+
+    // The folders in use during this session, all others are dropped on save
+    std::set<std::string> _usedFolders;
+
+public:
+    // Loads the cache from the given file, which doesn't need to exist yet
+    DeclarationCache(const std::string& cacheFile);
+
+    // Returns the parsed files of the given decl folder and extension,
+    // which is empty if the folder is not known yet
+    std::shared_ptr<ParsedFileCache> getParsedFiles(const std::string& folder, const std::string& extension);
+
+    // Writes the cache file if any of the folders has been changed.
+    // No parser must be running while this method is executed.
+    void save();
+
+private:
+    void load();
+};
+
+}
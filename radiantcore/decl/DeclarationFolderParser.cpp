@@ -1,8 +1,11 @@
 #include "DeclarationFolderParser.h"
 
 #include "DeclarationManager.h"
+#include "itaskscheduler.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "string/trim.h"
+#include "math/Hash.h"
+#include "os/fs.h"
 
 namespace decl
 {
@@ -25,21 +28,125 @@ namespace
 
         return syntax;
     }
+
+    // Physical files are the ones being edited, mtimes are not reliable enough
+    // to detect quick changes, so these are always checked by their contents
+    FileStamp getFileStamp(const vfs::FileInfo& fileInfo)
+    {
+        FileStamp stamp;
+
+        if (fileInfo.getIsPhysicalFile())
+        {
+            return stamp;
+        }
+
+        try
+        {
+            auto archivePath = fileInfo.getArchivePath();
+            stamp.modificationTime = static_cast<int64_t>(fs::last_write_time(archivePath).time_since_epoch().count());
+            stamp.size = fileInfo.getSize();
+            stamp.archivePath = archivePath;
+        }
+        catch (fs::filesystem_error&)
+        {
+            // Leave the stamp invalid, the file will be read
+        }
+
+        return stamp;
+    }
 }
 
 DeclarationFolderParser::DeclarationFolderParser(DeclarationManager& owner, Type declType, 
     const std::string& baseDir, const std::string& extension,
-    const std::map<std::string, Type, string::ILess>& typeMapping) :
+    const std::map<std::string, Type, string::ILess>& typeMapping,
+    const std::shared_ptr<ParsedFileCache>& parsedFiles) :
     ThreadedDeclParser<void>(declType, baseDir, extension, 1),
     _owner(owner),
     _typeMapping(typeMapping),
-    _defaultDeclType(declType)
+    _defaultDeclType(declType),
+    _parsedFiles(parsedFiles)
 {}
 
 void DeclarationFolderParser::parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir)
 {
-    // Parse the incoming stream into syntax blocks
-    parser::DefBlockSyntaxParser<std::istream> parser(stream);
+    auto result = parseFile(stream, fileInfo, modDir);
+    result.stamp = getFileStamp(fileInfo);
+
+    mergeFileResult(result);
+}
+
+void DeclarationFolderParser::processFiles(const std::vector<vfs::FileInfo>& files)
+{
+    std::vector<FileResult> results(files.size());
+
+    // File sizes vary a lot, so every worker just picks the next unparsed file
+    GlobalTaskScheduler().parallelFor(files.size(), [&](std::size_t i)
+    {
+        results[i] = parseFile(files[i]);
+    });
+
+    // Apply the results in file order, the first declaration of a name wins
+    for (auto& result : results)
+    {
+        if (result.valid)
+        {
+            mergeFileResult(result);
+        }
+    }
+}
+
+DeclarationFolderParser::FileResult DeclarationFolderParser::parseFile(const vfs::FileInfo& fileInfo) const
+{
+    FileResult result;
+    auto stamp = getFileStamp(fileInfo);
+
+    auto cached = _parsedFiles->files.find(fileInfo.fullPath());
+
+    if (stamp.isValid() && cached != _parsedFiles->files.end() && cached->second.stamp == stamp)
+    {
+        result.fileInfo = fileInfo;
+        result.modDir = cached->second.modName;
+        result.contentHash = cached->second.contentHash;
+        result.unchanged = true;
+        result.valid = true;
+    }
+    else
+    {
+        processFile(fileInfo, [&](std::istream& stream, const std::string& modDir)
+        {
+            result = parseFile(stream, fileInfo, modDir);
+        });
+    }
+
+    result.stamp = std::move(stamp);
+
+    return result;
+}
+
+DeclarationFolderParser::FileResult DeclarationFolderParser::parseFile(std::istream& stream,
+    const vfs::FileInfo& fileInfo, const std::string& modDir) const
+{
+    FileResult result;
+    result.fileInfo = fileInfo;
+    result.modDir = modDir;
+
+    const std::string contents(std::istreambuf_iterator<char>(stream), {});
+
+    math::Hash hash;
+    hash.addString(contents);
+    result.contentHash = hash;
+
+    auto cached = _parsedFiles->files.find(fileInfo.fullPath());
+
+    if (cached != _parsedFiles->files.end() && cached->second.contentHash == result.contentHash)
+    {
+        result.unchanged = true;
+        result.valid = true;
+        return result;
+    }
+
+    // Parse the file contents into syntax blocks
+    parser::DefBlockSyntaxParser<const std::string> parser(contents);
 
     auto syntaxTree = parser.parse();
 
@@ -53,21 +160,74 @@ void DeclarationFolderParser::parse(std::istream& stream, const vfs::FileInfo& f
         const auto& blockNode = static_cast<const parser::DefBlockSyntax&>(*node);
 
         // Convert the incoming block to a DeclarationBlockSyntax
-        auto blockSyntax = createBlock(blockNode, fileInfo, modDir);
+        result.blocks.emplace_back(createBlock(blockNode, fileInfo, modDir));
+    }
+
+    result.valid = true;
+    return result;
+}
+
+void DeclarationFolderParser::mergeFileResult(FileResult& result)
+{
+    auto path = result.fileInfo.fullPath();
+    _visitedFiles.insert(path);
 
-        // Move the block in the correct bucket
-        auto declType = determineBlockType(blockSyntax);
-        auto& blockList = _parsedBlocks.try_emplace(declType).first->second;
-        blockList.emplace_back(std::move(blockSyntax));
+    auto& parsedFile = _parsedFiles->files[path];
+
+    if (!result.unchanged || !(parsedFile.stamp == result.stamp) || parsedFile.modName != result.modDir)
+    {
+        _parsedFiles->changed = true;
+    }
+
+    parsedFile.stamp = std::move(result.stamp);
+    parsedFile.modName = result.modDir;
+
+    if (!result.unchanged)
+    {
+        parsedFile.contentHash = std::move(result.contentHash);
+        parsedFile.blocks = std::move(result.blocks);
+    }
+
+    for (const auto& block : parsedFile.blocks)
+    {
+        auto blockSyntax = block;
+
+        // The file might be located in a different archive after the VFS has been re-initialised
+        blockSyntax.fileInfo = result.fileInfo;
+        blockSyntax.modName = result.modDir;
+
+        addBlock(std::move(blockSyntax));
     }
 }
 
 void DeclarationFolderParser::onFinishParsing()
 {
+    // Forget about the files which are gone
+    for (auto i = _parsedFiles->files.begin(); i != _parsedFiles->files.end();)
+    {
+        if (_visitedFiles.count(i->first) == 0)
+        {
+            i = _parsedFiles->files.erase(i);
+            _parsedFiles->changed = true;
+            continue;
+        }
+
+        ++i;
+    }
+
     // Submit all parsed declarations to the decl manager
     _owner.onParserFinished(_defaultDeclType, _parsedBlocks);
 }
 
+void DeclarationFolderParser::addBlock(DeclarationBlockSyntax&& block)
+{
+    // Move the block in the correct bucket, the type mapping might
+    // have changed since the block has been parsed
+    auto declType = determineBlockType(block);
+    auto& blockList = _parsedBlocks.try_emplace(declType).first->second;
+    blockList.emplace_back(std::move(block));
+}
+
 Type DeclarationFolderParser::determineBlockType(const DeclarationBlockSyntax& block)
 {
     if (block.typeName.empty())
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <set>
 #include "ideclmanager.h"
 #include "DeclarationFile.h"
 
@@ -14,6 +17,47 @@ class DeclarationManager;
 
 using ParseResult = std::map<Type, std::vector<DeclarationBlockSyntax>>;
 
+// Identifies the version of a file located in an archive, without reading it
+struct FileStamp
+{
+    // The path of the containing archive, empty for physical files
+    std::string archivePath;
+
+    // The size of the file and the modification time of the archive
+    uint64_t size = 0;
+    int64_t modificationTime = 0;
+
+    bool isValid() const
+    {
+        return !archivePath.empty();
+    }
+
+    bool operator==(const FileStamp& other) const
+    {
+        return archivePath == other.archivePath && size == other.size &&
+            modificationTime == other.modificationTime;
+    }
+};
+
+// The blocks found in a single decl file, along with the hash of the file contents
+struct ParsedFile
+{
+    FileStamp stamp;
+    std::string modName;
+    std::string contentHash;
+    std::vector<DeclarationBlockSyntax> blocks;
+};
+
+// Parsed files of a decl folder, kept between the runs of its parser
+struct ParsedFileCache
+{
+    // Parsed files by VFS path
+    std::map<std::string, ParsedFile> files;
+
+    // Set if files have been added, changed or removed
+    bool changed = false;
+};
+
 // Threaded parser processing all files in the configured decl folder
 // Submits all parsed declarations to the IDeclarationManager when finished
 class DeclarationFolderParser :
@@ -31,10 +75,31 @@ private:
     // The default type to assign to untyped blocks
     Type _defaultDeclType;
 
+    // The files parsed in previous runs, unchanged files are not parsed again
+    std::shared_ptr<ParsedFileCache> _parsedFiles;
+    std::set<std::string> _visitedFiles;
+
+    // The outcome of parsing a single file, produced by the worker threads
+    struct FileResult
+    {
+        vfs::FileInfo fileInfo;
+        FileStamp stamp;
+        std::string modDir;
+        std::string contentHash;
+
+        // True if the file contents match the cached ones, blocks are empty in this case
+        bool unchanged = false;
+        std::vector<DeclarationBlockSyntax> blocks;
+
+        // False if the file could not be opened or parsed
+        bool valid = false;
+    };
+
 public:
     DeclarationFolderParser(DeclarationManager& owner, Type declType,
         const std::string& baseDir, const std::string& extension,
-        const std::map<std::string, Type, string::ILess>& typeMapping);
+        const std::map<std::string, Type, string::ILess>& typeMapping,
+        const std::shared_ptr<ParsedFileCache>& parsedFiles);
 
     ~DeclarationFolderParser() override
     {
@@ -44,10 +109,20 @@ public:
 
 protected:
     void parse(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) override;
+    void processFiles(const std::vector<vfs::FileInfo>& files) override;
     void onFinishParsing() override;
 
 private:
+    // Thread-safe as long as no results are merged at the same time.
+    // Files in unchanged archives are taken from the cache without reading them.
+    FileResult parseFile(const vfs::FileInfo& fileInfo) const;
+    FileResult parseFile(std::istream& stream, const vfs::FileInfo& fileInfo, const std::string& modDir) const;
+
+    // Applies the result of a single file, must be invoked in file order
+    void mergeFileResult(FileResult& result);
+
     Type determineBlockType(const DeclarationBlockSyntax& block);
+    void addBlock(DeclarationBlockSyntax&& block);
 };
 
 }
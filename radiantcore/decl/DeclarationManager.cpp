@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <future>
 #include <fstream>
 
@@ -9,18 +10,30 @@
 #include "DeclarationFolderParser.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "ifilesystem.h"
+#include "itaskscheduler.h"
 #include "module/StaticModule.h"
 #include "string/trim.h"
+#include "string/predicate.h"
 #include "os/path.h"
 #include "os/file.h"
 #include "fmt/format.h"
 #include "gamelib.h"
 #include "stream/TemporaryOutputStream.h"
 #include "util/ScopedBoolLock.h"
+#include "time/TraceRecorder.h"
 
 namespace decl
 {
 
+namespace
+{
+    bool isSameSyntax(const DeclarationBlockSyntax& a, const DeclarationBlockSyntax& b)
+    {
+        return a.typeName == b.typeName && a.name == b.name && a.contents == b.contents &&
+            a.modName == b.modName && a.fileInfo == b.fileInfo;
+    }
+}
+
 void DeclarationManager::registerDeclType(const std::string& typeName, const IDeclarationCreator::Ptr& creator)
 {
     {
@@ -60,16 +73,26 @@ void DeclarationManager::registerDeclFolder(Type defaultType, const std::string&
     auto vfsPath = os::standardPathWithSlash(inputFolder);
     auto extension = string::trim_left_copy(inputExtension, ".");
 
+    std::shared_ptr<ParsedFileCache> parsedFiles;
+
     {
         std::lock_guard folderLock(_registeredFoldersLock);
-        _registeredFolders.emplace_back(RegisteredFolder{ vfsPath, extension, defaultType });
+
+        parsedFiles = _declarationCache ? _declarationCache->getParsedFiles(vfsPath, extension) :
+            std::make_shared<ParsedFileCache>();
+
+        _registeredFolders.emplace_back(RegisteredFolder{ vfsPath, extension, defaultType, parsedFiles });
     }
 
     std::lock_guard declLock(_declarationAndCreatorLock);
     auto& decls = _declarationsByType.try_emplace(defaultType, Declarations()).first->second;
 
+    // The new parser can produce declarations of any type, lookups need to wait for it
+    invalidateAllPublishedDeclarations();
+
     // Start the parser thread
-    decls.parser = std::make_unique<DeclarationFolderParser>(*this, defaultType, vfsPath, extension, getTypenameMapping());
+    decls.parser = std::make_unique<DeclarationFolderParser>(*this, defaultType, vfsPath, extension,
+        getTypenameMapping(), parsedFiles);
     decls.parser->start();
 }
 
@@ -89,23 +112,19 @@ std::map<std::string, Type, string::ILess> DeclarationManager::getTypenameMappin
 
 IDeclaration::Ptr DeclarationManager::findDeclaration(Type type, const std::string& name)
 {
-    IDeclaration::Ptr returnValue;
-
-    doWithDeclarationLock(type, [&](NamedDeclarations& decls)
-    {
-        auto decl = decls.find(name);
+    auto decls = getPublishedDeclarations(type);
+    auto decl = decls->find(name);
 
-        if (decl != decls.end())
-        {
-            returnValue = decl->second;
-        }
-    });
-
-    return returnValue;
+    return decl != decls->end() ? decl->second : IDeclaration::Ptr();
 }
 
 IDeclaration::Ptr DeclarationManager::findOrCreateDeclaration(Type type, const std::string& name)
 {
+    if (auto existing = findDeclaration(type, name); existing)
+    {
+        return existing;
+    }
+
     IDeclaration::Ptr returnValue;
 
     doWithDeclarationLock(type, [&](NamedDeclarations& decls)
@@ -149,13 +168,112 @@ IDeclaration::Ptr DeclarationManager::findOrCreateDeclaration(Type type, const s
 
 void DeclarationManager::foreachDeclaration(Type type, const std::function<void(const IDeclaration::Ptr&)>& functor)
 {
-    doWithDeclarationLock(type, [&](NamedDeclarations& decls)
+    // The functor is invoked without holding any lock, changes made in
+    // the meantime are not reflected by this iteration
+    for (const auto& [_, decl] : *getPublishedDeclarations(type))
+    {
+        functor(decl);
+    }
+}
+
+DeclarationManager::PublishedDeclarations DeclarationManager::getPublishedDeclarations(Type type)
+{
+    auto index = static_cast<std::size_t>(type);
+    auto isPublishable = index < _publishedDeclarations.size();
+
+    if (isPublishable)
     {
-        for (const auto& [_, decl] : decls)
+        if (auto published = std::atomic_load(&_publishedDeclarations[index]); published)
         {
-            functor(decl);
+            return published;
         }
-    });
+    }
+
+    // All parsers should be done before doing anything with the declarations
+    waitForTypedParsersToFinish();
+
+    std::lock_guard declLock(_declarationAndCreatorLock);
+
+    auto decls = _declarationsByType.find(type);
+
+    auto published = decls != _declarationsByType.end() ?
+        std::make_shared<const NamedDeclarations>(decls->second.decls) :
+        std::make_shared<const NamedDeclarations>();
+
+    // Any change is made while holding the lock, so this copy is up to date
+    if (isPublishable)
+    {
+        std::atomic_store(&_publishedDeclarations[index], published);
+    }
+
+    return published;
+}
+
+void DeclarationManager::invalidatePublishedDeclarations(Type type)
+{
+    auto index = static_cast<std::size_t>(type);
+
+    if (index < _publishedDeclarations.size())
+    {
+        std::atomic_store(&_publishedDeclarations[index], PublishedDeclarations());
+    }
+}
+
+void DeclarationManager::invalidateAllPublishedDeclarations()
+{
+    for (auto& published : _publishedDeclarations)
+    {
+        std::atomic_store(&published, PublishedDeclarations());
+    }
+}
+
+DeclarationNameSnapshot::Ptr DeclarationManager::getNameSnapshot(Type type)
+{
+    // All parsers should be done before doing anything with the declarations
+    waitForTypedParsersToFinish();
+
+    std::lock_guard declLock(_declarationAndCreatorLock);
+
+    auto decls = _declarationsByType.find(type);
+
+    if (decls == _declarationsByType.end())
+    {
+        static auto emptySnapshot = std::make_shared<const DeclarationNameSnapshot>();
+        return emptySnapshot;
+    }
+
+    if (!decls->second.nameSnapshot)
+    {
+        auto snapshot = std::make_shared<DeclarationNameSnapshot>();
+
+        snapshot->version = ++_nameSnapshotVersion;
+        snapshot->entries.reserve(decls->second.decls.size());
+
+        for (const auto& [_, decl] : decls->second.decls)
+        {
+            // Some names contain backslashes, use forward slashes for the path
+            snapshot->entries.push_back(DeclarationNameSnapshot::Entry
+            {
+                decl->getDeclName(),
+                decl->getModName() + "/" + os::standardPath(decl->getDeclName()),
+                decl->getBlockSyntax().fileInfo.visibility
+            });
+        }
+
+        decls->second.nameSnapshot = snapshot;
+    }
+
+    return decls->second.nameSnapshot;
+}
+
+void DeclarationManager::invalidateNameSnapshot(Type type)
+{
+    auto decls = _declarationsByType.find(type);
+
+    if (decls != _declarationsByType.end())
+    {
+        decls->second.nameSnapshot.reset();
+    }
 }
 
 void DeclarationManager::doWithDeclarationLock(Type type, const std::function<void(NamedDeclarations&)>& action)
@@ -178,19 +296,19 @@ void DeclarationManager::reloadDeclarations()
     // Don't allow reloadDecls to be run before the startup phase is complete
     waitForTypedParsersToFinish();
 
+    // The parsers should see the files including any deferred saves
+    waitForPendingSaves();
+
     // Don't allow more than one simultaneous reloadDecls run
     if (_reparseInProgress) return;
 
     util::ScopedBoolLock reparseLock(_reparseInProgress);
 
-    // Invoke the declsReloading signal for all types
+    // The declsReloading signal is invoked as soon as a type is about to be changed,
+    // types without any changes are not notified at all
     {
         std::lock_guard declLock(_declarationAndCreatorLock);
-
-        for (const auto& [type, _] : _declarationsByType)
-        {
-            signal_DeclsReloading(type).emit();
-        }
+        _typesChangedByReparse.clear();
     }
 
     _parseStamp++;
@@ -227,25 +345,32 @@ void DeclarationManager::reloadDeclarations()
             {
                 if (decl->getParseStamp() < _parseStamp)
                 {
+                    auto syntax = decl->getBlockSyntax();
+
+                    // Declarations removed by a previous run have been cleared already
+                    if (syntax.contents.empty() && syntax.fileInfo.name.empty())
+                    {
+                        continue;
+                    }
+
+                    onTypeChangedByReparse(decl->getDeclType());
+
                     rMessage() << "[DeclManager] " << getTypeName(decl->getDeclType()) << " " <<
                         name << " no longer present after reloadDecls" << std::endl;
 
-                    auto syntax = decl->getBlockSyntax();
-
                     // Clear name and file info
                     syntax.contents.clear();
                     syntax.fileInfo = vfs::FileInfo();
 
                     decl->setBlockSyntax(syntax);
+                    invalidateNameSnapshot(decl->getDeclType());
                 }
             }
         }
 
-        // Invoke the declsReloaded signal for all types
-        for (const auto& [type, _] : _declarationsByType)
-        {
-            typesToNotify.push_back(type);
-        }
+        // Invoke the declsReloaded signal for all changed types
+        typesToNotify.assign(_typesChangedByReparse.begin(), _typesChangedByReparse.end());
+        _typesChangedByReparse.clear();
     }
 
     // Notify the clients with the lock released
@@ -363,7 +488,8 @@ void DeclarationManager::runParsersForAllFolders()
         for (const auto& folder : _registeredFolders)
         {
             auto& parser = parsers.emplace_back(
-                std::make_unique<DeclarationFolderParser>(*this, folder.defaultType, folder.folder, folder.extension, typeMapping)
+                std::make_unique<DeclarationFolderParser>(*this, folder.defaultType, folder.folder,
+                    folder.extension, typeMapping, folder.parsedFiles)
             );
             parser->start();
         }
@@ -377,11 +503,34 @@ void DeclarationManager::runParsersForAllFolders()
     }
 }
 
+bool DeclarationManager::isDeclarationFile(const std::string& vfsPath)
+{
+    auto path = os::standardPath(vfsPath);
+    auto extension = os::getExtension(path);
+
+    std::lock_guard folderLock(_registeredFoldersLock);
+
+    for (const auto& folder : _registeredFolders)
+    {
+        // The folder parsers don't descend into subdirectories
+        if (string::iequals(extension, folder.extension) && string::istarts_with(path, folder.folder) &&
+            path.find('/', folder.folder.length()) == std::string::npos)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
 void DeclarationManager::removeDeclaration(Type type, const std::string& name)
 {
     // All parsers need to have finished
     waitForTypedParsersToFinish();
 
+    // The file is going to be rewritten, the deferred saves have to be in there
+    waitForPendingSaves();
+
     // Acquire the lock and perform the removal
     doWithDeclarationLock(type, [&](NamedDeclarations& decls)
     {
@@ -400,6 +549,8 @@ void DeclarationManager::removeDeclaration(Type type, const std::string& name)
             decl->second->setBlockSyntax(syntax);
 
             decls.erase(decl);
+            invalidatePublishedDeclarations(type);
+            invalidateNameSnapshot(type);
 
             signal_DeclRemoved().emit(type, name);
         }
@@ -569,6 +720,8 @@ bool DeclarationManager::renameDeclaration(Type type, const std::string& oldName
 
         // Store the new in the decl itself
         decl->second->setDeclName(newName);
+        invalidatePublishedDeclarations(type);
+        invalidateNameSnapshot(type);
 
         result = true;
     });
@@ -619,6 +772,48 @@ void ensureTargetFileExists(const std::string& targetFile, const std::string& re
 }
 
 void DeclarationManager::saveDeclaration(const IDeclaration::Ptr& decl)
+{
+    bool fileWasQueued = false;
+    auto relativePath = queueDeclarationSave(decl, fileWasQueued);
+
+    // Write the file right away, along with any deferred saves queued for it
+    writePendingSaves(relativePath);
+
+    applyCompletedSaves();
+}
+
+void DeclarationManager::saveDeclarationDeferred(const IDeclaration::Ptr& decl)
+{
+    bool fileWasQueued = false;
+    auto relativePath = queueDeclarationSave(decl, fileWasQueued);
+
+    // Saves to a file which is already queued will be written along with the first one
+    if (!fileWasQueued) return;
+
+    _saveQueue.enqueue([this, relativePath]()
+    {
+        try
+        {
+            writePendingSaves(relativePath);
+        }
+        catch (const std::exception& ex)
+        {
+            rError() << "[DeclManager] Failed to save " << relativePath << ": " << ex.what() << std::endl;
+        }
+    });
+}
+
+void DeclarationManager::waitForPendingSaves()
+{
+    {
+        std::unique_lock lock(_pendingSaveLock);
+        _savesFinished.wait(lock, [this]() { return _pendingSavesByFile.empty() && _savesInProgress == 0; });
+    }
+
+    applyCompletedSaves();
+}
+
+std::string DeclarationManager::queueDeclarationSave(const IDeclaration::Ptr& decl, bool& fileWasQueued)
 {
     const auto& syntax = decl->getBlockSyntax();
 
@@ -631,15 +826,93 @@ void DeclarationManager::saveDeclaration(const IDeclaration::Ptr& decl)
     // All parsers need to have finished
     waitForTypedParsersToFinish();
 
-    std::string relativePath = syntax.fileInfo.fullPath();
+    // Bring the original names of the decls saved so far up to date
+    applyCompletedSaves();
+
+    auto relativePath = syntax.fileInfo.fullPath();
+
+    std::lock_guard lock(_pendingSaveLock);
+
+    auto [file, inserted] = _pendingSavesByFile.try_emplace(relativePath);
+    fileWasQueued = inserted;
+
+    auto existing = std::find_if(file->second.begin(), file->second.end(),
+        [&](const PendingSave& save) { return save.decl == decl; });
+
+    if (existing != file->second.end())
+    {
+        // Saved again before being written, replace the block, but keep the name it is stored under
+        existing->typeName = syntax.typeName;
+        existing->name = decl->getDeclName();
+        existing->contents = syntax.contents;
+    }
+    else
+    {
+        file->second.push_back(PendingSave{ decl, syntax.typeName, decl->getDeclName(),
+            decl->getOriginalDeclName(), syntax.contents });
+    }
+
+    return relativePath;
+}
+
+void DeclarationManager::writePendingSaves(const std::string& relativePath)
+{
+    // Writes to the decl files are not running in parallel
+    std::lock_guard writeLock(_fileWriteLock);
+
+    std::vector<PendingSave> saves;
 
+    {
+        std::lock_guard lock(_pendingSaveLock);
+
+        auto file = _pendingSavesByFile.find(relativePath);
+
+        if (file == _pendingSavesByFile.end()) return; // written by an earlier call
+
+        saves = std::move(file->second);
+        _pendingSavesByFile.erase(file);
+
+        ++_savesInProgress;
+    }
+
+    auto finishWrite = [&](bool succeeded)
+    {
+        std::lock_guard lock(_pendingSaveLock);
+
+        if (succeeded)
+        {
+            for (const auto& save : saves)
+            {
+                _completedSaves.push_back(CompletedSave{ save.decl, relativePath, save.name });
+            }
+        }
+
+        --_savesInProgress;
+        _savesFinished.notify_all();
+    };
+
+    try
+    {
+        writeDeclarationFile(relativePath, saves);
+    }
+    catch (...)
+    {
+        finishWrite(false);
+        throw;
+    }
+
+    finishWrite(true);
+}
+
+void DeclarationManager::writeDeclarationFile(const std::string& relativePath, const std::vector<PendingSave>& saves)
+{
     fs::path targetPath = game::current::getWriteableGameResourcePath();
 
     // Ensure the target folder exists
     targetPath /= os::getDirectory(relativePath);
     fs::create_directories(targetPath);
 
-    auto targetFile = targetPath / os::getFilename(syntax.fileInfo.name);
+    auto targetFile = targetPath / os::getFilename(relativePath);
 
     // Make sure the physical file exists and is inheriting its contents from the VFS (if necessary)
     ensureTargetFileExists(targetFile.string(), relativePath);
@@ -667,42 +940,71 @@ void DeclarationManager::saveDeclaration(const IDeclaration::Ptr& decl)
         syntaxTree = std::make_shared<parser::DefSyntaxTree>();
     }
 
-    // Take the first named block matching our decl. There's a risk that there is another
-    // decl of a different type with the same name in the tree, but we don't try to check this here
-    auto block = syntaxTree->findFirstNamedBlock(decl->getOriginalDeclName());
-
-    if (!block)
+    // All the decls saved to this file are merged into the same syntax tree
+    for (const auto& save : saves)
     {
-        // Create a new block node with leading whitespace and add it to the tree
-        syntaxTree->getRoot()->appendChildNode(parser::DefWhitespaceSyntax::Create("\n\n"));
+        // Take the first named block matching our decl. There's a risk that there is another
+        // decl of a different type with the same name in the tree, but we don't try to check this here
+        auto block = syntaxTree->findFirstNamedBlock(save.originalName);
 
-        block = parser::DefBlockSyntax::CreateTypedBlock(syntax.typeName, decl->getDeclName());
-        syntaxTree->getRoot()->appendChildNode(block);
-    }
+        // A renamed decl might have been saved again while its previous save was written
+        if (!block && save.name != save.originalName)
+        {
+            block = syntaxTree->findFirstNamedBlock(save.name);
+        }
 
-    // Check if the name of the decl has been changed
-    if (decl->getDeclName() != decl->getOriginalDeclName())
-    {
-        // Update the name syntax node
-        block->getName()->setName(decl->getDeclName());
-    }
+        if (!block)
+        {
+            // Create a new block node with leading whitespace and add it to the tree
+            syntaxTree->getRoot()->appendChildNode(parser::DefWhitespaceSyntax::Create("\n\n"));
+
+            block = parser::DefBlockSyntax::CreateTypedBlock(save.typeName, save.name);
+            syntaxTree->getRoot()->appendChildNode(block);
+        }
 
-    // Store the new block contents and save the file
-    block->setBlockContents(syntax.contents);
+        // Check if the name of the decl has been changed
+        if (save.name != save.originalName)
+        {
+            // Update the name syntax node
+            block->getName()->setName(save.name);
+        }
+
+        // Store the new block contents
+        block->setBlockContents(save.contents);
+    }
 
     // Export the modified syntax tree
     stream << syntaxTree->getString();
 
     tempStream.closeAndReplaceTargetFile();
+}
 
-    // Refresh the file info, otherwise a newly created file might not be considered "physical"
-    // and declarations might report themselves as if they were originating in a PK4
-    decl->setFileInfo(GlobalFileSystem().getFileInfo(relativePath));
+void DeclarationManager::applyCompletedSaves()
+{
+    std::vector<CompletedSave> completedSaves;
 
-    if (decl->getDeclName() != decl->getOriginalDeclName())
     {
+        std::lock_guard lock(_pendingSaveLock);
+        completedSaves.swap(_completedSaves);
+    }
+
+    for (const auto& save : completedSaves)
+    {
+        // Skip decls which have been assigned to a different file in the meantime
+        if (save.decl->getBlockSyntax().fileInfo.fullPath() != save.relativePath) continue;
+
+        // Refresh the file info, otherwise a newly created file might not be considered "physical"
+        // and declarations might report themselves as if they were originating in a PK4
+        save.decl->setFileInfo(GlobalFileSystem().getFileInfo(save.relativePath));
+
         // Now that the decl is saved under a new name, update the original decl name
-        decl->setOriginalDeclName(decl->getDeclName());
+        if (save.decl->getOriginalDeclName() != save.name)
+        {
+            save.decl->setOriginalDeclName(save.name);
+        }
+
+        std::lock_guard declLock(_declarationAndCreatorLock);
+        invalidateNameSnapshot(save.decl->getDeclType());
     }
 }
 
@@ -735,6 +1037,9 @@ sigc::signal<void(Type, const std::string&)>& DeclarationManager::signal_DeclRem
 
 void DeclarationManager::emitDeclsReloadedSignal(Type type)
 {
+    // The listeners are resolving the entity class, material and skin references
+    util::ScopedTraceEvent trace("decl", getTypeName(type) + " declarations reloaded");
+
     signal_DeclsReloaded(type).emit();
 }
 
@@ -793,6 +1098,8 @@ void DeclarationManager::onParserFinished(Type parserType, ParseResult& parsedBl
 
 void DeclarationManager::processParseResult(Type parserType, ParseResult& parsedBlocks)
 {
+    util::ScopedTraceEvent trace("decl", "Process parsed " + getTypeName(parserType) + " blocks");
+
     // Sort all parsed blocks into our main dictionary
     // unrecognised blocks will be pushed to _unrecognisedBlocks
     processParsedBlocks(parsedBlocks);
@@ -867,11 +1174,22 @@ const IDeclaration::Ptr& DeclarationManager::createOrUpdateDeclaration(Type type
     // See if this decl is already in use
     auto existing = map.find(block.name);
 
+    if (existing == map.end() || existing->second->getParseStamp() != _parseStamp)
+    {
+        // Even an unchanged block might have moved to a file of different visibility
+        it->second.nameSnapshot.reset();
+    }
+
     // Create declaration if not existing
     if (existing == map.end())
     {
+        onTypeChangedByReparse(type);
+
         auto creator = _creatorsByType.at(type);
         existing = map.emplace(block.name, creator->createDeclaration(block.name)).first;
+
+        // Existing declarations are updated in place, only new ones need to be published
+        invalidatePublishedDeclarations(type);
     }
     else if (existing->second->getParseStamp() == _parseStamp)
     {
@@ -881,6 +1199,19 @@ const IDeclaration::Ptr& DeclarationManager::createOrUpdateDeclaration(Type type
         // Any declaration following after the first is ignored
         return existing->second;
     }
+    else if (isSameSyntax(existing->second->getBlockSyntax(), block))
+    {
+        // Unchanged declarations keep their parsed state, the file might have been
+        // moved to a different archive though
+        existing->second->setFileInfo(block.fileInfo);
+        existing->second->setParseStamp(_parseStamp);
+
+        return existing->second;
+    }
+    else
+    {
+        onTypeChangedByReparse(type);
+    }
 
     // Assign the block to the declaration instance
     existing->second->setBlockSyntax(block);
@@ -891,6 +1222,15 @@ const IDeclaration::Ptr& DeclarationManager::createOrUpdateDeclaration(Type type
     return existing->second;
 }
 
+void DeclarationManager::onTypeChangedByReparse(Type type)
+{
+    // Notify the clients once per reparse, before the first declaration of this type is changed
+    if (_reparseInProgress && _typesChangedByReparse.insert(type).second)
+    {
+        signal_DeclsReloading(type).emit();
+    }
+}
+
 void DeclarationManager::handleUnrecognisedBlocks()
 {
     auto unrecognisedBlockLock = std::make_unique<std::lock_guard<std::recursive_mutex>>(_unrecognisedBlockLock);
@@ -954,12 +1294,43 @@ const std::string& DeclarationManager::getName() const
     return _name;
 }
 
+const std::string& DeclarationManager::getMemoryReporterName() const
+{
+    static std::string _name("DeclarationManager");
+    return _name;
+}
+
+void DeclarationManager::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    std::lock_guard declarationLock(_declarationAndCreatorLock);
+
+    for (const auto& [type, declarations] : _declarationsByType)
+    {
+        // The decls of this type are still being filled in by the parser
+        if (declarations.parser) continue;
+
+        std::size_t syntaxSize = 0;
+
+        for (const auto& [_, decl] : declarations.decls)
+        {
+            const auto& syntax = decl->getBlockSyntax();
+
+            syntaxSize += syntax.typeName.capacity() + syntax.name.capacity() +
+                syntax.contents.capacity() + syntax.modName.capacity();
+        }
+
+        report.addEntry(getTypeName(type) + " declarations", syntaxSize, declarations.decls.size());
+    }
+}
+
 const StringSet& DeclarationManager::getDependencies() const
 {
     static StringSet _dependencies
     {
         MODULE_VIRTUALFILESYSTEM,
         MODULE_COMMANDSYSTEM,
+        MODULE_MEMORYACCOUNTING,
+        MODULE_TASKSCHEDULER,
     };
 
     return _dependencies;
@@ -974,6 +1345,8 @@ void DeclarationManager::initialiseModule(const IApplicationContext& ctx)
     _parseStamp = 0;
     _reparseInProgress = false;
 
+    _declarationCache = std::make_unique<DeclarationCache>(ctx.getCacheDataPath() + "decl_syntax.cache");
+
     _vfsInitialisedConn = GlobalFileSystem().signal_Initialised().connect(
         sigc::mem_fun(*this, &DeclarationManager::onFilesystemInitialised)
     );
@@ -985,20 +1358,29 @@ void DeclarationManager::initialiseModule(const IApplicationContext& ctx)
         waitForTypedParsersToFinish();
         waitForSignalInvokersToFinish();
     });
+
+    GlobalMemoryAccounting().registerReporter(*this);
 }
 
 void DeclarationManager::shutdownModule()
 {
+    GlobalMemoryAccounting().unregisterReporter(*this);
+
     _vfsInitialisedConn.disconnect();
 
     waitForTypedParsersToFinish();
     waitForSignalInvokersToFinish();
+    waitForPendingSaves();
 
     // All parsers and tasks have finished, clear all structures, no need to lock anything
+    _declarationCache->save();
+    _declarationCache.reset();
+
     _parserCleanupTasks.clear();
     _registeredFolders.clear();
     _unrecognisedBlocks.clear();
     _declarationsByType.clear();
+    invalidateAllPublishedDeclarations();
     _creatorsByTypename.clear();
     _declsReloadingSignals.clear();
     _declsReloadedSignals.clear();
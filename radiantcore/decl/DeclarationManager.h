@@ -2,14 +2,20 @@
 
 #include "ideclmanager.h"
 #include "icommandsystem.h"
+#include "imemoryaccounting.h"
+#include <array>
 #include <map>
+#include <set>
 #include <vector>
 #include <memory>
+#include <condition_variable>
 #include <sigc++/connection.h>
 #include "string/string.h"
+#include "SequentialTaskQueue.h"
 
 #include "DeclarationFile.h"
 #include "DeclarationFolderParser.h"
+#include "DeclarationCache.h"
 
 namespace decl
 {
@@ -17,7 +23,8 @@ namespace decl
 class DeclarationFolderParser;
 
 class DeclarationManager :
-    public IDeclarationManager
+    public IDeclarationManager,
+    public memory::IMemoryReporter
 {
 private:
     // Declaration names are compared case-insensitively
@@ -33,6 +40,9 @@ private:
         std::string folder;
         std::string extension;
         Type defaultType;
+
+        // The files parsed so far, shared with the parsers of this folder
+        std::shared_ptr<ParsedFileCache> parsedFiles;
     };
 
     std::vector<RegisteredFolder> _registeredFolders;
@@ -48,11 +58,21 @@ private:
 
         std::future<void> parserFinisher;
         std::future<void> signalInvoker;
+
+        // Built on demand, reset whenever the decls change
+        DeclarationNameSnapshot::Ptr nameSnapshot;
     };
 
     // One entry for each decl
     std::map<Type, Declarations> _declarationsByType;
 
+    // Immutable copies of the declarations of each type, published for the lookups
+    // to run without acquiring the _declarationAndCreatorLock. A copy is rebuilt
+    // on demand after declarations have been added, renamed or removed.
+    // Indexed by type, access through std::atomic_load/store.
+    using PublishedDeclarations = std::shared_ptr<const NamedDeclarations>;
+    std::array<PublishedDeclarations, static_cast<std::size_t>(Type::TestDecl2) + 1> _publishedDeclarations;
+
     std::list<DeclarationBlockSyntax> _unrecognisedBlocks;
     std::recursive_mutex _unrecognisedBlockLock;
 
@@ -65,17 +85,58 @@ private:
     sigc::signal<void(Type, const std::string&)> _declRemovedSignal;
 
     std::size_t _parseStamp = 0;
+
+    // The version assigned to the most recently built name snapshot
+    std::size_t _nameSnapshotVersion = 0;
     bool _reparseInProgress = false;
 
+    // The types which have been modified by the running reparse, access requires the _declarationAndCreatorLock
+    std::set<Type> _typesChangedByReparse;
+
     // Holds the results during reparseDeclarations
     std::vector<std::pair<Type, ParseResult>> _parseResults;
     std::mutex _parseResultLock;
 
     sigc::connection _vfsInitialisedConn;
 
+    // The parsed files of the previous session, access requires the _registeredFoldersLock
+    std::unique_ptr<DeclarationCache> _declarationCache;
+
     // Access allowed if the _declarationAndCreatorLock is owned
     std::vector<std::shared_ptr<std::shared_future<void>>> _parserCleanupTasks;
 
+    // A declaration block waiting to be written to its file
+    struct PendingSave
+    {
+        IDeclaration::Ptr decl;
+        std::string typeName;
+        std::string name;
+        std::string originalName; // the name the block is stored under in the file
+        std::string contents;
+    };
+
+    // A written declaration, its file info and original name are updated on the main thread
+    struct CompletedSave
+    {
+        IDeclaration::Ptr decl;
+        std::string relativePath;
+        std::string name;
+    };
+
+    // The saves waiting to be written, by target file (mod-relative path),
+    // access to these members requires the _pendingSaveLock
+    std::map<std::string, std::vector<PendingSave>> _pendingSavesByFile;
+    std::vector<CompletedSave> _completedSaves;
+    std::size_t _savesInProgress = 0;
+    std::mutex _pendingSaveLock;
+    std::condition_variable _savesFinished;
+
+    // Held while a declaration file is written
+    std::mutex _fileWriteLock;
+
+    // Writes the deferred saves, one file after the other
+    util::SequentialTaskQueue _saveQueue;
+
 public:
     void registerDeclType(const std::string& typeName, const IDeclarationCreator::Ptr& parser) override;
     void unregisterDeclType(const std::string& typeName) override;
@@ -83,21 +144,29 @@ public:
     IDeclaration::Ptr findDeclaration(Type type, const std::string& name) override;
     IDeclaration::Ptr findOrCreateDeclaration(Type type, const std::string& name) override;
     void foreachDeclaration(Type type, const std::function<void(const IDeclaration::Ptr&)>& functor) override;
+    DeclarationNameSnapshot::Ptr getNameSnapshot(Type type) override;
     sigc::signal<void>& signal_DeclsReloading(Type type) override;
     sigc::signal<void>& signal_DeclsReloaded(Type type) override;
     sigc::signal<void(Type, const std::string&, const std::string&)>& signal_DeclRenamed() override;
     sigc::signal<void(Type, const std::string&)>& signal_DeclCreated() override;
     sigc::signal<void(Type, const std::string&)>& signal_DeclRemoved() override;
     void reloadDeclarations() override;
+    bool isDeclarationFile(const std::string& vfsPath) override;
     bool renameDeclaration(Type type, const std::string& oldName, const std::string& newName) override;
     void removeDeclaration(Type type, const std::string& name) override;
     void saveDeclaration(const IDeclaration::Ptr& decl) override;
+    void saveDeclarationDeferred(const IDeclaration::Ptr& decl) override;
+    void waitForPendingSaves() override;
 
     const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext& ctx) override;
     void shutdownModule() override;
 
+    // IMemoryReporter implementation
+    const std::string& getMemoryReporterName() const override;
+    void reportMemoryUsage(memory::IMemoryReport& report) override;
+
     // Invoked once a parser thread has finished
     void onParserFinished(Type parserType, ParseResult& parsedBlocks);
 
@@ -115,8 +184,31 @@ private:
     void processParsedBlocks(ParseResult& parsedBlocks);
     void removeDeclarationFromFile(const IDeclaration::Ptr& decl);
 
+    // Adds the decl to the saves pending for its file, returns the file's mod-relative path.
+    // fileWasQueued is set to true if there haven't been any other saves pending for this file.
+    std::string queueDeclarationSave(const IDeclaration::Ptr& decl, bool& fileWasQueued);
+
+    // Writes the saves pending for the given file (if any), throws on failure
+    void writePendingSaves(const std::string& relativePath);
+    void writeDeclarationFile(const std::string& relativePath, const std::vector<PendingSave>& saves);
+
+    // Updates the file info and the original names of the decls written so far
+    void applyCompletedSaves();
+
     // Requires the creatorsMutex and the declarationMutex to be locked
     const IDeclaration::Ptr& createOrUpdateDeclaration(Type type, const DeclarationBlockSyntax& block);
+    void onTypeChangedByReparse(Type type);
+
+    // Returns the published declarations of the given type, the first call after
+    // a change is waiting for the parsers and builds a new copy
+    PublishedDeclarations getPublishedDeclarations(Type type);
+
+    // Requires the declarationMutex to be locked
+    void invalidatePublishedDeclarations(Type type);
+    void invalidateAllPublishedDeclarations();
+
+    // Requires the declarationMutex to be locked
+    void invalidateNameSnapshot(Type type);
     void doWithDeclarationLock(Type type, const std::function<void(NamedDeclarations&)>& action);
     void handleUnrecognisedBlocks();
     void reloadDeclsCmd(const cmd::ArgumentList& args);
@@ -8,6 +8,14 @@ namespace eclass
 
 void EClassColourManager::addOverrideColour(const std::string& eclass, const Vector4& colour)
 {
+    auto existing = _overrides.find(eclass);
+
+    // Re-applying the same override doesn't need to touch the entity class
+    if (existing != _overrides.end() && existing->second == colour)
+    {
+        return;
+    }
+
     _overrides[eclass] = colour;
     _overrideChangedSignal.emit(eclass, false); // false ==> colour added
 }
@@ -40,7 +48,7 @@ void EClassColourManager::removeOverrideColour(const std::string& eclass)
 
 void EClassColourManager::clearOverrideColours()
 {
-    for (auto i = _overrides.begin(); i != _overrides.end(); ++i)
+    for (auto i = _overrides.begin(); i != _overrides.end();)
     {
         // Copy the eclass name to a local
         auto eclass = i->first;
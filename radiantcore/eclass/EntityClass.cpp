@@ -5,6 +5,8 @@
 #include "string/convert.h"
 
 #include "string/predicate.h"
+#include <algorithm>
+#include <atomic>
 #include <functional>
 #include <utility>
 
@@ -15,6 +17,10 @@ namespace
 {
     const Vector3 DefaultEntityColour(0.3, 0.3, 1);
     const Vector4 UndefinedColour(-1, -1, -1, -1);
+
+    // Incremented whenever an entity class referenced by a flattened attribute map
+    // is changed, which outdates all the flattened maps at once
+    std::atomic<std::size_t> AttributeRevision(1);
 }
 
 EntityClass::EntityClass(const std::string& name)
@@ -29,6 +35,7 @@ EntityClass::EntityClass(const std::string& name)
 EntityClass::~EntityClass()
 {
     _parentChangedConnection.disconnect();
+    _parentColourChangedConnection.disconnect();
 }
 
 IEntityClass* EntityClass::getParent()
@@ -60,6 +67,11 @@ sigc::signal<void>& EntityClass::changedSignal()
     return _changedSignal;
 }
 
+sigc::signal<void>& EntityClass::colourChangedSignal()
+{
+    return _colourChangedSignal;
+}
+
 void EntityClass::onSyntaxBlockAssigned(const decl::DeclarationBlockSyntax& block)
 {
     DeclarationBase<IEntityClass>::onSyntaxBlockAssigned(block);
@@ -154,9 +166,10 @@ void EntityClass::setColour(const Vector4& colour)
         _colour = DefaultEntityColour;
     }
 
-    // Emit the signal if the colour actually changed
+    // Emit the signal if the colour actually changed. Only the colour signal
+    // is fired, the entities don't need to re-evaluate their spawnargs.
     if (origColour != _colour)
-        emitChangedSignal();
+        emitColourChangedSignal();
 }
 
 void EntityClass::resetColour()
@@ -205,7 +218,12 @@ void EntityClass::emplaceAttribute(EntityClassAttribute&& attribute)
     // Try to emplace the class attribute
     auto result = _attributes.try_emplace(attribute.getName(), std::move(attribute));
 
-    if (!result.second)
+    if (result.second)
+    {
+        // A new attribute might hide an inherited one
+        invalidateFlattenedAttributes();
+    }
+    else
     {
         auto& existing = result.first->second;
 
@@ -224,49 +242,74 @@ void EntityClass::emplaceAttribute(EntityClassAttribute&& attribute)
     }
 }
 
-void EntityClass::forEachAttributeInternal(InternalAttrVisitor visitor,
-                                           bool editorKeys) const
+void EntityClass::invalidateFlattenedAttributes()
 {
-    // Visit parent attributes, making sure we set the inherited flag
-    if (_parent)
-        _parent->forEachAttributeInternal(visitor, editorKeys);
+    // Only the classes which have been flattened before can outdate a map
+    if (_attributesReferenced)
+    {
+        _attributesReferenced = false;
+        ++AttributeRevision;
+    }
+}
+
+void EntityClass::ensureAttributesFlattened()
+{
+    ensureParsed();
+
+    auto revision = AttributeRevision.load();
 
-    // Visit our own attributes
-    for (const auto& pair: _attributes)
+    if (_flattenedRevision == revision)
     {
-        // Visit if it is a non-editor key or we are visiting all keys
-        if (editorKeys || !string::istarts_with(pair.first, "editor_"))
+        return;
+    }
+
+    _flattenedAttributes.clear();
+
+    // Walk up the chain, the most derived attributes are inserted first and are not replaced
+    for (auto* cls = this; cls != nullptr; cls = cls->_parent)
+    {
+        cls->ensureParsed();
+        cls->_attributesReferenced = true;
+
+        for (auto& [name, attribute] : cls->_attributes)
         {
-            visitor(pair.second);
+            _flattenedAttributes.try_emplace(name, FlattenedAttribute{ &attribute, cls != this });
         }
     }
+
+    _sortedAttributes.clear();
+    _sortedAttributes.reserve(_flattenedAttributes.size());
+
+    for (const auto& pair : _flattenedAttributes)
+    {
+        _sortedAttributes.push_back(pair.second);
+    }
+
+    std::sort(_sortedAttributes.begin(), _sortedAttributes.end(), [](const FlattenedAttribute& a, const FlattenedAttribute& b)
+    {
+        return a.attribute->getName() < b.attribute->getName();
+    });
+
+    // Any change during the build will cause a rebuild on the next call
+    _flattenedRevision = revision;
 }
 
 void EntityClass::forEachAttribute(AttributeVisitor visitor,
                                    bool editorKeys)
 {
-    ensureParsed();
+    ensureAttributesFlattened();
 
-    // First compile a map of all attributes we need to pass to the visitor,
-    // ensuring that there is only one attribute per name (i.e. we don't want to
-    // visit the same-named attribute on both a child and one of its ancestors)
-    using AttrsByName = std::map<std::string, const EntityClassAttribute*>;
-    AttrsByName attrsByName;
-
-    // Internal visit function visits parent first, then child, ensuring that
-    // more derived attributes will replace parents in the map
-    forEachAttributeInternal(
-        [&attrsByName](const EntityClassAttribute& a) {
-            attrsByName[a.getName()] = &a;
-        },
-        editorKeys
-    );
-
-    // Pass attributes to the visitor function, setting the inherited flag on
-    // any which are not present on this EntityClass
-    for (const auto& pair: attrsByName)
+    // The sorted list contains only one attribute per name, the most derived one.
+    // Iterate over a copy, the visitor might cause the list to be rebuilt.
+    auto attributes = _sortedAttributes;
+
+    for (const auto& entry : attributes)
     {
-        visitor(*pair.second, (_attributes.count(pair.first) == 0));
+        // Visit if it is a non-editor key or we are visiting all keys
+        if (editorKeys || !string::istarts_with(entry.attribute->getName(), "editor_"))
+        {
+            visitor(*entry.attribute, entry.inherited);
+        }
     }
 }
 
@@ -293,6 +336,7 @@ void EntityClass::resolveInheritance()
     if (parentClass)
     {
         // Set our parent pointer
+        invalidateFlattenedAttributes();
         _parent = static_cast<EntityClass*>(parentClass.get());
     }
     else
@@ -332,6 +376,10 @@ void EntityClass::resolveInheritance()
         _parentChangedConnection = _parent->changedSignal().connect(
             sigc::mem_fun(this, &EntityClass::resetColour)
         );
+        _parentColourChangedConnection.disconnect();
+        _parentColourChangedConnection = _parent->colourChangedSignal().connect(
+            sigc::mem_fun(this, &EntityClass::resetColour)
+        );
     }
 }
 
@@ -355,21 +403,19 @@ bool EntityClass::isOfType(const std::string& className)
 // Find a single attribute
 EntityClassAttribute* EntityClass::getAttribute(const std::string& name, bool includeInherited)
 {
-    ensureParsed();
+    if (!includeInherited)
+    {
+        ensureParsed();
 
-    // First look up the attribute on this class; if found, we can simply return it
-    auto f = _attributes.find(name);
-    if (f != _attributes.end())
-        return &f->second;
+        auto f = _attributes.find(name);
+        return f != _attributes.end() ? &f->second : nullptr;
+    }
 
-    // If there is no parent or we have been instructed to ignore inheritance,
-    // this is the end of the line: return nothing
-    if (!_parent || !includeInherited)
-        return nullptr;
+    // The flattened map resolves the inheritance chain in a single lookup
+    ensureAttributesFlattened();
 
-    // Otherwise delegate to the parent (which will recurse until an attribute
-    // is found or a null parent ends the process)
-    return _parent->getAttribute(name);
+    auto f = _flattenedAttributes.find(name);
+    return f != _flattenedAttributes.end() ? f->second.attribute : nullptr;
 }
 
 std::string EntityClass::getAttributeValue(const std::string& name, bool includeInherited)
@@ -433,8 +479,13 @@ void EntityClass::clear()
 
     _fixedSize = false;
 
+    invalidateFlattenedAttributes();
     _attributes.clear();
     _inheritanceResolved = false;
+
+    _flattenedAttributes.clear();
+    _sortedAttributes.clear();
+    _flattenedRevision = 0;
 }
 
 void EntityClass::parseEditorSpawnarg(const std::string& key, const std::string& value)
@@ -16,6 +16,8 @@
 #include <map>
 #include <memory>
 #include <optional>
+#include <string_view>
+#include <unordered_map>
 
 #include <sigc++/connection.h>
 
@@ -62,10 +64,33 @@ private:
     // after recursively instructing the parent to resolve its own inheritance.
     bool _inheritanceResolved = false;
 
+    // Flattened view on the attributes of this class and all its ancestors,
+    // pointing to the most derived attribute of each name. The keys refer to the
+    // names stored in the attribute maps above, so no strings are copied.
+    // Built on demand and discarded when any of the referenced classes changes.
+    struct FlattenedAttribute
+    {
+        EntityClassAttribute* attribute;
+        bool inherited;
+    };
+    using FlattenedAttributeMap = std::unordered_map<std::string_view, FlattenedAttribute, string::IHash, string::IEqual>;
+    FlattenedAttributeMap _flattenedAttributes;
+
+    // The attributes of the flattened map, sorted by name
+    std::vector<FlattenedAttribute> _sortedAttributes;
+
+    // The attribute revision the flattened map has been built for, 0 if not built yet
+    std::size_t _flattenedRevision = 0;
+
+    // True if the attributes of this class are referenced by any flattened map
+    bool _attributesReferenced = false;
+
     // Emitted when contents are reloaded
     sigc::signal<void> _changedSignal;
+    sigc::signal<void> _colourChangedSignal;
     bool _blockChangeSignal = false;
     sigc::connection _parentChangedConnection;
+    sigc::connection _parentColourChangedConnection;
 
 private:
     // Resolve inheritance for this class.
@@ -77,14 +102,15 @@ private:
     void parseEditorSpawnarg(const std::string& key, const std::string& value);
     void setIsLight(bool val);
 
-    // Visit attributes recursively, parent first then child
-    using InternalAttrVisitor = std::function<void(const EntityClassAttribute&)>;
-    void forEachAttributeInternal(InternalAttrVisitor visitor,
-                                  bool editorKeys) const;
-
     // Return attribute if found, possibly checking parents
     EntityClassAttribute* getAttribute(const std::string&, bool includeInherited = true);
 
+    // Builds the flattened attribute map if it is missing or outdated
+    void ensureAttributesFlattened();
+
+    // To be called before the attributes or the parent of this class are changed
+    void invalidateFlattenedAttributes();
+
 public:
 
     /// Construct a named EntityClass
@@ -103,6 +129,7 @@ public:
     IEntityClass* getParent() override;
     vfs::Visibility getVisibility() override;
     sigc::signal<void>& changedSignal() override;
+    sigc::signal<void>& colourChangedSignal() override;
     bool isFixedSize() override;
     AABB getBounds() override;
     bool isLight() override;
@@ -126,6 +153,14 @@ public:
         }
     }
 
+    void emitColourChangedSignal()
+    {
+        if (!_blockChangeSignal)
+        {
+            _colourChangedSignal.emit();
+        }
+    }
+
     void blockChangedSignal(bool block)
     {
         _blockChangeSignal = block;
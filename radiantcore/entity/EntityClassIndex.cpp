@@ -0,0 +1,62 @@
+#include "EntityClassIndex.h"
+
+#include "string/case_conv.h"
+
+namespace entity
+{
+
+EntityClassIndex::EntityClassIndex() :
+    _nextSerial(0)
+{}
+
+void EntityClassIndex::foreachEntityOfClass(const std::string& className,
+    const std::function<void(const IEntityNodePtr&)>& functor)
+{
+    auto found = _entitiesByClass.find(string::to_lower_copy(className));
+
+    if (found == _entitiesByClass.end()) return;
+
+    for (const auto& [_, entity] : found->second)
+    {
+        functor(std::dynamic_pointer_cast<IEntityNode>(entity->getSelf()));
+    }
+}
+
+std::size_t EntityClassIndex::getNumEntitiesOfClass(const std::string& className)
+{
+    auto found = _entitiesByClass.find(string::to_lower_copy(className));
+
+    return found != _entitiesByClass.end() ? found->second.size() : 0;
+}
+
+void EntityClassIndex::addEntity(const std::string& className, IEntityNode& entity)
+{
+    removeEntity(entity);
+
+    auto serial = _nextSerial++;
+    auto lowerClassName = string::to_lower_copy(className);
+
+    _entitiesByClass[lowerClassName].emplace(serial, &entity);
+    _entries.emplace(&entity, Entry{ std::move(lowerClassName), serial });
+}
+
+void EntityClassIndex::removeEntity(IEntityNode& entity)
+{
+    auto entry = _entries.find(&entity);
+
+    if (entry == _entries.end()) return;
+
+    auto classEntities = _entitiesByClass.find(entry->second.className);
+    assert(classEntities != _entitiesByClass.end());
+
+    classEntities->second.erase(entry->second.serial);
+
+    if (classEntities->second.empty())
+    {
+        _entitiesByClass.erase(classEntities);
+    }
+
+    _entries.erase(entry);
+}
+
+} // namespace entity
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <string>
+#include "ientity.h"
+
+namespace entity
+{
+
+/**
+ * Index of all entities in a map, sorted by their (lowercase) class name.
+ * An instance is owned by each map's root node.
+ */
+class EntityClassIndex :
+    public IEntityClassIndex
+{
+private:
+    // The entities of each class, keyed by a serial number to preserve the insertion order
+    using ClassEntities = std::map<std::size_t, IEntityNode*>;
+    std::unordered_map<std::string, ClassEntities> _entitiesByClass;
+
+    struct Entry
+    {
+        std::string className;
+        std::size_t serial;
+    };
+    std::unordered_map<const IEntityNode*, Entry> _entries;
+
+    std::size_t _nextSerial;
+
+public:
+    EntityClassIndex();
+
+    void foreachEntityOfClass(const std::string& className,
+        const std::function<void(const IEntityNodePtr&)>& functor) override;
+
+    std::size_t getNumEntitiesOfClass(const std::string& className) override;
+
+    void addEntity(const std::string& className, IEntityNode& entity) override;
+    void removeEntity(IEntityNode& entity) override;
+};
+
+} // namespace entity
@@ -0,0 +1,58 @@
+#include "EntityClassShaders.h"
+
+#include <unordered_map>
+
+namespace entity
+{
+
+namespace
+{
+    struct CachedShaders
+    {
+        RenderSystemWeakPtr renderSystem;
+        Vector4 colour;
+
+        // The render system owns the shaders, don't keep them alive
+        std::weak_ptr<Shader> fill;
+        std::weak_ptr<Shader> wire;
+        std::weak_ptr<Shader> colourShader;
+    };
+
+    // Entries are validated by comparing the colour and the render system,
+    // a class reusing the address of a destroyed one can't get wrong shaders
+    std::unordered_map<const IEntityClass*, CachedShaders> _cachedShaders;
+}
+
+EntityClassShaders EntityClassShaders::Get(const RenderSystemPtr& renderSystem, IEntityClass& eclass)
+{
+    const auto& colour = eclass.getColour();
+    auto& cached = _cachedShaders[&eclass];
+
+    EntityClassShaders shaders;
+
+    if (cached.renderSystem.lock() == renderSystem && cached.colour == colour)
+    {
+        shaders.fill = cached.fill.lock();
+        shaders.wire = cached.wire.lock();
+        shaders.colour = cached.colourShader.lock();
+
+        if (shaders.fill && shaders.wire && shaders.colour)
+        {
+            return shaders;
+        }
+    }
+
+    shaders.fill = renderSystem->capture(ColourShaderType::CameraSolid, colour);
+    shaders.wire = renderSystem->capture(ColourShaderType::OrthoviewSolid, colour);
+    shaders.colour = renderSystem->capture(ColourShaderType::CameraAndOrthoview, colour);
+
+    cached.renderSystem = renderSystem;
+    cached.colour = colour;
+    cached.fill = shaders.fill;
+    cached.wire = shaders.wire;
+    cached.colourShader = shaders.colour;
+
+    return shaders;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "ieclass.h"
+#include "irender.h"
+
+namespace entity
+{
+
+/**
+ * Shares the shaders representing the colour of an entity class between all
+ * entities of that class. The first entity asking for them captures the
+ * shaders, the other ones receive the cached references until the colour of
+ * the class changes or the render system releases the shaders.
+ *
+ * Only to be used from the main thread.
+ */
+class EntityClassShaders final
+{
+public:
+    ShaderPtr fill;     // cam only
+    ShaderPtr wire;     // ortho only
+    ShaderPtr colour;   // cam+ortho view
+
+    // Returns the shaders for the current colour of the given entity class
+    static EntityClassShaders Get(const RenderSystemPtr& renderSystem, IEntityClass& eclass);
+};
+
+}
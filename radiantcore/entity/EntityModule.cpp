@@ -20,6 +20,7 @@
 #include "generic/GenericEntityNode.h"
 #include "eclassmodel/EclassModelNode.h"
 #include "target/TargetManager.h"
+#include "EntityClassIndex.h"
 #include "module/StaticModule.h"
 #include "EntitySettings.h"
 #include "selection/algorithm/General.h"
@@ -252,6 +253,11 @@ ITargetManagerPtr Doom3EntityModule::createTargetManager()
     return std::make_shared<TargetManager>();
 }
 
+IEntityClassIndexPtr Doom3EntityModule::createEntityClassIndex()
+{
+    return std::make_shared<EntityClassIndex>();
+}
+
 IEntitySettings& Doom3EntityModule::getSettings()
 {
 	return *EntitySettings::InstancePtr();
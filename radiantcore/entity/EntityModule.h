@@ -18,6 +18,7 @@ public:
     // EntityCreator implementation
 	IEntityNodePtr createEntity(const IEntityClassPtr& eclass) override;
     ITargetManagerPtr createTargetManager() override;
+    IEntityClassIndexPtr createEntityClassIndex() override;
 	IEntitySettings& getSettings() override;
 
 	/**
@@ -10,6 +10,7 @@
 #include "string/case_conv.h"
 
 #include "EntitySettings.h"
+#include "EntityClassShaders.h"
 
 namespace entity
 {
@@ -26,9 +27,11 @@ EntityNode::EntityNode(const IEntityClassPtr& eclass) :
 	_modelKey(*this),
 	_keyObservers(_spawnArgs),
 	_shaderParms(_keyObservers, _colourKey),
+	_filterKeyObserver(*this),
 	_direction(1,0,0),
     _isAttachedToRenderSystem(false),
-    _isShadowCasting(false)
+    _isShadowCasting(false),
+    _entityClassIndex(nullptr)
 {
 }
 
@@ -50,9 +53,11 @@ EntityNode::EntityNode(const EntityNode& other) :
 	_modelKey(*this),
 	_keyObservers(_spawnArgs),
 	_shaderParms(_keyObservers, _colourKey),
+	_filterKeyObserver(*this),
 	_direction(1,0,0),
     _isAttachedToRenderSystem(false),
-    _isShadowCasting(false)
+    _isShadowCasting(false),
+    _entityClassIndex(nullptr)
 {
 }
 
@@ -67,6 +72,10 @@ void EntityNode::construct()
 	{
 		this->onEntityClassChanged();
 	});
+	_eclassColourChangedConn = _eclass->colourChangedSignal().connect([this]()
+	{
+		this->onEntityClassColourChanged();
+	});
 
 	TargetableNode::construct();
 
@@ -85,9 +94,12 @@ void EntityNode::construct()
 	observeKey("skin", sigc::mem_fun(_modelKey, &ModelKey::skinChanged));
 
     observeKey("noshadows", sigc::mem_fun(this, &EntityNode::_onNoShadowsSettingsChanged));
+    observeKey("classname", sigc::mem_fun(this, &EntityNode::_onClassnameChanged));
 
 	_shaderParms.addKeyObservers();
 
+	_filterKeyObserver.attach(_spawnArgs);
+
     // Construct all attached entities
     createAttachedEntities();
 }
@@ -128,6 +140,9 @@ void EntityNode::destruct()
     _attachedEnts.clear();
 
 	_eclassChangedConn.disconnect();
+	_eclassColourChangedConn.disconnect();
+
+	_filterKeyObserver.detach(_spawnArgs);
 
 	TargetableNode::destruct();
 }
@@ -186,6 +201,18 @@ void EntityNode::onEntityClassChanged()
 
     // The colour might have changed too, so re-acquire the shaders if possible
     acquireShaders();
+
+    // The entity class might be treated differently by the filters
+    _filterKeyObserver.queueUpdate();
+}
+
+void EntityNode::onEntityClassColourChanged()
+{
+    // The spawnargs are unaffected, re-acquire the shaders and let the
+    // target lines pick up the new colour
+    acquireShaders();
+
+    TargetableNode::onRenderSystemChanged();
 }
 
 void EntityNode::observeKey(const std::string& key, KeyObserverFunc func)
@@ -247,6 +274,16 @@ void EntityNode::foreachRenderableTouchingBounds(const AABB& bounds,
     _renderObjects.foreachRenderableTouchingBounds(bounds, functor);
 }
 
+std::size_t EntityNode::getRenderableChangeCount() const
+{
+    return _renderObjects.getChangeCount();
+}
+
+AABB EntityNode::getRenderableBounds()
+{
+    return _renderObjects.getBounds();
+}
+
 bool EntityNode::isShadowCasting() const
 {
     return _isShadowCasting;
@@ -355,10 +392,24 @@ void EntityNode::onInsertIntoScene(scene::IMapRootNode& root)
 
 	SelectableNode::onInsertIntoScene(root);
     TargetableNode::onInsertIntoScene(root);
+
+    // Attached entities are not part of the scene graph and don't have a parent,
+    // they're kept out of the index like they are kept out of any scene traversal
+    if (getParent())
+    {
+        _entityClassIndex = &root.getEntityClassIndex();
+        _entityClassIndex->addEntity(_spawnArgs.getKeyValue("classname"), *this);
+    }
 }
 
 void EntityNode::onRemoveFromScene(scene::IMapRootNode& root)
 {
+    if (_entityClassIndex)
+    {
+        _entityClassIndex->removeEntity(*this);
+        _entityClassIndex = nullptr;
+    }
+
     TargetableNode::onRemoveFromScene(root);
 	SelectableNode::onRemoveFromScene(root);
 
@@ -446,10 +497,11 @@ void EntityNode::acquireShaders(const RenderSystemPtr& renderSystem)
 {
     if (renderSystem)
     {
-        const auto& colour = _spawnArgs.getEntityClass()->getColour();
-        _fillShader = renderSystem->capture(ColourShaderType::CameraSolid, colour);
-        _wireShader = renderSystem->capture(ColourShaderType::OrthoviewSolid, colour);
-        _colourShader = renderSystem->capture(ColourShaderType::CameraAndOrthoview, colour);
+        // The colour shaders are shared by all entities of this class
+        auto shaders = EntityClassShaders::Get(renderSystem, *_spawnArgs.getEntityClass());
+        _fillShader = std::move(shaders.fill);
+        _wireShader = std::move(shaders.wire);
+        _colourShader = std::move(shaders.colour);
         _textRenderer = renderSystem->captureTextRenderer(IGLFont::Style::Sans, 14);
         _inactiveShader = renderSystem->capture(BuiltInShaderType::WireframeInactive);
     }
@@ -550,6 +602,14 @@ void EntityNode::_onNoShadowsSettingsChanged(const std::string& noShadowsValue)
     _isShadowCasting = noShadowsValue != "1";
 }
 
+void EntityNode::_onClassnameChanged(const std::string& value)
+{
+    if (_entityClassIndex)
+    {
+        _entityClassIndex->addEntity(value, *this);
+    }
+}
+
 const ShaderPtr& EntityNode::getWireShader() const
 {
 	return _wireShader;
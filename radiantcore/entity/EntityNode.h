@@ -16,6 +16,7 @@
 #include "ModelKey.h"
 #include "ShaderParms.h"
 #include "OriginKey.h"
+#include "FilterKeyObserver.h"
 
 #include "KeyObserverMap.h"
 #include "RenderableEntityName.h"
@@ -80,6 +81,9 @@ protected:
 	// Helper class observing the "shaderParmNN" spawnargs and caching their values
 	ShaderParms _shaderParms;
 
+	// Queues filter updates when any spawnarg changes
+	FilterKeyObserver _filterKeyObserver;
+
 	// This entity's main direction, usually determined by the angle/rotation keys
 	Vector3 _direction;
 
@@ -92,6 +96,7 @@ protected:
 	ITextRenderer::Ptr _textRenderer; // for name rendering
 
 	sigc::connection _eclassChangedConn;
+	sigc::connection _eclassColourChangedConn;
 
     // List of attached sub-entities that we will submit for rendering (but are
     // otherwise non-interactable).
@@ -116,6 +121,9 @@ protected:
 
     bool _isShadowCasting;
 
+    // The entity class index of the map this entity has been inserted into
+    IEntityClassIndex* _entityClassIndex;
+
 protected:
 	// The Constructor needs the eclass
 	EntityNode(const IEntityClassPtr& eclass);
@@ -141,6 +149,8 @@ public:
     virtual void foreachRenderable(const ObjectVisitFunction& functor) override;
     virtual void foreachRenderableTouchingBounds(const AABB& bounds,
         const ObjectVisitFunction& functor) override;
+    virtual std::size_t getRenderableChangeCount() const override;
+    virtual AABB getRenderableBounds() override;
     virtual bool isShadowCasting() const override;
 
     // IMatrixTransform implementation
@@ -235,6 +245,11 @@ protected:
 	// reload the entity key values and notify observers
 	virtual void onEntityClassChanged();
 
+    // Invoked when only the colour of the entity class has changed. Subclasses
+    // need to update the renderables using the entity colour, the base method
+    // re-acquires the colour shaders.
+    virtual void onEntityClassColourChanged();
+
 private:
 	// Routine used by the destructor, should be non-virtual
 	void destruct();
@@ -244,6 +259,7 @@ private:
     void _originKeyChanged();
     void _colourKeyChanged(const std::string& value);
     void _onNoShadowsSettingsChanged(const std::string& value);
+    void _onClassnameChanged(const std::string& value);
 
     void acquireShaders();
     void acquireShaders(const RenderSystemPtr& renderSystem);
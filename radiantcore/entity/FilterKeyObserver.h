@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ientity.h"
+#include "ifilter.h"
+#include "inode.h"
+#include "SpawnArgs.h"
+
+namespace entity
+{
+
+/**
+ * Observes all spawnargs of an entity. Any change is queueing the
+ * entity node in the filter system, since the filter rules might
+ * apply differently now.
+ */
+class FilterKeyObserver :
+	public Entity::Observer
+{
+private:
+	scene::INode& _node;
+
+	// Set while attached, the notifications sent during attach
+	// and detach are not of interest
+	bool _isAttached;
+
+public:
+	FilterKeyObserver(scene::INode& node) :
+		_node(node),
+		_isAttached(false)
+	{}
+
+	void attach(SpawnArgs& spawnArgs)
+	{
+		spawnArgs.attachObserver(this);
+		_isAttached = true;
+	}
+
+	void detach(SpawnArgs& spawnArgs)
+	{
+		_isAttached = false;
+		spawnArgs.detachObserver(this);
+	}
+
+	void onKeyInsert(const std::string& key, EntityKeyValue& value) override
+	{
+		queueUpdate();
+	}
+
+	void onKeyChange(const std::string& key, const std::string& value) override
+	{
+		queueUpdate();
+	}
+
+	void onKeyErase(const std::string& key, EntityKeyValue& value) override
+	{
+		queueUpdate();
+	}
+
+	void queueUpdate()
+	{
+		// Entities outside the scene are evaluated when they're inserted
+		if (_isAttached && _node.inScene())
+		{
+			GlobalFilterSystem().queueUpdate(_node.getSelf());
+		}
+	}
+};
+
+}
@@ -12,7 +12,9 @@ KeyValue::KeyValue(const std::string& value, const std::string& empty,
     _emptyValue(empty),
     _undo(_value, std::bind(&KeyValue::importState, this, std::placeholders::_1),
         std::bind(&KeyValue::onUndoRedoOperationFinished, this), "KeyValue"),
-    _valueChanged(valueChanged)
+    _valueChanged(valueChanged),
+    _notificationsDeferred(false),
+    _notificationPending(false)
 {}
 
 KeyValue::~KeyValue()
@@ -54,7 +56,7 @@ void KeyValue::detach(KeyObserver& observer, bool sendEmptyValue)
 const std::string& KeyValue::get() const
 {
 	// Return the <empty> string if the actual value is ""
-	return (_value.empty()) ? _emptyValue : _value;
+	return (_value.empty()) ? _emptyValue.get() : _value.get();
 }
 
 void KeyValue::assign(const std::string& other)
@@ -62,13 +64,19 @@ void KeyValue::assign(const std::string& other)
 	if (_value != other)
     {
 		_undo.save();
-		_value = other;
+		_value = string::InternedString(other);
 		notify();
 	}
 }
 
 void KeyValue::notify()
 {
+    if (_notificationsDeferred)
+    {
+        _notificationPending = true;
+        return;
+    }
+
 	// Store the name locally, to avoid string-copy operations in the loop below
 	const std::string& value = get();
 
@@ -81,10 +89,28 @@ void KeyValue::notify()
 	}
 }
 
-void KeyValue::importState(const std::string& string)
+void KeyValue::deferNotifications()
+{
+    _notificationsDeferred = true;
+}
+
+void KeyValue::resumeNotifications(bool sendPending)
+{
+    auto notificationPending = _notificationPending;
+
+    _notificationsDeferred = false;
+    _notificationPending = false;
+
+    if (sendPending && notificationPending)
+    {
+        notify();
+    }
+}
+
+void KeyValue::importState(const string::InternedString& value)
 {
 	// We notify our observers after the entire undo rollback is done
-	_value = string;
+	_value = value;
 }
 
 void KeyValue::onUndoRedoOperationFinished()
@@ -94,7 +120,7 @@ void KeyValue::onUndoRedoOperationFinished()
 
 void KeyValue::onNameChange(const std::string& oldName, const std::string& newName)
 {
-	assert(oldName == _value); // The old name should match
+	assert(_value == oldName); // The old name should match
 
 	// Just assign the new name to this keyvalue
 	assign(newName);
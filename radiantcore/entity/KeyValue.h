@@ -3,6 +3,7 @@
 #include "ientity.h"
 #include "ObservedUndoable.h"
 #include "string/string.h"
+#include "string/InternedString.h"
 #include <vector>
 
 namespace entity
@@ -21,13 +22,18 @@ private:
 	typedef std::vector<KeyObserver*> KeyObservers;
 	KeyObservers _observers;
 
-	std::string _value;
-	std::string _emptyValue;
-	undo::ObservedUndoable<std::string> _undo;
+	// Values are shared with all the other key values of the same contents
+	string::InternedString _value;
+	string::InternedString _emptyValue;
+	undo::ObservedUndoable<string::InternedString> _undo;
 
     // This is a specialised callback pointing to the owning SpawnArgs
     std::function<void(const std::string&)> _valueChanged;
 
+    // Set during a batch update of the owning SpawnArgs
+    bool _notificationsDeferred;
+    bool _notificationPending;
+
 public:
 	KeyValue(const std::string& value, const std::string& empty, const std::function<void(const std::string&)>& valueChanged);
 
@@ -47,7 +53,13 @@ public:
 
 	void notify();
 
-	void importState(const std::string& string);
+	// Value changes are not notified until resumeNotifications() is called
+	void deferNotifications();
+
+	// Ends the deferral, a pending change is notified if sendPending is true
+	void resumeNotifications(bool sendPending);
+
+	void importState(const string::InternedString& value);
 
 	// NameObserver implementation
 	void onNameChange(const std::string& oldName, const std::string& newName) override;
@@ -81,8 +81,10 @@ void ModelKey::attachModelNode()
     }
 
 	// We have a non-empty model key, send the request to
-	// the model cache to acquire a new child node
-	_model.node = GlobalModelCache().getModelNode(actualModelPath);
+	// the model cache to acquire a new child node. Models which need to be
+	// parsed first are represented by a placeholder until they are loaded.
+	_model.node = GlobalModelCache().getModelNodeAsync(actualModelPath,
+        sigc::mem_fun(*this, &ModelKey::onModelLoaded));
 
 	// The model loader should not return NULL, but a sanity check is always ok
     if (!_model.node) return;
@@ -124,6 +126,19 @@ void ModelKey::onModelDefChanged()
     attachModelNodeKeepinSkin();
 }
 
+void ModelKey::onModelLoaded(const scene::INodePtr& placeholder)
+{
+    // Ignore the result if the model has been changed in the meantime
+    if (!_active || _model.node != placeholder) return;
+
+    attachModelNode();
+
+    if (auto skinned = std::dynamic_pointer_cast<SkinnedModel>(_model.node); skinned)
+    {
+        skinned->skinChanged(_pendingSkin);
+    }
+}
+
 void ModelKey::attachModelNodeKeepinSkin()
 {
     if (_model.node)
@@ -131,7 +146,7 @@ void ModelKey::attachModelNodeKeepinSkin()
         // Check if we have a skinnable model and remember the skin
 	    SkinnedModelPtr skinned = std::dynamic_pointer_cast<SkinnedModel>(_model.node);
 
-	    std::string skin = skinned ? skinned->getSkin() : "";
+	    std::string skin = skinned ? skinned->getSkin() : _pendingSkin;
 	
 	    attachModelNode();
 	
@@ -142,6 +157,11 @@ void ModelKey::attachModelNodeKeepinSkin()
 	    {
 		    skinned->skinChanged(skin);
 	    }
+	    else
+	    {
+		    // Keep the skin for the model that might be loaded in the background
+		    _pendingSkin = skin;
+	    }
     }
     else
     {
@@ -159,6 +179,11 @@ void ModelKey::skinChanged(const std::string& value)
 	{
 		skinned->skinChanged(value);
 	}
+	else
+	{
+		// The model might still be loading in the background
+		_pendingSkin = value;
+	}
 }
 
 void ModelKey::connectUndoSystem(IUndoSystem& undoSystem)
@@ -31,6 +31,9 @@ private:
 	// To deactivate model handling during node destruction
 	bool _active;
 
+	// The skin to apply to a model which is still being loaded in the background
+	std::string _pendingSkin;
+
 	// Saves modelnode and modelpath to undo stack
 	undo::ObservedUndoable<ModelNodeAndPath> _undo;
 
@@ -64,6 +67,9 @@ public:
 private:
     void onModelDefChanged();
 
+    // Replaces the placeholder node once the model has been loaded in the background
+    void onModelLoaded(const scene::INodePtr& placeholder);
+
 	// Loads the model node and attaches it to the parent node
     void attachModelNode();
     void detachModelNode();
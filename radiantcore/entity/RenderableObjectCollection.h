@@ -18,6 +18,9 @@ private:
     AABB _collectionBounds;
     bool _collectionBoundsNeedUpdate;
 
+    // Increased on every add/remove and bounds change
+    std::size_t _changeCount;
+
     struct ObjectData
     {
         Shader* shader;
@@ -28,7 +31,8 @@ private:
 
 public:
     RenderableObjectCollection() :
-        _collectionBoundsNeedUpdate(true)
+        _collectionBoundsNeedUpdate(true),
+        _changeCount(0)
     {}
 
     void addRenderable(const render::IRenderableObject::Ptr& object, Shader* shader)
@@ -45,6 +49,7 @@ public:
         }
 
         _collectionBoundsNeedUpdate = true;
+        ++_changeCount;
     }
 
     void removeRenderable(const render::IRenderableObject::Ptr& object)
@@ -62,6 +67,18 @@ public:
         }
 
         _collectionBoundsNeedUpdate = true;
+        ++_changeCount;
+    }
+
+    std::size_t getChangeCount() const
+    {
+        return _changeCount;
+    }
+
+    const AABB& getBounds()
+    {
+        ensureBoundsUpToDate();
+        return _collectionBounds;
     }
 
     void foreachRenderable(const IRenderEntity::ObjectVisitFunction& functor)
@@ -110,6 +127,7 @@ private:
     void onObjectBoundsChanged()
     {
         _collectionBoundsNeedUpdate = true;
+        ++_changeCount;
     }
 
     void ensureBoundsUpToDate()
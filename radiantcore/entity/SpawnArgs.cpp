@@ -13,6 +13,7 @@ SpawnArgs::SpawnArgs(const IEntityClassPtr& eclass) :
 	_undo(_keyValues, std::bind(&SpawnArgs::importState, this, std::placeholders::_1), 
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
+	_batchUpdateDepth(0),
 	_isContainer(!eclass->isFixedSize()),
 	_attachments(eclass->getDeclName())
 {
@@ -26,6 +27,7 @@ SpawnArgs::SpawnArgs(const SpawnArgs& other) :
 	_undo(_keyValues, std::bind(&SpawnArgs::importState, this, std::placeholders::_1), 
         std::function<void()>(), "EntityKeyValues"),
 	_observerMutex(false),
+	_batchUpdateDepth(0),
 	_isContainer(other._isContainer),
 	_attachments(other._attachments)
 {
@@ -84,9 +86,12 @@ void SpawnArgs::attachObserver(Observer* observer)
 	// Add the observer to the internal list
 	_observers.insert(observer);
 
-	// Now notify the observer about all the existing keys
+	// Now notify the observer about all the existing keys,
+	// keys inserted during a batch update are notified when it ends
 	for(KeyValues::const_iterator i = _keyValues.begin(); i != _keyValues.end(); ++i)
     {
+		if (_pendingInsertions.count(i->second.get()) > 0) continue;
+
 		observer->onKeyInsert(i->first, *i->second);
 	}
 }
@@ -110,8 +115,16 @@ void SpawnArgs::detachObserver(Observer* observer)
 	// Call onKeyErase() for every spawnarg, so that the observer gets cleanly shut down
 	for(KeyValues::const_iterator i = _keyValues.begin(); i != _keyValues.end(); ++i)
     {
+		if (_pendingInsertions.count(i->second.get()) > 0) continue;
+
 		observer->onKeyErase(i->first, *i->second);
 	}
+
+	// The observer has not been notified about the keys erased during a batch update yet
+	for (const auto& pair : _pendingErasures)
+	{
+		observer->onKeyErase(pair.first, *pair.second);
+	}
 }
 
 void SpawnArgs::connectUndoSystem(IUndoSystem& undoSystem)
@@ -179,6 +192,68 @@ void SpawnArgs::setKeyValue(const std::string& key, const std::string& value)
 	}
 }
 
+void SpawnArgs::beginBatchUpdate()
+{
+	if (_batchUpdateDepth++ > 0) return;
+
+	// Value changes of the existing keys are collected by the keys themselves
+	for (const auto& pair : _keyValues)
+	{
+		pair.second->deferNotifications();
+	}
+}
+
+void SpawnArgs::endBatchUpdate()
+{
+	assert(_batchUpdateDepth > 0);
+
+	if (--_batchUpdateDepth > 0) return;
+
+	flushBatchUpdate();
+}
+
+void SpawnArgs::flushBatchUpdate()
+{
+	// Take the pending changes, observers might change keys while being notified
+	auto erasures = std::move(_pendingErasures);
+	auto insertions = std::move(_pendingInsertions);
+	_pendingErasures.clear();
+	_pendingInsertions.clear();
+
+	KeyValues inserted;
+	std::vector<KeyValuePtr> existing;
+
+	for (const auto& pair : _keyValues)
+	{
+		if (insertions.count(pair.second.get()) > 0)
+		{
+			// The observers will get to see the final value on insertion
+			pair.second->resumeNotifications(false);
+			inserted.push_back(pair);
+		}
+		else
+		{
+			existing.push_back(pair.second);
+		}
+	}
+
+	for (const auto& pair : erasures)
+	{
+		pair.second->resumeNotifications(false);
+		notifyErase(pair.first, *pair.second);
+	}
+
+	for (const auto& value : existing)
+	{
+		value->resumeNotifications(true);
+	}
+
+	for (const auto& pair : inserted)
+	{
+		notifyInsert(pair.first, *pair.second);
+	}
+}
+
 std::string SpawnArgs::getKeyValue(const std::string& key) const
 {
 	// Lookup the key in the map
@@ -273,13 +348,22 @@ void SpawnArgs::notifyErase(const std::string& key, KeyValue& value)
 	_observerMutex = false;
 }
 
-void SpawnArgs::insert(const std::string& key, const KeyValuePtr& keyValue)
+void SpawnArgs::insert(const string::InternedString& key, const KeyValuePtr& keyValue)
 {
 	// Insert the new key at the end of the list
 	auto& pair = _keyValues.emplace_back(key, keyValue);
 
-	// Dereference the iterator to get a KeyValue& reference and notify the observers
-	notifyInsert(key, *pair.second);
+	if (_batchUpdateDepth > 0)
+	{
+		// Observers are notified when the batch update ends
+		pair.second->deferNotifications();
+		_pendingInsertions.insert(pair.second.get());
+	}
+	else
+	{
+		// Dereference the iterator to get a KeyValue& reference and notify the observers
+		notifyInsert(key, *pair.second);
+	}
 
 	if (_undo.isConnected())
 	{
@@ -305,9 +389,11 @@ void SpawnArgs::insert(const std::string& key, const std::string& value)
 		_undo.save();
 
 		// Allocate a new KeyValue object and insert it into the map
-        // Capture the key by value in the lambda
-		insert(key, std::make_shared<KeyValue>(value, _eclass->getAttributeValue(key),
-            [key, this](const std::string& value) { notifyChange(key, value); }));
+        // Capture the interned key by value in the lambda
+        string::InternedString internedKey(key);
+
+		insert(internedKey, std::make_shared<KeyValue>(value, _eclass->getAttributeValue(key),
+            [internedKey, this](const std::string& value) { notifyChange(internedKey, value); }));
 	}
 }
 
@@ -325,6 +411,18 @@ void SpawnArgs::erase(const KeyValues::iterator& i)
 	// Actually delete the object from the list
 	_keyValues.erase(i);
 
+	if (_batchUpdateDepth > 0)
+	{
+		// Observers never heard of keys inserted during this batch update,
+		// the others are notified when the batch update ends
+		if (_pendingInsertions.erase(value.get()) == 0)
+		{
+			_pendingErasures.emplace_back(key, value);
+		}
+
+		return;
+	}
+
 	// Notify about the deletion
 	notifyErase(key, *value);
 
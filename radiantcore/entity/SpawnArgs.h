@@ -26,8 +26,8 @@ class SpawnArgs: public Entity
 
 	typedef std::shared_ptr<KeyValue> KeyValuePtr;
 
-	// A key value pair using a dynamically allocated value
-	typedef std::pair<std::string, KeyValuePtr> KeyValuePair;
+	// A key value pair using a dynamically allocated value, the key is interned
+	typedef std::pair<string::InternedString, KeyValuePtr> KeyValuePair;
 
 	// The unsorted list of KeyValue pairs
 	typedef std::vector<KeyValuePair> KeyValues;
@@ -40,6 +40,15 @@ class SpawnArgs: public Entity
 
 	bool _observerMutex;
 
+	// Nesting level of the running batch updates
+	std::size_t _batchUpdateDepth;
+
+	// The keys inserted during the batch update, their observers are not notified yet
+	std::set<KeyValue*> _pendingInsertions;
+
+	// The keys erased during the batch update, in the order of their removal
+	KeyValues _pendingErasures;
+
 	bool _isContainer;
 
     // Store attachment information
@@ -64,6 +73,8 @@ public:
                          bool includeInherited) const override;
     void forEachEntityKeyValue(const EntityKeyValueVisitFunctor& visitor) override;
 	void setKeyValue(const std::string& key, const std::string& value) override;
+	void beginBatchUpdate() override;
+	void endBatchUpdate() override;
 	std::string getKeyValue(const std::string& key) const override;
 	bool isInherited(const std::string& key) const override;
     void forEachAttachment(AttachmentFunc func) const override;
@@ -92,7 +103,10 @@ private:
     void notifyChange(const std::string& k, const std::string& v);
 	void notifyErase(const std::string& key, KeyValue& value);
 
-	void insert(const std::string& key, const KeyValuePtr& keyValue);
+	// Sends the notifications collected during the batch update
+	void flushBatchUpdate();
+
+	void insert(const string::InternedString& key, const KeyValuePtr& keyValue);
 	void insert(const std::string& key, const std::string& value);
 
 	void erase(const KeyValues::iterator& i);
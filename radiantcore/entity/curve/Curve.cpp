@@ -1,5 +1,7 @@
 #include "Curve.h"
 
+#include <algorithm>
+#include <cmath>
 #include "itextstream.h"
 #include "string/convert.h"
 #include "parser/Tokeniser.h"
@@ -8,6 +10,9 @@ namespace entity {
 
 	namespace {
 
+		// The number of line segments each curve segment is tesselated into
+		constexpr std::size_t SEGMENTS_PER_CONTROL_POINT = 16;
+
 		inline void PointVertexArray_testSelect(VertexCb* first, std::size_t count,
 			SelectionTest& test, SelectionIntersection& best)
 		{
@@ -129,11 +134,77 @@ bool Curve::parseCurve(const std::string& value) {
 	return true;
 }
 
+void Curve::tesselate()
+{
+	const auto& points = _controlPointsTransformed;
+
+	if (points.empty())
+	{
+		_renderCurve.m_vertices.clear();
+		_tesselatedControlPoints.clear();
+		_renderCurve.queueUpdate();
+		return;
+	}
+
+	const std::size_t numSegments = (points.size() - 1) * SEGMENTS_PER_CONTROL_POINT;
+	std::size_t firstVertex = 0;
+	std::size_t endVertex = numSegments + 1;
+	bool partialUpdate = false;
+
+	if (numSegments > 0 && points.size() == _tesselatedControlPoints.size() &&
+		_renderCurve.m_vertices.size() == numSegments + 1)
+	{
+		auto firstChanged = std::mismatch(points.begin(), points.end(), _tesselatedControlPoints.begin()).first;
+
+		if (firstChanged == points.end())
+		{
+			return; // nothing moved
+		}
+
+		auto lastChanged = std::mismatch(points.rbegin(), points.rend(), _tesselatedControlPoints.rbegin()).first;
+
+		auto [start, end] = getInfluencedRange(
+			std::distance(points.begin(), firstChanged),
+			points.size() - 1 - std::distance(points.rbegin(), lastChanged));
+
+		// Add one vertex on either side to be safe from rounding errors
+		auto first = static_cast<std::size_t>(std::max(std::floor(start * numSegments) - 1, 0.0));
+		auto last = static_cast<std::size_t>(std::max(std::ceil(end * numSegments) + 1, 0.0));
+
+		firstVertex = std::min(first, numSegments);
+		endVertex = std::min(last, numSegments) + 1;
+		partialUpdate = true;
+	}
+	else
+	{
+		_renderCurve.m_vertices.resize(numSegments + 1);
+	}
+
+	for (auto i = firstVertex; i < endVertex; ++i)
+	{
+		_renderCurve.m_vertices[i].vertex = Vertex3(
+			i == 0 ? points.front() :
+			i == numSegments ? points.back() :
+			evaluate((1.0 / double(numSegments)) * double(i))
+		);
+	}
+
+	_tesselatedControlPoints = points;
+
+	if (partialUpdate)
+	{
+		_renderCurve.queueUpdate(firstVertex, endVertex);
+	}
+	else
+	{
+		_renderCurve.queueUpdate();
+	}
+}
+
 void Curve::curveChanged() 
 {
-	// Recalculate the tesselation
+	// Recalculate the tesselation, this queues the renderable update
 	tesselate();
-    updateRenderable();
 
 	// Recalculate bounds
     _bounds = AABB();
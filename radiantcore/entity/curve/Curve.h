@@ -30,6 +30,9 @@ protected:
 	RenderableCurve _renderCurve;
 	AABB _bounds;
 
+	// The control points the current tesselation has been calculated from
+	ControlPoints _tesselatedControlPoints;
+
 	Callback _boundsChanged;
     sigc::signal<void> _sigCurveChanged;
 
@@ -48,8 +51,9 @@ public:
         return _sigCurveChanged;
     }
 
-	// Tesselation has to be implemented by the subclasses
-	virtual void tesselate() = 0;
+	// Updates the tesselation. If the number of control points is unchanged,
+	// only the part of the curve influenced by the moved points is evaluated again.
+	void tesselate();
 
 	// This gets called when the entity keyvalue changes
 	void onKeyValueChanged(const std::string& value);
@@ -95,6 +99,13 @@ public:
     void updateRenderable();
 
 protected:
+	// Evaluates the curve at the given parameter in the range [0..1]
+	virtual Vector3 evaluate(double t) const = 0;
+
+	// Returns the parameter range [start, end] of the curve influenced by
+	// the control points with the indices firstPoint to lastPoint (inclusive)
+	virtual std::pair<double, double> getInfluencedRange(std::size_t firstPoint, std::size_t lastPoint) const = 0;
+
 	// Clears the control points and other associated elements
 	virtual void clearCurve() = 0;
 
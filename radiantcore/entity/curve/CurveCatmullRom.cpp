@@ -34,26 +34,20 @@ void CurveCatmullRom::insertControlPointsAt(IteratorList iterators) {
 	curveChanged();
 }
 
-void CurveCatmullRom::tesselate() {
-	if (!_controlPointsTransformed.empty()) {
-		const std::size_t numSegments = (_controlPointsTransformed.size() - 1) * 16;
-		_renderCurve.m_vertices.resize(numSegments + 1);
-		_renderCurve.m_vertices[0].vertex = Vertex3(_controlPointsTransformed[0]);
+Vector3 CurveCatmullRom::evaluate(double t) const
+{
+	return CatmullRom_evaluate(_controlPointsTransformed, t);
+}
+
+std::pair<double, double> CurveCatmullRom::getInfluencedRange(std::size_t firstPoint, std::size_t lastPoint) const
+{
+	// Each segment is defined by its two end points and their neighbours
+	const std::size_t numSegments = _controlPointsTransformed.size() - 1;
+
+	std::size_t firstSegment = firstPoint > 2 ? firstPoint - 2 : 0;
+	std::size_t lastSegment = std::min(lastPoint + 1, numSegments - 1);
 
-		for(std::size_t i = 1; i < numSegments; ++i) {
-			_renderCurve.m_vertices[i].vertex = Vertex3(
-				CatmullRom_evaluate(_controlPointsTransformed,
-									(1.0 / double(numSegments)) * double(i)
-				)
-			);
-		}
-		_renderCurve.m_vertices[numSegments].vertex = Vertex3(
-			_controlPointsTransformed[_controlPointsTransformed.size() - 1]
-		);
-	}
-	else {
-		_renderCurve.m_vertices.clear();
-	}
+	return { double(firstSegment) / numSegments, double(lastSegment + 1) / numSegments };
 }
 
 void CurveCatmullRom::saveToEntity(Entity& target) {
@@ -10,31 +10,15 @@ CurveNURBS::CurveNURBS(const IEntityNode& entity, const Callback& callback) :
 	Curve(entity, callback)
 {}
 
-void CurveNURBS::tesselate() {
-	if (!_controlPointsTransformed.empty()) {
-		const std::size_t numSegments = (_controlPointsTransformed.size() - 1) * 16;
-
-		_renderCurve.m_vertices.resize(numSegments + 1);
-		_renderCurve.m_vertices[0].vertex = Vertex3(_controlPointsTransformed[0]);
-
-		for (std::size_t i = 1; i < numSegments; ++i) {
-			_renderCurve.m_vertices[i].vertex = Vertex3(
-				NURBS_evaluate(_controlPointsTransformed,
-							   _weights,
-							   _knots,
-							   NURBS_degree,
-							   (1.0 / double(numSegments)) * double(i)
-				)
-			);
-		}
-		_renderCurve.m_vertices[numSegments].vertex = Vertex3(
-			_controlPointsTransformed[_controlPointsTransformed.size() - 1]
-		);
-	}
-	else {
-		// No control points found, clear the rendercurve object
-		_renderCurve.m_vertices.clear();
-	}
+Vector3 CurveNURBS::evaluate(double t) const
+{
+	return NURBS_evaluate(_controlPointsTransformed, _weights, _knots, NURBS_degree, t);
+}
+
+std::pair<double, double> CurveNURBS::getInfluencedRange(std::size_t firstPoint, std::size_t lastPoint) const
+{
+	// The basis function of control point i is non-zero within [knots[i], knots[i + degree + 1])
+	return { _knots[firstPoint], _knots[std::min(lastPoint + NURBS_degree + 1, _knots.size() - 1)] };
 }
 
 void CurveNURBS::clearCurve() {
@@ -17,9 +17,6 @@ class CurveNURBS :
 public:
 	CurveNURBS(const IEntityNode& entity, const Callback& callback);
 
-	// Subdivides the segments between the control points
-	virtual void tesselate();
-
 	// Extends the algorithm of the base class by a few commands
 	virtual void appendControlPoints(unsigned int numPoints);
 
@@ -32,6 +29,10 @@ public:
 	// Inserts control points before the specified list of iterators.
 	virtual void insertControlPointsAt(IteratorList iterators);
 
+protected:
+	Vector3 evaluate(double t) const override;
+	std::pair<double, double> getInfluencedRange(std::size_t firstPoint, std::size_t lastPoint) const override;
+
 private:
 	// Clears the control points, weights and knots
 	virtual void clearCurve();
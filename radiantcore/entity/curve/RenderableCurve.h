@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include "irenderable.h"
 #include "render.h"
@@ -15,17 +16,44 @@ private:
     const IEntityNode& _entity;
     bool _needsUpdate;
 
+    // Set if only the vertices in [_firstChangedVertex, _endChangedVertex) need to be uploaded
+    bool _partialUpdate;
+    std::size_t _firstChangedVertex;
+    std::size_t _endChangedVertex;
+
 public:
 	std::vector<VertexCb> m_vertices;
 
     RenderableCurve(const IEntityNode& entity) :
         _entity(entity),
-        _needsUpdate(true)
+        _needsUpdate(true),
+        _partialUpdate(false),
+        _firstChangedVertex(0),
+        _endChangedVertex(0)
     {}
 
     void queueUpdate()
     {
         _needsUpdate = true;
+        _partialUpdate = false;
+    }
+
+    // Queues an upload of the given vertex range only,
+    // the number of vertices needs to be the same as in the last update
+    void queueUpdate(std::size_t firstVertex, std::size_t endVertex)
+    {
+        if (!_needsUpdate)
+        {
+            _needsUpdate = true;
+            _partialUpdate = true;
+            _firstChangedVertex = firstVertex;
+            _endChangedVertex = endVertex;
+        }
+        else if (_partialUpdate)
+        {
+            _firstChangedVertex = std::min(_firstChangedVertex, firstVertex);
+            _endChangedVertex = std::max(_endChangedVertex, endVertex);
+        }
     }
 
 protected:
@@ -41,6 +69,26 @@ protected:
             return;
         }
 
+        auto colour = _entity.getEntityColour();
+
+        if (_partialUpdate && hasGeometry() && _endChangedVertex <= m_vertices.size())
+        {
+            _partialUpdate = false;
+
+            std::vector<render::RenderVertex> vertices;
+            vertices.reserve(_endChangedVertex - _firstChangedVertex);
+
+            for (auto i = _firstChangedVertex; i < _endChangedVertex; ++i)
+            {
+                vertices.push_back(render::RenderVertex(m_vertices[i].vertex, { 0,0,1 }, { 0,0 }, colour));
+            }
+
+            updateGeometryWithSubData(_firstChangedVertex, vertices);
+            return;
+        }
+
+        _partialUpdate = false;
+
         std::vector<render::RenderVertex> vertices;
         std::vector<unsigned int> indices;
 
@@ -49,8 +97,6 @@ protected:
 
         unsigned int index = 0;
 
-        auto colour = _entity.getEntityColour();
-
         for (const auto& v : m_vertices)
         {
             vertices.push_back(render::RenderVertex(v.vertex, { 0,0,1 }, { 0,0 }, colour));
@@ -121,6 +121,15 @@ void StaticGeometryNode::onVisibilityChanged(bool isVisibleNow)
     }
 }
 
+void StaticGeometryNode::onEntityClassColourChanged()
+{
+    EntityNode::onEntityClassColourChanged();
+
+    // The curves are drawn in the entity colour
+    m_curveNURBS.updateRenderable();
+    m_curveCatmullRom.updateRenderable();
+}
+
 void StaticGeometryNode::onSelectionStatusChange(bool changeGroupStatus)
 {
     EntityNode::onSelectionStatusChange(changeGroupStatus);
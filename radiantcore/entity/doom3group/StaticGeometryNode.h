@@ -160,6 +160,7 @@ protected:
 	virtual void construct() override;
 
     void onVisibilityChanged(bool isVisibleNow) override;
+    void onEntityClassColourChanged() override;
 
     void onSelectionStatusChange(bool changeGroupStatus) override;
 
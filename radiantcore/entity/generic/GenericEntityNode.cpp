@@ -362,5 +362,14 @@ void GenericEntityNode::onRenderStateChanged()
     updateRenderables();
 }
 
+void GenericEntityNode::onEntityClassColourChanged()
+{
+    EntityNode::onEntityClassColourChanged();
+
+    // The renderables are using the new shaders and vertex colours
+    clearRenderables();
+    updateRenderables();
+}
+
 
 } // namespace entity
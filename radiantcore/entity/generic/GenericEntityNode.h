@@ -126,6 +126,7 @@ protected:
 
     void onVisibilityChanged(bool isVisibleNow) override;
     void onRenderStateChanged() override;
+    void onEntityClassColourChanged() override;
 
     void updateRenderables();
     void clearRenderables();
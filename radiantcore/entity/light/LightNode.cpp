@@ -21,7 +21,6 @@ LightNode::LightNode(const IEntityClassPtr& eclass)
     _originTransformed(ORIGINKEY_IDENTITY),
     m_rotationKey(std::bind(&LightNode::rotationChanged, this)),
     m_transformChanged(std::bind(&scene::Node::transformChanged, this)),
-    m_boundsChanged(std::bind(&scene::Node::boundsChanged, this)),
     _instances(getDoom3Radius().m_centerTransformed, _projVectors.transformed,
                sigc::mem_fun(*this, &LightNode::selectedChangedComponent)),
     _dragPlanes(std::bind(&LightNode::selectedChangedComponent, this, std::placeholders::_1)),
@@ -41,7 +40,6 @@ LightNode::LightNode(const LightNode& other)
     _originTransformed(ORIGINKEY_IDENTITY),
     m_rotationKey(std::bind(&LightNode::rotationChanged, this)),
     m_transformChanged(std::bind(&Node::transformChanged, this)),
-    m_boundsChanged(std::bind(&Node::boundsChanged, this)),
     _instances(getDoom3Radius().m_centerTransformed, _projVectors.transformed,
         sigc::mem_fun(*this, &LightNode::selectedChangedComponent)),
     _dragPlanes(std::bind(&LightNode::selectedChangedComponent, this, std::placeholders::_1)),
@@ -96,6 +94,7 @@ void LightNode::construct()
     observeKey("texture", sigc::mem_fun(m_shader, &LightShader::valueChanged));
 
     _projectionChanged = true;
+    _projectedLightAABBChanged = true;
 
     _spawnArgs.setIsContainer(true);
 
@@ -132,9 +131,10 @@ AABB LightNode::getSelectAABB() const
 
 void LightNode::onLightRadiusChanged()
 {
-    // Light radius changed, mark bounds as dirty
+    // Light radius or center changed, mark bounds as dirty.
+    // The octagon is not affected, it only follows the transform.
     boundsChanged();
-    updateRenderables();
+    updateVolumeRenderables();
 }
 
 void LightNode::transformChanged()
@@ -508,8 +508,6 @@ void LightNode::_onTransformationChanged()
 	revertLightTransform();
 	evaluateTransform();
 	updateOrigin();
-
-    updateRenderables();
 }
 
 void LightNode::_applyTransformation()
@@ -519,20 +517,29 @@ void LightNode::_applyTransformation()
 	freezeLightTransform();
 }
 
-void LightNode::updateOrigin() {
-    m_boundsChanged();
-
-    m_doom3Radius.m_changed();
-
-    // Update the projection as well, if necessary
+void LightNode::updateOrigin()
+{
+    // Radius, center or projection vectors might have been changed along with the origin
     if (isProjected())
+    {
         projectionChanged();
+    }
+    else
+    {
+        onLightRadiusChanged();
+    }
 
-    // Update the transformation matrix
-    setLocalToParent(Matrix4::getTranslation(_originTransformed) * m_rotation.getMatrix4());
+    auto localToParent = Matrix4::getTranslation(_originTransformed) * m_rotation.getMatrix4();
 
-    // Notify all child nodes
-    m_transformChanged();
+    // Resizing the light volume doesn't necessarily move the light,
+    // there's no need to update the children and the octagon in this case
+    if (localToParent != EntityNode::localToParent())
+    {
+        setLocalToParent(localToParent);
+
+        // Notify all child nodes
+        m_transformChanged();
+    }
 
     GlobalSelectionSystem().pivotChanged();
 }
@@ -968,8 +975,20 @@ AABB LightNode::lightAABB() const
         // Make sure our frustum is up to date
         updateProjection();
 
-        // Return Frustum AABB in *world* space
-        return _frustum.getTransformedBy(localToParent()).getAABB();
+        auto localToParent = EntityNode::localToParent();
+
+        // Transforming the frustum involves intersecting its planes,
+        // re-use the previous result if nothing has changed
+        if (_projectedLightAABBChanged || localToParent != _projectedLightAABBTransform)
+        {
+            _projectedLightAABBChanged = false;
+            _projectedLightAABBTransform = localToParent;
+
+            // Frustum AABB in *world* space
+            _projectedLightAABB = _frustum.getTransformedBy(localToParent).getAABB();
+        }
+
+        return _projectedLightAABB;
     }
     else
     {
@@ -1032,10 +1051,9 @@ bool LightNode::useStartEnd() const {
 void LightNode::projectionChanged()
 {
     _projectionChanged = true;
-    m_doom3Radius.m_changed();
 
-    _renderableVertices.queueUpdate();
-    _renderableLightVolume.queueUpdate();
+    boundsChanged();
+    updateVolumeRenderables();
 
     SceneChangeNotify();
 }
@@ -1060,6 +1078,7 @@ void LightNode::updateProjection() const
     }
 
     _projectionChanged = false;
+    _projectedLightAABBChanged = true;
 
     Plane3 lightProject[4];
 
@@ -1248,7 +1267,11 @@ const IRenderEntity& LightNode::getLightEntity() const
 
 void LightNode::onColourKeyChanged(const std::string& value)
 {
-    updateRenderables();
+    // Only the vertex colours of the octagon and the volume are affected,
+    // the bounds and the interactions of this light remain the same
+    _renderableOctagon.queueUpdate();
+    _renderableOctagonOutline.queueUpdate();
+    _renderableLightVolume.queueUpdate();
 }
 
 void LightNode::onRenderStateChanged()
@@ -1259,6 +1282,15 @@ void LightNode::onRenderStateChanged()
     updateRenderables();
 }
 
+void LightNode::onEntityClassColourChanged()
+{
+    EntityNode::onEntityClassColourChanged();
+
+    // The renderables are using the new shaders and vertex colours
+    clearRenderables();
+    updateRenderables();
+}
+
 void LightNode::updateRenderables()
 {
     _renderableOctagon.queueUpdate();
@@ -1267,6 +1299,12 @@ void LightNode::updateRenderables()
     _renderableVertices.queueUpdate();
 }
 
+void LightNode::updateVolumeRenderables()
+{
+    _renderableLightVolume.queueUpdate();
+    _renderableVertices.queueUpdate();
+}
+
 void LightNode::clearRenderables()
 {
     _renderableOctagon.clear();
@@ -66,6 +66,12 @@ class LightNode :
 
     mutable bool _projectionChanged;
 
+    // World space bounds of the projected light volume, along with the
+    // transform they have been calculated for. Re-evaluated on demand only.
+    mutable AABB _projectedLightAABB;
+    mutable Matrix4 _projectedLightAABBTransform;
+    mutable bool _projectedLightAABBChanged;
+
 	LightShader m_shader;
     ShaderPtr _vertexShader;
     ShaderPtr _crystalFillShader;
@@ -75,7 +81,6 @@ class LightNode :
     AABB _lightBox;
 
     Callback m_transformChanged;
-    Callback m_boundsChanged;
     Callback m_evaluateTransform;
 
     LightVertexInstanceSet _instances;
@@ -212,6 +217,7 @@ protected:
 
     void onColourKeyChanged(const std::string& value) override;
     void onRenderStateChanged() override;
+    void onEntityClassColourChanged() override;
 
 private:
     void evaluateTransform();
@@ -259,7 +265,12 @@ private:
     void updateProjection() const;
 	bool useStartEnd() const;
 
+    // Queues an update of all renderables, needed when the light is moved or rotated
     void updateRenderables();
+
+    // Queues an update of the renderables depending on the light volume
+    void updateVolumeRenderables();
+
     void clearRenderables();
 
 public:
@@ -487,6 +487,15 @@ void SpeakerNode::onRenderStateChanged()
     updateRenderables();
 }
 
+void SpeakerNode::onEntityClassColourChanged()
+{
+    EntityNode::onEntityClassColourChanged();
+
+    // The renderables are using the new shaders and vertex colours
+    clearRenderables();
+    updateRenderables();
+}
+
 const Vector3& SpeakerNode::getWorldPosition() const
 {
     return m_origin;
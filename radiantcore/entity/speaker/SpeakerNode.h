@@ -142,6 +142,7 @@ protected:
     void onVisibilityChanged(bool isVisibleNow) override;
     void onSelectionStatusChange(bool changeGroupStatus) override;
     void onRenderStateChanged() override;
+    void onEntityClassColourChanged() override;
 
 private:
     void evaluateTransform();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_set>
 #include "TargetKeyCollection.h"
 #include "render.h"
 #include "ientity.h"
@@ -19,21 +20,37 @@ namespace
 /**
  * greebo: This is a helper object owned by the TargetableInstance.
  * It sets up a line-based renderable which repopulates
- * itself each frame with the coordinates of the targeted
- * instances. It provides a render() method.
+ * itself with the coordinates of the targeted instances.
+ * It provides a render() method.
  *
  * The render() method is invoked by the TargetableNode during the
  * frontend render pass.
+ *
+ * If only some of the targets moved, just the vertices of the lines
+ * leading to them are replaced in the geometry store.
  */
 class RenderableTargetLines :
     public render::RenderableGeometry
 {
 private:
+    static constexpr std::size_t VERTICES_PER_LINE = 6;
+
     const IEntityNode& _entity;
     const TargetKeyCollection& _targetKeys;
 
     Vector3 _worldPosition;
 
+    // The target and end point of each submitted line, in vertex order
+    struct Line
+    {
+        const Target* target;
+        Vector3 endPosition;
+    };
+    std::vector<Line> _lines;
+
+    // The targets that moved since the last update
+    std::unordered_set<const Target*> _changedTargets;
+
     bool _updateNeeded;
 
 public:
@@ -43,67 +60,157 @@ public:
         _updateNeeded(true)
     {}
 
+    // Requests a rebuild of all lines
     void queueUpdate()
     {
         _updateNeeded = true;
     }
 
+    // Requests an update of the lines leading to the given target
+    void queueUpdate(const TargetPtr& target)
+    {
+        if (!_updateNeeded && target)
+        {
+            _changedTargets.insert(target.get());
+        }
+    }
+
     bool hasTargets() const
     {
         return !_targetKeys.empty();
     }
 
+    // Removes the geometry, it's rebuilt on the next update
+    void clear()
+    {
+        RenderableGeometry::clear();
+
+        _lines.clear();
+        _changedTargets.clear();
+        _updateNeeded = true;
+    }
+
     void update(const ShaderPtr& shader, const Vector3& worldPosition)
     {
         // Force an update on position change
         _updateNeeded |= worldPosition != _worldPosition;
 
-        if (!_updateNeeded) return;
-        
-        _updateNeeded = false;
+        if (!_updateNeeded && _changedTargets.empty()) return;
 
         // Store the new world position for use in updateGeometry()
         _worldPosition = worldPosition;
 
         // Tell the base class to run the rest of the update routine
         RenderableGeometry::update(shader);
+
+        _updateNeeded = false;
+        _changedTargets.clear();
     }
 
 protected:
     void updateGeometry() override
     {
-        // Target lines are visible if both their start and end entities are visible
-        // This is hard to track in the scope of this class, so we fall back to doing
-        // an update on the renderable geometry every time we're asked to
+        if (!_updateNeeded && hasGeometry() && updateChangedLines())
+        {
+            return;
+        }
 
         // Collect vertex and index data
         std::vector<render::RenderVertex> vertices;
         std::vector<unsigned int> indices;
         auto maxTargets = _targetKeys.getNumTargets();
 
-        vertices.reserve(6 * maxTargets);
-        indices.reserve(6 * maxTargets);
+        vertices.reserve(VERTICES_PER_LINE * maxTargets);
+        indices.reserve(VERTICES_PER_LINE * maxTargets);
+
+        _lines.clear();
 
         _targetKeys.forEachTarget([&](const TargetPtr& target)
         {
-            if (!target || target->isEmpty() || !target->isVisible())
+            if (!isLineVisible(target))
             {
                 return;
             }
 
             auto targetPosition = target->getPosition();
 
-            addTargetLine(_worldPosition, targetPosition, vertices, indices);
+            _lines.emplace_back(Line{ target.get(), targetPosition });
+
+            for (unsigned int i = 0; i < VERTICES_PER_LINE; ++i)
+            {
+                indices.push_back(static_cast<unsigned int>(vertices.size()) + i);
+            }
+
+            addTargetLine(_worldPosition, targetPosition, vertices);
         });
 
         updateGeometryWithData(render::GeometryType::Lines, vertices, indices);
     }
 
 private:
+    // Target lines are visible if both their start and end entities are visible,
+    // the owning node is checking the start entity
+    static bool isLineVisible(const TargetPtr& target)
+    {
+        return target && !target->isEmpty() && target->isVisible();
+    }
+
+    // Replaces the vertices of the lines leading to the changed targets.
+    // Returns false if the set of visible lines changed, which needs a rebuild.
+    bool updateChangedLines()
+    {
+        std::size_t lineIndex = 0;
+        bool linesMatch = true;
+        std::vector<std::size_t> linesToUpdate;
+
+        _targetKeys.forEachTarget([&](const TargetPtr& target)
+        {
+            if (!linesMatch || !isLineVisible(target)) return;
+
+            if (lineIndex >= _lines.size() || _lines[lineIndex].target != target.get())
+            {
+                linesMatch = false;
+                return;
+            }
+
+            if (_changedTargets.count(target.get()) > 0)
+            {
+                linesToUpdate.push_back(lineIndex);
+            }
+
+            ++lineIndex;
+        });
+
+        if (!linesMatch || lineIndex != _lines.size())
+        {
+            return false;
+        }
+
+        std::vector<render::RenderVertex> vertices;
+        vertices.reserve(VERTICES_PER_LINE);
+
+        for (auto index : linesToUpdate)
+        {
+            auto& line = _lines[index];
+            auto targetPosition = line.target->getPosition();
+
+            if (targetPosition == line.endPosition) continue;
+
+            line.endPosition = targetPosition;
+
+            vertices.clear();
+            addTargetLine(_worldPosition, targetPosition, vertices);
+
+            updateGeometryWithSubData(index * VERTICES_PER_LINE, vertices);
+        }
+
+        return true;
+    }
+
     // Adds points to the vector, defining a line from start to end, with arrow indicators
     // in the XY plane (located at the midpoint between start/end).
     void addTargetLine(const Vector3& startPosition, const Vector3& endPosition,
-        std::vector<render::RenderVertex>& vertices, std::vector<unsigned int>& indices)
+        std::vector<render::RenderVertex>& vertices)
     {
         // Take the mid-point
         Vector3 mid((startPosition + endPosition) * 0.5f);
@@ -139,8 +246,6 @@ private:
 
         auto colour = _entity.getEntityColour();
 
-        auto indexOffset = static_cast<unsigned int>(vertices.size());
-
         // The line from this to the other entity
         vertices.push_back(render::RenderVertex(startPosition, { 1,0,0 }, { 0, 0 }, colour));
         vertices.push_back(render::RenderVertex(endPosition, { 1,0,0 }, { 0, 0 }, colour));
@@ -151,13 +256,6 @@ private:
 
         vertices.push_back(render::RenderVertex(mid, { 1,0,0 }, { 0, 0 }, colour));
         vertices.push_back(render::RenderVertex(xyPoint2, { 1,0,0 }, { 0, 0 }, colour));
-
-        indices.push_back(indexOffset + 0);
-        indices.push_back(indexOffset + 1);
-        indices.push_back(indexOffset + 2);
-        indices.push_back(indexOffset + 3);
-        indices.push_back(indexOffset + 4);
-        indices.push_back(indexOffset + 5);
     }
 };
 
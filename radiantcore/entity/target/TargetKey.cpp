@@ -20,10 +20,13 @@ void TargetKey::onTargetManagerChanged()
         return;
     }
 
+    _positionChangedSignal.disconnect();
+
     _target = std::static_pointer_cast<Target>(manager->getTarget(_curValue));
     assert(_target);
 
-    _target->signal_TargetChanged().connect(sigc::mem_fun(this, &TargetKey::onTargetPositionChanged));
+    _positionChangedSignal = _target->signal_TargetChanged().connect(
+        sigc::mem_fun(this, &TargetKey::onTargetPositionChanged));
 }
 
 const TargetPtr& TargetKey::getTarget() const
@@ -41,6 +44,8 @@ void TargetKey::detachFromKeyValue(EntityKeyValue& value)
 {
 	// Stop observing this KeyValue
 	value.detach(*this);
+
+    _positionChangedSignal.disconnect();
 }
 
 void TargetKey::onKeyValueChanged(const std::string& newValue)
@@ -58,13 +63,17 @@ void TargetKey::onKeyValueChanged(const std::string& newValue)
         _target = std::static_pointer_cast<Target>(targetManager->getTarget(_curValue));
         assert(_target);
 
-        _target->signal_TargetChanged().connect(sigc::mem_fun(this, &TargetKey::onTargetPositionChanged));
+        _positionChangedSignal = _target->signal_TargetChanged().connect(
+            sigc::mem_fun(this, &TargetKey::onTargetPositionChanged));
     }
+
+    // The line to the previous target is outdated
+    _owner.onTargetKeyChanged();
 }
 
 void TargetKey::onTargetPositionChanged()
 {
-    _owner.onTargetPositionChanged();
+    _owner.onTargetPositionChanged(_target);
 }
 
 } // namespace entity
@@ -24,7 +24,7 @@ void TargetKeyCollection::onTargetManagerChanged()
 
 void TargetKeyCollection::forEachTarget(const std::function<void(const TargetPtr&)>& func) const
 {
-	for (auto pair : _targetKeys)
+	for (const auto& pair : _targetKeys)
 	{
 		func(pair.second.getTarget());
 	}
@@ -86,14 +86,19 @@ void TargetKeyCollection::onKeyErase(const std::string& key, EntityKeyValue& val
     _owner.onTargetKeyCollectionChanged();
 }
 
-sigc::signal<void>& TargetKeyCollection::signal_TargetPositionChanged()
+sigc::signal<void, const TargetPtr&>& TargetKeyCollection::signal_TargetPositionChanged()
 {
     return _sigTargetPositionChanged;
 }
 
-void TargetKeyCollection::onTargetPositionChanged()
+void TargetKeyCollection::onTargetPositionChanged(const TargetPtr& target)
 {
-    _sigTargetPositionChanged.emit();
+    _sigTargetPositionChanged.emit(target);
+}
+
+void TargetKeyCollection::onTargetKeyChanged()
+{
+    _owner.onTargetKeyCollectionChanged();
 }
 
 } // namespace entity
@@ -19,7 +19,7 @@ private:
 	typedef std::map<std::string, TargetKey> TargetKeyMap;
 	TargetKeyMap _targetKeys;
 
-    sigc::signal<void> _sigTargetPositionChanged;
+    sigc::signal<void, const TargetPtr&> _sigTargetPositionChanged;
 
 public:
     TargetKeyCollection(TargetableNode& owner);
@@ -48,11 +48,14 @@ public:
 	// Returns TRUE if there are no "target" keys observed
 	bool empty() const;
 
-    // The TargetLineNode listens to this to reconstructs its renderables
-    sigc::signal<void>& signal_TargetPositionChanged();
+    // The TargetLineNode listens to this to update the line leading to the given target
+    sigc::signal<void, const TargetPtr&>& signal_TargetPositionChanged();
 
     // Invoked by the TargetKey instance if a single Target changes its position
-    void onTargetPositionChanged();
+    void onTargetPositionChanged(const TargetPtr& target);
+
+    // Invoked by the TargetKey instance if its value changed to point to a different Target
+    void onTargetKeyChanged();
 
 private:
 	// Returns TRUE if the given key matches the pattern for target keys
@@ -53,6 +53,9 @@ protected:
 
 private:
     Vector3 getOwnerPosition() const;
+
+    // Only the lines leading to the given target need to be updated
+    void onTargetPositionChanged(const TargetPtr& target);
 };
 
 }
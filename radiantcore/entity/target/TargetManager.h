@@ -1,6 +1,6 @@
 #pragma once
 
-#include <map>
+#include <unordered_map>
 #include <string>
 #include "ientity.h"
 #include "Target.h"
@@ -16,8 +16,9 @@ class TargetManager :
     public ITargetManager
 {
 private:
-	// The list of all named Target objects
-    std::map<std::string, TargetPtr> _targets;
+	// All named Target objects, hashed by name. The TargetKeys referencing
+	// a Target are connected to its changed signal.
+    std::unordered_map<std::string, TargetPtr> _targets;
 
 	// An empty Target (this is returned if an empty name is requested)
 	TargetPtr _emptyTarget;
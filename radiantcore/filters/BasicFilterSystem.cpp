@@ -8,6 +8,9 @@
 #include "iregistry.h"
 #include "igame.h"
 #include "ishaders.h"
+#include "ideclmanager.h"
+#include "ientity.h"
+#include "ieclass.h"
 
 #include "module/StaticModule.h"
 #include "InstanceUpdateWalker.h"
@@ -41,9 +44,8 @@ void BasicFilterSystem::setAllFilterStates(bool state)
 		_activeFilters.clear();
 	}
 
-	// Invalidate the visibility cache to force new values to be
-	// loaded from the filters themselves
-	_visibilityCache.clear();
+	// The cached masks stay valid, only the active set has changed
+	updateActiveFilters();
 
 	// Update the scenegraph instances
 	update();
@@ -165,6 +167,19 @@ void BasicFilterSystem::initialiseModule(const IApplicationContext& ctx)
 	// user-defined filters
 	addFiltersFromXML(userFilters, false);
 
+	updateActiveFilters();
+
+	GlobalSceneGraph().addSceneObserver(this);
+
+	// Drop the cached names when the declarations are reloaded, removed declarations
+	// shouldn't linger in the cache
+	_materialsReloadedConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::Material).connect(
+		[this]() { _visibilityCache[FilterRule::TYPE_TEXTURE].clear(); }
+	);
+	_entityClassesReloadedConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::EntityDef).connect(
+		[this]() { _visibilityCache[FilterRule::TYPE_ENTITYCLASS].clear(); }
+	);
+
 	// Add the (de-)activate all commands
 	GlobalCommandSystem().addCommand("SetAllFilterStates",
 		std::bind(&BasicFilterSystem::setAllFilterStatesCmd, this, std::placeholders::_1), { cmd::ARGTYPE_INT });
@@ -271,6 +286,11 @@ XmlFilterEventAdapter::Ptr BasicFilterSystem::ensureEventAdapter(XMLFilter& filt
 // Shut down the Filters module, saving active filters to registry
 void BasicFilterSystem::shutdownModule()
 {
+	_materialsReloadedConn.disconnect();
+	_entityClassesReloadedConn.disconnect();
+
+	GlobalSceneGraph().removeSceneObserver(this);
+
 	// Remove the existing set of active filter nodes
 	GlobalRegistry().deleteXPath(RKEY_USER_ACTIVE_FILTERS);
 
@@ -324,6 +344,10 @@ void BasicFilterSystem::shutdownModule()
 	}
 
 	_visibilityCache.clear();
+	_activeMask.clear();
+	_activeKeyValueFilters.clear();
+	_queuedNodes.clear();
+	_queuedNodeIndices.clear();
 	_eventAdapters.clear();
 	_activeFilters.clear();
 	_availableFilters.clear();
@@ -344,6 +368,10 @@ sigc::signal<void> BasicFilterSystem::filterCollectionChangedSignal() const
 
 void BasicFilterSystem::update()
 {
+	// The full update is covering the queued nodes
+	_queuedNodes.clear();
+	_queuedNodeIndices.clear();
+
 	// Update shaders first, so that nodes can judge whether they're hidden on basis of their texture
 	updateShaders();
 
@@ -389,9 +417,8 @@ void BasicFilterSystem::setFilterState(const std::string& filter, bool state)
 		_activeFilters.erase(filter);
 	}
 
-	// Invalidate the visibility cache to force new values to be
-	// loaded from the filters themselves
-	_visibilityCache.clear();
+	// The cached masks stay valid, only the active set has changed
+	updateActiveFilters();
 
 	// Update the scenegraph instances
 	update();
@@ -428,6 +455,9 @@ bool BasicFilterSystem::addFilter(const std::string& filterName, const FilterRul
 	// Create the event adapter
 	ensureEventAdapter(*filter);
 
+	// The new filter is shifting the indices of the ones sorted after it
+	invalidateVisibilityCache();
+
 	_filterCollectionChangedSignal.emit();
 
 	return true;
@@ -457,13 +487,13 @@ bool BasicFilterSystem::removeFilter(const std::string& filter)
 	// Now remove the object from the available filters too
 	_availableFilters.erase(f);
 
+	// The indices of the remaining filters are changing
+	invalidateVisibilityCache();
+
 	_filterCollectionChangedSignal.emit();
 
 	if (wasActive)
 	{
-		// Clear the cache, the rules have changed
-		_visibilityCache.clear();
-
 		_filterConfigChangedSignal.emit();
 
 		update();
@@ -530,6 +560,9 @@ bool BasicFilterSystem::renameFilter(const std::string& oldFilterName, const std
 	// Remove the old filter from the filtertable
 	_availableFilters.erase(oldFilterName);
 
+	// The filter might have moved to a different index
+	invalidateVisibilityCache();
+
 	_filterCollectionChangedSignal.emit();
 
 	return true;
@@ -538,56 +571,91 @@ bool BasicFilterSystem::renameFilter(const std::string& oldFilterName, const std
 // Query whether an item is visible or filtered out
 bool BasicFilterSystem::isVisible(const FilterRule::Type type, const std::string& name)
 {
-	// Check if this item is in the visibility cache, returning
-	// its cached value if found
-	auto cacheIter = _visibilityCache.find(name);
+	// The item is filtered if any of the active filters is hiding it
+	return !getHidingFilters(type, name).intersects(_activeMask);
+}
 
-	if (cacheIter != _visibilityCache.end())
+bool BasicFilterSystem::isEntityVisible(const FilterRule::Type type, const Entity& entity)
+{
+	if (type == FilterRule::TYPE_ENTITYCLASS)
 	{
-		return cacheIter->second;
+		// The entity class rules only depend on the class name
+		return isVisible(type, entity.getEntityClass()->getDeclName());
 	}
 
-	// Otherwise, walk the list of active filters to find a value for
-	// this item.
-	bool visFlag = true; // default if no filters modify it
+	if (type != FilterRule::TYPE_ENTITYKEYVALUE)
+	{
+		return true; // no other rule type is applied to entities
+	}
 
-	for (const auto& active : _activeFilters)
+	// Spawnarg rules can't be cached, but only a few filters have them
+	for (const auto& filter : _activeKeyValueFilters)
 	{
-		// Delegate the check to the filter object. If a filter returns
-		// false for the visibility check, then the item is filtered
-		// and we don't need any more checks.
-		if (!active.second->isVisible(type, name))
+		// If a filter returns false for the visibility check, then the item
+		// is filtered and we don't need any more checks.
+		if (!filter->isEntityVisible(type, entity))
 		{
-			visFlag = false;
-			break;
+			return false;
 		}
 	}
 
-	// Cache the result and return to caller
-	_visibilityCache.emplace(name, visFlag);
+	return true; // default if no filters modify it
+}
+
+const FilterMask& BasicFilterSystem::getHidingFilters(const FilterRule::Type type, const std::string& name)
+{
+	auto& cache = _visibilityCache[type];
+	auto found = cache.find(name);
+
+	if (found != cache.end())
+	{
+		return found->second;
+	}
+
+	// Evaluate the rules of all available filters, active or not
+	FilterMask mask;
+	std::size_t index = 0;
 
-	return visFlag;
+	for (const auto& [_, filter] : _availableFilters)
+	{
+		if (filter->hasRules(type) && !filter->isVisible(type, name))
+		{
+			mask.set(index);
+		}
+
+		++index;
+	}
+
+	return cache.emplace(name, std::move(mask)).first->second;
 }
 
-bool BasicFilterSystem::isEntityVisible(const FilterRule::Type type, const Entity& entity)
+void BasicFilterSystem::updateActiveFilters()
 {
-	// Otherwise, walk the list of active filters to find a value for
-	// this item.
-	bool visFlag = true; // default if no filters modify it
+	_activeMask.clear();
+	_activeKeyValueFilters.clear();
 
-	for (const auto& active : _activeFilters)
+	std::size_t index = 0;
+
+	for (const auto& [name, filter] : _availableFilters)
 	{
-		// Delegate the check to the filter object. If a filter returns
-		// false for the visibility check, then the item is filtered
-		// and we don't need any more checks.
-		if (!active.second->isEntityVisible(type, entity))
+		if (_activeFilters.count(name) > 0)
 		{
-			visFlag = false;
-			break;
+			_activeMask.set(index);
+
+			if (filter->hasRules(FilterRule::TYPE_ENTITYKEYVALUE))
+			{
+				_activeKeyValueFilters.push_back(filter);
+			}
 		}
+
+		++index;
 	}
+}
 
-	return visFlag;
+void BasicFilterSystem::invalidateVisibilityCache()
+{
+	_visibilityCache.clear();
+	updateActiveFilters();
 }
 
 FilterRules BasicFilterSystem::getRuleSet(const std::string& filter)
@@ -607,7 +675,7 @@ bool BasicFilterSystem::setFilterRules(const std::string& filter, const FilterRu
 		f->second->setRules(ruleSet);
 
 		// Clear the cache, the ruleset has changed
-		_visibilityCache.clear();
+		invalidateVisibilityCache();
 
 		_filterConfigChangedSignal.emit();
 
@@ -627,6 +695,48 @@ void BasicFilterSystem::updateSubgraph(const scene::INodePtr& root)
 	root->traverse(walker);
 }
 
+void BasicFilterSystem::queueUpdate(const scene::INodePtr& node)
+{
+	auto existing = _queuedNodeIndices.find(node.get());
+
+	if (existing == _queuedNodeIndices.end())
+	{
+		_queuedNodeIndices.emplace(node.get(), _queuedNodes.size());
+		_queuedNodes.emplace_back(node);
+		return;
+	}
+
+	// The queued node might have been destroyed and its address been reused
+	_queuedNodes[existing->second] = node;
+}
+
+void BasicFilterSystem::processQueuedUpdates()
+{
+	if (_queuedNodes.empty()) return;
+
+	// Swap the queue out, in case a node is queued again during the update
+	std::vector<scene::INodeWeakPtr> queuedNodes;
+	queuedNodes.swap(_queuedNodes);
+	_queuedNodeIndices.clear();
+
+	InstanceUpdateWalker walker(*this);
+
+	for (const auto& weakNode : queuedNodes)
+	{
+		auto node = weakNode.lock();
+
+		// Skip the nodes which have been removed in the meantime
+		if (!node || !node->inScene()) continue;
+
+		walker.updateNode(node);
+	}
+}
+
+void BasicFilterSystem::onSceneNodeInsert(const scene::INodePtr& node)
+{
+	queueUpdate(node);
+}
+
 // Update scenegraph instances with filtered status
 void BasicFilterSystem::updateScene()
 {
@@ -670,6 +780,8 @@ const StringSet& BasicFilterSystem::getDependencies() const
 		_dependencies.insert(MODULE_XMLREGISTRY);
 		_dependencies.insert(MODULE_GAMEMANAGER);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
+		_dependencies.insert(MODULE_DECLMANAGER);
+		_dependencies.insert(MODULE_SCENEGRAPH);
 	}
 
 	return _dependencies;
@@ -3,13 +3,17 @@
 #include "imodule.h"
 #include "ifilter.h"
 #include "icommandsystem.h"
+#include "iscenegraph.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <iostream>
+#include <sigc++/connection.h>
 
 #include "xmlutil/Node.h"
+#include "FilterMask.h"
 #include "XMLFilter.h"
 #include "XmlFilterEventAdapter.h"
 
@@ -19,7 +23,8 @@ namespace filters
 /** FilterSystem implementation class.
  */
 class BasicFilterSystem : 
-	public IFilterSystem
+	public IFilterSystem,
+	public scene::Graph::Observer
 {
 private:
 	// Hashtable of available filters, indexed by name
@@ -29,10 +34,25 @@ private:
 	// Second table containing just the active filters
 	FilterTable _activeFilters;
 
-	// Cache of visibility flags for item names, to avoid having to
-	// traverse the active filter list for each lookup
-	typedef std::map<std::string, bool> StringFlagCache;
-	StringFlagCache _visibilityCache;
+	// The filters hiding an item, per rule type and item name. The masks are
+	// referring to the available filters, such that toggling a filter doesn't
+	// need to evaluate the rules again, it's a single test against _activeMask.
+	typedef std::unordered_map<std::string, FilterMask> FilterMaskCache;
+	std::map<FilterRule::Type, FilterMaskCache> _visibilityCache;
+
+	// The indices of the active filters among the available ones
+	FilterMask _activeMask;
+
+	// The active filters having rules depending on the entity spawnargs,
+	// these can't be cached by name
+	std::vector<XMLFilter::Ptr> _activeKeyValueFilters;
+
+	// Nodes waiting to be re-evaluated, in the order they have been queued
+	std::vector<scene::INodeWeakPtr> _queuedNodes;
+	std::unordered_map<scene::INode*, std::size_t> _queuedNodeIndices;
+
+	sigc::connection _materialsReloadedConn;
+	sigc::connection _entityClassesReloadedConn;
 
     sigc::signal<void> _filterConfigChangedSignal;
     sigc::signal<void> _filterCollectionChangedSignal;
@@ -48,6 +68,16 @@ private:
 
 	void updateShaders();
 
+	// Refresh the active filter mask after the set of active filters has changed
+	void updateActiveFilters();
+
+	// Clear the cached masks and refresh the active filter mask, needs to be
+	// called when filters are added, removed, renamed or their rules are changing
+	void invalidateVisibilityCache();
+
+	// Returns the mask of the available filters hiding the given item
+	const FilterMask& getHidingFilters(const FilterRule::Type type, const std::string& name);
+
 	void addFiltersFromXML(const xml::NodeList& nodes, bool readOnly);
 
 	XmlFilterEventAdapter::Ptr ensureEventAdapter(XMLFilter& filter);
@@ -72,6 +102,12 @@ public:
 	// Updates the given subgraph
 	void updateSubgraph(const scene::INodePtr& root) override;
 
+	void queueUpdate(const scene::INodePtr& node) override;
+	void processQueuedUpdates() override;
+
+	// Graph::Observer implementation, queues the inserted nodes
+	void onSceneNodeInsert(const scene::INodePtr& node) override;
+
 	// Filter system visit function
 	void forEachFilter(const std::function<void(const std::string & name)>& func) override;
 
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace filters
+{
+
+/**
+ * Set of filters, each filter is identified by its index in the
+ * (name-sorted) list of available filters.
+ */
+class FilterMask
+{
+private:
+	static constexpr std::size_t BITS_PER_BLOCK = 64;
+
+	std::vector<std::uint64_t> _blocks;
+
+public:
+	void set(std::size_t index)
+	{
+		auto block = index / BITS_PER_BLOCK;
+
+		if (block >= _blocks.size())
+		{
+			_blocks.resize(block + 1, 0);
+		}
+
+		_blocks[block] |= std::uint64_t(1) << (index % BITS_PER_BLOCK);
+	}
+
+	// Returns true if any filter is contained in both masks
+	bool intersects(const FilterMask& other) const
+	{
+		auto numBlocks = std::min(_blocks.size(), other._blocks.size());
+
+		for (std::size_t i = 0; i < numBlocks; ++i)
+		{
+			if (_blocks[i] & other._blocks[i]) return true;
+		}
+
+		return false;
+	}
+
+	void clear()
+	{
+		_blocks.clear();
+	}
+};
+
+}
@@ -106,6 +106,30 @@ public:
 		return true;
 	}
 
+	/**
+	 * Re-evaluates a single node. The subgraph below is only visited if the node
+	 * is not an entity, or an entity changing its filtered status.
+	 */
+	void updateNode(const scene::INodePtr& node)
+	{
+		auto parent = node->getParent();
+
+		// Nodes are hidden along with their parent entity
+		if (parent && parent->isFiltered())
+		{
+			setSubgraphFilterStatus(node, false);
+			return;
+		}
+
+		// The children of entities don't depend on the entity's spawnargs
+		if (Node_isEntity(node) && evaluateEntity(node) != node->isFiltered())
+		{
+			return;
+		}
+
+		node->traverse(*this);
+	}
+
 private:
 	bool evaluateEntity(const scene::INodePtr& node)
 	{
@@ -25,24 +25,19 @@ bool XMLFilter::isVisible(const FilterRule::Type type, const std::string& name)
 
 	bool visible = true; // default if unmodified by rules
 
-	for (FilterRules::const_iterator ruleIter = _rules.begin();
-		 ruleIter != _rules.end();
-		 ++ruleIter)
+	for (std::size_t i = 0; i < _rules.size(); ++i)
 	{
 		// Check the item type.
-		if (ruleIter->type != type)
+		if (_rules[i].type != type)
 		{
 			continue;
 		}
 
-		// If we have a rule for this item, use a regex to match the query name
-		// against the "match" parameter
-		std::regex ex(ruleIter->match);
-
-		if (std::regex_match(name, ex))
+		// If we have a rule for this item, use its regex to match the query name
+		if (std::regex_match(name, _expressions[i]))
 		{
 			// Overwrite the visible flag with the value from the rule.
-			visible = ruleIter->show;
+			visible = _rules[i].show;
 		}
 	}
 
@@ -56,31 +51,27 @@ bool XMLFilter::isEntityVisible(const FilterRule::Type type, const Entity& entit
 
 	IEntityClassConstPtr eclass = entity.getEntityClass();
 	
-	for (FilterRules::const_iterator ruleIter = _rules.begin();
-		 ruleIter != _rules.end();
-		 ++ruleIter)
+	for (std::size_t i = 0; i < _rules.size(); ++i)
 	{
-		if (ruleIter->type != type)
+		const auto& rule = _rules[i];
+
+		if (rule.type != type)
 		{
 			continue;
 		}
 
 		if (type == FilterRule::TYPE_ENTITYCLASS)
 		{
-			std::regex ex(ruleIter->match);
-
-			if (std::regex_match(eclass->getDeclName(), ex))
+			if (std::regex_match(eclass->getDeclName(), _expressions[i]))
 			{
-				visible = ruleIter->show;
+				visible = rule.show;
 			}
 		}
 		else if (type == FilterRule::TYPE_ENTITYKEYVALUE)
 		{
-			std::regex ex(ruleIter->match);
-
-			if (std::regex_match(entity.getKeyValue(ruleIter->entityKey), ex))
+			if (std::regex_match(entity.getKeyValue(rule.entityKey), _expressions[i]))
 			{
-				visible = ruleIter->show;
+				visible = rule.show;
 			}
 		}
 	}
@@ -114,8 +105,24 @@ const FilterRules& XMLFilter::getRuleSet() const
 	return _rules;
 }
 
+bool XMLFilter::hasRules(const FilterRule::Type type) const
+{
+	return std::any_of(_rules.begin(), _rules.end(), [&](const FilterRule& rule)
+	{
+		return rule.type == type;
+	});
+}
+
 void XMLFilter::setRules(const FilterRules& rules) {
 	_rules = rules;
+
+	_expressions.clear();
+	_expressions.reserve(_rules.size());
+
+	for (const auto& rule : _rules)
+	{
+		_expressions.emplace_back(rule.match);
+	}
 }
 
 void XMLFilter::updateEventName() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <regex>
 #include <string>
 #include <vector>
 #include "ifilter.h"
@@ -24,6 +25,9 @@ private:
 	// Ordered list of rule objects
 	FilterRules _rules;
 
+	// The compiled match expression of each rule, using the same index as _rules
+	std::vector<std::regex> _expressions;
+
 	// True if this filter can't be changed
 	bool _readonly;
 
@@ -55,6 +59,7 @@ public:
 	void addRule(const FilterRule::Type type, const std::string& match, bool show)
 	{
 		_rules.push_back(FilterRule::Create(type, match, show));
+		_expressions.emplace_back(match);
 	}
 
 	/** Add an entitykeyvalue rule to this filter.
@@ -72,6 +77,7 @@ public:
 	void addEntityKeyValueRule(const std::string& key, const std::string& match, bool show)
 	{
 		_rules.push_back(FilterRule::CreateEntityKeyValueRule(key, match, show));
+		_expressions.emplace_back(match);
 	}
 
 	/** Test a given item for visibility against all of the rules
@@ -116,6 +122,9 @@ public:
 	// Returns the ruleset
 	const FilterRules& getRuleSet() const;
 
+	// Returns true if any rule of this filter applies to the given type
+	bool hasRules(const FilterRule::Type type) const;
+
 	// Applies the given ruleset, replacing the existing one.
 	void setRules(const FilterRules& rules);
 
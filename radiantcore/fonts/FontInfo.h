@@ -1,7 +1,10 @@
+#pragma once
+
 #include "ifonts.h"
 
 #include "GlyphSet.h"
 #include <memory>
+#include <mutex>
 
 namespace fonts
 {
@@ -9,18 +12,29 @@ namespace fonts
 /**
  * Holds information about one specific font.
  * A font consists of one to several resolutions.
+ *
+ * The font loader only registers the DAT file of each resolution,
+ * the glyph sets are loaded when they are requested the first time.
  */
 class FontInfo :
 	public IFontInfo
 {
+private:
+	// The DAT files of each resolution, empty if the resolution is not available
+	std::string _datFiles[NumResolutions];
+
+	// Three sets of glyphs, one for each resolution
+	GlyphSetPtr _glyphSets[NumResolutions];
+	bool _glyphSetLoaded[NumResolutions];
+
+	std::mutex _lock;
+
 public:
 	std::string name;		// The name of the font, e.g. "carleton"
 	std::string language;	// The language of this font
 
-	// Three sets of glyphs, one for each resolution
-	GlyphSetPtr glyphSets[NumResolutions];
-
 	FontInfo(const std::string& name_, const std::string& language_) :
+		_glyphSetLoaded{ false, false, false },
 		name(name_),
 		language(language_)
 	{}
@@ -36,10 +50,34 @@ public:
 		return language;
 	}
 
-	// Returns the glyphset for the specified resolution
+	// Registers the DAT file to load the glyphs of the given resolution from
+	void setDatFile(Resolution resolution, const std::string& vfsPath)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+
+		_datFiles[resolution] = vfsPath;
+		_glyphSets[resolution].reset();
+		_glyphSetLoaded[resolution] = false;
+	}
+
+	// Returns the glyphset for the specified resolution, loading it if necessary
 	IGlyphSetPtr getGlyphSet(Resolution resolution)
 	{
-		return glyphSets[resolution];
+		std::lock_guard<std::mutex> lock(_lock);
+
+		if (!_glyphSetLoaded[resolution])
+		{
+			_glyphSetLoaded[resolution] = true;
+
+			if (!_datFiles[resolution].empty())
+			{
+				_glyphSets[resolution] = GlyphSet::createFromDatFile(
+					_datFiles[resolution], name, language, resolution
+				);
+			}
+		}
+
+		return _glyphSets[resolution];
 	}
 };
 typedef std::shared_ptr<FontInfo> FontInfoPtr;
@@ -61,10 +61,8 @@ void FontLoader::loadFont(const vfs::FileInfo& fileInfo)
 			// Create the font (if not done yet), acquire the info structure
 			auto font = _manager.findOrCreateFontInfo(fontname);
 
-			// Load the DAT file and create the glyph info
-			font->glyphSets[resolution] = GlyphSet::createFromDatFile(
-				fullPath, fontname, _manager.getCurLanguage(), resolution
-			);
+			// The DAT file is loaded when the glyphs are requested the first time
+			font->setDatFile(resolution, fullPath);
 		}
 		else
 		{
@@ -44,6 +44,12 @@ void FontManager::initialiseModule(const IApplicationContext& ctx)
     _loader->start();
 }
 
+bool FontManager::canInitialiseOnWorkerThread() const
+{
+    // Initialisation is just starting the loader
+    return true;
+}
+
 void FontManager::shutdownModule()
 {
     _loader->reset();
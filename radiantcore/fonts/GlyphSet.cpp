@@ -55,6 +55,12 @@ GlyphSetPtr GlyphSet::createFromDatFile(const std::string& vfsPath,
 {
 	ArchiveFilePtr file = GlobalFileSystem().openFile(vfsPath);
 
+	if (!file)
+	{
+		rWarning() << "FontLoader: cannot open " << vfsPath << std::endl;
+		return GlyphSetPtr();
+	}
+
 	// Check file size
 	if (file->size() != sizeof(q3font::Q3FontInfo))
 	{
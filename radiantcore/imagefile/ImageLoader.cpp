@@ -10,6 +10,11 @@
 #include "iregistry.h"
 #include "igame.h"
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <thread>
+
 #include "string/case_conv.h"
 
 #include "os/path.h"
@@ -95,6 +100,62 @@ ImagePtr ImageLoader::imageFromVFS(const std::string& rawName) const
 	return ImagePtr();
 }
 
+std::string ImageLoader::findImageInVFS(const std::string& rawName) const
+{
+    auto name = os::standardPath(rawName).substr(0, rawName.rfind("."));
+
+    // Same search order as in imageFromVFS()
+    for (const auto& extension : _extensions)
+    {
+        auto loaderIter = _loadersByExtension.find(extension);
+
+        if (loaderIter == _loadersByExtension.end()) continue;
+
+        auto fullName = loaderIter->second->getPrefix() + name + "." + extension;
+
+        if (GlobalFileSystem().getFileCount(fullName) > 0)
+        {
+            return fullName;
+        }
+    }
+
+    return std::string();
+}
+
+std::vector<ImagePtr> ImageLoader::imagesFromVFS(const std::vector<std::string>& vfsPaths) const
+{
+    std::vector<ImagePtr> images(vfsPaths.size());
+    std::atomic<std::size_t> nextImage(0);
+
+    // The loaders don't share any state, each worker is picking the next image in the list
+    auto worker = [&]()
+    {
+        for (auto i = nextImage++; i < vfsPaths.size(); i = nextImage++)
+        {
+            images[i] = imageFromVFS(vfsPaths[i]);
+        }
+    };
+
+    auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), vfsPaths.size());
+
+    std::vector<std::future<void>> workers;
+
+    for (std::size_t i = 1; i < numWorkers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+
+    // The calling thread is decoding its share too
+    worker();
+
+    for (auto& result : workers)
+    {
+        result.get();
+    }
+
+    return images;
+}
+
 ImagePtr ImageLoader::imageFromFile(const std::string& filename) const
 {
     ImagePtr image;
@@ -154,6 +215,12 @@ void ImageLoader::initialiseModule(const IApplicationContext&)
     }
 }
 
+bool ImageLoader::canInitialiseOnWorkerThread() const
+{
+    // Only reading from the game file
+    return true;
+}
+
 // Static module instance
 module::StaticModuleRegistration<ImageLoader> imageLoaderModule;
 
@@ -30,12 +30,15 @@ public:
 
     // ImageLoader implementation
     ImagePtr imageFromVFS(const std::string& vfsPath) const override;
+    std::string findImageInVFS(const std::string& vfsPath) const override;
+    std::vector<ImagePtr> imagesFromVFS(const std::vector<std::string>& vfsPaths) const override;
 	ImagePtr imageFromFile(const std::string& filename) const override;
 
     // RegisterableModule implementation
     const std::string& getName() const override;
     const StringSet& getDependencies() const override;
     void initialiseModule(const IApplicationContext&) override;
+    bool canInitialiseOnWorkerThread() const override;
 };
 
 }
@@ -213,19 +213,18 @@ static void jpeg_buffer_src(j_decompress_ptr cinfo, void* buffer, int bufsize)
 
 // =============================================================================
 
-static char errormsg[JMSG_LENGTH_MAX];
-
 typedef struct my_jpeg_error_mgr
 {
     struct jpeg_error_mgr pub;  // "public" fields
     jmp_buf setjmp_buffer;      // for return to caller
+    char errormsg[JMSG_LENGTH_MAX]; // per decoder, images are decoded in parallel
 } bt_jpeg_error_mgr;
 
 static void my_jpeg_error_exit(j_common_ptr cinfo)
 {
     my_jpeg_error_mgr* myerr = (bt_jpeg_error_mgr*)cinfo->err;
 
-    (*cinfo->err->format_message) (cinfo, errormsg);
+    (*cinfo->err->format_message) (cinfo, myerr->errormsg);
 
     longjmp(myerr->setjmp_buffer, 1);
 }
@@ -326,7 +325,7 @@ static image::RGBAImagePtr LoadJPGBuff_(const void* src_buffer, int src_size)
 
     if (setjmp(jerr.setjmp_buffer)) //< TODO: use c++ exceptions instead of setjmp/longjmp to handle errors
     {
-        rError() << "WARNING: JPEG library error: " << errormsg << "\n";
+        rError() << "WARNING: JPEG library error: " << jerr.errormsg << "\n";
         jpeg_destroy_decompress(&cinfo);
         return {};
     }
@@ -334,12 +333,42 @@ static image::RGBAImagePtr LoadJPGBuff_(const void* src_buffer, int src_size)
     jpeg_create_decompress(&cinfo);
     jpeg_buffer_src(&cinfo, const_cast<void*>(src_buffer), src_size);
     jpeg_read_header(&cinfo, TRUE);
-    jpeg_start_decompress(&cinfo);
 
-    int row_stride = cinfo.output_width * cinfo.output_components;
+    bool decodeToRGBA = false;
+
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo is able to write RGBA scanlines itself, using its SIMD colour conversion
+    if (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_RGB ||
+        cinfo.jpeg_color_space == JCS_GRAYSCALE)
+    {
+        cinfo.out_color_space = JCS_EXT_RGBA;
+        decodeToRGBA = true;
+    }
+#endif
+
+    jpeg_start_decompress(&cinfo);
 
     image::RGBAImagePtr image(new image::RGBAImage(cinfo.output_width, cinfo.output_height));
 
+    if (decodeToRGBA)
+    {
+        // Decode straight into the image, no per-pixel copy needed
+        auto rowSize = static_cast<std::size_t>(cinfo.output_width) * 4;
+
+        while (cinfo.output_scanline < cinfo.output_height)
+        {
+            JSAMPROW row = image->getPixels() + cinfo.output_scanline * rowSize;
+            jpeg_read_scanlines(&cinfo, &row, 1);
+        }
+
+        jpeg_finish_decompress(&cinfo);
+        jpeg_destroy_decompress(&cinfo);
+
+        return image;
+    }
+
+    int row_stride = cinfo.output_width * cinfo.output_components;
+
     JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray) ((j_common_ptr)&cinfo, JPOOL_IMAGE, row_stride, 1);
 
     while (cinfo.output_scanline < cinfo.output_height)
@@ -96,13 +96,6 @@ void image_decode(stream::PointerInputStream& istream, PixelDecoder& decode, RGB
   }
 }
 
-inline void istream_read_gray(stream::PointerInputStream& istream, RGBAPixel& pixel)
-{
-  istream.read(&pixel.blue, 1);
-  pixel.red = pixel.green = pixel.blue;
-  pixel.alpha = 0xff;
-}
-
 inline void istream_read_rgb(stream::PointerInputStream& istream, RGBAPixel& pixel)
 {
   istream.read(&pixel.blue, 1);
@@ -119,52 +112,59 @@ inline void istream_read_rgba(stream::PointerInputStream& istream, RGBAPixel& pi
   istream.read(&pixel.alpha, 1);
 }
 
-class TargaDecodeGrayPixel
+// Whether the first row in the file is the bottom row of the image
+inline bool targa_rows_bottom_up(const Flip00&) { return true; }
+inline bool targa_rows_bottom_up(const Flip01&) { return false; }
+inline bool targa_rows_bottom_up(const Flip10&) { return true; }
+inline bool targa_rows_bottom_up(const Flip11&) { return false; }
+
+// Whether the pixels in each row are stored right to left
+inline bool targa_rows_mirrored(const Flip00&) { return false; }
+inline bool targa_rows_mirrored(const Flip01&) { return false; }
+inline bool targa_rows_mirrored(const Flip10&) { return true; }
+inline bool targa_rows_mirrored(const Flip11&) { return true; }
+
+// Converts a row of uncompressed grey, BGR or BGRA pixels to RGBA
+template<std::size_t BytesPerPixel>
+void targa_convert_row(const byte* in, RGBAPixel* out, std::size_t width, bool mirrored)
 {
-public:
-  void operator()(stream::PointerInputStream& istream, RGBAPixel& pixel)
-  {
-    istream_read_gray(istream, pixel);
-  }
-};
+  // Mirrored rows are written backwards, starting at the last pixel
+  std::ptrdiff_t step = mirrored ? -1 : 1;
+  RGBAPixel* pixel = mirrored ? out + width - 1 : out;
 
-template<typename Flip>
-void targa_decode_grayscale(stream::PointerInputStream& istream, RGBAImage& image, const Flip& flip)
-{
-  TargaDecodeGrayPixel decode;
-  image_decode(istream, decode, image, flip);
-}
-
-class TargaDecodeRGBPixel
-{
-public:
-  void operator()(stream::PointerInputStream& istream, RGBAPixel& pixel)
+  for (std::size_t x = 0; x < width; ++x, in += BytesPerPixel, pixel += step)
   {
-    istream_read_rgb(istream, pixel);
+    if constexpr (BytesPerPixel == 1)
+    {
+      pixel->red = pixel->green = pixel->blue = in[0];
+      pixel->alpha = 0xff;
+    }
+    else
+    {
+      pixel->red = in[2];
+      pixel->green = in[1];
+      pixel->blue = in[0];
+      pixel->alpha = BytesPerPixel == 4 ? in[3] : 0xff;
+    }
   }
-};
-
-template<typename Flip>
-void targa_decode_rgb(stream::PointerInputStream& istream, RGBAImage& image, const Flip& flip)
-{
-  TargaDecodeRGBPixel decode;
-  image_decode(istream, decode, image, flip);
 }
 
-class TargaDecodeRGBAPixel
+// Decodes uncompressed pixel data a row at a time, instead of reading each component from the stream
+template<std::size_t BytesPerPixel, typename Flip>
+void targa_decode_uncompressed(stream::PointerInputStream& istream, RGBAImage& image, const Flip& flip)
 {
-public:
-  void operator()(stream::PointerInputStream& istream, RGBAPixel& pixel)
+  auto width = image.getWidth();
+  auto height = image.getHeight();
+  auto bottomUp = targa_rows_bottom_up(flip);
+  auto mirrored = targa_rows_mirrored(flip);
+
+  for (std::size_t y = 0; y < height; ++y)
   {
-    istream_read_rgba(istream, pixel);
-  }
-};
+    auto row = image.pixels + (bottomUp ? height - 1 - y : y) * width;
 
-template<typename Flip>
-void targa_decode_rgba(stream::PointerInputStream& istream, RGBAImage& image, const Flip& flip)
-{
-  TargaDecodeRGBAPixel decode;
-  image_decode(istream, decode, image, flip);
+    targa_convert_row<BytesPerPixel>(istream.get(), row, width, mirrored);
+    istream.seek(width * BytesPerPixel);
+  }
 }
 
 typedef byte TargaPacket;
@@ -331,13 +331,13 @@ RGBAImagePtr Targa_decodeImageData(const TargaHeader& targa_header, stream::Poin
     switch (targa_header.pixel_size)
     {
     case 8:
-      targa_decode_grayscale(istream, *image, flip);
+      targa_decode_uncompressed<1>(istream, *image, flip);
       break;
     case 24:
-      targa_decode_rgb(istream, *image, flip);
+      targa_decode_uncompressed<3>(istream, *image, flip);
       break;
     case 32:
-      targa_decode_rgba(istream, *image, flip);
+      targa_decode_uncompressed<4>(istream, *image, flip);
       break;
     default:
       rError() << "LoadTGA: illegal pixel_size '" << targa_header.pixel_size << "'\n";
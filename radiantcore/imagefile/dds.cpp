@@ -23,6 +23,7 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <stdlib.h>
 #include <algorithm>
+#include <cstring>
 #include <map>
 
 #include "ifilesystem.h"
@@ -54,11 +55,15 @@ struct MipMapInfo
 typedef std::vector<MipMapInfo> MipMapInfoList;
 
 // Image subclass for DDS images
-class DDSImage: public Image, public util::Noncopyable
+class DDSImage: public Image, public ProgressiveBindableTexture, public util::Noncopyable
 {
     // The actual pixels
     mutable std::vector<uint8_t> _pixelData;
 
+    // Compressed images loaded from a memory-mapped archive refer to the file
+    // data instead of a copy in _pixelData. This keeps the mapping alive.
+    std::shared_ptr<const uint8_t> _mappedData;
+
     // The GL format of the texture data, and a boolean flag to indicate if we
     // need to upload with glCompressedTexImage2D rather than glTexImage2D
     GLenum _format = 0;
@@ -74,6 +79,12 @@ public:
     DDSImage(std::size_t size): _pixelData(size)
     {}
 
+    // Construct an image referring to the given data, the mipmaps are not copied
+    DDSImage(const std::shared_ptr<const uint8_t>& mappedData, const MipMapInfoList& mipMapInfo) :
+        _mappedData(mappedData),
+        _mipMapInfo(mipMapInfo)
+    {}
+
     // Set the compression format
     void setFormat(GLenum format, bool compressed)
     {
@@ -94,7 +105,12 @@ public:
     }
 
     /* Image implementation */
-    uint8_t* getPixels() const override { return _pixelData.data(); }
+    uint8_t* getPixels() const override
+    {
+        // Mapped data is only used for precompressed images, which are
+        // never handed to the image manipulation functions
+        return _mappedData ? const_cast<uint8_t*>(_mappedData.get()) : _pixelData.data();
+    }
     std::size_t getWidth(std::size_t level = 0) const override
     {
         return _mipMapInfo[level].width;
@@ -124,43 +140,21 @@ public:
         {
             const MipMapInfo& mipMap = _mipMapInfo[i];
 
-            if (_compressed)
-            {
-                glCompressedTexImage2D(
-                    GL_TEXTURE_2D, static_cast<GLint>(i), _format,
-                    static_cast<GLsizei>(mipMap.width),
-                    static_cast<GLsizei>(mipMap.height),
-                    0, static_cast<GLsizei>(mipMap.size),
-                    _pixelData.data() + mipMap.offset
-                );
-
-                // If the upload failed but this is not level 0, we can fall
-                // back to regenerating the mipmaps.
-                if (debug::checkGLErrors("uploading DDS mipmap") != GL_NO_ERROR
-                    && i > 0)
-                {
-                    rWarning() << "DDSImage: failed to upload mipmap " << (i+1)
-                               << " of " << _mipMapInfo.size()
-                               << " [" << mipMap.width << "x" << mipMap.height << "],"
-                               << " regenerating mipmaps.\n";
-                    glGenerateMipmap(GL_TEXTURE_2D);
-
-                    // Don't process any more mipmaps
-                    break;
-                }
-            }
-            else
+            uploadMipMap(i);
+
+            // If the upload of a compressed mipmap failed but this is not
+            // level 0, we can fall back to regenerating the mipmaps.
+            if (_compressed && debug::checkGLErrors("uploading DDS mipmap") != GL_NO_ERROR
+                && i > 0)
             {
-                // For uncompressed textures the format specifies the layout in
-                // memory, not the internal format we want OpenGL to use (which
-                // is always GL_RGB).
-                glTexImage2D(
-                    GL_TEXTURE_2D, static_cast<GLint>(i), GL_RGB,
-                    static_cast<GLsizei>(mipMap.width),
-                    static_cast<GLsizei>(mipMap.height),
-                    0, _format, GL_UNSIGNED_BYTE,
-                    _pixelData.data() + mipMap.offset
-                );
+                rWarning() << "DDSImage: failed to upload mipmap " << (i+1)
+                           << " of " << _mipMapInfo.size()
+                           << " [" << mipMap.width << "x" << mipMap.height << "],"
+                           << " regenerating mipmaps.\n";
+                glGenerateMipmap(GL_TEXTURE_2D);
+
+                // Don't process any more mipmaps
+                break;
             }
 
             // Handle unsupported format error
@@ -191,6 +185,97 @@ public:
 
         return texObj;
     }
+
+    /* ProgressiveBindableTexture implementation */
+    TexturePtr createProgressiveTexture(const std::string& name) const override
+    {
+        GLuint textureNum;
+        glGenTextures(1, &textureNum);
+        glBindTexture(GL_TEXTURE_2D, textureNum);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        // The base level is lowered with each uploaded mipmap
+        auto lastLevel = static_cast<GLint>(_mipMapInfo.size() - 1);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, lastLevel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lastLevel);
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        auto texObj = std::make_shared<BasicTexture2D>(textureNum, name);
+        texObj->setWidth(getWidth());
+        texObj->setHeight(getHeight());
+        texObj->setLevelsPending(true);
+
+        return texObj;
+    }
+
+    bool uploadLevel(const TexturePtr& texture, std::size_t level) const override
+    {
+        debug::checkGLErrors("before uploading DDS mipmap");
+
+        glBindTexture(GL_TEXTURE_2D, texture->getGLTexNum());
+
+        uploadMipMap(level);
+        auto error = debug::checkGLErrors("uploading DDS mipmap");
+
+        if (error == GL_NO_ERROR)
+        {
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+        }
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if (error != GL_NO_ERROR)
+        {
+            rWarning() << "DDSImage: failed to upload mipmap " << (level + 1)
+                       << " of " << _mipMapInfo.size() << " of texture "
+                       << texture->getName() << std::endl;
+            return false;
+        }
+
+        if (level == 0)
+        {
+            if (auto texObj = std::dynamic_pointer_cast<BasicTexture2D>(texture); texObj)
+            {
+                texObj->setLevelsPending(false);
+            }
+        }
+
+        return true;
+    }
+
+private:
+    // Uploads the given mipmap level into the currently bound texture
+    void uploadMipMap(std::size_t level) const
+    {
+        const MipMapInfo& mipMap = _mipMapInfo[level];
+
+        if (_compressed)
+        {
+            glCompressedTexImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(level), _format,
+                static_cast<GLsizei>(mipMap.width),
+                static_cast<GLsizei>(mipMap.height),
+                0, static_cast<GLsizei>(mipMap.size),
+                getPixels() + mipMap.offset
+            );
+        }
+        else
+        {
+            // For uncompressed textures the format specifies the layout in
+            // memory, not the internal format we want OpenGL to use (which
+            // is always GL_RGB).
+            glTexImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGB,
+                static_cast<GLsizei>(mipMap.width),
+                static_cast<GLsizei>(mipMap.height),
+                0, _format, GL_UNSIGNED_BYTE,
+                getPixels() + mipMap.offset
+            );
+        }
+    }
 };
 typedef std::shared_ptr<DDSImage> DDSImagePtr;
 
@@ -210,18 +295,29 @@ static const std::map<int, GLenum> GL_FMT_FOR_BITDEPTH
     { 32, GL_BGRA }
 };
 
-DDSImagePtr LoadDDSFromStream(InputStream& stream)
+namespace
 {
-    // Load the header
-    typedef StreamBase::byte_type byteType;
-    DDSHeader header;
-    stream.read(reinterpret_cast<byteType*>(&header), sizeof(header));
 
+// The layout of the image data following the DDS header
+struct DDSLayout
+{
+    MipMapInfoList mipMapInfo;
+
+    // The size of all mipmaps in bytes
+    std::size_t size = 0;
+
+    GLenum format = 0;
+    bool compressed = true;
+};
+
+// Validates the header and calculates the mipmap layout, returns false on failure
+bool getLayoutFromHeader(const DDSHeader& header, DDSLayout& layout)
+{
     // Reject any invalid DDS structure
     if (!header.isValid())
     {
         rError() << "Invalid DDS header" << std::endl;
-        return {};
+        return false;
     }
 
     // Extract basic metadata: width, height, format and mipmap count
@@ -230,19 +326,31 @@ DDSImagePtr LoadDDSFromStream(InputStream& stream)
     int bitDepth = header.getRGBBits();
     std::size_t mipMapCount = header.getMipMapCount();
 
-    MipMapInfoList mipMapInfo;
-    mipMapInfo.resize(mipMapCount);
+    // Determine the format of this DDS image
+    if (GL_FMT_FOR_FOURCC.count(compressionFormat) == 1) {
+        layout.format = GL_FMT_FOR_FOURCC.at(compressionFormat);
+        layout.compressed = true;
+    }
+    else if (GL_FMT_FOR_BITDEPTH.count(bitDepth) == 1) {
+        layout.format = GL_FMT_FOR_BITDEPTH.at(bitDepth);
+        layout.compressed = false;
+    }
+    else {
+        rError() << "Unknown DDS format (" << compressionFormat << ")" << std::endl;
+        return false;
+    }
+
+    layout.mipMapInfo.resize(mipMapCount);
 
     // Calculate the total memory requirements (greebo: DXT1 has 8 bytes per block)
     std::size_t blockBytes = (compressionFormat == "DXT1") ? 8 : 16;
 
-    std::size_t size = 0;
     std::size_t offset = 0;
 
     for (std::size_t i = 0; i < mipMapCount; ++i)
     {
         // Create a new mipmap structure
-        MipMapInfo& mipMap = mipMapInfo[i];
+        MipMapInfo& mipMap = layout.mipMapInfo[i];
 
         mipMap.offset = offset;
         mipMap.width = width;
@@ -259,48 +367,141 @@ DDSImagePtr LoadDDSFromStream(InputStream& stream)
         // Update the offset for the next mipmap
         offset += mipMap.size;
 
-        // Increase the size counter
-        size += mipMap.size;
-
         // Go to the next mipmap
         width = std::max(width/2, 1);
         height = std::max(height/2, 1);
     }
 
-    // Allocate a new DDS image with that size
-    DDSImagePtr image(new DDSImage(size));
+    layout.size = offset;
 
-    // Set the format of this DDS image
-    if (GL_FMT_FOR_FOURCC.count(compressionFormat) == 1) {
-        image->setFormat(GL_FMT_FOR_FOURCC.at(compressionFormat), true);
-    }
-    else if (GL_FMT_FOR_BITDEPTH.count(bitDepth) == 1) {
-        image->setFormat(GL_FMT_FOR_BITDEPTH.at(bitDepth), false);
+    return true;
+}
+
+}
+
+ImagePtr LoadDDSFromStream(InputStream& stream)
+{
+    // Load the header
+    typedef StreamBase::byte_type byteType;
+    DDSHeader header;
+
+    if (stream.read(reinterpret_cast<byteType*>(&header), sizeof(header)) != sizeof(header))
+    {
+        rError() << "DDS file is too small to contain a header" << std::endl;
+        return {};
     }
-    else {
-        rError() << "Unknown DDS format (" << compressionFormat << ")" << std::endl;
+
+    DDSLayout layout;
+
+    if (!getLayoutFromHeader(header, layout))
+    {
         return {};
     }
 
+    // Allocate a new DDS image with that size
+    DDSImagePtr image(new DDSImage(layout.size));
+    image->setFormat(layout.format, layout.compressed);
+
     // Load the mipmaps into the allocated memory
-    for (std::size_t i = 0; i < mipMapInfo.size(); ++i)
+    for (const auto& mipMap : layout.mipMapInfo)
     {
-        // Appaned a new mipmap and store the offset
-        const MipMapInfo& mipMap = mipMapInfo[i];
+        // Append a new mipmap and store the offset
         uint8_t* mipMapBytes = image->addMipMap(mipMap);
 
         // Read the data into the DDSImage's memory
         std::size_t bytesRead = stream.read(
             reinterpret_cast<byteType*>(mipMapBytes), mipMap.size
         );
-        assert(bytesRead == mipMap.size);
+
+        if (bytesRead != mipMap.size)
+        {
+            rError() << "DDS file is truncated, expected " << layout.size
+                     << " bytes of image data" << std::endl;
+            return {};
+        }
     }
 
     return image;
 }
 
-ImagePtr LoadDDS(ArchiveFile& file) {
-    return LoadDDSFromStream(file.getInputStream());
+void WriteDDSToStream(std::ostream& stream, const std::string& fourCC, std::size_t width,
+    std::size_t height, const std::vector<std::vector<uint8_t>>& mipMaps)
+{
+    constexpr uint32_t DDSCAPS_COMPLEX = 0x8;
+    constexpr uint32_t DDSCAPS_TEXTURE = 0x1000;
+    constexpr uint32_t DDSCAPS_MIPMAP = 0x400000;
+
+    assert(fourCC.size() == 4 && !mipMaps.empty());
+
+    DDSHeader header = {};
+
+    std::copy(fourCC.begin(), fourCC.end(), header.pixelFormat.fourCC);
+    std::copy_n("DDS ", 4, header.magic);
+
+    header.size = 124;
+    header.flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE;
+    header.height = static_cast<uint32_t>(height);
+    header.width = static_cast<uint32_t>(width);
+    header.linearSize = static_cast<uint32_t>(mipMaps.front().size());
+    header.mipMapCount = static_cast<uint32_t>(mipMaps.size());
+    header.pixelFormat.size = 32;
+    header.pixelFormat.flags = DDPF_FOURCC;
+    header.ddsCaps.caps1 = DDSCAPS_TEXTURE | (mipMaps.size() > 1 ? DDSCAPS_COMPLEX | DDSCAPS_MIPMAP : 0);
+
+    stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const auto& mipMap : mipMaps)
+    {
+        stream.write(reinterpret_cast<const char*>(mipMap.data()), mipMap.size());
+    }
+}
+
+ImagePtr LoadDDS(ArchiveFile& file)
+{
+    auto mappedData = file.getMappedData();
+
+    // Files which are not mapped into memory are read into the image's buffer
+    if (!mappedData)
+    {
+        return LoadDDSFromStream(file.getInputStream());
+    }
+
+    DDSHeader header;
+
+    if (file.size() < sizeof(header))
+    {
+        rError() << "DDS file is too small to contain a header" << std::endl;
+        return {};
+    }
+
+    std::memcpy(&header, mappedData.get(), sizeof(header));
+
+    DDSLayout layout;
+
+    if (!getLayoutFromHeader(header, layout))
+    {
+        return {};
+    }
+
+    if (file.size() - sizeof(header) < layout.size)
+    {
+        rError() << "DDS file is truncated, expected " << layout.size
+                 << " bytes of image data" << std::endl;
+        return {};
+    }
+
+    // Uncompressed images might be manipulated, they need their own copy
+    if (!layout.compressed)
+    {
+        return LoadDDSFromStream(file.getInputStream());
+    }
+
+    // Compressed mipmaps are uploaded right from the mapped file
+    auto image = std::make_shared<DDSImage>(
+        std::shared_ptr<const uint8_t>(mappedData, mappedData.get() + sizeof(header)), layout.mipMapInfo);
+    image->setFormat(layout.format, layout.compressed);
+
+    return image;
 }
 
 ImagePtr DDSLoader::load(ArchiveFile& file) const
@@ -2,6 +2,11 @@
 
 #include "ImageTypeLoader.h"
 
+#include <ostream>
+#include <vector>
+
+class InputStream;
+
 namespace image
 {
 
@@ -23,4 +28,21 @@ public:
 	}
 };
 
+/// Load a DDS image from the given stream, returns an empty pointer on failure
+ImagePtr LoadDDSFromStream(InputStream& stream);
+
+/**
+ * \brief
+ * Write a block-compressed DDS image to the given stream.
+ *
+ * \param fourCC
+ * The compression format of the mipmap data, one of the formats understood
+ * by LoadDDSFromStream(), e.g. "DXT5".
+ *
+ * \param mipMaps
+ * The compressed data of each mipmap, starting with the full size image.
+ */
+void WriteDDSToStream(std::ostream& stream, const std::string& fourCC, std::size_t width,
+    std::size_t height, const std::vector<std::vector<uint8_t>>& mipMaps);
+
 }
@@ -107,7 +107,7 @@ void LayerInfoFileModule::saveNode(const INodePtr& node)
 {
 	// Don't export the layer settings for models and particles, as they are not there
 	// at map load/parse time - these shouldn't even be passed in here
-	assert(Node_isEntity(node) || Node_isPrimitive(node));
+	assert(Node_isEntity(node) || Node_isPrimitive(node) || Node_isUnloadedBlock(node));
 
 	// Open a Node block
 	_output << "\t\t" << NODE << " { ";
@@ -247,20 +247,21 @@ void LayerInfoFileModule::parseNodeToLayerMapping(parser::DefTokeniser& tok)
 	// The opening brace
 	tok.assertNextToken("{");
 
+	// There is a Node block for every entity and primitive, avoid copying the tokens
 	while (tok.hasMoreTokens())
 	{
-		std::string token = tok.nextToken();
+		auto token = tok.nextTokenView();
 
 		if (token == NODE)
 		{
 			tok.assertNextToken("{");
 
 			// Create a new LayerList
-			_layerMappings.push_back(scene::LayerList());
+			auto& layers = _layerMappings.emplace_back();
 
 			while (tok.hasMoreTokens())
 			{
-				std::string nodeToken = tok.nextToken();
+				auto nodeToken = tok.nextTokenView();
 
 				if (nodeToken == "}")
 				{
@@ -268,8 +269,10 @@ void LayerInfoFileModule::parseNodeToLayerMapping(parser::DefTokeniser& tok)
 				}
 
 				// Add the ID to the list
-				_layerMappings.back().insert(string::convert<int>(nodeToken));
+				layers.insert(string::parseInteger<int>(nodeToken));
 			}
+
+			continue;
 		}
 
 		if (token == "}")
@@ -407,7 +410,8 @@ void LayerInfoFileModule::applyInfoToScene(const IMapRootNodePtr& root, const ma
 	{
 		// To prevent all the support node types from getting layers assigned
 		// filter them out, only Entities and Primitives get mapped in the info file
-		if (Node_isEntity(node) || Node_isPrimitive(node))
+		// (including the placeholders of a partially loaded map)
+		if (Node_isEntity(node) || Node_isPrimitive(node) || Node_isUnloadedBlock(node))
 		{
 			// Check if the node index is out of bounds
 			if (mapping == _layerMappings.end())
@@ -446,4 +450,9 @@ void LayerInfoFileModule::onInfoFileLoadFinished()
 	clear();
 }
 
+const std::vector<scene::LayerList>& LayerInfoFileModule::getNodeLayerMappings() const
+{
+	return _layerMappings;
+}
+
 }
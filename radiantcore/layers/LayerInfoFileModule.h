@@ -50,6 +50,10 @@ public:
 	void applyInfoToScene(const IMapRootNodePtr& root, const map::NodeIndexMap& nodeMap) override;
 	void onInfoFileLoadFinished() override;
 
+	// The parsed layers of each entity and primitive, in the order of the map file.
+	// Available after parsing, until the module is cleared by onInfoFileLoadFinished()
+	const std::vector<scene::LayerList>& getNodeLayerMappings() const;
+
 private:
 	void saveNode(const INodePtr& node);
 	void clear();
@@ -54,12 +54,11 @@ int LayerManager::createLayer(const std::string& name, int layerID)
 	// Update the visibility cache, so get the highest ID
 	int highestID = getHighestLayerID();
 
-	// Make sure the vectors are large enough
-	_layerVisibility.resize(highestID+1);
+	// Make sure the vector is large enough
 	_layerParentIds.resize(highestID+1);
 
 	// Set the newly created layer to "visible"
-	_layerVisibility[layerID] = true;
+	_visibleLayers.set(layerID);
     _layerParentIds[layerID] = NO_PARENT_ID;
 
 	// Layers have changed
@@ -105,14 +104,18 @@ void LayerManager::deleteLayer(const std::string& name)
     }
 
 	// Remove all nodes from this layer first, but don't de-select them yet
-	RemoveFromLayerWalker walker(layerID);
-	_rootNode.traverse(walker);
+	auto members = getLayerMembers({ layerID });
+
+	for (const auto& node : members)
+	{
+		node->removeFromLayer(layerID);
+	}
 
 	// Remove the layer
 	_layers.erase(layerID);
 
 	// Reset the visibility flag to TRUE, remove parent
-	_layerVisibility[layerID] = true;
+	_visibleLayers.set(layerID);
 	_layerParentIds[layerID] = NO_PARENT_ID;
 
 	if (layerID == _activeLayer)
@@ -125,8 +128,10 @@ void LayerManager::deleteLayer(const std::string& name)
 	onLayersChanged();
 
 	// Nodes might have switched to default, fire the visibility 
-	// changed event, update the scenegraph and redraw the views
-	onNodeMembershipChanged();
+	// changed event, update the former members and redraw the views
+	_nodeMembershipChangedSignal.emit();
+
+	updateVisibilityOfNodes(members);
 }
 
 void LayerManager::foreachLayer(const LayerVisitFunc& visitor)
@@ -144,8 +149,8 @@ void LayerManager::reset()
 	_layers.clear();
 	_layers.emplace(DEFAULT_LAYER, _(DEFAULT_LAYER_NAME));
 
-	_layerVisibility.resize(1);
-	_layerVisibility[DEFAULT_LAYER] = true;
+	_visibleLayers.clear();
+	_visibleLayers.set(DEFAULT_LAYER);
 
     _layerParentIds.resize(1);
     _layerParentIds[DEFAULT_LAYER] = NO_PARENT_ID;
@@ -184,7 +189,7 @@ int LayerManager::getFirstVisibleLayer() const
 	// Iterate over all IDs and check the visibility status, return the first visible
 	for (const auto& [layerId, _] : _layers)
 	{
-		if (_layerVisibility[layerId])
+		if (_visibleLayers.test(layerId))
 		{
 			return layerId;
 		}
@@ -213,20 +218,20 @@ void LayerManager::setActiveLayer(int layerID)
 bool LayerManager::layerIsVisible(int layerID)
 {
 	// Sanity check
-	if (layerID < 0 || layerID >= static_cast<int>(_layerVisibility.size()))
+	if (layerID < 0 || layerID >= static_cast<int>(_layerParentIds.size()))
     {
 		rMessage() << "LayerSystem: Querying invalid layer ID: " << layerID << std::endl;
 		return false;
 	}
 
-	return _layerVisibility[layerID];
+	return _visibleLayers.test(layerID);
 }
 
 void LayerManager::setLayerVisibility(int layerId, bool visible)
 {
-    auto layerVisibilityChanged = setLayerVisibilityRecursively(layerId, visible);
+    auto changedLayerIds = setLayerVisibilityRecursively(layerId, visible);
 
-	if (!visible && !_layerVisibility.at(_activeLayer))
+	if (!visible && !_visibleLayers.test(_activeLayer))
 	{
 		// We just hid the active layer, fall back to another one
 		_activeLayer = getFirstVisibleLayer();
@@ -234,32 +239,35 @@ void LayerManager::setLayerVisibility(int layerId, bool visible)
     
     // If the active layer is hidden (which can occur after "hide all")
     // re-set the active layer to this one as it has been made visible
-    if (visible && _activeLayer < static_cast<int>(_layerVisibility.size()) && 
-        !_layerVisibility[_activeLayer])
+    if (visible && _activeLayer < static_cast<int>(_layerParentIds.size()) && 
+        !_visibleLayers.test(_activeLayer))
     {
         _activeLayer = layerId;
     }
 
-    if (layerVisibilityChanged)
+    if (!changedLayerIds.empty())
     {
 	    // Fire the visibility changed event
-	    onLayerVisibilityChanged();
+	    onLayerVisibilityChanged(changedLayerIds);
     }
 }
 
-bool LayerManager::setLayerVisibilityRecursively(int rootLayerId, bool visible)
+std::vector<int> LayerManager::setLayerVisibilityRecursively(int rootLayerId, bool visible)
 {
-    bool visibilityChange = false;
+    std::vector<int> changedLayerIds;
 
     foreachLayerInHierarchy(rootLayerId, [&](int layerId)
     {
-        if (layerId < 0 || layerId >= _layerVisibility.size()) return;
+        if (layerId < 0 || layerId >= _layerParentIds.size()) return;
 
-        visibilityChange |= _layerVisibility.at(layerId) != visible;
-        _layerVisibility.at(layerId) = visible;
+        if (_visibleLayers.test(layerId) != visible)
+        {
+            _visibleLayers.set(layerId, visible);
+            changedLayerIds.push_back(layerId);
+        }
     });
 
-    return visibilityChange;
+    return changedLayerIds;
 }
 
 void LayerManager::updateSceneGraphVisibility()
@@ -283,10 +291,10 @@ void LayerManager::onNodeMembershipChanged()
 	updateSceneGraphVisibility();
 }
 
-void LayerManager::onLayerVisibilityChanged()
+void LayerManager::onLayerVisibilityChanged(const std::vector<int>& changedLayerIds)
 {
-	// Update all nodes and views
-	updateSceneGraphVisibility();
+	// Only the members of the changed layers (and their parents) can change their visibility
+	updateVisibilityOfNodes(getLayerMembers(changedLayerIds));
 
 	// Update the UI
 	_layerVisibilityChangedSignal.emit();
@@ -335,23 +343,8 @@ bool LayerManager::updateNodeVisibility(const INodePtr& node)
         return true; // doesn't support layers, return true for visible
     }
 
-	// Get the list of layers the node is associated with
-	const auto& layers = node->getLayers();
-
-	// We start with the assumption that a node is hidden
-    bool isHidden = true;
-
-	// Cycle through the Node's layers, and show the node as soon as
-	// a visible layer is found.
-	for (int layerId : layers)
-	{
-		if (_layerVisibility[layerId])
-		{
-			// The layer is visible, set the visibility to true and quit
-            isHidden = false;
-			break;
-		}
-	}
+	// The node is hidden unless any of its layers is visible
+    bool isHidden = !node->getLayerMask().intersects(_visibleLayers);
 
     if (isHidden)
     {
@@ -366,6 +359,114 @@ bool LayerManager::updateNodeVisibility(const INodePtr& node)
 	return !isHidden;
 }
 
+void LayerManager::registerNode(INode& node)
+{
+    // The root is not part of any layer
+    if (&node == &_rootNode) return;
+
+    for (int layerId : node.getLayers())
+    {
+        _layerMembers[layerId].insert(&node);
+    }
+}
+
+void LayerManager::unregisterNode(INode& node)
+{
+    for (int layerId : node.getLayers())
+    {
+        auto members = _layerMembers.find(layerId);
+
+        if (members != _layerMembers.end())
+        {
+            members->second.erase(&node);
+        }
+    }
+}
+
+std::vector<INodePtr> LayerManager::getLayerMembers(const std::vector<int>& layerIds) const
+{
+    std::vector<INodePtr> result;
+    std::unordered_set<INode*> visited;
+
+    for (int layerId : layerIds)
+    {
+        auto members = _layerMembers.find(layerId);
+
+        if (members == _layerMembers.end()) continue;
+
+        for (auto member : members->second)
+        {
+            if (visited.insert(member).second)
+            {
+                result.push_back(member->getSelf());
+            }
+        }
+    }
+
+    return result;
+}
+
+void LayerManager::updateVisibilityOfNodes(const std::vector<INodePtr>& nodes)
+{
+    // A parent stays visible if any of its children is visible, so the ancestors
+    // of the given nodes need to be re-evaluated too. Collect them along with
+    // their depth in the scene, children need to be evaluated before their parents.
+    std::vector<std::pair<std::size_t, INodePtr>> nodesByDepth;
+    std::unordered_set<INode*> visited;
+
+    for (const auto& node : nodes)
+    {
+        for (auto current = node; current && current.get() != &_rootNode; current = current->getParent())
+        {
+            if (!visited.insert(current.get()).second) break; // ancestors are listed already
+
+            nodesByDepth.emplace_back(0, current);
+        }
+    }
+
+    for (auto& [depth, node] : nodesByDepth)
+    {
+        for (auto parent = node->getParent(); parent; parent = parent->getParent())
+        {
+            ++depth;
+        }
+    }
+
+    std::stable_sort(nodesByDepth.begin(), nodesByDepth.end(), [](const auto& a, const auto& b)
+    {
+        return a.first > b.first;
+    });
+
+    for (const auto& [_, node] : nodesByDepth)
+    {
+        bool nodeIsVisible = updateNodeVisibility(node);
+
+        if (!nodeIsVisible)
+        {
+            // Show the node if any of its children is visible
+            node->foreachNode([&](const INodePtr& child)
+            {
+                nodeIsVisible = !child->checkStateFlag(Node::eLayered);
+                return !nodeIsVisible;
+            });
+
+            if (nodeIsVisible)
+            {
+                node->disable(Node::eLayered);
+            }
+        }
+
+        if (node->checkStateFlag(Node::eLayered))
+        {
+            // Node is hidden by layers after update (and no children are visible), de-select
+            Node_setSelected(node, false);
+        }
+    }
+
+    // Redraw
+    SceneChangeNotify();
+}
+
 void LayerManager::foreachLayerInHierarchy(int rootLayerId, const std::function<void(int)>& functor)
 {
     if (rootLayerId == -1) return;
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_set>
 #include "ilayer.h"
 
 namespace scene 
@@ -16,14 +17,17 @@ private:
     // The list of named layers, indexed by an integer ID
     std::map<int, std::string> _layers;
 
-	// greebo: An array of booleans reflects the visibility status
-	// of all layers. Indexed by the layer id, it can be used to
-	// quickly check whether a layer is visible or not.
-    std::vector<bool> _layerVisibility;
+	// The visible layers, a node is visible if its own layer
+	// mask intersects with this one
+    LayerMask _visibleLayers;
 
-    // The parent IDs of each layer (-1 for no parent)
+    // The parent IDs of each layer (-1 for no parent), indexed by layer ID.
+    // Its size is one larger than the highest layer ID.
     std::vector<int> _layerParentIds;
 
+    // The nodes in the scene, by the layer they're member of
+    std::map<int, std::unordered_set<INode*>> _layerMembers;
+
 	// The ID of the active layer
 	int _activeLayer;
 
@@ -109,6 +113,9 @@ public:
 
 	bool updateNodeVisibility(const scene::INodePtr& node) override;
 
+	void registerNode(INode& node) override;
+	void unregisterNode(INode& node) override;
+
 	// Selects/unselects an entire layer
 	void setSelected(int layerID, bool selected) override;
 
@@ -123,9 +130,8 @@ public:
 
 private:
     // Recursively sets the visibility of the given layer and updates
-    // the flags on the _layerVisibility vector.
-    // Returns true if any flag changed, false if nothing changed.
-    bool setLayerVisibilityRecursively(int layerID, bool visible);
+    // the _visibleLayers mask. Returns the IDs of the changed layers.
+    std::vector<int> setLayerVisibilityRecursively(int layerID, bool visible);
 
     // Invokes the function object with each layer ID in the hierarchy, including the given root
     void foreachLayerInHierarchy(int rootLayerId, const std::function<void(int)>& functor);
@@ -133,8 +139,8 @@ private:
 	// Internal event emitter
 	void onLayersChanged();
 
-	// Internal event, updates the scenegraph
-	void onLayerVisibilityChanged();
+	// Internal event, updates the members of the given layers
+	void onLayerVisibilityChanged(const std::vector<int>& changedLayerIds);
 
 	// Internal event emitter
 	void onNodeMembershipChanged();
@@ -142,6 +148,13 @@ private:
 	// Updates the visibility state of the entire scenegraph
 	void updateSceneGraphVisibility();
 
+	// Updates the visibility state of the given nodes and their ancestors,
+	// the other nodes' state is assumed to be up to date
+	void updateVisibilityOfNodes(const std::vector<INodePtr>& nodes);
+
+	// Returns the nodes which are members of any of the given layers
+	std::vector<INodePtr> getLayerMembers(const std::vector<int>& layerIds) const;
+
 	// Returns the highest used layer Id
 	int getHighestLayerID() const;
 
@@ -1,4 +1,5 @@
 #include "LogFile.h"
+#include "LogWriter.h"
 
 #include <iomanip>
 #include <thread>
@@ -32,6 +33,11 @@ const std::string& LogFile::getFullPath() const
 }
 
 void LogFile::writeLog(const std::string& outputStr, LogLevel level) 
+{
+    writeLogFromThread(outputStr, level, std::this_thread::get_id());
+}
+
+void LogFile::writeLogFromThread(const std::string& outputStr, LogLevel level, std::thread::id sourceThread)
 {
     _buffer.append(outputStr);
 
@@ -46,7 +52,7 @@ void LogFile::writeLog(const std::string& outputStr, LogLevel level)
         _logStream << std::put_time(&tm, TIME_FMT);
 #endif
 
-        _logStream << " (" << std::this_thread::get_id() << ") ";
+        _logStream << " (" << sourceThread << ") ";
 
         // Insert the string into the stream and flush the buffer
         _logStream << _buffer;
@@ -67,6 +73,9 @@ void LogFile::close()
     rMessage() << std::put_time(&tm, TIME_FMT) << " Closing log file." << std::endl;
 #endif
 
+    // Wait for the writer thread to pass the pending output
+    LogWriter::Instance().flush();
+
     // Insert the last few remaining bytes into the stream
     if (!_buffer.empty())
     {
@@ -36,6 +36,9 @@ public:
 	 */
 	void writeLog(const std::string& outputStr, LogLevel level) override;
 
+	// Includes the ID of the thread producing the output in the log
+	void writeLogFromThread(const std::string& outputStr, LogLevel level, std::thread::id sourceThread) override;
+
 	void close();
 };
 
@@ -66,6 +66,19 @@ LogStreamBuf::int_type LogStreamBuf::sync()
 	return 0;
 }
 
+std::streamsize LogStreamBuf::xsputn(const char_type* s, std::streamsize count)
+{
+	// Preserve the order of anything still in the buffer
+	writeToBuffer();
+
+	if (count > 0)
+	{
+		LogWriter::Instance().write(s, static_cast<std::size_t>(count), _level);
+	}
+
+	return count;
+}
+
 void LogStreamBuf::writeToBuffer()
 {
 	int_type charsToWrite = static_cast<int_type>(pptr() - pbase());
@@ -35,6 +35,9 @@ protected:
 	virtual int_type overflow(int_type c);
 	virtual int_type sync();
 
+	// Passes whole strings to the LogWriter instead of single characters
+	std::streamsize xsputn(const char_type* s, std::streamsize count) override;
+
 private:
 	// Writes the buffer contents to the log device
 	void writeToBuffer();
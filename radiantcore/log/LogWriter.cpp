@@ -7,7 +7,26 @@
 namespace applog
 {
 
-LogWriter::LogWriter()
+namespace
+{
+	constexpr std::size_t QueueCapacity = 8192;
+
+	// Pending repetitions are summarised if no different line arrives within this time
+	constexpr std::chrono::milliseconds RepetitionSummaryDelay(1000);
+
+	// Upper bound for the writer thread to sleep, in case a wakeup signal has been missed
+	constexpr std::chrono::milliseconds MaximumIdleTime(100);
+}
+
+LogWriter::LogWriter() :
+	_queue(QueueCapacity),
+	_running(false),
+	_writerWaiting(false),
+	_flushRequested(0),
+	_flushCompleted(0),
+	_pendingLineIsContinuation(false),
+	_lastLineIsIncomplete(false),
+	_numRepetitions(0)
 {
 	for (auto level : AllLogLevels)
 	{
@@ -15,15 +34,51 @@ LogWriter::LogWriter()
 	}
 }
 
+LogWriter::~LogWriter()
+{
+	stopWriterThread();
+}
+
 void LogWriter::write(const char* p, std::size_t length, LogLevel level)
 {
 	// Convert the buffer to a string
-	std::string output(p, length);
+	LogRecord record{ std::string(p, length), level, std::this_thread::get_id() };
 
-	// Visit all the logfiles and write the string
-	for (auto device : _devices)
-    {
-		device->writeLog(output, level);
+	if (!_running.load())
+	{
+		// Visit all the logfiles and write the string
+		std::lock_guard<std::mutex> lock(_deviceLock);
+		writeToDevices(record);
+		return;
+	}
+
+	if (isWriterThread())
+	{
+		// A device is logging, this is picked up after the current batch
+		_writerOutput.emplace_back(std::move(record));
+		return;
+	}
+
+	while (!_queue.tryPush(std::move(record)))
+	{
+		// The ring is full, let the writer catch up
+		wakeWriterThread();
+		std::this_thread::yield();
+	}
+
+	// Pairs with the fence in runWriterThread: either the writer sees the
+	// new record, or we see the writer waiting and wake it up
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	if (_writerWaiting.load())
+	{
+		wakeWriterThread();
+	}
+
+	// Errors are likely followed by a crash or an abort(), don't lose them
+	if (level == LogLevel::Error)
+	{
+		flush();
 	}
 }
 
@@ -38,40 +93,277 @@ std::mutex& LogWriter::getStreamLock()
 	return LogStream::GetStreamLock();
 }
 
-void LogWriter::attach(ILogDevice* device)
+void LogWriter::flush()
 {
-	_devices.insert(device);
+	if (!_running.load() || isWriterThread()) return;
+
+	std::unique_lock<std::mutex> lock(_wakeLock);
+
+	auto request = ++_flushRequested;
+	_wakeSignal.notify_one();
+
+	_flushedSignal.wait(lock, [&]() { return _flushCompleted >= request || !_running.load(); });
+}
 
+void LogWriter::attach(ILogDevice* device)
+{
+	// The buffered output should be complete before it is handed over
 	if (device->isConsole())
 	{
-		// The first console device receives all the buffered output
-		if (applog::StringLogDevice::InstancePtr())
-		{
-			applog::StringLogDevice& logger = *applog::StringLogDevice::InstancePtr();
+		flush();
+	}
 
-			for (auto level : applog::AllLogLevels)
+	{
+		std::lock_guard<std::mutex> lock(_deviceLock);
+
+		_devices.insert(device);
+
+		if (device->isConsole())
+		{
+			// The first console device receives all the buffered output
+			if (applog::StringLogDevice::InstancePtr())
 			{
-				std::string bufferedText = logger.getString(static_cast<applog::LogLevel>(level));
+				applog::StringLogDevice& logger = *applog::StringLogDevice::InstancePtr();
 
-				if (bufferedText.empty()) continue;
+				for (auto level : applog::AllLogLevels)
+				{
+					std::string bufferedText = logger.getString(static_cast<applog::LogLevel>(level));
 
-				device->writeLog(bufferedText + "\n", static_cast<applog::LogLevel>(level));
+					if (bufferedText.empty()) continue;
+
+					device->writeLog(bufferedText + "\n", static_cast<applog::LogLevel>(level));
+				}
 			}
 		}
+	}
 
+	if (device->isConsole())
+	{
+		// Detaches the buffer device, this must not happen while holding the device lock
 		applog::StringLogDevice::destroy();
 	}
 }
 
 void LogWriter::detach(ILogDevice* device)
 {
+	// Pass the pending output to the device before it goes away
+	flush();
+
+	std::lock_guard<std::mutex> lock(_deviceLock);
 	_devices.erase(device);
 }
 
+void LogWriter::startWriterThread()
+{
+	if (_running.load()) return;
+
+	_running.store(true);
+	_writerThread = std::thread(&LogWriter::runWriterThread, this);
+}
+
+void LogWriter::stopWriterThread()
+{
+	if (!_running.load()) return;
+
+	{
+		std::lock_guard<std::mutex> lock(_wakeLock);
+		_running.store(false);
+		_wakeSignal.notify_one();
+	}
+
+	// The writer is draining the queue before it exits
+	_writerThread.join();
+	_flushedSignal.notify_all();
+
+	// Pick up anything pushed while the writer was exiting
+	processQueue();
+
+	std::lock_guard<std::mutex> lock(_deviceLock);
+	writeRepetitionSummary();
+}
+
 LogWriter& LogWriter::Instance()
 {
 	static LogWriter _writer;
 	return _writer;
 }
 
+bool LogWriter::isWriterThread() const
+{
+	return std::this_thread::get_id() == _writerThreadId.load();
+}
+
+void LogWriter::wakeWriterThread()
+{
+	std::lock_guard<std::mutex> lock(_wakeLock);
+	_wakeSignal.notify_one();
+}
+
+void LogWriter::runWriterThread()
+{
+	_writerThreadId.store(std::this_thread::get_id());
+
+	while (true)
+	{
+		std::size_t flushRequest;
+		bool running;
+
+		{
+			std::unique_lock<std::mutex> lock(_wakeLock);
+
+			_writerWaiting.store(true);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+
+			if (_queue.empty() && _running.load() && _flushRequested == _flushCompleted)
+			{
+				_wakeSignal.wait_for(lock, MaximumIdleTime);
+			}
+
+			_writerWaiting.store(false);
+
+			// Everything pushed before these requests is visible at this point
+			flushRequest = _flushRequested;
+			running = _running.load();
+		}
+
+		processQueue();
+
+		bool flushRequested = flushRequest != _flushCompleted;
+
+		if (_numRepetitions > 0 && (flushRequested || !running ||
+			std::chrono::steady_clock::now() - _lastRepetition >= RepetitionSummaryDelay))
+		{
+			std::lock_guard<std::mutex> lock(_deviceLock);
+			writeRepetitionSummary();
+		}
+
+		if (flushRequested)
+		{
+			std::lock_guard<std::mutex> lock(_wakeLock);
+			_flushCompleted = flushRequest;
+			_flushedSignal.notify_all();
+		}
+
+		if (!running && _queue.empty())
+		{
+			break;
+		}
+	}
+
+	// From now on output is written synchronously
+	_writerThreadId.store(std::thread::id());
+}
+
+void LogWriter::processQueue()
+{
+	LogRecord record;
+
+	std::lock_guard<std::mutex> lock(_deviceLock);
+
+	while (_queue.tryPop(record))
+	{
+		processRecord(record);
+
+		// Output of the devices goes in between, it's usually a reaction to what they just received
+		for (std::size_t i = 0; i < _writerOutput.size(); ++i)
+		{
+			auto deviceOutput = std::move(_writerOutput[i]);
+			processRecord(deviceOutput);
+		}
+
+		_writerOutput.clear();
+	}
+
+	// The queue is drained, don't hold back the incomplete line
+	if (!_pendingLine.text.empty())
+	{
+		processLine(_pendingLine, false);
+	}
+}
+
+void LogWriter::processRecord(LogRecord& record)
+{
+	if (record.text.empty()) return;
+
+	// Output of another thread or level completes the line
+	if (!_pendingLine.text.empty() &&
+		(_pendingLine.level != record.level || _pendingLine.sourceThread != record.sourceThread))
+	{
+		processLine(_pendingLine, false);
+	}
+
+	if (_pendingLine.text.empty())
+	{
+		// The beginning of this line might have been written already, it can't be compared then
+		_pendingLineIsContinuation = _lastLineIsIncomplete &&
+			_lastLine.level == record.level && _lastLine.sourceThread == record.sourceThread;
+
+		_pendingLine.level = record.level;
+		_pendingLine.sourceThread = record.sourceThread;
+	}
+
+	_pendingLine.text.append(record.text);
+
+	if (_pendingLine.text.back() == '\n')
+	{
+		processLine(_pendingLine, true);
+	}
+}
+
+void LogWriter::processLine(LogRecord& line, bool isComplete)
+{
+	bool isComparable = isComplete && !_pendingLineIsContinuation && line.text != "\n";
+
+	if (isComparable && line.level == _lastLine.level && line.text == _lastLine.text)
+	{
+		++_numRepetitions;
+		_lastRepetition = std::chrono::steady_clock::now();
+		line.text.clear();
+		return;
+	}
+
+	writeRepetitionSummary();
+	writeToDevices(line);
+
+	_lastLine.level = line.level;
+	_lastLine.sourceThread = line.sourceThread;
+
+	if (isComparable)
+	{
+		_lastLine.text = std::move(line.text);
+	}
+	else
+	{
+		_lastLine.text.clear();
+	}
+
+	line.text.clear();
+	_lastLineIsIncomplete = !isComplete;
+	_pendingLineIsContinuation = false;
+}
+
+void LogWriter::writeRepetitionSummary()
+{
+	if (_numRepetitions == 0) return;
+
+	LogRecord summary
+	{
+		"(previous message repeated " + std::to_string(_numRepetitions) +
+			(_numRepetitions == 1 ? " time)\n" : " times)\n"),
+		_lastLine.level,
+		_lastLine.sourceThread
+	};
+
+	_numRepetitions = 0;
+	writeToDevices(summary);
+}
+
+void LogWriter::writeToDevices(const LogRecord& record)
+{
+	for (auto device : _devices)
+	{
+		device->writeLogFromThread(record.text, record.level, record.sourceThread);
+	}
+}
+
 } // namespace applog
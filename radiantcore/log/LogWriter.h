@@ -3,25 +3,81 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <thread>
+#include <vector>
 #include "ilogwriter.h"
+#include "util/MpscRingBuffer.h"
 
 #include "LogStream.h"
 
 namespace applog
 {
 
+/**
+ * Output written to the LogWriter is queued in a lock-free ring buffer
+ * and passed to the devices by a dedicated writer thread, such that
+ * threads producing lots of output (like the decl parsers) don't have to
+ * wait for the log file and the console. Errors are written synchronously.
+ *
+ * The writer thread is assembling the incoming pieces to lines. Lines
+ * identical to the previous one are not passed on, a summary with the
+ * number of repetitions is written instead.
+ *
+ * Before startWriterThread() and after stopWriterThread(), all output is
+ * passed to the devices on the calling thread.
+ */
 class LogWriter :
 	public ILogWriter
 {
 private:
+	struct LogRecord
+	{
+		std::string text;
+		LogLevel level = LogLevel::Standard;
+		std::thread::id sourceThread;
+	};
+
 	// The set of unique log devices
 	typedef std::set<ILogDevice*> LogDevices;
 	LogDevices _devices;
 
+	// Guards the device set, held by the writer thread while passing output to the devices
+	std::mutex _deviceLock;
+
     std::map<LogLevel, std::unique_ptr<LogStream>> _streams;
 
+	util::MpscRingBuffer<LogRecord> _queue;
+
+	std::thread _writerThread;
+	std::atomic<std::thread::id> _writerThreadId;
+	std::atomic<bool> _running;
+
+	// Guards the waiting and flushing state below
+	std::mutex _wakeLock;
+	std::condition_variable _wakeSignal;
+	std::condition_variable _flushedSignal;
+	std::atomic<bool> _writerWaiting;
+	std::size_t _flushRequested;
+	std::size_t _flushCompleted;
+
+	// Writer thread state: the line being assembled and the last complete line
+	LogRecord _pendingLine;
+	bool _pendingLineIsContinuation;
+	LogRecord _lastLine;
+	bool _lastLineIsIncomplete;
+	std::size_t _numRepetitions;
+	std::chrono::steady_clock::time_point _lastRepetition;
+
+	// Output written by the devices themselves while running on the writer thread
+	std::vector<LogRecord> _writerOutput;
+
 public:
 	LogWriter();
+	~LogWriter() override;
 
 	/**
 	 * greebo: Writes the given buffer p with the given length to the
@@ -32,6 +88,8 @@ public:
 	std::ostream& getLogStream(LogLevel level) override;
 	std::mutex& getStreamLock() override;
 
+	void flush() override;
+
 	/**
 	 * greebo: Use these methods to attach/detach a log device from the
 	 *         writer class. After attaching a device, all log output
@@ -40,8 +98,27 @@ public:
 	void attach(ILogDevice* device) override;
 	void detach(ILogDevice* device) override;
 
+	// Starts passing the output to the devices asynchronously
+	void startWriterThread();
+
+	// Writes all pending output and returns to synchronous writing
+	void stopWriterThread();
+
 	// Contains the static singleton instance of this writer
 	static LogWriter& Instance();
+
+private:
+	bool isWriterThread() const;
+	void wakeWriterThread();
+
+	void runWriterThread();
+
+	// Passes all queued records to the devices
+	void processQueue();
+	void processRecord(LogRecord& record);
+	void processLine(LogRecord& line, bool isComplete);
+	void writeRepetitionSummary();
+	void writeToDevices(const LogRecord& record);
 };
 
 } // namespace applog
@@ -50,6 +50,12 @@ stream::MapResourceStream::Ptr ArchivedMapResource::openInfofileStream()
     }
 }
 
+bool ArchivedMapResource::canUseMapCache()
+{
+    // The files in archives are never changing, and there's no place to put a cache
+    return false;
+}
+
 stream::MapResourceStream::Ptr ArchivedMapResource::openFileInArchive(const std::string& filePathWithinArchive)
 {
     assert(_archive);
@@ -33,6 +33,7 @@ public:
 protected:
     virtual stream::MapResourceStream::Ptr openMapfileStream() override;
     virtual stream::MapResourceStream::Ptr openInfofileStream() override;
+    virtual bool canUseMapCache() override;
 
 private:
     stream::MapResourceStream::Ptr openFileInArchive(const std::string& filePathWithinArchive);
@@ -29,11 +29,12 @@
 #include "time/ScopeTimer.h"
 
 #include "brush/BrushModule.h"
+#include "brush/BRepEvaluation.h"
 #include "scene/BasicRootNode.h"
-#include "scene/PrefabBoundsAccumulator.h"
 #include "map/MapFileManager.h"
 #include "map/MapPositionManager.h"
 #include "map/MapResource.h"
+#include "map/OperationReport.h"
 #include "map/algorithm/Import.h"
 #include "map/algorithm/Export.h"
 #include "scene/Traverse.h"
@@ -164,6 +165,9 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
 
     assert(_resource);
 
+    // Collects the time spent in the various load phases until the end of this method
+    OperationReport report(OperationReport::Type::Load, location.path);
+
     try
     {
         util::ScopeTimer timer("map load");
@@ -181,8 +185,17 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
 
     connectToRootNode();
 
+    // Build the brush windings up front, inserting the nodes needs their bounds
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::BRepBuilding);
+        brush::evaluateBRepsInSubgraph(_resource->getRootNode());
+    }
+
     // Take the new node and insert it as map root
-    GlobalSceneGraph().setRoot(_resource->getRootNode());
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::OctreeInsertion);
+        GlobalSceneGraph().setRoot(_resource->getRootNode());
+    }
 
 	// Traverse the scenegraph and find the worldspawn
 	findWorldspawn();
@@ -191,6 +204,7 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
     // This usually takes a while since all editor textures are loaded - display a dialog to inform the user
     {
         radiant::ScopedLongRunningOperation blocker(_("Loading textures..."));
+        OperationReport::ScopedPhase phase(OperationReport::Phase::RenderablePreparation);
 
         assignRenderSystem(GlobalSceneGraph().root());
     }
@@ -216,6 +230,8 @@ void Map::loadMapResourceFromLocation(const MapLocation& location)
 
     // Clear the modified flag
     setModified(false);
+
+    report.finish();
 }
 
 void Map::assignRenderSystem(const scene::IMapRootNodePtr& root)
@@ -384,6 +400,16 @@ bool Map::isPointTraceVisible() const
     return _pointTrace->isVisible();
 }
 
+sigc::signal<void>& Map::signal_pointTraceAnimationFrame()
+{
+    return _pointTrace->signal_animationFrame();
+}
+
+void Map::updatePointTraceAnimation()
+{
+    _pointTrace->updateAnimation();
+}
+
 void Map::onSceneNodeErase(const scene::INodePtr& node)
 {
 	// Detect when worldspawn is removed from the map
@@ -657,12 +683,16 @@ bool Map::save(const MapFormatPtr& mapFormat)
     // Save the actual map resource
     try
     {
+        OperationReport report(OperationReport::Type::Save, _mapName);
+
         _resource->save(mapFormat);
 
         // Clear the modified flag
         setModified(false);
 
         success = true;
+
+        report.finish();
     }
     catch (IMapResource::OperationException & ex)
     {
@@ -941,16 +971,28 @@ void Map::loadPrefabAt(const cmd::ArgumentList& args)
         // Deselect everything
         GlobalSelectionSystem().setSelectedAll(false);
 
-        // Now import the prefab (imported items get selected)
-		import(prefabPath);
+        try
+        {
+            // Now import a copy of the prefab (imported items get selected),
+            // the prefab file is parsed only the first time it is placed
+            auto prefab = GlobalMapResourceManager().createPrefabCopy(prefabPath);
 
-        // Get the selection bounds, snap its origin to the grid
-        scene::PrefabBoundsAccumulator accumulator;
-        GlobalSelectionSystem().foreachSelected(accumulator);
+            algorithm::prepareNamesForImport(getRoot(), prefab);
+            algorithm::importMap(prefab);
+
+            SceneChangeNotify();
+        }
+        catch (const IMapResource::OperationException& ex)
+        {
+            radiant::NotificationMessage::SendError(ex.what());
+            return;
+        }
 
         if (recalculatePrefabOrigin)
         {
-            auto prefabCenter = accumulator.getBounds().getOrigin().getSnapped(GlobalGrid().getGridSize());
+            // Get the bounds of the cached prefab, snap its origin to the grid
+            auto prefabBounds = GlobalMapResourceManager().getPrefabBounds(prefabPath);
+            auto prefabCenter = prefabBounds.getOrigin().getSnapped(GlobalGrid().getGridSize());
 
             // Switch texture lock on
             bool prevTexLockState = GlobalBrush().textureLockEnabled();
@@ -1514,7 +1556,8 @@ const StringSet& Map::getDependencies() const
         MODULE_MAPINFOFILEMANAGER,
         MODULE_FILETYPES,
         MODULE_MAPRESOURCEMANAGER,
-        MODULE_COMMANDSYSTEM
+        MODULE_COMMANDSYSTEM,
+        MODULE_MEMORYACCOUNTING
     };
 
     return _dependencies;
@@ -1540,6 +1583,8 @@ void Map::initialiseModule(const IApplicationContext& ctx)
 
 	MapFileManager::registerFileTypes();
 
+    GlobalMemoryAccounting().registerReporter(_memoryReporter);
+
     // Register an info file module to save the map property bag
     GlobalMapInfoFileManager().registerInfoFileModule(
         std::make_shared<MapPropertyInfoFileModule>()
@@ -1566,6 +1611,8 @@ void Map::shutdownModule()
 
     _scaledModelExporter.shutdown();
 
+    GlobalMemoryAccounting().unregisterReporter(_memoryReporter);
+
 	GlobalSceneGraph().removeSceneObserver(this);
 
     _modelScalePreserver.reset();
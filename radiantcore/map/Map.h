@@ -15,6 +15,7 @@
 #include "model/export/ModelScalePreserver.h"
 #include "MapPositionManager.h"
 #include "PointFile.h"
+#include "algorithm/MemoryReport.h"
 #include "messages/ApplicationShutdownRequest.h"
 
 #include <sigc++/signal.h>
@@ -82,6 +83,8 @@ private:
     // Point trace for leak detection
     std::unique_ptr<PointFile> _pointTrace;
 
+    algorithm::MapMemoryReporter _memoryReporter;
+
 private:
     std::string getSaveConfirmationText() const;
 
@@ -116,6 +119,8 @@ public:
     void forEachPointfile(PointfileFunctor func) const override;
     void showPointFile(const fs::path& filePath) override;
     bool isPointTraceVisible() const override;
+    sigc::signal<void>& signal_pointTraceAnimationFrame() override;
+    void updatePointTraceAnimation() override;
 
 	/**
 	 * greebo: Saves the current map, doesn't ask for any filenames,
@@ -0,0 +1,200 @@
+#include "MapAssetPreloader.h"
+
+#include <fstream>
+#include "itextstream.h"
+#include "imodelcache.h"
+#include "ishaders.h"
+#include "iscenestatistics.h"
+
+#include "os/file.h"
+#include "registry/registry.h"
+#include "module/StaticModule.h"
+
+namespace map
+{
+
+namespace
+{
+    const char* const MANIFEST_EXTENSION = ".assets";
+    const char* const MANIFEST_HEADER = "# DarkRadiant map asset manifest";
+
+    const char* const MODEL_PREFIX = "model ";
+    const char* const MATERIAL_PREFIX = "material ";
+
+    // Adds the remainder of the line to the target if it starts with the given prefix
+    bool parseLine(const std::string& line, const std::string& prefix, std::vector<std::string>& target)
+    {
+        if (line.compare(0, prefix.length(), prefix) != 0 || line.length() == prefix.length())
+        {
+            return false;
+        }
+
+        target.push_back(line.substr(prefix.length()));
+        return true;
+    }
+}
+
+std::string MapAssetPreloader::GetManifestPath(const std::string& mapPath)
+{
+    return mapPath + MANIFEST_EXTENSION;
+}
+
+bool MapAssetPreloader::ReadManifest(const std::string& mapPath, Manifest& manifest)
+{
+    std::ifstream stream(GetManifestPath(mapPath));
+
+    if (!stream.is_open())
+    {
+        return false;
+    }
+
+    std::string line;
+
+    while (std::getline(stream, line))
+    {
+        // Manifests written on Windows might be read elsewhere
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+
+        if (!parseLine(line, MODEL_PREFIX, manifest.models))
+        {
+            parseLine(line, MATERIAL_PREFIX, manifest.materials);
+        }
+    }
+
+    return true;
+}
+
+void MapAssetPreloader::WriteManifest(const std::string& mapPath, const Manifest& manifest)
+{
+    auto manifestPath = GetManifestPath(mapPath);
+    std::ofstream stream(manifestPath);
+
+    if (!stream.is_open())
+    {
+        rWarning() << "Cannot write the map asset manifest " << manifestPath << std::endl;
+        return;
+    }
+
+    stream << MANIFEST_HEADER << std::endl;
+
+    for (const auto& model : manifest.models)
+    {
+        stream << MODEL_PREFIX << model << std::endl;
+    }
+
+    for (const auto& material : manifest.materials)
+    {
+        stream << MATERIAL_PREFIX << material << std::endl;
+    }
+}
+
+void MapAssetPreloader::PreloadAssets(const std::string& mapPath)
+{
+    Manifest manifest;
+
+    if (!ReadManifest(mapPath, manifest))
+    {
+        rMessage() << "No asset manifest found for " << mapPath << std::endl;
+        return;
+    }
+
+    rMessage() << "Preloading " << manifest.models.size() << " models and "
+        << manifest.materials.size() << " materials of " << mapPath << std::endl;
+
+    // The models are parsed by the cache's workers if async loading is enabled,
+    // nobody is waiting for them, they are just staying in the cache
+    for (const auto& model : manifest.models)
+    {
+        GlobalModelCache().getModelNodeAsync(model, [](const scene::INodePtr&) {});
+    }
+
+    GlobalMaterialManager().preloadMaterials(manifest.materials);
+}
+
+void MapAssetPreloader::onMapEvent(IMap::MapEvent ev)
+{
+    if (ev != IMap::MapUnloading || !registry::getValue<bool>(RKEY_PRELOAD_LAST_MAP) ||
+        GlobalMapModule().isUnnamed())
+    {
+        return;
+    }
+
+    auto mapPath = GlobalMapModule().getMapName();
+
+    // Maps loaded from archives don't have a location to write to
+    if (!os::fileOrDirExists(mapPath))
+    {
+        return;
+    }
+
+    Manifest manifest;
+
+    for (const auto& [model, usage] : GlobalSceneStatistics().getModelCounts())
+    {
+        manifest.models.push_back(model);
+    }
+
+    for (const auto& [material, counts] : GlobalSceneStatistics().getMaterialCounts())
+    {
+        if (!material.empty())
+        {
+            manifest.materials.push_back(material);
+        }
+    }
+
+    WriteManifest(mapPath, manifest);
+}
+
+void MapAssetPreloader::preloadMapAssetsCmd(const cmd::ArgumentList& args)
+{
+    if (args.size() != 1)
+    {
+        rWarning() << "Usage: " << PRELOAD_MAP_ASSETS_CMD << " <mapPath>" << std::endl;
+        return;
+    }
+
+    PreloadAssets(args[0].getString());
+}
+
+const std::string& MapAssetPreloader::getName() const
+{
+    static std::string _name("MapAssetPreloader");
+    return _name;
+}
+
+const StringSet& MapAssetPreloader::getDependencies() const
+{
+    static StringSet _dependencies
+    {
+        MODULE_MAP,
+        MODULE_SCENESTATISTICS,
+        MODULE_MODELCACHE,
+        MODULE_SHADERSYSTEM,
+        MODULE_COMMANDSYSTEM,
+    };
+
+    return _dependencies;
+}
+
+void MapAssetPreloader::initialiseModule(const IApplicationContext& ctx)
+{
+    _mapEventConn = GlobalMapModule().signal_mapEvent().connect(
+        sigc::mem_fun(*this, &MapAssetPreloader::onMapEvent)
+    );
+
+    GlobalCommandSystem().addCommand(PRELOAD_MAP_ASSETS_CMD,
+        std::bind(&MapAssetPreloader::preloadMapAssetsCmd, this, std::placeholders::_1),
+        { cmd::ARGTYPE_STRING });
+}
+
+void MapAssetPreloader::shutdownModule()
+{
+    _mapEventConn.disconnect();
+}
+
+module::StaticModuleRegistration<MapAssetPreloader> mapAssetPreloaderModule;
+
+}
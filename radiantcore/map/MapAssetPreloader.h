@@ -0,0 +1,62 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "imodule.h"
+#include "imap.h"
+#include "icommandsystem.h"
+#include <sigc++/connection.h>
+
+namespace map
+{
+
+/**
+ * Remembers the models and materials used by a map when it is closed, such
+ * that they can be loaded in the background before the map is opened again.
+ *
+ * The assets are listed in a small text file next to the map and its info
+ * file (e.g. "maps/arkham.map.assets"), one asset per line:
+ *
+ * model models/darkmod/furniture/chair.lwo
+ * material textures/darkmod/stone/brick/blocks_brown
+ *
+ * The manifest is only written if RKEY_PRELOAD_LAST_MAP is enabled.
+ */
+class MapAssetPreloader final :
+    public RegisterableModule
+{
+public:
+    struct Manifest
+    {
+        std::vector<std::string> models;
+        std::vector<std::string> materials;
+    };
+
+private:
+    sigc::connection _mapEventConn;
+
+public:
+    // Returns the path of the manifest belonging to the given map file
+    static std::string GetManifestPath(const std::string& mapPath);
+
+    // Returns false if the manifest doesn't exist or couldn't be read
+    static bool ReadManifest(const std::string& mapPath, Manifest& manifest);
+
+    // Failures are logged, no manifest is written in that case
+    static void WriteManifest(const std::string& mapPath, const Manifest& manifest);
+
+    // Queues the assets listed in the manifest of the given map for loading
+    static void PreloadAssets(const std::string& mapPath);
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    void onMapEvent(IMap::MapEvent ev);
+    void preloadMapAssetsCmd(const cmd::ArgumentList& args);
+};
+
+}
@@ -0,0 +1,718 @@
+#include "MapCache.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include "i18n.h"
+#include "itextstream.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "ientity.h"
+#include "ieclass.h"
+
+#include "gamelib.h"
+#include "os/fs.h"
+#include "os/path.h"
+#include "scene/ChildPrimitives.h"
+#include "stream/utils.h"
+#include "fmt/format.h"
+#include "OperationReport.h"
+
+namespace map
+{
+
+namespace
+{
+    const char* const CACHE_EXTENSION = ".cache";
+    const char CACHE_MAGIC[4] = { 'D', 'R', 'M', 'C' };
+
+    // Increase this number whenever the layout is changing
+    const std::uint32_t CACHE_VERSION = 1;
+
+    enum class PrimitiveType : std::uint8_t
+    {
+        Brush,
+        Patch,
+    };
+
+    // Size and modification time of a file on disk
+    struct FileStamp
+    {
+        std::uint64_t size;
+        std::int64_t modificationTime;
+
+        bool operator==(const FileStamp& other) const
+        {
+            return size == other.size && modificationTime == other.modificationTime;
+        }
+    };
+
+    bool getFileStamp(const std::string& path, FileStamp& stamp)
+    {
+        try
+        {
+            if (!fs::is_regular_file(path)) return false;
+
+            stamp.size = static_cast<std::uint64_t>(fs::file_size(path));
+            stamp.modificationTime = static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count());
+            return true;
+        }
+        catch (const fs::filesystem_error&)
+        {
+            return false;
+        }
+    }
+
+    std::string getInfoFilePath(const std::string& mapPath)
+    {
+        return os::replaceExtension(mapPath, game::current::getInfoFileExtension());
+    }
+
+    template<typename ValueType>
+    void write(std::ostream& stream, ValueType value)
+    {
+        stream::writeLittleEndian<ValueType>(stream, value);
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    void writeStamp(std::ostream& stream, const FileStamp& stamp)
+    {
+        write<std::uint64_t>(stream, stamp.size);
+        write<std::int64_t>(stream, stamp.modificationTime);
+    }
+
+    template<typename ValueType>
+    ValueType read(std::istream& stream)
+    {
+        ValueType value = ValueType();
+        stream.read(reinterpret_cast<char*>(&value), sizeof(ValueType));
+
+#ifdef __BIG_ENDIAN__
+        std::reverse(reinterpret_cast<char*>(&value), reinterpret_cast<char*>(&value) + sizeof(ValueType));
+#endif
+
+        return value;
+    }
+
+    std::string readString(std::istream& stream)
+    {
+        auto length = read<std::uint32_t>(stream);
+
+        std::string value(length, '\0');
+        stream.read(value.data(), length);
+
+        return value;
+    }
+
+    FileStamp readStamp(std::istream& stream)
+    {
+        FileStamp stamp;
+        stamp.size = read<std::uint64_t>(stream);
+        stamp.modificationTime = read<std::int64_t>(stream);
+
+        return stamp;
+    }
+
+    // Assigns an index to each distinct material name while writing the primitives
+    class MaterialTable
+    {
+    private:
+        std::vector<std::string> _names;
+        std::unordered_map<std::string, std::uint32_t> _indices;
+
+    public:
+        std::uint32_t getIndex(const std::string& name)
+        {
+            auto result = _indices.emplace(name, static_cast<std::uint32_t>(_names.size()));
+
+            if (result.second)
+            {
+                _names.push_back(name);
+            }
+
+            return result.first->second;
+        }
+
+        const std::vector<std::string>& getNames() const
+        {
+            return _names;
+        }
+    };
+
+    void writeBrush(std::ostream& stream, const IBrush& brush, MaterialTable& materials)
+    {
+        write<std::uint8_t>(stream, static_cast<std::uint8_t>(PrimitiveType::Brush));
+        write<std::uint8_t>(stream, static_cast<std::uint8_t>(brush.getDetailFlag()));
+
+        // Like the map writers, leave out the faces not contributing to the brush
+        std::vector<const IFace*> faces;
+
+        for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+        {
+            const auto& face = brush.getFace(i);
+
+            if (face.getWinding().size() > 2)
+            {
+                faces.push_back(&face);
+            }
+        }
+
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(faces.size()));
+
+        for (auto face : faces)
+        {
+            const auto& plane = face->getPlane3();
+            write<double>(stream, plane.normal().x());
+            write<double>(stream, plane.normal().y());
+            write<double>(stream, plane.normal().z());
+            write<double>(stream, plane.dist());
+
+            auto texdef = face->getProjectionMatrix();
+            write<double>(stream, texdef.xx());
+            write<double>(stream, texdef.yx());
+            write<double>(stream, texdef.zx());
+            write<double>(stream, texdef.xy());
+            write<double>(stream, texdef.yy());
+            write<double>(stream, texdef.zy());
+
+            write<std::uint32_t>(stream, materials.getIndex(face->getShader()));
+        }
+    }
+
+    void writePatch(std::ostream& stream, const IPatch& patch, MaterialTable& materials)
+    {
+        write<std::uint8_t>(stream, static_cast<std::uint8_t>(PrimitiveType::Patch));
+        write<std::uint32_t>(stream, materials.getIndex(patch.getShader()));
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(patch.getWidth()));
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(patch.getHeight()));
+
+        write<std::uint8_t>(stream, patch.subdivisionsFixed() ? 1 : 0);
+
+        if (patch.subdivisionsFixed())
+        {
+            write<std::uint32_t>(stream, patch.getSubdivisions().x());
+            write<std::uint32_t>(stream, patch.getSubdivisions().y());
+        }
+
+        for (std::size_t r = 0; r < patch.getHeight(); ++r)
+        {
+            for (std::size_t c = 0; c < patch.getWidth(); ++c)
+            {
+                const auto& control = patch.ctrlAt(r, c);
+                write<double>(stream, control.vertex.x());
+                write<double>(stream, control.vertex.y());
+                write<double>(stream, control.vertex.z());
+                write<double>(stream, control.texcoord.x());
+                write<double>(stream, control.texcoord.y());
+            }
+        }
+    }
+
+    // Writes the entities and their primitives, returns the number of written nodes
+    std::size_t writeEntities(std::ostream& stream, const scene::IMapRootNodePtr& root, MaterialTable& materials)
+    {
+        std::vector<IEntityNodePtr> entities;
+
+        root->foreachNode([&](const scene::INodePtr& node)
+        {
+            if (auto entity = std::dynamic_pointer_cast<IEntityNode>(node); entity)
+            {
+                entities.push_back(entity);
+            }
+
+            return true;
+        });
+
+        std::size_t nodeCount = entities.size();
+
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(entities.size()));
+
+        for (const auto& entity : entities)
+        {
+            std::vector<std::pair<std::string, std::string>> keyValues;
+
+            entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+            {
+                keyValues.emplace_back(key, value);
+            });
+
+            write<std::uint32_t>(stream, static_cast<std::uint32_t>(keyValues.size()));
+
+            for (const auto& [key, value] : keyValues)
+            {
+                writeString(stream, key);
+                writeString(stream, value);
+            }
+
+            // Collect the primitives the same way the map exporter does
+            std::vector<scene::INodePtr> primitives;
+
+            entity->foreachNode([&](const scene::INodePtr& child)
+            {
+                if (auto brush = std::dynamic_pointer_cast<IBrushNode>(child); brush)
+                {
+                    brush->getIBrush().evaluateBRep();
+
+                    if (brush->getIBrush().hasContributingFaces())
+                    {
+                        primitives.push_back(child);
+                    }
+                }
+                else if (std::dynamic_pointer_cast<IPatchNode>(child))
+                {
+                    primitives.push_back(child);
+                }
+
+                return true;
+            });
+
+            nodeCount += primitives.size();
+
+            write<std::uint32_t>(stream, static_cast<std::uint32_t>(primitives.size()));
+
+            for (const auto& primitive : primitives)
+            {
+                if (auto brush = std::dynamic_pointer_cast<IBrushNode>(primitive); brush)
+                {
+                    writeBrush(stream, brush->getIBrush(), materials);
+                }
+                else
+                {
+                    writePatch(stream, std::dynamic_pointer_cast<IPatchNode>(primitive)->getPatch(), materials);
+                }
+            }
+        }
+
+        return nodeCount;
+    }
+
+    // Moves the child primitives back to their entity origins for the lifetime of this object
+    class ScopedChildPrimitiveOriginRemover
+    {
+    private:
+        scene::INodePtr _root;
+
+    public:
+        ScopedChildPrimitiveOriginRemover(const scene::INodePtr& root) :
+            _root(root)
+        {
+            scene::removeOriginFromChildPrimitives(_root);
+        }
+
+        ~ScopedChildPrimitiveOriginRemover()
+        {
+            scene::addOriginToChildPrimitives(_root);
+        }
+    };
+}
+
+// Sends the entities of an opened cache to the import filter
+class MapCacheReader :
+    public IMapReader
+{
+private:
+    IMapImportFilter& _importFilter;
+
+    const std::vector<std::string>& _materials;
+    std::streamoff _entitiesOffset;
+
+public:
+    MapCacheReader(IMapImportFilter& importFilter, const std::vector<std::string>& materials, std::streamoff entitiesOffset) :
+        _importFilter(importFilter),
+        _materials(materials),
+        _entitiesOffset(entitiesOffset)
+    {}
+
+    void readFromStream(std::istream& stream) override
+    {
+        // The import filter is rewinding the stream to measure its size
+        stream.seekg(_entitiesOffset, std::ios::beg);
+
+        auto numEntities = read<std::uint32_t>(stream);
+
+        for (std::uint32_t i = 0; i < numEntities && stream.good(); ++i)
+        {
+            readEntity(stream);
+        }
+
+        if (!stream.good())
+        {
+            throw FailureException(_("The map cache file is incomplete"));
+        }
+    }
+
+private:
+    void readEntity(std::istream& stream)
+    {
+        std::map<std::string, std::string> keyValues;
+
+        auto numKeyValues = read<std::uint32_t>(stream);
+
+        for (std::uint32_t i = 0; i < numKeyValues && stream.good(); ++i)
+        {
+            auto key = readString(stream);
+            keyValues[key] = readString(stream);
+        }
+
+        auto entity = createEntity(keyValues);
+
+        auto numPrimitives = read<std::uint32_t>(stream);
+
+        for (std::uint32_t i = 0; i < numPrimitives && stream.good(); ++i)
+        {
+            auto type = static_cast<PrimitiveType>(read<std::uint8_t>(stream));
+
+            switch (type)
+            {
+            case PrimitiveType::Brush:
+                _importFilter.addPrimitiveToEntity(readBrush(stream), entity);
+                break;
+            case PrimitiveType::Patch:
+                _importFilter.addPrimitiveToEntity(readPatch(stream), entity);
+                break;
+            default:
+                throw FailureException(_("Unknown primitive type in map cache file"));
+            }
+        }
+
+        _importFilter.addEntity(entity);
+    }
+
+    scene::INodePtr createEntity(const std::map<std::string, std::string>& keyValues)
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::EntityCreation);
+
+        auto className = keyValues.find("classname");
+
+        if (className == keyValues.end())
+        {
+            throw FailureException(_("Entity without classname in map cache file"));
+        }
+
+        auto eclass = GlobalEntityClassManager().findClass(className->second);
+
+        if (!eclass)
+        {
+            rError() << "[MapCache] Could not find entity class: " << className->second << std::endl;
+
+            // Same as the map readers, insert a brush-based class
+            eclass = GlobalEntityClassManager().findOrInsert(className->second, true);
+        }
+
+        auto node = GlobalEntityModule().createEntity(eclass);
+
+        for (const auto& [key, value] : keyValues)
+        {
+            node->getEntity().setKeyValue(key, value);
+        }
+
+        return node;
+    }
+
+    const std::string& getMaterial(std::uint32_t index)
+    {
+        if (index >= _materials.size())
+        {
+            throw FailureException(_("Invalid material index in map cache file"));
+        }
+
+        return _materials[index];
+    }
+
+    scene::INodePtr readBrush(std::istream& stream)
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+
+        auto node = GlobalBrushCreator().createBrush();
+        auto& brush = std::dynamic_pointer_cast<IBrushNode>(node)->getIBrush();
+
+        brush.setDetailFlag(static_cast<IBrush::DetailFlag>(read<std::uint8_t>(stream)));
+
+        auto numFaces = read<std::uint32_t>(stream);
+
+        for (std::uint32_t i = 0; i < numFaces && stream.good(); ++i)
+        {
+            Plane3 plane;
+            plane.normal().x() = read<double>(stream);
+            plane.normal().y() = read<double>(stream);
+            plane.normal().z() = read<double>(stream);
+            plane.dist() = read<double>(stream);
+
+            auto texdef = Matrix3::getIdentity();
+            texdef.xx() = read<double>(stream);
+            texdef.yx() = read<double>(stream);
+            texdef.zx() = read<double>(stream);
+            texdef.xy() = read<double>(stream);
+            texdef.yy() = read<double>(stream);
+            texdef.zy() = read<double>(stream);
+
+            brush.addFace(plane, texdef, getMaterial(read<std::uint32_t>(stream)));
+        }
+
+        brush.removeRedundantFaces();
+
+        return node;
+    }
+
+    scene::INodePtr readPatch(std::istream& stream)
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+
+        const auto& material = getMaterial(read<std::uint32_t>(stream));
+        std::size_t width = read<std::uint32_t>(stream);
+        std::size_t height = read<std::uint32_t>(stream);
+        bool fixedSubdivisions = read<std::uint8_t>(stream) != 0;
+
+        auto node = GlobalPatchModule().createPatch(fixedSubdivisions ? patch::PatchDefType::Def3 : patch::PatchDefType::Def2);
+        auto& patch = std::dynamic_pointer_cast<IPatchNode>(node)->getPatch();
+
+        patch.setShader(material);
+        patch.setDims(width, height);
+
+        if (fixedSubdivisions)
+        {
+            Subdivisions subdivisions;
+            subdivisions.x() = read<std::uint32_t>(stream);
+            subdivisions.y() = read<std::uint32_t>(stream);
+
+            patch.setFixedSubdivisions(true, subdivisions);
+        }
+
+        if (patch.getWidth() != width || patch.getHeight() != height)
+        {
+            throw FailureException(_("Invalid patch dimensions in map cache file"));
+        }
+
+        for (std::size_t r = 0; r < height; ++r)
+        {
+            for (std::size_t c = 0; c < width; ++c)
+            {
+                auto& control = patch.ctrlAt(r, c);
+                control.vertex.x() = read<double>(stream);
+                control.vertex.y() = read<double>(stream);
+                control.vertex.z() = read<double>(stream);
+                control.texcoord.x() = read<double>(stream);
+                control.texcoord.y() = read<double>(stream);
+            }
+        }
+
+        patch.controlPointsChanged();
+
+        return node;
+    }
+};
+
+MapCache::MapCache(const std::string& mapPath) :
+    _mapPath(mapPath),
+    _hasInfoFile(false),
+    _entitiesOffset(0)
+{}
+
+bool MapCache::open()
+{
+    _stream.open(GetCachePath(_mapPath), std::ios::binary);
+
+    if (!_stream.is_open())
+    {
+        return false;
+    }
+
+    if (!readHeader())
+    {
+        rMessage() << "The map cache is out of date: " << GetCachePath(_mapPath) << std::endl;
+        _stream.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool MapCache::readHeader()
+{
+    char magic[sizeof(CACHE_MAGIC)];
+    _stream.read(magic, sizeof(magic));
+
+    if (!_stream.good() || !std::equal(magic, magic + sizeof(magic), CACHE_MAGIC) ||
+        read<std::uint32_t>(_stream) != CACHE_VERSION)
+    {
+        return false;
+    }
+
+    _formatName = readString(_stream);
+
+    FileStamp mapStamp;
+
+    if (!getFileStamp(_mapPath, mapStamp) || !(readStamp(_stream) == mapStamp))
+    {
+        return false;
+    }
+
+    // The info file must still be missing if it was missing when writing the cache
+    _hasInfoFile = read<std::uint8_t>(_stream) != 0;
+
+    FileStamp infoFileStamp;
+    bool infoFileExists = getFileStamp(getInfoFilePath(_mapPath), infoFileStamp);
+
+    if (_hasInfoFile != infoFileExists)
+    {
+        return false;
+    }
+
+    if (_hasInfoFile)
+    {
+        if (!(readStamp(_stream) == infoFileStamp))
+        {
+            return false;
+        }
+
+        _infoFileContents = readString(_stream);
+    }
+
+    auto numMaterials = read<std::uint32_t>(_stream);
+
+    for (std::uint32_t i = 0; i < numMaterials && _stream.good(); ++i)
+    {
+        _materials.emplace_back(readString(_stream));
+    }
+
+    _entitiesOffset = _stream.tellg();
+
+    return _stream.good();
+}
+
+const std::string& MapCache::getFormatName() const
+{
+    return _formatName;
+}
+
+bool MapCache::hasInfoFile() const
+{
+    return _hasInfoFile;
+}
+
+const std::string& MapCache::getInfoFileContents() const
+{
+    return _infoFileContents;
+}
+
+std::istream& MapCache::getStream()
+{
+    return _stream;
+}
+
+IMapReaderPtr MapCache::createReader(IMapImportFilter& importFilter) const
+{
+    return std::make_shared<MapCacheReader>(importFilter, _materials, _entitiesOffset);
+}
+
+std::string MapCache::GetCachePath(const std::string& mapPath)
+{
+    return mapPath + CACHE_EXTENSION;
+}
+
+void MapCache::Write(const std::string& mapPath, const MapFormat& format,
+    const scene::IMapRootNodePtr& root, std::size_t expectedNodeCount)
+{
+    fs::path cachePath = GetCachePath(mapPath);
+    fs::path temporaryPath = cachePath.string() + ".tmp";
+
+    FileStamp mapStamp;
+
+    if (!getFileStamp(mapPath, mapStamp))
+    {
+        return;
+    }
+
+    try
+    {
+        // Assemble the entities first, the material table is written in front of them
+        MaterialTable materials;
+        std::ostringstream entities;
+        std::size_t nodeCount = 0;
+
+        {
+            // Child primitives are stored relative to their entity, like in the map file
+            ScopedChildPrimitiveOriginRemover remover(root);
+            nodeCount = writeEntities(entities, root, materials);
+        }
+
+        if (expectedNodeCount != 0 && nodeCount != expectedNodeCount)
+        {
+            rWarning() << "[MapCache] Scene doesn't match the loaded map file, not writing the cache" << std::endl;
+            return;
+        }
+
+        std::ofstream stream(temporaryPath.string(), std::ios::binary);
+
+        if (!stream.is_open())
+        {
+            rWarning() << "[MapCache] Could not open " << temporaryPath.string() << " for writing" << std::endl;
+            return;
+        }
+
+        stream.write(CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        write<std::uint32_t>(stream, CACHE_VERSION);
+        writeString(stream, format.getMapFormatName());
+        writeStamp(stream, mapStamp);
+
+        FileStamp infoFileStamp;
+        auto infoFilePath = getInfoFilePath(mapPath);
+        bool hasInfoFile = format.allowInfoFileCreation() && getFileStamp(infoFilePath, infoFileStamp);
+
+        write<std::uint8_t>(stream, hasInfoFile ? 1 : 0);
+
+        if (hasInfoFile)
+        {
+            std::ifstream infoFile(infoFilePath, std::ios::binary);
+            std::stringstream contents;
+            contents << infoFile.rdbuf();
+
+            writeStamp(stream, infoFileStamp);
+            writeString(stream, contents.str());
+        }
+
+        write<std::uint32_t>(stream, static_cast<std::uint32_t>(materials.getNames().size()));
+
+        for (const auto& name : materials.getNames())
+        {
+            writeString(stream, name);
+        }
+
+        stream << entities.rdbuf();
+        stream.close();
+
+        if (stream.fail())
+        {
+            throw std::runtime_error(fmt::format("Failed to write {0}", temporaryPath.string()));
+        }
+
+        if (fs::exists(cachePath))
+        {
+            fs::remove(cachePath);
+        }
+
+        fs::rename(temporaryPath, cachePath);
+
+        rMessage() << "Wrote map cache " << cachePath.string() << std::endl;
+    }
+    catch (const std::exception& ex)
+    {
+        rWarning() << "[MapCache] Could not write the map cache: " << ex.what() << std::endl;
+
+        try
+        {
+            fs::remove(temporaryPath);
+        }
+        catch (const fs::filesystem_error&)
+        {}
+    }
+}
+
+}
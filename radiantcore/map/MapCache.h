@@ -0,0 +1,75 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "imapformat.h"
+
+namespace map
+{
+
+/**
+ * Binary sidecar file of a map (e.g. "maps/arkham.map.cache"), holding the
+ * entities and primitives of the map together with the contents of its info
+ * file. The cache is written after a map has been loaded or saved. It is
+ * only valid as long as size and modification time of the map and its info
+ * file match the values recorded in the cache header.
+ *
+ * Reading the cache is creating the nodes straight from the stored values,
+ * without any tokenising. All values are stored with fixed widths in little
+ * endian byte order, strings are prefixed by their length. The materials are
+ * stored once in a table in front of the entities and referenced by index.
+ */
+class MapCache
+{
+private:
+    std::string _mapPath;
+    std::ifstream _stream;
+
+    std::string _formatName;
+
+    bool _hasInfoFile;
+    std::string _infoFileContents;
+
+    std::vector<std::string> _materials;
+
+    // The position of the entity section in the stream
+    std::streamoff _entitiesOffset;
+
+public:
+    MapCache(const std::string& mapPath);
+
+    // Opens the cache of the map, returns false if there is no cache
+    // or if the cache is not matching the files on disk
+    bool open();
+
+    // The name of the map format the map has been loaded or saved with
+    const std::string& getFormatName() const;
+
+    // True if the info file contents have been stored in the cache
+    bool hasInfoFile() const;
+    const std::string& getInfoFileContents() const;
+
+    // The stream of the opened cache file
+    std::istream& getStream();
+
+    // Returns a reader sending the cached entities and primitives to the
+    // given import filter. The reader is valid as long as this cache exists.
+    IMapReaderPtr createReader(IMapImportFilter& importFilter) const;
+
+    // Returns the path of the cache file belonging to the given map file
+    static std::string GetCachePath(const std::string& mapPath);
+
+    // Writes the cache of the given map, which must just have been loaded from or
+    // saved to the given path. If the expected node count is non-zero, the cache
+    // is discarded unless the same number of entities and primitives got written.
+    // Failures are logged, the cache is not written in that case.
+    static void Write(const std::string& mapPath, const MapFormat& format,
+        const scene::IMapRootNodePtr& root, std::size_t expectedNodeCount = 0);
+
+private:
+    // Reads the header and the material table, returns false on mismatch
+    bool readHeader();
+};
+
+}
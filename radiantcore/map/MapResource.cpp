@@ -19,6 +19,7 @@
 #include "os/path.h"
 #include "os/file.h"
 #include "os/fs.h"
+#include "registry/registry.h"
 #include "scene/Traverse.h"
 #include "scenelib.h"
 
@@ -35,6 +36,11 @@
 #include "messages/NotificationMessage.h"
 #include "NodeCounter.h"
 #include "MapResourceLoader.h"
+#include "MapCache.h"
+#include "OperationReport.h"
+#include "UnloadedBlockNode.h"
+#include "format/Doom3MapReader.h"
+#include "layers/LayerInfoFileModule.h"
 
 namespace map
 {
@@ -47,6 +53,47 @@ namespace
 			path_is_absolute(name.c_str()) ? name : GlobalFileSystem().findFile(name)
 		);
 	}
+
+	// Returns the first placeholder of a partial map load found below the given root
+	std::shared_ptr<UnloadedBlockNode> findUnloadedBlock(const scene::INodePtr& root)
+	{
+		std::shared_ptr<UnloadedBlockNode> found;
+
+		root->foreachNode([&](const scene::INodePtr& node)
+		{
+			found = std::dynamic_pointer_cast<UnloadedBlockNode>(node);
+			return !found;
+		});
+
+		return found;
+	}
+
+	// Looks for placeholders read by another format than the given one
+	class UnloadedBlockFormatCheck :
+		public scene::NodeVisitor
+	{
+	private:
+		const std::string& _formatName;
+
+	public:
+		std::string foreignFormatName;
+
+		UnloadedBlockFormatCheck(const std::string& formatName) :
+			_formatName(formatName)
+		{}
+
+		bool pre(const scene::INodePtr& node) override
+		{
+			auto unloadedBlock = std::dynamic_pointer_cast<UnloadedBlockNode>(node);
+
+			if (unloadedBlock && unloadedBlock->getFormatName() != _formatName)
+			{
+				foreignFormatName = unloadedBlock->getFormatName();
+			}
+
+			return foreignFormatName.empty();
+		}
+	};
 }
 
 MapResource::MapResource(const std::string& resourcePath)
@@ -110,6 +157,17 @@ bool MapResource::load()
 	return _mapRoot != nullptr;
 }
 
+bool MapResource::loadLayers(const std::set<int>& layerIds)
+{
+	if (!_mapRoot)
+	{
+		setRootNode(loadMapNode(createLayerNodeFilter(layerIds)));
+		mapSave();
+	}
+
+	return _mapRoot != nullptr;
+}
+
 bool MapResource::isReadOnly()
 {
     return !FileIsWriteable(getAbsoluteResourcePath());
@@ -133,11 +191,15 @@ void MapResource::save(const MapFormatPtr& mapFormat)
 	std::string fullpath = getAbsoluteResourcePath();
 
 	// Save a backup of the existing file (rename it to .bak) if it exists in the first place
-	if (os::fileOrDirExists(fullpath) && !saveBackup())
 	{
-		// angua: if backup creation is not possible, still save the map
-		// but create message in the console
-		rError() << "Could not create backup (Map is possibly open in Doom3)" << std::endl;
+		OperationReport::ScopedPhase phase(OperationReport::Phase::Backup);
+
+		if (os::fileOrDirExists(fullpath) && !saveBackup())
+		{
+			// angua: if backup creation is not possible, still save the map
+			// but create message in the console
+			rError() << "Could not create backup (Map is possibly open in Doom3)" << std::endl;
+		}
 	}
 
 	if (!path_is_absolute(fullpath.c_str()))
@@ -147,10 +209,20 @@ void MapResource::save(const MapFormatPtr& mapFormat)
 	}
 
 	// Save the actual file (throws on fail)
-	saveFile(*format, _mapRoot, scene::traverse, fullpath);
+	{
+		OperationReport::ScopedPhase phase(OperationReport::Phase::Writing);
+		saveFile(*format, _mapRoot, scene::traverse, fullpath);
+	}
 
     refreshLastModifiedTime();
 
+    // The cache of a partially loaded map would be missing the unloaded parts
+    if (!findUnloadedBlock(_mapRoot))
+    {
+        OperationReport::ScopedPhase phase(OperationReport::Phase::CacheWriting);
+        writeMapCache(*format, _mapRoot);
+    }
+
 	mapSave();
 }
 
@@ -279,9 +351,14 @@ void MapResource::mapSave()
     }
 }
 
-RootNodePtr MapResource::loadMapNode()
+RootNodePtr MapResource::loadMapNode(const std::function<bool(std::size_t)>& nodeFilter)
 {
-	RootNodePtr rootNode;
+	RootNodePtr rootNode = !nodeFilter && canUseMapCache() ? loadMapNodeFromCache() : RootNodePtr();
+
+    if (rootNode)
+    {
+        return rootNode;
+    }
 
 	// Open a stream - will throw on failure
     auto stream = openMapfileStream();
@@ -305,7 +382,22 @@ RootNodePtr MapResource::loadMapNode()
         MapResourceLoader loader(stream->getStream(), *format);
 
         // Load the root from the primary stream (throws on failure or cancel)
-        rootNode = loader.load();
+        rootNode = !nodeFilter ? loader.load() : loader.load([&](IMapImportFilter& importFilter)
+        {
+            auto reader = format->getMapReader(importFilter);
+
+            if (auto doom3Reader = std::dynamic_pointer_cast<Doom3MapReader>(reader); doom3Reader)
+            {
+                doom3Reader->setNodeFilter(nodeFilter, format->getMapFormatName());
+            }
+            else
+            {
+                rWarning() << format->getMapFormatName() << " maps cannot be loaded partially, "
+                    << "loading all layers" << std::endl;
+            }
+
+            return reader;
+        });
 
         if (rootNode)
         {
@@ -324,6 +416,12 @@ RootNodePtr MapResource::loadMapNode()
         }
 
         refreshLastModifiedTime();
+
+        // Only write the cache if all the parsed nodes made it into the scene
+        if (!nodeFilter)
+        {
+            writeMapCache(*format, rootNode, loader.getNumLoadedNodes());
+        }
     }
     catch (const OperationException& ex)
     {
@@ -335,6 +433,143 @@ RootNodePtr MapResource::loadMapNode()
 	return rootNode;
 }
 
+std::function<bool(std::size_t)> MapResource::createLayerNodeFilter(const std::set<int>& layerIds)
+{
+    auto infoFileStream = openInfofileStream();
+
+    if (!infoFileStream || !infoFileStream->isOpen())
+    {
+        return {};
+    }
+
+    // Only the layer assignments are needed before the map is parsed
+    scene::LayerInfoFileModule layerInfo;
+
+    try
+    {
+        scene::IMapRootNodePtr root;
+        NodeIndexMap nodeMap;
+
+        InfoFile infoFile(infoFileStream->getStream(), root, nodeMap);
+        infoFile.parseWithModule(layerInfo);
+    }
+    catch (parser::ParseException& e)
+    {
+        rError() << "[MapResource] Unable to parse the layers of the info file: " << e.what() << std::endl;
+        return {};
+    }
+
+    if (layerInfo.getNodeLayerMappings().empty())
+    {
+        return {};
+    }
+
+    auto nodeLayers = std::make_shared<std::vector<scene::LayerList>>(layerInfo.getNodeLayerMappings());
+
+    return [nodeLayers, layerIds](std::size_t nodeIndex)
+    {
+        // Nodes missing in the info file are put into the default layer
+        if (nodeIndex >= nodeLayers->size())
+        {
+            return layerIds.count(0) > 0;
+        }
+
+        for (auto layerId : (*nodeLayers)[nodeIndex])
+        {
+            if (layerIds.count(layerId) > 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    };
+}
+
+RootNodePtr MapResource::loadMapNodeFromCache()
+{
+    MapCache cache(getAbsoluteResourcePath());
+
+    if (!cache.open())
+    {
+        return RootNodePtr();
+    }
+
+    auto format = GlobalMapFormatManager().getMapFormatByName(cache.getFormatName());
+
+    if (!format)
+    {
+        return RootNodePtr();
+    }
+
+    rMessage() << "Loading map from cache " << MapCache::GetCachePath(getAbsoluteResourcePath()) << std::endl;
+
+    try
+    {
+        MapResourceLoader loader(cache.getStream(), *format);
+
+        auto rootNode = loader.load([&](IMapImportFilter& importFilter)
+        {
+            return cache.createReader(importFilter);
+        });
+
+        rootNode->setName(_name);
+
+        if (format->allowInfoFileCreation())
+        {
+            if (cache.hasInfoFile())
+            {
+                std::istringstream infoFileStream(cache.getInfoFileContents());
+                loader.loadInfoFile(infoFileStream, rootNode);
+            }
+            else if (auto infoFileStream = openInfofileStream(); infoFileStream && infoFileStream->isOpen())
+            {
+                loader.loadInfoFile(infoFileStream->getStream(), rootNode);
+            }
+        }
+
+        refreshLastModifiedTime();
+
+        return rootNode;
+    }
+    catch (const OperationException& ex)
+    {
+        if (ex.operationCancelled())
+        {
+            throw;
+        }
+
+        // A damaged cache is not stopping us, the map file is still there
+        rWarning() << "Could not load the map cache, parsing the map file instead: " << ex.what() << std::endl;
+        return RootNodePtr();
+    }
+}
+
+void MapResource::writeMapCache(const MapFormat& format, const scene::IMapRootNodePtr& root, std::size_t expectedNodeCount)
+{
+    auto fullPath = getAbsoluteResourcePath();
+
+    if (!root || !canUseMapCache() || !os::fileOrDirExists(fullPath))
+    {
+        return;
+    }
+
+    // Small maps are parsed quickly enough, don't clutter the folders with caches
+    auto minimumSize = static_cast<std::uintmax_t>(std::max(registry::getValue<int>(RKEY_MAP_CACHE_MIN_SIZE), 0)) * 1024;
+
+    if (fs::file_size(fullPath) < minimumSize)
+    {
+        return;
+    }
+
+    MapCache::Write(fullPath, format, root, expectedNodeCount);
+}
+
+bool MapResource::canUseMapCache()
+{
+    return registry::getValue<bool>(RKEY_MAP_USE_CACHE);
+}
+
 stream::MapResourceStream::Ptr MapResource::openFileStream(const std::string& path)
 {
     // Call the factory method to acquire a stream
@@ -444,6 +679,33 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 
 	rMessage() << "success" << std::endl;
 
+	exportToStreams(format, root, traverse, outFileStream, auxFileStream.get());
+
+	// Check for any stream failures now that we're done writing
+	if (outFileStream.fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), outFile.string()));
+	}
+
+	if (auxFileStream && auxFileStream->fail())
+	{
+		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
+	}
+}
+
+void MapResource::exportToStreams(const MapFormat& format, const scene::IMapRootNodePtr& root,
+	const GraphTraversalFunc& traverse, std::ostream& mapStream, std::ostream* infoFileStream)
+{
+	// The text of unloaded blocks is only understood by the format it has been read with
+	UnloadedBlockFormatCheck formatCheck(format.getMapFormatName());
+	traverse(root, formatCheck);
+
+	if (!formatCheck.foreignFormatName.empty())
+	{
+		throw OperationException(fmt::format(_("This map has been loaded partially, "
+			"it can only be saved in the {0} format."), formatCheck.foreignFormatName));
+	}
+
 	// Check the total count of nodes to traverse
 	NodeCounter counter;
 	traverse(root, counter);
@@ -455,13 +717,13 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	MapExporterPtr exporter;
 	auto mapWriter = format.getMapWriter();
 
-	if (format.allowInfoFileCreation())
+	if (infoFileStream && format.allowInfoFileCreation())
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, *auxFileStream, counter.getCount()));
+		exporter.reset(new MapExporter(*mapWriter, root, mapStream, *infoFileStream, counter.getCount()));
 	}
 	else
 	{
-		exporter.reset(new MapExporter(*mapWriter, root, outFileStream, counter.getCount())); // no aux stream
+		exporter.reset(new MapExporter(*mapWriter, root, mapStream, counter.getCount())); // no aux stream
 	}
 
 	try
@@ -474,17 +736,6 @@ void MapResource::saveFile(const MapFormat& format, const scene::IMapRootNodePtr
 	{
 		throw OperationException(_("Map writing cancelled"));
 	}
-
-	// Check for any stream failures now that we're done writing
-	if (outFileStream.fail())
-	{
-		throw OperationException(fmt::format(_("Failure writing to file {0}"), outFile.string()));
-	}
-
-	if (auxFileStream && auxFileStream->fail())
-	{
-		throw OperationException(fmt::format(_("Failure writing to file {0}"), auxFile.string()));
-	}
 }
 
 } // namespace map
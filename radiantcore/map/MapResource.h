@@ -5,6 +5,7 @@
 #include "imodel.h"
 #include "imap.h"
 #include <set>
+#include <functional>
 #include "RootNode.h"
 #include "os/fs.h"
 #include "stream/MapResourceStream.h"
@@ -49,6 +50,7 @@ public:
 	virtual void rename(const std::string& fullPath) override;
 
 	virtual bool load() override;
+	virtual bool loadLayers(const std::set<int>& layerIds) override;
     virtual bool isReadOnly() override;
 	virtual void save(const MapFormatPtr& mapFormat = MapFormatPtr()) override;
 
@@ -66,6 +68,15 @@ public:
 	static void saveFile(const MapFormat& format, const scene::IMapRootNodePtr& root,
 						 const GraphTraversalFunc& traverse, const std::string& filename);
 
+	// Export the map contents to the given streams using the given MapFormat export module.
+	// The info file is only written if the stream is non-null and the format allows it.
+	// Throws an OperationException if the user cancels the operation
+	static void exportToStreams(const MapFormat& format, const scene::IMapRootNodePtr& root,
+						 const GraphTraversalFunc& traverse, std::ostream& mapStream, std::ostream* infoFileStream);
+
+    // The full path of the map file, which is the path within the VFS prepended by its root folder
+    std::string getAbsoluteResourcePath();
+
 protected:
     // Implementation-specific method to open the stream of the primary .map or .mapx file
     // May return an empty reference, may throw OperationException on failure
@@ -75,13 +86,16 @@ protected:
     // May return an empty reference, may throw OperationException on failure
     virtual stream::MapResourceStream::Ptr openInfofileStream();
 
+    // Returns true if this resource is allowed to use the binary map cache
+    // next to the map file on disk (see MapCache)
+    virtual bool canUseMapCache();
+
     // Returns true if the file can be written to. Also returns true if the file
     // doesn't exist (assuming the file can always be created).
     static bool FileIsWriteable(const fs::path& path);
 
 private:
     void constructPaths(const std::string& resourcePath);
-    std::string getAbsoluteResourcePath();
 
     void refreshLastModifiedTime();
 	void mapSave();
@@ -90,7 +104,20 @@ private:
 	// Create a backup copy of the map (used before saving)
 	bool saveBackup();
 
-	RootNodePtr loadMapNode();
+	// Loads the root from the map file. If a node filter is given, only the nodes accepted
+	// by it are parsed (see Doom3MapReader::setNodeFilter), the map cache is not used then.
+	RootNodePtr loadMapNode(const std::function<bool(std::size_t)>& nodeFilter = {});
+
+	// Returns the node filter accepting the nodes of the given layers, as listed in
+	// the info file. Returns an empty function if no layer information is available.
+	std::function<bool(std::size_t)> createLayerNodeFilter(const std::set<int>& layerIds);
+
+    // Loads the root from the map cache, returns an empty reference if the
+    // cache is missing, out of date or unreadable (throws on cancel)
+    RootNodePtr loadMapNodeFromCache();
+
+    // Writes the map cache of the given root if the map file is large enough
+    void writeMapCache(const MapFormat& format, const scene::IMapRootNodePtr& root, std::size_t expectedNodeCount = 0);
 
 	// Opens a stream for the given path, which might be VFS path or an absolute one. 
     // Throws IMapResource::OperationException on stream open failure.
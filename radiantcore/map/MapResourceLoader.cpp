@@ -6,6 +6,7 @@
 #include "scenelib.h"
 #include "algorithm/MapImporter.h"
 #include "messages/MapFileOperation.h"
+#include "OperationReport.h"
 
 namespace map
 {
@@ -16,6 +17,14 @@ MapResourceLoader::MapResourceLoader(std::istream& stream, const MapFormat& form
 {}
 
 RootNodePtr MapResourceLoader::load()
+{
+    return load([&](IMapImportFilter& importFilter)
+    {
+        return _format.getMapReader(importFilter);
+    });
+}
+
+RootNodePtr MapResourceLoader::load(const std::function<IMapReaderPtr(IMapImportFilter&)>& createReader)
 {
     // Create a new map root node
     auto root = std::make_shared<RootNode>("");
@@ -26,12 +35,15 @@ RootNodePtr MapResourceLoader::load()
         MapImporter importFilter(root, _stream);
 
         // Acquire a map reader/parser
-        IMapReaderPtr reader = _format.getMapReader(importFilter);
+        IMapReaderPtr reader = createReader(importFilter);
 
         rMessage() << "Using " << _format.getMapFormatName() << " format to load the data." << std::endl;
 
-        // Start parsing
-        reader->readFromStream(_stream);
+        // Start parsing, the time not spent in any nested phase is the one of the tokeniser
+        {
+            OperationReport::ScopedPhase phase(OperationReport::Phase::Tokenising);
+            reader->readFromStream(_stream);
+        }
 
         // Prepare child primitives
         scene::addOriginToChildPrimitives(root);
@@ -60,6 +72,11 @@ RootNodePtr MapResourceLoader::load()
     }
 }
 
+std::size_t MapResourceLoader::getNumLoadedNodes() const
+{
+    return _indexMapping.size();
+}
+
 void MapResourceLoader::loadInfoFile(std::istream& stream, const RootNodePtr& root)
 {
     if (!stream.good())
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <istream>
 
 #include "imapresource.h"
@@ -33,6 +34,13 @@ public:
     // Throws IMapResource::OperationException on failure or cancel
     RootNodePtr load();
 
+    // Process the stream passed to the constructor using the reader created
+    // by the given function instead of the format's map reader
+    RootNodePtr load(const std::function<IMapReaderPtr(IMapImportFilter&)>& createReader);
+
+    // The number of entities and primitives passed to the import filter
+    std::size_t getNumLoadedNodes() const;
+
     // Load the info file from the given stream, apply it to the root node
     void loadInfoFile(std::istream& stream, const RootNodePtr& root);
 };
@@ -2,6 +2,7 @@
 
 #include "ifilesystem.h"
 #include "ifiletypes.h"
+#include "itaskscheduler.h"
 #include "itextstream.h"
 #include "os/path.h"
 #include "module/StaticModule.h"
@@ -29,6 +30,31 @@ IMapResourcePtr MapResourceManager::createFromArchiveFile(const std::string& arc
     return std::make_shared<ArchivedMapResource>(archivePath, filePathWithinArchive);
 }
 
+scene::IMapRootNodePtr MapResourceManager::createPrefabCopy(const std::string& path)
+{
+    return _prefabCache.createCopy(path);
+}
+
+AABB MapResourceManager::getPrefabBounds(const std::string& path)
+{
+    return _prefabCache.getBounds(path);
+}
+
+void MapResourceManager::preloadPrefab(const std::string& path)
+{
+    _prefabCache.preload(path);
+}
+
+bool MapResourceManager::isPrefabCached(const std::string& path)
+{
+    return _prefabCache.isCached(path);
+}
+
+sigc::signal<void(const std::string&)>& MapResourceManager::signal_prefabPreloaded()
+{
+    return _prefabCache.signal_prefabPreloaded();
+}
+
 MapResourceManager::ExportEvent& MapResourceManager::signal_onResourceExporting()
 {
 	return _resourceExporting;
@@ -54,6 +80,7 @@ const StringSet& MapResourceManager::getDependencies() const
 		_dependencies.insert(MODULE_VIRTUALFILESYSTEM);
 		_dependencies.insert(MODULE_FILETYPES);
 		_dependencies.insert("Doom3MapLoader");
+		_dependencies.insert(MODULE_TASKSCHEDULER);
 	}
 
 	return _dependencies;
@@ -63,6 +90,12 @@ void MapResourceManager::initialiseModule(const IApplicationContext& ctx)
 {
 }
 
+void MapResourceManager::shutdownModule()
+{
+    // The cached prefabs are referencing entity classes and materials
+    _prefabCache.clear();
+}
+
 // Define the MapResourceManager registerable module
 module::StaticModuleRegistration<MapResourceManager> mapResourceManagerModule;
 
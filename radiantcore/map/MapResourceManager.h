@@ -2,6 +2,7 @@
 
 #include "imapresource.h"
 #include "map/MapResource.h"
+#include "map/PrefabCache.h"
 
 namespace map
 {
@@ -13,11 +14,19 @@ private:
 	ExportEvent _resourceExporting;
 	ExportEvent _resourceExported;
 
+	PrefabCache _prefabCache;
+
 public:
 	IMapResourcePtr createFromPath(const std::string& path) override;
     IMapResourcePtr createFromArchiveFile(const std::string& archivePath,
         const std::string& filePathWithinArchive) override;
 
+    scene::IMapRootNodePtr createPrefabCopy(const std::string& path) override;
+    AABB getPrefabBounds(const std::string& path) override;
+    void preloadPrefab(const std::string& path) override;
+    bool isPrefabCached(const std::string& path) override;
+    sigc::signal<void(const std::string&)>& signal_prefabPreloaded() override;
+
 	ExportEvent& signal_onResourceExporting() override;
 	ExportEvent& signal_onResourceExported() override;
 
@@ -25,6 +34,7 @@ public:
 	virtual const std::string& getName() const override;
 	virtual const StringSet& getDependencies() const override;
 	virtual void initialiseModule(const IApplicationContext& ctx) override;
+	virtual void shutdownModule() override;
 };
 
 }
@@ -0,0 +1,218 @@
+#include "OperationReport.h"
+
+#include <algorithm>
+#include <fstream>
+#include "icounter.h"
+#include "imodule.h"
+#include "itextstream.h"
+#include <fmt/format.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(POSIX)
+#include <sys/resource.h>
+#endif
+
+namespace map
+{
+
+namespace
+{
+    // The innermost phase running on this thread
+    thread_local OperationReport::ScopedPhase* currentPhase = nullptr;
+
+    inline double getMilliseconds(std::chrono::steady_clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+}
+
+OperationReport::ScopedPhase::ScopedPhase(Phase phase) :
+    _report(ActiveReport().load()),
+    _phase(phase),
+    _nestedTime(std::chrono::steady_clock::duration::zero()),
+    _enclosingPhase(currentPhase),
+    _traceEvent("map", GetPhaseName(phase))
+{
+    if (_report == nullptr) return;
+
+    currentPhase = this;
+    _start = std::chrono::steady_clock::now();
+}
+
+OperationReport::ScopedPhase::~ScopedPhase()
+{
+    if (_report == nullptr) return;
+
+    auto duration = std::chrono::steady_clock::now() - _start;
+
+    _report->addTime(_phase, duration - _nestedTime);
+
+    if (_enclosingPhase != nullptr)
+    {
+        _enclosingPhase->_nestedTime += duration;
+    }
+
+    currentPhase = _enclosingPhase;
+}
+
+OperationReport::OperationReport(Type type, const std::string& mapName) :
+    _type(type),
+    _mapName(mapName),
+    _start(std::chrono::steady_clock::now())
+{
+    for (auto& nanoseconds : _phaseNanoseconds)
+    {
+        nanoseconds = 0;
+    }
+
+    for (auto& counter : _counters)
+    {
+        counter = 0;
+    }
+
+    _previousReport = ActiveReport().exchange(this);
+}
+
+OperationReport::~OperationReport()
+{
+    ActiveReport().store(_previousReport);
+}
+
+void OperationReport::finish()
+{
+    auto totalMilliseconds = getMilliseconds(std::chrono::steady_clock::now() - _start);
+    auto peakMemory = GetPeakMemoryUsage();
+
+    auto& counters = GlobalCounters();
+
+    std::size_t entities = counters.getCounter(counterEntities).get();
+    std::size_t brushes = counters.getCounter(counterBrushes).get();
+    std::size_t patches = counters.getCounter(counterPatches).get();
+
+    auto operationName = _type == Type::Load ? "load" : "save";
+
+    std::string text = fmt::format("--- Map {0} report: {1} ---\n", operationName, _mapName);
+    std::string phasesJson;
+
+    double accountedMilliseconds = 0;
+
+    for (std::size_t i = 0; i < _phaseNanoseconds.size(); ++i)
+    {
+        auto phase = static_cast<Phase>(i);
+
+        if (!includesPhase(phase)) continue;
+
+        auto milliseconds = _phaseNanoseconds[i].load() / 1e6;
+        accountedMilliseconds += milliseconds;
+
+        text += fmt::format("{0:<24} {1:10.1f} ms\n", GetPhaseName(phase), milliseconds);
+        phasesJson += fmt::format("{0}\n    \"{1}\": {2:.3f}", phasesJson.empty() ? "" : ",", GetPhaseName(phase), milliseconds);
+    }
+
+    text += fmt::format("{0:<24} {1:10.1f} ms\n", "Other", std::max(totalMilliseconds - accountedMilliseconds, 0.0));
+    text += fmt::format("{0:<24} {1:10.1f} ms\n", "Total", totalMilliseconds);
+    text += fmt::format("{0} entities, {1} brushes, {2} patches", entities, brushes, patches);
+
+    if (_type == Type::Load)
+    {
+        text += fmt::format(", {0} models, {1} materials",
+            _counters[static_cast<std::size_t>(Counter::Models)].load(),
+            _counters[static_cast<std::size_t>(Counter::Materials)].load());
+    }
+
+    text += fmt::format("\nPeak memory usage: {0:.1f} MB", peakMemory / (1024.0 * 1024.0));
+
+    rMessage() << text << std::endl;
+
+    auto filename = module::GlobalModuleRegistry().getApplicationContext().getCacheDataPath() +
+        fmt::format("map_{0}_report.json", operationName);
+
+    std::ofstream stream(filename, std::ios::trunc);
+
+    if (!stream.is_open())
+    {
+        rWarning() << "Could not write the map " << operationName << " report to " << filename << std::endl;
+        return;
+    }
+
+    stream << fmt::format("{{\n  \"operation\": \"{0}\",\n  \"map\": \"{1}\",\n  \"totalMs\": {2:.3f},\n  \"phasesMs\": {{{3}\n  }},\n",
+        operationName, util::TraceRecorder::EscapeJson(_mapName), totalMilliseconds, phasesJson);
+    stream << fmt::format("  \"entities\": {0},\n  \"brushes\": {1},\n  \"patches\": {2},\n  \"models\": {3},\n  \"materials\": {4},\n",
+        entities, brushes, patches,
+        _counters[static_cast<std::size_t>(Counter::Models)].load(),
+        _counters[static_cast<std::size_t>(Counter::Materials)].load());
+    stream << fmt::format("  \"peakMemoryBytes\": {0}\n}}\n", peakMemory);
+}
+
+void OperationReport::Increment(Counter counter)
+{
+    if (auto report = ActiveReport().load(); report != nullptr)
+    {
+        ++report->_counters[static_cast<std::size_t>(counter)];
+    }
+}
+
+const char* OperationReport::GetPhaseName(Phase phase)
+{
+    switch (phase)
+    {
+    case Phase::Tokenising: return "Tokenising";
+    case Phase::PrimitiveParsing: return "Primitive parsing";
+    case Phase::EntityCreation: return "Entity creation";
+    case Phase::ModelLoading: return "Model loading";
+    case Phase::MaterialResolution: return "Material resolution";
+    case Phase::BRepBuilding: return "BRep building";
+    case Phase::OctreeInsertion: return "Octree insertion";
+    case Phase::RenderablePreparation: return "Renderable preparation";
+    case Phase::Backup: return "Backup";
+    case Phase::Writing: return "Writing";
+    case Phase::CacheWriting: return "Cache writing";
+    default: return "Unknown";
+    }
+}
+
+std::size_t OperationReport::GetPeakMemoryUsage()
+{
+#if defined(WIN32)
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return static_cast<std::size_t>(counters.PeakWorkingSetSize);
+    }
+#elif defined(POSIX)
+    rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+#ifdef __APPLE__
+        return static_cast<std::size_t>(usage.ru_maxrss); // bytes
+#else
+        return static_cast<std::size_t>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+    }
+#endif
+
+    return 0;
+}
+
+std::atomic<OperationReport*>& OperationReport::ActiveReport()
+{
+    static std::atomic<OperationReport*> _activeReport(nullptr);
+    return _activeReport;
+}
+
+void OperationReport::addTime(Phase phase, std::chrono::steady_clock::duration duration)
+{
+    _phaseNanoseconds[static_cast<std::size_t>(phase)] +=
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+bool OperationReport::includesPhase(Phase phase) const
+{
+    return _type == Type::Load ? phase < Phase::Backup : phase >= Phase::Backup;
+}
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include "time/TraceRecorder.h"
+
+namespace map
+{
+
+/**
+ * Collects the time spent in the phases of a map load or save operation,
+ * along with the number of processed objects and the peak memory usage of
+ * the process. The finished report is written to the console and to a JSON
+ * file in the cache folder (map_load_report.json or map_save_report.json).
+ *
+ * An operation report is active between its construction and its destruction.
+ * The code doing the actual work (parsers, model loaders, the render system)
+ * is adding its phases through ScopedPhase, which costs a clock query only.
+ * Nested phases are not counted twice, the enclosing phase only gets the time
+ * not spent in the nested ones. Phases running on worker threads add their
+ * own time, such that they might add up to more than the wall clock time.
+ */
+class OperationReport
+{
+public:
+    enum class Type
+    {
+        Load,
+        Save,
+    };
+
+    enum class Phase
+    {
+        // Load phases
+        Tokenising,
+        PrimitiveParsing,
+        EntityCreation,
+        ModelLoading,
+        MaterialResolution,
+        BRepBuilding,
+        OctreeInsertion,
+        RenderablePreparation,
+
+        // Save phases
+        Backup,
+        Writing,
+        CacheWriting,
+
+        NumPhases
+    };
+
+    enum class Counter
+    {
+        Models,
+        Materials,
+
+        NumCounters
+    };
+
+    // Adds the time spent in its lifetime to the given phase of the active report
+    class ScopedPhase
+    {
+    private:
+        OperationReport* _report;
+        Phase _phase;
+        std::chrono::steady_clock::time_point _start;
+
+        // Time spent in nested phases, to be subtracted from this one
+        std::chrono::steady_clock::duration _nestedTime;
+
+        ScopedPhase* _enclosingPhase;
+        util::ScopedTraceEvent _traceEvent;
+
+    public:
+        ScopedPhase(Phase phase);
+        ~ScopedPhase();
+
+        ScopedPhase(const ScopedPhase& other) = delete;
+        ScopedPhase& operator=(const ScopedPhase& other) = delete;
+    };
+
+private:
+    Type _type;
+    std::string _mapName;
+    std::chrono::steady_clock::time_point _start;
+
+    std::array<std::atomic<std::int64_t>, static_cast<std::size_t>(Phase::NumPhases)> _phaseNanoseconds;
+    std::array<std::atomic<std::size_t>, static_cast<std::size_t>(Counter::NumCounters)> _counters;
+
+    OperationReport* _previousReport;
+
+public:
+    // Starts the report and makes it the active one
+    OperationReport(Type type, const std::string& mapName);
+    ~OperationReport();
+
+    OperationReport(const OperationReport& other) = delete;
+    OperationReport& operator=(const OperationReport& other) = delete;
+
+    // Stops the clock, writes the report to the console and the JSON file
+    void finish();
+
+    // Increments the given counter of the active report, if there is one
+    static void Increment(Counter counter);
+
+    static const char* GetPhaseName(Phase phase);
+
+    // The peak resident memory of this process in bytes, 0 if unknown
+    static std::size_t GetPeakMemoryUsage();
+
+private:
+    static std::atomic<OperationReport*>& ActiveReport();
+
+    void addTime(Phase phase, std::chrono::steady_clock::duration duration);
+    bool includesPhase(Phase phase) const;
+};
+
+}
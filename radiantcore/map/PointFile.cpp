@@ -6,6 +6,7 @@
 #include "icameraview.h"
 #include "imap.h"
 #include "iorthoview.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 
@@ -24,12 +25,22 @@ namespace map
 namespace
 {
     const Colour4b RED(255, 0, 0, 1);
+
+    // Upper limit for the number of points uploaded in a single geometry slot
+    constexpr std::size_t MAX_POINTS_PER_CHUNK = 4096;
+
+    // Camera speed of the FollowLeak animation in units per second, if not specified otherwise
+    constexpr double DEFAULT_ANIMATION_SPEED = 128.0;
+
+    constexpr std::size_t ANIMATION_INTERVAL_MSECS = 16;
 }
 
 // Constructor
 PointFile::PointFile() :
 	_curPos(0),
-    _renderable(_points)
+	_animationStartDistance(0),
+	_animationSpeed(DEFAULT_ANIMATION_SPEED),
+	_animationRunning(false)
 {
     GlobalCommandSystem().addCommand(
         "NextLeakSpot", sigc::mem_fun(*this, &PointFile::nextLeakSpot)
@@ -37,10 +48,16 @@ PointFile::PointFile() :
     GlobalCommandSystem().addCommand(
         "PrevLeakSpot", sigc::mem_fun(*this, &PointFile::prevLeakSpot)
     );
+    GlobalCommandSystem().addCommand(
+        "FollowLeak", sigc::mem_fun(*this, &PointFile::followLeak),
+        { cmd::ARGTYPE_DOUBLE | cmd::ARGTYPE_OPTIONAL }
+    );
 }
 
 PointFile::~PointFile()
 {
+    // Make sure no more frames are signalled once we're gone
+    _animationTimer.reset();
 }
 
 void PointFile::onMapEvent(IMap::MapEvent ev)
@@ -56,26 +73,25 @@ bool PointFile::isVisible() const
 	return !_points.empty();
 }
 
+sigc::signal<void>& PointFile::signal_animationFrame()
+{
+    return _sigAnimationFrame;
+}
+
 void PointFile::show(const fs::path& pointfile)
 {
+    stopAnimation();
+
+    // Any previous trace is replaced
+    clear();
+
 	// Update the status if required
 	if (!pointfile.empty())
 	{
-		// Parse the pointfile from disk
-		parse(pointfile);
-
-        // Construct shader if needed, and activate rendering
+        // Construct shader if needed, the chunks are uploaded while parsing
         auto renderSystem = GlobalMapModule().getRoot()->getRenderSystem();
 
-        if (renderSystem)
-        {
-            _renderable.update(renderSystem->capture(BuiltInShaderType::PointTraceLines));
-        }
-	}
-	else if (isVisible())
-    {
-        _points.clear();
-        _renderable.clear();
+        parse(pointfile, renderSystem ? renderSystem->capture(BuiltInShaderType::PointTraceLines) : ShaderPtr());
 	}
 
 	// Regardless whether hide or show, we reset the current position
@@ -85,7 +101,16 @@ void PointFile::show(const fs::path& pointfile)
 	SceneChangeNotify();
 }
 
-void PointFile::parse(const fs::path& pointfile)
+void PointFile::clear()
+{
+    _renderables.clear();
+    _points.clear();
+    _points.shrink_to_fit();
+    _distances.clear();
+    _distances.shrink_to_fit();
+}
+
+void PointFile::parse(const fs::path& pointfile, const ShaderPtr& shader)
 {
     // Open the first pointfile and get its input stream if possible
 	std::ifstream inFile(pointfile);
@@ -96,12 +121,94 @@ void PointFile::parse(const fs::path& pointfile)
         );
     }
 
-    // Construct vertices from parsed point data
-    PointTrace trace(inFile);
-    for (auto pos: trace.points())
+    std::size_t chunkStart = 0;
+
+    auto finishChunk = [&]()
+    {
+        auto numPoints = _points.size() - chunkStart;
+
+        if (numPoints < 2) return;
+
+        _renderables.emplace_back(std::make_unique<RenderablePointFile>(_points, chunkStart, numPoints, RED));
+
+        // The chunk is uploaded right away, its vertices are not kept around
+        if (shader)
+        {
+            _renderables.back()->update(shader);
+        }
+
+        // The next chunk starts at the last point of this one
+        chunkStart = _points.size() - 1;
+    };
+
+    PointTrace::ForEachPoint(inFile, [&](const Vector3& point)
+    {
+        _distances.push_back(_points.empty() ? 0.0 : _distances.back() + (point - _points.back()).getLength());
+        _points.push_back(point);
+
+        if (_points.size() - chunkStart == MAX_POINTS_PER_CHUNK)
+        {
+            finishChunk();
+        }
+    });
+
+    finishChunk();
+
+    rMessage() << "Loaded " << _points.size() << " points from " << pointfile.string() <<
+        " in " << _renderables.size() << " chunks" << std::endl;
+}
+
+Vector3 PointFile::getPositionAtDistance(double distance, std::size_t& segment) const
+{
+    // Find the last point which is not further away from the start than the given distance
+    auto next = std::upper_bound(_distances.begin(), _distances.end(), distance);
+
+    segment = next == _distances.begin() ? 0 : static_cast<std::size_t>(next - _distances.begin()) - 1;
+    segment = std::min(segment, _points.size() - 2);
+
+    auto segmentLength = _distances[segment + 1] - _distances[segment];
+
+    if (segmentLength <= 0)
     {
-        _points.emplace_back(pos, RED);
+        return _points[segment];
     }
+
+    auto fraction = std::clamp((distance - _distances[segment]) / segmentLength, 0.0, 1.0);
+
+    return _points[segment] + (_points[segment + 1] - _points[segment]) * fraction;
+}
+
+void PointFile::setCameraPosition(const Vector3& position, const Vector3& target)
+{
+	try
+	{
+		auto& cam = GlobalCameraManager().getActiveView();
+
+		cam.setCameraOrigin(position);
+
+		if (module::GlobalModuleRegistry().moduleExists(MODULE_ORTHOVIEWMANAGER))
+		{
+			GlobalXYWndManager().setOrigin(position);
+		}
+
+		{
+			Vector3 dir((target - cam.getCameraOrigin()).getNormalised());
+			Vector3 angles(cam.getCameraAngles());
+
+			angles[camera::CAMERA_YAW] = radians_to_degrees(atan2(dir[1], dir[0]));
+			angles[camera::CAMERA_PITCH] = radians_to_degrees(asin(dir[2]));
+
+			cam.setCameraAngles(angles);
+		}
+
+		// Redraw the scene
+		SceneChangeNotify();
+	}
+	catch (const std::runtime_error& ex)
+	{
+		rError() << "Cannot set camera view position: " << ex.what() << std::endl;
+		stopAnimation();
+	}
 }
 
 // advance camera to previous point
@@ -112,6 +219,9 @@ void PointFile::advance(bool forward)
 		return;
 	}
 
+	// Stepping through the points takes over from a running animation
+	stopAnimation();
+
 	if (forward)
 	{
 		if (_curPos + 2 >= _points.size())
@@ -133,34 +243,61 @@ void PointFile::advance(bool forward)
 		_curPos--;
 	}
 
-	try
-	{
-		auto& cam = GlobalCameraManager().getActiveView();
+	setCameraPosition(_points[_curPos], _points[_curPos + 1]);
+}
 
-		cam.setCameraOrigin(_points[_curPos].vertex);
+void PointFile::startAnimation(double speed)
+{
+    // Continue from the current leak spot, restart if we reached the end
+    if (_curPos + 2 >= _points.size())
+    {
+        _curPos = 0;
+    }
 
-		if (module::GlobalModuleRegistry().moduleExists(MODULE_ORTHOVIEWMANAGER))
-		{
-			GlobalXYWndManager().setOrigin(_points[_curPos].vertex);
-		}
+    _animationSpeed = speed;
+    _animationStartDistance = _distances[_curPos];
+    _animationStartTime = std::chrono::steady_clock::now();
+    _animationRunning = true;
 
-		{
-			Vector3 dir((_points[_curPos + 1].vertex - cam.getCameraOrigin()).getNormalised());
-			Vector3 angles(cam.getCameraAngles());
+    if (!_animationTimer)
+    {
+        // The timer thread only signals the frames, the camera is moved on the main thread
+        _animationTimer = std::make_unique<util::Timer>(ANIMATION_INTERVAL_MSECS,
+            [this]() { _sigAnimationFrame.emit(); });
+    }
 
-			angles[camera::CAMERA_YAW] = radians_to_degrees(atan2(dir[1], dir[0]));
-			angles[camera::CAMERA_PITCH] = radians_to_degrees(asin(dir[2]));
+    _animationTimer->start();
+}
 
-			cam.setCameraAngles(angles);
-		}
+void PointFile::stopAnimation()
+{
+    if (!_animationRunning) return;
 
-		// Redraw the scene
-		SceneChangeNotify();
-	}
-	catch (const std::runtime_error& ex)
-	{
-		rError() << "Cannot set camera view position: " << ex.what() << std::endl;
-	}
+    _animationRunning = false;
+    _animationTimer->stop();
+}
+
+void PointFile::updateAnimation()
+{
+    if (!_animationRunning || _points.size() < 2) return;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _animationStartTime;
+    auto distance = _animationStartDistance + elapsed.count() * _animationSpeed;
+
+    std::size_t segment = 0;
+    auto position = getPositionAtDistance(distance, segment);
+
+    // NextLeakSpot and PrevLeakSpot continue from the segment we're passing
+    _curPos = segment;
+
+    if (distance >= _distances.back())
+    {
+        rMessage() << "End of pointfile" << std::endl;
+        stopAnimation();
+        return;
+    }
+
+    setCameraPosition(position, _points[segment + 1]);
 }
 
 void PointFile::nextLeakSpot(const cmd::ArgumentList& args)
@@ -173,4 +310,28 @@ void PointFile::prevLeakSpot(const cmd::ArgumentList& args)
 	advance(false);
 }
 
+void PointFile::followLeak(const cmd::ArgumentList& args)
+{
+    if (_animationRunning)
+    {
+        stopAnimation();
+        return;
+    }
+
+    if (_points.size() < 2)
+    {
+        rMessage() << "No pointfile loaded" << std::endl;
+        return;
+    }
+
+    auto speed = !args.empty() ? args[0].getDouble() : DEFAULT_ANIMATION_SPEED;
+
+    if (speed <= 0)
+    {
+        throw cmd::ExecutionFailure(_("FollowLeak: the speed must be positive"));
+    }
+
+    startAnimation(speed);
+}
+
 } // namespace map
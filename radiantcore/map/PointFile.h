@@ -1,11 +1,14 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
 #include <vector>
+#include <sigc++/signal.h>
 #include "irender.h"
 #include "imap.h"
 #include "icommandsystem.h"
 #include "math/Vector3.h"
-#include "render/VertexCb.h"
+#include "time/Timer.h"
 #include "RenderablePointFile.h"
 
 namespace map
@@ -15,12 +18,26 @@ namespace map
 class PointFile
 {
 	// Vector of point coordinates
-	std::vector<VertexCb> _points;
+	std::vector<Vector3> _points;
+
+	// Length of the trace from the first point up to each point,
+	// used to locate the segment at a given distance by binary search
+	std::vector<double> _distances;
 
 	// Holds the current position in the point file chain
 	std::size_t _curPos;
 
-    RenderablePointFile _renderable;
+	// The trace is split into chunks with a bounded number of points each
+	std::vector<std::unique_ptr<RenderablePointFile>> _renderables;
+
+	// Animation moving the camera along the trace
+	std::unique_ptr<util::Timer> _animationTimer;
+	std::chrono::steady_clock::time_point _animationStartTime;
+	double _animationStartDistance;
+	double _animationSpeed;
+	bool _animationRunning;
+
+	sigc::signal<void> _sigAnimationFrame;
 
 public:
 	// Constructor
@@ -37,6 +54,12 @@ public:
     /// Show the specified pointfile, or hide if the path is empty
 	void show(const fs::path& pointfile);
 
+	// Emitted by the animation timer thread, see IMap::signal_pointTraceAnimationFrame
+	sigc::signal<void>& signal_animationFrame();
+
+	// Moves the camera to the current animation position, to be called on the main thread
+	void updateAnimation();
+
 private:
 
 	/**
@@ -45,13 +68,27 @@ private:
 	 */
 	void advance(bool forward);
 
+	// Places the camera at the given position, looking at the given target
+	void setCameraPosition(const Vector3& position, const Vector3& target);
+
+	// Returns the position at the given distance along the trace and the
+	// index of the segment it is located on
+	Vector3 getPositionAtDistance(double distance, std::size_t& segment) const;
+
+	void startAnimation(double speed);
+	void stopAnimation();
+
 	// command targets
 	// Toggles visibility of the point file line
 	void nextLeakSpot(const cmd::ArgumentList& args);
 	void prevLeakSpot(const cmd::ArgumentList& args);
+	void followLeak(const cmd::ArgumentList& args);
+
+	// Stream the specified pointfile into the point list, uploading the
+	// renderable chunks to the given shader as soon as they are complete
+	void parse(const fs::path& pointfile, const ShaderPtr& shader);
 
-	// Parse the specified pointfile and read the vectors into the point list
-	void parse(const fs::path& pointfile);
+	void clear();
 };
 
 } // namespace map
@@ -0,0 +1,314 @@
+#include "PrefabCache.h"
+
+#include <sstream>
+#include "i18n.h"
+#include "ientity.h"
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "entitylib.h"
+#include "gamelib.h"
+#include "os/file.h"
+#include "os/path.h"
+#include "registry/registry.h"
+#include "scene/BasicRootNode.h"
+#include "scene/Clone.h"
+#include "scene/PrefabBoundsAccumulator.h"
+#include "scene/Traverse.h"
+#include "MapResource.h"
+#include "fmt/format.h"
+
+namespace map
+{
+
+namespace
+{
+    // Includes the bounds of the top-level entities, the worldspawn is represented
+    // by its primitives, like the nodes that get selected when importing a prefab
+    class EntityBoundsWalker :
+        public scene::NodeVisitor
+    {
+    private:
+        scene::PrefabBoundsAccumulator& _accumulator;
+
+    public:
+        EntityBoundsWalker(scene::PrefabBoundsAccumulator& accumulator) :
+            _accumulator(accumulator)
+        {}
+
+        bool pre(const scene::INodePtr& node) override
+        {
+            if (Node_isWorldspawn(node))
+            {
+                node->traverseChildren(_accumulator);
+            }
+            else
+            {
+                _accumulator.pre(node);
+            }
+
+            return false;
+        }
+    };
+
+    // Map resource parsing the file contents read by a preload task
+    class PrefetchedMapResource final :
+        public MapResource
+    {
+    private:
+        const std::string& _mapContents;
+        const std::string* _infoContents;
+
+    public:
+        PrefetchedMapResource(const std::string& path, const std::string& mapContents, const std::string* infoContents) :
+            MapResource(path),
+            _mapContents(mapContents),
+            _infoContents(infoContents)
+        {}
+
+    protected:
+        stream::MapResourceStream::Ptr openMapfileStream() override
+        {
+            return stream::MapResourceStream::OpenFromContents(_mapContents);
+        }
+
+        stream::MapResourceStream::Ptr openInfofileStream() override
+        {
+            return _infoContents ? stream::MapResourceStream::OpenFromContents(*_infoContents) : stream::MapResourceStream::Ptr();
+        }
+
+        bool canUseMapCache() override
+        {
+            return false; // the contents have been read already
+        }
+    };
+
+    // Reads the whole file at the given absolute or VFS path into the string
+    bool readFileContents(const std::string& path, std::string& contents)
+    {
+        auto stream = stream::MapResourceStream::OpenFromPath(path);
+
+        if (!stream->isOpen()) return false;
+
+        std::stringstream buffer;
+        buffer << stream->getStream().rdbuf();
+        contents = buffer.str();
+
+        return true;
+    }
+
+    bool getFileSizeAndTime(const std::string& path, std::uintmax_t& size, fs::file_time_type& time)
+    {
+        std::error_code error;
+
+        if (!fs::is_regular_file(path, error)) return false;
+
+        size = fs::file_size(path, error);
+        if (error) return false;
+
+        time = fs::last_write_time(path, error);
+        return !error;
+    }
+}
+
+bool PrefabCache::getFileStamp(const std::string& fullPath, const std::string& path, Entry& stamp)
+{
+    if (getFileSizeAndTime(fullPath, stamp.fileSize, stamp.modificationTime))
+    {
+        return true;
+    }
+
+    // Files within archives are stamped with the archive they're contained in
+    auto archivePath = GlobalFileSystem().getFileInfo(path).getArchivePath();
+
+    return !archivePath.empty() && getFileSizeAndTime(archivePath, stamp.fileSize, stamp.modificationTime);
+}
+
+scene::IMapRootNodePtr PrefabCache::createCopy(const std::string& path)
+{
+    auto root = getPrefabRoot(path);
+
+    auto copy = std::make_shared<scene::BasicRootNode>();
+    scene::cloneNodesIntoRoot(root, scene::traverse, copy);
+
+    return copy;
+}
+
+AABB PrefabCache::getBounds(const std::string& path)
+{
+    auto root = getPrefabRoot(path);
+
+    // The nodes are keeping their bounds once they have been calculated
+    scene::PrefabBoundsAccumulator accumulator;
+    EntityBoundsWalker walker(accumulator);
+    root->traverseChildren(walker);
+
+    return accumulator.getBounds();
+}
+
+void PrefabCache::clear()
+{
+    for (const auto& [_, pending] : _pendingPreloads)
+    {
+        pending.task->cancel();
+    }
+
+    _pendingPreloads.clear();
+    _entries.clear();
+}
+
+scene::IMapRootNodePtr PrefabCache::getPrefabRoot(const std::string& path)
+{
+    MapResource resource(path);
+    auto fullPath = resource.getAbsoluteResourcePath();
+
+    Entry stamp;
+    bool fileIsCacheable = getFileStamp(fullPath, path, stamp);
+
+    if (!fileIsCacheable)
+    {
+        _entries.erase(fullPath);
+    }
+    else if (auto cachedRoot = findCachedRoot(fullPath, stamp); cachedRoot)
+    {
+        return cachedRoot;
+    }
+
+    // Throws on failure
+    if (!resource.load())
+    {
+        throw IMapResource::OperationException(fmt::format(_("Could not load prefab {0}"), path));
+    }
+
+    auto root = resource.getRootNode();
+
+    if (fileIsCacheable)
+    {
+        stamp.root = root;
+        _entries.emplace(fullPath, std::move(stamp));
+    }
+
+    return root;
+}
+
+scene::IMapRootNodePtr PrefabCache::findCachedRoot(const std::string& fullPath, const Entry& stamp)
+{
+    auto existing = _entries.find(fullPath);
+
+    if (existing == _entries.end()) return {};
+
+    if (existing->second.fileSize == stamp.fileSize && existing->second.modificationTime == stamp.modificationTime)
+    {
+        return existing->second.root;
+    }
+
+    _entries.erase(existing);
+    return {};
+}
+
+void PrefabCache::preload(const std::string& path)
+{
+    MapResource resource(path);
+    auto fullPath = resource.getAbsoluteResourcePath();
+
+    if (_pendingPreloads.count(fullPath) > 0) return;
+
+    Entry stamp;
+
+    // Files that can't be stamped wouldn't be kept in the cache
+    if (!getFileStamp(fullPath, path, stamp) || findCachedRoot(fullPath, stamp)) return;
+
+    auto files = std::make_shared<PrefetchedFiles>();
+
+    // Decide on the info file here, the worker is just reading
+    auto infoFilePath = os::replaceExtension(fullPath, game::current::getInfoFileExtension());
+
+    if (path_is_absolute(infoFilePath.c_str()) ? os::fileOrDirExists(infoFilePath) : GlobalFileSystem().getFileCount(infoFilePath) > 0)
+    {
+        files->infoFilePath = infoFilePath;
+    }
+
+    auto task = GlobalTaskScheduler().submitWithContinuation([fullPath, files](const threading::ITask& task)
+    {
+        files->mapFileRead = readFileContents(fullPath, files->mapContents);
+
+        if (files->mapFileRead && !files->infoFilePath.empty() && !task.isCancellationRequested())
+        {
+            files->infoFileRead = readFileContents(files->infoFilePath, files->infoContents);
+        }
+    },
+    [this, path, fullPath, files]()
+    {
+        finishPreload(path, fullPath, files);
+    },
+    threading::TaskPriority::Low);
+
+    _pendingPreloads[fullPath] = PendingPreload{ std::move(stamp), files, task };
+}
+
+void PrefabCache::finishPreload(const std::string& path, const std::string& fullPath,
+    const std::shared_ptr<PrefetchedFiles>& files)
+{
+    auto pending = _pendingPreloads.find(fullPath);
+
+    // Ignore the results of preloads that have been cancelled by clear()
+    if (pending == _pendingPreloads.end() || pending->second.files != files) return;
+
+    auto stamp = std::move(pending->second.stamp);
+    _pendingPreloads.erase(pending);
+
+    if (!files->mapFileRead)
+    {
+        rWarning() << "Could not read prefab " << path << std::endl;
+        return;
+    }
+
+    // Drop the contents if the file changed since the preload has been queued,
+    // or if the prefab has been loaded in the meantime
+    Entry currentStamp;
+
+    if (!getFileStamp(fullPath, path, currentStamp) || currentStamp.fileSize != stamp.fileSize ||
+        currentStamp.modificationTime != stamp.modificationTime || findCachedRoot(fullPath, stamp))
+    {
+        return;
+    }
+
+    // Preloading is never showing the progress dialog
+    registry::ScopedKeyChanger<bool> changer(RKEY_MAP_SUPPRESS_LOAD_STATUS_DIALOG, true);
+
+    PrefetchedMapResource resource(path, files->mapContents, files->infoFileRead ? &files->infoContents : nullptr);
+
+    try
+    {
+        if (!resource.load())
+        {
+            rWarning() << "Could not preload prefab " << path << std::endl;
+            return;
+        }
+    }
+    catch (const IMapResource::OperationException& ex)
+    {
+        rWarning() << "Could not preload prefab " << path << ": " << ex.what() << std::endl;
+        return;
+    }
+
+    stamp.root = resource.getRootNode();
+    _entries.emplace(fullPath, std::move(stamp));
+
+    _sigPrefabPreloaded.emit(path);
+}
+
+bool PrefabCache::isCached(const std::string& path)
+{
+    MapResource resource(path);
+    auto fullPath = resource.getAbsoluteResourcePath();
+
+    Entry stamp;
+    return getFileStamp(fullPath, path, stamp) && findCachedRoot(fullPath, stamp);
+}
+
+sigc::signal<void(const std::string&)>& PrefabCache::signal_prefabPreloaded()
+{
+    return _sigPrefabPreloaded;
+}
+
+}
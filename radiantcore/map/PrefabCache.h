@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <sigc++/signal.h>
+#include "imap.h"
+#include "itaskscheduler.h"
+#include "math/AABB.h"
+#include "os/fs.h"
+
+namespace map
+{
+
+/**
+ * Keeps the scenes of loaded prefabs, such that placing the same prefab
+ * again doesn't need to read and parse its file. The prefabs are identified
+ * by their absolute path, a cached scene is discarded as soon as the size or
+ * the modification time of the file changes. Prefabs in PK4 archives are
+ * stamped with the archive file, files that can't be stamped at all are
+ * loaded every time.
+ *
+ * The cached scenes are never handed out, callers receive clones instead.
+ *
+ * Prefabs can be preloaded in the background: the files are read by a worker
+ * of the task scheduler, the scene is parsed on the main thread afterwards,
+ * since creating the nodes is not thread-safe.
+ */
+class PrefabCache
+{
+private:
+    struct Entry
+    {
+        std::uintmax_t fileSize = 0;
+        fs::file_time_type modificationTime;
+        scene::IMapRootNodePtr root;
+    };
+
+    std::map<std::string, Entry> _entries;
+
+    // The file contents read by a preload task
+    struct PrefetchedFiles
+    {
+        std::string infoFilePath;
+
+        bool mapFileRead = false;
+        std::string mapContents;
+
+        bool infoFileRead = false;
+        std::string infoContents;
+    };
+
+    struct PendingPreload
+    {
+        // The stamp of the file at the time the preload has been queued
+        Entry stamp;
+        std::shared_ptr<PrefetchedFiles> files;
+        threading::TaskPtr task;
+    };
+
+    // Preloads in progress, keyed by absolute path like the entries
+    std::map<std::string, PendingPreload> _pendingPreloads;
+
+    sigc::signal<void(const std::string&)> _sigPrefabPreloaded;
+
+public:
+    // Returns a new scene holding a copy of the prefab at the given VFS or physical path.
+    // Throws IMapResource::OperationException if the prefab cannot be loaded.
+    scene::IMapRootNodePtr createCopy(const std::string& path);
+
+    // Returns the bounds of the prefab at the given path, as calculated by
+    // the PrefabBoundsAccumulator. Throws like createCopy() on load failure.
+    AABB getBounds(const std::string& path);
+
+    // Queues a background load of the given prefab, unless it is cached and
+    // up to date, or its preload is already in progress. Failures are logged only.
+    void preload(const std::string& path);
+
+    // True if the prefab at the given path is cached and up to date
+    bool isCached(const std::string& path);
+
+    // Emitted on the main thread when a preloaded prefab has been added to the cache,
+    // the argument is the path as it has been passed to preload()
+    sigc::signal<void(const std::string&)>& signal_prefabPreloaded();
+
+    // Releases all cached scenes and cancels the pending preloads
+    void clear();
+
+private:
+    // Returns the cached scene of the given prefab, loading it if necessary
+    scene::IMapRootNodePtr getPrefabRoot(const std::string& path);
+
+    // Returns the cached scene if its stamp still matches the given one, removes outdated entries
+    scene::IMapRootNodePtr findCachedRoot(const std::string& fullPath, const Entry& stamp);
+
+    // Creates the scene of a preloaded prefab from the contents read by its task
+    void finishPreload(const std::string& path, const std::string& fullPath,
+        const std::shared_ptr<PrefetchedFiles>& files);
+
+    // Fills in size and modification time of the file, returns false if the file can't be stamped
+    static bool getFileStamp(const std::string& fullPath, const std::string& path, Entry& stamp);
+};
+
+}
@@ -58,12 +58,7 @@ void RegionManager::disable()
     // Create a 64 unit border from the max world coord
     _bounds.extents -= Vector3(1,1,1)*64;
 
-    if (GlobalSceneGraph().root())
-    {
-        // Disable the exclude bit on all the scenegraph nodes
-        ExcludeAllWalker walker(false);
-        GlobalSceneGraph().root()->traverse(walker);
-    }
+    revertRegion();
 }
 
 void RegionManager::enable() {
@@ -74,8 +69,44 @@ void RegionManager::enable() {
     _active = true;
 
     // Show all elements within the current region / hide the outsiders
-    ExcludeRegionedWalker walker(false, _bounds);
-    GlobalSceneGraph().root()->traverse(walker);
+    applyRegion();
+}
+
+void RegionManager::applyRegion()
+{
+    revertRegion();
+
+    if (!GlobalSceneGraph().root()) return;
+
+    _appliedBounds = _bounds;
+
+    // Only the cells not entirely within the region need to be visited,
+    // nodes intersecting the region are kept, like the straddling ones
+    GlobalSceneGraph().foreachNodeByBounds(_appliedBounds,
+        [&](const scene::INodePtr& node, VolumeIntersectionValue intersection)
+    {
+        if (intersection == VOLUME_OUTSIDE)
+        {
+            excludeNode(node, true);
+        }
+    }, false);
+}
+
+void RegionManager::revertRegion()
+{
+    if (!_appliedBounds.isValid()) return;
+
+    if (GlobalSceneGraph().root())
+    {
+        // The nodes within the applied bounds have not been excluded, clear all the other ones
+        GlobalSceneGraph().foreachNodeByBounds(_appliedBounds,
+            [&](const scene::INodePtr& node, VolumeIntersectionValue intersection)
+        {
+            excludeNode(node, false);
+        }, false);
+    }
+
+    _appliedBounds = AABB();
 }
 
 void RegionManager::clear()
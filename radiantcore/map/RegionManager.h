@@ -39,6 +39,9 @@ class RegionManager :
 	// The bounds of this region
 	AABB _bounds;
 
+	// The bounds the nodes have been excluded with, invalid if nothing is excluded
+	AABB _appliedBounds;
+
 	// The brushes around the region boundaries
 	// (legacy array to stay compatible with the ConstructRegionBrushes() function)
 	scene::INodePtr _brushes[6];
@@ -98,6 +101,12 @@ public:
 	void initialiseModule(const IApplicationContext& ctx) override;
 
 private:
+	// Excludes the nodes outside the current bounds, re-including the ones of the previous region
+	void applyRegion();
+
+	// Re-includes the nodes which have been excluded by applyRegion()
+	void revertRegion();
+
 	/** greebo: Adds the bounding brushes that enclose the current region.
 	*/
 	void addRegionBrushes();
@@ -24,62 +24,6 @@ inline void excludeNode(scene::INodePtr node, bool exclude)
 	}
 }
 
-/** greebo: Sets/resets the exclude bit on the visited node
- */
-class ExcludeAllWalker :
-	public scene::NodeVisitor
-{
-	bool _exclude;
-public:
-	ExcludeAllWalker(bool exclude) :
-		_exclude(exclude)
-	{}
-
-	bool pre(const scene::INodePtr& node)
-	{
-		excludeNode(node, _exclude);
-
-		return true;
-	}
-};
-
-/** greebo: Sets the exclusion status of all the objects WITHIN the bounds.
- *
- * All the objects outside the bounds get their status set to the opposite.
- */
-class ExcludeRegionedWalker :
-	public scene::NodeVisitor
-{
-	bool _exclude;
-	// The reference to the currently active region bounds
-	AABB& _regionAABB;
-
-public:
-	ExcludeRegionedWalker(bool exclude, AABB& regionAABB) :
-		_exclude(exclude),
-		_regionAABB(regionAABB)
-	{}
-
-	bool pre(const scene::INodePtr& node)
-	{
-		// Check whether the instance is within the region
-		bool contained = node->worldAABB().intersects(_regionAABB);
-
-		if (contained) {
-			// The contained stuff is set according to the _exclude parameter
-			excludeNode(node, _exclude);
-		}
-		else {
-			// This is an object outside the bounds, set it to !_exclude
-			// as the _exclude should apply to the objects within.
-			excludeNode(node, !_exclude);
-		}
-
-		// Traverse the children as well
-		return true;
-	}
-};
-
 /** greebo: This class is used indirectly by the map saving walker to save the region.
  *
  * The map saving walker calls a function RegionManager::traverseRegion() which
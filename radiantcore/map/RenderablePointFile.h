@@ -1,7 +1,8 @@
 #pragma once
 
+#include <vector>
+#include "math/Vector3.h"
 #include "render/RenderableGeometry.h"
-#include "render/VertexCb.h"
 #include "render/Colour4b.h"
 
 namespace map
@@ -23,28 +24,44 @@ inline Vector4 toVector4(const Colour4b& colour)
 
 }
 
+/**
+ * One chunk of the point trace, rendering the lines between a bounded range
+ * of consecutive points. Consecutive chunks share their boundary point, such
+ * that the line strip is not interrupted. Splitting the trace keeps the size
+ * of every single allocation in the geometry store small, even for huge files.
+ */
 class RenderablePointFile :
     public render::RenderableGeometry
 {
 private:
-    const std::vector<VertexCb>& _points;
+    const std::vector<Vector3>& _points;
+    std::size_t _firstPoint;
+    std::size_t _numPoints;
+    Vector4 _colour;
 
 public:
-    RenderablePointFile(const std::vector<VertexCb>& points) :
-        _points(points)
+    RenderablePointFile(const std::vector<Vector3>& points, std::size_t firstPoint,
+                        std::size_t numPoints, const Colour4b& colour) :
+        _points(points),
+        _firstPoint(firstPoint),
+        _numPoints(numPoints),
+        _colour(detail::toVector4(colour))
     {}
 
 protected:
     void updateGeometry() override
     {
+        if (_numPoints < 2) return;
+
         std::vector<render::RenderVertex> vertices;
         std::vector<unsigned int> indices;
 
-        if (_points.size() < 2) return;
+        vertices.reserve(_numPoints);
+        indices.reserve((_numPoints - 1) * 2);
 
-        for (unsigned int i = 0; i < _points.size(); ++i)
+        for (unsigned int i = 0; i < _numPoints; ++i)
         {
-            vertices.push_back(render::RenderVertex(_points[i].vertex, { 0, 0, 0 }, { 0, 0 }, detail::toVector4(_points[i].colour)));
+            vertices.push_back(render::RenderVertex(_points[_firstPoint + i], { 0, 0, 0 }, { 0, 0 }, _colour));
 
             if (i > 0)
             {
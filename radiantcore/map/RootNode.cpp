@@ -18,6 +18,9 @@ RootNode::RootNode(const std::string& name) :
     _targetManager = GlobalEntityModule().createTargetManager();
     assert(_targetManager);
 
+    _entityClassIndex = GlobalEntityModule().createEntityClassIndex();
+    assert(_entityClassIndex);
+
 	_selectionGroupManager = GlobalSelectionGroupModule().createSelectionGroupManager();
 	assert(_selectionGroupManager);
 
@@ -58,6 +61,11 @@ ITargetManager& RootNode::getTargetManager()
     return *_targetManager;
 }
 
+IEntityClassIndex& RootNode::getEntityClassIndex()
+{
+    return *_entityClassIndex;
+}
+
 selection::ISelectionGroupManager& RootNode::getSelectionGroupManager()
 {
 	return *_selectionGroupManager;
@@ -42,6 +42,8 @@ private:
 
     ITargetManagerPtr _targetManager;
 
+    IEntityClassIndexPtr _entityClassIndex;
+
     selection::ISelectionGroupManager::Ptr _selectionGroupManager;
 
     selection::ISelectionSetManager::Ptr _selectionSetManager;
@@ -65,6 +67,7 @@ public:
     const INamespacePtr& getNamespace() override;
     IMapFileChangeTracker& getUndoChangeTracker() override;
     ITargetManager& getTargetManager() override;
+    IEntityClassIndex& getEntityClassIndex() override;
     selection::ISelectionGroupManager& getSelectionGroupManager() override;
     selection::ISelectionSetManager& getSelectionSetManager() override;
     scene::ILayerManager& getLayerManager() override;
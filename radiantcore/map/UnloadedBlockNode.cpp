@@ -0,0 +1,103 @@
+#include "UnloadedBlockNode.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace map
+{
+
+UnloadedBlockNode::UnloadedBlockNode(Kind kind, const std::string& text, const std::string& formatName) :
+    _kind(kind),
+    _text(text),
+    _formatName(formatName)
+{}
+
+UnloadedBlockNode::Kind UnloadedBlockNode::getKind() const
+{
+    return _kind;
+}
+
+const std::string& UnloadedBlockNode::getText() const
+{
+    return _text;
+}
+
+const std::string& UnloadedBlockNode::getFormatName() const
+{
+    return _formatName;
+}
+
+std::string UnloadedBlockNode::name() const
+{
+    return _kind == Kind::Entity ? "Unloaded entity" : "Unloaded primitive";
+}
+
+scene::INode::Type UnloadedBlockNode::getNodeType() const
+{
+    return Type::UnloadedBlock;
+}
+
+const AABB& UnloadedBlockNode::localAABB() const
+{
+    static AABB _aabb;
+    return _aabb;
+}
+
+void UnloadedBlockNode::onPreRender(const VolumeTest& volume)
+{}
+
+void UnloadedBlockNode::renderHighlights(IRenderableCollector& collector, const VolumeTest& volume)
+{}
+
+std::size_t UnloadedBlockNode::getHighlightFlags()
+{
+    return Highlight::NoHighlight;
+}
+
+void UnloadedBlockNode::setSelected(bool select)
+{}
+
+bool UnloadedBlockNode::isSelected() const
+{
+    return false;
+}
+
+void UnloadedBlockNode::addToGroup(std::size_t groupId)
+{
+    if (std::find(_groups.begin(), _groups.end(), groupId) == _groups.end())
+    {
+        _groups.push_back(groupId);
+    }
+}
+
+void UnloadedBlockNode::removeFromGroup(std::size_t groupId)
+{
+    auto i = std::find(_groups.begin(), _groups.end(), groupId);
+
+    if (i != _groups.end())
+    {
+        _groups.erase(i);
+    }
+}
+
+bool UnloadedBlockNode::isGroupMember()
+{
+    return !_groups.empty();
+}
+
+std::size_t UnloadedBlockNode::getMostRecentGroupId()
+{
+    if (_groups.empty()) throw std::runtime_error("This node is not a member of any group.");
+
+    return _groups.back();
+}
+
+const UnloadedBlockNode::GroupIds& UnloadedBlockNode::getGroupIds() const
+{
+    return _groups;
+}
+
+void UnloadedBlockNode::setSelected(bool select, bool changeGroupStatus)
+{}
+
+}
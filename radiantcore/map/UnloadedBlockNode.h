@@ -0,0 +1,69 @@
+#pragma once
+
+#include "scene/Node.h"
+#include "iselectiongroup.h"
+
+namespace map
+{
+
+/**
+ * Placeholder for an entity or a primitive which has been left unparsed
+ * during a partial map load (see MapResource::loadLayers). It keeps the
+ * text of the block as it was found in the map file, to be written back
+ * unchanged by the map writer of the same format.
+ *
+ * Unloaded entities store their keyvalue lines (without the comments of
+ * the file), their primitives are following as child nodes. The text of an
+ * unloaded primitive starts at its keyword and includes the closing brace
+ * of the primitive block.
+ *
+ * The node is neither rendered nor selectable, but it keeps its group
+ * memberships such that they survive the next save.
+ */
+class UnloadedBlockNode final :
+    public scene::Node,
+    public IGroupSelectable
+{
+public:
+    enum class Kind
+    {
+        Entity,
+        Primitive,
+    };
+
+private:
+    Kind _kind;
+    std::string _text;
+
+    // The name of the map format that read the text
+    std::string _formatName;
+
+    GroupIds _groups;
+
+public:
+    UnloadedBlockNode(Kind kind, const std::string& text, const std::string& formatName);
+
+    Kind getKind() const;
+    const std::string& getText() const;
+    const std::string& getFormatName() const;
+
+    std::string name() const override;
+    Type getNodeType() const override;
+
+    const AABB& localAABB() const override;
+    void onPreRender(const VolumeTest& volume) override;
+    void renderHighlights(IRenderableCollector& collector, const VolumeTest& volume) override;
+    std::size_t getHighlightFlags() override;
+
+    // IGroupSelectable, the selection state itself is ignored
+    void setSelected(bool select) override;
+    bool isSelected() const override;
+    void addToGroup(std::size_t groupId) override;
+    void removeFromGroup(std::size_t groupId) override;
+    bool isGroupMember() override;
+    std::size_t getMostRecentGroupId() override;
+    const GroupIds& getGroupIds() const override;
+    void setSelected(bool select, bool changeGroupStatus) override;
+};
+
+}
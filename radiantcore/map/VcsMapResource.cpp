@@ -67,6 +67,12 @@ stream::MapResourceStream::Ptr VcsMapResource::openInfofileStream()
     return openFileFromVcs(_infoFileUri);
 }
 
+bool VcsMapResource::canUseMapCache()
+{
+    // There's no file on disk the cache could be validated against
+    return false;
+}
+
 stream::MapResourceStream::Ptr VcsMapResource::openFileFromVcs(const std::string& uri)
 {
     if (!_vcsModule || !vcs::pathIsVcsUri(uri))
@@ -26,6 +26,7 @@ public:
 protected:
     virtual stream::MapResourceStream::Ptr openMapfileStream() override;
     virtual stream::MapResourceStream::Ptr openInfofileStream() override;
+    virtual bool canUseMapCache() override;
 
 private:
     stream::MapResourceStream::Ptr openFileFromVcs(const std::string& uri);
@@ -2,7 +2,6 @@
 
 #include "itextstream.h"
 #include "string/convert.h"
-#include "Util.h"
 
 namespace map
 {
@@ -95,19 +94,20 @@ const IAasFile::Area& Doom3AasFile::getArea(int areaNum) const
     return _areas[areaNum];
 }
 
-void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
+void Doom3AasFile::parse(Doom3AasTokenScanner& tok)
 {
     while (tok.hasMoreTokens())
     {
-        std::string token = tok.nextToken();
+        auto token = tok.nextToken();
 
         if (token == "settings")
         {
-            _settings.parseFromTokens(tok);
+            _settingsBlock = tok.nextBlock();
+            parseSettings();
         }
         else if (token == "planes")
         {
-            std::size_t planesCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t planesCount = tok.nextInteger<std::size_t>();
 
             _planes.reserve(planesCount);
 
@@ -116,15 +116,15 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( a b c dist )
             for (std::size_t i = 0; i < planesCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // plane index
+                tok.nextInteger<int>(); // plane index
 
                 tok.assertNextToken("(");
 
                 Plane3 plane;
-                plane.normal().x() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().y() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.normal().z() = string::convert<Vector3::ElementType>(tok.nextToken());
-                plane.dist() = string::convert<Vector3::ElementType>(tok.nextToken());
+                plane.normal().x() = tok.nextDouble();
+                plane.normal().y() = tok.nextDouble();
+                plane.normal().z() = tok.nextDouble();
+                plane.dist() = tok.nextDouble();
 
                 _planes.push_back(plane);
 
@@ -135,7 +135,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "vertices")
         {
-            std::size_t vertCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t vertCount = tok.nextInteger<std::size_t>();
 
             _vertices.reserve(vertCount);
 
@@ -144,15 +144,15 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( x y z )
             for (std::size_t i = 0; i < vertCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
-                _vertices.push_back(parseVector3(tok)); // components
+                tok.nextInteger<int>(); // index
+                _vertices.push_back(tok.nextVector3()); // components
             }
 
             tok.assertNextToken("}");
         }
         else if (token == "edges")
         {
-            std::size_t edgeCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t edgeCount = tok.nextInteger<std::size_t>();
 
             _edges.reserve(edgeCount);
 
@@ -161,13 +161,13 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( vertIdx1 vertIdx2 )
             for (std::size_t i = 0; i < edgeCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // index
+                tok.nextInteger<int>(); // index
 
                 tok.assertNextToken("(");
 
                 Edge edge;
-                edge.vertexNumber[0] = string::convert<int>(tok.nextToken());
-                edge.vertexNumber[1] = string::convert<int>(tok.nextToken());
+                edge.vertexNumber[0] = tok.nextInteger<int>();
+                edge.vertexNumber[1] = tok.nextInteger<int>();
 
                 tok.assertNextToken(")");
 
@@ -182,7 +182,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "faces")
         {
-            std::size_t faceCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t faceCount = tok.nextInteger<std::size_t>();
 
             _faces.reserve(faceCount);
 
@@ -191,18 +191,18 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( planeNum flags areas[0] areas[1] firstEdge numEdges )
             for (std::size_t i = 0; i < faceCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInteger<int>(); // number
 
                 tok.assertNextToken("(");
 
                 Face face;
 
-                face.planeNum = string::convert<int>(tok.nextToken());
-                face.flags = string::convert<unsigned short>(tok.nextToken());
-                face.areas[0] = string::convert<short>(tok.nextToken());
-                face.areas[1] = string::convert<short>(tok.nextToken());
-                face.firstEdge = string::convert<int>(tok.nextToken());
-                face.numEdges = string::convert<int>(tok.nextToken());
+                face.planeNum = tok.nextInteger<int>();
+                face.flags = tok.nextInteger<unsigned short>();
+                face.areas[0] = tok.nextInteger<short>();
+                face.areas[1] = tok.nextInteger<short>();
+                face.firstEdge = tok.nextInteger<int>();
+                face.numEdges = tok.nextInteger<int>();
 
                 _faces.push_back(face);
 
@@ -217,7 +217,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else if (token == "areas")
         {
-            std::size_t areaCount = string::convert<std::size_t>(tok.nextToken());
+            std::size_t areaCount = tok.nextInteger<std::size_t>();
 
             _areas.reserve(areaCount);
 
@@ -226,25 +226,26 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
             // num ( flags contents firstFace numFaces cluster clusterAreaNum ) reachabilityCount { reachabilities }
             for (std::size_t i = 0; i < areaCount; ++i)
             {
-                string::convert<int>(tok.nextToken()); // number
+                tok.nextInteger<int>(); // number
 
                 tok.assertNextToken("(");
 
                 Area area;
 
-                area.flags = string::convert<unsigned short>(tok.nextToken());
-                area.contents = string::convert<unsigned short>(tok.nextToken());
-                area.firstFace = string::convert<int>(tok.nextToken());
-                area.numFaces = string::convert<int>(tok.nextToken());
-                area.cluster = string::convert<short>(tok.nextToken());
-                area.clusterAreaNum = string::convert<short>(tok.nextToken());
+                area.flags = tok.nextInteger<unsigned short>();
+                area.contents = tok.nextInteger<unsigned short>();
+                area.firstFace = tok.nextInteger<int>();
+                area.numFaces = tok.nextInteger<int>();
+                area.cluster = tok.nextInteger<short>();
+                area.clusterAreaNum = tok.nextInteger<short>();
+                area.travelFlags = 0;
 
                 _areas.push_back(area);
 
                 tok.assertNextToken(")");
 
                 // Skip over reachabilities for the moment being
-                /*std::size_t reachCount = */string::convert<std::size_t>(tok.nextToken());
+                /*std::size_t reachCount = */tok.nextInteger<std::size_t>();
                 tok.assertNextToken("{");
 
                 while (tok.nextToken() != "}")
@@ -269,7 +270,7 @@ void Doom3AasFile::parseFromTokens(parser::DefTokeniser& tok)
         }
         else
         {
-            throw parser::ParseException("Unknown token: " + token);
+            throw parser::ParseException("Unknown token: " + std::string(token));
         }
     }
 
@@ -389,9 +390,9 @@ Vector3 Doom3AasFile::calcReachableGoalForArea(const IAasFile::Area& area) const
     return center;
 }
 
-void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
+void Doom3AasFile::parseIndex(Doom3AasTokenScanner& tok, Index& index)
 {
-    std::size_t idxCount = string::convert<std::size_t>(tok.nextToken());
+    std::size_t idxCount = tok.nextInteger<std::size_t>();
 
     index.reserve(idxCount);
 
@@ -400,14 +401,21 @@ void Doom3AasFile::parseIndex(parser::DefTokeniser& tok, Index& index)
     // num ( idx )
     for (std::size_t i = 0; i < idxCount; ++i)
     {
-        string::convert<int>(tok.nextToken()); // number
+        tok.nextInteger<int>(); // number
 
         tok.assertNextToken("(");
-        index.push_back(string::convert<int>(tok.nextToken()));
+        index.push_back(tok.nextInteger<int>());
         tok.assertNextToken(")");
     }
 
     tok.assertNextToken("}");
 }
 
+void Doom3AasFile::parseSettings()
+{
+    // The settings are using a different syntax, leave them to the regular tokeniser
+    parser::BasicDefTokeniser<std::string_view> tok(_settingsBlock);
+    _settings.parseFromTokens(tok);
+}
+
 }
@@ -1,8 +1,8 @@
 #pragma once
 
 #include "iaasfile.h"
-#include "parser/DefTokeniser.h"
 #include "Doom3AasFileSettings.h"
+#include "Doom3AasTokenScanner.h"
 #include <vector>
 #include "math/Plane3.h"
 #include "math/AABB.h"
@@ -16,6 +16,9 @@ class Doom3AasFile :
 private:
     Doom3AasFileSettings _settings;
 
+    // The source of the settings, kept for the binary cache
+    std::string _settingsBlock;
+
     std::vector<Plane3> _planes;
     std::vector<Vector3> _vertices;
     std::vector<Edge> _edges;
@@ -49,10 +52,14 @@ public:
     virtual std::size_t     getNumAreas() const override;
     virtual const Area&     getArea(int areaNum) const override;
 
-    void parseFromTokens(parser::DefTokeniser& tok);
+    // Parses the file contents following the header
+    void parse(Doom3AasTokenScanner& tok);
 
 private:
-    void parseIndex(parser::DefTokeniser& tok, Index& index);
+    friend class Doom3AasFileCache;
+
+    void parseIndex(Doom3AasTokenScanner& tok, Index& index);
+    void parseSettings();
     void finishAreas();
     Vector3 calcReachableGoalForArea(const IAasFile::Area& area) const;
     Vector3 calcFaceCenter(int faceNum) const;
@@ -0,0 +1,301 @@
+#include "Doom3AasFileCache.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/dir.h"
+#include "os/fs.h"
+#include "math/Hash.h"
+#include "stream/utils.h"
+#include "stream/MemoryInputStream.h"
+#include "vfs/MappedFile.h"
+
+namespace map
+{
+
+namespace
+{
+    const char* const CACHE_FILE_MAGIC = "DRAASBIN";
+
+    // Increase this to invalidate all existing cache entries
+    constexpr uint32_t CACHE_VERSION = 1;
+
+    class CacheReadException :
+        public std::runtime_error
+    {
+    public:
+        CacheReadException() :
+            std::runtime_error("Unexpected end of file")
+        {}
+    };
+
+    template<typename ValueType>
+    ValueType readValue(stream::MemoryInputStream& stream)
+    {
+        if (stream.remaining() < sizeof(ValueType)) throw CacheReadException();
+
+        return stream::readLittleEndian<ValueType>(stream);
+    }
+
+    std::string readString(stream::MemoryInputStream& stream)
+    {
+        auto length = readValue<uint32_t>(stream);
+
+        if (stream.remaining() < length) throw CacheReadException();
+
+        std::string value(reinterpret_cast<const char*>(stream.get()), length);
+        stream.seek(static_cast<SeekableStream::offset_type>(length), SeekableStream::cur);
+
+        return value;
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    // Arrays of plain structures are stored as they are in memory, prefixed by the element size and count
+    template<typename ElementType>
+    void writeArray(std::ostream& stream, const std::vector<ElementType>& elements)
+    {
+        static_assert(std::is_trivially_copyable_v<ElementType>, "Elements must be trivially copyable");
+
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(sizeof(ElementType)));
+        stream::writeLittleEndian<uint64_t>(stream, static_cast<uint64_t>(elements.size()));
+        stream.write(reinterpret_cast<const char*>(elements.data()), elements.size() * sizeof(ElementType));
+    }
+
+    template<typename ElementType>
+    void readArray(stream::MemoryInputStream& stream, std::vector<ElementType>& elements)
+    {
+        if (readValue<uint32_t>(stream) != sizeof(ElementType))
+        {
+            throw std::runtime_error("Element size mismatch");
+        }
+
+        auto count = readValue<uint64_t>(stream);
+
+        if (count > stream.remaining() / sizeof(ElementType)) throw CacheReadException();
+
+        auto numBytes = static_cast<std::size_t>(count) * sizeof(ElementType);
+
+        elements.resize(static_cast<std::size_t>(count));
+        std::memcpy(elements.data(), stream.get(), numBytes);
+        stream.seek(static_cast<SeekableStream::offset_type>(numBytes), SeekableStream::cur);
+    }
+
+    // Elements holding vectors are written member by member
+    template<typename ElementType, typename WriteFunc>
+    void writeArray(std::ostream& stream, const std::vector<ElementType>& elements, WriteFunc writeElement)
+    {
+        stream::writeLittleEndian<uint64_t>(stream, static_cast<uint64_t>(elements.size()));
+
+        for (const auto& element : elements)
+        {
+            writeElement(stream, element);
+        }
+    }
+
+    template<typename ElementType, typename ReadFunc>
+    void readArray(stream::MemoryInputStream& stream, std::vector<ElementType>& elements, std::size_t minElementSize, ReadFunc readElement)
+    {
+        auto count = readValue<uint64_t>(stream);
+
+        if (count > stream.remaining() / minElementSize) throw CacheReadException();
+
+        elements.resize(static_cast<std::size_t>(count));
+
+        for (auto& element : elements)
+        {
+            readElement(stream, element);
+        }
+    }
+
+    constexpr std::size_t Vector3Size = 3 * sizeof(Vector3::ElementType);
+
+    void writeVector3(std::ostream& stream, const Vector3& vector)
+    {
+        stream::writeLittleEndian<Vector3::ElementType>(stream, vector.x());
+        stream::writeLittleEndian<Vector3::ElementType>(stream, vector.y());
+        stream::writeLittleEndian<Vector3::ElementType>(stream, vector.z());
+    }
+
+    void readVector3(stream::MemoryInputStream& stream, Vector3& vector)
+    {
+        vector.x() = readValue<Vector3::ElementType>(stream);
+        vector.y() = readValue<Vector3::ElementType>(stream);
+        vector.z() = readValue<Vector3::ElementType>(stream);
+    }
+
+    void writePlane(std::ostream& stream, const Plane3& plane)
+    {
+        writeVector3(stream, plane.normal());
+        stream::writeLittleEndian<double>(stream, plane.dist());
+    }
+
+    void readPlane(stream::MemoryInputStream& stream, Plane3& plane)
+    {
+        readVector3(stream, plane.normal());
+        plane.dist() = readValue<double>(stream);
+    }
+
+    void writeArea(std::ostream& stream, const IAasFile::Area& area)
+    {
+        stream::writeLittleEndian<int32_t>(stream, area.numFaces);
+        stream::writeLittleEndian<int32_t>(stream, area.firstFace);
+        writeVector3(stream, area.bounds.origin);
+        writeVector3(stream, area.bounds.extents);
+        writeVector3(stream, area.center);
+        stream::writeLittleEndian<uint16_t>(stream, area.flags);
+        stream::writeLittleEndian<uint16_t>(stream, area.contents);
+        stream::writeLittleEndian<int16_t>(stream, area.cluster);
+        stream::writeLittleEndian<int16_t>(stream, area.clusterAreaNum);
+        stream::writeLittleEndian<int32_t>(stream, area.travelFlags);
+    }
+
+    void readArea(stream::MemoryInputStream& stream, IAasFile::Area& area)
+    {
+        area.numFaces = readValue<int32_t>(stream);
+        area.firstFace = readValue<int32_t>(stream);
+        readVector3(stream, area.bounds.origin);
+        readVector3(stream, area.bounds.extents);
+        readVector3(stream, area.center);
+        area.flags = readValue<uint16_t>(stream);
+        area.contents = readValue<uint16_t>(stream);
+        area.cluster = readValue<int16_t>(stream);
+        area.clusterAreaNum = readValue<int16_t>(stream);
+        area.travelFlags = readValue<int32_t>(stream);
+    }
+}
+
+Doom3AasFileCache::Doom3AasFileCache(const std::string& cachePath) :
+    _cachePath(cachePath)
+{}
+
+std::string Doom3AasFileCache::GetKey(const std::string& absolutePath)
+{
+    std::error_code ec;
+    auto modificationTime = fs::last_write_time(absolutePath, ec);
+
+    if (ec) return std::string();
+
+    auto size = fs::file_size(absolutePath, ec);
+
+    if (ec) return std::string();
+
+    math::Hash hash;
+
+    hash.addSizet(CACHE_VERSION);
+    hash.addString(absolutePath);
+    hash.addSizet(static_cast<std::size_t>(size));
+    hash.addSizet(static_cast<std::size_t>(modificationTime.time_since_epoch().count()));
+
+    return hash;
+}
+
+std::string Doom3AasFileCache::getFilename(const std::string& key) const
+{
+    return _cachePath + key + ".aasbin";
+}
+
+Doom3AasFilePtr Doom3AasFileCache::load(const std::string& key) const
+{
+    auto filename = getFilename(key);
+
+    if (key.empty() || !os::fileOrDirExists(filename)) return Doom3AasFilePtr();
+
+    archive::MappedFile file(filename);
+
+    if (!file.isValid()) return Doom3AasFilePtr();
+
+    stream::MemoryInputStream stream(file.data(), file.size());
+
+    auto aasFile = std::make_shared<Doom3AasFile>();
+
+    try
+    {
+        if (stream.remaining() < 8 || std::string(reinterpret_cast<const char*>(stream.get()), 8) != CACHE_FILE_MAGIC)
+        {
+            throw std::runtime_error("Invalid file header");
+        }
+
+        stream.seek(8);
+
+        if (readValue<uint32_t>(stream) != CACHE_VERSION)
+        {
+            throw std::runtime_error("Version mismatch");
+        }
+
+        aasFile->_settingsBlock = readString(stream);
+
+        readArray(stream, aasFile->_planes, Vector3Size + sizeof(double), readPlane);
+        readArray(stream, aasFile->_vertices, Vector3Size, readVector3);
+        readArray(stream, aasFile->_edges);
+        readArray(stream, aasFile->_edgeIndex);
+        readArray(stream, aasFile->_faces);
+        readArray(stream, aasFile->_faceIndex);
+        readArray(stream, aasFile->_areas, 3 * Vector3Size, readArea);
+
+        aasFile->parseSettings();
+    }
+    catch (const std::runtime_error& ex)
+    {
+        rWarning() << "[aas] Ignoring invalid cache file " << filename << ": " << ex.what() << std::endl;
+        return Doom3AasFilePtr();
+    }
+
+    return aasFile;
+}
+
+void Doom3AasFileCache::store(const std::string& key, const Doom3AasFile& aasFile) const
+{
+    if (key.empty()) return;
+
+    if (!os::fileOrDirExists(_cachePath) && !os::makeDirectory(_cachePath))
+    {
+        rWarning() << "[aas] Cannot create AAS cache folder " << _cachePath << std::endl;
+        return;
+    }
+
+    // Write to a temporary file first, such that no truncated files are left behind
+    auto filename = getFilename(key);
+    auto tempFilename = filename + ".tmp";
+
+    {
+        std::ofstream stream(tempFilename, std::ios::binary | std::ios::trunc);
+
+        if (!stream)
+        {
+            rWarning() << "[aas] Cannot write cache file " << filename << std::endl;
+            return;
+        }
+
+        stream.write(CACHE_FILE_MAGIC, 8);
+        stream::writeLittleEndian<uint32_t>(stream, CACHE_VERSION);
+
+        writeString(stream, aasFile._settingsBlock);
+
+        writeArray(stream, aasFile._planes, writePlane);
+        writeArray(stream, aasFile._vertices, writeVector3);
+        writeArray(stream, aasFile._edges);
+        writeArray(stream, aasFile._edgeIndex);
+        writeArray(stream, aasFile._faces);
+        writeArray(stream, aasFile._faceIndex);
+        writeArray(stream, aasFile._areas, writeArea);
+    }
+
+    std::error_code ec;
+    fs::rename(tempFilename, filename, ec);
+
+    if (ec)
+    {
+        rWarning() << "[aas] Cannot write cache file " << filename << ": " << ec.message() << std::endl;
+        fs::remove(tempFilename, ec);
+    }
+}
+
+}
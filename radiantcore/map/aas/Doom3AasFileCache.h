@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include "Doom3AasFile.h"
+
+namespace map
+{
+
+/**
+ * On-disk cache of parsed AAS files, such that big files don't need to be
+ * parsed again when they're loaded the next time.
+ *
+ * Entries are addressed by a key generated from the path, size and modification
+ * time of the AAS file, so any change to the file will lead to a cache miss.
+ * The parsed arrays are stored as they are in memory, including the calculated
+ * area bounds. Loading the entries is reading them from a memory-mapped file,
+ * the cache files are therefore machine-local and not meant to be shared.
+ */
+class Doom3AasFileCache
+{
+private:
+    std::string _cachePath;
+
+public:
+    // Cache files are stored in the given folder, which is created on demand
+    Doom3AasFileCache(const std::string& cachePath);
+
+    // Returns the key for the given AAS file, an empty string if the file properties
+    // cannot be determined, in which case the file won't be cached
+    static std::string GetKey(const std::string& absolutePath);
+
+    // Loads the AAS file stored for the given key, returns an empty pointer if there's no such entry
+    Doom3AasFilePtr load(const std::string& key) const;
+
+    // Stores the given AAS file for the given key
+    void store(const std::string& key, const Doom3AasFile& aasFile) const;
+
+private:
+    std::string getFilename(const std::string& key) const;
+};
+
+}
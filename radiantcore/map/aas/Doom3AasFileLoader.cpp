@@ -1,9 +1,10 @@
 #include "Doom3AasFileLoader.h"
 
+#include <fstream>
+#include <iterator>
 #include "itextstream.h"
 
 #include "parser/DefTokeniser.h"
-#include "string/convert.h"
 #include "Doom3AasFile.h"
 #include "module/StaticModule.h"
 
@@ -50,32 +51,63 @@ bool Doom3AasFileLoader::canLoad(std::istream& stream) const
 
 IAasFilePtr Doom3AasFileLoader::loadFromStream(std::istream& stream)
 {
-    Doom3AasFilePtr aasFile = std::make_shared<Doom3AasFile>();
+    return parseAasFile(stream);
+}
 
-    // We assume that the stream is rewound to the beginning
+IAasFilePtr Doom3AasFileLoader::loadFromFile(const std::string& absolutePath)
+{
+    auto key = Doom3AasFileCache::GetKey(absolutePath);
 
-    // Instantiate a tokeniser to read the version tag
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+    if (_cache)
+    {
+        if (auto cached = _cache->load(key))
+        {
+            return cached;
+        }
+    }
+
+    std::ifstream stream(absolutePath, std::ios::binary);
+
+    if (!stream)
+    {
+        rError() << "Cannot open AAS file " << absolutePath << std::endl;
+        return IAasFilePtr();
+    }
+
+    auto aasFile = parseAasFile(stream);
+
+    if (aasFile && _cache)
+    {
+        _cache->store(key, *aasFile);
+    }
+
+    return aasFile;
+}
+
+Doom3AasFilePtr Doom3AasFileLoader::parseAasFile(std::istream& stream) const
+{
+    // We assume that the stream is rewound to the beginning,
+    // read the whole file to let the scanner work on the buffer
+    std::string contents((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    Doom3AasTokenScanner tok(contents);
+
+    auto aasFile = std::make_shared<Doom3AasFile>();
 
     try
-	{
+    {
         // File header
         parseVersion(tok);
 
-        // Checksum (will throw if the string conversion fails)
-        string::convert<long>(tok.nextToken());
+        // Checksum
+        tok.nextToken();
 
-        aasFile->parseFromTokens(tok);
-	}
-	catch (parser::ParseException& ex)
-	{
-        rError() << "Failure parsing AAS file: " << ex.what() << std::endl;
-        return IAasFilePtr();
+        aasFile->parse(tok);
     }
-	catch (std::invalid_argument& ex)
-	{
-        rError() << "Conversion error while parsing AAS file: " << ex.what() << std::endl;
-        return IAasFilePtr();
+    catch (parser::ParseException& ex)
+    {
+        rError() << "Failure parsing AAS file: " << ex.what() << std::endl;
+        return Doom3AasFilePtr();
     }
 
     return aasFile;
@@ -93,6 +125,16 @@ void Doom3AasFileLoader::parseVersion(parser::DefTokeniser& tok) const
     }
 }
 
+void Doom3AasFileLoader::parseVersion(Doom3AasTokenScanner& tok) const
+{
+    tok.assertNextToken("DewmAAS");
+
+    if (static_cast<float>(tok.nextDouble()) != DEWM3_AAS_VERSION)
+    {
+        throw parser::ParseException("AAS File version mismatch");
+    }
+}
+
 const std::string& Doom3AasFileLoader::getName() const
 {
 	static std::string _name("Doom3AasFileLoader");
@@ -113,6 +155,8 @@ const StringSet& Doom3AasFileLoader::getDependencies() const
 
 void Doom3AasFileLoader::initialiseModule(const IApplicationContext& ctx)
 {
+    _cache = std::make_unique<Doom3AasFileCache>(ctx.getCacheDataPath() + "aas/");
+
 	// Register ourselves as aas format
     GlobalAasFileManager().registerLoader(shared_from_this());
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "iaasfile.h"
+#include "Doom3AasFile.h"
+#include "Doom3AasFileCache.h"
 
 namespace parser { class DefTokeniser; }
 
@@ -14,12 +16,16 @@ class Doom3AasFileLoader :
     public IAasFileLoader,
     public std::enable_shared_from_this<Doom3AasFileLoader>
 {
+private:
+    std::unique_ptr<Doom3AasFileCache> _cache;
+
 public:
     virtual const std::string& getAasFormatName() const override;
 	virtual const std::string& getGameType() const override;
 
 	virtual bool canLoad(std::istream& stream) const override;
     virtual IAasFilePtr loadFromStream(std::istream& stream) override;
+    virtual IAasFilePtr loadFromFile(const std::string& absolutePath) override;
 
     // RegisterableModule implementation
 	virtual const std::string& getName() const override;
@@ -30,6 +36,9 @@ public:
 private:
     // Parses the file header, throws exception on failure
     void parseVersion(parser::DefTokeniser& tok) const;
+    void parseVersion(Doom3AasTokenScanner& tok) const;
+
+    Doom3AasFilePtr parseAasFile(std::istream& stream) const;
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "parser/ParseException.h"
+#include "string/convert.h"
+#include "math/Vector3.h"
+
+namespace map
+{
+
+/**
+ * Scanner for the text AAS format, which apart from the settings block consists
+ * of whitespace-separated numbers, keywords and brackets only. Tokens are returned
+ * as views into the buffer, numbers are converted in place using from_chars, so
+ * files with millions of tokens are processed without any allocations.
+ *
+ * The buffer must stay alive and unchanged as long as the scanner is in use.
+ */
+class Doom3AasTokenScanner
+{
+private:
+    const char* _cur;
+    const char* _end;
+
+public:
+    Doom3AasTokenScanner(std::string_view buffer) :
+        _cur(buffer.data()),
+        _end(buffer.data() + buffer.size())
+    {}
+
+    bool hasMoreTokens()
+    {
+        skipWhitespace();
+        return _cur != _end;
+    }
+
+    // Returns the next token, brackets are returned as tokens in their own right
+    std::string_view nextToken()
+    {
+        skipWhitespace();
+
+        if (_cur == _end)
+        {
+            throw parser::ParseException("AAS file: no more tokens");
+        }
+
+        auto start = _cur++;
+
+        if (!isBracket(*start))
+        {
+            while (_cur != _end && !isWhitespace(*_cur) && !isBracket(*_cur))
+            {
+                ++_cur;
+            }
+        }
+
+        return std::string_view(start, _cur - start);
+    }
+
+    void assertNextToken(std::string_view expected)
+    {
+        auto token = nextToken();
+
+        if (token != expected)
+        {
+            throw parser::ParseException("AAS file: expected \"" + std::string(expected) +
+                "\", found \"" + std::string(token) + "\"");
+        }
+    }
+
+    // Malformed numbers are returned as 0, like string::convert would do
+    template<typename T>
+    T nextInteger()
+    {
+        return string::parseInteger<T>(nextToken());
+    }
+
+    double nextDouble()
+    {
+        return string::parseDouble(nextToken());
+    }
+
+    // Parses a vector in the form ( x y z )
+    Vector3 nextVector3()
+    {
+        assertNextToken("(");
+
+        Vector3 vec;
+        vec[0] = nextDouble();
+        vec[1] = nextDouble();
+        vec[2] = nextDouble();
+
+        assertNextToken(")");
+
+        return vec;
+    }
+
+    // Consumes the block enclosed in curly braces which must follow next,
+    // returns the whole block including the braces
+    std::string_view nextBlock()
+    {
+        skipWhitespace();
+
+        auto start = _cur;
+
+        assertNextToken("{");
+
+        for (std::size_t depth = 1; depth > 0;)
+        {
+            auto token = nextToken();
+
+            if (token == "{")
+            {
+                ++depth;
+            }
+            else if (token == "}")
+            {
+                --depth;
+            }
+        }
+
+        return std::string_view(start, _cur - start);
+    }
+
+private:
+    static bool isWhitespace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    static bool isBracket(char c)
+    {
+        return c == '(' || c == ')' || c == '{' || c == '}';
+    }
+
+    void skipWhitespace()
+    {
+        while (_cur != _end && isWhitespace(*_cur))
+        {
+            ++_cur;
+        }
+    }
+};
+
+}
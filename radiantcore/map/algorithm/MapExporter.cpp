@@ -1,6 +1,10 @@
 #include "MapExporter.h"
 
+#include <atomic>
+#include <future>
 #include <ostream>
+#include <sstream>
+#include <thread>
 #include "i18n.h"
 #include "itextstream.h"
 #include "ibrush.h"
@@ -14,7 +18,9 @@
 #include "string/string.h"
 
 #include "scene/ChildPrimitives.h"
+#include "brush/BRepEvaluation.h"
 #include "messages/MapFileOperation.h"
+#include "../UnloadedBlockNode.h"
 
 namespace map
 {
@@ -23,6 +29,44 @@ namespace map
 	{
 		const char* const RKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
 		const char* const RKEY_MAP_SAVE_STATUS_INTERLEAVE = "user/ui/map/saveStatusInterleave";
+
+		// Large entities like the worldspawn are split into chunks of this many primitives
+		const std::size_t PRIMITIVES_PER_CHUNK = 256;
+
+		// The number of nodes collected before the chunks are written and appended to the stream
+		const std::size_t NODES_PER_BATCH = 16384;
+
+		// Invokes the given function for each index in [0..count) using all available cores
+		void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+		{
+			std::atomic<std::size_t> nextIndex(0);
+
+			auto worker = [&]()
+			{
+				for (auto i = nextIndex++; i < count; i = nextIndex++)
+				{
+					function(i);
+				}
+			};
+
+			auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+			std::vector<std::future<void>> workers;
+
+			for (std::size_t i = 1; i < numWorkers; ++i)
+			{
+				workers.emplace_back(std::async(std::launch::async, worker));
+			}
+
+			// The calling thread is processing its share too
+			worker();
+
+			// Wait for all workers, this is re-throwing any exceptions
+			for (auto& result : workers)
+			{
+				result.get();
+			}
+		}
 	}
 
 MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root, std::ostream& mapStream, std::size_t nodeCount) :
@@ -34,7 +78,10 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 	_curNodeCount(0),
 	_entityNum(0),
 	_primitiveNum(0),
-    _sendProgressMessages(true)
+    _sendProgressMessages(true),
+	_parallelExport(false),
+	_numChunkNodes(0),
+	_entityPrimitiveNum(0)
 {
 	construct();
 }
@@ -50,7 +97,10 @@ MapExporter::MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
 	_curNodeCount(0),
 	_entityNum(0),
 	_primitiveNum(0),
-    _sendProgressMessages(true)
+    _sendProgressMessages(true),
+	_parallelExport(false),
+	_numChunkNodes(0),
+	_entityPrimitiveNum(0)
 {
 	construct();
 }
@@ -77,6 +127,9 @@ void MapExporter::construct()
 	int precision = string::convert<int>(nodes[0].getAttributeValue("value"));
 	_mapStream.precision(precision);
 
+	// Entities are written on worker threads if the writer is able to split up its work
+	_parallelExport = _writer.createParallelWriter(0, 0) != nullptr;
+
 	// Add origin to func_* children before writing
 	prepareScene();
 }
@@ -113,6 +166,9 @@ void MapExporter::exportMap(const scene::INodePtr& root, const GraphTraversalFun
 	// Perform the actual map traversal
 	traverse(root, *this);
 
+	// Write whatever is left from the parallel export
+	flushChunks();
+
 	try
 	{
 		auto mapRoot = std::dynamic_pointer_cast<scene::IMapRootNode>(root);
@@ -145,10 +201,21 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (entity)
 		{
-			// Progress dialog handling
-			onNodeProgress();
-			
-			_writer.beginWriteEntity(entity, _mapStream);
+			if (_parallelExport)
+			{
+				_currentEntity = entity;
+				_entityPrimitiveNum = 0;
+
+				_chunks.push_back(ExportChunk{ entity, _entityNum, 0, {}, true, false });
+				_numChunkNodes++;
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWriteEntity(entity, _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
 
@@ -159,10 +226,17 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (brush && brush->getIBrush().hasContributingFaces())
 		{
-			// Progress dialog handling
-			onNodeProgress();
-
-			_writer.beginWriteBrush(brush, _mapStream);
+			if (_parallelExport)
+			{
+				addPrimitiveToChunk(node);
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWriteBrush(brush, _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
@@ -173,10 +247,56 @@ bool MapExporter::pre(const scene::INodePtr& node)
 
 		if (patch)
 		{
-			// Progress dialog handling
+			if (_parallelExport)
+			{
+				addPrimitiveToChunk(node);
+			}
+			else
+			{
+				// Progress dialog handling
+				onNodeProgress();
+
+				_writer.beginWritePatch(patch, _mapStream);
+			}
+
+			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
+
+			return true;
+		}
+
+		auto unloadedBlock = std::dynamic_pointer_cast<UnloadedBlockNode>(node);
+
+		if (unloadedBlock && unloadedBlock->getKind() == UnloadedBlockNode::Kind::Entity)
+		{
+			if (_parallelExport)
+			{
+				// Write everything in front of it, this entity is written right here
+				flushChunks();
+				_unloadedEntityWriter = _writer.createParallelWriter(_entityNum, 0);
+			}
+
 			onNodeProgress();
 
-			_writer.beginWritePatch(patch, _mapStream);
+			getUnloadedBlockWriter().beginWriteUnloadedEntity(unloadedBlock->getText(), _mapStream);
+
+			if (_infoFileExporter) _infoFileExporter->visitEntity(node, _entityNum);
+
+			return true;
+		}
+
+		if (unloadedBlock)
+		{
+			// Unloaded primitives of a loaded entity are part of the chunks
+			if (_parallelExport && _currentEntity)
+			{
+				addPrimitiveToChunk(node);
+			}
+			else
+			{
+				onNodeProgress();
+
+				getUnloadedBlockWriter().writeUnloadedPrimitive(unloadedBlock->getText(), _mapStream);
+			}
 
 			if (_infoFileExporter) _infoFileExporter->visitPrimitive(node, _entityNum, _primitiveNum);
 
@@ -199,7 +319,26 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (entity)
 		{
-			_writer.endWriteEntity(entity, _mapStream);
+			if (_parallelExport)
+			{
+				// The last chunk might have been flushed already
+				if (_chunks.empty() || _chunks.back().entity != entity)
+				{
+					_chunks.push_back(ExportChunk{ entity, _entityNum, _entityPrimitiveNum, {}, false, false });
+				}
+
+				_chunks.back().writeEntityEnd = true;
+				_currentEntity.reset();
+
+				if (_numChunkNodes >= NODES_PER_BATCH)
+				{
+					flushChunks();
+				}
+			}
+			else
+			{
+				_writer.endWriteEntity(entity, _mapStream);
+			}
 
 			_entityNum++;
 			return;
@@ -209,7 +348,11 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (brush && brush->getIBrush().hasContributingFaces())
 		{
-			_writer.endWriteBrush(brush, _mapStream);
+			if (!_parallelExport)
+			{
+				_writer.endWriteBrush(brush, _mapStream);
+			}
+
 			_primitiveNum++;
 			return;
 		}
@@ -218,7 +361,28 @@ void MapExporter::post(const scene::INodePtr& node)
 
 		if (patch)
 		{
-			_writer.endWritePatch(patch, _mapStream);
+			if (!_parallelExport)
+			{
+				_writer.endWritePatch(patch, _mapStream);
+			}
+
+			_primitiveNum++;
+			return;
+		}
+
+		auto unloadedBlock = std::dynamic_pointer_cast<UnloadedBlockNode>(node);
+
+		if (unloadedBlock && unloadedBlock->getKind() == UnloadedBlockNode::Kind::Entity)
+		{
+			getUnloadedBlockWriter().endWriteUnloadedEntity(_mapStream);
+			_unloadedEntityWriter.reset();
+
+			_entityNum++;
+			return;
+		}
+
+		if (unloadedBlock)
+		{
 			_primitiveNum++;
 			return;
 		}
@@ -229,6 +393,111 @@ void MapExporter::post(const scene::INodePtr& node)
 	}
 }
 
+void MapExporter::addPrimitiveToChunk(const scene::INodePtr& node)
+{
+	// Start a new chunk when the current one is full or has been flushed
+	if (_chunks.empty() || _chunks.back().writeEntityEnd || _chunks.back().entity != _currentEntity ||
+		_chunks.back().primitives.size() >= PRIMITIVES_PER_CHUNK)
+	{
+		_chunks.push_back(ExportChunk{ _currentEntity, _entityNum, _entityPrimitiveNum, {}, false, false });
+	}
+
+	_chunks.back().primitives.push_back(node);
+
+	_entityPrimitiveNum++;
+	_numChunkNodes++;
+
+	if (_numChunkNodes >= NODES_PER_BATCH)
+	{
+		flushChunks();
+	}
+}
+
+void MapExporter::flushChunks()
+{
+	runInParallel(_chunks.size(), [&](std::size_t index)
+	{
+		writeChunk(_chunks[index]);
+	});
+
+	// Append the chunks in traversal order
+	for (const auto& chunk : _chunks)
+	{
+		// Progress dialog handling, one event per written node
+		for (std::size_t i = chunk.writeEntityBegin ? 0 : 1; i <= chunk.primitives.size(); ++i)
+		{
+			onNodeProgress();
+		}
+
+		for (const auto& error : chunk.errors)
+		{
+			rError() << error << std::endl;
+		}
+
+		_mapStream << chunk.output;
+	}
+
+	_chunks.clear();
+	_numChunkNodes = 0;
+}
+
+void MapExporter::writeChunk(ExportChunk& chunk)
+{
+	auto writer = _writer.createParallelWriter(chunk.entityNum, chunk.primitiveNum);
+
+	// Use the same precision and flags as the map stream
+	std::ostringstream stream;
+	stream.copyfmt(_mapStream);
+
+	// The error handling is the same as in pre() and post(), the messages are logged by the main thread
+	auto write = [&](const char* stage, const std::function<void()>& function)
+	{
+		try
+		{
+			function();
+		}
+		catch (IMapWriter::FailureException& ex)
+		{
+			chunk.errors.push_back(std::string("Failure exporting a node (") + stage + "): " + ex.what());
+		}
+	};
+
+	if (chunk.writeEntityBegin)
+	{
+		write("pre", [&]() { writer->beginWriteEntity(chunk.entity, stream); });
+	}
+
+	for (const auto& node : chunk.primitives)
+	{
+		if (auto brush = std::dynamic_pointer_cast<IBrushNode>(node); brush)
+		{
+			write("pre", [&]() { writer->beginWriteBrush(brush, stream); });
+			write("post", [&]() { writer->endWriteBrush(brush, stream); });
+		}
+		else if (auto patch = std::dynamic_pointer_cast<IPatchNode>(node); patch)
+		{
+			write("pre", [&]() { writer->beginWritePatch(patch, stream); });
+			write("post", [&]() { writer->endWritePatch(patch, stream); });
+		}
+		else if (auto unloadedBlock = std::dynamic_pointer_cast<UnloadedBlockNode>(node); unloadedBlock)
+		{
+			write("pre", [&]() { writer->writeUnloadedPrimitive(unloadedBlock->getText(), stream); });
+		}
+	}
+
+	if (chunk.writeEntityEnd)
+	{
+		write("post", [&]() { writer->endWriteEntity(chunk.entity, stream); });
+	}
+
+	chunk.output = stream.str();
+}
+
+IMapWriter& MapExporter::getUnloadedBlockWriter()
+{
+	return _unloadedEntityWriter ? *_unloadedEntityWriter : _writer;
+}
+
 void MapExporter::onNodeProgress()
 {
 	_curNodeCount++;
@@ -298,17 +567,7 @@ void MapExporter::finishScene()
 
 void MapExporter::recalculateBrushWindings()
 {
-	_root->foreachNode([] (const scene::INodePtr& child)->bool
-	{
-		auto* brush = Node_getIBrush(child);
-
-		if (brush != nullptr)
-		{
-			brush->evaluateBRep();
-		}
-
-		return true;
-	});
+	brush::evaluateBRepsInSubgraph(_root);
 }
 
 } // namespace
@@ -9,6 +9,7 @@
 #include "../infofile/InfoFileExporter.h"
 #include "EventRateLimiter.h"
 
+#include <vector>
 #include <sigc++/signal.h>
 
 namespace map
@@ -55,6 +56,39 @@ private:
 
     bool _sendProgressMessages;
 
+	// A part of an entity, which is written to its own buffer by a worker thread
+	struct ExportChunk
+	{
+		IEntityNodePtr entity;
+
+		// The numbers the writer is starting with
+		std::size_t entityNum;
+		std::size_t primitiveNum;
+
+		std::vector<scene::INodePtr> primitives;
+
+		bool writeEntityBegin;
+		bool writeEntityEnd;
+
+		std::string output;
+		std::vector<std::string> errors;
+	};
+
+	// True if the writer is supporting the parallel export
+	bool _parallelExport;
+
+	// The chunks collected during traversal, written on the next flushChunks()
+	std::vector<ExportChunk> _chunks;
+	std::size_t _numChunkNodes;
+
+	// The currently visited entity and the number of its primitives so far
+	IEntityNodePtr _currentEntity;
+	std::size_t _entityPrimitiveNum;
+
+	// Writes the currently visited unloaded entity during the parallel export,
+	// these are copied as they are and not worth a worker thread
+	IMapWriterPtr _unloadedEntityWriter;
+
 public:
 	// The constructor prepares the scene and the output stream
 	MapExporter(IMapWriter& writer, const scene::IMapRootNodePtr& root,
@@ -93,6 +127,18 @@ private:
 	void finishScene();
 
 	void recalculateBrushWindings();
+
+	// Adds the given primitive to the current chunk, starting a new chunk if necessary
+	void addPrimitiveToChunk(const scene::INodePtr& node);
+
+	// Writes the collected chunks in parallel, then appends them to the map stream in order
+	void flushChunks();
+
+	// Writes the given chunk to its output buffer, is called by the worker threads
+	void writeChunk(ExportChunk& chunk);
+
+	// The writer for the placeholders of unloaded entities and their primitives
+	IMapWriter& getUnloadedBlockWriter();
 };
 typedef std::shared_ptr<MapExporter> MapExporterPtr;
 
@@ -8,6 +8,7 @@
 #include <fmt/format.h>
 #include "registry/registry.h"
 #include "string/string.h"
+#include "scenelib.h"
 #include "messages/MapFileOperation.h"
 
 namespace map
@@ -91,7 +92,8 @@ bool MapImporter::addPrimitiveToEntity(const scene::INodePtr& primitive, const s
 		GlobalRadiantCore().getMessageBus().sendMessage(msg);
 	}
 
-	if (Node_getEntity(entity)->isContainer())
+	// The primitives of unloaded entities are placeholders as well
+	if (Node_isUnloadedBlock(entity) || Node_getEntity(entity)->isContainer())
 	{
 		entity->addChildNode(primitive);
 		return true;
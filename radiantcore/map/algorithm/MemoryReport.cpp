@@ -0,0 +1,74 @@
+#include "MemoryReport.h"
+
+#include "iscenegraph.h"
+#include "imap.h"
+#include "iundo.h"
+#include "ibrush.h"
+#include "ipatch.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+const std::string& MapMemoryReporter::getMemoryReporterName() const
+{
+    static std::string _name("Map");
+    return _name;
+}
+
+void MapMemoryReporter::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    const auto& root = GlobalMapModule().getRoot();
+
+    if (!root) return;
+
+    std::size_t numFaces = 0;
+    std::size_t numWindingVertices = 0;
+    std::size_t numPatchControls = 0;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto brush = Node_getIBrush(node); brush != nullptr)
+        {
+            numFaces += brush->getNumFaces();
+
+            for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+            {
+                numWindingVertices += brush->getFace(i).getWinding().size();
+            }
+        }
+        else if (auto patch = Node_getIPatch(node); patch != nullptr)
+        {
+            numPatchControls += patch->getWidth() * patch->getHeight();
+        }
+
+        return true;
+    });
+
+    report.addEntry("Brush faces", 0, numFaces);
+    report.addEntry("Winding vertices", numWindingVertices * sizeof(WindingVertex), numWindingVertices);
+    report.addEntry("Patch control vertices", numPatchControls * sizeof(PatchControl), numPatchControls);
+
+    auto statistics = root->getUndoSystem().getStatistics();
+
+    auto addOperations = [&](const std::string& name, const std::vector<UndoSystemStatistics::Operation>& operations)
+    {
+        std::size_t memoryUsage = 0;
+
+        for (const auto& operation : operations)
+        {
+            memoryUsage += operation.memoryUsage;
+        }
+
+        report.addEntry(name, memoryUsage, operations.size());
+    };
+
+    addOperations("Undo operations", statistics.undoOperations);
+    addOperations("Redo operations", statistics.redoOperations);
+}
+
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "imemoryaccounting.h"
+
+namespace map
+{
+
+namespace algorithm
+{
+
+/**
+ * Reports the number of brush faces, winding vertices and patch control
+ * vertices in the current map, along with the memory held by the undo
+ * and redo operations of the map.
+ */
+class MapMemoryReporter :
+    public memory::IMemoryReporter
+{
+public:
+    const std::string& getMemoryReporterName() const override;
+    void reportMemoryUsage(memory::IMemoryReport& report) override;
+};
+
+}
+
+}
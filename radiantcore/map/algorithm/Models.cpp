@@ -148,6 +148,8 @@ void refreshModelsByPath(const std::string& relativeModelPath)
 
     GlobalModelCache().removeModel(relativeModelPath);
 
+    if (!GlobalMapModule().getRoot()) return;
+
     GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
     {
         auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
@@ -3,6 +3,7 @@
 #include "i18n.h"
 #include <numeric>
 #include <iostream>
+#include <sstream>
 #include "imapfilechangetracker.h"
 #include "itextstream.h"
 #include "iscenegraph.h"
@@ -11,6 +12,7 @@
 #include "igame.h"
 #include "ipreferencesystem.h"
 #include "icommandsystem.h"
+#include "iundo.h"
 
 #include "registry/registry.h"
 
@@ -26,7 +28,10 @@
 #include "module/StaticModule.h"
 #include "messages/NotificationMessage.h"
 #include "messages/AutomaticMapSaveRequest.h"
+#include "command/ExecutionFailure.h"
 #include "map/Map.h"
+#include "map/MapResource.h"
+#include "scene/Traverse.h"
 
 #include <fmt/format.h>
 
@@ -57,20 +62,30 @@ namespace
 
 AutoMapSaver::AutoMapSaver() :
 	_snapshotsEnabled(false),
+	_differentialSnapshots(false),
+	_saveInBackground(false),
     _savedChangeCount(0)
 {}
 
 void AutoMapSaver::registryKeyChanged()
 {
 	_snapshotsEnabled = registry::getValue<bool>(RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
+	_differentialSnapshots = registry::getValue<bool>(RKEY_AUTOSAVE_DIFFERENTIAL_SNAPSHOTS);
+	_saveInBackground = registry::getValue<bool>(RKEY_AUTOSAVE_IN_BACKGROUND);
+
+	if (!_snapshotsEnabled || !_differentialSnapshots)
+	{
+		_journal.reset();
+	}
 }
 
 void AutoMapSaver::clearChanges()
 {
     _savedChangeCount = 0;
+    _journal.reset();
 }
 
-void AutoMapSaver::saveSnapshot()
+void AutoMapSaver::saveSnapshot(bool inBackground)
 {
 	// Original GtkRadiant comments:
 	// we need to do the following
@@ -78,6 +93,12 @@ void AutoMapSaver::saveSnapshot()
 	// 2. find out what the lastest save is based on number
 	// 3. inc that and save the map
 
+	// The numbering and the journal rely on the previous snapshots being on disk
+	if (!inBackground || _differentialSnapshots)
+	{
+		_backgroundWriter.waitUntilIdle();
+	}
+
 	// Construct the fs::path class out of the full map path (throws on fail)
 	fs::path fullPath = GlobalMapModule().getMapName();
 
@@ -104,14 +125,33 @@ void AutoMapSaver::saveSnapshot()
 
 		collectExistingSnapshots(existingSnapshots, snapshotPath, mapName);
 
+		// Record the changes in the journal of the latest snapshot if possible
+		if (_differentialSnapshots && !existingSnapshots.empty() &&
+			appendToJournal(existingSnapshots.rbegin()->second))
+		{
+			handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
+			return;
+		}
+
 		int highestNum = existingSnapshots.empty() ? 0 : existingSnapshots.rbegin()->first + 1;
 
 		std::string filename = constructSnapshotName(snapshotPath, mapName, highestNum);
 
+		// Don't interfere with a snapshot that is being written right now
+		while (_backgroundWriter.isWriting(filename))
+		{
+			filename = constructSnapshotName(snapshotPath, mapName, ++highestNum);
+		}
+
 		rMessage() << "Autosaving snapshot to " << filename << std::endl;
 
 		// Dump to map to the next available filename
-        GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+		saveBackup(filename, inBackground);
+
+		if (_differentialSnapshots)
+		{
+			startJournal(filename);
+		}
 
 		handleSnapshotSizeLimit(existingSnapshots, snapshotPath, mapName);
 	}
@@ -121,6 +161,145 @@ void AutoMapSaver::saveSnapshot()
 	}
 }
 
+bool AutoMapSaver::appendToJournal(const std::string& latestSnapshot)
+{
+	// The journal needs to be based on the latest snapshot, which might have been
+	// written by an earlier session or have been removed in the meantime
+	if (!_journal || _journal->getBasePath() != fs::path(latestSnapshot) ||
+		!os::fileOrDirExists(latestSnapshot))
+	{
+		return false;
+	}
+
+	auto maxEntries = registry::getValue<std::size_t>(RKEY_AUTOSAVE_MAX_JOURNAL_ENTRIES);
+	const auto& journalPath = _journal->getPath();
+
+	// Compact the journal into a new full snapshot once it is getting too long
+	if (_journal->getNumEntries() >= maxEntries ||
+		(os::fileOrDirExists(journalPath.string()) &&
+		 os::getFileSize(journalPath.string()) > os::getFileSize(latestSnapshot)))
+	{
+		rMessage() << "AutoSaver: Compacting snapshot journal " << journalPath.string() <<
+			" into a full snapshot" << std::endl;
+		return false;
+	}
+
+	rMessage() << "Autosaving snapshot changes to " << journalPath.string() << std::endl;
+
+	const auto& root = GlobalSceneGraph().root();
+	return _journal->append(root, root->getUndoChangeTracker().getCurrentChangeCount());
+}
+
+void AutoMapSaver::startJournal(const std::string& snapshot)
+{
+	auto format = GlobalMap().getMapFormatForFilenameSafe(snapshot);
+
+	if (!format)
+	{
+		_journal.reset();
+		return;
+	}
+
+	_journal = std::make_unique<SnapshotJournal>(snapshot, format);
+
+	if (!_journal->start(GlobalSceneGraph().root()))
+	{
+		rWarning() << "AutoSaver: Entity names are not unique, can't record differential snapshots" << std::endl;
+		_journal.reset();
+	}
+}
+
+void AutoMapSaver::applySnapshotJournal(const cmd::ArgumentList& args)
+{
+	if (args.size() != 1)
+	{
+		rWarning() << "Usage: ApplySnapshotJournal <pathToJournal>" << std::endl;
+		return;
+	}
+
+	if (!GlobalSceneGraph().root())
+	{
+		throw cmd::ExecutionFailure(_("No map loaded"));
+	}
+
+	auto journalPath = args[0].getString();
+
+	if (!os::fileOrDirExists(journalPath))
+	{
+		throw cmd::ExecutionFailure(fmt::format(_("File not found: {0}"), journalPath));
+	}
+
+	try
+	{
+		UndoableCommand cmd("applySnapshotJournal");
+		SnapshotJournal::Apply(journalPath, GlobalSceneGraph().root());
+	}
+	catch (const std::runtime_error& ex)
+	{
+		throw cmd::ExecutionFailure(fmt::format(_("Failed to apply the snapshot journal {0}:\n{1}"),
+			journalPath, ex.what()));
+	}
+}
+
+void AutoMapSaver::saveBackup(const std::string& filename, bool inBackground)
+{
+	if (inBackground)
+	{
+		saveBackupInBackground(filename);
+		return;
+	}
+
+	// Don't let a pending background save overwrite this one afterwards
+	_backgroundWriter.waitUntilIdle();
+
+	GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+}
+
+void AutoMapSaver::saveBackupInBackground(const std::string& filename)
+{
+	auto format = GlobalMap().getMapFormatForFilenameSafe(filename);
+
+	if (!format)
+	{
+		rError() << "AutoSaver: No map format found for " << filename << std::endl;
+		return;
+	}
+
+	fs::path infoFilePath = filename;
+	infoFilePath.replace_extension(game::current::getInfoFileExtension());
+
+	// Capture the scene, the files are written by the worker afterwards
+	std::ostringstream mapStream;
+	std::ostringstream infoFileStream;
+
+	try
+	{
+		MapResource::exportToStreams(*format, GlobalSceneGraph().root(), scene::traverse,
+			mapStream, &infoFileStream);
+	}
+	catch (const IMapResource::OperationException& ex)
+	{
+		radiant::NotificationMessage::SendError(ex.what());
+		return;
+	}
+
+	if (!_backgroundWriter.write(filename, mapStream.str(),
+		format->allowInfoFileCreation() ? infoFilePath.string() : std::string(), infoFileStream.str()))
+	{
+		rMessage() << "AutoSaver: Replaced the autosave still waiting to be written to " << filename << std::endl;
+	}
+}
+
+void AutoMapSaver::reportBackgroundErrors()
+{
+	for (const auto& error : _backgroundWriter.takeErrors())
+	{
+		rError() << "AutoSaver: Background save failed: " << error << std::endl;
+
+		radiant::NotificationMessage::SendError(fmt::format(_("Automatic save failed:\n{0}"), error));
+	}
+}
+
 void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& existingSnapshots,
 	const fs::path& snapshotPath, const std::string& mapName)
 {
@@ -139,6 +318,13 @@ void AutoMapSaver::handleSnapshotSizeLimit(const std::map<int, std::string>& exi
 	for (const std::pair<int, std::string>& pair : existingSnapshots)
 	{
 		folderSize += os::getFileSize(pair.second);
+
+		auto journalPath = SnapshotJournal::GetJournalPath(pair.second).string();
+
+		if (os::fileOrDirExists(journalPath))
+		{
+			folderSize += os::getFileSize(journalPath);
+		}
 	}
 
 	std::size_t maxSize = maxSnapshotFolderSize * 1024 * 1024;
@@ -220,6 +406,24 @@ bool AutoMapSaver::runAutosaveCheck()
 
 void AutoMapSaver::performAutosave()
 {
+    autosave(false);
+}
+
+void AutoMapSaver::performAutosaveInBackground()
+{
+    autosave(_saveInBackground);
+}
+
+void AutoMapSaver::waitForBackgroundSaves()
+{
+    _backgroundWriter.waitUntilIdle();
+    reportBackgroundErrors();
+}
+
+void AutoMapSaver::autosave(bool inBackground)
+{
+    reportBackgroundErrors();
+
     // Remember the change tracking counter
     _savedChangeCount = GlobalSceneGraph().root()->getUndoChangeTracker().getCurrentChangeCount();
 
@@ -228,7 +432,7 @@ void AutoMapSaver::performAutosave()
     {
         try
         {
-            saveSnapshot();
+            saveSnapshot(inBackground);
         }
         catch (fs::filesystem_error& f)
         {
@@ -252,7 +456,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving unnamed map to " << autoSaveFilename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", autoSaveFilename);
+            saveBackup(autoSaveFilename, inBackground);
         }
         else
         {
@@ -268,7 +472,7 @@ void AutoMapSaver::performAutosave()
             rMessage() << "Autosaving map to " << filename << std::endl;
 
             // Invoke the save call
-            GlobalCommandSystem().executeCommand("SaveAutomaticBackup", filename);
+            saveBackup(filename, inBackground);
         }
     }
 }
@@ -281,6 +485,9 @@ void AutoMapSaver::constructPreferences()
 	page.appendCheckBox(_("Save Snapshots"), RKEY_AUTOSAVE_SNAPSHOTS_ENABLED);
 	page.appendEntry(_("Snapshot Folder (absolute, or relative to Map Folder)"), RKEY_AUTOSAVE_SNAPSHOTS_FOLDER);
 	page.appendEntry(_("Max total Snapshot size per Map (MB)"), RKEY_AUTOSAVE_MAX_SNAPSHOT_FOLDER_SIZE);
+	page.appendCheckBox(_("Save differential Snapshots"), RKEY_AUTOSAVE_DIFFERENTIAL_SNAPSHOTS);
+	page.appendCheckBox(_("Write Autosaves in the Background"), RKEY_AUTOSAVE_IN_BACKGROUND);
+	page.appendSpinner(_("Max Journal Entries per full Snapshot"), RKEY_AUTOSAVE_MAX_JOURNAL_ENTRIES, 1, 1000, 0);
 }
 
 void AutoMapSaver::onMapEvent(IMap::MapEvent ev)
@@ -315,6 +522,7 @@ const StringSet& AutoMapSaver::getDependencies() const
 		_dependencies.insert(MODULE_MAP);
 		_dependencies.insert(MODULE_PREFERENCESYSTEM);
 		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_COMMANDSYSTEM);
 	}
 
 	return _dependencies;
@@ -326,6 +534,17 @@ void AutoMapSaver::initialiseModule(const IApplicationContext& ctx)
 		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
 	));
 
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_DIFFERENTIAL_SNAPSHOTS).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
+
+	_signalConnections.push_back(GlobalRegistry().signalForKey(RKEY_AUTOSAVE_IN_BACKGROUND).connect(
+		sigc::mem_fun(this, &AutoMapSaver::registryKeyChanged)
+	));
+
+	GlobalCommandSystem().addCommand("ApplySnapshotJournal",
+		std::bind(&AutoMapSaver::applySnapshotJournal, this, std::placeholders::_1), { cmd::ARGTYPE_STRING });
+
 	// Get notified when the map is loaded afresh
 	_signalConnections.push_back(GlobalMapModule().signal_mapEvent().connect(
 		sigc::mem_fun(*this, &AutoMapSaver::onMapEvent)
@@ -350,6 +569,9 @@ void AutoMapSaver::shutdownModule()
 	}
 
 	_signalConnections.clear();
+
+	// Don't lose any autosave still waiting to be written
+	_backgroundWriter.waitUntilIdle();
 }
 
 module::StaticModuleRegistration<AutoMapSaver> staticAutoSaverModule;
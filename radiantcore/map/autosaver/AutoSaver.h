@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 
 #include "imap.h"
 #include "iautosaver.h"
@@ -8,6 +9,9 @@
 #include <vector>
 #include <sigc++/connection.h>
 #include "os/fs.h"
+#include "icommandsystem.h"
+#include "SnapshotJournal.h"
+#include "BackgroundMapWriter.h"
 
 namespace map
 {
@@ -23,6 +27,17 @@ private:
 	// TRUE, if the autosaver generates snapshots
 	bool _snapshotsEnabled;
 
+	// TRUE, if snapshots are recorded in a journal after the first full snapshot
+	bool _differentialSnapshots;
+
+	// The journal based on the most recent full snapshot
+	std::unique_ptr<SnapshotJournal> _journal;
+
+	// TRUE, if the timed autosaves are written by a worker thread
+	bool _saveInBackground;
+
+	BackgroundMapWriter _backgroundWriter;
+
 	std::size_t _savedChangeCount;
 
 	std::vector<sigc::connection> _signalConnections;
@@ -45,6 +60,8 @@ public:
     bool runAutosaveCheck() override;
 
     void performAutosave() override;
+    void performAutosaveInBackground() override;
+    void waitForBackgroundSaves() override;
 
 private:
 	void constructPreferences();
@@ -53,8 +70,29 @@ private:
 
 	void onMapEvent(IMap::MapEvent ev);
 
+	// Saves the current map, either directly or in the background
+	void autosave(bool inBackground);
+
 	// Saves a snapshot of the currently active map (only named maps)
-	void saveSnapshot();
+	void saveSnapshot(bool inBackground);
+
+	// Saves a copy of the current map to the given file without changing the remembered paths
+	void saveBackup(const std::string& filename, bool inBackground);
+
+	// Captures the current map and passes it to the background writer
+	void saveBackupInBackground(const std::string& filename);
+
+	// Logs the errors of the failed background saves
+	void reportBackgroundErrors();
+
+	// Appends the changes to the journal, returns false if a full snapshot is needed
+	bool appendToJournal(const std::string& latestSnapshot);
+
+	// Starts a new journal based on the given full snapshot
+	void startJournal(const std::string& snapshot);
+
+	// Command target applying a snapshot journal to the current map
+	void applySnapshotJournal(const cmd::ArgumentList& args);
 
 	void collectExistingSnapshots(std::map<int, std::string>& existingSnapshots,
 		const fs::path& snapshotPath, const std::string& mapName);
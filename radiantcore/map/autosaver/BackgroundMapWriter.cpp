@@ -0,0 +1,155 @@
+#include "BackgroundMapWriter.h"
+
+#include <fstream>
+#include <stdexcept>
+#include "os/fs.h"
+
+#include <fmt/format.h>
+
+namespace map
+{
+
+BackgroundMapWriter::~BackgroundMapWriter()
+{
+    waitUntilIdle();
+}
+
+bool BackgroundMapWriter::write(const std::string& mapPath, std::string mapContents,
+    const std::string& infoFilePath, std::string infoFileContents)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        // Replace the contents of a job still waiting for the same file
+        for (auto& job : _pendingJobs)
+        {
+            if (job.mapPath == mapPath)
+            {
+                job.mapContents = std::move(mapContents);
+                job.infoFilePath = infoFilePath;
+                job.infoFileContents = std::move(infoFileContents);
+                return false;
+            }
+        }
+
+        _pendingJobs.emplace_back(Job{ mapPath, std::move(mapContents), infoFilePath, std::move(infoFileContents) });
+    }
+
+    _queue.enqueue(std::bind(&BackgroundMapWriter::writeNextJob, this));
+
+    return true;
+}
+
+bool BackgroundMapWriter::isWriting(const std::string& mapPath) const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _currentPath == mapPath;
+}
+
+void BackgroundMapWriter::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(_lock);
+
+    _finished.wait(lock, [this]()
+    {
+        return _pendingJobs.empty() && _currentPath.empty();
+    });
+}
+
+std::vector<std::string> BackgroundMapWriter::takeErrors()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    std::vector<std::string> errors;
+    errors.swap(_errors);
+
+    return errors;
+}
+
+void BackgroundMapWriter::writeNextJob()
+{
+    Job job;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (_pendingJobs.empty())
+        {
+            return;
+        }
+
+        job = std::move(_pendingJobs.front());
+        _pendingJobs.pop_front();
+
+        _currentPath = job.mapPath;
+    }
+
+    std::string error;
+
+    try
+    {
+        writeFile(job.mapPath, job.mapContents);
+
+        if (!job.infoFilePath.empty())
+        {
+            writeFile(job.infoFilePath, job.infoFileContents);
+        }
+    }
+    catch (const std::exception& ex)
+    {
+        error = ex.what();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!error.empty())
+        {
+            _errors.emplace_back(std::move(error));
+        }
+
+        _currentPath.clear();
+    }
+
+    _finished.notify_all();
+}
+
+void BackgroundMapWriter::writeFile(const std::string& path, const std::string& contents)
+{
+    fs::path temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream stream(temporaryPath.string());
+
+        if (!stream.is_open())
+        {
+            throw std::runtime_error(fmt::format("Could not open file for writing: {0}", temporaryPath.string()));
+        }
+
+        stream.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        stream.flush();
+
+        if (stream.fail())
+        {
+            throw std::runtime_error(fmt::format("Failure writing to file {0}", temporaryPath.string()));
+        }
+    }
+
+    try
+    {
+        fs::rename(temporaryPath, path);
+    }
+    catch (const fs::filesystem_error& ex)
+    {
+        try
+        {
+            fs::remove(temporaryPath);
+        }
+        catch (const fs::filesystem_error&)
+        {}
+
+        throw std::runtime_error(fmt::format("Could not move {0} to {1}: {2}", temporaryPath.string(), path, ex.what()));
+    }
+}
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SequentialTaskQueue.h"
+
+namespace map
+{
+
+/**
+ * Writes map files captured by the autosaver to disk, using a worker thread
+ * such that editing can continue while the files are written.
+ *
+ * The map and info file contents are captured on the main thread and handed
+ * over as strings, the worker doesn't touch the scene. A capture for a path
+ * that is still waiting to be written replaces the waiting one, such that an
+ * autosave colliding with the next one is only written once.
+ */
+class BackgroundMapWriter
+{
+private:
+    struct Job
+    {
+        std::string mapPath;
+        std::string mapContents;
+
+        // The info file is not written if the path is empty
+        std::string infoFilePath;
+        std::string infoFileContents;
+    };
+
+    mutable std::mutex _lock;
+    std::condition_variable _finished;
+
+    // The jobs waiting to be written, oldest first
+    std::list<Job> _pendingJobs;
+
+    // The map path of the job currently being written (empty if idle)
+    std::string _currentPath;
+
+    // Error messages of the failed jobs, reported on the main thread
+    std::vector<std::string> _errors;
+
+    util::SequentialTaskQueue _queue;
+
+public:
+    // Blocks until all pending jobs are written
+    ~BackgroundMapWriter();
+
+    // Queues the given file contents for writing, an empty info file path
+    // indicates that there is no info file to write.
+    // Returns false if a pending job for the same path has been replaced.
+    bool write(const std::string& mapPath, std::string mapContents,
+        const std::string& infoFilePath, std::string infoFileContents);
+
+    // True if the given map path is being written right now
+    bool isWriting(const std::string& mapPath) const;
+
+    // Blocks until all pending jobs are written
+    void waitUntilIdle();
+
+    // Returns and clears the error messages of the failed jobs
+    std::vector<std::string> takeErrors();
+
+private:
+    // Worker thread function, writes the oldest pending job
+    void writeNextJob();
+
+    // Writes the contents to a temporary file which is then moved to the
+    // given path, such that the previous file is intact on failure
+    static void writeFile(const std::string& path, const std::string& contents);
+};
+
+}
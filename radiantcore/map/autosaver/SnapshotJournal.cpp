@@ -0,0 +1,529 @@
+#include "SnapshotJournal.h"
+
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "i18n.h"
+#include "itextstream.h"
+#include "ientity.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "imapformat.h"
+
+#include "gamelib.h"
+#include "scenelib.h"
+#include "math/Hash.h"
+#include "parser/DefTokeniser.h"
+#include "scene/ChildPrimitives.h"
+#include <fmt/format.h>
+
+namespace map
+{
+
+namespace
+{
+    const char* const JOURNAL_EXTENSION = "journal";
+    const char* const JOURNAL_HEADER = "SnapshotJournal";
+    const char* const JOURNAL_ENTRY = "SnapshotJournalEntry";
+    const char* const GKEY_FLOAT_PRECISION = "/mapFormat/floatPrecision";
+
+    const int JOURNAL_VERSION = 1;
+
+    struct EntityState
+    {
+        IEntityNodePtr node;
+        std::size_t fingerprint;
+    };
+
+    // Entities are identified by name, there's only one worldspawn per map
+    std::string getEntityIdentity(const Entity& entity)
+    {
+        return entity.isWorldspawn() ? entity.getKeyValue("classname") : entity.getKeyValue("name");
+    }
+
+    template<typename ValueType>
+    void addToHash(std::size_t& seed, const ValueType& value)
+    {
+        math::combineHash(seed, std::hash<ValueType>()(value));
+    }
+
+    void addToHash(std::size_t& seed, const Vector3& vector)
+    {
+        addToHash(seed, vector.x());
+        addToHash(seed, vector.y());
+        addToHash(seed, vector.z());
+    }
+
+    // Hashes the spawnargs and the primitives of the given entity
+    std::size_t calculateFingerprint(const IEntityNodePtr& entity)
+    {
+        std::size_t hash = 0;
+
+        entity->getEntity().forEachKeyValue([&](const std::string& key, const std::string& value)
+        {
+            addToHash(hash, key);
+            addToHash(hash, value);
+        });
+
+        entity->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (auto brushNode = std::dynamic_pointer_cast<IBrushNode>(child); brushNode)
+            {
+                const auto& brush = brushNode->getIBrush();
+                addToHash(hash, static_cast<int>(brush.getDetailFlag()));
+
+                for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+                {
+                    const auto& face = brush.getFace(i);
+
+                    addToHash(hash, face.getPlane3().normal());
+                    addToHash(hash, face.getPlane3().dist());
+
+                    auto texdef = face.getProjectionMatrix();
+                    addToHash(hash, texdef.xx());
+                    addToHash(hash, texdef.yx());
+                    addToHash(hash, texdef.zx());
+                    addToHash(hash, texdef.xy());
+                    addToHash(hash, texdef.yy());
+                    addToHash(hash, texdef.zy());
+
+                    addToHash(hash, face.getShader());
+                }
+            }
+            else if (auto patchNode = std::dynamic_pointer_cast<IPatchNode>(child); patchNode)
+            {
+                const auto& patch = patchNode->getPatch();
+
+                addToHash(hash, patch.getShader());
+                addToHash(hash, patch.getWidth());
+                addToHash(hash, patch.getHeight());
+                addToHash(hash, patch.subdivisionsFixed());
+                addToHash(hash, patch.getSubdivisions().x());
+                addToHash(hash, patch.getSubdivisions().y());
+
+                for (std::size_t r = 0; r < patch.getHeight(); ++r)
+                {
+                    for (std::size_t c = 0; c < patch.getWidth(); ++c)
+                    {
+                        const auto& control = patch.ctrlAt(r, c);
+                        addToHash(hash, control.vertex);
+                        addToHash(hash, control.texcoord.x());
+                        addToHash(hash, control.texcoord.y());
+                    }
+                }
+            }
+
+            return true;
+        });
+
+        return hash;
+    }
+
+    // Collects the state of every entity in the scene, returns false
+    // if one of the entities cannot be identified
+    bool collectEntityStates(const scene::IMapRootNodePtr& root, std::map<std::string, EntityState>& states)
+    {
+        bool success = true;
+
+        root->foreachNode([&](const scene::INodePtr& node)
+        {
+            auto entity = std::dynamic_pointer_cast<IEntityNode>(node);
+
+            if (!entity) return true;
+
+            auto identity = getEntityIdentity(entity->getEntity());
+
+            if (identity.empty() || !states.emplace(identity, EntityState{ entity, calculateFingerprint(entity) }).second)
+            {
+                rWarning() << "[SnapshotJournal] Entity without unique name: " << identity << std::endl;
+                success = false;
+            }
+
+            // Stop at the first failure
+            return success;
+        });
+
+        return success;
+    }
+
+    // Writes the given entity and its primitives like the map exporter does
+    void writeEntity(IMapWriter& writer, const IEntityNodePtr& entity, std::ostream& stream)
+    {
+        writer.beginWriteEntity(entity, stream);
+
+        entity->foreachNode([&](const scene::INodePtr& child)
+        {
+            if (auto brush = std::dynamic_pointer_cast<IBrushNode>(child); brush)
+            {
+                brush->getIBrush().evaluateBRep();
+
+                if (brush->getIBrush().hasContributingFaces())
+                {
+                    writer.beginWriteBrush(brush, stream);
+                    writer.endWriteBrush(brush, stream);
+                }
+            }
+            else if (auto patch = std::dynamic_pointer_cast<IPatchNode>(child); patch)
+            {
+                writer.beginWritePatch(patch, stream);
+                writer.endWritePatch(patch, stream);
+            }
+
+            return true;
+        });
+
+        writer.endWriteEntity(entity, stream);
+    }
+
+    // Collects the entities parsed from a journal entry, without adding them to the scene
+    class JournalImportFilter :
+        public IMapImportFilter
+    {
+    private:
+        scene::IMapRootNodePtr _root;
+
+    public:
+        std::vector<scene::INodePtr> entities;
+
+        JournalImportFilter(const scene::IMapRootNodePtr& root) :
+            _root(root)
+        {}
+
+        const scene::IMapRootNodePtr& getRootNode() const override
+        {
+            return _root;
+        }
+
+        bool addEntity(const scene::INodePtr& entity) override
+        {
+            entities.push_back(entity);
+            return true;
+        }
+
+        bool addPrimitiveToEntity(const scene::INodePtr& primitive, const scene::INodePtr& entity) override
+        {
+            if (!Node_getEntity(entity)->isContainer())
+            {
+                return false;
+            }
+
+            entity->addChildNode(primitive);
+            return true;
+        }
+    };
+
+    // Parses the key/value block following the given block name
+    std::multimap<std::string, std::string> parseBlock(parser::DefTokeniser& tok, const std::string& blockName)
+    {
+        std::multimap<std::string, std::string> values;
+
+        tok.assertNextToken(blockName);
+        tok.assertNextToken("{");
+
+        for (auto token = tok.nextToken(); token != "}"; token = tok.nextToken())
+        {
+            values.emplace(token, tok.nextToken());
+        }
+
+        return values;
+    }
+
+    // Replaces the entities of the scene with the ones of the given journal entry
+    void applyEntry(const std::string& entry, const MapFormat& format, const scene::IMapRootNodePtr& root,
+        std::map<std::string, scene::INodePtr>& sceneEntities)
+    {
+        // The header block is followed by the entities in the map format
+        auto headerEnd = entry.find("\n}\n");
+
+        if (headerEnd == std::string::npos)
+        {
+            throw std::runtime_error(_("Incomplete snapshot journal entry"));
+        }
+
+        parser::BasicDefTokeniser<std::string> tok(entry.substr(0, headerEnd + 3));
+        auto header = parseBlock(tok, JOURNAL_ENTRY);
+
+        auto removed = header.equal_range("removed");
+
+        for (auto i = removed.first; i != removed.second; ++i)
+        {
+            auto existing = sceneEntities.find(i->second);
+
+            if (existing != sceneEntities.end())
+            {
+                scene::removeNodeFromParent(existing->second);
+                sceneEntities.erase(existing);
+            }
+        }
+
+        JournalImportFilter importFilter(root);
+        std::istringstream stream(entry.substr(headerEnd + 3));
+
+        try
+        {
+            format.getMapReader(importFilter)->readFromStream(stream);
+        }
+        catch (const IMapReader::FailureException& ex)
+        {
+            throw std::runtime_error(ex.what());
+        }
+
+        for (const auto& entity : importFilter.entities)
+        {
+            auto identity = getEntityIdentity(*Node_getEntity(entity));
+            auto existing = sceneEntities.find(identity);
+
+            if (existing != sceneEntities.end())
+            {
+                scene::removeNodeFromParent(existing->second);
+            }
+
+            // The worldspawn goes for the pole position, like everywhere else
+            if (Node_getEntity(entity)->isWorldspawn())
+            {
+                root->addChildNodeToFront(entity);
+            }
+            else
+            {
+                root->addChildNode(entity);
+            }
+
+            scene::addOriginToChildPrimitives(entity);
+
+            sceneEntities[identity] = entity;
+        }
+    }
+}
+
+SnapshotJournal::SnapshotJournal(const fs::path& basePath, const MapFormatPtr& format) :
+    _basePath(basePath),
+    _journalPath(GetJournalPath(basePath)),
+    _format(format),
+    _numEntries(0)
+{}
+
+const fs::path& SnapshotJournal::getBasePath() const
+{
+    return _basePath;
+}
+
+const fs::path& SnapshotJournal::getPath() const
+{
+    return _journalPath;
+}
+
+std::size_t SnapshotJournal::getNumEntries() const
+{
+    return _numEntries;
+}
+
+bool SnapshotJournal::start(const scene::IMapRootNodePtr& root)
+{
+    _numEntries = 0;
+    _fingerprints.clear();
+
+    std::map<std::string, EntityState> states;
+
+    if (!_format || !collectEntityStates(root, states))
+    {
+        return false;
+    }
+
+    for (const auto& [identity, state] : states)
+    {
+        _fingerprints.emplace(identity, state.fingerprint);
+    }
+
+    // Remove any leftover of an earlier session
+    if (fs::exists(_journalPath))
+    {
+        fs::remove(_journalPath);
+    }
+
+    return true;
+}
+
+bool SnapshotJournal::append(const scene::IMapRootNodePtr& root, std::size_t changeCount)
+{
+    std::map<std::string, EntityState> states;
+
+    if (!collectEntityStates(root, states))
+    {
+        return false;
+    }
+
+    std::vector<std::string> removed;
+    std::vector<IEntityNodePtr> changed;
+
+    for (const auto& [identity, fingerprint] : _fingerprints)
+    {
+        if (states.count(identity) == 0)
+        {
+            removed.push_back(identity);
+        }
+    }
+
+    for (const auto& [identity, state] : states)
+    {
+        auto previous = _fingerprints.find(identity);
+
+        if (previous == _fingerprints.end() || previous->second != state.fingerprint)
+        {
+            changed.push_back(state.node);
+        }
+    }
+
+    if (removed.empty() && changed.empty())
+    {
+        return true;
+    }
+
+    std::ostringstream entry;
+    entry.precision(game::current::getValue<int>(GKEY_FLOAT_PRECISION, 6));
+
+    // The journal header is written along with the first entry
+    if (_numEntries == 0)
+    {
+        entry << JOURNAL_HEADER << "\n{\n";
+        entry << "\t\"version\" \"" << JOURNAL_VERSION << "\"\n";
+        entry << "\t\"format\" \"" << _format->getMapFormatName() << "\"\n";
+        entry << "\t\"base\" \"" << _basePath.filename().string() << "\"\n";
+        entry << "}\n";
+    }
+
+    entry << JOURNAL_ENTRY << "\n{\n";
+    entry << "\t\"changeCount\" \"" << changeCount << "\"\n";
+
+    for (const auto& identity : removed)
+    {
+        entry << "\t\"removed\" \"" << identity << "\"\n";
+    }
+
+    entry << "}\n";
+
+    auto writer = _format->getMapWriter();
+    writer->beginWriteMap(root, entry);
+
+    for (const auto& entity : changed)
+    {
+        // Child primitives are written relative to their entity, like in the map file
+        scene::removeOriginFromChildPrimitives(entity);
+
+        try
+        {
+            writeEntity(*writer, entity, entry);
+        }
+        catch (const IMapWriter::FailureException& ex)
+        {
+            rError() << "[SnapshotJournal] Failure writing entity: " << ex.what() << std::endl;
+        }
+
+        scene::addOriginToChildPrimitives(entity);
+    }
+
+    writer->endWriteMap(root, entry);
+
+    std::ofstream stream(_journalPath.string(), _numEntries == 0 ? std::ios::trunc : std::ios::app);
+    stream << entry.str();
+    stream.close();
+
+    if (stream.fail())
+    {
+        rError() << "[SnapshotJournal] Could not write to " << _journalPath.string() << std::endl;
+        return false;
+    }
+
+    ++_numEntries;
+
+    _fingerprints.clear();
+
+    for (const auto& [identity, state] : states)
+    {
+        _fingerprints.emplace(identity, state.fingerprint);
+    }
+
+    rMessage() << "[SnapshotJournal] Wrote " << changed.size() << " changed and " <<
+        removed.size() << " removed entities to " << _journalPath.string() << std::endl;
+
+    return true;
+}
+
+fs::path SnapshotJournal::GetJournalPath(const fs::path& basePath)
+{
+    fs::path journalPath = basePath;
+    return journalPath.replace_extension(JOURNAL_EXTENSION);
+}
+
+void SnapshotJournal::Apply(const std::string& journalPath, const scene::IMapRootNodePtr& root)
+{
+    std::ifstream stream(journalPath);
+
+    if (!stream.is_open())
+    {
+        throw std::runtime_error(fmt::format(_("Could not open file: {0}"), journalPath));
+    }
+
+    std::stringstream buffer;
+    buffer << stream.rdbuf();
+    auto contents = buffer.str();
+
+    // Every entry starts with its block name on a line of its own
+    auto entryMarker = std::string("\n") + JOURNAL_ENTRY + "\n";
+    auto entryStart = contents.find(entryMarker);
+
+    if (entryStart == std::string::npos)
+    {
+        throw std::runtime_error(fmt::format(_("No entries found in snapshot journal {0}"), journalPath));
+    }
+
+    parser::BasicDefTokeniser<std::string> tok(contents.substr(0, entryStart));
+    auto header = parseBlock(tok, JOURNAL_HEADER);
+
+    auto version = header.find("version");
+
+    if (version == header.end() || version->second != std::to_string(JOURNAL_VERSION))
+    {
+        throw std::runtime_error(fmt::format(_("Unsupported snapshot journal version in {0}"), journalPath));
+    }
+
+    auto formatName = header.find("format");
+    auto format = formatName != header.end() ? GlobalMapFormatManager().getMapFormatByName(formatName->second) : MapFormatPtr();
+
+    if (!format)
+    {
+        throw std::runtime_error(fmt::format(_("Unknown map format in snapshot journal {0}"), journalPath));
+    }
+
+    std::map<std::string, scene::INodePtr> sceneEntities;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity)
+        {
+            sceneEntities.emplace(getEntityIdentity(*entity), node);
+        }
+
+        return true;
+    });
+
+    try
+    {
+        while (entryStart != std::string::npos)
+        {
+            auto entryEnd = contents.find(entryMarker, entryStart + 1);
+            auto end = entryEnd != std::string::npos ? entryEnd + 1 : contents.size();
+
+            applyEntry(contents.substr(entryStart + 1, end - entryStart - 1), *format, root, sceneEntities);
+
+            entryStart = entryEnd;
+        }
+    }
+    catch (const parser::ParseException& ex)
+    {
+        throw std::runtime_error(fmt::format(_("Failed to parse snapshot journal {0}: {1}"), journalPath, ex.what()));
+    }
+}
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include "inode.h"
+#include "imapformat.h"
+#include "os/fs.h"
+
+namespace map
+{
+
+/**
+ * Append-only journal of differential snapshots, stored next to the full
+ * snapshot it is based on (e.g. "snapshots/arkham.3.journal" next to
+ * "snapshots/arkham.3.map").
+ *
+ * Every entry holds the entities added or changed since the previous entry,
+ * written in the map format of the snapshot, followed by the names of the
+ * removed entities. Changes are detected by comparing a fingerprint of the
+ * spawnargs and primitives of each entity, entities are identified by name.
+ *
+ * Replaying the entries on top of the base snapshot restores the map as it
+ * has been at the time of the last entry, see Apply(). Layers and the other
+ * info file data are not part of the journal.
+ */
+class SnapshotJournal
+{
+private:
+    fs::path _basePath;
+    fs::path _journalPath;
+
+    MapFormatPtr _format;
+
+    // The fingerprint of each entity at the time of the previous entry
+    std::map<std::string, std::size_t> _fingerprints;
+
+    std::size_t _numEntries;
+
+public:
+    SnapshotJournal(const fs::path& basePath, const MapFormatPtr& format);
+
+    // The full snapshot this journal is based on
+    const fs::path& getBasePath() const;
+
+    // The journal file, which only exists after the first entry has been written
+    const fs::path& getPath() const;
+
+    std::size_t getNumEntries() const;
+
+    // Starts a new journal for the given scene, which has just been written to
+    // the base snapshot. Returns false if the scene cannot be journaled, which
+    // is the case if the entities are not uniquely named.
+    bool start(const scene::IMapRootNodePtr& root);
+
+    // Appends an entry holding the changes since the previous entry, nothing is
+    // written if nothing changed. Returns false on failure, the caller is supposed
+    // to write a full snapshot instead.
+    bool append(const scene::IMapRootNodePtr& root, std::size_t changeCount);
+
+    // Returns the path of the journal belonging to the given full snapshot
+    static fs::path GetJournalPath(const fs::path& basePath);
+
+    // Replays the journal at the given path on the given scene, which has to be
+    // loaded from the base snapshot. Throws std::runtime_error on failure.
+    static void Apply(const std::string& journalPath, const scene::IMapRootNodePtr& root);
+};
+
+}
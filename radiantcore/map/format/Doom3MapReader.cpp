@@ -4,12 +4,20 @@
 #include "ieclass.h"
 #include "igame.h"
 #include "ientity.h"
+#include "imap.h"
 #include "string/string.h"
+#include "string/trim.h"
+#include "registry/registry.h"
 
 #include "Doom3MapFormat.h"
+#include "map/OperationReport.h"
+#include "map/UnloadedBlockNode.h"
 
 #include "i18n.h"
 #include <fmt/format.h>
+#include <atomic>
+#include <future>
+#include <thread>
 
 #include "primitiveparsers/BrushDef.h"
 #include "primitiveparsers/BrushDef3.h"
@@ -18,26 +26,120 @@
 
 namespace map {
 
+namespace
+{
+	// The number of primitives located by the scan before they are parsed
+	const std::size_t PRIMITIVES_PER_BATCH = 16384;
+
+	// Every worker thread should have this many primitives to parse at least
+	const std::size_t MIN_PRIMITIVES_PER_WORKER = 64;
+
+	std::size_t getBufferOffset(const std::string& buffer, std::string_view token)
+	{
+		return static_cast<std::size_t>(token.data() - buffer.data());
+	}
+
+	// True if the token is the given brace character of the buffer, not a quoted one
+	bool isStructuralBrace(const std::string& buffer, std::string_view token, char brace)
+	{
+		if (token.size() != 1 || token.front() != brace ||
+			token.data() < buffer.data() || token.data() >= buffer.data() + buffer.size())
+		{
+			return false;
+		}
+
+		auto offset = getBufferOffset(buffer, token);
+		return offset == 0 || buffer[offset - 1] != '"';
+	}
+
+	// The trimmed text between the given buffer offsets
+	std::string getBlockText(const std::string& buffer, std::size_t begin, std::size_t end)
+	{
+		return string::trim_copy(buffer.substr(begin, end - begin));
+	}
+
+	[[noreturn]] void throwEntityFailure(std::size_t entityNum, const IMapReader::FailureException& e)
+	{
+		std::string text = fmt::format(_("Failed parsing entity {0:d}:\n{1}"), entityNum, e.what());
+
+		// Re-throw with more text
+		throw IMapReader::FailureException(text);
+	}
+}
+
 Doom3MapReader::Doom3MapReader(IMapImportFilter& importFilter) : 
 	_importFilter(importFilter),
 	_entityCount(0),
-	_primitiveCount(0)
+	_primitiveCount(0),
+	_inputStream(nullptr),
+	_bufferTokeniser(nullptr),
+	_bufferOffset(0),
+	_nodeIndex(0)
 {}
 
+void Doom3MapReader::setNodeFilter(const std::function<bool(std::size_t)>& isNodeRequired, const std::string& formatName)
+{
+	_isNodeRequired = isNodeRequired;
+	_formatName = formatName;
+}
+
 void Doom3MapReader::readFromStream(std::istream& stream)
 {
 	// Call the virtual method to initialise the primitve parser map (if not done yet)
 	initPrimitiveParsers();
 
-	// The tokeniser used to split the stream into pieces
-	parser::BasicDefTokeniser<std::istream> tok(stream);
+	// Load the whole stream into memory, the tokens are referring to this buffer
+	const std::string buffer(std::istreambuf_iterator<char>(stream), {});
+
+	// The tokeniser used to split the buffer into pieces
+	parser::BasicDefTokeniser<std::string_view> tok(buffer, parser::WHITESPACE, "{}(),");
+
+	// The import filter is reporting the progress based on the stream position,
+	// move it back to the start and let it follow the tokeniser
+	stream.clear();
+	stream.seekg(0, std::ios::beg);
+
+	_inputStream = &stream;
+	_bufferTokeniser = &tok;
+	_bufferOffset = 0;
 
 	// Try to parse the map version (throws on failure)
 	parseMapVersion(tok);
 
+	// The tokeniser should have just passed the opening brace of the first entity.
+	// Partial loading relies on the block scan, which is done by the parallel parser.
+	if ((_isNodeRequired || registry::getValue<bool>(RKEY_MAP_PARALLEL_PARSING)) && tok.hasMoreTokens() &&
+		tok.peek() == "{" && buffer[tok.getPosition() - 1] == '{')
+	{
+		auto offset = parseEntitiesInParallel(buffer, tok.getPosition() - 1);
+
+		// Whatever is left is handled by the serial parser, including any error reporting
+		parser::BasicDefTokeniser<std::string_view> remainder(
+			std::string_view(buffer).substr(offset), parser::WHITESPACE, "{}(),");
+
+		_bufferTokeniser = &remainder;
+		_bufferOffset = offset;
+
+		parseEntities(remainder);
+	}
+	else
+	{
+		parseEntities(tok);
+	}
+
+	_inputStream = nullptr;
+	_bufferTokeniser = nullptr;
+
+	// EOF reached, success
+}
+
+void Doom3MapReader::parseEntities(parser::BasicDefTokeniser<std::string_view>& tok)
+{
 	// Read each entity in the map, until EOF is reached
 	while (tok.hasMoreTokens())
 	{
+		updateStreamPosition();
+
 		// Create an entity node by parsing from the stream. If there is an
 		// exception, display it and return
 		try
@@ -46,16 +148,403 @@ void Doom3MapReader::readFromStream(std::istream& stream)
 		}
 		catch (FailureException& e)
 		{
-			std::string text = fmt::format(_("Failed parsing entity {0:d}:\n{1}"), _entityCount, e.what());
-
-			// Re-throw with more text
-			throw FailureException(text);
+			throwEntityFailure(_entityCount, e);
 		}
 
 		_entityCount++;
 	}
+}
 
-	// EOF reached, success
+std::size_t Doom3MapReader::parseEntitiesInParallel(const std::string& buffer, std::size_t offset)
+{
+	// This tokeniser is only looking for the braces, the token views are pointing
+	// into the buffer, which is used to calculate the offsets
+	parser::BasicDefTokeniser<std::string_view> tok(
+		std::string_view(buffer).substr(offset), parser::WHITESPACE, "{}(),");
+
+	std::vector<EntityBlock> entities;
+	std::vector<PrimitiveBlock> primitives;
+	std::vector<ParsedPrimitivePtr> parsedPrimitives;
+
+	while (tok.hasMoreTokens())
+	{
+		entities.clear();
+		primitives.clear();
+
+		// Phase one: locate a batch of entities, keeping the amount of parsed data in memory limited
+		bool scanFailed = false;
+
+		while (primitives.size() < PRIMITIVES_PER_BATCH && tok.hasMoreTokens())
+		{
+			EntityBlock entity;
+
+			if (!scanEntity(tok, buffer, entity, primitives))
+			{
+				scanFailed = true;
+				break;
+			}
+
+			entities.push_back(entity);
+		}
+
+		if (scanFailed)
+		{
+			// Drop the primitives of the entity which could not be scanned
+			primitives.resize(entities.empty() ? 0 :
+				entities.back().firstPrimitive + entities.back().numPrimitives);
+		}
+
+		// Everything is loaded unless a node filter has been set
+		std::vector<bool> entityLoaded(entities.size(), true);
+		std::vector<bool> primitiveLoaded(primitives.size(), true);
+
+		if (_isNodeRequired)
+		{
+			selectNodesToLoad(entities, entityLoaded, primitiveLoaded);
+		}
+
+		// Phase two: parse the primitives in parallel
+		{
+			OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+			parsePrimitivesDetached(buffer, primitives, primitiveLoaded, parsedPrimitives);
+		}
+
+		// Create and insert the nodes in file order
+		for (std::size_t i = 0; i < entities.size(); ++i)
+		{
+			const auto& entity = entities[i];
+
+			if (!insertEntity(buffer, entity, entityLoaded[i], primitives, primitiveLoaded, parsedPrimitives))
+			{
+				return entity.begin;
+			}
+
+			offset = entity.end + 1;
+		}
+
+		if (scanFailed)
+		{
+			break;
+		}
+	}
+
+	return offset;
+}
+
+bool Doom3MapReader::scanEntity(parser::BasicDefTokeniser<std::string_view>& tok, const std::string& buffer,
+	EntityBlock& entity, std::vector<PrimitiveBlock>& primitives)
+{
+	try
+	{
+		auto token = tok.nextTokenView();
+
+		if (!isStructuralBrace(buffer, token, '{'))
+		{
+			return false;
+		}
+
+		entity.begin = getBufferOffset(buffer, token);
+		entity.firstPrimitive = primitives.size();
+
+		std::size_t depth = 1;
+		std::size_t primitiveBegin = 0;
+
+		while (tok.hasMoreTokens())
+		{
+			token = tok.nextTokenView();
+
+			if (token == "{")
+			{
+				if (!isStructuralBrace(buffer, token, '{')) return false;
+
+				if (depth == 1)
+				{
+					// The primitive keyword is following the brace
+					primitiveBegin = getBufferOffset(buffer, token) + 1;
+				}
+
+				++depth;
+			}
+			else if (token == "}")
+			{
+				if (!isStructuralBrace(buffer, token, '}')) return false;
+
+				if (--depth == 1)
+				{
+					primitives.push_back(PrimitiveBlock{ primitiveBegin, getBufferOffset(buffer, token) + 1 });
+				}
+				else if (depth == 0)
+				{
+					entity.end = getBufferOffset(buffer, token);
+					entity.numPrimitives = primitives.size() - entity.firstPrimitive;
+					return true;
+				}
+			}
+		}
+	}
+	catch (const parser::ParseException&)
+	{}
+
+	// Unterminated entity or broken tokens, leave this to the serial parser
+	return false;
+}
+
+void Doom3MapReader::selectNodesToLoad(const std::vector<EntityBlock>& entities,
+	std::vector<bool>& entityLoaded, std::vector<bool>& primitiveLoaded)
+{
+	for (std::size_t i = 0; i < entities.size(); ++i)
+	{
+		const auto& entity = entities[i];
+
+		auto entityIndex = _nodeIndex++;
+		bool anyPrimitiveLoaded = false;
+
+		for (auto p = entity.firstPrimitive; p < entity.firstPrimitive + entity.numPrimitives; ++p)
+		{
+			primitiveLoaded[p] = _isNodeRequired(_nodeIndex++);
+			anyPrimitiveLoaded = anyPrimitiveLoaded || primitiveLoaded[p];
+		}
+
+		// The worldspawn is always needed, the map would create another one otherwise
+		entityLoaded[i] = entityIndex == 0 || anyPrimitiveLoaded || _isNodeRequired(entityIndex);
+	}
+}
+
+void Doom3MapReader::parsePrimitivesDetached(const std::string& buffer, const std::vector<PrimitiveBlock>& primitives,
+	const std::vector<bool>& primitiveLoaded, std::vector<ParsedPrimitivePtr>& parsedPrimitives) const
+{
+	parsedPrimitives.clear();
+	parsedPrimitives.resize(primitives.size());
+
+	std::atomic<std::size_t> nextIndex(0);
+
+	auto worker = [&]()
+	{
+		for (auto i = nextIndex++; i < primitives.size(); i = nextIndex++)
+		{
+			if (primitiveLoaded[i])
+			{
+				parsedPrimitives[i] = parsePrimitiveDetached(buffer, primitives[i]);
+			}
+		}
+	};
+
+	// Small batches are not worth spawning any threads
+	auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+		primitives.size() / MIN_PRIMITIVES_PER_WORKER);
+
+	std::vector<std::future<void>> workers;
+
+	for (std::size_t i = 1; i < numWorkers; ++i)
+	{
+		workers.emplace_back(std::async(std::launch::async, worker));
+	}
+
+	// The calling thread is processing its share too
+	worker();
+
+	// Wait for all workers, this is re-throwing any exceptions
+	for (auto& result : workers)
+	{
+		result.get();
+	}
+}
+
+ParsedPrimitivePtr Doom3MapReader::parsePrimitiveDetached(const std::string& buffer, const PrimitiveBlock& primitive) const
+{
+	parser::BasicDefTokeniser<std::string_view> tok(
+		std::string_view(buffer).substr(primitive.begin, primitive.end - primitive.begin), parser::WHITESPACE, "{}(),");
+
+	try
+	{
+		auto p = _primitiveParsers.find(tok.nextToken());
+
+		if (p == _primitiveParsers.end())
+		{
+			return ParsedPrimitivePtr();
+		}
+
+		auto parsed = p->second->parseDetached(tok);
+
+		// The parser must have stopped at the closing brace found by the scan
+		if (parsed && !tok.hasMoreTokens())
+		{
+			return parsed;
+		}
+	}
+	catch (const std::exception&)
+	{
+		// The error message is produced by the serial parser
+	}
+
+	return ParsedPrimitivePtr();
+}
+
+scene::INodePtr Doom3MapReader::parsePrimitiveBlock(const std::string& buffer, const PrimitiveBlock& primitive) const
+{
+	parser::BasicDefTokeniser<std::string_view> tok(
+		std::string_view(buffer).substr(primitive.begin, primitive.end - primitive.begin), parser::WHITESPACE, "{}(),");
+
+	try
+	{
+		auto p = _primitiveParsers.find(tok.nextToken());
+
+		if (p != _primitiveParsers.end())
+		{
+			auto node = p->second->parse(tok);
+
+			if (!tok.hasMoreTokens())
+			{
+				return node;
+			}
+		}
+	}
+	catch (const std::exception&)
+	{
+		// The error message is produced by the serial parser
+	}
+
+	return scene::INodePtr();
+}
+
+bool Doom3MapReader::insertEntity(const std::string& buffer, const EntityBlock& entity, bool entityLoaded,
+	const std::vector<PrimitiveBlock>& primitives, const std::vector<bool>& primitiveLoaded,
+	std::vector<ParsedPrimitivePtr>& parsedPrimitives)
+{
+	// Create all nodes before inserting anything, the serial parser
+	// is taking over the whole entity if anything goes wrong
+	std::vector<scene::INodePtr> nodes;
+	nodes.reserve(entity.numPrimitives);
+
+	for (auto i = entity.firstPrimitive; i < entity.firstPrimitive + entity.numPrimitives; ++i)
+	{
+		if (!primitiveLoaded[i])
+		{
+			nodes.push_back(std::make_shared<UnloadedBlockNode>(UnloadedBlockNode::Kind::Primitive,
+				getBlockText(buffer, primitives[i].begin, primitives[i].end), _formatName));
+			continue;
+		}
+
+		OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+
+		auto node = parsedPrimitives[i] ? parsedPrimitives[i]->createNode() : parsePrimitiveBlock(buffer, primitives[i]);
+
+		if (!node)
+		{
+			return false;
+		}
+
+		parsedPrimitives[i].reset();
+		nodes.push_back(node);
+	}
+
+	// The keyvalues in front of, in between and behind the primitives
+	std::vector<std::vector<EntityKeyValues::value_type>> keyValueSegments(entity.numPrimitives + 1);
+
+	for (std::size_t i = 0; i < keyValueSegments.size(); ++i)
+	{
+		auto begin = i == 0 ? entity.begin + 1 : primitives[entity.firstPrimitive + i - 1].end;
+		auto end = i < entity.numPrimitives ? primitives[entity.firstPrimitive + i].begin - 1 : entity.end;
+
+		parser::BasicDefTokeniser<std::string_view> tok(
+			std::string_view(buffer).substr(begin, end - begin), parser::WHITESPACE, "{}(),");
+
+		while (tok.hasMoreTokens())
+		{
+			auto key = tok.nextToken();
+
+			// A key without value is reported by the serial parser
+			if (!tok.hasMoreTokens())
+			{
+				return false;
+			}
+
+			keyValueSegments[i].emplace_back(key, tok.nextToken());
+		}
+	}
+
+	// Insert everything in the same order the serial parser would do
+	setStreamPosition(entity.begin);
+
+	try
+	{
+		EntityKeyValues keyValues;
+		scene::INodePtr entityNode;
+
+		if (!entityLoaded)
+		{
+			// Placeholder entities keep their keyvalues in front of the primitives,
+			// without the comments, which are re-generated by the writer
+			for (const auto& segment : keyValueSegments)
+			{
+				keyValues.insert(segment.begin(), segment.end());
+			}
+
+			std::string keyValueText;
+
+			for (const auto& [key, value] : keyValues)
+			{
+				keyValueText += (keyValueText.empty() ? "\"" : "\n\"") + key + "\" \"" + value + "\"";
+			}
+
+			entityNode = std::make_shared<UnloadedBlockNode>(UnloadedBlockNode::Kind::Entity,
+				keyValueText, _formatName);
+		}
+
+		_primitiveCount = 0;
+
+		for (std::size_t i = 0; i < keyValueSegments.size(); ++i)
+		{
+			keyValues.insert(keyValueSegments[i].begin(), keyValueSegments[i].end());
+
+			if (i == nodes.size())
+			{
+				break;
+			}
+
+			// Create the entity right now, if not yet done
+			if (!entityNode)
+			{
+				entityNode = createEntity(keyValues);
+			}
+
+			_primitiveCount++;
+			setStreamPosition(primitives[entity.firstPrimitive + i].begin);
+
+			_importFilter.addPrimitiveToEntity(nodes[i], entityNode);
+		}
+
+		if (!entityNode)
+		{
+			entityNode = createEntity(keyValues);
+		}
+
+		_importFilter.addEntity(entityNode);
+	}
+	catch (FailureException& e)
+	{
+		throwEntityFailure(_entityCount, e);
+	}
+
+	_entityCount++;
+
+	return true;
+}
+
+void Doom3MapReader::updateStreamPosition()
+{
+	if (_bufferTokeniser)
+	{
+		setStreamPosition(_bufferOffset + _bufferTokeniser->getPosition());
+	}
+}
+
+void Doom3MapReader::setStreamPosition(std::size_t offset)
+{
+	if (_inputStream)
+	{
+		_inputStream->seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	}
 }
 
 void Doom3MapReader::initPrimitiveParsers()
@@ -121,6 +610,8 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 {
     _primitiveCount++;
 
+    updateStreamPosition();
+
 	std::string primitiveKeyword = tok.nextToken();
 
 	// Get a parser for this keyword
@@ -136,7 +627,12 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 	// Try to parse the primitive, throwing exception if failed
 	try
 	{
-		scene::INodePtr primitive = parser->parse(tok);
+		scene::INodePtr primitive;
+
+		{
+			OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+			primitive = parser->parse(tok);
+		}
 
 		if (!primitive)
 		{
@@ -157,6 +653,8 @@ void Doom3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INod
 
 scene::INodePtr Doom3MapReader::createEntity(const EntityKeyValues& keyValues)
 {
+    OperationReport::ScopedPhase phase(OperationReport::Phase::EntityCreation);
+
     // Get the classname from the EntityKeyValues
     EntityKeyValues::const_iterator found = keyValues.find("classname");
 
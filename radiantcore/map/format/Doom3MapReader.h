@@ -1,7 +1,9 @@
 #ifndef NODE_IMPORTER_H_
 #define NODE_IMPORTER_H_
 
+#include <functional>
 #include <map>
+#include <vector>
 #include "inode.h"
 #include "imapformat.h"
 #include "parser/DefTokeniser.h"
@@ -33,6 +35,13 @@ public:
 	// IMapReader implementation
 	virtual void readFromStream(std::istream& stream);
 
+	// Enables the partial loading: only the nodes accepted by the given function are parsed,
+	// the others are inserted as UnloadedBlockNodes tagged with the given format name.
+	// The function receives the node index, counting each entity followed by its primitives
+	// in file order, the same way the nodes are listed in the map info file.
+	// An entity is parsed if any of its primitives is, the first entity is always parsed.
+	void setNodeFilter(const std::function<bool(std::size_t)>& isNodeRequired, const std::string& formatName);
+
 protected:
 	// Set up our set of primitive parsers
 	virtual void initPrimitiveParsers();
@@ -51,6 +60,80 @@ protected:
 
 	// Create an entity with the given properties and layers
 	scene::INodePtr createEntity(const EntityKeyValues& keyValues);
+
+private:
+	// Set during readFromStream()
+	std::istream* _inputStream;
+	const parser::BasicDefTokeniser<std::string_view>* _bufferTokeniser;
+
+	// The buffer offset of the text the tokeniser is working on
+	std::size_t _bufferOffset;
+
+	// Set by setNodeFilter(), plus the index of the next node passed to it
+	std::function<bool(std::size_t)> _isNodeRequired;
+	std::string _formatName;
+	std::size_t _nodeIndex;
+
+	// The location of an entity block in the buffer, as found by scanEntity()
+	struct EntityBlock
+	{
+		// The offsets of the opening and the closing brace
+		std::size_t begin;
+		std::size_t end;
+
+		// The range of this entity's primitives in the PrimitiveBlock list
+		std::size_t firstPrimitive;
+		std::size_t numPrimitives;
+	};
+
+	// The location of a primitive block, starting at its keyword
+	// and ending behind the closing brace
+	struct PrimitiveBlock
+	{
+		std::size_t begin;
+		std::size_t end;
+	};
+
+	// Reads all entities from the given tokeniser
+	void parseEntities(parser::BasicDefTokeniser<std::string_view>& tok);
+
+	// Reads the entities starting at the given offset, parsing the primitives on
+	// multiple threads. Returns the offset at which this stopped, because the
+	// remaining text is not structured in a way the serial parser would agree with.
+	std::size_t parseEntitiesInParallel(const std::string& buffer, std::size_t offset);
+
+	// Locates the braces of the next entity and its primitives, returns false
+	// if the braces cannot be matched unambiguously
+	bool scanEntity(parser::BasicDefTokeniser<std::string_view>& tok, const std::string& buffer,
+		EntityBlock& entity, std::vector<PrimitiveBlock>& primitives);
+
+	// Asks the node filter which of the given entities and primitives need to be parsed
+	void selectNodesToLoad(const std::vector<EntityBlock>& entities,
+		std::vector<bool>& entityLoaded, std::vector<bool>& primitiveLoaded);
+
+	// Runs parseDetached() on the given primitive blocks that are to be loaded, using multiple
+	// threads. The primitives that cannot be parsed this way are left empty.
+	void parsePrimitivesDetached(const std::string& buffer, const std::vector<PrimitiveBlock>& primitives,
+		const std::vector<bool>& primitiveLoaded, std::vector<ParsedPrimitivePtr>& parsedPrimitives) const;
+
+	// Parses a single primitive block, returns an empty pointer on failure
+	ParsedPrimitivePtr parsePrimitiveDetached(const std::string& buffer, const PrimitiveBlock& primitive) const;
+
+	// Runs the regular parse() method on the given primitive block, returns an empty pointer on failure
+	scene::INodePtr parsePrimitiveBlock(const std::string& buffer, const PrimitiveBlock& primitive) const;
+
+	// Creates the nodes of the given entity and inserts them, returns false without
+	// inserting anything if the entity needs to be handled by the serial parser.
+	// Entities and primitives which are not to be loaded are inserted as placeholders.
+	bool insertEntity(const std::string& buffer, const EntityBlock& entity, bool entityLoaded,
+		const std::vector<PrimitiveBlock>& primitives, const std::vector<bool>& primitiveLoaded,
+		std::vector<ParsedPrimitivePtr>& parsedPrimitives);
+
+	// Moves the stream to the position the tokeniser has reached
+	void updateStreamPosition();
+
+	// Moves the stream to the given buffer offset
+	void setStreamPosition(std::size_t offset);
 };
 
 } // namespace map
@@ -96,4 +96,47 @@ void Doom3MapWriter::endWritePatch(const IPatchNodePtr& patch, std::ostream& str
 	// nothing
 }
 
+void Doom3MapWriter::beginWriteUnloadedEntity(const std::string& keyValueText, std::ostream& stream)
+{
+	stream << "// entity " << _entityCount++ << std::endl;
+	stream << "{" << std::endl;
+
+	if (!keyValueText.empty())
+	{
+		stream << keyValueText << std::endl;
+	}
+}
+
+void Doom3MapWriter::endWriteUnloadedEntity(std::ostream& stream)
+{
+	stream << "}" << std::endl;
+
+	_primitiveCount = 0;
+}
+
+void Doom3MapWriter::writeUnloadedPrimitive(const std::string& primitiveText, std::ostream& stream)
+{
+	stream << "// primitive " << _primitiveCount++ << std::endl;
+
+	// The text is starting at the primitive keyword and includes the closing brace
+	stream << "{" << std::endl;
+	stream << primitiveText << std::endl;
+}
+
+IMapWriterPtr Doom3MapWriter::createParallelWriter(std::size_t entityNum, std::size_t primitiveNum) const
+{
+	auto writer = createInstance();
+
+	// The counters are the only state, the new writer can pick up at any point
+	writer->_entityCount = entityNum;
+	writer->_primitiveCount = primitiveNum;
+
+	return writer;
+}
+
+std::shared_ptr<Doom3MapWriter> Doom3MapWriter::createInstance() const
+{
+	return std::make_shared<Doom3MapWriter>();
+}
+
 } // namespace
@@ -36,8 +36,18 @@ public:
 	virtual void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 	virtual void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override;
 
+	// Unloaded block export methods, the text is written as it has been read
+	virtual void beginWriteUnloadedEntity(const std::string& keyValueText, std::ostream& stream) override;
+	virtual void endWriteUnloadedEntity(std::ostream& stream) override;
+	virtual void writeUnloadedPrimitive(const std::string& primitiveText, std::ostream& stream) override;
+
+	virtual IMapWriterPtr createParallelWriter(std::size_t entityNum, std::size_t primitiveNum) const override;
+
 protected:
 	void writeEntityKeyValues(const IEntityNodePtr& entity, std::ostream& stream);
+
+	// Creates a new writer of the same type, every subclass needs to override this
+	virtual std::shared_ptr<Doom3MapWriter> createInstance() const;
 };
 
 } // namespace
@@ -5,6 +5,7 @@
 #include "igame.h"
 #include "ientity.h"
 #include "string/string.h"
+#include "map/OperationReport.h"
 
 #include "i18n.h"
 #include <fmt/format.h>
@@ -94,7 +95,12 @@ void Quake3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INo
 	// Try to parse the primitive, throwing exception if failed
 	try
 	{
-		scene::INodePtr primitive = parser->parse(tok);
+		scene::INodePtr primitive;
+
+		{
+			OperationReport::ScopedPhase phase(OperationReport::Phase::PrimitiveParsing);
+			primitive = parser->parse(tok);
+		}
 
 		if (!primitive)
 		{
@@ -115,6 +121,8 @@ void Quake3MapReader::parsePrimitive(parser::DefTokeniser& tok, const scene::INo
 
 scene::INodePtr Quake3MapReader::createEntity(const EntityKeyValues& keyValues)
 {
+    OperationReport::ScopedPhase phase(OperationReport::Phase::EntityCreation);
+
     // Get the classname from the EntityKeyValues
     EntityKeyValues::const_iterator found = keyValues.find("classname");
 
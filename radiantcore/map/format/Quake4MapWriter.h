@@ -28,6 +28,12 @@ public:
 		// Export brushDef3 definition to stream, but without contents flags
 		BrushDef3Exporter::exportBrush(stream, brush, false);
 	}
+
+protected:
+	std::shared_ptr<Doom3MapWriter> createInstance() const override
+	{
+		return std::make_shared<Quake4MapWriter>();
+	}
 };
 
 } // namespace
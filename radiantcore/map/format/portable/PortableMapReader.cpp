@@ -14,7 +14,7 @@
 
 #include "scenelib.h"
 #include "string/convert.h"
-#include "xmlutil/Document.h"
+#include "xmlutil/StreamReader.h"
 
 namespace map
 {
@@ -55,186 +55,205 @@ PortableMapReader::PortableMapReader(IMapImportFilter& importFilter) :
 
 void PortableMapReader::readFromStream(std::istream& stream)
 {
-	xml::Document doc(stream);
-
-	auto mapNode = doc.getTopLevelNode();
-
-	if (string::convert<std::size_t>(mapNode.getAttributeValue(ATTR_VERSION)) != PortableMapFormat::Version)
+	try
 	{
-		throw FailureException("Unsupported format version.");
-	}
+		// Stream the document, only the tags of the map sections and
+		// the ones of a single primitive are in memory at the same time
+		xml::StreamReader reader(stream);
 
-	readLayers(mapNode);
-	readSelectionGroups(mapNode);
-	readSelectionSets(mapNode);
-	readMapProperties(mapNode);
+		if (!reader.readTopLevelElement())
+		{
+			throw FailureException("No map element found.");
+		}
 
-	readEntities(mapNode);
-}
+		if (string::convert<std::size_t>(reader.getAttributeValue(ATTR_VERSION)) != PortableMapFormat::Version)
+		{
+			throw FailureException("Unsupported format version.");
+		}
 
-void PortableMapReader::readLayers(const xml::Node& mapNode)
-{
-	try
-	{
-        auto& layerManager = _importFilter.getRootNode()->getLayerManager();
-        layerManager.reset();
+		auto& root = *_importFilter.getRootNode();
 
-		auto mapLayers = getNamedChild(mapNode, TAG_MAP_LAYERS);
+		root.getLayerManager().reset();
+		root.getSelectionGroupManager().deleteAllSelectionGroups();
+		root.getSelectionSetManager().deleteAllSelectionSets();
+		root.clearProperties();
+		_selectionSets.clear();
 
-		auto layers = mapLayers.getNamedChildren(TAG_MAP_LAYER);
+		std::map<std::string, std::size_t> sectionCounts =
+		{
+			{ TAG_MAP_LAYERS, 0 }, { TAG_SELECTIONGROUPS, 0 }, { TAG_SELECTIONSETS, 0 }, { TAG_MAP_PROPERTIES, 0 }
+		};
 
-		for (const auto& layer : layers)
+		reader.foreachChildElement([&]()
 		{
-			auto id = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_ID));
-			auto name = layer.getAttributeValue(ATTR_MAP_LAYER_NAME);
-
-            layerManager.createLayer(name, id);
-
-            // Check active layer properties
-            if (layer.getAttributeValue(ATTR_MAP_LAYER_ACTIVE) == ATTR_VALUE_TRUE)
-            {
-                layerManager.setActiveLayer(id);
-            }
-
-            // Set visibility (and make sure this happens before the hierarchy is restored)
-            if (layer.getAttributeValue(ATTR_MAP_LAYER_HIDDEN) == ATTR_VALUE_TRUE)
-            {
-                layerManager.setLayerVisibility(id, false);
-            }
-		}
+			auto name = reader.getName();
 
-        // Restore the layer hierarchy after all layers have been created
-        for (const auto& layer : layers)
-        {
-            auto childLayerId = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_ID));
-            // Parent layer ID is optional and defaults to -1
-            auto parentLayerId = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_PARENT_ID), -1);
+			if (name == TAG_ENTITY)
+			{
+				try
+				{
+					readEntity(reader);
+				}
+				catch (const BadDocumentFormatException& ex)
+				{
+					rError() << "PortableMapReader: Failed to parse entity: " << ex.what() << std::endl;
+				}
+				return;
+			}
 
-            layerManager.setParentLayer(childLayerId, parentLayerId);
-        }
-	}
-	catch (const BadDocumentFormatException& ex)
-	{
-		rError() << "PortableMapReader: " << ex.what() << std::endl;
-	}
-}
+			auto section = sectionCounts.find(name);
 
-void PortableMapReader::readSelectionGroups(const xml::Node& mapNode)
-{
-	try
-	{
-		assert(_importFilter.getRootNode());
-		_importFilter.getRootNode()->getSelectionGroupManager().deleteAllSelectionGroups();
+			if (section == sectionCounts.end()) return;
 
-		auto mapSelGroups = getNamedChild(mapNode, TAG_SELECTIONGROUPS);
+			section->second++;
 
-		auto groups = mapSelGroups.getNamedChildren(TAG_SELECTIONGROUP);
+			if (name == TAG_MAP_LAYERS)
+			{
+				readLayers(reader.expand());
+			}
+			else if (name == TAG_SELECTIONGROUPS)
+			{
+				readSelectionGroups(reader.expand());
+			}
+			else if (name == TAG_SELECTIONSETS)
+			{
+				readSelectionSets(reader.expand());
+			}
+			else if (name == TAG_MAP_PROPERTIES)
+			{
+				readMapProperties(reader.expand());
+			}
+		});
 
-		for (const auto& group : groups)
+		for (const auto& pair : sectionCounts)
 		{
-			auto id = string::convert<std::size_t>(group.getAttributeValue(ATTR_SELECTIONGROUP_ID));
-			auto name = group.getAttributeValue(ATTR_SELECTIONGROUP_NAME);
-
-			auto newGroup = _importFilter.getRootNode()->getSelectionGroupManager().createSelectionGroup(id);
-			newGroup->setName(name);
+			if (pair.second != 1)
+			{
+				rError() << "PortableMapReader: Odd number of " << pair.first << " nodes encountered." << std::endl;
+			}
 		}
 	}
-	catch (const BadDocumentFormatException & ex)
+	catch (const xml::ParseException& ex)
 	{
-		rError() << "PortableMapReader: " << ex.what() << std::endl;
+		throw FailureException(ex.what());
 	}
 }
 
-void PortableMapReader::readSelectionSets(const xml::Node& mapNode)
+void PortableMapReader::readLayers(const xml::Node& mapLayers)
 {
-	try
-	{
-		_selectionSets.clear();
+	auto& layerManager = _importFilter.getRootNode()->getLayerManager();
 
-		assert(_importFilter.getRootNode());
-		_importFilter.getRootNode()->getSelectionSetManager().deleteAllSelectionSets();
+	auto layers = mapLayers.getNamedChildren(TAG_MAP_LAYER);
 
-		auto mapSelSets = getNamedChild(mapNode, TAG_SELECTIONSETS);
+	for (const auto& layer : layers)
+	{
+		auto id = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_ID));
+		auto name = layer.getAttributeValue(ATTR_MAP_LAYER_NAME);
 
-		auto setNodes = mapSelSets.getNamedChildren(TAG_SELECTIONSET);
+		layerManager.createLayer(name, id);
 
-		for (const auto& setNode : setNodes)
+		// Check active layer properties
+		if (layer.getAttributeValue(ATTR_MAP_LAYER_ACTIVE) == ATTR_VALUE_TRUE)
 		{
-			auto id = string::convert<std::size_t>(setNode.getAttributeValue(ATTR_SELECTIONSET_ID));
-			auto name = setNode.getAttributeValue(ATTR_SELECTIONSET_NAME);
+			layerManager.setActiveLayer(id);
+		}
 
-			auto set = _importFilter.getRootNode()->getSelectionSetManager().createSelectionSet(name);
-			_selectionSets[id] = set;
+		// Set visibility (and make sure this happens before the hierarchy is restored)
+		if (layer.getAttributeValue(ATTR_MAP_LAYER_HIDDEN) == ATTR_VALUE_TRUE)
+		{
+			layerManager.setLayerVisibility(id, false);
 		}
 	}
-	catch (const BadDocumentFormatException & ex)
+
+	// Restore the layer hierarchy after all layers have been created
+	for (const auto& layer : layers)
 	{
-		rError() << "PortableMapReader: " << ex.what() << std::endl;
+		auto childLayerId = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_ID));
+		// Parent layer ID is optional and defaults to -1
+		auto parentLayerId = string::convert<int>(layer.getAttributeValue(ATTR_MAP_LAYER_PARENT_ID), -1);
+
+		layerManager.setParentLayer(childLayerId, parentLayerId);
 	}
 }
 
-void PortableMapReader::readMapProperties(const xml::Node& mapNode)
+void PortableMapReader::readSelectionGroups(const xml::Node& mapSelGroups)
 {
-	try
+	assert(_importFilter.getRootNode());
+
+	auto groups = mapSelGroups.getNamedChildren(TAG_SELECTIONGROUP);
+
+	for (const auto& group : groups)
 	{
-		_importFilter.getRootNode()->clearProperties();
+		auto id = string::convert<std::size_t>(group.getAttributeValue(ATTR_SELECTIONGROUP_ID));
+		auto name = group.getAttributeValue(ATTR_SELECTIONGROUP_NAME);
 
-		auto mapProperties = getNamedChild(mapNode, TAG_MAP_PROPERTIES);
+		auto newGroup = _importFilter.getRootNode()->getSelectionGroupManager().createSelectionGroup(id);
+		newGroup->setName(name);
+	}
+}
 
-		auto propertyNodes = mapProperties.getNamedChildren(TAG_MAP_PROPERTY);
+void PortableMapReader::readSelectionSets(const xml::Node& mapSelSets)
+{
+	assert(_importFilter.getRootNode());
 
-		for (const auto& propertyNode : propertyNodes)
-		{
-			auto key = propertyNode.getAttributeValue(ATTR_MAP_PROPERTY_KEY);
-			auto value = propertyNode.getAttributeValue(ATTR_MAP_PROPERTY_VALUE);
+	auto setNodes = mapSelSets.getNamedChildren(TAG_SELECTIONSET);
 
-			_importFilter.getRootNode()->setProperty(key, value);
-		}
-	}
-	catch (const BadDocumentFormatException & ex)
+	for (const auto& setNode : setNodes)
 	{
-		rError() << "PortableMapReader: " << ex.what() << std::endl;
+		auto id = string::convert<std::size_t>(setNode.getAttributeValue(ATTR_SELECTIONSET_ID));
+		auto name = setNode.getAttributeValue(ATTR_SELECTIONSET_NAME);
+
+		auto set = _importFilter.getRootNode()->getSelectionSetManager().createSelectionSet(name);
+		_selectionSets[id] = set;
 	}
 }
 
-void PortableMapReader::readEntities(const xml::Node& mapNode)
+void PortableMapReader::readMapProperties(const xml::Node& mapProperties)
 {
-	auto entityNodes = mapNode.getNamedChildren(TAG_ENTITY);
+	auto propertyNodes = mapProperties.getNamedChildren(TAG_MAP_PROPERTY);
 
-	for (const auto& entityNode : entityNodes)
+	for (const auto& propertyNode : propertyNodes)
 	{
-		try
-		{
-			readEntity(entityNode);
-		}
-		catch (const BadDocumentFormatException & ex)
-		{
-			rError() << "PortableMapReader: Failed to parse entity: " << ex.what() << std::endl;
-			continue;
-		}
+		auto key = propertyNode.getAttributeValue(ATTR_MAP_PROPERTY_KEY);
+		auto value = propertyNode.getAttributeValue(ATTR_MAP_PROPERTY_VALUE);
+
+		_importFilter.getRootNode()->setProperty(key, value);
 	}
 }
 
-void PortableMapReader::readPrimitives(const xml::Node& primitivesNode, const scene::INodePtr& entity)
+void PortableMapReader::readPrimitives(xml::StreamReader& reader, const std::string& entityNumber,
+	std::vector<PendingPrimitive>& primitives)
 {
-	auto childNodes = primitivesNode.getChildren();
-	
-	for (const auto childNode : childNodes)
+	reader.foreachChildElement([&]()
 	{
-		const std::string name = childNode.getName();
+		const std::string name = reader.getName();
+
+		if (name != TAG_BRUSH && name != TAG_PATCH) return;
 
-		if (name == TAG_BRUSH)
+		// Only the tag of this primitive is held in memory
+		auto primitiveTag = reader.expand();
+
+		try
 		{
-			readBrush(childNode, entity);
+			PendingPrimitive primitive;
+
+			primitive.node = name == TAG_BRUSH ? readBrush(primitiveTag, entityNumber) : readPatch(primitiveTag);
+
+			readObjectInformation(primitiveTag, TAG_OBJECT_LAYERS, primitive.info);
+			readObjectInformation(primitiveTag, TAG_OBJECT_SELECTIONGROUPS, primitive.info);
+			readObjectInformation(primitiveTag, TAG_OBJECT_SELECTIONSETS, primitive.info);
+
+			primitives.emplace_back(std::move(primitive));
 		}
-		else if (name == TAG_PATCH)
+		catch (const BadDocumentFormatException& ex)
 		{
-			readPatch(childNode, entity);
+			rError() << "PortableMapReader: Entity " << entityNumber << ", Primitive " <<
+				primitiveTag.getAttributeValue(ATTR_BRUSH_NUMBER) << ": " << ex.what() << std::endl;
 		}
-	}
+	});
 }
 
-void PortableMapReader::readBrush(const xml::Node& brushTag, const scene::INodePtr& entity)
+scene::INodePtr PortableMapReader::readBrush(const xml::Node& brushTag, const std::string& entityNumber)
 {
 	// Create a new brush
 	auto node = GlobalBrushCreator().createBrush();
@@ -290,7 +309,7 @@ void PortableMapReader::readBrush(const xml::Node& brushTag, const scene::INodeP
 		}
 		catch (const BadDocumentFormatException& ex)
 		{
-			rError() << "PortableMapReader: Entity " << entity->name() << ", Brush " << 
+			rError() << "PortableMapReader: Entity " << entityNumber << ", Brush " <<
 				brushTag.getAttributeValue(ATTR_BRUSH_NUMBER) << ": " << ex.what() << std::endl;
 		}
 	}
@@ -298,14 +317,10 @@ void PortableMapReader::readBrush(const xml::Node& brushTag, const scene::INodeP
     // Cleanup redundant face planes
     brush.removeRedundantFaces();
 
-	_importFilter.addPrimitiveToEntity(node, entity);
-
-	readLayerInformation(brushTag, node);
-	readSelectionGroupInformation(brushTag, node);
-	readSelectionSetInformation(brushTag, node);
+	return node;
 }
 
-void PortableMapReader::readPatch(const xml::Node& patchTag, const scene::INodePtr& entity)
+scene::INodePtr PortableMapReader::readPatch(const xml::Node& patchTag)
 {
 	bool isFixedSubdiv = patchTag.getAttributeValue(ATTR_PATCH_FIXED_SUBDIV) == ATTR_VALUE_TRUE;
 
@@ -356,26 +371,61 @@ void PortableMapReader::readPatch(const xml::Node& patchTag, const scene::INodeP
 
 	patch.controlPointsChanged();
 
-	_importFilter.addPrimitiveToEntity(node, entity);
-
-	readLayerInformation(patchTag, node);
-	readSelectionGroupInformation(patchTag, node);
-	readSelectionSetInformation(patchTag, node);
+	return node;
 }
 
-void PortableMapReader::readEntity(const xml::Node& entityTag)
+void PortableMapReader::readEntity(xml::StreamReader& reader)
 {
+	auto entityNumber = reader.getAttributeValue(ATTR_ENTITY_NUMBER);
+
 	std::map<std::string, std::string> entityKeyValues{};
+	ObjectInfo entityInfo;
 
-	auto keyValuesTag = getNamedChild(entityTag, TAG_ENTITY_KEYVALUES);
-	auto keyValueTags = keyValuesTag.getNamedChildren(TAG_ENTITY_KEYVALUE);
+	// The primitives are written in front of the keyValues, they are
+	// put on hold until the entity can be created
+	std::vector<PendingPrimitive> primitives;
 
-	for (const auto& keyValue : keyValueTags)
+	std::map<std::string, std::size_t> tagCounts =
 	{
-		auto key = keyValue.getAttributeValue(ATTR_ENTITY_PROPERTY_KEY);
-		auto value = keyValue.getAttributeValue(ATTR_ENTITY_PROPERTY_VALUE);
+		{ TAG_ENTITY_PRIMITIVES, 0 }, { TAG_ENTITY_KEYVALUES, 0 },
+		{ TAG_OBJECT_LAYERS, 0 }, { TAG_OBJECT_SELECTIONGROUPS, 0 }, { TAG_OBJECT_SELECTIONSETS, 0 }
+	};
+
+	reader.foreachChildElement([&]()
+	{
+		auto name = reader.getName();
+		auto tagCount = tagCounts.find(name);
+
+		if (tagCount == tagCounts.end()) return;
 
-		entityKeyValues[key] = value;
+		tagCount->second++;
+
+		if (name == TAG_ENTITY_PRIMITIVES)
+		{
+			readPrimitives(reader, entityNumber, primitives);
+		}
+		else if (name == TAG_ENTITY_KEYVALUES)
+		{
+			for (const auto& keyValue : reader.expand().getNamedChildren(TAG_ENTITY_KEYVALUE))
+			{
+				auto key = keyValue.getAttributeValue(ATTR_ENTITY_PROPERTY_KEY);
+				auto value = keyValue.getAttributeValue(ATTR_ENTITY_PROPERTY_VALUE);
+
+				entityKeyValues[key] = value;
+			}
+		}
+		else
+		{
+			readObjectInformation(reader.expand(), entityInfo);
+		}
+	});
+
+	for (const auto& pair : tagCounts)
+	{
+		if (pair.second != 1 && pair.first != TAG_ENTITY_PRIMITIVES)
+		{
+			throw BadDocumentFormatException("Odd number of " + pair.first + " nodes encountered.");
+		}
 	}
 
 	// Get the classname from the EntityKeyValues
@@ -406,85 +456,94 @@ void PortableMapReader::readEntity(const xml::Node& entityTag)
 		entityNode->getEntity().setKeyValue(pair.first, pair.second);
 	}
 
-	readLayerInformation(entityTag, entityNode);
-	readSelectionGroupInformation(entityTag, entityNode);
-	readSelectionSetInformation(entityTag, entityNode);
+	applyObjectInformation(entityInfo, entityNode);
 
 	_importFilter.addEntity(entityNode);
 
-	try
+	if (tagCounts[TAG_ENTITY_PRIMITIVES] != 1)
 	{
-		readPrimitives(getNamedChild(entityTag, TAG_ENTITY_PRIMITIVES), entityNode);
+		rError() << "PortableMapReader: Entity " << entityNode->name() << ": Odd number of " <<
+			TAG_ENTITY_PRIMITIVES << " nodes encountered." << std::endl;
+		return;
 	}
-	catch (const BadDocumentFormatException & ex)
+
+	for (const auto& primitive : primitives)
 	{
-		rError() << "PortableMapReader: Entity " << entityNode->name() << ": " << ex.what() << std::endl;
+		_importFilter.addPrimitiveToEntity(primitive.node, entityNode);
+
+		applyObjectInformation(primitive.info, primitive.node);
 	}
 }
 
-void PortableMapReader::readLayerInformation(const xml::Node& tag, const scene::INodePtr& sceneNode)
+void PortableMapReader::readObjectInformation(const xml::Node& parentTag, const std::string& tagName, ObjectInfo& info)
 {
-	auto layersTag = getNamedChild(tag, TAG_OBJECT_LAYERS);
+	readObjectInformation(getNamedChild(parentTag, tagName), info);
+}
 
-	auto layerTags = layersTag.getNamedChildren(TAG_OBJECT_LAYER);
-	auto layers = scene::LayerList{};
+void PortableMapReader::readObjectInformation(const xml::Node& tag, ObjectInfo& info)
+{
+	const std::string name = tag.getName();
 
-	// Read the list of node IDs
-	for (const auto& layerTag : layerTags)
+	if (name == TAG_OBJECT_LAYERS)
 	{
-		layers.insert(string::convert<int>(layerTag.getAttributeValue(ATTR_OBJECT_LAYER_ID)));
+		// Read the list of node IDs
+		for (const auto& layerTag : tag.getNamedChildren(TAG_OBJECT_LAYER))
+		{
+			info.layers.insert(string::convert<int>(layerTag.getAttributeValue(ATTR_OBJECT_LAYER_ID)));
+		}
+	}
+	else if (name == TAG_OBJECT_SELECTIONGROUPS)
+	{
+		// Read the list of group IDs
+		for (const auto& groupTag : tag.getNamedChildren(TAG_OBJECT_SELECTIONGROUP))
+		{
+			info.selectionGroups.push_back(string::convert<IGroupSelectable::GroupIds::value_type>(
+				groupTag.getAttributeValue(ATTR_OBJECT_SELECTIONGROUP_ID)
+			));
+		}
+	}
+	else if (name == TAG_OBJECT_SELECTIONSETS)
+	{
+		// Read the list of set indices
+		for (const auto& setTag : tag.getNamedChildren(TAG_OBJECT_SELECTIONSET))
+		{
+			info.selectionSets.push_back(string::convert<std::size_t>(
+				setTag.getAttributeValue(ATTR_OBJECT_SELECTIONSET_ID)
+			));
+		}
 	}
+}
 
-	sceneNode->assignToLayers(layers);
+void PortableMapReader::applyObjectInformation(const ObjectInfo& info, const scene::INodePtr& sceneNode)
+{
+	sceneNode->assignToLayers(info.layers);
 
 	sceneNode->foreachNode([&](const scene::INodePtr& child)
 	{
 		if (!Node_isEntity(child) && !Node_isPrimitive(child))
 		{
-			child->assignToLayers(layers);
+			child->assignToLayers(info.layers);
 		}
 
 		return true;
 	});
-}
-
-void PortableMapReader::readSelectionGroupInformation(const xml::Node& tag, const scene::INodePtr& sceneNode)
-{
-    auto groupsTag = getNamedChild(tag, TAG_OBJECT_SELECTIONGROUPS);
-    auto groupTags = groupsTag.getNamedChildren(TAG_OBJECT_SELECTIONGROUP);
-
-    auto& groupManager = _importFilter.getRootNode()->getSelectionGroupManager();
 
-    // Read the list of group IDs
-    for (const auto& groupTag : groupTags)
-    {
-        auto groupId = string::convert<IGroupSelectable::GroupIds::value_type>(
-            groupTag.getAttributeValue(ATTR_OBJECT_SELECTIONGROUP_ID)
-        );
+	auto& groupManager = _importFilter.getRootNode()->getSelectionGroupManager();
 
-        auto group = groupManager.getSelectionGroup(groupId);
-
-        if (group)
-        {
-            group->addNode(sceneNode);
-        }
-    }
-}
+	for (auto groupId : info.selectionGroups)
+	{
+		auto group = groupManager.getSelectionGroup(groupId);
 
-void PortableMapReader::readSelectionSetInformation(const xml::Node& tag, const scene::INodePtr& sceneNode)
-{
-	auto setsTag = getNamedChild(tag, TAG_OBJECT_SELECTIONSETS);
-	auto setTags = setsTag.getNamedChildren(TAG_OBJECT_SELECTIONSET);
+		if (group)
+		{
+			group->addNode(sceneNode);
+		}
+	}
 
-	// Read the list of set indices
-	for (const auto& setTag : setTags)
+	for (auto id : info.selectionSets)
 	{
-		auto id = string::convert<std::size_t>(
-			setTag.getAttributeValue(ATTR_OBJECT_SELECTIONSET_ID)
-		);
-
 		auto setIter = _selectionSets.find(id);
-		
+
 		if (setIter != _selectionSets.end())
 		{
 			setIter->second->addNode(sceneNode);
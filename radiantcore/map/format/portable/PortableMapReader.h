@@ -1,12 +1,17 @@
 #pragma once
 
 #include <map>
+#include <vector>
 #include "inode.h"
 #include "imapformat.h"
 #include "iselectionset.h"
 #include "parser/DefTokeniser.h"
 
-namespace xml { class Node; }
+namespace xml
+{
+	class Node;
+	class StreamReader;
+}
 
 namespace map 
 {
@@ -41,18 +46,35 @@ public:
 	static bool CanLoad(std::istream& stream);
 
 private:
-	void readLayers(const xml::Node& mapNode);
-	void readSelectionGroups(const xml::Node& mapNode);
-	void readSelectionSets(const xml::Node& mapNode);
-	void readMapProperties(const xml::Node& mapNode);
-	void readEntities(const xml::Node& mapNode);
-	void readEntity(const xml::Node& entityNode);
-	void readPrimitives(const xml::Node& primitivesNode, const scene::INodePtr& entity);
-	void readBrush(const xml::Node& brushNode, const scene::INodePtr& entity);
-	void readPatch(const xml::Node& patchNode, const scene::INodePtr& entity);
-	void readLayerInformation(const xml::Node& parentTag, const scene::INodePtr& sceneNode);
-	void readSelectionGroupInformation(const xml::Node& parentTag, const scene::INodePtr& sceneNode);
-	void readSelectionSetInformation(const xml::Node& parentTag, const scene::INodePtr& sceneNode);
+	// Layer, selection group and selection set membership of an entity or primitive
+	struct ObjectInfo
+	{
+		scene::LayerList layers;
+		std::vector<std::size_t> selectionGroups;
+		std::vector<std::size_t> selectionSets;
+	};
+
+	// A primitive waiting for its entity, which is created after its keyValues have been read
+	struct PendingPrimitive
+	{
+		scene::INodePtr node;
+		ObjectInfo info;
+	};
+
+	void readLayers(const xml::Node& layersTag);
+	void readSelectionGroups(const xml::Node& selectionGroupsTag);
+	void readSelectionSets(const xml::Node& selectionSetsTag);
+	void readMapProperties(const xml::Node& propertiesTag);
+	void readEntity(xml::StreamReader& reader);
+	void readPrimitives(xml::StreamReader& reader, const std::string& entityNumber,
+		std::vector<PendingPrimitive>& primitives);
+	scene::INodePtr readBrush(const xml::Node& brushNode, const std::string& entityNumber);
+	scene::INodePtr readPatch(const xml::Node& patchNode);
+
+	// Reads the layers, selectionGroups or selectionSets tag of an entity or primitive
+	void readObjectInformation(const xml::Node& tag, ObjectInfo& info);
+	void readObjectInformation(const xml::Node& parentTag, const std::string& tagName, ObjectInfo& info);
+	void applyObjectInformation(const ObjectInfo& info, const scene::INodePtr& sceneNode);
 };
 
 }
@@ -1,8 +1,5 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "BrushDef3.h"
-#include "string/convert.h"
+#include <vector>
 #include "imap.h"
 #include "ibrush.h"
 #include "parser/DefTokeniser.h"
@@ -44,105 +41,71 @@ brushDef3
 #pragma optimize( "", off )
 #endif
 
-scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
+namespace
 {
-	// Create a new brush
-	scene::INodePtr node = GlobalBrushCreator().createBrush();
-
-	// Cast the node, this must succeed
-	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
-	assert(brushNode != NULL);
-
-	IBrush& brush = brushNode->getIBrush();
 
-	tok.assertNextToken("{");
-
-	// Parse face tokens until a closing brace is encountered
-	while (1)
+// The values of a brushDef3 primitive, the faces are added to a new brush in createNode()
+class ParsedBrushDef3 :
+	public ParsedPrimitive
+{
+public:
+	struct Face
 	{
-		std::string token = tok.nextToken();
-
-		// Token should be either a "(" (start of face) or "}" (end of brush)
-		if (token == "}")
-		{
-			break; // end of brush
-		}
-		else if (token == "(") // FACE
-		{
-			// Construct a plane and parse its values
-			Plane3 plane;
+		Plane3 plane;
+		Matrix3 texdef;
+		std::string shader;
+		IBrush::DetailFlag detailFlag;
+	};
 
-			plane.normal().x() = string::to_float(tok.nextToken());
-			plane.normal().y() = string::to_float(tok.nextToken());
-			plane.normal().z() = string::to_float(tok.nextToken());
-			plane.dist() = -string::to_float(tok.nextToken()); // negate d
+	std::vector<Face> faces;
 
-			tok.assertNextToken(")");
+	// Quake 4 brushes don't carry the detail flag
+	bool hasDetailFlags;
 
-			// Parse TexDef
-			Matrix3 texdef;
-			tok.assertNextToken("(");
+	ParsedBrushDef3(bool hasDetailFlags_) :
+		hasDetailFlags(hasDetailFlags_)
+	{}
 
-			tok.assertNextToken("(");
-			texdef.xx() = string::to_float(tok.nextToken());
-			texdef.yx() = string::to_float(tok.nextToken());
-			texdef.zx() = string::to_float(tok.nextToken());
-			tok.assertNextToken(")");
-
-			tok.assertNextToken("(");
-			texdef.xy() = string::to_float(tok.nextToken());
-			texdef.yy() = string::to_float(tok.nextToken());
-			texdef.zy() = string::to_float(tok.nextToken());
-			tok.assertNextToken(")");
-
-			tok.assertNextToken(")");
+	scene::INodePtr createNode() const override
+	{
+		// Create a new brush
+		scene::INodePtr node = GlobalBrushCreator().createBrush();
 
-			// Parse Shader
-			std::string shader = tok.nextToken();
+		// Cast the node, this must succeed
+		IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
+		assert(brushNode != NULL);
 
-			// Parse Flags (usually each brush has all faces detail or all faces structural)
-			IBrush::DetailFlag flag = static_cast<IBrush::DetailFlag>(
-				string::convert<std::size_t>(tok.nextToken(), IBrush::Structural));
-			brush.setDetailFlag(flag);
+		IBrush& brush = brushNode->getIBrush();
 
-			// Ignore the other two flags
-			tok.skipTokens(2);
+		for (const auto& face : faces)
+		{
+			// Usually each brush has all faces detail or all faces structural
+			if (hasDetailFlags)
+			{
+				brush.setDetailFlag(face.detailFlag);
+			}
 
-			// Finally, add the new face to the brush
-			brush.addFace(plane, texdef, shader);
-		}
-		else {
-			std::string text = fmt::format(_("BrushDef3Parser: invalid token '{0}'"), token);
-			throw parser::ParseException(text);
+			brush.addFace(face.plane, face.texdef, face.shader);
 		}
-	}
 
-	// Final outer "}"
-	tok.assertNextToken("}");
-
-    // Cleanup redundant face planes
-    brush.removeRedundantFaces();
+		// Cleanup redundant face planes
+		brush.removeRedundantFaces();
 
-	return node;
-}
+		return node;
+	}
+};
 
-scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
+// Parses the face tokens of both the Doom 3 and the Quake 4 flavour of the brushDef3 primitive
+std::unique_ptr<ParsedBrushDef3> parseBrushDef3(parser::DefTokeniser& tok, bool quake4Format)
 {
-	// Create a new brush
-	scene::INodePtr node = GlobalBrushCreator().createBrush();
-
-	// Cast the node, this must succeed
-	IBrushNodePtr brushNode = std::dynamic_pointer_cast<IBrushNode>(node);
-	assert(brushNode != NULL);
-
-	IBrush& brush = brushNode->getIBrush();
+	auto brush = std::make_unique<ParsedBrushDef3>(!quake4Format);
 
 	tok.assertNextToken("{");
 
 	// Parse face tokens until a closing brace is encountered
 	while (1)
 	{
-		std::string token = tok.nextToken();
+		auto token = tok.nextTokenView();
 
 		// Token should be either a "(" (start of face) or "}" (end of brush)
 		if (token == "}")
@@ -151,42 +114,52 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 		}
 		else if (token == "(") // FACE
 		{
+			auto& face = brush->faces.emplace_back();
+
 			// Construct a plane and parse its values
-			Plane3 plane;
+			Plane3& plane = face.plane;
 
-			plane.normal().x() = string::to_float(tok.nextToken());
-			plane.normal().y() = string::to_float(tok.nextToken());
-			plane.normal().z() = string::to_float(tok.nextToken());
-			plane.dist() = -string::to_float(tok.nextToken()); // negate d
+			plane.normal().x() = tok.nextDouble();
+			plane.normal().y() = tok.nextDouble();
+			plane.normal().z() = tok.nextDouble();
+			plane.dist() = -tok.nextDouble(); // negate d
 
 			tok.assertNextToken(")");
 
 			// Parse TexDef
-			Matrix3 texdef;
+			Matrix3& texdef = face.texdef;
 			tok.assertNextToken("(");
 
 			tok.assertNextToken("(");
-			texdef.xx() = string::to_float(tok.nextToken());
-			texdef.yx() = string::to_float(tok.nextToken());
-			texdef.zx() = string::to_float(tok.nextToken());
+			texdef.xx() = tok.nextDouble();
+			texdef.yx() = tok.nextDouble();
+			texdef.zx() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken("(");
-			texdef.xy() = string::to_float(tok.nextToken());
-			texdef.yy() = string::to_float(tok.nextToken());
-			texdef.zy() = string::to_float(tok.nextToken());
+			texdef.xy() = tok.nextDouble();
+			texdef.yy() = tok.nextDouble();
+			texdef.zy() = tok.nextDouble();
 			tok.assertNextToken(")");
 
 			tok.assertNextToken(")");
 
 			// Parse Shader
-			std::string shader = tok.nextToken();
+			face.shader = tok.nextToken();
 
-			// Finally, add the new face to the brush
-			brush.addFace(plane, texdef, shader);
+			if (quake4Format) continue;
+
+			// Parse Flags
+			face.detailFlag = static_cast<IBrush::DetailFlag>(
+				tok.nextInteger<std::size_t>(IBrush::Structural));
+
+			// Ignore the other two flags
+			tok.skipTokens(2);
 		}
 		else {
-			std::string text = fmt::format(_("BrushDef3ParserQuake4: invalid token '{0}'"), token);
+			std::string text = quake4Format ?
+				fmt::format(_("BrushDef3ParserQuake4: invalid token '{0}'"), token) :
+				fmt::format(_("BrushDef3Parser: invalid token '{0}'"), token);
 			throw parser::ParseException(text);
 		}
 	}
@@ -194,10 +167,25 @@ scene::INodePtr BrushDef3ParserQuake4::parse(parser::DefTokeniser& tok) const
 	// Final outer "}"
 	tok.assertNextToken("}");
 
-    // Cleanup redundant face planes
-    brush.removeRedundantFaces();
+	return brush;
+}
+
+}
 
-	return node;
+scene::INodePtr BrushDef3Parser::parse(parser::DefTokeniser& tok) const
+{
+	// Detached parsing is always succeeding (or throwing), create the node right away
+	return parseDetached(tok)->createNode();
+}
+
+ParsedPrimitivePtr BrushDef3Parser::parseDetached(parser::DefTokeniser& tok) const
+{
+	return parseBrushDef3(tok, false);
+}
+
+ParsedPrimitivePtr BrushDef3ParserQuake4::parseDetached(parser::DefTokeniser& tok) const
+{
+	return parseBrushDef3(tok, true);
 }
 
 #if _MSC_VER >= 1600
@@ -1,36 +1,125 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "Patch.h"
 
-#include "string/convert.h"
 #include "parser/DefTokeniser.h"
+#include "patch/PatchConstants.h"
 
 namespace map
 {
 
+namespace
+{
+
+// The values of a patchDef2/3 primitive, which are assigned to a new patch in createNode()
+class ParsedPatch :
+	public ParsedPrimitive
+{
+public:
+	const PatchParser& parser;
+	patch::PatchDefType type;
+
+	std::string shader;
+	std::size_t width;
+	std::size_t height;
+
+	// Only patchDef3 is using fixed subdivisions
+	Subdivisions subdivisions;
+
+	// The control points, row by row
+	std::vector<PatchControl> controls;
+
+	ParsedPatch(const PatchParser& parser_, patch::PatchDefType type_) :
+		parser(parser_),
+		type(type_),
+		width(0),
+		height(0)
+	{}
+
+	scene::INodePtr createNode() const override
+	{
+		scene::INodePtr node = GlobalPatchModule().createPatch(type);
+
+		IPatchNodePtr patchNode = std::dynamic_pointer_cast<IPatchNode>(node);
+		assert(patchNode != NULL);
+
+		IPatch& patch = patchNode->getPatch();
+
+		parser.setShader(patch, shader);
+		patch.setDims(width, height);
+
+		if (type == patch::PatchDefType::Def3)
+		{
+			patch.setFixedSubdivisions(true, subdivisions);
+		}
+
+		for (std::size_t r = 0; r < height; r++)
+		{
+			for (std::size_t c = 0; c < width; c++)
+			{
+				patch.ctrlAt(r, c) = controls[r * width + c];
+			}
+		}
+
+		patch.controlPointsChanged();
+
+		return node;
+	}
+};
+
+// True if Patch::setDims() is taking the given dimension as it is
+inline bool isUnadjustedDimension(std::size_t value)
+{
+	return value % 2 == 1 && value >= MIN_PATCH_WIDTH && value <= MAX_PATCH_WIDTH;
+}
+
+}
+
+void PatchParser::setShader(IPatch& patch, const std::string& shader) const
+{
+	// Regular behaviour: just set the incoming shader name
+	patch.setShader(shader);
+}
+
 void PatchParser::parseMatrix(parser::DefTokeniser& tok, IPatch& patch) const
 {
+	std::vector<PatchControl> controls;
+	parseMatrix(tok, patch.getWidth(), patch.getHeight(), controls);
+
+	for (std::size_t r = 0; r < patch.getHeight(); r++)
+	{
+		for (std::size_t c = 0; c < patch.getWidth(); c++)
+		{
+			patch.ctrlAt(r, c) = controls[r * patch.getWidth() + c];
+		}
+	}
+}
+
+void PatchParser::parseMatrix(parser::DefTokeniser& tok, std::size_t width, std::size_t height,
+	std::vector<PatchControl>& controls) const
+{
+	controls.resize(width * height);
+
 	tok.assertNextToken("(");
 
 	// For each row
-	for (std::size_t c = 0; c < patch.getWidth(); c++)
+	for (std::size_t c = 0; c < width; c++)
 	{
 		tok.assertNextToken("(");
 
 		// For each column
-		for (std::size_t r=0; r < patch.getHeight(); r++)
+		for (std::size_t r=0; r < height; r++)
 		{
 			tok.assertNextToken("(");
 
+			auto& control = controls[r * width + c];
+
 			// Parse vertex coordinates
-			patch.ctrlAt(r, c).vertex[0] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).vertex[1] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).vertex[2] = string::to_float(tok.nextToken());
+			control.vertex[0] = tok.nextDouble();
+			control.vertex[1] = tok.nextDouble();
+			control.vertex[2] = tok.nextDouble();
 
 			// Parse texture coordinates
-			patch.ctrlAt(r, c).texcoord[0] = string::to_float(tok.nextToken());
-			patch.ctrlAt(r, c).texcoord[1] = string::to_float(tok.nextToken());
+			control.texcoord[0] = tok.nextDouble();
+			control.texcoord[1] = tok.nextDouble();
 
 			tok.assertNextToken(")");
 		}
@@ -41,4 +130,49 @@ void PatchParser::parseMatrix(parser::DefTokeniser& tok, IPatch& patch) const
 	tok.assertNextToken(")");
 }
 
+ParsedPrimitivePtr PatchParser::parsePatchDetached(parser::DefTokeniser& tok, patch::PatchDefType type) const
+{
+	auto patch = std::make_unique<ParsedPatch>(*this, type);
+
+	tok.assertNextToken("{");
+
+	// Parse shader
+	patch->shader = tok.nextToken();
+
+	// Parse parameters
+	tok.assertNextToken("(");
+
+	// parse matrix dimensions
+	patch->width = tok.nextInteger<std::size_t>();
+	patch->height = tok.nextInteger<std::size_t>();
+
+	if (!isUnadjustedDimension(patch->width) || !isUnadjustedDimension(patch->height))
+	{
+		return ParsedPrimitivePtr();
+	}
+
+	if (type == patch::PatchDefType::Def3)
+	{
+		// Parse fixed tesselation
+		std::size_t subdivX = tok.nextInteger<std::size_t>();
+		std::size_t subdivY = tok.nextInteger<std::size_t>();
+
+		patch->subdivisions = Subdivisions(subdivX, subdivY);
+	}
+
+	// ignore contents/flags values
+	tok.skipTokens(3);
+
+	tok.assertNextToken(")");
+
+	// Parse Patch Matrix
+	parseMatrix(tok, patch->width, patch->height, patch->controls);
+
+	// Parse Footer
+	tok.assertNextToken("}");
+	tok.assertNextToken("}");
+
+	return patch;
+}
+
 }
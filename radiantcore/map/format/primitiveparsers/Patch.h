@@ -1,6 +1,7 @@
 #ifndef Patch_h__
 #define Patch_h__
 
+#include <vector>
 #include "imapformat.h"
 #include "ipatch.h"
 
@@ -11,9 +12,22 @@ namespace map
 class PatchParser :
 	public PrimitiveParser
 {
+public:
+	// Assigns the parsed shader name to the patch
+	virtual void setShader(IPatch& patch, const std::string& shader) const;
+
 protected:
 	// Parses the control point matrix. The given patch must have its dimensions set before this call.
 	void parseMatrix(parser::DefTokeniser& tok, IPatch& patch) const;
+
+	// Parses the control point matrix of the given dimensions, the controls are stored row by row
+	void parseMatrix(parser::DefTokeniser& tok, std::size_t width, std::size_t height,
+		std::vector<PatchControl>& controls) const;
+
+	// Parses a patchDef2 or patchDef3 block without creating the patch. Returns an empty
+	// pointer if the patch would adjust the parsed dimensions, since the adjusted
+	// dimensions determine the number of control points to parse.
+	ParsedPrimitivePtr parsePatchDetached(parser::DefTokeniser& tok, patch::PatchDefType type) const;
 };
 
 } // namespace map
@@ -1,12 +1,8 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "PatchDef2.h"
 
 #include "imap.h"
 #include "ipatch.h"
 #include "parser/DefTokeniser.h"
-#include "string/convert.h"
 #include "shaderlib.h"
 
 namespace map
@@ -53,8 +49,8 @@ scene::INodePtr PatchDef2Parser::parse(parser::DefTokeniser& tok) const
 	tok.assertNextToken("(");
 
 	// parse matrix dimensions
-	std::size_t cols = string::convert<std::size_t>(tok.nextToken());
-	std::size_t rows = string::convert<std::size_t>(tok.nextToken());
+	std::size_t cols = tok.nextInteger<std::size_t>();
+	std::size_t rows = tok.nextInteger<std::size_t>();
 
 	patch.setDims(cols, rows);
 
@@ -75,10 +71,9 @@ scene::INodePtr PatchDef2Parser::parse(parser::DefTokeniser& tok) const
 	return node;
 }
 
-void PatchDef2Parser::setShader(IPatch& patch, const std::string& shader) const
+ParsedPrimitivePtr PatchDef2Parser::parseDetached(parser::DefTokeniser& tok) const
 {
-	// Regular behaviour: just set the incoming shader name
-	patch.setShader(shader);
+	return parsePatchDetached(tok, patch::PatchDefType::Def2);
 }
 
 // Quake3-parser
@@ -13,8 +13,7 @@ public:
 
     scene::INodePtr parse(parser::DefTokeniser& tok) const;
 
-protected:
-	virtual void setShader(IPatch& patch, const std::string& shader) const;
+    ParsedPrimitivePtr parseDetached(parser::DefTokeniser& tok) const;
 };
 typedef std::shared_ptr<PatchDef2Parser> PatchDef2ParserPtr;
 
@@ -22,7 +21,7 @@ typedef std::shared_ptr<PatchDef2Parser> PatchDef2ParserPtr;
 class PatchDef2ParserQ3 :
 	public PatchDef2Parser
 {
-protected:
+public:
 	virtual void setShader(IPatch& patch, const std::string& shader) const;
 };
 typedef std::shared_ptr<PatchDef2Parser> PatchDef2ParserPtr;
@@ -1,12 +1,8 @@
-// greebo: Specialise the float casting function
-#define SPECIALISE_STR_TO_FLOAT
-
 #include "PatchDef3.h"
 
 #include "imap.h"
 #include "ipatch.h"
 #include "parser/DefTokeniser.h"
-#include "string/convert.h"
 
 namespace map
 {
@@ -51,14 +47,14 @@ scene::INodePtr PatchDef3Parser::parse(parser::DefTokeniser& tok) const
 	// Parse parameters
 	tok.assertNextToken("(");
 
-	std::size_t cols = string::convert<std::size_t>(tok.nextToken());
-	std::size_t rows = string::convert<std::size_t>(tok.nextToken());
+	std::size_t cols = tok.nextInteger<std::size_t>();
+	std::size_t rows = tok.nextInteger<std::size_t>();
 
 	patch.setDims(cols, rows);
 
 	// Parse fixed tesselation
-	std::size_t subdivX = string::convert<std::size_t>(tok.nextToken());
-	std::size_t subdivY = string::convert<std::size_t>(tok.nextToken());
+	std::size_t subdivX = tok.nextInteger<std::size_t>();
+	std::size_t subdivY = tok.nextInteger<std::size_t>();
 
 	patch.setFixedSubdivisions(true, Subdivisions(subdivX, subdivY));
 
@@ -79,4 +75,9 @@ scene::INodePtr PatchDef3Parser::parse(parser::DefTokeniser& tok) const
 	return node;
 }
 
+ParsedPrimitivePtr PatchDef3Parser::parseDetached(parser::DefTokeniser& tok) const
+{
+	return parsePatchDetached(tok, patch::PatchDefType::Def3);
+}
+
 } // namespace map
@@ -13,6 +13,8 @@ public:
 	const std::string& getKeyword() const;
 
     scene::INodePtr parse(parser::DefTokeniser& tok) const;
+
+    ParsedPrimitivePtr parseDetached(parser::DefTokeniser& tok) const;
 };
 typedef std::shared_ptr<PatchDef3Parser> PatchDef3ParserPtr;
 
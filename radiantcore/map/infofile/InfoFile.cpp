@@ -1,5 +1,6 @@
 #include "InfoFile.h"
 
+#include <iterator>
 #include "itextstream.h"
 #include "imapinfofile.h"
 #include "string/convert.h"
@@ -14,7 +15,8 @@ const char* const InfoFile::HEADER_SEQUENCE = "DarkRadiant Map Information File
 
 // Pass the input stream to the constructor
 InfoFile::InfoFile(std::istream& infoStream, const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap) :
-	_tok(infoStream),
+	_buffer(std::istreambuf_iterator<char>(infoStream), {}),
+	_tok(_buffer, parser::WHITESPACE, "{}(),"),
 	_isValid(true),
 	_root(root),
 	_nodeMap(nodeMap)
@@ -22,12 +24,17 @@ InfoFile::InfoFile(std::istream& infoStream, const scene::IMapRootNodePtr& root,
 
 void InfoFile::parse()
 {
-	// Initialise the modules
-	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
+	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
 	{
-		module.onInfoFileLoadStart();
+		_modules.push_back(&module);
 	});
 
+	// Initialise the modules
+	for (auto module : _modules)
+	{
+		module->onInfoFileLoadStart();
+	}
+
 	// Parse the Header
 	parseInfoFileHeader();
 
@@ -35,16 +42,26 @@ void InfoFile::parse()
 	parseInfoFileBody();
 
 	// Apply the parsed info to the scene
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.applyInfoToScene(_root, _nodeMap);
-	});
+		module->applyInfoToScene(_root, _nodeMap);
+	}
 
 	// De-initialise the modules
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onInfoFileLoadFinished();
-	});
+		module->onInfoFileLoadFinished();
+	}
+}
+
+void InfoFile::parseWithModule(IMapInfoFileModule& module)
+{
+	_modules.assign(1, &module);
+
+	module.onInfoFileLoadStart();
+
+	parseInfoFileHeader();
+	parseInfoFileBody();
 }
 
 void InfoFile::parseInfoFileHeader()
@@ -94,14 +111,14 @@ void InfoFile::parseInfoFileBody()
 		bool blockParsed = false;
 
 		// Send each block to the modules that are able to load it
-		GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+		for (auto module : _modules)
 		{
-			if (!blockParsed && module.canParseBlock(token))
+			if (!blockParsed && module->canParseBlock(token))
 			{
-				module.parseBlock(token, _tok);
+				module->parseBlock(token, _tok);
 				blockParsed = true;
 			}
-		});
+		}
 
 		if (blockParsed)
 		{
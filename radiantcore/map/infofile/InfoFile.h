@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <string_view>
+#include <vector>
 #include "imap.h"
 #include "imapinfofile.h"
 #include "parser/DefTokeniser.h"
@@ -18,8 +21,11 @@ public:
 	static const char* const HEADER_SEQUENCE;
 
 private:
-	// The actual DefTokeniser to split the infoStream into pieces
-	parser::BasicDefTokeniser<std::istream> _tok;
+	// The contents of the info stream, read in one go
+	std::string _buffer;
+
+	// The actual DefTokeniser to split the buffer into pieces, the tokens refer to it
+	parser::BasicDefTokeniser<std::string_view> _tok;
 
 	// TRUE if the map info file was found to be valid
 	bool _isValid;
@@ -30,6 +36,9 @@ private:
 	// Index to Node mapping
 	const NodeIndexMap& _nodeMap;
 
+	// The modules the blocks are dispatched to
+	std::vector<IMapInfoFileModule*> _modules;
+
 public:
 	// Pass the input stream to the constructor, plus some info about the map we're dealing with
 	InfoFile(std::istream& infoStream, const scene::IMapRootNodePtr& root, const NodeIndexMap& nodeMap);
@@ -37,6 +46,10 @@ public:
 	// Parse the entire file
 	void parse();
 
+	// Parses the entire file using the given module only, without applying
+	// anything to the scene. The module can be queried afterwards.
+	void parseWithModule(IMapInfoFileModule& module);
+
 private:
 	void parseInfoFileHeader();
 	void parseInfoFileBody();
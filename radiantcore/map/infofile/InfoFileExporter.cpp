@@ -10,11 +10,16 @@ namespace map
 InfoFileExporter::InfoFileExporter(std::ostream& stream) :
     _stream(stream)
 {
-	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
+	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
 	{
-		module.onInfoFileSaveStart();
+		_modules.push_back(&module);
 	});
 
+	for (auto module : _modules)
+	{
+		module->onInfoFileSaveStart();
+	}
+
     // Write the information file header
     _stream << InfoFile::HEADER_SEQUENCE << " " << InfoFile::MAP_INFO_VERSION << std::endl;
     _stream << "{" << std::endl;
@@ -23,56 +28,54 @@ InfoFileExporter::InfoFileExporter(std::ostream& stream) :
 InfoFileExporter::~InfoFileExporter()
 {
 	// Tell the info file modules to write their data now
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		rMessage() << "Writing info file blocks for " << module.getName() << std::endl;
+		rMessage() << "Writing info file blocks for " << module->getName() << std::endl;
 
-		module.writeBlocks(_stream);
-	});
+		module->writeBlocks(_stream);
+	}
 
 	// Write the closing braces of the information file
     _stream << "}" << std::endl;
 
 	_stream.flush();
 
-	GlobalMapInfoFileManager().foreachModule([](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onInfoFileSaveFinished();
-	});
+		module->onInfoFileSaveFinished();
+	}
 }
 
 void InfoFileExporter::beginSaveMap(const scene::IMapRootNodePtr& root)
 {
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onBeginSaveMap(root);
-	});
+		module->onBeginSaveMap(root);
+	}
 }
 
 void InfoFileExporter::finishSaveMap(const scene::IMapRootNodePtr& root)
 {
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onFinishSaveMap(root);
-	});
+		module->onFinishSaveMap(root);
+	}
 }
 
 void InfoFileExporter::visitEntity(const scene::INodePtr& node, std::size_t entityNum)
 {
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onSaveEntity(node, entityNum);
-	});
+		module->onSaveEntity(node, entityNum);
+	}
 }
 
 void InfoFileExporter::visitPrimitive(const scene::INodePtr& node, std::size_t entityNum, std::size_t primitiveNum)
 {
-	GlobalMapInfoFileManager().foreachModule([&](IMapInfoFileModule& module)
+	for (auto module : _modules)
 	{
-		module.onSavePrimitive(node, entityNum, primitiveNum);
-	});
+		module->onSavePrimitive(node, entityNum, primitiveNum);
+	}
 }
 
-
-
 } // namespace
@@ -5,16 +5,23 @@
 #include "inode.h"
 #include "imap.h"
 #include <map>
+#include <vector>
 
 namespace map
 {
 
+class IMapInfoFileModule;
+
 class InfoFileExporter
 {
 private:
 	// The stream we're writing to
 	std::ostream& _stream;
 
+	// The registered info file modules, collected once since they
+	// are invoked for every entity and primitive written to the map
+	std::vector<IMapInfoFileModule*> _modules;
+
 public:
 	// The constructor prepares the output stream
 	InfoFileExporter(std::ostream& stream);
@@ -67,6 +67,7 @@ void MRU::constructPreferences()
 
 	page.appendEntry(_("Number of most recently used files"), RKEY_MRU_LENGTH);
 	page.appendCheckBox(_("Open last map on startup"), RKEY_LOAD_LAST_MAP);
+	page.appendCheckBox(_("Preload models and materials of the last map on startup"), RKEY_PRELOAD_LAST_MAP);
 }
 
 std::string MRU::getLastMapName()
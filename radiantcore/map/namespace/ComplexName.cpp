@@ -1,6 +1,8 @@
 #include "ComplexName.h"
 
 #include <climits>
+#include <iterator>
+#include <limits>
 #include "string/trim.h"
 #include "string/convert.h"
 
@@ -25,33 +27,140 @@ std::string ComplexName::getFullname() const
 
 namespace
 {
-    // Find the first integer not in the given set
-    std::string findFirstUnusedNumber(const PostfixSet& set)
+    // Returns the number represented by the postfix, or 0 if it's not a number
+    // in canonical form (the unique-making numbers never have leading zeros)
+    int getPostfixNumber(const std::string& postfix)
     {
-        static const int LOWEST_VAL = 1;
+        if (postfix.empty() || postfix[0] < '1' || postfix[0] > '9' ||
+            postfix.size() > std::numeric_limits<int>::digits10 + 1)
+        {
+            return 0;
+        }
 
-        for (int i = LOWEST_VAL; i < INT_MAX; ++i)
+        long long number = 0;
+
+        for (auto c : postfix)
         {
-			std::string testPostfix = string::to_string(i);
+            if (c < '0' || c > '9') return 0;
+
+            number = number * 10 + (c - '0');
+        }
+
+        return number <= INT_MAX ? static_cast<int>(number) : 0;
+    }
+}
+
+bool PostfixSet::insert(const std::string& postfix)
+{
+    if (!_postfixes.insert(postfix).second)
+    {
+        return false;
+    }
+
+    if (auto number = getPostfixNumber(postfix); number > 0)
+    {
+        insertNumber(number);
+    }
+
+    return true;
+}
+
+bool PostfixSet::erase(const std::string& postfix)
+{
+    if (_postfixes.erase(postfix) == 0)
+    {
+        return false;
+    }
+
+    if (auto number = getPostfixNumber(postfix); number > 0)
+    {
+        eraseNumber(number);
+    }
+
+    return true;
+}
+
+void PostfixSet::merge(const PostfixSet& other)
+{
+    for (const auto& postfix : other._postfixes)
+    {
+        insert(postfix);
+    }
+}
+
+int PostfixSet::getFirstUnusedNumber() const
+{
+    auto first = _usedNumbers.find(1);
+
+    if (first == _usedNumbers.end())
+    {
+        return 1;
+    }
+
+    // Pathological case, all numbers are used
+    return first->second < INT_MAX ? first->second + 1 : INT_MAX;
+}
+
+void PostfixSet::insertNumber(int number)
+{
+    // The range following the number might be joined
+    auto next = _usedNumbers.upper_bound(number);
+    auto last = number;
+
+    if (next != _usedNumbers.end() && number < INT_MAX && next->first == number + 1)
+    {
+        last = next->second;
+        next = _usedNumbers.erase(next);
+    }
+
+    // Extend the preceding range if it ends right before the number
+    if (next != _usedNumbers.begin())
+    {
+        auto previous = std::prev(next);
 
-            if (set.find(testPostfix) == set.end())
-            {
-                // Found an unused value
-                return testPostfix;
-            }
+        if (previous->second == number - 1)
+        {
+            previous->second = last;
+            return;
         }
+    }
+
+    _usedNumbers.emplace_hint(next, number, last);
+}
+
+void PostfixSet::eraseNumber(int number)
+{
+    // Locate the range containing the number
+    auto range = _usedNumbers.upper_bound(number);
+
+    if (range == _usedNumbers.begin()) return;
+
+    --range;
 
-        // Pathological case, could not find a value
-        return string::to_string(INT_MAX);
+    if (range->second < number) return;
+
+    auto first = range->first;
+    auto last = range->second;
+
+    _usedNumbers.erase(range);
+
+    if (first < number)
+    {
+        _usedNumbers.emplace(first, number - 1);
+    }
+
+    if (number < last)
+    {
+        _usedNumbers.emplace(number + 1, last);
     }
 }
 
 std::string ComplexName::makePostfixUnique(const PostfixSet& postfixes)
 {
     // If our postfix is already in the set, change it to a unique value
-    if (postfixes.find(_postFix) != postfixes.end())
+    if (postfixes.contains(_postFix))
     {
-        _postFix = findFirstUnusedNumber(postfixes);
+        _postFix = string::to_string(postfixes.getFirstUnusedNumber());
     }
 
     return _postFix;
@@ -2,9 +2,55 @@
 
 #include <string>
 #include <set>
+#include <map>
 
-/// Set of unique postfixes, e.g. "1", "6" or "04"
-typedef std::set<std::string> PostfixSet;
+/**
+ * Set of unique postfixes, e.g. "1", "6" or "04".
+ *
+ * The postfixes which are plain numbers without leading zeros are also kept
+ * as ranges of consecutive used numbers, such that the first unused number
+ * is found in logarithmic time.
+ */
+class PostfixSet
+{
+private:
+    std::set<std::string> _postfixes;
+
+    // Maps the first number of each used range to its last number
+    std::map<int, int> _usedNumbers;
+
+public:
+    bool empty() const
+    {
+        return _postfixes.empty();
+    }
+
+    std::size_t size() const
+    {
+        return _postfixes.size();
+    }
+
+    bool contains(const std::string& postfix) const
+    {
+        return _postfixes.count(postfix) > 0;
+    }
+
+    // Returns true if the postfix has not been in the set before
+    bool insert(const std::string& postfix);
+
+    // Returns true if the postfix has been in the set before
+    bool erase(const std::string& postfix);
+
+    // Adds all postfixes of the other set
+    void merge(const PostfixSet& other);
+
+    // Returns the lowest number, starting at 1, that is not used as postfix
+    int getFirstUnusedNumber() const;
+
+private:
+    void insertNumber(int number);
+    void eraseNumber(int number);
+};
 
 /// Name consisting of initial text and optional unique-making number-postfix 
 /// e.g. "Carl" + "6", or "Mary" + "03"
@@ -0,0 +1,180 @@
+#include "MemoryAccounting.h"
+
+#include <algorithm>
+#include "i18n.h"
+#include "iregistry.h"
+#include "ipreferencesystem.h"
+#include "itextstream.h"
+#include "registry/registry.h"
+#include "string/format.h"
+#include "util/PoolAllocator.h"
+#include "module/StaticModule.h"
+#include <fmt/format.h>
+
+namespace memory
+{
+
+namespace
+{
+    // Collects the entries of a single reporter
+    class MemoryReport :
+        public IMemoryReport
+    {
+    private:
+        const std::string& _reporter;
+        std::vector<MemoryUsageEntry>& _entries;
+
+    public:
+        MemoryReport(const std::string& reporter, std::vector<MemoryUsageEntry>& entries) :
+            _reporter(reporter),
+            _entries(entries)
+        {}
+
+        void addEntry(const std::string& name, std::size_t bytes, std::size_t count) override
+        {
+            _entries.emplace_back(MemoryUsageEntry{ _reporter, name, bytes, count });
+        }
+    };
+}
+
+void MemoryAccounting::registerReporter(IMemoryReporter& reporter)
+{
+    if (std::find(_reporters.begin(), _reporters.end(), &reporter) != _reporters.end())
+    {
+        rWarning() << "Duplicate memory reporter registered: " << reporter.getMemoryReporterName() << std::endl;
+        return;
+    }
+
+    _reporters.push_back(&reporter);
+}
+
+void MemoryAccounting::unregisterReporter(IMemoryReporter& reporter)
+{
+    _reporters.erase(std::remove(_reporters.begin(), _reporters.end(), &reporter), _reporters.end());
+}
+
+std::vector<MemoryUsageEntry> MemoryAccounting::collectMemoryUsage()
+{
+    auto reporters = _reporters;
+
+    std::stable_sort(reporters.begin(), reporters.end(), [](IMemoryReporter* a, IMemoryReporter* b)
+    {
+        return a->getMemoryReporterName() < b->getMemoryReporterName();
+    });
+
+    std::vector<MemoryUsageEntry> entries;
+
+    for (auto reporter : reporters)
+    {
+        MemoryReport report(reporter->getMemoryReporterName(), entries);
+        reporter->reportMemoryUsage(report);
+    }
+
+    return entries;
+}
+
+void MemoryAccounting::logMemoryUsage()
+{
+    auto entries = collectMemoryUsage();
+
+    std::string text = "--- Memory Report ---";
+    std::size_t totalBytes = 0;
+
+    for (const auto& entry : entries)
+    {
+        text += fmt::format("\n{0:<20} {1:<36} {2:>12}", entry.reporter, entry.name,
+            entry.bytes > 0 ? string::getFormattedByteSize(entry.bytes) : "-");
+
+        if (entry.count > 0)
+        {
+            text += fmt::format(" {0:>10}", entry.count);
+        }
+
+        totalBytes += entry.bytes;
+    }
+
+    text += fmt::format("\nTotal accounted memory: {0}", string::getFormattedByteSize(totalBytes));
+
+    rMessage() << text << std::endl;
+}
+
+sigc::signal<void>& MemoryAccounting::signal_sampleDue()
+{
+    return _sigSampleDue;
+}
+
+const std::string& MemoryAccounting::getMemoryReporterName() const
+{
+    static std::string _name("BlockPools");
+    return _name;
+}
+
+void MemoryAccounting::reportMemoryUsage(IMemoryReport& report)
+{
+    util::BlockPool::foreachPool([&](const util::BlockPool::Statistics& pool)
+    {
+        report.addEntry(fmt::format("{0} byte blocks in use", pool.blockSize), pool.blocksInUse * pool.blockSize, pool.blocksInUse);
+        report.addEntry(fmt::format("{0} byte blocks reserved", pool.blockSize), pool.blocksReserved * pool.blockSize, pool.blocksReserved);
+    });
+}
+
+const std::string& MemoryAccounting::getName() const
+{
+    static std::string _name(MODULE_MEMORYACCOUNTING);
+    return _name;
+}
+
+const StringSet& MemoryAccounting::getDependencies() const
+{
+    static StringSet _dependencies
+    {
+        MODULE_COMMANDSYSTEM,
+        MODULE_XMLREGISTRY,
+        MODULE_PREFERENCESYSTEM,
+    };
+
+    return _dependencies;
+}
+
+void MemoryAccounting::initialiseModule(const IApplicationContext& ctx)
+{
+    registerReporter(*this);
+
+    GlobalCommandSystem().addCommand("MemoryReport", sigc::mem_fun(*this, &MemoryAccounting::printMemoryReportCmd));
+
+    IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Memory"));
+    page.appendSpinner(_("Log memory usage every (minutes, 0 = off)"), RKEY_MEMORY_SAMPLE_INTERVAL, 0, 1440, 0);
+
+    GlobalRegistry().signalForKey(RKEY_MEMORY_SAMPLE_INTERVAL).connect(
+        sigc::mem_fun(*this, &MemoryAccounting::updateSampleTimer));
+
+    updateSampleTimer();
+}
+
+void MemoryAccounting::shutdownModule()
+{
+    _sampleTimer.reset();
+    _reporters.clear();
+}
+
+void MemoryAccounting::printMemoryReportCmd(const cmd::ArgumentList& args)
+{
+    logMemoryUsage();
+}
+
+void MemoryAccounting::updateSampleTimer()
+{
+    _sampleTimer.reset();
+
+    auto minutes = registry::getValue<int>(RKEY_MEMORY_SAMPLE_INTERVAL);
+
+    if (minutes <= 0) return;
+
+    _sampleTimer = std::make_unique<util::Timer>(static_cast<std::size_t>(minutes) * 60 * 1000,
+        [this]() { _sigSampleDue.emit(); });
+    _sampleTimer->start();
+}
+
+module::StaticModuleRegistration<MemoryAccounting> memoryAccountingModule;
+
+}
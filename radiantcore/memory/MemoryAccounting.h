@@ -0,0 +1,51 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "imemoryaccounting.h"
+#include "icommandsystem.h"
+#include "time/Timer.h"
+
+namespace memory
+{
+
+// The interval of the memory samples written to the log in minutes, 0 = off
+constexpr const char* const RKEY_MEMORY_SAMPLE_INTERVAL = "user/ui/memoryAccounting/sampleInterval";
+
+class MemoryAccounting final :
+    public IMemoryAccounting,
+    public IMemoryReporter
+{
+private:
+    std::vector<IMemoryReporter*> _reporters;
+
+    std::unique_ptr<util::Timer> _sampleTimer;
+    sigc::signal<void> _sigSampleDue;
+
+public:
+    void registerReporter(IMemoryReporter& reporter) override;
+    void unregisterReporter(IMemoryReporter& reporter) override;
+
+    std::vector<MemoryUsageEntry> collectMemoryUsage() override;
+    void logMemoryUsage() override;
+
+    sigc::signal<void>& signal_sampleDue() override;
+
+    // IMemoryReporter implementation, covering the block pools
+    const std::string& getMemoryReporterName() const override;
+    void reportMemoryUsage(IMemoryReport& report) override;
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    void printMemoryReportCmd(const cmd::ArgumentList& args);
+
+    // (Re-)starts the sampling timer according to the registry setting
+    void updateSampleTimer();
+};
+
+}
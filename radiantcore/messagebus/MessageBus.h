@@ -1,56 +1,123 @@
 #pragma once
 
-#include <map>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "imessagebus.h"
 #include "itextstream.h"
 
 namespace radiant
 {
 
+/**
+ * The listeners are stored in a flat table indexed by message type.
+ * The table and its channels are immutable once published: adding or
+ * removing a listener copies the affected parts and swaps the table,
+ * so sending a message doesn't need to acquire any lock and messages
+ * can be sent from any thread, also from within a listener.
+ */
 class MessageBus :
 	public IMessageBus
 {
 private:
-    // Listener and its registration handle
-    using Channel = std::map<std::size_t, Listener>;
-    
-    // Maps message types to a set of listeners
-    std::map<std::size_t, Channel> _channels;
+    struct Registration
+    {
+        std::size_t id;
+        Listener listener;
+
+        // Set by removeListener(), dispatches already running will skip this listener
+        std::atomic<bool> removed;
+
+        Registration(std::size_t id_, const Listener& listener_) :
+            id(id_),
+            listener(listener_),
+            removed(false)
+        {}
+    };
+    using RegistrationPtr = std::shared_ptr<Registration>;
+
+    struct Channel
+    {
+        std::size_t messageType;
+
+        // Listeners in the order of their registration
+        std::vector<RegistrationPtr> listeners;
+
+        // Set while a coalescable message is dispatched, shared by all copies of this channel
+        std::shared_ptr<std::atomic<bool>> dispatchingCoalescable;
+    };
+    using ChannelPtr = std::shared_ptr<const Channel>;
+
+    struct DispatchTable
+    {
+        // Indexed by the well-known message types
+        std::vector<ChannelPtr> wellKnown;
+
+        // User-defined message types, sorted by type
+        std::vector<ChannelPtr> userDefined;
+    };
+    using DispatchTablePtr = std::shared_ptr<const DispatchTable>;
+
+    static constexpr std::size_t NumWellKnownTypes = IMessage::Type::UserDefinedMessagesGoHigherThanThis + 1;
+
+    // The most recently published table, accessed through std::atomic_load/store
+    DispatchTablePtr _table;
+
+    // Serialises the modifications of the table
+    std::mutex _writeLock;
 
-    bool _processingMessage;
     std::size_t _nextId;
 
 public:
-    MessageBus() : 
+    MessageBus() :
         _nextId(1)
-    {}
+    {
+        auto table = std::make_shared<DispatchTable>();
+        table->wellKnown.resize(NumWellKnownTypes);
+
+        _table = table;
+    }
 
     std::size_t addListener(std::size_t messageType, const Listener& listener) override
     {
-        auto channel = _channels.find(messageType);
+        std::lock_guard<std::mutex> lock(_writeLock);
+
+        auto table = std::make_shared<DispatchTable>(*std::atomic_load(&_table));
+        auto& slot = findOrInsertSlot(*table, messageType);
+
+        auto channel = slot ? std::make_shared<Channel>(*slot) : std::make_shared<Channel>();
 
-        if (channel == _channels.end())
+        if (!slot)
         {
-            channel = _channels.emplace(messageType, Channel()).first;
+            channel->messageType = messageType;
+            channel->dispatchingCoalescable = std::make_shared<std::atomic<bool>>(false);
         }
 
         auto subscriberId = _nextId++;
-        channel->second.emplace(subscriberId, listener);
+        channel->listeners.emplace_back(std::make_shared<Registration>(subscriberId, listener));
+
+        slot = channel;
+        std::atomic_store(&_table, DispatchTablePtr(table));
 
         return subscriberId;
     }
 
     void removeListener(std::size_t listenerId) override
     {
-        for (auto& channel : _channels)
+        std::lock_guard<std::mutex> lock(_writeLock);
+
+        auto table = std::make_shared<DispatchTable>(*std::atomic_load(&_table));
+
+        if (removeFromSlots(table->wellKnown, listenerId) || removeFromSlots(table->userDefined, listenerId))
         {
-            auto l = channel.second.find(listenerId);
+            // Drop the user-defined channels getting empty, the well-known slots stay
+            table->userDefined.erase(std::remove(table->userDefined.begin(), table->userDefined.end(), nullptr),
+                table->userDefined.end());
 
-            if (l != channel.second.end())
-            {
-                channel.second.erase(l);
-                return;
-            }
+            std::atomic_store(&_table, DispatchTablePtr(table));
+            return;
         }
 
         rWarning() << "MessageBus: Could not locate listener with ID " << listenerId << std::endl;
@@ -58,19 +125,117 @@ public:
 
     void sendMessage(IMessage& message) override
     {
-        auto channel = _channels.find(message.getId());
+        // Keep the table alive during dispatch, listeners might be (de-)registered meanwhile
+        auto table = std::atomic_load(&_table);
+        auto channel = findChannel(*table, message.getId());
 
-        if (channel == _channels.end())
+        if (!channel)
         {
             // No listeners for this message
             return;
         }
 
-        for (auto it = channel->second.begin();
-             it != channel->second.end(); /* in-loop */)
+        if (message.isCoalescable())
+        {
+            // A message of this type is still being dispatched, this one is superseded by the next
+            if (channel->dispatchingCoalescable->exchange(true)) return;
+
+            // Listeners may throw to cancel an operation, reset the flag in any case
+            DispatchGuard guard(*channel->dispatchingCoalescable);
+            dispatch(*channel, message);
+            return;
+        }
+
+        dispatch(*channel, message);
+    }
+
+private:
+    class DispatchGuard
+    {
+    private:
+        std::atomic<bool>& _flag;
+
+    public:
+        DispatchGuard(std::atomic<bool>& flag) :
+            _flag(flag)
+        {}
+
+        ~DispatchGuard()
+        {
+            _flag.store(false);
+        }
+    };
+
+    static void dispatch(const Channel& channel, IMessage& message)
+    {
+        for (const auto& registration : channel.listeners)
+        {
+            if (!registration->removed.load())
+            {
+                registration->listener(message);
+            }
+        }
+    }
+
+    static ChannelPtr findChannel(const DispatchTable& table, std::size_t messageType)
+    {
+        if (messageType < NumWellKnownTypes)
+        {
+            return table.wellKnown[messageType];
+        }
+
+        auto found = std::lower_bound(table.userDefined.begin(), table.userDefined.end(), messageType,
+            [](const ChannelPtr& channel, std::size_t type) { return channel->messageType < type; });
+
+        return found != table.userDefined.end() && (*found)->messageType == messageType ? *found : ChannelPtr();
+    }
+
+    static ChannelPtr& findOrInsertSlot(DispatchTable& table, std::size_t messageType)
+    {
+        if (messageType < NumWellKnownTypes)
+        {
+            return table.wellKnown[messageType];
+        }
+
+        auto found = std::lower_bound(table.userDefined.begin(), table.userDefined.end(), messageType,
+            [](const ChannelPtr& channel, std::size_t type) { return channel->messageType < type; });
+
+        if (found != table.userDefined.end() && (*found)->messageType == messageType)
+        {
+            return *found;
+        }
+
+        return *table.userDefined.insert(found, ChannelPtr());
+    }
+
+    // Replaces the channel containing the given listener, returns false if there's none
+    static bool removeFromSlots(std::vector<ChannelPtr>& slots, std::size_t listenerId)
+    {
+        for (auto& slot : slots)
         {
-            (*it++).second(message);
+            if (!slot) continue;
+
+            auto found = std::find_if(slot->listeners.begin(), slot->listeners.end(),
+                [&](const RegistrationPtr& registration) { return registration->id == listenerId; });
+
+            if (found == slot->listeners.end()) continue;
+
+            (*found)->removed.store(true);
+
+            if (slot->listeners.size() == 1)
+            {
+                slot.reset();
+                return true;
+            }
+
+            auto channel = std::make_shared<Channel>(*slot);
+            channel->listeners.erase(channel->listeners.begin() + (found - slot->listeners.begin()));
+            slot = channel;
+
+            return true;
         }
+
+        return false;
     }
 };
 
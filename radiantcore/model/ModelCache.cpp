@@ -3,22 +3,69 @@
 #include "imodel.h"
 #include "iparticlenode.h"
 #include "iparticles.h"
+#include "itextstream.h"
+#include "imodelsurface.h"
+#include "ipreferencesystem.h"
+#include "i18n.h"
+#include "registry/registry.h"
 
 #include "os/path.h"
 #include "os/file.h"
 
 #include "module/StaticModule.h"
+#include <algorithm>
 #include <functional>
+#include <limits>
+#include <thread>
 
 #include "map/algorithm/Models.h"
+#include "map/OperationReport.h"
 
 namespace model
 {
 
 ModelCache::ModelCache() :
-	_enabled(true)
+	_enabled(true),
+	_accessCounter(0),
+	_memoryUsage(0),
+	_memoryBudget(0),
+	_numCacheHits(0),
+	_numCacheMisses(0),
+	_numEvictions(0),
+	_asyncLoadingEnabled(false),
+	_loadFocus(0, 0, 0),
+	_numRunningWorkers(0)
 {}
 
+namespace
+{
+	// Approximate size of the vertex and index data of the given model
+	std::size_t estimateMemoryUsage(const IModel& model)
+	{
+		std::size_t size = 0;
+
+		for (int i = 0; i < model.getSurfaceCount(); ++i)
+		{
+			const auto& surface = model.getSurface(i);
+
+			if (auto indexed = dynamic_cast<const IIndexedModelSurface*>(&surface); indexed)
+			{
+				size += indexed->getVertexArray().size() * sizeof(MeshVertex);
+				size += indexed->getIndexArray().size() * sizeof(unsigned int);
+			}
+			else
+			{
+				size += surface.getNumVertices() * sizeof(MeshVertex);
+				size += surface.getNumTriangles() * 3 * sizeof(unsigned int);
+			}
+		}
+
+		return size;
+	}
+
+	constexpr std::size_t BYTES_PER_MB = 1024 * 1024;
+}
+
 scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
 {
 	// Get the extension of this model
@@ -34,20 +81,347 @@ scene::INodePtr ModelCache::getModelNode(const std::string& modelPath)
 	auto modelLoader = GlobalModelFormatManager().getImporter(extension);
 
 	// Try to construct a model node using the suitable loader
+	map::OperationReport::ScopedPhase phase(map::OperationReport::Phase::ModelLoading);
+	map::OperationReport::Increment(map::OperationReport::Counter::Models);
+
 	auto node =  modelLoader->loadModel(modelPath);
 
-    // In case the model load failed, let's return a NullModel
-    return node ? node : loadNullModel(modelPath);
+    if (!node)
+    {
+        // In case the model load failed, let's return a NullModel
+        return loadNullModel(modelPath);
+    }
+
+    registerModelNode(modelPath, node);
+
+    return node;
 }
 
-IModelPtr ModelCache::getModel(const std::string& modelPath)
+scene::INodePtr ModelCache::getModelNodeAsync(const std::string& modelPath, const ModelLoadedSlot& onLoaded)
+{
+	auto extension = os::getExtension(modelPath);
+
+	// Particles and models which are cached already are quick to construct
+	if (!_asyncLoadingEnabled || !_enabled || extension == "prt" || isCached(modelPath) ||
+		GlobalModelFormatManager().getImporter(extension)->getExtension().empty())
+	{
+		return getModelNode(modelPath);
+	}
+
+	// Don't try again to load models which failed before
+	if (_failedLoads.count(modelPath) > 0)
+	{
+		return loadNullModel(modelPath);
+	}
+
+	auto placeholder = loadNullModel(modelPath);
+
+	auto pending = _pendingLoads.find(modelPath);
+
+	if (pending == _pendingLoads.end())
+	{
+		pending = _pendingLoads.emplace(modelPath, PendingLoad()).first;
+
+		std::lock_guard<std::mutex> lock(_asyncLock);
+
+		_loadQueue.push_back(modelPath);
+
+		// Start another worker if the ones running are all busy
+		auto maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+
+		if (_numRunningWorkers < std::min<std::size_t>(maxWorkers, _loadQueue.size()))
+		{
+			++_numRunningWorkers;
+			_loadWorkers.emplace_back(std::async(std::launch::async, &ModelCache::processLoadQueue, this));
+		}
+	}
+
+	// The slot is invalidated if its target object is destroyed in the meantime
+	pending->second.loaded.connect([onLoaded, placeholder]() { onLoaded(placeholder); });
+	pending->second.placeholders.push_back(placeholder);
+
+	return placeholder;
+}
+
+void ModelCache::setAsyncLoadingEnabled(bool enabled)
+{
+	_asyncLoadingEnabled = enabled;
+
+	if (!enabled)
+	{
+		stopAsyncLoads();
+	}
+}
+
+void ModelCache::setAsyncLoadFocus(const Vector3& focus)
+{
+	if (_loadFocus == focus) return;
+
+	_loadFocus = focus;
+	prioritiseLoadQueue();
+}
+
+void ModelCache::prioritiseLoadQueue()
+{
+	std::lock_guard<std::mutex> lock(_asyncLock);
+
+	if (_loadQueue.size() < 2) return;
+
+	// The squared distance of the closest placeholder to the focus, for every queued model
+	std::map<std::string, double> distances;
+
+	for (const auto& modelPath : _loadQueue)
+	{
+		auto pending = _pendingLoads.find(modelPath);
+		auto distance = std::numeric_limits<double>::max();
+
+		if (pending != _pendingLoads.end())
+		{
+			for (const auto& weakPlaceholder : pending->second.placeholders)
+			{
+				if (auto placeholder = weakPlaceholder.lock(); placeholder)
+				{
+					distance = std::min(distance, (placeholder->worldAABB().getOrigin() - _loadFocus).getLengthSquared());
+				}
+			}
+		}
+
+		distances[modelPath] = distance;
+	}
+
+	std::stable_sort(_loadQueue.begin(), _loadQueue.end(), [&](const std::string& a, const std::string& b)
+	{
+		return distances[a] < distances[b];
+	});
+}
+
+bool ModelCache::isModelLoading(const std::string& modelPath)
 {
-	// Try to lookup the existing model
+	return _pendingLoads.count(modelPath) > 0;
+}
+
+void ModelCache::processAsyncLoads()
+{
+	std::vector<std::string> finishedLoads;
+
+	{
+		std::lock_guard<std::mutex> lock(_asyncLock);
+
+		finishedLoads.swap(_finishedLoads);
+
+		// Clean up the workers which are done
+		_loadWorkers.erase(std::remove_if(_loadWorkers.begin(), _loadWorkers.end(), [](const std::future<void>& worker)
+		{
+			return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}), _loadWorkers.end());
+	}
+
+	for (const auto& modelPath : finishedLoads)
+	{
+		auto pending = _pendingLoads.find(modelPath);
+
+		if (pending == _pendingLoads.end()) continue;
+
+		// Remove the entry before notifying, the listeners are going to request the model again
+		auto signal = pending->second.loaded;
+		_pendingLoads.erase(pending);
+
+		if (!isCached(modelPath))
+		{
+			_failedLoads.insert(modelPath);
+		}
+
+		signal.emit();
+	}
+
+	if (!finishedLoads.empty())
+	{
+		evictUnusedModels();
+
+		// The entities might have moved since the models have been queued,
+		// e.g. the map loader sets the model key before the origin
+		prioritiseLoadQueue();
+	}
+}
+
+sigc::signal<void> ModelCache::signal_asyncLoadFinished()
+{
+	return _sigAsyncLoadFinished;
+}
+
+bool ModelCache::isCached(const std::string& modelPath)
+{
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+	return _modelMap.count(modelPath) > 0;
+}
+
+void ModelCache::insertModel(const std::string& modelPath, const IModelPtr& model)
+{
+	auto memoryUsage = estimateMemoryUsage(*model);
+
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+	if (_modelMap.emplace(modelPath, CachedModel{ model, memoryUsage, ++_accessCounter, {} }).second)
+	{
+		_memoryUsage += memoryUsage;
+	}
+}
+
+void ModelCache::registerModelNode(const std::string& modelPath, const scene::INodePtr& node)
+{
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
 	auto found = _modelMap.find(modelPath);
 
-	if (_enabled && found != _modelMap.end())
+	if (found != _modelMap.end())
+	{
+		// Drop the nodes which are gone, before adding the new one
+		found->second.isInUse();
+		found->second.nodes.emplace_back(node);
+	}
+}
+
+bool ModelCache::CachedModel::isInUse()
+{
+	nodes.erase(std::remove_if(nodes.begin(), nodes.end(), [](const scene::INodeWeakPtr& node)
+	{
+		return node.expired();
+	}), nodes.end());
+
+	return !nodes.empty() || model.use_count() > 1;
+}
+
+void ModelCache::evictUnusedModels()
+{
+	// Keep the evicted models alive until the lock is released, in case their
+	// destruction is calling back into the cache
+	std::vector<IModelPtr> evictedModels;
+
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+	if (_memoryBudget == 0 || _memoryUsage <= _memoryBudget)
+	{
+		return;
+	}
+
+	std::vector<ModelMap::iterator> candidates;
+
+	for (auto i = _modelMap.begin(); i != _modelMap.end(); ++i)
+	{
+		if (!i->second.isInUse())
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [](const ModelMap::iterator& a, const ModelMap::iterator& b)
+	{
+		return a->second.lastAccess < b->second.lastAccess;
+	});
+
+	for (const auto& candidate : candidates)
+	{
+		if (_memoryUsage <= _memoryBudget) break;
+
+		_memoryUsage -= candidate->second.memoryUsage;
+		evictedModels.push_back(candidate->second.model);
+		_modelMap.erase(candidate);
+
+		++_numEvictions;
+	}
+}
+
+void ModelCache::onBudgetChanged()
+{
+	_memoryBudget = static_cast<std::size_t>(registry::getValue<double>(RKEY_MODEL_CACHE_BUDGET) * BYTES_PER_MB);
+	evictUnusedModels();
+}
+
+void ModelCache::processLoadQueue()
+{
+	while (true)
+	{
+		std::string modelPath;
+
+		{
+			std::lock_guard<std::mutex> lock(_asyncLock);
+
+			if (_loadQueue.empty())
+			{
+				--_numRunningWorkers;
+				return;
+			}
+
+			modelPath = _loadQueue.front();
+			_loadQueue.pop_front();
+		}
+
+		try
+		{
+			map::OperationReport::ScopedPhase phase(map::OperationReport::Phase::ModelLoading);
+			map::OperationReport::Increment(map::OperationReport::Counter::Models);
+
+			auto modelLoader = GlobalModelFormatManager().getImporter(os::getExtension(modelPath));
+
+			if (auto model = modelLoader->loadModelFromPath(modelPath); model)
+			{
+				// Models are evicted on the main thread only, after the listeners had their chance
+				insertModel(modelPath, model);
+			}
+		}
+		catch (const std::exception& ex)
+		{
+			rError() << "Failed to load model " << modelPath << ": " << ex.what() << std::endl;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(_asyncLock);
+			_finishedLoads.push_back(modelPath);
+
+			// Emit the signal while holding the lock, such that it is never emitted concurrently
+			_sigAsyncLoadFinished.emit();
+		}
+	}
+}
+
+void ModelCache::stopAsyncLoads()
+{
+	std::vector<std::future<void>> workers;
+
+	{
+		std::lock_guard<std::mutex> lock(_asyncLock);
+
+		_loadQueue.clear();
+		workers.swap(_loadWorkers);
+	}
+
+	// Wait for all workers, this is re-throwing any exceptions
+	for (auto& worker : workers)
+	{
+		worker.get();
+	}
+
+	_finishedLoads.clear();
+	_pendingLoads.clear();
+	_failedLoads.clear();
+}
+
+IModelPtr ModelCache::getModel(const std::string& modelPath)
+{
 	{
-		return found->second;
+		std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+		// Try to lookup the existing model
+		auto found = _modelMap.find(modelPath);
+
+		if (_enabled && found != _modelMap.end())
+		{
+			++_numCacheHits;
+			found->second.lastAccess = ++_accessCounter;
+			return found->second.model;
+		}
+
+		++_numCacheMisses;
 	}
 
 	// The model is not cached or the cache is disabled, load afresh
@@ -63,7 +437,10 @@ IModelPtr ModelCache::getModel(const std::string& modelPath)
 	if (model)
 	{
 		// Model successfully loaded, insert a reference into the map
-		_modelMap.emplace(modelPath, model);
+		insertModel(modelPath, model);
+
+		// The new model is still referenced by us, it won't be evicted right away
+		evictUnusedModels();
 	}
 
 	return model;
@@ -98,13 +475,21 @@ void ModelCache::removeModel(const std::string& modelPath)
 	// get cleared, which might trigger a loopback to insert().
 	_enabled = false;
 
-	ModelMap::iterator found = _modelMap.find(modelPath);
-
-	if (found != _modelMap.end())
 	{
-		_modelMap.erase(found);
+		std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+		ModelMap::iterator found = _modelMap.find(modelPath);
+
+		if (found != _modelMap.end())
+		{
+			_memoryUsage -= found->second.memoryUsage;
+			_modelMap.erase(found);
+		}
 	}
 
+	// Give a changed model file another chance
+	_failedLoads.erase(modelPath);
+
 	// Allow usage of the modelnodemap again.
 	_enabled = true;
 }
@@ -115,7 +500,17 @@ void ModelCache::clear()
 	// get cleared, which might trigger a loopback to insert().
 	_enabled = false;
 
-	_modelMap.clear();
+	{
+		std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+		_modelMap.clear();
+
+		_memoryUsage = 0;
+		_numCacheHits = 0;
+		_numCacheMisses = 0;
+		_numEvictions = 0;
+	}
+
+	_failedLoads.clear();
 
 	// Allow usage of the modelnodemap again.
 	_enabled = true;
@@ -133,6 +528,19 @@ const std::string& ModelCache::getName() const
 	return _name;
 }
 
+const std::string& ModelCache::getMemoryReporterName() const
+{
+	static std::string _name("ModelCache");
+	return _name;
+}
+
+void ModelCache::reportMemoryUsage(memory::IMemoryReport& report)
+{
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+	report.addEntry("Cached models", _memoryUsage, _modelMap.size());
+}
+
 const StringSet& ModelCache::getDependencies() const
 {
 	static StringSet _dependencies;
@@ -141,6 +549,9 @@ const StringSet& ModelCache::getDependencies() const
 	{
 		_dependencies.insert(MODULE_MODELFORMATMANAGER);
 		_dependencies.insert(MODULE_COMMANDSYSTEM);
+		_dependencies.insert(MODULE_XMLREGISTRY);
+		_dependencies.insert(MODULE_PREFERENCESYSTEM);
+		_dependencies.insert(MODULE_MEMORYACCOUNTING);
 	}
 
 	return _dependencies;
@@ -152,10 +563,24 @@ void ModelCache::initialiseModule(const IApplicationContext& ctx)
 		std::bind(&ModelCache::refreshModelsCmd, this, std::placeholders::_1));
 	GlobalCommandSystem().addCommand("RefreshSelectedModels",
 		std::bind(&ModelCache::refreshSelectedModelsCmd, this, std::placeholders::_1));
+	GlobalCommandSystem().addCommand("ShowModelCacheStatistics",
+		std::bind(&ModelCache::showStatisticsCmd, this, std::placeholders::_1));
+
+	GlobalRegistry().signalForKey(RKEY_MODEL_CACHE_BUDGET).connect(
+		sigc::mem_fun(this, &ModelCache::onBudgetChanged));
+	onBudgetChanged();
+
+	IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Model Cache"));
+	page.appendSpinner(_("Memory Budget in MB (0 = unlimited)"), RKEY_MODEL_CACHE_BUDGET, 0, 65536, 0);
+
+	GlobalMemoryAccounting().registerReporter(*this);
 }
 
 void ModelCache::shutdownModule()
 {
+	GlobalMemoryAccounting().unregisterReporter(*this);
+
+	setAsyncLoadingEnabled(false);
 	clear();
 }
 
@@ -169,6 +594,11 @@ void ModelCache::refreshSelectedModels(bool blockScreenUpdates)
 	map::algorithm::refreshSelectedModels(blockScreenUpdates);
 }
 
+void ModelCache::refreshModel(const std::string& modelPath)
+{
+	map::algorithm::refreshModelsByPath(modelPath);
+}
+
 void ModelCache::refreshModelsCmd(const cmd::ArgumentList& args)
 {
 	map::algorithm::refreshModels(true);
@@ -179,6 +609,30 @@ void ModelCache::refreshSelectedModelsCmd(const cmd::ArgumentList& args)
 	map::algorithm::refreshSelectedModels(true);
 }
 
+void ModelCache::showStatisticsCmd(const cmd::ArgumentList& args)
+{
+	std::lock_guard<std::recursive_mutex> lock(_modelMapLock);
+
+	std::size_t numUnusedModels = 0;
+	std::size_t unusedMemory = 0;
+
+	for (auto& [path, cachedModel] : _modelMap)
+	{
+		if (!cachedModel.isInUse())
+		{
+			++numUnusedModels;
+			unusedMemory += cachedModel.memoryUsage;
+		}
+	}
+
+	rMessage() << "Model Cache: " << _modelMap.size() << " models using " <<
+		_memoryUsage / BYTES_PER_MB << " MB, " << numUnusedModels << " of them unused (" <<
+		unusedMemory / BYTES_PER_MB << " MB)" << std::endl;
+
+	rMessage() << "Model Cache: Budget " << (_memoryBudget > 0 ? std::to_string(_memoryBudget / BYTES_PER_MB) + " MB" : "unlimited") <<
+		", " << _numCacheHits << " hits, " << _numCacheMisses << " misses, " << _numEvictions << " evictions" << std::endl;
+}
+
 // The static module
 module::StaticModuleRegistration<ModelCache> modelCacheModule;
 
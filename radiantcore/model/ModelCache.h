@@ -1,32 +1,104 @@
 #pragma once
 
+#include <deque>
+#include <future>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 #include "imodelcache.h"
 #include "icommandsystem.h"
+#include "imemoryaccounting.h"
 
 namespace model
 {
 
 class ModelCache :
-	public IModelCache
+	public IModelCache,
+	public memory::IMemoryReporter
 {
 private:
+	struct CachedModel
+	{
+		IModelPtr model;
+
+		// The approximate size of the model's geometry in bytes
+		std::size_t memoryUsage;
+
+		// The value of the access counter when this model was last requested
+		std::size_t lastAccess;
+
+		// The nodes constructed from this model, which are working on their own copy
+		std::vector<scene::INodeWeakPtr> nodes;
+
+		// A model is in use as long as any of its nodes is alive, or someone else holds a reference
+		bool isInUse();
+	};
+
 	// The container maps model names to instances
-	typedef std::map<std::string, IModelPtr> ModelMap;
+	typedef std::map<std::string, CachedModel> ModelMap;
 	ModelMap _modelMap;
 
+	// Guards the model map and its statistics, the map is filled by the async loaders too
+	std::recursive_mutex _modelMapLock;
+
+	std::size_t _accessCounter;
+	std::size_t _memoryUsage;
+	std::size_t _memoryBudget;
+
+	// Statistics since the last clear()
+	std::size_t _numCacheHits;
+	std::size_t _numCacheMisses;
+	std::size_t _numEvictions;
+
 	// Flag to disable the cache on demand (used during clear())
 	bool _enabled;
 
 	sigc::signal<void> _sigModelsReloaded;
 
+	bool _asyncLoadingEnabled;
+
+	struct PendingLoad
+	{
+		// Emitted once the model has been loaded
+		sigc::signal<void> loaded;
+
+		// The placeholders handed out for this model, their position determines the load order
+		std::vector<scene::INodeWeakPtr> placeholders;
+	};
+
+	// The listeners waiting for each model path loaded in the background (main thread only)
+	std::map<std::string, PendingLoad> _pendingLoads;
+
+	// The point the load queue is ordered by (main thread only)
+	Vector3 _loadFocus;
+
+	// Model paths which failed to load in the background (main thread only)
+	std::set<std::string> _failedLoads;
+
+	// Guards the load queue, the finished loads and the workers
+	std::mutex _asyncLock;
+	std::deque<std::string> _loadQueue;
+	std::vector<std::string> _finishedLoads;
+	std::vector<std::future<void>> _loadWorkers;
+	std::size_t _numRunningWorkers;
+
+	sigc::signal<void> _sigAsyncLoadFinished;
+
 public:
 	ModelCache();
 
 	// greebo: For documentation, see the abstract base class.
 	scene::INodePtr getModelNode(const std::string& modelPath) override;
 
+	scene::INodePtr getModelNodeAsync(const std::string& modelPath, const ModelLoadedSlot& onLoaded) override;
+	void setAsyncLoadingEnabled(bool enabled) override;
+	void setAsyncLoadFocus(const Vector3& focus) override;
+	bool isModelLoading(const std::string& modelPath) override;
+	void processAsyncLoads() override;
+	sigc::signal<void> signal_asyncLoadFinished() override;
+
 	// greebo: For documentation, see the abstract base class.
 	IModelPtr getModel(const std::string& modelPath) override;
 
@@ -38,10 +110,15 @@ public:
 
 	void refreshModels(bool blockScreenUpdates = true) override;
 	void refreshSelectedModels(bool blockScreenUpdates = true) override;
+	void refreshModel(const std::string& modelPath) override;
 
 	// Public events
 	sigc::signal<void> signal_modelsReloaded() override;
 
+	// IMemoryReporter implementation
+	const std::string& getMemoryReporterName() const override;
+	void reportMemoryUsage(memory::IMemoryReport& report) override;
+
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
@@ -51,9 +128,33 @@ public:
 private:
     scene::INodePtr loadNullModel(const std::string& modelPath);
 
+    bool isCached(const std::string& modelPath);
+
+    void insertModel(const std::string& modelPath, const IModelPtr& model);
+
+    // Remembers the given node as user of the cached model
+    void registerModelNode(const std::string& modelPath, const scene::INodePtr& node);
+
+    // Removes the least recently used models which are not referenced
+    // by anyone else, until the cache fits into the memory budget again
+    void evictUnusedModels();
+
+    void onBudgetChanged();
+
+    // Worker thread function, parsing queued models until the queue is empty
+    void processLoadQueue();
+
+    // Sorts the load queue by the distance of the placeholders to the load focus,
+    // this is reading the node transforms and must be called on the main thread
+    void prioritiseLoadQueue();
+
+    // Blocks until all workers are done, queued models which have not been started are dropped
+    void stopAsyncLoads();
+
 	// Command targets
 	void refreshModelsCmd(const cmd::ArgumentList& args);
 	void refreshSelectedModelsCmd(const cmd::ArgumentList& args);
+	void showStatisticsCmd(const cmd::ArgumentList& args);
 };
 
 } // namespace model
@@ -3,6 +3,7 @@
 #include "StaticModelSurface.h"
 #include "ishaders.h"
 #include "iscenegraph.h"
+#include "iscenestatistics.h"
 #include "imap.h"
 
 namespace model
@@ -118,6 +119,12 @@ void StaticModelNode::skinChanged(const std::string& newSkinName)
     // Applying the skin might trigger onModelShadersChanged()
     _model->applySkin(GlobalModelSkinCache().findSkin(_skin));
 
+    // The skin is listed in the scene statistics, as are the remapped materials
+    if (inScene())
+    {
+        GlobalSceneStatistics().queueUpdate(getSelf());
+    }
+
     // Refresh the scene (TODO: get rid of that)
     GlobalSceneGraph().sceneChanged();
 }
@@ -160,7 +167,9 @@ void StaticModelNode::_applyTransformation()
 
 void StaticModelNode::onModelScaleApplied()
 {
-    queueRenderableUpdate();
+    // Scaling changes the geometry IDs of the surfaces, the renderables need to
+    // re-attach to get their own (or shared) storage in the next pre-render phase
+    detachFromShaders();
 }
 
 } // namespace model
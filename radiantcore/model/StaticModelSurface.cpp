@@ -1,5 +1,7 @@
 #include "StaticModelSurface.h"
 
+#include <atomic>
+
 #include "itextstream.h"
 #include "modelskin.h"
 #include "math/Frustum.h"
@@ -13,9 +15,19 @@
 namespace model
 {
 
+namespace
+{
+    std::size_t getNextGeometryId()
+    {
+        static std::atomic<std::size_t> _nextGeometryId(1);
+        return _nextGeometryId++;
+    }
+}
+
 StaticModelSurface::StaticModelSurface(std::vector<MeshVertex>&& vertices, std::vector<unsigned int>&& indices) :
     _vertices(vertices),
-    _indices(indices)
+    _indices(indices),
+    _geometryId(getNextGeometryId())
 {
     // Expand the local AABB to include all vertices
     for (const auto& vertex : _vertices)
@@ -30,7 +42,8 @@ StaticModelSurface::StaticModelSurface(const StaticModelSurface& other) :
     _defaultMaterial(other._defaultMaterial),
     _vertices(other._vertices),
     _indices(other._indices),
-    _localAABB(other._localAABB)
+    _localAABB(other._localAABB),
+    _geometryId(other._geometryId)
 {}
 
 void StaticModelSurface::calculateTangents()
@@ -124,6 +137,11 @@ const std::vector<unsigned int>& StaticModelSurface::getIndexArray() const
 	return _indices;
 }
 
+std::size_t StaticModelSurface::getGeometryId() const
+{
+	return _geometryId;
+}
+
 const std::string& StaticModelSurface::getDefaultMaterial() const
 {
 	return _defaultMaterial;
@@ -215,6 +233,9 @@ void StaticModelSurface::applyScale(const Vector3& scale, const StaticModelSurfa
 	}
 
 	calculateTangents();
+
+	// Scaled vertices are no longer shareable with the original surface
+	_geometryId = scale == Vector3(1, 1, 1) ? originalSurface._geometryId : getNextGeometryId();
 }
 
 } // namespace model
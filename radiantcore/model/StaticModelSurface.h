@@ -47,6 +47,9 @@ private:
 	// The AABB containing this surface, in local object space.
 	AABB _localAABB;
 
+	// Identifies the vertex data, copies of this surface share the same ID
+	std::size_t _geometryId;
+
 private:
 	// Calculate tangent and bitangent vectors for all vertices.
 	void calculateTangents();
@@ -79,6 +82,7 @@ public:
 
 	const std::vector<MeshVertex>& getVertexArray() const override;
 	const std::vector<unsigned int>& getIndexArray() const override;
+	std::size_t getGeometryId() const override;
 
 	const std::string& getDefaultMaterial() const override;
 	void setDefaultMaterial(const std::string& defaultMaterial);
@@ -8,7 +8,7 @@ namespace model
 Lwo2Chunk::Lwo2Chunk(const std::string& identifier_, Type type) :
 	_chunkType(type),
 	identifier(identifier_),
-	stream(std::ios_base::in | std::ios_base::out | std::ios_base::binary)
+	stream(&_buffer)
 {
 	// FORM sub-chunks are normal chunks and have 4 bytes size info
 	// whereas subchunks of e.g. CLIP use 2 bytes of size info
@@ -19,9 +19,8 @@ unsigned int Lwo2Chunk::getContentSize() const
 {
 	unsigned int totalSize = 0;
 
-	// Start with the size of the contents 
-	// (don't use seek as we don't know if the client still wants to write stuff)
-	totalSize += static_cast<unsigned int>(stream.str().length());
+	// Start with the size of the contents
+	totalSize += static_cast<unsigned int>(_buffer.getData().size());
 
 	if (!subChunks.empty())
 	{
@@ -86,8 +85,8 @@ void Lwo2Chunk::writeToStream(std::ostream& output)
 	}
 
 	// Write the direct contents of this chunk
-	std::string str = stream.str();
-	output.write(str.c_str(), str.length());
+	const auto& data = _buffer.getData();
+	output.write(data.data(), data.size());
 
 	// Write all subchunks
 	for (const Lwo2Chunk::Ptr& chunk : subChunks)
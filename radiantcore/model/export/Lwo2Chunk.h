@@ -3,7 +3,8 @@
 #include <string>
 #include <memory>
 #include <vector>
-#include <sstream>
+#include <ostream>
+#include <streambuf>
 
 namespace model
 {
@@ -28,6 +29,40 @@ private:
 	// The number of bytes used for the size info of this chunk
 	unsigned int _sizeDescriptorByteCount;
 
+	// Binary buffer behind the stream member. Unlike a stringstream it
+	// can report its size and contents without copying them.
+	class Buffer :
+		public std::streambuf
+	{
+	private:
+		std::vector<char> _data;
+
+	public:
+		const std::vector<char>& getData() const
+		{
+			return _data;
+		}
+
+	protected:
+		int_type overflow(int_type c) override
+		{
+			if (!traits_type::eq_int_type(c, traits_type::eof()))
+			{
+				_data.push_back(traits_type::to_char_type(c));
+			}
+
+			return traits_type::not_eof(c);
+		}
+
+		std::streamsize xsputn(const char* s, std::streamsize count) override
+		{
+			_data.insert(_data.end(), s, s + count);
+			return count;
+		}
+	};
+
+	Buffer _buffer;
+
 public:
 	std::string identifier; // the 4-byte ID
 
@@ -35,7 +70,7 @@ public:
 	std::vector<Lwo2Chunk::Ptr> subChunks;
 
 	// Stream binary data into here
-	std::stringstream stream;
+	std::ostream stream;
 
 	Lwo2Chunk(const std::string& identifier_, Type type);
 
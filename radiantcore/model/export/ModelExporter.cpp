@@ -10,9 +10,14 @@
 #include "os/fs.h"
 #include "entitylib.h"
 #include "registry/registry.h"
+#include <atomic>
+#include <functional>
+#include <future>
 #include <stdexcept>
 #include <fstream>
+#include <thread>
 
+#include "brush/BRepEvaluation.h"
 #include "PatchSurface.h"
 
 namespace model
@@ -21,6 +26,42 @@ namespace model
 namespace
 {
 
+// Below this number of nodes, starting the worker threads costs more than it saves
+constexpr std::size_t MIN_NODES_FOR_PARALLEL_EXPORT = 64;
+
+// Invokes the given function for each index in [0..count) using all available cores
+void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+{
+	std::atomic<std::size_t> nextIndex(0);
+
+	auto worker = [&]()
+	{
+		for (auto i = nextIndex++; i < count; i = nextIndex++)
+		{
+			function(i);
+		}
+	};
+
+	auto numWorkers = count < MIN_NODES_FOR_PARALLEL_EXPORT ? 1 :
+		std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+	std::vector<std::future<void>> workers;
+
+	for (std::size_t i = 1; i < numWorkers; ++i)
+	{
+		workers.emplace_back(std::async(std::launch::async, worker));
+	}
+
+	// The calling thread is processing its share too
+	worker();
+
+	// Wait for all workers, this is re-throwing any exceptions
+	for (auto& result : workers)
+	{
+		result.get();
+	}
+}
+
 // Adapter methods to convert brush vertices to MeshVertex type
 MeshVertex convertWindingVertex(const WindingVertex& in)
 {
@@ -120,8 +161,40 @@ void ModelExporter::processNodes()
 			Matrix4::getTranslation(-bounds.origin);
 	}
 
-	for (const scene::INodePtr& node : _nodes)
+	// The windings need to be up to date before they're read by the worker threads
+	brush::evaluateBRepsInSubgraphs(_nodes);
+
+	std::vector<NodeGeometry> geometry(_nodes.size());
+
+	// Updating the tesselation notifies the patch node, so this is done on this thread
+	for (std::size_t i = 0; i < _nodes.size(); ++i)
+	{
+		auto patch = Node_getIPatch(_nodes[i]);
+
+		if (patch != nullptr && isExportableMaterial(patch->getShader()))
+		{
+			geometry[i].patchMesh = patch->getTesselatedPatchMesh();
+		}
+	}
+
+	// Convert the brushes and patches to polygons on all cores, the nodes don't share any state
+	runInParallel(_nodes.size(), [&](std::size_t i)
+	{
+		if (Node_isBrush(_nodes[i]))
+		{
+			generateBrushGeometry(_nodes[i], geometry[i]);
+		}
+		else if (Node_isPatch(_nodes[i]))
+		{
+			generatePatchGeometry(_nodes[i], geometry[i]);
+		}
+	});
+
+	// Pass everything to the exporter in the original node order
+	for (std::size_t i = 0; i < _nodes.size(); ++i)
 	{
+		const auto& node = _nodes[i];
+
 		if (Node_isModel(node))
 		{
 			model::ModelNodePtr modelNode = Node_getModel(node);
@@ -141,13 +214,19 @@ void ModelExporter::processNodes()
 				}
 			}
 		}
-		else if (Node_isBrush(node))
+		else if (Node_isBrush(node) || Node_isPatch(node))
 		{
-			processBrush(node);
-		}
-		else if (Node_isPatch(node))
-		{
-			processPatch(node);
+			Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
+
+			for (const auto& [materialName, polys] : geometry[i].polygons)
+			{
+				_exporter->addPolygons(materialName, polys, exportTransform);
+			}
+
+			if (geometry[i].patchSurface)
+			{
+				_exporter->addSurface(*geometry[i].patchSurface, exportTransform);
+			}
 		}
 		else if (_exportLightsAsObjects && Node_getLightNode(node))
 		{
@@ -174,32 +253,26 @@ AABB ModelExporter::calculateModelBounds()
 	return bounds;
 }
 
-void ModelExporter::processPatch(const scene::INodePtr& node)
+void ModelExporter::generatePatchGeometry(const scene::INodePtr& node, NodeGeometry& geometry)
 {
 	IPatch* patch = Node_getIPatch(node);
 
-	if (patch == nullptr) return;
-
-	const std::string& materialName = patch->getShader();
-
-	if (!isExportableMaterial(materialName)) return;
-
-	PatchMesh mesh = patch->getTesselatedPatchMesh();
-    Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
+	// An empty mesh means that the material is not exported
+	if (patch == nullptr || geometry.patchMesh.vertices.empty()) return;
 
     // Convert the patch mesh to an indexed surface
-    PatchSurface surface(materialName, mesh);
-    _exporter->addSurface(surface, exportTransform);
+    geometry.patchSurface = std::make_unique<PatchSurface>(patch->getShader(), geometry.patchMesh);
+
+    // The mesh is not needed anymore
+    geometry.patchMesh = PatchMesh();
 }
 
-void ModelExporter::processBrush(const scene::INodePtr& node)
+void ModelExporter::generateBrushGeometry(const scene::INodePtr& node, NodeGeometry& geometry)
 {
 	IBrush* brush = Node_getIBrush(node);
 
 	if (brush == nullptr) return;
 
-	Matrix4 exportTransform = node->localToWorld().getPremultipliedBy(_centerTransform);
-
 	for (std::size_t b = 0; b < brush->getNumFaces(); ++b)
 	{
 		const IFace& face = brush->getFace(b);
@@ -230,7 +303,7 @@ void ModelExporter::processBrush(const scene::INodePtr& node)
 			polys.push_back(poly);
 		}
 
-		_exporter->addPolygons(materialName, polys, exportTransform);
+		geometry.polygons.emplace_back(materialName, std::move(polys));
 	}
 }
 
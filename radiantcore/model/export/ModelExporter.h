@@ -7,7 +7,9 @@
 #include "math/Matrix4.h"
 #include "math/Vector3.h"
 #include <map>
-#include <list>
+#include <memory>
+#include <vector>
+#include "PatchSurface.h"
 
 namespace model
 {
@@ -31,7 +33,7 @@ private:
 	// Whether lights should be exported too (as small diamond-shaped objects)
 	bool _exportLightsAsObjects;
 
-	std::list<scene::INodePtr> _nodes;
+	std::vector<scene::INodePtr> _nodes;
 
 	// The translation centering the objects
 	// is identity if _centerObjects is false
@@ -63,12 +65,24 @@ public:
 	const Matrix4& getCenterTransform();
 
 private:
+	// The exportable geometry of a single brush or patch, generated in parallel
+	struct NodeGeometry
+	{
+		// Brush polygons, grouped by material
+		std::vector<std::pair<std::string, std::vector<model::ModelPolygon>>> polygons;
+
+		// The tesselation is collected before the surface is generated
+		PatchMesh patchMesh;
+		std::unique_ptr<PatchSurface> patchSurface;
+	};
+
 	AABB calculateModelBounds();
 
 	bool isExportableMaterial(const std::string& materialName);
 
-	void processBrush(const scene::INodePtr& node);
-	void processPatch(const scene::INodePtr& node);
+	// These don't touch the nodes and are safe to be called from worker threads
+	void generateBrushGeometry(const scene::INodePtr& node, NodeGeometry& geometry);
+	void generatePatchGeometry(const scene::INodePtr& node, NodeGeometry& geometry);
 	void processLight(const scene::INodePtr& node);
 };
 
@@ -9,6 +9,7 @@
 #include "imodelsurface.h"
 
 #include "render.h"
+#include "render/VertexHashing.h"
 #include "math/Matrix4.h"
 #include "os/fs.h"
 #include "os/path.h"
@@ -31,6 +32,9 @@ protected:
 
 		// The indices connecting the vertices to triangles
 		IndexBuffer indices;
+
+		// Merges the similar vertices of the incoming polygons
+		render::VertexWelder<MeshVertex> welder;
 	};
 
 	typedef std::map<std::string, Surface> Surfaces;
@@ -97,8 +101,6 @@ public:
 		{
 			ModelPolygon poly = incoming.getPolygon(i);
 
-			unsigned int indexStart = static_cast<unsigned int>(surface.vertices.size());
-
 			poly.a.vertex = localToWorld.transformPoint(poly.a.vertex);
 			poly.b.vertex = localToWorld.transformPoint(poly.b.vertex);
 			poly.c.vertex = localToWorld.transformPoint(poly.c.vertex);
@@ -108,13 +110,9 @@ public:
 			poly.b.normal = invTranspTransform.transformPoint(poly.b.normal).getNormalised();
 			poly.c.normal = invTranspTransform.transformPoint(poly.c.normal).getNormalised();
 
-			surface.vertices.push_back(poly.a);
-			surface.vertices.push_back(poly.b);
-			surface.vertices.push_back(poly.c);
-
-			surface.indices.push_back(indexStart);
-			surface.indices.push_back(indexStart + 1);
-			surface.indices.push_back(indexStart + 2);
+			surface.indices.push_back(surface.welder.weld(surface.vertices, poly.a));
+			surface.indices.push_back(surface.welder.weld(surface.vertices, poly.b));
+			surface.indices.push_back(surface.welder.weld(surface.vertices, poly.c));
 		}
 	}
 
@@ -123,23 +121,19 @@ public:
 	{
 		Surface& surface = ensureSurface(materialName);
 
+		// Brush faces share their vertices with the adjacent faces,
+		// weld them instead of writing every corner of every triangle
 		for (const ModelPolygon& poly : polys)
 		{
-			unsigned int indexStart = static_cast<unsigned int>(surface.vertices.size());
-
 			ModelPolygon transformed(poly); // copy to transform
 
 			transformed.a.vertex = localToWorld.transformPoint(poly.a.vertex);
 			transformed.b.vertex = localToWorld.transformPoint(poly.b.vertex);
 			transformed.c.vertex = localToWorld.transformPoint(poly.c.vertex);
 
-			surface.vertices.push_back(transformed.a);
-			surface.vertices.push_back(transformed.b);
-			surface.vertices.push_back(transformed.c);
-
-			surface.indices.push_back(indexStart);
-			surface.indices.push_back(indexStart + 1);
-			surface.indices.push_back(indexStart + 2);
+			surface.indices.push_back(surface.welder.weld(surface.vertices, transformed.a));
+			surface.indices.push_back(surface.welder.weld(surface.vertices, transformed.b));
+			surface.indices.push_back(surface.welder.weld(surface.vertices, transformed.c));
 		}
 	}
 
@@ -1,6 +1,12 @@
 #include "FbxModelLoader.h"
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <istream>
+#include <string_view>
+#include <thread>
 
 #include "openfbx/ofbx.h"
 
@@ -22,6 +28,52 @@ FbxModelLoader::FbxModelLoader() :
 namespace
 {
 
+// The number of files whose converted surfaces are kept around
+constexpr std::size_t MAX_CACHED_FILES = 16;
+
+// Invokes the given function for each index in [0..count) using all available cores
+void runInParallel(std::size_t count, const std::function<void(std::size_t)>& function)
+{
+    std::atomic<std::size_t> nextIndex(0);
+
+    auto worker = [&]()
+    {
+        for (auto i = nextIndex++; i < count; i = nextIndex++)
+        {
+            function(i);
+        }
+    };
+
+    auto numWorkers = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), count);
+
+    std::vector<std::future<void>> workers;
+
+    for (std::size_t i = 1; i < numWorkers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, worker));
+    }
+
+    // The calling thread is processing its share too
+    worker();
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& result : workers)
+    {
+        result.get();
+    }
+}
+
+// Job processor passed to ofbx, which is using it to parse the geometries
+void ProcessJobsInParallel(ofbx::JobFunction function, void*, void* data, ofbx::u32 size, ofbx::u32 count)
+{
+    auto jobs = static_cast<ofbx::u8*>(data);
+
+    runInParallel(count, [&](std::size_t i)
+    {
+        function(jobs + i * size);
+    });
+}
+
 inline MeshVertex ConstructMeshVertex(const ofbx::Geometry& geometry, int index)
 {
     auto vertices = geometry.getVertices();
@@ -37,106 +89,192 @@ inline MeshVertex ConstructMeshVertex(const ofbx::Geometry& geometry, int index)
     );
 }
 
-}
-
-IModelPtr FbxModelLoader::loadModelFromPath(const std::string& path)
+// Converts the triangles of the given mesh into one surface per material
+std::vector<FbxSurface> ConvertMesh(const ofbx::Mesh& mesh)
 {
-    // Open an ArchiveFile to load
-    auto file = path_is_absolute(path.c_str()) ?
-        GlobalFileSystem().openFileInAbsolutePath(path) :
-        GlobalFileSystem().openFile(path);
+    std::vector<FbxSurface> surfaces;
 
-    if (!file)
+    auto geometry = mesh.getGeometry();
+
+    // Assign the materials for each surface
+    for (int m = 0; m < mesh.getMaterialCount(); ++m)
     {
-        rError() << "Failed to load model " << path << std::endl;
-        return IModelPtr();
+        auto material = mesh.getMaterial(m);
+        surfaces.emplace_back().setMaterial(material->name);
+    }
+
+    if (surfaces.empty())
+    {
+        surfaces.emplace_back().setMaterial("Material"); // create at least one surface
     }
 
-    // Load the model data from the given stream
-    archive::ScopedArchiveBuffer data(*file);
+    if (geometry == nullptr) return surfaces;
+
+    auto materials = geometry->getMaterials();
+    auto faceIndices = geometry->getFaceIndices();
+    auto numTriangles = static_cast<std::size_t>(geometry->getIndexCount() / 3);
+
+    // Material index is assigned per triangle, put into first material by default
+    auto getSurfaceIndex = [&](std::size_t polyIndex)
+    {
+        auto materialIndex = materials ? static_cast<std::size_t>(materials[polyIndex]) : 0;
+        return materialIndex < surfaces.size() ? materialIndex : 0;
+    };
+
+    // Count the triangles per surface to allocate the buffers only once
+    std::vector<std::size_t> trianglesPerSurface(surfaces.size(), 0);
+
+    for (std::size_t polyIndex = 0; polyIndex < numTriangles; ++polyIndex)
+    {
+        ++trianglesPerSurface[getSurfaceIndex(polyIndex)];
+    }
+
+    for (std::size_t s = 0; s < surfaces.size(); ++s)
+    {
+        surfaces[s].reserve(trianglesPerSurface[s], static_cast<std::size_t>(geometry->getVertexCount()));
+    }
+
+    for (std::size_t polyIndex = 0; polyIndex < numTriangles; ++polyIndex)
+    {
+        auto i = polyIndex * 3;
 
-    auto scene = ofbx::load(static_cast<ofbx::u8*>(data.buffer),
-        static_cast<int>(data.length), (ofbx::u64)ofbx::LoadFlags::TRIANGULATE);
+        // Reverse the poly indices to get the CCW order
+        auto indexA = (faceIndices[i + 2] * -1) - 1; // last index is negative and 1-based
+        auto indexB = faceIndices[i + 1];
+        auto indexC = faceIndices[i + 0];
+
+        auto& surface = surfaces[getSurfaceIndex(polyIndex)];
+
+        surface.addVertex(ConstructMeshVertex(*geometry, indexA));
+        surface.addVertex(ConstructMeshVertex(*geometry, indexB));
+        surface.addVertex(ConstructMeshVertex(*geometry, indexC));
+    }
+
+    return surfaces;
+}
+
+}
+
+FbxModelLoader::ConvertedSurfaces FbxModelLoader::ConvertScene(const unsigned char* data, std::size_t length)
+{
+    auto scene = ofbx::load(static_cast<const ofbx::u8*>(data),
+        static_cast<int>(length), (ofbx::u64)ofbx::LoadFlags::TRIANGULATE, ProcessJobsInParallel);
 
     if (!scene)
     {
-        rError() << "Failed to load FBX model " << path << std::endl;
-        return IModelPtr();
+        return ConvertedSurfaces();
     }
 
-    std::vector<FbxSurface> surfaces;
+    // The meshes don't share any data, convert them on all cores
+    std::vector<std::vector<FbxSurface>> meshSurfaces(static_cast<std::size_t>(scene->getMeshCount()));
 
-    for (int meshIndex = 0; meshIndex < scene->getMeshCount(); ++meshIndex)
+    runInParallel(meshSurfaces.size(), [&](std::size_t meshIndex)
     {
-        auto mesh = scene->getMesh(meshIndex);
-        auto geometry = mesh->getGeometry();
+        meshSurfaces[meshIndex] = ConvertMesh(*scene->getMesh(static_cast<int>(meshIndex)));
+    });
+
+    scene->destroy();
 
-        // Assign the materials for each surface
-        for (int m = 0; m < mesh->getMaterialCount(); ++m)
+    auto surfaces = std::make_shared<std::vector<ConvertedSurface>>();
+
+    for (auto& fbxSurfaces : meshSurfaces)
+    {
+        for (auto& fbxSurface : fbxSurfaces)
         {
-            auto material = mesh->getMaterial(m);
-            surfaces.emplace_back().setMaterial(material->name);
+            // Skip materials without any triangles assigned
+            if (fbxSurface.getIndexArray().empty()) continue;
+
+            surfaces->emplace_back(ConvertedSurface
+            {
+                fbxSurface.getMaterial(),
+                std::move(fbxSurface.getVertexArray()),
+                std::move(fbxSurface.getIndexArray())
+            });
         }
+    }
+
+    return surfaces;
+}
+
+FbxModelLoader::ConvertedSurfaces FbxModelLoader::findCachedSurfaces(std::size_t contentHash, std::size_t contentSize)
+{
+    std::lock_guard<std::mutex> lock(_cacheLock);
 
-        if (surfaces.empty())
+    for (auto entry = _cache.begin(); entry != _cache.end(); ++entry)
+    {
+        if (entry->contentHash == contentHash && entry->contentSize == contentSize)
         {
-            surfaces.emplace_back().setMaterial("Material"); // create at least one surface
+            // Move the entry to the front
+            _cache.splice(_cache.begin(), _cache, entry);
+            return _cache.front().surfaces;
         }
+    }
 
-        auto materials = geometry->getMaterials();
-        auto faceIndices = geometry->getFaceIndices();
+    return ConvertedSurfaces();
+}
 
-        for (int i = 0; i < geometry->getIndexCount(); i += 3)
-        {
-            // Material index is assigned per triangle
-            auto polyIndex = i / 3;
-            auto materialIndex = materials ? materials[polyIndex] : 0; // put into first material by default
+void FbxModelLoader::storeCachedSurfaces(std::size_t contentHash, std::size_t contentSize, const ConvertedSurfaces& surfaces)
+{
+    std::lock_guard<std::mutex> lock(_cacheLock);
 
-            // Reverse the poly indices to get the CCW order
-            auto indexA = (faceIndices[i + 2] * -1) - 1; // last index is negative and 1-based
-            auto indexB = faceIndices[i + 1];
-            auto indexC = faceIndices[i + 0];
+    _cache.push_front(CacheEntry{ contentHash, contentSize, surfaces });
 
-            auto& surface = surfaces[materialIndex];
+    if (_cache.size() > MAX_CACHED_FILES)
+    {
+        _cache.pop_back();
+    }
+}
 
-            surface.addVertex(ConstructMeshVertex(*geometry, indexA));
-            surface.addVertex(ConstructMeshVertex(*geometry, indexB));
-            surface.addVertex(ConstructMeshVertex(*geometry, indexC));
-        }
+IModelPtr FbxModelLoader::loadModelFromPath(const std::string& path)
+{
+    // Open an ArchiveFile to load
+    auto file = path_is_absolute(path.c_str()) ?
+        GlobalFileSystem().openFileInAbsolutePath(path) :
+        GlobalFileSystem().openFile(path);
+
+    if (!file)
+    {
+        rError() << "Failed to load model " << path << std::endl;
+        return IModelPtr();
+    }
+
+    ConvertedSurfaces surfaces;
+
+    {
+        // Load the model data from the given stream
+        archive::ScopedArchiveBuffer data(*file);
+
+        auto contentHash = std::hash<std::string_view>()(
+            std::string_view(reinterpret_cast<const char*>(data.buffer), data.length));
+
+        surfaces = findCachedSurfaces(contentHash, data.length);
 
-        // Apply the global transformation matrix
-        auto t = geometry->getGlobalTransform();
-#if 0
-        auto transform = Matrix4::byColumns(
-            t.m[0], t.m[1], t.m[2], t.m[3],
-            t.m[4], t.m[5], t.m[6], t.m[7],
-            t.m[8], t.m[9], t.m[10], t.m[11],
-            t.m[12], t.m[13], t.m[14], t.m[15]
-        );
-#endif
-        // "Objects in the FBX SDK are always created in the right handed, Y-Up axis system"
-        auto transform = Matrix4::getIdentity();
-
-        if (scene->getGlobalSettings()->UpAxis == ofbx::UpVector_AxisY)
+        if (!surfaces)
         {
-            transform = transform.getPremultipliedBy(Matrix4::getRotationForEulerXYZDegrees(Vector3(90, 0, 0)));
+            surfaces = ConvertScene(data.buffer, data.length);
+
+            if (!surfaces)
+            {
+                rError() << "Failed to load FBX model " << path << std::endl;
+                return IModelPtr();
+            }
+
+            storeCachedSurfaces(contentHash, data.length, surfaces);
         }
     }
 
-    // Construct a set of static surfaces from the FBX surfaces, destroying them on the go
+    // Construct a set of static surfaces from the converted ones, these are shared with the cache
     std::vector<StaticModelSurfacePtr> staticSurfaces;
 
-    for (auto& fbxSurface : surfaces)
+    for (const auto& surface : *surfaces)
     {
         auto& staticSurface = staticSurfaces.emplace_back(std::make_shared<StaticModelSurface>(
-            std::move(fbxSurface.getVertexArray()), std::move(fbxSurface.getIndexArray())));
+            std::vector<MeshVertex>(surface.vertices), std::vector<unsigned int>(surface.indices)));
 
-        staticSurface->setDefaultMaterial(fbxSurface.getMaterial());
+        staticSurface->setDefaultMaterial(surface.material);
         staticSurface->setActiveMaterial(staticSurface->getDefaultMaterial());
     }
 
-    surfaces.clear();
-
     auto staticModel = std::make_shared<StaticModel>(staticSurfaces);
 
     // Set the filename
@@ -1,5 +1,11 @@
 #pragma once
 
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "render/MeshVertex.h"
 #include "ModelImporterBase.h"
 
 namespace model
@@ -8,11 +14,42 @@ namespace model
 class FbxModelLoader :
     public ModelImporterBase
 {
+private:
+    struct ConvertedSurface
+    {
+        std::string material;
+        std::vector<MeshVertex> vertices;
+        std::vector<unsigned int> indices;
+    };
+
+    using ConvertedSurfaces = std::shared_ptr<const std::vector<ConvertedSurface>>;
+
+    struct CacheEntry
+    {
+        std::size_t contentHash;
+        std::size_t contentSize;
+        ConvertedSurfaces surfaces;
+    };
+
+    // The surfaces of the most recently loaded files, keyed by a hash of the
+    // file contents, such that reloading or re-using an unchanged file (also
+    // under a different name) doesn't need to parse it again. The most
+    // recently used entry is at the front.
+    std::list<CacheEntry> _cache;
+    std::mutex _cacheLock;
+
 public:
     FbxModelLoader();
 
     // Load the given model from the path, VFS or absolute
     IModelPtr loadModelFromPath(const std::string& name) override;
+
+private:
+    ConvertedSurfaces findCachedSurfaces(std::size_t contentHash, std::size_t contentSize);
+    void storeCachedSurfaces(std::size_t contentHash, std::size_t contentSize, const ConvertedSurfaces& surfaces);
+
+    // Parses the given FBX data and converts its meshes, returns an empty pointer on failure
+    static ConvertedSurfaces ConvertScene(const unsigned char* data, std::size_t length);
 };
 
 } // namespace model
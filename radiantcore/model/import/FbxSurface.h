@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -41,6 +42,17 @@ public:
         material = newMaterial;
     }
 
+	// Prepares the buffers for the given number of triangles, the number
+	// of vertices is limited to the given value
+	void reserve(std::size_t numTriangles, std::size_t maxVertices)
+	{
+		auto numVertices = std::min(numTriangles * 3, maxVertices);
+
+		indices.reserve(indices.size() + numTriangles * 3);
+		vertices.reserve(vertices.size() + numVertices);
+		vertexIndices.reserve(vertexIndices.size() + numVertices);
+	}
+
 	void addVertex(const MeshVertex& vertex)
 	{
 		// Try to look up an existing vertex or add a new index
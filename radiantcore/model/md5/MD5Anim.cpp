@@ -1,16 +1,191 @@
 #include "MD5Anim.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include "itextstream.h"
 #include "string/convert.h"
 
 namespace md5
 {
 
+namespace
+{
+	// The number of frames per animation keeping their joint keys cached
+	const std::size_t MAX_CACHED_FRAMES = 32;
+
+	const float MAX_QUANTISED_VALUE = std::numeric_limits<std::uint16_t>::max();
+
+	// Calculates the fourth component of a unit quaternion from the other three
+	double calculateQuaternionW(const Vector3& rotation)
+	{
+		auto w = -sqrt(1.0 - rotation.getLengthSquared());
+		return isNaN(w) ? 0 : w;
+	}
+}
+
 MD5Anim::MD5Anim() :
 	_frameRate(0),
-	_numAnimatedComponents(0)
+	_numAnimatedComponents(0),
+	_numFrames(0),
+	_numStoredComponents(0)
 {}
 
+IMD5Anim::FrameKeys MD5Anim::getFrameKeys(std::size_t index) const
+{
+	FrameKeys keys(_numAnimatedComponents);
+
+	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
+	{
+		keys[i] = getFrameValue(index, i);
+	}
+
+	return keys;
+}
+
+IMD5Anim::JointKeysPtr MD5Anim::getFrameJointKeys(std::size_t index) const
+{
+	std::lock_guard<std::mutex> lock(_jointKeyCacheLock);
+
+	auto found = _jointKeyCacheIndex.find(index);
+
+	if (found != _jointKeyCacheIndex.end())
+	{
+		// Move the frame to the front of the list
+		_jointKeyCache.splice(_jointKeyCache.begin(), _jointKeyCache, found->second);
+		return found->second->second;
+	}
+
+	auto keys = calculateJointKeys(index);
+
+	_jointKeyCache.emplace_front(index, keys);
+	_jointKeyCacheIndex[index] = _jointKeyCache.begin();
+
+	// Drop the least recently used frame
+	if (_jointKeyCache.size() > MAX_CACHED_FRAMES)
+	{
+		_jointKeyCacheIndex.erase(_jointKeyCache.back().first);
+		_jointKeyCache.pop_back();
+	}
+
+	return keys;
+}
+
+float MD5Anim::getFrameValue(std::size_t frame, std::size_t component) const
+{
+	const auto& range = _components[component];
+
+	if (range.slot == NoSlot)
+	{
+		return range.min;
+	}
+
+	return range.min + _frameData[frame * _numStoredComponents + range.slot] * range.scale;
+}
+
+IMD5Anim::JointKeysPtr MD5Anim::calculateJointKeys(std::size_t frame) const
+{
+	// Start with the base frame, and apply the animated components on top of it
+	auto keys = std::make_shared<JointKeys>(_baseFrame);
+
+	for (const auto& joint : _joints)
+	{
+		auto& jointKey = (*keys)[joint.id];
+
+		// The joint.firstKey member holds the offset into the frame data array
+		std::size_t key = joint.firstKey;
+
+		if (joint.animComponents & Joint::X)
+		{
+			jointKey.origin.x() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & Joint::Y)
+		{
+			jointKey.origin.y() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & Joint::Z)
+		{
+			jointKey.origin.z() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & Joint::YAW)
+		{
+			jointKey.orientation.x() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & Joint::PITCH)
+		{
+			jointKey.orientation.y() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & Joint::ROLL)
+		{
+			jointKey.orientation.z() = getFrameValue(frame, key++);
+		}
+
+		if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
+		{
+			jointKey.orientation.w() = calculateQuaternionW(jointKey.orientation.getVector3());
+		}
+	}
+
+	return keys;
+}
+
+void MD5Anim::compressFrames(const std::vector<float>& frameValues)
+{
+	_components.resize(_numAnimatedComponents);
+	_numStoredComponents = 0;
+
+	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
+	{
+		auto& range = _components[i];
+
+		auto min = std::numeric_limits<float>::max();
+		auto max = std::numeric_limits<float>::lowest();
+
+		for (std::size_t frame = 0; frame < _numFrames; ++frame)
+		{
+			auto value = frameValues[frame * _numAnimatedComponents + i];
+
+			min = std::min(min, value);
+			max = std::max(max, value);
+		}
+
+		if (_numFrames == 0 || max <= min)
+		{
+			// Constant components are stored just once
+			range.min = _numFrames == 0 ? 0 : min;
+			range.scale = 0;
+			range.slot = NoSlot;
+			continue;
+		}
+
+		range.min = min;
+		range.scale = (max - min) / MAX_QUANTISED_VALUE;
+		range.slot = _numStoredComponents++;
+	}
+
+	_frameData.resize(_numFrames * _numStoredComponents);
+
+	for (std::size_t frame = 0; frame < _numFrames; ++frame)
+	{
+		for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
+		{
+			const auto& range = _components[i];
+
+			if (range.slot == NoSlot) continue;
+
+			auto quantised = std::round((frameValues[frame * _numAnimatedComponents + i] - range.min) / range.scale);
+
+			_frameData[frame * _numStoredComponents + range.slot] =
+				static_cast<std::uint16_t>(std::clamp(quantised, 0.0f, MAX_QUANTISED_VALUE));
+		}
+	}
+}
+
 void MD5Anim::parseJointHierarchy(parser::DefTokeniser& tok)
 {
 	tok.assertNextToken("hierarchy");
@@ -50,7 +225,7 @@ void MD5Anim::parseFrameBounds(parser::DefTokeniser& tok)
 	tok.assertNextToken("bounds");
 	tok.assertNextToken("{");
 		
-	for (std::size_t i = 0; i < _frames.size(); ++i)
+	for (std::size_t i = 0; i < _numFrames; ++i)
 	{
 		tok.assertNextToken("(");
 
@@ -95,15 +270,7 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 		rawRotation.z() = string::convert<float>(tok.nextToken());
 
 		// Calculate the fourth component of the quaternion
-		auto lSq = rawRotation.getLengthSquared();
-        auto w = -sqrt(1.0 - lSq);
-
-	    if (isNaN(w))
-		{
-	    	w = 0;
-	    }
-
-		_baseFrame[i].orientation = Quaternion(rawRotation, w);
+		_baseFrame[i].orientation = Quaternion(rawRotation, calculateQuaternionW(rawRotation));
 
 		tok.assertNextToken(")");
 	}
@@ -111,7 +278,7 @@ void MD5Anim::parseBaseFrame(parser::DefTokeniser& tok)
 	tok.assertNextToken("}");
 }
 
-void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
+void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok, std::vector<float>& frameValues)
 {
 	tok.assertNextToken("frame");
 
@@ -121,13 +288,12 @@ void MD5Anim::parseFrame(std::size_t frame, parser::DefTokeniser& tok)
 
 	tok.assertNextToken("{");
 
-	// Reserve space for the floats
-	_frames[parsedFrameNum].resize(_numAnimatedComponents);
-
 	// Each frame block has <numAnimatedComponents> float values
+	auto values = frameValues.begin() + frame * _numAnimatedComponents;
+
 	for (std::size_t i = 0; i < _numAnimatedComponents; ++i)
 	{
-		_frames[parsedFrameNum][i] = string::convert<float>(tok.nextToken());
+		values[i] = string::convert<float>(tok.nextToken());
 	}
 
 	tok.assertNextToken("}");
@@ -141,6 +307,9 @@ void MD5Anim::parseFromStream(std::istream& stream)
 
 void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 {
+	// The frames are parsed at full precision and compressed afterwards
+	std::vector<float> frameValues;
+
 	try
 	{
 		tok.assertNextToken("MD5Version");
@@ -166,7 +335,7 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		_joints.resize(numJoints);
 		_bounds.resize(numFrames);
 		_baseFrame.resize(numJoints);
-		_frames.resize(numFrames);
+		_numFrames = numFrames;
 
 		tok.assertNextToken("frameRate");
 		_frameRate = string::convert<int>(tok.nextToken());
@@ -174,6 +343,8 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		tok.assertNextToken("numAnimatedComponents");
 		_numAnimatedComponents = string::convert<std::size_t>(tok.nextToken());
 
+		frameValues.resize(_numFrames * _numAnimatedComponents);
+
 		// Parse hierarchy block
 		parseJointHierarchy(tok);
 		
@@ -184,15 +355,17 @@ void MD5Anim::parseFromTokens(parser::DefTokeniser& tok)
 		parseBaseFrame(tok);
 
 		// Parse each actual frame
-		for (std::size_t i = 0; i < _frames.size(); ++i)
+		for (std::size_t i = 0; i < _numFrames; ++i)
 		{
-			parseFrame(i, tok);
+			parseFrame(i, tok, frameValues);
 		}
 	}
 	catch (parser::ParseException& ex)
 	{
 		rError() << "Error parsing MD5 Animation: " << ex.what() << std::endl;
 	}
+
+	compressFrames(frameValues);
 }
 
 } // namespace
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "imd5anim.h"
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 #include "parser/DefTokeniser.h"
 #include "math/AABB.h"
@@ -31,8 +35,35 @@ private:
 
 	Keys _baseFrame;
 
-	// Each frame has <numAnimatedComponents> float values
-	std::vector<FrameKeys> _frames;
+	std::size_t _numFrames;
+
+	// The value range of a single animated component, across all frames
+	struct ComponentRange
+	{
+		float min;
+		float scale;
+
+		// The offset into the values of a quantised frame, or NoSlot if the
+		// component has the same value in every frame and is not stored per frame
+		std::size_t slot;
+	};
+
+	static constexpr std::size_t NoSlot = static_cast<std::size_t>(-1);
+
+	std::vector<ComponentRange> _components;
+
+	// The number of components stored per frame
+	std::size_t _numStoredComponents;
+
+	// The non-constant components of all frames, each one quantised to 16 bits
+	// within the range of its component. Frame n starts at n * _numStoredComponents.
+	std::vector<std::uint16_t> _frameData;
+
+	// The most recently used joint keys, the front element being the newest one
+	typedef std::pair<std::size_t, JointKeysPtr> CachedFrame;
+	mutable std::list<CachedFrame> _jointKeyCache;
+	mutable std::unordered_map<std::size_t, std::list<CachedFrame>::iterator> _jointKeyCacheIndex;
+	mutable std::mutex _jointKeyCacheLock;
 
 public:
 	MD5Anim();
@@ -64,22 +95,27 @@ public:
 
 	std::size_t getNumFrames() const
 	{
-		return _frames.size();
+		return _numFrames;
 	}
 
-	const FrameKeys& getFrameKeys(std::size_t index) const
-	{
-		return _frames[index];
-	}
+	FrameKeys getFrameKeys(std::size_t index) const;
+
+	JointKeysPtr getFrameJointKeys(std::size_t index) const;
 
 	void parseFromStream(std::istream& stream);
 
 private:
+	float getFrameValue(std::size_t frame, std::size_t component) const;
+	JointKeysPtr calculateJointKeys(std::size_t frame) const;
+
+	// Determines the component ranges and quantises the given frame values
+	void compressFrames(const std::vector<float>& frameValues);
+
 	void parseFromTokens(parser::DefTokeniser& tok);
 	void parseJointHierarchy(parser::DefTokeniser& tok);
 	void parseFrameBounds(parser::DefTokeniser& tok);
 	void parseBaseFrame(parser::DefTokeniser& tok);
-	void parseFrame(std::size_t frame, parser::DefTokeniser& tok);
+	void parseFrame(std::size_t frame, parser::DefTokeniser& tok, std::vector<float>& frameValues);
 };
 typedef std::shared_ptr<MD5Anim> MD5AnimPtr;
 
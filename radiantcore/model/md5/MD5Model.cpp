@@ -303,6 +303,9 @@ void MD5Model::setAnim(const IMD5AnimPtr& anim)
 {
 	_anim = anim;
 
+	// The surfaces need to be re-skinned on the next update, even at the same time
+	_skeleton.invalidatePose();
+
 	if (!_anim)
 	{
         for (const auto& surface : _surfaces)
@@ -321,8 +324,8 @@ void MD5Model::updateAnim(std::size_t time)
 {
 	if (!_anim) return; // nothing to do
 
-	// Update our joint hierarchy first
-	_skeleton.update(_anim, time);
+	// Update our joint hierarchy first, nothing to do if the pose didn't change
+	if (!_skeleton.update(_anim, time)) return;
 
     for (const auto& surface : _surfaces)
 	{
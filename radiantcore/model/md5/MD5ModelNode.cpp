@@ -3,6 +3,7 @@
 #include "ivolumetest.h"
 #include "ishaders.h"
 #include "iscenegraph.h"
+#include "iscenestatistics.h"
 
 namespace md5
 {
@@ -121,6 +122,12 @@ void MD5ModelNode::skinChanged(const std::string& newSkinName)
     // Applying the skin might trigger onModelShadersChanged()
     _model->applySkin(GlobalModelSkinCache().findSkin(_skin));
 
+    // The skin is listed in the scene statistics, as are the remapped materials
+    if (inScene())
+    {
+        GlobalSceneStatistics().queueUpdate(getSelf());
+    }
+
     // Refresh the scene
     GlobalSceneGraph().sceneChanged();
 }
@@ -65,9 +65,13 @@ namespace
 	}
 }
 
-void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
+bool MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 {
-	_anim = anim;
+	if (anim != _anim)
+	{
+		_anim = anim;
+		_poseIsValid = false;
+	}
 
 	// Update the joint positions, recursively, starting from the first
 	// Only root nodes need to be processed, the children are reached through them
@@ -91,81 +95,45 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 	std::size_t curFrame = static_cast<std::size_t>(std::floor(frameTime)) % _anim->getNumFrames();
 	std::size_t nextFrame = curFrame == _anim->getNumFrames() -1 ? curFrame : (curFrame + 1) % _anim->getNumFrames();
 
-	// Apply the current frame keys to the base frame
-	for (std::size_t i = 0; i < numJoints; ++i)
+	// The pose is fully defined by the two frames and their weighting
+	if (_poseIsValid && curFrame == _poseFrame && nextFrame == _poseNextFrame && nextFrameFrac == _poseFraction)
 	{
-		const Joint& joint = _anim->getJoint(i);
-		const IMD5Anim::Key& baseKey = _anim->getBaseFrameKey(joint.id);
-
-		// Apply base frame
-		_skeleton[i].origin = baseKey.origin;
-		_skeleton[i].orientation = baseKey.orientation;
-		
-		// Apply actual frame data
-		const IMD5Anim::FrameKeys& cur = _anim->getFrameKeys(curFrame);
-		const IMD5Anim::FrameKeys& next = _anim->getFrameKeys(nextFrame);
-
-		// The joint.firstKey member holds the offset into the frame data array
-		std::size_t key = joint.firstKey;
+		return false;
+	}
 
-		// Shortcuts for handling the rotations
-		Quaternion& orientation = _skeleton[i].orientation;
-		Quaternion nextOrientation = baseKey.orientation;
+	_poseIsValid = true;
+	_poseFrame = curFrame;
+	_poseNextFrame = nextFrame;
+	_poseFraction = nextFrameFrac;
 
-		// Animate each vector component, interpolating values in between frames
+	// The joint keys of both frames are shared with everyone else playing this anim
+	auto cur = _anim->getFrameJointKeys(curFrame);
+	auto next = _anim->getFrameJointKeys(nextFrame);
 
-		if (joint.animComponents & Joint::X)
-		{
-			_skeleton[i].origin.x() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
-		}
-
-		if (joint.animComponents & Joint::Y)
-		{
-			_skeleton[i].origin.y() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
-		}
+	// Interpolate the keys of each joint in between frames
+	for (std::size_t i = 0; i < numJoints; ++i)
+	{
+		const Joint& joint = _anim->getJoint(i);
 
-		if (joint.animComponents & Joint::Z)
-		{
-			_skeleton[i].origin.z() = cur[key]*curFrameFrac + next[key]*nextFrameFrac;
-			key++;
-		}
+		const IMD5Anim::Key& curKey = (*cur)[joint.id];
+		const IMD5Anim::Key& nextKey = (*next)[joint.id];
 
-		if (joint.animComponents & Joint::YAW)
+		if (joint.animComponents & (Joint::X | Joint::Y | Joint::Z))
 		{
-			orientation.x() = cur[key];
-			nextOrientation.x() = next[key];
-			key++;
+			_skeleton[i].origin = curKey.origin * curFrameFrac + nextKey.origin * nextFrameFrac;
 		}
-
-		if (joint.animComponents & Joint::PITCH)
+		else
 		{
-			orientation.y() = cur[key];
-			nextOrientation.y() = next[key];
-			key++;
+			_skeleton[i].origin = curKey.origin;
 		}
 
-		if (joint.animComponents & Joint::ROLL)
+		if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
 		{
-			orientation.z() = cur[key];
-			nextOrientation.z() = next[key];
-			key++;
+			_skeleton[i].orientation = slerp(curKey.orientation, nextKey.orientation, nextFrameFrac).getNormalised();
 		}
-
-		if (joint.animComponents & (Joint::YAW | Joint::PITCH | Joint::ROLL))
+		else
 		{
-			auto lSq = orientation.getVector3().getLengthSquared();
-            auto w = -sqrt(1.0 - lSq);
-
-			orientation.w() = isNaN(w) ? 0 : w;
-
-			lSq = nextOrientation.getVector3().getLengthSquared();
-			w = -sqrt(1.0f - lSq);
-
-			nextOrientation.w() = isNaN(w) ? 0 : w;
-
-			orientation = slerp(orientation, nextOrientation, nextFrameFrac).getNormalised();
+			_skeleton[i].orientation = curKey.orientation;
 		}
 	}
 
@@ -178,6 +146,15 @@ void MD5Skeleton::update(const IMD5AnimPtr& anim, std::size_t time)
 			updateJointRecursively(i);
 		}
 	}
+
+	_transforms.resize(numJoints);
+
+	for (std::size_t i = 0; i < numJoints; ++i)
+	{
+		_transforms[i].set(_skeleton[i]);
+	}
+
+	return true;
 }
 
 void MD5Skeleton::updateJointRecursively(std::size_t jointId)
@@ -6,6 +6,50 @@
 namespace md5
 {
 
+/**
+ * The rotation matrix and the translation of an animated joint, such that
+ * a point in joint space can be transformed without any quaternion maths.
+ */
+struct JointTransform
+{
+	double m[9]; // row-major rotation
+	Vector3 origin;
+
+	void set(const IMD5Anim::Key& key)
+	{
+		const auto& q = key.orientation;
+
+		// Same terms as used by Quaternion::transformPoint, which is not assuming a unit quaternion
+		double xx = q.x() * q.x();
+		double yy = q.y() * q.y();
+		double zz = q.z() * q.z();
+		double ww = q.w() * q.w();
+
+		double xy2 = q.x() * q.y() * 2;
+		double xz2 = q.x() * q.z() * 2;
+		double xw2 = q.x() * q.w() * 2;
+		double yz2 = q.y() * q.z() * 2;
+		double yw2 = q.y() * q.w() * 2;
+		double zw2 = q.z() * q.w() * 2;
+
+		m[0] = ww + xx - yy - zz; m[1] = xy2 - zw2;         m[2] = xz2 + yw2;
+		m[3] = xy2 + zw2;         m[4] = ww - xx + yy - zz; m[5] = yz2 - xw2;
+		m[6] = xz2 - yw2;         m[7] = yz2 + xw2;         m[8] = ww - xx - yy + zz;
+
+		origin = key.origin;
+	}
+
+	// Returns the given point, rotated and translated into model space
+	Vector3 transformPoint(const Vector3& p) const
+	{
+		return Vector3(
+			m[0] * p.x() + m[1] * p.y() + m[2] * p.z() + origin.x(),
+			m[3] * p.x() + m[4] * p.y() + m[5] * p.z() + origin.y(),
+			m[6] * p.x() + m[7] * p.y() + m[8] * p.z() + origin.z()
+		);
+	}
+};
+
 /**
  * This object represents a joint hierarchy as used
  * by animated MD5 models. At any point in time
@@ -20,9 +64,25 @@ protected:
 	// The current animation, needed to get joint information etc.
 	IMD5AnimPtr _anim;
 
+	// The joint keys converted to matrices, calculated once per update
+	std::vector<JointTransform> _transforms;
+
+	// The frames and the interpolation factor of the current pose
+	bool _poseIsValid = false;
+	std::size_t _poseFrame = 0;
+	std::size_t _poseNextFrame = 0;
+	float _poseFraction = 0;
+
 public:
-	// Update the skeleton to match the given animation at the given time
-	void update(const IMD5AnimPtr& anim, std::size_t time);
+	// Update the skeleton to match the given animation at the given time.
+	// Returns false if the skeleton is already in the pose of the given time.
+	bool update(const IMD5AnimPtr& anim, std::size_t time);
+
+	// Forces the next update() to calculate the pose again
+	void invalidatePose()
+	{
+		_poseIsValid = false;
+	}
 
 	std::size_t size() const
 	{
@@ -34,6 +94,11 @@ public:
 		return _skeleton[jointIndex];
 	}
 
+	const JointTransform& getTransform(std::size_t jointIndex) const
+	{
+		return _transforms[jointIndex];
+	}
+
 	const Joint& getJoint(std::size_t index) const
 	{
 		return _anim->getJoint(index);
@@ -235,12 +235,9 @@ void MD5Surface::updateToSkeleton(const MD5Skeleton& skeleton)
 
 		for (std::size_t k = 0; k != vert.weight_count; ++k)
 		{
-			MD5Weight& weight = _mesh->weights[vert.weight_index + k];
-			const IMD5Anim::Key& key = skeleton.getKey(weight.joint);
-			//const Joint& joint = skeleton.getJoint(weight.joint);
+			const MD5Weight& weight = _mesh->weights[vert.weight_index + k];
 
-			Vector3 rotatedPoint = key.orientation.transformPoint(weight.v);
-			skinned += (rotatedPoint + key.origin) * weight.t;
+			skinned += skeleton.getTransform(weight.joint).transformPoint(weight.v) * weight.t;
 		}
 
 		_vertices[j].vertex = skinned;
@@ -25,7 +25,7 @@ namespace
 	}
 
     // Convert byte pointers to colour vector
-    inline Vector4 getColourVector(unsigned char* array)
+    inline Vector4 getColourVector(const unsigned char* array)
     {
         if (array)
         {
@@ -210,47 +210,45 @@ StaticModelSurfacePtr PicoModelLoader::CreateSurface(picoSurface_t* picoSurface,
     PicoFixSurfaceNormals(picoSurface);
 
     // Convert the pico vertex data to the types we need to construct a StaticModelSurface
+    auto numVertices = static_cast<std::size_t>(PicoGetSurfaceNumVertexes(picoSurface));
+    auto numIndices = static_cast<std::size_t>(PicoGetSurfaceNumIndexes(picoSurface));
 
-    // Get the number of vertices and indices, and reserve capacity in our
-    // vectors in advance by populating them with empty structs.
-    auto numVertices = PicoGetSurfaceNumVertexes(picoSurface);
-    unsigned int numIndices = PicoGetSurfaceNumIndexes(picoSurface);
+    // Access the arrays directly, the accessor functions are range-checking every single element
+    const picoVec2_t* texcoords = picoSurface->numSTArrays > 0 ? picoSurface->st[0] : nullptr;
+    const picoColor_t* colours = picoSurface->numColorArrays > 0 ? picoSurface->color[0] : nullptr;
 
     std::shared_ptr<StaticModelSurface> staticSurface;
 
     {
         // Allocate the vectors that will be moved to the surface at end of scope
-        std::vector<MeshVertex> vertices(numVertices);
-        std::vector<unsigned int> indices(numIndices);
+        std::vector<MeshVertex> vertices;
+        vertices.reserve(numVertices);
 
-        // Stream in the vertex data from the raw struct, expanding the local AABB
-        // to include each vertex.
-        for (int vNum = 0; vNum < numVertices; ++vNum) {
-
-            // Get the vertex position and colour
-            Vertex3 vertex(PicoGetSurfaceXYZ(picoSurface, vNum));
-
-            Normal3 normal = PicoGetSurfaceNormal(picoSurface, vNum);
-
-            vertices[vNum].vertex = vertex;
-            vertices[vNum].normal = normal;
-            vertices[vNum].texcoord = TexCoord2f(PicoGetSurfaceST(picoSurface, 0, vNum));
-            vertices[vNum].colour = getColourVector(PicoGetSurfaceColor(picoSurface, 0, vNum));
-        }
-
-        // Stream in the index data
-        picoIndex_t* ind = PicoGetSurfaceIndexes(picoSurface, 0);
-
-        for (unsigned int i = 0; i < numIndices; i++)
+        for (std::size_t vNum = 0; vNum < numVertices; ++vNum)
         {
-            indices[i] = ind[i];
+            const auto& xyz = picoSurface->xyz[vNum];
+            const auto& normal = picoSurface->normal[vNum];
+
+            vertices.emplace_back(
+                Vertex3(xyz[0], xyz[1], xyz[2]),
+                Normal3(normal[0], normal[1], normal[2]),
+                texcoords ? TexCoord2f(texcoords[vNum][0], texcoords[vNum][1]) : TexCoord2f(0, 0),
+                getColourVector(colours ? colours[vNum] : nullptr)
+            );
         }
 
+        // The index data is converted in one go
+        std::vector<unsigned int> indices(picoSurface->index, picoSurface->index + numIndices);
+
         staticSurface = std::make_shared<StaticModelSurface>(std::move(vertices), std::move(indices));
     }
 
     staticSurface->setDefaultMaterial(DetermineDefaultMaterial(picoSurface, extension));
 
+    // The pico arrays are not needed anymore, release them right away such that
+    // not all surfaces are held in memory twice while the model is converted
+    PicoFreeSurfaceGeometry(picoSurface);
+
     return staticSurface;
 }
 
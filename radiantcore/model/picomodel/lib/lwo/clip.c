@@ -85,7 +85,7 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
    /* remember where we started */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    pos = (int)_pico_memstream_tell( fp );
 
    /* index */
@@ -96,10 +96,10 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
    clip->type = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    sz += sz & 1;
-   set_flen( 0 );
+   set_flen( fp, 0 );
 
    switch ( clip->type ) {
       case ID_STIL:
@@ -120,7 +120,7 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
       case ID_ANIM:
          clip->source.anim.name   = getS0( fp );
          clip->source.anim.server = getS0( fp );
-         rlen = get_flen();
+         rlen = get_flen( fp );
          clip->source.anim.data   = getbytes( fp, sz - rlen );
          break;
 
@@ -141,7 +141,7 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
    /* error while reading current subchunk? */
 
-   rlen = get_flen();
+   rlen = get_flen( fp );
    if ( rlen < 0 || rlen > sz ) goto Fail;
 
    /* skip unread parts of the current subchunk */
@@ -160,11 +160,11 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_TIME:
@@ -209,7 +209,7 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
             filt->name = getS0( fp );
             filt->flags = getU2( fp );
-            rlen = get_flen();
+            rlen = get_flen( fp );
             filt->data = getbytes( fp, sz - rlen );
 
             if ( id == ID_IFLT ) {
@@ -228,7 +228,7 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
       /* error while reading current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) goto Fail;
 
       /* skip unread parts of the current subchunk */
@@ -244,10 +244,10 @@ lwClip *lwGetClip( picoMemStream_t *fp, int cksize )
 
       /* get the next chunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) goto Fail;
+      if ( 6 != get_flen( fp ) ) goto Fail;
    }
 
    return clip;
@@ -60,7 +60,7 @@ lwEnvelope *lwGetEnvelope( picoMemStream_t *fp, int cksize )
 
    /* remember where we started */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    pos = (int)_pico_memstream_tell( fp );
 
    /* index */
@@ -71,13 +71,13 @@ lwEnvelope *lwGetEnvelope( picoMemStream_t *fp, int cksize )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    /* process subchunks as they're encountered */
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_TYPE:
@@ -136,7 +136,7 @@ lwEnvelope *lwGetEnvelope( picoMemStream_t *fp, int cksize )
 
             plug->name = getS0( fp );
             plug->flags = getU2( fp );
-            plug->data = getbytes( fp, sz - get_flen() );
+            plug->data = getbytes( fp, sz - get_flen( fp ) );
 
             lwListAdd( (void *) &env->cfilter, plug );
             env->ncfilters++;
@@ -148,7 +148,7 @@ lwEnvelope *lwGetEnvelope( picoMemStream_t *fp, int cksize )
 
       /* error while reading current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) goto Fail;
 
       /* skip unread parts of the current subchunk */
@@ -164,10 +164,10 @@ lwEnvelope *lwGetEnvelope( picoMemStream_t *fp, int cksize )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) goto Fail;
+      if ( 6 != get_flen( fp ) ) goto Fail;
    }
 
    return env;
@@ -20,16 +20,17 @@ it at the beginning of a sequence of reads and then retrieve it to get
 the number of bytes actually read.  If one of the I/O functions fails,
 flen is set to an error code, after which the I/O functions ignore
 read requests until flen is reset.
+
+The counter is stored in the stream, such that several models can be
+read at the same time.
 ====================================================================== */
 
 #define INT_MIN     (-2147483647 - 1) /* minimum (signed) int value */
 #define FLEN_ERROR INT_MIN
 
-static int flen;
-
-void set_flen( int i ) { flen = i; }
+void set_flen( picoMemStream_t *fp, int i ) { fp->flen = i; }
 
-int get_flen( void ) { return flen; }
+int get_flen( picoMemStream_t *fp ) { return fp->flen; }
 
 
 #ifndef __BIG_ENDIAN__
@@ -89,34 +90,34 @@ void *getbytes( picoMemStream_t *fp, int size )
 {
    void *data;
 
-   if ( flen == FLEN_ERROR ) return NULL;
+   if ( fp->flen == FLEN_ERROR ) return NULL;
    if ( size < 0 ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
    data = _pico_alloc( size );
    if ( !data ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
    if ( 1 != _pico_memstream_read( fp, data, size )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       _pico_free( data );
       return NULL;
    }
 
-   flen += size;
+   fp->flen += size;
    return data;
 }
 
 
 void skipbytes( picoMemStream_t *fp, int n )
 {
-   if ( flen == FLEN_ERROR ) return;
+   if ( fp->flen == FLEN_ERROR ) return;
    if ( _pico_memstream_seek( fp, n, PICO_SEEK_CUR ))
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
    else
-      flen += n;
+      fp->flen += n;
 }
 
 
@@ -124,14 +125,14 @@ int getI1( picoMemStream_t *fp )
 {
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    i = _pico_memstream_getc( fp );
    if ( i < 0 ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    if ( i > 127 ) i -= 256;
-   flen += 1;
+   fp->flen += 1;
    return i;
 }
 
@@ -140,13 +141,13 @@ short getI2( picoMemStream_t *fp )
 {
    short i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    if ( 1 != _pico_memstream_read( fp, &i, 2 )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    revbytes( &i, 2, 1 );
-   flen += 2;
+   fp->flen += 2;
    return i;
 }
 
@@ -155,13 +156,13 @@ int getI4( picoMemStream_t *fp )
 {
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    if ( 1 != _pico_memstream_read( fp, &i, 4 )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    revbytes( &i, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    return i;
 }
 
@@ -170,13 +171,13 @@ unsigned char getU1( picoMemStream_t *fp )
 {
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    i = _pico_memstream_getc( fp );
    if ( i < 0 ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
-   flen += 1;
+   fp->flen += 1;
    return (unsigned char)i;
 }
 
@@ -185,13 +186,13 @@ unsigned short getU2( picoMemStream_t *fp )
 {
    unsigned short i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    if ( 1 != _pico_memstream_read( fp, &i, 2 )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    revbytes( &i, 2, 1 );
-   flen += 2;
+   fp->flen += 2;
    return i;
 }
 
@@ -200,13 +201,13 @@ unsigned int getU4( picoMemStream_t *fp )
 {
    unsigned int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    if ( 1 != _pico_memstream_read( fp, &i, 4 )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    revbytes( &i, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    return i;
 }
 
@@ -215,14 +216,14 @@ int getVX( picoMemStream_t *fp )
 {
    int i, c;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
 
    c = _pico_memstream_getc( fp );
    if ( c != 0xFF ) {
       i = c << 8;
       c = _pico_memstream_getc( fp );
       i |= c;
-      flen += 2;
+      fp->flen += 2;
    }
    else {
       c = _pico_memstream_getc( fp );
@@ -231,11 +232,11 @@ int getVX( picoMemStream_t *fp )
       i |= c << 8;
       c = _pico_memstream_getc( fp );
       i |= c;
-      flen += 4;
+      fp->flen += 4;
    }
 
    if ( _pico_memstream_error( fp )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0;
    }
    return i;
@@ -246,13 +247,13 @@ float getF4( picoMemStream_t *fp )
 {
    float f;
 
-   if ( flen == FLEN_ERROR ) return 0.0f;
+   if ( fp->flen == FLEN_ERROR ) return 0.0f;
    if ( 1 != _pico_memstream_read( fp, &f, 4 )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return 0.0f;
    }
    revbytes( &f, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    return f;
 }
 
@@ -262,7 +263,7 @@ char *getS0( picoMemStream_t *fp )
    char *s;
    int i, c, len, pos;
 
-   if ( flen == FLEN_ERROR ) return NULL;
+   if ( fp->flen == FLEN_ERROR ) return NULL;
 
    pos = (int)_pico_memstream_tell( fp );
    for ( i = 1; ; i++ ) {
@@ -270,173 +271,173 @@ char *getS0( picoMemStream_t *fp )
       if ( c <= 0 ) break;
    }
    if ( c < 0 ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
 
    if ( i == 1 ) {
       if ( _pico_memstream_seek( fp, pos + 2, PICO_SEEK_SET ))
-         flen = FLEN_ERROR;
+         fp->flen = FLEN_ERROR;
       else
-         flen += 2;
+         fp->flen += 2;
       return NULL;
    }
 
    len = i + ( i & 1 );
    s = _pico_alloc( len );
    if ( !s ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
 
    if ( _pico_memstream_seek( fp, pos, PICO_SEEK_SET )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
    if ( 1 != _pico_memstream_read( fp, s, len )) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
 
-   flen += len;
+   fp->flen += len;
    return s;
 }
 
 
-int sgetI1( unsigned char **bp )
+int sgetI1( picoMemStream_t *fp, unsigned char **bp )
 {
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    i = **bp;
    if ( i > 127 ) i -= 256;
-   flen += 1;
+   fp->flen += 1;
    (*bp)++;
    return i;
 }
 
 
-short sgetI2( unsigned char **bp )
+short sgetI2( picoMemStream_t *fp, unsigned char **bp )
 {
    short i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    memcpy( &i, *bp, 2 );
    revbytes( &i, 2, 1 );
-   flen += 2;
+   fp->flen += 2;
    *bp += 2;
    return i;
 }
 
 
-int sgetI4( unsigned char **bp )
+int sgetI4( picoMemStream_t *fp, unsigned char **bp )
 {
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    memcpy( &i, *bp, 4 );
    revbytes( &i, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    *bp += 4;
    return i;
 }
 
 
-unsigned char sgetU1( unsigned char **bp )
+unsigned char sgetU1( picoMemStream_t *fp, unsigned char **bp )
 {
    unsigned char c;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    c = **bp;
-   flen += 1;
+   fp->flen += 1;
    (*bp)++;
    return c;
 }
 
 
-unsigned short sgetU2( unsigned char **bp )
+unsigned short sgetU2( picoMemStream_t *fp, unsigned char **bp )
 {
    unsigned char *buf = *bp;
    unsigned short i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    i = ( buf[ 0 ] << 8 ) | buf[ 1 ];
-   flen += 2;
+   fp->flen += 2;
    *bp += 2;
    return i;
 }
 
 
-unsigned int sgetU4( unsigned char **bp )
+unsigned int sgetU4( picoMemStream_t *fp, unsigned char **bp )
 {
    unsigned int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
    memcpy( &i, *bp, 4 );
    revbytes( &i, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    *bp += 4;
    return i;
 }
 
 
-int sgetVX( unsigned char **bp )
+int sgetVX( picoMemStream_t *fp, unsigned char **bp )
 {
    unsigned char *buf = *bp;
    int i;
 
-   if ( flen == FLEN_ERROR ) return 0;
+   if ( fp->flen == FLEN_ERROR ) return 0;
 
    if ( buf[ 0 ] != 0xFF ) {
       i = buf[ 0 ] << 8 | buf[ 1 ];
-      flen += 2;
+      fp->flen += 2;
       *bp += 2;
    }
    else {
       i = ( buf[ 1 ] << 16 ) | ( buf[ 2 ] << 8 ) | buf[ 3 ];
-      flen += 4;
+      fp->flen += 4;
       *bp += 4;
    }
    return i;
 }
 
 
-float sgetF4( unsigned char **bp )
+float sgetF4( picoMemStream_t *fp, unsigned char **bp )
 {
    float f;
 
-   if ( flen == FLEN_ERROR ) return 0.0f;
+   if ( fp->flen == FLEN_ERROR ) return 0.0f;
    memcpy( &f, *bp, 4 );
    revbytes( &f, 4, 1 );
-   flen += 4;
+   fp->flen += 4;
    *bp += 4;
    return f;
 }
 
 
-char *sgetS0( unsigned char **bp )
+char *sgetS0( picoMemStream_t *fp, unsigned char **bp )
 {
    char *s;
    unsigned char *buf = *bp;
    size_t len;
 
-   if ( flen == FLEN_ERROR ) return NULL;
+   if ( fp->flen == FLEN_ERROR ) return NULL;
 
    len = strlen( (char*)buf ) + 1;
    if ( len == 1 ) {
-      flen += 2;
+      fp->flen += 2;
       *bp += 2;
       return NULL;
    }
    len += len & 1;
    s = _pico_alloc( len );
    if ( !s ) {
-      flen = FLEN_ERROR;
+      fp->flen = FLEN_ERROR;
       return NULL;
    }
 
    memcpy( s, buf, len );
-   flen += (int)len;
+   fp->flen += (int)len;
    *bp += len;
    return s;
 }
@@ -90,11 +90,11 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
 
    /* read the first 12 bytes */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    id       = getU4( fp );
    formsize = getU4( fp );
    type     = getU4( fp );
-   if ( 12 != get_flen() ) {
+   if ( 12 != get_flen( fp ) ) {
       return NULL;
    }
 
@@ -127,7 +127,7 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
 
    id = getU4( fp );
    cksize = getU4( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    /* process chunks as they're encountered */
 
@@ -144,7 +144,7 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
             }
             object->nlayers++;
 
-            set_flen( 0 );
+            set_flen( fp, 0 );
             layer->index = getU2( fp );
             layer->flags = getU2( fp );
             layer->pivot[ 0 ] = getF4( fp );
@@ -152,11 +152,11 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
             layer->pivot[ 2 ] = getF4( fp );
             layer->name = getS0( fp );
 
-            rlen = get_flen();
+            rlen = get_flen( fp );
             if ( rlen < 0 || rlen > cksize ) goto Fail;
             if ( rlen <= cksize - 2 )
                layer->parent = getU2( fp );
-            rlen = get_flen();
+            rlen = get_flen( fp );
             if ( rlen < cksize )
                _pico_memstream_seek( fp, cksize - rlen, PICO_SEEK_CUR );
             break;
@@ -188,10 +188,10 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
             break;
 
          case ID_BBOX:
-            set_flen( 0 );
+            set_flen( fp, 0 );
             for ( i = 0; i < 6; i++ )
                layer->bbox[ i ] = getF4( fp );
-            rlen = get_flen();
+            rlen = get_flen( fp );
             if ( rlen < 0 || rlen > cksize ) goto Fail;
             if ( rlen < cksize )
                _pico_memstream_seek( fp, cksize - rlen, PICO_SEEK_CUR );
@@ -237,10 +237,10 @@ lwObject *lwGetObject( char *filename, picoMemStream_t *fp, unsigned int *failID
 
       /* get the next chunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       cksize = getU4( fp );
-      if ( 8 != get_flen() ) goto Fail;
+      if ( 8 != get_flen( fp ) ) goto Fail;
    }
 
    if ( object->nlayers == 0 )
@@ -280,11 +280,11 @@ int lwValidateObject( char *filename, picoMemStream_t *fp, unsigned int *failID,
 
    /* read the first 12 bytes */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    id       = getU4( fp );
    formsize = getU4( fp );
    type     = getU4( fp );
-   if ( 12 != get_flen() ) {
+   if ( 12 != get_flen( fp ) ) {
       return PICO_PMV_ERROR_SIZE;
    }
 
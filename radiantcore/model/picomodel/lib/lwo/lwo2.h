@@ -619,8 +619,8 @@ void normalize( float v[] );
 
 /* lwio.c */
 
-void  set_flen( int i );
-int   get_flen( void );
+void  set_flen( picoMemStream_t *fp, int i );
+int   get_flen( picoMemStream_t *fp );
 void *getbytes( picoMemStream_t *fp, int size );
 void  skipbytes( picoMemStream_t *fp, int n );
 int   getI1( picoMemStream_t *fp );
@@ -632,15 +632,15 @@ unsigned int   getU4( picoMemStream_t *fp );
 int   getVX( picoMemStream_t *fp );
 float getF4( picoMemStream_t *fp );
 char *getS0( picoMemStream_t *fp );
-int   sgetI1( unsigned char **bp );
-short sgetI2( unsigned char **bp );
-int   sgetI4( unsigned char **bp );
-unsigned char  sgetU1( unsigned char **bp );
-unsigned short sgetU2( unsigned char **bp );
-unsigned int   sgetU4( unsigned char **bp );
-int   sgetVX( unsigned char **bp );
-float sgetF4( unsigned char **bp );
-char *sgetS0( unsigned char **bp );
+int   sgetI1( picoMemStream_t *fp, unsigned char **bp );
+short sgetI2( picoMemStream_t *fp, unsigned char **bp );
+int   sgetI4( picoMemStream_t *fp, unsigned char **bp );
+unsigned char  sgetU1( picoMemStream_t *fp, unsigned char **bp );
+unsigned short sgetU2( picoMemStream_t *fp, unsigned char **bp );
+unsigned int   sgetU4( picoMemStream_t *fp, unsigned char **bp );
+int   sgetVX( picoMemStream_t *fp, unsigned char **bp );
+float sgetF4( picoMemStream_t *fp, unsigned char **bp );
+char *sgetS0( picoMemStream_t *fp, unsigned char **bp );
 
 #ifndef __BIG_ENDIAN__
   void revbytes( void *bp, int elsize, int elcount );
@@ -218,7 +218,7 @@ lwSurface *lwGetSurface5( picoMemStream_t *fp, int cksize, lwObject *obj )
 
    /* remember where we started */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    pos = (int)_pico_memstream_tell( fp );
 
    /* name */
@@ -229,13 +229,13 @@ lwSurface *lwGetSurface5( picoMemStream_t *fp, int cksize, lwObject *obj )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    /* process subchunks as they're encountered */
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_COLR:
@@ -460,7 +460,7 @@ lwSurface *lwGetSurface5( picoMemStream_t *fp, int cksize, lwObject *obj )
 
       /* error while reading current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) goto Fail;
 
       /* skip unread parts of the current subchunk */
@@ -475,10 +475,10 @@ lwSurface *lwGetSurface5( picoMemStream_t *fp, int cksize, lwObject *obj )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) goto Fail;
+      if ( 6 != get_flen( fp ) ) goto Fail;
    }
 
    return surf;
@@ -509,7 +509,7 @@ int lwGetPolygons5( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int p
 
    /* read the whole chunk */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    buf = getbytes( fp, cksize );
    if ( !buf ) goto Fail;
 
@@ -520,11 +520,11 @@ int lwGetPolygons5( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int p
    bp = buf;
 
    while ( bp < buf + cksize ) {
-      nv = sgetU2( &bp );
+      nv = sgetU2( fp, &bp );
       nverts += nv;
       npols++;
       bp += 2 * nv;
-      i = sgetI2( &bp );
+      i = sgetI2( fp, &bp );
       if ( i < 0 ) bp += 2;      /* detail polygons */
    }
 
@@ -538,14 +538,14 @@ int lwGetPolygons5( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int p
    pv = plist->pol[ 0 ].v + plist->voffset;
 
    for ( i = 0; i < npols; i++ ) {
-      nv = sgetU2( &bp );
+      nv = sgetU2( fp, &bp );
 
       pp->nverts = nv;
       pp->type = ID_FACE;
       if ( !pp->v ) pp->v = pv;
       for ( j = 0; j < nv; j++ )
-         pv[ j ].index = sgetU2( &bp ) + ptoffset;
-      j = sgetI2( &bp );
+         pv[ j ].index = sgetU2( fp, &bp ) + ptoffset;
+      j = sgetI2( fp, &bp );
       if ( j < 0 ) {
          j = -j;
          bp += 2;
@@ -602,11 +602,11 @@ lwObject *lwGetObject5( char *filename, picoMemStream_t *fp, unsigned int *failI
 
    /* read the first 12 bytes */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    id       = getU4( fp );
    formsize = getU4( fp );
    type     = getU4( fp );
-   if ( 12 != get_flen() ) {
+   if ( 12 != get_flen( fp ) ) {
       return NULL;
    }
 
@@ -631,7 +631,7 @@ lwObject *lwGetObject5( char *filename, picoMemStream_t *fp, unsigned int *failI
 
    id = getU4( fp );
    cksize = getU4( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    /* process chunks as they're encountered */
 
@@ -674,10 +674,10 @@ lwObject *lwGetObject5( char *filename, picoMemStream_t *fp, unsigned int *failI
 
       /* get the next chunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       cksize = getU4( fp );
-      if ( 8 != get_flen() ) goto Fail;
+      if ( 8 != get_flen( fp ) ) goto Fail;
    }
 
    lwGetBoundingBox( &layer->point, layer->bbox );
@@ -709,11 +709,11 @@ int lwValidateObject5( char *filename, picoMemStream_t *fp, unsigned int *failID
 
    /* read the first 12 bytes */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    id       = getU4( fp );
    formsize = getU4( fp );
    type     = getU4( fp );
-   if ( 12 != get_flen() ) {
+   if ( 12 != get_flen( fp ) ) {
       return PICO_PMV_ERROR_SIZE;
    }
 
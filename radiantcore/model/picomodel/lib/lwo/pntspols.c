@@ -190,10 +190,10 @@ int lwGetPolygons( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int pt
 
    /* read the whole chunk */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    type = getU4( fp );
    buf = getbytes( fp, cksize - 4 );
-   if ( cksize != get_flen() ) goto Fail;
+   if ( cksize != get_flen( fp ) ) goto Fail;
 
    /* count the polygons and vertices */
 
@@ -202,12 +202,12 @@ int lwGetPolygons( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int pt
    bp = buf;
 
    while ( bp < buf + cksize - 4 ) {
-      nv = sgetU2( &bp );
+      nv = sgetU2( fp, &bp );
       nv &= 0x03FF;
       nverts += nv;
       npols++;
       for ( i = 0; i < nv; i++ )
-         j = sgetVX( &bp );
+         j = sgetVX( fp, &bp );
    }
 
    if ( !lwAllocPolygons( plist, npols, nverts ))
@@ -220,7 +220,7 @@ int lwGetPolygons( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int pt
    pv = plist->pol[ 0 ].v + plist->voffset;
 
    for ( i = 0; i < npols; i++ ) {
-      nv = sgetU2( &bp );
+      nv = sgetU2( fp, &bp );
       flags = nv & 0xFC00;
       nv &= 0x03FF;
 
@@ -229,7 +229,7 @@ int lwGetPolygons( picoMemStream_t *fp, int cksize, lwPolygonList *plist, int pt
       pp->type = type;
       if ( !pp->v ) pp->v = pv;
       for ( j = 0; j < nv; j++ )
-         pp->v[ j ].index = sgetVX( &bp ) + ptoffset;
+         pp->v[ j ].index = sgetVX( fp, &bp ) + ptoffset;
 
       pp++;
       pv += nv;
@@ -461,7 +461,7 @@ int lwGetTags( picoMemStream_t *fp, int cksize, lwTagList *tlist )
 
    /* read the whole chunk */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    buf = getbytes( fp, cksize );
    if ( !buf ) return 0;
 
@@ -488,7 +488,7 @@ int lwGetTags( picoMemStream_t *fp, int cksize, lwTagList *tlist )
 
    bp = buf;
    for ( i = 0; i < ntags; i++ )
-      tlist->tag[ i + tlist->offset ] = sgetS0( (unsigned char **) &bp );
+      tlist->tag[ i + tlist->offset ] = sgetS0( fp, (unsigned char **) &bp );
 
    _pico_free( buf );
    return 1;
@@ -512,9 +512,9 @@ int lwGetPolygonTags( picoMemStream_t *fp, int cksize, lwTagList *tlist,
    unsigned int type;
    int rlen = 0, i, j;
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    type = getU4( fp );
-   rlen = get_flen();
+   rlen = get_flen( fp );
    if ( rlen < 0 ) return 0;
 
    if ( type != ID_SURF && type != ID_PART && type != ID_SMGP ) {
@@ -525,7 +525,7 @@ int lwGetPolygonTags( picoMemStream_t *fp, int cksize, lwTagList *tlist,
    while ( rlen < cksize ) {
       i = getVX( fp ) + plist->offset;
       j = getVX( fp ) + tlist->offset;
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > cksize ) return 0;
     
       switch ( type ) {
@@ -108,7 +108,7 @@ int lwGetTHeader( picoMemStream_t *fp, int hsz, lwTexture *tex )
 
    /* remember where we started */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    pos = (int)_pico_memstream_tell( fp );
 
    /* ordinal string */
@@ -119,13 +119,13 @@ int lwGetTHeader( picoMemStream_t *fp, int hsz, lwTexture *tex )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) return 0;
+   if ( 0 > get_flen( fp ) ) return 0;
 
    /* process subchunks as they're encountered */
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_CHAN:
@@ -156,7 +156,7 @@ int lwGetTHeader( picoMemStream_t *fp, int hsz, lwTexture *tex )
 
       /* error while reading current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) return 0;
 
       /* skip unread parts of the current subchunk */
@@ -171,13 +171,13 @@ int lwGetTHeader( picoMemStream_t *fp, int hsz, lwTexture *tex )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) return 0;
+      if ( 6 != get_flen( fp ) ) return 0;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return 1;
 }
 
@@ -199,11 +199,11 @@ int lwGetTMap( picoMemStream_t *fp, int tmapsz, lwTMap *tmap )
    pos = (int)_pico_memstream_tell( fp );
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) return 0;
+   if ( 0 > get_flen( fp ) ) return 0;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_SIZE:
@@ -245,7 +245,7 @@ int lwGetTMap( picoMemStream_t *fp, int tmapsz, lwTMap *tmap )
 
       /* error while reading the current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) return 0;
 
       /* skip unread parts of the current subchunk */
@@ -260,13 +260,13 @@ int lwGetTMap( picoMemStream_t *fp, int tmapsz, lwTMap *tmap )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) return 0;
+      if ( 6 != get_flen( fp ) ) return 0;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return 1;
 }
 
@@ -287,11 +287,11 @@ int lwGetImageMap( picoMemStream_t *fp, int rsz, lwTexture *tex )
    pos = (int)_pico_memstream_tell( fp );
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) return 0;
+   if ( 0 > get_flen( fp ) ) return 0;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_TMAP:
@@ -354,7 +354,7 @@ int lwGetImageMap( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* error while reading the current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) return 0;
 
       /* skip unread parts of the current subchunk */
@@ -369,13 +369,13 @@ int lwGetImageMap( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) return 0;
+      if ( 6 != get_flen( fp ) ) return 0;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return 1;
 }
 
@@ -396,11 +396,11 @@ int lwGetProcedural( picoMemStream_t *fp, int rsz, lwTexture *tex )
    pos = (int)_pico_memstream_tell( fp );
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) return 0;
+   if ( 0 > get_flen( fp ) ) return 0;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_TMAP:
@@ -419,7 +419,7 @@ int lwGetProcedural( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
          case ID_FUNC:
             tex->param.proc.name = getS0( fp );
-            rlen = get_flen();
+            rlen = get_flen( fp );
             tex->param.proc.data = getbytes( fp, sz - rlen );
             break;
 
@@ -429,7 +429,7 @@ int lwGetProcedural( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* error while reading the current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) return 0;
 
       /* skip unread parts of the current subchunk */
@@ -444,13 +444,13 @@ int lwGetProcedural( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) return 0;
+      if ( 6 != get_flen( fp ) ) return 0;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return 1;
 }
 
@@ -471,11 +471,11 @@ int lwGetGradient( picoMemStream_t *fp, int rsz, lwTexture *tex )
    pos = (int)_pico_memstream_tell( fp );
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) return 0;
+   if ( 0 > get_flen( fp ) ) return 0;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_TMAP:
@@ -527,7 +527,7 @@ int lwGetGradient( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* error while reading the current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) return 0;
 
       /* skip unread parts of the current subchunk */
@@ -542,13 +542,13 @@ int lwGetGradient( picoMemStream_t *fp, int rsz, lwTexture *tex )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) return 0;
+      if ( 6 != get_flen( fp ) ) return 0;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return 1;
 }
 
@@ -596,7 +596,7 @@ lwTexture *lwGetTexture( picoMemStream_t *fp, int bloksz, unsigned int type )
       return NULL;
    }
 
-   set_flen( bloksz );
+   set_flen( fp, bloksz );
    return tex;
 }
 
@@ -619,12 +619,12 @@ lwPlugin *lwGetShader( picoMemStream_t *fp, int bloksz )
    if ( !shdr ) return NULL;
 
    pos = (int)_pico_memstream_tell( fp );
-   set_flen( 0 );
+   set_flen( fp, 0 );
    hsz = getU2( fp );
    shdr->ord = getS0( fp );
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    while ( hsz > 0 ) {
       sz += sz & 1;
@@ -642,16 +642,16 @@ lwPlugin *lwGetShader( picoMemStream_t *fp, int bloksz )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_FUNC:
             shdr->name = getS0( fp );
-            rlen = get_flen();
+            rlen = get_flen( fp );
             shdr->data = getbytes( fp, sz - rlen );
             break;
 
@@ -661,7 +661,7 @@ lwPlugin *lwGetShader( picoMemStream_t *fp, int bloksz )
 
       /* error while reading the current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) goto Fail;
 
       /* skip unread parts of the current subchunk */
@@ -676,13 +676,13 @@ lwPlugin *lwGetShader( picoMemStream_t *fp, int bloksz )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) goto Fail;
+      if ( 6 != get_flen( fp ) ) goto Fail;
    }
 
-   set_flen( (int)_pico_memstream_tell( fp ) - pos );
+   set_flen( fp, (int)_pico_memstream_tell( fp ) - pos );
    return shdr;
 
 Fail:
@@ -837,7 +837,7 @@ lwSurface *lwGetSurface( picoMemStream_t *fp, int cksize )
 
    /* remember where we started */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    pos = (int)_pico_memstream_tell( fp );
 
    /* names */
@@ -849,13 +849,13 @@ lwSurface *lwGetSurface( picoMemStream_t *fp, int cksize )
 
    id = getU4( fp );
    sz = getU2( fp );
-   if ( 0 > get_flen() ) goto Fail;
+   if ( 0 > get_flen( fp ) ) goto Fail;
 
    /* process subchunks as they're encountered */
 
    while ( 1 ) {
       sz += sz & 1;
-      set_flen( 0 );
+      set_flen( fp, 0 );
 
       switch ( id ) {
          case ID_COLR:
@@ -990,14 +990,14 @@ lwSurface *lwGetSurface( picoMemStream_t *fp, int cksize )
                   if ( !tex ) goto Fail;
                   if ( !add_texture( surf, tex ))
                      lwFreeTexture( tex );
-                  set_flen( 4 + get_flen() );
+                  set_flen( fp, 4 + get_flen( fp ) );
                   break;
                case ID_SHDR:
                   shdr = lwGetShader( fp, sz - 4 );
                   if ( !shdr ) goto Fail;
                   lwListInsert( (void **) &surf->shader, shdr, (int (*)(void *, void *))compare_shaders );
                   ++surf->nshaders;
-                  set_flen( 4 + get_flen() );
+                  set_flen( fp, 4 + get_flen( fp ) );
                   break;
             }
             break;
@@ -1008,7 +1008,7 @@ lwSurface *lwGetSurface( picoMemStream_t *fp, int cksize )
 
       /* error while reading current subchunk? */
 
-      rlen = get_flen();
+      rlen = get_flen( fp );
       if ( rlen < 0 || rlen > sz ) goto Fail;
 
       /* skip unread parts of the current subchunk */
@@ -1023,10 +1023,10 @@ lwSurface *lwGetSurface( picoMemStream_t *fp, int cksize )
 
       /* get the next subchunk header */
 
-      set_flen( 0 );
+      set_flen( fp, 0 );
       id = getU4( fp );
       sz = getU2( fp );
-      if ( 6 != get_flen() ) goto Fail;
+      if ( 6 != get_flen( fp ) ) goto Fail;
    }
 
    return surf;
@@ -51,7 +51,7 @@ lwVMap *lwGetVMap( picoMemStream_t *fp, int cksize, int ptoffset, int poloffset,
 
    /* read the whole chunk */
 
-   set_flen( 0 );
+   set_flen( fp, 0 );
    buf = getbytes( fp, cksize );
    if ( !buf ) return NULL;
 
@@ -66,19 +66,19 @@ lwVMap *lwGetVMap( picoMemStream_t *fp, int cksize, int ptoffset, int poloffset,
    vmap->perpoly = perpoly;
 
    bp = buf;
-   set_flen( 0 );
-   vmap->type = sgetU4( &bp );
-   vmap->dim  = sgetU2( &bp );
-   vmap->name = sgetS0( &bp );
-   rlen = get_flen();
+   set_flen( fp, 0 );
+   vmap->type = sgetU4( fp, &bp );
+   vmap->dim  = sgetU2( fp, &bp );
+   vmap->name = sgetS0( fp, &bp );
+   rlen = get_flen( fp );
 
    /* count the vmap records */
 
    npts = 0;
    while ( bp < buf + cksize ) {
-      i = sgetVX( &bp );
+      i = sgetVX( fp, &bp );
       if ( perpoly )
-         i = sgetVX( &bp );
+         i = sgetVX( fp, &bp );
       bp += vmap->dim * sizeof( float );
       ++npts;
    }
@@ -106,11 +106,11 @@ lwVMap *lwGetVMap( picoMemStream_t *fp, int cksize, int ptoffset, int poloffset,
 
    bp = buf + rlen;
    for ( i = 0; i < npts; i++ ) {
-      vmap->vindex[ i ] = sgetVX( &bp );
+      vmap->vindex[ i ] = sgetVX( fp, &bp );
       if ( perpoly )
-         vmap->pindex[ i ] = sgetVX( &bp );
+         vmap->pindex[ i ] = sgetVX( fp, &bp );
       for ( j = 0; j < vmap->dim; j++ )
-         vmap->val[ i ][ j ] = sgetF4( &bp );
+         vmap->val[ i ][ j ] = sgetF4( fp, &bp );
    }
 
    _pico_free( buf );
@@ -99,6 +99,7 @@ typedef struct picoMemStream_s
 	int			bufSize;
 	picoByte_t	*curPos;
 	int			flag;
+	int			flen;	/* byte counter of the LWO reader, kept here to be thread-safe */
 }
 picoMemStream_t;
 
@@ -617,6 +617,51 @@ void PicoFreeSurface( picoSurface_t *surface )
 
 
 
+/*
+PicoFreeSurfaceGeometry()
+frees the vertex and index arrays of a surface whose data has been copied elsewhere,
+name and shader are kept. the surface is still freed along with its model.
+*/
+
+void PicoFreeSurfaceGeometry( picoSurface_t *surface )
+{
+	int		i;
+
+
+	/* dummy check */
+	if( surface == NULL )
+		return;
+
+	_pico_free( surface->xyz );
+	_pico_free( surface->normal );
+	_pico_free( surface->smoothingGroup );
+	_pico_free( surface->index );
+	_pico_free( surface->faceNormal );
+
+	surface->xyz = NULL;
+	surface->normal = NULL;
+	surface->smoothingGroup = NULL;
+	surface->index = NULL;
+	surface->faceNormal = NULL;
+
+	for( i = 0; i < surface->numSTArrays; i++ )
+	{
+		_pico_free( surface->st[ i ] );
+		surface->st[ i ] = NULL;
+	}
+	for( i = 0; i < surface->numColorArrays; i++ )
+	{
+		_pico_free( surface->color[ i ] );
+		surface->color[ i ] = NULL;
+	}
+
+	surface->numVertexes = surface->maxVertexes = 0;
+	surface->numIndexes = surface->maxIndexes = 0;
+	surface->numFaceNormals = surface->maxFaceNormals = 0;
+}
+
+
+
 /*
 PicoAdjustSurface()
 adjusts a surface's memory allocations to handle the requested sizes.
@@ -237,6 +237,7 @@ picoShader_t				*PicoFindShader( picoModel_t *model, char *name, int caseSensiti
 /* surface functions */
 picoSurface_t				*PicoNewSurface( picoModel_t *model );
 void						PicoFreeSurface( picoSurface_t *surface );
+void						PicoFreeSurfaceGeometry( picoSurface_t *surface );
 picoSurface_t				*PicoFindSurface( picoModel_t *model, char *name, int caseSensitive );
 int							PicoAdjustSurface( picoSurface_t *surface, int numVertexes, int numSTArrays, int numColorArrays, int numIndexes, int numFaceNormals );
 
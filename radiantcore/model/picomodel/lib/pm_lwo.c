@@ -47,10 +47,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 /* helper functions */
-static const char *lwo_lwIDToStr( unsigned int lwID )
+static const char *lwo_lwIDToStr( unsigned int lwID, char lwIDStr[5] )
 {
-	static char lwIDStr[5];
-
 	if (!lwID)
 	{
 		return "n/a";
@@ -109,6 +107,7 @@ static picoModel_t *_lwo_load( PM_PARAMS_LOAD )
 	lwPolVert		*v;
 	lwVMapPt		*vm;
 	char			name[ 256 ];
+	char			idStr[ 5 ];
 	int				i, j, k, numverts;
 
 	picoModel_t		*picoModel;
@@ -152,7 +151,7 @@ static picoModel_t *_lwo_load( PM_PARAMS_LOAD )
 	_pico_free_memstream( s );
 
 	if( !obj ) {
-		_pico_printf( PICO_ERROR, "Couldn't load LWO file, failed on ID '%s', position %d", lwo_lwIDToStr( failID ), failpos );
+		_pico_printf( PICO_ERROR, "Couldn't load LWO file, failed on ID '%s', position %d", lwo_lwIDToStr( failID, idStr ), failpos );
 		return NULL;
 	}
 
@@ -285,7 +284,7 @@ static picoModel_t *_lwo_load( PM_PARAMS_LOAD )
 			/* we only support polygons of the FACE type */
 			if (pol->type != ID_FACE)
 			{
-				_pico_printf( PICO_WARNING, "LWO loader discarded a polygon because it's type != FACE (%s)", lwo_lwIDToStr( pol->type ) );
+				_pico_printf( PICO_WARNING, "LWO loader discarded a polygon because it's type != FACE (%s)", lwo_lwIDToStr( pol->type, idStr ) );
 				continue;
 			}
 
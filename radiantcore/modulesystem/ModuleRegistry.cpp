@@ -5,6 +5,13 @@
 #include "itextstream.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <future>
+#include <set>
+#include <thread>
 #include "ModuleLoader.h"
 
 #include <fmt/format.h>
@@ -22,6 +29,7 @@ ModuleRegistry::ModuleRegistry(const IApplicationContext& ctx) :
 
     // Initialise the Reference in the GlobalModuleRegistry() accessor.
     RegistryReference::Instance().setRegistry(*this);
+    util::GlobalTraceRecorderPtr() = &_traceRecorder;
 }
 
 ModuleRegistry::~ModuleRegistry()
@@ -91,43 +99,238 @@ void ModuleRegistry::registerModule(const RegisterableModulePtr& module)
 	rMessage() << "Module registered: " << module->getName() << std::endl;
 }
 
-// Initialise the module (including dependencies, if necessary)
-void ModuleRegistry::initialiseModuleRecursive(const std::string& name)
+void ModuleRegistry::collectInitialisationOrder(const std::string& name,
+	std::set<std::string>& visited, std::vector<std::string>& order)
 {
-	// Check if the module is already initialised
-	if (_initialisedModules.find(name) != _initialisedModules.end())
-    {
+	// Check if the module is already initialised or visited
+	if (_initialisedModules.find(name) != _initialisedModules.end() || visited.count(name) > 0)
+	{
 		return;
 	}
 
 	// Check if the module exists at all
-	if (_uninitialisedModules.find(name) == _uninitialisedModules.end())
+	auto found = _uninitialisedModules.find(name);
+
+	if (found == _uninitialisedModules.end())
 	{
 		throw std::logic_error("ModuleRegistry: Module doesn't exist: " + name);
 	}
 
-	// Tag this module as "ready" by moving it into the initialised list.
-	RegisterableModulePtr module = _initialisedModules.emplace(name, _uninitialisedModules[name]).first->second;
-	const StringSet& dependencies = module->getDependencies();
+	// Tag the module as visited before descending, to not run in circles
+	visited.insert(name);
 
-    // Debug builds should ensure that the dependencies don't reference the
-    // module itself directly
-    assert(dependencies.find(module->getName()) == dependencies.end());
+	const StringSet& dependencies = found->second->getDependencies();
 
-	// Initialise the dependencies first
+	// Debug builds should ensure that the dependencies don't reference the
+	// module itself directly
+	assert(dependencies.find(name) == dependencies.end());
+
+	// The dependencies go first
 	for (const std::string& namedDependency : dependencies)
 	{
-        initialiseModuleRecursive(namedDependency);
+		collectInitialisationOrder(namedDependency, visited, order);
+	}
+
+	order.push_back(name);
+}
+
+void ModuleRegistry::initialiseModules()
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Main thread modules are initialised in the depth-first order, like they always were
+	std::set<std::string> visited;
+	std::vector<std::string> order;
+
+	for (const auto& [name, module] : _uninitialisedModules)
+	{
+		collectInitialisationOrder(name, visited, order);
+	}
+
+	struct ModuleState
+	{
+		RegisterableModulePtr module;
+		bool onWorkerThread = false;
+		std::vector<std::size_t> dependencies;
+		bool started = false;
+		bool finished = false;
+		double milliseconds = 0;
+	};
+
+	std::map<std::string, std::size_t> positions;
+	std::vector<ModuleState> states(order.size());
+
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		auto& state = states[i];
+		state.module = _uninitialisedModules[order[i]];
+		state.onWorkerThread = state.module->canInitialiseOnWorkerThread();
+
+		// Only dependencies preceding the module in the order are waited for,
+		// back references of circular dependencies are ignored like before
+		for (const auto& dependency : state.module->getDependencies())
+		{
+			auto position = positions.find(dependency);
+
+			if (position != positions.end())
+			{
+				state.dependencies.push_back(position->second);
+			}
+		}
+
+		positions.emplace(order[i], i);
 	}
 
-	_progress = 0.1f + (static_cast<float>(_initialisedModules.size())/_uninitialisedModules.size())*0.9f;
+	std::mutex lock;
+	std::condition_variable moduleFinished;
+	std::exception_ptr error;
+	std::vector<std::future<void>> workers;
+
+	std::size_t numStarted = 0;
+	std::size_t numFinished = 0;
+	std::size_t numRunningWorkers = 0;
+	const std::size_t maxRunningWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	auto isReady = [&](const ModuleState& state)
+	{
+		return std::all_of(state.dependencies.begin(), state.dependencies.end(),
+			[&](std::size_t dependency) { return states[dependency].finished; });
+	};
+
+	// Tags the module as "ready" by moving it into the initialised list
+	auto startModule = [&](ModuleState& state)
+	{
+		state.started = true;
+
+		{
+			std::lock_guard<std::mutex> modulesLock(_modulesLock);
+			_initialisedModules.emplace(state.module->getName(), state.module);
+		}
 
-	_sigModuleInitialisationProgress.emit(
-		fmt::format(_("Initialising Module: {0}"), module->getName()),
-		_progress);
+		_progress = 0.1f + (static_cast<float>(++numStarted) / states.size()) * 0.9f;
+
+		_sigModuleInitialisationProgress.emit(
+			fmt::format(_("Initialising Module: {0}"), state.module->getName()),
+			_progress);
+	};
+
+	// Initialises the module, returns false if an exception has been thrown
+	auto initialise = [&](ModuleState& state)
+	{
+		auto start = Clock::now();
+
+		try
+		{
+			util::ScopedTraceEvent trace("module", state.module->getName());
+			state.module->initialiseModule(_context);
+		}
+		catch (...)
+		{
+			std::lock_guard<std::mutex> errorLock(lock);
+
+			if (!error)
+			{
+				error = std::current_exception();
+			}
+		}
+
+		state.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	};
+
+	auto start = Clock::now();
+	std::size_t nextMainThreadModule = 0;
+
+	util::ScopedTraceEvent trace("module", "Initialise modules");
+
+	std::unique_lock<std::mutex> guard(lock);
+
+	while (numFinished < states.size() && !error)
+	{
+		// Start all worker modules whose dependencies are done
+		for (auto& state : states)
+		{
+			if (numRunningWorkers >= maxRunningWorkers) break;
+
+			if (!state.onWorkerThread || state.started || !isReady(state)) continue;
+
+			startModule(state);
+			++numRunningWorkers;
+
+			workers.emplace_back(std::async(std::launch::async, [&]()
+			{
+				initialise(state);
+
+				std::lock_guard<std::mutex> finishLock(lock);
+				state.finished = true;
+				++numFinished;
+				--numRunningWorkers;
+				moduleFinished.notify_all();
+			}));
+		}
+
+		while (nextMainThreadModule < states.size() && states[nextMainThreadModule].onWorkerThread)
+		{
+			++nextMainThreadModule;
+		}
+
+		if (nextMainThreadModule < states.size() && isReady(states[nextMainThreadModule]))
+		{
+			auto& state = states[nextMainThreadModule++];
+
+			startModule(state);
+
+			guard.unlock();
+			initialise(state);
+			guard.lock();
+
+			state.finished = true;
+			++numFinished;
+			continue;
+		}
+
+		// Wait for a worker module to finish
+		moduleFinished.wait(guard);
+	}
+
+	guard.unlock();
+
+	// Running worker modules are completed in any case
+	workers.clear();
+
+	if (error)
+	{
+		std::rethrow_exception(error);
+	}
+
+	std::vector<std::pair<std::string, double>> times;
+
+	for (const auto& state : states)
+	{
+		times.emplace_back(state.module->getName() + (state.onWorkerThread ? " (worker thread)" : ""),
+			state.milliseconds);
+	}
 
-	// Initialise the module itself, now that the dependencies are ready
-	module->initialiseModule(_context);
+	reportInitialisationTimes(std::move(times),
+		std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+}
+
+void ModuleRegistry::reportInitialisationTimes(std::vector<std::pair<std::string, double>> times,
+	double totalMilliseconds)
+{
+	constexpr std::size_t NumReportedModules = 10;
+
+	std::sort(times.begin(), times.end(), [](const auto& a, const auto& b)
+	{
+		return a.second > b.second;
+	});
+
+	rMessage() << fmt::format("ModuleRegistry: {0} modules initialised in {1:.0f} ms, the slowest ones:",
+		times.size(), totalMilliseconds) << std::endl;
+
+	for (std::size_t i = 0; i < times.size() && i < NumReportedModules; ++i)
+	{
+		rMessage() << fmt::format("  {0}: {1:.1f} ms", times[i].first, times[i].second) << std::endl;
+	}
 }
 
 void ModuleRegistry::initialiseCoreModule()
@@ -161,23 +364,23 @@ void ModuleRegistry::loadAndInitialiseModules()
 
 	rMessage() << "ModuleRegistry Compatibility Level is " << getCompatibilityLevel() << std::endl;
 
+	enableTracingIfRequested();
+
 	// Invoke the ModuleLoad routine to load the DLLs from modules/ and plugins/
-	auto libraryPaths = _context.getLibraryPaths();
-	for (auto path : libraryPaths)
 	{
-		_loader->loadModulesFromPath(path);
+		util::ScopedTraceEvent trace("module", "Load module libraries");
+
+		auto libraryPaths = _context.getLibraryPaths();
+		for (auto path : libraryPaths)
+		{
+			_loader->loadModulesFromPath(path);
+		}
 	}
 
 	_progress = 0.1f;
 	_sigModuleInitialisationProgress.emit(_("Initialising Modules"), _progress);
 
-	for (ModulesMap::iterator i = _uninitialisedModules.begin();
-		 i != _uninitialisedModules.end(); ++i)
-	{
-		// greebo: Dive into the recursion
-		// (this will return immediately if the module is already initialised).
-		initialiseModuleRecursive(i->first);
-	}
+	initialiseModules();
 
 	_uninitialisedModules.clear();
 
@@ -200,6 +403,8 @@ void ModuleRegistry::shutdownModules()
 		throw std::logic_error("ModuleRegistry: shutdownModules called twice.");
 	}
 
+	writeTraceFile();
+
 	_sigModulesUninitialising.emit();
 	_sigModulesUninitialising.clear();
 
@@ -220,6 +425,8 @@ void ModuleRegistry::shutdownModules()
 
 bool ModuleRegistry::moduleExists(const std::string& name) const
 {
+	std::lock_guard<std::mutex> lock(_modulesLock);
+
 	// Try to find the initialised module, uninitialised don't count as existing
     return _initialisedModules.find(name) != _initialisedModules.end();
 }
@@ -230,12 +437,16 @@ RegisterableModulePtr ModuleRegistry::getModule(const std::string& name) const {
 	// The return value (NULL) by default
 	RegisterableModulePtr returnValue;
 
-	// Try to find the module
-	ModulesMap::const_iterator found = _initialisedModules.find(name);
+	{
+		std::lock_guard<std::mutex> lock(_modulesLock);
+
+		// Try to find the module
+		ModulesMap::const_iterator found = _initialisedModules.find(name);
 
-	if (found != _initialisedModules.end())
-    {
-		returnValue = found->second;
+		if (found != _initialisedModules.end())
+		{
+			returnValue = found->second;
+		}
 	}
 
 	if (!returnValue)
@@ -292,6 +503,57 @@ sigc::signal<void>& ModuleRegistry::signal_modulesUnloading()
     return _sigModulesUnloading;
 }
 
+std::mutex& ModuleRegistry::getSignalLock()
+{
+    return _signalLock;
+}
+
+util::TraceRecorder& ModuleRegistry::getTraceRecorder()
+{
+    return _traceRecorder;
+}
+
+void ModuleRegistry::enableTracingIfRequested()
+{
+	const std::string option = "--trace";
+	const auto& args = _context.getCmdLineArgs();
+
+	for (auto arg = args.begin(); arg != args.end(); ++arg)
+	{
+		if (arg->rfind(option + "=", 0) == 0)
+		{
+			_traceFile = arg->substr(option.length() + 1);
+		}
+		else if (*arg == option && arg + 1 != args.end())
+		{
+			_traceFile = *(arg + 1);
+		}
+	}
+
+	if (_traceFile.empty()) return;
+
+	rMessage() << "ModuleRegistry: recording trace events, they will be written to " << _traceFile << std::endl;
+	_traceRecorder.enable();
+}
+
+void ModuleRegistry::writeTraceFile()
+{
+	if (!_traceRecorder.isRecordingForExport()) return;
+
+	_traceRecorder.disable();
+
+	std::ofstream stream(_traceFile);
+
+	if (!stream)
+	{
+		rError() << "ModuleRegistry: cannot open trace file " << _traceFile << std::endl;
+		return;
+	}
+
+	_traceRecorder.writeChromeTrace(stream);
+	rMessage() << "ModuleRegistry: trace events written to " << _traceFile << std::endl;
+}
+
 std::size_t ModuleRegistry::getCompatibilityLevel() const
 {
 	return MODULE_COMPATIBILITY_LEVEL;
@@ -2,6 +2,8 @@
 
 #include <map>
 #include <list>
+#include <mutex>
+#include <vector>
 #include "imodule.h"
 
 namespace module 
@@ -31,6 +33,15 @@ private:
 	// After initialisiation, modules get enlisted here.
 	ModulesMap _initialisedModules;
 
+	// Guards the module maps, modules might be initialised on worker threads
+	mutable std::mutex _modulesLock;
+
+	std::mutex _signalLock;
+
+	// Collects the timeline events, written to _traceFile on shutdown
+	util::TraceRecorder _traceRecorder;
+	std::string _traceFile;
+
 	// Set to TRUE as soon as initialiseModules() is finished
 	bool _modulesInitialised;
 
@@ -80,6 +91,8 @@ public:
     sigc::signal<void>& signal_modulesUninitialising() override;
     sigc::signal<void>& signal_allModulesUninitialised() override;
     sigc::signal<void>& signal_modulesUnloading() override;
+    std::mutex& getSignalLock() override;
+    util::TraceRecorder& getTraceRecorder() override;
 
 	std::size_t getCompatibilityLevel() const override;
 
@@ -98,8 +111,21 @@ private:
 	// is destructed - the shared_ptrs don't work anymore and are causing double-deletes.
 	void unloadModules();
 
-	// Initialises the module (including dependencies, recursively).
-	void initialiseModuleRecursive(const std::string& name);
+	// Appends the module to the initialisation order, after its dependencies (recursively)
+	void collectInitialisationOrder(const std::string& name, std::set<std::string>& visited,
+		std::vector<std::string>& order);
+
+	// Initialises all uninitialised modules, the ones supporting it on worker threads
+	void initialiseModules();
+
+	// Writes the initialisation time of the slowest modules to the log
+	void reportInitialisationTimes(std::vector<std::pair<std::string, double>> times, double totalMilliseconds);
+
+	// Enables the trace recorder if the --trace=<file> argument has been passed
+	void enableTracingIfRequested();
+
+	// Exports the recorded events to the file passed on the command line
+	void writeTraceFile();
 
 }; // class Registry
 
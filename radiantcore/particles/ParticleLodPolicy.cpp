@@ -0,0 +1,123 @@
+#include "ParticleLodPolicy.h"
+
+#include <algorithm>
+#include <cmath>
+#include "iregistry.h"
+#include "registry/registry.h"
+
+namespace particles
+{
+
+namespace
+{
+    // Emitters covering at least this fraction of the view width are simulated in full detail
+    const double FULL_DETAIL_SIZE = 0.1;
+
+    // The particle count of the smallest emitters is not reduced below this fraction
+    const float MIN_COUNT_FRACTION = 0.125f;
+
+    // The update interval of the smallest emitters in msecs
+    const double MAX_UPDATE_INTERVAL = 100;
+}
+
+ParticleLodPolicy::ParticleLodPolicy() :
+    _enabled(false),
+    _budget(0),
+    _currentFrame(0),
+    _budgetUsed(0)
+{}
+
+void ParticleLodPolicy::initialise()
+{
+    loadSettings();
+
+    GlobalRegistry().signalForKey(RKEY_ENABLE_PARTICLE_LOD).connect(
+        sigc::mem_fun(this, &ParticleLodPolicy::loadSettings)
+    );
+    GlobalRegistry().signalForKey(RKEY_PARTICLE_BUDGET).connect(
+        sigc::mem_fun(this, &ParticleLodPolicy::loadSettings)
+    );
+}
+
+void ParticleLodPolicy::loadSettings()
+{
+    _enabled = registry::getValue<bool>(RKEY_ENABLE_PARTICLE_LOD);
+    _budget = static_cast<std::size_t>(std::max(registry::getValue<int>(RKEY_PARTICLE_BUDGET), 0));
+}
+
+ParticleLod ParticleLodPolicy::getLod(std::size_t frame, double projectedSize)
+{
+    ensureFrame(frame);
+
+    ++_statistics.numEmitters;
+
+    if (!_enabled || projectedSize >= FULL_DETAIL_SIZE)
+    {
+        return ParticleLod::Full();
+    }
+
+    // Scale the particle count and the update rate linearly with the projected size
+    auto detail = std::max(projectedSize, 0.0) / FULL_DETAIL_SIZE;
+
+    return ParticleLod
+    {
+        std::max(static_cast<float>(detail), MIN_COUNT_FRACTION),
+        static_cast<std::size_t>(std::lround((1.0 - detail) * MAX_UPDATE_INTERVAL))
+    };
+}
+
+std::size_t ParticleLodPolicy::requestParticles(std::size_t frame, std::size_t numParticles, std::size_t numParticlesTotal)
+{
+    ensureFrame(frame);
+
+    _statistics.numParticlesRequested += numParticles;
+
+    auto granted = numParticles;
+
+    if (_budget > 0 && _budgetUsed + numParticles > _budget)
+    {
+        granted = _budget - std::min(_budgetUsed, _budget);
+        ++_statistics.numBudgetLimited;
+    }
+
+    _budgetUsed += granted;
+    _statistics.numParticlesSimulated += granted;
+
+    if (granted == 0)
+    {
+        ++_statistics.numSkippedUpdates;
+    }
+    else if (granted < numParticlesTotal)
+    {
+        ++_statistics.numReducedDetail;
+    }
+    else
+    {
+        ++_statistics.numFullDetail;
+    }
+
+    return granted;
+}
+
+void ParticleLodPolicy::onUpdateSkipped(std::size_t frame)
+{
+    ensureFrame(frame);
+
+    ++_statistics.numSkippedUpdates;
+}
+
+const ParticleLodStatistics& ParticleLodPolicy::getStatistics() const
+{
+    return _statistics;
+}
+
+void ParticleLodPolicy::ensureFrame(std::size_t frame)
+{
+    if (frame == _currentFrame) return;
+
+    _currentFrame = frame;
+    _budgetUsed = 0;
+    _statistics = ParticleLodStatistics();
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "iparticles.h"
+#include <sigc++/trackable.h>
+
+namespace particles
+{
+
+// The level of detail a particle system is updated with
+struct ParticleLod
+{
+    // The share of particles to simulate [0..1]
+    float countFraction;
+
+    // The minimum time between two simulation updates, in msecs
+    std::size_t updateIntervalMsec;
+
+    static ParticleLod Full()
+    {
+        return ParticleLod{ 1.0f, 0 };
+    }
+};
+
+/**
+ * Decides about the level of detail of the particle nodes, based on their
+ * projected size in the view. Emitters covering a small part of the view are
+ * simulating fewer particles and are updated less frequently. The number of
+ * particles simulated per frame is limited by a budget, emitters exceeding
+ * it keep their geometry of the previous update.
+ *
+ * The frames are identified by the render system's frame count, the budget
+ * and the statistics are reset as soon as a new frame number shows up.
+ */
+class ParticleLodPolicy :
+    public sigc::trackable
+{
+private:
+    bool _enabled;
+
+    // Maximum number of particles per frame, 0 is unlimited
+    std::size_t _budget;
+
+    std::size_t _currentFrame;
+    std::size_t _budgetUsed;
+
+    ParticleLodStatistics _statistics;
+
+public:
+    ParticleLodPolicy();
+
+    // Loads the settings from the registry and starts observing them
+    void initialise();
+
+    // Returns the LOD of an emitter covering the given fraction of the view width
+    ParticleLod getLod(std::size_t frame, double projectedSize);
+
+    // Takes particles from the budget of the given frame, returns the number granted.
+    // A return value of 0 means that the emitter should not be updated at all.
+    std::size_t requestParticles(std::size_t frame, std::size_t numParticles, std::size_t numParticlesTotal);
+
+    // To be called by emitters keeping their geometry of an earlier frame
+    void onUpdateSkipped(std::size_t frame);
+
+    const ParticleLodStatistics& getStatistics() const;
+
+private:
+    void ensureFrame(std::size_t frame);
+    void loadSettings();
+};
+
+}
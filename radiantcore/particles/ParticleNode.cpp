@@ -1,13 +1,15 @@
 #include "ParticleNode.h"
 
 #include "ivolumetest.h"
+#include <cmath>
 #include "itextstream.h"
 
 namespace particles
 {
 
-ParticleNode::ParticleNode(const RenderableParticlePtr& particle) :
+ParticleNode::ParticleNode(const RenderableParticlePtr& particle, const std::shared_ptr<ParticleLodPolicy>& lodPolicy) :
 	_renderableParticle(particle),
+	_lodPolicy(lodPolicy),
 	_local2Parent(Matrix4::getIdentity())
 {}
 
@@ -99,7 +101,35 @@ void ParticleNode::update(const VolumeTest& viewVolume) const
 	_renderableParticle->setEntityColour(Vector3(
 		_renderEntity->getShaderParm(0), _renderEntity->getShaderParm(1), _renderEntity->getShaderParm(2)));
 
-	_renderableParticle->update(viewRotation, localToWorld(), _renderEntity);
+	auto lodPolicy = _lodPolicy.lock();
+
+	_renderableParticle->update(viewRotation, localToWorld(), _renderEntity, lodPolicy.get(),
+		lodPolicy ? getProjectedSize(viewVolume) : 0);
+}
+
+double ParticleNode::getProjectedSize(const VolumeTest& viewVolume) const
+{
+	// Use the bounds of the previous update, they are only re-calculated after a new update
+	const auto& bounds = worldAABB();
+
+	if (!bounds.isValid())
+	{
+		return 1.0; // unknown size, treat as fully visible
+	}
+
+	// The w coordinate in clip space is the distance to the viewer (or 1 for orthographic views)
+	auto clip = viewVolume.GetViewProjection().transform(Vector4(bounds.getOrigin(), 1));
+	auto distance = clip.w();
+	auto radius = bounds.getExtents().getLength();
+
+	// The view is inside the particle bounds
+	if (distance <= radius)
+	{
+		return 1.0;
+	}
+
+	// The projection matrix is scaling the x coordinates to [-1..1], i.e. the full view width is 2
+	return radius * std::abs(viewVolume.GetProjection().xx()) / distance;
 }
 
 void ParticleNode::onVisibilityChanged(bool isVisibleNow)
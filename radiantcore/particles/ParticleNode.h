@@ -22,11 +22,15 @@ class ParticleNode :
     // The actual particle system that will be rendered
 	RenderableParticlePtr _renderableParticle;
 
+	// The policy deciding about the level of detail (owned by the ParticlesManager)
+	std::weak_ptr<ParticleLodPolicy> _lodPolicy;
+
 	mutable Matrix4 _local2Parent;
 
 public:
-	// Construct the node giving a renderable particle
-	ParticleNode(const RenderableParticlePtr& particle);
+	// Construct the node giving a renderable particle and the LOD policy to use (optional)
+	ParticleNode(const RenderableParticlePtr& particle,
+		const std::shared_ptr<ParticleLodPolicy>& lodPolicy = std::shared_ptr<ParticleLodPolicy>());
 
 	std::string name() const override;
 	Type getNodeType() const override;
@@ -50,6 +54,9 @@ protected:
 
 private:
 	void update(const VolumeTest& viewVolume) const;
+
+	// Returns the approximate fraction of the view width covered by this particle
+	double getProjectedSize(const VolumeTest& viewVolume) const;
 };
 typedef std::shared_ptr<ParticleNode> ParticleNodePtr;
 
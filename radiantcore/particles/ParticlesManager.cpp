@@ -8,6 +8,7 @@
 #include "itextstream.h"
 #include "ifiletypes.h"
 #include "ideclmanager.h"
+#include "iregistry.h"
 #include "i18n.h"
 
 #include <functional>
@@ -61,7 +62,14 @@ IParticleNodePtr ParticlesManager::createParticleNode(const std::string& name)
         return IParticleNodePtr();
     }
 
-	return std::make_shared<ParticleNode>(std::make_shared<RenderableParticle>(def));
+	return std::make_shared<ParticleNode>(std::make_shared<RenderableParticle>(def), _lodPolicy);
+}
+
+const ParticleLodStatistics& ParticlesManager::getLodStatistics() const
+{
+    static const ParticleLodStatistics _emptyStatistics;
+
+    return _lodPolicy ? _lodPolicy->getStatistics() : _emptyStatistics;
 }
 
 IRenderableParticlePtr ParticlesManager::getRenderableParticle(const std::string& name)
@@ -101,6 +109,7 @@ const StringSet& ParticlesManager::getDependencies() const
         MODULE_DECLMANAGER,
         MODULE_COMMANDSYSTEM,
         MODULE_FILETYPES,
+        MODULE_XMLREGISTRY,
     };
 
 	return _dependencies;
@@ -117,11 +126,17 @@ void ParticlesManager::initialiseModule(const IApplicationContext& ctx)
     _defsReloadedConn = GlobalDeclarationManager().signal_DeclsReloaded(decl::Type::Particle).connect(
         [this]() { _particlesReloadedSignal.emit(); }
     );
+
+    _lodPolicy = std::make_shared<ParticleLodPolicy>();
+    _lodPolicy->initialise();
 }
 
 void ParticlesManager::shutdownModule()
 {
     _defsReloadedConn.disconnect();
+
+    // Nodes still alive fall back to full detail
+    _lodPolicy.reset();
 }
 
 void ParticlesManager::saveParticleDef(const std::string& particleName)
@@ -2,6 +2,7 @@
 
 #include "ParticleDef.h"
 #include "StageDef.h"
+#include "ParticleLodPolicy.h"
 
 #include "iparticles.h"
 #include "parser/DefTokeniser.h"
@@ -19,6 +20,9 @@ private:
     sigc::connection _defsReloadedConn;
     sigc::signal<void> _particlesReloadedSignal;
 
+    // Shared by all particle nodes created by this manager
+    std::shared_ptr<ParticleLodPolicy> _lodPolicy;
+
 public:
 	// IParticlesManager implementation
     sigc::signal<void>& signal_particlesReloaded() override;
@@ -34,6 +38,8 @@ public:
     IRenderableParticlePtr getRenderableParticle(const std::string& name) override;
     IParticleNodePtr createParticleNode(const std::string& name) override;
 
+    const ParticleLodStatistics& getLodStatistics() const override;
+
 	void saveParticleDef(const std::string& particle) override;
 
 	// RegisterableModule implementation
@@ -1,8 +1,20 @@
 #include "RenderableParticle.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <future>
+#include <thread>
+
 namespace particles
 {
 
+namespace
+{
+    // The number of particles in all visible stages, before the stages are simulated in parallel
+    const std::size_t PARALLEL_SIMULATION_THRESHOLD = 2048;
+}
+
 RenderableParticle::RenderableParticle(const IParticleDef::Ptr& particleDef) :
 	_particleDef(), // don't initialise the ptr yet
 	_random(rand()), // use a random seed
@@ -21,24 +33,39 @@ RenderableParticle::~RenderableParticle()
 
 // Time is in msecs
 void RenderableParticle::update(const Matrix4& viewRotation, const Matrix4& localToWorld, IRenderEntity* entity)
+{
+    update(viewRotation, localToWorld, entity, nullptr, 0);
+}
+
+void RenderableParticle::update(const Matrix4& viewRotation, const Matrix4& localToWorld, IRenderEntity* entity,
+    ParticleLodPolicy* lodPolicy, double projectedSize)
 {
 	auto renderSystem = _renderSystem.lock();
 
 	if (!renderSystem) return; // no rendersystem there yet
 
 	auto time = renderSystem->getTime();
+	auto frame = renderSystem->getFrameCount();
 
-	// Invalidate our bounds information
-	_bounds = AABB();
+	auto lod = lodPolicy ? lodPolicy->getLod(frame, projectedSize) : ParticleLod::Full();
+
+	// Keep the geometry of the last update for a while, as long as neither the view nor the emitter changed
+	if (lodPolicy && _lastUpdate && lod.updateIntervalMsec > 0 &&
+		time >= _lastUpdate->time && time - _lastUpdate->time < lod.updateIntervalMsec &&
+		_lastUpdate->viewRotation == viewRotation && _lastUpdate->localToWorld == localToWorld &&
+		_lastUpdate->direction == _direction && _lastUpdate->entityColour == _entityColour)
+	{
+		lodPolicy->onUpdateSkipped(frame);
+		return;
+	}
 
 	// Make sure all shaders are constructed
 	ensureShaders(*renderSystem);
 
-	// greebo: Use the inverse matrix of the incoming matrix, this is enough to compensate
-	// the camera rotation.
-	auto invViewRotation = viewRotation.getInverse();
+	// Collect the visible stages, clear the others
+	std::vector<std::pair<RenderableParticleStage*, const ShaderPtr*>> visibleStages;
+	std::size_t numParticles = 0;
 
-	// Traverse the stages and call update
 	for (const auto& pair : _shaderMap)
 	{
 		for (const auto& stage : pair.second.stages)
@@ -49,27 +76,99 @@ void RenderableParticle::update(const Matrix4& viewRotation, const Matrix4& loca
                 continue;
             }
 
-            // Update the particle quads
-            stage->update(time, invViewRotation);
+            visibleStages.emplace_back(stage.get(), &pair.second.shader);
+            numParticles += static_cast<std::size_t>(std::max(stage->getDef().getCount(), 0));
+		}
+	}
+
+	auto countFraction = 1.0f;
 
-            // Check if the stage is empty, otherwise remove any geometry
-            if (stage->getNumQuads() == 0)
-            {
-                stage->clear();
-                continue;
-            }
+	if (lodPolicy && numParticles > 0)
+	{
+		auto requested = static_cast<std::size_t>(std::ceil(numParticles * lod.countFraction));
+		auto granted = lodPolicy->requestParticles(frame, requested, numParticles);
 
-            // Attach the geometry to the shader
-            stage->submitGeometry(pair.second.shader, localToWorld);
+		// Out of budget, the stages keep their current geometry
+		if (granted == 0) return;
 
-            // Attach to the parent entity for lighting mode
-            stage->attachToEntity(entity);
-		}
+		countFraction = static_cast<float>(granted) / numParticles;
+	}
+
+	// Invalidate our bounds information
+	_bounds = AABB();
+
+	// greebo: Use the inverse matrix of the incoming matrix, this is enough to compensate
+	// the camera rotation.
+	auto invViewRotation = viewRotation.getInverse();
+
+	// Update the particle quads, the stages are independent of each other
+	simulateStages(visibleStages, static_cast<std::size_t>(numParticles * countFraction), time, invViewRotation, countFraction);
+
+	_lastUpdate = LastUpdate{ time, viewRotation, localToWorld, _direction, _entityColour };
+
+	for (const auto& [stage, shader] : visibleStages)
+	{
+        // Check if the stage is empty, otherwise remove any geometry
+        if (stage->getNumQuads() == 0)
+        {
+            stage->clear();
+            continue;
+        }
+
+        // Attach the geometry to the shader
+        stage->submitGeometry(*shader, localToWorld);
+
+        // Attach to the parent entity for lighting mode
+        stage->attachToEntity(entity);
 	}
 }
 
+void RenderableParticle::simulateStages(const std::vector<std::pair<RenderableParticleStage*, const ShaderPtr*>>& stages,
+    std::size_t numParticles, std::size_t time, const Matrix4& viewRotation, float countFraction)
+{
+    // Running worker threads only pays off for larger particle systems
+    auto numWorkers = std::min<std::size_t>(stages.size(), std::thread::hardware_concurrency());
+
+    if (numParticles < PARALLEL_SIMULATION_THRESHOLD || numWorkers < 2)
+    {
+        for (const auto& pair : stages)
+        {
+            pair.first->update(time, viewRotation, countFraction);
+        }
+
+        return;
+    }
+
+    std::atomic<std::size_t> nextStage(0);
+    std::vector<std::future<void>> workers;
+
+    // The calling thread is taking part in the work
+    auto simulate = [&]()
+    {
+        for (auto i = nextStage++; i < stages.size(); i = nextStage++)
+        {
+            stages[i].first->update(time, viewRotation, countFraction);
+        }
+    };
+
+    for (std::size_t i = 1; i < numWorkers; ++i)
+    {
+        workers.emplace_back(std::async(std::launch::async, simulate));
+    }
+
+    simulate();
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
 void RenderableParticle::clearRenderables()
 {
+    _lastUpdate.reset();
+
     for (const auto& pair : _shaderMap)
     {
         for (const auto& stage : pair.second.stages)
@@ -160,6 +259,7 @@ void RenderableParticle::calculateBounds()
 void RenderableParticle::setupStages()
 {
 	_shaderMap.clear();
+	_lastUpdate.reset();
 
 	if (!_particleDef) return; // nothing to do.
 
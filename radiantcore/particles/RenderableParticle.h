@@ -1,6 +1,7 @@
 #pragma once
 
 #include "RenderableParticleStage.h"
+#include "ParticleLodPolicy.h"
 
 #include "iparticles.h"
 #include "irender.h"
@@ -8,6 +9,7 @@
 #include "math/AABB.h"
 #include "render.h"
 #include <map>
+#include <optional>
 #include <sigc++/connection.h>
 
 namespace particles
@@ -54,6 +56,17 @@ class RenderableParticle : public IRenderableParticle,
 	// The associated rendersystem, needed to get time an shaders
 	RenderSystemWeakPtr _renderSystem;
 
+	// The input of the most recent update, to decide whether the geometry can be kept
+	struct LastUpdate
+	{
+		std::size_t time;
+		Matrix4 viewRotation;
+		Matrix4 localToWorld;
+		Vector3 direction;
+		Vector3 entityColour;
+	};
+	std::optional<LastUpdate> _lastUpdate;
+
 public:
 	RenderableParticle(const IParticleDef::Ptr& particleDef);
 
@@ -64,6 +77,12 @@ public:
 	// Time is in msecs
 	void update(const Matrix4& viewRotation, const Matrix4& localToWorld, IRenderEntity* entity) override;
 
+	// Update considering the level of detail for the given projected size (the fraction
+	// of the view width covered by the particle). The policy is optional, without it
+	// the particle is updated in full detail.
+	void update(const Matrix4& viewRotation, const Matrix4& localToWorld, IRenderEntity* entity,
+		ParticleLodPolicy* lodPolicy, double projectedSize);
+
     void onPreRender(const VolumeTest& volume) override;
     void renderHighlights(IRenderableCollector& collector, const VolumeTest& volume) override;
 
@@ -91,6 +110,10 @@ private:
 
 	// Capture all shaders, if necessary
 	void ensureShaders(RenderSystem& renderSystem);
+
+	// Updates the quads of the given stages, using worker threads for larger particle counts
+	void simulateStages(const std::vector<std::pair<RenderableParticleStage*, const ShaderPtr*>>& stages,
+		std::size_t numParticles, std::size_t time, const Matrix4& viewRotation, float countFraction);
 };
 typedef std::shared_ptr<RenderableParticle> RenderableParticlePtr;
 
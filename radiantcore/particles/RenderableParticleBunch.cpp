@@ -19,12 +19,13 @@ RenderableParticleBunch::RenderableParticleBunch(std::size_t index,
     _offset(_stage.getOffset()),
     _viewRotation(viewRotation),
     _direction(direction),
-    _entityColour(entityColour)
+    _entityColour(entityColour),
+    _directionRotation(Matrix4::getIdentity())
 {
     // Geometry is written in update(), just reserve the space
 }
 
-void RenderableParticleBunch::update(std::size_t time)
+void RenderableParticleBunch::update(std::size_t time, float countFraction)
 {
     _bounds = AABB();
     _quads.clear();
@@ -47,6 +48,20 @@ void RenderableParticleBunch::update(std::size_t time)
     // Reset the random number generator using our stored seed
     _random.seed(_randSeed);
 
+    // Check if the main direction is different to the z axis, this is the same for all particles
+    Vector3 dir = _direction.getNormalised();
+    Vector3 zDir(0,0,1);
+
+    double deviation = dir.angle(zDir);
+
+    _directionRotation = deviation != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
+
+    // Consider offset as starting point
+    _rotatedOffset = _directionRotation.transformPoint(_offset);
+
+    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
+    _gravity = (_stage.getWorldGravityFlag() ? Vector3(0,0,-1) : -dir) * _stage.getGravity();
+
     // Calculate the time between each particle spawn
     // When bunching is set to 1 the spacing is 0, and vice versa.
     std::size_t stageDurationMsec = static_cast<std::size_t>(SEC2MS(_stage.getDuration()));
@@ -77,6 +92,17 @@ void RenderableParticleBunch::update(std::size_t time)
         // Generate the particle renderinfo structure (our working set)
         ParticleRenderInfo particle(i, _random);
 
+        // Omitted particles still need to advance the RNG like the regular ones below
+        if (countFraction < 1.0f && !isIncluded(i, countFraction))
+        {
+            if (_stage.getInitialAngle() == 0)
+            {
+                _random();
+            }
+
+            continue;
+        }
+
         // Calculate the time fraction [0..1]
         particle.timeFraction = static_cast<float>(particleTime) / stageDurationMsec;
 
@@ -314,16 +340,8 @@ void RenderableParticleBunch::calculateColour(ParticleRenderInfo& particle)
 
 void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
 {
-    // Check if the main direction is different to the z axis
-    Vector3 dir = _direction.getNormalised();
-    Vector3 zDir(0,0,1);
-
-    double deviation = dir.angle(zDir);
-
-    Matrix4 rotation = deviation != 0 ? Matrix4::getRotation(zDir, dir) : Matrix4::getIdentity();
-
-    // Consider offset as starting point
-    particle.origin = rotation.transformPoint(_offset);
+    // Consider offset as starting point, rotated into the main direction in update()
+    particle.origin = _rotatedOffset;
 
     switch (_stage.getCustomPathType())
     {
@@ -336,7 +354,7 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
             particle.origin += distributionOffset;
 
             // Calculate particle direction, pass distribution offset (this is needed for DIRECTION_OUTWARD)
-            Vector3 particleDirection = getDirection(particle, rotation, distributionOffset);
+            Vector3 particleDirection = getDirection(particle, _directionRotation, distributionOffset);
 
             // Consider speed
             particle.origin += particleDirection * integrate(_stage.getSpeed(), particle.timeSecs);
@@ -422,11 +440,8 @@ void RenderableParticleBunch::calculateOrigin(ParticleRenderInfo& particle)
         break;
     };
 
-    // Consider gravity
-    // if "world" is set, use -z as gravity direction, otherwise use the reverse emitter direction
-    Vector3 gravity = _stage.getWorldGravityFlag() ? Vector3(0,0,-1) : -_direction.getNormalised();
-
-    particle.origin += gravity * _stage.getGravity() * particle.timeSecs * particle.timeSecs * 0.5f;
+    // Consider gravity, the direction has been calculated in update()
+    particle.origin += _gravity * particle.timeSecs * particle.timeSecs * 0.5f;
 }
 
 Vector3 RenderableParticleBunch::getDirection(ParticleRenderInfo& particle, const Matrix4& rotation, const Vector3& distributionOffset)
@@ -55,6 +55,11 @@ class RenderableParticleBunch
 	// The entity colour (instance owned by RenderableParticle)
 	const Vector3& _entityColour;
 
+	// Values depending on the particle direction only, calculated once per update
+	Matrix4 _directionRotation;
+	Vector3 _rotatedOffset;
+	Vector3 _gravity;
+
 public:
 	// Each bunch has a defined zero-based index
 	RenderableParticleBunch(std::size_t index,
@@ -71,7 +76,9 @@ public:
 
 	// Update the particle geometry and render information.
 	// Time is specified in stage time without offset,in msecs.
-	void update(std::size_t time);
+	// The count fraction [0..1] defines the share of particles to generate,
+	// the omitted particles are spread evenly across the bunch.
+	void update(std::size_t time, float countFraction = 1.0f);
 
     // Add the renderable geometry to the given arrays
     void addVertexData(std::vector<render::RenderVertex>& vertices,
@@ -85,6 +92,12 @@ public:
     }
 
 private:
+	// Returns true if the particle with the given index is part of the given fraction of particles
+	static bool isIncluded(std::size_t index, float countFraction)
+	{
+		return static_cast<std::size_t>((index + 1) * countFraction) > static_cast<std::size_t>(index * countFraction);
+	}
+
 	// Time is measured in seconds!
 	float integrate(const IParticleParameter& param, float time)
 	{
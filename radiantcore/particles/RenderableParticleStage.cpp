@@ -26,7 +26,7 @@ RenderableParticleStage::RenderableParticleStage(
 }
 
 // Generate particle geometry, time is absolute in msecs
-void RenderableParticleStage::update(std::size_t time, const Matrix4& viewRotation)
+void RenderableParticleStage::update(std::size_t time, const Matrix4& viewRotation, float countFraction)
 {
 	// Invalidate our bounds information
 	_bounds = AABB();
@@ -59,12 +59,12 @@ void RenderableParticleStage::update(std::size_t time, const Matrix4& viewRotati
 	if (_bunches[0])
 	{
 		// Get one of our seed values
-		_bunches[0]->update(localtimeMsec);
+		_bunches[0]->update(localtimeMsec, countFraction);
 	}
 
 	if (_bunches[1])
 	{
-		_bunches[1]->update(localtimeMsec);
+		_bunches[1]->update(localtimeMsec, countFraction);
 	}
 }
 
@@ -83,32 +83,31 @@ std::size_t RenderableParticleStage::getNumQuads() const
 
 void RenderableParticleStage::updateGeometry()
 {
-    std::vector<render::RenderVertex> vertices;
-    std::vector<unsigned int> indices;
+    _vertices.clear();
+    _indices.clear();
 
     auto numQuads = getNumQuads();
 
     if (numQuads == 0)
     {
-        updateGeometryWithData(render::GeometryType::Triangles, vertices,
-                                                   indices);
+        updateGeometryWithData(render::GeometryType::Triangles, _vertices, _indices);
         return;
     }
 
-    vertices.reserve(numQuads * 4);
-    indices.reserve(numQuads * 6);
+    _vertices.reserve(numQuads * 4);
+    _indices.reserve(numQuads * 6);
 
     if (_bunches[0])
     {
-        _bunches[0]->addVertexData(vertices, indices, _localToWorld);
+        _bunches[0]->addVertexData(_vertices, _indices, _localToWorld);
     }
 
     if (_bunches[1])
     {
-        _bunches[1]->addVertexData(vertices, indices, _localToWorld);
+        _bunches[1]->addVertexData(_vertices, _indices, _localToWorld);
     }
 
-    updateGeometryWithData(render::GeometryType::Triangles, vertices, indices);
+    updateGeometryWithData(render::GeometryType::Triangles, _vertices, _indices);
 }
 
 const AABB& RenderableParticleStage::getBounds()
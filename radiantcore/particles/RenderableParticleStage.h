@@ -44,14 +44,19 @@ class RenderableParticleStage :
 	// The entity colour (instance owned by RenderableParticle)
 	const Vector3& _entityColour;
 
+	// The buffers used to assemble the geometry, kept to re-use their capacity every frame
+	std::vector<render::RenderVertex> _vertices;
+	std::vector<unsigned int> _indices;
+
 public:
 	RenderableParticleStage(const IStageDef& stage, 
 							Rand48& random, 
 							const Vector3& direction,
 							const Vector3& entityColour);
 
-	// Generate particle geometry, time is absolute in msecs
-	void update(std::size_t time, const Matrix4& viewRotation);
+	// Generate particle geometry, time is absolute in msecs.
+	// Only the given fraction [0..1] of the stage's particles is generated.
+	void update(std::size_t time, const Matrix4& viewRotation, float countFraction = 1.0f);
 
     void submitGeometry(const ShaderPtr& shader, const Matrix4& localToWorld);
 
@@ -211,12 +211,10 @@ void Patch::testSelect(Selector& selector, SelectionTest& test)
 // Transform this patch as defined by the transformation matrix <matrix>
 void Patch::transform(const Matrix4& matrix)
 {
-    // Cycle through all the patch control vertices and transform the points
-    for (PatchControlIter i = _ctrlTransformed.begin();
-         i != _ctrlTransformed.end();
-         ++i)
+    // Transform the points of all the patch control vertices in one go
+    if (!_ctrlTransformed.empty())
     {
-        i->vertex = matrix.transformPoint(i->vertex);
+        matrix.transformPoints(&_ctrlTransformed.front().vertex, _ctrlTransformed.size(), sizeof(PatchControl));
     }
 
     // Check the handedness of the matrix and invert it if needed
@@ -383,7 +381,23 @@ void Patch::undoSave()
 // Save the current patch state into a new UndoMemento instance (allocated on heap) and return it to the undo observer
 IUndoMementoPtr Patch::exportState() const
 {
-    return IUndoMementoPtr(new SavedState(_width, _height, _ctrl, _patchDef3, _subDivisions.x(), _subDivisions.y(), _shader.getMaterialName()));
+    std::vector<SavedState::Vertex> vertices;
+    std::vector<SavedState::Texcoord> texcoords;
+    vertices.reserve(_ctrl.size());
+    texcoords.reserve(_ctrl.size());
+
+    for (const auto& ctrl : _ctrl)
+    {
+        vertices.push_back({ ctrl.vertex.x(), ctrl.vertex.y(), ctrl.vertex.z() });
+        texcoords.push_back({ ctrl.texcoord.x(), ctrl.texcoord.y() });
+    }
+
+    // Store the differences to the previously saved state only
+    _savedVertices = SavedState::VertexState::Create(vertices, _savedVertices);
+    _savedTexcoords = SavedState::TexcoordState::Create(texcoords, _savedTexcoords);
+
+    return IUndoMementoPtr(new SavedState(_width, _height, _savedVertices, _savedTexcoords,
+        _patchDef3, _subDivisions.x(), _subDivisions.y(), _shader.getInternedMaterialName()));
 }
 
 // Revert the state of this patch to the one that has been saved in the UndoMemento
@@ -399,7 +413,7 @@ void Patch::importState(const IUndoMementoPtr& state)
     {
         _width = other.m_width;
         _height = other.m_height;
-        _ctrl = other.m_ctrl;
+        other.restoreControls(_ctrl);
         _ctrlTransformed = _ctrl;
         _node.updateSelectableControls();
         _patchDef3 = other.m_patchDef3;
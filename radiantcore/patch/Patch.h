@@ -1,11 +1,13 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "transformlib.h"
 #include "editable.h"
 #include "iundo.h"
 #include "irender.h"
+#include "DeltaUndoMemento.h"
 #include "SurfaceShader.h"
 
 #include "PatchConstants.h"
@@ -50,6 +52,10 @@ class Patch :
 	PatchControlArray _ctrlTransformed;	// a temporary control array used during transformations, so that the
 										// changes can be reverted and overwritten by <_ctrl>
 
+	// The most recently exported control point states, the next saved state is stored relative to these
+	mutable std::shared_ptr<const undo::DeltaUndoMemento<std::array<Vector3::ElementType, 3>>> _savedVertices;
+	mutable std::shared_ptr<const undo::DeltaUndoMemento<std::array<Vector2::ElementType, 2>>> _savedTexcoords;
+
 	// The tesselation for this patch
 	PatchTesselation _mesh;
 
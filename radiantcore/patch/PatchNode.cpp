@@ -1,6 +1,7 @@
 #include "PatchNode.h"
 
 #include "ifilter.h"
+#include "iscenestatistics.h"
 #include "ientity.h"
 #include "iradiant.h"
 #include "icounter.h"
@@ -517,6 +518,13 @@ void PatchNode::onMaterialChanged()
 {
     _renderableSurfaceSolid.queueUpdate();
     _renderableSurfaceWireframe.queueUpdate();
+
+    // The new material might be filtered
+    if (inScene())
+    {
+        GlobalFilterSystem().queueUpdate(getSelf());
+        GlobalSceneStatistics().queueUpdate(getSelf());
+    }
 }
 
 void PatchNode::onVisibilityChanged(bool visible)
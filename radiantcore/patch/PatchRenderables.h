@@ -5,6 +5,7 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <iterator>
 #include "PatchTesselation.h"
 #include "PatchControlInstance.h"
@@ -104,12 +105,20 @@ private:
 
     bool _whiteVertexColour;
 
+    // The vertices and dimensions of the last submission. As long as the dimensions
+    // stay the same, only the range of changed vertices is uploaded again.
+    std::vector<render::RenderVertex> _submittedVertices;
+    std::size_t _submittedWidth;
+    std::size_t _submittedHeight;
+
 public:
     // When whiteVertexColour is set to true, all colour vertex attributes will be set to 1,1,1,1
     RenderablePatchTesselation(const PatchTesselation& tess, bool whiteVertexColour) :
         _tess(tess),
         _needsUpdate(true),
-        _whiteVertexColour(whiteVertexColour)
+        _whiteVertexColour(whiteVertexColour),
+        _submittedWidth(0),
+        _submittedHeight(0)
     {}
 
     void queueUpdate()
@@ -127,6 +136,16 @@ protected:
         if (_tess.height == 0 || _tess.width == 0)
         {
             clear();
+            _submittedVertices.clear();
+            return;
+        }
+
+        auto vertices = getColouredVertices();
+
+        if (hasGeometry() && _tess.width == _submittedWidth && _tess.height == _submittedHeight &&
+            vertices.size() == _submittedVertices.size())
+        {
+            updateChangedVertices(vertices);
             return;
         }
 
@@ -136,7 +155,40 @@ protected:
 
         _indexer.generateIndices(_tess, std::back_inserter(indices));
 
-        updateGeometryWithData(_indexer.getType(), getColouredVertices(), indices);
+        updateGeometryWithData(_indexer.getType(), vertices, indices);
+
+        _submittedVertices.swap(vertices);
+        _submittedWidth = _tess.width;
+        _submittedHeight = _tess.height;
+    }
+
+    // Uploads the range between the first and the last vertex that differ from the
+    // previous submission, the index data is still valid for the unchanged topology
+    void updateChangedVertices(const std::vector<render::RenderVertex>& vertices)
+    {
+        auto isEqual = [](const render::RenderVertex& a, const render::RenderVertex& b)
+        {
+            return a.vertex == b.vertex && a.normal == b.normal && a.texcoord == b.texcoord &&
+                a.colour == b.colour && a.tangent == b.tangent && a.bitangent == b.bitangent;
+        };
+
+        auto first = std::mismatch(vertices.begin(), vertices.end(), _submittedVertices.begin(), isEqual);
+
+        if (first.first == vertices.end())
+        {
+            return; // nothing changed
+        }
+
+        auto last = std::mismatch(vertices.rbegin(), vertices.rend(), _submittedVertices.rbegin(), isEqual);
+
+        auto firstIndex = static_cast<std::size_t>(std::distance(vertices.begin(), first.first));
+        auto endIndex = static_cast<std::size_t>(std::distance(last.first, vertices.rend()));
+
+        updateGeometryWithSubData(firstIndex, std::vector<render::RenderVertex>(
+            vertices.begin() + firstIndex, vertices.begin() + endIndex));
+
+        std::copy(vertices.begin() + firstIndex, vertices.begin() + endIndex,
+            _submittedVertices.begin() + firstIndex);
     }
 
     std::vector<render::RenderVertex> getColouredVertices()
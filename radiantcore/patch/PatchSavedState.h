@@ -1,39 +1,82 @@
 #pragma once
 
+#include <array>
 #include "PatchControl.h"
+#include "DeltaUndoMemento.h"
+#include "string/InternedString.h"
 
 /* greebo: This is a structure that is allocated on the heap and contains all the state
  * information of a patch. This information is used by the UndoSystem to save the current
  * patch state and to revert it on request.
+ *
+ * The vertices and texture coordinates of the control points are stored separately, relative
+ * to the previously saved state of the same patch. Most operations only change one of them.
  */
 class SavedState : 
 	public IUndoMemento
 {
 public:
+	// The components are stored as plain arrays, which can be compressed bytewise
+	using Vertex = std::array<Vector3::ElementType, 3>;
+	using Texcoord = std::array<Vector2::ElementType, 2>;
+	using VertexState = undo::DeltaUndoMemento<Vertex>;
+	using TexcoordState = undo::DeltaUndoMemento<Texcoord>;
+
 	// The members to store the state information
 	std::size_t m_width, m_height;
-	PatchControlArray m_ctrl;
+	VertexState::Ptr _vertices;
+	TexcoordState::Ptr _texcoords;
 	bool m_patchDef3;
 	std::size_t m_subdivisions_x;
 	std::size_t m_subdivisions_y;
-    std::string _materialName;
+    string::InternedString _materialName;
 
 	// Constructor
 	SavedState(
 		std::size_t width,
 		std::size_t height,
-		const PatchControlArray& ctrl,
+		const VertexState::Ptr& vertices,
+		const TexcoordState::Ptr& texcoords,
 		bool patchDef3,
 		std::size_t subdivisions_x,
 		std::size_t subdivisions_y,
-        const std::string& materialName
+        const string::InternedString& materialName
 	) :
 		m_width(width),
 		m_height(height),
-		m_ctrl(ctrl),
+		_vertices(vertices),
+		_texcoords(texcoords),
 		m_patchDef3(patchDef3),
 		m_subdivisions_x(subdivisions_x),
 		m_subdivisions_y(subdivisions_y),
         _materialName(materialName)
     {}
+
+	// Assemble the saved control points
+	void restoreControls(PatchControlArray& ctrl) const
+	{
+		std::vector<Vertex> vertices;
+		std::vector<Texcoord> texcoords;
+		_vertices->restore(vertices);
+		_texcoords->restore(texcoords);
+
+		ctrl.resize(vertices.size());
+
+		for (std::size_t i = 0; i < ctrl.size(); ++i)
+		{
+			ctrl[i].vertex = Vector3(vertices[i][0], vertices[i][1], vertices[i][2]);
+			ctrl[i].texcoord = Vector2(texcoords[i][0], texcoords[i][1]);
+		}
+	}
+
+	std::size_t getMemoryUsage() const override
+	{
+		return sizeof(*this) + _vertices->getMemoryUsage() + _texcoords->getMemoryUsage();
+	}
+
+	void compressData() override
+	{
+		_vertices->compressElements();
+		_texcoords->compressElements();
+	}
 };
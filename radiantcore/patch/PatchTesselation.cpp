@@ -1,5 +1,6 @@
 #include "PatchTesselation.h"
 
+#include <algorithm>
 #include "Patch.h"
 
 void PatchTesselation::clear()
@@ -7,6 +8,29 @@ void PatchTesselation::clear()
     *this = PatchTesselation();
 }
 
+bool PatchTesselation::Input::matches(std::size_t otherWidth, std::size_t otherHeight,
+	const PatchControlArray& otherControlPoints, bool otherSubdivisionsFixed,
+	const Subdivisions& otherSubdivisions, const Vector4& otherColour) const
+{
+	if (width != otherWidth || height != otherHeight || subdivisionsFixed != otherSubdivisionsFixed ||
+		colour != otherColour || controlPoints.size() != otherControlPoints.size())
+	{
+		return false;
+	}
+
+	// The subdivisions are only considered in fixed mode
+	if (subdivisionsFixed && subdivisions != otherSubdivisions)
+	{
+		return false;
+	}
+
+	return std::equal(controlPoints.begin(), controlPoints.end(), otherControlPoints.begin(),
+		[](const PatchControl& a, const PatchControl& b)
+	{
+		return a.vertex == b.vertex && a.texcoord == b.texcoord;
+	});
+}
+
 #define	COPLANAR_EPSILON	0.1f
 
 void PatchTesselation::generateNormals()
@@ -197,35 +221,18 @@ void PatchTesselation::generateNormals()
 	}
 }
 
-void PatchTesselation::sampleSinglePatchPoint(const MeshVertex ctrl[3][3], float u, float v, MeshVertex& out) const
+void PatchTesselation::sampleSinglePatchColumn(const double ctrl[3][3][NumSampleComponents], float u,
+	double vCtrl[3][NumSampleComponents])
 {
-	double vCtrl[3][8];
-
 	// find the control points for the v coordinate
 	for (std::size_t vPoint = 0; vPoint < 3; vPoint++)
 	{
-		for (std::size_t axis = 0; axis < 8; axis++)
+		// No branches in here, such that the compiler can vectorise the components
+		for (std::size_t axis = 0; axis < NumSampleComponents; axis++)
 		{
-			double a, b, c;
-
-			if (axis < 3)
-			{
-				a = ctrl[0][vPoint].vertex[axis];
-				b = ctrl[1][vPoint].vertex[axis];
-				c = ctrl[2][vPoint].vertex[axis];
-			}
-			else if (axis < 6)
-			{
-				a = ctrl[0][vPoint].normal[axis - 3];
-				b = ctrl[1][vPoint].normal[axis - 3];
-				c = ctrl[2][vPoint].normal[axis - 3];
-			}
-			else
-			{
-				a = ctrl[0][vPoint].texcoord[axis - 6];
-				b = ctrl[1][vPoint].texcoord[axis - 6];
-				c = ctrl[2][vPoint].texcoord[axis - 6];
-			}
+			double a = ctrl[0][vPoint][axis];
+			double b = ctrl[1][vPoint][axis];
+			double c = ctrl[2][vPoint][axis];
 
 			double qA = a - 2.0 * b + c;
 			double qB = 2.0 * b - 2.0 * a;
@@ -234,9 +241,14 @@ void PatchTesselation::sampleSinglePatchPoint(const MeshVertex ctrl[3][3], float
 			vCtrl[vPoint][axis] = qA * u * u + qB * u + qC;
 		}
 	}
+}
+
+void PatchTesselation::sampleSinglePatchPoint(const double vCtrl[3][NumSampleComponents], float v, MeshVertex& out)
+{
+	double result[NumSampleComponents];
 
 	// interpolate the v value
-	for (std::size_t axis = 0; axis < 8; axis++)
+	for (std::size_t axis = 0; axis < NumSampleComponents; axis++)
 	{
 		double a = vCtrl[0][axis];
 		double b = vCtrl[1][axis];
@@ -245,19 +257,13 @@ void PatchTesselation::sampleSinglePatchPoint(const MeshVertex ctrl[3][3], float
 		double qB = 2.0 * b - 2.0 * a;
 		double qC = a;
 
-		if (axis < 3)
-		{
-			out.vertex[axis] = qA * v * v + qB * v + qC;
-		}
-		else if (axis < 6)
-		{
-			out.normal[axis - 3] = qA * v * v + qB * v + qC;
-		}
-		else
-		{
-			out.texcoord[axis - 6] = qA * v * v + qB * v + qC;
-		}
+		result[axis] = qA * v * v + qB * v + qC;
 	}
+
+	out.vertex.set(result[0], result[1], result[2]);
+	out.normal.set(result[3], result[4], result[5]);
+	out.texcoord[0] = result[6];
+	out.texcoord[1] = result[7];
 }
 
 void PatchTesselation::sampleSinglePatch(const MeshVertex ctrl[3][3],
@@ -268,14 +274,41 @@ void PatchTesselation::sampleSinglePatch(const MeshVertex ctrl[3][3],
 	horzSub++;
 	vertSub++;
 
+	// Gather the interpolated components of the control points in one block
+	double components[3][3][NumSampleComponents];
+
+	for (std::size_t k = 0; k < 3; k++)
+	{
+		for (std::size_t l = 0; l < 3; l++)
+		{
+			const MeshVertex& vertex = ctrl[k][l];
+			double* component = components[k][l];
+
+			component[0] = vertex.vertex[0];
+			component[1] = vertex.vertex[1];
+			component[2] = vertex.vertex[2];
+			component[3] = vertex.normal[0];
+			component[4] = vertex.normal[1];
+			component[5] = vertex.normal[2];
+			component[6] = vertex.texcoord[0];
+			component[7] = vertex.texcoord[1];
+		}
+	}
+
+	double vCtrl[3][NumSampleComponents];
+
 	for (std::size_t i = 0; i < horzSub; i++)
 	{
+		float u = static_cast<float>(i) / (horzSub - 1);
+
+		// The v curve only depends on u, evaluate it once for the whole column
+		sampleSinglePatchColumn(components, u, vCtrl);
+
 		for (std::size_t j = 0; j < vertSub; j++)
 		{
-			float u = static_cast<float>(i) / (horzSub - 1);
 			float v = static_cast<float>(j) / (vertSub - 1);
 
-			sampleSinglePatchPoint(ctrl, u, v, outVerts[((baseRow + j) * w) + i + baseCol]);
+			sampleSinglePatchPoint(vCtrl, v, outVerts[((baseRow + j) * w) + i + baseCol]);
 		}
 	}
 }
@@ -839,6 +872,22 @@ void PatchTesselation::generate(std::size_t patchWidth, std::size_t patchHeight,
 	const PatchControlArray& controlPoints, bool subdivionsFixed, const Subdivisions& subdivs,
     IRenderEntity* renderEntity)
 {
+    auto colour = renderEntity ? renderEntity->getEntityColour() : Vector4(1, 1, 1, 1);
+
+	// Keep the existing mesh if it has been generated from the same input
+	if (!vertices.empty() &&
+		_input.matches(patchWidth, patchHeight, controlPoints, subdivionsFixed, subdivs, colour))
+	{
+		return;
+	}
+
+	_input.width = patchWidth;
+	_input.height = patchHeight;
+	_input.controlPoints = controlPoints;
+	_input.subdivisionsFixed = subdivionsFixed;
+	_input.subdivisions = subdivs;
+	_input.colour = colour;
+
 	width = patchWidth;
 	height = patchHeight;
 
@@ -870,8 +919,6 @@ void PatchTesselation::generate(std::size_t patchWidth, std::size_t patchHeight,
 	}
 
     // Final update: assign colours and normalise normals
-    auto colour = renderEntity ? renderEntity->getEntityColour() : Vector4(1, 1, 1, 1);
-
 	for (MeshVertex& vertex : vertices)
 	{
 	    // normalize all the lerped normals
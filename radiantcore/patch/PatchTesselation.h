@@ -29,6 +29,24 @@ private:
 	std::size_t _maxWidth;
 	std::size_t _maxHeight;
 
+	// The parameters the current mesh has been generated from. Nodes are requesting
+	// a new tesselation for many reasons (scene insertion, undo, colour changes),
+	// if none of the inputs changed the existing mesh is kept.
+	struct Input
+	{
+		std::size_t width = 0;
+		std::size_t height = 0;
+		PatchControlArray controlPoints;
+		bool subdivisionsFixed = false;
+		Subdivisions subdivisions = Subdivisions(0, 0);
+		Vector4 colour = Vector4(1, 1, 1, 1);
+
+		bool matches(std::size_t width, std::size_t height, const PatchControlArray& controlPoints,
+			bool subdivisionsFixed, const Subdivisions& subdivisions, const Vector4& colour) const;
+	};
+
+	Input _input;
+
 public:
 
     /// Construct an uninitialised patch tesselation
@@ -66,7 +84,14 @@ private:
 	void sampleSinglePatch(const MeshVertex ctrl[3][3], std::size_t baseCol, std::size_t baseRow, 
 		std::size_t width, std::size_t horzSub, std::size_t vertSub, 
 		std::vector<MeshVertex>& outVerts) const;
-	void sampleSinglePatchPoint(const MeshVertex ctrl[3][3], float u, float v, MeshVertex& out) const;
+
+	// Number of interpolated components per vertex (vertex, normal, texcoord)
+	static constexpr std::size_t NumSampleComponents = 8;
+
+	// Interpolates the three control rows along u, yielding the control points of the v curve
+	static void sampleSinglePatchColumn(const double ctrl[3][3][NumSampleComponents], float u,
+		double vCtrl[3][NumSampleComponents]);
+	static void sampleSinglePatchPoint(const double vCtrl[3][NumSampleComponents], float v, MeshVertex& out);
 	void deriveTangents();
 	void deriveFaceTangents(std::vector<FaceTangents>& faceTangents);
 };
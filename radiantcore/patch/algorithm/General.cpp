@@ -13,8 +13,11 @@
 #include "selectionlib.h"
 #include "command/ExecutionFailure.h"
 #include "patch/PatchIterators.h"
+#include "math/SpatialHash.h"
 
+#include <algorithm>
 #include <map>
+#include <set>
 
 namespace patch
 {
@@ -218,23 +221,52 @@ struct PatchEdge
     EdgeType edgeType;
 };
 
+constexpr double SHARED_VERTEX_EPSILON = 0.01;
+
 inline bool meshesAreFacingOppositeDirections(const PatchMesh& mesh1, const PatchMesh& mesh2)
 {
-    // Find the first matching 3D vertex and return it
+    // Index the vertices of the second mesh instead of comparing all pairs,
+    // tesselated terrain patches easily have tens of thousands of vertices
+    math::SpatialHash<std::size_t> mesh2Vertices(SHARED_VERTEX_EPSILON);
+
+    for (std::size_t i = 0; i < mesh2.vertices.size(); ++i)
+    {
+        mesh2Vertices.insert(mesh2.vertices[i].vertex, i);
+    }
+
+    // Find the first matching 3D vertex and compare the normals
     for (const auto& v1 : mesh1.vertices)
     {
-        for (const auto& v2 : mesh2.vertices)
+        auto match = mesh2.vertices.size();
+
+        mesh2Vertices.foreachNear(v1.vertex, SHARED_VERTEX_EPSILON, [&](const Vector3&, std::size_t index)
         {
-            if (math::isNear(v1.vertex, v2.vertex, 0.01))
-            {
-                return std::abs(v1.normal.angle(v2.normal)) > c_half_pi;
-            }
+            match = std::min(match, index);
+        });
+
+        if (match < mesh2.vertices.size())
+        {
+            return std::abs(v1.normal.angle(mesh2.vertices[match].normal)) > c_half_pi;
         }
     }
 
     return false;
 }
 
+inline std::vector<Vector3> getCornerControlPoints(const IPatch& patch)
+{
+    auto lastColumn = patch.getWidth() - 1;
+    auto lastRow = patch.getHeight() - 1;
+
+    return
+    {
+        patch.ctrlAt(0, 0).vertex,
+        patch.ctrlAt(0, lastColumn).vertex,
+        patch.ctrlAt(lastRow, 0).vertex,
+        patch.ctrlAt(lastRow, lastColumn).vertex,
+    };
+}
+
 void correctPatchOrientation(const IPatch& originalPatch, IPatch& mergedPatch)
 {
     if (meshesAreFacingOppositeDirections(originalPatch.getTesselatedPatchMesh(), mergedPatch.getTesselatedPatchMesh()))
@@ -394,19 +426,45 @@ void weldPatchPool()
 
     for (const auto& pair : patchesByEntity)
     {
-        // Try to combine each patch of this list with the rest of them O(2n)
-        for (auto p1 = pair.second.begin(); p1 != pair.second.end(); ++p1)
+        const auto& patches = pair.second;
+
+        // Two patches can only be welded if the matching edges share their end points,
+        // which are corner control points of both patches. Index the corners to find
+        // the candidates of each patch instead of trying all pairs.
+        math::SpatialHash<std::size_t> corners(WELD_EPSILON);
+
+        for (std::size_t i = 0; i < patches.size(); ++i)
+        {
+            for (const auto& corner : getCornerControlPoints(patches[i]->getPatch()))
+            {
+                corners.insert(corner, i);
+            }
+        }
+
+        for (std::size_t i = 0; i < patches.size(); ++i)
         {
-            if (!(*p1)->getParent()) continue; // patch has been merged already
+            if (!patches[i]->getParent()) continue; // patch has been merged already
+
+            // Try the candidates in the order they have been selected
+            std::set<std::size_t> candidates;
+
+            for (const auto& corner : getCornerControlPoints(patches[i]->getPatch()))
+            {
+                corners.foreachNear(corner, WELD_EPSILON, [&](const Vector3&, std::size_t index)
+                {
+                    if (index > i) candidates.insert(index);
+                });
+            }
 
-            for (auto p2 = p1 + 1; p2 != pair.second.end(); ++p2)
+            for (auto candidate : candidates)
             {
-                if (!(*p2)->getParent()) continue;// patch has been merged already
+                if (!patches[candidate]->getParent()) continue;// patch has been merged already
 
                 try
                 {
-                    weldPatches(*p1, *p2);
+                    weldPatches(patches[i], patches[candidate]);
                     ++numPatchesCreated;
+                    break; // the first patch has been removed from the scene
                 }
                 catch (const cmd::ExecutionFailure&)
                 {
@@ -7,6 +7,7 @@
 #include "iradiant.h"
 #include "icolourscheme.h"
 #include "ideclmanager.h"
+#include "ifilter.h"
 
 #include "math/Matrix4.h"
 #include "module/StaticModule.h"
@@ -17,12 +18,21 @@
 #include "backend/FullBrightRenderer.h"
 #include "backend/ObjectRenderer.h"
 #include "debugging/debugging.h"
+#include "time/TraceRecorder.h"
+#include "map/OperationReport.h"
 
+#include <chrono>
 #include <functional>
 
 namespace render
 {
 
+namespace
+{
+    // The time each frame may spend on uploading textures decoded in the background
+    constexpr std::chrono::milliseconds TEXTURE_UPLOAD_BUDGET(8);
+}
+
 /**
  * Main constructor.
  */
@@ -32,6 +42,7 @@ OpenGLRenderSystem::OpenGLRenderSystem() :
     _glProgramFactory(std::make_shared<GLProgramFactory>()),
     _currentShaderProgram(SHADER_PROGRAM_NONE),
     _time(0),
+    _frameCount(0),
     _geometryStore(_syncObjectProvider, _bufferObjectProvider),
     _objectRenderer(_geometryStore),
     m_traverseRenderablesMutex(false)
@@ -103,6 +114,9 @@ ShaderPtr OpenGLRenderSystem::capture(const std::string& name, const std::functi
     // Either the shader was not found, or the weak pointer failed to lock
     // because the shader had been deleted. Either way, create a new shader
     // using the given factory functor and insert into the cache.
+    map::OperationReport::ScopedPhase phase(map::OperationReport::Phase::MaterialResolution);
+    map::OperationReport::Increment(map::OperationReport::Counter::Materials);
+
     auto shader = createShader();
     _shaders[name] = shader;
 
@@ -165,37 +179,68 @@ IRenderResult::Ptr OpenGLRenderSystem::renderLitScene(RenderStateFlags globalFla
 IRenderResult::Ptr OpenGLRenderSystem::render(SceneRenderer& renderer, RenderStateFlags globalFlagsMask, const IRenderView& view)
 {
     // Make sure all shaders are ready for rendering, submitting their data to the store
-    for (const auto& [_, shader] : _shaders)
     {
-        shader->prepareForRendering();
+        util::ScopedTraceEvent trace("render", "Prepare shaders");
+
+        for (const auto& [_, shader] : _shaders)
+        {
+            shader->prepareForRendering();
+        }
     }
 
-    auto result = renderer.render(globalFlagsMask, view, _time);
+    IRenderResult::Ptr result;
 
-    renderText();
+    {
+        util::ScopedTraceEvent trace("render", "Render scene");
+        result = renderer.render(globalFlagsMask, view, _time);
+    }
+
+    renderText(view);
 
     return result;
 }
 
 void OpenGLRenderSystem::startFrame()
 {
+    ++_frameCount;
+
+    // Apply the filters to the nodes which changed since the last frame
+    GlobalFilterSystem().processQueuedUpdates();
+
+    // Upload the textures decoded in the background, as long as the frame can afford it
+    GlobalMaterialManager().processAsyncTextureLoads(TEXTURE_UPLOAD_BUDGET);
+
     // Prepare the storage objects
     _geometryStore.onFrameStart();
+
+    // The highlighted windings are collected again for every frame
+    for (const auto& [_, shader] : _shaders)
+    {
+        shader->clearHighlightedWindings();
+    }
 }
 
 void OpenGLRenderSystem::endFrame()
 {
     _geometryStore.onFrameFinished();
+
+    // Let the texture manager know which textures have been drawn, outside of any render pass
+    GlobalMaterialManager().updateTextureResidency(OpenGLState::TakeDrawnTextures());
 }
 
-void OpenGLRenderSystem::renderText()
+std::size_t OpenGLRenderSystem::getFrameCount() const
+{
+    return _frameCount;
+}
+
+void OpenGLRenderSystem::renderText(const IRenderView& view)
 {
     // Render all text
     glDisable(GL_DEPTH_TEST);
 
     for (const auto& [_, textRenderer] : _textRenderers)
     {
-        textRenderer->render();
+        textRenderer->render(view);
     }
 }
 
@@ -299,6 +344,27 @@ void OpenGLRenderSystem::extensionsInitialised()
     // Set the flag in the openGL module
     setShaderProgramsAvailable(haveGLSL);
 
+    // With persistently mapped buffers available we can cycle through several frame buffers
+    // without stalling on the GPU to finish reading the previous frame's geometry
+    if (GLEW_ARB_buffer_storage && !_bufferObjectProvider.persistentMappingEnabled())
+    {
+        rMessage() << "[OpenGLRenderSystem] Using " << GeometryStore::MultiBufferedFrameCount
+            << " persistently mapped geometry buffers.\n";
+
+        _bufferObjectProvider.setPersistentMappingEnabled(true);
+        _geometryStore.setNumFrameBuffers(GeometryStore::MultiBufferedFrameCount);
+    }
+
+    // Packed normals and tangents are using the GL_INT_2_10_10_10_REV attribute type
+    if (GLEW_VERSION_3_3 || GLEW_ARB_vertex_type_2_10_10_10_rev)
+    {
+        rMessage() << "[OpenGLRenderSystem] Using packed vertex attributes.\n";
+        _geometryStore.setVertexFormat(IGeometryStore::VertexFormat::Packed);
+    }
+
+    // Batches of geometry slots can be submitted with a single indirect draw call
+    _objectRenderer.setMultiDrawIndirectEnabled(GLEW_ARB_multi_draw_indirect ? true : false);
+
     // Inform the user of missing extensions
     if (!haveGLSL)
     {
@@ -369,6 +435,17 @@ void OpenGLRenderSystem::setMergeModeEnabled(bool enabled)
     }
 }
 
+const std::string& OpenGLRenderSystem::getMemoryReporterName() const
+{
+    static std::string _name("GeometryStore");
+    return _name;
+}
+
+void OpenGLRenderSystem::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    _geometryStore.reportMemoryUsage(report);
+}
+
 // RegisterableModule implementation
 const std::string& OpenGLRenderSystem::getName() const
 {
@@ -385,6 +462,7 @@ const StringSet& OpenGLRenderSystem::getDependencies() const
         MODULE_SHADERSYSTEM,
         MODULE_XMLREGISTRY,
         MODULE_SHARED_GL_CONTEXT,
+        MODULE_MEMORYACCOUNTING,
     };
 
     return _dependencies;
@@ -406,10 +484,14 @@ void OpenGLRenderSystem::initialiseModule(const IApplicationContext& ctx)
 
     GlobalCommandSystem().addCommand("ShowRenderMemoryStats",
         sigc::mem_fun(*this, &OpenGLRenderSystem::showMemoryStats));
+
+    GlobalMemoryAccounting().registerReporter(*this);
 }
 
 void OpenGLRenderSystem::shutdownModule()
 {
+    GlobalMemoryAccounting().unregisterReporter(*this);
+
     _orthoRenderer.reset();
     _editorPreviewRenderer.reset();
     _lightingModeRenderer.reset();
@@ -5,6 +5,7 @@
 #include <sigc++/connection.h>
 #include <map>
 #include "imodule.h"
+#include "imemoryaccounting.h"
 #include "backend/OpenGLStateManager.h"
 #include "backend/OpenGLShader.h"
 #include "backend/OpenGLStateLess.h"
@@ -27,7 +28,8 @@ typedef std::shared_ptr<GLProgramFactory> GLProgramFactoryPtr;
  */
 class OpenGLRenderSystem final
 : public RenderSystem,
-  public OpenGLStateManager
+  public OpenGLStateManager,
+  public memory::IMemoryReporter
 {
 	// Map of named Shader objects
     std::map<std::string, OpenGLShaderPtr> _shaders;
@@ -58,6 +60,9 @@ class OpenGLRenderSystem final
 	// Render time
 	std::size_t _time;
 
+    // Incremented by startFrame()
+    std::size_t _frameCount;
+
 	sigc::signal<void> _sigExtensionsInitialised;
 
 	sigc::connection _materialDefsLoaded;
@@ -90,6 +95,7 @@ public:
 
     void startFrame() override;
     void endFrame() override;
+    std::size_t getFrameCount() const override;
 
     IRenderResult::Ptr renderFullBrightScene(RenderViewType renderViewType, RenderStateFlags globalstate, const IRenderView& view) override;
     IRenderResult::Ptr renderLitScene(RenderStateFlags globalFlagsMask, const IRenderView& view) override;
@@ -130,6 +136,10 @@ public:
 
     void setMergeModeEnabled(bool enabled) override;
 
+    // IMemoryReporter implementation
+    const std::string& getMemoryReporterName() const override;
+    void reportMemoryUsage(memory::IMemoryReport& report) override;
+
 	// RegisterableModule implementation
     const std::string& getName() const override;
     const StringSet& getDependencies() const override;
@@ -142,7 +152,7 @@ public:
 private:
     IRenderResult::Ptr render(SceneRenderer& renderer, RenderStateFlags globalFlagsMask, const IRenderView& view);
 
-    void renderText();
+    void renderText(const IRenderView& view);
 
     ShaderPtr capture(const std::string& name, const std::function<OpenGLShaderPtr()>& createShader);
 
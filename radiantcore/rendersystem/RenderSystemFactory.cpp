@@ -1,5 +1,7 @@
 #include "RenderSystemFactory.h"
 
+#include <algorithm>
+#include "igl.h"
 #include "itextstream.h"
 #include "module/StaticModule.h"
 
@@ -8,11 +10,52 @@
 namespace render
 {
 
+namespace
+{
+	// The number of preview render systems kept around for re-use
+	constexpr std::size_t MAX_POOLED_PREVIEW_RENDERSYSTEMS = 4;
+}
+
 RenderSystemPtr RenderSystemFactory::createRenderSystem()
 {
     return std::make_shared<OpenGLRenderSystem>();
 }
 
+RenderSystemPtr RenderSystemFactory::acquirePreviewRenderSystem()
+{
+	// A render system referenced by the pool only has been released by its preview
+	for (const auto& renderSystem : _previewRenderSystems)
+	{
+		if (renderSystem.use_count() == 1)
+		{
+			renderSystem->setTime(0);
+			return renderSystem;
+		}
+	}
+
+	auto renderSystem = createRenderSystem();
+
+	if (_previewRenderSystems.size() < MAX_POOLED_PREVIEW_RENDERSYSTEMS)
+	{
+		_previewRenderSystems.push_back(renderSystem);
+	}
+
+	return renderSystem;
+}
+
+void RenderSystemFactory::releaseUnusedPreviewRenderSystems()
+{
+	// The ones still in use are unrealised by their previews
+	_previewRenderSystems.erase(std::remove_if(_previewRenderSystems.begin(), _previewRenderSystems.end(),
+		[](const RenderSystemPtr& renderSystem)
+	{
+		if (renderSystem.use_count() > 1) return false;
+
+		renderSystem->unrealise();
+		return true;
+	}), _previewRenderSystems.end());
+}
+
 const std::string& RenderSystemFactory::getName() const
 {
 	static std::string _name(MODULE_RENDERSYSTEMFACTORY);
@@ -21,12 +64,25 @@ const std::string& RenderSystemFactory::getName() const
 
 const StringSet& RenderSystemFactory::getDependencies() const
 {
-	static StringSet _dependencies; // no dependencies
+	static StringSet _dependencies
+	{
+		MODULE_SHARED_GL_CONTEXT,
+	};
+
 	return _dependencies;
 }
 
 void RenderSystemFactory::initialiseModule(const IApplicationContext& ctx)
 {
+	// The pooled render systems need to free their GL objects while there is a context
+	_sharedContextDestroyed = GlobalOpenGLContext().signal_sharedContextDestroyed().connect(
+		sigc::mem_fun(this, &RenderSystemFactory::releaseUnusedPreviewRenderSystems));
+}
+
+void RenderSystemFactory::shutdownModule()
+{
+	_sharedContextDestroyed.disconnect();
+	_previewRenderSystems.clear();
 }
 
 // Define the static RenderSystemFactory module
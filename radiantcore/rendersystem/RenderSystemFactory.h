@@ -1,6 +1,8 @@
 #ifndef _RENDERSYSTEM_FACTORY_IMPL_H_
 #define _RENDERSYSTEM_FACTORY_IMPL_H_
 
+#include <vector>
+#include <sigc++/connection.h>
 #include "irendersystemfactory.h"
 
 namespace render
@@ -9,13 +11,25 @@ namespace render
 class RenderSystemFactory :
 	public IRenderSystemFactory
 {
+private:
+	// The render systems handed out to previews, the ones
+	// not referenced by anyone else are free to be re-used
+	std::vector<RenderSystemPtr> _previewRenderSystems;
+
+	sigc::connection _sharedContextDestroyed;
+
 public:
 	RenderSystemPtr createRenderSystem();
+	RenderSystemPtr acquirePreviewRenderSystem();
 
 	// RegisterableModule implementation
 	const std::string& getName() const;
 	const StringSet& getDependencies() const;
 	void initialiseModule(const IApplicationContext& ctx);
+	void shutdownModule();
+
+private:
+	void releaseUnusedPreviewRenderSystems();
 };
 
 } // namespace
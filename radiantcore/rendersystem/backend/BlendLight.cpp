@@ -1,5 +1,8 @@
 #include "BlendLight.h"
 
+#include <algorithm>
+#include <map>
+
 #include "OpenGLShader.h"
 #include "glprogram/BlendLightProgram.h"
 
@@ -27,94 +30,180 @@ void BlendLight::collectSurfaces(const IRenderView& view, const std::set<IRender
         entity->foreachRenderableTouchingBounds(_lightBounds,
             [&](const IRenderableObject::Ptr& object, Shader* shader)
         {
-            // Skip empty objects and invisible surfaces
-            if (!object->isVisible() || !shader->isVisible()) return;
+            addObjectIfVisible(view, *object, shader);
+        });
+    }
+}
 
-            // Cull surfaces that are not in view
-            if (object->isOriented())
-            {
-                if (view.TestAABB(object->getObjectBounds(), object->getObjectTransform()) == VOLUME_OUTSIDE)
-                {
-                    return;
-                }
-            }
-            else if (view.TestAABB(object->getObjectBounds()) == VOLUME_OUTSIDE) // non-oriented AABB test
-            {
-                return;
-            }
+void BlendLight::collectSurfaces(const IRenderView& view, const LightInteractionCache::Objects& objects)
+{
+    for (const auto& cached : objects)
+    {
+        auto object = cached.object.lock();
 
-            auto glShader = static_cast<OpenGLShader*>(shader);
+        // Objects might have been removed in the meantime
+        if (!object || cached.entity.expired()) continue;
 
-            // We only consider materials designated for camera rendering
-            if (!glShader->isApplicableTo(RenderViewType::Camera))
-            {
-                return;
-            }
+        addObjectIfVisible(view, *object, cached.shader);
+    }
+}
 
-            // Blend lights only affect materials that interact with lighting
-            if (!glShader->getInteractionPass())
-            {
-                return;
-            }
+void BlendLight::addObjectIfVisible(const IRenderView& view, IRenderableObject& object, Shader* shader)
+{
+    // Skip empty objects and invisible surfaces
+    if (!object.isVisible() || !shader->isVisible()) return;
 
-            _objects.emplace_back(std::ref(*object));
+    // Cull surfaces that are not in view
+    if (object.isOriented())
+    {
+        if (view.TestAABB(object.getObjectBounds(), object.getObjectTransform()) == VOLUME_OUTSIDE)
+        {
+            return;
+        }
+    }
+    else if (view.TestAABB(object.getObjectBounds()) == VOLUME_OUTSIDE) // non-oriented AABB test
+    {
+        return;
+    }
 
-            ++_objectCount;
-        });
+    auto glShader = static_cast<OpenGLShader*>(shader);
+
+    // We only consider materials designated for camera rendering
+    if (!glShader->isApplicableTo(RenderViewType::Camera))
+    {
+        return;
     }
+
+    // Blend lights only affect materials that interact with lighting
+    if (!glShader->getInteractionPass())
+    {
+        return;
+    }
+
+    _objects.emplace_back(std::ref(object));
+
+    ++_objectCount;
 }
 
-void BlendLight::draw(OpenGLState& state, RenderStateFlags globalFlagsMask, 
-    BlendLightProgram& program, const IRenderView& view, std::size_t time)
+std::size_t BlendLight::DrawBatch(const std::vector<BlendLight*>& lights, OpenGLState& state,
+    RenderStateFlags globalFlagsMask, BlendLightProgram& program, std::size_t time)
 {
-    program.setLightTextureTransform(_light.getLightTextureTransformation());
-    auto lightShader = static_cast<OpenGLShader*>(_light.getShader().get());
+    if (lights.empty()) return 0;
+
+    auto lightShader = static_cast<OpenGLShader*>(lights.front()->_light.getShader().get());
+    auto& objectRenderer = lights.front()->_objectRenderer;
 
-    std::vector<IGeometryStore::Slot> untransformedObjects;
-    untransformedObjects.reserve(500);
+    std::size_t drawCalls = 0;
 
-    lightShader->foreachPass([&](OpenGLShaderPass& pass)
+    // The objects touched by the same set of lights, drawn together
+    struct ObjectGroup
     {
-        // Evaluate the stage before deciding whether it's active
-        pass.evaluateShaderStages(time, &_light.getLightEntity());
+        std::vector<IGeometryStore::Slot> untransformedObjects;
+        std::vector<IRenderableObject*> orientedObjects;
+    };
 
-        if (!pass.stateIsActive()) return;
+    std::vector<BlendLightProgram::LightParameters> lightParameters;
+    std::vector<bool> lightIsActive;
+    std::vector<BlendLightProgram::LightParameters> instanceParameters;
 
-        // Apply our state to the current state object
-        pass.applyState(state, globalFlagsMask);
+    for (std::size_t first = 0; first < lights.size(); first += BlendLightProgram::MaxBatchedLights)
+    {
+        auto count = std::min(lights.size() - first, BlendLightProgram::MaxBatchedLights);
 
-        // The light textures will be bound by applyState.
-        // The texture0/texture1 fields were filled in when constructing the pass
+        // Collect the lights touching each object, by their index within this batch
+        std::map<IRenderableObject*, std::vector<std::size_t>> lightsByObject;
 
-        program.setBlendColour(pass.state().getColour());
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            for (const auto& object : lights[first + i]->_objects)
+            {
+                lightsByObject[&object.get()].push_back(i);
+            }
+        }
 
-        for (const auto& objectRef : _objects)
+        std::map<std::vector<std::size_t>, ObjectGroup> objectsByLightSet;
+
+        for (const auto& [object, lightIndices] : lightsByObject)
         {
-            auto& object = objectRef.get();
+            auto& group = objectsByLightSet[lightIndices];
 
-            // We submit all objects with an identity matrix in a single multi draw call
-            if (!object.isOriented())
+            // Untransformed objects are submitted with an identity matrix in a single multi draw call
+            if (object->isOriented())
             {
-                untransformedObjects.push_back(object.getStorageLocation());
-                continue;
+                group.orientedObjects.push_back(object);
+            }
+            else
+            {
+                group.untransformedObjects.push_back(object->getStorageLocation());
             }
-
-            program.setObjectTransform(object.getObjectTransform());
-            
-            _objectRenderer.submitGeometry(object.getStorageLocation(), GL_TRIANGLES);
-            ++_drawCalls;
         }
 
-        if (!untransformedObjects.empty())
+        lightShader->foreachPass([&](OpenGLShaderPass& pass)
         {
-            program.setObjectTransform(Matrix4::getIdentity());
+            lightParameters.resize(count);
+            lightIsActive.assign(count, false);
 
-            _objectRenderer.submitGeometry(untransformedObjects, GL_TRIANGLES);
-            ++_drawCalls;
+            bool anyLightIsActive = false;
 
-            untransformedObjects.clear();
-        }
-    });
+            // Evaluate the stage for each light before deciding whether it's active
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto& light = lights[first + i]->_light;
+
+                pass.evaluateShaderStages(time, &light.getLightEntity());
+
+                if (!pass.stateIsActive()) continue;
+
+                lightIsActive[i] = true;
+                anyLightIsActive = true;
+                lightParameters[i].set(light.getLightTextureTransformation(), pass.state().getColour());
+            }
+
+            if (!anyLightIsActive) return;
+
+            // Apply our state to the current state object
+            // The light textures will be bound by applyState, they are the same for all lights
+            // since the texture0/texture1 fields were filled in when constructing the pass
+            pass.applyState(state, globalFlagsMask);
+
+            for (const auto& [lightIndices, group] : objectsByLightSet)
+            {
+                instanceParameters.clear();
+
+                for (auto index : lightIndices)
+                {
+                    if (lightIsActive[index])
+                    {
+                        instanceParameters.push_back(lightParameters[index]);
+                    }
+                }
+
+                if (instanceParameters.empty()) continue;
+
+                program.setLightParameters(instanceParameters);
+
+                auto numInstances = static_cast<int>(instanceParameters.size());
+
+                if (!group.untransformedObjects.empty())
+                {
+                    program.setObjectTransform(Matrix4::getIdentity());
+
+                    objectRenderer.submitInstancedGeometry(group.untransformedObjects, numInstances, GL_TRIANGLES);
+                    ++drawCalls;
+                }
+
+                for (auto object : group.orientedObjects)
+                {
+                    program.setObjectTransform(object->getObjectTransform());
+
+                    objectRenderer.submitInstancedGeometry(object->getStorageLocation(), numInstances, GL_TRIANGLES);
+                    ++drawCalls;
+                }
+            }
+        });
+    }
+
+    return drawCalls;
 }
 
 }
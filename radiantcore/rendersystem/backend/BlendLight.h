@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vector>
 #include "irender.h"
+#include "LightInteractionCache.h"
 
 namespace render
 {
@@ -30,7 +32,6 @@ private:
     ObjectList _objects;
 
     std::size_t _objectCount;
-    std::size_t _drawCalls;
 
 public:
     BlendLight(RendererLight& light, IGeometryStore& store, IObjectRenderer& objectRenderer);
@@ -39,18 +40,31 @@ public:
     bool isInView(const IRenderView& view);
     void collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities);
 
+    // Collects the surfaces from the cached list of objects touching this light
+    void collectSurfaces(const IRenderView& view, const LightInteractionCache::Objects& objects);
+
     std::size_t getObjectCount() const
     {
         return _objectCount;
     }
 
-    std::size_t getDrawCalls() const
+    RendererLight& getLight()
     {
-        return _drawCalls;
+        return _light;
     }
 
-    void draw(OpenGLState& state, RenderStateFlags globalFlagsMask, BlendLightProgram& program,
-        const IRenderView& view, std::size_t renderTime);
+    /**
+     * Draws the given lights, which must all be using the same light shader.
+     * Each stage is set up once for all lights, the per-light parameters are passed
+     * to the program in a uniform block. Objects touched by the same set of lights
+     * are drawn in a single instanced call, one instance per light.
+     * Returns the number of draw calls issued.
+     */
+    static std::size_t DrawBatch(const std::vector<BlendLight*>& lights, OpenGLState& state,
+        RenderStateFlags globalFlagsMask, BlendLightProgram& program, std::size_t renderTime);
+
+private:
+    void addObjectIfVisible(const IRenderView& view, IRenderableObject& object, Shader* shader);
 };
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <cstring>
 #include "igl.h"
 #include "igeometrystore.h"
 
@@ -98,9 +99,141 @@ private:
         }
     };
 
+    // Buffer object with immutable storage (GL_ARB_buffer_storage) that stays mapped
+    // into client memory for its whole lifetime. Data uploads are plain memory copies,
+    // the coherent mapping makes them visible to the GPU without any further GL calls.
+    // It's up to the client code to not overwrite memory the GPU is still reading from,
+    // which is why these buffers are only used when the GeometryStore is multi-buffered.
+    class PersistentBufferObject final :
+        public IBufferObject
+    {
+    private:
+        GLuint _buffer;
+        GLenum _target;
+        std::size_t _allocatedSize;
+        unsigned char* _mappedData;
+
+        static constexpr GLbitfield MappingFlags = GL_MAP_WRITE_BIT | GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    public:
+        PersistentBufferObject(IBufferObject::Type type) :
+            _buffer(0),
+            _target(type == Type::Vertex ? GL_ARRAY_BUFFER : GL_ELEMENT_ARRAY_BUFFER),
+            _allocatedSize(0),
+            _mappedData(nullptr)
+        {}
+
+        ~PersistentBufferObject() override
+        {
+            releaseStorage();
+        }
+
+        void bind() override
+        {
+            glBindBuffer(_target, _buffer);
+        }
+
+        void unbind() override
+        {
+            glBindBuffer(_target, 0);
+        }
+
+        void setData(std::size_t offset, const unsigned char* firstElement, std::size_t numBytes) override
+        {
+            if (offset + numBytes > _allocatedSize)
+            {
+                throw std::runtime_error("Buffer is too small, resize first");
+            }
+
+            std::memcpy(_mappedData + offset, firstElement, numBytes);
+        }
+
+        std::vector<unsigned char> getData(std::size_t offset, std::size_t numBytes) override
+        {
+            if (offset + numBytes > _allocatedSize)
+            {
+                throw std::runtime_error("Cannot read beyond the end of the buffer");
+            }
+
+            return std::vector<unsigned char>(_mappedData + offset, _mappedData + offset + numBytes);
+        }
+
+        // Buffer storage is immutable, so resizing means replacing the whole buffer object
+        void resize(std::size_t newSize) override
+        {
+            releaseStorage();
+
+            if (newSize == 0) return;
+
+            glGenBuffers(1, &_buffer);
+            debug::assertNoGlErrors();
+
+            glBindBuffer(_target, _buffer);
+
+            glBufferStorage(_target, static_cast<GLsizeiptr>(newSize), nullptr, MappingFlags);
+            debug::assertNoGlErrors();
+
+            _mappedData = static_cast<unsigned char*>(glMapBufferRange(_target, 0,
+                static_cast<GLsizeiptr>(newSize), MappingFlags));
+            debug::assertNoGlErrors();
+
+            glBindBuffer(_target, 0);
+
+            if (_mappedData == nullptr)
+            {
+                throw std::runtime_error("Failed to map the GL buffer storage");
+            }
+
+            _allocatedSize = newSize;
+        }
+
+    private:
+        void releaseStorage()
+        {
+            if (_buffer != 0)
+            {
+                if (_mappedData != nullptr)
+                {
+                    glBindBuffer(_target, _buffer);
+                    glUnmapBuffer(_target);
+                    glBindBuffer(_target, 0);
+                }
+
+                glDeleteBuffers(1, &_buffer);
+            }
+
+            _mappedData = nullptr;
+            _allocatedSize = 0;
+            _buffer = 0;
+        }
+    };
+
+    bool _persistentMappingEnabled;
+
 public:
+    BufferObjectProvider() :
+        _persistentMappingEnabled(false)
+    {}
+
+    // Enables creation of persistently mapped buffer objects (requires GL_ARB_buffer_storage)
+    // Affects only buffer objects created after this call.
+    void setPersistentMappingEnabled(bool enabled)
+    {
+        _persistentMappingEnabled = enabled;
+    }
+
+    bool persistentMappingEnabled() const
+    {
+        return _persistentMappingEnabled;
+    }
+
     IBufferObject::Ptr createBufferObject(IBufferObject::Type type) override
     {
+        if (_persistentMappingEnabled)
+        {
+            return std::make_shared<PersistentBufferObject>(type);
+        }
+
         return std::make_shared<BufferObject>(type);
     }
 };
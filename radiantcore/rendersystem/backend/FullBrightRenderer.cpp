@@ -14,16 +14,24 @@ class FullBrightRenderResult :
 {
 private:
     std::string _statistics;
+    std::size_t _drawnPasses;
 
 public:
-    FullBrightRenderResult(const std::string& statistics) :
-        _statistics(statistics)
+    FullBrightRenderResult(const std::string& statistics, std::size_t drawnPasses) :
+        _statistics(statistics),
+        _drawnPasses(drawnPasses)
     {}
 
     std::string toString() override
     {
         return _statistics;
     }
+
+    std::map<std::string, std::size_t> getCounters() override
+    {
+        // Each drawn pass applies its own state
+        return { { "drawnPasses", _drawnPasses } };
+    }
 };
 
 }
@@ -52,6 +60,8 @@ IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, cons
     // OpenGLShaderPasses (containing the renderable geometry), and render the
     // contents of each bucket. Each pass is passed a reference to the "current"
     // state, which it can change.
+    std::size_t drawnPasses = 0;
+
     for (const auto& [_, pass] : _sortedStates)
     {
         // Render the OpenGLShaderPass
@@ -61,6 +71,7 @@ IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, cons
         {
             // Apply our state to the current state object
             pass->evaluateStagesAndApplyState(current, globalstate, time, nullptr);
+            ++drawnPasses;
             
             if (!pass->hasRenderables())
             {
@@ -83,7 +94,7 @@ IRenderResult::Ptr FullBrightRenderer::render(RenderStateFlags globalstate, cons
 
     cleanupState();
 
-    return std::make_shared<FullBrightRenderResult>(view.getCullStats());
+    return std::make_shared<FullBrightRenderResult>(view.getCullStats(), drawnPasses);
 }
 
 }
@@ -0,0 +1,161 @@
+#include "GLProgramBinaryCache.h"
+
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/dir.h"
+#include "debugging/gl.h"
+
+namespace render
+{
+
+namespace
+{
+    constexpr std::uint32_t CACHE_FILE_MAGIC = 0x42505244; // "DRPB"
+    constexpr std::uint32_t CACHE_FILE_VERSION = 1;
+
+    inline void writeUint32(std::ostream& stream, std::uint32_t value)
+    {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    inline std::uint32_t readUint32(std::istream& stream)
+    {
+        std::uint32_t value = 0;
+        stream.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return value;
+    }
+
+    inline std::string getGLString(GLenum name)
+    {
+        auto value = reinterpret_cast<const char*>(glGetString(name));
+        return value != nullptr ? value : "";
+    }
+}
+
+GLProgramBinaryCache::GLProgramBinaryCache(const std::string& cachePath) :
+    _cachePath(cachePath)
+{}
+
+bool GLProgramBinaryCache::isSupported() const
+{
+    if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+    {
+        return false;
+    }
+
+    // Some drivers advertise the extension without supporting any format
+    GLint numFormats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+
+    return numFormats > 0;
+}
+
+std::string GLProgramBinaryCache::GetDriverString()
+{
+    return getGLString(GL_VENDOR) + "|" + getGLString(GL_RENDERER) + "|" + getGLString(GL_VERSION);
+}
+
+std::string GLProgramBinaryCache::getFilename(const std::string& key) const
+{
+    return _cachePath + key + ".bin";
+}
+
+GLuint GLProgramBinaryCache::loadProgram(const std::string& key)
+{
+    auto filename = getFilename(key);
+
+    if (!os::fileOrDirExists(filename)) return 0;
+
+    std::ifstream file(filename, std::ios::binary);
+
+    if (!file) return 0;
+
+    // The key is derived from the driver string, but check it anyway
+    // to be safe against hash collisions and truncated files
+    if (readUint32(file) != CACHE_FILE_MAGIC || readUint32(file) != CACHE_FILE_VERSION)
+    {
+        return 0;
+    }
+
+    auto binaryFormat = static_cast<GLenum>(readUint32(file));
+
+    std::string driverString(readUint32(file), '\0');
+    file.read(driverString.data(), driverString.size());
+
+    std::vector<char> binary(readUint32(file));
+    file.read(binary.data(), binary.size());
+
+    if (!file || driverString != GetDriverString() || binary.empty())
+    {
+        return 0;
+    }
+
+    auto program = glCreateProgram();
+    glProgramBinary(program, binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Drivers are free to reject binaries, e.g. after an update with the same version string
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+
+    if (linkStatus != GL_TRUE)
+    {
+        rMessage() << "[renderer] Discarding outdated program binary " << filename << std::endl;
+
+        glDeleteProgram(program);
+        file.close();
+        fs::remove(filename);
+
+        return 0;
+    }
+
+    debug::assertNoGlErrors();
+
+    return program;
+}
+
+void GLProgramBinaryCache::storeProgram(const std::string& key, GLuint program)
+{
+    GLint binaryLength = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+
+    if (binaryLength <= 0) return;
+
+    std::vector<char> binary(static_cast<std::size_t>(binaryLength));
+    GLenum binaryFormat = 0;
+    GLsizei length = 0;
+    glGetProgramBinary(program, binaryLength, &length, &binaryFormat, binary.data());
+
+    debug::assertNoGlErrors();
+
+    if (length <= 0) return;
+
+    if (!os::fileOrDirExists(_cachePath) && !os::makeDirectory(_cachePath))
+    {
+        rWarning() << "[renderer] Cannot create program binary folder " << _cachePath << std::endl;
+        return;
+    }
+
+    auto filename = getFilename(key);
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+
+    if (!file)
+    {
+        rWarning() << "[renderer] Cannot write program binary " << filename << std::endl;
+        return;
+    }
+
+    auto driverString = GetDriverString();
+
+    writeUint32(file, CACHE_FILE_MAGIC);
+    writeUint32(file, CACHE_FILE_VERSION);
+    writeUint32(file, static_cast<std::uint32_t>(binaryFormat));
+    writeUint32(file, static_cast<std::uint32_t>(driverString.size()));
+    file.write(driverString.data(), driverString.size());
+    writeUint32(file, static_cast<std::uint32_t>(length));
+    file.write(binary.data(), length);
+}
+
+}
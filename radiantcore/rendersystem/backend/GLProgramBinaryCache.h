@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include "igl.h"
+
+namespace render
+{
+
+/**
+ * On-disk cache of linked GLSL program binaries (GL_ARB_get_program_binary),
+ * to avoid compiling the built-in programs on every startup.
+ *
+ * Entries are addressed by a key that is generated from the GL driver
+ * string and the full program sources, so any change to the driver or the
+ * .glsl files will lead to a cache miss and a recompile.
+ */
+class GLProgramBinaryCache
+{
+private:
+    std::string _cachePath;
+
+public:
+    // Cache files are stored in the given folder, which is created on demand
+    GLProgramBinaryCache(const std::string& cachePath);
+
+    // Returns true if the current context supports retrieving program binaries
+    bool isSupported() const;
+
+    // The string identifying the GL driver of the current context
+    static std::string GetDriverString();
+
+    /**
+     * Loads the program binary stored for the given key into a new program object.
+     * Returns 0 if there's no such binary or the driver refused to load it,
+     * in which case the program needs to be built from its sources.
+     */
+    GLuint loadProgram(const std::string& key);
+
+    // Stores the binary of the given linked program. The program should have been linked
+    // with the GL_PROGRAM_BINARY_RETRIEVABLE_HINT parameter set.
+    void storeProgram(const std::string& key, GLuint program);
+
+private:
+    std::string getFilename(const std::string& key) const;
+};
+
+}
@@ -7,6 +7,7 @@
 #include "glprogram/ShadowMapProgram.h"
 #include "glprogram/RegularStageProgram.h"
 #include "glprogram/BlendLightProgram.h"
+#include "GLProgramBinaryCache.h"
 
 #include "irender.h"
 #include "itextstream.h"
@@ -14,6 +15,7 @@
 #include "imodule.h"
 #include "os/file.h"
 #include "string/convert.h"
+#include "math/Hash.h"
 #include "debugging/debugging.h"
 #include "debugging/gl.h"
 
@@ -99,6 +101,14 @@ std::string getBuiltInGLProgramPath(const std::string& progName)
          + "gl/" + progName;
 }
 
+GLProgramBinaryCache& getProgramBinaryCache()
+{
+    static GLProgramBinaryCache _cache(
+        module::GlobalModuleRegistry().getApplicationContext().getSettingsPath() + "glprograms/");
+
+    return _cache;
+}
+
 // Get file as a char buffer
 CharBufPtr getFileAsBuffer(const std::string& filename)
 {
@@ -243,4 +253,62 @@ GLuint GLProgramFactory::createGLSLProgram(const std::string& vFile,
     return program;
 }
 
+GLuint GLProgramFactory::createGLSLProgram(const std::string& vFile, const std::string& fFile,
+    const AttributeBindings& attributes)
+{
+    auto& cache = getProgramBinaryCache();
+    auto useCache = cache.isSupported();
+
+    std::string key;
+
+    if (useCache)
+    {
+        // Identify the program by the driver, the sources and the attribute locations
+        math::Hash hash;
+        hash.addString(GLProgramBinaryCache::GetDriverString());
+        hash.addString(vFile);
+        hash.addString(&getFileAsBuffer(vFile)->front());
+        hash.addString(fFile);
+        hash.addString(&getFileAsBuffer(fFile)->front());
+
+        for (const auto& [index, name] : attributes)
+        {
+            hash.addSizet(index);
+            hash.addString(name);
+        }
+
+        key = hash;
+
+        if (auto program = cache.loadProgram(key); program != 0)
+        {
+            return program;
+        }
+    }
+
+    auto program = createGLSLProgram(vFile, fFile);
+
+    // Bind vertex attribute locations and link the program again
+    for (const auto& [index, name] : attributes)
+    {
+        glBindAttribLocation(program, index, name.c_str());
+    }
+
+    if (useCache)
+    {
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+
+    glLinkProgram(program);
+    assertProgramLinked(program);
+
+    debug::assertNoGlErrors();
+
+    if (useCache)
+    {
+        cache.storeProgram(key, program);
+    }
+
+    return program;
+}
+
 } // namespace render
@@ -2,6 +2,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 #include "igl.h"
 #include "iglprogram.h"
 
@@ -85,6 +87,24 @@ public:
      * link.
      */
     static GLuint createGLSLProgram(const std::string& vFile, const std::string& fFile);
+
+    // Vertex attribute locations to bind before linking a program
+    using AttributeBindings = std::vector<std::pair<GLuint, std::string>>;
+
+    /**
+     * \brief
+     * Create and link a GLSL program using the given source files, binding the
+     * given attribute locations before linking.
+     *
+     * Linked programs are stored in a program binary cache on disk, if supported
+     * by the driver. Subsequent requests for the same sources and attributes load
+     * the binary from the cache instead of compiling the sources again.
+     *
+     * \return
+     * The linked program object id, ready to be used by glUseProgram().
+     */
+    static GLuint createGLSLProgram(const std::string& vFile, const std::string& fFile,
+        const AttributeBindings& attributes);
 };
 
 } // namespace
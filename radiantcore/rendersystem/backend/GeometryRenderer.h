@@ -141,6 +141,14 @@ public:
         _store.updateData(slotInfo.storageHandle, vertices, indices);
     }
 
+    void updateSubGeometry(Slot slot, std::size_t vertexOffset, const Vertices& vertices) override
+    {
+        const auto& slotInfo = _slots.at(slot);
+
+        // Upload the changed vertex range only
+        _store.updateVertexSubData(slotInfo.storageHandle, vertexOffset, vertices);
+    }
+
     AABB getGeometryBounds(Slot slot) const override
     {
         const auto& slotInfo = _slots.at(slot);
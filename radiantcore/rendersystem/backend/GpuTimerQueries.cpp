@@ -0,0 +1,133 @@
+#include "GpuTimerQueries.h"
+
+namespace render
+{
+
+GpuTimerQueries::GpuTimerQueries() :
+    _frameIndex(0),
+    _hasResults(false),
+    _activePass(Pass::NumPasses)
+{
+    _milliseconds.fill(0);
+}
+
+GpuTimerQueries::~GpuTimerQueries()
+{
+    clear();
+}
+
+bool GpuTimerQueries::isSupported() const
+{
+    return GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+}
+
+void GpuTimerQueries::onFrameStart()
+{
+    if (!isSupported()) return;
+
+    // Check all frames for available results, oldest first
+    for (std::size_t i = 1; i <= NumFrames; ++i)
+    {
+        collectResults((_frameIndex + i) % NumFrames);
+    }
+
+    _frameIndex = (_frameIndex + 1) % NumFrames;
+}
+
+void GpuTimerQueries::beginPass(Pass pass)
+{
+    if (!isSupported()) return;
+
+    auto& query = _queries[_frameIndex][static_cast<std::size_t>(pass)];
+
+    // A query that is still in flight after cycling through all frames is skipped,
+    // it's not allowed to re-issue a query before its result is available
+    if (query.pending) return;
+
+    if (query.id == 0)
+    {
+        glGenQueries(1, &query.id);
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, query.id);
+    query.pending = true;
+
+    _activePass = pass;
+}
+
+void GpuTimerQueries::endPass()
+{
+    if (_activePass == Pass::NumPasses) return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    _activePass = Pass::NumPasses;
+}
+
+void GpuTimerQueries::collectResults(std::size_t frameIndex)
+{
+    auto& queries = _queries[frameIndex];
+
+    bool frameCompleted = true;
+    bool frameHasResults = false;
+
+    for (auto& query : queries)
+    {
+        if (query.pending)
+        {
+            GLint available = 0;
+            glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (!available)
+            {
+                frameCompleted = false;
+                continue;
+            }
+
+            GLuint64 nanoseconds = 0;
+            glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &nanoseconds);
+
+            query.milliseconds = static_cast<double>(nanoseconds) / 1000000.0;
+            query.pending = false;
+            query.completed = true;
+        }
+
+        frameHasResults |= query.completed;
+    }
+
+    // Publish the timings once all passes of that frame are done
+    if (!frameCompleted || !frameHasResults) return;
+
+    for (std::size_t pass = 0; pass < NumPasses; ++pass)
+    {
+        _milliseconds[pass] = queries[pass].completed ? queries[pass].milliseconds : 0;
+        queries[pass].completed = false;
+    }
+
+    _hasResults = true;
+}
+
+void GpuTimerQueries::clear()
+{
+    if (_activePass != Pass::NumPasses)
+    {
+        endPass();
+    }
+
+    for (auto& queries : _queries)
+    {
+        for (auto& query : queries)
+        {
+            if (query.id != 0)
+            {
+                glDeleteQueries(1, &query.id);
+            }
+
+            query = Query();
+        }
+    }
+
+    _milliseconds.fill(0);
+    _hasResults = false;
+}
+
+}
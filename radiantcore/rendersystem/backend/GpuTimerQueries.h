@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include "igl.h"
+
+namespace render
+{
+
+/**
+ * Measures the GPU time spent on the render passes of a frame, using
+ * GL_TIME_ELAPSED queries around each pass.
+ *
+ * To avoid stalling the pipeline, every pass gets a small ring of query
+ * objects. Results are picked up a few frames later, whenever the driver
+ * reports them as available, so the reported times are lagging behind.
+ */
+class GpuTimerQueries
+{
+public:
+    enum class Pass
+    {
+        DepthFill,
+        ShadowMaps,
+        Interactions,
+        BlendLights,
+        NonInteraction,
+        NumPasses
+    };
+
+private:
+    // The number of frames a query result can be outstanding
+    static constexpr std::size_t NumFrames = 4;
+    static constexpr auto NumPasses = static_cast<std::size_t>(Pass::NumPasses);
+
+    struct Query
+    {
+        GLuint id = 0;
+
+        // True if the query has been issued and the result not collected yet
+        bool pending = false;
+
+        // True if the result has been collected, but not published yet
+        bool completed = false;
+        double milliseconds = 0;
+    };
+
+    std::array<std::array<Query, NumPasses>, NumFrames> _queries;
+    std::array<double, NumPasses> _milliseconds;
+
+    std::size_t _frameIndex;
+    bool _hasResults;
+
+    // The currently running pass, only one time query can be active at a time
+    Pass _activePass;
+
+public:
+    GpuTimerQueries();
+    ~GpuTimerQueries();
+
+    // Returns true if the GL context supports timer queries
+    bool isSupported() const;
+
+    // Picks up the available query results and advances to the next set of queries
+    void onFrameStart();
+
+    // Starts measuring the given pass. Passes can't be nested.
+    void beginPass(Pass pass);
+
+    // Stops measuring the pass started with beginPass
+    void endPass();
+
+    // True if the queries of at least one frame have been completed
+    bool hasResults() const
+    {
+        return _hasResults;
+    }
+
+    // The GPU time of the given pass in the most recent completed frame, in milliseconds.
+    // Passes that haven't been run in that frame report 0.
+    double getMilliseconds(Pass pass) const
+    {
+        return _milliseconds[static_cast<std::size_t>(pass)];
+    }
+
+    // Releases all GL query objects, they will be re-created when required
+    void clear();
+
+private:
+    void collectResults(std::size_t frameIndex);
+};
+
+}
@@ -52,16 +52,33 @@ InteractionPass::InteractionPass(OpenGLShader& owner, OpenGLRenderSystem& render
 
     for (auto&& stage : stages)
     {
-        auto texture = getTextureOrInteractionDefault(stage)->getGLTexNum();
-        _interactionStages.emplace_back(Stage{ std::move(stage), texture });
+        auto texture = getTextureOrInteractionDefault(stage);
+        auto textureNum = texture->getGLTexNum();
+        _interactionStages.emplace_back(Stage{ std::move(stage), textureNum, std::move(texture) });
     }
 
-    _defaultBumpTexture = getDefaultInteractionTexture(IShaderLayer::BUMP)->getGLTexNum();
-    _defaultDiffuseTexture = getDefaultInteractionTexture(IShaderLayer::DIFFUSE)->getGLTexNum();
-    _defaultSpecularTexture = getDefaultInteractionTexture(IShaderLayer::SPECULAR)->getGLTexNum();
+    _defaultBumpTexture = getDefaultInteractionTexture(IShaderLayer::BUMP);
+    _defaultDiffuseTexture = getDefaultInteractionTexture(IShaderLayer::DIFFUSE);
+    _defaultSpecularTexture = getDefaultInteractionTexture(IShaderLayer::SPECULAR);
+}
+
+void InteractionPass::updateStageTexture(const IShaderLayer::Ptr& stage)
+{
+    for (auto& interactionStage : _interactionStages)
+    {
+        if (interactionStage.stage != stage) continue;
+
+        interactionStage.textureObject = getTextureOrInteractionDefault(stage);
+        interactionStage.texture = interactionStage.textureObject->getGLTexNum();
+    }
 }
 
 GLuint InteractionPass::getDefaultInteractionTextureBinding(IShaderLayer::Type type)
+{
+    return getDefaultInteractionTextureObject(type)->getGLTexNum();
+}
+
+const TexturePtr& InteractionPass::getDefaultInteractionTextureObject(IShaderLayer::Type type)
 {
     switch (type)
     {
@@ -21,14 +21,17 @@ public:
     {
         IShaderLayer::Ptr stage;
         GLuint texture;
+
+        // The texture object, used to acquire bindless texture handles
+        TexturePtr textureObject;
     };
 
 private:
     std::vector<Stage> _interactionStages;
 
-    GLuint _defaultDiffuseTexture;
-    GLuint _defaultBumpTexture;
-    GLuint _defaultSpecularTexture;
+    TexturePtr _defaultDiffuseTexture;
+    TexturePtr _defaultBumpTexture;
+    TexturePtr _defaultSpecularTexture;
 
 public:
     InteractionPass(OpenGLShader& owner, OpenGLRenderSystem& renderSystem, std::vector<IShaderLayer::Ptr>& stages);
@@ -58,8 +61,13 @@ public:
         return _interactionStages;
     }
 
+    // Re-acquires the texture of the given stage, after its map has been changed
+    void updateStageTexture(const IShaderLayer::Ptr& stage);
+
     GLuint getDefaultInteractionTextureBinding(IShaderLayer::Type type);
 
+    const TexturePtr& getDefaultInteractionTextureObject(IShaderLayer::Type type);
+
     // Generates the state with all the required flags for drawing interaction passes
     static OpenGLState GenerateInteractionState(GLProgramFactory& programFactory);
 
@@ -0,0 +1,169 @@
+#include "LightInteractionCache.h"
+
+#include <algorithm>
+
+namespace render
+{
+
+namespace
+{
+    // Lights not rendered for this many frames are removed from the cache
+    constexpr std::size_t MaxUnusedFrames = 120;
+
+    // Same test as performed by the entities when collecting the objects touching a light
+    bool objectIntersectsBounds(IRenderableObject& object, const AABB& bounds)
+    {
+        if (object.isOriented())
+        {
+            return bounds.intersects(AABB::createFromOrientedAABBSafe(
+                object.getObjectBounds(), object.getObjectTransform()));
+        }
+
+        return bounds.intersects(object.getObjectBounds());
+    }
+}
+
+LightInteractionCache::LightInteractionCache() :
+    _frame(0),
+    _nextVersion(1),
+    _hits(0),
+    _misses(0)
+{}
+
+void LightInteractionCache::update(const std::set<IRenderEntityPtr>& entities)
+{
+    ++_frame;
+    _hits = 0;
+    _misses = 0;
+
+    for (const auto& entity : entities)
+    {
+        auto changeCount = entity->getRenderableChangeCount();
+        auto [existing, inserted] = _entities.try_emplace(entity);
+        auto& data = existing->second;
+
+        data.lastSeenFrame = _frame;
+
+        if (!inserted && data.changeCount == changeCount) continue;
+
+        // Anything touching both the old and the new bounds need to be refreshed
+        auto newBounds = entity->getRenderableBounds();
+
+        if (!inserted)
+        {
+            invalidateLightsTouching(data.bounds);
+        }
+
+        invalidateLightsTouching(newBounds);
+
+        data.changeCount = changeCount;
+        data.bounds = newBounds;
+    }
+
+    // Entities that have been removed invalidate their previous area
+    for (auto it = _entities.begin(); it != _entities.end();)
+    {
+        if (it->second.lastSeenFrame != _frame)
+        {
+            invalidateLightsTouching(it->second.bounds);
+            _entities.erase(it++);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+const LightInteractionCache::Objects& LightInteractionCache::getObjects(RendererLight& light,
+    const std::set<IRenderEntityPtr>& entities)
+{
+    auto& data = _lights[&light];
+    data.lastUsedFrame = _frame;
+
+    auto lightBounds = light.lightAABB();
+
+    if (data.valid && data.lightBounds.origin == lightBounds.origin &&
+        data.lightBounds.extents == lightBounds.extents)
+    {
+        ++_hits;
+        return data.objects;
+    }
+
+    // A shrinking light volume can only lose objects, like when dragging the radius
+    // inwards. Filter the existing list instead of asking every entity again.
+    if (data.valid && data.lightBounds.contains(lightBounds))
+    {
+        ++_hits;
+
+        data.objects.erase(std::remove_if(data.objects.begin(), data.objects.end(), [&](const Object& candidate)
+        {
+            auto object = candidate.object.lock();
+            return !object || !objectIntersectsBounds(*object, lightBounds);
+        }), data.objects.end());
+
+        data.lightBounds = lightBounds;
+        data.version = _nextVersion++;
+
+        return data.objects;
+    }
+
+    ++_misses;
+
+    data.objects.clear();
+    data.lightBounds = lightBounds;
+    data.valid = true;
+    data.version = _nextVersion++;
+
+    for (const auto& entity : entities)
+    {
+        entity->foreachRenderableTouchingBounds(lightBounds,
+            [&](const IRenderableObject::Ptr& object, Shader* shader)
+        {
+            data.objects.emplace_back(Object{ object, entity, shader });
+        });
+    }
+
+    return data.objects;
+}
+
+std::size_t LightInteractionCache::getObjectsVersion(const RendererLight& light) const
+{
+    auto existing = _lights.find(&light);
+
+    return existing != _lights.end() && existing->second.valid ? existing->second.version : 0;
+}
+
+void LightInteractionCache::releaseUnusedLights()
+{
+    for (auto it = _lights.begin(); it != _lights.end();)
+    {
+        if (_frame - it->second.lastUsedFrame > MaxUnusedFrames)
+        {
+            _lights.erase(it++);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+void LightInteractionCache::clear()
+{
+    _lights.clear();
+    _entities.clear();
+}
+
+void LightInteractionCache::invalidateLightsTouching(const AABB& bounds)
+{
+    if (!bounds.isValid()) return;
+
+    for (auto& [_, data] : _lights)
+    {
+        if (data.valid && data.lightBounds.intersects(bounds))
+        {
+            data.valid = false;
+        }
+    }
+}
+
+}
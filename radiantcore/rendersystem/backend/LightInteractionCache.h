@@ -0,0 +1,112 @@
+#pragma once
+
+#include <map>
+#include <set>
+#include <vector>
+#include "irender.h"
+#include "irenderableobject.h"
+
+namespace render
+{
+
+/**
+ * Keeps the list of objects touching each light's bounds across frames,
+ * such that RegularLight doesn't need to query every entity in the scene
+ * for each light in each frame.
+ *
+ * The cached lists are invalidated when the light volume changes, or when
+ * any entity reports a change of its renderables (see
+ * IRenderEntity::getRenderableChangeCount) within the light bounds.
+ * A light volume shrinking within its previous bounds is only filtering
+ * its existing list.
+ * View-dependent culling and visibility checks are not cached, they are
+ * performed by the client code on every frame.
+ */
+class LightInteractionCache
+{
+public:
+    // An object touching a light's bounds, as reported by its entity
+    struct Object
+    {
+        std::weak_ptr<IRenderableObject> object;
+        IRenderEntityWeakPtr entity;
+        Shader* shader;
+    };
+
+    using Objects = std::vector<Object>;
+
+private:
+    struct LightData
+    {
+        AABB lightBounds;
+        Objects objects;
+        bool valid = false;
+        std::size_t lastUsedFrame = 0;
+
+        // Changes every time the object list is re-collected
+        std::size_t version = 0;
+    };
+
+    std::map<const RendererLight*, LightData> _lights;
+
+    struct EntityData
+    {
+        std::size_t changeCount = 0;
+        AABB bounds;
+        std::size_t lastSeenFrame = 0;
+    };
+
+    std::map<IRenderEntityWeakPtr, EntityData, std::owner_less<IRenderEntityWeakPtr>> _entities;
+
+    std::size_t _frame;
+    std::size_t _nextVersion;
+
+    // Per-frame statistics
+    std::size_t _hits;
+    std::size_t _misses;
+
+public:
+    LightInteractionCache();
+
+    /**
+     * Checks all the given entities for changes since the last frame, and invalidates
+     * the cached object lists of all lights affected by these changes.
+     * Entities that disappeared from the set are treated as changed too.
+     */
+    void update(const std::set<IRenderEntityPtr>& entities);
+
+    /**
+     * Returns the objects touching the given light, re-collecting them from
+     * the given entities if the cached list is out of date.
+     */
+    const Objects& getObjects(RendererLight& light, const std::set<IRenderEntityPtr>& entities);
+
+    /**
+     * Returns a number identifying the object list currently cached for the given light.
+     * The number changes whenever the list needs to be re-collected, and is 0 for
+     * lights that are not known to the cache.
+     */
+    std::size_t getObjectsVersion(const RendererLight& light) const;
+
+    // Removes the data of lights that have not been requested for a while
+    void releaseUnusedLights();
+
+    void clear();
+
+    // The number of getObjects() calls in the current frame that were served from the cache
+    std::size_t getHits() const
+    {
+        return _hits;
+    }
+
+    // The number of getObjects() calls in the current frame that required re-collection
+    std::size_t getMisses() const
+    {
+        return _misses;
+    }
+
+private:
+    void invalidateLightsTouching(const AABB& bounds);
+};
+
+}
@@ -0,0 +1,197 @@
+#include "LightOcclusionQueries.h"
+
+#include "OpenGLState.h"
+#include "RegularLight.h"
+
+namespace render
+{
+
+namespace
+{
+    // Pending queries older than this many frames are re-issued
+    constexpr std::size_t MaxQueryAge = 3;
+
+    // Query objects of lights not checked for this many frames are released
+    constexpr std::size_t MaxUnusedFrames = 60;
+
+    // Results are discarded if the viewer moved further than this since issuing the query
+    constexpr double MaxViewerDistance = 64.0;
+
+    // The light box is expanded by this amount when checking if the viewer is inside,
+    // to account for the near clip plane cutting away the box faces
+    constexpr double ViewerInsideEpsilon = 8.0;
+
+    void drawBox(const AABB& box)
+    {
+        const auto& o = box.getOrigin();
+        const auto& e = box.getExtents();
+
+        Vector3 min = o - e;
+        Vector3 max = o + e;
+
+        glBegin(GL_QUADS);
+
+        // -x / +x
+        glVertex3d(min.x(), min.y(), min.z()); glVertex3d(min.x(), min.y(), max.z());
+        glVertex3d(min.x(), max.y(), max.z()); glVertex3d(min.x(), max.y(), min.z());
+        glVertex3d(max.x(), min.y(), min.z()); glVertex3d(max.x(), max.y(), min.z());
+        glVertex3d(max.x(), max.y(), max.z()); glVertex3d(max.x(), min.y(), max.z());
+
+        // -y / +y
+        glVertex3d(min.x(), min.y(), min.z()); glVertex3d(max.x(), min.y(), min.z());
+        glVertex3d(max.x(), min.y(), max.z()); glVertex3d(min.x(), min.y(), max.z());
+        glVertex3d(min.x(), max.y(), min.z()); glVertex3d(min.x(), max.y(), max.z());
+        glVertex3d(max.x(), max.y(), max.z()); glVertex3d(max.x(), max.y(), min.z());
+
+        // -z / +z
+        glVertex3d(min.x(), min.y(), min.z()); glVertex3d(min.x(), max.y(), min.z());
+        glVertex3d(max.x(), max.y(), min.z()); glVertex3d(max.x(), min.y(), min.z());
+        glVertex3d(min.x(), min.y(), max.z()); glVertex3d(max.x(), min.y(), max.z());
+        glVertex3d(max.x(), max.y(), max.z()); glVertex3d(min.x(), max.y(), max.z());
+
+        glEnd();
+    }
+}
+
+LightOcclusionQueries::LightOcclusionQueries() :
+    _frame(0)
+{}
+
+LightOcclusionQueries::~LightOcclusionQueries()
+{
+    clear();
+}
+
+void LightOcclusionQueries::onFrameStart()
+{
+    ++_frame;
+}
+
+bool LightOcclusionQueries::isOccluded(const RendererLight& light, const IRenderView& view)
+{
+    auto found = _queries.find(&light);
+
+    if (found == _queries.end()) return false; // never tested
+
+    auto& query = found->second;
+    query.lastUsedFrame = _frame;
+
+    if (query.pending)
+    {
+        GLint available = 0;
+        glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        // Don't wait for the result, consider the light visible for now
+        if (!available) return false;
+
+        GLuint samplesPassed = 0;
+        glGetQueryObjectuiv(query.id, GL_QUERY_RESULT, &samplesPassed);
+
+        query.pending = false;
+        query.occluded = samplesPassed == 0;
+    }
+
+    if (!query.occluded) return false;
+
+    // Don't trust the result if the viewer moved away or went into the light volume
+    if ((query.viewer - view.getViewer()).getLengthSquared() > MaxViewerDistance * MaxViewerDistance ||
+        viewerIsInside(light.lightAABB(), view))
+    {
+        query.occluded = false;
+        return false;
+    }
+
+    return true;
+}
+
+void LightOcclusionQueries::issueQueries(OpenGLState& current, const std::vector<RegularLight>& lights,
+    const IRenderView& view)
+{
+    if (lights.empty()) return;
+
+    // Depth test against the filled depth buffer, but don't write anything
+    OpenGLState queryState;
+    queryState.setRenderFlag(RENDER_MASKCOLOUR);
+    queryState.setRenderFlag(RENDER_FILL);
+    queryState.setRenderFlag(RENDER_DEPTHTEST);
+    queryState.setDepthFunc(GL_LEQUAL);
+
+    queryState.applyTo(current, RENDER_MASKCOLOUR | RENDER_FILL | RENDER_DEPTHTEST);
+
+    for (const auto& regularLight : lights)
+    {
+        const auto& light = regularLight.getLight();
+        auto lightBounds = light.lightAABB();
+
+        auto& query = _queries.emplace(&light, Query()).first->second;
+        query.lastUsedFrame = _frame;
+
+        // Wait for the previous result to arrive before issuing a new one
+        if (query.pending && _frame - query.issuedFrame < MaxQueryAge) continue;
+
+        // Lights enclosing the viewer are always visible, no need to ask the GPU
+        if (viewerIsInside(lightBounds, view))
+        {
+            query.pending = false;
+            query.occluded = false;
+            continue;
+        }
+
+        if (query.id == 0)
+        {
+            glGenQueries(1, &query.id);
+        }
+
+        glBeginQuery(GL_SAMPLES_PASSED, query.id);
+        drawBox(lightBounds);
+        glEndQuery(GL_SAMPLES_PASSED);
+
+        query.viewer = view.getViewer();
+        query.issuedFrame = _frame;
+        query.pending = true;
+    }
+
+    debug::assertNoGlErrors();
+}
+
+void LightOcclusionQueries::releaseUnusedQueries()
+{
+    for (auto it = _queries.begin(); it != _queries.end();)
+    {
+        if (_frame - it->second.lastUsedFrame > MaxUnusedFrames)
+        {
+            if (it->second.id != 0)
+            {
+                glDeleteQueries(1, &it->second.id);
+            }
+
+            _queries.erase(it++);
+            continue;
+        }
+
+        ++it;
+    }
+}
+
+void LightOcclusionQueries::clear()
+{
+    for (auto& [_, query] : _queries)
+    {
+        if (query.id != 0)
+        {
+            glDeleteQueries(1, &query.id);
+        }
+    }
+
+    _queries.clear();
+}
+
+bool LightOcclusionQueries::viewerIsInside(const AABB& lightBounds, const IRenderView& view) const
+{
+    AABB expanded = lightBounds;
+    expanded.extents += Vector3(ViewerInsideEpsilon, ViewerInsideEpsilon, ViewerInsideEpsilon);
+
+    return expanded.intersects(view.getViewer());
+}
+
+}
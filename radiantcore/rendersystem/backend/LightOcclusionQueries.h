@@ -0,0 +1,81 @@
+#pragma once
+
+#include <map>
+#include <vector>
+#include "igl.h"
+#include "irender.h"
+#include "irenderview.h"
+#include "math/Vector3.h"
+
+namespace render
+{
+
+class OpenGLState;
+class RegularLight;
+
+/**
+ * Hardware occlusion culling of lights, working on the depth buffer that
+ * has been populated by the depth fill pass.
+ *
+ * After the depth fill, the bounding box of every visible light is rasterised
+ * against the depth buffer inside an occlusion query, with colour and depth
+ * writes disabled. The query results are picked up in the next frame without
+ * stalling the pipeline: lights that didn't produce a single sample can be
+ * rejected before their interactions and shadow maps are set up.
+ *
+ * Results are only trusted if the viewer didn't move too far in between,
+ * since the same renderer is shared between several camera views.
+ */
+class LightOcclusionQueries
+{
+private:
+    struct Query
+    {
+        GLuint id = 0;
+
+        // The viewer position used when the query has been issued
+        Vector3 viewer;
+
+        // The frame number this query has been issued in
+        std::size_t issuedFrame = 0;
+
+        // The frame number this query has been issued or checked last
+        std::size_t lastUsedFrame = 0;
+
+        // True while the query result has not been picked up yet
+        bool pending = false;
+
+        // Result of the last completed query
+        bool occluded = false;
+    };
+
+    std::map<const RendererLight*, Query> _queries;
+
+    std::size_t _frame;
+
+public:
+    LightOcclusionQueries();
+    ~LightOcclusionQueries();
+
+    // Advances the frame counter, to be called before any lights are checked
+    void onFrameStart();
+
+    // Returns true if the given light had been fully hidden behind the depth buffer
+    // when it has been tested last, and the viewer is still close to that position.
+    bool isOccluded(const RendererLight& light, const IRenderView& view);
+
+    // Issues occlusion queries for the given lights, the depth buffer must be populated.
+    // Changes the GL state to depth-test only, the given state is updated accordingly.
+    void issueQueries(OpenGLState& current, const std::vector<RegularLight>& lights, const IRenderView& view);
+
+    // Releases the queries of lights that haven't been around for a while
+    void releaseUnusedQueries();
+
+    // Releases all GL query objects, queries will be re-created when required
+    void clear();
+
+private:
+    bool viewerIsInside(const AABB& lightBounds, const IRenderView& view) const;
+};
+
+}
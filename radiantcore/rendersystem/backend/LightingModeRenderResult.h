@@ -13,6 +13,13 @@ public:
     std::size_t visibleLights = 0;
     std::size_t skippedLights = 0;
 
+    // Lights which could re-use the objects collected in previous frames
+    std::size_t cachedLights = 0;
+
+    // Lights (and their objects) rejected by the occlusion test
+    std::size_t occludedLights = 0;
+    std::size_t occludedObjects = 0;
+
     std::size_t entities = 0;
     std::size_t objects = 0;
 
@@ -21,11 +28,57 @@ public:
     std::size_t nonInteractionDrawCalls = 0;
     std::size_t shadowDrawCalls = 0;
 
+    // Program and texture switches between the non-interaction draw calls
+    std::size_t nonInteractionStateChanges = 0;
+
+    // Shadow casting lights that could re-use their shadow map tile from the previous frame
+    std::size_t cachedShadowMaps = 0;
+
+    // GPU time per pass in milliseconds, only available if GPU timing is enabled.
+    // The timer query results are picked up a few frames late, to not stall the pipeline.
+    bool hasGpuTimes = false;
+    double depthFillTime = 0;
+    double shadowMapTime = 0;
+    double interactionTime = 0;
+    double blendLightTime = 0;
+    double nonInteractionTime = 0;
+
     std::string toString() override
     {
-        return fmt::format("Lights: {0}/{1} | Ents: {2} | Objs: {3} | Draws: D={4}|Int={5}|Bl={6}|Shdw={7}", 
+        auto result = fmt::format("Lights: {0}/{1} | Ents: {2} | Objs: {3} | Draws: D={4}|Int={5}|Bl={6}|Shdw={7} | States: {12} | Culled: L={8}|O={9} | Cached: {10}|Shdw={11}", 
             visibleLights, visibleLights + skippedLights, entities, objects, depthDrawCalls, 
-            interactionDrawCalls, nonInteractionDrawCalls, shadowDrawCalls);
+            interactionDrawCalls, nonInteractionDrawCalls, shadowDrawCalls, occludedLights, occludedObjects, cachedLights, cachedShadowMaps,
+            nonInteractionStateChanges);
+
+        if (hasGpuTimes)
+        {
+            result += fmt::format(" | GPU: D={0:.2f}|Shdw={1:.2f}|Int={2:.2f}|Bl={3:.2f}|NI={4:.2f} ms",
+                depthFillTime, shadowMapTime, interactionTime, blendLightTime, nonInteractionTime);
+        }
+
+        return result;
+    }
+
+    double getGpuMilliseconds() override
+    {
+        return hasGpuTimes ? depthFillTime + shadowMapTime + interactionTime + blendLightTime + nonInteractionTime : 0;
+    }
+
+    std::map<std::string, std::size_t> getCounters() override
+    {
+        return
+        {
+            { "visibleLights", visibleLights },
+            { "skippedLights", skippedLights },
+            { "occludedLights", occludedLights },
+            { "entities", entities },
+            { "objects", objects },
+            { "depthDrawCalls", depthDrawCalls },
+            { "interactionDrawCalls", interactionDrawCalls },
+            { "nonInteractionDrawCalls", nonInteractionDrawCalls },
+            { "shadowDrawCalls", shadowDrawCalls },
+            { "nonInteractionStateChanges", nonInteractionStateChanges },
+        };
     }
 };
 
@@ -1,5 +1,7 @@
 #include "LightingModeRenderer.h"
 
+#include <algorithm>
+
 #include "GLProgramFactory.h"
 #include "LightingModeRenderResult.h"
 #include "OpenGLShaderPass.h"
@@ -10,10 +12,35 @@
 #include "glprogram/DepthFillAlphaProgram.h"
 #include "glprogram/InteractionProgram.h"
 #include "glprogram/RegularStageProgram.h"
+#include "time/TraceRecorder.h"
 
 namespace render
 {
 
+namespace
+{
+    // Chooses the shadow map resolution by the approximate screen space size of the light,
+    // every level halves the face size of the shadow map tile
+    std::size_t getShadowMapLevel(const RegularLight& light, const Vector3& viewer, std::size_t maxLevel)
+    {
+        auto lightBounds = light.getLight().lightAABB();
+
+        if (lightBounds.intersects(viewer)) return 0;
+
+        auto distance = (lightBounds.getOrigin() - viewer).getLength();
+        auto ratio = lightBounds.getRadius() / distance;
+
+        std::size_t level = 0;
+
+        for (auto threshold = 0.5; level < maxLevel && ratio < threshold; threshold *= 0.5)
+        {
+            ++level;
+        }
+
+        return level;
+    }
+}
+
 LightingModeRenderer::LightingModeRenderer(GLProgramFactory& programFactory,
         IGeometryStore& store, IObjectRenderer& objectRenderer, 
         const std::set<RendererLightPtr>& lights,
@@ -26,10 +53,16 @@ LightingModeRenderer::LightingModeRenderer(GLProgramFactory& programFactory,
     _entities(entities),
     _shadowMapProgram(nullptr),
     _blendLightProgram(nullptr),
-    _shadowMappingEnabled(RKEY_ENABLE_SHADOW_MAPPING)
+    _shadowMappingEnabled(RKEY_ENABLE_SHADOW_MAPPING),
+    _occlusionCullingEnabled(RKEY_ENABLE_LIGHT_OCCLUSION_CULLING),
+    _gpuTimingEnabled(RKEY_ENABLE_GPU_TIMING),
+    _bindlessTexturesEnabled(RKEY_ENABLE_BINDLESS_TEXTURES),
+    _shadowMapAtlas(FrameBuffer::DefaultShadowMapSize, ShadowMapAtlasRows, MaxShadowMapLevel)
 {
     _untransformedObjectsWithoutAlphaTest.reserve(10000);
     _nearestShadowLights.reserve(MaxShadowCastingLights + 1);
+    _shadowMapRectangles.reserve(MaxShadowCastingLights);
+    _shadowMapsToRender.reserve(MaxShadowCastingLights);
 }
 
 void LightingModeRenderer::ensureShadowMapSetup()
@@ -40,16 +73,9 @@ void LightingModeRenderer::ensureShadowMapSetup()
     {
         _shadowMapFbo = FrameBuffer::CreateShadowMapBuffer();
 
-        // Define the shadow atlas regions (supporting 6 lights)
-        _shadowMapAtlas.resize(6);
-
-        for (int i = 0; i < 6; ++i)
-        {
-            _shadowMapAtlas[i].x = 0;
-            _shadowMapAtlas[i].y = static_cast<int>((_shadowMapFbo->getHeight() / 6) * i);
-            _shadowMapAtlas[i].width = static_cast<int>(_shadowMapFbo->getWidth() / 6);
-            _shadowMapAtlas[i].height = static_cast<int>(_shadowMapFbo->getHeight() / 6);
-        }
+        // Any tiles allocated so far refer to the previous texture
+        _shadowMapTiles.clear();
+        _shadowMapAtlas.clear();
     }
 
     if (!_shadowMapProgram)
@@ -66,8 +92,22 @@ IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask
 
     ensureShadowMapSetup();
 
+    _occlusionQueries.onFrameStart();
+
+    collectGpuTimes();
+
+    // Invalidate the cached interactions affected by any entity changes
+    _interactionCache.update(_entities);
+
     // Check and categorise all lights in view
-    collectLights(view);
+    {
+        util::ScopedTraceEvent trace("render", "Collect lights");
+        collectLights(view);
+    }
+
+    _interactionCache.releaseUnusedLights();
+
+    _result->cachedLights = _interactionCache.getHits();
 
     // Construct default OpenGL state
     OpenGLState current;
@@ -85,22 +125,50 @@ IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask
     _objectRenderer.initAttributePointers();
 
     // Render depth information to the shadow maps
-    drawShadowMaps(current, time);
+    {
+        util::ScopedTraceEvent trace("render", "Shadow maps");
+        beginTimedPass(GpuTimerQueries::Pass::ShadowMaps);
+        drawShadowMaps(current, time);
+        endTimedPass();
+    }
 
     // Load the model view & projection matrix for the main scene
     setupViewMatrices(view);
 
     // Run the depth fill pass
-    drawDepthFillPass(current, globalFlagsMask, view, time);
+    {
+        util::ScopedTraceEvent trace("render", "Depth fill");
+        beginTimedPass(GpuTimerQueries::Pass::DepthFill);
+        drawDepthFillPass(current, globalFlagsMask, view, time);
+        endTimedPass();
+    }
+
+    // Test the light volumes against the filled depth buffer, for use in the next frame
+    issueOcclusionQueries(current, view);
 
     // Draw the surfaces per light and material
-    drawInteractingLights(current, globalFlagsMask, view, time);
+    {
+        util::ScopedTraceEvent trace("render", "Interactions");
+        beginTimedPass(GpuTimerQueries::Pass::Interactions);
+        drawInteractingLights(current, globalFlagsMask, view, time);
+        endTimedPass();
+    }
 
     // Draw any surfaces without any light interactions
-    drawNonInteractionPasses(current, globalFlagsMask, view, time);
+    {
+        util::ScopedTraceEvent trace("render", "Non-interaction passes");
+        beginTimedPass(GpuTimerQueries::Pass::NonInteraction);
+        drawNonInteractionPasses(current, globalFlagsMask, view, time);
+        endTimedPass();
+    }
 
     // Draw blend lights
-    drawBlendLights(current, globalFlagsMask, view, time);
+    {
+        util::ScopedTraceEvent trace("render", "Blend lights");
+        beginTimedPass(GpuTimerQueries::Pass::BlendLights);
+        drawBlendLights(current, globalFlagsMask, view, time);
+        endTimedPass();
+    }
 
     vertexBuffer->unbind();
     indexBuffer->unbind();
@@ -110,11 +178,50 @@ IRenderResult::Ptr LightingModeRenderer::render(RenderStateFlags globalFlagsMask
     // Cleanup the data accumulated in this render pass
     _regularLights.clear();
     _nearestShadowLights.clear();
+    _shadowMapRectangles.clear();
+    _shadowMapsToRender.clear();
     _blendLights.clear();
 
     return std::move(_result); // move-return our result reference
 }
 
+void LightingModeRenderer::collectGpuTimes()
+{
+    if (!_gpuTimingEnabled.get())
+    {
+        // Release the query objects when the timing gets switched off
+        _timerQueries.clear();
+        return;
+    }
+
+    _timerQueries.onFrameStart();
+
+    if (!_timerQueries.hasResults()) return;
+
+    _result->hasGpuTimes = true;
+    _result->depthFillTime = _timerQueries.getMilliseconds(GpuTimerQueries::Pass::DepthFill);
+    _result->shadowMapTime = _timerQueries.getMilliseconds(GpuTimerQueries::Pass::ShadowMaps);
+    _result->interactionTime = _timerQueries.getMilliseconds(GpuTimerQueries::Pass::Interactions);
+    _result->blendLightTime = _timerQueries.getMilliseconds(GpuTimerQueries::Pass::BlendLights);
+    _result->nonInteractionTime = _timerQueries.getMilliseconds(GpuTimerQueries::Pass::NonInteraction);
+}
+
+void LightingModeRenderer::beginTimedPass(GpuTimerQueries::Pass pass)
+{
+    if (_gpuTimingEnabled.get())
+    {
+        _timerQueries.beginPass(pass);
+    }
+}
+
+void LightingModeRenderer::endTimedPass()
+{
+    if (_gpuTimingEnabled.get())
+    {
+        _timerQueries.endPass();
+    }
+}
+
 void LightingModeRenderer::collectLights(const IRenderView& view)
 {
     _regularLights.reserve(_lights.size());
@@ -133,11 +240,8 @@ void LightingModeRenderer::collectLights(const IRenderView& view)
         collectRegularLight(*light, view);
     }
 
-    // Assign shadow light indices
-    for (auto index = 0; index < _nearestShadowLights.size(); ++index)
-    {
-        _nearestShadowLights[index]->setShadowLightIndex(index);
-    }
+    // Assign shadow light indices and atlas tiles
+    assignShadowMapTiles(view.getViewer());
 }
 
 void LightingModeRenderer::collectRegularLight(RendererLight& light, const IRenderView& view)
@@ -151,9 +255,22 @@ void LightingModeRenderer::collectRegularLight(RendererLight& light, const IRend
     }
 
     // Check all the surfaces that are touching this light
-    interaction.collectSurfaces(view, _entities);
+    interaction.collectSurfaces(view, _interactionCache.getObjects(light, _entities));
+
+    // Occluded lights still contribute their objects to the depth buffer, but
+    // both interaction and shadow map rendering can be skipped
+    if (_occlusionCullingEnabled.get() && _occlusionQueries.isOccluded(light, view))
+    {
+        interaction.setOccluded(true);
+
+        _result->occludedLights++;
+        _result->occludedObjects += interaction.getObjectCount();
+    }
+    else
+    {
+        _result->visibleLights++;
+    }
 
-    _result->visibleLights++;
     _result->objects += interaction.getObjectCount();
     _result->entities += interaction.getEntityCount();
 
@@ -161,7 +278,7 @@ void LightingModeRenderer::collectRegularLight(RendererLight& light, const IRend
     auto& moved = _regularLights.emplace_back(std::move(interaction));
 
     // Check the distance of shadow casting lights to the viewer
-    if (_shadowMappingEnabled.get() && moved.isShadowCasting())
+    if (_shadowMappingEnabled.get() && moved.isShadowCasting() && !moved.isOccluded())
     {
         addToShadowLights(moved, view.getViewer());
     }
@@ -178,7 +295,7 @@ void LightingModeRenderer::collectBlendLight(RendererLight& light, const IRender
     }
 
     // Check all the surfaces that are touching this light
-    blendLight.collectSurfaces(view, _entities);
+    blendLight.collectSurfaces(view, _interactionCache.getObjects(light, _entities));
 
     _result->visibleLights++;
     _result->objects += blendLight.getObjectCount();
@@ -227,6 +344,94 @@ void LightingModeRenderer::addToShadowLights(RegularLight& light, const Vector3&
     }
 }
 
+void LightingModeRenderer::assignShadowMapTiles(const Vector3& viewer)
+{
+    for (auto& [_, tile] : _shadowMapTiles)
+    {
+        tile.isUsed = false;
+    }
+
+    // Release the tiles of lights that need a different resolution
+    for (auto light : _nearestShadowLights)
+    {
+        auto level = getShadowMapLevel(*light, viewer, MaxShadowMapLevel);
+        auto& tile = _shadowMapTiles[&light->getLight()];
+
+        tile.isUsed = true;
+
+        if (tile.handle != ShadowMapAtlas::InvalidHandle && tile.requestedLevel == level) continue;
+
+        if (tile.handle != ShadowMapAtlas::InvalidHandle)
+        {
+            _shadowMapAtlas.free(tile.handle);
+            tile.handle = ShadowMapAtlas::InvalidHandle;
+        }
+
+        tile.requestedLevel = level;
+    }
+
+    // Lights that are no longer casting shadows free their tiles
+    for (auto it = _shadowMapTiles.begin(); it != _shadowMapTiles.end();)
+    {
+        if (!it->second.isUsed)
+        {
+            if (it->second.handle != ShadowMapAtlas::InvalidHandle)
+            {
+                _shadowMapAtlas.free(it->second.handle);
+            }
+
+            _shadowMapTiles.erase(it++);
+            continue;
+        }
+
+        ++it;
+    }
+
+    // Allocate the missing tiles, nearest lights first
+    for (auto light : _nearestShadowLights)
+    {
+        auto& tile = _shadowMapTiles[&light->getLight()];
+
+        if (tile.handle == ShadowMapAtlas::InvalidHandle)
+        {
+            // Fall back to smaller tiles if the atlas is getting full
+            for (auto level = tile.requestedLevel; level <= MaxShadowMapLevel; ++level)
+            {
+                tile.handle = _shadowMapAtlas.allocate(level);
+
+                if (tile.handle != ShadowMapAtlas::InvalidHandle) break;
+            }
+
+            // Force the new tile to be rendered
+            tile.objectsVersion = 0;
+        }
+
+        // No space left, this light is rendered without shadows
+        if (tile.handle == ShadowMapAtlas::InvalidHandle) continue;
+
+        auto lightOrigin = light->getLight().getLightOrigin();
+        auto objectsVersion = _interactionCache.getObjectsVersion(light->getLight());
+        auto casterHash = light->getShadowCasterHash();
+
+        if (tile.objectsVersion != 0 && tile.objectsVersion == objectsVersion &&
+            tile.casterHash == casterHash && tile.lightOrigin == lightOrigin)
+        {
+            _result->cachedShadowMaps++;
+        }
+        else
+        {
+            tile.lightOrigin = lightOrigin;
+            tile.objectsVersion = objectsVersion;
+            tile.casterHash = casterHash;
+
+            _shadowMapsToRender.push_back(light);
+        }
+
+        light->setShadowLightIndex(static_cast<int>(_shadowMapRectangles.size()));
+        _shadowMapRectangles.push_back(_shadowMapAtlas.getRectangle(tile.handle));
+    }
+}
+
 void LightingModeRenderer::drawInteractingLights(OpenGLState& current, RenderStateFlags globalFlagsMask,
     const IRenderView& view, std::size_t renderTime)
 {
@@ -247,22 +452,27 @@ void LightingModeRenderer::drawInteractingLights(OpenGLState& current, RenderSta
         OpenGLState::SetTextureState(current.texture5, _shadowMapFbo->getTextureNumber(), GL_TEXTURE5, GL_TEXTURE_2D);
     }
 
+    // Objects of different materials can be combined into a single draw using bindless textures
+    auto useBatching = _bindlessTexturesEnabled.get() && interactionProgram->supportsBatching();
+
     for (auto& interactionList : _regularLights)
     {
+        if (interactionList.isOccluded()) continue;
+
         auto shadowLightIndex = interactionList.getShadowLightIndex();
 
         if (shadowLightIndex != -1)
         {
             // Define which part of the shadow map atlas should be sampled
             interactionProgram->enableShadowMapping(true);
-            interactionProgram->setShadowMapRectangle(_shadowMapAtlas[shadowLightIndex]);
+            interactionProgram->setShadowMapRectangle(_shadowMapRectangles[shadowLightIndex]);
         }
         else
         {
             interactionProgram->enableShadowMapping(false);
         }
 
-        interactionList.drawInteractions(current, *interactionProgram, view, renderTime);
+        interactionList.drawInteractions(current, *interactionProgram, view, renderTime, useBatching);
         _result->interactionDrawCalls += interactionList.getInteractionDrawCalls();
     }
 
@@ -285,16 +495,24 @@ void LightingModeRenderer::drawBlendLights(OpenGLState& current, RenderStateFlag
 
     _blendLightProgram->setModelViewProjection(view.GetViewProjection());
 
+    // Lights sharing their material are drawn together
+    std::map<Shader*, std::vector<BlendLight*>> blendLightsByShader;
+
     for (auto& blendLight : _blendLights)
     {
-        blendLight.draw(current, globalFlagsMask , *_blendLightProgram, view, renderTime);
-        _result->nonInteractionDrawCalls += blendLight.getDrawCalls();
+        blendLightsByShader[blendLight.getLight().getShader().get()].push_back(&blendLight);
+    }
+
+    for (const auto& [shader, blendLights] : blendLightsByShader)
+    {
+        _result->nonInteractionDrawCalls += BlendLight::DrawBatch(blendLights, current,
+            globalFlagsMask, *_blendLightProgram, renderTime);
     }
 }
 
 void LightingModeRenderer::drawShadowMaps(OpenGLState& current,std::size_t renderTime)
 {
-    if (!_shadowMappingEnabled.get()) return;
+    if (!_shadowMappingEnabled.get() || _shadowMapsToRender.empty()) return;
 
     // Draw the shadow maps of each light
     // Save the viewport set up in the camera code
@@ -326,16 +544,22 @@ void LightingModeRenderer::drawShadowMaps(OpenGLState& current,std::size_t rende
     glEnable(GL_CLIP_DISTANCE2);
     glEnable(GL_CLIP_DISTANCE3);
 
-    glViewport(0, 0, static_cast<GLsizei>(_shadowMapFbo->getWidth()), static_cast<GLsizei>(_shadowMapFbo->getHeight()));
-    glClear(GL_DEPTH_BUFFER_BIT);
+    // Tiles of unchanged lights are kept, clear and render the outdated ones only
+    glEnable(GL_SCISSOR_TEST);
 
-    // Render shadow casting lights to the shadow map buffer, up to MaxShadowLightCount
-    for (auto light : _nearestShadowLights)
+    for (auto light : _shadowMapsToRender)
     {
-        light->drawShadowMap(current, _shadowMapAtlas[light->getShadowLightIndex()], *_shadowMapProgram, renderTime);
+        const auto& rectangle = _shadowMapRectangles[light->getShadowLightIndex()];
+
+        glScissor(rectangle.x, rectangle.y, 6 * rectangle.width, rectangle.width);
+        glClear(GL_DEPTH_BUFFER_BIT);
+
+        light->drawShadowMap(current, rectangle, *_shadowMapProgram, renderTime);
         _result->shadowDrawCalls += light->getShadowMapDrawCalls();
     }
 
+    glDisable(GL_SCISSOR_TEST);
+
     _shadowMapFbo->unbind();
     _shadowMapProgram->disable();
 
@@ -353,6 +577,18 @@ void LightingModeRenderer::drawShadowMaps(OpenGLState& current,std::size_t rende
     current.clearRenderFlag(RENDER_DEPTHTEST);
 }
 
+void LightingModeRenderer::issueOcclusionQueries(OpenGLState& current, const IRenderView& view)
+{
+    if (!_occlusionCullingEnabled.get())
+    {
+        _occlusionQueries.clear();
+        return;
+    }
+
+    _occlusionQueries.issueQueries(current, _regularLights, view);
+    _occlusionQueries.releaseUnusedQueries();
+}
+
 void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFlags globalFlagsMask,
     const IRenderView& view, std::size_t renderTime)
 {
@@ -370,7 +606,8 @@ void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFl
 
     for (auto& interactionList : _regularLights)
     {
-        interactionList.fillDepthBuffer(current, *depthFillProgram, renderTime, _untransformedObjectsWithoutAlphaTest);
+        interactionList.fillDepthBuffer(current, *depthFillProgram, renderTime,
+            _untransformedObjectsWithoutAlphaTest, _orientedObjectsWithoutAlphaTest);
         _result->depthDrawCalls += interactionList.getDepthDrawCalls();
     }
 
@@ -388,21 +625,83 @@ void LightingModeRenderer::drawDepthFillPass(OpenGLState& current, RenderStateFl
 
         _untransformedObjectsWithoutAlphaTest.clear();
     }
+
+    if (!_orientedObjectsWithoutAlphaTest.empty())
+    {
+        depthFillProgram->setAlphaTest(-1);
+
+        drawOrientedDepthFill(*depthFillProgram);
+    }
 }
 
-void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, RenderStateFlags globalFlagsMask, 
-    const IRenderView& view, std::size_t time)
+void LightingModeRenderer::drawOrientedDepthFill(DepthFillAlphaProgram& program)
 {
-    glUseProgram(0);
-    glActiveTexture(GL_TEXTURE0);
-    glClientActiveTexture(GL_TEXTURE0);
+    std::vector<Matrix4> transforms;
+    transforms.reserve(DepthFillAlphaProgram::MaxInstances);
 
-    glEnableClientState(GL_VERTEX_ARRAY);
-    glEnableClientState(GL_COLOR_ARRAY);
-    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-    glEnableClientState(GL_NORMAL_ARRAY);
+    for (auto& [slot, objects] : _orientedObjectsWithoutAlphaTest)
+    {
+        // Objects touched by more than one light have been collected multiple times
+        std::sort(objects.begin(), objects.end());
+        objects.erase(std::unique(objects.begin(), objects.end()), objects.end());
+
+        if (objects.size() == 1)
+        {
+            program.setObjectTransform(objects.front()->getObjectTransform());
+
+            _objectRenderer.submitGeometry(slot, GL_TRIANGLES);
+            _result->depthDrawCalls++;
+            continue;
+        }
+
+        for (std::size_t offset = 0; offset < objects.size(); offset += DepthFillAlphaProgram::MaxInstances)
+        {
+            auto count = std::min(objects.size() - offset, DepthFillAlphaProgram::MaxInstances);
+
+            transforms.clear();
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                transforms.push_back(objects[offset + i]->getObjectTransform());
+            }
+
+            program.setInstanceTransforms(transforms);
+
+            _objectRenderer.submitInstancedGeometry(slot, static_cast<int>(count), GL_TRIANGLES);
+            _result->depthDrawCalls++;
+        }
 
-    // Draw non-interaction passes (like skyboxes or blend stages)
+        program.disableInstanceTransforms();
+    }
+
+    _orientedObjectsWithoutAlphaTest.clear();
+}
+
+std::uint64_t LightingModeRenderer::getNonInteractionSortKey(const OpenGLShaderPass& pass)
+{
+    const auto& state = pass.state();
+
+    // Sort position in the upper 16 bits, the passes need to be drawn in this order
+    auto sortPosition = static_cast<std::uint64_t>(std::clamp(state.getSortPosition() + 32768, 0, 0xFFFF));
+
+    // Followed by the program, enumerated in the order of appearance
+    auto program = std::find(_nonInteractionPrograms.begin(), _nonInteractionPrograms.end(), state.glProgram);
+
+    if (program == _nonInteractionPrograms.end())
+    {
+        program = _nonInteractionPrograms.insert(program, state.glProgram);
+    }
+
+    auto programIndex = static_cast<std::uint64_t>(std::min<std::size_t>(program - _nonInteractionPrograms.begin(), 0xFF));
+
+    // The diffuse texture in the lower 32 bits
+    return (sortPosition << 48) | (programIndex << 40) | static_cast<std::uint64_t>(state.texture0);
+}
+
+void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, RenderStateFlags globalFlagsMask, 
+    const IRenderView& view, std::size_t time)
+{
+    // Collect the non-interaction passes (like skyboxes or blend stages) of all objects
     for (const auto& entity : _entities)
     {
         entity->foreachRenderable([&](const IRenderableObject::Ptr& object, Shader* shader)
@@ -421,7 +720,7 @@ void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, Render
                 return;
             }
 
-            // For each pass except for the depth fill and interaction passes, draw the geometry
+            // Collect each pass except for the depth fill and interaction passes
             glShader->foreachNonInteractionPass([&](OpenGLShaderPass& pass)
             {
                 // Evaluate the stage before deciding whether it's active
@@ -432,33 +731,71 @@ void LightingModeRenderer::drawNonInteractionPasses(OpenGLState& current, Render
                     return;
                 }
 
-                // Apply our state to the current state object
-                pass.applyState(current, globalFlagsMask);
+                _nonInteractionDraws.add(getNonInteractionSortKey(pass),
+                    NonInteractionDraw{ entity.get(), object.get(), &pass });
+            });
+        });
+    }
 
-                // Bind textures
-                OpenGLState::SetTextureState(current.texture0, pass.state().texture0, GL_TEXTURE0, GL_TEXTURE_2D);
+    glUseProgram(0);
+    glActiveTexture(GL_TEXTURE0);
+    glClientActiveTexture(GL_TEXTURE0);
 
-                if (dynamic_cast<RegularStageProgram*>(current.glProgram))
-                {
-                    auto program = static_cast<RegularStageProgram*>(current.glProgram);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_NORMAL_ARRAY);
 
-                    program->setModelViewProjection(view.GetViewProjection());
-                    program->setObjectTransform(object->getObjectTransform());
-                    program->setStageVertexColour(pass.state().getVertexColourMode(), pass.state().getColour());
+    // Draw the passes in key order, passes sharing their program and texture are adjacent
+    const IRenderEntity* lastEntity = nullptr;
+    OpenGLShaderPass* lastPass = nullptr;
 
-                    const auto& diffuse = pass.state().stage0;
-                    program->setDiffuseTextureTransform(diffuse ? diffuse->getTextureTransform() : Matrix4::getIdentity());
-                }
-                else if (dynamic_cast<CubeMapProgram*>(current.glProgram))
-                {
-                    static_cast<CubeMapProgram*>(current.glProgram)->setViewer(view.getViewer());
-                }
+    _nonInteractionDraws.foreachItem([&](std::uint64_t key, const NonInteractionDraw& draw)
+    {
+        auto& pass = *draw.pass;
 
-                _objectRenderer.submitGeometry(object->getStorageLocation(), GL_TRIANGLES);
-                _result->nonInteractionDrawCalls++;
-            });
-        });
-    }
+        // The stage values depend on the entity, evaluate them again if the pass
+        // has been evaluated for a different entity during collection
+        if (draw.pass != lastPass || draw.entity != lastEntity)
+        {
+            pass.evaluateShaderStages(time, draw.entity);
+            lastPass = draw.pass;
+            lastEntity = draw.entity;
+        }
+
+        if (current.glProgram != pass.state().glProgram || current.texture0 != pass.state().texture0)
+        {
+            _result->nonInteractionStateChanges++;
+        }
+
+        // Apply our state to the current state object
+        pass.applyState(current, globalFlagsMask);
+
+        // Bind textures
+        OpenGLState::SetTextureState(current.texture0, pass.state().texture0, GL_TEXTURE0, GL_TEXTURE_2D);
+
+        if (dynamic_cast<RegularStageProgram*>(current.glProgram))
+        {
+            auto program = static_cast<RegularStageProgram*>(current.glProgram);
+
+            program->setModelViewProjection(view.GetViewProjection());
+            program->setObjectTransform(draw.object->getObjectTransform());
+            program->setStageVertexColour(pass.state().getVertexColourMode(), pass.state().getColour());
+
+            const auto& diffuse = pass.state().stage0;
+            program->setDiffuseTextureTransform(diffuse ? diffuse->getTextureTransform() : Matrix4::getIdentity());
+        }
+        else if (dynamic_cast<CubeMapProgram*>(current.glProgram))
+        {
+            static_cast<CubeMapProgram*>(current.glProgram)->setViewer(view.getViewer());
+        }
+
+        _objectRenderer.submitGeometry(draw.object->getStorageLocation(), GL_TRIANGLES);
+        _result->nonInteractionDrawCalls++;
+    });
+
+    _nonInteractionDraws.clear();
+    _nonInteractionPrograms.clear();
 
     OpenGLState::SetTextureState(current.texture0, 0, GL_TEXTURE0, GL_TEXTURE_2D);
 }
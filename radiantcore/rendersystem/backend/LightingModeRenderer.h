@@ -5,12 +5,17 @@
 #include "SceneRenderer.h"
 #include "igeometrystore.h"
 #include "iobjectrenderer.h"
-#include "FrameBuffer.h"
+#include "render/FrameBuffer.h"
 #include "render/Rectangle.h"
+#include "render/ShadowMapAtlas.h"
+#include "render/SortedDrawList.h"
 #include "glprogram/ShadowMapProgram.h"
 #include "glprogram/BlendLightProgram.h"
 #include "RegularLight.h"
 #include "BlendLight.h"
+#include "LightOcclusionQueries.h"
+#include "LightInteractionCache.h"
+#include "GpuTimerQueries.h"
 #include "registry/CachedKey.h"
 
 namespace render
@@ -18,6 +23,7 @@ namespace render
 
 class GLProgramFactory;
 class LightingModeRenderResult;
+class OpenGLShaderPass;
 
 class LightingModeRenderer final :
     public SceneRenderer
@@ -35,22 +41,76 @@ private:
     const std::set<IRenderEntityPtr>& _entities;
 
     std::vector<IGeometryStore::Slot> _untransformedObjectsWithoutAlphaTest;
+    RegularLight::OrientedObjectsBySlot _orientedObjectsWithoutAlphaTest;
 
     FrameBuffer::Ptr _shadowMapFbo;
-    std::vector<Rectangle> _shadowMapAtlas;
     ShadowMapProgram* _shadowMapProgram;
     BlendLightProgram* _blendLightProgram;
 
-    constexpr static std::size_t MaxShadowCastingLights = 6;
+    constexpr static std::size_t MaxShadowCastingLights = 16;
+
+    // The shadow map texture is divided into 6 rows of full-size tiles,
+    // which can be subdivided 3 times for lights covering less screen space
+    constexpr static std::size_t ShadowMapAtlasRows = 6;
+    constexpr static std::size_t MaxShadowMapLevel = 3;
+
+    ShadowMapAtlas _shadowMapAtlas;
+
+    // A light's tile in the shadow map atlas, kept across frames. The tile doesn't need
+    // to be re-rendered as long as the light and the objects casting shadows are unchanged.
+    struct ShadowMapTile
+    {
+        ShadowMapAtlas::Handle handle = ShadowMapAtlas::InvalidHandle;
+        std::size_t requestedLevel = 0;
+
+        Vector3 lightOrigin;
+        std::size_t objectsVersion = 0;
+        std::size_t casterHash = 0;
+
+        bool isUsed = false;
+    };
+
+    std::map<const RendererLight*, ShadowMapTile> _shadowMapTiles;
 
     registry::CachedKey<bool> _shadowMappingEnabled;
+    registry::CachedKey<bool> _occlusionCullingEnabled;
+    registry::CachedKey<bool> _gpuTimingEnabled;
+    registry::CachedKey<bool> _bindlessTexturesEnabled;
+
+    LightOcclusionQueries _occlusionQueries;
+
+    // Measures the GPU time of the individual passes
+    GpuTimerQueries _timerQueries;
+
+    // Objects touching each light, kept across frames
+    LightInteractionCache _interactionCache;
 
     // Data that is valid during a single render pass only
 
     std::vector<RegularLight> _regularLights;
     std::vector<RegularLight*> _nearestShadowLights;
+
+    // The atlas region of each shadow light, indexed by RegularLight::getShadowLightIndex
+    std::vector<Rectangle> _shadowMapRectangles;
+
+    // The shadow lights with outdated shadow map tiles
+    std::vector<RegularLight*> _shadowMapsToRender;
     std::vector<BlendLight> _blendLights;
 
+    // A non-interaction pass to draw for a single object
+    struct NonInteractionDraw
+    {
+        const IRenderEntity* entity;
+        IRenderableObject* object;
+        OpenGLShaderPass* pass;
+    };
+
+    // The non-interaction passes of this frame, sorted by pass order, program and texture
+    SortedDrawList<NonInteractionDraw> _nonInteractionDraws;
+
+    // The programs used by the non-interaction passes of this frame, the position is used in the sort key
+    std::vector<GLProgram*> _nonInteractionPrograms;
+
     std::shared_ptr<LightingModeRenderResult> _result;
 
 public:
@@ -76,14 +136,29 @@ private:
     void drawDepthFillPass(OpenGLState& current, RenderStateFlags globalFlagsMask,
         const IRenderView& view, std::size_t renderTime);
 
+    // Draws the collected oriented objects, using instanced calls for objects sharing their geometry
+    void drawOrientedDepthFill(DepthFillAlphaProgram& program);
+
+    // Returns the key to sort the given non-interaction pass into the draw list
+    std::uint64_t getNonInteractionSortKey(const OpenGLShaderPass& pass);
+
     void drawNonInteractionPasses(OpenGLState& current, RenderStateFlags globalFlagsMask, 
         const IRenderView& view, std::size_t time);
 
     void drawShadowMaps(OpenGLState& current, std::size_t renderTime);
 
+    void issueOcclusionQueries(OpenGLState& current, const IRenderView& view);
+
     void ensureShadowMapSetup();
 
+    // Starts/stops the GPU time measurement of a pass, if enabled
+    void beginTimedPass(GpuTimerQueries::Pass pass);
+    void endTimedPass();
+    void collectGpuTimes();
+
     void addToShadowLights(RegularLight& light, const Vector3& viewer);
+
+    void assignShadowMapTiles(const Vector3& viewer);
 };
 
 }
@@ -2,16 +2,34 @@
 
 #include "GLProgramAttributes.h"
 #include "irenderableobject.h"
+#include "math/AABB.h"
 #include "math/Matrix4.h"
-#include "render/RenderVertex.h"
+#include "render/PackedRenderVertex.h"
 
 namespace render
 {
 
 ObjectRenderer::ObjectRenderer(IGeometryStore& store) :
-    _store(store)
+    _store(store),
+    _multiDrawIndirectEnabled(false),
+    _indirectBuffer(0),
+    _indirectBufferCapacity(0)
 {}
 
+ObjectRenderer::~ObjectRenderer()
+{
+    if (_indirectBuffer != 0)
+    {
+        glDeleteBuffers(1, &_indirectBuffer);
+        _indirectBuffer = 0;
+    }
+}
+
+void ObjectRenderer::setMultiDrawIndirectEnabled(bool enabled)
+{
+    _multiDrawIndirectEnabled = enabled;
+}
+
 void ObjectRenderer::submitObject(IRenderableObject& object)
 {
     // Orient the object
@@ -25,8 +43,47 @@ void ObjectRenderer::submitObject(IRenderableObject& object)
     glPopMatrix();
 }
 
+void ObjectRenderer::submitObjectBounds(IRenderableObject& object)
+{
+    const auto& bounds = object.getObjectBounds();
+
+    if (!bounds.isValid()) return;
+
+    Vector3 corners[8];
+    bounds.getCorners(corners);
+
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glMultMatrixd(object.getObjectTransform());
+
+    // Corners 0..3 form the top face, 4..7 the bottom face
+    glBegin(GL_LINES);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto next = (i + 1) % 4;
+
+        glVertex3dv(corners[i]);
+        glVertex3dv(corners[next]);
+        glVertex3dv(corners[i + 4]);
+        glVertex3dv(corners[next + 4]);
+        glVertex3dv(corners[i]);
+        glVertex3dv(corners[i + 4]);
+    }
+
+    glEnd();
+
+    glPopMatrix();
+}
+
 void ObjectRenderer::initAttributePointers()
 {
+    if (_store.getVertexFormat() == IGeometryStore::VertexFormat::Packed)
+    {
+        initPackedAttributePointers();
+        return;
+    }
+
     const RenderVertex* bufferStart = nullptr;
 
     glVertexPointer(3, GL_FLOAT, sizeof(RenderVertex), &bufferStart->vertex);
@@ -42,6 +99,28 @@ void ObjectRenderer::initAttributePointers()
     glVertexAttribPointer(GLProgramAttribute::Colour, 4, GL_FLOAT, 0, sizeof(RenderVertex), &bufferStart->colour);
 }
 
+void ObjectRenderer::initPackedAttributePointers()
+{
+    // The positions are a tightly packed stream at the start of the buffer
+    glVertexPointer(3, GL_FLOAT, sizeof(Vector3f), nullptr);
+    glVertexAttribPointer(GLProgramAttribute::Position, 3, GL_FLOAT, 0, sizeof(Vector3f), nullptr);
+
+    // The remaining attributes are located after the last position
+    const auto* attributes = reinterpret_cast<const PackedVertexAttributes*>(
+        static_cast<std::uintptr_t>(_store.getPackedAttributesOffset()));
+    constexpr auto stride = static_cast<GLsizei>(sizeof(PackedVertexAttributes));
+
+    glColorPointer(4, GL_UNSIGNED_BYTE, stride, &attributes->colour);
+    glTexCoordPointer(2, GL_FLOAT, stride, &attributes->texcoord);
+    glNormalPointer(GL_INT_2_10_10_10_REV, stride, &attributes->normal);
+
+    glVertexAttribPointer(GLProgramAttribute::Normal, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, &attributes->normal);
+    glVertexAttribPointer(GLProgramAttribute::TexCoord, 2, GL_FLOAT, 0, stride, &attributes->texcoord);
+    glVertexAttribPointer(GLProgramAttribute::Tangent, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, &attributes->tangent);
+    glVertexAttribPointer(GLProgramAttribute::Bitangent, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, &attributes->bitangent);
+    glVertexAttribPointer(GLProgramAttribute::Colour, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, &attributes->colour);
+}
+
 void ObjectRenderer::submitGeometry(IGeometryStore::Slot slot, GLenum primitiveMode)
 {
     const auto renderParams = _store.getBufferAddresses(slot);
@@ -73,13 +152,39 @@ void ObjectRenderer::submitGeometryWithCustomIndices(IGeometryStore::Slot slot,
     indexBuffer->bind();
 }
 
+void ObjectRenderer::submitGeometryRanges(IGeometryStore::Slot slot, GLenum primitiveMode,
+    const std::vector<GLint>& firstVertices, const std::vector<GLsizei>& counts)
+{
+    if (firstVertices.empty()) return;
+
+    const auto renderParams = _store.getBufferAddresses(slot);
+
+    // The ranges are relative to the slot, convert them to absolute vertex numbers
+    std::vector<GLint> absoluteFirstVertices;
+    absoluteFirstVertices.reserve(firstVertices.size());
+
+    for (auto firstVertex : firstVertices)
+    {
+        absoluteFirstVertices.push_back(firstVertex + static_cast<GLint>(renderParams.firstVertex));
+    }
+
+    glMultiDrawArrays(primitiveMode, absoluteFirstVertices.data(), counts.data(),
+        static_cast<GLsizei>(absoluteFirstVertices.size()));
+}
+
 template<typename ContainerT>
-void SubmitGeometryInternal(const ContainerT& slots, GLenum primitiveMode, IGeometryStore& store)
+void ObjectRenderer::submitGeometryInternal(const ContainerT& slots, GLenum primitiveMode)
 {
     auto surfaceCount = slots.size();
 
     if (surfaceCount == 0) return;
 
+    if (_multiDrawIndirectEnabled && surfaceCount > 1)
+    {
+        submitGeometryIndirect(slots, primitiveMode);
+        return;
+    }
+
     // Build the indices and offsets used for the glMulti draw call
     std::vector<GLsizei> sizes;
     std::vector<void*> firstIndices;
@@ -91,7 +196,7 @@ void SubmitGeometryInternal(const ContainerT& slots, GLenum primitiveMode, IGeom
 
     for (const auto slot : slots)
     {
-        auto renderParams = store.getBufferAddresses(slot);
+        auto renderParams = _store.getBufferAddresses(slot);
 
         sizes.push_back(static_cast<GLsizei>(renderParams.indexCount));
         firstVertices.push_back(static_cast<GLint>(renderParams.firstVertex));
@@ -102,14 +207,63 @@ void SubmitGeometryInternal(const ContainerT& slots, GLenum primitiveMode, IGeom
         firstIndices.data(), static_cast<GLsizei>(sizes.size()), firstVertices.data());
 }
 
+template<typename ContainerT>
+void ObjectRenderer::submitGeometryIndirect(const ContainerT& slots, GLenum primitiveMode)
+{
+    _indirectCommands.clear();
+    _indirectCommands.reserve(slots.size());
+
+    for (const auto slot : slots)
+    {
+        auto renderParams = _store.getBufferAddresses(slot);
+
+        // The indirect command expects the first index as element offset, not as pointer
+        auto firstIndex = reinterpret_cast<std::uintptr_t>(renderParams.firstIndex) / sizeof(unsigned int);
+
+        _indirectCommands.emplace_back(DrawElementsIndirectCommand
+        {
+            static_cast<GLuint>(renderParams.indexCount),
+            1,
+            static_cast<GLuint>(firstIndex),
+            static_cast<GLint>(renderParams.firstVertex),
+            0
+        });
+    }
+
+    if (_indirectBuffer == 0)
+    {
+        glGenBuffers(1, &_indirectBuffer);
+    }
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+
+    auto numBytes = static_cast<GLsizeiptr>(_indirectCommands.size() * sizeof(DrawElementsIndirectCommand));
+
+    // Grow the buffer if necessary, otherwise orphan the previous contents
+    // to not wait for the previous draw call to finish reading them
+    if (_indirectCommands.size() > _indirectBufferCapacity)
+    {
+        _indirectBufferCapacity = _indirectCommands.size() * 2;
+    }
+
+    glBufferData(GL_DRAW_INDIRECT_BUFFER,
+        static_cast<GLsizeiptr>(_indirectBufferCapacity * sizeof(DrawElementsIndirectCommand)), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, numBytes, _indirectCommands.data());
+
+    glMultiDrawElementsIndirect(primitiveMode, GL_UNSIGNED_INT, nullptr,
+        static_cast<GLsizei>(_indirectCommands.size()), 0);
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
 void ObjectRenderer::submitGeometry(const std::set<IGeometryStore::Slot>& slots, GLenum primitiveMode)
 {
-    SubmitGeometryInternal(slots, primitiveMode, _store);
+    submitGeometryInternal(slots, primitiveMode);
 }
 
 void ObjectRenderer::submitGeometry(const std::vector<IGeometryStore::Slot>& slots, GLenum primitiveMode)
 {
-    SubmitGeometryInternal(slots, primitiveMode, _store);
+    submitGeometryInternal(slots, primitiveMode);
 }
 
 void ObjectRenderer::submitInstancedGeometry(const std::vector<IGeometryStore::Slot>& slots, int numInstances, GLenum primitiveMode)
@@ -17,8 +17,30 @@ class ObjectRenderer :
 private:
     IGeometryStore& _store;
 
+    // Layout as defined by the GL_ARB_multi_draw_indirect spec
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    bool _multiDrawIndirectEnabled;
+
+    // The buffer object holding the draw commands, re-filled on every submission
+    GLuint _indirectBuffer;
+    std::size_t _indirectBufferCapacity;
+    std::vector<DrawElementsIndirectCommand> _indirectCommands;
+
 public:
     ObjectRenderer(IGeometryStore& store);
+    ~ObjectRenderer();
+
+    // Lets multi-slot submissions use a single glMultiDrawElementsIndirect call,
+    // requires GL_ARB_multi_draw_indirect. Falls back to glMultiDrawElementsBaseVertex if disabled.
+    void setMultiDrawIndirectEnabled(bool enabled);
 
     // Initialise the vertex attribute pointers using the given start address (can be nullptr)
     void initAttributePointers() override;
@@ -26,6 +48,9 @@ public:
     // Draws the given object, sets up transform and submits geometry
     void submitObject(IRenderableObject& object) override;
 
+    // Draws the outline of the given object's bounding box instead of its geometry, sets up transform
+    void submitObjectBounds(IRenderableObject& object) override;
+
     // Draws the geometry of the given slot in the given primitive mode, no transforms
     void submitGeometry(IGeometryStore::Slot slot, GLenum primitiveMode) override;
 
@@ -36,6 +61,10 @@ public:
     void submitGeometryWithCustomIndices(IGeometryStore::Slot slot, GLenum primitiveMode, 
         const std::vector<unsigned int>& indices) override;
 
+    // Draws a number of vertex ranges of the given slot in a single call
+    void submitGeometryRanges(IGeometryStore::Slot slot, GLenum primitiveMode,
+        const std::vector<GLint>& firstVertices, const std::vector<GLsizei>& counts) override;
+
     // Draws all geometry as defined by their store IDs in the given mode, no transforms (std::set variant)
     void submitGeometry(const std::set<IGeometryStore::Slot>& slots, GLenum primitiveMode) override;
     // Draws all geometry as defined by their store IDs in the given mode, no transforms (std::vector variant)
@@ -43,6 +72,15 @@ public:
 
     // Draws all geometry as defined by their store IDs in the given mode, no transforms (std::vector variant)
     void submitInstancedGeometry(const std::vector<IGeometryStore::Slot>& slots, int numInstances, GLenum primitiveMode) override;
+
+private:
+    void initPackedAttributePointers();
+
+    template<typename ContainerT>
+    void submitGeometryInternal(const ContainerT& slots, GLenum primitiveMode);
+
+    template<typename ContainerT>
+    void submitGeometryIndirect(const ContainerT& slots, GLenum primitiveMode);
 };
 
 }
@@ -11,6 +11,7 @@
 #include "irender.h"
 #include "texturelib.h"
 
+#include <algorithm>
 #include <functional>
 
 namespace render
@@ -169,6 +170,12 @@ void OpenGLShader::updateGeometry(IGeometryRenderer::Slot slot, const std::vecto
     _geometryRenderer.updateGeometry(slot, vertices, indices);
 }
 
+void OpenGLShader::updateSubGeometry(IGeometryRenderer::Slot slot, std::size_t vertexOffset,
+    const std::vector<RenderVertex>& vertices)
+{
+    _geometryRenderer.updateSubGeometry(slot, vertexOffset, vertices);
+}
+
 void OpenGLShader::renderAllVisibleGeometry()
 {
     _geometryRenderer.renderAllVisibleGeometry();
@@ -239,6 +246,16 @@ void OpenGLShader::renderWinding(IWindingRenderer::RenderMode mode, IWindingRend
     _windingRenderer->renderWinding(mode, slot);
 }
 
+const OpenGLRenderable* OpenGLShader::addHighlightedWinding(IWindingRenderer::Slot slot, std::size_t batchKey)
+{
+    return _windingRenderer->addHighlightedWinding(slot, batchKey);
+}
+
+void OpenGLShader::clearHighlightedWindings()
+{
+    _windingRenderer->clearHighlightedWindings();
+}
+
 void OpenGLShader::setVisible(bool visible)
 {
     // Control visibility by inserting or removing our shader passes from the GL
@@ -711,6 +728,8 @@ void OpenGLShader::constructFromMaterial(const MaterialPtr& material)
         // Editor image rendering only
         constructEditorPreviewPassFromMaterial();
     }
+
+    _passLayout = capturePassLayout();
 }
 
 void OpenGLShader::construct()
@@ -723,13 +742,152 @@ void OpenGLShader::construct()
 void OpenGLShader::onMaterialChanged()
 {
     // It's possible that the name of the material got changed, update it
-    if (_material && _material->getName() != _name)
+    if (!_material || _material->getName() != _name)
+    {
+        if (_material)
+        {
+            _name = _material->getName();
+        }
+
+        unrealise();
+        realise();
+        return;
+    }
+
+    auto layout = capturePassLayout();
+
+    // Only re-construct the passes if the change is affecting them,
+    // parameter changes are picked up when evaluating the stages
+    if (!layout.hasSamePasses(_passLayout))
+    {
+        unrealise();
+        realise();
+        return;
+    }
+
+    rebindTextures(layout);
+}
+
+OpenGLShader::PassLayout OpenGLShader::capturePassLayout() const
+{
+    PassLayout layout;
+
+    layout.lightingMode = canUseLightingMode();
+    layout.sortRequest = _material->getSortRequest();
+    layout.polygonOffset = _material->getPolygonOffset();
+    layout.materialFlags = _material->getMaterialFlags();
+    layout.cullType = _material->getCullType();
+    layout.coverage = _material->getCoverage();
+    layout.isBlendLight = _material->isBlendLight();
+
+    if (layout.isBlendLight && layout.lightingMode)
+    {
+        layout.lightFalloff = _material->lightFalloffImage();
+    }
+
+    if (!layout.lightingMode)
+    {
+        layout.editorImage = _material->getEditorImage();
+    }
+
+    _material->foreachLayer([&](const IShaderLayer::Ptr& layer)
+    {
+        // Evaluate the stage like the pass construction does, to get the same alphatest value
+        layer->evaluateExpressions(0);
+
+        auto blendFunc = layer->getBlendFunc();
+
+        layout.stages.emplace_back(StageLayout
+        {
+            layer, layer->getType(), layer->isEnabled(), blendFunc.src, blendFunc.dest,
+            layer->getCubeMapMode(), layer->getVertexColourMode(), layer->hasAlphaTest(), layer->getAlphaTest(),
+            layout.lightingMode && layer->isEnabled() ? layer->getTexture() : TexturePtr()
+        });
+
+        return true;
+    });
+
+    return layout;
+}
+
+bool OpenGLShader::PassLayout::hasSamePasses(const PassLayout& other) const
+{
+    if (lightingMode != other.lightingMode || sortRequest != other.sortRequest ||
+        polygonOffset != other.polygonOffset || materialFlags != other.materialFlags ||
+        cullType != other.cullType || coverage != other.coverage || isBlendLight != other.isBlendLight ||
+        lightFalloff != other.lightFalloff || stages.size() != other.stages.size())
+    {
+        return false;
+    }
+
+    return std::equal(stages.begin(), stages.end(), other.stages.begin(), [](const StageLayout& a, const StageLayout& b)
+    {
+        // Stages without a texture don't get a pass at all
+        return a.layer == b.layer && a.type == b.type && a.enabled == b.enabled &&
+            a.blendSrc == b.blendSrc && a.blendDest == b.blendDest &&
+            a.cubeMapMode == b.cubeMapMode && a.vertexColourMode == b.vertexColourMode &&
+            a.hasAlphaTest == b.hasAlphaTest && a.alphaTest == b.alphaTest &&
+            (a.texture != nullptr) == (b.texture != nullptr);
+    });
+}
+
+void OpenGLShader::rebindTextures(const PassLayout& layout)
+{
+    bool texturesChanged = layout.editorImage != _passLayout.editorImage;
+
+    for (std::size_t i = 0; i < layout.stages.size(); ++i)
+    {
+        texturesChanged |= layout.stages[i].texture != _passLayout.stages[i].texture;
+    }
+
+    if (!texturesChanged)
     {
-        _name = _material->getName();
+        _passLayout = layout;
+        return;
     }
 
-    unrealise();
-    realise();
+    // The texture numbers are part of the pass sort order, re-insert the passes afterwards
+    removePasses();
+
+    if (!layout.lightingMode && !_shaderPasses.empty())
+    {
+        auto& previewPass = _shaderPasses.front()->state();
+        previewPass.texture0 = layout.editorImage ? layout.editorImage->getGLTexNum() : 0;
+    }
+
+    for (std::size_t i = 0; i < layout.stages.size(); ++i)
+    {
+        const auto& stage = layout.stages[i];
+
+        if (stage.texture == _passLayout.stages[i].texture) continue;
+
+        // Blend and depth fill passes are referencing the stage they're drawing
+        for (const auto& pass : _shaderPasses)
+        {
+            auto& state = pass->state();
+
+            if (layout.lightingMode && state.stage0 == stage.layer && pass != _interactionPass)
+            {
+                state.texture0 = getTextureOrInteractionDefault(stage.layer)->getGLTexNum();
+            }
+        }
+
+        if (_interactionPass)
+        {
+            _interactionPass->updateStageTexture(stage.layer);
+        }
+    }
+
+    insertPasses();
+
+    _passLayout = layout;
+
+    // Surfaces might depend on the dimensions of the new textures
+    for (auto observer : _observers)
+    {
+        observer->onShaderUnrealised();
+        observer->onShaderRealised();
+    }
 }
 
 bool OpenGLShader::isApplicableTo(RenderViewType renderViewType) const
@@ -65,6 +65,48 @@ private:
 
     bool _mergeModeActive;
 
+    // The properties of a material stage the passes have been constructed from
+    struct StageLayout
+    {
+        IShaderLayer::Ptr layer;
+        IShaderLayer::Type type;
+        bool enabled;
+        GLenum blendSrc;
+        GLenum blendDest;
+        IShaderLayer::CubeMapMode cubeMapMode;
+        IShaderLayer::VertexColourMode vertexColourMode;
+        bool hasAlphaTest;
+        float alphaTest;
+
+        // The texture bound by the passes (lighting mode only), a change
+        // of which doesn't require the passes to be re-constructed
+        TexturePtr texture;
+    };
+
+    // The material properties the passes have been constructed from. Changes to
+    // anything else (like the expressions of a stage) are picked up by the passes
+    // when they are evaluating their stages, there's no need to rebuild them.
+    struct PassLayout
+    {
+        bool lightingMode;
+        float sortRequest;
+        float polygonOffset;
+        int materialFlags;
+        Material::CullType cullType;
+        Material::Coverage coverage;
+        bool isBlendLight;
+        TexturePtr lightFalloff;
+        std::vector<StageLayout> stages;
+
+        // The texture used by the editor preview pass
+        TexturePtr editorImage;
+
+        // True if the passes constructed from both layouts are the same, apart from their textures
+        bool hasSamePasses(const PassLayout& other) const;
+    };
+
+    PassLayout _passLayout;
+
 private:
 
     void constructFromMaterial(const MaterialPtr& material);
@@ -84,6 +126,11 @@ private:
 
     void onMaterialChanged();
 
+    PassLayout capturePassLayout() const;
+
+    // Updates the texture bindings of the passes to the given layout
+    void rebindTextures(const PassLayout& layout);
+
 public:
     /// Construct and initialise
     OpenGLShader(const std::string& name, OpenGLRenderSystem& renderSystem);
@@ -109,6 +156,8 @@ public:
     void removeGeometry(IGeometryRenderer::Slot slot) override;
     void updateGeometry(IGeometryRenderer::Slot slot, const std::vector<RenderVertex>& vertices,
         const std::vector<unsigned int>& indices) override;
+    void updateSubGeometry(IGeometryRenderer::Slot slot, std::size_t vertexOffset,
+        const std::vector<RenderVertex>& vertices) override;
     void renderAllVisibleGeometry() override;
     void renderGeometry(IGeometryRenderer::Slot slot) override;
     AABB getGeometryBounds(IGeometryRenderer::Slot slot) const override;
@@ -125,6 +174,10 @@ public:
     void updateWinding(IWindingRenderer::Slot slot, const std::vector<RenderVertex>& vertices) override;
     bool hasWindings() const;
     void renderWinding(IWindingRenderer::RenderMode mode, IWindingRenderer::Slot slot) override;
+    const OpenGLRenderable* addHighlightedWinding(IWindingRenderer::Slot slot, std::size_t batchKey) override;
+
+    // Empties the highlight batches of the windings, called at the start of every frame
+    void clearHighlightedWindings();
 
     void setVisible(bool visible) override;
     bool isVisible() const override;
@@ -6,6 +6,8 @@
 #include "ishaderlayer.h"
 #include "irender.h"
 
+#include <algorithm>
+#include <vector>
 #include "debugging/gl.h"
 #include "render/Colour4.h"
 
@@ -512,6 +514,29 @@ public:
         glBindTexture(textureMode, texture);
         debug::assertNoGlErrors();
         current = texture;
+
+        RecordDrawnTexture(texture);
+    }
+
+    // Remembers the given texture as drawn, for the texture residency statistics
+    static void RecordDrawnTexture(GLuint texture)
+    {
+        if (texture != 0)
+        {
+            DrawnTextures().push_back(texture);
+        }
+    }
+
+    // Returns the textures recorded since the previous call, without duplicates
+    static std::vector<GLuint> TakeDrawnTextures()
+    {
+        std::vector<GLuint> textures;
+        textures.swap(DrawnTextures());
+
+        std::sort(textures.begin(), textures.end());
+        textures.erase(std::unique(textures.begin(), textures.end()), textures.end());
+
+        return textures;
     }
 
 private:
@@ -538,6 +563,14 @@ private:
         glBindTexture(textureMode, texture);
         debug::assertNoGlErrors();
         current = texture;
+
+        RecordDrawnTexture(texture);
+    }
+
+    static std::vector<GLuint>& DrawnTextures()
+    {
+        static std::vector<GLuint> _drawnTextures;
+        return _drawnTextures;
     }
 
     // Apply all textures to texture units
@@ -5,6 +5,7 @@
 #include "ObjectRenderer.h"
 #include "glprogram/DepthFillAlphaProgram.h"
 #include "glprogram/ShadowMapProgram.h"
+#include "math/Hash.h"
 
 namespace render
 {
@@ -18,7 +19,8 @@ RegularLight::RegularLight(RendererLight& light, IGeometryStore& store, IObjectR
     _depthDrawCalls(0),
     _objectCount(0),
     _shadowMapDrawCalls(0),
-    _shadowLightIndex(-1)
+    _shadowLightIndex(-1),
+    _isOccluded(false)
 {
     // Consider the "noshadows" flag and the setting of the light material
     _isShadowCasting = _light.isShadowCasting() && _light.getShader() && 
@@ -50,57 +52,104 @@ bool RegularLight::isShadowCasting() const
 
 void RegularLight::collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities)
 {
-    bool shadowCasting = isShadowCasting();
-
     // Now check all the entities intersecting with this light
     for (const auto& entity : entities)
     {
         entity->foreachRenderableTouchingBounds(_lightBounds,
             [&](const IRenderableObject::Ptr& object, Shader* shader)
         {
-            // Skip empty objects
-            if (!object->isVisible()) return;
+            addObjectIfInteracting(view, *object, *entity, shader);
+        });
+    }
+}
+
+std::size_t RegularLight::getShadowCasterHash() const
+{
+    std::size_t hash = 0;
+
+    for (const auto& [entity, objectsByShader] : _objectsByEntity)
+    {
+        if (!entity->isShadowCasting()) continue;
+
+        for (const auto& [shader, objects] : objectsByShader)
+        {
+            if (!shader->getMaterial()->surfaceCastsShadow()) continue;
 
-            // Don't collect invisible shaders
-            if (!shader->isVisible()) return;
+            math::combineHash(hash, std::hash<OpenGLShader*>()(shader));
 
-            // For non-shadow lights we can cull surfaces that are not in view
-            if (!shadowCasting)
+            for (const auto& object : objects)
             {
-                if (object->isOriented())
-                {
-                    if (view.TestAABB(object->getObjectBounds(), object->getObjectTransform()) == VOLUME_OUTSIDE)
-                    {
-                        return;
-                    }
-                }
-                else if (view.TestAABB(object->getObjectBounds()) == VOLUME_OUTSIDE) // non-oriented AABB test
-                {
-                    return;
-                }
+                if (!object.get().isShadowCasting()) continue;
+
+                // Instances of the same model share their storage, so include the object itself
+                math::combineHash(hash, std::hash<const IRenderableObject*>()(&object.get()));
+                math::combineHash(hash, std::hash<IGeometryStore::Slot>()(object.get().getStorageLocation()));
             }
+        }
+    }
 
-            auto glShader = static_cast<OpenGLShader*>(shader);
+    return hash;
+}
+
+void RegularLight::collectSurfaces(const IRenderView& view, const LightInteractionCache::Objects& objects)
+{
+    for (const auto& cached : objects)
+    {
+        auto object = cached.object.lock();
+        auto entity = cached.entity.lock();
+
+        // Objects might have been removed in the meantime
+        if (!object || !entity) continue;
+
+        addObjectIfInteracting(view, *object, *entity, cached.shader);
+    }
+}
+
+void RegularLight::addObjectIfInteracting(const IRenderView& view, IRenderableObject& object,
+    IRenderEntity& entity, Shader* shader)
+{
+    // Skip empty objects
+    if (!object.isVisible()) return;
+
+    // Don't collect invisible shaders
+    if (!shader->isVisible()) return;
 
-            // We only consider materials designated for camera rendering
-            if (!glShader->isApplicableTo(RenderViewType::Camera))
+    // For non-shadow lights we can cull surfaces that are not in view
+    if (!isShadowCasting())
+    {
+        if (object.isOriented())
+        {
+            if (view.TestAABB(object.getObjectBounds(), object.getObjectTransform()) == VOLUME_OUTSIDE)
             {
                 return;
             }
+        }
+        else if (view.TestAABB(object.getObjectBounds()) == VOLUME_OUTSIDE) // non-oriented AABB test
+        {
+            return;
+        }
+    }
 
-            // Collect all interaction surfaces and the ones with forceShadows materials
-            if (!glShader->getInteractionPass() && (!shader->getMaterial() || !shader->getMaterial()->surfaceCastsShadow()))
-            {
-                return; // This material doesn't interact with this light
-            }
+    auto glShader = static_cast<OpenGLShader*>(shader);
 
-            addObject(*object, *entity, glShader);
-        });
+    // We only consider materials designated for camera rendering
+    if (!glShader->isApplicableTo(RenderViewType::Camera))
+    {
+        return;
     }
+
+    // Collect all interaction surfaces and the ones with forceShadows materials
+    if (!glShader->getInteractionPass() && (!shader->getMaterial() || !shader->getMaterial()->surfaceCastsShadow()))
+    {
+        return; // This material doesn't interact with this light
+    }
+
+    addObject(object, entity, glShader);
 }
 
-void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, 
-    std::size_t renderTime, std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest)
+void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, std::size_t renderTime,
+    std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest,
+    OrientedObjectsBySlot& orientedObjectsWithoutAlphaTest)
 {
     std::vector<IGeometryStore::Slot> untransformedObjects;
     untransformedObjects.reserve(1000);
@@ -133,6 +182,13 @@ void RegularLight::fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& pr
                     continue;
                 }
 
+                // Repeated models without alpha test are drawn instanced, by their shared storage
+                if (shader->getMaterial()->getCoverage() != Material::MC_PERFORATED)
+                {
+                    orientedObjectsWithoutAlphaTest[object.get().getStorageLocation()].push_back(&object.get());
+                    continue;
+                }
+
                 program.setObjectTransform(object.get().getObjectTransform());
 
                 _objectRenderer.submitGeometry(object.get().getStorageLocation(), GL_TRIANGLES);
@@ -217,7 +273,8 @@ void RegularLight::drawShadowMap(OpenGLState& state, const Rectangle& rectangle,
 }
 
 RegularLight::InteractionDrawCall::InteractionDrawCall(OpenGLState& state, InteractionProgram& program,
-    IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer) :
+    IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer,
+    bool useBatching) :
     _state(state),
     _program(program),
     _objectRenderer(objectRenderer),
@@ -226,9 +283,16 @@ RegularLight::InteractionDrawCall::InteractionDrawCall(OpenGLState& state, Inter
     _bump(nullptr),
     _diffuse(nullptr),
     _specular(nullptr),
+    _useBatching(useBatching && program.supportsBatching()),
     _interactionDrawCalls(0)
 {
     _untransformedObjects.reserve(10000);
+
+    if (_useBatching)
+    {
+        _batchedObjects.reserve(InteractionProgram::MaxBatchedDraws);
+        _batchedDrawParameters.reserve(InteractionProgram::MaxBatchedDraws);
+    }
 }
 
 void RegularLight::InteractionDrawCall::submit(const ObjectList& objects)
@@ -250,6 +314,35 @@ void RegularLight::InteractionDrawCall::submit(const ObjectList& objects)
         _specular = &_defaultSpecularStage;
     }
 
+    // Objects without transform can be added to the batch, regardless of their textures
+    InteractionProgram::DrawParameters drawParameters;
+    auto batchObjects = _useBatching && getDrawParameters(drawParameters);
+
+    if (batchObjects)
+    {
+        auto hasOrientedObjects = false;
+
+        for (const auto& object : objects)
+        {
+            if (object.get().isOriented())
+            {
+                hasOrientedObjects = true;
+                continue;
+            }
+
+            _batchedObjects.push_back(object.get().getStorageLocation());
+            _batchedDrawParameters.push_back(drawParameters);
+
+            if (_batchedObjects.size() == InteractionProgram::MaxBatchedDraws)
+            {
+                flush();
+            }
+        }
+
+        // The remaining objects need the regular texture bindings
+        if (!hasOrientedObjects) return;
+    }
+
     // Bind textures
     OpenGLState::SetTextureState(_state.texture0, _diffuse->texture, GL_TEXTURE0, GL_TEXTURE_2D);
     OpenGLState::SetTextureState(_state.texture1, _bump->texture, GL_TEXTURE1, GL_TEXTURE_2D);
@@ -280,7 +373,10 @@ void RegularLight::InteractionDrawCall::submit(const ObjectList& objects)
         // We submit all objects with an identity matrix in a single multi draw call
         if (!object.get().isOriented())
         {
-            _untransformedObjects.push_back(object.get().getStorageLocation());
+            if (!batchObjects)
+            {
+                _untransformedObjects.push_back(object.get().getStorageLocation());
+            }
             continue;
         }
 
@@ -303,6 +399,53 @@ void RegularLight::InteractionDrawCall::submit(const ObjectList& objects)
     }
 }
 
+void RegularLight::InteractionDrawCall::flush()
+{
+    if (_batchedObjects.empty()) return;
+
+    // Alpha testing is performed by the program, using the per-draw reference value
+    glDisable(GL_ALPHA_TEST);
+
+    _program.setUpObjectLighting(_worldLightOrigin, _viewer, Matrix4::getIdentity());
+    _program.setObjectTransform(Matrix4::getIdentity());
+    _program.setDrawParameters(_batchedDrawParameters);
+
+    _objectRenderer.submitGeometry(_batchedObjects, GL_TRIANGLES);
+    ++_interactionDrawCalls;
+
+    _program.disableDrawParameters();
+
+    _batchedObjects.clear();
+    _batchedDrawParameters.clear();
+}
+
+bool RegularLight::InteractionDrawCall::getDrawParameters(InteractionProgram::DrawParameters& parameters) const
+{
+    if (!_diffuse->textureObject || !_bump->textureObject || !_specular->textureObject) return false;
+
+    auto diffuseHandle = _diffuse->textureObject->getBindlessHandle();
+    auto bumpHandle = _bump->textureObject->getBindlessHandle();
+    auto specularHandle = _specular->textureObject->getBindlessHandle();
+
+    if (diffuseHandle == 0 || bumpHandle == 0 || specularHandle == 0) return false;
+
+    // Bindless textures are never bound, record them for the residency statistics
+    OpenGLState::RecordDrawnTexture(_diffuse->texture);
+    OpenGLState::RecordDrawnTexture(_bump->texture);
+    OpenGLState::RecordDrawnTexture(_specular->texture);
+
+    parameters.setTextureHandles(diffuseHandle, bumpHandle, specularHandle);
+    parameters.setTextureTransforms(
+        _diffuse->stage ? _diffuse->stage->getTextureTransform() : Matrix4::getIdentity(),
+        _bump->stage ? _bump->stage->getTextureTransform() : Matrix4::getIdentity(),
+        _specular->stage ? _specular->stage->getTextureTransform() : Matrix4::getIdentity());
+    parameters.setStageVertexColour(_diffuse->stage ? _diffuse->stage->getVertexColourMode() : IShaderLayer::VERTEX_COLOUR_NONE,
+        _diffuse->stage ? _diffuse->stage->getColour() : Colour4::WHITE());
+    parameters.setAlphaTest(_diffuse->stage && _diffuse->stage->hasAlphaTest() ? _diffuse->stage->getAlphaTest() : -1.0f);
+
+    return true;
+}
+
 void RegularLight::InteractionDrawCall::setBump(const InteractionPass::Stage* bump)
 {
     _bump = bump;
@@ -319,7 +462,7 @@ void RegularLight::InteractionDrawCall::setSpecular(const InteractionPass::Stage
 }
 
 void RegularLight::drawInteractions(OpenGLState& state, InteractionProgram& program, 
-    const IRenderView& view, std::size_t renderTime)
+    const IRenderView& view, std::size_t renderTime, bool useBatching)
 {
     if (_objectsByEntity.empty())
     {
@@ -328,7 +471,7 @@ void RegularLight::drawInteractions(OpenGLState& state, InteractionProgram& prog
 
     auto worldLightOrigin = _light.getLightOrigin();
 
-    InteractionDrawCall draw(state, program, _objectRenderer, worldLightOrigin, view.getViewer());
+    InteractionDrawCall draw(state, program, _objectRenderer, worldLightOrigin, view.getViewer(), useBatching);
 
     // Set up textures used by this light
     program.setupLightParameters(state, _light, renderTime);
@@ -382,6 +525,9 @@ void RegularLight::drawInteractions(OpenGLState& state, InteractionProgram& prog
         }
     }
 
+    // Draw the remaining batched objects
+    draw.flush();
+
     _interactionDrawCalls += draw.getInteractionDrawCalls();
 
     // Unbind the light textures
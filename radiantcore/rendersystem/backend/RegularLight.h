@@ -9,6 +9,7 @@
 #include "irenderview.h"
 #include "render/Rectangle.h"
 #include "InteractionPass.h"
+#include "LightInteractionCache.h"
 
 namespace render
 {
@@ -54,6 +55,9 @@ private:
     int _shadowLightIndex;
     bool _isShadowCasting;
 
+    // True if this light has been found to be hidden behind the depth buffer
+    bool _isOccluded;
+
     // Helper object submitting a DBS interaction draw call
     class InteractionDrawCall
     {
@@ -71,6 +75,11 @@ private:
 
         std::vector<IGeometryStore::Slot> _untransformedObjects;
 
+        // Untransformed objects of different materials, drawn with bindless textures
+        bool _useBatching;
+        std::vector<IGeometryStore::Slot> _batchedObjects;
+        std::vector<InteractionProgram::DrawParameters> _batchedDrawParameters;
+
         InteractionPass::Stage _defaultBumpStage;
         InteractionPass::Stage _defaultDiffuseStage;
         InteractionPass::Stage _defaultSpecularStage;
@@ -79,7 +88,8 @@ private:
 
     public:
         InteractionDrawCall(OpenGLState& state, InteractionProgram& program,
-            IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer);
+            IObjectRenderer& objectRenderer, const Vector3& worldLightOrigin, const Vector3& viewer,
+            bool useBatching);
 
         std::size_t getInteractionDrawCalls() const
         {
@@ -95,6 +105,10 @@ private:
             _defaultBumpStage.texture = pass.getDefaultInteractionTextureBinding(IShaderLayer::BUMP);
             _defaultDiffuseStage.texture = pass.getDefaultInteractionTextureBinding(IShaderLayer::DIFFUSE);
             _defaultSpecularStage.texture = pass.getDefaultInteractionTextureBinding(IShaderLayer::SPECULAR);
+
+            _defaultBumpStage.textureObject = pass.getDefaultInteractionTextureObject(IShaderLayer::BUMP);
+            _defaultDiffuseStage.textureObject = pass.getDefaultInteractionTextureObject(IShaderLayer::DIFFUSE);
+            _defaultSpecularStage.textureObject = pass.getDefaultInteractionTextureObject(IShaderLayer::SPECULAR);
         }
 
         bool hasBump() const
@@ -117,6 +131,14 @@ private:
         void setSpecular(const InteractionPass::Stage* specular);
 
         void submit(const ObjectList& objects);
+
+        // Draws the pending batch of untransformed objects
+        void flush();
+
+    private:
+        // Fills in the parameters of the current stage triple, returns false
+        // if any of the textures doesn't provide a bindless handle
+        bool getDrawParameters(InteractionProgram::DrawParameters& parameters) const;
     };
 
 public:
@@ -138,6 +160,16 @@ public:
         _shadowLightIndex = index;
     }
 
+    bool isOccluded() const
+    {
+        return _isOccluded;
+    }
+
+    void setOccluded(bool occluded)
+    {
+        _isOccluded = occluded;
+    }
+
     const RendererLight& getLight() const
     {
         return _light;
@@ -170,21 +202,42 @@ public:
 
     void addObject(IRenderableObject& object, IRenderEntity& entity, OpenGLShader* shader);
 
+    // Returns a hash value combining all the shadow casting objects of this light,
+    // used to determine whether a previously rendered shadow map is still valid
+    std::size_t getShadowCasterHash() const;
+
     bool isInView(const IRenderView& view);
 
     bool isShadowCasting() const;
 
     void collectSurfaces(const IRenderView& view, const std::set<IRenderEntityPtr>& entities);
 
-    void fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, 
-        std::size_t renderTime, std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest);
+    // Collects the surfaces from the list of objects touching this light, as provided by the cache
+    void collectSurfaces(const IRenderView& view, const LightInteractionCache::Objects& objects);
+
+    // Oriented objects without alpha test, grouped by their storage location.
+    // Objects sharing the same geometry can be drawn in a single instanced call.
+    using OrientedObjectsBySlot = std::map<IGeometryStore::Slot, std::vector<IRenderableObject*>>;
+
+    // Objects that can be drawn without alpha test are not submitted right away,
+    // they are added to the given collections instead
+    void fillDepthBuffer(OpenGLState& state, DepthFillAlphaProgram& program, std::size_t renderTime,
+        std::vector<IGeometryStore::Slot>& untransformedObjectsWithoutAlphaTest,
+        OrientedObjectsBySlot& orientedObjectsWithoutAlphaTest);
 
     void drawShadowMap(OpenGLState& state, const Rectangle& rectangle, ShadowMapProgram& program, std::size_t renderTime);
 
-    void drawInteractions(OpenGLState& state, InteractionProgram& program, const IRenderView& view, std::size_t renderTime);
+    // With useBatching set, objects without transform are drawn in multi draw calls spanning
+    // several materials (requires InteractionProgram::supportsBatching)
+    void drawInteractions(OpenGLState& state, InteractionProgram& program, const IRenderView& view,
+        std::size_t renderTime, bool useBatching = false);
 
     void setupAlphaTest(OpenGLState& state, OpenGLShader* shader, DepthFillPass* depthFillPass,
         ISupportsAlphaTest& alphaTestProgram, std::size_t renderTime, IRenderEntity* entity);
+
+private:
+    void addObjectIfInteracting(const IRenderView& view, IRenderableObject& object,
+        IRenderEntity& entity, Shader* shader);
 };
 
 }
@@ -81,6 +81,9 @@ void SceneRenderer::setupState(OpenGLState& state)
     glDisableVertexAttribArray(GLProgramAttribute::Normal);
     glDisableVertexAttribArray(GLProgramAttribute::Colour);
 
+    // Don't modify the texture left bound by the previous frame, its parameters
+    // are immutable if it has been used through a bindless handle
+    glBindTexture(GL_TEXTURE_2D, 0);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
@@ -6,6 +6,7 @@
 #include "isurfacerenderer.h"
 #include "igeometrystore.h"
 #include "iobjectrenderer.h"
+#include "render/ScreenSpaceSize.h"
 
 namespace render
 {
@@ -14,6 +15,9 @@ class SurfaceRenderer :
     public ISurfaceRenderer
 {
 private:
+    // Surfaces smaller than this (in pixels) are drawn as bounding box in orthographic views
+    static constexpr double MinOrthoSizeInPixels = 4;
+
     IGeometryStore& _store;
     IObjectRenderer& _renderer;
 
@@ -22,15 +26,25 @@ private:
         std::reference_wrapper<IRenderableSurface> surface;
         bool surfaceDataChanged;
         IGeometryStore::Slot storageHandle;
+        std::size_t geometryId;
 
-        SurfaceInfo(IRenderableSurface& surface_, IGeometryStore::Slot slot) :
+        SurfaceInfo(IRenderableSurface& surface_, IGeometryStore::Slot slot, std::size_t geometryId_) :
             surface(surface_),
             surfaceDataChanged(false),
-            storageHandle(slot)
+            storageHandle(slot),
+            geometryId(geometryId_)
         {}
     };
     std::map<Slot, SurfaceInfo> _surfaces;
 
+    // Storage shared by all surfaces with the same geometry ID
+    struct SharedGeometry
+    {
+        IGeometryStore::Slot storageHandle;
+        std::size_t useCount;
+    };
+    std::map<std::size_t, SharedGeometry> _sharedGeometry;
+
     Slot _freeSlotMappingHint;
 
     std::vector<Slot> _surfacesNeedingUpdate;
@@ -54,15 +68,10 @@ public:
         // Find a free slot
         auto newSlotIndex = getNextFreeSlotIndex();
 
-        const auto& vertices = surface.getVertices();
-        const auto& indices = surface.getIndices();
-
-        auto slot = _store.allocateSlot(vertices.size(), indices.size());
-
-        // Transform the vertices to single precision
-        _store.updateData(slot, ConvertToRenderVertices(vertices), indices);
+        auto geometryId = surface.getGeometryId();
+        auto slot = acquireStorage(surface, geometryId);
 
-        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, slot));
+        _surfaces.emplace(newSlotIndex, SurfaceInfo(surface, slot, geometryId));
 
         return newSlotIndex;
     }
@@ -73,7 +82,7 @@ public:
         assert(surface != _surfaces.end());
 
         // Deallocate the storage
-        _store.deallocateSlot(surface->second.storageHandle);
+        releaseStorage(surface->second);
         _surfaces.erase(surface);
 
         if (slot < _freeSlotMappingHint)
@@ -91,9 +100,11 @@ public:
 
     void render(const VolumeTest& view)
     {
+        auto useBoundsForSmallSurfaces = isOrthographicView(view);
+
         for (auto& surface : _surfaces)
         {
-            renderSlot(surface.second, &view);
+            renderSlot(surface.second, &view, useBoundsForSmallSurfaces);
         }
     }
 
@@ -126,6 +137,9 @@ public:
             {
                 surfaceInfo.surfaceDataChanged = false;
 
+                // Shared geometry is immutable, surfaces changing their vertices get a new ID
+                if (surfaceInfo.geometryId != 0) continue;
+
                 auto& surface = surfaceInfo.surface.get();
                 _store.updateData(surfaceInfo.storageHandle, ConvertToRenderVertices(surface.getVertices()), surface.getIndices());
             }
@@ -149,7 +163,51 @@ private:
         return transformedVertices;
     }
 
-    void renderSlot(SurfaceInfo& slot, const VolumeTest* view = nullptr)
+    IGeometryStore::Slot acquireStorage(IRenderableSurface& surface, std::size_t geometryId)
+    {
+        if (geometryId != 0)
+        {
+            auto existing = _sharedGeometry.find(geometryId);
+
+            if (existing != _sharedGeometry.end())
+            {
+                ++existing->second.useCount;
+                return existing->second.storageHandle;
+            }
+        }
+
+        const auto& vertices = surface.getVertices();
+        const auto& indices = surface.getIndices();
+
+        auto slot = _store.allocateSlot(vertices.size(), indices.size());
+
+        // Transform the vertices to single precision
+        _store.updateData(slot, ConvertToRenderVertices(vertices), indices);
+
+        if (geometryId != 0)
+        {
+            _sharedGeometry.emplace(geometryId, SharedGeometry{ slot, 1 });
+        }
+
+        return slot;
+    }
+
+    void releaseStorage(const SurfaceInfo& info)
+    {
+        if (info.geometryId != 0)
+        {
+            auto shared = _sharedGeometry.find(info.geometryId);
+            assert(shared != _sharedGeometry.end());
+
+            if (--shared->second.useCount > 0) return;
+
+            _sharedGeometry.erase(shared);
+        }
+
+        _store.deallocateSlot(info.storageHandle);
+    }
+
+    void renderSlot(SurfaceInfo& slot, const VolumeTest* view = nullptr, bool useBoundsForSmallSurfaces = false)
     {
         auto& surface = slot.surface.get();
 
@@ -164,6 +222,14 @@ private:
             throw std::logic_error("Cannot render unprepared slot, ensure calling SurfaceRenderer::prepareForRendering first");
         }
 
+        // Zoomed out far enough, a few lines are indistinguishable from the whole mesh
+        if (useBoundsForSmallSurfaces && getProjectedSizeInPixels(*view,
+            AABB::createFromOrientedAABBSafe(surface.getObjectBounds(), surface.getObjectTransform())) < MinOrthoSizeInPixels)
+        {
+            _renderer.submitObjectBounds(surface);
+            return;
+        }
+
         _renderer.submitObject(surface);
     }
 
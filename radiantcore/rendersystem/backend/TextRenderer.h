@@ -3,6 +3,7 @@
 #include <map>
 #include "igl.h"
 #include "irender.h"
+#include "ivolumetest.h"
 
 namespace render
 {
@@ -52,7 +53,9 @@ public:
         }
     }
 
-    void render()
+    // Texts positioned outside the view are skipped, their raster position
+    // would be invalid and nothing would be drawn anyway
+    void render(const VolumeTest& view)
     {
         for (const auto& [_, ref] : _slots)
         {
@@ -61,8 +64,12 @@ public:
 
             if (text.empty()) continue;
 
+            const auto& position = renderable.getWorldPosition();
+
+            if (!view.TestPoint(position)) continue;
+
             glColor4dv(renderable.getColour());
-            glRasterPos3dv(renderable.getWorldPosition());
+            glRasterPos3dv(position);
 
             _font->drawString(text);
         }
@@ -12,25 +12,55 @@ namespace
     // Filenames of shader code
     constexpr const char* const BLEND_LIGHT_VP_FILENAME = "blend_light_vp.glsl";
     constexpr const char* const BLEND_LIGHT_FP_FILENAME = "blend_light_fp.glsl";
+
+    // The uniform buffer binding point of the light parameter block
+    constexpr GLuint LIGHT_PARAMETER_BINDING = 1;
+
+    static_assert(sizeof(BlendLightProgram::LightParameters) == 5 * 4 * sizeof(float),
+        "LightParameters must match the std140 layout of the GLSL struct");
+}
+
+void BlendLightProgram::LightParameters::set(const Matrix4& lightTextureTransform, const Colour4& colour)
+{
+    // Same layout as in GLSLProgramBase::loadMatrixUniform
+    for (auto i = 0; i < 16; ++i)
+    {
+        lightTextureMatrix[i] = static_cast<float>(lightTextureTransform[i]);
+    }
+
+    blendColour[0] = static_cast<float>(colour.x());
+    blendColour[1] = static_cast<float>(colour.y());
+    blendColour[2] = static_cast<float>(colour.z());
+    blendColour[3] = static_cast<float>(colour.w());
 }
 
+BlendLightProgram::BlendLightProgram() :
+    _lightParameterBuffer(0)
+{}
+
 void BlendLightProgram::create()
 {
     // Create the program object
     rMessage() << "[renderer] Creating GLSL Blend Light program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(BLEND_LIGHT_VP_FILENAME, BLEND_LIGHT_FP_FILENAME);
-
-    // Bind vertex attribute locations and link the program
-    glBindAttribLocation(_programObj, GLProgramAttribute::Position, "attr_Position");
-
-    glLinkProgram(_programObj);
+    // Bind the vertex attribute locations when linking the program
+    _programObj = GLProgramFactory::createGLSLProgram(BLEND_LIGHT_VP_FILENAME, BLEND_LIGHT_FP_FILENAME,
+    {
+        { GLProgramAttribute::Position, "attr_Position" }
+    });
     debug::assertNoGlErrors();
 
     _locModelViewProjection = glGetUniformLocation(_programObj, "u_ModelViewProjection");
     _locObjectTransform = glGetUniformLocation(_programObj, "u_ObjectTransform");
-    _locBlendColour = glGetUniformLocation(_programObj, "u_BlendColour");
-    _locLightTextureMatrix = glGetUniformLocation(_programObj, "u_LightTextureMatrix");
+
+    auto lightParameterBlock = glGetUniformBlockIndex(_programObj, "LightParameterBlock");
+    glUniformBlockBinding(_programObj, lightParameterBlock, LIGHT_PARAMETER_BINDING);
+
+    glGenBuffers(1, &_lightParameterBuffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, _lightParameterBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, MaxBatchedLights * sizeof(LightParameters), nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    debug::assertNoGlErrors();
 
     glUseProgram(_programObj);
     debug::assertNoGlErrors();
@@ -46,6 +76,17 @@ void BlendLightProgram::create()
     debug::assertNoGlErrors();
 }
 
+void BlendLightProgram::destroy()
+{
+    if (_lightParameterBuffer != 0)
+    {
+        glDeleteBuffers(1, &_lightParameterBuffer);
+        _lightParameterBuffer = 0;
+    }
+
+    GLSLProgramBase::destroy();
+}
+
 void BlendLightProgram::enable()
 {
     GLSLProgramBase::enable();
@@ -60,6 +101,7 @@ void BlendLightProgram::disable()
     GLSLProgramBase::disable();
 
     glDisableVertexAttribArray(GLProgramAttribute::Position);
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_PARAMETER_BINDING, 0);
 
     debug::assertNoGlErrors();
 }
@@ -74,18 +116,19 @@ void BlendLightProgram::setObjectTransform(const Matrix4& transform)
     loadMatrixUniform(_locObjectTransform, transform);
 }
 
-void BlendLightProgram::setLightTextureTransform(const Matrix4& transform)
+void BlendLightProgram::setLightParameters(const std::vector<LightParameters>& parameters)
 {
-    loadMatrixUniform(_locLightTextureMatrix, transform);
-}
+    assert(parameters.size() <= MaxBatchedLights);
 
-void BlendLightProgram::setBlendColour(const Colour4& colour)
-{
-    glUniform4f(_locBlendColour,
-        static_cast<float>(colour.x()),
-        static_cast<float>(colour.y()),
-        static_cast<float>(colour.z()),
-        static_cast<float>(colour.w()));
+    // Orphan the previous contents, the last draw call might still be using them
+    glBindBuffer(GL_UNIFORM_BUFFER, _lightParameterBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, MaxBatchedLights * sizeof(LightParameters), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, parameters.size() * sizeof(LightParameters), parameters.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_PARAMETER_BINDING, _lightParameterBuffer);
+
+    debug::assertNoGlErrors();
 }
 
 }
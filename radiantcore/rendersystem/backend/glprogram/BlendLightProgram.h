@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "GLSLProgramBase.h"
 #include "render/Colour4.h"
 
@@ -9,21 +10,43 @@ namespace render
 class BlendLightProgram :
     public GLSLProgramBase
 {
+public:
+    // The number of lights that can be drawn in a single instanced call
+    static constexpr std::size_t MaxBatchedLights = 64;
+
+    /**
+     * Per-light data of an instanced blend light draw call, indexed by gl_InstanceID.
+     * Matches the std140 layout of the LightParameters struct in blend_light_vp.glsl.
+     */
+    struct LightParameters
+    {
+        float lightTextureMatrix[16];
+        float blendColour[4];
+
+        void set(const Matrix4& lightTextureTransform, const Colour4& colour);
+    };
+
 private:
-    int _locLightTextureMatrix;
-    int _locBlendColour;
     int _locModelViewProjection;
     int _locObjectTransform;
 
+    // The uniform buffer holding the LightParameters of a draw call
+    GLuint _lightParameterBuffer;
+
 public:
+    BlendLightProgram();
+
     void create() override;
+    void destroy() override;
     void enable() override;
     void disable() override;
 
     void setModelViewProjection(const Matrix4& modelViewProjection);
     void setObjectTransform(const Matrix4& transform);
-    void setLightTextureTransform(const Matrix4& transform);
-    void setBlendColour(const Colour4& colour);
+
+    // Uploads the parameters of the lights to draw the next objects with, one entry per
+    // instance. The list must not hold more than MaxBatchedLights elements.
+    void setLightParameters(const std::vector<LightParameters>& parameters);
 };
 
 }
@@ -21,15 +21,14 @@ void CubeMapProgram::create()
     // Create the program object
     rMessage() << "[renderer] Creating GLSL CubeMap program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(VP_FILENAME, FP_FILENAME);
-
-    // Bind vertex attribute locations and link the program
-    glBindAttribLocation(_programObj, GLProgramAttribute::TexCoord, "attr_TexCoord0");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Tangent, "attr_Tangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Bitangent, "attr_Bitangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Normal, "attr_Normal");
-
-    glLinkProgram(_programObj);
+    // Bind the vertex attribute locations when linking the program
+    _programObj = GLProgramFactory::createGLSLProgram(VP_FILENAME, FP_FILENAME,
+    {
+        { GLProgramAttribute::TexCoord, "attr_TexCoord0" },
+        { GLProgramAttribute::Tangent, "attr_Tangent" },
+        { GLProgramAttribute::Bitangent, "attr_Bitangent" },
+        { GLProgramAttribute::Normal, "attr_Normal" }
+    });
     debug::assertNoGlErrors();
 
     // Get a grip of the uniform declared in the fragment shader
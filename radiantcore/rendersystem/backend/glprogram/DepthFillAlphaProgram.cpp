@@ -1,5 +1,6 @@
 #include "DepthFillAlphaProgram.h"
 
+#include <algorithm>
 #include "GLProgramAttributes.h"
 #include "../GLProgramFactory.h"
 #include "debugging/gl.h"
@@ -20,14 +21,12 @@ void DepthFillAlphaProgram::create()
     // Create the program object
     rMessage() << "[renderer] Creating GLSL depthfill+alpha program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(
-        DEPTHFILL_ALPHA_VP_FILENAME, DEPTHFILL_ALPHA_FP_FILENAME
-    );
-
-    glBindAttribLocation(_programObj, GLProgramAttribute::Position, "attr_Position");
-    glBindAttribLocation(_programObj, GLProgramAttribute::TexCoord, "attr_TexCoord");
-
-    glLinkProgram(_programObj);
+    // Bind the vertex attribute locations when linking the program
+    _programObj = GLProgramFactory::createGLSLProgram(DEPTHFILL_ALPHA_VP_FILENAME, DEPTHFILL_ALPHA_FP_FILENAME,
+    {
+        { GLProgramAttribute::Position, "attr_Position" },
+        { GLProgramAttribute::TexCoord, "attr_TexCoord" }
+    });
 
     debug::assertNoGlErrors();
 
@@ -35,6 +34,8 @@ void DepthFillAlphaProgram::create()
     _locObjectTransform = glGetUniformLocation(_programObj, "u_ObjectTransform");
     _locModelViewProjection = glGetUniformLocation(_programObj, "u_ModelViewProjection");
     _locDiffuseTextureMatrix = glGetUniformLocation(_programObj, "u_DiffuseTextureMatrix");
+    _locInstanceTransforms = glGetUniformLocation(_programObj, "u_InstanceTransforms");
+    _locUseInstanceTransforms = glGetUniformLocation(_programObj, "u_UseInstanceTransforms");
 
     glUseProgram(_programObj);
     debug::assertNoGlErrors();
@@ -42,6 +43,8 @@ void DepthFillAlphaProgram::create()
     auto samplerLoc = glGetUniformLocation(_programObj, "u_Diffuse");
     glUniform1i(samplerLoc, 0);
 
+    glUniform1i(_locUseInstanceTransforms, 0);
+
     debug::assertNoGlErrors();
 }
 
@@ -76,6 +79,32 @@ void DepthFillAlphaProgram::setObjectTransform(const Matrix4& transform)
     loadMatrixUniform(_locObjectTransform, transform);
 }
 
+void DepthFillAlphaProgram::setInstanceTransforms(const std::vector<Matrix4>& transforms)
+{
+    assert(transforms.size() <= MaxInstances);
+
+    float values[16 * MaxInstances];
+    auto count = std::min(transforms.size(), MaxInstances);
+
+    for (std::size_t instance = 0; instance < count; ++instance)
+    {
+        for (auto i = 0; i < 16; ++i)
+        {
+            values[instance * 16 + i] = static_cast<float>(transforms[instance][i]);
+        }
+    }
+
+    glUniformMatrix4fv(_locInstanceTransforms, static_cast<GLsizei>(count), GL_FALSE, values);
+    glUniform1i(_locUseInstanceTransforms, 1);
+
+    debug::assertNoGlErrors();
+}
+
+void DepthFillAlphaProgram::disableInstanceTransforms()
+{
+    glUniform1i(_locUseInstanceTransforms, 0);
+}
+
 void DepthFillAlphaProgram::setDiffuseTextureTransform(const Matrix4& transform)
 {
     loadTextureMatrixUniform(_locDiffuseTextureMatrix, transform);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "GLSLProgramBase.h"
 
 namespace render
@@ -9,12 +10,19 @@ class DepthFillAlphaProgram :
     public GLSLProgramBase,
     public ISupportsAlphaTest
 {
+public:
+    // The number of instance transforms that can be passed in a single draw call,
+    // needs to match the array size in zfill_alpha_vp.glsl
+    static constexpr std::size_t MaxInstances = 32;
+
 private:
     GLint _locAlphaTest;
     GLint _locObjectTransform;
     GLint _locModelViewProjection;
     GLint _locDiffuseTextureMatrix;
-    
+    GLint _locInstanceTransforms;
+    GLint _locUseInstanceTransforms;
+
 public:
     void create() override;
     void enable() override;
@@ -23,6 +31,13 @@ public:
     void setModelViewProjection(const Matrix4& modelViewProjection);
     void setObjectTransform(const Matrix4& transform);
 
+    // Instanced draw calls will pick the object transform of each instance
+    // from the given list, which must not hold more than MaxInstances elements
+    void setInstanceTransforms(const std::vector<Matrix4>& transforms);
+
+    // Reverts to using the single object transform
+    void disableInstanceTransforms();
+
     void setAlphaTest(float alphaTest) override;
     void setDiffuseTextureTransform(const Matrix4& transform) override;
 };
@@ -10,7 +10,7 @@
 #include "math/Matrix4.h"
 #include "../OpenGLState.h"
 #include "render/Rectangle.h"
-#include "rendersystem/backend/FrameBuffer.h"
+#include "render/FrameBuffer.h"
 
 namespace render
 {
@@ -24,8 +24,45 @@ namespace
     const char* BUMP_VP_FILENAME = "interaction_vp.glsl";
     const char* BUMP_FP_FILENAME = "interaction_fp.glsl";
 
+    // Variant using bindless textures and per-draw parameters for batching
+    const char* BINDLESS_VP_FILENAME = "interaction_bindless_vp.glsl";
+    const char* BINDLESS_FP_FILENAME = "interaction_bindless_fp.glsl";
+
+    // The uniform buffer binding point of the draw parameter block
+    constexpr GLuint DRAW_PARAMETER_BINDING = 0;
+
+    static_assert(sizeof(InteractionProgram::DrawParameters) == 11 * 4 * sizeof(float),
+        "DrawParameters must match the std140 layout of the GLSL struct");
+
+    inline void setTextureMatrixRows(float* values, const Matrix4& matrix)
+    {
+        // Same layout as in GLSLProgramBase::loadTextureMatrixUniform
+        values[0] = static_cast<float>(matrix.xx());
+        values[1] = static_cast<float>(matrix.yx());
+        values[2] = 0.0f;
+        values[3] = static_cast<float>(matrix.tx());
+
+        values[4] = static_cast<float>(matrix.xy());
+        values[5] = static_cast<float>(matrix.yy());
+        values[6] = 0.0f;
+        values[7] = static_cast<float>(matrix.ty());
+    }
+
+    inline void setVector4(float* values, float x, float y, float z, float w)
+    {
+        values[0] = x;
+        values[1] = y;
+        values[2] = z;
+        values[3] = w;
+    }
 }
 
+InteractionProgram::InteractionProgram() :
+    _lightScale(1.0f),
+    _locUseDrawParameters(-1),
+    _drawParameterBuffer(0)
+{}
+
 // Main construction
 void InteractionProgram::create()
 {
@@ -37,18 +74,35 @@ void InteractionProgram::create()
     // Create the program object
     rMessage() << "[renderer] Creating GLSL bump program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(
-        BUMP_VP_FILENAME, BUMP_FP_FILENAME
-    );
+    // Vertex attribute locations to bind when linking the program
+    GLProgramFactory::AttributeBindings attributes
+    {
+        { GLProgramAttribute::Position, "attr_Position" },
+        { GLProgramAttribute::TexCoord, "attr_TexCoord" },
+        { GLProgramAttribute::Tangent, "attr_Tangent" },
+        { GLProgramAttribute::Bitangent, "attr_Bitangent" },
+        { GLProgramAttribute::Normal, "attr_Normal" },
+        { GLProgramAttribute::Colour, "attr_Colour" }
+    };
+
+    if (GLEW_ARB_bindless_texture && GLEW_ARB_shader_draw_parameters)
+    {
+        try
+        {
+            _programObj = GLProgramFactory::createGLSLProgram(BINDLESS_VP_FILENAME, BINDLESS_FP_FILENAME, attributes);
+        }
+        catch (const std::runtime_error& ex)
+        {
+            rWarning() << "[renderer] Bindless interaction program not available, "
+                "falling back to the regular one: " << ex.what() << std::endl;
+            _programObj = 0;
+        }
+    }
 
-    // Bind vertex attribute locations and link the program
-    glBindAttribLocation(_programObj, GLProgramAttribute::Position, "attr_Position");
-    glBindAttribLocation(_programObj, GLProgramAttribute::TexCoord, "attr_TexCoord");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Tangent, "attr_Tangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Bitangent, "attr_Bitangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Normal, "attr_Normal");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Colour, "attr_Colour");
-    glLinkProgram(_programObj);
+    if (_programObj == 0)
+    {
+        _programObj = GLProgramFactory::createGLSLProgram(BUMP_VP_FILENAME, BUMP_FP_FILENAME, attributes);
+    }
     debug::assertNoGlErrors();
 
     // Set the uniform locations to the correct bound values
@@ -71,6 +125,22 @@ void InteractionProgram::create()
 
     _locShadowMapRect = glGetUniformLocation(_programObj, "u_ShadowMapRect");
     _locUseShadowMap = glGetUniformLocation(_programObj, "u_UseShadowMap");
+    _locUseDrawParameters = glGetUniformLocation(_programObj, "u_UseDrawParameters");
+
+    // The per-draw parameters are only present in the bindless program
+    auto drawParameterBlock = glGetUniformBlockIndex(_programObj, "DrawParameterBlock");
+
+    if (_locUseDrawParameters != -1 && drawParameterBlock != GL_INVALID_INDEX)
+    {
+        glUniformBlockBinding(_programObj, drawParameterBlock, DRAW_PARAMETER_BINDING);
+
+        glGenBuffers(1, &_drawParameterBuffer);
+        glBindBuffer(GL_UNIFORM_BUFFER, _drawParameterBuffer);
+        glBufferData(GL_UNIFORM_BUFFER, MaxBatchedDraws * sizeof(DrawParameters), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+        rMessage() << "[renderer] Interaction batching with bindless textures enabled" << std::endl;
+    }
 
     // Set up the texture uniforms. The renderer uses fixed texture units for
     // particular textures, so make sure they are correct here.
@@ -104,12 +174,30 @@ void InteractionProgram::create()
     // Light scale is constant at this point
     glUniform1f(_locLightScale, _lightScale);
 
+    if (_locUseDrawParameters != -1)
+    {
+        glUniform1i(_locUseDrawParameters, 0);
+    }
+
     debug::assertNoGlErrors();
     glUseProgram(0);
 
     debug::assertNoGlErrors();
 }
 
+void InteractionProgram::destroy()
+{
+    if (_drawParameterBuffer != 0)
+    {
+        glDeleteBuffers(1, &_drawParameterBuffer);
+        _drawParameterBuffer = 0;
+    }
+
+    _locUseDrawParameters = -1;
+
+    GLSLProgramBase::destroy();
+}
+
 void InteractionProgram::enable()
 {
     GLSLProgramBase::enable();
@@ -142,6 +230,36 @@ void InteractionProgram::disable()
     debug::assertNoGlErrors();
 }
 
+bool InteractionProgram::supportsBatching() const
+{
+    return _drawParameterBuffer != 0;
+}
+
+void InteractionProgram::setDrawParameters(const std::vector<DrawParameters>& parameters)
+{
+    assert(supportsBatching());
+    assert(parameters.size() <= MaxBatchedDraws);
+
+    // Orphan the previous contents, the last batch might still be in use
+    glBindBuffer(GL_UNIFORM_BUFFER, _drawParameterBuffer);
+    glBufferData(GL_UNIFORM_BUFFER, MaxBatchedDraws * sizeof(DrawParameters), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, parameters.size() * sizeof(DrawParameters), parameters.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    glBindBufferBase(GL_UNIFORM_BUFFER, DRAW_PARAMETER_BINDING, _drawParameterBuffer);
+    glUniform1i(_locUseDrawParameters, 1);
+
+    debug::assertNoGlErrors();
+}
+
+void InteractionProgram::disableDrawParameters()
+{
+    if (_locUseDrawParameters == -1) return;
+
+    glUniform1i(_locUseDrawParameters, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, DRAW_PARAMETER_BINDING, 0);
+}
+
 void InteractionProgram::setStageVertexColour(IShaderLayer::VertexColourMode vertexColourMode, const Colour4& stageColour)
 {
     // Define the colour factors to blend into the final fragment
@@ -291,8 +409,55 @@ void InteractionProgram::setShadowMapRectangle(const Rectangle& rectangle)
     debug::assertNoGlErrors();
 }
 
+void InteractionProgram::DrawParameters::setTextureHandles(GLuint64 diffuse, GLuint64 bump, GLuint64 specular)
+{
+    // The handles are passed as uvec2 (low word first) to the shader
+    textureHandles[0] = static_cast<GLuint>(diffuse & 0xFFFFFFFF);
+    textureHandles[1] = static_cast<GLuint>(diffuse >> 32);
+    textureHandles[2] = static_cast<GLuint>(bump & 0xFFFFFFFF);
+    textureHandles[3] = static_cast<GLuint>(bump >> 32);
+    textureHandles[4] = static_cast<GLuint>(specular & 0xFFFFFFFF);
+    textureHandles[5] = static_cast<GLuint>(specular >> 32);
+    textureHandles[6] = 0;
+    textureHandles[7] = 0;
+}
+
+void InteractionProgram::DrawParameters::setTextureTransforms(const Matrix4& diffuse, const Matrix4& bump, const Matrix4& specular)
+{
+    setTextureMatrixRows(diffuseTextureMatrix, diffuse);
+    setTextureMatrixRows(bumpTextureMatrix, bump);
+    setTextureMatrixRows(specularTextureMatrix, specular);
 }
 
+void InteractionProgram::DrawParameters::setStageVertexColour(IShaderLayer::VertexColourMode vertexColourMode, const Colour4& stageColour)
+{
+    // Same factors as in InteractionProgram::setStageVertexColour
+    switch (vertexColourMode)
+    {
+    case IShaderLayer::VERTEX_COLOUR_NONE:
+        setVector4(colourModulation, 0, 0, 0, 0);
+        setVector4(colourAddition,
+            static_cast<float>(stageColour.x()),
+            static_cast<float>(stageColour.y()),
+            static_cast<float>(stageColour.z()),
+            static_cast<float>(stageColour.w()));
+        break;
+
+    case IShaderLayer::VERTEX_COLOUR_MULTIPLY:
+        setVector4(colourModulation, 1, 1, 1, 1);
+        setVector4(colourAddition, 0, 0, 0, 0);
+        break;
 
+    case IShaderLayer::VERTEX_COLOUR_INVERSE_MULTIPLY:
+        setVector4(colourModulation, -1, -1, -1, -1);
+        setVector4(colourAddition, 1, 1, 1, 1);
+        break;
+    }
+}
 
+void InteractionProgram::DrawParameters::setAlphaTest(float alphaTestValue)
+{
+    setVector4(alphaTest, alphaTestValue, 0, 0, 0);
+}
 
+}
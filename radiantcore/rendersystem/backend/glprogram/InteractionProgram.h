@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "ishaderlayer.h"
 #include "irender.h"
 #include "GLSLProgramBase.h"
@@ -13,6 +14,37 @@ struct Rectangle;
 class InteractionProgram :
     public GLSLProgramBase
 {
+public:
+    // The number of draws that can be combined into a single batch
+    static constexpr std::size_t MaxBatchedDraws = 64;
+
+    /**
+     * Per-draw data of a batched interaction draw call, indexed by gl_DrawIDARB
+     * in the bindless program. Matches the std140 layout of the DrawParameters
+     * struct in interaction_bindless_vp.glsl.
+     */
+    struct DrawParameters
+    {
+        // Diffuse, bump and specular texture handles, two uints each
+        GLuint textureHandles[8];
+
+        // The two top rows of the texture matrices
+        float diffuseTextureMatrix[8];
+        float bumpTextureMatrix[8];
+        float specularTextureMatrix[8];
+
+        float colourModulation[4];
+        float colourAddition[4];
+
+        // Alpha test reference value in the first component, negative to disable
+        float alphaTest[4];
+
+        void setTextureHandles(GLuint64 diffuse, GLuint64 bump, GLuint64 specular);
+        void setTextureTransforms(const Matrix4& diffuse, const Matrix4& bump, const Matrix4& specular);
+        void setStageVertexColour(IShaderLayer::VertexColourMode vertexColourMode, const Colour4& stageColour);
+        void setAlphaTest(float alphaTestValue);
+    };
+
 private:
 	// The value all lights should be scaled by, obtained from the game description
 	float _lightScale;
@@ -38,13 +70,32 @@ private:
     int _locUseShadowMap;
     int _locShadowMapRect;
 
+    int _locUseDrawParameters;
+
+    // The uniform buffer holding the DrawParameters of a batch,
+    // only present if the bindless program could be compiled
+    GLuint _drawParameterBuffer;
+
 public:
+    InteractionProgram();
 
     /* GLProgram implementation */
     void create() override;
+    void destroy() override;
     void enable() override;
     void disable() override;
 
+    // True if this program is able to render batches of objects with different
+    // interaction textures, using bindless textures and per-draw parameters
+    bool supportsBatching() const;
+
+    // Uploads the parameters of the next multi draw call, one entry per draw,
+    // and switches the program to source its stage parameters from them
+    void setDrawParameters(const std::vector<DrawParameters>& parameters);
+
+    // Switches back to the stage parameters set through the regular uniforms
+    void disableDrawParameters();
+
     void setModelViewProjection(const Matrix4& modelViewProjection);
     void setObjectTransform(const Matrix4& transform);
 
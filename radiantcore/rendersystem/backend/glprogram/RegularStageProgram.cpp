@@ -21,17 +21,16 @@ void RegularStageProgram::create()
     // Create the program object
     rMessage() << "[renderer] Creating GLSL Regular Stage program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(VP_FILENAME, FP_FILENAME);
-
-    // Bind vertex attribute locations and link the program
-    glBindAttribLocation(_programObj, GLProgramAttribute::Position, "attr_Position");
-    glBindAttribLocation(_programObj, GLProgramAttribute::TexCoord, "attr_TexCoord");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Tangent, "attr_Tangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Bitangent, "attr_Bitangent");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Normal, "attr_Normal");
-    glBindAttribLocation(_programObj, GLProgramAttribute::Colour, "attr_Colour");
-
-    glLinkProgram(_programObj);
+    // Bind the vertex attribute locations when linking the program
+    _programObj = GLProgramFactory::createGLSLProgram(VP_FILENAME, FP_FILENAME,
+    {
+        { GLProgramAttribute::Position, "attr_Position" },
+        { GLProgramAttribute::TexCoord, "attr_TexCoord" },
+        { GLProgramAttribute::Tangent, "attr_Tangent" },
+        { GLProgramAttribute::Bitangent, "attr_Bitangent" },
+        { GLProgramAttribute::Normal, "attr_Normal" },
+        { GLProgramAttribute::Colour, "attr_Colour" }
+    });
     debug::assertNoGlErrors();
 
     _locDiffuseTextureMatrix = glGetUniformLocation(_programObj, "u_DiffuseTextureMatrix");
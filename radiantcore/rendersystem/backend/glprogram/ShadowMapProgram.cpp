@@ -20,14 +20,12 @@ void ShadowMapProgram::create()
     // Create the program object
     rMessage() << "[renderer] Creating GLSL shadowmap program" << std::endl;
 
-    _programObj = GLProgramFactory::createGLSLProgram(
-        SHADOWMAP_VP_FILENAME, SHADOWMAP_FP_FILENAME
-    );
-
-    glBindAttribLocation(_programObj, GLProgramAttribute::Position, "attr_Position");
-    glBindAttribLocation(_programObj, GLProgramAttribute::TexCoord, "attr_TexCoord");
-
-    glLinkProgram(_programObj);
+    // Bind the vertex attribute locations when linking the program
+    _programObj = GLProgramFactory::createGLSLProgram(SHADOWMAP_VP_FILENAME, SHADOWMAP_FP_FILENAME,
+    {
+        { GLProgramAttribute::Position, "attr_Position" },
+        { GLProgramAttribute::TexCoord, "attr_TexCoord" }
+    });
 
     debug::assertNoGlErrors();
 
@@ -1,5 +1,6 @@
 #include "SpacePartitionRenderer.h"
 
+#include "itextstream.h"
 #include "registry/adaptors.h"
 #include "module/StaticModule.h"
 #include <functional>
@@ -20,6 +21,19 @@ void SpacePartitionRenderer::toggle(const cmd::ArgumentList& args)
 	);
 }
 
+void SpacePartitionRenderer::printStatistics(const cmd::ArgumentList& args)
+{
+	if (!registry::getValue<bool>(RKEY_RENDER_SPACE_PARTITION))
+	{
+		// Without rendering there are no query figures, but the tree can be evaluated
+		auto statistics = scene::collectSpacePartitionStatistics(GlobalSceneGraph().getSpacePartition()->getRoot());
+		rMessage() << "Space Partition Statistics (rendering disabled)\n" << statistics.toReport();
+		return;
+	}
+
+	rMessage() << "Space Partition Statistics\n" << _renderableSP.getStatistics().toReport();
+}
+
 const std::string& SpacePartitionRenderer::getName() const
 {
 	static std::string _name("SpacePartitionRenderer");
@@ -56,6 +70,7 @@ void SpacePartitionRenderer::initialiseModule(const IApplicationContext& ctx)
 
 	// Add the icon to the toolbar
 	GlobalCommandSystem().addCommand("ToggleSpacePartitionRendering", std::bind(&SpacePartitionRenderer::toggle, this, std::placeholders::_1));
+	GlobalCommandSystem().addCommand("PrintSpacePartitionStatistics", std::bind(&SpacePartitionRenderer::printStatistics, this, std::placeholders::_1));
 }
 
 void SpacePartitionRenderer::shutdownModule()
@@ -21,6 +21,9 @@ public:
 
 	void toggle(const cmd::ArgumentList& args);
 
+	// Prints the statistics of the last rendered frame to the console
+	void printStatistics(const cmd::ArgumentList& args);
+
 private:
 	void installRenderer();
 	void uninstallRenderer();
@@ -0,0 +1,89 @@
+#include "GraphSnapshot.h"
+
+namespace scene
+{
+
+GraphSnapshot::GraphSnapshot(const INodePtr& root, std::size_t epoch) :
+    _epoch(epoch)
+{
+    // Records the nodes depth-first, along with the end of their subtrees
+    class SnapshotBuilder :
+        public NodeVisitor
+    {
+    private:
+        std::vector<Entry>& _entries;
+        std::vector<std::size_t> _stack;
+
+    public:
+        SnapshotBuilder(std::vector<Entry>& entries) :
+            _entries(entries)
+        {}
+
+        bool pre(const INodePtr& node) override
+        {
+            _stack.push_back(_entries.size());
+            _entries.push_back(Entry{ node, 0 });
+            return true;
+        }
+
+        void post(const INodePtr& node) override
+        {
+            _entries[_stack.back()].subtreeEnd = _entries.size();
+            _stack.pop_back();
+        }
+    };
+
+    SnapshotBuilder builder(_entries);
+    root->traverse(builder);
+
+    _indices.reserve(_entries.size());
+
+    for (std::size_t i = 0; i < _entries.size(); ++i)
+    {
+        _indices.emplace(_entries[i].node.get(), i);
+    }
+}
+
+std::size_t GraphSnapshot::getEpoch() const
+{
+    return _epoch;
+}
+
+std::size_t GraphSnapshot::getNodeCount() const
+{
+    return _entries.size();
+}
+
+void GraphSnapshot::foreachNode(const INode::VisitorFunc& functor) const
+{
+    for (const auto& entry : _entries)
+    {
+        if (!functor(entry.node))
+        {
+            return;
+        }
+    }
+}
+
+void GraphSnapshot::foreachChildNode(const INodePtr& parent, const INode::VisitorFunc& functor) const
+{
+    auto found = _indices.find(parent.get());
+
+    if (found == _indices.end())
+    {
+        return;
+    }
+
+    auto end = _entries[found->second].subtreeEnd;
+
+    // Skip over the subtree of each child to get to the next one
+    for (auto i = found->second + 1; i < end; i = _entries[i].subtreeEnd)
+    {
+        if (!functor(_entries[i].node))
+        {
+            return;
+        }
+    }
+}
+
+} // namespace scene
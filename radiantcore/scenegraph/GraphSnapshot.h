@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include "iscenegraph.h"
+
+namespace scene
+{
+
+/**
+ * Implementation of a read-only scene graph snapshot. The nodes are
+ * stored in depth-first order, each entry knowing where its subtree ends.
+ */
+class GraphSnapshot :
+    public IGraphSnapshot
+{
+private:
+    struct Entry
+    {
+        INodePtr node;
+
+        // One past the index of the last node in this node's subtree
+        std::size_t subtreeEnd;
+    };
+
+    std::size_t _epoch;
+
+    std::vector<Entry> _entries;
+
+    // Maps nodes to their entry index, used to look up the children
+    std::unordered_map<const INode*, std::size_t> _indices;
+
+public:
+    // Captures the hierarchy below (and including) the given root node
+    GraphSnapshot(const INodePtr& root, std::size_t epoch);
+
+    std::size_t getEpoch() const override;
+    std::size_t getNodeCount() const override;
+
+    void foreachNode(const INode::VisitorFunc& functor) const override;
+    void foreachChildNode(const INodePtr& parent, const INode::VisitorFunc& functor) const override;
+};
+
+} // namespace scene
@@ -0,0 +1,231 @@
+#include "LooseOctree.h"
+
+#include <algorithm>
+#include <cmath>
+#include "inode.h"
+#include "math/AABB.h"
+#include "RayTraversal.h"
+
+namespace scene
+{
+
+namespace
+{
+    // The number of members, before a cell tries to subdivide itself
+    const std::size_t SUBDIVISION_THRESHOLD = 32;
+
+    // Cells are not subdivided below this half edge length
+    const double MIN_NODE_EXTENTS = 128;
+
+    // The half edge length of the root cell
+    const double MAX_WORLD_COORD = 65536;
+}
+
+class LooseOctreeNode :
+    public ISPNode,
+    public std::enable_shared_from_this<LooseOctreeNode>
+{
+private:
+    friend class LooseOctree;
+
+    // The center and the half edge length of the (tight) cell
+    Vector3 _origin;
+    double _cellExtents;
+
+    // The cell bounds enlarged by the factor 2, containing all the members
+    AABB _looseBounds;
+
+    ISPNodeWeakPtr _parent;
+
+    // The child nodes (8 or 0)
+    NodeList _children;
+
+    MemberList _members;
+
+public:
+    LooseOctreeNode(const Vector3& origin, double cellExtents, const LooseOctreeNodePtr& parent = LooseOctreeNodePtr()) :
+        _origin(origin),
+        _cellExtents(cellExtents),
+        _looseBounds(origin, Vector3(cellExtents, cellExtents, cellExtents) * 2),
+        _parent(parent)
+    {}
+
+    ISPNodePtr getParent() const override
+    {
+        return _parent.lock();
+    }
+
+    const AABB& getBounds() const override
+    {
+        return _looseBounds;
+    }
+
+    const NodeList& getChildNodes() const override
+    {
+        return _children;
+    }
+
+    bool isLeaf() const override
+    {
+        return _children.empty();
+    }
+
+    const MemberList& getMembers() const override
+    {
+        return _members;
+    }
+
+private:
+    // Returns true if the given point is located in the tight cell bounds
+    bool cellContains(const Vector3& point) const
+    {
+        return std::abs(point.x() - _origin.x()) <= _cellExtents &&
+            std::abs(point.y() - _origin.y()) <= _cellExtents &&
+            std::abs(point.z() - _origin.z()) <= _cellExtents;
+    }
+
+    // The index of the child cell containing the given point, one bit per axis
+    std::size_t getChildIndex(const Vector3& point) const
+    {
+        return (point.x() >= _origin.x() ? 1 : 0) |
+            (point.y() >= _origin.y() ? 2 : 0) |
+            (point.z() >= _origin.z() ? 4 : 0);
+    }
+
+    LooseOctreeNode& getChild(std::size_t index)
+    {
+        return static_cast<LooseOctreeNode&>(*_children[index]);
+    }
+
+    void createChildren()
+    {
+        auto childExtents = _cellExtents * 0.5;
+
+        _children.resize(8);
+
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            Vector3 childOrigin(
+                _origin.x() + (i & 1 ? childExtents : -childExtents),
+                _origin.y() + (i & 2 ? childExtents : -childExtents),
+                _origin.z() + (i & 4 ? childExtents : -childExtents)
+            );
+
+            _children[i] = std::make_shared<LooseOctreeNode>(childOrigin, childExtents, shared_from_this());
+        }
+    }
+};
+
+LooseOctree::LooseOctree() :
+    _root(std::make_shared<LooseOctreeNode>(Vector3(0, 0, 0), MAX_WORLD_COORD))
+{}
+
+LooseOctree::~LooseOctree()
+{
+    _nodeMapping.clear();
+    _root.reset();
+}
+
+void LooseOctree::link(const INodePtr& sceneNode)
+{
+    // Make sure we don't do double-links
+    assert(_nodeMapping.find(sceneNode) == _nodeMapping.end());
+
+    linkRecursively(*_root, sceneNode);
+}
+
+void LooseOctree::linkRecursively(LooseOctreeNode& cell, const INodePtr& sceneNode)
+{
+    const AABB& bounds = sceneNode->worldAABB();
+
+    // Descend into the child cell containing the center, if the node is small enough
+    if (bounds.isValid() && !cell.isLeaf() && cell.cellContains(bounds.origin))
+    {
+        auto size = std::max({ bounds.extents.x(), bounds.extents.y(), bounds.extents.z() });
+
+        if (size <= cell._cellExtents * 0.5)
+        {
+            linkRecursively(cell.getChild(cell.getChildIndex(bounds.origin)), sceneNode);
+            return;
+        }
+    }
+
+    cell._members.push_back(sceneNode);
+    _nodeMapping.emplace(sceneNode, Location{ &cell, cell._members.size() - 1 });
+
+    if (cell.isLeaf() &&
+        cell._members.size() >= SUBDIVISION_THRESHOLD &&
+        cell._cellExtents > MIN_NODE_EXTENTS)
+    {
+        subdivide(cell);
+    }
+}
+
+void LooseOctree::subdivide(LooseOctreeNode& cell)
+{
+    // Evaluate all member bounds before re-distributing them, this might
+    // trigger re-links of the members (see Octree)
+    {
+        ISPNode::MemberList temp = cell._members;
+
+        for (const auto& member : temp)
+        {
+            member->worldAABB();
+        }
+    }
+
+    // A re-link might have subdivided the cell already
+    if (!cell.isLeaf()) return;
+
+    cell.createChildren();
+
+    ISPNode::MemberList oldList;
+    oldList.swap(cell._members);
+
+    for (const auto& member : oldList)
+    {
+        _nodeMapping.erase(member);
+
+        // The cell is no leaf anymore, members that don't fit into a child stay here
+        linkRecursively(cell, member);
+    }
+}
+
+bool LooseOctree::unlink(const INodePtr& sceneNode)
+{
+    auto found = _nodeMapping.find(sceneNode);
+
+    if (found == _nodeMapping.end())
+    {
+        return false;
+    }
+
+    auto& members = found->second.cell->_members;
+    auto index = found->second.index;
+
+    _nodeMapping.erase(found);
+
+    // Swap the last member into the gap, the member order is not relevant
+    if (index != members.size() - 1)
+    {
+        members[index] = std::move(members.back());
+        _nodeMapping.at(members[index]).index = index;
+    }
+
+    members.pop_back();
+
+    return true;
+}
+
+ISPNodePtr LooseOctree::getRoot() const
+{
+    return _root;
+}
+
+void LooseOctree::foreachNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) const
+{
+    // The loose bounds contain all the members, so they can be used to cull the cells
+    traverseAlongRay(*_root, ray, visitor, maxDistance);
+}
+
+} // namespace scene
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "ispacepartition.h"
+#include <unordered_map>
+
+namespace scene
+{
+
+class LooseOctreeNode;
+typedef std::shared_ptr<LooseOctreeNode> LooseOctreeNodePtr;
+
+/**
+ * A loose octree is an alternative to the regular Octree, covering
+ * a fixed cube around the world origin, subdividing itself like the Octree
+ * when a cell holds too many members.
+ *
+ * The difference is how scene::INodes are assigned to the cells: a node is
+ * linked to the cell containing its center, on the deepest level whose cell
+ * size is larger than the node's own size. The bounds of every cell are
+ * enlarged to twice the cell size, such that they still contain all the
+ * members. Nodes straddling a cell boundary therefore don't need to be moved
+ * up to the parent cell, which keeps large maps from piling up thousands of
+ * members in the root node.
+ *
+ * The bounds reported through ISPNode::getBounds() are the loose bounds,
+ * so the tree can be traversed like any other ISpacePartitionSystem.
+ */
+class LooseOctree :
+    public ISpacePartitionSystem
+{
+private:
+    // The root node of this SP
+    LooseOctreeNodePtr _root;
+
+    // Maps scene nodes against the cells they are linked to
+    struct Location
+    {
+        LooseOctreeNode* cell;
+        std::size_t index;
+    };
+    typedef std::unordered_map<INodePtr, Location> NodeMapping;
+    NodeMapping _nodeMapping;
+
+public:
+    LooseOctree();
+    ~LooseOctree();
+
+    void link(const INodePtr& sceneNode) override;
+    bool unlink(const INodePtr& sceneNode) override;
+
+    ISPNodePtr getRoot() const override;
+
+    void foreachNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) const override;
+
+private:
+    // Links the scene node into the given cell or one of its descendants
+    void linkRecursively(LooseOctreeNode& cell, const INodePtr& sceneNode);
+
+    // Adds 8 children to the given cell and moves down the members fitting into them
+    void subdivide(LooseOctreeNode& cell);
+};
+
+} // namespace scene
@@ -3,6 +3,7 @@
 #include "inode.h"
 
 #include "OctreeNode.h"
+#include "RayTraversal.h"
 
 namespace scene
 {
@@ -113,7 +114,7 @@ bool Octree::unlink(const scene::INodePtr& sceneNode)
 	if (found != _nodeMapping.end())
 	{
 		// Lookup successful, unlink the node (will fire notifyUnlink())
-		found->second->unlink(sceneNode);
+		found->second.node->unlink(found->second.index);
 		return true;
 	}
 
@@ -126,10 +127,16 @@ ISPNodePtr Octree::getRoot() const
 	return _root;
 }
 
-void Octree::notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node)
+void Octree::foreachNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) const
+{
+	// All members are contained in the bounds of their octree node
+	traverseAlongRay(*_root, ray, visitor, maxDistance);
+}
+
+void Octree::notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node, std::size_t index)
 {
 	std::pair<NodeMapping::iterator, bool> result =
-		_nodeMapping.insert(NodeMapping::value_type(sceneNode, node));
+		_nodeMapping.emplace(sceneNode, Location{ node, index });
 
 	assert(result.second);
 }
@@ -144,13 +151,22 @@ void Octree::notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node)
 	_nodeMapping.erase(found);
 }
 
+void Octree::notifyMove(const scene::INodePtr& sceneNode, std::size_t newIndex)
+{
+	NodeMapping::iterator found = _nodeMapping.find(sceneNode);
+
+	assert(found != _nodeMapping.end());
+
+	found->second.index = newIndex;
+}
+
 #ifdef _DEBUG
 void Octree::notifyErase(OctreeNode* node)
 {
 	// Remove the node from the lookup table, if found
 	for (NodeMapping::iterator i = _nodeMapping.begin(); i != _nodeMapping.end(); ++i)
 	{
-		assert(i->second != node);
+		assert(i->second.node != node);
 	}
 }
 #endif
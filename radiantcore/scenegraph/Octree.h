@@ -2,7 +2,7 @@
 #define _OCTREE_H_
 
 #include "ispacepartition.h"
-#include <map>
+#include <unordered_map>
 
 namespace scene
 {
@@ -36,7 +36,8 @@ typedef std::shared_ptr<OctreeNode> OctreeNodePtr;
  * The Octree maintains a lookup table (NodeMapping) to implement a fast unlink()
  * algorithm. The scene::INodes don't know or care where they are linked to, so
  * it needs a fast lookup to avoid having to traverse the entire tree to find and
- * remove a single node.
+ * remove a single node. The table also stores the index of the scene::INode in
+ * the member list of its OctreeNode, such that unlinking takes constant time.
  */
 class Octree :
 	public ISpacePartitionSystem
@@ -45,8 +46,15 @@ private:
 	// The root node of this SP
 	OctreeNodePtr _root;
 
+	// The octree node a scene node is linked to, and its index in the member list
+	struct Location
+	{
+		OctreeNode* node;
+		std::size_t index;
+	};
+
 	// Maps scene nodes against octree nodes, for fast lookup during unlink
-	typedef std::map<INodePtr, OctreeNode*> NodeMapping;
+	typedef std::unordered_map<INodePtr, Location> NodeMapping;
 	NodeMapping _nodeMapping;
 
 public:
@@ -63,10 +71,15 @@ public:
 	// Returns the root node of this SP tree
 	ISPNodePtr getRoot() const;
 
+	void foreachNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) const override;
+
 	// Callback used by the OctreeNodes to let the tree update its caching structures
-	void notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node);
+	void notifyLink(const scene::INodePtr& sceneNode, OctreeNode* node, std::size_t index);
 	void notifyUnlink(const scene::INodePtr& sceneNode, OctreeNode* node);
 
+	// A member has been moved to a different index within the same octree node
+	void notifyMove(const scene::INodePtr& sceneNode, std::size_t newIndex);
+
 #ifdef _DEBUG
 	// In debug builds, this ensures that no octree node is deleted
 	// while it is still mapped in the NodeMapping table
@@ -149,14 +149,16 @@ public:
 	// This method moves all the contents (members) of this node to the "other" target node
 	void relocateMembersTo(OctreeNode& target)
 	{
+		auto firstIndex = target._members.size();
+
 		// Copy all members from here to the target
 		target._members.insert(target._members.end(), _members.begin(), _members.end());
 
 		// Notify the Octree about the relocation
-		for (ISPNode::MemberList::iterator i = _members.begin(); i != _members.end(); ++i)
+		for (std::size_t i = 0; i < _members.size(); ++i)
 		{
-			_owner.notifyUnlink(*i, this);
-			_owner.notifyLink(*i, &target);
+			_owner.notifyUnlink(_members[i], this);
+			_owner.notifyLink(_members[i], &target, firstIndex + i);
 		}
 
 		// Clear our own member list
@@ -184,7 +186,7 @@ public:
 		_members.push_back(sceneNode);
 
 		// Notify the Octree to update lookup caches
-		_owner.notifyLink(sceneNode, this);
+		_owner.notifyLink(sceneNode, this, _members.size() - 1);
 	}
 
 	// Links the given scene object into the tree
@@ -261,18 +263,23 @@ public:
 		return this;
 	}
 
-	void unlink(const scene::INodePtr& sceneNode)
+	// Removes the member at the given index, as stored in the owning Octree's lookup table
+	void unlink(std::size_t index)
 	{
-		// Lookup the node in the members list (rather slow lookup)
-		ISPNode::MemberList::iterator found =
-			std::find(_members.begin(), _members.end(), sceneNode);
+		assert(index < _members.size());
+
+		auto sceneNode = _members[index];
 
-		if (found != _members.end())
+		// Swap the last member into the gap, the member order is not relevant
+		if (index != _members.size() - 1)
 		{
-			_members.erase(found);
+			_members[index] = std::move(_members.back());
+			_owner.notifyMove(_members[index], index);
 		}
 
-		// Let the Octree know about this, regardless whether we found it or not (the Octree relies on this)
+		_members.pop_back();
+
+		// Let the Octree know about this
 		_owner.notifyUnlink(sceneNode, this);
 	}
 
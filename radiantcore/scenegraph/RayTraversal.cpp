@@ -0,0 +1,49 @@
+#include "RayTraversal.h"
+
+#include <queue>
+#include "math/Ray.h"
+
+namespace scene
+{
+
+void traverseAlongRay(const ISPNode& root, const Ray& ray,
+    const ISpacePartitionSystem::RayVisitor& visitor, double maxDistance)
+{
+    // SP nodes waiting to be visited, the closest one on top
+    typedef std::pair<double, const ISPNode*> Candidate;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+
+    double entry, exit;
+
+    if (ray.intersectAABB(root.getBounds(), entry, exit) && entry <= maxDistance)
+    {
+        candidates.emplace(entry, &root);
+    }
+
+    while (!candidates.empty())
+    {
+        auto [distance, node] = candidates.top();
+        candidates.pop();
+
+        // The visitor might have found a hit closer than this SP node
+        if (distance > maxDistance)
+        {
+            break;
+        }
+
+        for (const auto& member : node->getMembers())
+        {
+            visitor(member, maxDistance);
+        }
+
+        for (const auto& child : node->getChildNodes())
+        {
+            if (ray.intersectAABB(child->getBounds(), entry, exit) && entry <= maxDistance)
+            {
+                candidates.emplace(entry, child.get());
+            }
+        }
+    }
+}
+
+} // namespace scene
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ispacepartition.h"
+
+namespace scene
+{
+
+/**
+ * Front-to-back traversal of the SP nodes below (and including) the given root,
+ * as described by ISpacePartitionSystem::foreachNodeAlongRay(). The SP nodes are
+ * visited in the order of their entry distance, so the traversal can stop as soon
+ * as the next SP node is further away than the nearest hit found by the visitor.
+ */
+void traverseAlongRay(const ISPNode& root, const Ray& ray,
+    const ISpacePartitionSystem::RayVisitor& visitor, double maxDistance);
+
+} // namespace scene
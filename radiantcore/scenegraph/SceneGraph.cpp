@@ -1,5 +1,8 @@
 #include "SceneGraph.h"
 
+#include <algorithm>
+#include <future>
+#include <numeric>
 #include "ivolumetest.h"
 #include "itextstream.h"
 
@@ -7,19 +10,188 @@
 #include "debugging/debugging.h"
 
 #include "math/AABB.h"
+#include "math/AABBBatch.h"
+#include "registry/registry.h"
 #include "Octree.h"
+#include "LooseOctree.h"
 #include "SceneGraphFactory.h"
+#include "GraphSnapshot.h"
 #include "util/ScopedBoolLock.h"
 #include "module/StaticModule.h"
 
 namespace scene
 {
 
+namespace
+{
+    ISpacePartitionSystemPtr createSpacePartition()
+    {
+        if (registry::getValue<std::string>(RKEY_SPACE_PARTITION_TYPE) == "looseOctree")
+        {
+            return std::make_shared<LooseOctree>();
+        }
+
+        return std::make_shared<Octree>();
+    }
+
+    std::string getNodeTypeName(INode::Type type)
+    {
+        switch (type)
+        {
+        case INode::Type::MapRoot: return "Map root";
+        case INode::Type::Entity: return "Entity";
+        case INode::Type::Brush: return "Brush";
+        case INode::Type::Patch: return "Patch";
+        case INode::Type::Model: return "Model";
+        case INode::Type::Particle: return "Particle";
+        case INode::Type::EntityConnection: return "Entity connection";
+        case INode::Type::MergeAction: return "Merge action";
+        case INode::Type::UnloadedBlock: return "Unloaded block";
+        default: return "Other";
+        }
+    }
+
+    // Adds the visible members of the given partition node to the list
+    void collectVisibleMembers(const ISPNode& node, std::vector<INodePtr>& nodes)
+    {
+        for (const auto& member : node.getMembers())
+        {
+            if (member->visible())
+            {
+                nodes.push_back(member);
+            }
+        }
+    }
+
+    // Tests the bounds of the given node's children against the volume, a batch at a time.
+    // The visitor is invoked with each child and its intersection value, in order,
+    // returns false as soon as the visitor returns false.
+    template<typename Visitor>
+    bool foreachChildIntersection(const ISPNode& node, const VolumeTest& volume, const Visitor& visitor)
+    {
+        const auto& children = node.getChildNodes();
+
+        AABBBatch batch;
+        VolumeIntersectionValue results[AABBBatch::Size];
+
+        for (std::size_t first = 0; first < children.size(); first += AABBBatch::Size)
+        {
+            auto count = std::min(AABBBatch::Size, children.size() - first);
+
+            batch.clear();
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                batch.add(children[first + i]->getBounds());
+            }
+
+            volume.TestAABBs(batch, results);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                if (!visitor(children[first + i], results[i]))
+                {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    // Classifies the given member by its own bounds, members without valid bounds count as intersecting
+    VolumeIntersectionValue classifyMember(const INode& member, const AABB& bounds)
+    {
+        const auto& memberBounds = member.worldAABB();
+
+        if (!memberBounds.isValid())
+        {
+            return VOLUME_PARTIAL;
+        }
+
+        if (bounds.contains(memberBounds))
+        {
+            return VOLUME_INSIDE;
+        }
+
+        return memberBounds.intersects(bounds) ? VOLUME_PARTIAL : VOLUME_OUTSIDE;
+    }
+
+    // The cell bounds contain the bounds of its members (except for the ones of the root cell),
+    // such that members of cells entirely inside or outside don't need to be tested individually
+    void foreachNodeByBounds_r(const ISPNode& node, const AABB& bounds, const Graph::BoundsVisitor& visitor,
+        bool visitContained, VolumeIntersectionValue intersection)
+    {
+        if (intersection == VOLUME_INSIDE && !visitContained)
+        {
+            return;
+        }
+
+        for (const auto& member : node.getMembers())
+        {
+            if (intersection == VOLUME_PARTIAL)
+            {
+                auto memberIntersection = classifyMember(*member, bounds);
+
+                if (memberIntersection != VOLUME_INSIDE || visitContained)
+                {
+                    visitor(member, memberIntersection);
+                }
+            }
+            else
+            {
+                visitor(member, member->worldAABB().isValid() ? intersection : VOLUME_PARTIAL);
+            }
+        }
+
+        for (const auto& child : node.getChildNodes())
+        {
+            auto childIntersection = intersection;
+
+            if (intersection == VOLUME_PARTIAL)
+            {
+                const auto& childBounds = child->getBounds();
+
+                childIntersection = bounds.contains(childBounds) ? VOLUME_INSIDE :
+                    childBounds.intersects(bounds) ? VOLUME_PARTIAL : VOLUME_OUTSIDE;
+            }
+
+            foreachNodeByBounds_r(*child, bounds, visitor, visitContained, childIntersection);
+        }
+    }
+
+    // Thread-safe version of foreachNodeInVolume_r, collecting the visible nodes in traversal order
+    // The number of entered SP nodes is added to visitedNodes
+    void collectVisibleNodesInVolume_r(const ISPNode& node, const VolumeTest& volume, std::vector<INodePtr>& nodes,
+        std::size_t& visitedNodes)
+    {
+        visitedNodes++;
+
+        collectVisibleMembers(node, nodes);
+
+        foreachChildIntersection(node, volume, [&](const ISPNodePtr& child, VolumeIntersectionValue intersection)
+        {
+            if (intersection != VOLUME_OUTSIDE)
+            {
+                collectVisibleNodesInVolume_r(*child, volume, nodes, visitedNodes);
+            }
+
+            return true;
+        });
+    }
+}
+
 SceneGraph::SceneGraph() :
 	_spacePartition(new Octree),
 	_visitedSPNodes(0),
 	_skippedSPNodes(0),
-    _traversalOngoing(false)
+    _numVolumeQueries(0),
+    _numVisitedSPNodes(0),
+    _batchUpdateDepth(0),
+    _sceneChangedPending(false),
+    _boundsChangedPending(false),
+    _traversalOngoing(false),
+    _epoch(0)
 {}
 
 SceneGraph::~SceneGraph()
@@ -30,6 +202,9 @@ SceneGraph::~SceneGraph()
         flushActionBuffer();
 		setRoot(IMapRootNodePtr());
 	}
+
+    std::atomic_store(&_latestSnapshot, IGraphSnapshotPtr());
+    _publishedSnapshots.clear();
 }
 
 void SceneGraph::addSceneObserver(Graph::Observer* observer)
@@ -58,6 +233,12 @@ void SceneGraph::removeSceneObserver(Graph::Observer* observer)
 
 void SceneGraph::sceneChanged()
 {
+    if (_batchUpdateDepth > 0)
+    {
+        _sceneChangedPending = true;
+        return;
+    }
+
     for (Graph::Observer* observer : _sceneObservers)
     {
 		observer->onSceneGraphChange();
@@ -86,9 +267,12 @@ void SceneGraph::setRoot(const IMapRootNodePtr& newRoot)
 	}
 
 	_root = newRoot;
+    ++_epoch;
 
-	// Refresh the space partition class
-	_spacePartition = std::make_shared<Octree>();
+	// Refresh the space partition class, the type can be changed between maps
+	_spacePartition = createSpacePartition();
+    _nodesWithChangedBounds.clear();
+    _damagedBounds = AABB();
 
 	if (_root)
 	{
@@ -131,9 +315,39 @@ void SceneGraph::onUndoEvent(IUndoSystem::EventType type, const std::string& ope
 
 void SceneGraph::boundsChanged()
 {
+    if (_batchUpdateDepth > 0)
+    {
+        _boundsChangedPending = true;
+        return;
+    }
+
     _sigBoundsChanged();
 }
 
+void SceneGraph::beginBatchUpdate()
+{
+    ++_batchUpdateDepth;
+}
+
+void SceneGraph::endBatchUpdate()
+{
+    assert(_batchUpdateDepth > 0);
+
+    if (--_batchUpdateDepth > 0) return;
+
+    if (_boundsChangedPending)
+    {
+        _boundsChangedPending = false;
+        boundsChanged();
+    }
+
+    if (_sceneChangedPending)
+    {
+        _sceneChangedPending = false;
+        sceneChanged();
+    }
+}
+
 sigc::signal<void> SceneGraph::signal_boundsChanged() const
 {
     return _sigBoundsChanged;
@@ -147,6 +361,8 @@ void SceneGraph::insert(const INodePtr& node)
         return;
     }
 
+    ++_epoch;
+
     // Notify the graph tree model about the change
 	sceneChanged();
 
@@ -171,7 +387,10 @@ void SceneGraph::erase(const INodePtr& node)
         return;
     }
 
+    ++_epoch;
+
 	_spacePartition->unlink(node);
+    _nodesWithChangedBounds.erase(node);
 
 	// Fire the onRemove event on the Node
     assert(_root);
@@ -186,19 +405,102 @@ void SceneGraph::erase(const INodePtr& node)
 	}
 }
 
-void SceneGraph::nodeBoundsChanged(const INodePtr& node)
+void SceneGraph::nodeBoundsChanged(const INodePtr& node, const AABB& damagedBounds)
 {
-    if (_traversalOngoing)
+    // The node is re-linked before the space partition is used the next time,
+    // such that a node changing its bounds many times is only re-linked once
+    _nodesWithChangedBounds.insert(node);
+
+    _damagedBounds.includeAABB(damagedBounds);
+}
+
+void SceneGraph::notifyDamagedBounds()
+{
+    if (!_root) return;
+
+    // Evaluating the root bounds is evaluating every node with pending bounds changes
+    _root->worldAABB();
+
+    if (!_damagedBounds.isValid()) return;
+
+    AABB damagedBounds = _damagedBounds;
+    _damagedBounds = AABB();
+
+    for (Graph::Observer* observer : _sceneObservers)
     {
-        _actionBuffer.push_back(NodeAction(BoundsChange, node));
-        return;
+        observer->onSceneBoundsDamaged(damagedBounds);
     }
+}
 
-	if (_spacePartition->unlink(node))
-	{
-		// unlink returned true, so the given node was linked before => re-link it
-		_spacePartition->link(node);
-	}
+void SceneGraph::relinkNodesWithChangedBounds()
+{
+    // Don't modify the space partition during traversal
+    if (_traversalOngoing) return;
+
+    // Re-linking evaluates the node bounds, which might mark further nodes as changed
+    while (!_nodesWithChangedBounds.empty())
+    {
+        std::unordered_set<INodePtr> changedNodes;
+        changedNodes.swap(_nodesWithChangedBounds);
+
+        for (const auto& node : changedNodes)
+        {
+            if (_spacePartition->unlink(node))
+            {
+                // unlink returned true, so the given node was linked before => re-link it
+                _spacePartition->link(node);
+            }
+        }
+    }
+}
+
+std::size_t SceneGraph::getEpoch() const
+{
+    return _epoch;
+}
+
+IGraphSnapshotPtr SceneGraph::createSnapshot()
+{
+    releaseUnusedSnapshots();
+
+    if (!_root)
+    {
+        std::atomic_store(&_latestSnapshot, IGraphSnapshotPtr());
+        return IGraphSnapshotPtr();
+    }
+
+    auto latest = std::atomic_load(&_latestSnapshot);
+
+    if (latest && latest->getEpoch() == _epoch)
+    {
+        return latest;
+    }
+
+    auto snapshot = std::make_shared<GraphSnapshot>(_root, _epoch);
+
+    // Keep a reference to make sure the snapshot is released on this thread
+    _publishedSnapshots.push_back(snapshot);
+    std::atomic_store(&_latestSnapshot, IGraphSnapshotPtr(snapshot));
+
+    return snapshot;
+}
+
+IGraphSnapshotPtr SceneGraph::getLatestSnapshot() const
+{
+    return std::atomic_load(&_latestSnapshot);
+}
+
+void SceneGraph::releaseUnusedSnapshots()
+{
+    auto latest = std::atomic_load(&_latestSnapshot);
+
+    // Snapshots other than the latest one can't be acquired anymore, a use count of 1
+    // means the reference in this list is the last one around
+    _publishedSnapshots.erase(std::remove_if(_publishedSnapshots.begin(), _publishedSnapshots.end(),
+        [&](const IGraphSnapshotPtr& snapshot)
+        {
+            return snapshot != latest && snapshot.use_count() == 1;
+        }), _publishedSnapshots.end());
 }
 
 void SceneGraph::foreachNode(const INode::VisitorFunc& functor)
@@ -248,6 +550,9 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
     // changes during traversal so let's call this now. If nothing got changed, this call is very cheap.
     if (_root != nullptr) _root->worldAABB();
 
+    // Bring the space partition up to date, nodes might have changed their bounds since the last query
+    relinkNodesWithChangedBounds();
+
     {
         // Buffer any calls that might happen in between
         util::ScopedBoolLock traversal(_traversalOngoing);
@@ -257,7 +562,10 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
 
         _visitedSPNodes = _skippedSPNodes = 0;
 
-        foreachNodeInVolume_r(*root, volume, functor, visitHidden);
+        foreachNodeInVolume_r(*root, volume, functor, visitHidden, VOLUME_PARTIAL);
+
+        _numVolumeQueries++;
+        _numVisitedSPNodes += _visitedSPNodes;
 
         _visitedSPNodes = _skippedSPNodes = 0;
     }
@@ -266,6 +574,110 @@ void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, const INode::Visi
     flushActionBuffer();
 }
 
+void SceneGraph::foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, const INode::VisitorFunc& functor)
+{
+    // Update the root bounds and the partition before traversal, see foreachNodeInVolume
+    if (_root != nullptr) _root->worldAABB();
+
+    relinkNodesWithChangedBounds();
+
+    {
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        ISPNodePtr root = _spacePartition->getRoot();
+
+        // One bucket for the root members, one for each child subtree
+        std::vector<std::vector<INodePtr>> buckets(root->getChildNodes().size() + 1);
+        std::vector<std::size_t> visitedNodes(buckets.size(), 0);
+        std::vector<std::future<void>> workers;
+
+        collectVisibleMembers(*root, buckets[0]);
+
+        std::size_t childIndex = 0;
+
+        foreachChildIntersection(*root, volume, [&](const ISPNodePtr& child, VolumeIntersectionValue intersection)
+        {
+            auto& bucket = buckets[++childIndex];
+            auto& visited = visitedNodes[childIndex];
+
+            if (intersection != VOLUME_OUTSIDE)
+            {
+                workers.emplace_back(std::async(std::launch::async, [&, child]()
+                {
+                    collectVisibleNodesInVolume_r(*child, volume, bucket, visited);
+                }));
+            }
+
+            return true;
+        });
+
+        // Wait for all workers, this is re-throwing any exceptions
+        for (auto& worker : workers)
+        {
+            worker.get();
+        }
+
+        // The root node itself counts as visited too
+        _numVolumeQueries++;
+        _numVisitedSPNodes += std::accumulate(visitedNodes.begin(), visitedNodes.end(), std::size_t(1));
+
+        // Dispatch the collected nodes on this thread, in traversal order,
+        // until the functor signals to stop
+        bool proceed = true;
+
+        for (auto bucket = buckets.begin(); proceed && bucket != buckets.end(); ++bucket)
+        {
+            for (auto node = bucket->begin(); proceed && node != bucket->end(); ++node)
+            {
+                proceed = functor(*node);
+            }
+        }
+    }
+
+    flushActionBuffer();
+}
+
+void SceneGraph::foreachVisibleNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance)
+{
+    // Evaluate the bounds and bring the space partition up to date, see foreachNodeInVolume
+    if (_root != nullptr) _root->worldAABB();
+
+    relinkNodesWithChangedBounds();
+
+    {
+        // Buffer any calls that might happen in between
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        _spacePartition->foreachNodeAlongRay(ray, [&](const INodePtr& node, double& distance)
+        {
+            if (node->visible())
+            {
+                visitor(node, distance);
+            }
+        }, maxDistance);
+    }
+
+    flushActionBuffer();
+}
+
+void SceneGraph::foreachNodeByBounds(const AABB& bounds, const BoundsVisitor& visitor, bool visitContained)
+{
+    // Evaluate the bounds and bring the space partition up to date, see foreachNodeInVolume
+    if (_root != nullptr) _root->worldAABB();
+
+    relinkNodesWithChangedBounds();
+
+    {
+        // Buffer any calls that might happen in between
+        util::ScopedBoolLock traversal(_traversalOngoing);
+
+        // The root cell is growing up to the map limits only, its members are always tested
+        foreachNodeByBounds_r(*_spacePartition->getRoot(), bounds, visitor, visitContained, VOLUME_PARTIAL);
+    }
+
+    flushActionBuffer();
+}
+
 void SceneGraph::foreachNodeInVolume(const VolumeTest& volume, Walker& walker)
 {
 	// Use a small adaptor lambda to dispatch calls to the walker
@@ -283,58 +695,100 @@ void SceneGraph::foreachVisibleNodeInVolume(const VolumeTest& volume, Walker& wa
 }
 
 bool SceneGraph::foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume,
-									   const INode::VisitorFunc& functor, bool visitHidden)
+									   const INode::VisitorFunc& functor, bool visitHidden,
+									   VolumeIntersectionValue intersection)
 {
 	_visitedSPNodes++;
 
-	// Visit all members
+	// Visit all members. The members are contained in the node bounds, so they
+	// only need to be tested against the volume if the node is partially visible.
 	const ISPNode::MemberList& members = node.getMembers();
 
-	for (ISPNode::MemberList::const_iterator m = members.begin();
-		 m != members.end(); /* in-loop increment */)
+	AABBBatch batch;
+	VolumeIntersectionValue results[AABBBatch::Size];
+
+	for (std::size_t first = 0; first < members.size(); first += AABBBatch::Size)
 	{
-		// Skip hidden nodes, if specified
-		if (!visitHidden && !(*m)->visible())
+		auto count = std::min(AABBBatch::Size, members.size() - first);
+
+		// One bit for each member without valid bounds, these are always visited
+		unsigned invalidBounds = 0;
+
+		if (intersection == VOLUME_PARTIAL)
 		{
-			++m;
-			continue;
+			batch.clear();
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const AABB& bounds = members[first + i]->worldAABB();
+
+				if (!bounds.isValid())
+				{
+					invalidBounds |= 1u << i;
+				}
+
+				batch.add(bounds);
+			}
+
+			volume.TestAABBs(batch, results);
 		}
 
-		// We're done, as soon as the walker returns FALSE
-		if (!functor(*m++))
+		for (std::size_t i = 0; i < count; ++i)
 		{
-			return false;
+			const INodePtr& member = members[first + i];
+
+			// Skip hidden nodes, if specified
+			if (!visitHidden && !member->visible())
+			{
+				continue;
+			}
+
+			if (intersection == VOLUME_PARTIAL && results[i] == VOLUME_OUTSIDE && !(invalidBounds & (1u << i)))
+			{
+				continue;
+			}
+
+			// We're done, as soon as the walker returns FALSE
+			if (!functor(member))
+			{
+				return false;
+			}
 		}
 	}
 
 	// Now consider the children
-	const ISPNode::NodeList& children = node.getChildNodes();
-
-	for (ISPNode::NodeList::const_iterator i = children.begin(); i != children.end(); ++i)
+	return foreachChildIntersection(node, volume, [&](const ISPNodePtr& child, VolumeIntersectionValue childIntersection)
 	{
-		if (volume.TestAABB((*i)->getBounds()) == VOLUME_OUTSIDE)
+		if (childIntersection == VOLUME_OUTSIDE)
 		{
 			// Skip this node, not visible
 			_skippedSPNodes++;
-			continue;
-		}
-
-		// Traverse all the children too, enter recursion
-		if (!foreachNodeInVolume_r(**i, volume, functor, visitHidden))
-		{
-			// The walker returned false somewhere in the recursion depths, propagate this message
-			return false;
+			return true;
 		}
-	}
 
-	return true; // continue traversal
+		// Traverse all the children too, enter recursion. If the walker returned false
+		// somewhere in the recursion depths, this is propagated by returning false
+		return foreachNodeInVolume_r(*child, volume, functor, visitHidden, childIntersection);
+	});
 }
 
 ISpacePartitionSystemPtr SceneGraph::getSpacePartition()
 {
+    relinkNodesWithChangedBounds();
+
 	return _spacePartition;
 }
 
+Graph::SpacePartitionQueryStatistics SceneGraph::getSpacePartitionQueryStatistics() const
+{
+    SpacePartitionQueryStatistics statistics;
+
+    statistics.numQueries = _numVolumeQueries;
+    statistics.numVisitedNodes = _numVisitedSPNodes;
+
+    return statistics;
+}
+
 void SceneGraph::flushActionBuffer()
 {
     // Do any actions now, in the same order they came in
@@ -348,9 +802,6 @@ void SceneGraph::flushActionBuffer()
         case Erase:
             erase(action.second);
             break;
-        case BoundsChange:
-            nodeBoundsChanged(action.second);
-            break;
         };
     }
 
@@ -366,12 +817,46 @@ const std::string& SceneGraphModule::getName() const
 
 const StringSet& SceneGraphModule::getDependencies() const
 {
-	static StringSet _dependencies; // no deps
+	static StringSet _dependencies{ MODULE_XMLREGISTRY, MODULE_MEMORYACCOUNTING };
 	return _dependencies;
 }
 
 void SceneGraphModule::initialiseModule(const IApplicationContext& ctx)
 {
+	GlobalMemoryAccounting().registerReporter(*this);
+}
+
+void SceneGraphModule::shutdownModule()
+{
+	GlobalMemoryAccounting().unregisterReporter(*this);
+}
+
+const std::string& SceneGraphModule::getMemoryReporterName() const
+{
+	static std::string _name("SceneGraph");
+	return _name;
+}
+
+void SceneGraphModule::reportMemoryUsage(memory::IMemoryReport& report)
+{
+	if (!root()) return;
+
+	std::map<INode::Type, std::size_t> nodesByType;
+	std::size_t numNodes = 0;
+
+	root()->foreachNode([&](const INodePtr& node)
+	{
+		++nodesByType[node->getNodeType()];
+		++numNodes;
+		return true;
+	});
+
+	report.addEntry("Nodes", 0, numNodes);
+
+	for (const auto& [type, count] : nodesByType)
+	{
+		report.addEntry(getNodeTypeName(type) + " nodes", 0, count);
+	}
 }
 
 // Static module instances
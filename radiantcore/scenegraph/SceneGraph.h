@@ -2,14 +2,20 @@
 
 #include <map>
 #include <list>
+#include <atomic>
+#include <vector>
+#include <unordered_set>
 #include <sigc++/signal.h>
 #include <sigc++/connection.h>
 
 #include "iscenegraph.h"
 #include "imodule.h"
+#include "imemoryaccounting.h"
 #include "ispacepartition.h"
 #include "imap.h"
 #include "iundo.h"
+#include "VolumeIntersectionValue.h"
+#include "math/AABB.h"
 
 namespace scene
 {
@@ -30,6 +36,11 @@ private:
 
     sigc::signal<void> _sigBoundsChanged;
 
+    // The nesting level of beginBatchUpdate() and the notifications held back meanwhile
+    std::size_t _batchUpdateDepth;
+    bool _sceneChangedPending;
+    bool _boundsChangedPending;
+
 	// The root-element, the scenegraph starts here
     IMapRootNodePtr _root;
 
@@ -39,13 +50,16 @@ private:
 	std::size_t _visitedSPNodes;
 	std::size_t _skippedSPNodes;
 
+	// The figures returned by getSpacePartitionQueryStatistics()
+	std::atomic<std::size_t> _numVolumeQueries;
+	std::atomic<std::size_t> _numVisitedSPNodes;
+
     // During partition traversal all link/unlink calls are buffered and
     // performed later on.
     enum ActionType
     {
         Insert,
         Erase,
-        BoundsChange,
     };
     typedef std::pair<ActionType, scene::INodePtr> NodeAction;
     typedef std::list<NodeAction> BufferedActions;
@@ -53,8 +67,23 @@ private:
 
     bool _traversalOngoing;
 
+    // Nodes waiting to be re-linked in the space partition
+    std::unordered_set<INodePtr> _nodesWithChangedBounds;
+
+    // The region covered by the nodes changing their bounds since the last notifyDamagedBounds()
+    AABB _damagedBounds;
+
     sigc::connection _undoEventHandler;
 
+    // Increased on every change of the node hierarchy
+    std::atomic<std::size_t> _epoch;
+
+    // The most recently published snapshot, accessed through std::atomic_load/store
+    IGraphSnapshotPtr _latestSnapshot;
+
+    // All published snapshots, released once nobody else is holding a reference
+    std::vector<IGraphSnapshotPtr> _publishedSnapshots;
+
 public:
 	SceneGraph();
 
@@ -83,7 +112,11 @@ public:
     void insert(const INodePtr& node) override;
     void erase(const INodePtr& node) override;
 
-    void nodeBoundsChanged(const scene::INodePtr& node) override;
+    void nodeBoundsChanged(const scene::INodePtr& node, const AABB& damagedBounds) override;
+    void notifyDamagedBounds() override;
+
+    void beginBatchUpdate() override;
+    void endBatchUpdate() override;
 
 	// Walker variants
     void foreachNodeInVolume(const VolumeTest& volume, Walker& walker) override;
@@ -94,31 +127,54 @@ public:
     void foreachVisibleNode(const INode::VisitorFunc& functor) override;
     void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
     void foreachVisibleNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
+    void foreachVisibleNodeInVolumeParallel(const VolumeTest& volume, const INode::VisitorFunc& functor) override;
+    void foreachVisibleNodeAlongRay(const Ray& ray, const RayVisitor& visitor, double maxDistance) override;
+    void foreachNodeByBounds(const AABB& bounds, const BoundsVisitor& visitor, bool visitContained) override;
 
     ISpacePartitionSystemPtr getSpacePartition() override;
+    SpacePartitionQueryStatistics getSpacePartitionQueryStatistics() const override;
+
+    std::size_t getEpoch() const override;
+    IGraphSnapshotPtr createSnapshot() override;
+    IGraphSnapshotPtr getLatestSnapshot() const override;
+
 private:
 	void foreachNodeInVolume(const VolumeTest& volume, const INode::VisitorFunc& functor, bool visitHidden);
 
-	// Recursive method used to descend the SpacePartition tree, returns FALSE if the walker signaled stop
+	// Recursive method used to descend the SpacePartition tree, returns FALSE if the walker signaled stop.
+	// The intersection value of the node's bounds decides whether the members need to be tested.
 	bool foreachNodeInVolume_r(const ISPNode& node, const VolumeTest& volume, 
-							   const INode::VisitorFunc& functor, bool visitHidden);
+							   const INode::VisitorFunc& functor, bool visitHidden,
+							   VolumeIntersectionValue intersection);
 
     void flushActionBuffer();
 
+    // Re-links the nodes that changed their bounds since the last call
+    void relinkNodesWithChangedBounds();
+
     void onUndoEvent(IUndoSystem::EventType type, const std::string& operationName);
+
+    // Drops the published snapshots that are not referenced by anyone else
+    void releaseUnusedSnapshots();
 };
 typedef std::shared_ptr<SceneGraph> SceneGraphPtr;
 
 // Type used to register the GlobalSceneGraph in the module registry
 class SceneGraphModule :
 	public SceneGraph,
-	public RegisterableModule
+	public RegisterableModule,
+	public memory::IMemoryReporter
 {
 public:
 	// RegisterableModule implementation
 	const std::string& getName() const;
 	const StringSet& getDependencies() const;
 	void initialiseModule(const IApplicationContext& ctx);
+	void shutdownModule() override;
+
+	// IMemoryReporter implementation, reporting the number of nodes by type
+	const std::string& getMemoryReporterName() const override;
+	void reportMemoryUsage(memory::IMemoryReport& report) override;
 };
 typedef std::shared_ptr<SceneGraphModule> SceneGraphModulePtr;
 
@@ -1,6 +1,7 @@
 #include "SceneGraphFactory.h"
 
 #include "itextstream.h"
+#include "iregistry.h"
 #include "SceneGraph.h"
 
 namespace scene
@@ -19,7 +20,8 @@ const std::string& SceneGraphFactory::getName() const
 
 const StringSet& SceneGraphFactory::getDependencies() const
 {
-	static StringSet _dependencies; // no dependencies
+	// Scene graphs read the space partition type from the registry
+	static StringSet _dependencies{ MODULE_XMLREGISTRY };
 	return _dependencies;
 }
 
@@ -0,0 +1,304 @@
+#include "SceneStatistics.h"
+
+#include <set>
+#include "ientity.h"
+#include "ieclass.h"
+#include "ibrush.h"
+#include "ipatch.h"
+#include "imodel.h"
+#include "modelskin.h"
+#include "iparticlenode.h"
+#include "iparticles.h"
+#include "iparticlestage.h"
+#include "scenelib.h"
+#include "module/StaticModule.h"
+
+namespace scene
+{
+
+namespace
+{
+    // Decrements the counter, the entry is removed when dropping to zero
+    template<typename MapType>
+    void decreaseCount(MapType& map, const typename MapType::key_type& key)
+    {
+        auto found = map.find(key);
+
+        if (found != map.end() && --found->second == 0)
+        {
+            map.erase(found);
+        }
+    }
+}
+
+const ISceneStatistics::EntityClassCounts& SceneStatistics::getEntityClassCounts()
+{
+    processPendingUpdates();
+    return _entityClassCounts;
+}
+
+const ISceneStatistics::MaterialCounts& SceneStatistics::getMaterialCounts()
+{
+    processPendingUpdates();
+    return _materialCounts;
+}
+
+const ISceneStatistics::ModelCounts& SceneStatistics::getModelCounts()
+{
+    processPendingUpdates();
+    return _modelCounts;
+}
+
+const ISceneStatistics::LayerCounts& SceneStatistics::getLayerCounts()
+{
+    processPendingUpdates();
+    return _layerCounts;
+}
+
+void SceneStatistics::queueUpdate(const INodePtr& node)
+{
+    // Nodes which are not known yet are evaluated when they are inserted
+    if (_contributions.count(node.get()) == 0) return;
+
+    _pendingUpdates.emplace(node.get(), node);
+    _sigStatisticsChanged.emit();
+}
+
+sigc::signal<void>& SceneStatistics::signal_statisticsChanged()
+{
+    return _sigStatisticsChanged;
+}
+
+void SceneStatistics::onSceneNodeInsert(const INodePtr& node)
+{
+    auto result = _contributions.emplace(node.get(), EvaluateNode(node));
+
+    if (!result.second)
+    {
+        // Inserted twice without being erased, replace the old figures
+        removeContribution(result.first->second);
+        result.first->second = EvaluateNode(node);
+    }
+
+    addContribution(result.first->second);
+    _sigStatisticsChanged.emit();
+}
+
+void SceneStatistics::onSceneNodeErase(const INodePtr& node)
+{
+    _pendingUpdates.erase(node.get());
+
+    auto found = _contributions.find(node.get());
+
+    if (found == _contributions.end()) return;
+
+    removeContribution(found->second);
+    _contributions.erase(found);
+
+    _sigStatisticsChanged.emit();
+}
+
+void SceneStatistics::processPendingUpdates()
+{
+    if (_pendingUpdates.empty()) return;
+
+    auto pendingUpdates = std::move(_pendingUpdates);
+    _pendingUpdates.clear();
+
+    for (const auto& [rawNode, weakNode] : pendingUpdates)
+    {
+        auto node = weakNode.lock();
+        auto found = _contributions.find(rawNode);
+
+        if (!node || found == _contributions.end()) continue;
+
+        removeContribution(found->second);
+        found->second = EvaluateNode(node);
+        addContribution(found->second);
+    }
+}
+
+SceneStatistics::NodeContribution SceneStatistics::EvaluateNode(const INodePtr& node)
+{
+    NodeContribution contribution;
+
+    if (auto entity = Node_getEntity(node); entity != nullptr)
+    {
+        contribution.entityClass = entity->getEntityClass()->getDeclName();
+    }
+
+    if (Node_isPatch(node))
+    {
+        contribution.materials.emplace_back(Node_getIPatch(node)->getShader(), Patch);
+    }
+    else if (Node_isBrush(node))
+    {
+        auto brush = Node_getIBrush(node);
+
+        for (std::size_t i = 0; i < brush->getNumFaces(); ++i)
+        {
+            contribution.materials.emplace_back(brush->getFace(i).getShader(), Face);
+        }
+    }
+    else if (auto particleNode = std::dynamic_pointer_cast<particles::IParticleNode>(node); particleNode)
+    {
+        auto particleDef = particleNode->getParticle()->getParticleDef();
+
+        if (particleDef)
+        {
+            std::set<std::string> usedMaterials;
+
+            for (std::size_t i = 0; i < particleDef->getNumStages(); ++i)
+            {
+                usedMaterials.insert(particleDef->getStage(i)->getMaterialName());
+            }
+
+            for (const auto& material : usedMaterials)
+            {
+                contribution.materials.emplace_back(material, Particle);
+            }
+        }
+    }
+    else if (auto modelNode = Node_getModel(node); modelNode)
+    {
+        const auto& activeMaterials = modelNode->getIModel().getActiveMaterials();
+        std::set<std::string> usedMaterials(activeMaterials.begin(), activeMaterials.end());
+
+        for (const auto& material : usedMaterials)
+        {
+            contribution.materials.emplace_back(material, Model);
+        }
+    }
+
+    if (auto modelNode = Node_getModel(node); modelNode)
+    {
+        const auto& model = modelNode->getIModel();
+
+        contribution.modelPath = model.getModelPath();
+        contribution.modelPolyCount = model.getPolyCount();
+
+        if (auto skinned = std::dynamic_pointer_cast<SkinnedModel>(node); skinned)
+        {
+            contribution.isSkinned = true;
+            contribution.skin = skinned->getSkin();
+        }
+    }
+
+    if (Node_isPrimitive(node) || Node_isEntity(node))
+    {
+        contribution.layers = node->getLayers();
+    }
+
+    return contribution;
+}
+
+void SceneStatistics::addContribution(const NodeContribution& contribution)
+{
+    if (!contribution.entityClass.empty())
+    {
+        _entityClassCounts[contribution.entityClass]++;
+    }
+
+    for (const auto& [material, owner] : contribution.materials)
+    {
+        _materialCounts[material][owner]++;
+    }
+
+    if (!contribution.modelPath.empty())
+    {
+        auto result = _modelCounts.emplace(contribution.modelPath, ModelUsage());
+
+        // The polycount of the first occurrence is reported
+        if (result.second)
+        {
+            result.first->second.polyCount = contribution.modelPolyCount;
+        }
+
+        result.first->second.count++;
+
+        if (contribution.isSkinned)
+        {
+            result.first->second.skinCount[contribution.skin]++;
+        }
+    }
+
+    for (int layerId : contribution.layers)
+    {
+        _layerCounts[layerId]++;
+    }
+}
+
+void SceneStatistics::removeContribution(const NodeContribution& contribution)
+{
+    if (!contribution.entityClass.empty())
+    {
+        decreaseCount(_entityClassCounts, contribution.entityClass);
+    }
+
+    for (const auto& [material, owner] : contribution.materials)
+    {
+        auto found = _materialCounts.find(material);
+
+        if (found == _materialCounts.end()) continue;
+
+        auto& counts = found->second;
+        counts[owner]--;
+
+        if (counts[Face] == 0 && counts[Patch] == 0 && counts[Model] == 0 && counts[Particle] == 0)
+        {
+            _materialCounts.erase(found);
+        }
+    }
+
+    if (!contribution.modelPath.empty())
+    {
+        auto found = _modelCounts.find(contribution.modelPath);
+
+        if (found != _modelCounts.end())
+        {
+            if (contribution.isSkinned)
+            {
+                decreaseCount(found->second.skinCount, contribution.skin);
+            }
+
+            if (--found->second.count == 0)
+            {
+                _modelCounts.erase(found);
+            }
+        }
+    }
+
+    for (int layerId : contribution.layers)
+    {
+        decreaseCount(_layerCounts, layerId);
+    }
+}
+
+const std::string& SceneStatistics::getName() const
+{
+    static std::string _name(MODULE_SCENESTATISTICS);
+    return _name;
+}
+
+const StringSet& SceneStatistics::getDependencies() const
+{
+    static StringSet _dependencies{ MODULE_SCENEGRAPH };
+    return _dependencies;
+}
+
+void SceneStatistics::initialiseModule(const IApplicationContext& ctx)
+{
+    GlobalSceneGraph().addSceneObserver(this);
+}
+
+void SceneStatistics::shutdownModule()
+{
+    GlobalSceneGraph().removeSceneObserver(this);
+
+    _pendingUpdates.clear();
+    _contributions.clear();
+}
+
+module::StaticModuleRegistration<SceneStatistics> sceneStatisticsModule;
+
+}
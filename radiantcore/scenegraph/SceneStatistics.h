@@ -0,0 +1,75 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include "iscenestatistics.h"
+#include "iscenegraph.h"
+
+namespace scene
+{
+
+class SceneStatistics final :
+    public ISceneStatistics,
+    public Graph::Observer
+{
+private:
+    // What a single node is adding to the figures
+    struct NodeContribution
+    {
+        // Empty if the node is not an entity
+        std::string entityClass;
+
+        std::vector<std::pair<std::string, MaterialOwner>> materials;
+
+        // Empty if the node is not a model
+        std::string modelPath;
+        std::size_t modelPolyCount = 0;
+        bool isSkinned = false;
+        std::string skin;
+
+        // Only entities and primitives are counted in the layer figures
+        LayerList layers;
+    };
+
+    std::unordered_map<const INode*, NodeContribution> _contributions;
+
+    // Nodes in the scene which need to be evaluated again
+    std::unordered_map<const INode*, INodeWeakPtr> _pendingUpdates;
+
+    EntityClassCounts _entityClassCounts;
+    MaterialCounts _materialCounts;
+    ModelCounts _modelCounts;
+    LayerCounts _layerCounts;
+
+    sigc::signal<void> _sigStatisticsChanged;
+
+public:
+    const EntityClassCounts& getEntityClassCounts() override;
+    const MaterialCounts& getMaterialCounts() override;
+    const ModelCounts& getModelCounts() override;
+    const LayerCounts& getLayerCounts() override;
+
+    void queueUpdate(const INodePtr& node) override;
+
+    sigc::signal<void>& signal_statisticsChanged() override;
+
+    // Graph::Observer implementation
+    void onSceneNodeInsert(const INodePtr& node) override;
+    void onSceneNodeErase(const INodePtr& node) override;
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    void processPendingUpdates();
+
+    static NodeContribution EvaluateNode(const INodePtr& node);
+
+    void addContribution(const NodeContribution& contribution);
+    void removeContribution(const NodeContribution& contribution);
+};
+
+}
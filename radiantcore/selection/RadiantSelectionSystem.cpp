@@ -4,14 +4,18 @@
 #include "iundo.h"
 #include "igrid.h"
 #include "iselectiongroup.h"
+#include "ilightnode.h"
 #include "iradiant.h"
 #include "ipreferencesystem.h"
+#include "itaskscheduler.h"
 #include "selection/SelectionPool.h"
 #include "module/StaticModule.h"
 #include "brush/csg/CSG.h"
+#include "brush/BRepEvaluation.h"
 #include "selection/algorithm/General.h"
 #include "selection/algorithm/Primitives.h"
 #include "selection/algorithm/Transformation.h"
+#include "selection/clipboard/Clipboard.h"
 #include "SceneWalkers.h"
 #include "SelectionTestWalkers.h"
 #include "command/ExecutionFailure.h"
@@ -43,6 +47,7 @@ RadiantSelectionSystem::RadiantSelectionSystem() :
     _componentMode(ComponentSelectionMode::Default),
     _countPrimitive(0),
     _countComponent(0),
+    _selectionBoundsValid(false),
     _selectionFocusActive(false)
 {}
 
@@ -393,6 +398,11 @@ void RadiantSelectionSystem::onSelectedChanged(const scene::INodePtr& node, cons
 	{
         _selection.append(node);
 
+        if (_selectionBoundsValid)
+        {
+            _nodesPendingForSelectionBounds.push_back(node);
+        }
+
         // Any selectable that is not in the pool yet will be added
         // otherwise creating new nodes is making them unselectable
         if (_selectionFocusActive)
@@ -403,6 +413,10 @@ void RadiantSelectionSystem::onSelectedChanged(const scene::INodePtr& node, cons
     else
 	{
         _selection.erase(node);
+
+        // The remaining bounds can't be derived from the current ones
+        _selectionBoundsValid = false;
+        _nodesPendingForSelectionBounds.clear();
     }
 
 	// greebo: Moved this here, the selectionInfo structure should be up to date before calling this
@@ -804,17 +818,36 @@ void RadiantSelectionSystem::onManipulationStart()
 	_pivot.beginOperation();
 }
 
+void RadiantSelectionSystem::evaluateSelectedBrushes()
+{
+    std::vector<scene::INodePtr> selectedNodes;
+    selectedNodes.reserve(getSelectionInfo().totalCount);
+
+    foreachSelected([&](const scene::INodePtr& node)
+    {
+        selectedNodes.push_back(node);
+    });
+
+    brush::evaluateBRepsInSubgraphs(selectedNodes);
+}
+
 void RadiantSelectionSystem::onManipulationChanged()
 {
 	_requestWorkZoneRecalculation = true;
 
-	GlobalSceneGraph().sceneChanged();
+    evaluateSelectedBrushes();
+
+	// Only the geometry of the manipulated nodes changed, views not
+	// showing the damaged region don't need to be redrawn
+	GlobalSceneGraph().notifyDamagedBounds();
 }
 
 void RadiantSelectionSystem::onManipulationEnd()
 {
     GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
 
+    evaluateSelectedBrushes();
+
     _pivot.endOperation();
 
 	// The selection bounds have possibly changed
@@ -957,12 +990,56 @@ void RadiantSelectionSystem::onPreRender(const VolumeTest& volume)
 
 void RadiantSelectionSystem::onSceneBoundsChanged()
 {
-    // The bounds of the scenegraph have (possibly) changed
-    pivotChanged();
+    // The bounds of the scenegraph have (possibly) changed. The views are picking
+    // up the damaged bounds themselves, don't trigger a redraw of every view here.
+    _pivot.setNeedsRecalculation(true);
+
+    _selectionBoundsValid = false;
+    _nodesPendingForSelectionBounds.clear();
 
     _requestWorkZoneRecalculation = true;
 }
 
+AABB RadiantSelectionSystem::getSelectionBounds(bool considerLightVolumes)
+{
+    if (!_selectionBoundsValid)
+    {
+        _selectionBounds = AABB();
+        _selectionBoundsWithoutLightVolumes = AABB();
+        _nodesPendingForSelectionBounds.clear();
+
+        for (const auto& [node, _] : _selection)
+        {
+            includeInSelectionBounds(node);
+        }
+
+        _selectionBoundsValid = true;
+    }
+    else
+    {
+        for (const auto& node : _nodesPendingForSelectionBounds)
+        {
+            includeInSelectionBounds(node);
+        }
+
+        _nodesPendingForSelectionBounds.clear();
+    }
+
+    return considerLightVolumes ? _selectionBounds : _selectionBoundsWithoutLightVolumes;
+}
+
+void RadiantSelectionSystem::includeInSelectionBounds(const scene::INodePtr& node)
+{
+    const AABB& bounds = node->worldAABB();
+
+    _selectionBounds.includeAABB(bounds);
+
+    // Lights only contribute the small diamond AABB if light volumes are ignored (#4578)
+    auto lightNode = Node_getLightNode(node);
+
+    _selectionBoundsWithoutLightVolumes.includeAABB(lightNode ? lightNode->getSelectAABB() : bounds);
+}
+
 const std::string& RadiantSelectionSystem::getName() const
 {
     static std::string _name(MODULE_SELECTIONSYSTEM);
@@ -982,6 +1059,7 @@ const StringSet& RadiantSelectionSystem::getDependencies() const
 		_dependencies.insert(MODULE_MAP);
 		_dependencies.insert(MODULE_PREFERENCESYSTEM);
 		_dependencies.insert(MODULE_OPENGL);
+		_dependencies.insert(MODULE_TASKSCHEDULER);
     }
 
     return _dependencies;
@@ -1056,6 +1134,9 @@ void RadiantSelectionSystem::shutdownModule()
 {
     _selectionFocusPool.clear();
 
+    // The copied nodes are holding references to the entity classes and materials
+    selection::clipboard::clearCopiedNodes();
+
     // greebo: Unselect everything so that no references to scene::Nodes
     // are kept after shutdown, causing destruction issues.
     setSelectedAll(false);
@@ -1081,6 +1162,9 @@ void RadiantSelectionSystem::shutdownModule()
     // Clear the list of anything which remains.
 	_selection.clear();
 
+    _selectionBoundsValid = false;
+    _nodesPendingForSelectionBounds.clear();
+
 	_activeManipulator.reset();
 	_manipulators.clear();
 
@@ -58,6 +58,14 @@ private:
     SelectedNodeList _selection;
     SelectedNodeList _componentSelection;
 
+    // The combined bounds of the selected nodes, with and without light volumes.
+    // Newly selected nodes are queued up and added on the next request,
+    // deselections and scene bounds changes invalidate the bounds.
+    AABB _selectionBounds;
+    AABB _selectionBoundsWithoutLightVolumes;
+    bool _selectionBoundsValid;
+    std::vector<scene::INodePtr> _nodesPendingForSelectionBounds;
+
 	// The coordinates of the mouse pointer when the manipulation starts
 	Vector2 _deviceStart;
 
@@ -165,6 +173,7 @@ public:
     void toggleSelectionFocus() override;
     bool selectionFocusIsActive() override;
     AABB getSelectionFocusBounds() override;
+    AABB getSelectionBounds(bool considerLightVolumes) override;
 
 	// RegisterableModule implementation
 	const std::string& getName() const override;
@@ -177,6 +186,13 @@ public:
 private:
     bool nodeCanBeSelectionTested(const scene::INodePtr& node);
 
+    // Adds the node to the combined selection bounds
+    void includeInSelectionBounds(const scene::INodePtr& node);
+
+    // Builds the windings of the transformed brushes in one batch, instead of
+    // having them evaluated one by one when their bounds are requested
+    void evaluateSelectedBrushes();
+
     // Sets the selection status of the given selectable. The selection status will
     // be propagated to groups if the current selection mode / focus is allowing that
     void setSelectionStatus(ISelectable* selectable, bool selected);
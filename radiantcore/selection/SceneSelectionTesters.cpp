@@ -1,6 +1,12 @@
 #include "SceneSelectionTesters.h"
 
+#include <algorithm>
+#include <future>
+#include <limits>
+#include <thread>
+#include "ibrush.h"
 #include "iscenegraph.h"
+#include "registry/registry.h"
 #include "SelectionTestWalkers.h"
 #include "selection/EntitiesFirstSelector.h"
 #include "selection/SelectionPool.h"
@@ -8,6 +14,115 @@
 namespace selection
 {
 
+namespace
+{
+
+// Parallel testing is only worth the overhead above this number of brushes
+constexpr std::size_t MinBrushesForParallelTesting = 256;
+
+// The minimum number of brushes to be tested by a single thread
+constexpr std::size_t MinBrushesPerThread = 64;
+
+/**
+ * Selector recording the calls made by the tested nodes,
+ * to pass them on to a different selector later on.
+ */
+class SelectionRecorder :
+    public Selector
+{
+private:
+    struct Event
+    {
+        // Either the pushed selectable or nullptr for addIntersection() and popSelectable()
+        ISelectable* selectable;
+        SelectionIntersection intersection;
+        bool isPop;
+    };
+
+    std::vector<Event> _events;
+
+public:
+    void pushSelectable(ISelectable& selectable) override
+    {
+        _events.push_back({ &selectable, SelectionIntersection(), false });
+    }
+
+    void popSelectable() override
+    {
+        _events.push_back({ nullptr, SelectionIntersection(), true });
+    }
+
+    void addIntersection(const SelectionIntersection& intersection) override
+    {
+        // Subsequent intersections can be merged, the selector is keeping the closest one
+        if (!_events.empty() && !_events.back().selectable && !_events.back().isPop)
+        {
+            _events.back().intersection.assignIfCloser(intersection);
+            return;
+        }
+
+        _events.push_back({ nullptr, intersection, false });
+    }
+
+    bool empty() const override
+    {
+        return _events.empty();
+    }
+
+    void foreachSelectable(const std::function<void(ISelectable*)>& functor) override
+    {
+        for (const auto& event : _events)
+        {
+            if (event.selectable)
+            {
+                functor(event.selectable);
+            }
+        }
+    }
+
+    std::size_t size() const
+    {
+        return _events.size();
+    }
+
+    // Repeats the recorded calls in the range [first, end) on the given selector
+    void replay(Selector& selector, std::size_t first, std::size_t end) const
+    {
+        for (auto i = first; i < end; ++i)
+        {
+            const auto& event = _events[i];
+
+            if (event.selectable)
+            {
+                selector.pushSelectable(*event.selectable);
+            }
+            else if (event.isPop)
+            {
+                selector.popSelectable();
+            }
+            else
+            {
+                selector.addIntersection(event.intersection);
+            }
+        }
+    }
+};
+
+// A node to be tested, either on this thread or by one of the workers
+struct Candidate
+{
+    static constexpr std::size_t NotRecorded = std::numeric_limits<std::size_t>::max();
+
+    scene::INodePtr node;
+
+    // The recorder holding the results of this node, with the range of its events
+    std::size_t recorder = NotRecorded;
+    std::size_t firstEvent = 0;
+    std::size_t endEvent = 0;
+};
+
+}
+
 SelectionTesterBase::SelectionTesterBase(const NodePredicate& nodePredicate) :
     _nodePredicate(nodePredicate)
 {}
@@ -44,6 +159,108 @@ void SelectionTesterBase::testSelectScene(const VolumeTest& view, SelectionTest&
     testSelectSceneWithFilter(view, test, [](ISelectable*) { return true; });
 }
 
+void SelectionTesterBase::testVisibleNodes(const VolumeTest& view, SelectionTest& test, Selector& selector,
+    const WalkerFactory& createWalker)
+{
+    auto walker = createWalker(selector, test);
+
+    if (!registry::getValue<bool>(RKEY_ENABLE_PARALLEL_SELECTION_TEST))
+    {
+        GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+        {
+            testNode(node, *walker);
+            return true;
+        });
+        return;
+    }
+
+    // Collect the candidates in traversal order, remembering the brushes.
+    // Brushes don't change any state when being tested, other nodes like patches
+    // might update their tesselation, so these are kept on this thread.
+    std::vector<Candidate> candidates;
+    std::vector<std::size_t> brushes;
+
+    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    {
+        if (!nodeIsEligible(node)) return true;
+
+        if (Node_isBrush(node))
+        {
+            brushes.push_back(candidates.size());
+        }
+
+        candidates.push_back(Candidate{ node });
+        return true;
+    });
+
+    auto numThreads = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u),
+        brushes.size() / MinBrushesPerThread);
+
+    // Every thread needs its own copy of the test, since it is storing the current mesh transform
+    std::vector<std::shared_ptr<SelectionTest>> threadTests;
+
+    if (brushes.size() >= MinBrushesForParallelTesting && numThreads > 1)
+    {
+        for (std::size_t i = 0; i < numThreads; ++i)
+        {
+            auto threadTest = test.clone();
+
+            if (!threadTest)
+            {
+                threadTests.clear();
+                break;
+            }
+
+            threadTests.push_back(threadTest);
+        }
+    }
+
+    // Split the brushes into contiguous ranges, one for each thread
+    std::vector<SelectionRecorder> recorders(threadTests.size());
+    std::vector<std::future<void>> workers;
+
+    auto brushesPerThread = threadTests.empty() ? 0 : (brushes.size() + threadTests.size() - 1) / threadTests.size();
+
+    for (std::size_t t = 0; t < threadTests.size(); ++t)
+    {
+        workers.emplace_back(std::async(std::launch::async, [&, t]()
+        {
+            auto threadWalker = createWalker(recorders[t], *threadTests[t]);
+            auto end = std::min(brushes.size(), (t + 1) * brushesPerThread);
+
+            for (auto i = t * brushesPerThread; i < end; ++i)
+            {
+                auto& candidate = candidates[brushes[i]];
+
+                candidate.recorder = t;
+                candidate.firstEvent = recorders[t].size();
+                threadWalker->testNode(candidate.node);
+                candidate.endEvent = recorders[t].size();
+            }
+        }));
+    }
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    // Feed the results to the selector in traversal order, the selector
+    // receives exactly the same calls as in the serial case
+    for (const auto& candidate : candidates)
+    {
+        if (candidate.recorder == Candidate::NotRecorded)
+        {
+            walker->testNode(candidate.node);
+        }
+        else
+        {
+            recorders[candidate.recorder].replay(selector, candidate.firstEvent, candidate.endEvent);
+        }
+    }
+}
+
 void SelectionTesterBase::storeSelectable(ISelectable* selectable)
 {
     _selectables.push_back(selectable);
@@ -75,11 +292,9 @@ void PrimitiveSelectionTester::testSelectSceneWithFilter(const VolumeTest& view,
     auto& targetPool = !view.fill() && higherEntitySelectionPriority() ?
         static_cast<Selector&>(sortedPool) : simplePool;
 
-    AnySelector anyTester(targetPool, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    testVisibleNodes(view, test, targetPool, [](Selector& selector, SelectionTest& test)
     {
-        testNode(node, anyTester);
-        return true;
+        return std::make_unique<AnySelector>(selector, test);
     });
 
     storeSelectablesInPool(targetPool, predicate);
@@ -99,11 +314,9 @@ void EntitySelectionTester::testSelectSceneWithFilter(const VolumeTest& view, Se
 {
     SelectionPool selector;
 
-    EntitySelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    testVisibleNodes(view, test, selector, [](Selector& selector, SelectionTest& test)
     {
-        testNode(node, tester);
-        return true;
+        return std::make_unique<EntitySelector>(selector, test);
     });
 
     storeSelectablesInPool(selector, predicate);
@@ -118,11 +331,9 @@ void GroupChildPrimitiveSelectionTester::testSelectSceneWithFilter(const VolumeT
 {
     SelectionPool selector;
 
-    GroupChildPrimitiveSelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    testVisibleNodes(view, test, selector, [](Selector& selector, SelectionTest& test)
     {
-        testNode(node, tester);
-        return true;
+        return std::make_unique<GroupChildPrimitiveSelector>(selector, test);
     });
 
     storeSelectablesInPool(selector, predicate);
@@ -137,11 +348,9 @@ void MergeActionSelectionTester::testSelectSceneWithFilter(const VolumeTest& vie
 {
     SelectionPool selector;
 
-    MergeActionSelector tester(selector, test);
-    GlobalSceneGraph().foreachVisibleNodeInVolume(view, [&](const scene::INodePtr& node)
+    testVisibleNodes(view, test, selector, [](Selector& selector, SelectionTest& test)
     {
-        testNode(node, tester);
-        return true;
+        return std::make_unique<MergeActionSelector>(selector, test);
     });
 
     storeSelectablesInPool(selector, predicate);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <vector>
 #include "iselectiontest.h"
 
@@ -36,6 +38,16 @@ protected:
 
     bool nodeIsEligible(const scene::INodePtr& node) const;
 
+    // Creates a walker of the type required by the subclass, using the given selector and test
+    using WalkerFactory = std::function<std::unique_ptr<SelectionTestWalker>(Selector&, SelectionTest&)>;
+
+    // Tests all visible and eligible nodes in the given view, feeding the results to the selector.
+    // If parallel testing is enabled, brushes are tested on multiple threads, and the results
+    // are passed to the selector in traversal order, such that it ends up in the same state
+    // as if all nodes had been tested on the calling thread.
+    void testVisibleNodes(const VolumeTest& view, SelectionTest& test, Selector& selector,
+        const WalkerFactory& createWalker);
+
     void storeSelectablesInPool(Selector& selector, const std::function<bool(ISelectable*)>& predicate);
     void storeSelectable(ISelectable* selectable);
 };
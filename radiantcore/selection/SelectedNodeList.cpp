@@ -1,39 +1,13 @@
 #include "SelectedNodeList.h"
 
-const scene::INodePtr& SelectedNodeList::ultimate() {
-	if (size() == 0) {
-		return end()->first; // return invalid iterator
-	}
-
-	std::size_t latestTime(0);
-	iterator latest;
-
-	for (iterator i = begin(); i != end(); i++) {
-		if (i->second > latestTime) {
-			latestTime = i->second;
-			latest = i;
-		}
-	}
-
-	return latest->first;
-}
+#include <iterator>
 
 const scene::INodePtr& SelectedNodeList::ultimate() const {
 	if (size() == 0) {
 		return end()->first; // return invalid iterator
 	}
 
-	std::size_t latestTime(0);
-	const_iterator latest;
-
-	for (const_iterator i = begin(); i != end(); i++) {
-		if (i->second > latestTime) {
-			latestTime = i->second;
-			latest = i;
-		}
-	}
-
-	return latest->first;
+	return _insertionOrder.rbegin()->second->first;
 }
 
 const scene::INodePtr& SelectedNodeList::penultimate() const {
@@ -41,62 +15,17 @@ const scene::INodePtr& SelectedNodeList::penultimate() const {
 		return end()->first; // return invalid iterator
 	}
 
-	std::size_t ultimateTime(0);
-	std::size_t penUltimateTime(0);
-	const_iterator ultimate;
-	const_iterator penUltimate;
-
-	for (const_iterator i = begin(); i != end(); i++) {
-		if (i->second > ultimateTime) {
-			penUltimateTime = ultimateTime;
-			penUltimate = ultimate;
-
-			ultimateTime = i->second;
-			ultimate = i;
-		}
-		else if (i->second > penUltimateTime) {
-			penUltimateTime = i->second;
-			penUltimate = i;
-		}
-	}
-
-	return penUltimate->first;
-}
-
-const scene::INodePtr& SelectedNodeList::penultimate() {
-	if (size() <= 1) {
-		return end()->first; // return invalid iterator
-	}
-
-	std::size_t ultimateTime(0);
-	std::size_t penUltimateTime(0);
-	iterator ultimate;
-	iterator penUltimate;
-
-	for (iterator i = begin(); i != end(); i++) {
-		if (i->second > ultimateTime) {
-			penUltimateTime = ultimateTime;
-			penUltimate = ultimate;
-
-			ultimateTime = i->second;
-			ultimate = i;
-		}
-		else if (i->second > penUltimateTime) {
-			penUltimateTime = i->second;
-			penUltimate = i;
-		}
-	}
-
-	return penUltimate->first;
+	return std::next(_insertionOrder.rbegin())->second->first;
 }
 
 void SelectedNodeList::append(const scene::INodePtr& selected) {
 	time++;
-	MapType::insert(value_type(selected, time));
+	iterator inserted = MapType::insert(value_type(selected, time));
+	_insertionOrder.emplace(time, inserted);
 }
 
 void SelectedNodeList::erase(const scene::INodePtr& selected) {
-	iterator last;
+	iterator last = end();
 	std::size_t lastTime(0);
 
 	// Lookup the instance selected last
@@ -113,7 +42,13 @@ void SelectedNodeList::erase(const scene::INodePtr& selected) {
 	assert(last != end());
 
 	// Remove the element selected last, leave the others
+	_insertionOrder.erase(lastTime);
 	MapType::erase(last);
 }
 
+void SelectedNodeList::clear() {
+	_insertionOrder.clear();
+	MapType::clear();
+}
+
 std::size_t SelectedNodeList::time = 1;
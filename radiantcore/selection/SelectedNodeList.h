@@ -18,7 +18,8 @@
  * allows for fast lookup of arbitrary nodes.
  *
  * Also, the map interface is extended by the penultimate() accessor
- * which is needed by the RadiantSelectionSystem.
+ * which is needed by the RadiantSelectionSystem. A second map sorted
+ * by insertion time keeps these accessors from scanning the whole list.
  */
 class SelectedNodeList :
 	public std::multimap<scene::INodePtr, std::size_t>
@@ -28,22 +29,20 @@ class SelectedNodeList :
 
 	// This is an ever-incrementing counter, some sort of "insertion time"
 	static std::size_t time;
+
+	// The elements of the base map, by insertion time
+	std::map<std::size_t, MapType::iterator> _insertionOrder;
+
 public:
 	/**
 	 * greebo: Returns the element which has been inserted last.
-	 *
-	 * Note: Runs in linear time = SLOW
 	 */
-	const scene::INodePtr& ultimate();
 	const scene::INodePtr& ultimate() const;
 
 	/**
 	 * greebo: Returns the element right before the last selected.
-	 *
-	 * Note: Runs in linear time = SLOW
 	 */
 	const scene::INodePtr& penultimate() const;
-	const scene::INodePtr& penultimate();
 
 	/**
 	 * greebo: Inserts a new element to this container.
@@ -59,6 +58,9 @@ public:
 	 * highest time is removed, the others are left.
 	 */
 	void erase(const scene::INodePtr& selected);
+
+	// Removes all elements
+	void clear();
 };
 
 #endif /*SELECTEDNODELIST_H_*/
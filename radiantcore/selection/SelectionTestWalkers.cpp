@@ -174,10 +174,24 @@ void ComponentSelector::performComponentselectionTest(const scene::INodePtr& nod
 {
 	ComponentSelectionTestablePtr testable = Node_getComponentSelectionTestable(node);
 
-	if (testable)
+	if (!testable)
 	{
-		testable->testSelectComponents(_selector, _test, _mode);
+		return;
 	}
+
+	// The components of brushes and patches are located within their bounds,
+	// primitives outside the selection volume don't need their components tested
+	if (Node_isPrimitive(node))
+	{
+		const AABB& bounds = node->worldAABB();
+
+		if (bounds.isValid() && _test.getVolume().TestAABB(bounds) == VOLUME_OUTSIDE)
+		{
+			return;
+		}
+	}
+
+	testable->testSelectComponents(_selector, _test, _mode);
 }
 
 MergeActionSelector::MergeActionSelector(Selector& selector, SelectionTest& test) :
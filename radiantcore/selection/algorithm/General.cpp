@@ -662,31 +662,8 @@ AABB getCurrentComponentSelectionBounds()
 // This is the same as for selection
 AABB getCurrentSelectionBounds(bool considerLightVolumes)
 {
-	AABB bounds;
-
-	GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
-	{
-		if (considerLightVolumes)
-		{
-			bounds.includeAABB(node->worldAABB());
-			return;
-		}
-
-		// We were asked to ignore light volumes, so for lights we'll only
-		// sum up the small diamond AABB to calculate the selection bounds (#4578)
-		ILightNodePtr lightNode = Node_getLightNode(node);
-
-		if (lightNode)
-		{
-			bounds.includeAABB(lightNode->getSelectAABB());
-		}
-		else
-		{
-			bounds.includeAABB(node->worldAABB());
-		}
-	});
-
-	return bounds;
+	// The selection system keeps the bounds up to date incrementally
+	return GlobalSelectionSystem().getSelectionBounds(considerLightVolumes);
 }
 
 AABB getCurrentSelectionBounds()
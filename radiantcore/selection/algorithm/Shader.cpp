@@ -32,6 +32,25 @@ namespace selection
 namespace algorithm
 {
 
+namespace
+{
+
+// Returns the faces the texture commands are applied to, i.e. the selected
+// faces as well as the ones of selected brushes
+FacePtrVector getFacesOfSelection()
+{
+	FacePtrVector faces;
+
+	GlobalSelectionSystem().foreachFace([&](IFace& face)
+	{
+		faces.push_back(static_cast<Face*>(&face));
+	});
+
+	return faces;
+}
+
+}
+
 void applyShaderToSelectionCmd(const cmd::ArgumentList& args)
 {
 	if (args.size() != 1 || args[0].getString().empty())
@@ -436,10 +455,12 @@ void fitTexture(const double repeatS, const double repeatT)
 {
 	UndoableCommand command("fitTexture");
 
-	GlobalSelectionSystem().foreachFace([&] (IFace& face) 
-    { 
-        face.fitTexture(static_cast<float>(repeatS), static_cast<float>(repeatT));
-    });
+	transformFaceProjections(getFacesOfSelection(), [&](const Face& face,
+		std::size_t width, std::size_t height, TextureProjection& projection)
+	{
+		projection.fitTexture(width, height, face.getPlane3().normal(), face.getWinding(),
+			static_cast<float>(repeatS), static_cast<float>(repeatT));
+	});
 	GlobalSelectionSystem().foreachPatch([&] (IPatch& patch)
     { 
         patch.fitTexture(static_cast<float>(repeatS), static_cast<float>(repeatT));
@@ -513,10 +534,12 @@ void shiftTexture(const Vector2& shift)
 
 	UndoableCommand undo(command);
 
-	GlobalSelectionSystem().foreachFace([&] (IFace& face) 
-    { 
-        face.shiftTexdefByPixels(static_cast<float>(shift[0]), static_cast<float>(shift[1]));
-    });
+	// Scale down the s,t translation using the texture dimensions of each face
+	transformFaceProjections(getFacesOfSelection(), [&](const Face& face,
+		std::size_t width, std::size_t height, TextureProjection& projection)
+	{
+		projection.shift(static_cast<float>(shift[0]) / width, static_cast<float>(shift[1]) / height);
+	});
 	GlobalSelectionSystem().foreachPatch([&] (IPatch& patch)
     { 
         patch.translateTexture(static_cast<float>(shift[0]), static_cast<float>(shift[1]));
@@ -537,8 +560,15 @@ void scaleTexture(const Vector2& scale)
 	// Prepare the 1.0-based scale value (incoming values are relative to 0)
 	Vector2 patchScale = scale + Vector2(1, 1);
 
-    // Flip every node about its own center point
-    GlobalSelectionSystem().foreachFace([&](IFace& face) { TextureScaler::ScaleFace(face, patchScale); });
+    // Scale every node about its own center point
+    transformFaceProjections(getFacesOfSelection(), [&](const Face& face,
+        std::size_t, std::size_t, TextureProjection& projection)
+    {
+        auto bounds = getFaceTexcoordBounds(face);
+        TextureScaler scaler({ bounds.origin.x(), bounds.origin.y() }, patchScale);
+
+        transformFaceTexcoords(face, scaler.getTransform(), projection);
+    });
     GlobalSelectionSystem().foreachPatch([&](IPatch& patch) { TextureScaler::ScalePatch(patch, patchScale); });
 }
 
@@ -549,7 +579,15 @@ void rotateTexture(const float angle)
 
 	UndoableCommand undo(command);
 
-	GlobalSelectionSystem().foreachFace([&] (IFace& face) { face.rotateTexdef(angle); });
+	transformFaceProjections(getFacesOfSelection(), [&](const Face& face,
+		std::size_t width, std::size_t height, TextureProjection& projection)
+	{
+		auto bounds = getFaceTexcoordBounds(face);
+		auto aspect = static_cast<float>(width) / height;
+		TextureRotator rotator({ bounds.origin.x(), bounds.origin.y() }, degrees_to_radians(angle), aspect);
+
+		transformFaceTexcoords(face, rotator.getTransform(), projection);
+	});
 	GlobalSelectionSystem().foreachPatch([&] (IPatch& patch) { patch.rotateTexture(angle); });
 }
 
@@ -714,7 +752,11 @@ void alignTexture(EAlignType align)
 
 	UndoableCommand undo(command);
 
-	GlobalSelectionSystem().foreachFace([&] (IFace& face) { face.alignTexture(faceAlignEdge); });
+	transformFaceProjections(getFacesOfSelection(), [&](const Face& face,
+		std::size_t, std::size_t, TextureProjection& projection)
+	{
+		projection.alignTexture(faceAlignEdge, face.getWinding());
+	});
 	GlobalSelectionSystem().foreachPatch([&] (IPatch& patch) { patch.alignTexture(patchAlignEdge); });
 
 	SceneChangeNotify();
@@ -758,7 +800,14 @@ void normaliseTexture(const cmd::ArgumentList& args)
 {
 	UndoableCommand undo("normaliseTexture");
 
-	GlobalSelectionSystem().foreachFace([] (IFace& face) { face.normaliseTexture(); });
+	transformFaceProjections(getFacesOfSelection(), [](const Face& face,
+		std::size_t, std::size_t, TextureProjection& projection)
+	{
+		auto bounds = getFaceTexcoordBounds(face);
+		TextureNormaliser normaliser({ bounds.origin.x(), bounds.origin.y() });
+
+		transformFaceTexcoords(face, normaliser.getTransform(), projection);
+	});
 	GlobalSelectionSystem().foreachPatch([] (IPatch& patch) { patch.normaliseTexture(); });
 
 	SceneChangeNotify();
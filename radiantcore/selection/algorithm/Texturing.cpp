@@ -6,6 +6,8 @@
 
 #include "ipatch.h"
 #include "ibrush.h"
+#include "itaskscheduler.h"
+#include "brush/Face.h"
 
 namespace selection
 {
@@ -23,6 +25,12 @@ inline void applyTransform(const textool::INode::Ptr& node, const Matrix3& trans
     node->commitTransformation();
 }
 
+// Smaller face batches are processed on the calling thread
+constexpr std::size_t MinFacesForParallelProcessing = 64;
+
+// The number of faces processed by a single worker in one go
+constexpr std::size_t FacesPerTask = 32;
+
 }
 
 TextureNodeProcessor::operator std::function<bool(const textool::INode::Ptr& node)>()
@@ -187,6 +195,93 @@ void TextureNormaliser::NormaliseNode(const textool::INode::Ptr& node)
     normaliser.processNode(node);
 }
 
+// Face batches
+
+void transformFaceProjections(const std::vector<Face*>& faces, const FaceProjectionOperation& operation)
+{
+    if (faces.empty()) return;
+
+    struct FaceProjectionJob
+    {
+        Face* face;
+        std::size_t textureWidth;
+        std::size_t textureHeight;
+        TextureProjection projection;
+    };
+
+    // Capture the input on this thread, the texture dimensions might need to load the image
+    std::vector<FaceProjectionJob> jobs;
+    jobs.reserve(faces.size());
+
+    for (auto face : faces)
+    {
+        const auto& shader = face->getFaceShader();
+        jobs.push_back({ face, shader.getWidth(), shader.getHeight(), face->getProjection() });
+    }
+
+    auto processJobs = [&](std::size_t first, std::size_t end)
+    {
+        for (auto i = first; i < end; ++i)
+        {
+            auto& job = jobs[i];
+            operation(*job.face, job.textureWidth, job.textureHeight, job.projection);
+        }
+    };
+
+    if (jobs.size() < MinFacesForParallelProcessing)
+    {
+        processJobs(0, jobs.size());
+    }
+    else
+    {
+        auto numTasks = (jobs.size() + FacesPerTask - 1) / FacesPerTask;
+
+        GlobalTaskScheduler().parallelFor(numTasks, [&](std::size_t task)
+        {
+            auto first = task * FacesPerTask;
+            processJobs(first, std::min(first + FacesPerTask, jobs.size()));
+        });
+    }
+
+    // Each face would send its own TextureChangedMessage through this signal
+    auto& texdefChangedSignal = Face::signal_texdefChanged();
+    auto wasBlocked = texdefChangedSignal.blocked();
+    texdefChangedSignal.block();
+
+    for (const auto& job : jobs)
+    {
+        job.face->SetTexdef(job.projection);
+    }
+
+    texdefChangedSignal.block(wasBlocked);
+
+    radiant::TextureChangedMessage::Send();
+}
+
+AABB getFaceTexcoordBounds(const Face& face)
+{
+    AABB bounds;
+
+    for (const auto& vertex : face.getWinding())
+    {
+        bounds.includePoint({ vertex.texcoord.x(), vertex.texcoord.y(), 0 });
+    }
+
+    return bounds;
+}
+
+void transformFaceTexcoords(const Face& face, const Matrix3& transform, TextureProjection& projection)
+{
+    const auto& winding = face.getWinding();
+
+    if (winding.size() < 3) return;
+
+    Vector3 vertices[3] = { winding[0].vertex, winding[1].vertex, winding[2].vertex };
+    Vector2 texcoords[3] = { transform * winding[0].texcoord, transform * winding[1].texcoord, transform * winding[2].texcoord };
+
+    projection.calculateFromPoints(vertices, texcoords, face.getPlane3().normal());
+}
+
 }
 
 }
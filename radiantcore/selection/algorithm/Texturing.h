@@ -1,11 +1,14 @@
 #pragma once
 
+#include <vector>
 #include "itexturetoolmodel.h"
 #include "math/AABB.h"
 #include "math/Matrix3.h"
 
 class IPatch;
 class IFace;
+class Face;
+class TextureProjection;
 
 namespace selection
 {
@@ -128,6 +131,29 @@ private:
     static void NormaliseNode(const textool::INode::Ptr& node);
 };
 
+/**
+ * Calculates the new texture projection of a face as part of a batch, see
+ * transformFaceProjections(). The face must only be read from, since the
+ * operation is invoked on worker threads. The projection argument holds the
+ * current projection of the face and receives the result. The texture
+ * dimensions are queried up front, since that might load the editor image.
+ */
+using FaceProjectionOperation = std::function<void(const Face& face,
+    std::size_t textureWidth, std::size_t textureHeight, TextureProjection& projection)>;
+
+// Applies the given operation to all faces, in parallel for larger face counts.
+// The results are assigned afterwards, saving the undo state of each face, and a
+// single TextureChangedMessage is sent instead of one per face.
+void transformFaceProjections(const std::vector<Face*>& faces, const FaceProjectionOperation& operation);
+
+// Returns the bounds of the face's texture coordinates (with z == 0)
+AABB getFaceTexcoordBounds(const Face& face);
+
+// Replaces the projection with the one mapping the face winding to the texture
+// coordinates as transformed by the given UV-space matrix. This is what the
+// TextureNodeManipulators do to a face, without touching the face itself.
+void transformFaceTexcoords(const Face& face, const Matrix3& transform, TextureProjection& projection);
+
 }
 
 }
@@ -23,6 +23,7 @@
 #include "debugging/debugging.h"
 #include "selection/TransformationVisitors.h"
 #include "selection/SceneWalkers.h"
+#include "brush/BRepEvaluation.h"
 #include "command/ExecutionFailure.h"
 
 #include "string/case_conv.h"
@@ -36,6 +37,24 @@ namespace algorithm
 namespace
 {
 	const std::string RKEY_OFFSET_CLONED_OBJECTS = "user/ui/offsetClonedObjects";
+
+	// Commits the pending transforms. Freezing emits the undo and bounds-changed
+	// notifications and happens on the calling thread, the windings of the
+	// transformed brushes are rebuilt on all cores afterwards instead of one
+	// by one when they're rendered the next time.
+	void freezeTransforms()
+	{
+		GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+
+		std::vector<scene::INodePtr> selectedNodes;
+
+		GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
+		{
+			selectedNodes.push_back(node);
+		});
+
+		brush::evaluateBRepsInSubgraphs(selectedNodes);
+	}
 }
 
 void rotateSelected(const Quaternion& rotation)
@@ -56,7 +75,7 @@ void rotateSelected(const Quaternion& rotation)
 	// Update the views
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	freezeTransforms();
 }
 
 // greebo: see header for documentation
@@ -106,7 +125,7 @@ void scaleSelected(const Vector3& scaleXYZ)
 		// Update the scene views
 		SceneChangeNotify();
 
-		GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+		freezeTransforms();
 	}
 	else
 	{
@@ -372,7 +391,7 @@ void translateSelected(const Vector3& translation)
 	// Update the scene so that the changes are made visible
 	SceneChangeNotify();
 
-	GlobalSceneGraph().foreachNode(scene::freezeTransformableNode);
+	freezeTransforms();
 }
 
 // Specialised overload, called by the general nudgeSelected() routine
@@ -8,6 +8,9 @@
 #include "iclipboard.h"
 #include "ishaderclipboard.h"
 #include "string/trim.h"
+#include "scene/BasicRootNode.h"
+#include "scene/Clone.h"
+#include "scene/Traverse.h"
 
 #include "map/Map.h"
 #include "brush/FaceInstance.h"
@@ -24,6 +27,16 @@ namespace selection
 namespace clipboard
 {
 
+namespace
+{
+    // The nodes copied by this instance, pasting them again doesn't need to
+    // parse the text which has been sent to the system clipboard
+    std::shared_ptr<scene::BasicRootNode> _copiedNodes;
+
+    // The clipboard contents as they were read back after copying the nodes
+    std::string _copiedText;
+}
+
 void pasteToMap()
 {
 	if (!module::GlobalModuleRegistry().moduleExists(MODULE_CLIPBOARD))
@@ -31,8 +44,23 @@ void pasteToMap()
 		throw cmd::ExecutionNotPossible(_("No clipboard module attached, cannot perform this action."));
 	}
 
-    std::stringstream stream(GlobalClipboard().getString());
-	map::algorithm::importFromStream(stream);
+    auto text = GlobalClipboard().getString();
+
+    if (!_copiedNodes || text != _copiedText)
+    {
+        std::stringstream stream(text);
+        map::algorithm::importFromStream(stream);
+        return;
+    }
+
+    // The clipboard still holds what has been copied here, clone the copied nodes
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    auto pastedNodes = std::make_shared<scene::BasicRootNode>();
+    scene::cloneNodesIntoRoot(_copiedNodes, scene::traverse, pastedNodes);
+
+    map::algorithm::prepareNamesForImport(GlobalMap().getRoot(), pastedNodes);
+    map::algorithm::importMap(pastedNodes);
 }
 
 void copySelectedMapElementsToClipboard()
@@ -46,6 +74,19 @@ void copySelectedMapElementsToClipboard()
 
     // Copy the resulting string to the clipboard
     GlobalClipboard().setString(out.str());
+
+    // Keep a copy of the nodes for pasting them into this instance. The text
+    // is read back, the system clipboard might have converted the line endings.
+    _copiedNodes = std::make_shared<scene::BasicRootNode>();
+    scene::cloneNodesIntoRoot(GlobalSceneGraph().root(), scene::traverseSelected, _copiedNodes);
+
+    _copiedText = GlobalClipboard().getString();
+}
+
+void clearCopiedNodes()
+{
+    _copiedNodes.reset();
+    _copiedText.clear();
 }
 
 void copy(const cmd::ArgumentList& args)
@@ -38,6 +38,12 @@ void paste(const cmd::ArgumentList& args);
  */
 void pasteToCamera(const cmd::ArgumentList& args);
 
+/**
+ * Releases the nodes kept for pasting the most recent copy without parsing
+ * the clipboard text. Called on shutdown, before the modules are destroyed.
+ */
+void clearCopiedNodes();
+
 // If the system clipboard holds a valid material name, this method will return the string
 // Returns empty in case none was found.
 std::string getMaterialNameFromClipboard();
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "iselectiongroup.h"
+#include "inode.h"
 #include "util/ScopedBoolLock.h"
+#include <unordered_map>
 
 namespace selection
 {
@@ -15,8 +17,18 @@ private:
 
 	std::string _name;
 
-	// The contained nodes of this group
-	std::set<scene::INodeWeakPtr, std::owner_less<scene::INodeWeakPtr> > _nodes;
+	struct Member
+	{
+		scene::INodeWeakPtr node;
+
+		// Valid as long as the node is alive, saves the cast when selecting the group
+		IGroupSelectable* selectable;
+	};
+
+	// The contained nodes of this group, indexed by node. Nodes leave their
+	// groups when they are removed from the scene, so selecting a group
+	// only needs to visit its members.
+	std::unordered_map<const scene::INode*, Member> _nodes;
 
 	// To avoid entering feedback loops during group updates
 	bool _selectionLock;
@@ -50,7 +62,8 @@ public:
 
 		selectable->addToGroup(_id);
 
-		_nodes.insert(scene::INodeWeakPtr(node));
+		// An expired entry at the same address belongs to a deleted node, replace it
+		_nodes[node.get()] = Member{ node, selectable.get() };
 	}
 
 	void removeNode(const scene::INodePtr& node) override
@@ -61,19 +74,17 @@ public:
 
 		selectable->removeFromGroup(_id);
 
-		_nodes.erase(scene::INodeWeakPtr(node));
+		_nodes.erase(node.get());
 	}
 
 	void removeAllNodes()
 	{
-		foreachNode([this](const scene::INodePtr& node)
+		foreachMember([this](const scene::INodePtr&, IGroupSelectable& selectable)
 		{
-			std::shared_ptr<IGroupSelectable> selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
-
-			assert(selectable);
-
-			selectable->removeFromGroup(_id);
+			selectable.removeFromGroup(_id);
 		});
+
+		_nodes.clear();
 	}
 
 	std::size_t size() const override
@@ -91,26 +102,32 @@ public:
 
 		util::ScopedBoolLock lock(_selectionLock);
 
-		foreachNode([&](const scene::INodePtr& node)
+		foreachMember([&](const scene::INodePtr&, IGroupSelectable& selectable)
 		{
-			std::shared_ptr<IGroupSelectable> selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
-
-			assert(selectable);
-
 			// Set the node status, but don't do a group update (we're already here)
-			selectable->setSelected(selected, false);
+			selectable.setSelected(selected, false);
 		});
 	}
 
 	void foreachNode(const std::function<void(const scene::INodePtr&)>& functor) override
 	{
-		for (const scene::INodeWeakPtr& node : _nodes)
+		foreachMember([&](const scene::INodePtr& node, IGroupSelectable&)
+		{
+			functor(node);
+		});
+	}
+
+private:
+	template<typename FunctorT>
+	void foreachMember(const FunctorT& functor)
+	{
+		for (const auto& pair : _nodes)
 		{
-			scene::INodePtr locked = node.lock();
+			scene::INodePtr locked = pair.second.node.lock();
 
 			if (locked)
 			{
-				functor(locked);
+				functor(locked, *pair.second.selectable);
 			}
 		}
 	}
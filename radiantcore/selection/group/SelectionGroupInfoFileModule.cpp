@@ -91,7 +91,7 @@ void SelectionGroupInfoFileModule::saveNode(const scene::INodePtr& node, std::si
 {
 	// Don't export the group settings for models and particles, as they are not there
 	// at map load/parse time - these shouldn't even be passed in here
-	assert(Node_isEntity(node) || Node_isPrimitive(node));
+	assert(Node_isEntity(node) || Node_isPrimitive(node) || Node_isUnloadedBlock(node));
 
 	std::shared_ptr<IGroupSelectable> selectable = std::dynamic_pointer_cast<IGroupSelectable>(node);
 
@@ -149,8 +149,11 @@ void SelectionGroupInfoFileModule::writeBlocks(std::ostream& stream)
 	stream << "\t" << NODE_MAPPING << std::endl;
 	stream << "\t{" << std::endl;
 
-	// Write the output buffer to the stream
-	stream << _output.str();
+	// Write the output buffer to the stream, without copying it into a string first
+	if (_output.tellp() > 0)
+	{
+		stream << _output.rdbuf();
+	}
 
 	// Closing braces of NodeToLayerMapping block
 	stream << "\t}" << std::endl;
@@ -232,9 +235,10 @@ void SelectionGroupInfoFileModule::parseNodeMappings(parser::DefTokeniser& tok)
 	// The opening brace
 	tok.assertNextToken("{");
 
+	// There is a Node block for every grouped entity and primitive, avoid copying the tokens
 	while (tok.hasMoreTokens())
 	{
-		std::string token = tok.nextToken();
+		auto token = tok.nextTokenView();
 
 		if (token == NODE)
 		{
@@ -246,16 +250,16 @@ void SelectionGroupInfoFileModule::parseNodeMappings(parser::DefTokeniser& tok)
 			tok.assertNextToken("(");
 
 			// Entity number is always there
-			std::size_t entityNum = string::convert<std::size_t>(tok.nextToken());
+			auto entityNum = tok.nextInteger<std::size_t>();
 			std::size_t primitiveNum = EMPTY_PRIMITVE_NUM;
 
-			token = tok.nextToken();
+			token = tok.nextTokenView();
 
 			// If we hit the closing parenthesis, we don't have a primitive number
 			if (token != ")")
 			{
 				// We have a primitive number
-				primitiveNum = string::convert<std::size_t>(token);
+				primitiveNum = string::parseInteger<std::size_t>(token);
 				tok.assertNextToken(")");
 			}
 
@@ -267,11 +271,9 @@ void SelectionGroupInfoFileModule::parseNodeMappings(parser::DefTokeniser& tok)
 			tok.assertNextToken("(");
 
 			// Parse the group IDs until we hit the closing parenthesis
-			for (token = tok.nextToken(); token != ")"; token = tok.nextToken())
+			for (token = tok.nextTokenView(); token != ")"; token = tok.nextTokenView())
 			{
-				std::size_t groupId = string::convert<std::size_t>(token);
-
-				mapped->second.push_back(groupId);
+				mapped->second.push_back(string::parseInteger<std::size_t>(token));
 			}
 
 			// Node closed
@@ -352,7 +352,8 @@ void ModelScaleComponent::transform(const Matrix4& pivot2world, const VolumeTest
 		return true;
 	});
 
-	SceneChangeNotify();
+	// Only the geometry changed, views not showing the damaged region are left alone
+	GlobalSceneGraph().notifyDamagedBounds();
 }
 
 SelectionTranslator::SelectionTranslator(const TranslationCallback& onTranslation) :
@@ -317,7 +317,8 @@ void RotateManipulator::rotate(const Quaternion& rotation)
 		GlobalSelectionSystem().foreachSelected(RotateSelected(rotation, _pivot.getVector3()));
 	}
 
-	SceneChangeNotify();
+	// Only the geometry changed, views not showing the damaged region are left alone
+	GlobalSceneGraph().notifyDamagedBounds();
 }
 
 }
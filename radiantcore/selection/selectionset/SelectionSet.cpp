@@ -26,36 +26,34 @@ void SelectionSet::clear()
 
 void SelectionSet::select()
 {
-	for (NodeSet::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
-	{
-		scene::INodePtr node = i->lock();
-
-		if (node == NULL) continue; // skip deleted nodes
-
-		if (!node->visible()) continue; // skip invisible, non-instantiated nodes
-
-		Node_setSelected(node, true);
-	}
+	setMembersSelected(true);
 }
 
 void SelectionSet::deselect()
 {
-	for (NodeSet::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+	setMembersSelected(false);
+}
+
+void SelectionSet::setMembersSelected(bool selected)
+{
+	for (const auto& pair : _nodes)
 	{
-		scene::INodePtr node = i->lock();
+		if (pair.second.selectable == nullptr) continue;
+
+		scene::INodePtr node = pair.second.node.lock();
 
 		if (node == NULL) continue; // skip deleted nodes
 
 		if (!node->visible()) continue; // skip invisible, non-instantiated nodes
 
-		Node_setSelected(node, false);
+		pair.second.selectable->setSelected(selected);
 	}
 }
 
 void SelectionSet::addNode(const scene::INodePtr& node)
 {
-	scene::INodeWeakPtr weakPtr(node);
-	_nodes.insert(weakPtr);
+	// An expired entry at the same address belongs to a deleted node, replace it
+	_nodes[node.get()] = Member{ node, scene::node_cast<ISelectable>(node).get() };
 }
 
 void SelectionSet::assignFromCurrentScene()
@@ -72,9 +70,9 @@ std::set<scene::INodePtr> SelectionSet::getNodes()
 {
 	std::set<scene::INodePtr> nodeSet;
 
-	for (NodeSet::iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+	for (const auto& pair : _nodes)
 	{
-		scene::INodePtr node = i->lock();
+		scene::INodePtr node = pair.second.node.lock();
 
 		if (node == NULL) continue; // skip deleted nodes
 
@@ -3,6 +3,7 @@
 #include "iselectionset.h"
 #include "iselection.h"
 #include "inode.h"
+#include <unordered_map>
 
 namespace selection
 {
@@ -11,8 +12,17 @@ class SelectionSet :
 	public ISelectionSet
 {
 private:
-    typedef std::set<scene::INodeWeakPtr, std::owner_less<scene::INodeWeakPtr> > NodeSet;
-	NodeSet _nodes;
+	struct Member
+	{
+		scene::INodeWeakPtr node;
+
+		// Valid as long as the node is alive, can be empty for non-selectable nodes
+		ISelectable* selectable;
+	};
+
+	// The member nodes, indexed by node
+	typedef std::unordered_map<const scene::INode*, Member> NodeMap;
+	NodeMap _nodes;
 
 	std::string _name;
 
@@ -40,6 +50,9 @@ public:
 	void assignFromCurrentScene();
 
 	std::set<scene::INodePtr> getNodes();
+
+private:
+	void setMembersSelected(bool selected);
 };
 typedef std::shared_ptr<SelectionSet> SelectionSetPtr;
 
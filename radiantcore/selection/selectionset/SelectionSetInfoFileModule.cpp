@@ -25,6 +25,7 @@ void SelectionSetInfoFileModule::clear()
 {
 	_importInfo.clear();
 	_exportInfo.clear();
+	_setsByNode.clear();
 }
 
 void SelectionSetInfoFileModule::onBeginSaveMap(const scene::IMapRootNodePtr& root)
@@ -32,11 +33,16 @@ void SelectionSetInfoFileModule::onBeginSaveMap(const scene::IMapRootNodePtr& ro
 	// Visit all selection sets and assemble the info into the structures
 	root->getSelectionSetManager().foreachSelectionSet([&](const ISelectionSetPtr& set)
 	{
-		// Get all nodes of this selection set and store them for later use
-		_exportInfo.push_back(SelectionSetExportInfo());
+		// Remember the set of every member node for later use
+		auto setIndex = _exportInfo.size();
 
+		_exportInfo.push_back(SelectionSetExportInfo());
 		_exportInfo.back().set = set;
-		_exportInfo.back().nodes = set->getNodes();
+
+		for (const auto& node : set->getNodes())
+		{
+			_setsByNode[node.get()].push_back(setIndex);
+		}
 	});
 }
 
@@ -50,25 +56,24 @@ void SelectionSetInfoFileModule::onInfoFileSaveStart()
 
 void SelectionSetInfoFileModule::onSavePrimitive(const scene::INodePtr& node, std::size_t entityNum, std::size_t primitiveNum)
 {
-	// Determine the item index for the selection set index mapping
-	for (auto& info : _exportInfo)
-	{
-		if (info.nodes.find(node) != info.nodes.end())
-		{
-			info.nodeIndices.insert(map::NodeIndexPair(entityNum, primitiveNum));
-		}
-	}
+	saveNode(node, map::NodeIndexPair(entityNum, primitiveNum));
 }
 
 void SelectionSetInfoFileModule::onSaveEntity(const scene::INodePtr& node, std::size_t entityNum)
+{
+	saveNode(node, map::NodeIndexPair(entityNum, EMPTY_PRIMITVE_NUM));
+}
+
+void SelectionSetInfoFileModule::saveNode(const scene::INodePtr& node, const map::NodeIndexPair& indices)
 {
 	// Determine the item index for the selection set index mapping
-	for (auto& info : _exportInfo)
+	auto sets = _setsByNode.find(node.get());
+
+	if (sets == _setsByNode.end()) return;
+
+	for (auto setIndex : sets->second)
 	{
-		if (info.nodes.find(node) != info.nodes.end())
-		{
-			info.nodeIndices.insert(map::NodeIndexPair(entityNum, EMPTY_PRIMITVE_NUM));
-		}
+		_exportInfo[setIndex].nodeIndices.insert(indices);
 	}
 }
 
@@ -159,7 +164,7 @@ void SelectionSetInfoFileModule::parseBlock(const std::string& blockName, parser
 
 			while (tok.hasMoreTokens())
 			{
-				std::string nextToken = tok.nextToken();
+				auto nextToken = tok.nextTokenView();
 
 				if (nextToken == "}") break;
 
@@ -167,13 +172,13 @@ void SelectionSetInfoFileModule::parseBlock(const std::string& blockName, parser
 				if (nextToken != "(")
 				{
 					throw parser::ParseException("InfoFile: Assertion failed: Required \"("
-						"\", found \"" + nextToken + "\"");
+						"\", found \"" + std::string(nextToken) + "\"");
 				}
 
 				// Expect one or two numbers now
-				std::size_t entityNum = string::convert<std::size_t>(tok.nextToken());
+				auto entityNum = tok.nextInteger<std::size_t>();
 
-				nextToken = tok.nextToken();
+				nextToken = tok.nextTokenView();
 
 				if (nextToken == ")")
 				{
@@ -184,7 +189,7 @@ void SelectionSetInfoFileModule::parseBlock(const std::string& blockName, parser
 				else
 				{
 					// Primitive number is provided as well
-					std::size_t primitiveNum = string::convert<std::size_t>(nextToken);
+					auto primitiveNum = string::parseInteger<std::size_t>(nextToken);
 
 					// No more than 2 numbers are supported, so assume a closing parenthesis now
 					tok.assertNextToken(")");
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include "imapinfofile.h"
 #include "iselectionset.h"
 
@@ -31,9 +32,6 @@ private:
 		// The set we're working with
 		selection::ISelectionSetPtr set;
 
-		// The nodes in this set
-		std::set<scene::INodePtr> nodes;
-
 		// The node indices, which will be resolved during traversal
 		std::set<map::NodeIndexPair> nodeIndices;
 	};
@@ -42,6 +40,10 @@ private:
 	typedef std::vector<SelectionSetExportInfo> SelectionSetInfo;
 	SelectionSetInfo _exportInfo;
 
+	// The indices into _exportInfo of the sets each member node belongs to,
+	// every saved node needs a single lookup regardless of the number of sets
+	std::unordered_map<const scene::INode*, std::vector<std::size_t>> _setsByNode;
+
 public:
 	std::string getName() override;
 
@@ -61,6 +63,7 @@ public:
 
 private:
 	void clear();
+	void saveNode(const scene::INodePtr& node, const map::NodeIndexPair& indices);
 };
 
 }
@@ -54,6 +54,14 @@ IFace& FaceNode::getFace()
     return _face;
 }
 
+bool FaceNode::isUpToDate() const
+{
+    const auto& winding = _face.getWinding();
+
+    return winding.size() == _vertices.size() &&
+        (winding.empty() || &winding.front().texcoord == &_vertices.front().getTexcoord());
+}
+
 void FaceNode::beginTransformation()
 {
     _face.undoSave();
@@ -149,6 +157,19 @@ void FaceNode::render(SelectionMode mode)
     }
 }
 
+void FaceNode::getSurfaceTriangles(std::vector<Vector2>& triangles) const
+{
+    const auto& winding = _face.getWinding();
+
+    // Triangulate the winding as a fan around its first vertex
+    for (std::size_t i = 2; i < winding.size(); ++i)
+    {
+        triangles.push_back(winding[0].texcoord);
+        triangles.push_back(winding[i - 1].texcoord);
+        triangles.push_back(winding[i].texcoord);
+    }
+}
+
 void FaceNode::expandSelectionToRelated()
 {
     if (!isSelected())
@@ -25,6 +25,9 @@ public:
 
     IFace& getFace() override;
 
+    // True if the vertices of this node are still referring to the current face winding
+    bool isUpToDate() const;
+
     void beginTransformation() override;
     void revertTransformation() override;
     void commitTransformation() override;
@@ -36,6 +39,7 @@ public:
     void testSelect(Selector& selector, SelectionTest& test) override;
     
     void render(SelectionMode mode) override;
+    void getSurfaceTriangles(std::vector<Vector2>& triangles) const override;
 
     void expandSelectionToRelated() override;
     void snapto(float snap) override;
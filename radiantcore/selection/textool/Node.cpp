@@ -102,6 +102,14 @@ void Node::expandComponentSelectionToRelated()
     }
 }
 
+void Node::foreachComponentVertex(const std::function<void(const Vector2&, bool)>& functor) const
+{
+    for (const auto& vertex : _vertices)
+    {
+        functor(vertex.getTexcoord(), vertex.isSelected());
+    }
+}
+
 Colour4 Node::getSurfaceColour(SelectionMode mode)
 {
     if (mode == SelectionMode::Surface && isSelected())
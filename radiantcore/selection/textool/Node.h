@@ -32,6 +32,7 @@ public:
     virtual void testSelectComponents(Selector& selector, SelectionTest& test) override;
     virtual AABB getSelectedComponentBounds() override;
     virtual void expandComponentSelectionToRelated() override;
+    virtual void foreachComponentVertex(const std::function<void(const Vector2&, bool)>& functor) const override;
 
 protected:
     virtual void renderComponents();
@@ -22,6 +22,16 @@ IPatch& PatchNode::getPatch()
     return _patch;
 }
 
+bool PatchNode::isUpToDate() const
+{
+    if (_patch.getWidth() * _patch.getHeight() != _vertices.size())
+    {
+        return false;
+    }
+
+    return _vertices.empty() || &_patch.getTransformedCtrlAt(0, 0).texcoord == &_vertices.front().getTexcoord();
+}
+
 void PatchNode::beginTransformation()
 {
     // We call undoSave() here for consistency, but technically it's too early -
@@ -145,6 +155,36 @@ void PatchNode::render(SelectionMode mode)
     }
 }
 
+void PatchNode::getSurfaceTriangles(std::vector<Vector2>& triangles) const
+{
+    auto tess = _patch.getTesselatedPatchMesh();
+    auto renderInfo = _patch.getRenderIndices();
+
+    if (renderInfo.indices.empty()) return;
+
+    const auto* strip_indices = &renderInfo.indices.front();
+
+    // Split the quads of each strip into two triangles
+    for (std::size_t i = 0; i < renderInfo.numStrips; i++, strip_indices += renderInfo.lenStrips)
+    {
+        for (std::size_t offset = 0; offset + 3 < renderInfo.lenStrips; offset += 2)
+        {
+            const auto& a = tess.vertices[*(strip_indices + offset)].texcoord;
+            const auto& b = tess.vertices[*(strip_indices + offset + 1)].texcoord;
+            const auto& c = tess.vertices[*(strip_indices + offset + 2)].texcoord;
+            const auto& d = tess.vertices[*(strip_indices + offset + 3)].texcoord;
+
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(d);
+
+            triangles.push_back(a);
+            triangles.push_back(d);
+            triangles.push_back(c);
+        }
+    }
+}
+
 void PatchNode::expandSelectionToRelated()
 {}
 
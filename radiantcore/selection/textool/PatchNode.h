@@ -23,6 +23,9 @@ public:
 
     IPatch& getPatch() override;
 
+    // True if the vertices of this node are still referring to the current patch controls
+    bool isUpToDate() const;
+
     void beginTransformation() override;
     void revertTransformation() override;
     void commitTransformation() override;
@@ -34,6 +37,7 @@ public:
     void testSelect(Selector& selector, SelectionTest& test) override;
 
     void render(SelectionMode mode) override;
+    void getSurfaceTriangles(std::vector<Vector2>& triangles) const override;
 
     void expandSelectionToRelated() override;
     void snapto(float snap) override;
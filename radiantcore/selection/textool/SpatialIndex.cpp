@@ -0,0 +1,235 @@
+#include "SpatialIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include "ivolumetest.h"
+
+namespace textool
+{
+
+namespace
+{
+    // The average number of nodes the layout is aiming for per cell
+    constexpr std::size_t NODES_PER_CELL = 8;
+    constexpr std::size_t MAX_CELLS_PER_AXIS = 64;
+
+    // The layout is re-calculated once the index grew beyond this factor
+    constexpr std::size_t GROWTH_FACTOR_BEFORE_REBUILD = 2;
+}
+
+SpatialIndex::SpatialIndex() :
+    _origin(0, 0),
+    _cellSize(1, 1),
+    _cellsPerAxis(1),
+    _layoutSize(0),
+    _layoutNeedsRebuild(true)
+{}
+
+void SpatialIndex::clear()
+{
+    _entries.clear();
+    _entryByNode.clear();
+    _cells.clear();
+    _layoutSize = 0;
+    _layoutNeedsRebuild = true;
+}
+
+void SpatialIndex::insert(const INode::Ptr& node, std::size_t order)
+{
+    auto existing = _entryByNode.find(node.get());
+
+    if (existing != _entryByNode.end())
+    {
+        _entries[existing->second].order = order;
+        return;
+    }
+
+    auto index = _entries.size();
+    _entries.emplace_back(Entry{ node, node->localAABB(), order });
+    _entryByNode.emplace(node.get(), index);
+
+    if (!_layoutNeedsRebuild)
+    {
+        addToCells(index);
+    }
+}
+
+void SpatialIndex::remove(const INode::Ptr& node)
+{
+    auto existing = _entryByNode.find(node.get());
+
+    if (existing == _entryByNode.end()) return;
+
+    auto index = existing->second;
+    auto last = _entries.size() - 1;
+
+    _entryByNode.erase(existing);
+
+    if (!_layoutNeedsRebuild)
+    {
+        removeFromCells(index);
+    }
+
+    // Move the last entry into the gap, the cells are referring to it by index
+    if (index != last)
+    {
+        if (!_layoutNeedsRebuild)
+        {
+            removeFromCells(last);
+        }
+
+        _entries[index] = std::move(_entries[last]);
+        _entryByNode[_entries[index].node.get()] = index;
+
+        if (!_layoutNeedsRebuild)
+        {
+            addToCells(index);
+        }
+    }
+
+    _entries.pop_back();
+}
+
+void SpatialIndex::invalidateBounds()
+{
+    _layoutNeedsRebuild = true;
+}
+
+void SpatialIndex::foreachNodeInVolume(const VolumeTest& volume, const std::function<bool(const INode::Ptr&)>& functor)
+{
+    ensureLayout();
+
+    std::vector<std::size_t> candidates;
+
+    for (const auto& cell : _cells)
+    {
+        if (cell.entries.empty() || volume.TestAABB(cell.bounds) == VOLUME_OUTSIDE) continue;
+
+        candidates.insert(candidates.end(), cell.entries.begin(), cell.entries.end());
+    }
+
+    // Nodes spanning several cells have been added more than once
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](std::size_t index)
+    {
+        return volume.TestAABB(_entries[index].bounds) == VOLUME_OUTSIDE;
+    }), candidates.end());
+
+    std::sort(candidates.begin(), candidates.end(), [&](std::size_t a, std::size_t b)
+    {
+        return _entries[a].order < _entries[b].order;
+    });
+
+    for (auto index : candidates)
+    {
+        if (!functor(_entries[index].node))
+        {
+            break;
+        }
+    }
+}
+
+void SpatialIndex::ensureLayout()
+{
+    if (_layoutNeedsRebuild || _entries.size() > _layoutSize * GROWTH_FACTOR_BEFORE_REBUILD + NODES_PER_CELL)
+    {
+        calculateLayout();
+    }
+}
+
+void SpatialIndex::calculateLayout()
+{
+    _layoutNeedsRebuild = false;
+    _layoutSize = _entries.size();
+
+    AABB totalBounds;
+
+    for (auto& entry : _entries)
+    {
+        entry.bounds = entry.node->localAABB();
+        totalBounds.includeAABB(entry.bounds);
+    }
+
+    auto numCells = std::max(_entries.size() / NODES_PER_CELL, static_cast<std::size_t>(1));
+    _cellsPerAxis = std::min(static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(numCells)))), MAX_CELLS_PER_AXIS);
+
+    if (totalBounds.isValid())
+    {
+        auto min = totalBounds.getOrigin() - totalBounds.getExtents();
+        auto size = totalBounds.getExtents() * 2 / static_cast<double>(_cellsPerAxis);
+
+        _origin = Vector2(min.x(), min.y());
+        _cellSize = Vector2(size.x() > 0 ? size.x() : 1, size.y() > 0 ? size.y() : 1);
+    }
+    else
+    {
+        _origin = Vector2(0, 0);
+        _cellSize = Vector2(1, 1);
+    }
+
+    _cells.clear();
+    _cells.resize(_cellsPerAxis * _cellsPerAxis);
+
+    for (std::size_t index = 0; index < _entries.size(); ++index)
+    {
+        addToCells(index);
+    }
+}
+
+void SpatialIndex::addToCells(std::size_t index)
+{
+    const auto& bounds = _entries[index].bounds;
+
+    // Nodes without any vertices cannot be hit by any selection test
+    if (!bounds.isValid()) return;
+
+    auto min = bounds.getOrigin() - bounds.getExtents();
+    auto max = bounds.getOrigin() + bounds.getExtents();
+
+    for (auto row = getCellRow(min.y()); row <= getCellRow(max.y()); ++row)
+    {
+        for (auto column = getCellColumn(min.x()); column <= getCellColumn(max.x()); ++column)
+        {
+            auto& cell = _cells[row * _cellsPerAxis + column];
+
+            cell.entries.push_back(index);
+            cell.bounds.includeAABB(bounds);
+        }
+    }
+}
+
+void SpatialIndex::removeFromCells(std::size_t index)
+{
+    const auto& bounds = _entries[index].bounds;
+
+    if (!bounds.isValid()) return;
+
+    auto min = bounds.getOrigin() - bounds.getExtents();
+    auto max = bounds.getOrigin() + bounds.getExtents();
+
+    // The cell bounds are not shrinking, they are re-calculated with the next layout
+    for (auto row = getCellRow(min.y()); row <= getCellRow(max.y()); ++row)
+    {
+        for (auto column = getCellColumn(min.x()); column <= getCellColumn(max.x()); ++column)
+        {
+            auto& entries = _cells[row * _cellsPerAxis + column].entries;
+            entries.erase(std::remove(entries.begin(), entries.end(), index), entries.end());
+        }
+    }
+}
+
+std::size_t SpatialIndex::getCellColumn(double s) const
+{
+    auto column = std::floor((s - _origin.x()) / _cellSize.x());
+    return static_cast<std::size_t>(std::clamp(column, 0.0, static_cast<double>(_cellsPerAxis - 1)));
+}
+
+std::size_t SpatialIndex::getCellRow(double t) const
+{
+    auto row = std::floor((t - _origin.y()) / _cellSize.y());
+    return static_cast<std::size_t>(std::clamp(row, 0.0, static_cast<double>(_cellsPerAxis - 1)));
+}
+
+}
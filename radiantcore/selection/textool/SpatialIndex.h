@@ -0,0 +1,89 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "itexturetoolmodel.h"
+#include "math/AABB.h"
+#include "math/Vector2.h"
+
+class VolumeTest;
+
+namespace textool
+{
+
+/**
+ * A uniform 2D grid over the UV space, sorting the texture tool nodes into
+ * cells according to their texture coordinate bounds. Selection tests use it to
+ * skip all the nodes outside the tested volume, instead of testing every single
+ * face and vertex of a large texture tool scene.
+ *
+ * The grid layout is derived from the bounds of all nodes and is calculated
+ * lazily on the first query after the node bounds have been invalidated.
+ * Nodes inserted later on are sorted into the existing layout, nodes outside the
+ * grid end up in its border cells.
+ */
+class SpatialIndex
+{
+private:
+    struct Entry
+    {
+        INode::Ptr node;
+        AABB bounds;
+
+        // The position of the node in the scene, queries are returned in this order
+        std::size_t order;
+    };
+
+    struct Cell
+    {
+        std::vector<std::size_t> entries;
+
+        // The combined bounds of all entries touching this cell
+        AABB bounds;
+    };
+
+    std::vector<Entry> _entries;
+    std::unordered_map<const INode*, std::size_t> _entryByNode;
+
+    std::vector<Cell> _cells;
+    Vector2 _origin;
+    Vector2 _cellSize;
+    std::size_t _cellsPerAxis;
+
+    // The number of entries the current layout has been calculated for
+    std::size_t _layoutSize;
+    bool _layoutNeedsRebuild;
+
+public:
+    SpatialIndex();
+
+    // Removes all nodes from the index
+    void clear();
+
+    // Adds the node to the index, using its current UV bounds. If the node is
+    // already in the index, only its order is updated.
+    void insert(const INode::Ptr& node, std::size_t order);
+
+    void remove(const INode::Ptr& node);
+
+    // To be called when the texture coordinates of any node have changed,
+    // the bounds are re-calculated on the next query
+    void invalidateBounds();
+
+    // Invokes the functor for every node whose bounds are intersecting the volume,
+    // in the order the nodes have been inserted with. Returning false stops the traversal.
+    void foreachNodeInVolume(const VolumeTest& volume, const std::function<bool(const INode::Ptr&)>& functor);
+
+private:
+    void ensureLayout();
+    void calculateLayout();
+
+    void addToCells(std::size_t index);
+    void removeFromCells(std::size_t index);
+
+    std::size_t getCellColumn(double s) const;
+    std::size_t getCellRow(double t) const;
+};
+
+}
@@ -1,6 +1,8 @@
 #include "TextureToolSceneGraph.h"
 
+#include <unordered_set>
 #include "iselection.h"
+#include "iscenegraph.h"
 #include "ibrush.h"
 #include "ipatch.h"
 #include "module/StaticModule.h"
@@ -26,7 +28,7 @@ const std::string& TextureToolSceneGraph::getName() const
 
 const StringSet& TextureToolSceneGraph::getDependencies() const
 {
-    static StringSet _dependencies{ MODULE_SELECTIONSYSTEM };
+    static StringSet _dependencies{ MODULE_SELECTIONSYSTEM, MODULE_SCENEGRAPH };
     return _dependencies;
 }
 
@@ -36,6 +38,11 @@ void TextureToolSceneGraph::initialiseModule(const IApplicationContext& ctx)
         sigc::mem_fun(this, &TextureToolSceneGraph::onSceneSelectionChanged)
     );
 
+    // Brush faces change their texture coordinates when their plane changes
+    _sceneBoundsChanged = GlobalSceneGraph().signal_boundsChanged().connect(
+        sigc::mem_fun(this, &TextureToolSceneGraph::onSceneBoundsChanged)
+    );
+
     _textureChangedHandler = GlobalRadiantCore().getMessageBus().addListener(
         radiant::IMessage::Type::TextureChanged,
         radiant::TypeListener<radiant::TextureChangedMessage>(
@@ -46,9 +53,9 @@ void TextureToolSceneGraph::shutdownModule()
 {
     _selectionNeedsRescan = false;
     _activeMaterialNeedsRescan = false;
-    clearFaceObservers();
-    _nodes.clear();
+    clearNodes();
     _sceneSelectionChanged.disconnect();
+    _sceneBoundsChanged.disconnect();
     GlobalRadiantCore().getMessageBus().removeListener(_textureChangedHandler);
 }
 
@@ -65,6 +72,13 @@ void TextureToolSceneGraph::foreachNode(const std::function<bool(const INode::Pt
     }
 }
 
+void TextureToolSceneGraph::foreachNodeInVolume(const VolumeTest& volume, const std::function<bool(const INode::Ptr&)>& functor)
+{
+    ensureSceneIsAnalysed();
+
+    _spatialIndex.foreachNodeInVolume(volume, functor);
+}
+
 const std::string& TextureToolSceneGraph::getActiveMaterial()
 {
     ensureSceneIsAnalysed();
@@ -93,57 +107,146 @@ void TextureToolSceneGraph::ensureSceneIsAnalysed()
     if (!_selectionNeedsRescan) return;
 
     _selectionNeedsRescan = false;
-    clearFaceObservers();
+
+    // Keep the nodes of the previous scan around, the ones of the faces and
+    // patches that are still selected don't need to be constructed again
+    auto previousNodes = std::move(_nodes);
+    auto previousFaceNodes = std::move(_faceNodes);
+    auto previousPatchNodes = std::move(_patchNodes);
+
     _nodes.clear();
+    _faceNodes.clear();
+    _patchNodes.clear();
 
     // No unique material, leave everything empty
-    if (_activeMaterial.empty()) return;
-
-    if (GlobalSelectionSystem().countSelectedComponents() > 0)
+    if (!_activeMaterial.empty())
     {
-        selection::algorithm::forEachSelectedFaceComponent([&](IFace& face)
+        if (GlobalSelectionSystem().countSelectedComponents() > 0)
         {
-            createFaceNode(face);
-        });
-    }
+            selection::algorithm::forEachSelectedFaceComponent([&](IFace& face)
+            {
+                addFaceNode(face, previousFaceNodes);
+            });
+        }
 
-    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
-    {
-        if (Node_isBrush(node))
+        GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node)
         {
-            auto brush = Node_getIBrush(node);
-            assert(brush);
+            if (Node_isBrush(node))
+            {
+                auto brush = Node_getIBrush(node);
+                assert(brush);
 
-            for (auto i = 0; i < brush->getNumFaces(); ++i)
+                for (auto i = 0; i < brush->getNumFaces(); ++i)
+                {
+                    addFaceNode(brush->getFace(i), previousFaceNodes);
+                }
+            }
+            else if (Node_isPatch(node))
             {
-                createFaceNode(brush->getFace(i));
+                addPatchNode(node, previousPatchNodes);
             }
-        }
-        else if (Node_isPatch(node))
+        });
+    }
+
+    for (auto& [face, entry] : previousFaceNodes)
+    {
+        entry.faceObserver.disconnect();
+    }
+
+    // Update the spatial index, only the new nodes need to be sorted in
+    std::unordered_set<const INode*> currentNodes;
+    std::size_t order = 0;
+
+    for (const auto& node : _nodes)
+    {
+        currentNodes.insert(node.get());
+        _spatialIndex.insert(node, order++);
+    }
+
+    for (const auto& node : previousNodes)
+    {
+        if (currentNodes.count(node.get()) == 0)
         {
-            _nodes.emplace_back(std::make_shared<PatchNode>(*Node_getIPatch(node)));
+            _spatialIndex.remove(node);
         }
-    });
+    }
 }
 
-void TextureToolSceneGraph::clearFaceObservers()
+void TextureToolSceneGraph::clearNodes()
 {
-    for (auto& conn : _faceObservers)
+    for (auto& [face, entry] : _faceNodes)
     {
-        conn.disconnect();
+        entry.faceObserver.disconnect();
     }
 
-    _faceObservers.clear();
+    _faceNodes.clear();
+    _patchNodes.clear();
+    _spatialIndex.clear();
+    _nodes.clear();
 }
 
-void TextureToolSceneGraph::createFaceNode(IFace& face)
+void TextureToolSceneGraph::addFaceNode(IFace& face, std::unordered_map<IFace*, FaceNodeEntry>& previousFaceNodes)
 {
-    _nodes.emplace_back(std::make_shared<FaceNode>(face));
+    auto previous = previousFaceNodes.find(&face);
+
+    if (previous != previousFaceNodes.end() && previous->second.node->isUpToDate())
+    {
+        // Re-used nodes start out unselected, like newly created ones
+        auto node = previous->second.node;
+        node->setSelected(false);
+        node->clearComponentSelection();
+
+        _nodes.emplace_back(node);
+        _faceNodes.emplace(&face, std::move(previous->second));
+        previousFaceNodes.erase(previous);
+        return;
+    }
+
+    auto node = std::make_shared<FaceNode>(face);
+    _nodes.emplace_back(node);
+
+    // Faces selected as component and as part of their brush show up twice
+    if (_faceNodes.count(&face) > 0) return;
 
     // When faces are destroyed, the selection is out of date, queue a rescan
-    _faceObservers.emplace_back(face.signal_faceDestroyed().connect(
-        [this]() { _selectionNeedsRescan = true; }
-    ));
+    auto faceObserver = face.signal_faceDestroyed().connect([this, &face]()
+    {
+        _selectionNeedsRescan = true;
+
+        // The face won't be around anymore, make sure its node is not re-used
+        auto existing = _faceNodes.find(&face);
+
+        if (existing != _faceNodes.end())
+        {
+            _spatialIndex.remove(existing->second.node);
+            _faceNodes.erase(existing);
+        }
+    });
+
+    _faceNodes.emplace(&face, FaceNodeEntry{ node, faceObserver });
+}
+
+void TextureToolSceneGraph::addPatchNode(const scene::INodePtr& node, std::unordered_map<IPatch*, PatchNodeEntry>& previousPatchNodes)
+{
+    auto patch = Node_getIPatch(node);
+    auto previous = previousPatchNodes.find(patch);
+
+    if (previous != previousPatchNodes.end() &&
+        previous->second.sceneNode.lock() == node && previous->second.node->isUpToDate())
+    {
+        auto patchNode = previous->second.node;
+        patchNode->setSelected(false);
+        patchNode->clearComponentSelection();
+
+        _nodes.emplace_back(patchNode);
+        _patchNodes.emplace(patch, std::move(previous->second));
+        previousPatchNodes.erase(previous);
+        return;
+    }
+
+    auto patchNode = std::make_shared<PatchNode>(*patch);
+    _nodes.emplace_back(patchNode);
+    _patchNodes.emplace(patch, PatchNodeEntry{ patchNode, node });
 }
 
 void TextureToolSceneGraph::onSceneSelectionChanged(const ISelectable& selectable)
@@ -156,6 +259,12 @@ void TextureToolSceneGraph::onSceneSelectionChanged(const ISelectable& selectabl
 void TextureToolSceneGraph::onTextureChanged(radiant::TextureChangedMessage& msg)
 {
     _activeMaterialNeedsRescan = true;
+    _spatialIndex.invalidateBounds();
+}
+
+void TextureToolSceneGraph::onSceneBoundsChanged()
+{
+    _spatialIndex.invalidateBounds();
 }
 
 module::StaticModuleRegistration<TextureToolSceneGraph> _textureToolSceneGraphModule;
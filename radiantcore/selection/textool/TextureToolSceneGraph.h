@@ -1,25 +1,53 @@
 #pragma once
 
 #include <list>
+#include <unordered_map>
 #include <sigc++/connection.h>
 #include "itexturetoolmodel.h"
 #include "messages/TextureChanged.h"
+#include "SpatialIndex.h"
+
+class IFace;
+class IPatch;
 
 namespace textool
 {
 
+class FaceNode;
+class PatchNode;
+
 class TextureToolSceneGraph :
     public ITextureToolSceneGraph
 {
 private:
     sigc::connection _sceneSelectionChanged;
+    sigc::connection _sceneBoundsChanged;
     std::size_t _textureChangedHandler;
 
     bool _selectionNeedsRescan;
     bool _activeMaterialNeedsRescan;
 
     std::list<INode::Ptr> _nodes;
-    std::vector<sigc::connection> _faceObservers;
+
+    struct FaceNodeEntry
+    {
+        std::shared_ptr<FaceNode> node;
+        sigc::connection faceObserver;
+    };
+
+    struct PatchNodeEntry
+    {
+        std::shared_ptr<PatchNode> node;
+
+        // Used to detect patches that have been deleted in the meantime
+        scene::INodeWeakPtr sceneNode;
+    };
+
+    // The nodes of the last scan, to be re-used when the selection changes
+    std::unordered_map<IFace*, FaceNodeEntry> _faceNodes;
+    std::unordered_map<IPatch*, PatchNodeEntry> _patchNodes;
+
+    SpatialIndex _spatialIndex;
 
     // The single active material. Is empty if the scene graph has no items
     std::string _activeMaterial;
@@ -33,14 +61,18 @@ public:
     void shutdownModule() override;
 
     void foreachNode(const std::function<bool(const INode::Ptr&)>& functor) override;
+    void foreachNodeInVolume(const VolumeTest& volume, const std::function<bool(const INode::Ptr&)>& functor) override;
 
     const std::string& getActiveMaterial() override;
 
 private:
     void onSceneSelectionChanged(const ISelectable& selectable);
     void onTextureChanged(radiant::TextureChangedMessage& msg);
-    void createFaceNode(IFace& face);
-    void clearFaceObservers();
+    void onSceneBoundsChanged();
+
+    void addFaceNode(IFace& face, std::unordered_map<IFace*, FaceNodeEntry>& previousFaceNodes);
+    void addPatchNode(const scene::INodePtr& node, std::unordered_map<IPatch*, PatchNodeEntry>& previousPatchNodes);
+    void clearNodes();
 
     void ensureSceneIsAnalysed();
 };
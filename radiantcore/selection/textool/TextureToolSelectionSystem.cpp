@@ -549,7 +549,8 @@ void TextureToolSelectionSystem::selectArea(SelectionTest& test, selection::Sele
 
 void TextureToolSelectionSystem::performSelectionTest(Selector& selector, SelectionTest& test)
 {
-    GlobalTextureToolSceneGraph().foreachNode([&](const INode::Ptr& node)
+    // Only the nodes near the tested area need to be looked at
+    GlobalTextureToolSceneGraph().foreachNodeInVolume(test.getVolume(), [&](const INode::Ptr& node)
     {
         if (getSelectionMode() == SelectionMode::Surface)
         {
@@ -714,6 +715,8 @@ void TextureToolSelectionSystem::flipSelected(int axis)
 
     selection::algorithm::TextureFlipper flipper(flipCenter, axis);
     foreachSelectedNode(flipper);
+
+    radiant::TextureChangedMessage::Send();
 }
 
 void TextureToolSelectionSystem::flipVerticallyCmd(const cmd::ArgumentList& args)
@@ -749,6 +752,8 @@ void TextureToolSelectionSystem::normaliseSelectionCmd(const cmd::ArgumentList&
 
     selection::algorithm::TextureNormaliser normaliser(normaliseCenter);
     foreachSelectedNode(normaliser);
+
+    radiant::TextureChangedMessage::Send();
 }
 
 void TextureToolSelectionSystem::shiftSelectionCmd(const cmd::ArgumentList& args)
@@ -819,6 +824,8 @@ void TextureToolSelectionSystem::scaleSelectionCmd(const cmd::ArgumentList& args
     Vector2 pivot{ accumulator.getBounds().origin.x(), accumulator.getBounds().origin.y() };
     selection::algorithm::TextureScaler scaler(pivot, scale);
     foreachSelectedNode(scaler);
+
+    radiant::TextureChangedMessage::Send();
 }
 
 void TextureToolSelectionSystem::rotateSelectionCmd(const cmd::ArgumentList& args)
@@ -854,6 +861,8 @@ void TextureToolSelectionSystem::rotateSelectionCmd(const cmd::ArgumentList& arg
     Vector2 pivot{ accumulator.getBounds().origin.x(), accumulator.getBounds().origin.y() };
     selection::algorithm::TextureRotator rotator(pivot, angle, aspectRatio);
     foreachSelectedNode(rotator);
+
+    radiant::TextureChangedMessage::Send();
 }
 
 module::StaticModuleRegistration<TextureToolSelectionSystem> _textureToolSelectionSystemModule;
@@ -1,4 +1,7 @@
 #include "ColourSchemeManager.h"
+
+#include <map>
+#include <vector>
 #include "iregistry.h"
 #include "itextstream.h"
 #include "ieclasscolours.h"
@@ -225,14 +228,36 @@ void ColourSchemeManager::initialiseModule(const IApplicationContext& ctx)
 
 void ColourSchemeManager::emitEclassOverrides()
 {
-    auto& colourManager = GlobalEclassColourManager();
-    colourManager.clearOverrideColours();
-
-    // Apply the overrides for the known entity classes
     auto& activeScheme = getActiveScheme();
 
-    colourManager.addOverrideColour("worldspawn", activeScheme.getColour("default_brush").getColour());
-    colourManager.addOverrideColour("light", activeScheme.getColour("light_volumes").getColour());
+    std::map<std::string, Vector4> overrides
+    {
+        { "worldspawn", activeScheme.getColour("default_brush").getColour() },
+        { "light", activeScheme.getColour("light_volumes").getColour() },
+    };
+
+    // Only remove the overrides that are not part of the scheme, re-adding an
+    // unchanged override won't touch the entity class and the entities using it
+    auto& colourManager = GlobalEclassColourManager();
+    std::vector<std::string> obsoleteOverrides;
+
+    colourManager.foreachOverrideColour([&](const std::string& eclass, const Vector4&)
+    {
+        if (overrides.count(eclass) == 0)
+        {
+            obsoleteOverrides.push_back(eclass);
+        }
+    });
+
+    for (const auto& eclass : obsoleteOverrides)
+    {
+        colourManager.removeOverrideColour(eclass);
+    }
+
+    for (const auto& [eclass, colour] : overrides)
+    {
+        colourManager.addOverrideColour(eclass, colour);
+    }
 }
 
 module::StaticModuleRegistration<ColourSchemeManager> colourSchemeManagerModule;
@@ -5,6 +5,9 @@
 #include "iregistry.h"
 #include "ishaders.h"
 #include "texturelib.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+#include "string/predicate.h"
 #include "gamelib.h"
 #include "decl/DeclLib.h"
 #include "materials/ParseLib.h"
@@ -80,27 +83,33 @@ TexturePtr CShader::getEditorImage()
 {
     if (!_editorTexture)
     {
-        auto editorTex = _template->getEditorTexture();
+        // Pass the call to the GLTextureManager to realise this image
+        _editorTexture = GetTextureManager().getBinding(getEditorImageMapExpression());
+    }
+
+    return _editorTexture;
+}
+
+MapExpressionPtr CShader::getEditorImageMapExpression()
+{
+    auto editorTex = _template->getEditorTexture();
 
-        if (!editorTex)
+    if (editorTex)
+    {
+        return editorTex;
+    }
+
+    // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
+    for (const auto& layer : _template->getLayers())
+    {
+        if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
+            std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
         {
-            // If there is no editor expression defined, use the an image from a layer, but no Bump or speculars
-            for (const auto& layer : _template->getLayers())
-            {
-                if (layer->getType() != IShaderLayer::BUMP && layer->getType() != IShaderLayer::SPECULAR &&
-                    std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()))
-                {
-                    editorTex = std::static_pointer_cast<MapExpression>(layer->getMapExpression());
-                    break;
-                }
-            }
+            return std::static_pointer_cast<MapExpression>(layer->getMapExpression());
         }
-
-        // Pass the call to the GLTextureManager to realise this image
-        _editorTexture = GetTextureManager().getBinding(editorTex);
     }
 
-    return _editorTexture;
+    return MapExpressionPtr();
 }
 
 IMapExpression::Ptr CShader::getEditorImageExpression()
@@ -687,6 +696,65 @@ void CShader::refreshImageMaps()
     _sigMaterialModified.emit();
 }
 
+bool CShader::referencesImage(const std::string& imageName) const
+{
+    bool found = false;
+
+    auto checkExpression = [&](const MapExpressionPtr& expression)
+    {
+        if (!expression || found) return;
+
+        expression->foreachImageName([&](const std::string& name)
+        {
+            auto normalisedName = string::to_lower_copy(os::removeExtension(os::standardPath(name)));
+
+            if (imageName == normalisedName || string::ends_with(imageName, "/" + normalisedName))
+            {
+                found = true;
+            }
+        });
+    };
+
+    checkExpression(_template->getEditorTexture());
+    checkExpression(_template->getLightFalloff());
+
+    for (const auto& layer : _template->getLayers())
+    {
+        checkExpression(std::dynamic_pointer_cast<MapExpression>(layer->getMapExpression()));
+    }
+
+    return found;
+}
+
+void CShader::preloadImages()
+{
+    // The uploaded editor image is picked up by the next getEditorImage() call
+    if (!_editorTexture)
+    {
+        GetTextureManager().getBindingAsync(getEditorImageMapExpression(), BindableTexture::Role::COLOUR, TexturePtr());
+    }
+
+    for (const auto& layer : _template->getLayers())
+    {
+        layer->getTexture();
+    }
+}
+
+void CShader::onTexturesLoaded(const std::set<std::string>& identifiers)
+{
+    bool texturesChanged = false;
+
+    for (const auto& layer : _template->getLayers())
+    {
+        texturesChanged |= layer->onTexturesLoaded(identifiers);
+    }
+
+    if (texturesChanged)
+    {
+        _sigMaterialModified.emit();
+    }
+}
+
 Material::ParseResult CShader::updateFromSourceText(const std::string& sourceText)
 {
     ensureTemplateCopy();
@@ -2,6 +2,7 @@
 
 #include "ShaderTemplate.h"
 #include <sigc++/connection.h>
+#include <set>
 #include <memory>
 
 namespace shaders {
@@ -58,6 +59,10 @@ public:
     void setPolygonOffset(float offset) override;
 	TexturePtr getEditorImage() override;
     IMapExpression::Ptr getEditorImageExpression() override;
+
+    // Returns the expression the editor image is generated from. This is the
+    // editorimage expression if there is one, or the first suitable layer map.
+    MapExpressionPtr getEditorImageMapExpression();
     void setEditorImageExpressionFromString(const std::string& editorImagePath) override;
 	bool isEditorImageNoTex() override;
 	TexturePtr lightFalloffImage() override;
@@ -154,6 +159,18 @@ public:
 
     void refreshImageMaps() override;
 
+    // True if any map expression of this material reads the given image, which is
+    // a lowercase VFS path without extension. Images loaded from the dds/ folder
+    // are matched by the path following that folder.
+    bool referencesImage(const std::string& imageName) const;
+
+    // Notifies the observers if any layer texture is among the given textures loaded in the background
+    void onTexturesLoaded(const std::set<std::string>& identifiers);
+
+    // Queues the editor image and the layer images for background decoding,
+    // requires the texture manager's async loading to be enabled
+    void preloadImages();
+
     ParseResult updateFromSourceText(const std::string& sourceText) override;
 
     // Returns the current template (including any modifications) of this material
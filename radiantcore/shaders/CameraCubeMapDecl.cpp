@@ -3,6 +3,7 @@
 #include "debugging/gl.h"
 #include "itextstream.h"
 #include <stdexcept>
+#include <vector>
 
 namespace shaders
 {
@@ -19,11 +20,9 @@ NamedBindablePtr CameraCubeMapDecl::createForPrefix(const std::string& prefix)
 }
 
 // Bind directional image
-void CameraCubeMapDecl::bindDirection(const std::string& dir,
+void CameraCubeMapDecl::bindDirection(const ImagePtr& img, const std::string& dir,
                                       GLuint glDir) const
 {
-    // Load the image
-    ImagePtr img = GlobalImageLoader().imageFromVFS(_prefix + dir);
     if (!img)
     {
         throw std::runtime_error(
@@ -62,7 +61,17 @@ std::string CameraCubeMapDecl::getExpressionString()
 TexturePtr CameraCubeMapDecl::bindTexture(const std::string& name,
                                           Role /* role */) const
 {
-    // Load the six images from the prefix
+    // Load the six images from the prefix, they're decoded in parallel
+    const std::vector<std::string> directions = { "_right", "_left", "_up", "_down", "_forward", "_back" };
+    std::vector<std::string> paths;
+
+    for (const auto& dir : directions)
+    {
+        paths.emplace_back(_prefix + dir);
+    }
+
+    auto images = GlobalImageLoader().imagesFromVFS(paths);
+
     try
     {
         // Allocate the GL texture
@@ -82,12 +91,12 @@ TexturePtr CameraCubeMapDecl::bindTexture(const std::string& name,
         );
 
         // Bind the images
-        bindDirection("_right", GL_TEXTURE_CUBE_MAP_POSITIVE_X);
-        bindDirection("_left", GL_TEXTURE_CUBE_MAP_NEGATIVE_X);
-        bindDirection("_up", GL_TEXTURE_CUBE_MAP_POSITIVE_Y);
-        bindDirection("_down", GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
-        bindDirection("_forward", GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
-        bindDirection("_back", GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
+        bindDirection(images[0], directions[0], GL_TEXTURE_CUBE_MAP_POSITIVE_X);
+        bindDirection(images[1], directions[1], GL_TEXTURE_CUBE_MAP_NEGATIVE_X);
+        bindDirection(images[2], directions[2], GL_TEXTURE_CUBE_MAP_POSITIVE_Y);
+        bindDirection(images[3], directions[3], GL_TEXTURE_CUBE_MAP_NEGATIVE_Y);
+        bindDirection(images[4], directions[4], GL_TEXTURE_CUBE_MAP_POSITIVE_Z);
+        bindDirection(images[5], directions[5], GL_TEXTURE_CUBE_MAP_NEGATIVE_Z);
 
         rMessage() << "[shaders] bound cubemap texture " << texnum << std::endl;
 
@@ -182,12 +182,30 @@ TexturePtr Doom3ShaderLayer::getTexture() const
             _type == BUMP ? BindableTexture::Role::NORMAL_MAP
                           : BindableTexture::Role::COLOUR
         );
-        _texture = GetTextureManager().getBinding(_bindableTex, role);
+
+        // Images are decoded in the background if enabled, the default
+        // interaction textures are filling in until they are uploaded
+        auto placeholder = GetShaderSystem()->getDefaultInteractionTexture(
+            _type == BUMP ? IShaderLayer::BUMP : IShaderLayer::DIFFUSE
+        );
+        _texture = GetTextureManager().getBindingAsync(_bindableTex, role, placeholder);
     }
 
     return _texture;
 }
 
+bool Doom3ShaderLayer::onTexturesLoaded(const std::set<std::string>& identifiers)
+{
+    if (!_texture || !_bindableTex || identifiers.count(_bindableTex->getIdentifier()) == 0)
+    {
+        return false;
+    }
+
+    // The next getTexture() call picks up the loaded texture
+    _texture.reset();
+    return true;
+}
+
 void Doom3ShaderLayer::refreshImageMaps()
 {
     if (_bindableTex)
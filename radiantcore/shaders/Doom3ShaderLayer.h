@@ -1,5 +1,6 @@
 #pragma once
 
+#include <set>
 #include <vector>
 #include "ishaders.h"
 
@@ -107,6 +108,11 @@ public:
     /* IShaderLayer implementation */
     TexturePtr getTexture() const;
     void refreshImageMaps();
+
+    // Drops the placeholder texture if the texture of this layer has been
+    // loaded in the background. Returns true if that has been the case.
+    bool onTexturesLoaded(const std::set<std::string>& identifiers);
+
     BlendFunc getBlendFunc() const;
     Colour4 getColour() const;
     VertexColourMode getVertexColourMode() const;
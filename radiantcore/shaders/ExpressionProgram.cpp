@@ -0,0 +1,146 @@
+#include "ExpressionProgram.h"
+
+#include <cmath>
+#include "irender.h"
+#include "ishaders.h"
+
+namespace shaders
+{
+
+std::size_t ExpressionProgram::addConstant(float value)
+{
+    Instruction instruction{ OpCode::Constant, 0, 0 };
+    instruction.constant = value;
+    instruction.table = nullptr;
+
+    return add(instruction);
+}
+
+std::size_t ExpressionProgram::addTime()
+{
+    Instruction instruction{ OpCode::Time, 0, 0 };
+    instruction.parmNum = 0;
+    instruction.table = nullptr;
+
+    return add(instruction);
+}
+
+std::size_t ExpressionProgram::addParm(OpCode opCode, int parmNum)
+{
+    Instruction instruction{ opCode, 0, 0 };
+    instruction.parmNum = parmNum;
+    instruction.table = nullptr;
+
+    return add(instruction);
+}
+
+std::size_t ExpressionProgram::addTableLookup(ITableDefinition& table, std::size_t lookup)
+{
+    if (lookup == InvalidIndex) return InvalidIndex;
+
+    Instruction instruction{ OpCode::TableLookup, static_cast<std::uint16_t>(lookup), 0 };
+    instruction.parmNum = 0;
+    instruction.table = &table;
+
+    return add(instruction);
+}
+
+std::size_t ExpressionProgram::addOperation(OpCode opCode, std::size_t a, std::size_t b)
+{
+    if (a == InvalidIndex || b == InvalidIndex) return InvalidIndex;
+
+    Instruction instruction{ opCode, static_cast<std::uint16_t>(a), static_cast<std::uint16_t>(b) };
+    instruction.parmNum = 0;
+    instruction.table = nullptr;
+
+    return add(instruction);
+}
+
+std::size_t ExpressionProgram::add(const Instruction& instruction)
+{
+    // The operand indices are limited to 16 bits
+    if (_instructions.size() >= std::numeric_limits<std::uint16_t>::max())
+    {
+        return InvalidIndex;
+    }
+
+    _instructions.push_back(instruction);
+    _values.resize(_instructions.size());
+
+    return _instructions.size() - 1;
+}
+
+float ExpressionProgram::evaluate(std::size_t time, const IRenderEntity* entity) const
+{
+    auto values = _values.data();
+    auto count = _instructions.size();
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto& instr = _instructions[i];
+
+        // The operations produce the same values as the getValue() methods of the tree
+        switch (instr.opCode)
+        {
+        case OpCode::Constant:
+            values[i] = instr.constant;
+            break;
+        case OpCode::Time:
+            values[i] = time / 1000.0f; // convert msecs to secs
+            break;
+        case OpCode::ShaderParm:
+            // Without entity the RGBA parms [0-3] default to 1.0, the rest to 0
+            values[i] = entity != nullptr ? entity->getShaderParm(instr.parmNum) : (instr.parmNum < 4 ? 1.0f : 0.0f);
+            break;
+        case OpCode::GlobalParm:
+            values[i] = 0.0f;
+            break;
+        case OpCode::TableLookup:
+            values[i] = instr.table->getValue(values[instr.a]);
+            break;
+        case OpCode::Add:
+            values[i] = values[instr.a] + values[instr.b];
+            break;
+        case OpCode::Subtract:
+            values[i] = values[instr.a] - values[instr.b];
+            break;
+        case OpCode::Multiply:
+            values[i] = values[instr.a] * values[instr.b];
+            break;
+        case OpCode::Divide:
+            values[i] = values[instr.a] / values[instr.b];
+            break;
+        case OpCode::Modulo:
+            values[i] = fmod(values[instr.a], values[instr.b]);
+            break;
+        case OpCode::LessThan:
+            values[i] = values[instr.a] < values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::LessThanOrEqual:
+            values[i] = values[instr.a] <= values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::GreaterThan:
+            values[i] = values[instr.a] > values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::GreaterThanOrEqual:
+            values[i] = values[instr.a] >= values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::Equal:
+            values[i] = values[instr.a] == values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::NotEqual:
+            values[i] = values[instr.a] != values[instr.b] ? 1.0f : 0;
+            break;
+        case OpCode::LogicalAnd:
+            values[i] = (values[instr.a] != 0 && values[instr.b] != 0) ? 1.0f : 0;
+            break;
+        case OpCode::LogicalOr:
+            values[i] = (values[instr.a] != 0 || values[instr.b] != 0) ? 1.0f : 0;
+            break;
+        }
+    }
+
+    return count > 0 ? values[count - 1] : 0.0f;
+}
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+class IRenderEntity;
+class ITableDefinition;
+
+namespace shaders
+{
+
+/**
+ * Flat representation of a shader expression tree, as compiled by
+ * ShaderExpression::compile(). The nodes are stored in post-order, such that
+ * every instruction only refers to the results of the instructions before it.
+ * Evaluating the program is a single loop over the instructions, without
+ * any of the virtual calls needed to walk the tree.
+ *
+ * The result of each instruction is stored in the value slot of the same
+ * index, the last instruction produces the result of the whole expression.
+ */
+class ExpressionProgram
+{
+public:
+    enum class OpCode : std::uint8_t
+    {
+        Constant,
+        Time,
+        ShaderParm,
+        GlobalParm,
+        TableLookup,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        LessThan,
+        LessThanOrEqual,
+        GreaterThan,
+        GreaterThanOrEqual,
+        Equal,
+        NotEqual,
+        LogicalAnd,
+        LogicalOr,
+    };
+
+    struct Instruction
+    {
+        OpCode opCode;
+
+        // The indices of the operand instructions
+        std::uint16_t a;
+        std::uint16_t b;
+
+        // The constant value or the parm number
+        union
+        {
+            float constant;
+            int parmNum;
+        };
+
+        // The table used by TableLookup, the operand a is the lookup value
+        ITableDefinition* table;
+    };
+
+    // Returned by the compile methods if an expression cannot be flattened
+    static constexpr std::size_t InvalidIndex = std::numeric_limits<std::size_t>::max();
+
+private:
+    std::vector<Instruction> _instructions;
+
+    // Scratch space holding the result of each instruction
+    mutable std::vector<float> _values;
+
+public:
+    bool empty() const
+    {
+        return _instructions.empty();
+    }
+
+    std::size_t size() const
+    {
+        return _instructions.size();
+    }
+
+    // The add methods return the index of the new instruction, or InvalidIndex
+    // if one of the operands is invalid or the program is growing too large
+    std::size_t addConstant(float value);
+    std::size_t addTime();
+
+    // Adds a ShaderParm or GlobalParm instruction
+    std::size_t addParm(OpCode opCode, int parmNum);
+
+    std::size_t addTableLookup(ITableDefinition& table, std::size_t lookup);
+
+    // Adds an instruction combining the results of the two given instructions
+    std::size_t addOperation(OpCode opCode, std::size_t a, std::size_t b);
+
+    // Runs the program, the entity is optional and providing the shader parms
+    float evaluate(std::size_t time, const IRenderEntity* entity) const;
+
+private:
+    std::size_t add(const Instruction& instruction);
+};
+
+}
@@ -5,6 +5,7 @@
 #include "imodule.h"
 
 #include <iostream>
+#include <future>
 
 #include "os/path.h"
 #include "string/convert.h"
@@ -13,10 +14,11 @@
 #include "fmt/format.h"
 
 #include "RGBAImage.h"
-#include "textures/HeightmapCreator.h"
+#include "textures/NormalMapKernels.h"
 #include "textures/TextureManipulator.h"
 #include "string/predicate.h"
 #include "ShaderTemplate.h"
+#include "MapExpressionCache.h"
 
 /* CONSTANTS */
 namespace
@@ -110,6 +112,47 @@ MapExpressionPtr MapExpression::createForString(const std::string& str)
     }
 }
 
+ImagePtr MapExpression::getImage() const
+{
+    if (!isMemoised())
+    {
+        return evaluateImage();
+    }
+
+    // The top-level image is handed over to the texture, which keeps its own copy,
+    // so only reuse an existing image without storing a new one
+    auto image = MapExpressionCache::Instance().findImage(getIdentifier());
+
+    return image ? image : evaluateImage();
+}
+
+void MapExpression::ClearImageCache()
+{
+    MapExpressionCache::Instance().clear();
+}
+
+ImagePtr MapExpression::getChildImage(const MapExpressionPtr& child)
+{
+    if (!child->isMemoised())
+    {
+        return child->evaluateImage();
+    }
+
+    return MapExpressionCache::Instance().getImage(child->getIdentifier(), [&]()
+    {
+        return child->evaluateImage();
+    });
+}
+
+std::pair<ImagePtr, ImagePtr> MapExpression::getChildImages(const MapExpressionPtr& one, const MapExpressionPtr& two)
+{
+    // Evaluate the second branch on another thread while this one is processing the first
+    auto imageTwo = std::async(std::launch::async, [&]() { return getChildImage(two); });
+    auto imageOne = getChildImage(one);
+
+    return std::make_pair(imageOne, imageTwo.get());
+}
+
 ImagePtr MapExpression::getResampled(const ImagePtr& input, std::size_t width, std::size_t height)
 {
 	// Don't process precompressed images
@@ -146,9 +189,9 @@ HeightMapExpression::HeightMapExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr HeightMapExpression::getImage() const {
+ImagePtr HeightMapExpression::evaluateImage() const {
 	// Get the heightmap from the contained expression
-	ImagePtr heightMap = heightMapExp->getImage();
+	ImagePtr heightMap = getChildImage(heightMapExp);
 
 	if (heightMap == NULL) return ImagePtr();
 
@@ -169,6 +212,11 @@ std::string HeightMapExpression::getIdentifier() const {
 	return identifier;
 }
 
+void HeightMapExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    heightMapExp->foreachImageName(functor);
+}
+
 std::string HeightMapExpression::getExpressionString()
 {
     return fmt::format("heightmap({0}, {1})", heightMapExp->getExpressionString(), scale);
@@ -182,18 +230,14 @@ AddNormalsExpression::AddNormalsExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr AddNormalsExpression::getImage() const {
-    ImagePtr imgOne = mapExpOne->getImage();
+ImagePtr AddNormalsExpression::evaluateImage() const {
+    auto [imgOne, imgTwo] = getChildImages(mapExpOne, mapExpTwo);
 
-    if (imgOne == NULL) return ImagePtr();
+    if (imgOne == NULL || imgTwo == NULL) return ImagePtr();
 
     std::size_t width = imgOne->getWidth();
     std::size_t height = imgOne->getHeight();
 
-    ImagePtr imgTwo = mapExpTwo->getImage();
-
-    if (imgTwo == NULL) return ImagePtr();
-
 	// Don't process precompressed images
 	if (imgOne->isPrecompressed() || imgTwo->isPrecompressed()) {
 		rWarning() << "Cannot evaluate map expression with precompressed texture." << std::endl;
@@ -203,43 +247,7 @@ ImagePtr AddNormalsExpression::getImage() const {
 	// The image must match the dimensions of the first
 	imgTwo = getResampled(imgTwo, width, height);
 
-    ImagePtr result (new image::RGBAImage(width, height));
-
-    byte* pixOne = imgOne->getPixels();
-    byte* pixTwo = imgTwo->getPixels();
-    byte* pixOut = result->getPixels();
-
-    // iterate through the pixels
-    for( std::size_t y = 0; y < height; y++ )
-	{
-		for( std::size_t x = 0; x < width; x++ )
-		{
-			// create the two vectors
-			Vector3 vectorOne(
-    			static_cast<double>(pixOne[0]),
-    			static_cast<double>(pixOne[1]),
-    			static_cast<double>(pixOne[2])
-			);
-			Vector3 vectorTwo(
-    			static_cast<double>(pixTwo[0]),
-    			static_cast<double>(pixTwo[1]),
-    			static_cast<double>(pixTwo[2])
-			);
-			// Take the mean value of the two vectors
-			Vector3 vectorOut = (vectorOne + vectorTwo) * 0.5;
-
-			pixOut[0] = static_cast<byte>(float_to_integer(vectorOut.x()));
-			pixOut[1] = static_cast<byte>(float_to_integer(vectorOut.y()));
-			pixOut[2] = static_cast<byte>(float_to_integer(vectorOut.z()));
-			pixOut[3] = 255;
-
-			// advance the pixel pointer
-			pixOne += 4;
-			pixTwo += 4;
-			pixOut += 4;
-		}
-    }
-    return result;
+    return addNormalmaps(imgOne, imgTwo);
 }
 
 std::string AddNormalsExpression::getIdentifier() const {
@@ -248,6 +256,12 @@ std::string AddNormalsExpression::getIdentifier() const {
 	return identifier;
 }
 
+void AddNormalsExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExpOne->foreachImageName(functor);
+    mapExpTwo->foreachImageName(functor);
+}
+
 std::string AddNormalsExpression::getExpressionString()
 {
     return fmt::format("addnormals({0}, {1})", mapExpOne->getExpressionString(), mapExpTwo->getExpressionString());
@@ -259,9 +273,9 @@ SmoothNormalsExpression::SmoothNormalsExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr SmoothNormalsExpression::getImage() const {
+ImagePtr SmoothNormalsExpression::evaluateImage() const {
 
-	ImagePtr normalMap = mapExp->getImage();
+	ImagePtr normalMap = getChildImage(mapExp);
 
 	if (normalMap == NULL) return ImagePtr();
 
@@ -271,62 +285,7 @@ ImagePtr SmoothNormalsExpression::getImage() const {
 		return normalMap;
 	}
 
-	std::size_t width = normalMap->getWidth();
-	std::size_t height = normalMap->getHeight();
-
-	ImagePtr result (new image::RGBAImage(width, height));
-
-	byte* in = normalMap->getPixels();
-	byte* out = result->getPixels();
-
-	struct KernelElement {
-		// offset to the current pixel
-		int dx, dy;
-	};
-
-	// a 3x3 kernel with the surrounding pixels including the pixel itself
-	const int kernelSize = 9;
-	KernelElement kernel[kernelSize] = {
-		{-1, -1 },
-		{ 0, -1 },
-		{ 1, -1 },
-		{ 1,  0 },
-		{ 1,  1 },
-		{ 0,  1 },
-		{-1,  1 },
-		{-1,  0 },
-		{ 0,  0 }
-	};
-	const float perKernelSize = 1.0f/kernelSize;
-
-	// iterate through the pixels
-	for( std::size_t y = 0; y < height; y++) {
-		for( std::size_t x = 0; x < width; x++) {
-			//the new normal vector for this pixel
-			Vector3 smoothVector(0,0,0);
-
-			// calculate the average direction of the surrounding vectors
-			for (KernelElement* i = kernel; i != kernel + kernelSize; ++i) {
-				// temporary vector to represent one of the surrounding pixels
-				byte* pixel = getPixel(in, width, height, x + i->dx, y + i->dy);
-				Vector3 temp(pixel[0], pixel[1], pixel[2]);
-
-				smoothVector += temp;
-			}
-
-			// Take the average normal vector as result
-			smoothVector *= perKernelSize;
-
-			out[0] = static_cast<byte>(float_to_integer(smoothVector.x()));
-			out[1] = static_cast<byte>(float_to_integer(smoothVector.y()));
-			out[2] = static_cast<byte>(float_to_integer(smoothVector.z()));
-			out[3] = 255;
-
-			// advance the pixel pointer
-			out += 4;
-	    }
-	}
-    return result;
+	return smoothNormalmap(normalMap);
 }
 
 std::string SmoothNormalsExpression::getIdentifier() const {
@@ -335,6 +294,11 @@ std::string SmoothNormalsExpression::getIdentifier() const {
 	return identifier;
 }
 
+void SmoothNormalsExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string SmoothNormalsExpression::getExpressionString()
 {
     return fmt::format("smoothnormals({0})", mapExp->getExpressionString());
@@ -348,18 +312,14 @@ AddExpression::AddExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr AddExpression::getImage() const {
-    ImagePtr imgOne = mapExpOne->getImage();
+ImagePtr AddExpression::evaluateImage() const {
+    auto [imgOne, imgTwo] = getChildImages(mapExpOne, mapExpTwo);
 
-    if (imgOne == NULL) return ImagePtr();
+    if (imgOne == NULL || imgTwo == NULL) return ImagePtr();
 
     std::size_t width = imgOne->getWidth();
     std::size_t height = imgOne->getHeight();
 
-	ImagePtr imgTwo = mapExpTwo->getImage();
-
-	if (imgTwo == NULL) return ImagePtr();
-
 	// Don't process precompressed images
 	if (imgOne->isPrecompressed() || imgTwo->isPrecompressed()) {
 		rWarning() << "Cannot evaluate map expression with precompressed texture." << std::endl;
@@ -402,6 +362,12 @@ std::string AddExpression::getIdentifier() const
 	return identifier;
 }
 
+void AddExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExpOne->foreachImageName(functor);
+    mapExpTwo->foreachImageName(functor);
+}
+
 std::string AddExpression::getExpressionString()
 {
     return fmt::format("add({0}, {1})", mapExpOne->getExpressionString(), mapExpTwo->getExpressionString());
@@ -431,9 +397,9 @@ ScaleExpression::ScaleExpression(DefTokeniser& token) :
 	token.assertNextToken(")");
 }
 
-ImagePtr ScaleExpression::getImage() const
+ImagePtr ScaleExpression::evaluateImage() const
 {
-    ImagePtr img = mapExp->getImage();
+    ImagePtr img = getChildImage(mapExp);
 
     if (img == NULL) return ImagePtr();
 
@@ -488,6 +454,11 @@ std::string ScaleExpression::getIdentifier() const {
 	return identifier;
 }
 
+void ScaleExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string ScaleExpression::getExpressionString()
 {
     auto scaleAlphaStr = scaleAlpha == 0 ? std::string() : fmt::format(", {0}", scaleAlpha);
@@ -503,8 +474,8 @@ InvertAlphaExpression::InvertAlphaExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr InvertAlphaExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+ImagePtr InvertAlphaExpression::evaluateImage() const {
+	ImagePtr img = getChildImage(mapExp);
 
 	if (img == NULL) return ImagePtr();
 
@@ -547,6 +518,11 @@ std::string InvertAlphaExpression::getIdentifier() const {
 	return identifier;
 }
 
+void InvertAlphaExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string InvertAlphaExpression::getExpressionString()
 {
     return fmt::format("invertAlpha({0})", mapExp->getExpressionString());
@@ -558,8 +534,8 @@ InvertColorExpression::InvertColorExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr InvertColorExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+ImagePtr InvertColorExpression::evaluateImage() const {
+	ImagePtr img = getChildImage(mapExp);
 
 	if (img == NULL) return ImagePtr();
 
@@ -600,6 +576,11 @@ std::string InvertColorExpression::getIdentifier() const {
 	return identifier;
 }
 
+void InvertColorExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string InvertColorExpression::getExpressionString()
 {
     return fmt::format("invertColor({0})", mapExp->getExpressionString());
@@ -611,8 +592,8 @@ MakeIntensityExpression::MakeIntensityExpression (DefTokeniser& token) {
 	token.assertNextToken(")");
 }
 
-ImagePtr MakeIntensityExpression::getImage() const {
-	ImagePtr img = mapExp->getImage();
+ImagePtr MakeIntensityExpression::evaluateImage() const {
+	ImagePtr img = getChildImage(mapExp);
 
 	if (img == NULL) return ImagePtr();
 
@@ -656,6 +637,11 @@ std::string MakeIntensityExpression::getIdentifier() const
 	return identifier;
 }
 
+void MakeIntensityExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string MakeIntensityExpression::getExpressionString()
 {
     return fmt::format("makeIntensity({0})", mapExp->getExpressionString());
@@ -668,9 +654,9 @@ MakeAlphaExpression::MakeAlphaExpression(DefTokeniser& token)
 	token.assertNextToken(")");
 }
 
-ImagePtr MakeAlphaExpression::getImage() const
+ImagePtr MakeAlphaExpression::evaluateImage() const
 {
-	ImagePtr img = mapExp->getImage();
+	ImagePtr img = getChildImage(mapExp);
 
 	if (img == NULL) return ImagePtr();
 
@@ -714,6 +700,11 @@ std::string MakeAlphaExpression::getIdentifier() const
 	return identifier;
 }
 
+void MakeAlphaExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    mapExp->foreachImageName(functor);
+}
+
 std::string MakeAlphaExpression::getExpressionString()
 {
     return fmt::format("makeAlpha({0})", mapExp->getExpressionString());
@@ -728,7 +719,7 @@ ImageExpression::ImageExpression(const std::string& imgName) :
     // it is normalised and stripped of its extension by the GlobalImageLoader()
 }
 
-ImagePtr ImageExpression::getImage() const
+ImagePtr ImageExpression::evaluateImage() const
 {
 	// Check for some image keywords and load the correct file
 	if (_imgName == "_black") {
@@ -813,6 +804,11 @@ std::string ImageExpression::getIdentifier() const
 	return _imgName;
 }
 
+void ImageExpression::foreachImageName(const std::function<void(const std::string&)>& functor) const
+{
+    functor(_imgName);
+}
+
 std::string ImageExpression::getExpressionString()
 {
     return _imgName;
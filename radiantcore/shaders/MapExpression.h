@@ -2,7 +2,9 @@
 
 #include <string>
 
+#include <functional>
 #include <memory>
+#include <utility>
 
 #include "ishaderexpression.h"
 #include "NamedBindable.h"
@@ -46,8 +48,18 @@ public:
             return TexturePtr();
     }
 
-    // Abstract method to be implemented
-    virtual ImagePtr getImage() const = 0;
+    /**
+     * Returns the image generated by this expression. The images of nested
+     * expressions are memoised by the MapExpressionCache, such that
+     * sub-expressions shared by several materials are evaluated only once.
+     */
+    ImagePtr getImage() const;
+
+    // Invokes the functor with the name of each image this expression is reading
+    virtual void foreachImageName(const std::function<void(const std::string&)>& functor) const = 0;
+
+    // Discards the memoised images, to be called when the image files have been changed
+    static void ClearImageCache();
 
 public: /* STATIC CONSTRUCTION METHODS */
 
@@ -70,6 +82,21 @@ protected:
 	 * @returns: the resampled image, this might as well be input.
 	 */
 	static ImagePtr getResampled(const ImagePtr& input, std::size_t width, std::size_t height);
+
+    // Generates the image from the sources, to be implemented by subclasses
+    virtual ImagePtr evaluateImage() const = 0;
+
+    // Whether the image of this expression should be memoised
+    virtual bool isMemoised() const
+    {
+        return true;
+    }
+
+    // Returns the (memoised) image of the given nested expression
+    static ImagePtr getChildImage(const MapExpressionPtr& child);
+
+    // Returns the images of the two given nested expressions, evaluating them in parallel
+    static std::pair<ImagePtr, ImagePtr> getChildImages(const MapExpressionPtr& one, const MapExpressionPtr& two);
 };
 
 // the specific MapExpressions
@@ -80,9 +107,11 @@ class HeightMapExpression :
 	float scale;
 public:
 	HeightMapExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class AddNormalsExpression :
@@ -92,9 +121,11 @@ class AddNormalsExpression :
 	MapExpressionPtr mapExpTwo;
 public:
 	AddNormalsExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class SmoothNormalsExpression :
@@ -103,9 +134,11 @@ class SmoothNormalsExpression :
 	MapExpressionPtr mapExp;
 public:
 	SmoothNormalsExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class AddExpression : public MapExpression {
@@ -113,9 +146,11 @@ class AddExpression : public MapExpression {
 	MapExpressionPtr mapExpTwo;
 public:
 	AddExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class ScaleExpression :
@@ -128,9 +163,11 @@ class ScaleExpression :
 	float scaleAlpha;
 public:
 	ScaleExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class InvertAlphaExpression :
@@ -139,9 +176,11 @@ class InvertAlphaExpression :
 	MapExpressionPtr mapExp;
 public:
 	InvertAlphaExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class InvertColorExpression :
@@ -150,9 +189,11 @@ class InvertColorExpression :
 	MapExpressionPtr mapExp;
 public:
 	InvertColorExpression(DefTokeniser& token);
-	ImagePtr getImage() const;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class MakeIntensityExpression :
@@ -161,9 +202,11 @@ class MakeIntensityExpression :
 	MapExpressionPtr mapExp;
 public:
 	MakeIntensityExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 class MakeAlphaExpression :
@@ -172,9 +215,11 @@ class MakeAlphaExpression :
 	MapExpressionPtr mapExp;
 public:
 	MakeAlphaExpression(DefTokeniser& token);
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
 };
 
 /**
@@ -192,9 +237,17 @@ private:
 public:
 	ImageExpression(const std::string& imgName);
 
-	ImagePtr getImage() const override;
+	void foreachImageName(const std::function<void(const std::string&)>& functor) const override;
 	std::string getIdentifier() const override;
     std::string getExpressionString() override;
+protected:
+	ImagePtr evaluateImage() const override;
+
+	// Plain images are not worth the memory, only the results of the expressions are kept
+	bool isMemoised() const override
+	{
+		return false;
+	}
 };
 
 } // namespace shaders
@@ -0,0 +1,151 @@
+#include "MapExpressionCache.h"
+
+namespace shaders
+{
+
+namespace
+{
+    // The memory held by the cache used for the map expressions
+    constexpr std::size_t DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+    std::size_t getImageSize(const Image& image)
+    {
+        // Compressed images use up to one byte per pixel, the uncompressed ones are RGBA
+        return image.getWidth() * image.getHeight() * (image.isPrecompressed() ? 1 : 4);
+    }
+}
+
+MapExpressionCache::MapExpressionCache(std::size_t capacity) :
+    _capacity(capacity),
+    _size(0),
+    _generation(0)
+{}
+
+ImagePtr MapExpressionCache::getImage(const std::string& identifier, const std::function<ImagePtr()>& evaluate)
+{
+    std::promise<ImagePtr> promise;
+    std::size_t generation;
+
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+
+        auto existing = _images.find(identifier);
+
+        if (existing != _images.end())
+        {
+            // Move the image to the front of the usage list
+            _usage.splice(_usage.begin(), _usage, existing->second.usage);
+            return existing->second.image;
+        }
+
+        auto pending = _pendingImages.find(identifier);
+
+        if (pending != _pendingImages.end())
+        {
+            auto future = pending->second;
+            lock.unlock();
+
+            return future.get();
+        }
+
+        _pendingImages.emplace(identifier, promise.get_future().share());
+        generation = _generation;
+    }
+
+    ImagePtr image;
+
+    try
+    {
+        image = evaluate();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        promise.set_exception(std::current_exception());
+
+        if (generation == _generation)
+        {
+            _pendingImages.erase(identifier);
+        }
+
+        throw;
+    }
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    promise.set_value(image);
+
+    // After a clear() the pending entry might belong to a newer evaluation
+    if (generation == _generation)
+    {
+        _pendingImages.erase(identifier);
+
+        if (image)
+        {
+            insert(identifier, image);
+        }
+    }
+
+    return image;
+}
+
+ImagePtr MapExpressionCache::findImage(const std::string& identifier)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto existing = _images.find(identifier);
+
+    if (existing == _images.end()) return ImagePtr();
+
+    _usage.splice(_usage.begin(), _usage, existing->second.usage);
+    return existing->second.image;
+}
+
+void MapExpressionCache::insert(const std::string& identifier, const ImagePtr& image)
+{
+    auto size = getImageSize(*image);
+
+    if (size > _capacity) return;
+
+    // Evict the least recently used images until the new one fits
+    while (!_usage.empty() && _size + size > _capacity)
+    {
+        auto oldest = _images.find(_usage.back());
+
+        _size -= oldest->second.size;
+        _images.erase(oldest);
+        _usage.pop_back();
+    }
+
+    _usage.push_front(identifier);
+    _images.emplace(identifier, Entry{ image, size, _usage.begin() });
+    _size += size;
+}
+
+void MapExpressionCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _images.clear();
+    _usage.clear();
+    _size = 0;
+
+    // Running evaluations might be using outdated images
+    _pendingImages.clear();
+    ++_generation;
+}
+
+std::size_t MapExpressionCache::getSize()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _size;
+}
+
+MapExpressionCache& MapExpressionCache::Instance()
+{
+    static MapExpressionCache _instance(DEFAULT_CAPACITY);
+    return _instance;
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <functional>
+#include <future>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include "iimage.h"
+
+namespace shaders
+{
+
+/**
+ * Memoises the images generated by map expressions, keyed by the expression
+ * identifier, such that sub-expressions shared by several materials (or
+ * several layers of the same material) are only evaluated once.
+ *
+ * The cache holds at most the given amount of pixel data, the least recently
+ * used images are evicted first. Concurrent requests for an image which is
+ * evaluated right now are waiting for that evaluation instead of starting
+ * another one. Access is synchronised, the expressions are evaluated by the
+ * texture decoding workers as well.
+ */
+class MapExpressionCache final
+{
+private:
+    struct Entry
+    {
+        ImagePtr image;
+        std::size_t size;
+        std::list<std::string>::iterator usage;
+    };
+
+    std::size_t _capacity;
+    std::size_t _size;
+
+    std::mutex _lock;
+
+    std::map<std::string, Entry> _images;
+
+    // Identifiers of the cached images, the most recently used first
+    std::list<std::string> _usage;
+
+    // Evaluations in progress
+    std::map<std::string, std::shared_future<ImagePtr>> _pendingImages;
+
+    // Incremented by clear(), evaluations started before are not stored
+    std::size_t _generation;
+
+public:
+    // Construct a cache holding at most the given number of bytes
+    MapExpressionCache(std::size_t capacity);
+
+    /**
+     * Returns the image stored for the given identifier, or invokes the given
+     * functor to evaluate and store it. Exceptions thrown by the functor are
+     * propagated to all waiting callers, the result is not stored in this case.
+     */
+    ImagePtr getImage(const std::string& identifier, const std::function<ImagePtr()>& evaluate);
+
+    // Returns the image stored for the given identifier without evaluating it,
+    // returns an empty pointer if there's no such image
+    ImagePtr findImage(const std::string& identifier);
+
+    // Discards all cached images, e.g. after the image files have been changed
+    void clear();
+
+    // The number of bytes held by the cache
+    std::size_t getSize();
+
+    // The instance used by the map expressions
+    static MapExpressionCache& Instance();
+
+private:
+    void insert(const std::string& identifier, const ImagePtr& image);
+};
+
+}
@@ -9,10 +9,14 @@
 #include "ifilesystem.h"
 #include "ifiletypes.h"
 #include "igame.h"
+#include "itaskscheduler.h"
 
 #include "ShaderExpression.h"
+#include "MapExpression.h"
 
 #include "debugging/ScopedDebugTimer.h"
+#include "os/path.h"
+#include "string/case_conv.h"
 #include "module/StaticModule.h"
 
 #include "decl/DeclarationCreator.h"
@@ -48,6 +52,8 @@ void MaterialManager::construct()
 {
     _library = std::make_shared<ShaderLibrary>();
     _textureManager = std::make_shared<GLTextureManager>();
+    _thumbnailLoader = std::make_unique<ThumbnailLoader>(
+        module::GlobalModuleRegistry().getApplicationContext().getCacheDataPath() + "thumbnails/");
 }
 
 void MaterialManager::destroy()
@@ -268,18 +274,112 @@ ITableDefinition::Ptr MaterialManager::getTable(const std::string& name)
 
 void MaterialManager::reloadImages()
 {
+    // The memoised images are outdated too
+    MapExpression::ClearImageCache();
+
     _library->foreachShader([](const CShaderPtr& shader)
     {
         shader->refreshImageMaps();
     });
 }
 
+void MaterialManager::reloadImage(const std::string& vfsPath)
+{
+    // Materials refer to their images without the file extension
+    auto imageName = string::to_lower_copy(os::removeExtension(os::standardPath(vfsPath)));
+
+    MapExpression::ClearImageCache();
+
+    _library->foreachShader([&](const CShaderPtr& shader)
+    {
+        if (shader->referencesImage(imageName))
+        {
+            shader->refreshImageMaps();
+        }
+    });
+}
+
+void MaterialManager::setAsyncTextureLoadingEnabled(bool enabled)
+{
+    _textureManager->setAsyncLoadingEnabled(enabled);
+}
+
+void MaterialManager::processAsyncTextureLoads(std::chrono::milliseconds budget)
+{
+    notifyTexturesChanged(_textureManager->processAsyncLoads(budget));
+}
+
+void MaterialManager::preloadMaterials(const std::vector<std::string>& names)
+{
+    for (const auto& name : names)
+    {
+        if (!_library->definitionExists(name)) continue;
+
+        auto shader = _library->findShader(name);
+
+        // Without background decoding the images would be loaded right here
+        if (_textureManager->isAsyncLoadingEnabled())
+        {
+            shader->preloadImages();
+        }
+    }
+}
+
+void MaterialManager::updateTextureResidency(const std::vector<GLuint>& drawnTextures)
+{
+    notifyTexturesChanged(_textureManager->updateResidency(drawnTextures));
+}
+
+IMaterialManager::EditorImageThumbnailPtr MaterialManager::getEditorImageThumbnail(const std::string& materialName)
+{
+    // Resolve the editor image on the main thread, the workers only evaluate the expression
+    auto shader = _library->findShader(materialName);
+
+    return _thumbnailLoader->getThumbnail(materialName, shader->getEditorImageMapExpression());
+}
+
+sigc::signal<void> MaterialManager::signal_editorImageThumbnailReady()
+{
+    return _thumbnailLoader->signal_thumbnailReady();
+}
+
+void MaterialManager::notifyTexturesChanged(const std::set<std::string>& identifiers)
+{
+    if (identifiers.empty()) return;
+
+    _library->foreachShader([&](const CShaderPtr& shader)
+    {
+        shader->onTexturesLoaded(identifiers);
+    });
+}
+
+sigc::signal<void> MaterialManager::signal_asyncTextureLoadFinished()
+{
+    return _textureManager->signal_asyncLoadFinished();
+}
+
 const std::string& MaterialManager::getName() const
 {
     static std::string _name(MODULE_SHADERSYSTEM);
     return _name;
 }
 
+const std::string& MaterialManager::getMemoryReporterName() const
+{
+    static std::string _name("MaterialManager");
+    return _name;
+}
+
+void MaterialManager::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    std::size_t numShaders = 0;
+    _library->foreachShader([&](const CShaderPtr&) { ++numShaders; });
+
+    report.addEntry("Instantiated materials", numShaders * sizeof(CShader), numShaders);
+
+    _textureManager->reportMemoryUsage(report);
+}
+
 const StringSet& MaterialManager::getDependencies() const
 {
     static StringSet _dependencies
@@ -290,6 +390,8 @@ const StringSet& MaterialManager::getDependencies() const
         MODULE_XMLREGISTRY,
         MODULE_GAMEMANAGER,
         MODULE_FILETYPES,
+        MODULE_MEMORYACCOUNTING,
+        MODULE_TASKSCHEDULER,
     };
 
     return _dependencies;
@@ -310,6 +412,9 @@ void MaterialManager::initialiseModule(const IApplicationContext& ctx)
     GlobalFiletypes().registerPattern("material", FileTypePattern(_("Material File"), "mtr", "*.mtr"));
 
     GlobalCommandSystem().addCommand("ReloadImages", [this](const cmd::ArgumentList&) { reloadImages(); });
+    GlobalCommandSystem().addCommand("ShowTextureMemoryStats", [this](const cmd::ArgumentList&) { _textureManager->printMemoryStats(); });
+
+    GlobalMemoryAccounting().registerReporter(*this);
 }
 
 void MaterialManager::onMaterialDefsReloaded()
@@ -326,6 +431,11 @@ void MaterialManager::shutdownModule()
 {
     rMessage() << "MaterialManager::shutdownModule called" << std::endl;
 
+    GlobalMemoryAccounting().unregisterReporter(*this);
+
+    _textureManager->setAsyncLoadingEnabled(false);
+    _thumbnailLoader->stop();
+
     destroy();
     _library->clear();
     _library.reset();
@@ -2,11 +2,13 @@
 
 #include "ishaders.h"
 #include "imodule.h"
+#include "imemoryaccounting.h"
 
 #include <functional>
 
 #include "ShaderLibrary.h"
 #include "textures/GLTextureManager.h"
+#include "textures/ThumbnailLoader.h"
 
 namespace shaders
 {
@@ -16,7 +18,8 @@ namespace shaders
  * Implementation of the IMaterialManager for Doom 3 .
  */
 class MaterialManager :
-	public IMaterialManager
+	public IMaterialManager,
+	public memory::IMemoryReporter
 {
 	// The shaderlibrary stores all the known templates
 	// as well as the active shaders
@@ -25,6 +28,9 @@ class MaterialManager :
 	// The manager that handles the texture caching.
 	GLTextureManagerPtr _textureManager;
 
+	// Generates the thumbnails for the texture browsers
+	std::unique_ptr<ThumbnailLoader> _thumbnailLoader;
+
 	// Active shaders list changed signal
     sigc::signal<void> _signalActiveShadersChanged;
 
@@ -89,10 +95,23 @@ public:
 	ITableDefinition::Ptr getTable(const std::string& name) override;
 
     void reloadImages() override;
+    void reloadImage(const std::string& vfsPath) override;
+
+    void setAsyncTextureLoadingEnabled(bool enabled) override;
+    void processAsyncTextureLoads(std::chrono::milliseconds budget) override;
+    sigc::signal<void> signal_asyncTextureLoadFinished() override;
+    void preloadMaterials(const std::vector<std::string>& names) override;
+    void updateTextureResidency(const std::vector<GLuint>& drawnTextures) override;
+    EditorImageThumbnailPtr getEditorImageThumbnail(const std::string& materialName) override;
+    sigc::signal<void> signal_editorImageThumbnailReady() override;
 
 public:
     sigc::signal<void> signal_activeShadersChanged() const override;
 
+    // IMemoryReporter implementation
+    const std::string& getMemoryReporterName() const override;
+    void reportMemoryUsage(memory::IMemoryReport& report) override;
+
 	// RegisterableModule implementation
     const std::string& getName() const override;
     const StringSet& getDependencies() const override;
@@ -108,6 +127,9 @@ private:
     void freeShaders();
 
     void onMaterialDefsReloaded();
+
+    // Lets the materials pick up the textures which have been replaced
+    void notifyTexturesChanged(const std::set<std::string>& identifiers);
 };
 
 typedef std::shared_ptr<MaterialManager> MaterialManagerPtr;
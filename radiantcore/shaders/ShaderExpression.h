@@ -6,6 +6,8 @@
 #include "fmt/format.h"
 #include "string/convert.h"
 #include "TableDefinition.h"
+#include "ExpressionProgram.h"
+#include <memory>
 
 namespace shaders
 {
@@ -22,6 +24,10 @@ class ShaderExpression :
 
     bool _surroundedByParentheses;
 
+    // The flattened tree, compiled on first evaluation (empty if not compilable)
+    std::unique_ptr<ExpressionProgram> _program;
+    bool _programCompiled;
+
 protected:
     ShaderExpression(const ShaderExpression& other) :
         ShaderExpression() // use default ctor to initialise the members
@@ -34,14 +40,15 @@ public:
 	ShaderExpression() :
 		_index(-1),
 		_registers(nullptr),
-        _surroundedByParentheses(false)
+        _surroundedByParentheses(false),
+        _programCompiled(false)
 	{}
 
 	// Base implementations
 	virtual float evaluate(std::size_t time) override
 	{
 		// Evaluate this register and write it into the respective register index
-		float val = getValue(time);
+		float val = getProgram() ? _program->evaluate(time, nullptr) : getValue(time);
 
 		if (_registers != nullptr)
 		{
@@ -54,7 +61,7 @@ public:
 	virtual float evaluate(std::size_t time, const IRenderEntity& entity) override
 	{
 		// Evaluate this register and write it into the respective register index
-		float val = getValue(time, entity);
+		float val = getProgram() ? _program->evaluate(time, &entity) : getValue(time, entity);
 
 		if (_registers != nullptr)
 		{
@@ -119,6 +126,44 @@ public:
 
     // To be implemented by the subclasses
     virtual std::string convertToString() = 0;
+
+    // Appends the instructions of this expression to the given program, returning the
+    // index of the instruction holding the result (or ExpressionProgram::InvalidIndex)
+    virtual std::size_t compile(ExpressionProgram& program) = 0;
+
+protected:
+    // Compiles the given sub-expression into the program
+    static std::size_t compile(const IShaderExpression::Ptr& expression, ExpressionProgram& program)
+    {
+        auto shaderExpression = std::dynamic_pointer_cast<ShaderExpression>(expression);
+        return shaderExpression ? shaderExpression->compile(program) : ExpressionProgram::InvalidIndex;
+    }
+
+    // To be called by the subclasses when the tree below this expression has been changed
+    void invalidateProgram()
+    {
+        _program.reset();
+        _programCompiled = false;
+    }
+
+private:
+    // Returns the compiled program of this tree, or null if it cannot be compiled
+    ExpressionProgram* getProgram()
+    {
+        if (!_programCompiled)
+        {
+            _programCompiled = true;
+
+            _program = std::make_unique<ExpressionProgram>();
+
+            if (compile(*_program) == ExpressionProgram::InvalidIndex)
+            {
+                _program.reset();
+            }
+        }
+
+        return _program.get();
+    }
 };
 
 // Detail namespace
@@ -159,6 +204,11 @@ public:
 		return entity.getShaderParm(_parmNum);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addParm(ExpressionProgram::OpCode::ShaderParm, _parmNum);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("parm{0}", _parmNum);
@@ -199,6 +249,11 @@ public:
 		return getValue(time);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addParm(ExpressionProgram::OpCode::GlobalParm, _parmNum);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("global{0}", _parmNum);
@@ -233,6 +288,11 @@ public:
 		return getValue(time);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addTime();
+    }
+
     virtual std::string convertToString() override
     {
         return "time";
@@ -272,6 +332,11 @@ public:
 		return getValue(time);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addConstant(_value);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0}", _value);
@@ -321,6 +386,11 @@ public:
 		return _tableDef->getValue(lookupVal);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return program.addTableLookup(*_tableDef, ShaderExpression::compile(_lookupExpr, program));
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0}[{1}]", _tableDef->getDeclName(), _lookupExpr->getExpressionString());
@@ -384,12 +454,23 @@ public:
 	void setA(const IShaderExpression::Ptr& a)
 	{
 		_a = a;
+		invalidateProgram();
 	}
 
 	void setB(const IShaderExpression::Ptr& b)
 	{
 		_b = b;
+		invalidateProgram();
 	}
+
+protected:
+    std::size_t compileOperation(ExpressionProgram::OpCode opCode, ExpressionProgram& program)
+    {
+        auto a = ShaderExpression::compile(_a, program);
+        auto b = ShaderExpression::compile(_b, program);
+
+        return program.addOperation(opCode, a, b);
+    }
 };
 typedef std::shared_ptr<BinaryExpression> BinaryExpressionPtr;
 
@@ -417,6 +498,11 @@ public:
 		return _a->getValue(time, entity) + _b->getValue(time, entity);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Add, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} + {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -452,6 +538,11 @@ public:
 		return _a->getValue(time, entity) - _b->getValue(time, entity);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Subtract, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} - {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -487,6 +578,11 @@ public:
 		return _a->getValue(time, entity) * _b->getValue(time, entity);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Multiply, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} * {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -522,6 +618,11 @@ public:
 		return _a->getValue(time, entity) / _b->getValue(time, entity);
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Divide, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} / {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -557,6 +658,11 @@ public:
 		return fmod(_a->getValue(time, entity), _b->getValue(time, entity));
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Modulo, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} % {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -592,6 +698,11 @@ public:
 		return _a->getValue(time, entity) < _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::LessThan, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} < {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -627,6 +738,11 @@ public:
 		return _a->getValue(time, entity) <= _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::LessThanOrEqual, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} <= {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -662,6 +778,11 @@ public:
 		return _a->getValue(time, entity) > _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::GreaterThan, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} > {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -697,6 +818,11 @@ public:
 		return _a->getValue(time, entity) >= _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::GreaterThanOrEqual, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} >= {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -732,6 +858,11 @@ public:
 		return _a->getValue(time, entity) == _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::Equal, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} == {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -767,6 +898,11 @@ public:
 		return _a->getValue(time, entity) != _b->getValue(time, entity) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::NotEqual, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} != {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -802,6 +938,11 @@ public:
 		return (_a->getValue(time, entity) != 0 && _b->getValue(time, entity) != 0) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::LogicalAnd, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} && {1}", _a->getExpressionString(), _b->getExpressionString());
@@ -837,6 +978,11 @@ public:
 		return (_a->getValue(time, entity) != 0 || _b->getValue(time, entity) != 0) ? 1.0f : 0;
 	}
 
+    std::size_t compile(ExpressionProgram& program) override
+    {
+        return compileOperation(ExpressionProgram::OpCode::LogicalOr, program);
+    }
+
     virtual std::string convertToString() override
     {
         return fmt::format("{0} || {1}", _a->getExpressionString(), _b->getExpressionString());
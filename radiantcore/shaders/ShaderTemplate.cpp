@@ -27,7 +27,6 @@ namespace shaders
 ShaderTemplate::ShaderTemplate(const ShaderTemplate& other) :
     decl::EditableDeclaration<shaders::IShaderTemplate>(other),
     _name(other._name),
-    _currentLayer(new Doom3ShaderLayer(*this)),
     _suppressChangeSignal(false),
     _lightFalloff(other._lightFalloff),
     _lightFalloffCubeMapType(other._lightFalloffCubeMapType),
@@ -1310,7 +1309,7 @@ bool ShaderTemplate::saveLayer()
 void ShaderTemplate::clear()
 {
     _layers.clear();
-    _currentLayer.reset(new Doom3ShaderLayer(*this));
+    _currentLayer.reset();
 
     description.clear();
     _suppressChangeSignal = false;
@@ -1344,6 +1343,14 @@ void ShaderTemplate::clear()
 void ShaderTemplate::onBeginParsing()
 {
     clear();
+
+    // The stage currently being parsed, only needed until the block is processed
+    _currentLayer = std::make_shared<Doom3ShaderLayer>(*this);
+}
+
+void ShaderTemplate::onParsingFinished()
+{
+    _currentLayer.reset();
 }
 
 void ShaderTemplate::parseFromTokens(parser::DefTokeniser& tokeniser)
@@ -35,7 +35,7 @@ private:
 	// Template name
 	std::string _name;
 
-	// Temporary current layer (used by the parsing functions)
+	// Temporary current layer (used by the parsing functions), empty outside of parsing
 	Doom3ShaderLayer::Ptr _currentLayer;
 
     sigc::signal<void> _sigTemplateChanged;
@@ -591,6 +591,8 @@ protected:
      */
     void parseFromTokens(parser::DefTokeniser& tokeniser) override;
 
+    void onParsingFinished() override;
+
     void onSyntaxBlockAssigned(const decl::DeclarationBlockSyntax& block) override;
 
     std::string generateSyntax() override;
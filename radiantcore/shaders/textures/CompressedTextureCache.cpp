@@ -0,0 +1,235 @@
+#include "CompressedTextureCache.h"
+
+#include <vector>
+#include <fstream>
+#include "igl.h"
+#include "ifilesystem.h"
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/dir.h"
+#include "os/fs.h"
+#include "math/Hash.h"
+#include "stream/FileInputStream.h"
+#include "BasicTexture2D.h"
+#include "debugging/gl.h"
+
+#include "../MapExpression.h"
+#include "../../imagefile/dds.h"
+
+namespace shaders
+{
+
+namespace
+{
+    // Increase this to invalidate all existing cache entries
+    constexpr std::size_t CACHE_VERSION = 1;
+
+    // Returns false if the file properties could not be determined
+    bool getFileProperties(const std::string& path, std::size_t& size, std::size_t& modificationTime)
+    {
+        std::error_code ec;
+        auto time = fs::last_write_time(path, ec);
+
+        if (ec) return false;
+
+        size = static_cast<std::size_t>(fs::file_size(path, ec));
+        modificationTime = static_cast<std::size_t>(time.time_since_epoch().count());
+
+        return !ec;
+    }
+
+    bool imageHasAlpha(const Image& image)
+    {
+        auto pixels = image.getPixels();
+        auto numPixels = image.getWidth() * image.getHeight();
+
+        for (std::size_t i = 0; i < numPixels; ++i)
+        {
+            if (pixels[i * 4 + 3] != 255) return true;
+        }
+
+        return false;
+    }
+}
+
+CompressedTextureCache::CompressedTextureCache(const std::string& cachePath) :
+    _cachePath(cachePath)
+{}
+
+bool CompressedTextureCache::isSupported() const
+{
+    // Mipmaps are generated by the driver, before they're read back
+    return GLEW_EXT_texture_compression_s3tc && GLEW_VERSION_3_0;
+}
+
+std::string CompressedTextureCache::GetKey(const MapExpression& expression, BindableTexture::Role role)
+{
+    math::Hash hash;
+
+    hash.addSizet(CACHE_VERSION);
+    hash.addString(expression.getIdentifier());
+    hash.addSizet(static_cast<std::size_t>(role));
+
+    bool allImagesFound = true;
+
+    expression.foreachImageName([&](const std::string& imageName)
+    {
+        if (!allImagesFound) return;
+
+        auto vfsPath = GlobalImageLoader().findImageInVFS(imageName);
+        auto info = !vfsPath.empty() ? GlobalFileSystem().getFileInfo(vfsPath) : vfs::FileInfo();
+
+        if (info.isEmpty())
+        {
+            allImagesFound = false;
+            return;
+        }
+
+        // Files in archives are considered changed when the archive has been modified
+        auto path = info.getIsPhysicalFile() ? info.getArchivePath() + info.fullPath() : info.getArchivePath();
+
+        std::size_t size = 0;
+        std::size_t modificationTime = 0;
+
+        if (!getFileProperties(path, size, modificationTime))
+        {
+            allImagesFound = false;
+            return;
+        }
+
+        hash.addString(path);
+        hash.addString(vfsPath);
+        hash.addSizet(size);
+        hash.addSizet(modificationTime);
+    });
+
+    return allImagesFound ? std::string(hash) : std::string();
+}
+
+std::string CompressedTextureCache::getFilename(const std::string& key) const
+{
+    return _cachePath + key + ".dds";
+}
+
+ImagePtr CompressedTextureCache::loadImage(const std::string& key) const
+{
+    auto filename = getFilename(key);
+
+    if (key.empty() || !os::fileOrDirExists(filename)) return ImagePtr();
+
+    stream::FileInputStream file(filename);
+
+    if (file.failed()) return ImagePtr();
+
+    auto image = image::LoadDDSFromStream(file);
+
+    if (!image || !image->isPrecompressed())
+    {
+        rWarning() << "[shaders] Ignoring invalid compressed texture " << filename << std::endl;
+        return ImagePtr();
+    }
+
+    return image;
+}
+
+TexturePtr CompressedTextureCache::bindAndStore(const std::string& key, const Image& image,
+                                                const std::string& name, BindableTexture::Role role)
+{
+    // Only uncompressed single-level images can be compressed, don't re-compress DDS files
+    if (key.empty() || image.isPrecompressed() || image.getGLFormat() != GL_RGBA || image.getLevels() != 1)
+    {
+        return TexturePtr();
+    }
+
+    // The interaction shader is reading the normal from all three channels,
+    // so use DXT5 instead of the two-channel RGTC2 for normal maps
+    auto useDXT1 = role == BindableTexture::Role::COLOUR && !imageHasAlpha(image);
+    auto internalFormat = useDXT1 ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+
+    auto width = static_cast<GLsizei>(image.getWidth());
+    auto height = static_cast<GLsizei>(image.getHeight());
+
+    debug::assertNoGlErrors();
+
+    GLuint textureNum;
+    glGenTextures(1, &textureNum);
+    glBindTexture(GL_TEXTURE_2D, textureNum);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+    // Let the driver compress the image and generate the mipmaps
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixels());
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    GLint isCompressed = GL_FALSE;
+    GLint actualFormat = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &isCompressed);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &actualFormat);
+
+    if (glGetError() != GL_NO_ERROR || isCompressed != GL_TRUE || actualFormat != static_cast<GLint>(internalFormat))
+    {
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDeleteTextures(1, &textureNum);
+        return TexturePtr();
+    }
+
+    // Read back the compressed mipmaps
+    std::vector<std::vector<uint8_t>> mipMaps;
+
+    for (auto size = std::max(width, height); ; size >>= 1)
+    {
+        auto level = static_cast<GLint>(mipMaps.size());
+
+        GLint compressedSize = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+
+        mipMaps.emplace_back(static_cast<std::size_t>(compressedSize));
+        glGetCompressedTexImage(GL_TEXTURE_2D, level, mipMaps.back().data());
+
+        if (size <= 1) break;
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    debug::assertNoGlErrors();
+
+    BasicTexture2DPtr texture(new BasicTexture2D(textureNum, name));
+    texture->setWidth(image.getWidth());
+    texture->setHeight(image.getHeight());
+
+    if (!os::fileOrDirExists(_cachePath) && !os::makeDirectory(_cachePath))
+    {
+        rWarning() << "[shaders] Cannot create compressed texture folder " << _cachePath << std::endl;
+        return texture;
+    }
+
+    // Write to a temporary file first, such that no truncated files are left behind
+    auto filename = getFilename(key);
+    auto tempFilename = filename + ".tmp";
+
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            rWarning() << "[shaders] Cannot write compressed texture " << filename << std::endl;
+            return texture;
+        }
+
+        image::WriteDDSToStream(file, useDXT1 ? "DXT1" : "DXT5", image.getWidth(), image.getHeight(), mipMaps);
+    }
+
+    std::error_code ec;
+    fs::rename(tempFilename, filename, ec);
+
+    if (ec)
+    {
+        rWarning() << "[shaders] Cannot write compressed texture " << filename << ": " << ec.message() << std::endl;
+        fs::remove(tempFilename, ec);
+    }
+
+    return texture;
+}
+
+}
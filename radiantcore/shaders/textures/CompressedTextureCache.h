@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include "iimage.h"
+
+namespace shaders
+{
+
+class MapExpression;
+
+// Enables the compressed texture cache, off by default
+constexpr const char* const RKEY_TEXTURES_COMPRESSED_CACHE = "user/ui/textures/useCompressedCache";
+
+/**
+ * On-disk cache of block-compressed (DXT1/DXT5) and fully mipmapped textures
+ * generated from map expressions, to avoid decoding, evaluating and mipmapping
+ * the source images every time a material is realised.
+ *
+ * Entries are addressed by a key that is generated from the map expression
+ * identifier, the texture role and the path, size and modification time of
+ * each source image, so any change to the images or the expression will lead
+ * to a cache miss. The entries are stored as regular DDS files.
+ */
+class CompressedTextureCache
+{
+private:
+    std::string _cachePath;
+
+public:
+    // Cache files are stored in the given folder, which is created on demand
+    CompressedTextureCache(const std::string& cachePath);
+
+    // Returns true if the current context is able to compress textures
+    bool isSupported() const;
+
+    // Returns the key of the given expression. Returns an empty string if one of the
+    // source images is not a file in the VFS, such textures are not cached.
+    // Doesn't touch any GL state, can be called from worker threads.
+    static std::string GetKey(const MapExpression& expression, BindableTexture::Role role);
+
+    // Loads the image stored for the given key, returns an empty pointer if there's no such image.
+    // Doesn't touch any GL state, can be called from worker threads.
+    ImagePtr loadImage(const std::string& key) const;
+
+    /**
+     * Uploads the given image as compressed texture and stores the compressed
+     * mipmaps for the given key. Returns an empty pointer if the image cannot be
+     * compressed, in which case it needs to be bound as usual.
+     */
+    TexturePtr bindAndStore(const std::string& key, const Image& image,
+                            const std::string& name, BindableTexture::Role role);
+
+private:
+    std::string getFilename(const std::string& key) const;
+};
+
+}
@@ -8,14 +8,86 @@
 #include "../MapExpression.h"
 #include "TextureManipulator.h"
 #include "parser/DefTokeniser.h"
+#include "string/format.h"
+#include "BasicTexture2D.h"
+#include "debugging/gl.h"
+
+#include <algorithm>
+#include <thread>
 
 namespace
 {
     const std::string SHADER_NOT_FOUND = "notex.bmp";
+
+    // Textures need to be left undrawn for this long before they're demoted
+    constexpr std::chrono::seconds MIN_DEMOTION_IDLE_TIME(10);
+
+    // Limits the work done per frame, each demotion is copying a texture
+    constexpr std::size_t MAX_DEMOTIONS_PER_UPDATE = 16;
+
+    // Textures are not demoted any further than this
+    constexpr GLint MIN_DEMOTED_SIZE = 64;
+
+    // Returns the video memory used by all mipmap levels of the given 2D texture
+    std::size_t getTextureMemoryUsage(GLuint textureNumber)
+    {
+        std::size_t memoryUsage = 0;
+
+        glBindTexture(GL_TEXTURE_2D, textureNumber);
+
+        for (GLint level = 0; ; ++level)
+        {
+            GLint width = 0;
+            GLint height = 0;
+            GLint isCompressed = GL_FALSE;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &width);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &height);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &isCompressed);
+
+            if (width <= 0 || height <= 0) break;
+
+            if (isCompressed == GL_TRUE)
+            {
+                GLint compressedSize = 0;
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &compressedSize);
+                memoryUsage += static_cast<std::size_t>(compressedSize);
+            }
+            else
+            {
+                // Assume 4 bytes per pixel, which is what we're uploading
+                memoryUsage += static_cast<std::size_t>(width) * height * 4;
+            }
+
+            if (width == 1 && height == 1) break;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        return memoryUsage;
+    }
+
+    bool textureDemotionSupported()
+    {
+        return GLEW_VERSION_4_3 || (GLEW_ARB_copy_image && GLEW_ARB_texture_storage);
+    }
 }
 
 namespace shaders {
 
+GLTextureManager::GLTextureManager() :
+    _totalMemoryUsage(0),
+    _memoryBudget(RKEY_TEXTURES_MEMORY_BUDGET),
+    _useCompressedCache(RKEY_TEXTURES_COMPRESSED_CACHE),
+    _compressedCache(module::GlobalModuleRegistry().getApplicationContext().getCacheDataPath() + "textures/"),
+    _asyncLoadingEnabled(false),
+    _numRunningWorkers(0)
+{}
+
+GLTextureManager::~GLTextureManager()
+{
+    stopAsyncLoads();
+}
+
 void GLTextureManager::checkBindings()
 {
     // Check the TextureMap for unique pointers and release them
@@ -25,11 +97,9 @@ void GLTextureManager::checkBindings()
          /* in-loop increment */)
     {
         // If the std::shared_ptr is unique (i.e. refcount==1), remove it
-        if (i->second.use_count() == 1)
+        if (i->second.texture.use_count() == 1)
         {
-            // Be sure to increment the iterator with a postfix ++,
-            // so that the iterator is incremented right before deletion
-            _textures.erase(i++);
+            i = eraseTexture(i);
         }
         else
         {
@@ -54,14 +124,15 @@ TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable,
     if (existing != _textures.end())
     {
         // Found, return
-        return existing->second;
+        return existing->second.texture;
     }
 
     // Create and insert texture object, if it is valid
-    auto texture = bindable->bindTexture(identifier, role);
+    auto texture = createTexture(bindable, identifier, role);
+
     if (texture)
     {
-        _textures.emplace(identifier, texture);
+        storeTexture(identifier, texture, bindable, role);
         return texture;
     }
 
@@ -69,6 +140,312 @@ TexturePtr GLTextureManager::getBinding(const NamedBindablePtr& bindable,
     return getShaderNotFound();
 }
 
+TexturePtr GLTextureManager::getBindingAsync(const NamedBindablePtr& bindable,
+                                             BindableTexture::Role role, const TexturePtr& placeholder)
+{
+    // Only map expressions can be decoded separately from their upload
+    auto expression = std::dynamic_pointer_cast<MapExpression>(bindable);
+
+    if (!_asyncLoadingEnabled || !expression)
+    {
+        return getBinding(bindable, role);
+    }
+
+    auto identifier = expression->getIdentifier();
+    auto existing = _textures.find(identifier);
+
+    if (existing != _textures.end())
+    {
+        return existing->second.texture;
+    }
+
+    // Don't try again to decode images which failed before
+    if (_failedLoads.count(identifier) > 0)
+    {
+        return getShaderNotFound();
+    }
+
+    queueDecode(identifier, role, expression);
+
+    return placeholder ? placeholder : getShaderNotFound();
+}
+
+void GLTextureManager::queueDecode(const std::string& identifier, BindableTexture::Role role,
+                                   const MapExpressionPtr& expression)
+{
+    if (!_pendingLoads.insert(identifier).second) return;
+
+    std::lock_guard<std::mutex> lock(_asyncLock);
+
+    _decodeQueue.push_back(QueuedImage{ identifier, role, expression, compressedCacheEnabled() });
+
+    // Start another worker if the ones running are all busy
+    auto maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (_numRunningWorkers < std::min<std::size_t>(maxWorkers, _decodeQueue.size()))
+    {
+        ++_numRunningWorkers;
+        _decodeWorkers.emplace_back(std::async(std::launch::async, &GLTextureManager::processDecodeQueue, this));
+    }
+}
+
+void GLTextureManager::setAsyncLoadingEnabled(bool enabled)
+{
+    _asyncLoadingEnabled = enabled;
+
+    if (!enabled)
+    {
+        stopAsyncLoads();
+    }
+}
+
+bool GLTextureManager::isAsyncLoadingEnabled() const
+{
+    return _asyncLoadingEnabled;
+}
+
+std::set<std::string> GLTextureManager::processAsyncLoads(std::chrono::milliseconds budget)
+{
+    std::set<std::string> loadedTextures;
+    auto deadline = std::chrono::steady_clock::now() + budget;
+    bool imagesLeft = false;
+
+    // Upload at least one image per call, such that the queue is always making progress
+    do
+    {
+        DecodedImage decoded;
+
+        {
+            std::lock_guard<std::mutex> lock(_asyncLock);
+
+            // Clean up the workers which are done
+            _decodeWorkers.erase(std::remove_if(_decodeWorkers.begin(), _decodeWorkers.end(), [](const std::future<void>& worker)
+            {
+                return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }), _decodeWorkers.end());
+
+            if (_decodedImages.empty()) break;
+
+            decoded = std::move(_decodedImages.front());
+            _decodedImages.pop_front();
+            imagesLeft = !_decodedImages.empty();
+        }
+
+        // The cache might have been cleared since the image has been queued
+        if (_pendingLoads.erase(decoded.identifier) == 0) continue;
+
+        // Restored textures are replacing their demoted versions
+        auto existing = _textures.find(decoded.identifier);
+
+        TexturePtr texture;
+
+        if (decoded.image && !decoded.cacheKey.empty())
+        {
+            texture = _compressedCache.bindAndStore(decoded.cacheKey, *decoded.image, decoded.identifier, decoded.role);
+        }
+
+        if (decoded.image && !texture)
+        {
+            texture = createProgressiveTexture(decoded);
+        }
+
+        if (decoded.image && !texture)
+        {
+            texture = decoded.image->bindTexture(decoded.identifier, decoded.role);
+        }
+
+        if (texture)
+        {
+            storeTexture(decoded.identifier, texture, decoded.expression, decoded.role);
+        }
+        else if (existing == _textures.end())
+        {
+            rError() << "[shaders] Unable to load texture: " << decoded.identifier << std::endl;
+            _failedLoads.insert(decoded.identifier);
+        }
+
+        loadedTextures.insert(decoded.identifier);
+    }
+    while (std::chrono::steady_clock::now() < deadline);
+
+    // Spend the remaining time on the larger mipmap levels of the textures created above,
+    // at least one level is uploaded per call such that they're always making progress
+    bool levelsUploaded = false;
+
+    do
+    {
+        if (!uploadNextLevel()) break;
+
+        levelsUploaded = true;
+    }
+    while (std::chrono::steady_clock::now() < deadline);
+
+    // Another round is needed for the remaining images, and to draw the uploaded levels
+    if (imagesLeft || levelsUploaded)
+    {
+        std::lock_guard<std::mutex> lock(_asyncLock);
+        _sigAsyncLoadFinished.emit();
+    }
+
+    return loadedTextures;
+}
+
+TexturePtr GLTextureManager::createProgressiveTexture(const DecodedImage& decoded)
+{
+    auto progressive = std::dynamic_pointer_cast<ProgressiveBindableTexture>(decoded.image);
+
+    if (!progressive || decoded.image->getLevels() < 2) return TexturePtr();
+
+    auto texture = progressive->createProgressiveTexture(decoded.identifier);
+    auto smallestLevel = decoded.image->getLevels() - 1;
+
+    // On failure the regular upload is going to report the error
+    if (!texture || !progressive->uploadLevel(texture, smallestLevel))
+    {
+        return TexturePtr();
+    }
+
+    _progressiveUploads.push_back(ProgressiveUpload{ decoded.identifier, decoded.image, texture, smallestLevel - 1 });
+
+    return texture;
+}
+
+bool GLTextureManager::uploadNextLevel()
+{
+    while (!_progressiveUploads.empty())
+    {
+        auto upload = std::move(_progressiveUploads.front());
+        _progressiveUploads.pop_front();
+
+        auto texture = upload.texture.lock();
+        auto record = _textures.find(upload.identifier);
+
+        // Skip textures which have been released or replaced in the meantime
+        if (!texture || record == _textures.end() || record->second.texture != texture)
+        {
+            continue;
+        }
+
+        auto progressive = std::dynamic_pointer_cast<ProgressiveBindableTexture>(upload.image);
+
+        if (!progressive->uploadLevel(texture, upload.nextLevel))
+        {
+            // Keep the levels uploaded so far, the texture is complete at that size
+            if (auto texture2D = std::dynamic_pointer_cast<BasicTexture2D>(texture); texture2D)
+            {
+                texture2D->setLevelsPending(false);
+            }
+
+            return true;
+        }
+
+        if (upload.nextLevel > 0)
+        {
+            // Take turns, such that all queued textures are getting sharper at the same pace
+            --upload.nextLevel;
+            _progressiveUploads.push_back(std::move(upload));
+
+            return true;
+        }
+
+        // The texture is complete, its memory has not been accounted for so far
+        auto memoryUsage = getTextureMemoryUsage(texture->getGLTexNum());
+
+        _totalMemoryUsage = _totalMemoryUsage - record->second.memoryUsage + memoryUsage;
+        record->second.memoryUsage = memoryUsage;
+
+        return true;
+    }
+
+    return false;
+}
+
+sigc::signal<void> GLTextureManager::signal_asyncLoadFinished()
+{
+    return _sigAsyncLoadFinished;
+}
+
+void GLTextureManager::processDecodeQueue()
+{
+    while (true)
+    {
+        QueuedImage queued;
+
+        {
+            std::lock_guard<std::mutex> lock(_asyncLock);
+
+            if (_decodeQueue.empty())
+            {
+                --_numRunningWorkers;
+                return;
+            }
+
+            queued = std::move(_decodeQueue.front());
+            _decodeQueue.pop_front();
+        }
+
+        // Decoding the image doesn't touch any GL state, the upload is left to the main thread
+        ImagePtr image;
+        std::string cacheKey;
+
+        try
+        {
+            if (queued.useCompressedCache)
+            {
+                cacheKey = CompressedTextureCache::GetKey(*queued.expression, queued.role);
+                image = _compressedCache.loadImage(cacheKey);
+            }
+
+            // Cache hits don't need to be stored again
+            if (image)
+            {
+                cacheKey.clear();
+            }
+            else
+            {
+                image = queued.expression->getImage();
+            }
+        }
+        catch (const std::exception& ex)
+        {
+            rError() << "Failed to decode image " << queued.identifier << ": " << ex.what() << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_asyncLock);
+            _decodedImages.push_back(DecodedImage{ queued.identifier, queued.role, queued.expression, image, cacheKey });
+
+            // Emit the signal while holding the lock, such that it is never emitted concurrently
+            _sigAsyncLoadFinished.emit();
+        }
+    }
+}
+
+void GLTextureManager::stopAsyncLoads()
+{
+    std::vector<std::future<void>> workers;
+
+    {
+        std::lock_guard<std::mutex> lock(_asyncLock);
+
+        _decodeQueue.clear();
+        workers.swap(_decodeWorkers);
+    }
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+
+    _decodedImages.clear();
+    _pendingLoads.clear();
+    _failedLoads.clear();
+
+    // Textures waiting for their larger levels remain usable at their current size
+    _progressiveUploads.clear();
+}
+
 TexturePtr GLTextureManager::getBinding(const std::string& fullPath)
 {
     // check if the texture has to be loaded
@@ -83,7 +460,7 @@ TexturePtr GLTextureManager::getBinding(const std::string& fullPath)
         {
             // Constructor returned a valid image, now create the texture object
             TexturePtr texture = img->bindTexture(fullPath);
-            _textures[fullPath] = texture;
+            storeTexture(fullPath, texture, NamedBindablePtr(), BindableTexture::Role::COLOUR);
         }
         else
         {
@@ -95,14 +472,346 @@ TexturePtr GLTextureManager::getBinding(const std::string& fullPath)
     }
 
     // Cast should succeed since all single image textures will be Texture2D
-    return _textures[fullPath];
+    return _textures[fullPath].texture;
 }
 
 void GLTextureManager::clearCacheForBindable(const NamedBindablePtr& bindable)
 {
     if (!bindable) return;
 
-    _textures.erase(bindable->getIdentifier());
+    auto identifier = bindable->getIdentifier();
+    auto existing = _textures.find(identifier);
+
+    if (existing != _textures.end())
+    {
+        eraseTexture(existing);
+    }
+
+    _pendingLoads.erase(identifier);
+    _failedLoads.erase(identifier);
+}
+
+TexturePtr GLTextureManager::createTexture(const NamedBindablePtr& bindable, const std::string& identifier,
+                                           BindableTexture::Role role)
+{
+    auto expression = std::dynamic_pointer_cast<MapExpression>(bindable);
+
+    return expression && compressedCacheEnabled() ?
+        bindCompressed(*expression, identifier, role) : bindable->bindTexture(identifier, role);
+}
+
+void GLTextureManager::storeTexture(const std::string& identifier, const TexturePtr& texture,
+                                    const NamedBindablePtr& bindable, BindableTexture::Role role)
+{
+    auto existing = _textures.find(identifier);
+
+    if (existing != _textures.end())
+    {
+        eraseTexture(existing);
+    }
+
+    // Only 2D textures are accounted for, the cube maps are few and small
+    auto memoryUsage = texture && std::dynamic_pointer_cast<BasicTexture2D>(texture) ?
+        getTextureMemoryUsage(texture->getGLTexNum()) : 0;
+
+    _textures.emplace(identifier, TextureRecord
+    {
+        texture, bindable, role, memoryUsage, 0, std::chrono::steady_clock::now()
+    });
+
+    if (texture)
+    {
+        _identifiersByTextureNumber[texture->getGLTexNum()] = identifier;
+    }
+
+    _totalMemoryUsage += memoryUsage;
+}
+
+GLTextureManager::TextureMap::iterator GLTextureManager::eraseTexture(TextureMap::iterator texture)
+{
+    if (texture->second.texture)
+    {
+        _identifiersByTextureNumber.erase(texture->second.texture->getGLTexNum());
+    }
+
+    _totalMemoryUsage -= texture->second.memoryUsage;
+
+    return _textures.erase(texture);
+}
+
+std::set<std::string> GLTextureManager::updateResidency(const std::vector<GLuint>& drawnTextures)
+{
+    std::set<std::string> replacedTextures;
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto textureNumber : drawnTextures)
+    {
+        auto found = _identifiersByTextureNumber.find(textureNumber);
+
+        if (found == _identifiersByTextureNumber.end()) continue;
+
+        // Restoring the texture is replacing the map entries
+        auto identifier = found->second;
+        auto& record = _textures.at(identifier);
+        record.lastDrawn = now;
+
+        // Demoted textures which are in use again are loaded at full size
+        if (record.demotionLevel > 0 && _pendingLoads.count(identifier) == 0 &&
+            restoreTexture(identifier, record))
+        {
+            replacedTextures.insert(identifier);
+        }
+    }
+
+    auto budget = static_cast<std::size_t>(std::max(_memoryBudget.get(), 0)) * 1024 * 1024;
+
+    if (budget == 0 || _totalMemoryUsage <= budget || !textureDemotionSupported())
+    {
+        return replacedTextures;
+    }
+
+    // Demote the least recently drawn textures first
+    std::vector<TextureMap::iterator> candidates;
+
+    for (auto i = _textures.begin(); i != _textures.end(); ++i)
+    {
+        if (i->second.bindable && i->second.memoryUsage > 0 && now - i->second.lastDrawn >= MIN_DEMOTION_IDLE_TIME)
+        {
+            candidates.push_back(i);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const TextureMap::iterator& a, const TextureMap::iterator& b)
+    {
+        return a->second.lastDrawn < b->second.lastDrawn;
+    });
+
+    std::size_t numDemotions = 0;
+
+    for (const auto& candidate : candidates)
+    {
+        if (_totalMemoryUsage <= budget || numDemotions >= MAX_DEMOTIONS_PER_UPDATE) break;
+
+        if (demoteTexture(candidate->second))
+        {
+            replacedTextures.insert(candidate->first);
+            ++numDemotions;
+        }
+    }
+
+    return replacedTextures;
+}
+
+bool GLTextureManager::demoteTexture(TextureRecord& record)
+{
+    auto texture = std::dynamic_pointer_cast<BasicTexture2D>(record.texture);
+
+    if (!texture) return false;
+
+    // Textures used through bindless handles are immutable, so the mipmaps
+    // are copied into a new texture object which has one level less
+    auto oldTextureNumber = texture->getGLTexNum();
+    glBindTexture(GL_TEXTURE_2D, oldTextureNumber);
+
+    GLint width = 0;
+    GLint height = 0;
+    GLint internalFormat = 0;
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 1, GL_TEXTURE_WIDTH, &width);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 1, GL_TEXTURE_HEIGHT, &height);
+    glGetTexLevelParameteriv(GL_TEXTURE_2D, 1, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+
+    // Count the levels below the largest one, not all textures have a full mipmap chain
+    GLint levels = 0;
+
+    for (GLint levelWidth = width, levelHeight = height; levelWidth > 0 && levelHeight > 0; ++levels)
+    {
+        if (levelWidth == 1 && levelHeight == 1)
+        {
+            ++levels;
+            break;
+        }
+
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, levels + 2, GL_TEXTURE_WIDTH, &levelWidth);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, levels + 2, GL_TEXTURE_HEIGHT, &levelHeight);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    if (std::max(width, height) < MIN_DEMOTED_SIZE) return false;
+
+    debug::assertNoGlErrors();
+
+    GLuint newTextureNumber;
+    glGenTextures(1, &newTextureNumber);
+    glBindTexture(GL_TEXTURE_2D, newTextureNumber);
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexStorage2D(GL_TEXTURE_2D, levels, static_cast<GLenum>(internalFormat), width, height);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    for (GLint level = 0; level < levels; ++level)
+    {
+        glCopyImageSubData(oldTextureNumber, GL_TEXTURE_2D, level + 1, 0, 0, 0,
+            newTextureNumber, GL_TEXTURE_2D, level, 0, 0, 0,
+            std::max(width >> level, 1), std::max(height >> level, 1), 1);
+    }
+
+    if (glGetError() != GL_NO_ERROR)
+    {
+        glDeleteTextures(1, &newTextureNumber);
+        return false;
+    }
+
+    // The texture object stays the same, the materials need to pick up the new number
+    texture->setGLTexNum(newTextureNumber);
+    glDeleteTextures(1, &oldTextureNumber);
+
+    auto memoryUsage = getTextureMemoryUsage(newTextureNumber);
+
+    _identifiersByTextureNumber[newTextureNumber] = _identifiersByTextureNumber[oldTextureNumber];
+    _identifiersByTextureNumber.erase(oldTextureNumber);
+
+    _totalMemoryUsage = _totalMemoryUsage - record.memoryUsage + memoryUsage;
+    record.memoryUsage = memoryUsage;
+    ++record.demotionLevel;
+
+    return true;
+}
+
+bool GLTextureManager::restoreTexture(const std::string& identifier, TextureRecord& record)
+{
+    auto expression = std::dynamic_pointer_cast<MapExpression>(record.bindable);
+
+    // Keep the demoted version around until the full-size image has been decoded
+    if (_asyncLoadingEnabled && expression)
+    {
+        queueDecode(identifier, record.role, expression);
+        return false;
+    }
+
+    auto texture = createTexture(record.bindable, identifier, record.role);
+
+    if (!texture) return false;
+
+    // Copy the bindable, the record is overwritten
+    auto bindable = record.bindable;
+    storeTexture(identifier, texture, bindable, record.role);
+
+    return true;
+}
+
+void GLTextureManager::printMemoryStats()
+{
+    std::size_t numDemoted = 0;
+    std::size_t demotedMemoryUsage = 0;
+
+    std::vector<TextureMap::const_iterator> textures;
+
+    for (auto i = _textures.cbegin(); i != _textures.cend(); ++i)
+    {
+        textures.push_back(i);
+
+        if (i->second.demotionLevel > 0)
+        {
+            ++numDemoted;
+            demotedMemoryUsage += i->second.memoryUsage;
+        }
+    }
+
+    auto budget = std::max(_memoryBudget.get(), 0);
+
+    rMessage() << "-- Texture Memory --" << std::endl;
+    rMessage() << "Textures: " << _textures.size() << std::endl;
+    rMessage() << "Total: " << string::getFormattedByteSize(_totalMemoryUsage) << std::endl;
+    rMessage() << "Budget: " << (budget > 0 ? string::getFormattedByteSize(static_cast<std::size_t>(budget) * 1024 * 1024) : "unlimited") << std::endl;
+    rMessage() << "Demoted Textures: " << numDemoted << " (" << string::getFormattedByteSize(demotedMemoryUsage) << ")" << std::endl;
+
+    std::sort(textures.begin(), textures.end(), [](const TextureMap::const_iterator& a, const TextureMap::const_iterator& b)
+    {
+        return a->second.memoryUsage > b->second.memoryUsage;
+    });
+
+    constexpr std::size_t NUM_LARGEST_TEXTURES = 20;
+    auto now = std::chrono::steady_clock::now();
+
+    rMessage() << "Largest Textures:" << std::endl;
+
+    for (std::size_t i = 0; i < std::min(textures.size(), NUM_LARGEST_TEXTURES); ++i)
+    {
+        const auto& record = textures[i]->second;
+        auto idleSeconds = std::chrono::duration_cast<std::chrono::seconds>(now - record.lastDrawn).count();
+
+        rMessage() << "  " << textures[i]->first << ": " << string::getFormattedByteSize(record.memoryUsage)
+            << ", demoted by " << record.demotionLevel << " levels, last drawn " << idleSeconds << "s ago" << std::endl;
+    }
+}
+
+void GLTextureManager::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    std::size_t numDemoted = 0;
+    std::size_t demotedMemoryUsage = 0;
+
+    for (const auto& [_, record] : _textures)
+    {
+        if (record.demotionLevel > 0)
+        {
+            ++numDemoted;
+            demotedMemoryUsage += record.memoryUsage;
+        }
+    }
+
+    report.addEntry("Textures (video memory)", _totalMemoryUsage, _textures.size());
+    report.addEntry("Demoted textures (video memory)", demotedMemoryUsage, numDemoted);
+
+    std::size_t decodedMemoryUsage = 0;
+    std::size_t numDecoded = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(_asyncLock);
+
+        for (const auto& decoded : _decodedImages)
+        {
+            if (!decoded.image) continue;
+
+            ++numDecoded;
+
+            for (std::size_t level = 0; level < decoded.image->getLevels(); ++level)
+            {
+                decodedMemoryUsage += decoded.image->getWidth(level) * decoded.image->getHeight(level) * 4;
+            }
+        }
+    }
+
+    report.addEntry("Decoded images awaiting upload", decodedMemoryUsage, numDecoded);
+}
+
+bool GLTextureManager::compressedCacheEnabled() const
+{
+    return _useCompressedCache.get() && _compressedCache.isSupported();
+}
+
+TexturePtr GLTextureManager::bindCompressed(const MapExpression& expression, const std::string& identifier,
+                                            BindableTexture::Role role)
+{
+    auto key = CompressedTextureCache::GetKey(expression, role);
+
+    if (auto cached = _compressedCache.loadImage(key))
+    {
+        if (auto texture = cached->bindTexture(identifier, role))
+        {
+            return texture;
+        }
+    }
+
+    auto image = expression.getImage();
+
+    if (!image) return TexturePtr();
+
+    auto texture = _compressedCache.bindAndStore(key, *image, identifier, role);
+
+    return texture ? texture : image->bindTexture(identifier, role);
 }
 
 // Return the shader-not-found texture, loading if necessary
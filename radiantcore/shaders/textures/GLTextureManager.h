@@ -2,28 +2,156 @@
 #define GLTEXTUREMANAGER_H_
 
 #include "ishaders.h"
+#include "imemoryaccounting.h"
+#include <chrono>
+#include <deque>
+#include <future>
 #include <map>
+#include <mutex>
+#include <set>
+#include <vector>
 #include "../MapExpression.h"
 #include "texturelib.h"
+#include "registry/CachedKey.h"
+#include "CompressedTextureCache.h"
 
 namespace shaders
 {
 
+// The texture memory budget in MB, textures are demoted if it's exceeded. 0 means unlimited.
+constexpr const char* const RKEY_TEXTURES_MEMORY_BUDGET = "user/ui/textures/memoryBudget";
+
 class GLTextureManager
 {
+	// A bound texture along with its residency information
+	struct TextureRecord
+	{
+		TexturePtr texture;
+
+		// The bindable the texture has been created from, used to restore demoted
+		// textures. Empty for textures which cannot be demoted.
+		NamedBindablePtr bindable;
+		BindableTexture::Role role;
+
+		// Estimated video memory used by all mipmap levels
+		std::size_t memoryUsage;
+
+		// The number of mipmap levels dropped to save memory
+		std::size_t demotionLevel;
+
+		std::chrono::steady_clock::time_point lastDrawn;
+	};
+
 	// The mapping between texturekeys and Texture instances
-	typedef std::map<std::string, TexturePtr> TextureMap;
+	typedef std::map<std::string, TextureRecord> TextureMap;
 	TextureMap _textures;
 
+	// The identifiers of the textures by their GL texture number
+	std::map<GLuint, std::string> _identifiersByTextureNumber;
+
+	std::size_t _totalMemoryUsage;
+
+	// The texture memory budget in MB, 0 means unlimited
+	registry::CachedKey<int> _memoryBudget;
+
 	// The fallback textures in case a texture is empty or broken
 	TexturePtr _shaderNotFound;
 
+	registry::CachedKey<bool> _useCompressedCache;
+	CompressedTextureCache _compressedCache;
+
+	// An image decoded by a worker, waiting to be uploaded.
+	// The cache key is set if the image should be stored in the compressed cache.
+	struct DecodedImage
+	{
+		std::string identifier;
+		BindableTexture::Role role;
+		MapExpressionPtr expression;
+		ImagePtr image;
+		std::string cacheKey;
+	};
+
+	struct QueuedImage
+	{
+		std::string identifier;
+		BindableTexture::Role role;
+		MapExpressionPtr expression;
+		bool useCompressedCache;
+	};
+
+	bool _asyncLoadingEnabled;
+
+	// Identifiers queued for decoding or waiting for their upload (main thread only)
+	std::set<std::string> _pendingLoads;
+
+	// Identifiers which failed to decode in the background (main thread only)
+	std::set<std::string> _failedLoads;
+
+	// Guards the decode queue, the decoded images and the workers
+	std::mutex _asyncLock;
+	std::deque<QueuedImage> _decodeQueue;
+	std::deque<DecodedImage> _decodedImages;
+	std::vector<std::future<void>> _decodeWorkers;
+	std::size_t _numRunningWorkers;
+
+	sigc::signal<void> _sigAsyncLoadFinished;
+
+	// A texture created with only its smallest mipmap levels, the remaining
+	// ones are uploaded by processAsyncLoads(), the largest one last.
+	struct ProgressiveUpload
+	{
+		std::string identifier;
+		ImagePtr image;
+		std::weak_ptr<Texture> texture;
+
+		// The smallest level not uploaded yet, counting down to 0
+		std::size_t nextLevel;
+	};
+
+	// Textures waiting for their larger mipmap levels (main thread only)
+	std::deque<ProgressiveUpload> _progressiveUploads;
+
 private:
 
 	// Constructs the fallback textures like "Shader Image Missing"
 	TexturePtr loadStandardTexture(const std::string& filename);
 
+	bool compressedCacheEnabled() const;
+
+	// Creates the texture for the given bindable, returns an empty pointer on failure
+	TexturePtr createTexture(const NamedBindablePtr& bindable, const std::string& identifier,
+	                         BindableTexture::Role role);
+
+	// Adds or replaces the texture stored for the given identifier
+	void storeTexture(const std::string& identifier, const TexturePtr& texture,
+	                  const NamedBindablePtr& bindable, BindableTexture::Role role);
+
+	TextureMap::iterator eraseTexture(TextureMap::iterator texture);
+
+	// Drops the largest mipmap level of the given texture, returns false if that's not possible
+	bool demoteTexture(TextureRecord& record);
+
+	// Reloads the given demoted texture at full size. Returns true if the texture
+	// has been replaced right away, otherwise it is loaded in the background.
+	bool restoreTexture(const std::string& identifier, TextureRecord& record);
+
+	void queueDecode(const std::string& identifier, BindableTexture::Role role, const MapExpressionPtr& expression);
+
+	// Creates the texture of a decoded image with precomputed mipmaps, uploading only
+	// the smallest level. Returns an empty pointer if the image doesn't support this.
+	TexturePtr createProgressiveTexture(const DecodedImage& decoded);
+
+	// Uploads the next mipmap level of the first queued texture, returns false
+	// if there was nothing to upload
+	bool uploadNextLevel();
+
+	// Binds the texture stored in the compressed cache, or creates the cache entry
+	TexturePtr bindCompressed(const MapExpression& expression, const std::string& identifier,
+	                          BindableTexture::Role role);
+
 public:
+	GLTextureManager();
+	~GLTextureManager();
 
     /// Construct a bound texture from a generic named bindable.
     TexturePtr getBinding(const NamedBindablePtr& bindable,
@@ -37,6 +165,35 @@ public:
 	 */
 	TexturePtr getBinding(const std::string& fullPath);
 
+    /**
+     * \brief
+     * Like getBinding(), but the image of map expressions which are not
+     * loaded yet is decoded by a worker thread. The given placeholder is
+     * returned in the meantime, the texture is uploaded by a later call to
+     * processAsyncLoads(). Falls back to getBinding() if async loading is
+     * disabled.
+     */
+    TexturePtr getBindingAsync(const NamedBindablePtr& bindable,
+                               BindableTexture::Role role, const TexturePtr& placeholder);
+
+    // Enables or disables the background decoding. Disabling it blocks until
+    // the running workers are done, the images not decoded yet are dropped.
+    void setAsyncLoadingEnabled(bool enabled);
+
+    bool isAsyncLoadingEnabled() const;
+
+    // Uploads the images decoded in the background, until the given time budget
+    // is used up. Images with precomputed mipmaps are made available at their
+    // smallest level first, the larger levels are following with the next calls.
+    // Needs to be called on the main thread with a current GL context.
+    // Returns the identifiers of the textures loaded (or failed to load) by this call.
+    std::set<std::string> processAsyncLoads(std::chrono::milliseconds budget);
+
+    // Emitted by the worker threads when an image has been decoded, and again by
+    // processAsyncLoads() if there are images or mipmap levels left to upload.
+    // Listeners need to arrange for processAsyncLoads() to be called on the main thread.
+    sigc::signal<void> signal_asyncLoadFinished();
+
     // Removes any Texture references held in the cache referring to this bindable's ID.
     // The next call to getBinding() will produce a new TexturePtr object.
     void clearCacheForBindable(const NamedBindablePtr& bindable);
@@ -53,6 +210,28 @@ public:
 	 */
 	void checkBindings();
 
+    /**
+     * \brief
+     * Marks the given GL textures as drawn and enforces the texture memory budget,
+     * by demoting the least recently drawn textures to lower mipmap levels.
+     * Demoted textures which are drawn again are restored to their full size.
+     * Needs to be called on the main thread with a current GL context.
+     * Returns the identifiers of the textures which have been replaced.
+     */
+    std::set<std::string> updateResidency(const std::vector<GLuint>& drawnTextures);
+
+    // Writes the texture memory usage to the console
+    void printMemoryStats();
+
+    // Adds the video memory of the textures and the decoded images waiting for upload
+    void reportMemoryUsage(memory::IMemoryReport& report);
+
+private:
+	// Worker thread function, decoding queued images until the queue is empty
+	void processDecodeQueue();
+
+	// Blocks until all workers are done, queued images which have not been started are dropped
+	void stopAsyncLoads();
 };
 
 typedef std::shared_ptr<GLTextureManager> GLTextureManagerPtr;
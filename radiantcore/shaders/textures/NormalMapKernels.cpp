@@ -0,0 +1,333 @@
+#include "NormalMapKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "itaskscheduler.h"
+#include "math/FloatTools.h"
+#include "RGBAImage.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define NORMALMAP_KERNELS_SSE2
+#endif
+
+namespace shaders
+{
+
+namespace
+{
+	// The number of rows processed by a single worker in one go
+	const std::size_t ROWS_PER_BAND = 32;
+
+	// The alpha channel of the RGBA output pixels is always opaque
+	const std::uint32_t OPAQUE_ALPHA = 0xff000000;
+
+	// Invokes the function(firstRow, endRow) for bands of rows covering the whole image,
+	// the bands are processed in parallel if there is more than one
+	void forEachRowBand(std::size_t height, const std::function<void(std::size_t, std::size_t)>& function)
+	{
+		auto numBands = (height + ROWS_PER_BAND - 1) / ROWS_PER_BAND;
+
+		if (numBands <= 1)
+		{
+			function(0, height);
+			return;
+		}
+
+		GlobalTaskScheduler().parallelFor(numBands, [&](std::size_t band)
+		{
+			auto firstRow = band * ROWS_PER_BAND;
+			function(firstRow, std::min(firstRow + ROWS_PER_BAND, height));
+		});
+	}
+
+	inline std::size_t previousRow(std::size_t y, std::size_t height)
+	{
+		return (y + height - 1) % height;
+	}
+
+	inline std::size_t nextRow(std::size_t y, std::size_t height)
+	{
+		return (y + 1) % height;
+	}
+
+	// Copies the first and last element of the row into the padding on the opposite side,
+	// such that the elements at index 0 and size-1 are wrapping around
+	template<typename Element>
+	inline void wrapPadding(std::vector<Element>& row, std::size_t elementsPerPixel)
+	{
+		auto width = row.size() / elementsPerPixel - 2;
+
+		for (std::size_t c = 0; c < elementsPerPixel; ++c)
+		{
+			row[c] = row[width * elementsPerPixel + c];
+			row[(width + 1) * elementsPerPixel + c] = row[elementsPerPixel + c];
+		}
+	}
+
+	// Converts the derivatives of the height (in units of the 0..255 range) into a normal
+	inline void heightDerivativesToNormal(int du, int dv, float scale, byte* out)
+	{
+		float nx = -(du / 255.0f) * scale;
+		float ny = -(dv / 255.0f) * scale;
+
+		float norm = 1.0f / std::sqrt(nx * nx + ny * ny + 1.0f);
+
+		out[0] = static_cast<byte>(float_to_integer((nx * norm + 1) * 127.5f));
+		out[1] = static_cast<byte>(float_to_integer((ny * norm + 1) * 127.5f));
+		out[2] = static_cast<byte>(float_to_integer((norm + 1) * 127.5f));
+		out[3] = 255;
+	}
+
+	// Computes the normals of a heightmap row, using a 3x3 Prewitt filter. The given
+	// column sums and differences (next row - previous row) are padded by one wrapped
+	// element on each side.
+	void heightmapRowToNormals(const int* columnSums, const int* columnDiffs, byte* out,
+		std::size_t width, float scale)
+	{
+		std::size_t x = 0;
+
+#if defined(NORMALMAP_KERNELS_SSE2)
+		const auto negativeScale = _mm_set1_ps(-scale);
+		const auto maxValue = _mm_set1_ps(255.0f);
+		const auto one = _mm_set1_ps(1.0f);
+		const auto half = _mm_set1_ps(127.5f);
+		const auto zero = _mm_setzero_ps();
+		const auto alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+
+		auto toByte = [&](__m128 component)
+		{
+			auto value = _mm_mul_ps(_mm_add_ps(component, one), half);
+			return _mm_cvtps_epi32(_mm_min_ps(_mm_max_ps(value, zero), maxValue));
+		};
+
+		for (; x + 4 <= width; x += 4)
+		{
+			auto du = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(columnSums + x + 2)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(columnSums + x)));
+
+			auto dv = _mm_add_epi32(_mm_add_epi32(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(columnDiffs + x)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(columnDiffs + x + 1))),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(columnDiffs + x + 2)));
+
+			auto nx = _mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(du), maxValue), negativeScale);
+			auto ny = _mm_mul_ps(_mm_div_ps(_mm_cvtepi32_ps(dv), maxValue), negativeScale);
+
+			auto lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), one);
+			auto norm = _mm_div_ps(one, _mm_sqrt_ps(lengthSquared));
+
+			auto r = toByte(_mm_mul_ps(nx, norm));
+			auto g = toByte(_mm_mul_ps(ny, norm));
+			auto b = toByte(norm);
+
+			auto pixels = _mm_or_si128(_mm_or_si128(r, _mm_slli_epi32(g, 8)),
+				_mm_or_si128(_mm_slli_epi32(b, 16), alpha));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4), pixels);
+		}
+#endif
+
+		for (; x < width; ++x)
+		{
+			heightDerivativesToNormal(columnSums[x + 2] - columnSums[x],
+				columnDiffs[x] + columnDiffs[x + 1] + columnDiffs[x + 2], scale, out + x * 4);
+		}
+	}
+
+	// Averages the two RGBA rows, rounding halfway values to even like lrint() does
+	void averageRows(const byte* one, const byte* two, byte* out, std::size_t numPixels)
+	{
+		std::size_t i = 0;
+		std::size_t numBytes = numPixels << 2;
+
+#if defined(NORMALMAP_KERNELS_SSE2)
+		const auto lowestBit = _mm_set1_epi8(1);
+		const auto alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+
+		for (; i + 16 <= numBytes; i += 16)
+		{
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(one + i));
+			auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(two + i));
+
+			// avg_epu8 rounds up, odd results of odd sums are stepping down to the even value
+			auto average = _mm_avg_epu8(a, b);
+			auto correction = _mm_and_si128(_mm_xor_si128(a, b), _mm_and_si128(average, lowestBit));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+				_mm_or_si128(_mm_sub_epi8(average, correction), alpha));
+		}
+#endif
+
+		for (; i < numBytes; i += 4)
+		{
+			for (std::size_t c = 0; c < 3; ++c)
+			{
+				int average = (one[i + c] + two[i + c] + 1) >> 1;
+				out[i + c] = static_cast<byte>(average - ((one[i + c] ^ two[i + c]) & average & 1));
+			}
+
+			out[i + 3] = 255;
+		}
+	}
+
+	// Divides the sum of nine values (at most 9*255) by 9, rounded to the nearest integer:
+	// (sum + 4) / 9 computed as ((sum + 4) * 7282) >> 16, which is exact in this range
+	inline byte averageOfNine(unsigned int sum)
+	{
+		return static_cast<byte>(((sum + 4) * 7282) >> 16);
+	}
+
+	// Averages the 3x3 neighbourhood of each RGBA pixel, the given column sums are holding
+	// the sums of the three rows for each channel, padded by one wrapped pixel on each side
+	void smoothRow(const std::uint16_t* columnSums, byte* out, std::size_t width)
+	{
+		std::size_t x = 0;
+
+#if defined(NORMALMAP_KERNELS_SSE2)
+		const auto rounding = _mm_set1_epi16(4);
+		const auto divisor = _mm_set1_epi16(7282);
+		const auto alpha = _mm_set1_epi32(static_cast<int>(OPAQUE_ALPHA));
+
+		// Each 16 bit vector holds two pixels
+		auto averageTwoPixels = [&](const std::uint16_t* sums)
+		{
+			auto sum = _mm_add_epi16(_mm_add_epi16(
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(sums)),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + 4))),
+				_mm_loadu_si128(reinterpret_cast<const __m128i*>(sums + 8)));
+
+			return _mm_mulhi_epu16(_mm_add_epi16(sum, rounding), divisor);
+		};
+
+		for (; x + 4 <= width; x += 4)
+		{
+			auto low = averageTwoPixels(columnSums + x * 4);
+			auto high = averageTwoPixels(columnSums + x * 4 + 8);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + x * 4),
+				_mm_or_si128(_mm_packus_epi16(low, high), alpha));
+		}
+#endif
+
+		for (; x < width; ++x)
+		{
+			const auto* sums = columnSums + x * 4;
+
+			for (std::size_t c = 0; c < 3; ++c)
+			{
+				out[x * 4 + c] = averageOfNine(sums[c] + sums[c + 4] + sums[c + 8]);
+			}
+
+			out[x * 4 + 3] = 255;
+		}
+	}
+}
+
+ImagePtr createNormalmapFromHeightmap(const ImagePtr& heightMap, float scale)
+{
+	assert(heightMap);
+
+	auto width = heightMap->getWidth();
+	auto height = heightMap->getHeight();
+
+	auto normalMap = std::make_shared<image::RGBAImage>(width, height);
+
+	const byte* in = heightMap->getPixels();
+	byte* out = normalMap->getPixels();
+
+	// if you want to understand the code below, read http://en.wikipedia.org/wiki/Edge_detection
+	// A 3x3 Prewitt filter is applied to the red channel. The horizontal derivative is the
+	// difference of the column sums right and left of the pixel, the vertical one is
+	// the sum of the (next row - previous row) differences of the three columns.
+	forEachRowBand(height, [&](std::size_t firstRow, std::size_t endRow)
+	{
+		std::vector<int> columnSums(width + 2);
+		std::vector<int> columnDiffs(width + 2);
+
+		for (auto y = firstRow; y < endRow; ++y)
+		{
+			const byte* previous = in + previousRow(y, height) * width * 4;
+			const byte* current = in + y * width * 4;
+			const byte* next = in + nextRow(y, height) * width * 4;
+
+			for (std::size_t x = 0; x < width; ++x)
+			{
+				columnSums[x + 1] = previous[x * 4] + current[x * 4] + next[x * 4];
+				columnDiffs[x + 1] = next[x * 4] - previous[x * 4];
+			}
+
+			wrapPadding(columnSums, 1);
+			wrapPadding(columnDiffs, 1);
+
+			heightmapRowToNormals(columnSums.data(), columnDiffs.data(), out + y * width * 4, width, scale);
+		}
+	});
+
+	return normalMap;
+}
+
+ImagePtr addNormalmaps(const ImagePtr& one, const ImagePtr& two)
+{
+	assert(one && two);
+	assert(one->getWidth() == two->getWidth() && one->getHeight() == two->getHeight());
+
+	auto width = one->getWidth();
+	auto height = one->getHeight();
+
+	auto result = std::make_shared<image::RGBAImage>(width, height);
+
+	const byte* pixOne = one->getPixels();
+	const byte* pixTwo = two->getPixels();
+	byte* pixOut = result->getPixels();
+
+	forEachRowBand(height, [&](std::size_t firstRow, std::size_t endRow)
+	{
+		auto offset = firstRow * width * 4;
+		averageRows(pixOne + offset, pixTwo + offset, pixOut + offset, (endRow - firstRow) * width);
+	});
+
+	return result;
+}
+
+ImagePtr smoothNormalmap(const ImagePtr& normalMap)
+{
+	assert(normalMap);
+
+	auto width = normalMap->getWidth();
+	auto height = normalMap->getHeight();
+
+	auto result = std::make_shared<image::RGBAImage>(width, height);
+
+	const byte* in = normalMap->getPixels();
+	byte* out = result->getPixels();
+
+	forEachRowBand(height, [&](std::size_t firstRow, std::size_t endRow)
+	{
+		// Per-channel sums of the previous, current and next row
+		std::vector<std::uint16_t> columnSums((width + 2) * 4);
+
+		for (auto y = firstRow; y < endRow; ++y)
+		{
+			const byte* previous = in + previousRow(y, height) * width * 4;
+			const byte* current = in + y * width * 4;
+			const byte* next = in + nextRow(y, height) * width * 4;
+
+			for (std::size_t i = 0; i < width * 4; ++i)
+			{
+				columnSums[i + 4] = static_cast<std::uint16_t>(previous[i] + current[i] + next[i]);
+			}
+
+			wrapPadding(columnSums, 4);
+
+			smoothRow(columnSums.data(), out + y * width * 4, width);
+		}
+	});
+
+	return result;
+}
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "iimage.h"
+
+namespace shaders
+{
+
+/**
+ * The image transforms of the heightmap(), addnormals() and smoothnormals()
+ * map expressions. All of them are processing the RGBA input in bands of rows,
+ * which are distributed over the task scheduler's workers. The border pixels
+ * are wrapping around to the opposite side of the image.
+ *
+ * The source images are left untouched, precompressed images are not supported.
+ */
+
+// Creates a normal map from the red channel of the given heightmap
+ImagePtr createNormalmapFromHeightmap(const ImagePtr& heightMap, float scale);
+
+// Averages the two normal maps, which need to have the same dimensions
+ImagePtr addNormalmaps(const ImagePtr& one, const ImagePtr& two);
+
+// Replaces each normal with the average of its 3x3 neighbourhood
+ImagePtr smoothNormalmap(const ImagePtr& normalMap);
+
+}
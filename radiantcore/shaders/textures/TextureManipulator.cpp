@@ -2,22 +2,152 @@
 
 #include "igl.h"
 #include <stdlib.h>
+#include <cstring>
+#include <vector>
 #include "itextstream.h"
 #include "registry/registry.h"
 #include "math/Vector3.h"
 #include "ipreferencesystem.h"
 #include "../MaterialManager.h"
 #include "RGBAImage.h"
+#include "CompressedTextureCache.h"
+#include "GLTextureManager.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_RESAMPLE_SSE2
+#endif
 
 namespace 
 {
-	static byte *row1 = NULL, *row2 = NULL;
-	static std::size_t rowsize = 0;
-
 	const std::size_t MAX_TEXTURE_QUALITY = 3;
 
 	const std::string RKEY_TEXTURES_QUALITY = "user/ui/textures/quality";
 	const std::string RKEY_TEXTURES_GAMMA = "user/ui/textures/gamma";
+
+	// Interpolates between the two rows byte by byte: out = row1 + ((row2 - row1) * lerp >> 16)
+	inline void lerpRows(const byte* row1, const byte* row2, byte* out, std::size_t numBytes, std::size_t lerp)
+	{
+		std::size_t i = 0;
+
+#if defined(TEXTURE_RESAMPLE_SSE2)
+		// The 16 bit multiplication is signed, factors >= 0x8000 are wrapping around to
+		// (lerp - 0x10000), which is compensated for by adding the difference once more
+		const auto factor = _mm_set1_epi16(static_cast<short>(lerp));
+		const auto correction = _mm_set1_epi16(lerp >= 0x8000 ? -1 : 0);
+		const auto zero = _mm_setzero_si128();
+
+		for (; i + 16 <= numBytes; i += 16)
+		{
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+			auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row2 + i));
+
+			auto aLow = _mm_unpacklo_epi8(a, zero);
+			auto aHigh = _mm_unpackhi_epi8(a, zero);
+			auto diffLow = _mm_sub_epi16(_mm_unpacklo_epi8(b, zero), aLow);
+			auto diffHigh = _mm_sub_epi16(_mm_unpackhi_epi8(b, zero), aHigh);
+
+			auto low = _mm_add_epi16(aLow, _mm_add_epi16(_mm_mulhi_epi16(diffLow, factor), _mm_and_si128(diffLow, correction)));
+			auto high = _mm_add_epi16(aHigh, _mm_add_epi16(_mm_mulhi_epi16(diffHigh, factor), _mm_and_si128(diffHigh, correction)));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+		}
+#endif
+
+		for (; i < numBytes; ++i)
+		{
+			out[i] = static_cast<byte>((((row2[i] - row1[i]) * static_cast<int>(lerp)) >> 16) + row1[i]);
+		}
+	}
+
+	// Averages 2x2 blocks of RGBA pixels of the two given rows into numPixels output pixels
+	inline void reduceRowsAndColumns(const byte* row1, const byte* row2, byte* out, std::size_t numPixels)
+	{
+		std::size_t x = 0;
+
+#if defined(TEXTURE_RESAMPLE_SSE2)
+		const auto zero = _mm_setzero_si128();
+
+		for (; x + 2 <= numPixels; x += 2, row1 += 16, row2 += 16, out += 8)
+		{
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1));
+			auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row2));
+
+			// Vertical sums of the pixels 0,1 and 2,3, then add the neighbouring pixels
+			auto low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+			auto high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+			auto sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+
+			auto result = _mm_srli_epi16(sum, 2);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(result, result));
+		}
+#endif
+
+		for (; x < numPixels; ++x, row1 += 8, row2 += 8, out += 4)
+		{
+			out[0] = (byte) ((row1[0] + row1[4] + row2[0] + row2[4]) >> 2);
+			out[1] = (byte) ((row1[1] + row1[5] + row2[1] + row2[5]) >> 2);
+			out[2] = (byte) ((row1[2] + row1[6] + row2[2] + row2[6]) >> 2);
+			out[3] = (byte) ((row1[3] + row1[7] + row2[3] + row2[7]) >> 2);
+		}
+	}
+
+	// Averages horizontal pairs of RGBA pixels into numPixels output pixels
+	inline void reduceColumns(const byte* row, byte* out, std::size_t numPixels)
+	{
+		std::size_t x = 0;
+
+#if defined(TEXTURE_RESAMPLE_SSE2)
+		const auto zero = _mm_setzero_si128();
+
+		for (; x + 2 <= numPixels; x += 2, row += 16, out += 8)
+		{
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+
+			auto low = _mm_unpacklo_epi8(a, zero);
+			auto high = _mm_unpackhi_epi8(a, zero);
+			auto sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), _mm_unpackhi_epi64(low, high));
+
+			auto result = _mm_srli_epi16(sum, 1);
+			_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(result, result));
+		}
+#endif
+
+		for (; x < numPixels; ++x, row += 8, out += 4)
+		{
+			out[0] = (byte) ((row[0] + row[4]) >> 1);
+			out[1] = (byte) ((row[1] + row[5]) >> 1);
+			out[2] = (byte) ((row[2] + row[6]) >> 1);
+			out[3] = (byte) ((row[3] + row[7]) >> 1);
+		}
+	}
+
+	// Averages the vertically neighbouring RGBA pixels of the two given rows
+	inline void reduceRows(const byte* row1, const byte* row2, byte* out, std::size_t numPixels)
+	{
+		std::size_t i = 0;
+		std::size_t numBytes = numPixels << 2;
+
+#if defined(TEXTURE_RESAMPLE_SSE2)
+		const auto zero = _mm_setzero_si128();
+
+		for (; i + 16 <= numBytes; i += 16)
+		{
+			auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + i));
+			auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row2 + i));
+
+			auto low = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)), 1);
+			auto high = _mm_srli_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)), 1);
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(low, high));
+		}
+#endif
+
+		for (; i < numBytes; ++i)
+		{
+			out[i] = (byte) ((row1[i] + row2[i]) >> 1);
+		}
+	}
 }
 
 namespace shaders {
@@ -293,189 +423,57 @@ R_ResampleTexture
 void TextureManipulator::resampleTexture(const void *indata, std::size_t inwidth, std::size_t inheight,
 										 void *outdata,  std::size_t outwidth, std::size_t outheight, int bytesperpixel)
 {
-	if (rowsize < outwidth * bytesperpixel) {
-		if (row1)
-			free(row1);
-		if (row2)
-			free(row2);
-
-		rowsize = outwidth * bytesperpixel;
-		row1 = (byte *)malloc(rowsize);
-		row2 = (byte *)malloc(rowsize);
+	if (bytesperpixel != 3 && bytesperpixel != 4) {
+		rMessage() << "R_ResampleTexture: unsupported bytesperpixel " << bytesperpixel << "\n";
+		return;
 	}
 
-	if (bytesperpixel == 4) {
-		std::size_t i, yi, oldy, f, fstep, lerp, endy = (inheight-1), inwidth4 = inwidth*4, outwidth4 = outwidth*4;
-		long j;
-		byte *inrow, *out;
-		out = (byte *)outdata;
-		fstep = (int) (inheight * 65536.0f / outheight);
-#define LERPBYTE(i) out[i] = (byte) ((((row2[i] - row1[i]) * lerp) >> 16) + row1[i])
+	std::size_t inRowSize = inwidth * bytesperpixel;
+	std::size_t outRowSize = outwidth * bytesperpixel;
 
-		inrow = (byte *)indata;
-		oldy = 0;
-		resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-		resampleTextureLerpLine(inrow + inwidth4, row2, inwidth, outwidth, bytesperpixel);
+	// The two horizontally resampled input rows the output rows are interpolated from.
+	// Map expressions are resampling their images on several threads, don't share these.
+	std::vector<byte> row1(outRowSize);
+	std::vector<byte> row2(outRowSize);
 
-		for (i = 0, f = 0;i < outheight;i++,f += fstep) {
-			yi = f >> 16;
-			if (yi < endy) {
-				lerp = f & 0xFFFF;
-				if (yi != oldy) {
-					inrow = (byte *)indata + inwidth4 * yi;
-					if (yi == oldy+1)
-						memcpy(row1, row2, outwidth4);
-					else
-						resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-
-					resampleTextureLerpLine(inrow + inwidth4, row2, inwidth, outwidth, bytesperpixel);
-					oldy = yi;
-				}
-				j = static_cast<long>(outwidth - 4);
-				while (j >= 0) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					LERPBYTE( 3);
-					LERPBYTE( 4);
-					LERPBYTE( 5);
-					LERPBYTE( 6);
-					LERPBYTE( 7);
-					LERPBYTE( 8);
-					LERPBYTE( 9);
-					LERPBYTE(10);
-					LERPBYTE(11);
-					LERPBYTE(12);
-					LERPBYTE(13);
-					LERPBYTE(14);
-					LERPBYTE(15);
-					out += 16;
-					row1 += 16;
-					row2 += 16;
-					j -= 4;
-				}
-				if (j & 2) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					LERPBYTE( 3);
-					LERPBYTE( 4);
-					LERPBYTE( 5);
-					LERPBYTE( 6);
-					LERPBYTE( 7);
-					out += 8;
-					row1 += 8;
-					row2 += 8;
-				}
-				if (j & 1) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					LERPBYTE( 3);
-					out += 4;
-					row1 += 4;
-					row2 += 4;
-				}
-				row1 -= outwidth4;
-				row2 -= outwidth4;
-			}
-			else {
-				if (yi != oldy) {
-					inrow = (byte *)indata + inwidth4*yi;
-					if (yi == oldy+1)
-						memcpy(row1, row2, outwidth4);
-					else
-						resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-
-					oldy = yi;
-				}
-				memcpy(out, row1, outwidth4);
-			}
-		}
+	const byte* in = static_cast<const byte*>(indata);
+	byte* out = static_cast<byte*>(outdata);
+
+	std::size_t fstep = static_cast<std::size_t>(inheight * 65536.0f / outheight);
+	std::size_t endy = inheight - 1;
+	std::size_t oldy = 0;
+
+	resampleTextureLerpLine(in, row1.data(), inwidth, outwidth, bytesperpixel);
+
+	if (inheight > 1) {
+		resampleTextureLerpLine(in + inRowSize, row2.data(), inwidth, outwidth, bytesperpixel);
 	}
-	else if (bytesperpixel == 3) {
-		std::size_t i, yi, oldy, f, fstep, lerp, endy = (inheight-1), inwidth3 = inwidth * 3, outwidth3 = outwidth * 3;
-		long j;
-		byte *inrow, *out;
-		out = (byte *)outdata;
-		fstep = (int) (inheight*65536.0f/outheight);
-#define LERPBYTE(i) out[i] = (byte) ((((row2[i] - row1[i]) * lerp) >> 16) + row1[i])
 
-		inrow = (byte *)indata;
-		oldy = 0;
-		resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-		resampleTextureLerpLine(inrow + inwidth3, row2, inwidth, outwidth, bytesperpixel);
-		for (i = 0, f = 0;i < outheight;i++,f += fstep) {
-			yi = f >> 16;
-			if (yi < endy) {
-				lerp = f & 0xFFFF;
-				if (yi != oldy) {
-					inrow = (byte *)indata + inwidth3*yi;
-					if (yi == oldy+1)
-						memcpy(row1, row2, outwidth3);
-					else
-						resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-
-					resampleTextureLerpLine(inrow + inwidth3, row2, inwidth, outwidth, bytesperpixel);
-					oldy = yi;
-				}
-				j = static_cast<long>(outwidth - 4);
-				while (j >= 0) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					LERPBYTE( 3);
-					LERPBYTE( 4);
-					LERPBYTE( 5);
-					LERPBYTE( 6);
-					LERPBYTE( 7);
-					LERPBYTE( 8);
-					LERPBYTE( 9);
-					LERPBYTE(10);
-					LERPBYTE(11);
-					out += 12;
-					row1 += 12;
-					row2 += 12;
-					j -= 4;
-				}
-				if (j & 2) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					LERPBYTE( 3);
-					LERPBYTE( 4);
-					LERPBYTE( 5);
-					out += 6;
-					row1 += 6;
-					row2 += 6;
-				}
-				if (j & 1) {
-					LERPBYTE( 0);
-					LERPBYTE( 1);
-					LERPBYTE( 2);
-					out += 3;
-					row1 += 3;
-					row2 += 3;
-				}
-				row1 -= outwidth3;
-				row2 -= outwidth3;
-			}
-			else {
-				if (yi != oldy) {
-					inrow = (byte *)indata + inwidth3*yi;
-					if (yi == oldy+1)
-						memcpy(row1, row2, outwidth3);
-					else
-						resampleTextureLerpLine(inrow, row1, inwidth, outwidth, bytesperpixel);
-
-					oldy = yi;
-				}
-				memcpy(out, row1, outwidth3);
-			}
+	for (std::size_t i = 0, f = 0; i < outheight; i++, f += fstep, out += outRowSize) {
+		std::size_t yi = f >> 16;
+
+		if (yi != oldy) {
+			const byte* inrow = in + inRowSize * yi;
+
+			// Moving on to the next row, the second row has already been resampled
+			if (yi == oldy + 1)
+				row1.swap(row2);
+			else
+				resampleTextureLerpLine(inrow, row1.data(), inwidth, outwidth, bytesperpixel);
+
+			if (yi < endy)
+				resampleTextureLerpLine(inrow + inRowSize, row2.data(), inwidth, outwidth, bytesperpixel);
+
+			oldy = yi;
+		}
+
+		if (yi < endy) {
+			lerpRows(row1.data(), row2.data(), out, outRowSize, f & 0xFFFF);
+		}
+		else {
+			// Last row of the input has no row to lerp to
+			memcpy(out, row1.data(), outRowSize);
 		}
-	}
-	else {
-		rMessage() << "R_ResampleTexture: unsupported bytesperpixel " << bytesperpixel << "\n";
 	}
 }
 
@@ -484,7 +482,7 @@ void TextureManipulator::mipReduce(byte *in, byte *out,
 								   std::size_t width, std::size_t height,
 								   std::size_t destwidth, std::size_t destheight)
 {
-	std::size_t x, y, width2, height2, nextrow;
+	std::size_t y, width2, height2, nextrow;
 	if (width > destwidth) {
 		if (height > destheight) {
 			// reduce both
@@ -492,29 +490,18 @@ void TextureManipulator::mipReduce(byte *in, byte *out,
 			height2 = height >> 1;
 			nextrow = width << 2;
 			for (y = 0;y < height2;y++) {
-				for (x = 0;x < width2;x++) {
-					out[0] = (byte) ((in[0] + in[4] + in[nextrow  ] + in[nextrow+4]) >> 2);
-					out[1] = (byte) ((in[1] + in[5] + in[nextrow+1] + in[nextrow+5]) >> 2);
-					out[2] = (byte) ((in[2] + in[6] + in[nextrow+2] + in[nextrow+6]) >> 2);
-					out[3] = (byte) ((in[3] + in[7] + in[nextrow+3] + in[nextrow+7]) >> 2);
-					out += 4;
-					in += 8;
-				}
-				in += nextrow; // skip a line
+				reduceRowsAndColumns(in, in + nextrow, out, width2);
+				out += width2 << 2;
+				in += nextrow << 1; // skip a line
 			}
 		}
 		else {
 			// reduce width
 			width2 = width >> 1;
 			for (y = 0;y < height;y++) {
-				for (x = 0;x < width2;x++) {
-					out[0] = (byte) ((in[0] + in[4]) >> 1);
-					out[1] = (byte) ((in[1] + in[5]) >> 1);
-					out[2] = (byte) ((in[2] + in[6]) >> 1);
-					out[3] = (byte) ((in[3] + in[7]) >> 1);
-					out += 4;
-					in += 8;
-				}
+				reduceColumns(in, out, width2);
+				out += width2 << 2;
+				in += width << 2;
 			}
 		}
 	}
@@ -524,15 +511,9 @@ void TextureManipulator::mipReduce(byte *in, byte *out,
 			height2 = height >> 1;
 			nextrow = width << 2;
 			for (y = 0;y < height2;y++) {
-				for (x = 0;x < width;x++) {
-					out[0] = (byte) ((in[0] + in[nextrow  ]) >> 1);
-					out[1] = (byte) ((in[1] + in[nextrow+1]) >> 1);
-					out[2] = (byte) ((in[2] + in[nextrow+2]) >> 1);
-					out[3] = (byte) ((in[3] + in[nextrow+3]) >> 1);
-					out += 4;
-					in += 4;
-				}
-				in += nextrow; // skip a line
+				reduceRows(in, in + nextrow, out, width);
+				out += nextrow;
+				in += nextrow << 1; // skip a line
 			}
 		}
 		else {
@@ -559,6 +540,11 @@ void TextureManipulator::constructPreferences()
 
 	// Texture Gamma Settings
 	page.appendSpinner("Texture Gamma", RKEY_TEXTURES_GAMMA, 0.0f, 1.0f, 10);
+
+	page.appendCheckBox("Cache compressed textures on disk", RKEY_TEXTURES_COMPRESSED_CACHE);
+
+	// Texture memory budget in MB, 0 disables the demotion of unused textures
+	page.appendSpinner("Texture Memory Budget (MB, 0 = unlimited)", RKEY_TEXTURES_MEMORY_BUDGET, 0.0f, 65536.0f, 0);
 }
 
 } // namespace shaders
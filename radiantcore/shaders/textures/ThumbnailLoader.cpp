@@ -0,0 +1,334 @@
+#include "ThumbnailLoader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <thread>
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/dir.h"
+#include "os/fs.h"
+#include "stream/FileInputStream.h"
+#include "stream/utils.h"
+#include "RGBAImage.h"
+
+#include "CompressedTextureCache.h"
+#include "TextureManipulator.h"
+
+namespace shaders
+{
+
+namespace
+{
+    // Increase this to invalidate all existing thumbnail files
+    constexpr uint32_t THUMBNAIL_VERSION = 1;
+
+    // "DRTN" in little endian byte order
+    constexpr uint32_t THUMBNAIL_MAGIC = 0x4e545244;
+
+    // Older requests are dropped, they are requested again when they become visible
+    constexpr std::size_t MAX_QUEUED_THUMBNAILS = 1024;
+}
+
+ThumbnailLoader::ThumbnailLoader(const std::string& cachePath) :
+    _cachePath(cachePath),
+    _numRunningWorkers(0)
+{}
+
+ThumbnailLoader::~ThumbnailLoader()
+{
+    stop();
+}
+
+ThumbnailLoader::ThumbnailPtr ThumbnailLoader::getThumbnail(const std::string& materialName,
+                                                            const MapExpressionPtr& expression)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto ready = _readyThumbnails.find(materialName);
+
+    if (ready != _readyThumbnails.end())
+    {
+        auto thumbnail = ready->second;
+        _readyThumbnails.erase(ready);
+        return thumbnail;
+    }
+
+    // Materials without editor image don't need a worker
+    if (!expression)
+    {
+        return std::make_shared<Thumbnail>();
+    }
+
+    if (!_pendingThumbnails.insert(materialName).second)
+    {
+        // Move the request to the back such that it's processed next
+        auto queued = std::find_if(_queue.begin(), _queue.end(), [&](const QueuedThumbnail& request)
+        {
+            return request.materialName == materialName;
+        });
+
+        if (queued != _queue.end() && queued + 1 != _queue.end())
+        {
+            auto request = std::move(*queued);
+            _queue.erase(queued);
+            _queue.emplace_back(std::move(request));
+        }
+
+        return ThumbnailPtr();
+    }
+
+    _queue.emplace_back(QueuedThumbnail{ materialName, expression });
+
+    if (_queue.size() > MAX_QUEUED_THUMBNAILS)
+    {
+        _pendingThumbnails.erase(_queue.front().materialName);
+        _queue.pop_front();
+    }
+
+    // Clean up the workers which are done
+    _workers.erase(std::remove_if(_workers.begin(), _workers.end(), [](const std::future<void>& worker)
+    {
+        return worker.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }), _workers.end());
+
+    // Start another worker if the ones running are all busy
+    auto maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    if (_numRunningWorkers < std::min<std::size_t>(maxWorkers, _queue.size()))
+    {
+        ++_numRunningWorkers;
+        _workers.emplace_back(std::async(std::launch::async, &ThumbnailLoader::processQueue, this));
+    }
+
+    return ThumbnailPtr();
+}
+
+sigc::signal<void> ThumbnailLoader::signal_thumbnailReady()
+{
+    return _sigThumbnailReady;
+}
+
+void ThumbnailLoader::stop()
+{
+    std::vector<std::future<void>> workers;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        for (const auto& request : _queue)
+        {
+            _pendingThumbnails.erase(request.materialName);
+        }
+
+        _queue.clear();
+        workers.swap(_workers);
+    }
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+void ThumbnailLoader::processQueue()
+{
+    while (true)
+    {
+        QueuedThumbnail request;
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            if (_queue.empty())
+            {
+                --_numRunningWorkers;
+                return;
+            }
+
+            // The most recent request first, that's the one the user is looking at
+            request = std::move(_queue.back());
+            _queue.pop_back();
+        }
+
+        ThumbnailPtr thumbnail;
+
+        try
+        {
+            thumbnail = generateThumbnail(*request.expression);
+        }
+        catch (const std::exception& ex)
+        {
+            rError() << "Failed to generate thumbnail for " << request.materialName << ": " << ex.what() << std::endl;
+            thumbnail = std::make_shared<Thumbnail>();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+
+            _pendingThumbnails.erase(request.materialName);
+            _readyThumbnails[request.materialName] = thumbnail;
+
+            // Emit the signal while holding the lock, such that it is never emitted concurrently
+            _sigThumbnailReady.emit();
+        }
+    }
+}
+
+ThumbnailLoader::ThumbnailPtr ThumbnailLoader::generateThumbnail(const MapExpression& expression)
+{
+    // The key is empty for images which are not files in the VFS, these are not stored
+    auto key = CompressedTextureCache::GetKey(expression, BindableTexture::Role::COLOUR);
+    auto filename = !key.empty() ? _cachePath + key + ".thumb" : std::string();
+
+    if (!filename.empty() && os::fileOrDirExists(filename))
+    {
+        if (auto thumbnail = loadThumbnail(filename); thumbnail)
+        {
+            return thumbnail;
+        }
+
+        rWarning() << "[shaders] Ignoring invalid thumbnail " << filename << std::endl;
+    }
+
+    auto thumbnail = std::make_shared<Thumbnail>();
+    auto image = expression.getImage();
+
+    if (!image) return thumbnail;
+
+    thumbnail->width = image->getWidth();
+    thumbnail->height = image->getHeight();
+
+    // Precompressed images would need to be decompressed first, these are shown at full size
+    if (!image->isPrecompressed() && image->getGLFormat() == GL_RGBA)
+    {
+        thumbnail->image = CreateThumbnail(*image, IMaterialManager::THUMBNAIL_SIZE);
+    }
+
+    if (!filename.empty() && thumbnail->image)
+    {
+        saveThumbnail(filename, *thumbnail);
+    }
+
+    return thumbnail;
+}
+
+ImagePtr ThumbnailLoader::CreateThumbnail(const Image& image, std::size_t size)
+{
+    auto width = image.getWidth();
+    auto height = image.getHeight();
+
+    if (width == 0 || height == 0) return ImagePtr();
+
+    // Scale the larger side down to the thumbnail size, preserving the aspect ratio
+    auto largerSide = std::max(width, height);
+    auto targetWidth = largerSide > size ? std::max<std::size_t>(width * size / largerSide, 1) : width;
+    auto targetHeight = largerSide > size ? std::max<std::size_t>(height * size / largerSide, 1) : height;
+
+    std::vector<byte> pixels(image.getPixels(), image.getPixels() + width * height * 4);
+
+    // Halve the image while it's at least twice the target size, such that
+    // the final bilinear resampling isn't skipping any source pixels
+    while (width >= targetWidth * 2 && height >= targetHeight * 2)
+    {
+        TextureManipulator::instance().mipReduce(pixels.data(), pixels.data(), width, height, width / 2, height / 2);
+        width /= 2;
+        height /= 2;
+    }
+
+    auto thumbnail = std::make_shared<image::RGBAImage>(targetWidth, targetHeight);
+
+    if (width == targetWidth && height == targetHeight)
+    {
+        std::copy(pixels.begin(), pixels.begin() + width * height * 4, thumbnail->getPixels());
+    }
+    else
+    {
+        TextureManipulator::instance().resampleTexture(pixels.data(), width, height,
+            thumbnail->getPixels(), targetWidth, targetHeight, 4);
+    }
+
+    return thumbnail;
+}
+
+ThumbnailLoader::ThumbnailPtr ThumbnailLoader::loadThumbnail(const std::string& filename)
+{
+    stream::FileInputStream file(filename);
+
+    if (file.failed()) return ThumbnailPtr();
+
+    if (stream::readLittleEndian<uint32_t>(file) != THUMBNAIL_MAGIC ||
+        stream::readLittleEndian<uint32_t>(file) != THUMBNAIL_VERSION)
+    {
+        return ThumbnailPtr();
+    }
+
+    auto thumbnail = std::make_shared<Thumbnail>();
+    thumbnail->width = stream::readLittleEndian<uint32_t>(file);
+    thumbnail->height = stream::readLittleEndian<uint32_t>(file);
+
+    auto thumbnailWidth = stream::readLittleEndian<uint32_t>(file);
+    auto thumbnailHeight = stream::readLittleEndian<uint32_t>(file);
+
+    if (thumbnailWidth == 0 || thumbnailWidth > IMaterialManager::THUMBNAIL_SIZE ||
+        thumbnailHeight == 0 || thumbnailHeight > IMaterialManager::THUMBNAIL_SIZE)
+    {
+        return ThumbnailPtr();
+    }
+
+    auto image = std::make_shared<image::RGBAImage>(thumbnailWidth, thumbnailHeight);
+    auto numBytes = static_cast<std::size_t>(thumbnailWidth) * thumbnailHeight * 4;
+
+    if (file.read(image->getPixels(), numBytes) != numBytes)
+    {
+        return ThumbnailPtr();
+    }
+
+    thumbnail->image = image;
+    return thumbnail;
+}
+
+void ThumbnailLoader::saveThumbnail(const std::string& filename, const Thumbnail& thumbnail)
+{
+    if (!os::fileOrDirExists(_cachePath) && !os::makeDirectory(_cachePath))
+    {
+        rWarning() << "[shaders] Cannot create thumbnail folder " << _cachePath << std::endl;
+        return;
+    }
+
+    // Write to a temporary file first, such that no truncated files are left behind
+    // Several workers might be writing the same thumbnail, use a unique name for each thread
+    auto tempFilename = filename + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+
+    {
+        std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            rWarning() << "[shaders] Cannot write thumbnail " << filename << std::endl;
+            return;
+        }
+
+        const auto& image = *thumbnail.image;
+
+        stream::writeLittleEndian<uint32_t>(file, THUMBNAIL_MAGIC);
+        stream::writeLittleEndian<uint32_t>(file, THUMBNAIL_VERSION);
+        stream::writeLittleEndian<uint32_t>(file, static_cast<uint32_t>(thumbnail.width));
+        stream::writeLittleEndian<uint32_t>(file, static_cast<uint32_t>(thumbnail.height));
+        stream::writeLittleEndian<uint32_t>(file, static_cast<uint32_t>(image.getWidth()));
+        stream::writeLittleEndian<uint32_t>(file, static_cast<uint32_t>(image.getHeight()));
+
+        file.write(reinterpret_cast<const char*>(image.getPixels()), image.getWidth() * image.getHeight() * 4);
+    }
+
+    std::error_code ec;
+    fs::rename(tempFilename, filename, ec);
+
+    if (ec)
+    {
+        rWarning() << "[shaders] Cannot write thumbnail " << filename << ": " << ec.message() << std::endl;
+        fs::remove(tempFilename, ec);
+    }
+}
+
+}
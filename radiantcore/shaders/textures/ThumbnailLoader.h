@@ -0,0 +1,87 @@
+#pragma once
+
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
+#include <sigc++/signal.h>
+#include "ishaders.h"
+#include "../MapExpression.h"
+
+namespace shaders
+{
+
+/**
+ * Generates the editor image thumbnails shown by the texture browsers.
+ *
+ * The thumbnails are evaluated and downsampled by worker threads, and stored
+ * in an on-disk cache folder. The cache files are keyed on the map expression
+ * and the path, size and modification time of its source images, like the
+ * entries of the CompressedTextureCache, so a changed image file is picked up
+ * the next time its thumbnail is requested.
+ */
+class ThumbnailLoader
+{
+public:
+    using Thumbnail = IMaterialManager::EditorImageThumbnail;
+    using ThumbnailPtr = IMaterialManager::EditorImageThumbnailPtr;
+
+private:
+    struct QueuedThumbnail
+    {
+        std::string materialName;
+        MapExpressionPtr expression;
+    };
+
+    std::string _cachePath;
+
+    // Guards all members below
+    std::mutex _lock;
+
+    // Requests waiting for a worker, the most recent request at the back
+    std::deque<QueuedThumbnail> _queue;
+
+    // Requests which are queued or being generated
+    std::set<std::string> _pendingThumbnails;
+
+    // Thumbnails waiting to be picked up
+    std::map<std::string, ThumbnailPtr> _readyThumbnails;
+
+    std::vector<std::future<void>> _workers;
+    std::size_t _numRunningWorkers;
+
+    sigc::signal<void> _sigThumbnailReady;
+
+public:
+    // Cache files are stored in the given folder, which is created on demand
+    ThumbnailLoader(const std::string& cachePath);
+    ~ThumbnailLoader();
+
+    /**
+     * Returns the thumbnail generated for the given material, if it's ready.
+     * Otherwise its generation from the given expression is queued, if that's
+     * not already done, and an empty pointer is returned.
+     */
+    ThumbnailPtr getThumbnail(const std::string& materialName, const MapExpressionPtr& expression);
+
+    // Emitted by the worker threads when a thumbnail is ready
+    sigc::signal<void> signal_thumbnailReady();
+
+    // Blocks until the running workers are done, the queued requests are dropped
+    void stop();
+
+    // Downsamples the given RGBA image to fit into a square of the given size
+    static ImagePtr CreateThumbnail(const Image& image, std::size_t size);
+
+private:
+    void processQueue();
+
+    ThumbnailPtr generateThumbnail(const MapExpression& expression);
+
+    ThumbnailPtr loadThumbnail(const std::string& filename);
+    void saveThumbnail(const std::string& filename, const Thumbnail& thumbnail);
+};
+
+}
@@ -173,8 +173,10 @@ void Doom3SkinCache::shutdownModule()
     _declsReloadedConnection.disconnect();
 
     _modelSkins.clear();
+    _skinModels.clear();
     _allSkins.clear();
     _skinsPendingReparse.clear();
+    _skinsChangedSinceSceneUpdate.clear();
 }
 
 void Doom3SkinCache::subscribeToSkin(const decl::ISkin::Ptr& skin)
@@ -192,10 +194,13 @@ void Doom3SkinCache::handleSkinAddition(const std::string& name)
     auto skin = findSkin(name);
     if (!skin) return;
 
+    auto& models = _skinModels[name];
+
     for (const auto& modelName : skin->getModels())
     {
         auto& matchingSkins = _modelSkins.try_emplace(modelName).first->second;
         matchingSkins.push_back(skin->getDeclName());
+        models.push_back(modelName);
     }
 
     subscribeToSkin(skin);
@@ -212,14 +217,22 @@ void Doom3SkinCache::handleSkinRemoval(const std::string& name)
         _allSkins.erase(allSkinIt);
     }
 
-    for (auto& [_, matchingSkins] : _modelSkins)
+    // Only visit the models this skin has been associated with
+    auto skinModels = _skinModels.find(name);
+    if (skinModels == _skinModels.end()) return;
+
+    for (const auto& modelName : skinModels->second)
     {
+        auto& matchingSkins = _modelSkins[modelName];
+
         auto found = std::find(matchingSkins.begin(), matchingSkins.end(), name);
         if (found != matchingSkins.end())
         {
             matchingSkins.erase(found);
         }
     }
+
+    _skinModels.erase(skinModels);
 }
 
 void Doom3SkinCache::onSkinDeclCreated(decl::Type type, const std::string& name)
@@ -228,6 +241,7 @@ void Doom3SkinCache::onSkinDeclCreated(decl::Type type, const std::string& name)
 
     std::lock_guard<std::mutex> lock(_cacheLock);
     handleSkinAddition(name);
+    _skinsChangedSinceSceneUpdate.insert(name);
 }
 
 void Doom3SkinCache::onSkinDeclRemoved(decl::Type type, const std::string& name)
@@ -237,6 +251,7 @@ void Doom3SkinCache::onSkinDeclRemoved(decl::Type type, const std::string& name)
     std::lock_guard<std::mutex> lock(_cacheLock);
     handleSkinRemoval(name);
     _skinsPendingReparse.erase(name);
+    _skinsChangedSinceSceneUpdate.insert(name);
 }
 
 void Doom3SkinCache::onSkinDeclRenamed(decl::Type type, const std::string& oldName, const std::string& newName)
@@ -246,6 +261,8 @@ void Doom3SkinCache::onSkinDeclRenamed(decl::Type type, const std::string& oldNa
     std::lock_guard<std::mutex> lock(_cacheLock);
     handleSkinRemoval(oldName);
     handleSkinAddition(newName);
+    _skinsChangedSinceSceneUpdate.insert(oldName);
+    _skinsChangedSinceSceneUpdate.insert(newName);
 }
 
 void Doom3SkinCache::unsubscribeFromAllSkins()
@@ -264,52 +281,63 @@ void Doom3SkinCache::onSkinDeclChanged(decl::ISkin& skin)
 
     // Add it to the pile, it will be processed once we need to access the cached lists
     _skinsPendingReparse.insert(skin.getDeclName());
+    _skinsChangedSinceSceneUpdate.insert(skin.getDeclName());
 }
 
 void Doom3SkinCache::onSkinDeclsReloaded()
 {
+    std::set<std::string, string::ILess> changedSkins;
+
     {
         std::lock_guard<std::mutex> lock(_cacheLock);
 
+        // Skins appearing or disappearing during the reload don't send any signals
+        std::set<std::string, string::ILess> previousSkins(_allSkins.begin(), _allSkins.end());
+
         unsubscribeFromAllSkins();
         _modelSkins.clear();
+        _skinModels.clear();
         _allSkins.clear();
+        _skinsPendingReparse.clear();
 
         // Re-build the lists and mappings
         GlobalDeclarationManager().foreachDeclaration(decl::Type::Skin, [&](const decl::IDeclaration::Ptr& decl)
         {
-            auto skin = std::static_pointer_cast<Skin>(decl);
-
-            _allSkins.push_back(skin->getDeclName());
-
-            skin->foreachMatchingModel([&](const std::string& modelName)
+            if (previousSkins.erase(decl->getDeclName()) == 0)
             {
-                auto& matchingSkins = _modelSkins.try_emplace(modelName).first->second;
-                matchingSkins.push_back(skin->getDeclName());
-            });
+                _skinsChangedSinceSceneUpdate.insert(decl->getDeclName());
+            }
 
-            subscribeToSkin(skin);
+            handleSkinAddition(decl->getDeclName());
         });
+
+        _skinsChangedSinceSceneUpdate.insert(previousSkins.begin(), previousSkins.end());
+        changedSkins.swap(_skinsChangedSinceSceneUpdate);
     }
 
     // Run an update of the active scene, if the module is present
-    if (module::GlobalModuleRegistry().moduleExists(MODULE_SCENEGRAPH))
+    if (!changedSkins.empty() && module::GlobalModuleRegistry().moduleExists(MODULE_SCENEGRAPH))
     {
-        updateModelsInScene();
+        updateModelsInScene(changedSkins);
     }
 
     signal_skinsReloaded().emit();
 }
 
-void Doom3SkinCache::updateModelsInScene()
+void Doom3SkinCache::updateModelsInScene(const std::set<std::string, string::ILess>& changedSkins)
 {
-    GlobalSceneGraph().foreachNode([](const scene::INodePtr& node)->bool
+    GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)->bool
     {
         // Check if we have a skinnable model
         if (auto skinned = std::dynamic_pointer_cast<SkinnedModel>(node); skinned)
         {
-            // Let the skinned model reload its current skin.
-            skinned->skinChanged(skinned->getSkin());
+            auto skin = skinned->getSkin();
+
+            // Let the skinned model reload its current skin, if it has been changed
+            if (changedSkins.count(skin) > 0)
+            {
+                skinned->skinChanged(skin);
+            }
         }
 
         return true; // traverse further
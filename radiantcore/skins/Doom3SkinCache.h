@@ -9,8 +9,10 @@
 
 #include <sigc++/connection.h>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
+#include "string/string.h"
 
 namespace skins
 {
@@ -30,6 +32,9 @@ class Doom3SkinCache :
 	// which are contained in the main NamedSkinMap.
     std::map<std::string, std::vector<std::string>> _modelSkins;
 
+    // Reverse index: the model paths each skin has been added to in _modelSkins
+    std::map<std::string, std::vector<std::string>> _skinModels;
+
 	sigc::signal<void> _sigSkinsReloaded;
     sigc::connection _declsReloadedConnection;
     sigc::connection _declCreatedConnection;
@@ -40,6 +45,10 @@ class Doom3SkinCache :
     std::map<std::string, sigc::connection> _declChangedConnections;
     std::set<std::string> _skinsPendingReparse;
 
+    // Skins which have been changed, created or removed since the last scene update,
+    // only the models using one of these skins are refreshed after a reload
+    std::set<std::string, string::ILess> _skinsChangedSinceSceneUpdate;
+
 public:
     decl::ISkin::Ptr findSkin(const std::string& name) override;
     bool renameSkin(const std::string& oldName, const std::string& newName) override;
@@ -64,7 +73,7 @@ public:
 
 private:
     void onSkinDeclsReloaded();
-    void updateModelsInScene();
+    void updateModelsInScene(const std::set<std::string, string::ILess>& changedSkins);
     void onSkinDeclCreated(decl::Type type, const std::string& name);
     void onSkinDeclRemoved(decl::Type type, const std::string& name);
     void onSkinDeclRenamed(decl::Type type, const std::string& oldName, const std::string& newName);
@@ -0,0 +1,403 @@
+#include "TaskScheduler.h"
+
+#include "itextstream.h"
+#include "module/StaticModule.h"
+
+namespace threading
+{
+
+namespace
+{
+    // The scheduler and queue index of the worker running on this thread
+    thread_local const TaskScheduler* t_workerOwner = nullptr;
+    thread_local std::size_t t_workerIndex = 0;
+}
+
+Task::Task(TaskScheduler& owner, const ITaskScheduler::CancellableTaskFunction& function,
+    const ITaskScheduler::TaskFunction& continuation) :
+    _owner(owner),
+    _function(function),
+    _continuation(continuation),
+    _state(State::Pending),
+    _cancellationRequested(false)
+{}
+
+bool Task::isFinished() const
+{
+    return _state == State::Finished;
+}
+
+void Task::wait()
+{
+    // Run the task right here if it's still queued
+    if (!tryRun())
+    {
+        std::unique_lock<std::mutex> lock(_finishedLock);
+        _finishedCondition.wait(lock, [this]() { return _state == State::Finished; });
+    }
+
+    if (_exception)
+    {
+        std::rethrow_exception(_exception);
+    }
+}
+
+void Task::cancel()
+{
+    _cancellationRequested = true;
+}
+
+bool Task::isCancellationRequested() const
+{
+    return _cancellationRequested;
+}
+
+bool Task::tryRun()
+{
+    auto expected = State::Pending;
+
+    if (!_state.compare_exchange_strong(expected, State::Running))
+    {
+        return false;
+    }
+
+    if (!_cancellationRequested)
+    {
+        try
+        {
+            _function(*this);
+        }
+        catch (...)
+        {
+            _exception = std::current_exception();
+        }
+    }
+
+    // Release anything bound by the function as soon as possible
+    _function = ITaskScheduler::CancellableTaskFunction();
+
+    if (_continuation && !_exception && !_cancellationRequested)
+    {
+        _owner.postToMainThread(_continuation);
+    }
+
+    _continuation = ITaskScheduler::TaskFunction();
+
+    setFinished();
+    return true;
+}
+
+void Task::setFinished()
+{
+    {
+        std::lock_guard<std::mutex> lock(_finishedLock);
+        _state = State::Finished;
+    }
+
+    _finishedCondition.notify_all();
+}
+
+TaskScheduler::TaskScheduler() :
+    _numWorkers(std::max(std::thread::hardware_concurrency(), 2u) - 1),
+    _poolState(PoolState::NotStarted),
+    _numQueuedTasks(0)
+{
+    for (std::size_t i = 0; i <= _numWorkers; ++i)
+    {
+        _queues.emplace_back(std::make_unique<TaskQueue>());
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    stopWorkers();
+}
+
+std::size_t TaskScheduler::getNumWorkers() const
+{
+    return _numWorkers;
+}
+
+TaskPtr TaskScheduler::submit(const CancellableTaskFunction& function, TaskPriority priority)
+{
+    return enqueue(std::make_shared<Task>(*this, function, TaskFunction()), priority);
+}
+
+TaskPtr TaskScheduler::submitWithContinuation(const CancellableTaskFunction& function,
+    const TaskFunction& mainThreadContinuation, TaskPriority priority)
+{
+    return enqueue(std::make_shared<Task>(*this, function, mainThreadContinuation), priority);
+}
+
+void TaskScheduler::parallelFor(std::size_t count, const std::function<void(std::size_t)>& function,
+    TaskPriority priority)
+{
+    std::atomic<std::size_t> nextIndex(0);
+
+    auto processIndices = [&]()
+    {
+        try
+        {
+            for (auto i = nextIndex++; i < count; i = nextIndex++)
+            {
+                function(i);
+            }
+        }
+        catch (...)
+        {
+            // Let the other threads stop early
+            nextIndex = count;
+            throw;
+        }
+    };
+
+    auto numHelpers = std::min(_numWorkers, count > 0 ? count - 1 : 0);
+
+    std::vector<TaskPtr> helpers;
+    helpers.reserve(numHelpers);
+
+    for (std::size_t i = 0; i < numHelpers; ++i)
+    {
+        helpers.emplace_back(submit(processIndices, priority));
+    }
+
+    // The calling thread is processing its share too
+    std::exception_ptr exception;
+
+    try
+    {
+        processIndices();
+    }
+    catch (...)
+    {
+        exception = std::current_exception();
+    }
+
+    // Helpers that didn't get started yet are finished quickly by this thread
+    for (const auto& helper : helpers)
+    {
+        try
+        {
+            helper->wait();
+        }
+        catch (...)
+        {
+            if (!exception)
+            {
+                exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+void TaskScheduler::postToMainThread(const TaskFunction& function)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mainThreadLock);
+        _mainThreadTasks.push_back(function);
+    }
+
+    _sigMainThreadTasksPending.emit();
+}
+
+void TaskScheduler::processMainThreadTasks()
+{
+    std::vector<TaskFunction> tasks;
+
+    {
+        std::lock_guard<std::mutex> lock(_mainThreadLock);
+        tasks.swap(_mainThreadTasks);
+    }
+
+    for (const auto& task : tasks)
+    {
+        task();
+    }
+}
+
+sigc::signal<void>& TaskScheduler::signal_mainThreadTasksPending()
+{
+    return _sigMainThreadTasksPending;
+}
+
+TaskPtr TaskScheduler::enqueue(const TaskImplPtr& task, TaskPriority priority)
+{
+    if (!ensureWorkersStarted())
+    {
+        // The pool has been shut down, run the task synchronously
+        task->tryRun();
+        return task;
+    }
+
+    // Tasks spawned by a worker are going to that worker's queue
+    auto queueIndex = t_workerOwner == this ? t_workerIndex : _numWorkers;
+    auto& queue = *_queues[queueIndex];
+
+    {
+        std::lock_guard<std::mutex> lock(queue.lock);
+        queue.tasks[static_cast<std::size_t>(priority)].push_back(task);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_poolLock);
+        ++_numQueuedTasks;
+    }
+
+    _wakeupCondition.notify_one();
+
+    return task;
+}
+
+bool TaskScheduler::ensureWorkersStarted()
+{
+    std::lock_guard<std::mutex> lock(_poolLock);
+
+    if (_poolState == PoolState::NotStarted)
+    {
+        _poolState = PoolState::Running;
+
+        for (std::size_t i = 0; i < _numWorkers; ++i)
+        {
+            _workers.emplace_back(&TaskScheduler::runWorker, this, i);
+        }
+    }
+
+    return _poolState == PoolState::Running;
+}
+
+void TaskScheduler::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(_poolLock);
+
+        if (_poolState == PoolState::Stopped) return;
+
+        _poolState = PoolState::Stopped;
+    }
+
+    _wakeupCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+
+    _workers.clear();
+
+    // Tasks still queued are dropped, anyone waiting for one of them is running it
+    for (auto& queue : _queues)
+    {
+        std::lock_guard<std::mutex> lock(queue->lock);
+
+        for (auto& tasks : queue->tasks)
+        {
+            tasks.clear();
+        }
+    }
+
+    _numQueuedTasks = 0;
+}
+
+void TaskScheduler::runWorker(std::size_t workerIndex)
+{
+    t_workerOwner = this;
+    t_workerIndex = workerIndex;
+
+    while (true)
+    {
+        auto task = takeTask(workerIndex);
+
+        if (task)
+        {
+            // The task might have been run by a waiting thread in the meantime
+            task->tryRun();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_poolLock);
+        _wakeupCondition.wait(lock, [this]()
+        {
+            return _poolState == PoolState::Stopped || _numQueuedTasks > 0;
+        });
+
+        if (_poolState == PoolState::Stopped)
+        {
+            return;
+        }
+    }
+}
+
+TaskImplPtr TaskScheduler::takeTask(std::size_t workerIndex)
+{
+    for (std::size_t priority = 0; priority < NumPriorities; ++priority)
+    {
+        // The own queue is processed last in, first out, for better cache locality
+        {
+            auto& own = *_queues[workerIndex];
+            std::lock_guard<std::mutex> lock(own.lock);
+            auto& tasks = own.tasks[priority];
+
+            if (!tasks.empty())
+            {
+                auto task = std::move(tasks.back());
+                tasks.pop_back();
+                --_numQueuedTasks;
+                return task;
+            }
+        }
+
+        // The external queue comes next, then the other workers' queues
+        for (std::size_t offset = 0; offset < _queues.size(); ++offset)
+        {
+            auto index = (_numWorkers + _queues.size() - offset) % _queues.size();
+            if (index == workerIndex) continue;
+
+            auto& other = *_queues[index];
+            std::lock_guard<std::mutex> lock(other.lock);
+            auto& tasks = other.tasks[priority];
+
+            if (!tasks.empty())
+            {
+                auto task = std::move(tasks.front());
+                tasks.pop_front();
+                --_numQueuedTasks;
+                return task;
+            }
+        }
+    }
+
+    return TaskImplPtr();
+}
+
+const std::string& TaskScheduler::getName() const
+{
+    static std::string _name(MODULE_TASKSCHEDULER);
+    return _name;
+}
+
+const StringSet& TaskScheduler::getDependencies() const
+{
+    static StringSet _dependencies;
+    return _dependencies;
+}
+
+void TaskScheduler::initialiseModule(const IApplicationContext& ctx)
+{
+    ensureWorkersStarted();
+
+    rMessage() << getName() << ": running " << _numWorkers << " worker threads" << std::endl;
+}
+
+void TaskScheduler::shutdownModule()
+{
+    stopWorkers();
+}
+
+module::StaticModuleRegistration<TaskScheduler> taskSchedulerModule;
+
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "itaskscheduler.h"
+
+namespace threading
+{
+
+class TaskScheduler;
+
+class Task final :
+    public ITask
+{
+private:
+    enum class State
+    {
+        Pending,
+        Running,
+        Finished,
+    };
+
+    TaskScheduler& _owner;
+    ITaskScheduler::CancellableTaskFunction _function;
+    ITaskScheduler::TaskFunction _continuation;
+
+    std::atomic<State> _state;
+    std::atomic<bool> _cancellationRequested;
+    std::exception_ptr _exception;
+
+    std::mutex _finishedLock;
+    std::condition_variable _finishedCondition;
+
+public:
+    Task(TaskScheduler& owner, const ITaskScheduler::CancellableTaskFunction& function,
+        const ITaskScheduler::TaskFunction& continuation);
+
+    bool isFinished() const override;
+    void wait() override;
+    void cancel() override;
+    bool isCancellationRequested() const override;
+
+    // Runs the task on the calling thread if nobody else started it yet.
+    // Returns false if the task had already been claimed by another thread.
+    bool tryRun();
+
+private:
+    void setFinished();
+};
+using TaskImplPtr = std::shared_ptr<Task>;
+
+class TaskScheduler final :
+    public ITaskScheduler
+{
+private:
+    static constexpr std::size_t NumPriorities = 3;
+
+    std::size_t _numWorkers;
+
+    // Pending tasks, one deque per priority
+    struct TaskQueue
+    {
+        std::mutex lock;
+        std::array<std::deque<TaskImplPtr>, NumPriorities> tasks;
+    };
+
+    // One queue per worker, plus the last one for tasks submitted by other threads
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    enum class PoolState
+    {
+        NotStarted,
+        Running,
+        Stopped,
+    };
+
+    // Guards the pool state and the wake-up condition of the workers
+    std::mutex _poolLock;
+    std::condition_variable _wakeupCondition;
+    PoolState _poolState;
+    std::atomic<std::size_t> _numQueuedTasks;
+
+    std::mutex _mainThreadLock;
+    std::vector<TaskFunction> _mainThreadTasks;
+    sigc::signal<void> _sigMainThreadTasksPending;
+
+public:
+    TaskScheduler();
+    ~TaskScheduler() override;
+
+    using ITaskScheduler::submit;
+
+    std::size_t getNumWorkers() const override;
+    TaskPtr submit(const CancellableTaskFunction& function, TaskPriority priority) override;
+    TaskPtr submitWithContinuation(const CancellableTaskFunction& function,
+        const TaskFunction& mainThreadContinuation, TaskPriority priority) override;
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)>& function,
+        TaskPriority priority) override;
+
+    void postToMainThread(const TaskFunction& function) override;
+    void processMainThreadTasks() override;
+    sigc::signal<void>& signal_mainThreadTasksPending() override;
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    TaskPtr enqueue(const TaskImplPtr& task, TaskPriority priority);
+
+    // Starts the worker threads if this hasn't happened yet, returns false if the pool is stopped
+    bool ensureWorkersStarted();
+    void stopWorkers();
+
+    void runWorker(std::size_t workerIndex);
+
+    // Takes the next task, preferring the given worker's own queue, then
+    // the external queue, then stealing from the other workers
+    TaskImplPtr takeTask(std::size_t workerIndex);
+};
+
+}
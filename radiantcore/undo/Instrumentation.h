@@ -0,0 +1,127 @@
+#pragma once
+
+#include "iundo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+
+namespace undo
+{
+
+/**
+ * Accumulates the timings of the undoables exporting and importing
+ * their states, and of the undo and redo steps of an UndoSystem.
+ */
+class Instrumentation
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    struct Timing
+    {
+        std::size_t count = 0;
+        double milliseconds = 0;
+        double maxMilliseconds = 0;
+
+        void add(const Clock::time_point& start)
+        {
+            auto duration = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            ++count;
+            milliseconds += duration;
+            maxMilliseconds = std::max(maxMilliseconds, duration);
+        }
+    };
+
+    std::map<std::type_index, Timing> _exports;
+    std::map<std::type_index, Timing> _imports;
+
+    Timing _undos;
+    Timing _redos;
+
+public:
+    void recordExport(const std::type_index& type, const Clock::time_point& start)
+    {
+        _exports[type].add(start);
+    }
+
+    void recordImport(const std::type_index& type, const Clock::time_point& start)
+    {
+        _imports[type].add(start);
+    }
+
+    void recordUndo(const Clock::time_point& start)
+    {
+        _undos.add(start);
+    }
+
+    void recordRedo(const Clock::time_point& start)
+    {
+        _redos.add(start);
+    }
+
+    // Adds the recorded timings to the given statistics
+    void fillStatistics(UndoSystemStatistics& statistics) const
+    {
+        for (const auto& [type, timing] : _exports)
+        {
+            auto& info = statistics.undoableTypes[GetTypeName(type)];
+            info.numExports += timing.count;
+            info.exportMilliseconds += timing.milliseconds;
+        }
+
+        for (const auto& [type, timing] : _imports)
+        {
+            auto& info = statistics.undoableTypes[GetTypeName(type)];
+            info.numImports += timing.count;
+            info.importMilliseconds += timing.milliseconds;
+        }
+
+        statistics.numUndos = _undos.count;
+        statistics.undoMilliseconds = _undos.milliseconds;
+        statistics.maxUndoMilliseconds = _undos.maxMilliseconds;
+        statistics.numRedos = _redos.count;
+        statistics.redoMilliseconds = _redos.milliseconds;
+        statistics.maxRedoMilliseconds = _redos.maxMilliseconds;
+    }
+
+    // Returns the readable class name of the given type
+    static std::string GetTypeName(const std::type_index& type)
+    {
+#ifdef __GNUC__
+        int status = 0;
+        auto demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+
+        if (status == 0 && demangled != nullptr)
+        {
+            std::string name(demangled);
+            std::free(demangled);
+            return name;
+        }
+#endif
+        std::string name(type.name());
+
+        // MSVC is prepending the kind of type
+        for (const auto& prefix : { "class ", "struct " })
+        {
+            if (name.rfind(prefix, 0) == 0)
+            {
+                return name.substr(std::char_traits<char>::length(prefix));
+            }
+        }
+
+        return name;
+    }
+};
+
+}
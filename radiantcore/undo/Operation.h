@@ -1,7 +1,9 @@
 #pragma once
 
 #include "iundo.h"
+#include "Instrumentation.h"
 
+#include <atomic>
 #include <list>
 #include <memory>
 #include <string>
@@ -23,21 +25,43 @@ private:
 	{
 	private:
 		IUndoable& _undoable;
+		std::type_index _type;
 		IUndoMementoPtr _data;
 
 	public:
-        UndoableState(IUndoable& undoable) :
+        UndoableState(IUndoable& undoable, Instrumentation& instrumentation) :
             _undoable(undoable),
-            _data(_undoable.exportState())
-        {}
+            _type(typeid(undoable))
+        {
+            auto start = Instrumentation::Clock::now();
+            _data = _undoable.exportState();
+            instrumentation.recordExport(_type, start);
+        }
 
         // Noncopyable
         UndoableState(const UndoableState& other) = delete;
         UndoableState& operator=(const UndoableState& other) = delete;
 
-		void restore()
+		std::size_t getMemoryUsage() const
+		{
+			return sizeof(*this) + _data->getMemoryUsage();
+		}
+
+		void compressData()
+		{
+			_data->compressData();
+		}
+
+		const std::type_index& getType() const
 		{
+			return _type;
+		}
+
+		void restore(Instrumentation& instrumentation)
+		{
+			auto start = Instrumentation::Clock::now();
 			_undoable.importState(_data);
+			instrumentation.recordImport(_type, start);
 		}
 
         void notifyOperationRestored()
@@ -52,11 +76,16 @@ private:
 	// The name of the UndoOperaton
 	std::string _command;
 
+	// The approximate number of bytes used by the snapshot,
+	// updated by the worker thread compressing the snapshot
+	std::atomic<std::size_t> _memoryUsage;
+
 public:
     using Ptr = std::shared_ptr<Operation>;
 
 	Operation(const std::string& command) :
-		_command(command)
+		_command(command),
+		_memoryUsage(sizeof(*this))
 	{}
 
 	const std::string& getName() const
@@ -74,19 +103,56 @@ public:
         return _snapshot.empty();
     }
 
-	void save(IUndoable& undoable)
+    std::size_t getMemoryUsage() const
+    {
+        return _memoryUsage;
+    }
+
+	void save(IUndoable& undoable, Instrumentation& instrumentation)
 	{
 		// Record the state of the given undable and push it to the snapshot
 		// The order is relevant, we add to the front
-		_snapshot.emplace_front(undoable);
+		_snapshot.emplace_front(undoable, instrumentation);
+		_memoryUsage += _snapshot.front().getMemoryUsage();
+	}
+
+	// Compresses the saved states, to be called on a worker thread
+	// while the operation is in the undo or redo stack
+	void compressSnapshot()
+	{
+		std::size_t memoryUsage = sizeof(*this);
+
+		for (auto& state : _snapshot)
+		{
+			state.compressData();
+			memoryUsage += state.getMemoryUsage();
+		}
+
+		_memoryUsage = memoryUsage;
+	}
+
+	// Adds the number and size of the saved states to the given statistics
+	void collectStatistics(UndoSystemStatistics::Operation& operation,
+		std::map<std::string, UndoSystemStatistics::UndoableType>& undoableTypes) const
+	{
+		operation.name = _command;
+		operation.memoryUsage = _memoryUsage;
+
+		for (const auto& state : _snapshot)
+		{
+			auto& type = undoableTypes[Instrumentation::GetTypeName(state.getType())];
+			++type.numStates;
+			type.memoryUsage += state.getMemoryUsage();
+			++operation.numStates;
+		}
 	}
 
-	void restoreSnapshot()
+	void restoreSnapshot(Instrumentation& instrumentation)
 	{
         // Walk through the snapshot front-to-back, the most recently added one is at the front
 		for (auto& state : _snapshot)
 		{
-            state.restore();
+            state.restore(instrumentation);
 		}
 
         // After all the snapshots have been restored, notify the undoables to give them a chance to cleanup
@@ -1,12 +1,18 @@
 #pragma once
 
 #include "debugging/debugging.h"
+#include <chrono>
+#include <future>
 #include <list>
+#include <vector>
 #include "Operation.h"
 
 namespace undo
 {
 
+// The number of most recent operations in a stack which are kept uncompressed
+constexpr std::size_t NUM_UNCOMPRESSED_OPERATIONS = 32;
+
 /** 
  * greebo: The UndoSystem keeps track of Undoable and Redoable operations,
  * which are kept in a chain-like data structure.
@@ -28,7 +34,24 @@ private:
 	// The pending undo operation (will be committed on finish, if not empty)
     Operation::Ptr _pending;
 
+	// The number of operations at the front of the stack handed to the compressor
+	std::size_t _numCompressedOperations = 0;
+
+	// The worker compressing the operations deep down in the stack
+	std::future<void> _compressor;
+
+	// Receives the export timings of the saved states
+	Instrumentation& _instrumentation;
+
 public:
+	UndoStack(Instrumentation& instrumentation) :
+		_instrumentation(instrumentation)
+	{}
+
+	~UndoStack()
+	{
+		waitForCompression();
+	}
 
 	bool empty() const
 	{
@@ -50,19 +73,83 @@ public:
 		return _stack.front();
 	}
 
+	// The approximate number of bytes used by the committed operations
+	std::size_t getMemoryUsage() const
+	{
+		std::size_t memoryUsage = 0;
+
+		for (const auto& operation : _stack)
+		{
+			memoryUsage += operation->getMemoryUsage();
+		}
+
+		return memoryUsage;
+	}
+
+	// The operations must not be destroyed while they are being compressed,
+	// all methods removing operations wait for the compressor to finish
+
 	void pop_front()
 	{
+		waitForCompression();
+
 		_stack.pop_front();
+
+		if (_numCompressedOperations > 0)
+		{
+			--_numCompressedOperations;
+		}
 	}
 
 	void pop_back()
 	{
+		waitForCompression();
+
 		_stack.pop_back();
+		_numCompressedOperations = std::min(_numCompressedOperations, _stack.size());
 	}
 
 	void clear()
 	{
+		waitForCompression();
+
 		_stack.clear();
+		_numCompressedOperations = 0;
+	}
+
+	// Hands the operations exceeding the uncompressed ones to a worker thread, which
+	// compresses their saved states. Does nothing while the previous compression is running.
+	void compressColdOperations()
+	{
+		if (_compressor.valid() && _compressor.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			return;
+		}
+
+		waitForCompression();
+
+		if (_stack.size() <= _numCompressedOperations + NUM_UNCOMPRESSED_OPERATIONS)
+		{
+			return;
+		}
+
+		std::vector<Operation*> operations;
+		auto operation = std::next(_stack.begin(), _numCompressedOperations);
+
+		for (auto i = _stack.size() - _numCompressedOperations - NUM_UNCOMPRESSED_OPERATIONS; i > 0; --i, ++operation)
+		{
+			operations.push_back(operation->get());
+		}
+
+		_numCompressedOperations += operations.size();
+
+		_compressor = std::async(std::launch::async, [operations = std::move(operations)]()
+		{
+			for (auto operation : operations)
+			{
+				operation->compressSnapshot();
+			}
+		});
 	}
 
 	// Allocate a new Operation to work with
@@ -106,8 +193,28 @@ public:
     void save(IUndoable& undoable)
     {
         assert(_pending);
-        _pending->save(undoable);
+        _pending->save(undoable, _instrumentation);
+    }
+
+    // Appends the figures of each operation, from oldest to most recent
+    void collectStatistics(std::vector<UndoSystemStatistics::Operation>& operations,
+        std::map<std::string, UndoSystemStatistics::UndoableType>& undoableTypes) const
+    {
+        for (const auto& operation : _stack)
+        {
+            operations.emplace_back();
+            operation->collectStatistics(operations.back(), undoableTypes);
+        }
     }
+
+private:
+	void waitForCompression()
+	{
+		if (_compressor.valid())
+		{
+			_compressor.get();
+		}
+	}
 };
 
 } // namespace
@@ -11,8 +11,11 @@ namespace undo
 {
 
 UndoSystem::UndoSystem() :
+	_undoStack(_instrumentation),
+	_redoStack(_instrumentation),
 	_activeUndoStack(nullptr),
-	_undoLevels(RKEY_UNDO_QUEUE_SIZE)
+	_undoLevels(RKEY_UNDO_QUEUE_SIZE),
+	_memoryBudget(RKEY_UNDO_MEMORY_BUDGET)
 {}
 
 UndoSystem::~UndoSystem()
@@ -66,6 +69,9 @@ void UndoSystem::finish(const std::string& command)
 {
 	if (finishUndo(command))
     {
+        trimUndoStackToBudget();
+        _undoStack.compressColdOperations();
+
 		rMessage() << command << std::endl;
         _eventSignal.emit(EventType::OperationRecorded, command);
 	}
@@ -85,14 +91,19 @@ void UndoSystem::undo()
         return;
     }
 		
+	auto start = Instrumentation::Clock::now();
+
 	const auto& operation = _undoStack.back();
     auto operationName = operation->getName(); // copy this name, we need it after op destruction
 	rMessage() << "Undo: " << operationName << std::endl;
 
 	startRedo();
-	operation->restoreSnapshot();
+	operation->restoreSnapshot(_instrumentation);
 	finishRedo(operationName);
 	_undoStack.pop_back();
+	_redoStack.compressColdOperations();
+
+	_instrumentation.recordUndo(start);
     _eventSignal.emit(EventType::OperationUndone, operationName);
 }
 
@@ -110,14 +121,18 @@ void UndoSystem::redo()
         return;
     }
 		
+	auto start = Instrumentation::Clock::now();
+
 	const auto& operation = _redoStack.back();
     auto operationName = operation->getName(); // copy this name, we need it after op destruction
 	rMessage() << "Redo: " << operationName << std::endl;
 
 	startUndo();
-	operation->restoreSnapshot();
+	operation->restoreSnapshot(_instrumentation);
 	finishUndo(operationName);
 	_redoStack.pop_back();
+
+	_instrumentation.recordRedo(start);
     _eventSignal.emit(EventType::OperationRedone, operationName);
 }
 
@@ -132,6 +147,17 @@ void UndoSystem::clear()
 	// there are some "persistent" observers like EntityInspector and ShaderClipboard
 }
 
+UndoSystemStatistics UndoSystem::getStatistics() const
+{
+	UndoSystemStatistics statistics;
+
+	_undoStack.collectStatistics(statistics.undoOperations, statistics.undoableTypes);
+	_redoStack.collectStatistics(statistics.redoOperations, statistics.undoableTypes);
+	_instrumentation.fillStatistics(statistics);
+
+	return statistics;
+}
+
 sigc::signal<void(IUndoSystem::EventType, const std::string&)>& UndoSystem::signal_undoEvent()
 {
     return _eventSignal;
@@ -163,6 +189,18 @@ bool UndoSystem::finishRedo(const std::string& command)
 	return changed;
 }
 
+void UndoSystem::trimUndoStackToBudget()
+{
+    auto budget = _memoryBudget.get() * 1024 * 1024;
+
+    if (budget == 0) return;
+
+    while (_undoStack.size() > 1 && _undoStack.getMemoryUsage() > budget)
+    {
+        _undoStack.pop_front();
+    }
+}
+
 // Assigns the given stack to all of the Undoables listed in the map
 void UndoSystem::setActiveUndoStack(UndoStack* stack)
 {
@@ -9,6 +9,7 @@
 
 #include "Stack.h"
 #include "StackFiller.h"
+#include "Instrumentation.h"
 #include "registry/CachedKey.h"
 
 namespace undo
@@ -16,6 +17,9 @@ namespace undo
 
 constexpr const char* const RKEY_UNDO_QUEUE_SIZE = "user/ui/undo/queueSize";
 
+// The memory the undo stack may occupy in megabytes, 0 for no limit
+constexpr const char* const RKEY_UNDO_MEMORY_BUDGET = "user/ui/undo/memoryBudget";
+
 /**
 * greebo: The UndoSystem (interface: iundo.h) is maintaining two internal
 * stacks of Operations (one for Undo, one for Redo), each containing a list
@@ -38,6 +42,9 @@ class UndoSystem final :
 	public IUndoSystem
 {
 private:
+	// Timings of the undoables and the undo/redo steps, used by both stacks
+	Instrumentation _instrumentation;
+
 	// The undo and redo stacks
 	UndoStack _undoStack;
 	UndoStack _redoStack;
@@ -47,6 +54,7 @@ private:
 	std::map<IUndoable*, UndoStackFiller> _undoables;
 
     registry::CachedKey<std::size_t> _undoLevels;
+    registry::CachedKey<std::size_t> _memoryBudget;
 
     sigc::signal<void(EventType, const std::string&)> _eventSignal;
 
@@ -63,6 +71,8 @@ public:
 
 	bool operationStarted() const override;
 
+	UndoSystemStatistics getStatistics() const override;
+
 	void undo() override;
 	void redo() override;
 
@@ -79,6 +89,10 @@ private:
 
 	// Assigns the given stack to all of the Undoables listed in the map
 	void setActiveUndoStack(UndoStack* stack);
+
+	// Removes the oldest operations until the undo stack fits into the memory
+	// budget. The most recent operation is always kept.
+	void trimUndoStackToBudget();
 };
 
 }
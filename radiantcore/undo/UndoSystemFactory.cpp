@@ -1,8 +1,12 @@
 #include "iundo.h"
 
 #include "i18n.h"
+#include "icommandsystem.h"
+#include "imap.h"
 #include "ipreferencesystem.h"
+#include "itextstream.h"
 #include "UndoSystem.h"
+#include <fmt/format.h>
 #include "module/StaticModule.h"
 
 namespace undo
@@ -20,7 +24,7 @@ public:
 
     const StringSet& getDependencies() const override
     {
-        static StringSet _dependencies{ MODULE_PREFERENCESYSTEM };
+        static StringSet _dependencies{ MODULE_PREFERENCESYSTEM, MODULE_COMMANDSYSTEM };
         return _dependencies;
     }
 
@@ -28,6 +32,9 @@ public:
     {
         // add the preference settings
         constructPreferences();
+
+        GlobalCommandSystem().addCommand("ShowUndoStatistics",
+            std::bind(&UndoSystemFactory::showStatisticsCmd, this, std::placeholders::_1));
     }
 
     IUndoSystem::Ptr createUndoSystem() override
@@ -40,6 +47,60 @@ private:
     {
         IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Undo System"));
         page.appendSpinner(_("Undo Queue Size"), RKEY_UNDO_QUEUE_SIZE, 0, 1024, 1);
+        page.appendSpinner(_("Memory Budget in MB (0 = unlimited)"), RKEY_UNDO_MEMORY_BUDGET, 0, 16384, 0);
+    }
+
+    // Prints the statistics of the active map's undo system
+    void showStatisticsCmd(const cmd::ArgumentList& args)
+    {
+        if (!GlobalMapModule().getRoot())
+        {
+            rWarning() << "Undo Statistics: no map loaded" << std::endl;
+            return;
+        }
+
+        auto statistics = GlobalUndoSystem().getStatistics();
+
+        auto printOperations = [](const std::string& stackName, const std::vector<UndoSystemStatistics::Operation>& operations)
+        {
+            std::size_t memoryUsage = 0;
+            const UndoSystemStatistics::Operation* largest = nullptr;
+
+            for (const auto& operation : operations)
+            {
+                memoryUsage += operation.memoryUsage;
+
+                if (largest == nullptr || operation.memoryUsage > largest->memoryUsage)
+                {
+                    largest = &operation;
+                }
+            }
+
+            rMessage() << "Undo Statistics: " << operations.size() << " " << stackName << " operations using " <<
+                memoryUsage / 1024 << " KB";
+
+            if (largest != nullptr)
+            {
+                rMessage() << ", largest is " << largest->name << " with " << largest->numStates << " states using " <<
+                    largest->memoryUsage / 1024 << " KB";
+            }
+
+            rMessage() << std::endl;
+        };
+
+        printOperations("undo", statistics.undoOperations);
+        printOperations("redo", statistics.redoOperations);
+
+        for (const auto& [typeName, type] : statistics.undoableTypes)
+        {
+            rMessage() << fmt::format("Undo Statistics: {0}: {1} states using {2} KB, {3} exports in {4:.1f} ms, {5} imports in {6:.1f} ms",
+                typeName, type.numStates, type.memoryUsage / 1024, type.numExports, type.exportMilliseconds,
+                type.numImports, type.importMilliseconds) << std::endl;
+        }
+
+        rMessage() << fmt::format("Undo Statistics: {0} undos in {1:.1f} ms (max {2:.1f} ms), {3} redos in {4:.1f} ms (max {5:.1f} ms)",
+            statistics.numUndos, statistics.undoMilliseconds, statistics.maxUndoMilliseconds,
+            statistics.numRedos, statistics.redoMilliseconds, statistics.maxRedoMilliseconds) << std::endl;
     }
 };
 
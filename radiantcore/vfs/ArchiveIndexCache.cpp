@@ -0,0 +1,244 @@
+#include "ArchiveIndexCache.h"
+
+#include <fstream>
+#include <stdexcept>
+#include "itextstream.h"
+#include "os/file.h"
+#include "os/fs.h"
+#include "stream/utils.h"
+#include "stream/MemoryInputStream.h"
+#include "MappedFile.h"
+
+namespace vfs
+{
+
+namespace
+{
+    const char* const CACHE_FILE_MAGIC = "DRVFSIDX";
+    const uint32_t CACHE_FILE_VERSION = 1;
+
+    enum EntryFlags : uint8_t
+    {
+        Directory = 1 << 0,
+        Deflated = 1 << 1,
+    };
+
+    class CacheReadException :
+        public std::runtime_error
+    {
+    public:
+        CacheReadException() :
+            std::runtime_error("Unexpected end of file")
+        {}
+    };
+
+    template<typename ValueType>
+    ValueType readValue(stream::MemoryInputStream& stream)
+    {
+        if (stream.remaining() < sizeof(ValueType)) throw CacheReadException();
+
+        return stream::readLittleEndian<ValueType>(stream);
+    }
+
+    std::string readString(stream::MemoryInputStream& stream)
+    {
+        auto length = readValue<uint32_t>(stream);
+
+        if (stream.remaining() < length) throw CacheReadException();
+
+        std::string value(reinterpret_cast<const char*>(stream.get()), length);
+        stream.seek(static_cast<SeekableStream::offset_type>(length), SeekableStream::cur);
+
+        return value;
+    }
+
+    void writeString(std::ostream& stream, const std::string& value)
+    {
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(value.size()));
+        stream.write(value.data(), value.size());
+    }
+
+    // Returns false if the file properties could not be determined
+    bool getFileProperties(const std::string& path, uint64_t& size, int64_t& modificationTime)
+    {
+        try
+        {
+            size = static_cast<uint64_t>(fs::file_size(path));
+            modificationTime = static_cast<int64_t>(fs::last_write_time(path).time_since_epoch().count());
+            return true;
+        }
+        catch (fs::filesystem_error&)
+        {
+            return false;
+        }
+    }
+}
+
+ArchiveIndexCache::ArchiveIndexCache(const std::string& cacheFile) :
+    _cacheFile(cacheFile),
+    _changed(false)
+{
+    load();
+}
+
+std::shared_ptr<archive::ZipArchive> ArchiveIndexCache::openArchive(const std::string& path)
+{
+    uint64_t size = 0;
+    int64_t modificationTime = 0;
+
+    if (!getFileProperties(path, size, modificationTime))
+    {
+        return std::make_shared<archive::ZipArchive>(path);
+    }
+
+    std::shared_ptr<const archive::ZipArchive::Index> cachedIndex;
+
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        auto found = _archives.find(path);
+
+        if (found != _archives.end() && found->second.size == size &&
+            found->second.modificationTime == modificationTime)
+        {
+            cachedIndex = found->second.index;
+        }
+    }
+
+    // Open the archive without holding the lock, this might involve slow file access
+    if (cachedIndex)
+    {
+        return std::make_shared<archive::ZipArchive>(path, *cachedIndex);
+    }
+
+    auto archive = std::make_shared<archive::ZipArchive>(path);
+    auto index = archive->getIndex();
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    _archives[path] = CachedArchive{ size, modificationTime,
+        std::make_shared<const archive::ZipArchive::Index>(std::move(index)) };
+    _changed = true;
+
+    return archive;
+}
+
+void ArchiveIndexCache::save()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    for (auto i = _archives.begin(); i != _archives.end();)
+    {
+        if (!os::fileOrDirExists(i->first))
+        {
+            i = _archives.erase(i);
+            _changed = true;
+            continue;
+        }
+
+        ++i;
+    }
+
+    if (!_changed) return;
+
+    std::ofstream stream(_cacheFile, std::ios::binary | std::ios::trunc);
+
+    if (!stream)
+    {
+        rWarning() << "[vfs] Cannot write archive index cache " << _cacheFile << std::endl;
+        return;
+    }
+
+    stream.write(CACHE_FILE_MAGIC, 8);
+    stream::writeLittleEndian<uint32_t>(stream, CACHE_FILE_VERSION);
+    stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(_archives.size()));
+
+    for (const auto& [path, archive] : _archives)
+    {
+        writeString(stream, path);
+        stream::writeLittleEndian<uint64_t>(stream, archive.size);
+        stream::writeLittleEndian<int64_t>(stream, archive.modificationTime);
+        stream::writeLittleEndian<uint32_t>(stream, static_cast<uint32_t>(archive.index->size()));
+
+        for (const auto& entry : *archive.index)
+        {
+            writeString(stream, entry.path);
+            stream::writeLittleEndian<uint8_t>(stream,
+                (entry.isDirectory ? Directory : 0) | (entry.isDeflated ? Deflated : 0));
+            stream::writeLittleEndian<uint32_t>(stream, entry.position);
+            stream::writeLittleEndian<uint32_t>(stream, entry.compressedSize);
+            stream::writeLittleEndian<uint32_t>(stream, entry.uncompressedSize);
+        }
+    }
+
+    _changed = false;
+}
+
+void ArchiveIndexCache::load()
+{
+    if (!os::fileOrDirExists(_cacheFile)) return;
+
+    archive::MappedFile file(_cacheFile);
+
+    if (!file.isValid()) return;
+
+    stream::MemoryInputStream stream(file.data(), file.size());
+
+    try
+    {
+        if (stream.remaining() < 8 || std::string(reinterpret_cast<const char*>(stream.get()), 8) != CACHE_FILE_MAGIC)
+        {
+            throw std::runtime_error("Invalid file header");
+        }
+
+        stream.seek(8);
+
+        if (readValue<uint32_t>(stream) != CACHE_FILE_VERSION)
+        {
+            // Written by a different version, will be replaced on the next save
+            return;
+        }
+
+        auto numArchives = readValue<uint32_t>(stream);
+
+        for (uint32_t i = 0; i < numArchives; ++i)
+        {
+            auto path = readString(stream);
+
+            CachedArchive cachedArchive;
+            cachedArchive.size = readValue<uint64_t>(stream);
+            cachedArchive.modificationTime = readValue<int64_t>(stream);
+
+            auto numEntries = readValue<uint32_t>(stream);
+            archive::ZipArchive::Index index;
+
+            for (uint32_t e = 0; e < numEntries; ++e)
+            {
+                auto& entry = index.emplace_back();
+
+                entry.path = readString(stream);
+
+                auto flags = readValue<uint8_t>(stream);
+                entry.isDirectory = (flags & Directory) != 0;
+                entry.isDeflated = (flags & Deflated) != 0;
+
+                entry.position = readValue<uint32_t>(stream);
+                entry.compressedSize = readValue<uint32_t>(stream);
+                entry.uncompressedSize = readValue<uint32_t>(stream);
+            }
+
+            cachedArchive.index = std::make_shared<const archive::ZipArchive::Index>(std::move(index));
+
+            _archives.emplace(path, std::move(cachedArchive));
+        }
+
+        rMessage() << "[vfs] Loaded the file tables of " << _archives.size() << " archives from " << _cacheFile << std::endl;
+    }
+    catch (std::runtime_error& ex)
+    {
+        rWarning() << "[vfs] Discarding archive index cache " << _cacheFile << ": " << ex.what() << std::endl;
+        _archives.clear();
+    }
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "ZipArchive.h"
+
+namespace vfs
+{
+
+/**
+ * Persistent cache of the PK4 file tables, stored in a binary file in the
+ * user's cache folder. Archives are identified by their path, the size and
+ * the modification time of the file. Unchanged archives are then constructed
+ * from the cached file table, without reading their central directory.
+ *
+ * The cache file is machine-local and not meant to be shared, it will simply
+ * be discarded if it cannot be read back.
+ *
+ * openArchive() can be called from several threads at once.
+ */
+class ArchiveIndexCache
+{
+private:
+    struct CachedArchive
+    {
+        uint64_t size;
+        int64_t modificationTime;
+        // Shared to avoid copying the table while holding the lock
+        std::shared_ptr<const archive::ZipArchive::Index> index;
+    };
+
+    std::string _cacheFile;
+    std::map<std::string, CachedArchive> _archives;
+
+    // True if entries have been added or removed since the last load/save
+    bool _changed;
+
+    std::mutex _lock;
+
+public:
+    // Loads the cache from the given file, which doesn't need to exist yet
+    ArchiveIndexCache(const std::string& cacheFile);
+
+    // Opens the archive at the given path. The file table is taken from the cache
+    // if the file is unchanged, otherwise the archive is read and its table is cached.
+    std::shared_ptr<archive::ZipArchive> openArchive(const std::string& path);
+
+    // Writes the cache file if there have been any changes, archives
+    // which no longer exist are removed from the cache.
+    void save();
+
+private:
+    void load();
+};
+
+}
@@ -0,0 +1,198 @@
+#include "AssetWatcher.h"
+
+#include <algorithm>
+#include "i18n.h"
+#include "ideclmanager.h"
+#include "ifilesystem.h"
+#include "imodel.h"
+#include "imodelcache.h"
+#include "ipreferencesystem.h"
+#include "iregistry.h"
+#include "ishaders.h"
+#include "itextstream.h"
+#include "registry/registry.h"
+#include "os/file.h"
+#include "os/path.h"
+#include "string/case_conv.h"
+#include "string/predicate.h"
+#include "module/StaticModule.h"
+
+namespace vfs
+{
+
+namespace
+{
+    bool isImageFile(const std::string& extension)
+    {
+        static const std::set<std::string> _imageExtensions{ "tga", "png", "jpg", "jpeg", "dds", "bmp" };
+        return _imageExtensions.count(extension) > 0;
+    }
+
+    bool isModelFile(const std::string& extension)
+    {
+        // The format manager returns the null loader (without extension) for unknown formats
+        return !GlobalModelFormatManager().getImporter(extension)->getExtension().empty();
+    }
+}
+
+bool AssetWatcher::isWatching() const
+{
+    return _watcher != nullptr;
+}
+
+sigc::signal<void>& AssetWatcher::signal_changesDetected()
+{
+    return _sigChangesDetected;
+}
+
+void AssetWatcher::processChanges()
+{
+    if (!_watcher) return;
+
+    std::set<std::string> vfsPaths;
+
+    for (const auto& path : _watcher->getChangedFiles())
+    {
+        auto root = GlobalFileSystem().findRoot(path);
+
+        if (root.empty()) continue;
+
+        auto vfsPath = path.substr(root.length());
+
+        // Skip files that have been removed again in the meantime,
+        // or that are overridden by a search path with higher priority
+        if (GlobalFileSystem().findFile(vfsPath) != root) continue;
+
+        vfsPaths.insert(vfsPath);
+    }
+
+    reloadChangedFiles(vfsPaths);
+}
+
+void AssetWatcher::reloadChangedFiles(const std::set<std::string>& vfsPaths)
+{
+    // Re-parse the declarations first, the materials might refer to the changed images
+    bool declarationsChanged = std::any_of(vfsPaths.begin(), vfsPaths.end(), [](const std::string& vfsPath)
+    {
+        return GlobalDeclarationManager().isDeclarationFile(vfsPath);
+    });
+
+    if (declarationsChanged)
+    {
+        // The reload pass skips all files that are still unchanged
+        rMessage() << "AssetWatcher: Reloading changed declaration files" << std::endl;
+        GlobalDeclarationManager().reloadDeclarations();
+    }
+
+    for (const auto& vfsPath : vfsPaths)
+    {
+        auto extension = string::to_lower_copy(os::getExtension(vfsPath));
+
+        if (isImageFile(extension))
+        {
+            rMessage() << "AssetWatcher: Reloading image " << vfsPath << std::endl;
+            GlobalMaterialManager().reloadImage(vfsPath);
+        }
+        else if (isModelFile(extension))
+        {
+            rMessage() << "AssetWatcher: Reloading model " << vfsPath << std::endl;
+            GlobalModelCache().refreshModel(vfsPath);
+        }
+    }
+}
+
+const std::string& AssetWatcher::getName() const
+{
+    static std::string _name(MODULE_ASSETWATCHER);
+    return _name;
+}
+
+const StringSet& AssetWatcher::getDependencies() const
+{
+    static StringSet _dependencies
+    {
+        MODULE_VIRTUALFILESYSTEM,
+        MODULE_DECLMANAGER,
+        MODULE_SHADERSYSTEM,
+        MODULE_MODELCACHE,
+        MODULE_MODELFORMATMANAGER,
+        MODULE_XMLREGISTRY,
+        MODULE_PREFERENCESYSTEM,
+    };
+
+    return _dependencies;
+}
+
+void AssetWatcher::initialiseModule(const IApplicationContext& ctx)
+{
+    IPreferencePage& page = GlobalPreferenceSystem().getPage(_("Settings/Asset Files"));
+    page.appendCheckBox(_("Reload changed asset files automatically"), RKEY_WATCH_ASSET_FILES);
+
+    GlobalRegistry().signalForKey(RKEY_WATCH_ASSET_FILES).connect(
+        sigc::mem_fun(*this, &AssetWatcher::updateWatcher));
+
+    _vfsInitialisedConn = GlobalFileSystem().signal_Initialised().connect(
+        sigc::mem_fun(*this, &AssetWatcher::updateWatcher));
+
+    updateWatcher();
+}
+
+void AssetWatcher::shutdownModule()
+{
+    _vfsInitialisedConn.disconnect();
+    _watcher.reset();
+}
+
+void AssetWatcher::updateWatcher()
+{
+    _watcher.reset();
+
+    if (!registry::getValue<bool>(RKEY_WATCH_ASSET_FILES) || !GlobalFileSystem().isInitialised()) return;
+
+    if (!DirectoryWatcher::IsSupported())
+    {
+        rMessage() << "AssetWatcher: File change notifications are not supported on this platform" << std::endl;
+        return;
+    }
+
+    std::vector<std::string> candidates;
+
+    for (const auto& path : GlobalFileSystem().getVfsSearchPaths())
+    {
+        auto rootPath = os::standardPathWithSlash(path);
+
+        if (os::fileOrDirExists(rootPath))
+        {
+            candidates.push_back(rootPath);
+        }
+    }
+
+    // Search paths nested in other ones (like a mission folder) are covered by their parent
+    std::sort(candidates.begin(), candidates.end(), [](const std::string& a, const std::string& b)
+    {
+        return a.length() < b.length();
+    });
+
+    std::vector<std::string> rootPaths;
+
+    for (const auto& candidate : candidates)
+    {
+        auto isNested = std::any_of(rootPaths.begin(), rootPaths.end(), [&](const std::string& rootPath)
+        {
+            return string::starts_with(candidate, rootPath);
+        });
+
+        if (!isNested)
+        {
+            rootPaths.push_back(candidate);
+        }
+    }
+
+    if (rootPaths.empty()) return;
+
+    _watcher = std::make_unique<DirectoryWatcher>(rootPaths, [this]() { _sigChangesDetected.emit(); });
+}
+
+module::StaticModuleRegistration<AssetWatcher> assetWatcherModule;
+
+}
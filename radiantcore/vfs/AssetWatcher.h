@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <sigc++/connection.h>
+#include "iassetwatcher.h"
+#include "DirectoryWatcher.h"
+
+namespace vfs
+{
+
+// Whether changed asset files in the VFS search paths are reloaded automatically
+constexpr const char* const RKEY_WATCH_ASSET_FILES = "user/ui/assetWatcher/enabled";
+
+class AssetWatcher final :
+    public IAssetWatcher
+{
+private:
+    std::unique_ptr<DirectoryWatcher> _watcher;
+    sigc::signal<void> _sigChangesDetected;
+
+    sigc::connection _vfsInitialisedConn;
+
+public:
+    bool isWatching() const override;
+    sigc::signal<void>& signal_changesDetected() override;
+    void processChanges() override;
+    void reloadChangedFiles(const std::set<std::string>& vfsPaths) override;
+
+    // RegisterableModule implementation
+    const std::string& getName() const override;
+    const StringSet& getDependencies() const override;
+    void initialiseModule(const IApplicationContext& ctx) override;
+    void shutdownModule() override;
+
+private:
+    // (Re-)starts watching the search paths according to the registry setting
+    void updateWatcher();
+};
+
+}
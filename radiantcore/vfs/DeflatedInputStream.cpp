@@ -1,28 +1,171 @@
 #include "DeflatedInputStream.h"
 
+#include <algorithm>
+#include <cstring>
 #include <zlib.h>
 
 namespace archive
 {
 
+namespace
+{
+	// Blocks up to this size are inflated in one go, this covers most decl files
+	const DeflatedInputStream::size_type WHOLE_BUFFER_THRESHOLD = 64 * 1024;
+
+	// The number of unused states and buffers kept per thread
+	const std::size_t MAX_POOLED_OBJECTS = 8;
+
+	// Unused z_stream states and output buffers of a single thread. Setting up
+	// a z_stream is allocating several KB, which is significant for small files.
+	class InflatePool
+	{
+	private:
+		std::vector<z_stream*> _states;
+		std::vector<std::vector<unsigned char>> _buffers;
+
+	public:
+		~InflatePool()
+		{
+			for (auto state : _states)
+			{
+				inflateEnd(state);
+				delete state;
+			}
+		}
+
+		z_stream* acquireState()
+		{
+			if (!_states.empty())
+			{
+				auto state = _states.back();
+				_states.pop_back();
+
+				inflateReset(state);
+				return state;
+			}
+
+			auto state = new z_stream;
+
+			state->zalloc = 0;
+			state->zfree = 0;
+			state->opaque = 0;
+			state->next_in = nullptr;
+			state->avail_in = 0;
+
+			inflateInit2(state, -MAX_WBITS);
+
+			return state;
+		}
+
+		void releaseState(z_stream* state)
+		{
+			if (_states.size() < MAX_POOLED_OBJECTS)
+			{
+				_states.push_back(state);
+				return;
+			}
+
+			inflateEnd(state);
+			delete state;
+		}
+
+		std::vector<unsigned char> acquireBuffer()
+		{
+			if (_buffers.empty())
+			{
+				return std::vector<unsigned char>();
+			}
+
+			auto buffer = std::move(_buffers.back());
+			_buffers.pop_back();
+
+			return buffer;
+		}
+
+		void releaseBuffer(std::vector<unsigned char>&& buffer)
+		{
+			if (_buffers.size() < MAX_POOLED_OBJECTS && buffer.capacity() > 0)
+			{
+				buffer.clear();
+				_buffers.emplace_back(std::move(buffer));
+			}
+		}
+	};
+
+	InflatePool& getInflatePool()
+	{
+		thread_local InflatePool pool;
+		return pool;
+	}
+}
+
 DeflatedInputStream::DeflatedInputStream(InputStream& istream) :
-	_istream(istream),
-	_zipStream(new z_stream)
+	_istream(&istream),
+	_zipStream(getInflatePool().acquireState()),
+	_uncompressedSize(0),
+	_inflatedAll(false),
+	_inflatedPosition(0)
 {
-	_zipStream->zalloc = 0;
-	_zipStream->zfree = 0;
-	_zipStream->opaque = 0;
+	_zipStream->next_in = nullptr;
 	_zipStream->avail_in = 0;
+}
 
-	inflateInit2(_zipStream.get(), -MAX_WBITS);
+DeflatedInputStream::DeflatedInputStream(const byte_type* data, size_type length, size_type uncompressedSize) :
+	_istream(nullptr),
+	_zipStream(getInflatePool().acquireState()),
+	_uncompressedSize(uncompressedSize <= WHOLE_BUFFER_THRESHOLD ? uncompressedSize : 0),
+	_inflatedAll(false),
+	_inflatedPosition(0)
+{
+	// Let z_stream read the whole block right from the source, zlib doesn't modify the input
+	_zipStream->next_in = const_cast<byte_type*>(data);
+	_zipStream->avail_in = static_cast<uInt>(length);
 }
 
 DeflatedInputStream::~DeflatedInputStream()
 {
-	inflateEnd(_zipStream.get());
+	// The stream might be destroyed by a different thread, which is fine,
+	// the objects will just end up in the pool of that thread
+	auto& pool = getInflatePool();
+
+	pool.releaseState(_zipStream);
+	pool.releaseBuffer(std::move(_inflated));
 }
 
 DeflatedInputStream::size_type DeflatedInputStream::read(byte_type* buffer, size_type length)
+{
+	if (_uncompressedSize == 0)
+	{
+		return inflateInto(buffer, length);
+	}
+
+	if (!_inflatedAll)
+	{
+		_inflatedAll = true;
+
+		// The caller wants everything at once, no need for a temporary buffer
+		if (length >= _uncompressedSize)
+		{
+			return inflateInto(buffer, length);
+		}
+
+		_inflated = getInflatePool().acquireBuffer();
+		_inflated.resize(_uncompressedSize);
+		_inflated.resize(inflateInto(_inflated.data(), _uncompressedSize));
+	}
+
+	auto count = std::min(length, _inflated.size() - _inflatedPosition);
+
+	if (count > 0)
+	{
+		std::memcpy(buffer, _inflated.data() + _inflatedPosition, count);
+		_inflatedPosition += count;
+	}
+
+	return count;
+}
+
+DeflatedInputStream::size_type DeflatedInputStream::inflateInto(byte_type* buffer, size_type length)
 {
 	// Tell inflate() to load the data directly to the given buffer
 	_zipStream->next_out = buffer;
@@ -32,12 +175,18 @@ DeflatedInputStream::size_type DeflatedInputStream::read(byte_type* buffer, size
 	{
 		if (_zipStream->avail_in == 0)
 		{
+			// All the data in memory has been consumed
+			if (_istream == nullptr)
+			{
+				break;
+			}
+
 			// Load some data from the wrapped buffer and point z_stream to it
 			_zipStream->next_in = _buffer;
-			_zipStream->avail_in = static_cast<uInt>(_istream.read(_buffer, sizeof(_buffer)));
+			_zipStream->avail_in = static_cast<uInt>(_istream->read(_buffer, sizeof(_buffer)));
 		}
 
-		if (inflate(_zipStream.get(), Z_SYNC_FLUSH) != Z_OK)
+		if (inflate(_zipStream, Z_SYNC_FLUSH) != Z_OK)
 		{
 			break;
 		}
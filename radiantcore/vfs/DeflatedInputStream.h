@@ -1,7 +1,7 @@
 #pragma once
 
 #include "idatastream.h"
-#include <memory>
+#include <vector>
 
 // Forward decl.
 struct z_stream_s;
@@ -14,21 +14,43 @@ namespace archive
 ///
 /// - Uses z_stream to decompress the data stream on the fly.
 /// - Uses a buffer to reduce the number of times the wrapped stream must be read.
+/// - Alternatively inflates a block of compressed data in memory, without any buffering.
+///   Small blocks of known size are inflated in one go on the first read.
+///
+/// The z_stream states and the buffers are taken from a thread-local pool
+/// and are re-used by the streams opened later on.
 class DeflatedInputStream :
 	public InputStream
 {
 private:
-	InputStream& _istream;
-	std::unique_ptr<z_stream> _zipStream;
+	InputStream* _istream;
+	z_stream* _zipStream;
 	unsigned char _buffer[1024];
 
+	// The size of a small block inflated in one go, 0 if streaming
+	size_type _uncompressedSize;
+	bool _inflatedAll;
+
+	std::vector<byte_type> _inflated;
+	size_type _inflatedPosition;
+
 public:
 	DeflatedInputStream(InputStream& istream);
 
+	// Inflates the given block of memory, which must stay valid during the lifetime of this stream
+	// The uncompressed size is optional, it enables the whole-buffer path for small blocks
+	DeflatedInputStream(const byte_type* data, size_type length, size_type uncompressedSize = 0);
+
+	DeflatedInputStream(const DeflatedInputStream& other) = delete;
+	DeflatedInputStream& operator=(const DeflatedInputStream& other) = delete;
+
 	virtual ~DeflatedInputStream();
 
 	// InputStream implementation
 	size_type read(byte_type* buffer, size_type length) override;
+
+private:
+	size_type inflateInto(byte_type* buffer, size_type length);
 };
 
 }
@@ -0,0 +1,354 @@
+#include "DirectoryWatcher.h"
+
+#include <map>
+#include "itextstream.h"
+#include "os/fs.h"
+#include "os/path.h"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "string/encoding.h"
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/inotify.h>
+#endif
+#endif
+
+namespace vfs
+{
+
+namespace
+{
+    // Saving a file usually produces several events in a row,
+    // wait for this long without further events before notifying
+    constexpr int SETTLE_TIME_MSECS = 250;
+}
+
+DirectoryWatcher::DirectoryWatcher(const std::vector<std::string>& rootPaths, const std::function<void()>& onChanges) :
+    _rootPaths(rootPaths),
+    _onChanges(onChanges),
+    _stopRequested(false)
+{
+#ifdef WIN32
+    _stopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+#else
+    if (pipe(_stopPipe) == -1)
+    {
+        _stopPipe[0] = _stopPipe[1] = -1;
+        rWarning() << "[DirectoryWatcher] Failed to create the stop pipe" << std::endl;
+        return;
+    }
+#endif
+
+    if (IsSupported())
+    {
+        _worker = std::thread(&DirectoryWatcher::run, this);
+    }
+}
+
+DirectoryWatcher::~DirectoryWatcher()
+{
+    _stopRequested = true;
+
+#ifdef WIN32
+    SetEvent(_stopEvent);
+#else
+    if (_stopPipe[1] != -1)
+    {
+        char signal = 0;
+        [[maybe_unused]] auto written = write(_stopPipe[1], &signal, 1);
+    }
+#endif
+
+    if (_worker.joinable())
+    {
+        _worker.join();
+    }
+
+#ifdef WIN32
+    CloseHandle(_stopEvent);
+#else
+    if (_stopPipe[0] != -1)
+    {
+        close(_stopPipe[0]);
+        close(_stopPipe[1]);
+    }
+#endif
+}
+
+bool DirectoryWatcher::IsSupported()
+{
+#if defined(WIN32) || defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::set<std::string> DirectoryWatcher::getChangedFiles()
+{
+    std::set<std::string> changedFiles;
+
+    std::lock_guard<std::mutex> lock(_lock);
+    changedFiles.swap(_changedFiles);
+
+    return changedFiles;
+}
+
+void DirectoryWatcher::addChangedFile(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _changedFiles.insert(os::standardPath(path));
+}
+
+#ifdef WIN32
+
+void DirectoryWatcher::run()
+{
+    struct WatchedDirectory
+    {
+        std::string root;
+        HANDLE handle;
+        OVERLAPPED overlapped;
+        std::vector<DWORD> buffer;
+    };
+
+    std::vector<WatchedDirectory> directories;
+    directories.reserve(_rootPaths.size());
+
+    auto requestChanges = [](WatchedDirectory& directory)
+    {
+        return ReadDirectoryChangesW(directory.handle, directory.buffer.data(),
+            static_cast<DWORD>(directory.buffer.size() * sizeof(DWORD)), TRUE,
+            FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+            nullptr, &directory.overlapped, nullptr) != FALSE;
+    };
+
+    for (const auto& root : _rootPaths)
+    {
+        // The stop event occupies one of the wait handles
+        if (directories.size() + 1 >= MAXIMUM_WAIT_OBJECTS)
+        {
+            rWarning() << "[DirectoryWatcher] Too many directories, not watching " << root << std::endl;
+            continue;
+        }
+
+        auto handle = CreateFileW(string::utf8_to_unicode(root).c_str(), FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            rWarning() << "[DirectoryWatcher] Cannot watch " << root << std::endl;
+            continue;
+        }
+
+        auto& directory = directories.emplace_back(WatchedDirectory{ os::standardPathWithSlash(root), handle });
+        directory.overlapped.hEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        directory.buffer.resize(16384);
+
+        if (!requestChanges(directory))
+        {
+            rWarning() << "[DirectoryWatcher] Cannot watch " << root << std::endl;
+        }
+    }
+
+    std::vector<HANDLE> events{ _stopEvent };
+
+    for (const auto& directory : directories)
+    {
+        events.push_back(directory.overlapped.hEvent);
+    }
+
+    bool changesPending = false;
+
+    while (!_stopRequested)
+    {
+        auto result = WaitForMultipleObjects(static_cast<DWORD>(events.size()), events.data(), FALSE,
+            changesPending ? SETTLE_TIME_MSECS : INFINITE);
+
+        if (result == WAIT_TIMEOUT)
+        {
+            changesPending = false;
+            _onChanges();
+            continue;
+        }
+
+        if (result <= WAIT_OBJECT_0 || result >= WAIT_OBJECT_0 + events.size())
+        {
+            break; // stop event or failure
+        }
+
+        auto& directory = directories[result - WAIT_OBJECT_0 - 1];
+        DWORD bytesReturned = 0;
+
+        // Zero bytes means that the buffer overflowed, these changes are lost
+        if (GetOverlappedResult(directory.handle, &directory.overlapped, &bytesReturned, FALSE) && bytesReturned > 0)
+        {
+            auto data = reinterpret_cast<const unsigned char*>(directory.buffer.data());
+
+            for (;;)
+            {
+                auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(data);
+
+                if (info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_ADDED ||
+                    info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    std::wstring filename(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                    addChangedFile(directory.root + string::unicode_to_utf8(filename));
+                    changesPending = true;
+                }
+
+                if (info->NextEntryOffset == 0) break;
+
+                data += info->NextEntryOffset;
+            }
+        }
+
+        requestChanges(directory);
+    }
+
+    for (auto& directory : directories)
+    {
+        CancelIo(directory.handle);
+        CloseHandle(directory.handle);
+        CloseHandle(directory.overlapped.hEvent);
+    }
+}
+
+#elif defined(__linux__)
+
+void DirectoryWatcher::run()
+{
+    auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (fd == -1)
+    {
+        rWarning() << "[DirectoryWatcher] Failed to initialise inotify" << std::endl;
+        return;
+    }
+
+    // inotify watches a single directory, every subdirectory needs its own watch
+    std::map<int, std::string> directoriesByWatch;
+    bool watchLimitReached = false;
+
+    auto addWatch = [&](const std::string& directory)
+    {
+        auto watch = inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+
+        if (watch == -1)
+        {
+            if (errno == ENOSPC && !watchLimitReached)
+            {
+                watchLimitReached = true;
+                rWarning() << "[DirectoryWatcher] The inotify watch limit has been reached, " <<
+                    "changes below " << directory << " will not be detected" << std::endl;
+            }
+
+            return;
+        }
+
+        directoriesByWatch[watch] = os::standardPathWithSlash(directory);
+    };
+
+    auto addWatchRecursively = [&](const std::string& root)
+    {
+        addWatch(root);
+
+        std::error_code ec;
+
+        for (fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec), end;
+             !ec && it != end && !watchLimitReached; it.increment(ec))
+        {
+            if (it->is_directory(ec))
+            {
+                addWatch(it->path().string());
+            }
+        }
+    };
+
+    for (const auto& root : _rootPaths)
+    {
+        addWatchRecursively(root);
+    }
+
+    alignas(inotify_event) char buffer[16384];
+    bool changesPending = false;
+
+    while (!_stopRequested)
+    {
+        pollfd descriptors[2] = { { fd, POLLIN, 0 }, { _stopPipe[0], POLLIN, 0 } };
+
+        auto result = poll(descriptors, 2, changesPending ? SETTLE_TIME_MSECS : -1);
+
+        if (result == -1)
+        {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        if (descriptors[1].revents != 0)
+        {
+            break; // stop requested
+        }
+
+        if (result == 0)
+        {
+            changesPending = false;
+            _onChanges();
+            continue;
+        }
+
+        ssize_t length;
+
+        while ((length = read(fd, buffer, sizeof(buffer))) > 0)
+        {
+            for (auto position = buffer; position < buffer + length;)
+            {
+                auto event = reinterpret_cast<const inotify_event*>(position);
+                position += sizeof(inotify_event) + event->len;
+
+                auto directory = directoriesByWatch.find(event->wd);
+
+                if (directory == directoriesByWatch.end()) continue;
+
+                // The watch is removed along with its directory
+                if (event->mask & IN_IGNORED)
+                {
+                    directoriesByWatch.erase(directory);
+                    continue;
+                }
+
+                if (event->len == 0) continue;
+
+                auto path = directory->second + event->name;
+
+                if (event->mask & IN_ISDIR)
+                {
+                    addWatchRecursively(path);
+                }
+                else if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+                {
+                    addChangedFile(path);
+                    changesPending = true;
+                }
+            }
+        }
+    }
+
+    close(fd);
+}
+
+#else
+
+void DirectoryWatcher::run()
+{}
+
+#endif
+
+}
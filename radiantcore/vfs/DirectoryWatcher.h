@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vfs
+{
+
+/**
+ * Watches a set of directory trees for files being written, using the file
+ * change notifications of the operating system (inotify on Linux and
+ * ReadDirectoryChangesW on Windows). On other platforms no changes are reported.
+ *
+ * The notifications are received by a worker thread, which invokes the given
+ * callback once a burst of changes has settled. The changed files can then be
+ * picked up through getChangedFiles() from any thread.
+ */
+class DirectoryWatcher final
+{
+private:
+    std::vector<std::string> _rootPaths;
+    std::function<void()> _onChanges;
+
+    std::mutex _lock;
+    std::set<std::string> _changedFiles;
+
+    std::atomic<bool> _stopRequested;
+    std::thread _worker;
+
+#ifdef WIN32
+    void* _stopEvent;
+#else
+    int _stopPipe[2];
+#endif
+
+public:
+    // Starts watching the given absolute directory paths, including their subdirectories.
+    // The callback is invoked by the worker thread.
+    DirectoryWatcher(const std::vector<std::string>& rootPaths, const std::function<void()>& onChanges);
+
+    // Blocks until the worker thread has stopped
+    ~DirectoryWatcher();
+
+    DirectoryWatcher(const DirectoryWatcher& other) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher& other) = delete;
+
+    // True if this platform provides the file change notifications
+    static bool IsSupported();
+
+    // Returns the absolute paths (using forward slashes) of the files changed
+    // since the last call
+    std::set<std::string> getChangedFiles();
+
+private:
+    void run();
+    void addChangedFile(const std::string& path);
+};
+
+}
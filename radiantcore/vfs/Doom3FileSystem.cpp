@@ -16,6 +16,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <locale>
+#include <atomic>
+#include <future>
+#include <thread>
 
 #include "iradiant.h"
 #include "idatastream.h"
@@ -34,6 +37,7 @@
 
 #include "string/split.h"
 #include "debugging/ScopedDebugTimer.h"
+#include "time/TraceRecorder.h"
 
 #include "DirectoryArchive.h"
 #include "DirectoryArchiveFile.h"
@@ -48,6 +52,8 @@ namespace vfs
 
 void Doom3FileSystem::initDirectory(const std::string& inputPath)
 {
+    util::ScopedTraceEvent trace("vfs", "Search directory " + inputPath);
+
     // greebo: Normalise path: Replace backslashes and ensure trailing slash
     _directories.push_back(os::standardPathWithSlash(inputPath));
 
@@ -119,6 +125,8 @@ void Doom3FileSystem::initialise(const SearchPaths& vfsSearchPaths, const std::s
         shutdown();
     }
 
+    util::ScopedTraceEvent trace("vfs", "Initialise filesystem");
+
     _vfsSearchPaths = vfsSearchPaths;
     _allowedExtensions = allowedExtensions;
 
@@ -139,6 +147,21 @@ void Doom3FileSystem::initialise(const SearchPaths& vfsSearchPaths, const std::s
         initDirectory(path);
     }
 
+    {
+        util::ScopedTraceEvent pakTrace("vfs", "Open PK4 files");
+        openPakFiles();
+    }
+
+    {
+        util::ScopedTraceEvent indexTrace("vfs", "Build file index");
+        buildFileIndex();
+    }
+
+    if (_indexCache)
+    {
+        _indexCache->save();
+    }
+
     signal_Initialised().emit();
 }
 
@@ -149,6 +172,9 @@ bool Doom3FileSystem::isInitialised() const
 
 void Doom3FileSystem::shutdown()
 {
+    _pakFileIndex.clear();
+    _directoryPositions.clear();
+    _searchOrder.clear();
     _archives.clear();
     _directories.clear();
     _vfsSearchPaths.clear();
@@ -168,26 +194,37 @@ int Doom3FileSystem::getFileCount(const std::string& filename)
     int count = 0;
     std::string fixedFilename(os::standardPath(filename));
 
-    for (const ArchiveDescriptor& descriptor : _archives)
+    foreachCandidateArchive(fixedFilename, [&](const ArchiveDescriptor& descriptor)
     {
         if (descriptor.archive->containsFile(fixedFilename))
         {
             ++count;
         }
-    }
+
+        return true;
+    });
 
     return count;
 }
 
 FileInfo Doom3FileSystem::getFileInfo(const std::string& vfsRelativePath)
 {
-    for (const auto& descriptor : _archives)
+    const ArchiveDescriptor* found = nullptr;
+
+    foreachCandidateArchive(vfsRelativePath, [&](const ArchiveDescriptor& descriptor)
     {
-        if (!descriptor.archive->containsFile(vfsRelativePath))
+        if (descriptor.archive->containsFile(vfsRelativePath))
         {
-            continue;
+            found = &descriptor;
+            return false;
         }
 
+        return true;
+    });
+
+    if (found != nullptr)
+    {
+
         // Determine the visibility of this file
         auto topLevelDir = os::getToplevelDirectory(vfsRelativePath);
 
@@ -201,7 +238,7 @@ FileInfo Doom3FileSystem::getFileInfo(const std::string& vfsRelativePath)
             visibility = assetsList->getVisibility(relativePath);
         }
 
-        return FileInfo("", vfsRelativePath, visibility, *descriptor.archive);
+        return FileInfo("", vfsRelativePath, visibility, *found->archive);
     }
 
     return FileInfo();
@@ -215,18 +252,15 @@ ArchiveFilePtr Doom3FileSystem::openFile(const std::string& filename)
         return ArchiveFilePtr();
     }
 
-    for (const auto& descriptor : _archives)
-    {
-        auto file = descriptor.archive->openFile(filename);
+    ArchiveFilePtr file;
 
-        if (file)
-        {
-            return file;
-        }
-    }
+    foreachCandidateArchive(filename, [&](const ArchiveDescriptor& descriptor)
+    {
+        file = descriptor.archive->openFile(filename);
+        return !file;
+    });
 
-    // not found
-    return ArchiveFilePtr();
+    return file;
 }
 
 ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filename)
@@ -243,17 +277,15 @@ ArchiveFilePtr Doom3FileSystem::openFileInAbsolutePath(const std::string& filena
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFile(const std::string& filename)
 {
-    for (const auto& descriptor : _archives)
-    {
-        auto file = descriptor.archive->openTextFile(filename);
+    ArchiveTextFilePtr file;
 
-        if (file)
-        {
-            return file;
-        }
-    }
+    foreachCandidateArchive(filename, [&](const ArchiveDescriptor& descriptor)
+    {
+        file = descriptor.archive->openTextFile(filename);
+        return !file;
+    });
 
-    return ArchiveTextFilePtr();
+    return file;
 }
 
 ArchiveTextFilePtr Doom3FileSystem::openTextFileInAbsolutePath(const std::string& filename)
@@ -373,8 +405,8 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
         // Matched extension for archive (e.g. "pk3", "pk4")
         ArchiveDescriptor entry;
 
+        // The archive itself is opened later on, see openPakFiles()
         entry.name = filename;
-        entry.archive = std::make_shared<archive::ZipArchive>(filename);
         entry.is_pakfile = true;
         _archives.push_back(entry);
 
@@ -395,6 +427,124 @@ void Doom3FileSystem::initPakFile(const std::string& filename)
     }
 }
 
+void Doom3FileSystem::openPakFiles()
+{
+    // The descriptors are already in search order, the threads only fill in the archives
+    std::vector<ArchiveDescriptor*> pakFiles;
+
+    for (auto& descriptor : _archives)
+    {
+        if (descriptor.is_pakfile && !descriptor.archive)
+        {
+            pakFiles.push_back(&descriptor);
+        }
+    }
+
+    auto numThreads = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), pakFiles.size());
+
+    // Archives on network drives are mostly waiting for I/O, so every thread
+    // just picks the next unopened archive until all of them are done
+    std::atomic<std::size_t> nextPakFile(0);
+    std::vector<std::future<void>> workers;
+
+    for (std::size_t t = 0; t < numThreads; ++t)
+    {
+        workers.emplace_back(std::async(std::launch::async, [&]()
+        {
+            for (auto i = nextPakFile++; i < pakFiles.size(); i = nextPakFile++)
+            {
+                const auto& filename = pakFiles[i]->name;
+
+                pakFiles[i]->archive = _indexCache ?
+                    _indexCache->openArchive(filename) : std::make_shared<archive::ZipArchive>(filename);
+            }
+        }));
+    }
+
+    // Wait for all workers, this is re-throwing any exceptions
+    for (auto& worker : workers)
+    {
+        worker.get();
+    }
+}
+
+void Doom3FileSystem::buildFileIndex()
+{
+    class FileCollector :
+        public IArchive::Visitor
+    {
+    public:
+        std::vector<std::string> files;
+
+        void visitFile(const std::string& name, IArchiveFileInfoProvider& infoProvider) override
+        {
+            files.push_back(name);
+        }
+
+        bool visitDirectory(const std::string& name, std::size_t depth) override
+        {
+            return false; // descend
+        }
+    };
+
+    for (const auto& descriptor : _archives)
+    {
+        auto position = _searchOrder.size();
+        _searchOrder.push_back(&descriptor);
+
+        if (!descriptor.is_pakfile)
+        {
+            _directoryPositions.push_back(position);
+            continue;
+        }
+
+        FileCollector collector;
+        descriptor.archive->traverse(collector, "");
+
+        for (const auto& file : collector.files)
+        {
+            auto& positions = _pakFileIndex[string::to_lower_copy(file)];
+
+            // Archives are visited in search order, so the positions stay sorted
+            if (positions.empty() || positions.back() != position)
+            {
+                positions.push_back(position);
+            }
+        }
+    }
+}
+
+void Doom3FileSystem::foreachCandidateArchive(const std::string& filename, const std::function<bool(const ArchiveDescriptor&)>& functor)
+{
+    static const std::vector<std::size_t> NoPakFiles;
+
+    auto found = _pakFileIndex.find(string::to_lower_copy(filename));
+    const auto& pakPositions = found != _pakFileIndex.end() ? found->second : NoPakFiles;
+
+    // Merge the two sorted position lists to visit the archives in search order
+    auto pak = pakPositions.begin();
+    auto directory = _directoryPositions.begin();
+
+    while (pak != pakPositions.end() || directory != _directoryPositions.end())
+    {
+        std::size_t position;
+
+        if (directory == _directoryPositions.end() || (pak != pakPositions.end() && *pak < *directory))
+        {
+            position = *pak++;
+        }
+        else
+        {
+            position = *directory++;
+        }
+
+        if (!functor(*_searchOrder[position]))
+        {
+            return;
+        }
+    }
+}
+
 sigc::signal<void>& Doom3FileSystem::signal_Initialised()
 {
     return _sigInitialised;
@@ -418,19 +568,48 @@ const std::string& Doom3FileSystem::getName() const
     return _name;
 }
 
+const std::string& Doom3FileSystem::getMemoryReporterName() const
+{
+    static std::string _name("VFS");
+    return _name;
+}
+
+void Doom3FileSystem::reportMemoryUsage(memory::IMemoryReport& report)
+{
+    std::size_t indexSize = _pakFileIndex.bucket_count() * sizeof(void*);
+
+    for (const auto& [path, positions] : _pakFileIndex)
+    {
+        indexSize += sizeof(std::string) + path.capacity() + sizeof(positions) + positions.capacity() * sizeof(std::size_t);
+    }
+
+    report.addEntry("Archives", 0, _archives.size());
+    report.addEntry("PK4 file index", indexSize, _pakFileIndex.size());
+}
+
 const StringSet& Doom3FileSystem::getDependencies() const
 {
-    static StringSet _dependencies;
+    static StringSet _dependencies
+    {
+        MODULE_MEMORYACCOUNTING,
+    };
+
     return _dependencies;
 }
 
 void Doom3FileSystem::initialiseModule(const IApplicationContext& ctx)
 {
+    _indexCache = std::make_unique<ArchiveIndexCache>(ctx.getCacheDataPath() + "vfs_index.cache");
+
+    GlobalMemoryAccounting().registerReporter(*this);
 }
 
 void Doom3FileSystem::shutdownModule()
 {
+    GlobalMemoryAccounting().unregisterReporter(*this);
+
     shutdown();
+    _indexCache.reset();
 }
 
 // Static module instance
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
+#include <functional>
 #include "iarchive.h"
 #include "ifilesystem.h"
+#include "imemoryaccounting.h"
+#include "ArchiveIndexCache.h"
 
 namespace vfs
 {
@@ -10,7 +14,8 @@ namespace vfs
 class AssetsList;
 
 class Doom3FileSystem :
-	public VirtualFileSystem
+	public VirtualFileSystem,
+	public memory::IMemoryReporter
 {
 private:
 	// Our ordered list of paths to search
@@ -29,6 +34,20 @@ private:
 
     std::list<ArchiveDescriptor> _archives;
 
+    // All archives in search order, the positions are referred to by the lookup tables below
+    std::vector<const ArchiveDescriptor*> _searchOrder;
+
+    // Positions of the directory archives, their contents are changing on disk
+    std::vector<std::size_t> _directoryPositions;
+
+    // Maps the lowercase path of every file in a PK4 to the positions of the
+    // PK4s containing it, sorted in search order. PK4s don't change after
+    // they have been opened, so they don't have to be asked one by one.
+    std::unordered_map<std::string, std::vector<std::size_t>> _pakFileIndex;
+
+    // File tables of the PK4s seen in previous sessions, available after module initialisation
+    std::unique_ptr<ArchiveIndexCache> _indexCache;
+
     sigc::signal<void> _sigInitialised;
 
 public:
@@ -69,6 +88,10 @@ public:
 	const SearchPaths& getVfsSearchPaths() override;
     FileInfo getFileInfo(const std::string& vfsRelativePath) override;
 
+	// IMemoryReporter implementation
+	const std::string& getMemoryReporterName() const override;
+	void reportMemoryUsage(memory::IMemoryReport& report) override;
+
 	// RegisterableModule implementation
 	const std::string& getName() const override;
 	const StringSet& getDependencies() const override;
@@ -79,6 +102,17 @@ private:
 	void initDirectory(const std::string& path);
 	void initPakFile(const std::string& filename);
 
+    // Opens all archives found by initPakFile() concurrently
+    void openPakFiles();
+
+    // Fills the lookup tables, after all archives have been opened
+    void buildFileIndex();
+
+    // Calls the functor for each archive which might contain the given file, in search order,
+    // until the functor returns false. These are all directory archives, and the PK4s which
+    // are known to contain the file.
+    void foreachCandidateArchive(const std::string& filename, const std::function<bool(const ArchiveDescriptor&)>& functor);
+
     std::shared_ptr<AssetsList> findAssetsList(const std::string& topLevelPath);
 };
 
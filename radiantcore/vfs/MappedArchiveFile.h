@@ -0,0 +1,96 @@
+#pragma once
+
+#include "iarchive.h"
+#include "stream/MemoryInputStream.h"
+#include "DeflatedInputStream.h"
+#include "MappedFile.h"
+
+namespace archive
+{
+
+/// \brief An ArchiveFile stored uncompressed in a memory-mapped archive.
+/// Reads are served right from the mapped bytes, no file handle is involved.
+class MappedStoredArchiveFile :
+	public ArchiveFile
+{
+private:
+	std::string _name;
+	MappedFilePtr _mappedFile; // keeps the mapping alive
+	stream::MemoryInputStream _stream;
+	std::size_t _position;
+	std::size_t _size;
+
+public:
+	MappedStoredArchiveFile(const std::string& name,
+							const MappedFilePtr& mappedFile,
+							std::size_t position,
+							std::size_t size) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_stream(mappedFile->data() + position, size),
+		_position(position),
+		_size(size)
+	{}
+
+	std::size_t size() const override
+	{
+		return _size;
+	}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	InputStream& getInputStream() override
+	{
+		return _stream;
+	}
+
+	std::shared_ptr<const uint8_t> getMappedData() override
+	{
+		// Share the ownership of the mapping, pointing to this file's bytes
+		return std::shared_ptr<const uint8_t>(_mappedFile, _mappedFile->data() + _position);
+	}
+};
+
+/// \brief An ArchiveFile stored in DEFLATE format in a memory-mapped archive.
+/// The data is inflated right from the mapped bytes.
+class MappedDeflatedArchiveFile :
+	public ArchiveFile
+{
+private:
+	std::string _name;
+	MappedFilePtr _mappedFile; // keeps the mapping alive
+	DeflatedInputStream _zipstream;
+	std::size_t _size;
+
+public:
+	MappedDeflatedArchiveFile(const std::string& name,
+							  const MappedFilePtr& mappedFile,
+							  std::size_t position,
+							  std::size_t streamSize,
+							  std::size_t fileSize) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_zipstream(mappedFile->data() + position, streamSize, fileSize),
+		_size(fileSize)
+	{}
+
+	std::size_t size() const override
+	{
+		return _size;
+	}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	InputStream& getInputStream() override
+	{
+		return _zipstream;
+	}
+};
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "iarchive.h"
+#include "gamelib.h"
+#include "stream/BinaryToTextInputStream.h"
+#include "stream/MemoryInputStream.h"
+#include "DeflatedInputStream.h"
+#include "MappedFile.h"
+
+namespace archive
+{
+
+/// \brief An ArchiveTextFile stored uncompressed in a memory-mapped archive.
+class MappedStoredArchiveTextFile :
+	public ArchiveTextFile
+{
+private:
+	std::string _name;
+	MappedFilePtr _mappedFile; // keeps the mapping alive
+	stream::MemoryInputStream _stream;
+	stream::BinaryToTextInputStream<stream::MemoryInputStream> _textStream; // converts data from _stream
+
+	// Mod root
+	std::string _modRoot;
+
+public:
+	MappedStoredArchiveTextFile(const std::string& name,
+								const MappedFilePtr& mappedFile,
+								const std::string& modRoot,
+								std::size_t position,
+								std::size_t size) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_stream(mappedFile->data() + position, size),
+		_textStream(_stream),
+		_modRoot(modRoot)
+	{}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	TextInputStream& getInputStream() override
+	{
+		return _textStream;
+	}
+
+	std::string getModName() const override
+	{
+		return game::current::getModPath(_modRoot);
+	}
+};
+
+/// \brief An ArchiveTextFile stored in DEFLATE format in a memory-mapped archive.
+class MappedDeflatedArchiveTextFile :
+	public ArchiveTextFile
+{
+private:
+	std::string _name;
+	MappedFilePtr _mappedFile; // keeps the mapping alive
+	DeflatedInputStream _zipstream;	// inflates the mapped data
+	stream::BinaryToTextInputStream<DeflatedInputStream> _textStream; // converts data from _zipstream
+
+	// Mod root
+	std::string _modRoot;
+
+public:
+	MappedDeflatedArchiveTextFile(const std::string& name,
+								  const MappedFilePtr& mappedFile,
+								  const std::string& modRoot,
+								  std::size_t position,
+								  std::size_t streamSize,
+								  std::size_t fileSize) :
+		_name(name),
+		_mappedFile(mappedFile),
+		_zipstream(mappedFile->data() + position, streamSize, fileSize),
+		_textStream(_zipstream),
+		_modRoot(modRoot)
+	{}
+
+	const std::string& getName() const override
+	{
+		return _name;
+	}
+
+	TextInputStream& getInputStream() override
+	{
+		return _textStream;
+	}
+
+	std::string getModName() const override
+	{
+		return game::current::getModPath(_modRoot);
+	}
+};
+
+}
@@ -0,0 +1,99 @@
+#include "MappedFile.h"
+
+#ifdef WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include "string/encoding.h"
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace archive
+{
+
+#ifdef WIN32
+
+MappedFile::MappedFile(const std::string& path) :
+    _data(nullptr),
+    _size(0),
+    _fileHandle(INVALID_HANDLE_VALUE),
+    _mappingHandle(nullptr)
+{
+    _fileHandle = CreateFileW(string::utf8_to_unicode(path).c_str(), GENERIC_READ, FILE_SHARE_READ,
+        nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (_fileHandle == INVALID_HANDLE_VALUE) return;
+
+    LARGE_INTEGER fileSize;
+
+    // Empty files cannot be mapped
+    if (!GetFileSizeEx(_fileHandle, &fileSize) || fileSize.QuadPart == 0) return;
+
+    _mappingHandle = CreateFileMappingW(_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    if (_mappingHandle == nullptr) return;
+
+    _data = static_cast<const byte_type*>(MapViewOfFile(_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    _size = _data != nullptr ? static_cast<std::size_t>(fileSize.QuadPart) : 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data != nullptr)
+    {
+        UnmapViewOfFile(_data);
+    }
+
+    if (_mappingHandle != nullptr)
+    {
+        CloseHandle(_mappingHandle);
+    }
+
+    if (_fileHandle != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(_fileHandle);
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) :
+    _data(nullptr),
+    _size(0)
+{
+    auto fd = open(path.c_str(), O_RDONLY);
+
+    if (fd == -1) return;
+
+    struct stat info;
+
+    // Empty files cannot be mapped
+    if (fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        auto address = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address != MAP_FAILED)
+        {
+            _data = static_cast<const byte_type*>(address);
+            _size = static_cast<std::size_t>(info.st_size);
+        }
+    }
+
+    // The mapping keeps a reference to the file on its own
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (_data != nullptr)
+    {
+        munmap(const_cast<byte_type*>(_data), _size);
+    }
+}
+
+#endif
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace archive
+{
+
+/**
+ * A read-only memory mapping of a whole file. The mapped bytes remain valid
+ * until the object is destroyed, share the instance to keep them alive.
+ *
+ * The mapping is not guaranteed to succeed (e.g. on empty files or when the
+ * address space is exhausted), callers need to check isValid() and fall back
+ * to read the file through regular streams.
+ */
+class MappedFile
+{
+public:
+    typedef unsigned char byte_type;
+
+private:
+    const byte_type* _data;
+    std::size_t _size;
+
+#ifdef WIN32
+    void* _fileHandle;
+    void* _mappingHandle;
+#endif
+
+public:
+    MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    // Returns true if the file has been mapped successfully
+    bool isValid() const
+    {
+        return _data != nullptr;
+    }
+
+    // The first byte of the mapped file, nullptr if the mapping failed
+    const byte_type* data() const
+    {
+        return _data;
+    }
+
+    std::size_t size() const
+    {
+        return _size;
+    }
+};
+typedef std::shared_ptr<MappedFile> MappedFilePtr;
+
+}
@@ -8,10 +8,13 @@
 
 #include "os/fs.h"
 #include "os/path.h"
+#include "stream/MemoryInputStream.h"
 
 #include "ZipStreamUtils.h"
 #include "DeflatedArchiveFile.h"
 #include "DeflatedArchiveTextFile.h"
+#include "MappedArchiveFile.h"
+#include "MappedArchiveTextFile.h"
 #include "StoredArchiveFile.h"
 #include "StoredArchiveTextFile.h"
 
@@ -40,10 +43,20 @@ ZipArchive::ZipArchive(const std::string& fullPath) :
 		return;
 	}
 
+    mapZipFile();
+
 	try
 	{
 		// Try loading the zip file, this will throw exceptoions on any problem
-		loadZipFile();
+        if (_mappedFile)
+        {
+            stream::MemoryInputStream mappedStream(_mappedFile->data(), _mappedFile->size());
+            loadZipFile(mappedStream);
+        }
+        else
+        {
+            loadZipFile(_istream);
+        }
 	}
 	catch (ZipFailureException& ex)
 	{
@@ -51,11 +64,59 @@ ZipArchive::ZipArchive(const std::string& fullPath) :
 	}
 }
 
+ZipArchive::ZipArchive(const std::string& fullPath, const Index& index) :
+	_fullPath(fullPath),
+	_containingFolder(os::standardPathWithSlash(fs::path(_fullPath).remove_filename())),
+	_istream(_fullPath)
+{
+	if (_istream.failed())
+	{
+		rError() << "Cannot open Zip file stream: " << _fullPath << std::endl;
+		return;
+	}
+
+    mapZipFile();
+
+    for (const auto& entry : index)
+    {
+        auto& fileSystemEntry = _filesystem[entry.path];
+
+        if (!entry.isDirectory)
+        {
+            fileSystemEntry.getRecord() = std::make_shared<ZipRecord>(entry.position,
+                entry.compressedSize, entry.uncompressedSize,
+                entry.isDeflated ? ZipRecord::eDeflated : ZipRecord::eStored);
+        }
+    }
+}
+
 ZipArchive::~ZipArchive()
 {
 	_filesystem.clear();
 }
 
+ZipArchive::Index ZipArchive::getIndex()
+{
+    Index index;
+
+    for (auto& [path, entry] : _filesystem)
+    {
+        auto& indexEntry = index.emplace_back(IndexEntry{ path.string(), entry.isDirectory(), false, 0, 0, 0 });
+
+        if (!entry.isDirectory())
+        {
+            const auto& record = *entry.getRecord();
+
+            indexEntry.isDeflated = record.mode == ZipRecord::eDeflated;
+            indexEntry.position = record.position;
+            indexEntry.compressedSize = record.stream_size;
+            indexEntry.uncompressedSize = record.file_size;
+        }
+    }
+
+    return index;
+}
+
 ArchiveFilePtr ZipArchive::openFile(const std::string& name)
 {
 	ZipFileSystem::iterator i = _filesystem.find(name);
@@ -64,6 +125,21 @@ ArchiveFilePtr ZipArchive::openFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
+        if (_mappedFile)
+        {
+            auto position = getMappedDataPosition(*file);
+
+            if (position == 0) return ArchiveFilePtr();
+
+            switch (file->mode)
+            {
+            case ZipRecord::eStored:
+                return std::make_shared<MappedStoredArchiveFile>(name, _mappedFile, position, file->stream_size);
+            case ZipRecord::eDeflated:
+                return std::make_shared<MappedDeflatedArchiveFile>(name, _mappedFile, position, file->stream_size, file->file_size);
+            }
+        }
+
 		stream::FileInputStream::size_type position = 0;
 
 		{
@@ -104,6 +180,25 @@ ArchiveTextFilePtr ZipArchive::openTextFile(const std::string& name)
 	{
 		const std::shared_ptr<ZipRecord>& file = i->second.getRecord();
 
+        if (_mappedFile)
+        {
+            auto position = getMappedDataPosition(*file);
+
+            if (position == 0) return ArchiveTextFilePtr();
+
+            switch (file->mode)
+            {
+            case ZipRecord::eStored:
+                return std::make_shared<MappedStoredArchiveTextFile>(
+                    name, _mappedFile, _containingFolder, position, file->stream_size
+                );
+            case ZipRecord::eDeflated:
+                return std::make_shared<MappedDeflatedArchiveTextFile>(
+                    name, _mappedFile, _containingFolder, position, file->stream_size, file->file_size
+                );
+            }
+        }
+
 		// Guard against concurrent access
 		std::lock_guard<std::mutex> lock(_streamLock);
 
@@ -163,10 +258,42 @@ std::string ZipArchive::getArchivePath(const std::string& relativePath)
     return _fullPath;
 }
 
-void ZipArchive::readZipRecord()
+void ZipArchive::mapZipFile()
+{
+    _mappedFile = std::make_shared<MappedFile>(_fullPath);
+
+    if (!_mappedFile->isValid())
+    {
+        rWarning() << "Cannot map Zip file into memory, falling back to file streams: " << _fullPath << std::endl;
+        _mappedFile.reset();
+    }
+}
+
+std::size_t ZipArchive::getMappedDataPosition(const ZipRecord& record)
+{
+    // The mapping is read-only, no need to guard against concurrent access
+    if (record.position >= _mappedFile->size()) return 0;
+
+    stream::MemoryInputStream mappedStream(_mappedFile->data() + record.position, _mappedFile->size() - record.position);
+
+    ZipFileHeader header;
+    stream::readZipFileHeader(mappedStream, header);
+
+    auto position = record.position + mappedStream.tell();
+
+    if (header.magic != ZIP_MAGIC_FILE_HEADER || position + record.stream_size > _mappedFile->size())
+    {
+        rError() << "Error reading zip file " << _fullPath << std::endl;
+        return 0;
+    }
+
+    return position;
+}
+
+void ZipArchive::readZipRecord(SeekableInputStream& istream)
 {
 	ZipMagic magic;
-	stream::readZipMagic(_istream, magic);
+	stream::readZipMagic(istream, magic);
 
 	if (magic != ZIP_MAGIC_ROOT_DIR_ENTRY)
 	{
@@ -179,9 +306,9 @@ void ZipArchive::readZipRecord()
 	stream::readZipVersion(_istream, version_extract);
 
 	//unsigned short flags =
-	stream::readLittleEndian<int16_t>(_istream);
+	stream::readLittleEndian<int16_t>(istream);
 	
-	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(_istream);
+	uint16_t compression_mode = stream::readLittleEndian<uint16_t>(istream);
 
 	if (compression_mode != Z_DEFLATED && compression_mode != 0)
 	{
@@ -192,22 +319,22 @@ void ZipArchive::readZipRecord()
 	stream::readZipDosTime(_istream, dostime);
 
 	//unsigned int crc32 =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 	
-	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(_istream);
-	uint16_t namelength = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t extras = stream::readLittleEndian<uint16_t>(_istream);
-	uint16_t comment = stream::readLittleEndian<uint16_t>(_istream);
+	uint32_t compressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint32_t uncompressed_size = stream::readLittleEndian<uint32_t>(istream);
+	uint16_t namelength = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t extras = stream::readLittleEndian<uint16_t>(istream);
+	uint16_t comment = stream::readLittleEndian<uint16_t>(istream);
 
 	//unsigned short diskstart =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned short filetype =
-	stream::readLittleEndian<uint16_t>(_istream);
+	stream::readLittleEndian<uint16_t>(istream);
 	//unsigned int filemode =
-	stream::readLittleEndian<uint32_t>(_istream);
+	stream::readLittleEndian<uint32_t>(istream);
 
-	uint32_t position = stream::readLittleEndian<uint32_t>(_istream);
+	uint32_t position = stream::readLittleEndian<uint32_t>(istream);
 
 	// greebo: Read the filename directly into a newly constructed std::string.
 
@@ -218,11 +345,11 @@ void ZipArchive::readZipRecord()
 
 	std::string path(namelength, '\0');
 
-	_istream.read(
-		reinterpret_cast<stream::FileInputStream::byte_type*>(const_cast<char*>(path.data())),
+	istream.read(
+		reinterpret_cast<InputStream::byte_type*>(const_cast<char*>(path.data())),
 		namelength);
 
-	_istream.seek(extras + comment, stream::FileInputStream::cur);
+	istream.seek(extras + comment, SeekableInputStream::cur);
 
 	if (os::isDirectory(path))
 	{
@@ -246,30 +373,30 @@ void ZipArchive::readZipRecord()
 	}
 }
 
-void ZipArchive::loadZipFile()
+void ZipArchive::loadZipFile(SeekableInputStream& istream)
 {
-	SeekableStream::position_type pos = findZipDiskTrailerPosition(_istream);
+	SeekableStream::position_type pos = findZipDiskTrailerPosition(istream);
 
 	if (pos == 0)
 	{
 		throw ZipFailureException("Unable to locate Zip disk trailer");
 	}
 
-	_istream.seek(pos);
+	istream.seek(pos);
 
 	ZipDiskTrailer trailer;
-	stream::readZipDiskTrailer(_istream, trailer);
+	stream::readZipDiskTrailer(istream, trailer);
 
 	if (trailer.magic != ZIP_MAGIC_DISK_TRAILER)
 	{
 		throw ZipFailureException("Invalid Zip Magic, maybe this is not a zip file?");
 	}
 
-	_istream.seek(trailer.rootseek);
+	istream.seek(trailer.rootseek);
 
 	for (unsigned short i = 0; i < trailer.entries; ++i)
 	{
-		readZipRecord();
+		readZipRecord(istream);
 	}
 }
 
@@ -3,7 +3,9 @@
 #include "iarchive.h"
 #include "GenericFileSystem.h"
 #include "stream/FileInputStream.h"
+#include "MappedFile.h"
 #include <mutex>
+#include <vector>
 
 namespace archive
 {
@@ -16,6 +18,11 @@ namespace archive
  * physical directories.
  *
  * Archives are owned and instantiated by the GlobalFileSystem instance.
+ *
+ * The archive is mapped into memory if possible: the file entries are then
+ * read from the mapped bytes without any locking or copying, and the opened
+ * files keep the mapping alive. If the mapping fails, the entries are read
+ * through separate file streams instead.
  */
 class ZipArchive final :
 	public IArchive
@@ -54,10 +61,32 @@ private:
 	stream::FileInputStream _istream;
     std::mutex _streamLock;
 
+    // The memory mapping of the whole archive, empty if the mapping failed
+    MappedFilePtr _mappedFile;
+
 public:
+    // An entry of the archive's file table, plain data to be stored in the ArchiveIndexCache
+    struct IndexEntry
+    {
+        std::string path;
+        bool isDirectory;
+        bool isDeflated;
+        uint32_t position;
+        uint32_t compressedSize;
+        uint32_t uncompressedSize;
+    };
+    typedef std::vector<IndexEntry> Index;
+
 	ZipArchive(const std::string& fullPath);
+
+    // Constructs the archive from a file table read earlier, skipping the central directory
+	ZipArchive(const std::string& fullPath, const Index& index);
+
 	virtual ~ZipArchive();
 
+    // Returns the file table of this archive, including all directories
+    Index getIndex();
+
 	// Archive implementation
 	ArchiveFilePtr openFile(const std::string& name) override;
 	ArchiveTextFilePtr openTextFile(const std::string& name) override;
@@ -69,8 +98,12 @@ public:
     std::string getArchivePath(const std::string& relativePath) override;
 
 private:
-	void readZipRecord();
-	void loadZipFile();
+	void readZipRecord(SeekableInputStream& istream);
+	void loadZipFile(SeekableInputStream& istream);
+    void mapZipFile();
+
+    // Returns the position of the entry data in the mapped file, or 0 on failure
+    std::size_t getMappedDataPosition(const ZipRecord& record);
 };
 
 }
@@ -18,13 +18,16 @@ namespace registry
 
 XMLRegistry::XMLRegistry() :
     _queryCounter(0),
+    _cacheGeneration(0),
+    _cacheHits(0),
     _changesSinceLastSave(0),
     _shutdown(false)
 {}
 
 void XMLRegistry::shutdown()
 {
-    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed." << std::endl;
+    rMessage() << "XMLRegistry Shutdown: " << _queryCounter << " queries processed, "
+        << _cacheHits << " values served from the cache." << std::endl;
 
     saveToDisk();
 
@@ -81,6 +84,14 @@ void XMLRegistry::saveToDisk()
 }
 
 xml::NodeList XMLRegistry::findXPath(const std::string& path)
+{
+    // The caller might modify the returned nodes
+    invalidateValueCache();
+
+    return findXPathInTrees(path);
+}
+
+xml::NodeList XMLRegistry::findXPathInTrees(const std::string& path)
 {
     // Query the user tree first
     xml::NodeList results = _userTree.findXPath(path);
@@ -115,8 +126,8 @@ sigc::signal<void> XMLRegistry::signalForKey(const std::string& key) const
 
 bool XMLRegistry::keyExists(const std::string& key)
 {
-    // Pass the query on to findXPath which queries the subtrees
-    xml::NodeList result = findXPath(key);
+    // Pass the query on to findXPathInTrees which queries the subtrees
+    xml::NodeList result = findXPathInTrees(key);
     return !result.empty();
 }
 
@@ -129,6 +140,8 @@ void XMLRegistry::deleteXPath(const std::string& path)
     auto numDeletedNodes = _userTree.deleteXPath(path);
     numDeletedNodes += _standardTree.deleteXPath(path);
 
+    invalidateValueCache();
+
     if (numDeletedNodes > 0)
     {
         _changesSinceLastSave++;
@@ -145,6 +158,9 @@ xml::Node XMLRegistry::createKeyWithName(const std::string& path,
 
     _changesSinceLastSave++;
 
+    // The caller is likely to set the value of the returned node
+    invalidateValueCache();
+
     // The key will be created in the user tree (the default tree is read-only)
     return _userTree.createKeyWithName(path, key, name);
 }
@@ -157,6 +173,8 @@ xml::Node XMLRegistry::createKey(const std::string& key)
 
     _changesSinceLastSave++;
 
+    invalidateValueCache();
+
     return _userTree.createKey(key);
 }
 
@@ -170,13 +188,15 @@ void XMLRegistry::setAttribute(const std::string& path,
     _changesSinceLastSave++;
 
     _userTree.setAttribute(path, attrName, attrValue);
+
+    invalidateValueCache();
 }
 
 std::string XMLRegistry::getAttribute(const std::string& path,
                                       const std::string& attrName)
 {
-    // Pass the query to the findXPath method, which queries the user tree first
-    xml::NodeList nodeList = findXPath(path);
+    // Pass the query to the findXPathInTrees method, which queries the user tree first
+    xml::NodeList nodeList = findXPathInTrees(path);
 
     if (nodeList.empty())
     {
@@ -188,8 +208,41 @@ std::string XMLRegistry::getAttribute(const std::string& path,
 
 std::string XMLRegistry::get(const std::string& key)
 {
-    // Pass the query to the findXPath method, which queries the user tree first
-    xml::NodeList nodeList = findXPath(key);
+    std::size_t generation;
+
+    {
+        std::lock_guard<std::mutex> lock(_cacheLock);
+
+        auto cached = _valueCache.find(key);
+
+        if (cached != _valueCache.end())
+        {
+            ++_cacheHits;
+            return cached->second;
+        }
+
+        generation = _cacheGeneration;
+    }
+
+    auto value = lookupValue(key);
+
+    {
+        std::lock_guard<std::mutex> lock(_cacheLock);
+
+        // Don't store the value if the trees have been changed in the meantime
+        if (generation == _cacheGeneration)
+        {
+            _valueCache.emplace(key, value);
+        }
+    }
+
+    return value;
+}
+
+std::string XMLRegistry::lookupValue(const std::string& key)
+{
+    // Pass the query to the findXPathInTrees method, which queries the user tree first
+    xml::NodeList nodeList = findXPathInTrees(key);
 
     // Does it even exist?
     // It may well be the case that this returns two or more nodes that match the key criteria
@@ -215,6 +268,8 @@ void XMLRegistry::set(const std::string& key, const std::string& value)
         _userTree.set(key, string::mb_to_utf8(value));
 
         _changesSinceLastSave++;
+
+        invalidateValueCache();
     }
 
     // Notify the observers
@@ -227,19 +282,38 @@ void XMLRegistry::import(const std::string& importFilePath, const std::string& p
 
     assert(!_shutdown);
 
-    switch (tree)
+    try
     {
-        case treeUser:
-            _userTree.importFromFile(importFilePath, parentKey);
-            break;
-        case treeStandard:
-            _standardTree.importFromFile(importFilePath, parentKey);
-            break;
+        switch (tree)
+        {
+            case treeUser:
+                _userTree.importFromFile(importFilePath, parentKey);
+                break;
+            case treeStandard:
+                _standardTree.importFromFile(importFilePath, parentKey);
+                break;
+        }
     }
+    catch (...)
+    {
+        // A failing import might have changed the tree too
+        invalidateValueCache();
+        throw;
+    }
+
+    invalidateValueCache();
 
     _changesSinceLastSave++;
 }
 
+void XMLRegistry::invalidateValueCache()
+{
+    std::lock_guard<std::mutex> lock(_cacheLock);
+
+    _valueCache.clear();
+    ++_cacheGeneration;
+}
+
 void XMLRegistry::emitSignalForKey(const std::string& changedKey)
 {
     // Do not default-construct a signal, just emit if there is one already
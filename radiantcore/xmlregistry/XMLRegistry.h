@@ -24,6 +24,7 @@
 #include "iregistry.h"
 #include <map>
 #include <mutex>
+#include <unordered_map>
 
 #include "imodule.h"
 #include "RegistryTree.h"
@@ -53,6 +54,14 @@ private:
 	// The query counter for some statistics :)
 	unsigned int _queryCounter;
 
+	// The values returned by get(), keyed by the queried path. Any modification
+	// of the trees is clearing it, including the ones made through the nodes
+	// handed out by findXPath() and createKey(), which could be changed by the caller.
+	std::unordered_map<std::string, std::string> _valueCache;
+	std::size_t _cacheGeneration;
+	std::size_t _cacheHits;
+	std::mutex _cacheLock;
+
 	// Change tracking counter, is reset when saveToDisk() is called
 	unsigned int _changesSinceLastSave;
 
@@ -136,6 +145,14 @@ private:
 
 	void emitSignalForKey(const std::string& changedKey);
 
+	// Queries both trees, the user tree first
+	xml::NodeList findXPathInTrees(const std::string& path);
+
+	// Looks up the value of the given key in the trees, bypassing the cache
+	std::string lookupValue(const std::string& key);
+
+	void invalidateValueCache();
+
 	// Invoked after all modules have been uninitialised
 	void shutdown();
 
@@ -1,11 +1,14 @@
 #include "RadiantTest.h"
 
 #include "ibrush.h"
+#include "icommandsystem.h"
+#include "imemoryaccounting.h"
 #include "imap.h"
 #include "iselection.h"
 #include "itransformable.h"
 #include "scenelib.h"
 #include "math/Quaternion.h"
+#include "math/pi.h"
 #include "algorithm/Scene.h"
 #include "algorithm/Primitives.h"
 #include "math/Vector3.h"
@@ -446,4 +449,122 @@ TEST_F(BrushTest, LoadBrushWithDuplicatePlanes)
     }
 }
 
+TEST_F(BrushTest, PreviewTransformMatchesFrozenWindings)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    auto& brush = *Node_getIBrush(brushNode);
+
+    auto transformable = scene::node_cast<ITransformable>(brushNode);
+    transformable->setRotation(Quaternion::createForZ(math::PI / 4));
+
+    // Evaluating the transform is previewing the windings
+    brush.evaluateBRep();
+
+    auto expectedExtent = 64 * sqrt(2.0);
+    EXPECT_NEAR(brushNode->localAABB().getExtents().x(), expectedExtent, 0.01);
+    EXPECT_NEAR(brushNode->localAABB().getExtents().y(), expectedExtent, 0.01);
+    EXPECT_NEAR(brushNode->localAABB().getExtents().z(), 64, 0.01);
+
+    std::vector<IWinding> previewWindings;
+
+    for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+    {
+        previewWindings.push_back(brush.getFace(i).getWinding());
+    }
+
+    // Moving on with the manipulation is transforming the same windings
+    transformable->setRotation(Quaternion::createForZ(math::PI / 2));
+    brush.evaluateBRep();
+
+    EXPECT_NEAR(brushNode->localAABB().getExtents().x(), 64, 0.01);
+    EXPECT_NEAR(brushNode->localAABB().getExtents().y(), 64, 0.01);
+
+    transformable->setRotation(Quaternion::createForZ(math::PI / 4));
+    transformable->freezeTransform();
+    brush.evaluateBRep();
+
+    // The frozen brush is built from its planes, the vertices should match the preview
+    for (std::size_t i = 0; i < brush.getNumFaces(); ++i)
+    {
+        const auto& face = brush.getFace(i);
+        const auto& winding = face.getWinding();
+
+        EXPECT_EQ(winding.size(), previewWindings[i].size()) << "Face " << i << " has a different vertex count";
+
+        for (const auto& vertex : previewWindings[i])
+        {
+            EXPECT_NEAR(face.getPlane3().distanceToPoint(vertex.vertex), 0, 0.01) << "Preview vertex not on face " << i;
+
+            EXPECT_TRUE(algorithm::faceHasVertex(&face, [&](const WindingVertex& frozen)
+            {
+                return math::isNear(frozen.vertex, vertex.vertex, 0.01) &&
+                    math::isNear(frozen.texcoord, vertex.texcoord, 0.01);
+            })) << "Preview vertex " << vertex.vertex << " not found on face " << i;
+        }
+    }
+}
+
+TEST_F(BrushTest, MemoryReport)
+{
+    loadMap("altar.map");
+
+    // Copying a brush allocates its faces from the pool
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/tiles01");
+    ASSERT_TRUE(brush);
+
+    auto copy = scene::node_cast<scene::Cloneable>(brush)->clone();
+    scene::addNodeToContainer(copy, worldspawn);
+
+    const auto& original = *Node_getIBrush(brush);
+    const auto& copiedBrush = *Node_getIBrush(copy);
+    ASSERT_EQ(copiedBrush.getNumFaces(), original.getNumFaces());
+
+    for (std::size_t i = 0; i < original.getNumFaces(); ++i)
+    {
+        EXPECT_EQ(copiedBrush.getFace(i).getPlane3(), original.getFace(i).getPlane3());
+        EXPECT_EQ(copiedBrush.getFace(i).getShader(), original.getFace(i).getShader());
+    }
+
+    EXPECT_NO_THROW(GlobalCommandSystem().executeCommand("MemoryReport"));
+}
+
+TEST_F(BrushTest, MemoryAccountingReportsBrushFaces)
+{
+    loadMap("altar.map");
+
+    std::size_t numFaces = 0;
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node))
+        {
+            numFaces += Node_getIBrush(node)->getNumFaces();
+        }
+        return true;
+    });
+
+    auto entries = GlobalMemoryAccounting().collectMemoryUsage();
+
+    auto faces = std::find_if(entries.begin(), entries.end(), [](const memory::MemoryUsageEntry& entry)
+    {
+        return entry.reporter == "Map" && entry.name == "Brush faces";
+    });
+    ASSERT_NE(faces, entries.end()) << "Brush faces not reported";
+    EXPECT_EQ(faces->count, numFaces);
+
+    auto sceneGraph = std::find_if(entries.begin(), entries.end(), [](const memory::MemoryUsageEntry& entry)
+    {
+        return entry.reporter == "SceneGraph" && entry.name == "Nodes";
+    });
+    ASSERT_NE(sceneGraph, entries.end()) << "Scene graph nodes not reported";
+    EXPECT_GT(sceneGraph->count, 0);
+
+    // The entries are ordered by reporter
+    EXPECT_TRUE(std::is_sorted(entries.begin(), entries.end(), [](const memory::MemoryUsageEntry& a, const memory::MemoryUsageEntry& b)
+    {
+        return a.reporter < b.reporter;
+    }));
+}
+
 }
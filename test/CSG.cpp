@@ -2,8 +2,11 @@
 
 #include "imap.h"
 #include "ibrush.h"
+#include "iundo.h"
+#include "iselection.h"
 #include "entitylib.h"
 #include "algorithm/Scene.h"
+#include "algorithm/Primitives.h"
 
 namespace test
 {
@@ -224,4 +227,70 @@ TEST_F(CsgTest, CSGMergeWithFuncStatic)
     ASSERT_TRUE(walker.getEntityNode()->hasChildNodes());
 }
 
+TEST_F(CsgTest, CSGSubtractOnlyAffectsIntersectingBrushes)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto targetBrush = algorithm::createCuboidBrush(worldspawn, AABB({ 0, 0, 0 }, { 128, 128, 128 }), "textures/numbers/1");
+    auto distantBrush = algorithm::createCuboidBrush(worldspawn, AABB({ 1024, 0, 0 }, { 32, 32, 32 }), "textures/numbers/2");
+    auto subtrahend = algorithm::createCuboidBrush(worldspawn, AABB({ 128, 0, 0 }, { 64, 64, 64 }), "textures/numbers/3");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(subtrahend, true);
+
+    GlobalCommandSystem().executeCommand("CSGSubtract");
+
+    // The intersected brush got replaced by its fragments, the others are untouched
+    EXPECT_FALSE(targetBrush->getParent());
+    EXPECT_EQ(distantBrush->getParent(), worldspawn);
+    EXPECT_EQ(subtrahend->getParent(), worldspawn);
+
+    // The four side faces and the back face of the subtrahend are cutting the target brush
+    std::size_t fragmentCount = 0;
+    worldspawn->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node) && node != distantBrush && node != subtrahend)
+        {
+            ++fragmentCount;
+        }
+        return true;
+    });
+
+    EXPECT_EQ(fragmentCount, 5);
+}
+
+TEST_F(CsgTest, CSGHollowSelectedBrushes)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto first = algorithm::createCuboidBrush(worldspawn, AABB({ 0, 0, 0 }, { 128, 128, 128 }), "textures/numbers/1");
+    auto second = algorithm::createCuboidBrush(worldspawn, AABB({ 1024, 0, 0 }, { 64, 64, 64 }), "textures/numbers/2");
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    Node_setSelected(first, true);
+    Node_setSelected(second, true);
+
+    GlobalCommandSystem().executeCommand("CSGHollow");
+
+    // Both brushes have been replaced by six selected walls each
+    EXPECT_FALSE(first->getParent());
+    EXPECT_FALSE(second->getParent());
+    EXPECT_EQ(algorithm::getChildCount(worldspawn), 12);
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 12);
+
+    worldspawn->foreachNode([&](const scene::INodePtr& node)
+    {
+        EXPECT_TRUE(Node_isBrush(node));
+        EXPECT_EQ(Node_getIBrush(node)->getNumFaces(), 6) << "Wall brush should be a cuboid";
+        return true;
+    });
+
+    // A single undo step restores the source brushes
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(first->getParent(), worldspawn);
+    EXPECT_EQ(second->getParent(), worldspawn);
+    EXPECT_EQ(algorithm::getChildCount(worldspawn), 2);
+}
+
 }
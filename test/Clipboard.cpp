@@ -6,10 +6,13 @@
 
 #include "testutil/CommandFailureHelper.h"
 #include "testutil/MapOperationMonitor.h"
+#include "algorithm/Entity.h"
 #include "algorithm/Primitives.h"
+#include "algorithm/Scene.h"
 #include "algorithm/View.h"
 #include "algorithm/XmlUtils.h"
 #include "render/View.h"
+#include "string/replace.h"
 
 namespace test
 {
@@ -112,6 +115,91 @@ TEST_F(ClipboardTest, CutIsUndoable)
     EXPECT_TRUE(brush->inScene()) << "Brush should be back now";
 }
 
+TEST_F(ClipboardTest, PasteCopiedNodes)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto worldBrush = algorithm::createCubicBrush(worldspawn, { 0, 0, 0 }, "textures/numbers/1");
+
+    auto funcStatic = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+    algorithm::createCubicBrush(funcStatic, { 256, 0, 0 }, "textures/numbers/2");
+
+    Node_setSelected(worldBrush, true);
+    Node_setSelected(funcStatic, true);
+
+    GlobalCommandSystem().executeCommand("Copy");
+    algorithm::assertStringIsMapxFile(GlobalClipboard().getString());
+
+    // Changes after copying are not affecting the nodes on the clipboard
+    auto originalBounds = worldBrush->worldAABB();
+    GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(0, 0, 512)));
+
+    GlobalCommandSystem().executeCommand("Paste");
+
+    std::vector<scene::INodePtr> pastedNodes;
+    GlobalSelectionSystem().foreachSelected([&](const scene::INodePtr& node) { pastedNodes.push_back(node); });
+
+    EXPECT_EQ(pastedNodes.size(), 2) << "The pasted brush and entity should be selected";
+
+    for (const auto& node : pastedNodes)
+    {
+        EXPECT_TRUE(node->inScene());
+        EXPECT_NE(node, worldBrush);
+        EXPECT_NE(node, funcStatic);
+
+        if (Node_isBrush(node))
+        {
+            EXPECT_EQ(node->getParent(), worldspawn) << "The brush should have been merged into the worldspawn";
+            EXPECT_TRUE(math::isNear(node->worldAABB().getOrigin(), originalBounds.getOrigin(), 0.01));
+        }
+        else
+        {
+            auto entity = Node_getEntity(node);
+            ASSERT_TRUE(entity);
+            EXPECT_EQ(entity->getKeyValue("classname"), "func_static");
+            EXPECT_NE(entity->getKeyValue("name"), Node_getEntity(funcStatic)->getKeyValue("name"))
+                << "The pasted entity should have been assigned a unique name";
+            EXPECT_TRUE(algorithm::findFirstBrushWithMaterial(node, "textures/numbers/2"))
+                << "The child brush should have been pasted along with the entity";
+        }
+    }
+
+    // Pasting once more is creating another copy
+    GlobalCommandSystem().executeCommand("Paste");
+
+    std::size_t numEntityBrushes = 0;
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isBrush(node) && Node_getIBrush(node)->hasShader("textures/numbers/2"))
+        {
+            ++numEntityBrushes;
+        }
+        return true;
+    });
+
+    EXPECT_EQ(numEntityBrushes, 3);
+}
+
+TEST_F(ClipboardTest, PasteChangedClipboardText)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::createCubicBrush(worldspawn, { 0, 0, 0 }, "textures/numbers/1");
+
+    Node_setSelected(brush, true);
+    GlobalCommandSystem().executeCommand("Copy");
+
+    // Let some other application replace the clipboard contents
+    auto text = GlobalClipboard().getString();
+    string::replace_all(text, "textures/numbers/1", "textures/numbers/4");
+    GlobalClipboard().setString(text);
+
+    // The text is parsed since it doesn't match the most recent copy
+    GlobalCommandSystem().executeCommand("Paste");
+
+    EXPECT_TRUE(algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/4"))
+        << "The brush in the clipboard text should have been pasted";
+}
+
 TEST_F(ClipboardTest, CopyFaceSelection)
 {
     // Create a brush and select a single face
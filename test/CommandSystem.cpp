@@ -1,5 +1,11 @@
 #include "RadiantTest.h"
 
+#include "ientity.h"
+#include "iscenegraph.h"
+#include "iundo.h"
+#include "scenelib.h"
+#include "algorithm/Entity.h"
+
 namespace test
 {
 
@@ -282,6 +288,85 @@ TEST_F(CommandSystemTest, AcceptIntAsDoubleArg)
     EXPECT_EQ(rec.args.at(0).getDouble(), -2);
 }
 
+TEST_F(CommandSystemTest, RunPreparedCommand)
+{
+    TestCommandReceiver first("firstPreparedCommand");
+    TestCommandReceiver second("secondPreparedCommand");
+
+    GlobalCommandSystem().addCommand(first.name, [&](const cmd::ArgumentList& a) { first(a); },
+                                     {cmd::ARGTYPE_STRING});
+
+    // Preparing the same string again should return the same ID
+    auto id = GlobalCommandSystem().prepare("firstPreparedCommand \"blah\"; secondPreparedCommand");
+    EXPECT_EQ(GlobalCommandSystem().prepare("firstPreparedCommand \"blah\"; secondPreparedCommand"), id);
+    EXPECT_NE(GlobalCommandSystem().prepare("secondPreparedCommand"), id);
+
+    // The missing second command should not prevent the first from running
+    GlobalCommandSystem().executePrepared(id);
+    GlobalCommandSystem().executePrepared(id);
+    EXPECT_EQ(first.runCount, 2);
+    EXPECT_EQ(first.args.at(0).getString(), "blah");
+
+    // Commands added after preparing are picked up
+    GlobalCommandSystem().addCommand(second.name, [&](const cmd::ArgumentList& a) { second(a); });
+    GlobalCommandSystem().executePrepared(id);
+    EXPECT_EQ(first.runCount, 3);
+    EXPECT_EQ(second.runCount, 1);
+
+    // Removed commands are not executed anymore
+    GlobalCommandSystem().removeCommand(first.name);
+    GlobalCommandSystem().executePrepared(id);
+    EXPECT_EQ(first.runCount, 3);
+    EXPECT_EQ(second.runCount, 2);
+}
+
+namespace
+{
+    class SceneChangeCounter :
+        public scene::Graph::Observer
+    {
+    public:
+        std::size_t count = 0;
+
+        void onSceneGraphChange() override
+        {
+            ++count;
+        }
+    };
+}
+
+TEST_F(CommandSystemTest, RunCommandBatch)
+{
+    auto entity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    // Every invocation is an undoable operation of its own
+    GlobalCommandSystem().addCommand("setBatchTestKey", [&](const cmd::ArgumentList& args)
+    {
+        UndoableCommand undo("setBatchTestKey");
+        entity->getEntity().setKeyValue("batchtest", args.at(0).getString());
+        SceneChangeNotify();
+    }, { cmd::ARGTYPE_STRING });
+
+    SceneChangeCounter counter;
+    GlobalSceneGraph().addSceneObserver(&counter);
+
+    GlobalCommandSystem().executeBatch("setBatchTestKey first; setBatchTestKey second", "batchTest");
+    EXPECT_EQ(entity->getEntity().getKeyValue("batchtest"), "second");
+    EXPECT_EQ(counter.count, 1) << "Scene observers should be notified once";
+
+    // A single undo step reverts the whole batch
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(entity->getEntity().getKeyValue("batchtest"), "");
+
+    // Without batch, every command is its own step
+    GlobalCommandSystem().execute("setBatchTestKey first; setBatchTestKey second");
+    GlobalUndoSystem().undo();
+    EXPECT_EQ(entity->getEntity().getKeyValue("batchtest"), "first");
+
+    GlobalSceneGraph().removeSceneObserver(&counter);
+}
+
 TEST_F(CommandSystemTest, AddCheckedCommand)
 {
     const char* COMMAND_NAME = "testCheckedCommand";
@@ -657,4 +657,106 @@ TEST(ContinuousBufferTest, SyncToBufferAfterApplyingTransaction)
     EXPECT_TRUE(checkDataInBufferObject(buffer, handle2, *bufferObject, eight)) << "Data sync unsuccessful";
 }
 
+
+TEST(ContinuousBufferTest, BestFitAllocation)
+{
+    auto four = std::vector<int>({ 10,11,12,13 });
+
+    render::ContinuousBuffer<int> buffer(64);
+
+    // Allocate 4 + 8 + 4 + 4 + 4 elements, then release the blocks of size 8 and 4 at the end
+    auto handle1 = buffer.allocate(4);
+    auto handle2 = buffer.allocate(8);
+    auto handle3 = buffer.allocate(4);
+    auto handle4 = buffer.allocate(4);
+    auto handle5 = buffer.allocate(4);
+
+    auto offsetOfFourGap = buffer.getOffset(handle4);
+    buffer.deallocate(handle2);
+    buffer.deallocate(handle4);
+
+    // The 4-sized block should go into the gap that fits exactly, not into the first one
+    auto handle6 = buffer.allocate(four.size());
+    EXPECT_EQ(buffer.getOffset(handle6), offsetOfFourGap) << "Block should have been put into the best-fitting gap";
+
+    buffer.setData(handle6, four);
+    EXPECT_TRUE(checkData(buffer, handle6, four));
+
+    buffer.deallocate(handle1);
+    buffer.deallocate(handle3);
+    buffer.deallocate(handle5);
+    buffer.deallocate(handle6);
+
+    // Everything has been merged again
+    auto handle7 = buffer.allocate(64);
+    EXPECT_EQ(buffer.getOffset(handle7), 0) << "This block should be starting at offset 0";
+    EXPECT_EQ(buffer.getNumBufferElements(), 64) << "Buffer should not have grown";
+}
+
+TEST(ContinuousBufferTest, CompactBuffer)
+{
+    render::ContinuousBuffer<int> buffer(64);
+    auto bufferObject = std::make_shared<TestBufferObject>();
+
+    std::vector<render::ContinuousBuffer<int>::Handle> handles;
+    std::vector<std::vector<int>> data;
+
+    for (auto i = 0; i < 8; ++i)
+    {
+        data.emplace_back(std::vector<int>(6, i));
+        handles.push_back(buffer.allocate(8));
+        buffer.setData(handles.back(), data.back());
+    }
+
+    // Release every other block, leaving gaps in between
+    for (auto i = 0; i < 8; i += 2)
+    {
+        buffer.deallocate(handles[i]);
+    }
+
+    EXPECT_EQ(buffer.getNumFragmentedElements(), 32);
+
+    buffer.syncModificationsToBufferObject(bufferObject);
+    auto bufferObjectSize = bufferObject->buffer.size();
+
+    // Compact in small steps, one block at a time
+    std::vector<render::ContinuousBuffer<int>::Handle> movedHandles;
+    auto onSlotMoved = [&](render::ContinuousBuffer<int>::Handle handle) { movedHandles.push_back(handle); };
+
+    EXPECT_FALSE(buffer.compact(1, onSlotMoved));
+    EXPECT_EQ(movedHandles.size(), 1);
+
+    while (!buffer.compact(1, onSlotMoved)) {}
+
+    EXPECT_EQ(movedHandles.size(), 4);
+    EXPECT_EQ(buffer.getNumFragmentedElements(), 0);
+
+    // The remaining blocks are packed at the start of the buffer, the data moved along
+    for (auto i = 1; i < 8; i += 2)
+    {
+        EXPECT_EQ(buffer.getOffset(handles[i]), (i / 2) * 8) << "Block has not been moved to the left";
+        EXPECT_TRUE(checkData(buffer, handles[i], data[i]));
+    }
+
+    // Syncing uploads the moved blocks without resizing the buffer object
+    buffer.syncModificationsToBufferObject(bufferObject);
+    EXPECT_EQ(bufferObject->buffer.size(), bufferObjectSize) << "Buffer object should not have been re-allocated";
+    EXPECT_EQ(bufferObject->lastUsedByteCount, data[7].size() * sizeof(int)) << "Only the used part should have been synced";
+
+    for (auto i = 1; i < 8; i += 2)
+    {
+        EXPECT_TRUE(checkDataInBufferObject(buffer, handles[i], *bufferObject, data[i]));
+    }
+
+    // The free space at the end can be used by a single allocation
+    auto handle = buffer.allocate(32);
+    EXPECT_EQ(buffer.getOffset(handle), 32);
+    EXPECT_EQ(buffer.getNumBufferElements(), 64) << "Buffer should not have grown";
+
+    // Nothing to do anymore
+    movedHandles.clear();
+    EXPECT_TRUE(buffer.compact(1, onSlotMoved));
+    EXPECT_TRUE(movedHandles.empty());
+}
+
 }
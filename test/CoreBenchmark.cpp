@@ -0,0 +1,416 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include "icommandsystem.h"
+#include "imapformat.h"
+#include "iscenegraph.h"
+#include "iselection.h"
+#include "ispacepartition.h"
+#include "iundo.h"
+#include "parser/DefTokeniser.h"
+#include "render/CameraView.h"
+#include "render/ContinuousBuffer.h"
+#include "render/View.h"
+#include "scenelib.h"
+#include "scene/Traverse.h"
+#include "fmt/format.h"
+#include "algorithm/Primitives.h"
+#include "algorithm/ProceduralMap.h"
+#include "algorithm/Selection.h"
+
+namespace test
+{
+
+namespace
+{
+
+struct BenchmarkResult
+{
+    std::string name;
+    std::size_t iterations;
+    double nanosecondsPerIteration;
+
+    // The number of processed items (like tokens or nodes) per iteration, 0 if not applicable
+    std::size_t itemsPerIteration;
+};
+
+// The results of all benchmarks run so far, written to the output file after each test
+std::vector<BenchmarkResult> benchmarkResults;
+
+void writeResults(const std::string& defaultFilename)
+{
+    auto outputPath = getenv("DR_CORE_BENCHMARK_OUTPUT");
+    auto filename = outputPath != nullptr ? std::string(outputPath) : defaultFilename;
+
+    std::ofstream stream(filename, std::ios::trunc);
+
+    stream << "{\n  \"benchmarks\": [\n";
+
+    for (std::size_t i = 0; i < benchmarkResults.size(); ++i)
+    {
+        const auto& result = benchmarkResults[i];
+
+        stream << fmt::format("    {{ \"name\": \"{0}\", \"iterations\": {1}, \"nsPerIteration\": {2:.1f}, \"itemsPerIteration\": {3} }}",
+            result.name, result.iterations, result.nanosecondsPerIteration, result.itemsPerIteration);
+        stream << (i + 1 < benchmarkResults.size() ? ",\n" : "\n");
+    }
+
+    stream << "  ]\n}\n";
+}
+
+/**
+ * Runs the given operation until it has been executed at least MinIterations
+ * times and for at least MinDuration, then records the average time per iteration.
+ * The operation returns the number of items it processed.
+ */
+void runBenchmark(const std::string& name, const std::function<std::size_t()>& operation)
+{
+    constexpr std::size_t MinIterations = 5;
+    constexpr auto MinDuration = std::chrono::milliseconds(500);
+
+    std::size_t iterations = 0;
+    std::size_t items = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::steady_clock::duration::zero();
+
+    while (iterations < MinIterations || elapsed < MinDuration)
+    {
+        items = operation();
+        ++iterations;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    auto nanoseconds = std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+
+    benchmarkResults.push_back(BenchmarkResult{ name, iterations, nanoseconds, items });
+
+    std::cout << fmt::format("{0:<40} {1:>14.0f} ns {2:>10} iterations", name, nanoseconds, iterations);
+
+    if (items > 0)
+    {
+        std::cout << fmt::format(" {0:>14.0f} items/s", items * 1e9 / nanoseconds);
+    }
+
+    std::cout << std::endl;
+}
+
+// Collects the parsed entities without adding them to the scene
+class CollectingImportFilter :
+    public map::IMapImportFilter
+{
+private:
+    const scene::IMapRootNodePtr& _root;
+
+public:
+    std::size_t numEntities = 0;
+    std::size_t numPrimitives = 0;
+
+    CollectingImportFilter(const scene::IMapRootNodePtr& root) :
+        _root(root)
+    {}
+
+    const scene::IMapRootNodePtr& getRootNode() const override
+    {
+        return _root;
+    }
+
+    bool addEntity(const scene::INodePtr& entity) override
+    {
+        ++numEntities;
+        return true;
+    }
+
+    bool addPrimitiveToEntity(const scene::INodePtr& primitive, const scene::INodePtr& entity) override
+    {
+        ++numPrimitives;
+        return true;
+    }
+};
+
+}
+
+/**
+ * Microbenchmarks of frequently used core operations, run on procedurally generated
+ * scenes, such that the results don't depend on any game assets.
+ *
+ * These are built into the drbenchmark executable along with the render benchmark.
+ * The results are printed and written to the file given by the DR_CORE_BENCHMARK_OUTPUT
+ * environment variable, which defaults to core_benchmark.json in the cache folder.
+ */
+class CoreBenchmark :
+    public RadiantTest
+{
+protected:
+    void preShutdown() override
+    {
+        writeResults(_context.getCacheDataPath() + "core_benchmark.json");
+    }
+};
+
+TEST_F(CoreBenchmark, BrushConstruction)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::createCubicBrush(worldspawn);
+    auto& brush = *Node_getIBrush(brushNode);
+
+    // Building the BRep of a brush with many faces clips every face winding by all other planes
+    for (std::size_t sides : { 6, 32 })
+    {
+        runBenchmark(fmt::format("Brush/buildBRep/{0}", sides), [&]()
+        {
+            brush.clear();
+
+            for (std::size_t i = 0; i < sides - 2; ++i)
+            {
+                auto angle = 2 * math::PI * i / (sides - 2);
+                brush.addFace(Plane3(cos(angle), sin(angle), 0, 256));
+            }
+
+            brush.addFace(Plane3(0, 0, 1, 128));
+            brush.addFace(Plane3(0, 0, -1, 128));
+
+            brush.evaluateBRep();
+
+            return brush.getNumFaces();
+        });
+    }
+
+    EXPECT_TRUE(brush.hasContributingFaces());
+}
+
+TEST_F(CoreBenchmark, PatchTesselation)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(0, 0, 0), Vector3(512, 512, 0)));
+    auto patch = Node_getIPatch(patchNode);
+
+    for (std::size_t size : { 3, 15, 31 })
+    {
+        patch->setDims(size, size);
+
+        // Make the control points bumpy, such that the automatic subdivision kicks in
+        for (std::size_t row = 0; row < size; ++row)
+        {
+            for (std::size_t col = 0; col < size; ++col)
+            {
+                patch->ctrlAt(row, col).vertex = Vector3(col * 64.0, row * 64.0, (row + col) % 2 == 0 ? 0 : 64);
+            }
+        }
+
+        patch->controlPointsChanged();
+
+        runBenchmark(fmt::format("PatchTesselation/generate/{0}x{0}", size), [&]()
+        {
+            patch->updateTesselation(true);
+            return std::size_t(0);
+        });
+    }
+}
+
+TEST_F(CoreBenchmark, DefTokeniser)
+{
+    // Material-like declarations, roughly 1 MB of text
+    std::string text;
+
+    for (int i = 0; i < 4000; ++i)
+    {
+        text += fmt::format("textures/benchmark/material_{0}\n{{\n    qer_editorimage textures/benchmark/{0}_ed\n"
+            "    diffusemap textures/benchmark/{0}_d\n    bumpmap textures/benchmark/{0}_local\n"
+            "    {{\n        blend add\n        map textures/benchmark/{0}_glow\n        rgb 0.5 * sintable[time * 0.1]\n    }}\n}}\n\n", i);
+    }
+
+    runBenchmark("DefTokeniser/string", [&]()
+    {
+        parser::BasicDefTokeniser<std::string> tokeniser(text);
+        std::size_t tokens = 0;
+
+        while (tokeniser.hasMoreTokens())
+        {
+            tokeniser.nextToken();
+            ++tokens;
+        }
+
+        return tokens;
+    });
+
+    runBenchmark("DefTokeniser/stream", [&]()
+    {
+        std::istringstream stream(text);
+        parser::BasicDefTokeniser<std::istream> tokeniser(stream);
+        std::size_t tokens = 0;
+
+        while (tokeniser.hasMoreTokens())
+        {
+            tokeniser.nextToken();
+            ++tokens;
+        }
+
+        return tokens;
+    });
+}
+
+TEST_F(CoreBenchmark, MapRoundTrip)
+{
+    algorithm::createProceduralMap();
+
+    auto format = GlobalMapFormatManager().getMapFormatForGameType("doom3", "map");
+    const auto& root = GlobalMapModule().getRoot();
+
+    std::string mapText;
+
+    runBenchmark("Doom3MapWriter/write", [&]()
+    {
+        std::ostringstream output;
+
+        {
+            auto writer = format->getMapWriter();
+            auto exporter = GlobalMapModule().createMapExporter(*writer, root, output);
+            exporter->exportMap(root, scene::traverse);
+        }
+
+        mapText = output.str();
+        return mapText.size();
+    });
+
+    runBenchmark("Doom3MapReader/read", [&]()
+    {
+        CollectingImportFilter filter(root);
+        auto reader = format->getMapReader(filter);
+
+        std::istringstream stream(mapText);
+        reader->readFromStream(stream);
+
+        return filter.numPrimitives;
+    });
+}
+
+TEST_F(CoreBenchmark, SpacePartition)
+{
+    auto statistics = algorithm::createProceduralMap();
+
+    // Collect all nodes, to unlink and re-link them
+    std::vector<scene::INodePtr> nodes;
+
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_isPrimitive(node)) nodes.push_back(node);
+        return true;
+    });
+
+    EXPECT_EQ(nodes.size(), statistics.numBrushes + statistics.numPatches);
+
+    auto spacePartition = GlobalSceneGraph().getSpacePartition();
+
+    runBenchmark("Octree/unlinkAndLink", [&]()
+    {
+        for (const auto& node : nodes)
+        {
+            spacePartition->unlink(node);
+        }
+
+        for (const auto& node : nodes)
+        {
+            spacePartition->link(node);
+        }
+
+        return nodes.size();
+    });
+
+    // Camera views looking along the diagonal of the room grid
+    auto projection = camera::calculateProjectionMatrix(1.0f, 4096.0f, 90.0f, 640, 480);
+    std::vector<render::View> views;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        auto& view = views.emplace_back();
+        view.construct(projection, camera::calculateModelViewMatrix(Vector3(i * 512.0, i * 512.0, 128), Vector3(0, i * 45.0, 0)), 640, 480);
+    }
+
+    runBenchmark("Octree/queryVolume", [&]()
+    {
+        std::size_t visitedNodes = 0;
+
+        for (const auto& view : views)
+        {
+            GlobalSceneGraph().foreachNodeInVolume(view, [&](const scene::INodePtr& node)
+            {
+                ++visitedNodes;
+                return true;
+            });
+        }
+
+        return visitedNodes;
+    });
+}
+
+TEST_F(CoreBenchmark, ContinuousBuffer)
+{
+    constexpr std::size_t NumAllocations = 10000;
+
+    render::ContinuousBuffer<int> buffer;
+    std::vector<render::ContinuousBuffer<int>::Handle> handles;
+    handles.reserve(NumAllocations);
+
+    runBenchmark("ContinuousBuffer/allocateAndFree", [&]()
+    {
+        for (std::size_t i = 0; i < NumAllocations; ++i)
+        {
+            handles.push_back(buffer.allocate(4 + (i * 7) % 60));
+        }
+
+        // Free every other allocation first to create gaps
+        for (std::size_t i = 0; i < handles.size(); i += 2)
+        {
+            buffer.deallocate(handles[i]);
+        }
+
+        for (std::size_t i = 1; i < handles.size(); i += 2)
+        {
+            buffer.deallocate(handles[i]);
+        }
+
+        handles.clear();
+
+        return NumAllocations;
+    });
+}
+
+TEST_F(CoreBenchmark, PointSelection)
+{
+    algorithm::createProceduralMap();
+
+    runBenchmark("Selection/selectPoint", [&]()
+    {
+        for (std::size_t i = 0; i < 16; ++i)
+        {
+            algorithm::performPointSelectionOnPosition(Vector3(i * 512.0 + 256, i * 512.0 + 256, 0),
+                selection::SelectionSystem::eManipulator);
+        }
+
+        return std::size_t(16);
+    });
+}
+
+TEST_F(CoreBenchmark, UndoLargeSelection)
+{
+    auto statistics = algorithm::createProceduralMap();
+
+    GlobalSelectionSystem().setSelectedAll(true);
+
+    EXPECT_GT(GlobalSelectionSystem().countSelected(), 0);
+
+    // Moving the selection saves the undo state of every selected node
+    runBenchmark("UndoSystem/moveSelectionAndUndo", [&]()
+    {
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(0, 0, 16)));
+        GlobalUndoSystem().undo();
+
+        return statistics.numBrushes + statistics.numPatches + statistics.numEntities;
+    });
+}
+
+}
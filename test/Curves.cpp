@@ -5,6 +5,7 @@
 #include "imap.h"
 #include "algorithm/Scene.h"
 #include "algorithm/Selection.h"
+#include <fmt/format.h>
 
 namespace test
 {
@@ -60,6 +61,36 @@ TEST_F(CurveTest, SplineWithoutModelKeyIsSelectable)
     performSelectionTestOnSplineEntity("spline_without_model");
 }
 
+// Moving a single control point re-tesselates the affected part of the curve only
+TEST_F(CurveTest, SplineIsSelectableAfterMovingControlPoint)
+{
+    loadMap("splines.map");
+
+    auto splineEntity = algorithm::getEntityByName(GlobalMapModule().getRoot(), "spline_without_model");
+    auto entity = Node_getEntity(splineEntity);
+
+    auto firstVertex = getFirstNurbsVertex(splineEntity);
+    auto movedVertex = firstVertex + Vector3(0, 0, 64);
+
+    // Replace the first control point, keeping the number of points
+    auto value = entity->getKeyValue("curve_Nurbs");
+    auto firstPointStart = value.find('(');
+    auto firstPointEnd = value.find(' ', value.find_first_not_of(' ', firstPointStart + 1));
+    firstPointEnd = value.find(' ', value.find_first_not_of(' ', firstPointEnd + 1));
+    firstPointEnd = value.find(' ', value.find_first_not_of(' ', firstPointEnd + 1));
+
+    entity->setKeyValue("curve_Nurbs", value.substr(0, firstPointStart) +
+        fmt::format("( {0} {1} {2}", movedVertex.x(), movedVertex.y(), movedVertex.z()) + value.substr(firstPointEnd));
+
+    EXPECT_EQ(getFirstNurbsVertex(splineEntity), movedVertex) << "Control point has not been moved";
+
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0) << "Nothing should be selected at first";
+
+    algorithm::performPointSelectionOnPosition(movedVertex, selection::SelectionSystem::eToggle);
+    EXPECT_EQ(GlobalSelectionSystem().countSelected(), 1) << "Curve should be selectable at the moved position";
+    EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), splineEntity);
+}
+
 TEST_F(CurveTest, CreateCatmullRomCurve)
 {
     GlobalCommandSystem().executeCommand("CreateCurveCatmullRom");
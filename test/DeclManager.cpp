@@ -1,5 +1,8 @@
 #include "RadiantTest.h"
 
+#include <fstream>
+#include <future>
+
 #include "igame.h"
 #include "ideclmanager.h"
 #include "testutil/TemporaryFile.h"
@@ -9,6 +12,7 @@
 #include "os/path.h"
 #include "parser/DefBlockSyntaxParser.h"
 #include "string/case_conv.h"
+#include "fmt/format.h"
 
 namespace test
 {
@@ -262,6 +266,19 @@ TEST_F(DeclManagerTest, DeclFolderRegistrationWithoutExtensionDot)
     checkKnownTestDeclNames();
 }
 
+TEST_F(DeclManagerTest, IsDeclarationFile)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, "decl");
+
+    EXPECT_TRUE(GlobalDeclarationManager().isDeclarationFile("testdecls/numbers.decl"));
+    EXPECT_TRUE(GlobalDeclarationManager().isDeclarationFile("testdecls/NUMBERS.DECL")) << "Extension should be case-insensitive";
+    EXPECT_TRUE(GlobalDeclarationManager().isDeclarationFile("testdecls\\numbers.decl")) << "Backslashes should be accepted";
+    EXPECT_FALSE(GlobalDeclarationManager().isDeclarationFile("testdecls/subfolder/numbers.decl")) << "Subfolders are not parsed";
+    EXPECT_FALSE(GlobalDeclarationManager().isDeclarationFile("testdecls/numbers.txt"));
+    EXPECT_FALSE(GlobalDeclarationManager().isDeclarationFile("models/numbers.decl"));
+}
+
 // Test a second decl creator
 TEST_F(DeclManagerTest, DeclTypeCreatorRegistration)
 {
@@ -396,12 +413,26 @@ TEST_F(DeclManagerTest, DeclsReloadedSignals)
         [&]() { testdecl2sReloadedFired = true; }
     );
 
+    // Nothing changed on disk, no type should be notified
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_FALSE(testdeclsReloadingFired) << "testdecl signal should not fire without any changes";
+    EXPECT_FALSE(testdecl2sReloadingFired) << "testdecl2 signal should not fire without any changes";
+    EXPECT_EQ(testdeclsReloadedFireCount, 0) << "testdecl signal should not fire without any changes";
+    EXPECT_FALSE(testdecl2sReloadedFired) << "testdecl2 signal should not fire without any changes";
+
+    // Add a new testdecl, only this type should be notified
+    TemporaryFile tempFile(_context.getTestProjectPath() + "testdecls/temp_file.decl");
+    tempFile.setContents(R"(
+testdecl decl/temporary/11 { diffusemap textures/temporary/11 }
+)");
+
     GlobalDeclarationManager().reloadDeclarations();
 
     EXPECT_TRUE(testdeclsReloadingFired) << "testdecl signal should have fired before reloadDecls";
-    EXPECT_TRUE(testdecl2sReloadingFired) << "testdecl2 signal should have fired before reloadDecls";
+    EXPECT_FALSE(testdecl2sReloadingFired) << "testdecl2 signal should not fire, no testdecl2 has changed";
     EXPECT_EQ(testdeclsReloadedFireCount, 1) << "testdecl signal should have fired once after reloadDecls";
-    EXPECT_TRUE(testdecl2sReloadedFired) << "testdecl2 signal should have fired after reloadDecls";
+    EXPECT_FALSE(testdecl2sReloadedFired) << "testdecl2 signal should not fire, no testdecl2 has changed";
 
     // The signal has to be fire on the same thread as the calling code
     EXPECT_EQ(callingThreadId, signalThreadId) << "Reloaded Signal should have been fired on the calling thread.";
@@ -443,6 +474,55 @@ TEST_F(DeclManagerTest, FindOrCreateDeclaration)
         << "We expect the created declaration to be persistent";
 }
 
+TEST_F(DeclManagerTest, LookupsDontBlockOnRunningIteration)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    std::size_t numVisited = 0;
+
+    GlobalDeclarationManager().foreachDeclaration(decl::Type::TestDecl, [&](const decl::IDeclaration::Ptr&)
+    {
+        if (numVisited++ > 0) return;
+
+        // A lookup from a different thread must not have to wait for this iteration to finish
+        auto lookup = std::async(std::launch::async, []()
+        {
+            return GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/exporttest/guisurf1");
+        });
+
+        ASSERT_EQ(lookup.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+        EXPECT_TRUE(lookup.get());
+    });
+
+    EXPECT_GT(numVisited, 1);
+}
+
+TEST_F(DeclManagerTest, LookupsReflectAddedAndRenamedDeclarations)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    auto countDecls = []()
+    {
+        std::size_t count = 0;
+        GlobalDeclarationManager().foreachDeclaration(decl::Type::TestDecl, [&](const decl::IDeclaration::Ptr&) { ++count; });
+        return count;
+    };
+
+    auto countBefore = countDecls();
+    auto created = GlobalDeclarationManager().findOrCreateDeclaration(decl::Type::TestDecl, "decl/created");
+
+    EXPECT_EQ(countDecls(), countBefore + 1);
+    EXPECT_EQ(GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/created"), created);
+
+    EXPECT_TRUE(GlobalDeclarationManager().renameDeclaration(decl::Type::TestDecl, "decl/created", "decl/renamed"));
+
+    EXPECT_FALSE(GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/created"));
+    EXPECT_EQ(GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/renamed"), created);
+    EXPECT_EQ(countDecls(), countBefore + 1);
+}
+
 TEST_F(DeclManagerTest, FindOrCreateUnknownDeclarationType)
 {
     // Unknown types should yield an exception
@@ -671,6 +751,105 @@ TEST_F(DeclManagerTest, ReloadDeclarationsIncreasesParseStamp)
     EXPECT_NE(decl->getParseStamp(), firstParseStamp) << "Parse stamp should have changed on reload";
 }
 
+TEST_F(DeclManagerTest, ReloadDeclarationsLeavesUnchangedDeclarations)
+{
+    TemporaryFile tempFile(_context.getTestProjectPath() + "testdecls/temp_file.decl");
+    tempFile.setContents(R"(
+testdecl decl/temporary/11 { diffusemap textures/temporary/11 }
+testdecl decl/temporary/12 { diffusemap textures/temporary/12 }
+)");
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    auto unchanged = GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/exporttest/guisurf1");
+    auto temp11 = GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/temporary/11");
+    auto temp12 = GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/temporary/12");
+
+    std::size_t unchangedSignalCount = 0;
+    std::size_t temp11SignalCount = 0;
+    std::size_t temp12SignalCount = 0;
+    unchanged->signal_DeclarationChanged().connect([&] { ++unchangedSignalCount; });
+    temp11->signal_DeclarationChanged().connect([&] { ++temp11SignalCount; });
+    temp12->signal_DeclarationChanged().connect([&] { ++temp12SignalCount; });
+
+    // Change decl 12 only, the other decl in the same file stays untouched
+    tempFile.setContents(R"(
+testdecl decl/temporary/11 { diffusemap textures/temporary/11 }
+testdecl decl/temporary/12 { diffusemap textures/changed_temporary/12 }
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(unchangedSignalCount, 0) << "Declaration in an unchanged file should not have been updated";
+    EXPECT_EQ(temp11SignalCount, 0) << "Unchanged declaration should not have been updated";
+    EXPECT_EQ(temp12SignalCount, 1) << "Changed declaration should have been updated";
+    expectDeclContains(decl::Type::TestDecl, "decl/temporary/12", "diffusemap textures/changed_temporary/12");
+
+    // All declarations should still carry the new parse stamp
+    EXPECT_EQ(unchanged->getParseStamp(), temp12->getParseStamp());
+    EXPECT_EQ(temp11->getParseStamp(), temp12->getParseStamp());
+}
+
+// The files are parsed concurrently, the first file in alphabetical order still defines a decl
+TEST_F(DeclManagerTest, FirstFileDefinesDeclarationWhenParsingConcurrently)
+{
+    std::vector<std::unique_ptr<TemporaryFile>> tempFiles;
+
+    for (int i = 0; i < 32; ++i)
+    {
+        auto number = fmt::format("{0:02d}", i);
+
+        tempFiles.emplace_back(std::make_unique<TemporaryFile>(
+            _context.getTestProjectPath() + "testdecls/temp_file_" + number + ".decl",
+            "testdecl decl/temporary/shared { diffusemap textures/temporary/" + number + " }\n" +
+            "testdecl decl/temporary/" + number + " { diffusemap textures/temporary/" + number + " }\n"
+        ));
+    }
+
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    for (int i = 0; i < 32; ++i)
+    {
+        expectDeclIsPresent(decl::Type::TestDecl, fmt::format("decl/temporary/{0:02d}", i));
+    }
+
+    expectDeclContains(decl::Type::TestDecl, "decl/temporary/shared", "diffusemap textures/temporary/00");
+
+    // Same thing after reparsing the changed files
+    tempFiles.front()->setContents("testdecl decl/temporary/00 { diffusemap textures/temporary/00 }\n");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    expectDeclContains(decl::Type::TestDecl, "decl/temporary/shared", "diffusemap textures/temporary/01");
+}
+
+// Writes a truncated declaration cache before the modules start up
+class DeclManagerWithCorruptCacheTest :
+    public DeclManagerTest
+{
+public:
+    void preStartup() override
+    {
+        DeclManagerTest::preStartup();
+
+        std::ofstream cacheFile(_context.getCacheDataPath() + "decl_syntax.cache", std::ios::binary);
+        cacheFile << "DRDECLCA" << '\x01' << '\0' << '\0' << '\0' << '\x05';
+    }
+};
+
+TEST_F(DeclManagerWithCorruptCacheTest, UnreadableCacheIsDiscarded)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    // All files are parsed as if there was no cache
+    expectDeclIsPresent(decl::Type::TestDecl, "decl/exporttest/guisurf1");
+    expectDeclIsPresent(decl::Type::TestDecl, "decl/numbers/0");
+    expectDeclContains(decl::Type::TestDecl, "decl/exporttest/guisurf1", "guis/lvlmaps/genericmap.gui");
+}
+
 // A declaration that is removed after reloadDecls should have its visibility set to hidden
 TEST_F(DeclManagerTest, RemovedDeclarationIsHidden)
 {
@@ -1131,6 +1310,50 @@ TEST_F(DeclManagerTest, RenameDeclaration)
     EXPECT_EQ(newSyntax.fileInfo.fullPath(), oldSyntax.fileInfo.fullPath());
 }
 
+TEST_F(DeclManagerTest, NameSnapshot)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    auto snapshot = GlobalDeclarationManager().getNameSnapshot(decl::Type::TestDecl);
+
+    std::size_t declCount = 0;
+    GlobalDeclarationManager().foreachDeclaration(decl::Type::TestDecl, [&](const decl::IDeclaration::Ptr&) { ++declCount; });
+    EXPECT_EQ(snapshot->entries.size(), declCount);
+
+    auto entry = std::find_if(snapshot->entries.begin(), snapshot->entries.end(),
+        [](const decl::DeclarationNameSnapshot::Entry& e) { return e.name == "decl/precedence_test/1"; });
+    ASSERT_NE(entry, snapshot->entries.end());
+
+    auto decl = GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/precedence_test/1");
+    EXPECT_EQ(entry->fullPath, decl->getModName() + "/decl/precedence_test/1");
+    EXPECT_EQ(entry->visibility, decl->getBlockSyntax().fileInfo.visibility);
+
+    // Unchanged declarations return the same snapshot
+    EXPECT_EQ(GlobalDeclarationManager().getNameSnapshot(decl::Type::TestDecl), snapshot);
+
+    GlobalDeclarationManager().renameDeclaration(decl::Type::TestDecl, "decl/precedence_test/1", "decl/renamed/1");
+
+    auto renamedSnapshot = GlobalDeclarationManager().getNameSnapshot(decl::Type::TestDecl);
+    EXPECT_GT(renamedSnapshot->version, snapshot->version);
+    EXPECT_EQ(renamedSnapshot->entries.size(), snapshot->entries.size());
+
+    auto hasName = [](const decl::DeclarationNameSnapshot::Ptr& s, const std::string& name)
+    {
+        return std::any_of(s->entries.begin(), s->entries.end(),
+            [&](const decl::DeclarationNameSnapshot::Entry& e) { return e.name == name; });
+    };
+
+    EXPECT_TRUE(hasName(renamedSnapshot, "decl/renamed/1"));
+    EXPECT_FALSE(hasName(renamedSnapshot, "decl/precedence_test/1"));
+
+    // The previous snapshot is left untouched
+    EXPECT_TRUE(hasName(snapshot, "decl/precedence_test/1"));
+
+    // Unknown decl types have an empty snapshot
+    EXPECT_TRUE(GlobalDeclarationManager().getNameSnapshot(decl::Type::TestDecl2)->entries.empty());
+}
+
 TEST_F(DeclManagerTest, DeclRenamedSignal)
 {
     GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
@@ -1522,6 +1745,35 @@ TEST_F(DeclManagerTest, SaveExistingDeclWithMixedCaseTypename)
     // The test fixture will restore the original file contents in TearDown
 }
 
+TEST_F(DeclManagerTest, SaveDeclarationsDeferred)
+{
+    GlobalDeclarationManager().registerDeclType("testdecl", std::make_shared<TestDeclarationCreator>());
+    GlobalDeclarationManager().registerDeclFolder(decl::Type::TestDecl, TEST_DECL_FOLDER, ".decl");
+
+    auto decl1 = std::static_pointer_cast<ITestDeclaration>(
+        GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/numbers/1"));
+    auto decl2 = std::static_pointer_cast<ITestDeclaration>(
+        GlobalDeclarationManager().findDeclaration(decl::Type::TestDecl, "decl/numbers/2"));
+    EXPECT_EQ(decl1->getDeclFilePath(), decl2->getDeclFilePath()) << "The decls should be in the same .decl file";
+
+    decl1->setKeyValue("diffusemap", "textures/changed/1");
+    GlobalDeclarationManager().saveDeclarationDeferred(decl1);
+
+    decl2->setKeyValue("diffusemap", "textures/changed/2");
+    GlobalDeclarationManager().saveDeclarationDeferred(decl2);
+
+    // Saving the same decl again before it is written replaces the queued block
+    decl1->setKeyValue("diffusemap", "textures/changed_again/1");
+    GlobalDeclarationManager().saveDeclarationDeferred(decl1);
+
+    GlobalDeclarationManager().waitForPendingSaves();
+
+    expectDeclIsPresentInFile(decl1, decl1->getBlockSyntax().fileInfo.fullPath(), true);
+    expectDeclIsPresentInFile(decl2, decl2->getBlockSyntax().fileInfo.fullPath(), true);
+
+    // The test fixture will restore the original file contents in TearDown
+}
+
 // Looks like this: testdecl decl/numbers/5 { // a comment in the same line as the opening brace
 TEST_F(DeclManagerTest, SaveExistingDeclWithCommentInTheSameLine)
 {
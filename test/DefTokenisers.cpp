@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
 
+#include <clocale>
+#include <cmath>
+#include <vector>
 #include "parser/DefTokeniser.h"
 
 namespace test
@@ -128,4 +131,125 @@ TEST(DefTokeniser, EmptyQuotesAtEndOfBlock)
     EXPECT_EQ(keyValuePairs["mins"], "-1 -1 -3");
 }
 
+namespace
+{
+
+std::vector<std::string> collectTokens(parser::DefTokeniser& tokeniser)
+{
+    std::vector<std::string> tokens;
+
+    while (tokeniser.hasMoreTokens())
+    {
+        tokens.emplace_back(tokeniser.nextToken());
+    }
+
+    return tokens;
+}
+
+// The string_view variant should produce the same tokens as the std::string one
+void expectSameTokens(const std::string& input, const char* delims = parser::WHITESPACE, const char* keptDelims = "{}()")
+{
+    parser::BasicDefTokeniser<std::string> stringTokeniser(input, delims, keptDelims);
+    parser::BasicDefTokeniser<std::string_view> viewTokeniser(input, delims, keptDelims);
+
+    EXPECT_EQ(collectTokens(viewTokeniser), collectTokens(stringTokeniser)) << "Tokens differ for input: " << input;
+}
+
+}
+
+TEST(DefTokeniser, StringViewTokensMatchStringTokens)
+{
+    expectSameTokens("");
+    expectSameTokens(" \t \r\n\t");
+    expectSameTokens(R"("inherit"					"atdm:mover_handle_base")");
+    expectSameTokens(R"(		"" )");
+    expectSameTokens(R"("")");
+    expectSameTokens("\"unterminated");
+    expectSameTokens("\"");
+    expectSameTokens(R"( "inherit"	"atdm:" \
+    "mover_handle_base")");
+    expectSameTokens(R"( "inherit"	"atdm:" \ 	 
+    "mover_handle_base" "" \ "" next)");
+    expectSameTokens(R"("escaped \"quote\" \n \t \x \\" token)");
+    expectSameTokens("\"trailing backslash \\");
+    expectSameTokens("\"abc\" \\");
+    expectSameTokens("material textures/common/caulk { qer_editorimage textures/common/caulk.tga }");
+    expectSameTokens("// comment\ntoken // trailing comment\r\nsecond /* delimited\n comment **/ third");
+    expectSameTokens("abc//comment\ndef abc/*comment*/def /*/ still comment */ x");
+    expectSameTokens("/a /  a/ b / /*unterminated");
+    expectSameTokens("token/");
+    expectSameTokens("/");
+    expectSameTokens("abc\"quoted\"def");
+    expectSameTokens("{(abc)}{} ( 0 0 1 -604 ) ( ( 0.015625 0 255.9375 ) )");
+    expectSameTokens("func(a,b)", parser::WHITESPACE, "{}(),");
+    expectSameTokens("a+b*c/2-[d%e]", "", "[]+-%*/");
+}
+
+TEST(DefTokeniser, StringViewTokensReferToTheBuffer)
+{
+    std::string input = R"(textures/common/caulk "quoted" "escaped\n")";
+    parser::BasicDefTokeniser<std::string_view> tokeniser(input);
+
+    auto token = tokeniser.nextTokenView();
+    EXPECT_EQ(token, "textures/common/caulk");
+    EXPECT_EQ(token.data(), input.data()) << "Unquoted token should refer to the buffer";
+
+    token = tokeniser.nextTokenView();
+    EXPECT_EQ(token, "quoted");
+    EXPECT_EQ(token.data(), input.data() + 23) << "Quoted token without escapes should refer to the buffer";
+
+    EXPECT_EQ(tokeniser.peek(), "escaped\n");
+    EXPECT_EQ(tokeniser.nextTokenView(), "escaped\n");
+    EXPECT_FALSE(tokeniser.hasMoreTokens());
+
+    EXPECT_THROW(tokeniser.nextTokenView(), parser::ParseException);
+}
+
+TEST(DefTokeniser, StringViewAssertAndSkipTokens)
+{
+    std::string input = "{ 1 2 3 }";
+    parser::BasicDefTokeniser<std::string_view> tokeniser(input);
+
+    EXPECT_NO_THROW(tokeniser.assertNextToken("{"));
+    tokeniser.skipTokens(2);
+    EXPECT_THROW(tokeniser.assertNextToken("{"), parser::ParseException);
+    EXPECT_EQ(tokeniser.nextToken(), "}");
+}
+
+TEST(DefTokeniser, NumericTokens)
+{
+    std::string input = "( 0.5 -1024 +3 1e3 -0 .25 ) 12 +7 x -1 99999999999999999999";
+
+    // Numbers must be parsed the same way, regardless of the current locale
+    auto previousLocale = std::string(std::setlocale(LC_NUMERIC, nullptr));
+
+    for (auto locale : { "C", "de_DE.UTF-8" })
+    {
+        if (std::setlocale(LC_NUMERIC, locale) == nullptr) continue;
+
+        parser::BasicDefTokeniser<std::string_view> tokeniser(input);
+
+        tokeniser.assertNextToken("(");
+        EXPECT_EQ(tokeniser.nextDouble(), 0.5);
+        EXPECT_EQ(tokeniser.nextDouble(), -1024);
+        EXPECT_EQ(tokeniser.nextDouble(), 3);
+        EXPECT_EQ(tokeniser.nextDouble(), 1000);
+        EXPECT_EQ(tokeniser.nextDouble(), 0);
+        EXPECT_EQ(tokeniser.nextDouble(), 0.25);
+        EXPECT_EQ(tokeniser.nextDouble(2), 2) << "Non-numeric token should yield the fallback value";
+
+        EXPECT_EQ(tokeniser.nextInteger<std::size_t>(), 12);
+        EXPECT_EQ(tokeniser.nextInteger<std::size_t>(), 7);
+        EXPECT_EQ(tokeniser.nextInteger<std::size_t>(5), 5);
+        EXPECT_EQ(tokeniser.nextInteger<std::size_t>(5), 5) << "Negative values are out of range";
+        EXPECT_EQ(tokeniser.nextInteger<int>(5), 5) << "Large values are out of range";
+        EXPECT_FALSE(tokeniser.hasMoreTokens());
+    }
+
+    std::setlocale(LC_NUMERIC, previousLocale.c_str());
+
+    EXPECT_EQ(string::parseDouble("1e400"), HUGE_VAL) << "Overflowing values should behave like strtod";
+    EXPECT_EQ(string::parseDouble("12.5abc"), 12.5) << "Only the leading number should be converted";
+}
+
 }
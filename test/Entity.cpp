@@ -2,6 +2,7 @@
 
 #include "ieclass.h"
 #include "ientity.h"
+#include "ilightnode.h"
 #include "irendersystemfactory.h"
 #include "iselectable.h"
 #include "iselection.h"
@@ -241,6 +242,39 @@ TEST_F(EntityTest, CopySpawnargs)
     EXPECT_EQ(overlap.size(), 0);
 }
 
+TEST_F(EntityTest, CopiedSpawnargsShareStrings)
+{
+    auto light = algorithm::createEntityByClassName("atdm:light_base");
+    auto& spawnArgs = light->getEntity();
+    spawnArgs.setKeyValue("_color", "1 0 1");
+
+    auto lightCopy = light->clone();
+    Entity* clonedEnt = Node_getEntity(lightCopy);
+    ASSERT_TRUE(clonedEnt);
+
+    // Keys and values are interned, both entities refer to the same string instances
+    std::map<std::string, std::pair<const std::string*, const std::string*>> original;
+    spawnArgs.forEachEntityKeyValue([&](const std::string& k, EntityKeyValue& v)
+    {
+        original.emplace(k, std::make_pair(&k, &v.get()));
+    });
+
+    std::size_t count = 0;
+    clonedEnt->forEachEntityKeyValue([&](const std::string& k, EntityKeyValue& v)
+    {
+        EXPECT_EQ(original.at(k).first, &k) << "Key " << k << " should be shared";
+        EXPECT_EQ(original.at(k).second, &v.get()) << "Value of " << k << " should be shared";
+        ++count;
+    });
+
+    EXPECT_EQ(count, original.size());
+
+    // Changing the value on the copy must not affect the original
+    clonedEnt->setKeyValue("_color", "0 1 0");
+    EXPECT_EQ(spawnArgs.getKeyValue("_color"), "1 0 1");
+    EXPECT_EQ(clonedEnt->getKeyValue("_color"), "0 1 0");
+}
+
 TEST_F(EntityTest, UndoRedoSpawnargValueChange)
 {
     // Create entity with initial default args.
@@ -529,6 +563,68 @@ TEST_F(EntityTest, TranslateFuncStatic)
     EXPECT_EQ(torch.args().getKeyValue("origin"), "128 56 -64");
 }
 
+TEST_F(EntityTest, TargetManagerResolvesNames)
+{
+    auto source = TestEntity::create("func_static");
+    auto target = TestEntity::create("light");
+    target.args().setKeyValue("name", "target_light");
+    source.args().setKeyValue("target", "target_light");
+
+    auto& targetManager = GlobalMapModule().getRoot()->getTargetManager();
+    EXPECT_EQ(targetManager.getTarget("target_light")->getNode(), target.node.get());
+
+    // The source got a child node rendering the target line
+    std::size_t numConnections = 0;
+    source.node->foreachNode([&](const scene::INodePtr& child)
+    {
+        if (child->getNodeType() == scene::INode::Type::EntityConnection) ++numConnections;
+        return true;
+    });
+    EXPECT_EQ(numConnections, 1);
+
+    // Renaming the target disassociates the old name
+    target.args().setKeyValue("name", "renamed_light");
+    EXPECT_TRUE(targetManager.getTarget("target_light")->isEmpty());
+    EXPECT_EQ(targetManager.getTarget("renamed_light")->getNode(), target.node.get());
+
+    // Removing the target from the scene clears the target
+    scene::removeNodeFromParent(target.node);
+    EXPECT_TRUE(targetManager.getTarget("renamed_light")->isEmpty());
+}
+
+TEST_F(EntityTest, EntityClassIndexTracksEntities)
+{
+    auto& index = GlobalMapModule().getRoot()->getEntityClassIndex();
+    EXPECT_EQ(index.getNumEntitiesOfClass("func_static"), 0);
+
+    auto first = TestEntity::create("func_static");
+    auto second = TestEntity::create("func_static");
+    auto light = TestEntity::create("light");
+
+    EXPECT_EQ(index.getNumEntitiesOfClass("func_static"), 2);
+    EXPECT_EQ(index.getNumEntitiesOfClass("FUNC_STATIC"), 2);
+    EXPECT_EQ(index.getNumEntitiesOfClass("light"), 1);
+
+    // Entities are visited in the order they have been inserted
+    std::vector<scene::INodePtr> visited;
+    index.foreachEntityOfClass("func_static", [&](const IEntityNodePtr& entity)
+    {
+        visited.push_back(entity);
+    });
+    ASSERT_EQ(visited.size(), 2);
+    EXPECT_EQ(visited[0], first.node);
+    EXPECT_EQ(visited[1], second.node);
+
+    // Changing the classname moves the entity to the other class
+    second.args().setKeyValue("classname", "light");
+    EXPECT_EQ(index.getNumEntitiesOfClass("func_static"), 1);
+    EXPECT_EQ(index.getNumEntitiesOfClass("light"), 2);
+
+    // Removed entities are dropped from the index
+    scene::removeNodeFromParent(light.node);
+    EXPECT_EQ(index.getNumEntitiesOfClass("light"), 1);
+}
+
 TEST_F(EntityTest, RotateFuncStatic)
 {
     auto torch = TestEntity::create("func_static");
@@ -779,6 +875,53 @@ TEST_F(EntityTest, RenderLightProperties)
               "lights/biground_torchflicker");
 }
 
+TEST_F(EntityTest, LightBoundsFollowVolumeChanges)
+{
+    auto light = algorithm::createEntityByClassName("light");
+    scene::addNodeToContainer(light, GlobalMapModule().getRoot());
+
+    auto& spawnArgs = light->getEntity();
+    auto lightNode = std::dynamic_pointer_cast<ILightNode>(light);
+    ASSERT_TRUE(lightNode);
+    const auto& rLight = lightNode->getRendererLight();
+
+    static const Vector3 ORIGIN(64, -128, 32);
+    spawnArgs.setKeyValue("origin", string::to_string(ORIGIN));
+    spawnArgs.setKeyValue("light_radius", "100 200 300");
+
+    EXPECT_EQ(rLight.lightAABB().origin, ORIGIN);
+    EXPECT_EQ(rLight.lightAABB().extents, Vector3(100, 200, 300));
+    EXPECT_TRUE(light->worldAABB().contains(rLight.lightAABB()));
+
+    // A colour change doesn't affect the volume
+    spawnArgs.setKeyValue("_color", "0.5 0.2 0.1");
+    EXPECT_EQ(rLight.lightAABB().origin, ORIGIN);
+    EXPECT_EQ(rLight.lightAABB().extents, Vector3(100, 200, 300));
+
+    // Shrinking the radius
+    spawnArgs.setKeyValue("light_radius", "50 50 50");
+    EXPECT_EQ(rLight.lightAABB().extents, Vector3(50, 50, 50));
+    EXPECT_TRUE(light->worldAABB().contains(rLight.lightAABB()));
+
+    // Turn it into a projected light, the bounds need to follow every change of the projection
+    spawnArgs.setKeyValue("light_target", "0 0 -256");
+    spawnArgs.setKeyValue("light_up", "0 128 0");
+    spawnArgs.setKeyValue("light_right", "-128 0 0");
+
+    auto projectedBounds = rLight.lightAABB();
+    EXPECT_TRUE(projectedBounds.isValid());
+    EXPECT_NEAR(projectedBounds.origin.z() - projectedBounds.extents.z(), ORIGIN.z() - 256, 0.01);
+
+    spawnArgs.setKeyValue("light_target", "0 0 -512");
+    EXPECT_NEAR(rLight.lightAABB().origin.z() - rLight.lightAABB().extents.z(), ORIGIN.z() - 512, 0.01);
+
+    // Moving the light moves the cached bounds along
+    auto boundsBeforeMove = rLight.lightAABB();
+    spawnArgs.setKeyValue("origin", string::to_string(ORIGIN + Vector3(16, 0, 0)));
+    EXPECT_TRUE(math::isNear(rLight.lightAABB().origin, boundsBeforeMove.origin + Vector3(16, 0, 0), 0.01));
+    EXPECT_TRUE(math::isNear(rLight.lightAABB().extents, boundsBeforeMove.extents, 0.01));
+}
+
 TEST_F(EntityTest, RenderEmptyFuncStatic)
 {
     auto funcStatic = algorithm::createEntityByClassName("func_static");
@@ -1653,6 +1796,88 @@ TEST_F(EntityTest, KeyObserverKeyRemoval)
     keyValue->detach(observer);
 }
 
+TEST_F(EntityTest, BatchUpdateCoalescesNotifications)
+{
+    auto [guardNode, guard] = TestEntity::create("atdm:ai_builder_guard");
+
+    guard->setKeyValue("changed_key", "0");
+    guard->setKeyValue("erased_key", "0");
+
+    TestEntityObserver observer;
+    guard->attachObserver(&observer);
+    observer.reset();
+
+    TestKeyObserver keyObserver;
+    auto keyValue = findKeyValue(guard, "changed_key");
+    ASSERT_TRUE(keyValue != nullptr);
+    keyValue->attach(keyObserver);
+    keyObserver.reset();
+
+    {
+        EntityBatchUpdate batch(*guard);
+
+        for (int i = 1; i <= 10; ++i)
+        {
+            guard->setKeyValue("changed_key", std::to_string(i));
+            guard->setKeyValue("inserted_key", std::to_string(i));
+        }
+
+        guard->setKeyValue("erased_key", "");
+        guard->setKeyValue("temporary_key", "1");
+        guard->setKeyValue("temporary_key", "");
+
+        // Nested batches are sending their notifications with the outermost one
+        {
+            EntityBatchUpdate nestedBatch(*guard);
+            guard->setKeyValue("changed_key", "final");
+        }
+
+        EXPECT_TRUE(observer.insertStack.empty()) << "No notifications during the batch";
+        EXPECT_TRUE(observer.changeStack.empty()) << "No notifications during the batch";
+        EXPECT_TRUE(observer.eraseStack.empty()) << "No notifications during the batch";
+        EXPECT_FALSE(keyObserver.hasBeenInvoked()) << "No notifications during the batch";
+
+        // The values are accessible right away
+        EXPECT_EQ(guard->getKeyValue("changed_key"), "final");
+        EXPECT_EQ(guard->getKeyValue("erased_key"), "");
+    }
+
+    // One notification per key, carrying the final value
+    EXPECT_EQ(observer.changeStack, (std::vector<std::pair<std::string, std::string>>{ { "changed_key", "final" } }));
+    EXPECT_EQ(observer.insertStack, (std::vector<std::pair<std::string, std::string>>{ { "inserted_key", "10" } }));
+    EXPECT_EQ(observer.eraseStack, (std::vector<std::pair<std::string, std::string>>{ { "erased_key", "0" } }));
+    EXPECT_EQ(keyObserver.invocationCount, 1);
+    EXPECT_EQ(keyObserver.receivedValue, "final");
+
+    // Without a batch, every change is notified again
+    observer.reset();
+    guard->setKeyValue("changed_key", "1");
+    guard->setKeyValue("changed_key", "2");
+    EXPECT_EQ(observer.changeStack.size(), 2);
+
+    keyValue->detach(keyObserver);
+    guard->detachObserver(&observer);
+}
+
+TEST_F(EntityTest, BatchUpdateModelChange)
+{
+    auto torch = TestEntity::create("func_static");
+    torch.args().setKeyValue("model", "models/torch.lwo");
+
+    {
+        EntityBatchUpdate batch(torch.args());
+        torch.args().setKeyValue("model", "models/moss_patch.ase");
+        torch.args().setKeyValue("model", "models/torch.lwo");
+        torch.args().setKeyValue("origin", "64 0 0");
+    }
+
+    // The final model and origin have been applied
+    auto model = algorithm::findChildModel(torch.node);
+    ASSERT_TRUE(model);
+    EXPECT_EQ(model->getIModel().getModelPath(), "models/torch.lwo");
+    EXPECT_EQ(torch.node->localToWorld(), Matrix4::getTranslation(Vector3(64, 0, 0)));
+}
+
 TEST_F(EntityTest, EntityNodeObserveKeyViaFunc)
 {
     auto [entityNode, _] = TestEntity::create("atdm:ai_builder_guard");
@@ -390,6 +390,85 @@ TEST_F(EntityClassTest, OverrideEClassColourRemoval)
     EXPECT_EQ(torchCls->getColour(), GREEN); // inherited
 }
 
+// Colour overrides should only emit the colour signal, and only if the colour is different
+TEST_F(EntityClassTest, OverrideEClassColourEmitsColourSignal)
+{
+    auto lightCls = algorithm::createEntityByClassName("light")->getEntity().getEntityClass();
+    auto torchCls = algorithm::createEntityByClassName("light_torchflame_small")->getEntity().getEntityClass();
+
+    std::size_t changedCount = 0;
+    std::size_t lightColourChangedCount = 0;
+    std::size_t torchColourChangedCount = 0;
+
+    lightCls->changedSignal().connect([&] { ++changedCount; });
+    torchCls->changedSignal().connect([&] { ++changedCount; });
+    lightCls->colourChangedSignal().connect([&] { ++lightColourChangedCount; });
+    torchCls->colourChangedSignal().connect([&] { ++torchColourChangedCount; });
+
+    GlobalEclassColourManager().addOverrideColour("light", YELLOW);
+
+    EXPECT_EQ(lightColourChangedCount, 1) << "Colour signal should have fired once";
+    EXPECT_EQ(torchColourChangedCount, 1) << "Colour signal of the subclass should have fired once";
+
+    // Setting the same override again doesn't change anything
+    GlobalEclassColourManager().addOverrideColour("light", YELLOW);
+
+    EXPECT_EQ(lightColourChangedCount, 1) << "Unchanged override should not emit the colour signal";
+    EXPECT_EQ(torchColourChangedCount, 1) << "Unchanged override should not emit the colour signal";
+
+    GlobalEclassColourManager().removeOverrideColour("light");
+
+    EXPECT_EQ(lightColourChangedCount, 2) << "Colour signal should have fired after removing the override";
+    EXPECT_EQ(torchColourChangedCount, 2) << "Colour signal should have fired after removing the override";
+    EXPECT_EQ(changedCount, 0) << "Colour changes should not emit the changed signal";
+}
+
+TEST_F(EntityClassTest, ClearOverrideColours)
+{
+    auto lightCls = algorithm::createEntityByClassName("light")->getEntity().getEntityClass();
+    auto speakerCls = algorithm::createEntityByClassName("speaker")->getEntity().getEntityClass();
+    auto originalSpeakerColour = speakerCls->getColour();
+
+    GlobalEclassColourManager().addOverrideColour("light", YELLOW);
+    GlobalEclassColourManager().addOverrideColour("speaker", YELLOW);
+
+    EXPECT_EQ(lightCls->getColour(), YELLOW) << "Eclass colour override not working";
+    EXPECT_EQ(speakerCls->getColour(), YELLOW) << "Eclass colour override not working";
+
+    GlobalEclassColourManager().clearOverrideColours();
+
+    // All overrides should be gone
+    EXPECT_EQ(lightCls->getColour(), GREEN);
+    EXPECT_EQ(speakerCls->getColour(), originalSpeakerColour);
+
+    std::size_t overrideCount = 0;
+    GlobalEclassColourManager().foreachOverrideColour([&](const std::string&, const Vector4&) { ++overrideCount; });
+    EXPECT_EQ(overrideCount, 0) << "No overrides should be left";
+}
+
+// Entities of the same class share their colour shaders
+TEST_F(EntityClassTest, EntitiesShareClassColourShaders)
+{
+    auto renderSystem = GlobalRenderSystemFactory().createRenderSystem();
+    auto cls = GlobalEntityClassManager().findClass("light");
+
+    auto first = GlobalEntityModule().createEntity(cls);
+    auto second = GlobalEntityModule().createEntity(cls);
+    first->setRenderSystem(renderSystem);
+    second->setRenderSystem(renderSystem);
+
+    ASSERT_TRUE(first->getWireShader());
+    EXPECT_EQ(first->getWireShader(), second->getWireShader());
+    EXPECT_EQ(first->getColourShader(), second->getColourShader());
+
+    auto originalShader = first->getWireShader();
+    cls->setColour(Vector3(0.5, 0.24, 0.87));
+
+    // Both entities should have picked up the new shader
+    EXPECT_NE(first->getWireShader(), originalShader);
+    EXPECT_EQ(first->getWireShader(), second->getWireShader());
+}
+
 TEST_F(EntityClassTest, DefaultEclassColourIsValid)
 {
     auto eclass = GlobalEntityClassManager().findClass("dr:entity_using_modeldef");
@@ -500,6 +579,74 @@ entityDef changingVisibility
     EXPECT_EQ(eclass->getVisibility(), vfs::Visibility::NORMAL) << "Should be visible now";
 }
 
+TEST_F(EntityClassTest, InheritedAttributesAreUpdatedAfterReloadDecls)
+{
+    TemporaryFile tempFile(_context.getTestProjectPath() + "def/temporary_file.def");
+
+    tempFile.setContents(R"(
+entityDef temp_base
+{
+    "base_key" "base_value"
+    "overridden_key" "base_value"
+}
+entityDef temp_middle
+{
+    "inherit" "temp_base"
+}
+entityDef temp_child
+{
+    "inherit" "temp_middle"
+    "Overridden_Key" "child_value"
+}
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    auto child = GlobalEntityClassManager().findClass("temp_child");
+    ASSERT_TRUE(child) << "Cannot find temp_child";
+
+    EXPECT_EQ(child->getAttributeValue("base_key"), "base_value");
+    EXPECT_EQ(child->getAttributeValue("BASE_KEY"), "base_value") << "Inherited lookup should ignore case";
+    EXPECT_EQ(child->getAttributeValue("overridden_key"), "child_value");
+    EXPECT_EQ(child->getAttributeValue("middle_key"), "");
+
+    // Change the base class and add a key to the middle class, the child file stays the same
+    tempFile.setContents(R"(
+entityDef temp_base
+{
+    "base_key" "changed_value"
+    "overridden_key" "base_value"
+}
+entityDef temp_middle
+{
+    "inherit" "temp_base"
+    "middle_key" "middle_value"
+}
+entityDef temp_child
+{
+    "inherit" "temp_middle"
+    "Overridden_Key" "child_value"
+}
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(child->getAttributeValue("base_key"), "changed_value");
+    EXPECT_EQ(child->getAttributeValue("middle_key"), "middle_value");
+    EXPECT_EQ(child->getAttributeValue("overridden_key"), "child_value");
+
+    std::map<std::string, bool> attributes;
+    child->forEachAttribute([&](const EntityClassAttribute& a, bool inherited)
+    {
+        attributes.emplace(a.getName(), inherited);
+    }, true);
+
+    EXPECT_EQ(attributes.count("overridden_key"), 0) << "Overridden key should be visited only once";
+    EXPECT_EQ(attributes.at("Overridden_Key"), false);
+    EXPECT_EQ(attributes.at("middle_key"), true);
+    EXPECT_EQ(attributes.at("base_key"), true);
+}
+
 TEST_F(EntityClassTest, GetAttributeValue)
 {
     auto eclass = GlobalEntityClassManager().findClass("attribute_type_test");
@@ -934,4 +934,52 @@ TEST_F(EntityInspectorTest, MoveFuncStaticAndWorldPrimitives)
     EXPECT_EQ(keyValueStore.store.size(), 1) << "Only classname should show up after selection";
 }
 
+// A large selection of entities sharing most of their values, one of them is different
+TEST_F(EntityInspectorTest, SelectManyEntitiesWithOneDifferingValue)
+{
+    KeyValueStore keyValueStore;
+
+    std::vector<IEntityNodePtr> entities;
+
+    for (int i = 0; i < 500; ++i)
+    {
+        auto entity = algorithm::createEntityByClassName("func_static");
+        scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+        entity->getEntity().setKeyValue("name", "static_" + std::to_string(i));
+        entity->getEntity().setKeyValue("shared", i == 250 ? "odd" : "common");
+
+        Node_setSelected(entity, true);
+        entities.push_back(entity);
+    }
+
+    keyValueStore.rescanSelection();
+
+    EXPECT_EQ(keyValueStore.getNumSelectedEntities(), 500);
+    expectUnique(keyValueStore, "classname", "func_static");
+    expectNonUnique(keyValueStore, "name");
+    expectNonUnique(keyValueStore, "shared");
+
+    // Assimilating the odd value makes the key unique
+    entities[250]->getEntity().setKeyValue("shared", "common");
+    expectUnique(keyValueStore, "shared", "common");
+
+    entities[250]->getEntity().setKeyValue("shared", "odd");
+    expectNonUnique(keyValueStore, "shared");
+
+    // Deselecting the odd entity should have the same effect
+    Node_setSelected(entities[250], false);
+    keyValueStore.rescanSelection();
+
+    expectUnique(keyValueStore, "shared", "common");
+    expectNonUnique(keyValueStore, "name");
+
+    // Removing the key from one of the remaining entities hides it
+    entities[10]->getEntity().setKeyValue("shared", "");
+    expectNotListed(keyValueStore, "shared");
+
+    entities[10]->getEntity().setKeyValue("shared", "common");
+    expectUnique(keyValueStore, "shared", "common");
+}
+
 }
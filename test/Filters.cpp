@@ -1,9 +1,12 @@
 #include "RadiantTest.h"
 
 #include "ifilter.h"
+#include "ieclass.h"
+#include "ientity.h"
 #include "scene/Node.h"
 #include "imap.h"
 #include "scenelib.h"
+#include "algorithm/Primitives.h"
 
 namespace test
 {
@@ -50,4 +53,145 @@ TEST_F(FilterTest, OnFiltersChangedInvoked)
     EXPECT_EQ(testNode->onFiltersChangedInvocationCount, 1) << "Node should have been notified";
 }
 
+TEST_F(FilterTest, ToggledFilterChangesVisibility)
+{
+    const std::string caulk = "textures/common/caulk";
+
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, caulk));
+
+    // Toggle the filter a few times, the results must not be stale
+    for (int i = 0; i < 3; ++i)
+    {
+        GlobalFilterSystem().setFilterState("Caulk", true);
+        EXPECT_FALSE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, caulk)) << "Caulk should be hidden";
+        EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, "textures/common/nodraw"));
+
+        GlobalFilterSystem().setFilterState("Caulk", false);
+        EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, caulk)) << "Caulk should be visible again";
+    }
+
+    // Texture and entity class rules with the same name are separate
+    GlobalFilterSystem().setFilterState("Caulk", true);
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_ENTITYCLASS, caulk));
+}
+
+TEST_F(FilterTest, EntityClassVisibility)
+{
+    auto light = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("light"));
+    auto& entity = *Node_getEntity(light);
+
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, entity));
+
+    GlobalFilterSystem().setFilterState("Lights", true);
+    EXPECT_FALSE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, entity)) << "Light should be hidden";
+
+    GlobalFilterSystem().setFilterState("Lights", false);
+    EXPECT_TRUE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, entity));
+
+    // The "All entities" filter is showing worldspawn
+    GlobalFilterSystem().setFilterState("All entities", true);
+    EXPECT_FALSE(GlobalFilterSystem().isEntityVisible(FilterRule::TYPE_ENTITYCLASS, entity));
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_ENTITYCLASS, "worldspawn"));
+}
+
+TEST_F(FilterTest, ChangedRulesAreApplied)
+{
+    const std::string material = "textures/numbers/1";
+
+    FilterRules rules{ FilterRule::Create(FilterRule::TYPE_TEXTURE, "textures/numbers/.*", false) };
+    EXPECT_TRUE(GlobalFilterSystem().addFilter("Numbers", rules));
+
+    GlobalFilterSystem().setFilterState("Numbers", true);
+    EXPECT_FALSE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, material)) << "Numbers should be hidden";
+
+    // Renaming the filter shouldn't affect the active filters
+    EXPECT_TRUE(GlobalFilterSystem().renameFilter("Numbers", "A Numbers Filter"));
+    EXPECT_TRUE(GlobalFilterSystem().getFilterState("A Numbers Filter"));
+    EXPECT_FALSE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, material));
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, "textures/common/caulk"));
+
+    rules.push_back(FilterRule::Create(FilterRule::TYPE_TEXTURE, material, true));
+    EXPECT_TRUE(GlobalFilterSystem().setFilterRules("A Numbers Filter", rules));
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, material)) << "The new rule should show the material";
+    EXPECT_FALSE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, "textures/numbers/2"));
+
+    EXPECT_TRUE(GlobalFilterSystem().removeFilter("A Numbers Filter"));
+    EXPECT_TRUE(GlobalFilterSystem().isVisible(FilterRule::TYPE_TEXTURE, "textures/numbers/2"));
+}
+
+TEST_F(FilterTest, InsertedNodesAreFiltered)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    GlobalFilterSystem().setFilterState("Caulk", true);
+
+    auto caulkBrush = algorithm::createCubicBrush(worldspawn, { 0, 0, 0 }, "textures/common/caulk");
+    auto visibleBrush = algorithm::createCubicBrush(worldspawn, { 128, 0, 0 }, "textures/numbers/1");
+
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_TRUE(caulkBrush->isFiltered()) << "The inserted caulk brush should be filtered";
+    EXPECT_FALSE(visibleBrush->isFiltered()) << "The other brush should be visible";
+}
+
+TEST_F(FilterTest, ChangedMaterialIsFiltered)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    GlobalFilterSystem().setFilterState("Caulk", true);
+
+    auto brush = algorithm::createCubicBrush(worldspawn, { 0, 0, 0 }, "textures/numbers/1");
+    auto patch = algorithm::createPatchFromBounds(worldspawn, AABB({ 0, 0, 0 }, { 64, 64, 64 }), "textures/numbers/1");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_FALSE(brush->isFiltered());
+    EXPECT_FALSE(patch->isFiltered());
+
+    Node_getIBrush(brush)->setShader("textures/common/caulk");
+    Node_getIPatch(patch)->setShader("textures/common/caulk");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_TRUE(brush->isFiltered()) << "The brush should be filtered after the material change";
+    EXPECT_TRUE(patch->isFiltered()) << "The patch should be filtered after the material change";
+
+    Node_getIBrush(brush)->setShader("textures/numbers/1");
+    Node_getIPatch(patch)->setShader("textures/numbers/1");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_FALSE(brush->isFiltered()) << "The brush should be visible again";
+    EXPECT_FALSE(patch->isFiltered()) << "The patch should be visible again";
+}
+
+TEST_F(FilterTest, ChangedSpawnargsAreFiltered)
+{
+    FilterRules rules{ FilterRule::CreateEntityKeyValueRule("hideme", "1", false) };
+    GlobalFilterSystem().addFilter("Hidden entities", rules);
+    GlobalFilterSystem().setFilterState("Hidden entities", true);
+
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+    auto brush = algorithm::createCubicBrush(entity, { 0, 0, 0 }, "textures/numbers/1");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_FALSE(entity->isFiltered());
+    EXPECT_FALSE(brush->isFiltered());
+
+    Node_getEntity(entity)->setKeyValue("hideme", "1");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_TRUE(entity->isFiltered()) << "The entity should be filtered after the spawnarg change";
+    EXPECT_TRUE(brush->isFiltered()) << "The child brush should be hidden along with the entity";
+
+    // A brush added to the hidden entity is hidden too
+    auto secondBrush = algorithm::createCubicBrush(entity, { 128, 0, 0 }, "textures/numbers/1");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_TRUE(secondBrush->isFiltered()) << "The new child brush should be hidden";
+
+    Node_getEntity(entity)->setKeyValue("hideme", "");
+    GlobalFilterSystem().processQueuedUpdates();
+
+    EXPECT_FALSE(entity->isFiltered()) << "The entity should be visible again";
+    EXPECT_FALSE(brush->isFiltered());
+    EXPECT_FALSE(secondBrush->isFiltered());
+}
+
 }
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 
+#include <cstring>
 #include <limits>
 #include <numeric>
 #include <random>
@@ -65,6 +66,152 @@ inline void verifyAllAllocations(render::IGeometryStore& store, const std::vecto
     }
 }
 
+// Runs a series of random operations on the given store, verifying the data at every frame
+void performRandomFrameOperations(render::GeometryStore& store)
+{
+    store.onFrameStart();
+
+    std::vector<Allocation> allocations;
+
+    // Allocate 10 slots of various sizes, store some data in there
+    for (auto i = 0; i < 10; ++i)
+    {
+        auto vertices = generateVertices(i, (i + 5) * 20);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        EXPECT_NE(slot, std::numeric_limits<render::IGeometryStore::Slot>::max()) << "Invalid slot";
+
+        // Uploading the data should succeed
+        EXPECT_NO_THROW(store.updateData(slot, vertices, indices));
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    // Verify all
+    verifyAllAllocations(store, allocations);
+    store.onFrameFinished();
+
+    // Begin a new frame, the data in the new buffer should be up to date
+    store.onFrameStart();
+    verifyAllAllocations(store, allocations);
+    store.onFrameFinished();
+
+    auto dataUpdates = 0;
+    auto subDataUpdates = 0;
+    auto dataResizes = 0;
+    auto allocationCount = 0;
+    auto deallocationCount = 0;
+
+    std::minstd_rand rand(17); // fixed seed
+
+    // Run a few updates
+    for (auto frame = 0; frame < 100; ++frame)
+    {
+        store.onFrameStart();
+
+        // Verify all allocations at the start of every frame
+        verifyAllAllocations(store, allocations);
+
+        // Do something random with every allocation
+        for (auto a = 0; a < allocations.size(); ++a)
+        {
+            auto& allocation = allocations[a];
+
+            // Perform a random action
+            switch (rand() % 7)
+            {
+            case 1: // updateSubData
+            {
+                subDataUpdates++;
+
+                // Update 50% of the data
+                auto newVertices = generateVertices(rand() % 9, allocation.vertices.size() >> 2);
+                auto newIndices = generateIndices(newVertices);
+
+                // Overwrite some of the data
+                std::copy(newVertices.begin(), newVertices.end(), allocation.vertices.begin());
+                std::copy(newIndices.begin(), newIndices.end(), allocation.indices.begin());
+
+                store.updateSubData(allocation.slot, 0, newVertices, 0, newIndices);
+                break;
+            }
+
+            case 2: // updateData
+            {
+                dataUpdates++;
+
+                allocation.vertices = generateVertices(rand() % 9, allocation.vertices.size());
+                allocation.indices = generateIndices(allocation.vertices);
+                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
+                break;
+            }
+
+            case 3: // resize
+            {
+                dataResizes++;
+
+                // Don't touch vertices below a minimum size
+                if (allocation.vertices.size() < 10) break;
+
+                // Allow 10% shrinking of the data
+                auto newSize = allocation.vertices.size() - (rand() % (allocation.vertices.size() / 10));
+
+                allocation.vertices.resize(newSize);
+                allocation.indices = generateIndices(allocation.vertices);
+
+                store.resizeData(allocation.slot, allocation.vertices.size(), allocation.indices.size());
+
+                // after resize, we have to update the data too, unfortunately, otherwise the indices are out of bounds
+                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
+                break;
+            }
+
+            case 4: // allocations
+            {
+                allocationCount++;
+
+                auto vertices = generateVertices(rand() % 9, rand() % 100);
+                auto indices = generateIndices(vertices);
+
+                auto slot = store.allocateSlot(vertices.size(), indices.size());
+                EXPECT_NE(slot, std::numeric_limits<render::IGeometryStore::Slot>::max()) << "Invalid slot";
+
+                EXPECT_NO_THROW(store.updateData(slot, vertices, indices));
+                allocations.emplace_back(Allocation{ slot, vertices, indices });
+                break;
+            }
+
+            case 5: // dellocation
+            {
+                deallocationCount++;
+
+                store.deallocateSlot(allocations[a].slot);
+                allocations.erase(allocations.begin() + a);
+                // We're going to skip one loop iteration, but that's not very important
+                break;
+            }
+            } // switch
+        }
+
+        // Verify all allocations at the end of every frame
+        verifyAllAllocations(store, allocations);
+
+        store.onFrameFinished();
+    }
+
+    // One final check
+    store.onFrameStart();
+    verifyAllAllocations(store, allocations);
+    store.onFrameFinished();
+
+    EXPECT_GT(dataUpdates, 0) << "No data update operations performed";
+    EXPECT_GT(subDataUpdates, 0) << "No sub data update operations performed";
+    EXPECT_GT(dataResizes, 0) << "No resize operations performed";
+    EXPECT_GT(allocationCount, 0) << "No allocation operations performed";
+    EXPECT_GT(deallocationCount, 0) << "No deallocation operations performed";
+}
+
 }
 
 TEST(GeometryStore, AllocateAndDeallocate)
@@ -207,6 +354,40 @@ TEST(GeometryStore, UpdateSubData)
     }
 }
 
+TEST(GeometryStore, UpdateVertexSubData)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider,
+        render::GeometryStore::MultiBufferedFrameCount);
+
+    auto vertices = generateVertices(3, 17 * 20);
+    auto indices = generateIndices(vertices);
+
+    store.onFrameStart();
+    auto slot = store.allocateSlot(vertices.size(), indices.size());
+    store.updateData(slot, vertices, indices);
+    store.onFrameFinished();
+
+    // Replace a range in the middle of the vertices, the indices stay the same
+    auto changedVertices = generateVertices(5, 40);
+    std::copy(changedVertices.begin(), changedVertices.end(), vertices.begin() + 100);
+
+    store.onFrameStart();
+    EXPECT_NO_THROW(store.updateVertexSubData(slot, 100, changedVertices));
+    verifyAllocation(store, slot, vertices, indices);
+    store.onFrameFinished();
+
+    // The change has to propagate to all other frame buffers
+    for (auto frame = 0; frame < render::GeometryStore::MultiBufferedFrameCount * 2; ++frame)
+    {
+        store.onFrameStart();
+        verifyAllocation(store, slot, vertices, indices);
+        store.onFrameFinished();
+    }
+
+    // Out of bounds updates are rejected
+    EXPECT_THROW(store.updateVertexSubData(slot, vertices.size() - 10, changedVertices), std::logic_error);
+}
+
 TEST(GeometryStore, ResizeData)
 {
     render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
@@ -255,147 +436,233 @@ TEST(GeometryStore, FrameBufferSwitching)
 {
     render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
 
-    store.onFrameStart();
+    performRandomFrameOperations(store);
+}
+
+TEST(GeometryStore, MultiBufferedFrameSwitching)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider,
+        render::GeometryStore::MultiBufferedFrameCount);
+
+    EXPECT_EQ(store.getNumFrameBuffers(), render::GeometryStore::MultiBufferedFrameCount);
+
+    performRandomFrameOperations(store);
+}
+
+TEST(GeometryStore, ChangeNumberOfFrameBuffers)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
 
     std::vector<Allocation> allocations;
 
-    // Allocate 10 slots of various sizes, store some data in there
+    store.onFrameStart();
+
     for (auto i = 0; i < 10; ++i)
     {
         auto vertices = generateVertices(i, (i + 5) * 20);
         auto indices = generateIndices(vertices);
 
         auto slot = store.allocateSlot(vertices.size(), indices.size());
-        EXPECT_NE(slot, std::numeric_limits<render::IGeometryStore::Slot>::max()) << "Invalid slot";
-
-        // Uploading the data should succeed
-        EXPECT_NO_THROW(store.updateData(slot, vertices, indices));
+        store.updateData(slot, vertices, indices);
 
         allocations.emplace_back(Allocation{ slot, vertices, indices });
     }
 
-    // Verify all
-    verifyAllAllocations(store, allocations);
     store.onFrameFinished();
 
-    // Begin a new frame, the data in the new buffer should be up to date
+    // Switch to multi-buffering, all data should be preserved in every buffer
+    store.setNumFrameBuffers(render::GeometryStore::MultiBufferedFrameCount);
+    EXPECT_EQ(store.getNumFrameBuffers(), render::GeometryStore::MultiBufferedFrameCount);
+
+    for (auto frame = 0; frame < render::GeometryStore::MultiBufferedFrameCount * 2; ++frame)
+    {
+        store.onFrameStart();
+        verifyAllAllocations(store, allocations);
+
+        // Syncing should upload the full buffer to the new buffer objects
+        store.syncToBufferObjects();
+        auto [vertexBuffer, indexBuffer] = store.getBufferObjects();
+        EXPECT_FALSE(std::static_pointer_cast<TestBufferObject>(vertexBuffer)->buffer.empty());
+        EXPECT_FALSE(std::static_pointer_cast<TestBufferObject>(indexBuffer)->buffer.empty());
+
+        store.onFrameFinished();
+    }
+
+    // Modify a slot in one frame, the change has to propagate to all other buffers
     store.onFrameStart();
-    verifyAllAllocations(store, allocations);
+    allocations.front().vertices = generateVertices(7, allocations.front().vertices.size());
+    allocations.front().indices = generateIndices(allocations.front().vertices);
+    store.updateData(allocations.front().slot, allocations.front().vertices, allocations.front().indices);
     store.onFrameFinished();
 
-    auto dataUpdates = 0;
-    auto subDataUpdates = 0;
-    auto dataResizes = 0;
-    auto allocationCount = 0;
-    auto deallocationCount = 0;
-
-    std::minstd_rand rand(17); // fixed seed
+    // Going back to single buffering keeps the data too
+    store.setNumFrameBuffers(1);
 
-    // Run a few updates
-    for (auto frame = 0; frame < 100; ++frame)
+    for (auto frame = 0; frame < 2; ++frame)
     {
         store.onFrameStart();
-
-        // Verify all allocations at the start of every frame
         verifyAllAllocations(store, allocations);
+        store.onFrameFinished();
+    }
 
-        // Do something random with every allocation
-        for (auto a = 0; a < allocations.size(); ++a)
-        {
-            auto& allocation = allocations[a];
+    EXPECT_THROW(store.setNumFrameBuffers(0), std::invalid_argument);
+}
 
-            // Perform a random action
-            switch (rand() % 7)
-            {
-            case 1: // updateSubData
-            {
-                subDataUpdates++;
+namespace
+{
 
-                // Update 50% of the data
-                auto newVertices = generateVertices(rand() % 9, allocation.vertices.size() >> 2);
-                auto newIndices = generateIndices(newVertices);
+// Checks the vertex buffer object contents against the given allocation, assuming the packed format
+void verifyPackedBufferObject(render::GeometryStore& store, const Allocation& allocation)
+{
+    auto [vertexBuffer, _] = store.getBufferObjects();
+    const auto& buffer = std::static_pointer_cast<TestBufferObject>(vertexBuffer)->buffer;
 
-                // Overwrite some of the data
-                std::copy(newVertices.begin(), newVertices.end(), allocation.vertices.begin());
-                std::copy(newIndices.begin(), newIndices.end(), allocation.indices.begin());
+    auto firstVertex = store.getBufferAddresses(allocation.slot).firstVertex;
+    auto attributesOffset = store.getPackedAttributesOffset();
 
-                store.updateSubData(allocation.slot, 0, newVertices, 0, newIndices);
-                break;
-            }
+    for (std::size_t i = 0; i < allocation.vertices.size(); ++i)
+    {
+        const auto& expected = allocation.vertices[i];
 
-            case 2: // updateData
-            {
-                dataUpdates++;
+        Vector3f position;
+        std::memcpy(&position, buffer.data() + (firstVertex + i) * sizeof(Vector3f), sizeof(Vector3f));
+        EXPECT_EQ(position, expected.vertex) << "Position mismatch";
 
-                allocation.vertices = generateVertices(rand() % 9, allocation.vertices.size());
-                allocation.indices = generateIndices(allocation.vertices);
-                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
-                break;
-            }
+        render::PackedVertexAttributes attributes;
+        std::memcpy(&attributes, buffer.data() + attributesOffset + (firstVertex + i) * sizeof(attributes), sizeof(attributes));
 
-            case 3: // resize
-            {
-                dataResizes++;
+        EXPECT_EQ(attributes.texcoord, expected.texcoord) << "Texcoord mismatch";
+        EXPECT_TRUE(math::isNear(render::PackedVertexAttributes::UnpackSignedNormalised(attributes.normal), expected.normal, 0.01)) << "Normal mismatch";
+        EXPECT_TRUE(math::isNear(render::PackedVertexAttributes::UnpackSignedNormalised(attributes.tangent), expected.tangent, 0.01)) << "Tangent mismatch";
+        EXPECT_NEAR(attributes.colour[0] / 255.0, expected.colour.x(), 0.01) << "Colour mismatch";
+        EXPECT_NEAR(attributes.colour[3] / 255.0, expected.colour.w(), 0.01) << "Colour mismatch";
+    }
+}
 
-                // Don't touch vertices below a minimum size
-                if (allocation.vertices.size() < 10) break;
+std::vector<render::RenderVertex> generateNormalisedVertices(int id, std::size_t size)
+{
+    auto vertices = generateVertices(id, size);
 
-                // Allow 10% shrinking of the data
-                auto newSize = allocation.vertices.size() - (rand() % (allocation.vertices.size() / 10));
+    for (auto& vertex : vertices)
+    {
+        vertex.normal = Vector3f(vertex.vertex.x(), -vertex.vertex.y(), 1).getNormalised();
+        vertex.tangent = Vector3f(1, vertex.vertex.z(), 0).getNormalised();
+        vertex.colour = Vector4f(0.25f, 0.5f, 0.75f, 1.0f);
+    }
 
-                allocation.vertices.resize(newSize);
-                allocation.indices = generateIndices(allocation.vertices);
+    return vertices;
+}
 
-                store.resizeData(allocation.slot, allocation.vertices.size(), allocation.indices.size());
+}
 
-                // after resize, we have to update the data too, unfortunately, otherwise the indices are out of bounds
-                store.updateData(allocation.slot, allocation.vertices, allocation.indices);
-                break;
-            }
+TEST(GeometryStore, PackedVertexFormat)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider);
+    EXPECT_EQ(store.getVertexFormat(), render::IGeometryStore::VertexFormat::Interleaved);
 
-            case 4: // allocations
-            {
-                allocationCount++;
+    std::vector<Allocation> allocations;
 
-                auto vertices = generateVertices(rand() % 9, rand() % 100);
-                auto indices = generateIndices(vertices);
+    store.onFrameStart();
 
-                auto slot = store.allocateSlot(vertices.size(), indices.size());
-                EXPECT_NE(slot, std::numeric_limits<render::IGeometryStore::Slot>::max()) << "Invalid slot";
+    for (auto i = 0; i < 10; ++i)
+    {
+        auto vertices = generateNormalisedVertices(i, (i + 5) * 20);
+        auto indices = generateIndices(vertices);
 
-                EXPECT_NO_THROW(store.updateData(slot, vertices, indices));
-                allocations.emplace_back(Allocation{ slot, vertices, indices });
-                break;
-            }
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
 
-            case 5: // dellocation
-            {
-                deallocationCount++;
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
 
-                store.deallocateSlot(allocations[a].slot);
-                allocations.erase(allocations.begin() + a);
-                // We're going to skip one loop iteration, but that's not very important
-                break;
-            }
-            } // switch
-        }
+    store.syncToBufferObjects();
+    store.onFrameFinished();
 
-        // Verify all allocations at the end of every frame
-        verifyAllAllocations(store, allocations);
+    // Switching the format re-uploads everything in two streams
+    store.setVertexFormat(render::IGeometryStore::VertexFormat::Packed);
+    EXPECT_EQ(store.getVertexFormat(), render::IGeometryStore::VertexFormat::Packed);
 
-        store.onFrameFinished();
+    store.onFrameStart();
+    store.syncToBufferObjects();
+
+    auto [vertexBuffer, _] = store.getBufferObjects();
+    auto& buffer = std::static_pointer_cast<TestBufferObject>(vertexBuffer)->buffer;
+    auto numBufferVertices = store.getPackedAttributesOffset() / sizeof(Vector3f);
+
+    EXPECT_EQ(buffer.size(), numBufferVertices * render::GeometryStore::PackedVertexSize);
+
+    for (const auto& allocation : allocations)
+    {
+        verifyPackedBufferObject(store, allocation);
     }
 
-    // One final check
+    store.onFrameFinished();
+
+    // Modifications are converted when syncing
     store.onFrameStart();
+    auto& modified = allocations.at(3);
+    modified.vertices = generateNormalisedVertices(17, modified.vertices.size());
+    store.updateVertexSubData(modified.slot, 0, modified.vertices);
+    store.syncToBufferObjects();
+
+    verifyPackedBufferObject(store, modified);
+
+    // The client-side data is unaffected by the packing
     verifyAllAllocations(store, allocations);
     store.onFrameFinished();
+}
 
-    EXPECT_GT(dataUpdates, 0) << "No data update operations performed";
-    EXPECT_GT(subDataUpdates, 0) << "No sub data update operations performed";
-    EXPECT_GT(dataResizes, 0) << "No resize operations performed";
-    EXPECT_GT(allocationCount, 0) << "No allocation operations performed";
-    EXPECT_GT(deallocationCount, 0) << "No deallocation operations performed";
+TEST(GeometryStore, CompactionClosesGaps)
+{
+    render::GeometryStore store(TestSyncObjectProvider::Instance(), _testBufferObjectProvider,
+        render::GeometryStore::MultiBufferedFrameCount);
+
+    std::vector<Allocation> allocations;
+
+    store.onFrameStart();
+
+    for (auto i = 0; i < 64; ++i)
+    {
+        auto vertices = generateVertices(i, 1000);
+        auto indices = generateIndices(vertices);
+
+        auto slot = store.allocateSlot(vertices.size(), indices.size());
+        store.updateData(slot, vertices, indices);
+
+        allocations.emplace_back(Allocation{ slot, vertices, indices });
+    }
+
+    store.onFrameFinished();
+
+    // Release every other slot, this leaves half of the used space in gaps
+    store.onFrameStart();
+
+    for (auto i = 0; i < allocations.size(); ++i)
+    {
+        store.deallocateSlot(allocations[i].slot);
+        allocations.erase(allocations.begin() + i);
+    }
+
+    store.onFrameFinished();
+
+    // The slots are moved over the next frames, the data must stay intact in every buffer
+    for (auto frame = 0; frame < 20; ++frame)
+    {
+        store.onFrameStart();
+        verifyAllAllocations(store, allocations);
+        store.onFrameFinished();
+    }
+
+    // All remaining vertices should be located at the start of the buffer now
+    std::size_t highestVertex = 0;
+
+    for (const auto& allocation : allocations)
+    {
+        auto renderParms = store.getBufferAddresses(allocation.slot);
+        highestVertex = std::max(highestVertex, renderParms.firstVertex + allocation.vertices.size());
+    }
+
+    EXPECT_EQ(highestVertex, allocations.size() * 1000) << "Vertex slots have not been compacted";
 }
 
 TEST(GeometryStore, SyncObjectAcquisition)
@@ -2,6 +2,7 @@
 
 #include "iimage.h"
 #include "RGBAImage.h"
+#include <cstring>
 
 // Helpers for examining pixel data
 using RGB8 = BasicVector3<uint8_t>;
@@ -239,4 +240,58 @@ TEST_F(ImageLoadingTest, LoadDDSCompressedBC5MipMaps)
     EXPECT_EQ(img->getGLFormat(), GL_COMPRESSED_RG_RGTC2);
 }
 
+TEST_F(ImageLoadingTest, LoadTruncatedDDS)
+{
+    // The last mipmaps are cut off, the file must be rejected instead of reading past its end
+    auto img = loadImage("textures/dds/test_60x128_dxt5_mips_truncated.dds");
+    EXPECT_FALSE(img);
+}
+
+TEST_F(ImageLoadingTest, DDSMipMapsCanBeUploadedProgressively)
+{
+    auto img = loadImage("textures/dds/test_60x128_dxt5_mips.dds");
+    ASSERT_TRUE(img);
+
+    EXPECT_TRUE(std::dynamic_pointer_cast<ProgressiveBindableTexture>(img));
+}
+
+TEST_F(ImageLoadingTest, FindImageInVFS)
+{
+    // The extension is replaced by the ones configured in the .game file
+    EXPECT_EQ(GlobalImageLoader().findImageInVFS("textures/numbers/6"), "textures/numbers/6.tga");
+    EXPECT_EQ(GlobalImageLoader().findImageInVFS("textures/numbers/6.png"), "textures/numbers/6.tga");
+    EXPECT_EQ(GlobalImageLoader().findImageInVFS("textures/numbers/nonexistent"), "");
+}
+
+TEST_F(ImageLoadingTest, LoadImagesFromVFSInParallel)
+{
+    auto images = GlobalImageLoader().imagesFromVFS({
+        "textures/numbers/6", "textures/numbers/nonexistent", "textures/a_1024x512"
+    });
+
+    ASSERT_EQ(images.size(), 3);
+    EXPECT_FALSE(images[1]) << "Missing images should be returned as empty pointers";
+
+    ASSERT_TRUE(images[0]);
+    EXPECT_EQ(images[0]->getWidth(), 32);
+    EXPECT_EQ(images[0]->getHeight(), 32);
+
+    ASSERT_TRUE(images[2]);
+    EXPECT_EQ(images[2]->getWidth(), 1024);
+    EXPECT_EQ(images[2]->getHeight(), 512);
+
+    // The uncompressed TGA is stored bottom-up, check the orientation of the black "6"
+    Pixelator<image::RGBAPixel> pixels(*images[0]);
+    EXPECT_EQ(pixels(0, 0).red, 255);
+    EXPECT_EQ(pixels(13, 4).red, 0);
+    EXPECT_EQ(pixels(13, 4).alpha, 255);
+    EXPECT_EQ(pixels(8, 14).green, 0);
+    EXPECT_EQ(pixels(23, 14).blue, 255);
+
+    // The batch should produce the same pixels as loading the images one by one
+    auto single = GlobalImageLoader().imageFromVFS("textures/a_1024x512");
+    ASSERT_TRUE(single);
+    EXPECT_EQ(std::memcmp(single->getPixels(), images[2]->getPixels(), 1024 * 512 * 4), 0);
+}
+
 }
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "imap.h"
 #include "ilayer.h"
 #include "ifilter.h"
+#include "ieclass.h"
+#include "ientity.h"
 #include "scenelib.h"
 #include "algorithm/Primitives.h"
 #include "os/file.h"
@@ -469,6 +471,82 @@ TEST_F(LayerTest, SetLayerVisibilityWorksRecursively)
         "The parent layer visibility should have propagated down to the boards layer";
 }
 
+TEST_F(LayerTest, ParentStaysVisibleWithVisibleChild)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto entityLayerId = layerManager.createLayer("Entities");
+    auto brushLayerId = layerManager.createLayer("Brushes");
+
+    auto entity = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+    auto brush = algorithm::createCubicBrush(entity);
+    auto otherBrush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+
+    entity->moveToLayer(entityLayerId);
+    brush->moveToLayer(brushLayerId);
+    otherBrush->moveToLayer(brushLayerId);
+
+    layerManager.setLayerVisibility(entityLayerId, false);
+    EXPECT_TRUE(entity->visible()) << "Entity should stay visible since its child is visible";
+    EXPECT_TRUE(brush->visible());
+
+    layerManager.setLayerVisibility(brushLayerId, false);
+    EXPECT_FALSE(entity->visible()) << "Entity should be hidden along with its child";
+    EXPECT_FALSE(brush->visible());
+    EXPECT_FALSE(otherBrush->visible());
+    EXPECT_TRUE(GlobalMapModule().findOrInsertWorldspawn()->visible()) << "Worldspawn is in the visible default layer";
+
+    layerManager.setLayerVisibility(brushLayerId, true);
+    EXPECT_TRUE(entity->visible()) << "Entity should be visible again";
+    EXPECT_TRUE(brush->visible());
+    EXPECT_TRUE(otherBrush->visible());
+
+    layerManager.setLayerVisibility(entityLayerId, true);
+    EXPECT_TRUE(entity->visible());
+}
+
+TEST_F(LayerTest, DeletedLayerMembersAreVisible)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto layerId = layerManager.createLayer("TestLayer");
+
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+    brush->moveToLayer(layerId);
+
+    layerManager.setLayerVisibility(layerId, false);
+    EXPECT_FALSE(brush->visible()) << "Brush should be hidden";
+
+    layerManager.deleteLayer("TestLayer");
+
+    EXPECT_EQ(brush->getLayers(), scene::LayerList{ 0 }) << "Brush should have fallen back to the default layer";
+    EXPECT_TRUE(brush->visible()) << "Brush should be visible again";
+}
+
+TEST_F(LayerTest, HighLayerIds)
+{
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto layerId = layerManager.createLayer("HighLayer", 130);
+    EXPECT_EQ(layerId, 130);
+
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+    brush->moveToLayer(layerId);
+
+    EXPECT_TRUE(brush->getLayerMask().test(layerId));
+    EXPECT_FALSE(brush->getLayerMask().test(0)) << "The mask should follow the layer set";
+
+    layerManager.setLayerVisibility(layerId, false);
+    EXPECT_FALSE(layerManager.layerIsVisible(layerId));
+    EXPECT_FALSE(brush->visible()) << "Brush should be hidden";
+
+    brush->addToLayer(0);
+    EXPECT_TRUE(brush->getLayerMask().test(0));
+    layerManager.setLayerVisibility(0, true);
+    EXPECT_TRUE(layerManager.updateNodeVisibility(brush)) << "Brush is in the visible default layer";
+
+    layerManager.setLayerVisibility(layerId, true);
+    EXPECT_TRUE(brush->visible()) << "Brush should be visible again";
+}
+
 TEST_F(LayerTest, GetParentLayer)
 {
     auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
@@ -0,0 +1,223 @@
+#include "RadiantTest.h"
+
+#include <atomic>
+#include <thread>
+#include "ilogwriter.h"
+#include "itextstream.h"
+#include "string/predicate.h"
+#include "util/MpscRingBuffer.h"
+
+namespace test
+{
+
+using LoggingTest = RadiantTest;
+
+namespace
+{
+
+// Collects the lines written by the log writer
+class CapturingLogDevice :
+    public applog::ILogDevice
+{
+private:
+    std::mutex _lock;
+    std::string _output;
+
+public:
+    void writeLog(const std::string& outputStr, applog::LogLevel level) override
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _output.append(outputStr);
+    }
+
+    // Returns the lines starting with the given prefix
+    std::vector<std::string> getLines(const std::string& prefix)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        std::vector<std::string> lines;
+        std::istringstream stream(_output);
+
+        for (std::string line; std::getline(stream, line);)
+        {
+            if (string::starts_with(line, prefix))
+            {
+                lines.push_back(line);
+            }
+        }
+
+        return lines;
+    }
+};
+
+}
+
+TEST(MpscRingBufferTest, PopReturnsElementsInOrder)
+{
+    util::MpscRingBuffer<int> ring(4);
+
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.tryPush(int(i)));
+    }
+
+    EXPECT_FALSE(ring.tryPush(4)) << "Ring should be full";
+
+    int value = -1;
+
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+
+    EXPECT_FALSE(ring.tryPop(value));
+    EXPECT_TRUE(ring.empty());
+
+    // The slots are reusable in the next lap
+    EXPECT_TRUE(ring.tryPush(5));
+    EXPECT_TRUE(ring.tryPop(value));
+    EXPECT_EQ(value, 5);
+}
+
+TEST(MpscRingBufferTest, ConcurrentProducers)
+{
+    constexpr int NumThreads = 4;
+    constexpr int NumValues = 10000;
+
+    util::MpscRingBuffer<int> ring(64);
+    std::vector<std::thread> producers;
+
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        producers.emplace_back([&, t]()
+        {
+            for (int i = 0; i < NumValues; ++i)
+            {
+                while (!ring.tryPush(t * NumValues + i))
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // Each value arrives exactly once, the values of each producer in order
+    std::vector<int> lastValues(NumThreads, -1);
+    std::vector<bool> received(NumThreads * NumValues, false);
+    int numReceived = 0;
+
+    while (numReceived < NumThreads * NumValues)
+    {
+        int value;
+
+        if (!ring.tryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        EXPECT_FALSE(received[value]);
+        received[value] = true;
+
+        auto& lastValue = lastValues[value / NumValues];
+        EXPECT_GT(value, lastValue);
+        lastValue = value;
+
+        ++numReceived;
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(LoggingTest, FlushPassesOutputOfAllThreads)
+{
+    CapturingLogDevice device;
+    GlobalRadiantCore().getLogWriter().attach(&device);
+
+    constexpr int NumThreads = 4;
+    constexpr int NumLines = 100;
+
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < NumThreads; ++t)
+    {
+        threads.emplace_back([=]()
+        {
+            for (int i = 0; i < NumLines; ++i)
+            {
+                rMessage() << "LoggingTest thread " << t << " line " << i << std::endl;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    GlobalRadiantCore().getLogWriter().flush();
+
+    auto lines = device.getLines("LoggingTest ");
+    EXPECT_EQ(lines.size(), NumThreads * NumLines);
+
+    GlobalRadiantCore().getLogWriter().detach(&device);
+}
+
+TEST_F(LoggingTest, ErrorsAreWrittenImmediately)
+{
+    CapturingLogDevice device;
+    GlobalRadiantCore().getLogWriter().attach(&device);
+
+    rError() << "LoggingTest error" << std::endl;
+
+    // No flush, the error should have arrived already
+    auto lines = device.getLines("LoggingTest ");
+    ASSERT_EQ(lines.size(), 1);
+    EXPECT_EQ(lines.front(), "LoggingTest error");
+
+    GlobalRadiantCore().getLogWriter().detach(&device);
+}
+
+TEST_F(LoggingTest, DetachPassesPendingOutput)
+{
+    CapturingLogDevice device;
+    GlobalRadiantCore().getLogWriter().attach(&device);
+
+    rMessage() << "LoggingTest before detach" << std::endl;
+    GlobalRadiantCore().getLogWriter().detach(&device);
+
+    EXPECT_EQ(device.getLines("LoggingTest ").size(), 1);
+}
+
+TEST_F(LoggingTest, RepeatedLinesAreSummarised)
+{
+    CapturingLogDevice device;
+    GlobalRadiantCore().getLogWriter().attach(&device);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        rWarning() << "LoggingTest repeated warning" << std::endl;
+    }
+
+    rWarning() << "LoggingTest other warning" << std::endl;
+    GlobalRadiantCore().getLogWriter().flush();
+
+    auto lines = device.getLines("LoggingTest ");
+    ASSERT_EQ(lines.size(), 2);
+    EXPECT_EQ(lines[0], "LoggingTest repeated warning");
+    EXPECT_EQ(lines[1], "LoggingTest other warning");
+
+    EXPECT_EQ(device.getLines("(previous message repeated 4 times)").size(), 1);
+
+    GlobalRadiantCore().getLogWriter().detach(&device);
+}
+
+}
@@ -7,6 +7,7 @@
 #include "math/Matrix3.h"
 #include "iselection.h"
 #include "scenelib.h"
+#include "scene/Traverse.h"
 #include "os/path.h"
 #include "string/predicate.h"
 #include "xmlutil/Document.h"
@@ -339,4 +340,79 @@ TEST_F(MapExportTest, ExportPrefabWithEmptyFileExtension)
     runExportWithEmptyFileExtension(_context.getTemporaryDataPath(), "SaveSelectedAsPrefab");
 }
 
+namespace
+{
+
+// Forwards everything to the given writer, without supporting the parallel export
+class SerialMapWriter :
+    public map::IMapWriter
+{
+private:
+    map::IMapWriterPtr _writer;
+
+public:
+    SerialMapWriter(const map::IMapWriterPtr& writer) :
+        _writer(writer)
+    {}
+
+    void beginWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override { _writer->beginWriteMap(root, stream); }
+    void endWriteMap(const scene::IMapRootNodePtr& root, std::ostream& stream) override { _writer->endWriteMap(root, stream); }
+    void beginWriteEntity(const IEntityNodePtr& entity, std::ostream& stream) override { _writer->beginWriteEntity(entity, stream); }
+    void endWriteEntity(const IEntityNodePtr& entity, std::ostream& stream) override { _writer->endWriteEntity(entity, stream); }
+    void beginWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override { _writer->beginWriteBrush(brush, stream); }
+    void endWriteBrush(const IBrushNodePtr& brush, std::ostream& stream) override { _writer->endWriteBrush(brush, stream); }
+    void beginWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override { _writer->beginWritePatch(patch, stream); }
+    void endWritePatch(const IPatchNodePtr& patch, std::ostream& stream) override { _writer->endWritePatch(patch, stream); }
+};
+
+std::string exportSceneUsingWriter(map::IMapWriter& writer)
+{
+    std::ostringstream output;
+
+    {
+        auto exporter = GlobalMapModule().createMapExporter(writer, GlobalMapModule().getRoot(), output);
+        exporter->exportMap(GlobalMapModule().getRoot(), scene::traverse);
+    }
+
+    return output.str();
+}
+
+}
+
+TEST_F(MapExportTest, parallelExportMatchesSerialExport)
+{
+    loadMap("altar.map");
+
+    // Fill the worldspawn with enough brushes to have it split into multiple chunks
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (int x = 0; x < 16; ++x)
+    {
+        for (int y = 0; y < 16; ++y)
+        {
+            for (int z = 0; z < 4; ++z)
+            {
+                algorithm::createCubicBrush(worldspawn, Vector3(x * 128, y * 128, 512 + z * 128), "textures/numbers/" + std::to_string(z));
+            }
+        }
+    }
+
+    for (const auto& gameType : { "doom3", "quake3", "quake4" })
+    {
+        auto format = GlobalMapFormatManager().getMapFormatForGameType(gameType, "map");
+        auto writer = format->getMapWriter();
+
+        EXPECT_TRUE(writer->createParallelWriter(0, 0)) << gameType << " writer should support the parallel export";
+
+        SerialMapWriter serialWriter(format->getMapWriter());
+
+        auto parallelOutput = exportSceneUsingWriter(*writer);
+        auto serialOutput = exportSceneUsingWriter(serialWriter);
+
+        EXPECT_NE(parallelOutput.find("// entity 2"), std::string::npos) << "Export seems incomplete";
+        EXPECT_GT(parallelOutput.size(), 100000) << "Export seems incomplete";
+        EXPECT_EQ(parallelOutput, serialOutput) << "Parallel export differs from the serial one using " << gameType;
+    }
+}
+
 }
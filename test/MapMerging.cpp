@@ -6,6 +6,7 @@
 #include "imapresource.h"
 #include "ipatch.h"
 #include "icomparablenode.h"
+#include "iundo.h"
 #include "algorithm/Scene.h"
 #include "registry/registry.h"
 #include "scenelib.h"
@@ -385,6 +386,44 @@ TEST_F(MapMergeTest, DetectChildPrimitiveChanges)
     EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved), 3);
 }
 
+TEST_F(MapMergeTest, FingerprintCacheReusedAcrossComparisons)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/fingerprinting.mapx"));
+
+    auto resource = GlobalMapResourceManager().createFromPath(_context.getTestProjectPath() + "maps/fingerprinting_2.mapx");
+    EXPECT_TRUE(resource->load()) << "Test map not found";
+
+    auto uncached = GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot());
+
+    FingerprintCache cache;
+    auto first = GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot(), cache);
+
+    EXPECT_EQ(cache.getEntityFingerprints(GlobalMapModule().getRoot()),
+        cache.getEntityFingerprints(GlobalMapModule().getRoot())) << "Fingerprints should have been cached";
+
+    auto second = GraphComparer::Compare(resource->getRootNode(), GlobalMapModule().getRoot(), cache);
+
+    for (const auto& result : { first, second })
+    {
+        EXPECT_EQ(result->equivalentEntities.size(), uncached->equivalentEntities.size());
+        EXPECT_EQ(result->differingEntities.size(), uncached->differingEntities.size());
+
+        auto diff = getEntityDifference(result, "worldspawn");
+        EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveAdded), 3);
+        EXPECT_EQ(countPrimitiveDifference(diff, ComparisonResult::PrimitiveDifference::Type::PrimitiveRemoved), 3);
+    }
+
+    // Changing the scene invalidates the cached fingerprints
+    auto cachedBase = cache.getEntityFingerprints(GlobalMapModule().getRoot());
+    {
+        UndoableCommand cmd("removeEntity");
+        scene::removeNodeFromParent(getEntityDifference(uncached, "info_player_start_1").baseNode);
+    }
+
+    EXPECT_NE(cache.getEntityFingerprints(GlobalMapModule().getRoot()), cachedBase);
+    EXPECT_EQ(cache.getEntityFingerprints(GlobalMapModule().getRoot())->sorted.size(), cachedBase->sorted.size() - 1);
+}
+
 template<typename T>
 std::shared_ptr<T> findAction(const IMergeOperation::Ptr& operation, const std::function<bool(const std::shared_ptr<T>&)>& predicate)
 {
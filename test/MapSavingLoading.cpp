@@ -1,6 +1,9 @@
 #include "RadiantTest.h"
 
+#include <algorithm>
+#include <chrono>
 #include <fstream>
+#include <iterator>
 #include "iundo.h"
 #include "imap.h"
 #include "imapformat.h"
@@ -9,8 +12,11 @@
 #include "ifilesystem.h"
 #include "iradiant.h"
 #include "iselectiongroup.h"
+#include "iselectionset.h"
 #include "ilightnode.h"
 #include "icommandsystem.h"
+#include "icounter.h"
+#include "imodelcache.h"
 #include "messages/ApplicationShutdownRequest.h"
 #include "messages/FileSelectionRequest.h"
 #include "messages/FileOverwriteConfirmation.h"
@@ -21,10 +27,12 @@
 #include "algorithm/XmlUtils.h"
 #include "algorithm/Primitives.h"
 #include "os/file.h"
+#include "scene/Traverse.h"
 #include <sigc++/connection.h>
 #include "testutil/FileSelectionHelper.h"
 #include "testutil/FileSaveConfirmationHelper.h"
 #include "registry/registry.h"
+#include "fmt/format.h"
 
 using namespace std::chrono_literals;
 
@@ -454,6 +462,267 @@ TEST_F(MapLoadingTest, loadMapxInResourceOnly)
     checkAltarScene(resource->getRootNode());
 }
 
+namespace
+{
+
+// Loads the given map into a resource and returns the whole scene written in the Doom 3 format
+std::string loadMapAndExportScene(const std::string& path)
+{
+    auto resource = GlobalMapResourceManager().createFromPath(path);
+    EXPECT_TRUE(resource->load()) << "Map not found: " << path;
+
+    auto format = GlobalMapFormatManager().getMapFormatForGameType("doom3", "map");
+    auto writer = format->getMapWriter();
+
+    std::ostringstream output;
+
+    {
+        auto exporter = GlobalMapModule().createMapExporter(*writer, resource->getRootNode(), output);
+        exporter->exportMap(resource->getRootNode(), scene::traverse);
+    }
+
+    return output.str();
+}
+
+}
+
+// The parallel parser must produce the very same scene as the serial one
+TEST_F(MapLoadingTest, parallelParsingMatchesSerialParsing)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    // Add enough brushes to have the primitives distributed to multiple threads
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (int x = 0; x < 16; ++x)
+    {
+        for (int y = 0; y < 16; ++y)
+        {
+            for (int z = 0; z < 4; ++z)
+            {
+                algorithm::createCubicBrush(worldspawn, Vector3(x * 128, y * 128, 512 + z * 128), "textures/numbers/" + std::to_string(z));
+            }
+        }
+    }
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_parallel_parsing.map";
+
+    FileSelectionHelper responder(tempPath.string(), GlobalMapFormatManager().getMapFormatForFilename(tempPath.string()));
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    EXPECT_TRUE(os::fileOrDirExists(tempPath));
+
+    registry::setValue(RKEY_MAP_PARALLEL_PARSING, false);
+    auto serialScene = loadMapAndExportScene(tempPath.string());
+
+    registry::setValue(RKEY_MAP_PARALLEL_PARSING, true);
+    auto parallelScene = loadMapAndExportScene(tempPath.string());
+
+    EXPECT_NE(serialScene.find("patchDef3"), std::string::npos) << "Test map should contain patches";
+    EXPECT_GT(serialScene.size(), 100000) << "Scene has not been loaded completely";
+    EXPECT_EQ(serialScene, parallelScene) << "Parallel parsing produced a different scene";
+
+    fs::remove(tempPath);
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant"));
+}
+
+// Only the requested layers are parsed, the rest is written back unchanged
+TEST_F(MapSavingTest, partiallyLoadedMapIsSavedCompletely)
+{
+    fs::path mapPath = _context.getTestProjectPath();
+    mapPath /= "maps/altar.map";
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_partial_load.map";
+
+    fs::remove(tempPath);
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant"));
+    fs::copy(mapPath, tempPath);
+    fs::copy(fs::path(mapPath).replace_extension("darkradiant"), fs::path(tempPath).replace_extension("darkradiant"));
+
+    auto originalScene = loadMapAndExportScene(tempPath.string());
+
+    // Load the "Lights" layer only
+    auto resource = GlobalMapResourceManager().createFromPath(tempPath.string());
+    EXPECT_TRUE(resource->loadLayers({ 2 }));
+
+    auto root = resource->getRootNode();
+    std::size_t numUnloadedBlocks = 0;
+
+    root->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (node->getNodeType() == scene::INode::Type::UnloadedBlock)
+        {
+            ++numUnloadedBlocks;
+        }
+        return true;
+    });
+
+    EXPECT_GT(numUnloadedBlocks, 0) << "All nodes have been parsed";
+    EXPECT_TRUE(algorithm::findWorldspawn(root)) << "The worldspawn must always be loaded";
+    EXPECT_TRUE(algorithm::getEntityByName(root, "light_torchflame_13")) << "Light layer has not been loaded";
+    EXPECT_FALSE(algorithm::getEntityByName(root, "func_static_153")) << "Windows layer should not be loaded";
+
+    resource->save();
+
+    // The saved map is identical to the original one
+    EXPECT_EQ(loadMapAndExportScene(tempPath.string()), originalScene);
+
+    // The layers and groups of the unloaded nodes are kept too
+    auto reloaded = GlobalMapResourceManager().createFromPath(tempPath.string());
+    EXPECT_TRUE(reloaded->load());
+
+    auto funcStatic = algorithm::getEntityByName(reloaded->getRootNode(), "func_static_153");
+    ASSERT_TRUE(funcStatic);
+    EXPECT_EQ(funcStatic->getLayers(), scene::LayerList({ 1 }));
+    EXPECT_TRUE(std::dynamic_pointer_cast<IGroupSelectable>(funcStatic)->isGroupMember());
+
+    fs::remove(tempPath);
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant"));
+    fs::remove(fs::path(tempPath).replace_extension("bak"));
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant.bak"));
+}
+
+// The cache is used as long as the map file is unchanged according to its size and time
+TEST_F(MapLoadingTest, mapCacheIsUsedForUnchangedMapFile)
+{
+    registry::setValue(RKEY_MAP_CACHE_MIN_SIZE, 0);
+
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_map_cache.map";
+    fs::path cachePath = tempPath.string() + ".cache";
+
+    FileSelectionHelper responder(tempPath.string(), GlobalMapFormatManager().getMapFormatForFilename(tempPath.string()));
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    EXPECT_TRUE(os::fileOrDirExists(tempPath));
+
+    registry::setValue(RKEY_MAP_USE_CACHE, false);
+    auto originalScene = loadMapAndExportScene(tempPath.string());
+    EXPECT_FALSE(os::fileOrDirExists(cachePath)) << "Cache should not be written when disabled";
+
+    registry::setValue(RKEY_MAP_USE_CACHE, true);
+    EXPECT_EQ(loadMapAndExportScene(tempPath.string()), originalScene);
+    EXPECT_TRUE(os::fileOrDirExists(cachePath)) << "Cache should have been written after loading the map";
+
+    // Change a material in the map, keeping size and modification time
+    auto modificationTime = fs::last_write_time(tempPath);
+    std::string mapContents;
+    {
+        std::ifstream input(tempPath.string(), std::ios::binary);
+        mapContents.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+
+    auto materialPos = mapContents.find("textures/tiles01");
+    ASSERT_NE(materialPos, std::string::npos);
+    mapContents.replace(materialPos, 16, "textures/tiles02");
+    {
+        std::ofstream output(tempPath.string(), std::ios::binary);
+        output << mapContents;
+    }
+    fs::last_write_time(tempPath, modificationTime);
+
+    // The scene is coming from the cache, including the layers of the info file
+    auto resource = GlobalMapResourceManager().createFromPath(tempPath.string());
+    EXPECT_TRUE(resource->load());
+
+    std::vector<std::string> layerNames;
+    resource->getRootNode()->getLayerManager().foreachLayer([&](int layerId, const std::string& layerName)
+    {
+        layerNames.push_back(layerName);
+    });
+    EXPECT_EQ(layerNames, std::vector<std::string>({ "Default", "Windows", "Lights", "Ceiling" }));
+
+    EXPECT_EQ(loadMapAndExportScene(tempPath.string()), originalScene) << "Scene should have been loaded from the cache";
+
+    // Touching the map file invalidates the cache
+    fs::last_write_time(tempPath, modificationTime + std::chrono::seconds(10));
+
+    auto modifiedScene = loadMapAndExportScene(tempPath.string());
+    EXPECT_NE(modifiedScene, originalScene) << "Outdated cache should have been ignored";
+    EXPECT_NE(modifiedScene.find("textures/tiles02"), std::string::npos);
+
+    registry::setValue(RKEY_MAP_CACHE_MIN_SIZE, 2048);
+
+    fs::remove(tempPath);
+    fs::remove(cachePath);
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant"));
+}
+
+// With preloading enabled, closing a map writes the manifest of its models and materials
+TEST_F(MapLoadingTest, closingMapWritesAssetManifest)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "altar_asset_manifest.map";
+    fs::path manifestPath = tempPath.string() + ".assets";
+
+    FileSelectionHelper responder(tempPath.string(), GlobalMapFormatManager().getMapFormatForFilename(tempPath.string()));
+    GlobalCommandSystem().executeCommand("SaveMapCopyAs");
+    EXPECT_TRUE(os::fileOrDirExists(tempPath));
+
+    registry::setValue(RKEY_PRELOAD_LAST_MAP, false);
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument(tempPath.string()));
+    GlobalCommandSystem().executeCommand("NewMap");
+    EXPECT_FALSE(os::fileOrDirExists(manifestPath)) << "Manifest should not be written when disabled";
+
+    registry::setValue(RKEY_PRELOAD_LAST_MAP, true);
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument(tempPath.string()));
+    GlobalCommandSystem().executeCommand("NewMap");
+    ASSERT_TRUE(os::fileOrDirExists(manifestPath)) << "Manifest should have been written when closing the map";
+
+    std::ifstream input(manifestPath.string());
+    std::string manifest(std::istreambuf_iterator<char>(input), {});
+    input.close();
+
+    EXPECT_NE(manifest.find("model models/window.ase\n"), std::string::npos);
+    EXPECT_NE(manifest.find("material textures/tiles01\n"), std::string::npos);
+
+    // Preloading queues the models for background parsing
+    GlobalModelCache().clear();
+    GlobalModelCache().setAsyncLoadingEnabled(true);
+
+    GlobalCommandSystem().executeCommand(PRELOAD_MAP_ASSETS_CMD, cmd::Argument(tempPath.string()));
+    EXPECT_TRUE(GlobalModelCache().isModelLoading("models/window.ase"));
+
+    GlobalModelCache().setAsyncLoadingEnabled(false);
+    registry::setValue(RKEY_PRELOAD_LAST_MAP, false);
+
+    fs::remove(tempPath);
+    fs::remove(manifestPath);
+    fs::remove(fs::path(tempPath).replace_extension("darkradiant"));
+}
+
+// Every map load is writing a report of the time spent in the various load phases
+TEST_F(MapLoadingTest, loadingMapWritesLoadReport)
+{
+    auto reportPath = _context.getCacheDataPath() + "map_load_report.json";
+    fs::remove(reportPath);
+
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+    checkAltarScene();
+
+    ASSERT_TRUE(os::fileOrDirExists(reportPath)) << "Load report has not been written";
+
+    std::ifstream input(reportPath);
+    std::string report(std::istreambuf_iterator<char>(input), {});
+
+    EXPECT_NE(report.find("\"operation\": \"load\""), std::string::npos);
+    EXPECT_NE(report.find("altar.map"), std::string::npos);
+
+    for (auto phase : { "Tokenising", "Primitive parsing", "Entity creation", "Model loading",
+        "Material resolution", "BRep building", "Octree insertion", "Renderable preparation" })
+    {
+        EXPECT_NE(report.find(fmt::format("\"{0}\":", phase)), std::string::npos) << "Phase missing: " << phase;
+    }
+
+    EXPECT_NE(report.find(fmt::format("\"brushes\": {0}",
+        GlobalCounters().getCounter(counterBrushes).get())), std::string::npos);
+    EXPECT_EQ(report.find("\"peakMemoryBytes\": 0\n"), std::string::npos) << "Peak memory should be known";
+}
+
 TEST_F(MapSavingTest, saveMapWithoutModification)
 {
     auto tempPath = createMapCopyInTempDataPath("altar.map", "altar_saveMapWithoutModification.map");
@@ -498,6 +767,27 @@ TEST_F(MapSavingTest, saveMapClearsModifiedFlag)
     EXPECT_FALSE(GlobalMapModule().isModified());
 }
 
+TEST_F(MapSavingTest, saveMapWritesSaveReport)
+{
+    auto tempPath = createMapCopyInTempDataPath("altar.map", "altar_save_report_test.map");
+    auto reportPath = _context.getCacheDataPath() + "map_save_report.json";
+    fs::remove(reportPath);
+
+    GlobalCommandSystem().executeCommand("OpenMap", tempPath.string());
+    checkAltarScene();
+
+    GlobalCommandSystem().executeCommand("SaveMap");
+
+    ASSERT_TRUE(os::fileOrDirExists(reportPath)) << "Save report has not been written";
+
+    std::ifstream input(reportPath);
+    std::string report(std::istreambuf_iterator<char>(input), {});
+
+    EXPECT_NE(report.find("\"operation\": \"save\""), std::string::npos);
+    EXPECT_NE(report.find("\"Writing\":"), std::string::npos);
+    EXPECT_EQ(report.find("\"Tokenising\":"), std::string::npos) << "Load phases should not be part of the save report";
+}
+
 TEST_F(MapSavingTest, saveMapDoesntChangeMap)
 {
     // Create a copy of the map file in the mod-relative maps/ folder
@@ -642,6 +932,76 @@ TEST_F(MapSavingTest, saveMapxPreservesLayerInfo)
     doCheckSaveMapPreservesLayerInfo(tempPath.string(), format);
 }
 
+TEST_F(MapSavingTest, saveMapPreservesSelectionSetsAndGroups)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(400, 400, 400), "shader1");
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(500, 100, 200), "shader2");
+    auto brush3 = algorithm::createCubicBrush(worldspawn, Vector3(300, 100, 200), "shader3");
+
+    auto& setManager = GlobalMapModule().getRoot()->getSelectionSetManager();
+
+    // brush2 is member of both sets
+    auto set1 = setManager.createSelectionSet("Set1");
+    set1->addNode(brush1);
+    set1->addNode(brush2);
+
+    auto set2 = setManager.createSelectionSet("Set2");
+    set2->addNode(brush2);
+    set2->addNode(brush3);
+
+    auto& groupManager = GlobalMapModule().getRoot()->getSelectionGroupManager();
+
+    // brush3 is member of both groups
+    auto group1 = groupManager.createSelectionGroup();
+    group1->addNode(brush1);
+    group1->addNode(brush3);
+    auto group1Id = group1->getId();
+
+    auto group2 = groupManager.createSelectionGroup();
+    group2->addNode(brush3);
+    auto group2Id = group2->getId();
+
+    set1 = set2 = selection::ISelectionSetPtr();
+    group1 = group2 = selection::ISelectionGroupPtr();
+    worldspawn = brush1 = brush2 = brush3 = scene::INodePtr();
+
+    fs::path tempPath = _context.getTemporaryDataPath();
+    tempPath /= "three_brushes_with_sets.map";
+    FileSelectionHelper responder(tempPath.string(), GlobalMapFormatManager().getMapFormatForFilename(tempPath.string()));
+
+    GlobalCommandSystem().executeCommand("SaveMap");
+    GlobalCommandSystem().executeCommand("OpenMap", tempPath.string());
+
+    worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    brush1 = algorithm::findFirstBrushWithMaterial(worldspawn, "shader1");
+    brush2 = algorithm::findFirstBrushWithMaterial(worldspawn, "shader2");
+    brush3 = algorithm::findFirstBrushWithMaterial(worldspawn, "shader3");
+
+    auto& loadedSetManager = GlobalMapModule().getRoot()->getSelectionSetManager();
+    set1 = loadedSetManager.findSelectionSet("Set1");
+    set2 = loadedSetManager.findSelectionSet("Set2");
+
+    ASSERT_TRUE(set1);
+    ASSERT_TRUE(set2);
+    EXPECT_EQ(set1->getNodes(), std::set<scene::INodePtr>({ brush1, brush2 }));
+    EXPECT_EQ(set2->getNodes(), std::set<scene::INodePtr>({ brush2, brush3 }));
+
+    auto& loadedGroupManager = GlobalMapModule().getRoot()->getSelectionGroupManager();
+    group1 = loadedGroupManager.getSelectionGroup(group1Id);
+    group2 = loadedGroupManager.getSelectionGroup(group2Id);
+
+    ASSERT_TRUE(group1);
+    ASSERT_TRUE(group2);
+    EXPECT_EQ(group1->size(), 2);
+    EXPECT_EQ(group2->size(), 1);
+
+    auto groupSelectable = std::dynamic_pointer_cast<IGroupSelectable>(brush3);
+    ASSERT_TRUE(groupSelectable);
+    EXPECT_EQ(groupSelectable->getGroupIds(), IGroupSelectable::GroupIds({ group1Id, group2Id }));
+}
+
 TEST_F(MapSavingTest, saveAs)
 {
     std::string modRelativePath = "maps/altar.map";
@@ -1308,6 +1668,139 @@ TEST_F(MapSavingTest, AutoSaveSnapshotsSupportAbsolutePaths)
     fs::remove(expectedSnapshotPath);
 }
 
+TEST_F(MapSavingTest, AutoSaveSnapshotsInBackground)
+{
+    std::string modRelativePath = "maps/altar.map";
+    GlobalCommandSystem().executeCommand("OpenMap", modRelativePath);
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "backgroundsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_IN_BACKGROUND, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    std::string expectedSnapshotPath = snapshotFolder + "altar.0.map";
+
+    EXPECT_FALSE(os::fileOrDirExists(expectedSnapshotPath)) << "Snapshot already exists in " << expectedSnapshotPath;
+
+    // Trigger two background saves in quick succession, then wait for the writer
+    GlobalAutoSaver().performAutosaveInBackground();
+    GlobalAutoSaver().performAutosaveInBackground();
+    GlobalAutoSaver().waitForBackgroundSaves();
+
+    EXPECT_TRUE(os::fileOrDirExists(expectedSnapshotPath)) << "Snapshot should now exist in " << expectedSnapshotPath;
+    EXPECT_FALSE(os::fileOrDirExists(expectedSnapshotPath + ".tmp")) << "Temporary file should have been moved";
+
+    // Load and confirm the saved scene
+    GlobalCommandSystem().executeCommand("OpenMap", expectedSnapshotPath);
+    checkAltarScene();
+
+    for (const auto& snapshot : { "altar.0", "altar.1" })
+    {
+        auto path = snapshotFolder + snapshot + ".map";
+
+        if (fs::exists(path))
+        {
+            fs::remove(os::replaceExtension(path, "darkradiant"));
+            fs::remove(path);
+        }
+    }
+}
+
+namespace
+{
+
+// Writes the given scene in the Doom 3 format, returning the entity blocks in
+// sorted order with the numbering comments stripped, for order-independent comparison
+std::vector<std::string> exportSortedEntityBlocks(const scene::IMapRootNodePtr& root)
+{
+    auto format = GlobalMapFormatManager().getMapFormatForGameType("doom3", "map");
+    auto writer = format->getMapWriter();
+
+    std::ostringstream output;
+
+    {
+        auto exporter = GlobalMapModule().createMapExporter(*writer, root, output);
+        exporter->exportMap(root, scene::traverse);
+    }
+
+    std::vector<std::string> blocks;
+    std::istringstream input(output.str());
+    std::string line;
+
+    while (std::getline(input, line))
+    {
+        if (line.rfind("// entity", 0) == 0)
+        {
+            blocks.emplace_back();
+            continue;
+        }
+
+        if (!blocks.empty())
+        {
+            blocks.back() += line + "\n";
+        }
+    }
+
+    std::sort(blocks.begin(), blocks.end());
+
+    return blocks;
+}
+
+}
+
+TEST_F(MapSavingTest, AutoSaveDifferentialSnapshotsRestoreScene)
+{
+    std::string modRelativePath = "maps/altar.map";
+    GlobalCommandSystem().executeCommand("OpenMap", modRelativePath);
+    checkAltarScene();
+
+    auto snapshotFolder = _context.getTemporaryDataPath() + "differentialsnapshots/";
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_ENABLED, true);
+    registry::setValue(map::RKEY_AUTOSAVE_DIFFERENTIAL_SNAPSHOTS, true);
+    registry::setValue(map::RKEY_AUTOSAVE_SNAPSHOTS_FOLDER, snapshotFolder);
+
+    std::string baseSnapshotPath = snapshotFolder + "altar.0.map";
+    std::string journalPath = snapshotFolder + "altar.0.journal";
+
+    // The first snapshot is a full one
+    GlobalAutoSaver().performAutosave();
+
+    EXPECT_TRUE(os::fileOrDirExists(baseSnapshotPath)) << "Snapshot should now exist in " << baseSnapshotPath;
+    EXPECT_FALSE(os::fileOrDirExists(journalPath)) << "Journal should not exist yet";
+
+    // Change a spawnarg, add a brush and remove an entity
+    {
+        UndoableCommand cmd("modifyScene");
+
+        auto root = GlobalMapModule().getRoot();
+        Node_getEntity(algorithm::getEntityByName(root, "religious_symbol_1"))->setKeyValue("_color", "1 0 0");
+        algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn(), Vector3(512, 512, 512), "textures/numbers/1");
+        scene::removeNodeFromParent(algorithm::getEntityByName(root, "func_static_66"));
+    }
+
+    auto expectedScene = exportSortedEntityBlocks(GlobalMapModule().getRoot());
+
+    // The second snapshot should end up in the journal
+    GlobalAutoSaver().performAutosave();
+
+    EXPECT_FALSE(os::fileOrDirExists(snapshotFolder + "altar.1.map")) << "No full snapshot should have been written";
+    EXPECT_TRUE(os::fileOrDirExists(journalPath)) << "Journal should now exist in " << journalPath;
+
+    // Load the base snapshot and replay the journal on it
+    GlobalCommandSystem().executeCommand("OpenMap", baseSnapshotPath);
+    checkAltarScene();
+
+    GlobalCommandSystem().executeCommand("ApplySnapshotJournal", journalPath);
+
+    EXPECT_EQ(exportSortedEntityBlocks(GlobalMapModule().getRoot()), expectedScene);
+    EXPECT_FALSE(algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_66"));
+
+    fs::remove(os::replaceExtension(baseSnapshotPath, "darkradiant"));
+    fs::remove(baseSnapshotPath);
+    fs::remove(journalPath);
+}
+
 namespace
 {
 
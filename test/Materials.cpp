@@ -1,8 +1,15 @@
 #include "RadiantTest.h"
 
 #include "ishaders.h"
+#include "icommandsystem.h"
+#include "ieclass.h"
+#include "ientity.h"
+#include "irender.h"
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
+#include "registry/registry.h"
 #include "string/split.h"
 #include "string/case_conv.h"
 #include "string/trim.h"
@@ -1794,6 +1801,57 @@ TEST_F(MaterialsTest, ShaderExpressionEvaluation)
     }
 }
 
+// Evaluating an expression runs its compiled program, which must match the values of the tree
+TEST_F(MaterialsTest, ShaderExpressionProgramMatchesTree)
+{
+    constexpr std::size_t TimeInMilliseconds = 1700;
+
+    auto entityNode = GlobalEntityModule().createEntity(GlobalEntityClassManager().findClass("func_static"));
+    Node_getEntity(entityNode)->setKeyValue("_color", "0.25 0.3 0.75");
+    Node_getEntity(entityNode)->setKeyValue("shaderParm5", "-0.5");
+    Node_getEntity(entityNode)->setKeyValue("shaderParm7", "3");
+
+    auto renderEntity = std::dynamic_pointer_cast<IRenderEntity>(entityNode);
+    ASSERT_TRUE(renderEntity) << "Entity node should be a render entity";
+
+    auto testExpressions = std::vector<std::string>
+    {
+        "3",
+        "time",
+        "parm0",
+        "parm5",
+        "global3",
+        "(3+3*7)-5",
+        "time / (6 * 3) % 0.4",
+        "cosTable[time * parm7]",
+        "3 + cosTable[parm5 + sinTable[time]] * 7",
+        "parm0 * 4 > parm1 * 3 && parm7 != 3",
+        "parm5 <= 0 || time >= 2 == parm2 < 1",
+        "parm4 / parm5 - parm7",
+    };
+
+    for (const auto& expressionString : testExpressions)
+    {
+        auto expr = GlobalMaterialManager().createShaderExpressionFromString(expressionString);
+
+        shaders::Registers registers;
+        auto index = expr->linkToRegister(registers);
+
+        EXPECT_NEAR(expr->evaluate(TimeInMilliseconds), expr->getValue(TimeInMilliseconds), 0.0001f) <<
+            "Expression " << expressionString << " evaluates differently without an entity";
+        EXPECT_NEAR(registers[index], expr->getValue(TimeInMilliseconds), 0.0001f);
+
+        EXPECT_NEAR(expr->evaluate(TimeInMilliseconds, *renderEntity), expr->getValue(TimeInMilliseconds, *renderEntity), 0.0001f) <<
+            "Expression " << expressionString << " evaluates differently with an entity";
+        EXPECT_NEAR(registers[index], expr->getValue(TimeInMilliseconds, *renderEntity), 0.0001f);
+
+        // Changing the entity's parms is reflected in the next evaluation
+        Node_getEntity(entityNode)->setKeyValue("shaderParm7", "1");
+        EXPECT_NEAR(expr->evaluate(TimeInMilliseconds, *renderEntity), expr->getValue(TimeInMilliseconds, *renderEntity), 0.0001f);
+        Node_getEntity(entityNode)->setKeyValue("shaderParm7", "3");
+    }
+}
+
 TEST_F(MaterialsTest, UpdateFromValidSourceText)
 {
     auto material = GlobalMaterialManager().getMaterial("textures/exporttest/empty");
@@ -2035,4 +2093,105 @@ TEST_F(MaterialsTest, EditorImageUpdatedBeforeMaterialChangedSignalEmission)
     EXPECT_FALSE(material->isEditorImageNoTex()) << "Editor image should have been updated";
 }
 
+// Layer images requested while async loading is enabled are represented by a placeholder until they are uploaded
+TEST_F(MaterialsTest, AsyncTextureLoadingReturnsPlaceholder)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/numbers/7");
+    auto layers = getAllLayers(material);
+    ASSERT_EQ(layers.size(), 1);
+
+    GlobalMaterialManager().setAsyncTextureLoadingEnabled(true);
+
+    std::atomic<bool> decodeFinished(false);
+    auto finishedConn = GlobalMaterialManager().signal_asyncTextureLoadFinished().connect([&]() { decodeFinished = true; });
+
+    auto placeholder = GlobalMaterialManager().getDefaultInteractionTexture(IShaderLayer::DIFFUSE);
+    EXPECT_EQ(layers.front()->getTexture(), placeholder) << "Layer should use the default texture until the image is uploaded";
+
+    // Wait for the worker, the upload happens on the main thread only
+    for (int i = 0; i < 1000 && !decodeFinished; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_TRUE(decodeFinished) << "Image has not been decoded in the background";
+    EXPECT_EQ(layers.front()->getTexture(), placeholder) << "Texture should not change before processAsyncTextureLoads()";
+
+    bool materialChanged = false;
+    auto changedConn = material->sig_materialChanged().connect([&]() { materialChanged = true; });
+
+    GlobalMaterialManager().processAsyncTextureLoads(std::chrono::milliseconds(1000));
+
+    EXPECT_TRUE(materialChanged) << "Material should have been notified about the uploaded texture";
+
+    auto texture = layers.front()->getTexture();
+    ASSERT_TRUE(texture);
+    EXPECT_NE(texture, placeholder) << "Layer should use the uploaded texture now";
+    EXPECT_NE(texture->getGLTexNum(), placeholder->getGLTexNum());
+
+    changedConn.disconnect();
+    finishedConn.disconnect();
+    GlobalMaterialManager().setAsyncTextureLoadingEnabled(false);
+}
+
+// Without a texture memory budget, drawn textures are never replaced
+TEST_F(MaterialsTest, TextureResidencyWithoutBudgetKeepsTextures)
+{
+    registry::setValue("user/ui/textures/memoryBudget", 0);
+
+    auto material = GlobalMaterialManager().getMaterial("textures/numbers/8");
+    auto layers = getAllLayers(material);
+    ASSERT_EQ(layers.size(), 1);
+
+    auto texture = layers.front()->getTexture();
+    ASSERT_TRUE(texture);
+
+    bool materialChanged = false;
+    auto changedConn = material->sig_materialChanged().connect([&]() { materialChanged = true; });
+
+    GlobalMaterialManager().updateTextureResidency({ texture->getGLTexNum() });
+
+    EXPECT_FALSE(materialChanged) << "Material should not have been notified";
+    EXPECT_EQ(layers.front()->getTexture(), texture);
+
+    EXPECT_NO_THROW(GlobalCommandSystem().executeCommand("ShowTextureMemoryStats"));
+
+    changedConn.disconnect();
+}
+
+// Thumbnails are generated in the background, the result is handed out once
+TEST_F(MaterialsTest, EditorImageThumbnailIsDownsampled)
+{
+    std::atomic<bool> thumbnailReady(false);
+    auto readyConn = GlobalMaterialManager().signal_editorImageThumbnailReady().connect([&]() { thumbnailReady = true; });
+
+    IMaterialManager::EditorImageThumbnailPtr thumbnail;
+
+    for (int i = 0; i < 1000 && !thumbnail; ++i)
+    {
+        thumbnail = GlobalMaterialManager().getEditorImageThumbnail("textures/a_1024x512");
+
+        if (!thumbnail)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    ASSERT_TRUE(thumbnail) << "Thumbnail has not been generated";
+    EXPECT_TRUE(thumbnailReady) << "Ready signal should have been emitted";
+
+    // The size of the full image is reported along with the thumbnail
+    EXPECT_EQ(thumbnail->width, 1024);
+    EXPECT_EQ(thumbnail->height, 512);
+
+    ASSERT_TRUE(thumbnail->image);
+    EXPECT_EQ(thumbnail->image->getWidth(), IMaterialManager::THUMBNAIL_SIZE);
+    EXPECT_EQ(thumbnail->image->getHeight(), IMaterialManager::THUMBNAIL_SIZE / 2);
+
+    EXPECT_FALSE(GlobalMaterialManager().getEditorImageThumbnail("textures/a_1024x512"))
+        << "The thumbnail should be handed out only once";
+
+    readyConn.disconnect();
+}
+
 }
@@ -1,5 +1,6 @@
 #include "RadiantTest.h"
 
+#include <atomic>
 #include <future>
 #include "imessagebus.h"
 
@@ -32,6 +33,23 @@ public:
     }
 };
 
+class ProgressMessage :
+    public radiant::IMessage
+{
+public:
+    static const std::size_t Id = radiant::IMessage::Type::UserDefinedMessagesGoHigherThanThis + 1002;
+
+    std::size_t getId() const override
+    {
+        return Id;
+    }
+
+    bool isCoalescable() const override
+    {
+        return true;
+    }
+};
+
 TEST_F(MessageBusTest, Registration)
 {
     auto counter1 = 0;
@@ -169,4 +187,171 @@ TEST_F(MessageBusTest, MultipleThreadsCanSendMessages)
     }
 }
 
+TEST_F(MessageBusTest, ListenerRemovedDuringCallbackIsNotInvoked)
+{
+    auto counter1 = 0;
+    auto counter2 = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    std::size_t listenerId2 = 0;
+
+    // The first listener removes the second one, which is already part of the running dispatch
+    auto listenerId1 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&)
+    {
+        ++counter1;
+        messageBus.removeListener(listenerId2);
+    });
+
+    listenerId2 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter2; });
+
+    CustomMessage1 msg1;
+    messageBus.sendMessage(msg1);
+
+    EXPECT_EQ(counter1, 1);
+    EXPECT_EQ(counter2, 0) << "Removed listener has been invoked";
+
+    messageBus.removeListener(listenerId1);
+}
+
+TEST_F(MessageBusTest, ListenerAddedDuringCallbackReceivesNextMessage)
+{
+    auto counter1 = 0;
+    auto counter2 = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    std::size_t listenerId2 = 0;
+
+    auto listenerId1 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&)
+    {
+        ++counter1;
+
+        if (listenerId2 == 0)
+        {
+            listenerId2 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter2; });
+        }
+    });
+
+    CustomMessage1 msg1;
+    messageBus.sendMessage(msg1);
+
+    // The new listener is not part of the running dispatch
+    EXPECT_EQ(counter1, 1);
+    EXPECT_EQ(counter2, 0);
+
+    messageBus.sendMessage(msg1);
+
+    EXPECT_EQ(counter1, 2);
+    EXPECT_EQ(counter2, 1);
+
+    messageBus.removeListener(listenerId1);
+    messageBus.removeListener(listenerId2);
+}
+
+TEST_F(MessageBusTest, ConcurrentSendsFromWorkerThreads)
+{
+    constexpr int NumThreads = 8;
+    constexpr int NumMessages = 1000;
+
+    std::atomic<int> counter1(0);
+    std::atomic<int> counter2(0);
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    auto listenerId1 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&) { ++counter1; });
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < NumThreads; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            CustomMessage1 msg1;
+
+            for (int n = 0; n < NumMessages; ++n)
+            {
+                messageBus.sendMessage(msg1);
+            }
+        });
+    }
+
+    // Register and remove listeners on another channel while the threads are sending
+    for (int n = 0; n < 100; ++n)
+    {
+        auto id = messageBus.addListener(CustomMessage2::Id, [&](radiant::IMessage&) { ++counter2; });
+        messageBus.removeListener(id);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter1, NumThreads * NumMessages);
+    EXPECT_EQ(counter2, 0);
+
+    messageBus.removeListener(listenerId1);
+}
+
+TEST_F(MessageBusTest, CoalescableMessageIsDroppedWhileDispatching)
+{
+    auto progressCounter = 0;
+    auto customCounter = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    // Sending another message of the same type during dispatch
+    auto listenerId1 = messageBus.addListener(ProgressMessage::Id, [&](radiant::IMessage&)
+    {
+        ++progressCounter;
+
+        ProgressMessage progress;
+        messageBus.sendMessage(progress);
+    });
+
+    // Non-coalescable messages are always delivered
+    auto listenerId2 = messageBus.addListener(CustomMessage1::Id, [&](radiant::IMessage&)
+    {
+        if (++customCounter < 3)
+        {
+            CustomMessage1 msg1;
+            messageBus.sendMessage(msg1);
+        }
+    });
+
+    ProgressMessage progress;
+    messageBus.sendMessage(progress);
+
+    EXPECT_EQ(progressCounter, 1) << "Nested progress message should have been dropped";
+
+    // Once the dispatch is done, the next progress message is delivered
+    messageBus.sendMessage(progress);
+    EXPECT_EQ(progressCounter, 2);
+
+    CustomMessage1 msg1;
+    messageBus.sendMessage(msg1);
+    EXPECT_EQ(customCounter, 3);
+
+    messageBus.removeListener(listenerId1);
+    messageBus.removeListener(listenerId2);
+}
+
+TEST_F(MessageBusTest, CoalescableMessageIsDeliveredAfterListenerThrew)
+{
+    auto counter = 0;
+    auto& messageBus = GlobalRadiantCore().getMessageBus();
+
+    // Listeners cancel operations by throwing, like the map file progress handler
+    auto listenerId1 = messageBus.addListener(ProgressMessage::Id, [&](radiant::IMessage&)
+    {
+        ++counter;
+        throw std::runtime_error("Cancelled");
+    });
+
+    ProgressMessage progress;
+    EXPECT_THROW(messageBus.sendMessage(progress), std::runtime_error);
+    EXPECT_THROW(messageBus.sendMessage(progress), std::runtime_error);
+
+    EXPECT_EQ(counter, 2);
+
+    messageBus.removeListener(listenerId1);
+}
+
 }
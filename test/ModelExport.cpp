@@ -293,6 +293,38 @@ TEST_F(ModelExportTest, LwoVertexColoursAddedBySurface)
     checkVertexColoursOfExportedModel(exporter, _context.getTestProjectPath());
 }
 
+TEST_F(ModelExportTest, PolygonVerticesAreWelded)
+{
+    auto exporter = GlobalModelFormatManager().getExporter("lwo");
+    EXPECT_TRUE(exporter);
+
+    // Two triangles forming a quad share two of their vertices
+    MeshVertex a(Vertex3(0, 0, 0), Normal3(0, 0, 1), TexCoord2f(0, 0));
+    MeshVertex b(Vertex3(64, 0, 0), Normal3(0, 0, 1), TexCoord2f(1, 0));
+    MeshVertex c(Vertex3(64, 64, 0), Normal3(0, 0, 1), TexCoord2f(1, 1));
+    MeshVertex d(Vertex3(0, 64, 0), Normal3(0, 0, 1), TexCoord2f(0, 1));
+
+    // The second triangle's copy of a is slightly off, within the welding epsilon
+    MeshVertex aNearby(Vertex3(0.001, 0, 0), Normal3(0, 0, 1), TexCoord2f(0, 0));
+
+    std::vector<model::ModelPolygon> polys
+    {
+        model::ModelPolygon{ a, b, c },
+        model::ModelPolygon{ aNearby, c, d },
+    };
+
+    exporter->addPolygons(CustomMaterialName, polys, Matrix4::getIdentity());
+
+    auto outputPath = _context.getTemporaryDataPath();
+    exporter->exportToPath(outputPath, "welded.lwo");
+
+    auto exportedModel = GlobalModelFormatManager().getImporter("LWO")->loadModelFromPath(outputPath + "welded.lwo");
+
+    ASSERT_TRUE(exportedModel);
+    EXPECT_EQ(exportedModel->getVertexCount(), 4) << "The shared vertices should have been welded";
+    EXPECT_EQ(exportedModel->getPolyCount(), 2);
+}
+
 inline void runConverterCode(const std::string& inputPath, const std::string& outputPath)
 {
     auto extension = string::to_upper_copy(os::getExtension(outputPath));
@@ -1,13 +1,24 @@
 #include "RadiantTest.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
 #include <unordered_set>
+#include "imodel.h"
 #include "imodelsurface.h"
 #include "imodelcache.h"
+#include "iassetwatcher.h"
+#include "imd5anim.h"
+#include "itransformable.h"
+#include "modelskin.h"
 #include "scenelib.h"
 #include "algorithm/Entity.h"
 #include "algorithm/FileUtils.h"
 #include "algorithm/Scene.h"
 #include "os/file.h"
+#include "registry/registry.h"
 
 #include "render/VertexHashing.h"
 #include "string/replace.h"
@@ -460,6 +471,25 @@ TEST_F(ModelTest, LoadFbxModel)
     EXPECT_EQ(model->getPolyCount(), 12);
 }
 
+TEST_F(ModelTest, LoadFbxModelTwice)
+{
+    auto inputPath = _context.getTestResourcePath() + "fbx/test_cube.fbx";
+    auto importer = GlobalModelFormatManager().getImporter("FBX");
+
+    // The second model is constructed from the converted surfaces of the first load
+    auto first = importer->loadModelFromPath(inputPath);
+    auto second = importer->loadModelFromPath(inputPath);
+
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_NE(first, second) << "Each load should return a new model";
+    EXPECT_EQ(second->getSurfaceCount(), 1);
+    EXPECT_EQ(second->getSurface(0).getDefaultMaterial(), "phong1");
+    EXPECT_EQ(second->getVertexCount(), first->getVertexCount());
+    EXPECT_EQ(second->getPolyCount(), first->getPolyCount());
+    EXPECT_EQ(second->getSurface(0).getVertex(0).vertex, first->getSurface(0).getVertex(0).vertex);
+}
+
 // #5964: Model nodes below a func_emitter didn't get rendered at the entity's origin after creating the entity
 TEST_F(ModelTest, NullModelTransformAfterSceneInsertion)
 {
@@ -515,6 +545,34 @@ TEST_F(ModelTest, ModelKeyReferencesMd5Model)
     performModelNodeTest(_context.getTestProjectPath(), "models/md5/flag01.md5mesh", 96);
 }
 
+// A changed model file is reloaded for the entities using it, the others keep their model
+TEST_F(ModelTest, ChangedModelFileIsReloaded)
+{
+    const std::string changedPath("models/ase/testcube.ase");
+
+    auto changedEntity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(changedEntity, GlobalMapModule().getRoot());
+    changedEntity->getEntity().setKeyValue("model", changedPath);
+
+    auto unchangedEntity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(unchangedEntity, GlobalMapModule().getRoot());
+    unchangedEntity->getEntity().setKeyValue("model", "models/torch.lwo");
+
+    auto changedModel = algorithm::findChildModel(changedEntity);
+    auto unchangedModel = algorithm::findChildModel(unchangedEntity);
+    ASSERT_TRUE(changedModel);
+    ASSERT_TRUE(unchangedModel);
+
+    // Files which are not assets are ignored
+    GlobalAssetWatcher().reloadChangedFiles({ changedPath, "models/readme.txt" });
+
+    auto reloadedModel = algorithm::findChildModel(changedEntity);
+    ASSERT_TRUE(reloadedModel);
+    EXPECT_NE(reloadedModel, changedModel) << "The model should have been reloaded";
+    EXPECT_EQ(reloadedModel->getIModel().getModelPath(), changedPath);
+    EXPECT_EQ(algorithm::findChildModel(unchangedEntity), unchangedModel) << "The other model should be untouched";
+}
+
 TEST_F(ModelTest, ModelKeyReferencesModelDef)
 {
     auto funcStatic = algorithm::createEntityByClassName("func_static");
@@ -699,6 +757,224 @@ TEST_F(ModelTest, ModelOriginIsPreservedAfterDefChange)
         << "Translation changed after reloading the def, was " << translation << ", it changed to " << newTranslation;
 }
 
+namespace
+{
+
+inline std::size_t getGeometryIdOfFirstSurface(const scene::INodePtr& node)
+{
+    const auto& surface = Node_getModel(node)->getIModel().getSurface(0);
+    return static_cast<const model::IIndexedModelSurface&>(surface).getGeometryId();
+}
+
+}
+
+// Instances of the same static model share their geometry, until scaled individually
+TEST_F(ModelTest, StaticModelInstancesShareGeometryId)
+{
+    auto first = GlobalModelCache().getModelNode("models/darkmod/test/unit_cube.ase");
+    auto second = GlobalModelCache().getModelNode("models/darkmod/test/unit_cube.ase");
+    auto other = GlobalModelCache().getModelNode("models/darkmod/test/unit_cube.lwo");
+
+    auto firstId = getGeometryIdOfFirstSurface(first);
+    EXPECT_NE(firstId, 0) << "Static model surfaces should be shareable";
+    EXPECT_EQ(getGeometryIdOfFirstSurface(second), firstId) << "Instances should share the geometry ID";
+    EXPECT_NE(getGeometryIdOfFirstSurface(other), firstId) << "Different models should not share the geometry ID";
+
+    auto transformable = scene::node_cast<ITransformable>(second);
+    ASSERT_TRUE(transformable);
+
+    transformable->setType(TRANSFORM_PRIMITIVE);
+    transformable->setScale(Vector3(2, 2, 2));
+    transformable->freezeTransform();
+
+    EXPECT_NE(getGeometryIdOfFirstSurface(second), firstId) << "Scaled instance should get its own geometry";
+    EXPECT_EQ(getGeometryIdOfFirstSurface(first), firstId) << "Unscaled instance should keep its geometry ID";
+}
+
+// Models which are not used by any node are evicted if the cache exceeds its budget
+TEST_F(ModelTest, ModelCacheEvictsUnusedModels)
+{
+    const std::string asePath("models/darkmod/test/unit_cube.ase");
+    const std::string lwoPath("models/darkmod/test/unit_cube.lwo");
+
+    // Without a budget every model stays cached
+    registry::setValue(model::RKEY_MODEL_CACHE_BUDGET, 0);
+    GlobalModelCache().clear();
+
+    std::weak_ptr<model::IModel> unusedModel = GlobalModelCache().getModel(asePath);
+    auto lwoModel = GlobalModelCache().getModel(lwoPath);
+
+    EXPECT_FALSE(unusedModel.expired()) << "Model should still be cached";
+
+    // A budget of 1 KB is exceeded by these two models
+    registry::setValue(model::RKEY_MODEL_CACHE_BUDGET, 1.0 / 1024);
+    EXPECT_TRUE(unusedModel.expired()) << "Unused model should have been evicted";
+    EXPECT_EQ(GlobalModelCache().getModel(lwoPath), lwoModel) << "Used model should not be evicted";
+
+    // Models with a node in use are kept, the others are evicted
+    auto node = GlobalModelCache().getModelNode(asePath);
+    std::weak_ptr<model::IModel> usedModel = GlobalModelCache().getModel(asePath);
+
+    unusedModel = lwoModel;
+    lwoModel.reset();
+
+    GlobalModelCache().getModelNode("models/md5/flag01.md5mesh");
+
+    EXPECT_TRUE(unusedModel.expired()) << "Unused model should have been evicted";
+    EXPECT_FALSE(usedModel.expired()) << "Model used by a node should not be evicted";
+
+    registry::setValue(model::RKEY_MODEL_CACHE_BUDGET, 1024);
+}
+
+// Models requested asynchronously are represented by a placeholder until they are loaded
+TEST_F(ModelTest, AsyncModelLoadingReturnsPlaceholder)
+{
+    const std::string modelPath("models/md5/flag01.md5mesh");
+
+    GlobalModelCache().clear();
+    GlobalModelCache().setAsyncLoadingEnabled(true);
+
+    std::atomic<bool> loadFinished(false);
+    auto finishedConn = GlobalModelCache().signal_asyncLoadFinished().connect([&]() { loadFinished = true; });
+
+    scene::INodePtr loadedPlaceholder;
+    auto placeholder = GlobalModelCache().getModelNodeAsync(modelPath, [&](const scene::INodePtr& node)
+    {
+        loadedPlaceholder = node;
+    });
+
+    ASSERT_TRUE(placeholder);
+    EXPECT_TRUE(Node_getModel(placeholder)) << "Placeholder should be a model node";
+    EXPECT_FALSE(std::dynamic_pointer_cast<SkinnedModel>(placeholder)) << "Placeholder should be a NullModel";
+    EXPECT_TRUE(GlobalModelCache().isModelLoading(modelPath)) << "Model should be reported as loading";
+
+    // Wait for the worker, the listener is invoked on the main thread only
+    for (int i = 0; i < 1000 && !loadFinished; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    ASSERT_TRUE(loadFinished) << "Model has not been loaded in the background";
+    EXPECT_FALSE(loadedPlaceholder) << "Listener should not be invoked before processAsyncLoads()";
+
+    GlobalModelCache().processAsyncLoads();
+    EXPECT_EQ(loadedPlaceholder, placeholder) << "Listener should have received its placeholder";
+    EXPECT_FALSE(GlobalModelCache().isModelLoading(modelPath)) << "Model should not be loading anymore";
+
+    // The model is cached now, the real node is returned right away
+    auto modelNode = GlobalModelCache().getModelNodeAsync(modelPath, [&](const scene::INodePtr&)
+    {
+        FAIL() << "Listener should not be invoked for cached models";
+    });
+
+    ASSERT_TRUE(std::dynamic_pointer_cast<SkinnedModel>(modelNode)) << "Expected the MD5 model node";
+    EXPECT_EQ(Node_getModel(modelNode)->getIModel().getPolyCount(), 96);
+    EXPECT_EQ(&Node_getModel(modelNode)->getIModel(), GlobalModelCache().getModel(modelPath).get()) <<
+        "Model node should use the cached model";
+
+    finishedConn.disconnect();
+    GlobalModelCache().setAsyncLoadingEnabled(false);
+}
+
+// Changing the load focus re-orders the queue, all queued models are still delivered
+TEST_F(ModelTest, AsyncModelLoadingWithFocus)
+{
+    const std::vector<std::string> modelPaths
+    {
+        "models/ase/testcube.ase",
+        "models/ase/testsphere.ase",
+        "models/ase/tiles.ase",
+        "models/darkmod/test/unit_cube.lwo",
+    };
+
+    GlobalModelCache().clear();
+    GlobalModelCache().setAsyncLoadingEnabled(true);
+
+    std::set<scene::INodePtr> loadedPlaceholders;
+    std::vector<scene::INodePtr> placeholders;
+
+    for (const auto& modelPath : modelPaths)
+    {
+        placeholders.push_back(GlobalModelCache().getModelNodeAsync(modelPath, [&](const scene::INodePtr& node)
+        {
+            loadedPlaceholders.insert(node);
+        }));
+    }
+
+    GlobalModelCache().setAsyncLoadFocus(Vector3(1024, 0, 0));
+
+    auto isLoading = [&]()
+    {
+        return std::any_of(modelPaths.begin(), modelPaths.end(),
+            [](const std::string& path) { return GlobalModelCache().isModelLoading(path); });
+    };
+
+    for (int i = 0; i < 1000 && isLoading(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        GlobalModelCache().processAsyncLoads();
+    }
+
+    EXPECT_FALSE(isLoading()) << "Models have not been loaded in the background";
+    EXPECT_EQ(loadedPlaceholders, std::set<scene::INodePtr>(placeholders.begin(), placeholders.end()))
+        << "Every listener should have received its placeholder";
+
+    for (const auto& modelPath : modelPaths)
+    {
+        EXPECT_TRUE(GlobalModelCache().getModel(modelPath)) << modelPath << " should be cached";
+    }
+
+    GlobalModelCache().setAsyncLoadFocus(Vector3(0, 0, 0));
+    GlobalModelCache().setAsyncLoadingEnabled(false);
+}
+
+// The compressed frames of an md5anim should decode to the parsed values
+TEST_F(ModelTest, MD5AnimFrameDecoding)
+{
+    auto anim = GlobalAnimationCache().getAnim("models/md5/flag01_wave.md5anim");
+    ASSERT_TRUE(anim);
+    EXPECT_EQ(GlobalAnimationCache().getAnim("models/md5/flag01_wave.md5anim"), anim) << "Anim should be cached";
+
+    EXPECT_EQ(anim->getNumJoints(), 14);
+    EXPECT_EQ(anim->getNumFrames(), 5);
+
+    // Frame 4, the last two components have the same value in every frame
+    auto keys = anim->getFrameKeys(4);
+    ASSERT_EQ(keys.size(), 6);
+
+    EXPECT_NEAR(keys[0], -67.658241, 0.001);
+    EXPECT_NEAR(keys[1], 0, 0.001);
+    EXPECT_NEAR(keys[2], 0.1, 0.0001);
+    EXPECT_NEAR(keys[3], -0.2, 0.0001);
+    EXPECT_FLOAT_EQ(keys[4], 0.05f);
+    EXPECT_FLOAT_EQ(keys[5], 0.25f);
+
+    // The joint keys apply the frame values to the base frame
+    auto jointKeys = anim->getFrameJointKeys(2);
+    ASSERT_TRUE(jointKeys);
+    ASSERT_EQ(jointKeys->size(), 14);
+
+    const auto& root = (*jointKeys)[1];
+    EXPECT_NEAR(root.origin.x(), -69.658241, 0.001);
+    EXPECT_NEAR(root.origin.y(), 0, 0.001) << "Non-animated component should keep the base frame value";
+    EXPECT_NEAR(root.origin.z(), 2.5, 0.001);
+
+    const auto& up5 = (*jointKeys)[7];
+    EXPECT_NEAR(up5.orientation.x(), 0.05, 0.0001);
+    EXPECT_NEAR(up5.orientation.y(), -0.1, 0.0001);
+    EXPECT_NEAR(up5.orientation.z(), 0.05, 0.0001);
+    EXPECT_NEAR(up5.orientation.getVector3().getLengthSquared() + up5.orientation.w() * up5.orientation.w(), 1.0, 0.0001) <<
+        "Orientation should be a unit quaternion";
+
+    const auto& do5 = (*jointKeys)[13];
+    EXPECT_FLOAT_EQ(do5.orientation.y(), 0.25f);
+
+    // Non-animated joints are equal to the base frame
+    EXPECT_EQ((*jointKeys)[3].origin, anim->getBaseFrameKey(3).origin);
+
+    EXPECT_EQ(anim->getFrameJointKeys(2), jointKeys) << "Joint keys should be cached";
+}
+
 // an .obj file with usemtl directly referring to the material name
 TEST_F(ObjImportTest, UseMtlReferencingMaterial)
 {
@@ -2,6 +2,15 @@
 
 #include "iparticles.h"
 #include "iparticlestage.h"
+#include "iparticlenode.h"
+#include "ientity.h"
+#include "imap.h"
+#include "irendersystemfactory.h"
+#include "registry/registry.h"
+#include "render/View.h"
+#include "render/CameraView.h"
+#include "scenelib.h"
+#include "algorithm/Scene.h"
 #include "os/path.h"
 #include "string/replace.h"
 #include "algorithm/FileUtils.h"
@@ -539,4 +548,73 @@ TEST_F(ParticlesTest, AcquireParticleNode)
     EXPECT_TRUE(GlobalParticlesManager().createParticleNode("firefly_blue_in_pk4"));
 }
 
+namespace
+{
+
+// A camera view placed at the given distance in front of the given point, looking at it
+render::View createViewLookingAt(const Vector3& origin, double distance)
+{
+    render::View view(true);
+
+    view.construct(camera::calculateProjectionMatrix(1.0f, 65536.0f, 90.0f, 640, 480),
+        camera::calculateModelViewMatrix(origin - Vector3(distance, 0, 0), Vector3(0, 0, 0)), 640, 480);
+
+    return view;
+}
+
+}
+
+TEST_F(ParticlesTest, DistantParticleNodesUseReducedDetail)
+{
+    registry::setValue(particles::RKEY_ENABLE_PARTICLE_LOD, true);
+    registry::setValue(particles::RKEY_PARTICLE_BUDGET, 0);
+
+    auto emitter = GlobalEntityModule().createEntityFromSelection("func_emitter", Vector3(0, 0, 0));
+    scene::addNodeToContainer(emitter, GlobalMapModule().getRoot());
+    emitter->getEntity().setKeyValue("model", "tdm_fire_torch.prt");
+
+    auto particleNode = algorithm::getNthChild(emitter, 0);
+    ASSERT_TRUE(particles::isParticleNode(particleNode)) << "func_emitter should have a particle node as child";
+
+    RenderSystemPtr backend = GlobalRenderSystemFactory().createRenderSystem();
+    emitter->setRenderSystem(backend);
+
+    // A close view updates the particle in full detail
+    auto statistics = GlobalParticlesManager().getLodStatistics();
+    particleNode->onPreRender(createViewLookingAt(Vector3(0, 0, 0), 64));
+
+    auto closeStatistics = GlobalParticlesManager().getLodStatistics();
+    EXPECT_EQ(closeStatistics.numEmitters, statistics.numEmitters + 1);
+    EXPECT_EQ(closeStatistics.numFullDetail, statistics.numFullDetail + 1);
+    EXPECT_EQ(closeStatistics.numParticlesSimulated - statistics.numParticlesSimulated,
+        closeStatistics.numParticlesRequested - statistics.numParticlesRequested);
+
+    auto numParticlesTotal = closeStatistics.numParticlesSimulated - statistics.numParticlesSimulated;
+    EXPECT_GT(numParticlesTotal, 0);
+
+    // A distant view is simulating fewer particles
+    particleNode->onPreRender(createViewLookingAt(Vector3(0, 0, 0), 20000));
+
+    auto distantStatistics = GlobalParticlesManager().getLodStatistics();
+    EXPECT_EQ(distantStatistics.numReducedDetail, closeStatistics.numReducedDetail + 1);
+    EXPECT_LT(distantStatistics.numParticlesSimulated - closeStatistics.numParticlesSimulated, numParticlesTotal);
+
+    // Nothing changed since the last update, the distant particle keeps its geometry
+    particleNode->onPreRender(createViewLookingAt(Vector3(0, 0, 0), 20000));
+
+    auto skippedStatistics = GlobalParticlesManager().getLodStatistics();
+    EXPECT_EQ(skippedStatistics.numSkippedUpdates, distantStatistics.numSkippedUpdates + 1);
+    EXPECT_EQ(skippedStatistics.numParticlesSimulated, distantStatistics.numParticlesSimulated);
+
+    // Exhausting the budget limits the particles of the next update
+    registry::setValue(particles::RKEY_PARTICLE_BUDGET, static_cast<int>(skippedStatistics.numParticlesSimulated + 1));
+    particleNode->onPreRender(createViewLookingAt(Vector3(0, 0, 0), 64));
+
+    auto budgetStatistics = GlobalParticlesManager().getLodStatistics();
+    EXPECT_EQ(budgetStatistics.numBudgetLimited, skippedStatistics.numBudgetLimited + 1);
+    EXPECT_LE(budgetStatistics.numParticlesSimulated, skippedStatistics.numParticlesSimulated + 1);
+
+    emitter->setRenderSystem(RenderSystemPtr());
+}
+
 }
@@ -2,6 +2,7 @@
 
 #include "imap.h"
 #include "ipatch.h"
+#include "iundo.h"
 #include "igrid.h"
 #include "iselection.h"
 #include "scenelib.h"
@@ -33,6 +34,42 @@ void selectSinglePatchVertexAt(const Vector3& position)
         << "1 additional vertex component should be selected now";
 }
 
+std::vector<PatchControl> getControlPoints(const IPatch& patch)
+{
+    std::vector<PatchControl> controls;
+
+    for (std::size_t row = 0; row < patch.getHeight(); ++row)
+    {
+        for (std::size_t col = 0; col < patch.getWidth(); ++col)
+        {
+            controls.push_back(patch.ctrlAt(row, col));
+        }
+    }
+
+    return controls;
+}
+
+void expectControlPoints(const IPatch& patch, const std::vector<PatchControl>& expected)
+{
+    auto controls = getControlPoints(patch);
+    ASSERT_EQ(controls.size(), expected.size()) << "Control point count mismatch";
+
+    for (std::size_t i = 0; i < controls.size(); ++i)
+    {
+        EXPECT_TRUE(math::isNear(controls[i].vertex, expected[i].vertex, 0.001)) << "Vertex " << i << " mismatch";
+        EXPECT_TRUE(math::isNear(controls[i].texcoord, expected[i].texcoord, 0.001)) << "Texcoord " << i << " mismatch";
+    }
+}
+
+void moveControlPoint(IPatch& patch, std::size_t row, std::size_t col, const Vector3& offset)
+{
+    UndoableCommand cmd("moveControlPoint");
+
+    patch.undoSave();
+    patch.ctrlAt(row, col).vertex += offset;
+    patch.controlPointsChanged();
+}
+
 }
 
 // Checks that snapping a single selected patch vertex is working
@@ -97,4 +134,73 @@ TEST_F(PatchTest, VertexSnappingIsUndoable)
     EXPECT_TRUE(math::isNear(ctrl.vertex, vertexBeforeSnapping, 0.01)) << "Vertex should be reverted and off-grid again";
 }
 
+// Patch states are saved relative to the previous state, restoring any of them must be exact
+TEST_F(PatchTest, SequentialChangesAreUndoable)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB({ 0,0,0 }, { 64, 64, 64 }));
+    auto patch = Node_getIPatch(patchNode);
+
+    std::vector<std::vector<PatchControl>> states{ getControlPoints(*patch) };
+
+    // Change a single vertex, followed by all texture coordinates and another vertex
+    moveControlPoint(*patch, 0, 0, Vector3(8, 0, 0));
+    states.emplace_back(getControlPoints(*patch));
+
+    {
+        UndoableCommand cmd("translateTexture");
+        patch->translateTexture(13, 11);
+    }
+    states.emplace_back(getControlPoints(*patch));
+
+    moveControlPoint(*patch, 1, 1, Vector3(0, 0, 16));
+    states.emplace_back(getControlPoints(*patch));
+
+    for (auto i = states.size() - 1; i > 0; --i)
+    {
+        GlobalUndoSystem().undo();
+        expectControlPoints(*patch, states[i - 1]);
+    }
+
+    for (std::size_t i = 1; i < states.size(); ++i)
+    {
+        GlobalUndoSystem().redo();
+        expectControlPoints(*patch, states[i]);
+    }
+}
+
+// Operations deep down in the undo history are compressed, they need to be restored all the same
+TEST_F(PatchTest, CompressedUndoStatesAreRestored)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB({ 0,0,0 }, { 64, 64, 64 }));
+    auto patch = Node_getIPatch(patchNode);
+
+    std::vector<std::vector<PatchControl>> states{ getControlPoints(*patch) };
+
+    // Move all control points in each step, to have every state stored as keyframe
+    for (int i = 0; i < 80; ++i)
+    {
+        UndoableCommand cmd("moveControlPoints");
+        patch->undoSave();
+
+        for (std::size_t row = 0; row < patch->getHeight(); ++row)
+        {
+            for (std::size_t col = 0; col < patch->getWidth(); ++col)
+            {
+                patch->ctrlAt(row, col).vertex += Vector3(1, 2, 3);
+            }
+        }
+
+        patch->controlPointsChanged();
+        states.emplace_back(getControlPoints(*patch));
+    }
+
+    for (auto i = states.size() - 1; i > 0; --i)
+    {
+        GlobalUndoSystem().undo();
+        expectControlPoints(*patch, states[i - 1]);
+    }
+}
+
 }
@@ -42,6 +42,25 @@ TEST_F(PointTraceTest, ConstructPointTraceWithData)
     EXPECT_EQ(ps[4], Vector3(544, 64, 112));
 }
 
+TEST_F(PointTraceTest, StreamPointTraceStopsAtInvalidData)
+{
+    std::istringstream iss("544 64 112\r\n"
+                           "  544.5\t64 -240\n"
+                           "\n"
+                           "512 64 +240\n"
+                           "512 nonsense 112\n"
+                           "544 64 112\n");
+
+    std::vector<Vector3> points;
+    map::PointTrace::ForEachPoint(iss, [&](const Vector3& point) { points.push_back(point); });
+
+    // Parsing should stop at the first component which is not a number
+    ASSERT_EQ(points.size(), 3);
+    EXPECT_EQ(points[0], Vector3(544, 64, 112));
+    EXPECT_EQ(points[1], Vector3(544.5, 64, -240));
+    EXPECT_EQ(points[2], Vector3(512, 64, 240));
+}
+
 namespace
 {
 
@@ -1,12 +1,21 @@
 #include "RadiantTest.h"
 
 #include "icommandsystem.h"
+#include "imapresource.h"
+#include "itaskscheduler.h"
 #include "ispeakernode.h"
 #include "ilightnode.h"
 #include "ibrush.h"
 #include "scene/PrefabBoundsAccumulator.h"
 #include "os/path.h"
 #include "algorithm/Scene.h"
+#include "testutil/TemporaryFile.h"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 
 namespace test
 {
@@ -119,4 +128,181 @@ TEST_F(PrefabTest, PrefabInsertPositionWithoutOriginCorrection)
     EXPECT_EQ(brush->worldAABB().getOrigin(), Vector3(128, 0, 0));
 }
 
+
+TEST_F(PrefabTest, PlacePrefabRepeatedly)
+{
+    fs::path prefabPath = _context.getTestProjectPath();
+    prefabPath /= "prefabs/large_bounds.pfbx";
+
+    // Every placement is an independent copy of the prefab
+    for (int i = 0; i < 3; ++i)
+    {
+        GlobalCommandSystem().executeCommand("LoadPrefabAt",
+                                             {prefabPath.string(), Vector3(i * 1024, 0, 0), 1});
+    }
+
+    std::vector<scene::INodePtr> lights;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (Node_getLightNode(node))
+        {
+            lights.push_back(node);
+        }
+
+        return true;
+    });
+
+    ASSERT_EQ(lights.size(), 3);
+
+    std::unordered_set<std::string> names;
+
+    for (std::size_t i = 0; i < lights.size(); ++i)
+    {
+        names.insert(Node_getEntity(lights[i])->getKeyValue("name"));
+
+        // The placements are corrected by the same prefab bounds
+        EXPECT_EQ(lights[i]->worldAABB().getOrigin().y(), 0);
+        EXPECT_EQ(std::fmod(lights[i]->worldAABB().getOrigin().x(), 1024.0), 0);
+    }
+
+    EXPECT_EQ(names.size(), 3) << "The placed entities should have unique names";
+}
+
+TEST_F(PrefabTest, PlacePrefabAfterFileChange)
+{
+    auto writePrefab = [](const std::string& path, const std::string& classname)
+    {
+        std::ofstream stream(path, std::ios::trunc);
+        stream << "Version 2\n// entity 0\n{\n\"classname\" \"worldspawn\"\n}\n";
+        stream << "// entity 1\n{\n\"classname\" \"" << classname << "\"\n\"origin\" \"0 0 0\"\n}\n";
+    };
+
+    auto countEntities = [](const std::string& classname)
+    {
+        std::size_t count = 0;
+
+        GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+        {
+            if (auto entity = Node_getEntity(node); entity && entity->getKeyValue("classname") == classname)
+            {
+                ++count;
+            }
+
+            return true;
+        });
+
+        return count;
+    };
+
+    fs::path prefabPath = _context.getTemporaryDataPath();
+    prefabPath /= "changing.pfb";
+    TemporaryFile tempFile(prefabPath.string(), "");
+
+    writePrefab(prefabPath.string(), "info_player_start");
+    GlobalCommandSystem().executeCommand("LoadPrefabAt", { prefabPath.string(), Vector3(0, 0, 0), 0 });
+
+    EXPECT_EQ(countEntities("info_player_start"), 1);
+
+    // Change the file and make sure the modification time is different
+    auto modificationTime = fs::last_write_time(prefabPath);
+    writePrefab(prefabPath.string(), "light");
+    fs::last_write_time(prefabPath, modificationTime + std::chrono::seconds(10));
+
+    GlobalCommandSystem().executeCommand("LoadPrefabAt", { prefabPath.string(), Vector3(0, 0, 0), 0 });
+
+    EXPECT_EQ(countEntities("info_player_start"), 1) << "The cached prefab should not have been used";
+    EXPECT_EQ(countEntities("light"), 1) << "The changed prefab should have been loaded";
+}
+
+TEST_F(PrefabTest, ImportManyNamedEntitiesBenchmark)
+{
+    constexpr int NumEntities = 10000;
+
+    // A prefab of func_statics named like the ones created by the editor
+    std::ostringstream prefab;
+    prefab << "Version 2\n";
+    prefab << "// entity 0\n{\n\"classname\" \"worldspawn\"\n}\n";
+
+    for (int i = 1; i <= NumEntities; ++i)
+    {
+        prefab << "// entity " << i << "\n{\n\"classname\" \"func_static\"\n";
+        prefab << "\"name\" \"func_static_" << i << "\"\n";
+        prefab << "\"origin\" \"" << i * 8 << " 0 0\"\n}\n";
+    }
+
+    fs::path prefabPath = _context.getTemporaryDataPath();
+    prefabPath /= "many_entities.pfb";
+    TemporaryFile tempFile(prefabPath.string(), prefab.str());
+
+    GlobalCommandSystem().executeCommand("LoadPrefabAt", { prefabPath.string(), Vector3(0, 0, 0), 1 });
+
+    // The second import is conflicting with every existing name
+    auto start = std::chrono::steady_clock::now();
+    GlobalCommandSystem().executeCommand("LoadPrefabAt", { prefabPath.string(), Vector3(0, 0, 0), 1 });
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    std::unordered_set<std::string> names;
+    std::size_t numFuncStatics = 0;
+
+    GlobalMapModule().getRoot()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity && entity->getKeyValue("classname") == "func_static")
+        {
+            ++numFuncStatics;
+            names.insert(entity->getKeyValue("name"));
+        }
+
+        return true;
+    });
+
+    EXPECT_EQ(numFuncStatics, 2 * NumEntities);
+    EXPECT_EQ(names.size(), numFuncStatics) << "Imported names are not unique";
+    EXPECT_TRUE(algorithm::getEntityByName(GlobalMapModule().getRoot(), "func_static_" + std::to_string(2 * NumEntities)));
+
+    std::cout << "[ Prefab ] Importing " << NumEntities << " conflicting entity names: " <<
+        duration.count() << " msec" << std::endl;
+}
+
+TEST_F(PrefabTest, PreloadPrefabInBackground)
+{
+    fs::path prefabPath = _context.getTestProjectPath();
+    prefabPath /= "prefabs/large_bounds.pfbx";
+
+    std::vector<std::string> preloadedPaths;
+    auto connection = GlobalMapResourceManager().signal_prefabPreloaded().connect(
+        [&](const std::string& path) { preloadedPaths.push_back(path); });
+
+    EXPECT_FALSE(GlobalMapResourceManager().isPrefabCached(prefabPath.string()));
+
+    GlobalMapResourceManager().preloadPrefab(prefabPath.string());
+
+    // Queueing the same prefab again is not starting another load
+    GlobalMapResourceManager().preloadPrefab(prefabPath.string());
+
+    // The scene is created by the main thread, once the worker has read the file
+    auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+
+    while (preloadedPaths.empty() && std::chrono::steady_clock::now() < timeout)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        GlobalTaskScheduler().processMainThreadTasks();
+    }
+
+    connection.disconnect();
+
+    ASSERT_EQ(preloadedPaths, std::vector<std::string>({ prefabPath.string() })) << "Prefab should have been preloaded once";
+    EXPECT_TRUE(GlobalMapResourceManager().isPrefabCached(prefabPath.string()));
+
+    // The preloaded scene is handed out as copy
+    auto copy = GlobalMapResourceManager().createPrefabCopy(prefabPath.string());
+
+    auto numSpeakers = algorithm::getChildCount(copy, [](const scene::INodePtr& node)
+    {
+        return Node_getSpeakerNode(node) != nullptr;
+    });
+
+    EXPECT_EQ(numSpeakers, 1) << "The preloaded prefab should contain its speaker";
+}
+
 }
@@ -59,6 +59,7 @@ protected:
 
 			module::RegistryReference::Instance().setRegistry(radiant->getModuleRegistry());
 			module::initialiseStreams(radiant->getLogWriter());
+			util::GlobalTraceRecorderPtr() = &radiant->getModuleRegistry().getTraceRecorder();
 
             initTestLog();
 		}
@@ -0,0 +1,88 @@
+#include "RadiantTest.h"
+
+#include "iregistry.h"
+#include "registry/registry.h"
+
+namespace test
+{
+
+using RegistryTest = RadiantTest;
+
+namespace
+{
+    const std::string TestKey = "user/ui/registryTest/value";
+}
+
+TEST_F(RegistryTest, GetReturnsValueAfterSet)
+{
+    GlobalRegistry().set(TestKey, "1");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "1");
+
+    // The second query is served from the cache, the set() call must invalidate it
+    GlobalRegistry().set(TestKey, "2");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "2");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "2");
+}
+
+TEST_F(RegistryTest, GetReturnsEmptyStringAfterDelete)
+{
+    GlobalRegistry().set(TestKey, "1");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "1");
+
+    GlobalRegistry().deleteXPath(TestKey);
+
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "");
+    EXPECT_FALSE(GlobalRegistry().keyExists(TestKey));
+}
+
+TEST_F(RegistryTest, GetReturnsValueAfterCreatingKey)
+{
+    // Query the non-existent key first, this empty result is cached too
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "");
+
+    auto node = GlobalRegistry().createKey(TestKey);
+    node.setAttributeValue("value", "3");
+
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "3");
+}
+
+TEST_F(RegistryTest, GetReturnsValueChangedThroughNode)
+{
+    GlobalRegistry().set(TestKey, "1");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "1");
+
+    auto nodes = GlobalRegistry().findXPath(TestKey);
+    ASSERT_FALSE(nodes.empty());
+
+    nodes.front().setAttributeValue("value", "4");
+
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "4");
+}
+
+TEST_F(RegistryTest, GetReturnsValueAfterSetAttribute)
+{
+    GlobalRegistry().set(TestKey, "1");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "1");
+
+    GlobalRegistry().setAttribute(TestKey, "value", "5");
+
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "5");
+}
+
+TEST_F(RegistryTest, KeySignalObserversSeeNewValue)
+{
+    GlobalRegistry().set(TestKey, "1");
+    EXPECT_EQ(GlobalRegistry().get(TestKey), "1");
+
+    std::string observedValue;
+    GlobalRegistry().signalForKey(TestKey).connect([&]()
+    {
+        observedValue = GlobalRegistry().get(TestKey);
+    });
+
+    registry::setValue(TestKey, 6);
+
+    EXPECT_EQ(observedValue, "6");
+}
+
+}
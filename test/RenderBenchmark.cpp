@@ -0,0 +1,212 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include "icameraview.h"
+#include "irender.h"
+#include "iscenegraph.h"
+#include "registry/registry.h"
+#include "render/CamRenderer.h"
+#include "render/FrameBuffer.h"
+#include "render/RenderableCollectionWalker.h"
+#include "render/View.h"
+#include "math/pi.h"
+#include "fmt/format.h"
+
+namespace test
+{
+
+/**
+ * Renders the reference maps along a scripted camera path into an offscreen
+ * buffer, once with the fullbright and once with the lighting mode renderer,
+ * and writes the CPU and GPU times and the renderer statistics of every frame
+ * to a JSON file, such that the results can be compared across versions.
+ *
+ * The benchmark is built into its own executable (drbenchmark), which is not
+ * part of the regular test run. The output file can be set through the
+ * DR_RENDER_BENCHMARK_OUTPUT environment variable, it defaults to
+ * render_benchmark.json in the cache folder.
+ */
+class RenderBenchmark :
+    public RadiantTest
+{
+protected:
+    static constexpr int Width = 1280;
+    static constexpr int Height = 720;
+
+    // Number of frames rendered along the camera path of each map
+    static constexpr std::size_t FramesPerMap = 120;
+
+    struct FrameResult
+    {
+        double cpuMilliseconds = 0;
+        double gpuMilliseconds = 0;
+        std::map<std::string, std::size_t> counters;
+    };
+
+    // The JSON objects of the finished runs
+    std::vector<std::string> _runs;
+
+    void preShutdown() override
+    {
+        writeResults();
+    }
+
+    void runMap(const std::string& mapFile)
+    {
+        loadMap(mapFile);
+
+        runCameraPath(mapFile, "fullbright", false);
+
+        if (GlobalRenderSystem().shaderProgramsAvailable())
+        {
+            runCameraPath(mapFile, "lighting", true);
+        }
+    }
+
+private:
+    // Orbits the camera around the center of the map, looking at its center
+    void runCameraPath(const std::string& mapFile, const std::string& rendererName, bool lightingMode)
+    {
+        auto frameBuffer = render::FrameBuffer::CreateColourBuffer(Width, Height);
+        ASSERT_TRUE(frameBuffer) << "Failed to create the offscreen frame buffer";
+
+        render::View view(true);
+        auto camera = GlobalCameraManager().createCamera(view, [](bool) {});
+        camera->setDeviceDimensions(Width, Height);
+
+        render::CamRenderer::HighlightShaders highlightShaders;
+
+        const auto& mapBounds = GlobalSceneGraph().root()->worldAABB();
+        auto center = mapBounds.isValid() ? mapBounds.getOrigin() : Vector3(0, 0, 0);
+        auto radius = std::max(mapBounds.isValid() ? mapBounds.getExtents().getLength() : 0.0, 256.0);
+
+        frameBuffer->bind();
+        glViewport(0, 0, Width, Height);
+
+        std::vector<FrameResult> frames;
+
+        for (std::size_t frame = 0; frame < FramesPerMap; ++frame)
+        {
+            auto angle = 2 * math::PI * frame / FramesPerMap;
+            auto origin = center + Vector3(cos(angle), sin(angle), 0.3) * radius;
+            auto direction = center - origin;
+
+            Vector3 angles(0, 0, 0);
+            angles[camera::CAMERA_PITCH] = radians_to_degrees(atan2(direction.z(), sqrt(direction.x() * direction.x() + direction.y() * direction.y())));
+            angles[camera::CAMERA_YAW] = radians_to_degrees(atan2(direction.y(), direction.x()));
+
+            camera->setOriginAndAngles(origin, angles);
+
+            frames.emplace_back(renderFrame(view, highlightShaders, lightingMode));
+        }
+
+        frameBuffer->unbind();
+
+        GlobalCameraManager().destroyCamera(camera);
+
+        addRun(mapFile, rendererName, frames);
+    }
+
+    FrameResult renderFrame(render::View& view, const render::CamRenderer::HighlightShaders& highlightShaders,
+        bool lightingMode)
+    {
+        // Same flags as used by the camera window in textured and lighting mode
+        unsigned int allowedRenderFlags = RENDER_DEPTHTEST | RENDER_MASKCOLOUR | RENDER_DEPTHWRITE |
+            RENDER_ALPHATEST | RENDER_BLEND | RENDER_CULLFACE | RENDER_OFFSETLINE | RENDER_VERTEX_COLOUR |
+            RENDER_FILL | RENDER_LIGHTING | RENDER_TEXTURE_2D | RENDER_SMOOTH | RENDER_SCALED;
+
+        if (lightingMode)
+        {
+            allowedRenderFlags |= RENDER_TEXTURE_CUBEMAP | RENDER_BUMP | RENDER_PROGRAM;
+        }
+
+        glDepthMask(GL_TRUE);
+        glClearColor(0, 0, 0, 0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        view.resetCullStats();
+
+        auto start = std::chrono::steady_clock::now();
+
+        GlobalRenderSystem().startFrame();
+
+        render::CamRenderer renderer(view, highlightShaders);
+        renderer.prepare();
+
+        render::RenderableCollectionWalker::CollectRenderablesInScene(renderer, view);
+
+        auto result = lightingMode ?
+            GlobalRenderSystem().renderLitScene(allowedRenderFlags, view) :
+            GlobalRenderSystem().renderFullBrightScene(RenderViewType::Camera, allowedRenderFlags, view);
+
+        renderer.cleanup();
+
+        GlobalRenderSystem().endFrame();
+
+        FrameResult frame;
+
+        frame.cpuMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        frame.gpuMilliseconds = result->getGpuMilliseconds();
+        frame.counters = result->getCounters();
+
+        return frame;
+    }
+
+    void addRun(const std::string& mapFile, const std::string& rendererName, const std::vector<FrameResult>& frames)
+    {
+        std::string framesJson;
+
+        for (const auto& frame : frames)
+        {
+            std::string counters;
+
+            for (const auto& [name, value] : frame.counters)
+            {
+                counters += fmt::format("{0}\"{1}\": {2}", counters.empty() ? "" : ", ", name, value);
+            }
+
+            framesJson += fmt::format("{0}\n        {{ \"cpuMs\": {1:.3f}, \"gpuMs\": {2:.3f}, \"counters\": {{ {3} }} }}",
+                framesJson.empty() ? "" : ",", frame.cpuMilliseconds, frame.gpuMilliseconds, counters);
+        }
+
+        _runs.emplace_back(fmt::format("    {{\n      \"map\": \"{0}\",\n      \"renderer\": \"{1}\",\n      \"width\": {2},\n      \"height\": {3},\n      \"frames\": [{4}\n      ]\n    }}",
+            mapFile, rendererName, Width, Height, framesJson));
+    }
+
+    void writeResults()
+    {
+        if (_runs.empty()) return;
+
+        auto outputPath = getenv("DR_RENDER_BENCHMARK_OUTPUT");
+        auto filename = outputPath != nullptr ? std::string(outputPath) : _context.getCacheDataPath() + "render_benchmark.json";
+
+        std::ofstream stream(filename, std::ios::trunc);
+
+        stream << "{\n  \"runs\": [\n";
+
+        for (std::size_t i = 0; i < _runs.size(); ++i)
+        {
+            stream << _runs[i] << (i + 1 < _runs.size() ? ",\n" : "\n");
+        }
+
+        stream << "  ]\n}\n";
+
+        std::cout << "Render benchmark results written to " << filename << std::endl;
+    }
+};
+
+TEST_F(RenderBenchmark, ReferenceMaps)
+{
+    // Measure the GPU time of the lighting mode passes
+    registry::setValue(RKEY_ENABLE_GPU_TIMING, true);
+
+    for (const auto& mapFile : { "altar.map", "general_purpose.mapx", "material_usage.map" })
+    {
+        runMap(mapFile);
+    }
+}
+
+}
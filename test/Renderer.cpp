@@ -3,9 +3,14 @@
 #include "ieclass.h"
 #include "ientity.h"
 #include "irender.h"
+#include "irenderableobject.h"
+#include "ishaders.h"
 #include "ilightnode.h"
 #include "math/Matrix4.h"
 #include "scenelib.h"
+#include "render/CameraView.h"
+#include "render/ScreenSpaceSize.h"
+#include "render/View.h"
 
 namespace test
 {
@@ -490,4 +495,166 @@ TEST_F(RenderSystemTest, AttachmentIsRegisteredAsLight)
     EXPECT_EQ(getLightCount(renderSystem), 1) << "Rendersystem should know of 1 light after removing the torch";
 }
 
+namespace
+{
+
+class TestRenderableObject final :
+    public render::IRenderableObject
+{
+public:
+    AABB bounds;
+    sigc::signal<void> sigBoundsChanged;
+
+    bool isVisible() override { return true; }
+    bool isOriented() override { return false; }
+    const Matrix4& getObjectTransform() override
+    {
+        static Matrix4 identity = Matrix4::getIdentity();
+        return identity;
+    }
+    const AABB& getObjectBounds() override { return bounds; }
+    sigc::signal<void>& signal_boundsChanged() override { return sigBoundsChanged; }
+    render::IGeometryStore::Slot getStorageLocation() override { return 0; }
+    bool isShadowCasting() override { return true; }
+};
+
+}
+
+TEST_F(RenderSystemTest, RenderableChangeCount)
+{
+    auto entity = createByClassName("func_static");
+
+    auto object = std::make_shared<TestRenderableObject>();
+    object->bounds = AABB({ 10, 20, 30 }, { 5, 5, 5 });
+
+    auto changeCount = entity->getRenderableChangeCount();
+
+    entity->addRenderable(object, nullptr);
+    EXPECT_GT(entity->getRenderableChangeCount(), changeCount) << "Adding a renderable should increase the counter";
+    EXPECT_TRUE(math::isNear(entity->getRenderableBounds().getOrigin(), object->bounds.getOrigin(), 0.01));
+    EXPECT_TRUE(math::isNear(entity->getRenderableBounds().getExtents(), object->bounds.getExtents(), 0.01));
+
+    // Moving the object should increase the counter and update the bounds
+    changeCount = entity->getRenderableChangeCount();
+    object->bounds = AABB({ -10, 20, 30 }, { 5, 5, 5 });
+    object->sigBoundsChanged.emit();
+
+    EXPECT_GT(entity->getRenderableChangeCount(), changeCount) << "Bounds change should increase the counter";
+    EXPECT_TRUE(math::isNear(entity->getRenderableBounds().getOrigin(), object->bounds.getOrigin(), 0.01));
+
+    // An unchanged entity keeps its counter
+    changeCount = entity->getRenderableChangeCount();
+    entity->getRenderableBounds();
+    EXPECT_EQ(entity->getRenderableChangeCount(), changeCount) << "Counter should not change without modifications";
+
+    entity->removeRenderable(object);
+    EXPECT_GT(entity->getRenderableChangeCount(), changeCount) << "Removing a renderable should increase the counter";
+    EXPECT_FALSE(entity->getRenderableBounds().isValid()) << "Bounds should be empty after removing the only object";
+}
+
+namespace
+{
+
+class TestShaderObserver :
+    public Shader::Observer
+{
+public:
+    std::size_t realiseCount = 0;
+    std::size_t unrealiseCount = 0;
+
+    void onShaderRealised() override
+    {
+        ++realiseCount;
+    }
+
+    void onShaderUnrealised() override
+    {
+        ++unrealiseCount;
+    }
+};
+
+}
+
+// Changing the expressions of a stage doesn't require the shader passes to be re-constructed
+TEST_F(RenderSystemTest, StageParameterChangeKeepsShaderPasses)
+{
+    auto material = GlobalMaterialManager().getMaterial("textures/numbers/1");
+    auto shader = GlobalRenderSystem().capture(material->getName());
+    ASSERT_TRUE(shader->isRealised());
+
+    // The first modification replaces the stages with the ones of the editable copy
+    auto layer = material->getEditableLayer(0);
+    layer->setColourExpressionFromString(IShaderLayer::COMP_RGB, "0.5");
+
+    TestShaderObserver observer;
+    shader->attachObserver(observer);
+    observer.realiseCount = 0;
+
+    layer->setColourExpressionFromString(IShaderLayer::COMP_RGB, "0.25");
+    EXPECT_EQ(observer.unrealiseCount, 0) << "Colour change should not re-construct the passes";
+    EXPECT_EQ(observer.realiseCount, 0) << "Colour change should not re-construct the passes";
+
+    material->setPolygonOffset(2.0f);
+    EXPECT_EQ(observer.unrealiseCount, 1) << "Polygon offset change should re-construct the passes";
+    EXPECT_EQ(observer.realiseCount, 1) << "Polygon offset change should re-construct the passes";
+
+    shader->detachObserver(observer);
+    material->revertModifications();
+}
+
+namespace
+{
+
+// An orthographic top-down view set up the same way as the XY view does it
+render::View createOrthoView(double scale, std::size_t width, std::size_t height)
+{
+    const double maxWorldCoord = 65536;
+
+    auto projection = Matrix4::getIdentity();
+    projection[0] = 1.0 / (width / 2);
+    projection[5] = 1.0 / (height / 2);
+    projection[10] = 1.0 / (maxWorldCoord * scale);
+    projection[14] = -1.0;
+
+    auto modelview = Matrix4::getIdentity();
+    modelview[0] = scale;
+    modelview[5] = scale;
+    modelview[10] = -scale;
+    modelview[14] = maxWorldCoord * scale;
+
+    render::View view;
+    view.construct(projection, modelview, width, height);
+
+    return view;
+}
+
+}
+
+TEST_F(RendererTest, ProjectedSizeInOrthoView)
+{
+    auto bounds = AABB(Vector3(100, 50, 0), Vector3(16, 8, 32));
+
+    // The larger screen extent is the 32 units along the x axis, the z axis points into the screen
+    auto view = createOrthoView(1.0, 800, 600);
+    EXPECT_TRUE(render::isOrthographicView(view));
+    EXPECT_NEAR(render::getProjectedSizeInPixels(view, bounds), 32, 1e-4);
+
+    auto zoomedOut = createOrthoView(0.125, 800, 600);
+    EXPECT_NEAR(render::getProjectedSizeInPixels(zoomedOut, bounds), 4, 1e-4);
+
+    // Invalid bounds have no size
+    EXPECT_EQ(render::getProjectedSizeInPixels(view, AABB()), -1);
+}
+
+TEST_F(RendererTest, ProjectedSizeInPerspectiveView)
+{
+    render::View view(true);
+    view.construct(camera::calculateProjectionMatrix(1.0f, 65536.0f, 90.0f, 640, 480),
+        camera::calculateModelViewMatrix(Vector3(-256, 0, 0), Vector3(0, 0, 0)), 640, 480);
+
+    // The size depends on the depth, which is not handled
+    EXPECT_FALSE(render::isOrthographicView(view));
+    EXPECT_EQ(render::getProjectedSizeInPixels(view, AABB(Vector3(0, 0, 0), Vector3(16, 16, 16))), -1);
+}
+
 }
@@ -1,9 +1,16 @@
 #include "RadiantTest.h"
 
+#include <chrono>
+#include <future>
+#include <iostream>
 #include "scene/BasicRootNode.h"
 #include "scene/Node.h"
 #include "scenelib.h"
+#include "icommandsystem.h"
+#include "render/NopVolumeTest.h"
 #include "algorithm/Entity.h"
+#include "algorithm/Primitives.h"
+#include "itransformable.h"
 
 namespace test
 {
@@ -386,4 +393,339 @@ TEST_F(SceneNodeTest, SetRenderStateAffectsAttachments)
     });
 }
 
+namespace
+{
+
+std::vector<scene::INodePtr> collectVisibleNodes(const VolumeTest& volume, bool parallel)
+{
+    std::vector<scene::INodePtr> nodes;
+
+    auto collector = [&](const scene::INodePtr& node)
+    {
+        nodes.push_back(node);
+        return true;
+    };
+
+    if (parallel)
+    {
+        GlobalSceneGraph().foreachVisibleNodeInVolumeParallel(volume, collector);
+    }
+    else
+    {
+        GlobalSceneGraph().foreachVisibleNodeInVolume(volume, collector);
+    }
+
+    return nodes;
+}
+
+}
+
+TEST_F(SceneNodeTest, ParallelVolumeTraversal)
+{
+    GlobalCommandSystem().executeCommand("OpenMap", cmd::Argument("maps/altar.map"));
+
+    render::NopVolumeTest volume;
+
+    auto sequentialNodes = collectVisibleNodes(volume, false);
+    EXPECT_GT(sequentialNodes.size(), 100) << "Test map should have a reasonable amount of nodes";
+
+    EXPECT_EQ(collectVisibleNodes(volume, true), sequentialNodes) << "Parallel traversal should visit the same nodes in the same order";
+
+    // Hide every other brush of the worldspawn
+    std::size_t index = 0;
+    GlobalMapModule().findOrInsertWorldspawn()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (index++ % 2 == 0)
+        {
+            node->enable(scene::Node::eHidden);
+        }
+        return true;
+    });
+
+    auto sequentialVisibleNodes = collectVisibleNodes(volume, false);
+    EXPECT_LT(sequentialVisibleNodes.size(), sequentialNodes.size()) << "Hidden nodes should have been skipped";
+    EXPECT_EQ(collectVisibleNodes(volume, true), sequentialVisibleNodes) << "Parallel traversal should skip the hidden nodes";
+
+    // Returning false should stop the traversal
+    std::size_t visitCount = 0;
+    GlobalSceneGraph().foreachVisibleNodeInVolumeParallel(volume, [&](const scene::INodePtr&)
+    {
+        return ++visitCount < 5;
+    });
+
+    EXPECT_EQ(visitCount, 5) << "Traversal should have been stopped";
+}
+
+namespace
+{
+
+// Calculates the bounds of the given node's children from scratch
+AABB accumulateChildBounds(const scene::INodePtr& parent)
+{
+    AABB bounds;
+
+    parent->foreachNode([&](const scene::INodePtr& child)
+    {
+        bounds.includeAABB(child->worldAABB());
+        return true;
+    });
+
+    return bounds;
+}
+
+void moveBrush(const scene::INodePtr& brush, const Vector3& translation)
+{
+    auto transformable = scene::node_cast<ITransformable>(brush);
+    transformable->setTranslation(translation);
+    transformable->freezeTransform();
+}
+
+// Fills the worldspawn with 10k brushes, returned in insertion order
+std::vector<scene::INodePtr> createWorldspawnWithManyChildren(scene::INodePtr& worldspawn)
+{
+    GlobalMapModule().createNewMap();
+    worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+
+    for (int x = 0; x < 25; ++x)
+    {
+        for (int y = 0; y < 20; ++y)
+        {
+            for (int z = 0; z < 20; ++z)
+            {
+                brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3(x * 64, y * 64, z * 64)));
+            }
+        }
+    }
+
+    return brushes;
+}
+
+}
+
+TEST_F(SceneNodeTest, ChildBoundsFollowChildChanges)
+{
+    scene::INodePtr worldspawn;
+    auto brushes = createWorldspawnWithManyChildren(worldspawn);
+
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn));
+
+    // The first brush is touching the border of the child bounds, the one in the middle doesn't
+    auto borderBrush = brushes.front();
+    auto innerBrush = brushes[brushes.size() / 2];
+
+    moveBrush(innerBrush, Vector3(8, 8, 8));
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Moving an inner child";
+
+    // Grow and shrink the child bounds
+    moveBrush(borderBrush, Vector3(-100, 0, 0));
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Moving a child outwards";
+
+    moveBrush(borderBrush, Vector3(100, 0, 0));
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Moving a child inwards";
+
+    // Several children changing before the bounds are requested
+    moveBrush(innerBrush, Vector3(-8, -8, -8));
+    moveBrush(brushes.back(), Vector3(0, 0, 500));
+    moveBrush(innerBrush, Vector3(0, 16, 0));
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Moving several children";
+
+    // Adding and removing children
+    auto outsideBrush = algorithm::createCubicBrush(worldspawn, Vector3(-1000, 0, 0));
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Adding a child";
+
+    scene::removeNodeFromParent(outsideBrush);
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Removing a border child";
+
+    // Removing a changed child before the bounds are requested
+    moveBrush(innerBrush, Vector3(0, -16, 0));
+    scene::removeNodeFromParent(innerBrush);
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Removing a changed child";
+
+    scene::removeNodeFromParent(brushes.back());
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn)) << "Removing the topmost child";
+
+    // The root bounds are following the worldspawn
+    EXPECT_EQ(GlobalMapModule().getRoot()->worldAABB(), accumulateChildBounds(GlobalMapModule().getRoot()));
+}
+
+namespace
+{
+
+class DamagedBoundsObserver :
+    public scene::Graph::Observer
+{
+public:
+    std::vector<AABB> damagedBounds;
+    std::size_t numSceneChanges = 0;
+
+    void onSceneGraphChange() override
+    {
+        ++numSceneChanges;
+    }
+
+    void onSceneBoundsDamaged(const AABB& bounds) override
+    {
+        damagedBounds.push_back(bounds);
+    }
+};
+
+}
+
+TEST_F(SceneNodeTest, DamagedBoundsCoverMovedNodes)
+{
+    GlobalMapModule().createNewMap();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto movedBrush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto otherBrush = algorithm::createCubicBrush(worldspawn, Vector3(1024, 0, 0));
+
+    DamagedBoundsObserver observer;
+    GlobalSceneGraph().addSceneObserver(&observer);
+
+    // Flush everything caused by the setup
+    GlobalSceneGraph().notifyDamagedBounds();
+    observer.damagedBounds.clear();
+
+    auto previousBounds = movedBrush->worldAABB();
+    moveBrush(movedBrush, Vector3(0, 128, 0));
+
+    // The bounds are evaluated by the notification
+    GlobalSceneGraph().notifyDamagedBounds();
+    auto currentBounds = movedBrush->worldAABB();
+
+    ASSERT_EQ(observer.damagedBounds.size(), 1) << "Expected exactly one notification";
+    EXPECT_TRUE(observer.damagedBounds.front().contains(previousBounds)) << "Previous bounds should be damaged";
+    EXPECT_TRUE(observer.damagedBounds.front().contains(currentBounds)) << "Current bounds should be damaged";
+    EXPECT_FALSE(observer.damagedBounds.front().intersects(otherBrush->worldAABB()))
+        << "The changed worldspawn bounds should not damage the unchanged children";
+    EXPECT_EQ(observer.numSceneChanges, 0) << "Observers should not receive a full scene change";
+
+    // Nothing changed since the last notification
+    GlobalSceneGraph().notifyDamagedBounds();
+    EXPECT_EQ(observer.damagedBounds.size(), 1) << "No changes, no notification";
+
+    GlobalSceneGraph().removeSceneObserver(&observer);
+}
+
+TEST_F(SceneNodeTest, ChildBoundsBenchmark)
+{
+    constexpr int Rounds = 1000;
+
+    scene::INodePtr worldspawn;
+    auto brushes = createWorldspawnWithManyChildren(worldspawn);
+
+    worldspawn->worldAABB();
+
+    auto innerBrush = brushes[brushes.size() / 2];
+    auto start = std::chrono::steady_clock::now();
+
+    // Move a single child back and forth, requesting the bounds after every step
+    for (int round = 0; round < Rounds; ++round)
+    {
+        moveBrush(innerBrush, Vector3(round % 2 == 0 ? 4 : -4, 0, 0));
+        GlobalMapModule().getRoot()->worldAABB();
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(worldspawn->worldAABB(), accumulateChildBounds(worldspawn));
+
+    std::cout << "[ SceneNode ] Moving one of " << brushes.size() << " children: " <<
+        static_cast<double>(duration.count()) / Rounds << " usec per bounds update" << std::endl;
+}
+
+namespace
+{
+
+std::size_t countChildNodes(const scene::IGraphSnapshot& snapshot, const scene::INodePtr& parent)
+{
+    std::size_t count = 0;
+
+    snapshot.foreachChildNode(parent, [&](const scene::INodePtr&)
+    {
+        ++count;
+        return true;
+    });
+
+    return count;
+}
+
+}
+
+TEST_F(SceneNodeTest, GraphSnapshotKeepsItsVersion)
+{
+    GlobalMapModule().createNewMap();
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        brushes.push_back(algorithm::createCubicBrush(worldspawn, Vector3(i * 64, 0, 0)));
+    }
+
+    auto snapshot = GlobalSceneGraph().createSnapshot();
+    ASSERT_TRUE(snapshot);
+    EXPECT_EQ(snapshot->getEpoch(), GlobalSceneGraph().getEpoch());
+    EXPECT_EQ(GlobalSceneGraph().createSnapshot(), snapshot) << "Snapshot should be re-used if nothing changed";
+    EXPECT_EQ(GlobalSceneGraph().getLatestSnapshot(), snapshot);
+
+    // The snapshot contains the same nodes in the same order as the scene graph traversal
+    std::vector<scene::INodePtr> sceneNodes;
+    GlobalSceneGraph().foreachNode([&](const scene::INodePtr& node)
+    {
+        sceneNodes.push_back(node);
+        return true;
+    });
+
+    std::vector<scene::INodePtr> snapshotNodes;
+    snapshot->foreachNode([&](const scene::INodePtr& node)
+    {
+        snapshotNodes.push_back(node);
+        return true;
+    });
+
+    EXPECT_EQ(snapshotNodes, sceneNodes);
+    EXPECT_EQ(snapshot->getNodeCount(), sceneNodes.size());
+    EXPECT_EQ(countChildNodes(*snapshot, GlobalMapModule().getRoot()), 1);
+    EXPECT_EQ(countChildNodes(*snapshot, worldspawn), brushes.size());
+
+    // Traverse the snapshot on a worker thread while the scene is modified
+    auto worker = std::async(std::launch::async, [snapshot, worldspawn]()
+    {
+        return countChildNodes(*snapshot, worldspawn);
+    });
+
+    std::weak_ptr<scene::INode> removedBrush = brushes.back();
+    scene::removeNodeFromParent(brushes.back());
+    brushes.pop_back();
+    algorithm::createCubicBrush(worldspawn, Vector3(0, 64, 0));
+    algorithm::createCubicBrush(worldspawn, Vector3(0, 128, 0));
+
+    EXPECT_EQ(worker.get(), 10) << "Snapshot should not reflect the changes made afterwards";
+    EXPECT_GT(GlobalSceneGraph().getEpoch(), snapshot->getEpoch());
+    EXPECT_EQ(GlobalSceneGraph().getLatestSnapshot(), snapshot) << "Latest snapshot is only replaced by createSnapshot";
+
+    auto newSnapshot = GlobalSceneGraph().createSnapshot();
+    EXPECT_NE(newSnapshot, snapshot);
+    EXPECT_EQ(countChildNodes(*newSnapshot, worldspawn), 11);
+    EXPECT_EQ(GlobalSceneGraph().getLatestSnapshot(), newSnapshot);
+
+    // The old snapshot keeps the removed node alive, even after it is released by a worker
+    EXPECT_FALSE(removedBrush.expired());
+
+    std::async(std::launch::async, [oldSnapshot = std::move(snapshot)]() mutable
+    {
+        oldSnapshot.reset();
+    }).get();
+
+    EXPECT_FALSE(removedBrush.expired()) << "Node should not be destroyed on the worker thread";
+
+    // The scene graph releases the unused snapshot on this thread
+    GlobalSceneGraph().createSnapshot();
+    EXPECT_TRUE(removedBrush.expired()) << "Unused snapshot should have been released";
+}
+
 }
@@ -1,6 +1,16 @@
 #include "RadiantTest.h"
 
+#include "iscenestatistics.h"
+#include "iscenegraph.h"
+#include "ientity.h"
+#include "ieclass.h"
+#include "ilayer.h"
+#include "imap.h"
+#include "scene/EntityBreakdown.h"
 #include "scene/ShaderBreakdown.h"
+#include "scene/LayerUsageBreakdown.h"
+#include "scenelib.h"
+#include "algorithm/Primitives.h"
 
 namespace test
 {
@@ -26,4 +36,83 @@ TEST_F(SceneStatisticsTest, MaterialBreakDown)
     EXPECT_EQ(map.at("torch_shadowcasting"), (std::array<std::size_t, 4>({ 0, 0, 1, 0 })));
 }
 
+TEST_F(SceneStatisticsTest, EntityBreakdownMatchesScene)
+{
+    loadMap("altar.map");
+
+    std::map<std::string, std::size_t> expected;
+
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        if (auto entity = Node_getEntity(node); entity)
+        {
+            expected[entity->getEntityClass()->getDeclName()]++;
+        }
+        return true;
+    });
+
+    EXPECT_FALSE(expected.empty());
+    EXPECT_EQ(scene::EntityBreakdown().getMap(), expected);
+}
+
+TEST_F(SceneStatisticsTest, MaterialCountsFollowSceneChanges)
+{
+    loadMap("material_usage.map");
+
+    auto countsAfterLoading = GlobalSceneStatistics().getMaterialCounts();
+    const auto& counts = GlobalSceneStatistics().getMaterialCounts();
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/5");
+
+    // The faces have been added after the brush got inserted
+    EXPECT_EQ(counts.at("textures/numbers/5"), (std::array<std::size_t, 4>({ 6, 0, 0, 0 })));
+
+    Node_getIBrush(brush)->getFace(0).setShader("textures/numbers/1");
+
+    EXPECT_EQ(counts.at("textures/numbers/5"), (std::array<std::size_t, 4>({ 5, 0, 0, 0 })));
+    EXPECT_EQ(counts.at("textures/numbers/1"), (std::array<std::size_t, 4>({ 7, 0, 0, 0 })));
+
+    auto patch = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(0, 0, 0), Vector3(64, 64, 64)), "textures/numbers/5");
+    EXPECT_EQ(counts.at("textures/numbers/5"), (std::array<std::size_t, 4>({ 5, 1, 0, 0 })));
+
+    Node_getIPatch(patch)->setShader("textures/numbers/0");
+    EXPECT_EQ(counts.at("textures/numbers/5"), (std::array<std::size_t, 4>({ 5, 0, 0, 0 })));
+    EXPECT_EQ(counts.at("textures/numbers/0"), (std::array<std::size_t, 4>({ 6, 3, 0, 0 })));
+
+    scene::removeNodeFromParent(brush);
+    scene::removeNodeFromParent(patch);
+
+    // The figures are the same as after loading the map
+    EXPECT_EQ(counts.count("textures/numbers/5"), 0) << "Unused materials should be removed";
+    EXPECT_EQ(counts.at("textures/numbers/1"), (std::array<std::size_t, 4>({ 6, 0, 0, 0 })));
+    EXPECT_EQ(scene::ShaderBreakdown().getMap(), countsAfterLoading);
+}
+
+TEST_F(SceneStatisticsTest, LayerCountsFollowMembershipChanges)
+{
+    loadMap("material_usage.map");
+
+    auto& layerManager = GlobalMapModule().getRoot()->getLayerManager();
+    auto layerId = layerManager.createLayer("TestLayer");
+
+    EXPECT_EQ(GlobalSceneStatistics().getLayerCounts().count(layerId), 0);
+
+    auto brush = algorithm::createCubicBrush(GlobalMapModule().findOrInsertWorldspawn());
+    brush->moveToLayer(layerId);
+
+    EXPECT_EQ(GlobalSceneStatistics().getLayerCounts().at(layerId), 1);
+
+    // All nodes are visible, the breakdown of the scene walk has to be the same
+    auto breakdown = scene::LayerUsageBreakdown::CreateFromScene(true);
+    EXPECT_EQ(breakdown, scene::LayerUsageBreakdown::CreateFromScene(false));
+    EXPECT_EQ(breakdown.at(layerId), 1);
+
+    brush->moveToLayer(0);
+    EXPECT_EQ(GlobalSceneStatistics().getLayerCounts().count(layerId), 0);
+
+    scene::removeNodeFromParent(brush);
+    EXPECT_EQ(scene::LayerUsageBreakdown::CreateFromScene(true), scene::LayerUsageBreakdown::CreateFromScene(false));
+}
+
 }
@@ -10,6 +10,7 @@
 #include "ipatch.h"
 #include "ientity.h"
 #include "ieclass.h"
+#include "algorithm/Entity.h"
 #include "algorithm/Scene.h"
 #include "algorithm/Primitives.h"
 #include "scenelib.h"
@@ -392,6 +393,158 @@ TEST_F(SelectionTest, DeselectCommandLeavesFocus)
     EXPECT_EQ(GlobalSelectionSystem().countSelected(), 0);
 }
 
+TEST_F(SelectionTest, SelectionBoundsFollowSelectionChanges)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(512, 0, 0));
+    auto brush3 = algorithm::createCubicBrush(worldspawn, Vector3(0, 1024, 0));
+
+    EXPECT_FALSE(GlobalSelectionSystem().getSelectionBounds(true).isValid());
+
+    Node_setSelected(brush1, true);
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionBounds(true), brush1->worldAABB());
+
+    // Growing the selection extends the bounds
+    Node_setSelected(brush2, true);
+    Node_setSelected(brush3, true);
+
+    AABB expected = brush1->worldAABB();
+    expected.includeAABB(brush2->worldAABB());
+    expected.includeAABB(brush3->worldAABB());
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionBounds(true), expected);
+    EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), brush3);
+    EXPECT_EQ(GlobalSelectionSystem().penultimateSelected(), brush2);
+
+    // Deselecting brings the bounds back to the remaining nodes
+    Node_setSelected(brush3, false);
+
+    expected = brush1->worldAABB();
+    expected.includeAABB(brush2->worldAABB());
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionBounds(true), expected);
+    EXPECT_EQ(GlobalSelectionSystem().ultimateSelected(), brush2);
+    EXPECT_EQ(GlobalSelectionSystem().penultimateSelected(), brush1);
+
+    // Moving the selection is updating the bounds too
+    GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(0, 0, 64)));
+
+    expected = brush1->worldAABB();
+    expected.includeAABB(brush2->worldAABB());
+    EXPECT_EQ(GlobalSelectionSystem().getSelectionBounds(true), expected);
+    EXPECT_EQ(GlobalSelectionSystem().getWorkZone().bounds, expected);
+
+    GlobalSelectionSystem().setSelectedAll(false);
+    EXPECT_FALSE(GlobalSelectionSystem().getSelectionBounds(true).isValid());
+}
+
+TEST_F(SelectionTest, GroupSelectionFollowsSceneMembership)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0));
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(512, 0, 0));
+    auto brush3 = algorithm::createCubicBrush(worldspawn, Vector3(0, 1024, 0));
+    auto ungrouped = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 1024));
+
+    auto group = GlobalMapModule().getRoot()->getSelectionGroupManager().createSelectionGroup();
+    group->addNode(brush1);
+    group->addNode(brush2);
+    group->addNode(brush3);
+    EXPECT_EQ(group->size(), 3);
+
+    // Selecting one member selects the whole group
+    Node_setSelected(brush1, true);
+    expectNodeSelectionStatus({ brush1, brush2, brush3 }, { ungrouped });
+
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    // A node removed from the scene leaves the group
+    scene::removeNodeFromParent(brush3);
+    EXPECT_EQ(group->size(), 2);
+
+    Node_setSelected(brush2, true);
+    expectNodeSelectionStatus({ brush1, brush2 }, { brush3, ungrouped });
+
+    GlobalSelectionSystem().setSelectedAll(false);
+
+    // Re-inserting the node makes it a member again
+    worldspawn->addChildNode(brush3);
+    EXPECT_EQ(group->size(), 3);
+
+    Node_setSelected(brush2, true);
+    expectNodeSelectionStatus({ brush1, brush2, brush3 }, { ungrouped });
+}
+
+namespace
+{
+
+std::vector<ISelectable*> testSelectScene(selection::SelectionMode mode, SelectionVolume& test)
+{
+    auto& factory = dynamic_cast<selection::ISceneSelectionTesterFactory&>(GlobalSelectionSystem());
+    auto tester = factory.createSceneSelectionTester(mode);
+
+    tester->testSelectScene(test.getVolume(), test);
+
+    std::vector<ISelectable*> selectables;
+    tester->foreachSelectable([&](ISelectable* selectable) { selectables.push_back(selectable); });
+
+    return selectables;
+}
+
+}
+
+TEST_F(SelectionTest, ParallelSceneTestMatchesSerialResult)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    auto funcStatic = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+
+    // A stack of overlapping brushes, every fourth of them belongs to the func_static
+    for (int x = -4; x < 4; ++x)
+    {
+        for (int y = -4; y < 4; ++y)
+        {
+            for (int z = 0; z < 8; ++z)
+            {
+                auto parent = (x + y + z) % 4 == 0 ? funcStatic : worldspawn;
+                algorithm::createCubicBrush(parent, Vector3(x * 48, y * 48, z * 48));
+            }
+        }
+    }
+
+    algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(0, 0, 400), Vector3(64, 64, 0)));
+
+    render::View orthoView(false);
+    algorithm::constructCenteredOrthoview(orthoView, Vector3(0, 0, 0));
+
+    // One point test and one area test covering the whole view
+    auto pointTest = algorithm::constructOrthoviewSelectionTest(orthoView);
+
+    render::View areaView(orthoView);
+    ConstructSelectionTest(areaView, selection::Rectangle(Vector2(-1, -1), Vector2(1, 1)));
+    SelectionVolume areaTest(areaView);
+
+    for (auto mode : { selection::SelectionMode::Primitive, selection::SelectionMode::Entity,
+        selection::SelectionMode::GroupPart })
+    {
+        for (auto test : { &pointTest, &areaTest })
+        {
+            registry::setValue(RKEY_ENABLE_PARALLEL_SELECTION_TEST, false);
+            auto serialResult = testSelectScene(mode, *test);
+
+            registry::setValue(RKEY_ENABLE_PARALLEL_SELECTION_TEST, true);
+            auto parallelResult = testSelectScene(mode, *test);
+
+            EXPECT_FALSE(serialResult.empty()) << "Test should hit something";
+            EXPECT_EQ(serialResult, parallelResult) << "Parallel result differs in mode " << static_cast<int>(mode);
+        }
+    }
+
+    registry::setValue(RKEY_ENABLE_PARALLEL_SELECTION_TEST, false);
+}
+
 class ViewSelectionTest :
     public SelectionTest
 {
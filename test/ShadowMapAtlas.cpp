@@ -0,0 +1,145 @@
+#include "gtest/gtest.h"
+
+#include <set>
+#include "render/ShadowMapAtlas.h"
+
+namespace test
+{
+
+namespace
+{
+
+constexpr std::size_t TextureSize = 6 * 1024;
+constexpr std::size_t Rows = 6;
+constexpr std::size_t MaxLevel = 3;
+
+inline bool rectanglesOverlap(const render::Rectangle& a, const render::Rectangle& b)
+{
+    // Each tile spans 6 faces horizontally
+    return a.x < b.x + 6 * b.width && b.x < a.x + 6 * a.width &&
+        a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+inline void expectTileWithinTexture(const render::Rectangle& rectangle)
+{
+    EXPECT_GE(rectangle.x, 0);
+    EXPECT_GE(rectangle.y, 0);
+    EXPECT_LE(rectangle.x + 6 * rectangle.width, static_cast<int>(TextureSize));
+    EXPECT_LE(rectangle.y + rectangle.height, static_cast<int>(TextureSize));
+}
+
+}
+
+TEST(ShadowMapAtlasTest, AllocateFullSizeTiles)
+{
+    render::ShadowMapAtlas atlas(TextureSize, Rows, MaxLevel);
+
+    std::set<int> rows;
+
+    for (std::size_t i = 0; i < Rows; ++i)
+    {
+        auto handle = atlas.allocate(0);
+        EXPECT_NE(handle, render::ShadowMapAtlas::InvalidHandle) << "Allocation " << i << " failed";
+
+        const auto& rectangle = atlas.getRectangle(handle);
+        EXPECT_EQ(rectangle.x, 0);
+        EXPECT_EQ(rectangle.width, 1024);
+        EXPECT_EQ(rectangle.height, 1024);
+        expectTileWithinTexture(rectangle);
+
+        rows.insert(rectangle.y);
+    }
+
+    EXPECT_EQ(rows.size(), Rows) << "Tiles should be located in different rows";
+    EXPECT_EQ(atlas.getNumOccupiedTiles(), Rows);
+
+    // No more room for another full-size or any smaller tile
+    EXPECT_EQ(atlas.allocate(0), render::ShadowMapAtlas::InvalidHandle);
+    EXPECT_EQ(atlas.allocate(MaxLevel), render::ShadowMapAtlas::InvalidHandle);
+    EXPECT_EQ(atlas.allocate(MaxLevel + 1), render::ShadowMapAtlas::InvalidHandle);
+}
+
+TEST(ShadowMapAtlasTest, SubdividedTilesDontOverlap)
+{
+    render::ShadowMapAtlas atlas(TextureSize, Rows, MaxLevel);
+
+    std::vector<render::ShadowMapAtlas::Handle> handles;
+
+    // Allocate 3 level 3 tiles for each level 1 tile (and vice versa), until the atlas is full
+    for (std::size_t i = 0; ; ++i)
+    {
+        auto level = i % 4 == 0 ? 1 : 3;
+        auto handle = atlas.allocate(level);
+
+        if (handle == render::ShadowMapAtlas::InvalidHandle) break;
+
+        EXPECT_EQ(atlas.getLevel(handle), level);
+        EXPECT_EQ(atlas.getRectangle(handle).width, atlas.getFaceSize(level));
+
+        handles.push_back(handle);
+    }
+
+    EXPECT_GT(handles.size(), Rows * 4) << "Subdivided atlas should hold more tiles than rows";
+
+    for (auto a = handles.begin(); a != handles.end(); ++a)
+    {
+        expectTileWithinTexture(atlas.getRectangle(*a));
+
+        for (auto b = a + 1; b != handles.end(); ++b)
+        {
+            EXPECT_FALSE(rectanglesOverlap(atlas.getRectangle(*a), atlas.getRectangle(*b)))
+                << "Tiles " << *a << " and " << *b << " are overlapping";
+        }
+    }
+}
+
+TEST(ShadowMapAtlasTest, FreedTilesAreMerged)
+{
+    render::ShadowMapAtlas atlas(TextureSize, Rows, MaxLevel);
+
+    std::vector<render::ShadowMapAtlas::Handle> handles;
+
+    // Fill the whole atlas with the smallest tiles
+    for (auto handle = atlas.allocate(MaxLevel); handle != render::ShadowMapAtlas::InvalidHandle; handle = atlas.allocate(MaxLevel))
+    {
+        handles.push_back(handle);
+    }
+
+    EXPECT_EQ(handles.size(), Rows * 64);
+    EXPECT_EQ(atlas.allocate(0), render::ShadowMapAtlas::InvalidHandle);
+
+    for (auto handle : handles)
+    {
+        atlas.free(handle);
+    }
+
+    EXPECT_EQ(atlas.getNumOccupiedTiles(), 0);
+
+    // All the rows should be available again
+    for (std::size_t i = 0; i < Rows; ++i)
+    {
+        EXPECT_NE(atlas.allocate(0), render::ShadowMapAtlas::InvalidHandle) << "Rows have not been merged";
+    }
+}
+
+TEST(ShadowMapAtlasTest, SplitTilesArePreferred)
+{
+    render::ShadowMapAtlas atlas(TextureSize, Rows, MaxLevel);
+
+    auto first = atlas.allocate(2);
+    auto second = atlas.allocate(2);
+
+    // The second small tile should go into the row that has been split already
+    EXPECT_EQ(atlas.getRectangle(first).y / 1024, atlas.getRectangle(second).y / 1024);
+
+    // Leaving 5 rows available at full size
+    for (std::size_t i = 0; i < Rows - 1; ++i)
+    {
+        EXPECT_NE(atlas.allocate(0), render::ShadowMapAtlas::InvalidHandle);
+    }
+
+    EXPECT_EQ(atlas.allocate(0), render::ShadowMapAtlas::InvalidHandle);
+    EXPECT_THROW(atlas.free(render::ShadowMapAtlas::InvalidHandle), std::logic_error);
+}
+
+}
@@ -542,6 +542,48 @@ TEST_F(ModelSkinTest, ReloadDeclsRefreshesModelsUsingSignal)
     EXPECT_EQ(activeMaterials.at(0), "textures/common/noclip");
 }
 
+// Only models using a changed skin are refreshed, this includes skins appearing during reloadDecls
+TEST_F(ModelSkinTest, ReloadDeclsRefreshesModelsUsingNewSkin)
+{
+    auto funcStaticClass = GlobalEntityClassManager().findClass("func_static");
+    auto funcStatic = GlobalEntityModule().createEntity(funcStaticClass);
+    scene::addNodeToContainer(funcStatic, GlobalMapModule().getRoot());
+
+    auto otherFuncStatic = GlobalEntityModule().createEntity(funcStaticClass);
+    scene::addNodeToContainer(otherFuncStatic, GlobalMapModule().getRoot());
+
+    // Reference a skin that doesn't exist yet
+    funcStatic->getEntity().setKeyValue("model", "models/ase/tiles.ase");
+    funcStatic->getEntity().setKeyValue("skin", "skin_created_later");
+
+    otherFuncStatic->getEntity().setKeyValue("model", "models/ase/tiles.ase");
+    otherFuncStatic->getEntity().setKeyValue("skin", "tile_skin");
+
+    auto model = algorithm::findChildModel(funcStatic);
+    auto otherModel = algorithm::findChildModel(otherFuncStatic);
+    EXPECT_EQ(model->getIModel().getActiveMaterials().at(0), "textures/atest/a");
+    EXPECT_EQ(otherModel->getIModel().getActiveMaterials().at(0), "textures/numbers/10");
+
+    TemporaryFile tempFile(_context.getTestProjectPath() + "skins/_skin_decl_test.skin");
+    tempFile.setContents(R"(
+skin skin_created_later
+{
+    textures/atest/a    textures/common/caulk
+}
+)");
+
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(model->getIModel().getActiveMaterials().at(0), "textures/common/caulk");
+    EXPECT_EQ(otherModel->getIModel().getActiveMaterials().at(0), "textures/numbers/10");
+
+    // Removing the skin again reverts the model to its original materials
+    tempFile.setContents("");
+    GlobalDeclarationManager().reloadDeclarations();
+
+    EXPECT_EQ(model->getIModel().getActiveMaterials().at(0), "textures/atest/a");
+}
+
 TEST_F(ModelSkinTest, SkinIsUnlistedAfterSkinRemoval)
 {
     constexpr auto skinToRemove = "tile_skin2";
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <random>
+#include "render/SortedDrawList.h"
+
+namespace test
+{
+
+TEST(SortedDrawListTest, ItemsAreSortedByKey)
+{
+    render::SortedDrawList<std::uint64_t> list;
+
+    std::mt19937_64 generator(17);
+    std::vector<std::uint64_t> keys;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        keys.push_back(generator());
+        list.add(keys.back(), keys.back());
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<std::uint64_t> sortedKeys;
+
+    list.foreachItem([&](std::uint64_t key, std::uint64_t item)
+    {
+        EXPECT_EQ(key, item) << "Key and item don't match";
+        sortedKeys.push_back(key);
+    });
+
+    EXPECT_EQ(sortedKeys, keys) << "Items are not sorted by key";
+}
+
+TEST(SortedDrawListTest, EqualKeysKeepInsertionOrder)
+{
+    render::SortedDrawList<int> list;
+
+    // Keys only differing in the upper bits, items with equal keys added in ascending order
+    for (int i = 0; i < 100; ++i)
+    {
+        list.add(static_cast<std::uint64_t>(i % 3) << 56, i);
+    }
+
+    std::uint64_t lastKey = 0;
+    int lastItem = -1;
+
+    list.foreachItem([&](std::uint64_t key, int item)
+    {
+        EXPECT_GE(key, lastKey) << "Items are not sorted by key";
+
+        if (key == lastKey)
+        {
+            EXPECT_GT(item, lastItem) << "Items with equal keys changed their order";
+        }
+
+        lastKey = key;
+        lastItem = item;
+    });
+}
+
+TEST(SortedDrawListTest, ClearList)
+{
+    render::SortedDrawList<int> list;
+
+    list.add(2, 2);
+    list.add(1, 1);
+
+    EXPECT_EQ(list.size(), 2);
+
+    list.clear();
+
+    EXPECT_TRUE(list.empty());
+
+    // The list can be re-used after clearing
+    list.add(5, 5);
+    list.add(3, 3);
+
+    std::vector<int> items;
+    list.foreachItem([&](std::uint64_t, int item) { items.push_back(item); });
+
+    EXPECT_EQ(items, std::vector<int>({ 3, 5 }));
+}
+
+}
@@ -81,6 +81,13 @@ TEST_F(SoundManagerTest, GetWaveSoundFileDuration)
     EXPECT_NEAR(duration, 0.096, 0.001) << "WAV file duration incorrect";
 }
 
+TEST_F(SoundManagerTest, GetWaveSoundFileDurationWithAdditionalChunks)
+{
+    // This file has an extended fmt chunk and a LIST chunk in front of the data
+    auto duration = GlobalSoundManager().getSoundFileDuration("sound/test/chunks.wav");
+    EXPECT_NEAR(duration, 0.1, 0.001) << "WAV file duration incorrect";
+}
+
 TEST_F(SoundManagerTest, GetSoundFileDurationWithoutExtension)
 {
     auto oggDuration = GlobalSoundManager().getSoundFileDuration("sound/test/jorge.ogg");
@@ -92,4 +99,34 @@ TEST_F(SoundManagerTest, GetSoundFileDurationWithoutExtension)
     EXPECT_NEAR(duration, oggDuration, 0.001) << "The OGG file should have been found, not the wav file";
 }
 
+TEST_F(SoundManagerTest, FindIndexedSoundFile)
+{
+    // Querying the duration puts the file into the index
+    GlobalSoundManager().getSoundFileDuration("sound/test/jorge");
+
+    SoundFileInfo info;
+    EXPECT_TRUE(GlobalSoundManager().findIndexedSoundFile("sound/test/jorge", info)) << "File should be indexed";
+    EXPECT_EQ(info.resolvedPath, "sound/test/jorge.ogg") << "The OGG file should have been resolved";
+    EXPECT_NEAR(info.duration, 0.293, 0.001) << "OGG file duration incorrect";
+    EXPECT_EQ(info.sampleRate, 44100);
+    EXPECT_EQ(info.numChannels, 1);
+
+    GlobalSoundManager().getSoundFileDuration("sound/test/jorge.wav");
+
+    EXPECT_TRUE(GlobalSoundManager().findIndexedSoundFile("sound/test/jorge.wav", info)) << "File should be indexed";
+    EXPECT_EQ(info.resolvedPath, "sound/test/jorge.wav");
+    EXPECT_NEAR(info.duration, 0.096, 0.001) << "WAV file duration incorrect";
+    EXPECT_EQ(info.sampleRate, 44100);
+    EXPECT_EQ(info.numChannels, 1);
+}
+
+TEST_F(SoundManagerTest, FindNonexistentIndexedSoundFile)
+{
+    EXPECT_THROW(GlobalSoundManager().getSoundFileDuration("sound/nonexistent.ogg"), std::out_of_range);
+
+    SoundFileInfo info;
+    EXPECT_FALSE(GlobalSoundManager().findIndexedSoundFile("sound/nonexistent.ogg", info))
+        << "Unresolvable files should not be indexed";
+}
+
 }
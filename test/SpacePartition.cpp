@@ -0,0 +1,424 @@
+#include "RadiantTest.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <set>
+#include "icommandsystem.h"
+#include "iscenegraph.h"
+#include "iselection.h"
+#include "ispacepartition.h"
+#include "imap.h"
+#include "iregion.h"
+#include "ivolumetest.h"
+#include "itraceable.h"
+#include "math/Ray.h"
+#include "math/pi.h"
+#include "render/View.h"
+#include "render/CameraView.h"
+#include "registry/registry.h"
+#include "scenelib.h"
+#include "scene/SpacePartitionStatistics.h"
+#include "algorithm/Primitives.h"
+
+namespace test
+{
+
+class SpacePartitionTest :
+    public RadiantTest
+{
+protected:
+    void TearDown() override
+    {
+        // Revert to the default partition type for the following tests
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, "octree");
+
+        RadiantTest::TearDown();
+    }
+};
+
+namespace
+{
+
+const std::vector<std::string> SpacePartitionTypes{ "octree", "looseOctree" };
+
+// Camera views looking in 8 directions from a grid of positions within the given bounds
+std::vector<render::View> createCameraViews(const AABB& bounds)
+{
+    std::vector<render::View> views;
+
+    auto projection = camera::calculateProjectionMatrix(1.0f, 2048.0f, 90.0f, 640, 480);
+
+    for (int x = -1; x <= 1; ++x)
+    {
+        for (int y = -1; y <= 1; ++y)
+        {
+            auto origin = bounds.origin + Vector3(x * bounds.extents.x(), y * bounds.extents.y(), 0) * 0.5;
+
+            for (int yaw = 0; yaw < 360; yaw += 45)
+            {
+                auto& view = views.emplace_back();
+                view.construct(projection, camera::calculateModelViewMatrix(origin, Vector3(0, yaw, 0)), 640, 480);
+            }
+        }
+    }
+
+    return views;
+}
+
+std::set<scene::INode*> collectNodesInVolume(const VolumeTest& volume)
+{
+    std::set<scene::INode*> nodes;
+
+    GlobalSceneGraph().foreachNodeInVolume(volume, [&](const scene::INodePtr& node)
+    {
+        nodes.insert(node.get());
+        return true;
+    });
+
+    return nodes;
+}
+
+// The space partition is allowed to return more nodes than necessary, but it must
+// not miss any node intersecting the volume
+void expectAllIntersectingNodesVisited(const VolumeTest& volume)
+{
+    auto visited = collectNodesInVolume(volume);
+
+    GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+    {
+        const auto& bounds = node->worldAABB();
+
+        if (bounds.isValid() && volume.TestAABB(bounds) != VOLUME_OUTSIDE)
+        {
+            EXPECT_EQ(visited.count(node.get()), 1) << "Node intersecting the volume has not been visited";
+        }
+
+        return true;
+    });
+}
+
+// Returns the average time in microseconds to run a query for all the given views
+double measureQueryTime(const std::vector<render::View>& views, std::size_t& visitedNodes)
+{
+    constexpr int Rounds = 20;
+
+    visitedNodes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < Rounds; ++round)
+    {
+        for (const auto& view : views)
+        {
+            GlobalSceneGraph().foreachNodeInVolume(view, [&](const scene::INodePtr& node)
+            {
+                ++visitedNodes;
+                return true;
+            });
+        }
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+    visitedNodes /= Rounds;
+    return static_cast<double>(duration.count()) / Rounds;
+}
+
+// Fills the map with a grid of brushes centered on the multiples of 256 units,
+// all of them straddling the boundaries of the regular octree
+void createBrushGrid()
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    for (int x = -8; x < 8; ++x)
+    {
+        for (int y = -8; y < 8; ++y)
+        {
+            for (int z = 0; z < 4; ++z)
+            {
+                algorithm::createCubicBrush(worldspawn, Vector3(x * 256, y * 256, z * 256));
+            }
+        }
+    }
+}
+
+void runBenchmark(const std::string& name, const std::function<void()>& populateScene)
+{
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        populateScene();
+
+        auto views = createCameraViews(GlobalSceneGraph().root()->worldAABB());
+
+        for (const auto& view : views)
+        {
+            expectAllIntersectingNodesVisited(view);
+        }
+
+        std::size_t visitedNodes = 0;
+        auto time = measureQueryTime(views, visitedNodes);
+
+        std::cout << "[ SpacePartition ] " << name << " using " << type << ": " << time << " usec for " <<
+            views.size() << " views, " << visitedNodes << " nodes visited, " <<
+            GlobalSceneGraph().getSpacePartition()->getRoot()->getMembers().size() << " root members" << std::endl;
+    }
+}
+
+// Returns the distance to the nearest traceable node hit by the ray, or -1 if there is none
+double getNearestHit(const scene::INodePtr& node, const Ray& ray, double maxDistance)
+{
+    auto traceable = std::dynamic_pointer_cast<ITraceable>(node);
+    Vector3 intersection;
+
+    if (!traceable || !traceable->getIntersection(ray, intersection))
+    {
+        return -1;
+    }
+
+    auto distance = (intersection - ray.origin).getLength();
+    return distance < maxDistance ? distance : -1;
+}
+
+}
+
+TEST_F(SpacePartitionTest, ChangeSpacePartitionType)
+{
+    registry::setValue(RKEY_SPACE_PARTITION_TYPE, "octree");
+    GlobalMapModule().createNewMap();
+
+    auto octree = GlobalSceneGraph().getSpacePartition();
+
+    registry::setValue(RKEY_SPACE_PARTITION_TYPE, "looseOctree");
+    GlobalMapModule().createNewMap();
+
+    auto looseOctree = GlobalSceneGraph().getSpacePartition();
+    EXPECT_NE(octree, looseOctree) << "Space partition should have been replaced";
+
+    // The loose root cell covers the world cube enlarged by the factor 2
+    const auto& bounds = looseOctree->getRoot()->getBounds();
+    EXPECT_EQ(bounds.extents, Vector3(131072, 131072, 131072));
+}
+
+TEST_F(SpacePartitionTest, BoundaryStraddlingNodesStayOutOfRoot)
+{
+    std::map<std::string, std::size_t> rootMembers;
+
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        GlobalMapModule().createNewMap();
+
+        createBrushGrid();
+
+        expectAllIntersectingNodesVisited(createCameraViews(GlobalSceneGraph().root()->worldAABB()).front());
+
+        rootMembers[type] = GlobalSceneGraph().getSpacePartition()->getRoot()->getMembers().size();
+    }
+
+    EXPECT_LT(rootMembers["looseOctree"], rootMembers["octree"]) << "Loose octree should keep the root node clear";
+    EXPECT_LT(rootMembers["looseOctree"], 10);
+}
+
+TEST_F(SpacePartitionTest, RelinkAfterMovingAndRemovingNodes)
+{
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        GlobalMapModule().createNewMap();
+
+        createBrushGrid();
+
+        // Move every third brush, remove every fifth brush and re-insert it
+        std::vector<scene::INodePtr> brushes;
+        GlobalMapModule().findOrInsertWorldspawn()->foreachNode([&](const scene::INodePtr& node)
+        {
+            brushes.push_back(node);
+            return true;
+        });
+
+        for (std::size_t i = 0; i < brushes.size(); i += 3)
+        {
+            Node_setSelected(brushes[i], true);
+        }
+
+        GlobalCommandSystem().executeCommand("MoveSelection", cmd::Argument(Vector3(100, 50, 20)));
+        GlobalSelectionSystem().setSelectedAll(false);
+
+        for (std::size_t i = 0; i < brushes.size(); i += 5)
+        {
+            auto parent = brushes[i]->getParent();
+            scene::removeNodeFromParent(brushes[i]);
+            scene::addNodeToContainer(brushes[i], parent);
+        }
+
+        for (const auto& view : createCameraViews(GlobalSceneGraph().root()->worldAABB()))
+        {
+            expectAllIntersectingNodesVisited(view);
+        }
+    }
+}
+
+TEST_F(SpacePartitionTest, RegionExcludesNodesOutsideBounds)
+{
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        GlobalMapModule().createNewMap();
+
+        createBrushGrid();
+
+        std::vector<scene::INodePtr> brushes;
+        GlobalMapModule().findOrInsertWorldspawn()->foreachNode([&](const scene::INodePtr& node)
+        {
+            brushes.push_back(node);
+            return true;
+        });
+
+        // Set a region around two brushes, then shrink it to the second one
+        for (const auto& selection : { std::vector<std::size_t>{ 70, 153 }, std::vector<std::size_t>{ 153 } })
+        {
+            for (auto index : selection)
+            {
+                Node_setSelected(brushes[index], true);
+            }
+
+            GlobalCommandSystem().executeCommand("RegionSetSelection");
+
+            auto region = GlobalRegionManager().getRegionBounds();
+            std::size_t numExcluded = 0;
+
+            GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+            {
+                EXPECT_EQ(node->excluded(), !node->worldAABB().intersects(region)) << "Wrong exclusion using " << type;
+                numExcluded += node->excluded() ? 1 : 0;
+                return true;
+            });
+
+            EXPECT_GT(numExcluded, 0) << "Region should exclude some of the brushes";
+        }
+
+        GlobalCommandSystem().executeCommand("RegionOff");
+
+        GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+        {
+            EXPECT_FALSE(node->excluded()) << "Node still excluded after disabling the region";
+            return true;
+        });
+    }
+}
+
+TEST_F(SpacePartitionTest, QueryBenchmark)
+{
+    runBenchmark("altar.map", [&]() { loadMap("altar.map"); });
+    runBenchmark("brush grid", [&]() { GlobalMapModule().createNewMap(); createBrushGrid(); });
+}
+
+TEST_F(SpacePartitionTest, RayQueryFindsNearestNode)
+{
+    constexpr double MaxDistance = 4096;
+
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        GlobalMapModule().createNewMap();
+
+        createBrushGrid();
+
+        std::size_t numHits = 0;
+        std::size_t visitedNodes = 0;
+
+        for (int angle = 0; angle < 360; angle += 15)
+        {
+            auto radians = degrees_to_radians(angle);
+            Ray ray(Vector3(20, -36, 300), Vector3(cos(radians), sin(radians), -0.25 * (angle % 4)).getNormalised());
+
+            // Run the query, letting the visitor shorten the ray on every hit
+            auto nearestHit = MaxDistance;
+
+            GlobalSceneGraph().foreachVisibleNodeAlongRay(ray, [&](const scene::INodePtr& node, double& maxDistance)
+            {
+                ++visitedNodes;
+
+                auto distance = getNearestHit(node, ray, maxDistance);
+
+                if (distance >= 0)
+                {
+                    maxDistance = nearestHit = distance;
+                }
+            }, MaxDistance);
+
+            // Compare the result to testing each and every node
+            auto expectedHit = MaxDistance;
+
+            GlobalSceneGraph().root()->foreachNode([&](const scene::INodePtr& node)
+            {
+                auto distance = getNearestHit(node, ray, expectedHit);
+
+                if (distance >= 0)
+                {
+                    expectedHit = distance;
+                }
+
+                return true;
+            });
+
+            EXPECT_NEAR(nearestHit, expectedHit, 0.001) << "Ray query missed the nearest hit at angle " << angle << " using " << type;
+            numHits += expectedHit < MaxDistance ? 1 : 0;
+        }
+
+        EXPECT_GT(numHits, 0) << "Test setup is wrong, no ray hit anything";
+
+        std::cout << "[ SpacePartition ] Ray query using " << type << ": " << visitedNodes <<
+            " nodes visited, " << numHits << " hits" << std::endl;
+    }
+}
+
+TEST_F(SpacePartitionTest, StatisticsReflectTreeAndQueries)
+{
+    for (const auto& type : SpacePartitionTypes)
+    {
+        registry::setValue(RKEY_SPACE_PARTITION_TYPE, type);
+        GlobalMapModule().createNewMap();
+
+        createBrushGrid();
+
+        // Evaluate the bounds such that the changed nodes get relinked
+        auto views = createCameraViews(GlobalSceneGraph().root()->worldAABB());
+        collectNodesInVolume(views.front());
+
+        auto root = GlobalSceneGraph().getSpacePartition()->getRoot();
+        auto stats = scene::collectSpacePartitionStatistics(root);
+
+        EXPECT_EQ(stats.numRootMembers, root->getMembers().size());
+        EXPECT_GT(stats.maxDepth, 0) << "Brush grid should be distributed over several levels using " << type;
+        EXPECT_GT(stats.numNodes, stats.numLeaves);
+        EXPECT_GE(stats.numMembers, 16 * 16 * 4) << "Each brush should be linked once";
+        EXPECT_EQ(stats.membersPerDepth.size(), stats.maxDepth + 1);
+
+        std::size_t membersPerDepthSum = 0;
+
+        for (auto count : stats.membersPerDepth)
+        {
+            membersPerDepthSum += count;
+        }
+
+        EXPECT_EQ(membersPerDepthSum, stats.numMembers);
+
+        // Both volume traversal variants are counted
+        auto before = GlobalSceneGraph().getSpacePartitionQueryStatistics();
+
+        collectNodesInVolume(views.front());
+        GlobalSceneGraph().foreachVisibleNodeInVolumeParallel(views.front(), [](const scene::INodePtr&) { return true; });
+
+        auto after = GlobalSceneGraph().getSpacePartitionQueryStatistics();
+
+        EXPECT_EQ(after.numQueries, before.numQueries + 2);
+        EXPECT_GE(after.numVisitedNodes, before.numVisitedNodes + 2) << "The root node is visited by every query";
+        EXPECT_LE(after.numVisitedNodes, before.numVisitedNodes + 2 * stats.numNodes);
+    }
+}
+
+}
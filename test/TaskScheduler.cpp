@@ -0,0 +1,213 @@
+#include "RadiantTest.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include "itaskscheduler.h"
+#include "parser/ThreadedDefLoader.h"
+#include "SequentialTaskQueue.h"
+
+namespace test
+{
+
+using TaskSchedulerTest = RadiantTest;
+
+TEST_F(TaskSchedulerTest, ParallelForVisitsEachIndexOnce)
+{
+    constexpr std::size_t Count = 10000;
+    std::vector<std::atomic<int>> visits(Count);
+
+    GlobalTaskScheduler().parallelFor(Count, [&](std::size_t i)
+    {
+        ++visits[i];
+    });
+
+    for (std::size_t i = 0; i < Count; ++i)
+    {
+        EXPECT_EQ(visits[i].load(), 1) << "Index " << i << " has not been visited exactly once";
+    }
+}
+
+TEST_F(TaskSchedulerTest, NestedParallelFor)
+{
+    std::atomic<std::size_t> count(0);
+
+    // The inner loops are running on the worker threads, they must not wait for each other forever
+    GlobalTaskScheduler().parallelFor(64, [&](std::size_t)
+    {
+        GlobalTaskScheduler().parallelFor(64, [&](std::size_t) { ++count; });
+    });
+
+    EXPECT_EQ(count.load(), 64 * 64);
+}
+
+TEST_F(TaskSchedulerTest, ParallelForRethrowsExceptions)
+{
+    EXPECT_THROW(GlobalTaskScheduler().parallelFor(1000, [&](std::size_t i)
+    {
+        if (i == 500) throw std::runtime_error("Test");
+    }), std::runtime_error);
+}
+
+TEST_F(TaskSchedulerTest, WaitingTasksSpawningTasks)
+{
+    std::atomic<std::size_t> count(0);
+    std::vector<threading::TaskPtr> tasks;
+
+    // Submit more waiting tasks than there are workers
+    for (std::size_t i = 0; i < GlobalTaskScheduler().getNumWorkers() * 4; ++i)
+    {
+        tasks.emplace_back(GlobalTaskScheduler().submit([&]()
+        {
+            GlobalTaskScheduler().submit([&]() { ++count; })->wait();
+        }));
+    }
+
+    for (const auto& task : tasks)
+    {
+        task->wait();
+        EXPECT_TRUE(task->isFinished());
+    }
+
+    EXPECT_EQ(count.load(), tasks.size());
+}
+
+TEST_F(TaskSchedulerTest, WaitRethrowsException)
+{
+    auto task = GlobalTaskScheduler().submit([]() { throw std::runtime_error("Test"); });
+
+    EXPECT_THROW(task->wait(), std::runtime_error);
+    EXPECT_TRUE(task->isFinished());
+}
+
+TEST_F(TaskSchedulerTest, CancelledTaskIsNotRun)
+{
+    std::atomic<bool> releaseBlockers(false);
+    std::vector<threading::TaskPtr> blockers;
+
+    // Keep all workers busy such that the next task stays in the queue
+    for (std::size_t i = 0; i < GlobalTaskScheduler().getNumWorkers(); ++i)
+    {
+        blockers.emplace_back(GlobalTaskScheduler().submit([&]()
+        {
+            while (!releaseBlockers) std::this_thread::yield();
+        }));
+    }
+
+    bool taskRun = false;
+    auto task = GlobalTaskScheduler().submit([&]() { taskRun = true; }, threading::TaskPriority::Low);
+    task->cancel();
+
+    releaseBlockers = true;
+    task->wait();
+
+    for (const auto& blocker : blockers)
+    {
+        blocker->wait();
+    }
+
+    EXPECT_TRUE(task->isCancellationRequested());
+    EXPECT_TRUE(task->isFinished());
+    EXPECT_FALSE(taskRun) << "Cancelled task has been run";
+}
+
+TEST_F(TaskSchedulerTest, RunningTaskSeesCancellationRequest)
+{
+    std::atomic<bool> started(false);
+
+    auto task = GlobalTaskScheduler().submit([&](const threading::ITask& self)
+    {
+        started = true;
+        while (!self.isCancellationRequested()) std::this_thread::yield();
+    });
+
+    while (!started) std::this_thread::yield();
+
+    task->cancel();
+    task->wait();
+
+    EXPECT_TRUE(task->isFinished());
+}
+
+TEST_F(TaskSchedulerTest, ContinuationRunsOnMainThread)
+{
+    auto mainThread = std::this_thread::get_id();
+    std::thread::id continuationThread;
+    bool taskRun = false;
+
+    auto task = GlobalTaskScheduler().submitWithContinuation([&](const threading::ITask&)
+    {
+        taskRun = true;
+    },
+    [&]()
+    {
+        continuationThread = std::this_thread::get_id();
+    });
+
+    task->wait();
+    EXPECT_TRUE(taskRun);
+    EXPECT_EQ(continuationThread, std::thread::id()) << "Continuation must wait for the main thread";
+
+    GlobalTaskScheduler().processMainThreadTasks();
+    EXPECT_EQ(continuationThread, mainThread);
+}
+
+TEST_F(TaskSchedulerTest, NoContinuationAfterException)
+{
+    bool continuationRun = false;
+
+    auto task = GlobalTaskScheduler().submitWithContinuation([&](const threading::ITask&)
+    {
+        throw std::runtime_error("Test");
+    },
+    [&]() { continuationRun = true; });
+
+    EXPECT_THROW(task->wait(), std::runtime_error);
+
+    GlobalTaskScheduler().processMainThreadTasks();
+    EXPECT_FALSE(continuationRun);
+}
+
+TEST_F(TaskSchedulerTest, ThreadedDefLoaderReturnsResult)
+{
+    parser::ThreadedDefLoader<int> inner([]() { return 21; });
+
+    // The outer loader is waiting for the inner one from within a task
+    parser::ThreadedDefLoader<int> outer([&]() { return inner.get() * 2; });
+
+    outer.start();
+    EXPECT_EQ(outer.get(), 42);
+
+    outer.reset();
+    inner.reset();
+    EXPECT_EQ(outer.get(), 42);
+}
+
+TEST_F(TaskSchedulerTest, SequentialTaskQueueRunsOneTaskAtATime)
+{
+    std::atomic<int> runningTasks(0);
+    std::atomic<int> processedTasks(0);
+    std::atomic<bool> overlapDetected(false);
+
+    {
+        util::SequentialTaskQueue queue;
+
+        for (int i = 0; i < 10; ++i)
+        {
+            queue.enqueue([&]()
+            {
+                if (++runningTasks > 1) overlapDetected = true;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                --runningTasks;
+                ++processedTasks;
+            });
+        }
+
+        while (processedTasks < 10) std::this_thread::yield();
+    }
+
+    EXPECT_FALSE(overlapDetected) << "Queued tasks have been running concurrently";
+}
+
+}
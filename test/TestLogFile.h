@@ -37,6 +37,11 @@ public:
     }
 
     void writeLog(const std::string& outputStr, applog::LogLevel level) override
+    {
+        writeLogFromThread(outputStr, level, std::this_thread::get_id());
+    }
+
+    void writeLogFromThread(const std::string& outputStr, applog::LogLevel level, std::thread::id sourceThread) override
     {
         _buffer.append(outputStr);
 
@@ -48,7 +53,7 @@ public:
 
             // Write timestamp and thread information
             _logStream << std::put_time(&tm, _timeFormat);
-            _logStream << " (" << std::this_thread::get_id() << ") ";
+            _logStream << " (" << sourceThread << ") ";
 
             // Insert the string into the stream and flush the buffer
             _logStream << _buffer;
@@ -12,6 +12,8 @@
 #include "registry/registry.h"
 #include "render/CameraView.h"
 #include "algorithm/View.h"
+#include "scene/ShaderReplacement.h"
+#include "messages/TextureChanged.h"
 
 namespace test
 {
@@ -509,6 +511,146 @@ TEST_F(TextureManipulationTest, NormaliseFace)
     EXPECT_TRUE(algorithm::faceHasVertex(face, Vector3(-992.0,-280.0,208.0), Vector2(-2.5, 0.75)));
 }
 
+namespace
+{
+
+// Runs the texture command against a selection large enough to be processed in parallel,
+// and compares the result to the per-face method applied to an unselected copy of each brush
+void performFaceBatchTest(const std::function<void()>& runCommand, const std::function<void(IFace&)>& applyToFace)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    std::vector<scene::INodePtr> brushes;
+    std::vector<scene::INodePtr> referenceBrushes;
+
+    // 16 cubes with differently rotated and shifted textures, 96 faces in total
+    for (int i = 0; i < 16; ++i)
+    {
+        Vector3 origin(i * 128, 0, 0);
+
+        brushes.push_back(algorithm::createCubicBrush(worldspawn, origin, "textures/numbers/1"));
+        referenceBrushes.push_back(algorithm::createCubicBrush(worldspawn, origin, "textures/numbers/1"));
+
+        for (const auto& brush : { brushes.back(), referenceBrushes.back() })
+        {
+            for (std::size_t f = 0; f < Node_getIBrush(brush)->getNumFaces(); ++f)
+            {
+                auto& face = Node_getIBrush(brush)->getFace(f);
+                face.rotateTexdef(i * 7.0f);
+                face.shiftTexdefByPixels(i * 3.0f, i * 5.0f);
+            }
+        }
+
+        Node_setSelected(brushes.back(), true);
+    }
+
+    std::vector<Vector2> oldTexcoords;
+
+    for (const auto& brush : brushes)
+    {
+        for (std::size_t f = 0; f < Node_getIBrush(brush)->getNumFaces(); ++f)
+        {
+            for (const auto& vertex : Node_getIBrush(brush)->getFace(f).getWinding())
+            {
+                oldTexcoords.push_back(vertex.texcoord);
+            }
+        }
+    }
+
+    std::size_t numMessages = 0;
+    auto listener = GlobalRadiantCore().getMessageBus().addListener(
+        radiant::IMessage::Type::TextureChanged,
+        radiant::TypeListener<radiant::TextureChangedMessage>(
+            [&](radiant::TextureChangedMessage& msg) { ++numMessages; }));
+
+    runCommand();
+
+    GlobalRadiantCore().getMessageBus().removeListener(listener);
+
+    // The texture tool should not be notified once per face
+    EXPECT_LE(numMessages, 2) << "Expected the texture change to be announced once";
+
+    for (std::size_t i = 0; i < brushes.size(); ++i)
+    {
+        auto brush = Node_getIBrush(brushes[i]);
+        auto referenceBrush = Node_getIBrush(referenceBrushes[i]);
+
+        for (std::size_t f = 0; f < brush->getNumFaces(); ++f)
+        {
+            auto& face = brush->getFace(f);
+            auto& referenceFace = referenceBrush->getFace(f);
+
+            applyToFace(referenceFace);
+
+            ASSERT_EQ(face.getWinding().size(), referenceFace.getWinding().size());
+
+            for (std::size_t v = 0; v < face.getWinding().size(); ++v)
+            {
+                EXPECT_TRUE(math::isNear(face.getWinding()[v].texcoord, referenceFace.getWinding()[v].texcoord, 1e-5))
+                    << "Texcoord should be " << referenceFace.getWinding()[v].texcoord << " but was " << face.getWinding()[v].texcoord;
+            }
+        }
+    }
+
+    // A single undo step is reverting all faces
+    GlobalUndoSystem().undo();
+
+    auto old = oldTexcoords.begin();
+
+    for (const auto& brush : brushes)
+    {
+        for (std::size_t f = 0; f < Node_getIBrush(brush)->getNumFaces(); ++f)
+        {
+            for (const auto& vertex : Node_getIBrush(brush)->getFace(f).getWinding())
+            {
+                EXPECT_TRUE(math::isNear(vertex.texcoord, *old, 1e-5))
+                    << "Texcoord should have been reverted to " << *old << " but was " << vertex.texcoord;
+                ++old;
+            }
+        }
+    }
+}
+
+}
+
+TEST_F(TextureManipulationTest, FitSelectedFaces)
+{
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("FitTexture", { cmd::Argument(2.0), cmd::Argument(3.0) }); },
+        [](IFace& face) { face.fitTexture(2, 3); });
+}
+
+TEST_F(TextureManipulationTest, AlignSelectedFaces)
+{
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("TexAlign", { cmd::Argument("left") }); },
+        [](IFace& face) { face.alignTexture(IFace::AlignEdge::Left); });
+}
+
+TEST_F(TextureManipulationTest, ShiftSelectedFaces)
+{
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("TexShift", { cmd::Argument("12 -7") }); },
+        [](IFace& face) { face.shiftTexdefByPixels(12, -7); });
+}
+
+TEST_F(TextureManipulationTest, ScaleSelectedFaces)
+{
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("TexScale", { cmd::Argument("0.5 -0.25") }); },
+        [](IFace& face) { face.scaleTexdef(1.5f, 0.75f); });
+}
+
+TEST_F(TextureManipulationTest, RotateSelectedFaces)
+{
+    registry::setValue("user/ui/textures/surfaceInspector/rotStep", 25.0f);
+
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("TexRotate", { cmd::Argument("1") }); },
+        [](IFace& face) { face.rotateTexdef(25); });
+}
+
+TEST_F(TextureManipulationTest, NormaliseSelectedFaces)
+{
+    performFaceBatchTest([] { GlobalCommandSystem().executeCommand("NormaliseTexture"); },
+        [](IFace& face) { face.normaliseTexture(); });
+}
+
 TEST_F(TextureManipulationTest, NormalisePatch)
 {
     std::string mapPath = "maps/simple_brushes.map";
@@ -853,4 +995,53 @@ TEST_F(TextureManipulationTest, RotateFuncStaticBrush90)
     }
 }
 
+TEST_F(TextureManipulationTest, FindAndReplaceShader)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    constexpr const char* Find = "textures/numbers/1";
+    constexpr const char* Replace = "textures/numbers/2";
+
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), Find);
+    auto otherBrush = algorithm::createCubicBrush(worldspawn, Vector3(128, 0, 0), "textures/numbers/3");
+    auto patch = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(0, 256, 0), Vector3(64, 64, 64)), Find);
+    Node_getIBrush(otherBrush)->getFace(0).setShader(Find);
+
+    EXPECT_EQ(scene::findAndReplaceShader(Find, Replace, false), 6 + 1 + 1);
+
+    EXPECT_EQ(algorithm::findFirstBrushWithMaterial(worldspawn, Find), scene::INodePtr());
+    EXPECT_EQ(Node_getIPatch(patch)->getShader(), Replace);
+    EXPECT_EQ(Node_getIBrush(otherBrush)->getFace(0).getShader(), Replace);
+    EXPECT_EQ(Node_getIBrush(otherBrush)->getFace(1).getShader(), "textures/numbers/3");
+
+    // All changes are reverted in one step
+    GlobalUndoSystem().undo();
+
+    EXPECT_EQ(Node_getIPatch(patch)->getShader(), Find);
+    EXPECT_EQ(Node_getIBrush(otherBrush)->getFace(0).getShader(), Find);
+
+    for (std::size_t i = 0; i < Node_getIBrush(brush)->getNumFaces(); ++i)
+    {
+        EXPECT_EQ(Node_getIBrush(brush)->getFace(i).getShader(), Find);
+    }
+}
+
+TEST_F(TextureManipulationTest, FindAndReplaceShaderInSelection)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    constexpr const char* Find = "textures/numbers/1";
+    constexpr const char* Replace = "textures/numbers/2";
+
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), Find);
+    auto otherBrush = algorithm::createCubicBrush(worldspawn, Vector3(128, 0, 0), Find);
+
+    Node_setSelected(brush, true);
+
+    EXPECT_EQ(scene::findAndReplaceShader(Find, Replace, true), 6);
+
+    EXPECT_EQ(Node_getIBrush(brush)->getFace(0).getShader(), Replace);
+    EXPECT_EQ(Node_getIBrush(otherBrush)->getFace(0).getShader(), Find);
+}
+
 }
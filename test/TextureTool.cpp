@@ -284,6 +284,102 @@ TEST_F(TextureToolTest, SceneGraphUpdatesOnBrushMaterialChange)
     EXPECT_EQ(getTextureToolNodeCount(), brush1->getNumFaces()) << "There shoud be 6 faces in the tex tool";
 }
 
+// Nodes of faces that stay selected are re-used, but lose their tex tool selection
+TEST_F(TextureToolTest, SceneGraphReusesNodesOfSelectedFaces)
+{
+    std::string material = "textures/numbers/1";
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), material);
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(0, 256, 256), material);
+
+    Node_setSelected(brush1, true);
+
+    auto firstNodes = getAllTextureToolNodes();
+    EXPECT_EQ(firstNodes.size(), 6) << "There should be 6 tex tool nodes";
+
+    firstNodes.front()->setSelected(true);
+
+    Node_setSelected(brush2, true);
+
+    auto secondNodes = getAllTextureToolNodes();
+    EXPECT_EQ(secondNodes.size(), 12) << "There should be 12 tex tool nodes";
+
+    for (const auto& node : firstNodes)
+    {
+        EXPECT_NE(std::find(secondNodes.begin(), secondNodes.end(), node), secondNodes.end()) << "Node should have been re-used";
+        EXPECT_FALSE(node->isSelected()) << "Re-used node should be unselected";
+    }
+
+    Node_setSelected(brush1, false);
+
+    auto thirdNodes = getAllTextureToolNodes();
+    EXPECT_EQ(thirdNodes.size(), 6) << "There should be 6 tex tool nodes";
+
+    for (const auto& node : firstNodes)
+    {
+        EXPECT_EQ(std::find(thirdNodes.begin(), thirdNodes.end(), node), thirdNodes.end()) << "Node should have been removed";
+    }
+}
+
+inline std::vector<textool::INode::Ptr> getTextureToolNodesInBounds(const AABB& bounds)
+{
+    render::TextureToolView view;
+    view.constructFromTextureSpaceBounds(bounds, 500, 400);
+
+    std::vector<textool::INode::Ptr> list;
+
+    GlobalTextureToolSceneGraph().foreachNodeInVolume(view, [&](const textool::INode::Ptr& node)
+    {
+        list.push_back(node);
+        return true;
+    });
+
+    return list;
+}
+
+TEST_F(TextureToolTest, SceneGraphNodesInVolume)
+{
+    std::string material = "textures/numbers/1";
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush1 = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), material);
+    auto brush2 = algorithm::createCubicBrush(worldspawn, Vector3(512, 512, 0), material);
+
+    Node_setSelected(brush1, true);
+    Node_setSelected(brush2, true);
+
+    auto faceUp1 = algorithm::findBrushFaceWithNormal(Node_getIBrush(brush1), Vector3(0, 0, 1));
+    auto faceUp2 = algorithm::findBrushFaceWithNormal(Node_getIBrush(brush2), Vector3(0, 0, 1));
+
+    auto findNodeOfFace = [](const std::vector<textool::INode::Ptr>& nodes, IFace* face)
+    {
+        return std::find_if(nodes.begin(), nodes.end(), [&](const textool::INode::Ptr& node)
+        {
+            auto faceNode = std::dynamic_pointer_cast<textool::IFaceNode>(node);
+            return faceNode && &faceNode->getFace() == face;
+        }) != nodes.end();
+    };
+
+    auto bounds = algorithm::getTextureSpaceBounds(*faceUp1);
+    bounds.extents *= 1.2f;
+
+    auto nodes = getTextureToolNodesInBounds(bounds);
+    EXPECT_TRUE(findNodeOfFace(nodes, faceUp1)) << "Face 1 should be in the volume";
+    EXPECT_FALSE(findNodeOfFace(nodes, faceUp2)) << "Face 2 should be outside the volume";
+    EXPECT_LT(nodes.size(), getTextureToolNodeCount()) << "Not all nodes should be in the volume";
+
+    // Move the texture of the first face, the index needs to follow
+    faceUp1->shiftTexdef(10, 10);
+
+    nodes = getTextureToolNodesInBounds(bounds);
+    EXPECT_FALSE(findNodeOfFace(nodes, faceUp1)) << "Face 1 should have left the volume";
+
+    auto shiftedBounds = algorithm::getTextureSpaceBounds(*faceUp1);
+    shiftedBounds.extents *= 1.2f;
+
+    nodes = getTextureToolNodesInBounds(shiftedBounds);
+    EXPECT_TRUE(findNodeOfFace(nodes, faceUp1)) << "Face 1 should be found at its new position";
+}
+
 TEST_F(TextureToolTest, PatchNodeBounds)
 {
     auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
@@ -655,6 +751,82 @@ void performPointSelection(const Vector2& texcoord, const render::View& view, se
     GlobalTextureToolSelectionSystem().selectPoint(test, mode);
 }
 
+TEST_F(TextureToolTest, FaceNodeSurfaceTriangles)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brush = algorithm::createCubicBrush(worldspawn, Vector3(0, 0, 0), "textures/numbers/1");
+    Node_setSelected(brush, true);
+
+    auto node = getFirstTextureToolNode();
+    auto faceNode = std::dynamic_pointer_cast<textool::IFaceNode>(node);
+    ASSERT_TRUE(faceNode) << "Expected a face node";
+
+    const auto& winding = faceNode->getFace().getWinding();
+
+    std::vector<Vector2> triangles;
+    node->getSurfaceTriangles(triangles);
+    EXPECT_EQ(triangles.size(), (winding.size() - 2) * 3) << "Winding should be split into a triangle fan";
+
+    for (const auto& texcoord : triangles)
+    {
+        EXPECT_NE(std::find_if(winding.begin(), winding.end(), [&](const WindingVertex& vertex)
+        {
+            return vertex.texcoord == texcoord;
+        }), winding.end()) << "Triangles should use the winding texcoords";
+    }
+
+    // Select one vertex, it should be reported as such
+    auto componentSelectable = std::dynamic_pointer_cast<textool::IComponentSelectable>(node);
+    auto bounds = node->localAABB();
+    bounds.extents *= 1.2f;
+
+    render::TextureToolView view;
+    view.constructFromTextureSpaceBounds(bounds, TEXTOOL_WIDTH, TEXTOOL_HEIGHT);
+
+    GlobalTextureToolSelectionSystem().setSelectionMode(textool::SelectionMode::Vertex);
+    performPointSelection(winding.front().texcoord, view);
+
+    std::size_t vertexCount = 0;
+    std::size_t selectedCount = 0;
+
+    componentSelectable->foreachComponentVertex([&](const Vector2& texcoord, bool selected)
+    {
+        ++vertexCount;
+
+        if (selected)
+        {
+            ++selectedCount;
+            EXPECT_EQ(texcoord, winding.front().texcoord) << "Wrong vertex reported as selected";
+        }
+    });
+
+    EXPECT_EQ(vertexCount, winding.size()) << "Every winding vertex should be reported";
+    EXPECT_EQ(selectedCount, componentSelectable->getNumSelectedComponents()) << "Selection state mismatch";
+}
+
+TEST_F(TextureToolTest, PatchNodeSurfaceTriangles)
+{
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto patchNode = algorithm::createPatchFromBounds(worldspawn, AABB(Vector3(4, 50, 60), Vector3(64, 128, 256)), "textures/numbers/1");
+    Node_setSelected(patchNode, true);
+
+    auto node = getFirstTextureToolNode();
+    ASSERT_TRUE(std::dynamic_pointer_cast<textool::IPatchNode>(node)) << "Expected a patch node";
+
+    std::vector<Vector2> triangles;
+    node->getSurfaceTriangles(triangles);
+
+    EXPECT_FALSE(triangles.empty()) << "Patch should have produced triangles";
+    EXPECT_EQ(triangles.size() % 3, 0) << "Expected three texcoords per triangle";
+
+    auto bounds = node->localAABB();
+
+    for (const auto& texcoord : triangles)
+    {
+        EXPECT_TRUE(bounds.intersects(Vector3(texcoord.x(), texcoord.y(), 0))) << "Triangle texcoord out of bounds";
+    }
+}
+
 TEST_F(TextureToolTest, TestSelectPatchSurfaceByPoint)
 {
     auto patchNode = setupPatchNodeForTextureTool();
@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include "time/TraceRecorder.h"
+
+namespace test
+{
+
+namespace
+{
+
+// Points the scoped trace events to the given recorder during its lifetime
+class ScopedRecorderOverride
+{
+private:
+    util::TraceRecorder* _previous;
+
+public:
+    ScopedRecorderOverride(util::TraceRecorder& recorder) :
+        _previous(util::GlobalTraceRecorderPtr())
+    {
+        util::GlobalTraceRecorderPtr() = &recorder;
+    }
+
+    ~ScopedRecorderOverride()
+    {
+        util::GlobalTraceRecorderPtr() = _previous;
+    }
+};
+
+}
+
+TEST(TraceRecorderTest, DisabledRecorderIgnoresEvents)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    {
+        util::ScopedTraceEvent event("test", "Ignored");
+    }
+
+    EXPECT_TRUE(recorder.getEvents().empty());
+}
+
+TEST(TraceRecorderTest, NestedEventsEncloseEachOther)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    recorder.enable();
+
+    {
+        util::ScopedTraceEvent outer("test", "Outer");
+        util::ScopedTraceEvent inner("test", "Inner");
+    }
+
+    auto events = recorder.getEvents();
+    ASSERT_EQ(events.size(), 2);
+
+    // The inner event ends first
+    const auto& inner = events[0];
+    const auto& outer = events[1];
+
+    EXPECT_EQ(inner.name, "Inner");
+    EXPECT_EQ(outer.name, "Outer");
+    EXPECT_EQ(outer.category, "test");
+    EXPECT_EQ(inner.threadIndex, outer.threadIndex);
+    EXPECT_GE(inner.startMicroseconds, outer.startMicroseconds);
+    EXPECT_LE(inner.startMicroseconds + inner.durationMicroseconds,
+        outer.startMicroseconds + outer.durationMicroseconds);
+}
+
+TEST(TraceRecorderTest, EventsOfOtherThreadsGetTheirOwnIndex)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    recorder.enable();
+
+    std::thread([&]()
+    {
+        util::ScopedTraceEvent event("test", "Worker");
+    }).join();
+
+    {
+        util::ScopedTraceEvent event("test", "Main");
+    }
+
+    auto events = recorder.getEvents();
+    ASSERT_EQ(events.size(), 2);
+
+    EXPECT_EQ(events[0].name, "Worker");
+    EXPECT_EQ(events[0].threadIndex, 1);
+    EXPECT_EQ(events[1].name, "Main");
+    EXPECT_EQ(events[1].threadIndex, 0);
+}
+
+TEST(TraceRecorderTest, CaptureReturnsTheEventsOfItsTimeSpan)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    auto marker = recorder.beginCapture();
+    EXPECT_TRUE(recorder.isEnabled());
+
+    {
+        util::ScopedTraceEvent event("test", "Captured");
+    }
+
+    auto events = recorder.endCapture(marker);
+
+    ASSERT_EQ(events.size(), 1);
+    EXPECT_EQ(events[0].name, "Captured");
+
+    // Without export, the captured events are not kept and recording stops
+    EXPECT_FALSE(recorder.isEnabled());
+    EXPECT_TRUE(recorder.getEvents().empty());
+
+    {
+        util::ScopedTraceEvent event("test", "Ignored");
+    }
+
+    EXPECT_TRUE(recorder.getEvents().empty());
+}
+
+TEST(TraceRecorderTest, CaptureKeepsEventsForExport)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    recorder.enable();
+
+    auto marker = recorder.beginCapture();
+
+    {
+        util::ScopedTraceEvent event("test", "Captured");
+    }
+
+    EXPECT_EQ(recorder.endCapture(marker).size(), 1);
+
+    EXPECT_TRUE(recorder.isEnabled());
+    EXPECT_EQ(recorder.getEvents().size(), 1);
+}
+
+TEST(TraceRecorderTest, WriteChromeTrace)
+{
+    util::TraceRecorder recorder;
+    ScopedRecorderOverride recorderOverride(recorder);
+
+    recorder.enable();
+
+    {
+        util::ScopedTraceEvent event("test", "Load \"textures/common\\caulk\"");
+    }
+
+    std::ostringstream stream;
+    recorder.writeChromeTrace(stream);
+
+    auto json = stream.str();
+
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+    EXPECT_NE(json.find(R"("name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"Main thread"})"), std::string::npos);
+    EXPECT_NE(json.find(R"("name":"Load \"textures/common\\caulk\"","cat":"test","ph":"X")"), std::string::npos);
+    EXPECT_NE(json.rfind("]}"), std::string::npos);
+}
+
+}
@@ -9,6 +9,9 @@
 #include "selection/SelectedPlaneSet.h"
 #include "render/View.h"
 #include "algorithm/View.h"
+#include "algorithm/Primitives.h"
+#include "registry/registry.h"
+#include "math/Quaternion.h"
 
 namespace test
 {
@@ -65,6 +68,59 @@ TEST_F(TransformationTest, TranslationAfterRotatingGenericEntity)
     EXPECT_EQ(angleAfterTransformation, initialAngle);
 }
 
+TEST_F(TransformationTest, RotateManyBrushesWithTextureLock)
+{
+    registry::setValue(RKEY_ENABLE_TEXTURE_LOCK, true);
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+
+    // Enough brushes to have their windings rebuilt in parallel
+    std::vector<scene::INodePtr> brushes;
+
+    for (int x = 0; x < 12; ++x)
+    {
+        for (int y = 0; y < 12; ++y)
+        {
+            auto brush = algorithm::createCubicBrush(worldspawn, Vector3(x * 256, y * 256, 0), "textures/numbers/1");
+            Node_setSelected(brush, true);
+            brushes.push_back(brush);
+        }
+    }
+
+    // Remember the vertices and texture coordinates of the top faces
+    std::vector<std::vector<WindingVertex>> topVertices;
+
+    for (const auto& brush : brushes)
+    {
+        auto face = algorithm::findBrushFaceWithNormal(Node_getIBrush(brush), Vector3(0, 0, 1));
+        topVertices.emplace_back(face->getWinding().begin(), face->getWinding().end());
+    }
+
+    auto pivot = GlobalSelectionSystem().getPivot2World().translation();
+    auto rotation = Quaternion::createForEulerXYZDegrees(Vector3(0, 0, 90));
+    auto rotationMatrix = Matrix4::getRotationQuantised(rotation);
+
+    GlobalCommandSystem().executeCommand("RotateSelectedEulerXYZ", cmd::Argument(Vector3(0, 0, 90)));
+
+    // The windings are rebuilt, the texture coordinates stick to the rotated vertices
+    for (std::size_t i = 0; i < brushes.size(); ++i)
+    {
+        auto brush = Node_getIBrush(brushes[i]);
+        auto face = algorithm::findBrushFaceWithNormal(brush, Vector3(0, 0, 1));
+        ASSERT_TRUE(face) << "Top face of brush " << i << " not found";
+
+        for (const auto& vertex : topVertices[i])
+        {
+            auto expectedPosition = pivot + rotationMatrix.transformPoint(vertex.vertex - pivot);
+
+            EXPECT_TRUE(algorithm::faceHasVertex(face, expectedPosition, vertex.texcoord))
+                << "Brush " << i << " doesn't have the rotated vertex " << expectedPosition;
+        }
+    }
+
+    registry::setValue(RKEY_ENABLE_TEXTURE_LOCK, false);
+}
+
 scene::INodePtr createAndSelectLight()
 {
     // Create an entity which has editor_mins/editor_maxs defined (GenericEntity)
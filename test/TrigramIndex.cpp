@@ -0,0 +1,77 @@
+#include "gtest/gtest.h"
+
+#include "string/TrigramIndex.h"
+
+namespace test
+{
+
+namespace
+{
+
+string::TrigramIndex createIndex()
+{
+    string::TrigramIndex index;
+
+    index.add("textures/common/caulk");
+    index.add("textures/darkmod/stone/brick/rough_big_blocks");
+    index.add("textures/darkmod/wood/boards/rough_planks");
+    index.add("models/darkmod/props/crate.lwo");
+    index.add("ab");
+
+    return index;
+}
+
+}
+
+TEST(TrigramIndexTest, AddReturnsSequentialIndices)
+{
+    string::TrigramIndex index;
+
+    EXPECT_EQ(index.add("first"), 0);
+    EXPECT_EQ(index.add("second"), 1);
+    EXPECT_EQ(index.add("first"), 2) << "Duplicates are stored separately";
+
+    EXPECT_EQ(index.size(), 3);
+    EXPECT_EQ(index.get(1), "second");
+}
+
+TEST(TrigramIndexTest, FindMatches)
+{
+    auto index = createIndex();
+
+    EXPECT_EQ(index.findMatches("rough"), std::vector<std::size_t>({ 1, 2 }));
+    EXPECT_EQ(index.findMatches("darkmod"), std::vector<std::size_t>({ 1, 2, 3 }));
+    EXPECT_EQ(index.findMatches("caulk"), std::vector<std::size_t>({ 0 }));
+    EXPECT_EQ(index.findMatches("crate.lwo"), std::vector<std::size_t>({ 3 }));
+    EXPECT_TRUE(index.findMatches("metal").empty());
+}
+
+TEST(TrigramIndexTest, FindMatchesVerifiesOrder)
+{
+    string::TrigramIndex index;
+
+    // Contains all trigrams of "abcabd" but not the needle itself
+    index.add("abcab_bca_cab_abd");
+    index.add("xabcabdx");
+
+    EXPECT_EQ(index.findMatches("abcabd"), std::vector<std::size_t>({ 1 }));
+}
+
+TEST(TrigramIndexTest, FindShortNeedles)
+{
+    auto index = createIndex();
+
+    EXPECT_EQ(index.findMatches("ab"), std::vector<std::size_t>({ 4 }));
+    EXPECT_EQ(index.findMatches("/"), std::vector<std::size_t>({ 0, 1, 2, 3 }));
+    EXPECT_EQ(index.findMatches(""), std::vector<std::size_t>({ 0, 1, 2, 3, 4 })) << "Empty needle matches everything";
+}
+
+TEST(TrigramIndexTest, FindIsCaseSensitive)
+{
+    auto index = createIndex();
+
+    EXPECT_TRUE(index.findMatches("Caulk").empty());
+    EXPECT_TRUE(index.findMatches("AB").empty());
+}
+
+}
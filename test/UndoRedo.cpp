@@ -85,6 +85,48 @@ TEST_F(UndoTest, BrushCreation)
     EXPECT_TRUE(GlobalMapModule().isModified()) << "Map should be changed again after redo";
 }
 
+TEST_F(UndoTest, OperationStatistics)
+{
+    std::string mapPath = "maps/simple_brushes.map";
+    GlobalCommandSystem().executeCommand("OpenMap", mapPath);
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto brushNode = algorithm::findFirstBrushWithMaterial(worldspawn, "textures/numbers/1");
+    ASSERT_TRUE(brushNode) << "Could not locate the test brush";
+
+    auto& brush = *Node_getIBrush(brushNode);
+    auto numFaces = brush.getNumFaces();
+
+    {
+        UndoableCommand cmd("setMaterial");
+        brush.setShader("textures/numbers/19");
+    }
+
+    auto statistics = GlobalUndoSystem().getStatistics();
+
+    ASSERT_EQ(statistics.undoOperations.size(), 1) << "Expected one recorded operation";
+    EXPECT_EQ(statistics.undoOperations.front().name, "setMaterial");
+    EXPECT_EQ(statistics.undoOperations.front().numStates, numFaces) << "Each face should have saved its state";
+    EXPECT_GT(statistics.undoOperations.front().memoryUsage, 0) << "Operation should report its memory usage";
+    EXPECT_TRUE(statistics.redoOperations.empty());
+
+    ASSERT_EQ(statistics.undoableTypes.count("Face"), 1) << "Face type should be listed";
+    EXPECT_EQ(statistics.undoableTypes["Face"].numStates, numFaces);
+    EXPECT_EQ(statistics.undoableTypes["Face"].numExports, numFaces);
+    EXPECT_EQ(statistics.undoableTypes["Face"].numImports, 0);
+    EXPECT_EQ(statistics.numUndos, 0);
+
+    GlobalUndoSystem().undo();
+    statistics = GlobalUndoSystem().getStatistics();
+
+    EXPECT_TRUE(statistics.undoOperations.empty());
+    ASSERT_EQ(statistics.redoOperations.size(), 1) << "Expected the operation to be redoable";
+    EXPECT_EQ(statistics.redoOperations.front().numStates, numFaces);
+    EXPECT_EQ(statistics.undoableTypes["Face"].numImports, numFaces) << "Each face should have imported its state";
+    EXPECT_EQ(statistics.numUndos, 1);
+    EXPECT_EQ(statistics.numRedos, 0);
+}
+
 namespace
 {
 
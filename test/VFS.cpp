@@ -1,8 +1,11 @@
 #include "RadiantTest.h"
 
 #include "ifilesystem.h"
+#include "idatastream.h"
 #include "os/path.h"
 #include "os/file.h"
+#include "string/replace.h"
+#include "testutil/TemporaryFile.h"
 
 namespace test
 {
@@ -176,6 +179,229 @@ TEST_F(VfsTest, openArchiveInAbsolutePath)
     ASSERT_NE(contents.find("textures/AFX/AFXmodulate"), std::string::npos);
 }
 
+namespace
+{
+
+std::string readBinaryFile(const ArchiveFilePtr& file)
+{
+    std::string contents;
+    InputStream::byte_type buffer[16];
+
+    for (std::size_t bytesRead; (bytesRead = file->getInputStream().read(buffer, sizeof(buffer))) > 0;)
+    {
+        contents.append(reinterpret_cast<const char*>(buffer), bytesRead);
+    }
+
+    return contents;
+}
+
+std::string readTextFile(const ArchiveTextFilePtr& file)
+{
+    std::istream fileStream(&(file->getInputStream()));
+    return std::string(std::istreambuf_iterator<char>(fileStream), {});
+}
+
+}
+
+TEST_F(VfsTest, ReadStoredAndDeflatedFilesInArchive)
+{
+    fs::path pk4Path = _context.getTestResourcePath();
+    pk4Path /= "zip_stored_entries.pk4";
+
+    auto archive = GlobalFileSystem().openArchiveInAbsolutePath(pk4Path.string());
+    ASSERT_TRUE(archive) << "Could not open " << pk4Path.string();
+
+    std::string storedContents = "textures/stored\r\n{\r\n    diffusemap _white\r\n}\r\n";
+    std::string deflatedContents;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        deflatedContents += "textures/deflated\r\n{\r\n    diffusemap _black\r\n}\r\n";
+    }
+
+    // Binary files return the contents as they are
+    auto storedFile = archive->openFile("materials/stored.mtr");
+    ASSERT_TRUE(storedFile);
+    EXPECT_EQ(storedFile->size(), storedContents.size());
+    EXPECT_EQ(readBinaryFile(storedFile), storedContents);
+
+    auto deflatedFile = archive->openFile("materials/deflated.mtr");
+    ASSERT_TRUE(deflatedFile);
+    EXPECT_EQ(deflatedFile->size(), deflatedContents.size());
+    EXPECT_EQ(readBinaryFile(deflatedFile), deflatedContents);
+
+    // Text files have their line endings converted
+    EXPECT_EQ(readTextFile(archive->openTextFile("materials/stored.mtr")), string::replace_all_copy(storedContents, "\r", ""));
+    EXPECT_EQ(readTextFile(archive->openTextFile("materials/deflated.mtr")), string::replace_all_copy(deflatedContents, "\r", ""));
+}
+
+TEST_F(VfsTest, MappedDataOfStoredFilesInArchive)
+{
+    fs::path pk4Path = _context.getTestResourcePath();
+    pk4Path /= "zip_stored_entries.pk4";
+
+    auto archive = GlobalFileSystem().openArchiveInAbsolutePath(pk4Path.string());
+    ASSERT_TRUE(archive) << "Could not open " << pk4Path.string();
+
+    auto storedFile = archive->openFile("materials/stored.mtr");
+    ASSERT_TRUE(storedFile);
+
+    // Stored files are served right from the mapped archive
+    auto mappedData = storedFile->getMappedData();
+    ASSERT_TRUE(mappedData);
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(mappedData.get()), storedFile->size()),
+        readBinaryFile(storedFile));
+
+    // The data remains valid after the file and the archive are gone
+    storedFile.reset();
+    archive.reset();
+    EXPECT_EQ(std::string(reinterpret_cast<const char*>(mappedData.get()), 15), "textures/stored");
+
+    // Deflated files need to be read through their stream
+    archive = GlobalFileSystem().openArchiveInAbsolutePath(pk4Path.string());
+    auto deflatedFile = archive->openFile("materials/deflated.mtr");
+    ASSERT_TRUE(deflatedFile);
+    EXPECT_FALSE(deflatedFile->getMappedData());
+}
+
+TEST_F(VfsTest, InterleavedReadsOfDeflatedFiles)
+{
+    // A small file inflated in one go and a large one inflated while reading
+    const std::vector<std::string> files{ "materials/tdm_ai_nobles.mtr", "maps/altar_in_pk4.map" };
+
+    std::vector<std::string> expectedContents;
+
+    for (const auto& name : files)
+    {
+        expectedContents.push_back(readBinaryFile(GlobalFileSystem().openFile(name)));
+        EXPECT_EQ(expectedContents.back().size(), GlobalFileSystem().openFile(name)->size()) << name;
+    }
+
+    // Open the files again and repeatedly, the pooled inflate states must not interfere
+    for (int round = 0; round < 3; ++round)
+    {
+        std::vector<ArchiveFilePtr> openedFiles;
+        std::vector<std::string> contents(files.size());
+
+        for (const auto& name : files)
+        {
+            openedFiles.push_back(GlobalFileSystem().openFile(name));
+            ASSERT_TRUE(openedFiles.back()) << name;
+        }
+
+        InputStream::byte_type buffer[100];
+
+        for (bool dataLeft = true; dataLeft;)
+        {
+            dataLeft = false;
+
+            for (std::size_t i = 0; i < openedFiles.size(); ++i)
+            {
+                auto bytesRead = openedFiles[i]->getInputStream().read(buffer, sizeof(buffer));
+                contents[i].append(reinterpret_cast<const char*>(buffer), bytesRead);
+                dataLeft |= bytesRead > 0;
+            }
+        }
+
+        EXPECT_EQ(contents, expectedContents);
+    }
+}
+
+TEST_F(VfsTest, ArchiveFilesOutliveTheirArchive)
+{
+    fs::path pk4Path = _context.getTestResourcePath();
+    pk4Path /= "zip_stored_entries.pk4";
+
+    auto archive = GlobalFileSystem().openArchiveInAbsolutePath(pk4Path.string());
+    ASSERT_TRUE(archive) << "Could not open " << pk4Path.string();
+
+    auto storedFile = archive->openFile("materials/stored.mtr");
+    auto deflatedTextFile = archive->openTextFile("materials/deflated.mtr");
+    ASSERT_TRUE(storedFile);
+    ASSERT_TRUE(deflatedTextFile);
+
+    // The opened files need to remain readable after the archive is gone
+    archive.reset();
+
+    EXPECT_EQ(readBinaryFile(storedFile), "textures/stored\r\n{\r\n    diffusemap _white\r\n}\r\n");
+    EXPECT_EQ(readTextFile(deflatedTextFile).find("textures/deflated\n{\n    diffusemap _black\n}\n"), 0);
+}
+
+TEST_F(VfsTest, ReinitialiseUsingArchiveIndexCache)
+{
+    auto collectFiles = []()
+    {
+        std::set<std::string> files;
+        GlobalFileSystem().forEachFile("", "*", [&](const vfs::FileInfo& fi) { files.insert(fi.name); }, 0);
+        return files;
+    };
+
+    auto filesBefore = collectFiles();
+
+    // The initialisation of the test fixture should have written the cache
+    EXPECT_TRUE(fs::exists(_context.getCacheDataPath() + "vfs_index.cache"));
+
+    // Initialise again, this time the archives are constructed from the cache
+    auto searchPaths = GlobalFileSystem().getVfsSearchPaths();
+    auto extensions = GlobalFileSystem().getArchiveExtensions();
+
+    GlobalFileSystem().shutdown();
+    GlobalFileSystem().initialise(searchPaths, extensions);
+
+    EXPECT_EQ(collectFiles(), filesBefore);
+    EXPECT_EQ(GlobalFileSystem().getFileCount("materials/tdm_bloom_afx.mtr"), 1);
+    EXPECT_EQ(GlobalFileSystem().findFile("materials/tdm_bloom_afx.mtr"), "");
+
+    auto file = GlobalFileSystem().openTextFile("materials/tdm_bloom_afx.mtr");
+    ASSERT_TRUE(file);
+    EXPECT_NE(readTextFile(file).find("textures/AFX/AFXmodulate"), std::string::npos);
+}
+
+TEST_F(VfsTest, FilesAreAssignedToTheirArchive)
+{
+    // The archives are opened concurrently, every file has to end up at the right one
+    std::map<std::string, std::string> filesInArchive
+    {
+        { "def/altar_lights.def", "altar.pk4" },
+        { "materials/tdm_bloom_afx.mtr", "tdm_example_mtrs.pk4" },
+        { "skins/skins_within_pk4.skin", "test_decls.pk4" },
+        { "particles/override_test.prt", "test_particles.pk4" },
+    };
+
+    for (const auto& [file, archiveName] : filesInArchive)
+    {
+        auto info = GlobalFileSystem().getFileInfo(file);
+
+        EXPECT_FALSE(info.getIsPhysicalFile()) << file;
+        EXPECT_EQ(os::getFilename(info.getArchivePath()), archiveName) << file;
+    }
+}
+
+TEST_F(VfsTest, PakFileLookupIsCaseInsensitive)
+{
+    EXPECT_EQ(GlobalFileSystem().getFileCount("Materials/TDM_Bloom_AFX.mtr"), 1);
+
+    auto file = GlobalFileSystem().openTextFile("MATERIALS/tdm_bloom_afx.MTR");
+    ASSERT_TRUE(file);
+    EXPECT_NE(readTextFile(file).find("textures/AFX/AFXmodulate"), std::string::npos);
+
+    EXPECT_TRUE(GlobalFileSystem().openFile("materials/TDM_BLOOM_AFX.mtr"));
+    EXPECT_FALSE(GlobalFileSystem().openFile("materials/tdm_bloom_afx_nothere.mtr"));
+}
+
+TEST_F(VfsTest, FilesCreatedAfterInitialisationAreFound)
+{
+    // Physical directories are not part of the file index, new files need to show up
+    TemporaryFile tempFile(_context.getTestProjectPath() + "materials/vfs_temp_file.mtr");
+    tempFile.setContents("textures/temporary/vfs\n{\n}\n");
+
+    EXPECT_EQ(GlobalFileSystem().getFileCount("materials/vfs_temp_file.mtr"), 1);
+
+    auto file = GlobalFileSystem().openTextFile("materials/vfs_temp_file.mtr");
+    ASSERT_TRUE(file);
+    EXPECT_EQ(readTextFile(file), "textures/temporary/vfs\n{\n}\n");
+}
+
 TEST_F(VfsTest, VisitEachFileInArchive)
 {
     fs::path pk4Path = _context.getTestProjectPath();
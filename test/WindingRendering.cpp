@@ -629,4 +629,88 @@ TEST_F(WindingRendererTest, IndexRemapsUpdatedAfterReallocation)
     EXPECT_EQ(entity2VertexOffset, firstVertexOffsetAfterMove) << "First vertex offset of both entities should match";
 }
 
+// Object renderer remembering the vertex ranges submitted through submitGeometryRanges
+class RangeRecordingObjectRenderer :
+    public TestObjectRenderer
+{
+public:
+    struct Submission
+    {
+        render::IGeometryStore::Slot slot;
+        GLenum mode;
+        std::vector<GLint> firstVertices;
+        std::vector<GLsizei> counts;
+    };
+
+    std::vector<Submission> submissions;
+
+    void submitGeometryRanges(render::IGeometryStore::Slot slot, GLenum primitiveMode,
+        const std::vector<GLint>& firstVertices, const std::vector<GLsizei>& counts) override
+    {
+        submissions.push_back({ slot, primitiveMode, firstVertices, counts });
+    }
+};
+
+TEST_F(WindingRendererTest, HighlightedWindingsAreBatchedPerWindingSize)
+{
+    render::GeometryStore geometryStore(syncObjectProvider, bufferObjectProvider);
+    RangeRecordingObjectRenderer objectRenderer;
+    auto shader = GlobalRenderSystem().capture("textures/common/caulk");
+    auto entity = algorithm::createEntityByClassName("func_static");
+    scene::addNodeToContainer(entity, GlobalMapModule().getRoot());
+
+    render::WindingRenderer<render::WindingIndexer_Triangles> renderer(geometryStore, objectRenderer, shader.get());
+
+    auto slot1 = renderer.addWinding(generateVertices(1, 4), entity.get());
+    renderer.addWinding(generateVertices(2, 4), entity.get());
+    auto slot3 = renderer.addWinding(generateVertices(3, 4), entity.get());
+    auto slot4 = renderer.addWinding(generateVertices(4, 3), entity.get());
+    renderer.prepareForRendering();
+
+    // Only the first winding added to a batch yields the renderable
+    auto batch = renderer.addHighlightedWinding(slot1, 1);
+    EXPECT_NE(batch, nullptr) << "First winding should return the batch renderable";
+    EXPECT_EQ(renderer.addHighlightedWinding(slot3, 1), nullptr) << "Batch has already been handed out";
+    EXPECT_EQ(renderer.addHighlightedWinding(slot4, 1), nullptr) << "Batch has already been handed out";
+
+    // A different key is a different batch
+    auto otherBatch = renderer.addHighlightedWinding(slot4, 2);
+    EXPECT_NE(otherBatch, nullptr);
+    EXPECT_NE(otherBatch, batch);
+
+    batch->render();
+
+    // One submission per winding size, drawing the ranges of the highlighted windings
+    ASSERT_EQ(objectRenderer.submissions.size(), 2);
+
+    auto& quads = objectRenderer.submissions.at(0);
+    EXPECT_EQ(quads.mode, GL_POLYGON);
+    EXPECT_EQ(quads.firstVertices, std::vector<GLint>({ 0, 8 }));
+    EXPECT_EQ(quads.counts, std::vector<GLsizei>({ 4, 4 }));
+
+    auto& triangles = objectRenderer.submissions.at(1);
+    EXPECT_NE(triangles.slot, quads.slot) << "Winding sizes are stored in different buckets";
+    EXPECT_EQ(triangles.firstVertices, std::vector<GLint>({ 0 }));
+    EXPECT_EQ(triangles.counts, std::vector<GLsizei>({ 3 }));
+
+    // Removing a winding moves the ones behind it, the batch needs to follow
+    renderer.removeWinding(slot1);
+    renderer.prepareForRendering();
+
+    objectRenderer.submissions.clear();
+    batch->render();
+
+    ASSERT_EQ(objectRenderer.submissions.size(), 2);
+    EXPECT_EQ(objectRenderer.submissions.at(0).firstVertices, std::vector<GLint>({ 4 })) << "Removed winding should be skipped";
+
+    // After clearing, the next winding starts the batch again
+    renderer.clearHighlightedWindings();
+
+    objectRenderer.submissions.clear();
+    batch->render();
+    EXPECT_TRUE(objectRenderer.submissions.empty()) << "Cleared batch should not submit anything";
+
+    EXPECT_EQ(renderer.addHighlightedWinding(slot3, 1), batch) << "Batch should be handed out again";
+}
+
 }
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <random>
+#include "imap.h"
+#include "ientity.h"
+#include "string/convert.h"
+#include "Entity.h"
+#include "Primitives.h"
+
+namespace test
+{
+
+namespace algorithm
+{
+
+// Parameters of the map created by createProceduralMap
+struct ProceduralMapSettings
+{
+    // The rooms are arranged in a grid of roomsX * roomsY cells
+    std::size_t roomsX = 16;
+    std::size_t roomsY = 16;
+
+    double roomSize = 512;
+    double wallThickness = 16;
+
+    std::size_t patchesPerRoom = 2;
+
+    // Each of these is a func_static holding a single brush
+    std::size_t staticsPerRoom = 2;
+
+    // The same seed always produces the same map
+    unsigned int seed = 1;
+};
+
+struct ProceduralMapStatistics
+{
+    std::size_t numBrushes = 0;
+    std::size_t numPatches = 0;
+    std::size_t numEntities = 0;
+};
+
+/**
+ * Fills the current map with a grid of closed rooms, each of them made of six brushes,
+ * holding a few patches, func_static entities and a light. Room heights, object
+ * positions and materials are chosen randomly, but reproducibly for a given seed.
+ * This provides large test scenes without depending on the game assets.
+ */
+inline ProceduralMapStatistics createProceduralMap(const ProceduralMapSettings& settings = ProceduralMapSettings())
+{
+    ProceduralMapStatistics statistics;
+
+    std::mt19937 generator(settings.seed);
+    std::uniform_real_distribution<double> heightFactor(0.5, 1.0);
+    std::uniform_real_distribution<double> position(0.2, 0.8);
+    std::uniform_int_distribution<int> materialNumber(0, 5);
+
+    auto randomMaterial = [&]() { return "textures/numbers/" + std::to_string(materialNumber(generator)); };
+
+    auto worldspawn = GlobalMapModule().findOrInsertWorldspawn();
+    auto root = GlobalMapModule().getRoot();
+
+    auto halfWall = settings.wallThickness / 2;
+
+    for (std::size_t x = 0; x < settings.roomsX; ++x)
+    {
+        for (std::size_t y = 0; y < settings.roomsY; ++y)
+        {
+            auto size = settings.roomSize;
+            auto height = settings.roomSize * heightFactor(generator);
+            Vector3 corner(x * size, y * size, 0);
+            Vector3 center = corner + Vector3(size / 2, size / 2, height / 2);
+
+            // Floor, ceiling and the four walls
+            createCuboidBrush(worldspawn, AABB(center - Vector3(0, 0, height / 2), Vector3(size / 2, size / 2, halfWall)), randomMaterial());
+            createCuboidBrush(worldspawn, AABB(center + Vector3(0, 0, height / 2), Vector3(size / 2, size / 2, halfWall)), randomMaterial());
+            createCuboidBrush(worldspawn, AABB(center - Vector3(size / 2, 0, 0), Vector3(halfWall, size / 2, height / 2)), randomMaterial());
+            createCuboidBrush(worldspawn, AABB(center + Vector3(size / 2, 0, 0), Vector3(halfWall, size / 2, height / 2)), randomMaterial());
+            createCuboidBrush(worldspawn, AABB(center - Vector3(0, size / 2, 0), Vector3(size / 2, halfWall, height / 2)), randomMaterial());
+            createCuboidBrush(worldspawn, AABB(center + Vector3(0, size / 2, 0), Vector3(size / 2, halfWall, height / 2)), randomMaterial());
+            statistics.numBrushes += 6;
+
+            for (std::size_t i = 0; i < settings.patchesPerRoom; ++i)
+            {
+                Vector3 origin = corner + Vector3(position(generator) * size, position(generator) * size, position(generator) * height);
+                createPatchFromBounds(worldspawn, AABB(origin, Vector3(size / 8, size / 8, 0)), randomMaterial());
+                ++statistics.numPatches;
+            }
+
+            for (std::size_t i = 0; i < settings.staticsPerRoom; ++i)
+            {
+                auto entity = createEntityByClassName("func_static");
+                scene::addNodeToContainer(entity, root);
+
+                Vector3 origin = corner + Vector3(position(generator) * size, position(generator) * size, position(generator) * height);
+                createCubicBrush(entity, origin, randomMaterial());
+
+                ++statistics.numBrushes;
+                ++statistics.numEntities;
+            }
+
+            auto light = createEntityByClassName("light");
+            scene::addNodeToContainer(light, root);
+
+            light->getEntity().setKeyValue("origin", string::to_string(center));
+            light->getEntity().setKeyValue("light_radius", string::to_string(Vector3(size / 2, size / 2, height / 2)));
+            ++statistics.numEntities;
+        }
+    }
+
+    return statistics;
+}
+
+}
+
+}
@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include "math/Frustum.h"
+#include "math/AABBBatch.h"
+
+namespace test
+{
+
+namespace
+{
+
+// A perspective frustum looking down the negative z axis, taken from the camera code
+Frustum createPerspectiveFrustum()
+{
+    const double nearClip = 1;
+    const double farClip = 4096;
+
+    Matrix4 projection = Matrix4::byColumns(
+        1, 0, 0, 0,
+        0, 1.333, 0, 0,
+        0, 0, -(farClip + nearClip) / (farClip - nearClip), -1,
+        0, 0, -(2 * farClip * nearClip) / (farClip - nearClip), 0
+    );
+
+    Matrix4 modelView = Matrix4::getRotationForEulerXYZDegrees(Vector3(0, 0, 30));
+    modelView.translateBy(Vector3(-200, 50, -30));
+
+    return Frustum::createFromViewproj(projection.getMultipliedBy(modelView));
+}
+
+}
+
+TEST(MathTest, FrustumBatchMatchesSingleIntersection)
+{
+    auto frustum = createPerspectiveFrustum();
+
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> originDistribution(-5000, 5000);
+    std::uniform_real_distribution<double> extentsDistribution(0, 1000);
+
+    std::size_t numOutside = 0;
+    std::size_t numPartial = 0;
+    std::size_t numInside = 0;
+
+    for (int round = 0; round < 500; ++round)
+    {
+        AABBBatch batch;
+
+        // Vary the number of boxes in the batch
+        auto count = round % AABBBatch::Size + 1;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            batch.add(AABB(
+                Vector3(originDistribution(generator), originDistribution(generator), -originDistribution(generator) / 2 - 2500),
+                Vector3(extentsDistribution(generator), extentsDistribution(generator), extentsDistribution(generator))
+            ));
+        }
+
+        EXPECT_EQ(batch.size(), count);
+
+        VolumeIntersectionValue results[AABBBatch::Size];
+        frustum.testIntersection(batch, results);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            auto expected = frustum.testIntersection(batch.get(i));
+            EXPECT_EQ(results[i], expected) << "Batch result differs for box " << i << " in round " << round;
+
+            numOutside += expected == VOLUME_OUTSIDE ? 1 : 0;
+            numPartial += expected == VOLUME_PARTIAL ? 1 : 0;
+            numInside += expected == VOLUME_INSIDE ? 1 : 0;
+        }
+    }
+
+    // All three outcomes should have been covered
+    EXPECT_GT(numOutside, 0);
+    EXPECT_GT(numPartial, 0);
+    EXPECT_GT(numInside, 0);
+}
+
+TEST(MathTest, FrustumBatchWithInvalidBounds)
+{
+    auto frustum = createPerspectiveFrustum();
+
+    AABBBatch batch;
+    batch.add(AABB());
+    batch.add(AABB(Vector3(0, 0, -100), Vector3(10, 10, 10)));
+
+    VolumeIntersectionValue results[AABBBatch::Size];
+    frustum.testIntersection(batch, results);
+
+    EXPECT_EQ(results[0], frustum.testIntersection(AABB()));
+    EXPECT_EQ(results[1], frustum.testIntersection(batch.get(1)));
+
+    batch.clear();
+    EXPECT_TRUE(batch.empty());
+}
+
+}
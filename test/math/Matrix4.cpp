@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include <vector>
+
 #include "math/Matrix4.h"
 #include "MatrixUtils.h"
 #include "pivot.h"
@@ -568,4 +570,69 @@ TEST(Matrix4Test, GetInverseScale)
     EXPECT_TRUE(math::isNear(invSc.tCol(), Vector4(0, 0, 0, 1), 1E-6));
 }
 
+TEST(Matrix4Test, TransformPoints)
+{
+    Matrix4 m = Matrix4::getRotationForEulerXYZDegrees(Vector3(13, 27, 41))
+              * Matrix4::getScale(Vector3(1.3, 0.7, 2))
+              * Matrix4::getTranslation(Vector3(5.5, -3, 7));
+
+    std::vector<Vector3> points;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        points.emplace_back(i * 13.7 - 500, 300 - i * 7.1, i * i * 0.3);
+    }
+
+    auto transformed = points;
+    m.transformPoints(transformed.data(), transformed.size());
+
+    const double* c = m.eigen().matrix().data();
+
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const auto& p = points[i];
+
+        // Matches the single point transformation
+        expectNear(transformed[i], m.transformPoint(p), 1E-9);
+
+#if !defined(__aarch64__) && !defined(_M_ARM64)
+        // And the scalar evaluation order, bit by bit (ARM compilers are
+        // allowed to fuse the expression below into multiply-add instructions)
+        for (int row = 0; row < 3; ++row)
+        {
+            EXPECT_EQ(transformed[i][row], ((c[row] * p.x() + c[4 + row] * p.y()) + c[8 + row] * p.z()) + c[12 + row]);
+        }
+#endif
+    }
+}
+
+TEST(Matrix4Test, TransformPointsWithStride)
+{
+    struct Vertex
+    {
+        Vector3 vertex;
+        double somethingElse;
+    };
+
+    Matrix4 m = Matrix4::getRotationAboutZ(math::Degrees(30)) * Matrix4::getTranslation(Vector3(10, 30, -61));
+
+    std::vector<Vertex> vertices;
+
+    for (int i = 0; i < 10; ++i)
+    {
+        vertices.push_back(Vertex{ Vector3(i, -i * 2, i * 3), static_cast<double>(i) });
+    }
+
+    auto transformed = vertices;
+    m.transformPoints(&transformed.front().vertex, transformed.size(), sizeof(Vertex));
+
+    for (std::size_t i = 0; i < vertices.size(); ++i)
+    {
+        expectNear(transformed[i].vertex, m.transformPoint(vertices[i].vertex), 1E-9);
+
+        // The members in between are left alone
+        EXPECT_EQ(transformed[i].somethingElse, vertices[i].somethingElse);
+    }
+}
+
 }
@@ -0,0 +1,65 @@
+#include "gtest/gtest.h"
+
+#include <random>
+#include "math/Ray.h"
+
+namespace test
+{
+
+TEST(MathTest, RayAABBDistances)
+{
+    AABB box(Vector3(100, 0, 0), Vector3(10, 20, 30));
+
+    double entry, exit;
+
+    // Hitting the box head-on
+    EXPECT_TRUE(Ray(Vector3(0, 0, 0), Vector3(1, 0, 0)).intersectAABB(box, entry, exit));
+    EXPECT_EQ(entry, 90);
+    EXPECT_EQ(exit, 110);
+
+    // Starting within the box
+    EXPECT_TRUE(Ray(Vector3(100, 0, 0), Vector3(0, 0, -1)).intersectAABB(box, entry, exit));
+    EXPECT_EQ(entry, 0);
+    EXPECT_EQ(exit, 30);
+
+    // Pointing away from the box, parallel to it, or passing by
+    EXPECT_FALSE(Ray(Vector3(0, 0, 0), Vector3(-1, 0, 0)).intersectAABB(box, entry, exit));
+    EXPECT_FALSE(Ray(Vector3(0, 50, 0), Vector3(1, 0, 0)).intersectAABB(box, entry, exit));
+    EXPECT_FALSE(Ray(Vector3(0, 0, 0), Vector3(1, 1, 0).getNormalised()).intersectAABB(box, entry, exit));
+
+    // Invalid bounds are never hit
+    EXPECT_FALSE(Ray(Vector3(0, 0, 0), Vector3(1, 0, 0)).intersectAABB(AABB(), entry, exit));
+}
+
+TEST(MathTest, RayAABBDistancesMatchIntersectionPoint)
+{
+    std::mt19937 generator(4321);
+    std::uniform_real_distribution<double> distribution(-100, 100);
+
+    AABB box(Vector3(10, -20, 5), Vector3(30, 15, 40));
+
+    std::size_t numHits = 0;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        Ray ray(Vector3(distribution(generator), distribution(generator), distribution(generator)),
+            Vector3(distribution(generator), distribution(generator), distribution(generator)).getNormalised());
+
+        Vector3 intersection;
+        double entry, exit;
+
+        auto hit = ray.intersectAABB(box, intersection);
+        EXPECT_EQ(ray.intersectAABB(box, entry, exit), hit);
+
+        if (hit)
+        {
+            EXPECT_NEAR((ray.origin + ray.direction * entry - intersection).getLength(), 0, 0.0001);
+            EXPECT_LE(entry, exit);
+            ++numHits;
+        }
+    }
+
+    EXPECT_GT(numHits, 0);
+}
+
+}
@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+
+#include <string>
+#include "math/Hash.h"
+
+namespace test
+{
+
+namespace
+{
+
+std::string sha256(const std::string& input, std::size_t chunkSize)
+{
+    math::Hash hash;
+
+    for (std::size_t offset = 0; offset < input.length(); offset += chunkSize)
+    {
+        hash.addString(input.substr(offset, chunkSize));
+    }
+
+    return hash;
+}
+
+}
+
+TEST(MathTest, SHA256KnownDigests)
+{
+    EXPECT_EQ(sha256("", 1), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    EXPECT_EQ(sha256("abc", 3), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    EXPECT_EQ(sha256("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56),
+        "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    EXPECT_EQ(sha256(std::string(1000000, 'a'), 1000000),
+        "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+TEST(MathTest, SHA256DigestIndependentOfChunking)
+{
+    std::string input;
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        input += static_cast<char>(i * 31 + 7);
+    }
+
+    auto expected = sha256(input, input.length());
+
+    // Chunks smaller than, equal to and larger than one 64 byte block
+    for (std::size_t chunkSize : { 1, 7, 63, 64, 65, 130, 999 })
+    {
+        EXPECT_EQ(sha256(input, chunkSize), expected) << "Chunk size " << chunkSize;
+    }
+}
+
+}
@@ -0,0 +1,70 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include "math/SpatialHash.h"
+
+namespace test
+{
+
+namespace
+{
+
+std::vector<int> findNear(const math::SpatialHash<int>& hash, const Vector3& point, double epsilon)
+{
+    std::vector<int> result;
+
+    hash.foreachNear(point, epsilon, [&](const Vector3&, int value)
+    {
+        result.push_back(value);
+    });
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
+
+}
+
+TEST(SpatialHashTest, FindsPointsWithinEpsilon)
+{
+    math::SpatialHash<int> hash(0.01);
+
+    hash.insert(Vector3(0, 0, 0), 1);
+    hash.insert(Vector3(0.005, -0.005, 0.005), 2);
+    hash.insert(Vector3(0.02, 0, 0), 3);
+    hash.insert(Vector3(64, 64, 64), 4);
+
+    EXPECT_EQ(findNear(hash, Vector3(0, 0, 0), 0.01), (std::vector<int>{ 1, 2 }));
+    EXPECT_EQ(findNear(hash, Vector3(64, 64, 64), 0.01), (std::vector<int>{ 4 }));
+    EXPECT_EQ(findNear(hash, Vector3(32, 32, 32), 0.01), std::vector<int>());
+}
+
+TEST(SpatialHashTest, FindsPointsInNeighbouringCells)
+{
+    math::SpatialHash<int> hash(1.0);
+
+    // Points on either side of the cell borders, including negative coordinates
+    hash.insert(Vector3(0.9995, 0.9995, 0.9995), 1);
+    hash.insert(Vector3(-0.0004, -0.0004, -0.0004), 2);
+    hash.insert(Vector3(-1.0005, 0, 0), 3);
+
+    EXPECT_EQ(findNear(hash, Vector3(1.0004, 1.0004, 1.0004), 0.001), (std::vector<int>{ 1 }));
+    EXPECT_EQ(findNear(hash, Vector3(0.0004, 0.0004, 0.0004), 0.001), (std::vector<int>{ 2 }));
+    EXPECT_EQ(findNear(hash, Vector3(-0.9995, 0, 0), 0.001), (std::vector<int>{ 3 }));
+}
+
+TEST(SpatialHashTest, ClearRemovesAllPoints)
+{
+    math::SpatialHash<int> hash(0.01);
+
+    EXPECT_TRUE(hash.empty());
+
+    hash.insert(Vector3(1, 2, 3), 1);
+    EXPECT_FALSE(hash.empty());
+
+    hash.clear();
+    EXPECT_TRUE(hash.empty());
+    EXPECT_EQ(findNear(hash, Vector3(1, 2, 3), 0.01), std::vector<int>());
+}
+
+}
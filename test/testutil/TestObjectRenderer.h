@@ -16,6 +16,9 @@ public:
     void submitObject(render::IRenderableObject& object) override
     {}
 
+    void submitObjectBounds(render::IRenderableObject& object) override
+    {}
+
     void submitGeometry(render::IGeometryStore::Slot slot, GLenum primitiveMode) override
     {}
 
@@ -34,6 +37,10 @@ public:
     void submitGeometryWithCustomIndices(render::IGeometryStore::Slot slot, GLenum primitiveMode,
         const std::vector<unsigned int>& indices) override
     {}
+
+    void submitGeometryRanges(render::IGeometryStore::Slot slot, GLenum primitiveMode,
+        const std::vector<GLint>& firstVertices, const std::vector<GLsizei>& counts) override
+    {}
 };
 
 }